@@ -646,6 +646,10 @@ index_fetch_heap(IndexScanDesc scan)
 			return scan->xs_hitup;
 		}
 
+		/* The row could be already fetched by a batched secondary index scan. */
+		if (scan->xs_hitup)
+			return scan->xs_hitup;
+
 		return YBCFetchTuple(scan->heapRelation, scan->xs_ctup.t_ybctid);
 	}
 
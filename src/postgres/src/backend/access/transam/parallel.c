@@ -41,6 +41,8 @@
 #include "utils/snapmgr.h"
 #include "utils/typcache.h"
 
+#include "pg_yb_utils.h"
+
 
 /*
  * We don't want to waste a lot of memory on an error queue which, most of
@@ -89,6 +91,14 @@ typedef struct FixedParallelState
 	TimestampTz xact_ts;
 	TimestampTz stmt_ts;
 
+	/*
+	 * YugaByte read time of the leader, that workers read at, or 0 if it could
+	 * not be shared.
+	 */
+	uint64		yb_read_time;
+	uint64		yb_global_limit;
+	uint64		yb_catalog_cache_version;
+
 	/* Mutex protects remaining fields. */
 	slock_t		mutex;
 
@@ -325,6 +335,14 @@ InitializeParallelDSM(ParallelContext *pcxt)
 	fps->parallel_master_backend_id = MyBackendId;
 	fps->xact_ts = GetCurrentTransactionStartTimestamp();
 	fps->stmt_ts = GetCurrentStatementStartTimestamp();
+	fps->yb_read_time = 0;
+	fps->yb_global_limit = 0;
+	fps->yb_catalog_cache_version = yb_catalog_cache_version;
+	if (IsYugaByteEnabled() &&
+		YBCPgTxnManager_CanShareReadTime(YBCGetPgTxnManager()))
+		YBCPgTxnManager_ExportReadTime(YBCGetPgTxnManager(),
+									   &fps->yb_read_time,
+									   &fps->yb_global_limit);
 	SpinLockInit(&fps->mutex);
 	fps->last_xlog_end = 0;
 	shm_toc_insert(pcxt->toc, PARALLEL_KEY_FIXED, fps);
@@ -1354,6 +1372,19 @@ ParallelWorkerMain(Datum main_arg)
 	tstatespace = shm_toc_lookup(toc, PARALLEL_KEY_TRANSACTION_STATE, false);
 	StartParallelWorkerTransaction(tstatespace);
 
+	/*
+	 * Read YugaByte tables at the same read time as the leader, so all
+	 * participants see the same snapshot.
+	 */
+	if (IsYugaByteEnabled())
+	{
+		yb_catalog_cache_version = fps->yb_catalog_cache_version;
+		if (fps->yb_read_time != 0)
+			YBCPgTxnManager_ImportReadTime(YBCGetPgTxnManager(),
+										   fps->yb_read_time,
+										   fps->yb_global_limit);
+	}
+
 	/* Restore combo CID state. */
 	combocidspace = shm_toc_lookup(toc, PARALLEL_KEY_COMBO_CID, false);
 	RestoreComboCIDState(combocidspace);
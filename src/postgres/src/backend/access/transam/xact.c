@@ -1969,6 +1969,7 @@ StartTransaction(void)
 
 	if (YBTransactionsEnabled())
 	{
+		YBSetFollowerReadStaleness(XactReadOnly);
 		YBCPgTxnManager_BeginTransaction(YBCGetPgTxnManager(), XactIsoLevel);
 	}
 
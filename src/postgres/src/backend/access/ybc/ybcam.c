@@ -524,6 +524,12 @@ static void ybcEndScan(YbScanDesc ybScan)
 		HandleYBStatus(YBCPgDeleteStatement(ybScan->handle));
 		ResourceOwnerForgetYugaByteStmt(ybScan->stmt_owner, ybScan->handle);
 	}
+	if (ybScan->fetch_itups)
+	{
+		pfree(ybScan->fetch_itups);
+		pfree(ybScan->fetch_htups);
+		pfree(ybScan->fetch_rechecks);
+	}
 	pfree(ybScan);
 }
 
@@ -838,6 +844,64 @@ IndexTuple ybc_index_getnext(IndexScanDesc scan_desc, bool is_forward_scan)
 	return ybc_getnext_indextuple(ybscan, is_forward_scan, &scan_desc->xs_recheck);
 }
 
+IndexTuple ybc_index_getnext_batched(IndexScanDesc scan_desc, bool is_forward_scan,
+									 HeapTuple *heap_tuple)
+{
+	YbScanDesc ybscan = (YbScanDesc) scan_desc->opaque;
+	Assert(PointerIsValid(ybscan));
+
+	if (ybscan->fetch_next == ybscan->fetch_count)
+	{
+		if (ybscan->fetch_itups == NULL)
+		{
+			ybscan->fetch_max_size = YBCGetIndexFetchBatchSize();
+			ybscan->fetch_size     = 1;
+			ybscan->fetch_itups    = (IndexTuple *) palloc(ybscan->fetch_max_size *
+														   sizeof(IndexTuple));
+			ybscan->fetch_htups    = (HeapTuple *) palloc(ybscan->fetch_max_size *
+														  sizeof(HeapTuple));
+			ybscan->fetch_rechecks = (bool *) palloc(ybscan->fetch_max_size * sizeof(bool));
+		}
+		else
+		{
+			/*
+			 * Start with small batches, so that a scan that stops early (e.g. because of LIMIT)
+			 * does not fetch many rows it does not need.
+			 */
+			ybscan->fetch_size = Min(ybscan->fetch_size * 2, ybscan->fetch_max_size);
+		}
+
+		Datum *ybctids = (Datum *) palloc(ybscan->fetch_size * sizeof(Datum));
+		ybscan->fetch_count = 0;
+		ybscan->fetch_next  = 0;
+		while (ybscan->fetch_count < ybscan->fetch_size)
+		{
+			bool       recheck = false;
+			IndexTuple tuple   = ybc_getnext_indextuple(ybscan, is_forward_scan, &recheck);
+
+			if (!tuple)
+				break;
+
+			ybscan->fetch_itups[ybscan->fetch_count]    = tuple;
+			ybscan->fetch_rechecks[ybscan->fetch_count] = recheck;
+			ybctids[ybscan->fetch_count]                = tuple->t_ybctid;
+			ybscan->fetch_count++;
+		}
+		if (ybscan->fetch_count > 0)
+			YBCFetchTuples(scan_desc->heapRelation, ybscan->fetch_count, ybctids,
+						   ybscan->fetch_htups);
+		pfree(ybctids);
+
+		if (ybscan->fetch_count == 0)
+			return NULL;
+	}
+
+	int next = ybscan->fetch_next++;
+	scan_desc->xs_recheck = ybscan->fetch_rechecks[next];
+	*heap_tuple = ybscan->fetch_htups[next];
+	return ybscan->fetch_itups[next];
+}
+
 void ybc_heap_endscan(HeapScanDesc scan_desc)
 {
 	Assert(PointerIsValid(scan_desc->ybscan));
@@ -955,7 +1019,10 @@ void ybcIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
 	RelationClose(index);
 }
 
-HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
+/*
+ * Create a select of all "real" columns of the relation and its ybctid.
+ */
+static YBCPgStatement ybcNewFetchStatement(Relation relation)
 {
 	YBCPgStatement ybc_stmt;
 	TupleDesc      tupdesc = RelationGetDescr(relation);
@@ -967,15 +1034,6 @@ HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
 								  &ybc_stmt,
 								  NULL /* read_time */));
 
-	/* Bind ybctid to identify the current row. */
-	YBCPgExpr ybctid_expr = YBCNewConstant(ybc_stmt,
-										   BYTEAOID,
-										   ybctid,
-										   false);
-	HandleYBStmtStatus(YBCPgDmlBindColumn(ybc_stmt,
-										  YBTupleIdAttributeNumber,
-										  ybctid_expr), ybc_stmt);
-
 	/*
 	 * Set up the scan targets. For index-based scan we need to return all "real" columns.
 	 */
@@ -998,9 +1056,14 @@ HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
 									   &type_attrs);
 	HandleYBStmtStatus(YBCPgDmlAppendTarget(ybc_stmt, expr), ybc_stmt);
 
-	/* Execute the select statement. */
-	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
+	return ybc_stmt;
+}
 
+/*
+ * Fetch the next row of a statement created by ybcNewFetchStatement, NULL if there are no more.
+ */
+static HeapTuple ybcFetchNextTuple(YBCPgStatement ybc_stmt, TupleDesc tupdesc)
+{
 	HeapTuple tuple    = NULL;
 	bool      has_data = false;
 
@@ -1033,8 +1096,131 @@ HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
 	pfree(values);
 	pfree(nulls);
 
+	return tuple;
+}
+
+HeapTuple YBCFetchTuple(Relation relation, Datum ybctid)
+{
+	YBCPgStatement ybc_stmt = ybcNewFetchStatement(relation);
+
+	/* Bind ybctid to identify the current row. */
+	YBCPgExpr ybctid_expr = YBCNewConstant(ybc_stmt,
+										   BYTEAOID,
+										   ybctid,
+										   false);
+	HandleYBStmtStatus(YBCPgDmlBindColumn(ybc_stmt,
+										  YBTupleIdAttributeNumber,
+										  ybctid_expr), ybc_stmt);
+
+	/* Execute the select statement. */
+	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
+
+	HeapTuple tuple = ybcFetchNextTuple(ybc_stmt, RelationGetDescr(relation));
+
 	/* Complete execution */
 	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
 
 	return tuple;
 }
+
+static bool ybctid_equals(Datum lhs, Datum rhs)
+{
+	return VARSIZE_ANY_EXHDR(lhs) == VARSIZE_ANY_EXHDR(rhs) &&
+		   memcmp(VARDATA_ANY(lhs), VARDATA_ANY(rhs), VARSIZE_ANY_EXHDR(lhs)) == 0;
+}
+
+void YBCFetchTuples(Relation relation, int count, Datum *ybctids, HeapTuple *tuples)
+{
+	YBCPgStatement ybc_stmt = ybcNewFetchStatement(relation);
+	TupleDesc      tupdesc = RelationGetDescr(relation);
+
+	YBCPgExpr *ybctid_exprs = (YBCPgExpr *) palloc(count * sizeof(YBCPgExpr));
+	for (int i = 0; i < count; i++)
+	{
+		ybctid_exprs[i] = YBCNewConstant(ybc_stmt, BYTEAOID, ybctids[i], false);
+		tuples[i] = NULL;
+	}
+	HandleYBStmtStatus(YBCPgSelectBindYbctids(ybc_stmt, count, ybctid_exprs), ybc_stmt);
+	pfree(ybctid_exprs);
+
+	/* Execute the select statement. */
+	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
+
+	/*
+	 * Rows are returned in the order of the ybctids, and rows that do not exist are skipped.
+	 */
+	int       next = 0;
+	HeapTuple tuple;
+	while (next < count && HeapTupleIsValid(tuple = ybcFetchNextTuple(ybc_stmt, tupdesc)))
+	{
+		while (next < count && !ybctid_equals(ybctids[next], tuple->t_ybctid))
+			next++;
+		if (next < count)
+			tuples[next++] = tuple;
+	}
+
+	/* Complete execution */
+	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
+}
+
+static bool ybcTupleHasKey(HeapTuple tuple, TupleDesc tupdesc, int nkeys, AttrNumber *attnums,
+						   Datum *key, FmgrInfo *eq_funcs, Oid *collations)
+{
+	for (int i = 0; i < nkeys; i++)
+	{
+		bool  is_null;
+		Datum value = heap_getattr(tuple, attnums[i], tupdesc, &is_null);
+		if (is_null ||
+			!DatumGetBool(FunctionCall2Coll(&eq_funcs[i], collations[i], value, key[i])))
+			return false;
+	}
+	return true;
+}
+
+void YBCFetchTuplesByPrimaryKey(Relation relation, int count, int nkeys, AttrNumber *attnums,
+								Datum *values, FmgrInfo *eq_funcs, Oid *collations,
+								HeapTuple *tuples)
+{
+	YBCPgStatement ybc_stmt = ybcNewFetchStatement(relation);
+	TupleDesc      tupdesc = RelationGetDescr(relation);
+
+	int       *attr_nums = (int *) palloc(nkeys * sizeof(int));
+	YBCPgExpr *exprs = (YBCPgExpr *) palloc(count * nkeys * sizeof(YBCPgExpr));
+	for (int i = 0; i < nkeys; i++)
+		attr_nums[i] = attnums[i];
+	for (int i = 0; i < count; i++)
+	{
+		for (int j = 0; j < nkeys; j++)
+		{
+			Form_pg_attribute att = TupleDescAttr(tupdesc, attnums[j] - 1);
+			exprs[i * nkeys + j] = YBCNewConstant(ybc_stmt, att->atttypid,
+												  values[i * nkeys + j], false);
+		}
+		tuples[i] = NULL;
+	}
+	HandleYBStmtStatus(YBCPgSelectBindKeyBatch(ybc_stmt, count, nkeys, attr_nums, exprs),
+					   ybc_stmt);
+	pfree(attr_nums);
+	pfree(exprs);
+
+	/* Execute the select statement. */
+	HandleYBStmtStatus(YBCPgExecSelect(ybc_stmt), ybc_stmt);
+
+	/*
+	 * Rows are returned in the order of the keys, and keys without rows are skipped.
+	 */
+	int       next = 0;
+	HeapTuple tuple;
+	while (next < count && HeapTupleIsValid(tuple = ybcFetchNextTuple(ybc_stmt, tupdesc)))
+	{
+		while (next < count &&
+			   !ybcTupleHasKey(tuple, tupdesc, nkeys, attnums, &values[next * nkeys],
+							   eq_funcs, collations))
+			next++;
+		if (next < count)
+			tuples[next++] = tuple;
+	}
+
+	/* Complete execution */
+	HandleYBStatus(YBCPgDeleteStatement(ybc_stmt));
+}
@@ -30,6 +30,7 @@
 #include "access/sysattr.h"
 #include "access/ybcam.h"
 #include "access/ybcin.h"
+#include "catalog/catalog.h"
 #include "catalog/index.h"
 #include "catalog/pg_type.h"
 #include "utils/rel.h"
@@ -42,6 +43,8 @@ typedef struct
 {
 	bool	isprimary;
 	double	index_tuples;
+	/* Bulk insert of the entries, NULL if they are inserted one by one. */
+	YBCBulkInsertState bulk_insert;
 } YBCBuildState;
 
 /*
@@ -102,7 +105,9 @@ ybcinbuildCallback(Relation index, HeapTuple heapTuple, Datum *values, bool *isn
 {
 	YBCBuildState  *buildstate = (YBCBuildState *)state;
 
-	if (!buildstate->isprimary)
+	if (buildstate->bulk_insert)
+		YBCBulkInsertIndex(buildstate->bulk_insert, values, isnull, heapTuple->t_ybctid);
+	else if (!buildstate->isprimary)
 		YBCExecuteInsertIndex(index, values, isnull, heapTuple->t_ybctid);
 
 	buildstate->index_tuples += 1;
@@ -123,8 +128,24 @@ ybcinbuild(Relation heap, Relation index, struct IndexInfo *indexInfo)
 		/* Do the heap scan */
 		buildstate.isprimary = index->rd_index->indisprimary;
 		buildstate.index_tuples = 0;
+		buildstate.bulk_insert = NULL;
+
+		/*
+		 * Entries of a secondary index of a user table are sent in batches,
+		 * instead of a write round-trip per row of the base table. The batches
+		 * are split per tablet of the index, and several of them are in flight
+		 * at the same time. The heap scan reads all rows at the same snapshot.
+		 * System catalog indexes are built one entry at a time, as their
+		 * writes could require the catalog version update.
+		 */
+		if (!buildstate.isprimary && !IsBootstrapProcessingMode() && !IsSystemRelation(index))
+			buildstate.bulk_insert = YBCBeginBulkInsertIndex(index);
+
 		heap_tuples = IndexBuildHeapScan(heap, index, indexInfo, true, ybcinbuildCallback,
 										 &buildstate, NULL);
+
+		if (buildstate.bulk_insert)
+			YBCEndBulkInsert(buildstate.bulk_insert);
 	}
 	PG_CATCH();
 	{
@@ -265,7 +286,26 @@ ybcingettuple(IndexScanDesc scan, ScanDirection dir)
 	 * If IndexTuple is requested or it is a secondary index, return the result as IndexTuple.
 	 * Otherwise, return the result as a HeapTuple of the base table.
 	 */
-	if (scan->xs_want_itup || !scan->indexRelation->rd_index->indisprimary)
+	if (!scan->xs_want_itup && !scan->indexRelation->rd_index->indisprimary &&
+		scan->heapRelation && YBCGetIndexFetchBatchSize() > 1)
+	{
+		/*
+		 * The base table rows are needed, fetch them in batches instead of one by one in
+		 * index_fetch_heap().
+		 */
+		HeapTuple  heap_tuple = NULL;
+		IndexTuple tuple = ybc_index_getnext_batched(scan, is_forward_scan, &heap_tuple);
+
+		if (tuple)
+		{
+			scan->xs_ctup.t_ybctid = tuple->t_ybctid;
+			scan->xs_itup = tuple;
+			scan->xs_itupdesc = RelationGetDescr(scan->indexRelation);
+			scan->xs_hitup = heap_tuple;
+			scan->xs_hitupdesc = RelationGetDescr(scan->heapRelation);
+		}
+	}
+	else if (scan->xs_want_itup || !scan->indexRelation->rd_index->indisprimary)
 	{
 		IndexTuple tuple = ybc_index_getnext(scan, is_forward_scan);
 
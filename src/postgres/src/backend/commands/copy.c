@@ -23,6 +23,7 @@
 #include "access/sysattr.h"
 #include "access/xact.h"
 #include "access/xlog.h"
+#include "catalog/catalog.h"
 #include "catalog/dependency.h"
 #include "catalog/pg_authid.h"
 #include "catalog/pg_type.h"
@@ -2344,6 +2345,7 @@ CopyFrom(CopyState cstate)
 	BulkInsertState bistate;
 	uint64		processed = 0;
 	bool		useHeapMultiInsert;
+	YBCBulkInsertState ybcBulkInsertState = NULL;
 	int			nBufferedTuples = 0;
 	int			prev_leaf_part_index = -1;
 
@@ -2617,6 +2619,21 @@ CopyFrom(CopyState cstate)
 	bistate = GetBulkInsertState();
 	econtext = GetPerTupleExprContext(estate);
 
+	/*
+	 * Rows of a YugaByte table are sent in batches, unless something needs to
+	 * see each row as soon as it is inserted: triggers (including foreign key
+	 * checks), secondary indexes that need ybctid of the row, or catalog
+	 * changes.
+	 */
+	if (IsYBRelation(resultRelInfo->ri_RelationDesc) &&
+		resultRelInfo->ri_TrigDesc == NULL &&
+		cstate->partition_tuple_routing == NULL &&
+		!YBCRelInfoHasSecondaryIndices(resultRelInfo) &&
+		!IsSystemRelation(resultRelInfo->ri_RelationDesc))
+	{
+		ybcBulkInsertState = YBCBeginBulkInsert(cstate->rel);
+	}
+
 	/* Set up callback to identify error line number */
 	errcallback.callback = CopyFromErrorCallback;
 	errcallback.arg = (void *) cstate;
@@ -2834,7 +2851,11 @@ CopyFrom(CopyState cstate)
 					List	   *recheckIndexes = NIL;
 
 					/* OK, store the tuple and create index entries for it */
-					if (IsYBRelation(resultRelInfo->ri_RelationDesc))
+					if (ybcBulkInsertState != NULL)
+					{
+						YBCBulkInsert(ybcBulkInsertState, tupDesc, tuple);
+					}
+					else if (IsYBRelation(resultRelInfo->ri_RelationDesc))
 					{
 						YBCExecuteInsert(cstate->rel, tupDesc, tuple);
 					}
@@ -2906,6 +2927,13 @@ next_tuple:
 	/* Done, clean up */
 	error_context_stack = errcallback.previous;
 
+	/*
+	 * Wait for the bulk inserted rows. Their errors are reported without the
+	 * line context, because the failed row is not known at this point.
+	 */
+	if (ybcBulkInsertState != NULL)
+		YBCEndBulkInsert(ybcBulkInsertState);
+
 	FreeBulkInsertState(bistate);
 
 	MemoryContextSwitchTo(oldcontext);
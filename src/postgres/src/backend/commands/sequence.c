@@ -699,6 +699,14 @@ nextval_internal(Oid relid, bool check_permissions)
 	cycle = pgsform->seqcycle;
 	ReleaseSysCache(pgstuple);
 
+	/*
+	 * Every range of values allocated in YugaByte costs a read and a conditional
+	 * write of the sequence tuple, so the range could be larger than the CACHE
+	 * setting of the sequence.
+	 */
+	if (IsYugaByteEnabled())
+		cache = Max(cache, YBCGetSequenceCacheMinval());
+
 retry:
 	if (IsYugaByteEnabled())
 	{
@@ -4592,6 +4592,10 @@ afterTriggerInvokeEvents(AfterTriggerEventList *events,
 		ExecDropSingleTupleTableSlot(slot2);
 	}
 
+	/* Foreign key checks of YugaByte tables could have been batched. */
+	if (IsYugaByteEnabled())
+		YBFlushForeignKeyChecks();
+
 	/* Release working resources */
 	MemoryContextDelete(per_tuple_context);
 
@@ -515,6 +515,19 @@ check_transaction_read_only(bool *newval, void **extra, GucSource source)
 	return true;
 }
 
+/*
+ * Follower reads are only used by read-only transactions, and the read time
+ * can only change before the first snapshot of the transaction is taken.
+ */
+void
+assign_transaction_read_only(bool newval, void *extra)
+{
+	if (IsTransactionState() && !FirstSnapshotSet && !InitializingParallelWorker)
+	{
+		YBSetFollowerReadStaleness(newval);
+	}
+}
+
 /*
  * SET TRANSACTION ISOLATION LEVEL
  *
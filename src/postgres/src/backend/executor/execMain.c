@@ -1711,6 +1711,14 @@ ExecutePlan(EState *estate,
 	if (!execute_once)
 		use_parallel_mode = false;
 
+	/*
+	 * Parallel workers read YugaByte tables at the read time of the leader, but
+	 * could not see the writes of its transaction.
+	 */
+	if (use_parallel_mode && IsYugaByteEnabled() &&
+		!YBCPgTxnManager_CanShareReadTime(YBCGetPgTxnManager()))
+		use_parallel_mode = false;
+
 	estate->es_use_parallel_mode = use_parallel_mode;
 	if (use_parallel_mode)
 		EnterParallelMode();
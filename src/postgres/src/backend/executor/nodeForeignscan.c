@@ -28,6 +28,7 @@
 #include "utils/memutils.h"
 #include "utils/rel.h"
 
+#include "executor/ybc_fdw.h"
 #include "pg_yb_utils.h"
 
 static TupleTableSlot *ForeignNext(ForeignScanState *node);
@@ -170,6 +171,11 @@ ExecInitForeignScan(ForeignScan *node, EState *estate, int eflags)
 		scanstate->ss.ss_currentRelation = currentRelation;
 		fdwroutine = GetFdwRoutineForRelation(currentRelation, true);
 	}
+	else if (IsYugaByteEnabled() && !OidIsValid(node->fs_server))
+	{
+		/* YugaByte relations have no foreign server, e.g. for aggregates computed by YugaByte */
+		fdwroutine = (FdwRoutine *) ybc_fdw_handler();
+	}
 	else
 	{
 		/* We can't use the relcache, so get fdwroutine the hard way */
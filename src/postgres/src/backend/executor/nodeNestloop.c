@@ -21,10 +21,17 @@
 
 #include "postgres.h"
 
+#include "access/stratnum.h"
+#include "access/ybcam.h"
 #include "executor/execdebug.h"
 #include "executor/nodeNestloop.h"
 #include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/lsyscache.h"
 #include "utils/memutils.h"
+#include "utils/rel.h"
+
+#include "pg_yb_utils.h"
 
 
 /* ----------------------------------------------------------------
@@ -255,6 +262,276 @@ ExecNestLoop(PlanState *pstate)
 	}
 }
 
+/*
+ * Collect the next batch of outer tuples and fetch their inner tuples.
+ */
+static void
+ybcFetchNestLoopBatch(NestLoopState *node)
+{
+	PlanState  *outerPlan = outerPlanState(node);
+	PlanState  *innerPlan = innerPlanState(node);
+	Relation	relation = ((ScanState *) innerPlan)->ss_currentRelation;
+	int			nkeys = node->yb_nkeys;
+	MemoryContext oldcontext;
+
+	MemoryContextReset(node->yb_batch_context);
+	oldcontext = MemoryContextSwitchTo(node->yb_batch_context);
+
+	Datum	   *keys = (Datum *) palloc(node->yb_batch_size * nkeys * sizeof(Datum));
+	int		   *key_rows = (int *) palloc(node->yb_batch_size * sizeof(int));
+	HeapTuple  *key_tuples = (HeapTuple *) palloc(node->yb_batch_size * sizeof(HeapTuple));
+	int			count = 0;
+
+	node->yb_num_outer = 0;
+	node->yb_next_outer = 0;
+	while (node->yb_num_outer < node->yb_batch_size)
+	{
+		int			row = node->yb_num_outer;
+		TupleTableSlot *outerTupleSlot;
+		bool		has_null = false;
+
+		MemoryContextSwitchTo(oldcontext);
+		outerTupleSlot = ExecProcNode(outerPlan);
+		MemoryContextSwitchTo(node->yb_batch_context);
+		if (TupIsNull(outerTupleSlot))
+		{
+			node->yb_outer_done = true;
+			break;
+		}
+		ExecCopySlot(node->yb_outer_slots[row], outerTupleSlot);
+		node->yb_inner_tuples[row] = NULL;
+		node->yb_num_outer++;
+
+		/* A key with a null value has no inner tuple. */
+		for (int i = 0; i < nkeys; i++)
+		{
+			bool		isnull;
+
+			keys[count * nkeys + i] = slot_getattr(node->yb_outer_slots[row],
+												   node->yb_outer_attnums[i],
+												   &isnull);
+			has_null = has_null || isnull;
+		}
+		if (!has_null)
+			key_rows[count++] = row;
+	}
+
+	if (count > 0)
+	{
+		YBCFetchTuplesByPrimaryKey(relation, count, nkeys, node->yb_inner_attnums, keys,
+								   node->yb_eq_funcs, node->yb_collations, key_tuples);
+		for (int i = 0; i < count; i++)
+			node->yb_inner_tuples[key_rows[i]] = key_tuples[i];
+	}
+
+	MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * ExecNestLoop for the batched mode. The inner plan is not executed, its scan
+ * slot and projection are used to present the fetched inner tuples.
+ */
+static TupleTableSlot *
+ExecYbBatchedNestLoop(PlanState *pstate)
+{
+	NestLoopState *node = castNode(NestLoopState, pstate);
+	ScanState  *innerScan = (ScanState *) innerPlanState(node);
+	ExprState  *joinqual = node->js.joinqual;
+	ExprState  *otherqual = node->js.ps.qual;
+	ExprContext *econtext = node->js.ps.ps_ExprContext;
+
+	CHECK_FOR_INTERRUPTS();
+
+	ResetExprContext(econtext);
+
+	for (;;)
+	{
+		HeapTuple	innerTuple;
+
+		if (node->yb_next_outer >= node->yb_num_outer)
+		{
+			if (node->yb_outer_done)
+				return NULL;
+			ybcFetchNestLoopBatch(node);
+			if (node->yb_num_outer == 0)
+				return NULL;
+		}
+
+		/* Primary key lookup finds at most one inner tuple for every outer one. */
+		econtext->ecxt_outertuple = node->yb_outer_slots[node->yb_next_outer];
+		innerTuple = node->yb_inner_tuples[node->yb_next_outer];
+		node->yb_next_outer++;
+
+		if (HeapTupleIsValid(innerTuple))
+		{
+			TupleTableSlot *innerTupleSlot = innerScan->ss_ScanTupleSlot;
+			ProjectionInfo *innerProj = innerScan->ps.ps_ProjInfo;
+
+			ExecStoreTuple(innerTuple, innerTupleSlot, InvalidBuffer, false);
+			if (innerProj)
+			{
+				innerProj->pi_exprContext->ecxt_scantuple = innerTupleSlot;
+				innerTupleSlot = ExecProject(innerProj);
+			}
+			econtext->ecxt_innertuple = innerTupleSlot;
+
+			if (ExecQual(joinqual, econtext))
+			{
+				if (otherqual == NULL || ExecQual(otherqual, econtext))
+					return ExecProject(node->js.ps.ps_ProjInfo);
+				InstrCountFiltered2(node, 1);
+				ResetExprContext(econtext);
+				continue;
+			}
+			InstrCountFiltered1(node, 1);
+		}
+
+		if (node->js.jointype == JOIN_LEFT)
+		{
+			econtext->ecxt_innertuple = node->nl_NullInnerTupleSlot;
+			if (otherqual == NULL || ExecQual(otherqual, econtext))
+				return ExecProject(node->js.ps.ps_ProjInfo);
+			InstrCountFiltered2(node, 1);
+		}
+
+		ResetExprContext(econtext);
+	}
+}
+
+/*
+ * Return the param id if expr is a PARAM_EXEC param, -1 otherwise.
+ */
+static int
+ybcExecParamId(Node *expr)
+{
+	if (IsA(expr, RelabelType))
+		expr = (Node *) ((RelabelType *) expr)->arg;
+	if (!IsA(expr, Param) || ((Param *) expr)->paramkind != PARAM_EXEC)
+		return -1;
+	return ((Param *) expr)->paramid;
+}
+
+/*
+ * Set up the batched mode if the inner plan is a scan of the primary key of a
+ * YugaByte relation, whose index quals equate all primary key columns to outer
+ * values. Return false if the join should run tuple by tuple.
+ */
+static bool
+ybcInitBatchedNestLoop(NestLoopState *nlstate, NestLoop *node, EState *estate, int eflags)
+{
+	int			batch_size = YBCGetNestLoopBatchSize();
+	PlanState  *innerPlan = innerPlanState(nlstate);
+	IndexScan  *indexScan;
+	Relation	index;
+	int			nkeys;
+	ListCell   *lc;
+	int			i = 0;
+
+	if (!IsYugaByteEnabled() || batch_size < 2 || (eflags & EXEC_FLAG_EXPLAIN_ONLY) ||
+		(node->join.jointype != JOIN_INNER && node->join.jointype != JOIN_LEFT) ||
+		!IsA(innerPlan, IndexScanState))
+		return false;
+
+	indexScan = (IndexScan *) innerPlan->plan;
+	index = ((IndexScanState *) innerPlan)->iss_RelationDesc;
+	if (!IsYBRelation(((ScanState *) innerPlan)->ss_currentRelation) ||
+		!index->rd_index->indisprimary || indexScan->scan.plan.qual != NIL ||
+		indexScan->indexorderby != NIL)
+		return false;
+
+	nkeys = IndexRelationGetNumberOfKeyAttributes(index);
+	if (list_length(indexScan->indexqualorig) != nkeys)
+		return false;
+
+	/* The inner target list must not depend on the params. */
+	foreach(lc, indexScan->scan.plan.targetlist)
+	{
+		if (!IsA(((TargetEntry *) lfirst(lc))->expr, Var))
+			return false;
+	}
+
+	nlstate->yb_inner_attnums = (AttrNumber *) palloc0(nkeys * sizeof(AttrNumber));
+	nlstate->yb_outer_attnums = (AttrNumber *) palloc0(nkeys * sizeof(AttrNumber));
+	nlstate->yb_eq_funcs = (FmgrInfo *) palloc0(nkeys * sizeof(FmgrInfo));
+	nlstate->yb_collations = (Oid *) palloc0(nkeys * sizeof(Oid));
+
+	/* Every qual must be "key column = param of an outer column". */
+	foreach(lc, indexScan->indexqualorig)
+	{
+		OpExpr	   *op = (OpExpr *) lfirst(lc);
+		Var		   *var;
+		Node	   *param;
+		int			paramid;
+		int			indexcol;
+		ListCell   *plc;
+
+		if (!IsA(op, OpExpr) || list_length(op->args) != 2)
+			return false;
+		/* The original form of the qual could have the key column on either side. */
+		if (IsA(linitial(op->args), Var))
+		{
+			var = (Var *) linitial(op->args);
+			param = (Node *) lsecond(op->args);
+		}
+		else if (IsA(lsecond(op->args), Var))
+		{
+			var = (Var *) lsecond(op->args);
+			param = (Node *) linitial(op->args);
+		}
+		else
+			return false;
+		paramid = ybcExecParamId(param);
+		if (var->varattno <= 0 || paramid < 0 || exprType(param) != var->vartype)
+			return false;
+
+		for (indexcol = 0; indexcol < nkeys; indexcol++)
+		{
+			if (index->rd_index->indkey.values[indexcol] == var->varattno)
+				break;
+		}
+		if (indexcol == nkeys ||
+			get_op_opfamily_strategy(op->opno, index->rd_opfamily[indexcol]) !=
+				BTEqualStrategyNumber)
+			return false;
+		for (int j = 0; j < i; j++)
+		{
+			if (nlstate->yb_inner_attnums[j] == var->varattno)
+				return false;
+		}
+
+		nlstate->yb_inner_attnums[i] = var->varattno;
+		foreach(plc, node->nestParams)
+		{
+			NestLoopParam *nlp = (NestLoopParam *) lfirst(plc);
+
+			if (nlp->paramno == paramid)
+				nlstate->yb_outer_attnums[i] = nlp->paramval->varattno;
+		}
+		if (nlstate->yb_outer_attnums[i] == 0)
+			return false;
+		fmgr_info(get_opcode(op->opno), &nlstate->yb_eq_funcs[i]);
+		nlstate->yb_collations[i] = op->inputcollid;
+		i++;
+	}
+
+	nlstate->yb_batched = true;
+	nlstate->yb_batch_size = batch_size;
+	nlstate->yb_nkeys = nkeys;
+	nlstate->yb_outer_slots = (TupleTableSlot **) palloc(batch_size * sizeof(TupleTableSlot *));
+	for (i = 0; i < batch_size; i++)
+		nlstate->yb_outer_slots[i] =
+			ExecInitExtraTupleSlot(estate, ExecGetResultType(outerPlanState(nlstate)));
+	nlstate->yb_inner_tuples = (HeapTuple *) palloc0(batch_size * sizeof(HeapTuple));
+	nlstate->yb_num_outer = 0;
+	nlstate->yb_next_outer = 0;
+	nlstate->yb_outer_done = false;
+	nlstate->yb_batch_context = AllocSetContextCreate(CurrentMemoryContext,
+													  "NestLoop batch",
+													  ALLOCSET_DEFAULT_SIZES);
+	nlstate->js.ps.ExecProcNode = ExecYbBatchedNestLoop;
+	return true;
+}
+
 /* ----------------------------------------------------------------
  *		ExecInitNestLoop
  * ----------------------------------------------------------------
@@ -345,6 +622,8 @@ ExecInitNestLoop(NestLoop *node, EState *estate, int eflags)
 	nlstate->nl_NeedNewOuter = true;
 	nlstate->nl_MatchedOuter = false;
 
+	ybcInitBatchedNestLoop(nlstate, node, estate, eflags);
+
 	NL1_printf("ExecInitNestLoop: %s\n",
 			   "node initialized");
 
@@ -407,4 +686,7 @@ ExecReScanNestLoop(NestLoopState *node)
 
 	node->nl_NeedNewOuter = true;
 	node->nl_MatchedOuter = false;
+	node->yb_num_outer = 0;
+	node->yb_next_outer = 0;
+	node->yb_outer_done = false;
 }
@@ -373,6 +373,195 @@ Oid YBCExecuteSingleRowTxnInsert(Relation rel,
 	                                true /* is_single_row_txn */);
 }
 
+/*
+ * State of a bulk insert, see YBCBeginBulkInsert().
+ */
+typedef struct YBCBulkInsertStateData
+{
+	Relation		rel;
+	Bitmapset	   *pkey;
+	YBCPgStatement	insert_stmt;
+	/* Constants bound to the columns, indexed by attnum - minattr. */
+	YBCPgExpr	   *exprs;
+	/* Constant bound to the ybbasectid column of an index. */
+	YBCPgExpr		ybbasectid_expr;
+} YBCBulkInsertStateData;
+
+YBCBulkInsertState YBCBeginBulkInsert(Relation rel)
+{
+	AttrNumber		   minattr = FirstLowInvalidHeapAttributeNumber + 1;
+	int				   natts   = RelationGetNumberOfAttributes(rel);
+	YBCBulkInsertState state   = palloc0(sizeof(YBCBulkInsertStateData));
+
+	state->rel   = rel;
+	state->pkey  = GetTablePrimaryKey(rel);
+	state->exprs = palloc0((natts - minattr + 1) * sizeof(YBCPgExpr));
+
+	/* Drop whatever is left by a bulk insert that was aborted by an error. */
+	YBCPgStartBulkInserts(ybc_pg_session);
+
+	HandleYBStatus(YBCPgNewInsert(ybc_pg_session,
+	                              YBCGetDatabaseOid(rel),
+	                              RelationGetRelid(rel),
+	                              false /* is_single_row_txn */,
+	                              &state->insert_stmt));
+	HandleYBStmtStatus(YBCPgSetCatalogCacheVersion(state->insert_stmt,
+	                                               yb_catalog_cache_version),
+	                   state->insert_stmt);
+	return state;
+}
+
+Oid YBCBulkInsert(YBCBulkInsertState state,
+                  TupleDesc tupleDesc,
+                  HeapTuple tuple)
+{
+	Relation	   rel         = state->rel;
+	AttrNumber	   minattr     = FirstLowInvalidHeapAttributeNumber + 1;
+	int			   natts       = RelationGetNumberOfAttributes(rel);
+	YBCPgStatement insert_stmt = state->insert_stmt;
+	bool		   is_null     = false;
+
+	/* Generate a new oid for this row if needed */
+	if (rel->rd_rel->relhasoids)
+	{
+		if (!OidIsValid(HeapTupleGetOid(tuple)))
+			HeapTupleSetOid(tuple, GetNewOid(rel));
+	}
+
+	/*
+	 * The columns are bound once, by the first row. The following rows only
+	 * update the values of the bound constants.
+	 */
+	for (AttrNumber attnum = minattr; attnum <= natts; attnum++)
+	{
+		/* Skip virtual (system) and dropped columns */
+		if (!IsRealYBColumn(rel, attnum))
+		{
+			continue;
+		}
+
+		YBCPgExpr *ybc_expr = &state->exprs[attnum - minattr];
+		Datum      datum    = heap_getattr(tuple, attnum, tupleDesc, &is_null);
+
+		/* Check not-null constraint on primary key early */
+		if (is_null && bms_is_member(attnum - minattr, state->pkey))
+		{
+			HandleYBStatus(YBCPgDeleteStatement(insert_stmt));
+			ereport(ERROR,
+			        (errcode(ERRCODE_NOT_NULL_VIOLATION), errmsg(
+					        "Missing/null value for primary key column")));
+		}
+
+		if (*ybc_expr == NULL)
+		{
+			*ybc_expr = YBCNewConstant(insert_stmt,
+			                           GetTypeId(attnum, tupleDesc),
+			                           datum,
+			                           is_null);
+			HandleYBStmtStatus(YBCPgDmlBindColumn(insert_stmt, attnum, *ybc_expr),
+			                   insert_stmt);
+		}
+		else
+		{
+			HandleYBStmtStatus(YBCPgUpdateConstDatum(*ybc_expr, datum, is_null),
+			                   insert_stmt);
+		}
+	}
+
+	/*
+	 * Rows are flushed in batches, so an error of the row flushed earlier could
+	 * be reported here.
+	 */
+	YBCHandleInsertStatus(YBCPgExecBulkInsert(insert_stmt), rel, insert_stmt);
+
+	return HeapTupleGetOid(tuple);
+}
+
+YBCBulkInsertState YBCBeginBulkInsertIndex(Relation index)
+{
+	int				   natts = RelationGetNumberOfAttributes(index);
+	YBCBulkInsertState state = palloc0(sizeof(YBCBulkInsertStateData));
+
+	Assert(index->rd_rel->relkind == RELKIND_INDEX);
+
+	state->rel   = index;
+	state->exprs = palloc0(natts * sizeof(YBCPgExpr));
+
+	/* Drop whatever is left by a bulk insert that was aborted by an error. */
+	YBCPgStartBulkInserts(ybc_pg_session);
+
+	HandleYBStatus(YBCPgNewInsert(ybc_pg_session,
+	                              YBCGetDatabaseOid(index),
+	                              RelationGetRelid(index),
+	                              false /* is_single_row_txn */,
+	                              &state->insert_stmt));
+	HandleYBStmtStatus(YBCPgSetCatalogCacheVersion(state->insert_stmt,
+	                                               yb_catalog_cache_version),
+	                   state->insert_stmt);
+	return state;
+}
+
+void YBCBulkInsertIndex(YBCBulkInsertState state, Datum *values, bool *isnull, Datum ybctid)
+{
+	TupleDesc	   tupdesc     = RelationGetDescr(state->rel);
+	int			   natts       = RelationGetNumberOfAttributes(state->rel);
+	YBCPgStatement insert_stmt = state->insert_stmt;
+
+	/* Same as in YBCBulkInsert, the columns are bound by the first entry. */
+	for (AttrNumber attnum = 1; attnum <= natts; attnum++)
+	{
+		YBCPgExpr *ybc_expr = &state->exprs[attnum - 1];
+		Datum      value    = values[attnum - 1];
+		bool       is_null  = isnull[attnum - 1];
+
+		if (*ybc_expr == NULL)
+		{
+			*ybc_expr = YBCNewConstant(insert_stmt,
+			                           GetTypeId(attnum, tupdesc),
+			                           value,
+			                           is_null);
+			HandleYBStmtStatus(YBCPgDmlBindColumn(insert_stmt, attnum, *ybc_expr),
+			                   insert_stmt);
+		}
+		else
+		{
+			HandleYBStmtStatus(YBCPgUpdateConstDatum(*ybc_expr, value, is_null),
+			                   insert_stmt);
+		}
+	}
+
+	/* Bind the ybctid from the base table to the ybbasectid column. */
+	Assert(ybctid != 0);
+	if (state->ybbasectid_expr == NULL)
+	{
+		state->ybbasectid_expr = YBCNewConstant(insert_stmt, BYTEAOID, ybctid,
+		                                        false /* is_null */);
+		HandleYBStmtStatus(YBCPgDmlBindColumn(insert_stmt,
+		                                      YBBaseTupleIdAttributeNumber,
+		                                      state->ybbasectid_expr),
+		                   insert_stmt);
+	}
+	else
+	{
+		HandleYBStmtStatus(YBCPgUpdateConstDatum(state->ybbasectid_expr, ybctid,
+		                                         false /* is_null */),
+		                   insert_stmt);
+	}
+
+	YBCHandleInsertStatus(YBCPgExecBulkInsert(insert_stmt), state->rel, insert_stmt);
+}
+
+void YBCEndBulkInsert(YBCBulkInsertState state)
+{
+	YBCHandleInsertStatus(YBCPgFlushBulkInserts(ybc_pg_session),
+	                      state->rel,
+	                      state->insert_stmt);
+	HandleYBStatus(YBCPgDeleteStatement(state->insert_stmt));
+	bms_free(state->pkey);
+	pfree(state->exprs);
+	pfree(state);
+}
+
 Oid YBCHeapInsert(TupleTableSlot *slot,
 									HeapTuple tuple,
 									EState *estate) {
@@ -31,9 +31,11 @@
 
 /*  TODO see which includes of this block are still needed. */
 #include "access/htup_details.h"
+#include "access/parallel.h"
 #include "access/reloptions.h"
 #include "access/sysattr.h"
 #include "catalog/catalog.h"
+#include "catalog/pg_aggregate.h"
 #include "catalog/pg_foreign_table.h"
 #include "commands/copy.h"
 #include "commands/defrem.h"
@@ -48,14 +50,22 @@
 #include "optimizer/paths.h"
 #include "optimizer/planmain.h"
 #include "optimizer/restrictinfo.h"
+#include "optimizer/tlist.h"
 #include "optimizer/var.h"
+#include "parser/parsetree.h"
+#include "port/atomics.h"
 #include "utils/memutils.h"
 #include "utils/rel.h"
 #include "utils/sampling.h"
 
 /*  YB includes. */
+#include "access/transam.h"
 #include "commands/dbcommands.h"
+#include "access/stratnum.h"
 #include "catalog/pg_operator.h"
+#include "catalog/pg_opfamily.h"
+#include "catalog/pg_type.h"
+#include "catalog/ybctype.h"
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 
@@ -129,10 +139,354 @@ ybcGetForeignPaths(PlannerInfo *root,
 	                                          NULL, /* no extra plan */
 	                                          NULL  /* no options yet */ ));
 
+	/*
+	 * Divide the scan among parallel workers, see ybcIsForeignScanParallelSafe. Every
+	 * participant reads its share of the rows.
+	 */
+	if (baserel->consider_parallel && baserel->lateral_relids == NULL)
+	{
+		int parallel_workers = baserel->rel_parallel_workers != -1 ?
+		                       Min(baserel->rel_parallel_workers,
+		                           max_parallel_workers_per_gather) :
+		                       max_parallel_workers_per_gather;
+		if (parallel_workers > 0)
+		{
+			double      divisor = parallel_workers + (parallel_leader_participation ? 1 : 0);
+			ForeignPath *path   = create_foreignscan_path(root,
+			                                              baserel,
+			                                              NULL, /* default pathtarget */
+			                                              baserel->rows / divisor,
+			                                              startup_cost,
+			                                              startup_cost +
+			                                              (total_cost - startup_cost) / divisor,
+			                                              NIL,  /* no pathkeys */
+			                                              NULL, /* no outer rel either */
+			                                              NULL, /* no extra plan */
+			                                              NULL  /* no options yet */);
+			path->path.parallel_aware   = true;
+			path->path.parallel_workers = parallel_workers;
+			add_partial_path(baserel, (Path *) path);
+		}
+	}
+
 	/* Add primary key and secondary index paths also */
 	create_index_paths(root, baserel);
 }
 
+/*
+ * ybcGetPushdownOpName
+ *		Returns name of the operator of a scan condition "column op constant" if YugaByte
+ *		could evaluate the condition while scanning, or NULL otherwise. The condition could
+ *		also be written as "constant op column", in that case the commuted operator is
+ *		returned.
+ *
+ *		YugaByte compares values of the same type without collations and does not follow SQL
+ *		semantics for NULLs, which is safe only for the types and operators accepted here.
+ *		Postgres still evaluates the conditions on the rows returned.
+ */
+static char *
+ybcGetPushdownOpName(OpExpr *opexpr, Var **var, Const **constant)
+{
+	if (list_length(opexpr->args) != 2)
+		return NULL;
+
+	Node *left  = (Node *) linitial(opexpr->args);
+	Node *right = (Node *) lsecond(opexpr->args);
+	Oid  opno   = opexpr->opno;
+	if (IsA(left, Var) && IsA(right, Const))
+	{
+		*var      = (Var *) left;
+		*constant = (Const *) right;
+	}
+	else if (IsA(left, Const) && IsA(right, Var))
+	{
+		*var      = (Var *) right;
+		*constant = (Const *) left;
+		opno      = get_commutator(opno);
+	}
+	else
+		return NULL;
+
+	/* Only builtin operators on regular columns and non-NULL constants of the same type. */
+	if (!OidIsValid(opno) || opno >= FirstNormalObjectId ||
+		(*var)->varattno <= 0 || (*var)->varlevelsup != 0 ||
+		(*constant)->constisnull || (*var)->vartype != (*constant)->consttype)
+		return NULL;
+
+	Oid lefttype;
+	Oid righttype;
+	op_input_types(opno, &lefttype, &righttype);
+	if (lefttype != (*var)->vartype || righttype != (*var)->vartype)
+		return NULL;
+
+	char *opname  = get_opname(opno);
+	bool is_equality = strcmp(opname, "=") == 0 || strcmp(opname, "<>") == 0;
+	bool is_ordering = strcmp(opname, "<") == 0 || strcmp(opname, "<=") == 0 ||
+	                   strcmp(opname, ">") == 0 || strcmp(opname, ">=") == 0;
+	switch ((*var)->vartype)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case OIDOID:
+			return (is_equality || is_ordering) ? opname : NULL;
+		case BOOLOID:
+		case TEXTOID:
+			/* Text ordering depends on collation, so only equality is evaluated. */
+			return is_equality ? opname : NULL;
+		default:
+			return NULL;
+	}
+}
+
+/*
+ * ybcGetTopN
+ *		Returns the limit and the sort keys of "SELECT ... FROM rel ORDER BY ... LIMIT n" if
+ *		YugaByte could return only the first n rows of every tablet, or NIL otherwise. The
+ *		list holds the limit followed by three Integer nodes per sort key: the attribute
+ *		number, whether the key is descending and whether NULLs come first.
+ *
+ *		Postgres still sorts the rows returned and applies the limit, so it is enough that
+ *		every tablet returns its own first rows. This is correct only if all rows returned
+ *		by YugaByte are part of the result, so the scan must have no conditions. Sort keys
+ *		must be integer columns, which YugaByte orders the same way as Postgres.
+ */
+static List *
+ybcGetTopN(PlannerInfo *root, RelOptInfo *baserel, List *scan_clauses)
+{
+	List     *top_n = NIL;
+	ListCell *lc;
+
+	/* The planner has already ruled out grouping, aggregates and SRFs for limit_tuples. */
+	if (root->limit_tuples < 1 || root->sort_pathkeys == NIL || scan_clauses != NIL ||
+	    root->parse->commandType != CMD_SELECT || root->parse->rowMarks != NIL ||
+	    bms_membership(root->all_baserels) != BMS_SINGLETON)
+		return NIL;
+
+	top_n = lappend(top_n, makeInteger((long) root->limit_tuples));
+	foreach(lc, root->sort_pathkeys)
+	{
+		PathKey  *pathkey = (PathKey *) lfirst(lc);
+		Var      *var     = NULL;
+		ListCell *lc_member;
+
+		if (pathkey->pk_opfamily != INTEGER_BTREE_FAM_OID &&
+		    pathkey->pk_opfamily != OID_BTREE_FAM_OID)
+			return NIL;
+
+		foreach(lc_member, pathkey->pk_eclass->ec_members)
+		{
+			EquivalenceMember *member = (EquivalenceMember *) lfirst(lc_member);
+			Var               *member_var = (Var *) member->em_expr;
+			if (IsA(member_var, Var) && member_var->varno == baserel->relid &&
+			    member_var->varattno > 0 && member_var->varlevelsup == 0)
+			{
+				var = member_var;
+				break;
+			}
+		}
+		if (var == NULL)
+			return NIL;
+
+		switch (var->vartype)
+		{
+			case INT2OID:
+			case INT4OID:
+			case INT8OID:
+			case OIDOID:
+				break;
+			default:
+				return NIL;
+		}
+
+		top_n = lappend(top_n, makeInteger(var->varattno));
+		top_n = lappend(top_n, makeInteger(pathkey->pk_strategy == BTGreaterStrategyNumber));
+		top_n = lappend(top_n, makeInteger(pathkey->pk_nulls_first));
+	}
+	return top_n;
+}
+
+/*
+ * ybcIsGroupingType
+ *		Whether YugaByte groups and counts values of the type the same way as Postgres.
+ *		YugaByte compares the values without collations, which matches the equality of text
+ *		in Postgres.
+ */
+static bool
+ybcIsGroupingType(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case OIDOID:
+		case BOOLOID:
+		case TEXTOID:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * ybcGetPushdownAggName
+ *		Returns name of the aggregate if YugaByte could compute it for every group of the scan,
+ *		or NULL otherwise. The partial results of the tablets are merged by pggate, which is
+ *		possible for COUNT, SUM, MIN and MAX of regular columns. SUM, MIN and MAX are computed
+ *		only for integer columns, so that the results have the types Postgres declares.
+ */
+static char *
+ybcGetPushdownAggName(Aggref *aggref, Index relid)
+{
+	if (aggref->aggfnoid >= FirstNormalObjectId || aggref->aggkind != AGGKIND_NORMAL ||
+	    aggref->aggsplit != AGGSPLIT_SIMPLE || aggref->agglevelsup != 0 ||
+	    aggref->aggdirectargs != NIL || aggref->aggdistinct != NIL ||
+	    aggref->aggorder != NIL || aggref->aggfilter != NULL)
+		return NULL;
+
+	char *aggname = get_func_name(aggref->aggfnoid);
+	bool is_count = strcmp(aggname, "count") == 0;
+	if (aggref->aggstar)
+		return is_count ? aggname : NULL;
+
+	if (list_length(aggref->args) != 1)
+		return NULL;
+	Var *var = (Var *) ((TargetEntry *) linitial(aggref->args))->expr;
+	if (!IsA(var, Var) || var->varno != relid || var->varattno <= 0 || var->varlevelsup != 0)
+		return NULL;
+
+	if (is_count)
+		return ybcIsGroupingType(var->vartype) ? aggname : NULL;
+	if (strcmp(aggname, "sum") != 0 && strcmp(aggname, "min") != 0 &&
+	    strcmp(aggname, "max") != 0)
+		return NULL;
+	switch (var->vartype)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+			return aggname;
+		default:
+			return NULL;
+	}
+}
+
+/*
+ * ybcGetForeignUpperPaths
+ *		Add a path for "SELECT ... FROM rel GROUP BY ..." that lets YugaByte compute the
+ *		aggregates, so that every tablet returns one row per group instead of all of its rows.
+ *		Every row read is aggregated, so the scan must have no conditions. The targets must
+ *		be computed from group-by columns and aggregates accepted by ybcGetPushdownAggName,
+ *		which are the columns returned by the scan.
+ */
+static void
+ybcGetForeignUpperPaths(PlannerInfo *root,
+						UpperRelationKind stage,
+						RelOptInfo *input_rel,
+						RelOptInfo *output_rel,
+						void *extra)
+{
+	Query         *parse          = root->parse;
+	List          *group_by       = NIL;
+	List          *scan_exprs     = NIL;
+	bool          has_aggregates  = false;
+	RangeTblEntry *rte;
+	ListCell      *lc;
+
+	if (stage != UPPERREL_GROUP_AGG || output_rel->pathlist == NIL ||
+	    input_rel->reloptkind != RELOPT_BASEREL || input_rel->baserestrictinfo != NIL ||
+	    parse->commandType != CMD_SELECT || parse->rowMarks != NIL ||
+	    parse->groupingSets != NIL || parse->hasTargetSRFs || root->hasHavingQual ||
+	    bms_membership(root->all_baserels) != BMS_SINGLETON)
+		return;
+
+	rte = planner_rt_fetch(input_rel->relid, root);
+	if (rte->rtekind != RTE_RELATION || rte->inh || !IsYBRelationById(rte->relid))
+		return;
+
+	/* Get the group-by columns. */
+	foreach(lc, parse->groupClause)
+	{
+		SortGroupClause *clause = (SortGroupClause *) lfirst(lc);
+		Var             *var    = (Var *) get_sortgroupclause_expr(clause,
+		                                                           root->processed_tlist);
+		if (!IsA(var, Var) || var->varno != input_rel->relid || var->varattno <= 0 ||
+		    var->varlevelsup != 0 || !ybcIsGroupingType(var->vartype))
+			return;
+		group_by = lappend_int(group_by, var->varattno);
+	}
+
+	/* YugaByte returns only group-by columns and aggregates, Postgres computes the rest. */
+	foreach(lc, output_rel->reltarget->exprs)
+	{
+		Node     *target = (Node *) lfirst(lc);
+		List     *exprs  = IsA(target, Var) || IsA(target, Aggref) ?
+		                   list_make1(target) :
+		                   pull_var_clause(target,
+		                                   PVC_INCLUDE_AGGREGATES | PVC_RECURSE_PLACEHOLDERS);
+		ListCell *lc_expr;
+		foreach(lc_expr, exprs)
+		{
+			Expr *expr = (Expr *) lfirst(lc_expr);
+			if (IsA(expr, Aggref))
+			{
+				if (ybcGetPushdownAggName((Aggref *) expr, input_rel->relid) == NULL)
+					return;
+				has_aggregates = true;
+			}
+			else if (!IsA(expr, Var) || ((Var *) expr)->varno != input_rel->relid ||
+			         !list_member_int(group_by, ((Var *) expr)->varattno))
+				return;
+		}
+		scan_exprs = list_concat(scan_exprs, exprs);
+	}
+	if (!has_aggregates)
+		return;
+
+	/*
+	 * All rows are still read, but only the groups are sent to Postgres, which saves the cost
+	 * of the local aggregation.
+	 */
+	Cost startup_cost;
+	Cost total_cost;
+	ybcCostEstimate(input_rel, YBC_FULL_SCAN_SELECTIVITY, &startup_cost, &total_cost);
+	add_path(output_rel,
+	         (Path *) create_foreignscan_path(root,
+	                                          output_rel,
+	                                          output_rel->reltarget,
+	                                          ((Path *) linitial(output_rel->pathlist))->rows,
+	                                          total_cost,
+	                                          total_cost,
+	                                          NIL,  /* no pathkeys */
+	                                          NULL, /* no outer rel either */
+	                                          NULL, /* no extra plan */
+	                                          list_make2(group_by, scan_exprs)));
+}
+
+/*
+ * ybcGetForeignGroupingPlan
+ *		Create a ForeignScan plan node for the path of ybcGetForeignUpperPaths. The scan has
+ *		no scan relation, its rows are the group-by columns and aggregates of fdw_scan_tlist.
+ */
+static ForeignScan *
+ybcGetForeignGroupingPlan(ForeignPath *best_path,
+						  List *tlist,
+						  Plan *outer_plan)
+{
+	List *group_by       = linitial(best_path->fdw_private);
+	List *fdw_scan_tlist = add_to_flat_tlist(NIL, lsecond(best_path->fdw_private));
+
+	return make_foreignscan(tlist,  /* target list */
+	                        NIL,    /* no conditions, see ybcGetForeignUpperPaths */
+	                        0,      /* no scan relation, the table is taken from fs_relids */
+	                        NIL,    /* no expressions YB may evaluate */
+	                        list_make3(NIL, NIL, group_by),  /* fdw_private data for YB */
+	                        fdw_scan_tlist, /* group-by columns and aggregates */
+	                        NIL,    /* no conditions to recheck */
+	                        outer_plan);
+}
+
 /*
  * ybcGetForeignPlan
  *		Create a ForeignScan plan node for scanning the foreign table
@@ -150,8 +504,24 @@ ybcGetForeignPlan(PlannerInfo *root,
 	Index          scan_relid     = baserel->relid;
 	ListCell       *lc;
 
+	if (IS_UPPER_REL(baserel))
+		return ybcGetForeignGroupingPlan(best_path, tlist, outer_plan);
+
 	scan_clauses = extract_actual_clauses(scan_clauses, false);
 
+	/* Get the scan conditions that YugaByte could evaluate. */
+	List *pushdown_exprs = NIL;
+	foreach(lc, scan_clauses)
+	{
+		Expr  *expr = (Expr *) lfirst(lc);
+		Var   *var;
+		Const *constant;
+		if (IsA(expr, OpExpr) &&
+		    ybcGetPushdownOpName((OpExpr *) expr, &var, &constant) != NULL &&
+		    var->varno == scan_relid)
+			pushdown_exprs = lappend(pushdown_exprs, expr);
+	}
+
 	/* Get the target columns that need to be retrieved from YugaByte */
 	foreach(lc, baserel->reltarget->exprs)
 	{
@@ -214,11 +584,12 @@ ybcGetForeignPlan(PlannerInfo *root,
 	}
 
 	/* Create the ForeignScan node */
+	List *top_n = ybcGetTopN(root, baserel, scan_clauses);
 	return make_foreignscan(tlist,  /* target list */
 	                        scan_clauses,
 	                        scan_relid,
-	                        NIL,    /* expressions YB may evaluate (none) */
-	                        target_attrs,  /* fdw_private data for YB */
+	                        pushdown_exprs, /* expressions YB may evaluate */
+	                        list_make2(target_attrs, top_n),  /* fdw_private data for YB */
 	                        NIL,    /* custom YB target list (none for now) */
 	                        NIL,    /* custom YB target list (none for now) */
 	                        outer_plan);
@@ -227,6 +598,19 @@ ybcGetForeignPlan(PlannerInfo *root,
 /* ------------------------------------------------------------------------- */
 /*  Scanning functions */
 
+/* Hash codes of the rows of hash partitioned tables are in [0, YBC_MAX_HASH_CODE]. */
+#define YBC_MAX_HASH_CODE 0xFFFF
+
+/*
+ * Shared state of a scan divided among parallel workers. The table is divided into ranges of
+ * hash codes, that the leader and the workers claim one by one until none is left.
+ */
+typedef struct YbFdwParallelScanState
+{
+	uint32           num_chunks;
+	pg_atomic_uint32 next_chunk;
+} YbFdwParallelScanState;
+
 /*
  * FDW-specific information for ForeignScanState.fdw_state.
  */
@@ -235,34 +619,103 @@ typedef struct YbFdwExecState
 	/* The handle for the internal YB Select statement. */
 	YBCPgStatement	handle;
 	ResourceOwner	stmt_owner;
+
+	/* The table scanned, opened by ybcBeginForeignScan if the plan has no scan relation. */
+	Relation		relation;
+
+	/* Whether the scan has started, used by scans that are not divided among workers. */
+	bool			started;
+
+	/* Shared state of a parallel scan, NULL if this process reads the whole table. */
+	YbFdwParallelScanState *pscan;
 } YbFdwExecState;
 
 /*
- * ybcBeginForeignScan
- *		Initiate access to the Yugabyte by allocating a Select handle.
+ * ybcSetGroupingTargets
+ *		Set the group-by columns and the targets of a scan that returns the groups of the table,
+ *		which are the group-by columns and the aggregates of fdw_scan_tlist.
  */
 static void
-ybcBeginForeignScan(ForeignScanState *node, int eflags)
+ybcSetGroupingTargets(ForeignScan *foreignScan, YbFdwExecState *ybc_state)
+{
+	List     *group_by = lthird(foreignScan->fdw_private);
+	Index    relid     = bms_singleton_member(foreignScan->fs_relids);
+	ListCell *lc;
+
+	foreach(lc, group_by)
+	{
+		Form_pg_attribute attr       = TupleDescAttr(RelationGetDescr(ybc_state->relation),
+		                                             lfirst_int(lc) - 1);
+		YBCPgTypeAttrs    type_attrs = { attr->atttypmod };
+		HandleYBStmtStatusWithOwner(YBCPgSelectAppendGroupBy(ybc_state->handle,
+		                                                     YBCNewColumnRef(ybc_state->handle,
+		                                                                     attr->attnum,
+		                                                                     attr->atttypid,
+		                                                                     &type_attrs)),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+	}
+
+	/* Rows are fetched into the scan slot, which has one column per entry of fdw_scan_tlist. */
+	foreach(lc, foreignScan->fdw_scan_tlist)
+	{
+		Expr      *expr  = ((TargetEntry *) lfirst(lc))->expr;
+		YBCPgExpr target = NULL;
+		if (IsA(expr, Var))
+		{
+			Var            *var       = (Var *) expr;
+			YBCPgTypeAttrs type_attrs = { var->vartypmod };
+			target = YBCNewColumnRef(ybc_state->handle, var->varattno, var->vartype, &type_attrs);
+		}
+		else
+		{
+			Aggref *aggref  = (Aggref *) expr;
+			char   *aggname = ybcGetPushdownAggName(aggref, relid);
+			Assert(aggname != NULL);
+			HandleYBStmtStatusWithOwner(YBCPgNewOperator(ybc_state->handle,
+			                                             aggname,
+			                                             YBCDataTypeFromOidMod(InvalidAttrNumber,
+			                                                                   aggref->aggtype),
+			                                             &target),
+			                            ybc_state->handle,
+			                            ybc_state->stmt_owner);
+			if (!aggref->aggstar)
+			{
+				Var            *var       = (Var *) ((TargetEntry *) linitial(aggref->args))->expr;
+				YBCPgTypeAttrs type_attrs = { var->vartypmod };
+				YBCPgExpr      arg        = YBCNewColumnRef(ybc_state->handle,
+				                                            var->varattno,
+				                                            var->vartype,
+				                                            &type_attrs);
+				HandleYBStmtStatusWithOwner(YBCPgOperatorAppendArg(target, arg),
+				                            ybc_state->handle,
+				                            ybc_state->stmt_owner);
+			}
+		}
+		HandleYBStmtStatusWithOwner(YBCPgDmlAppendTarget(ybc_state->handle, target),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+	}
+}
+
+/*
+ * ybcNewSelect
+ *		Allocate the Select handle with the targets and the conditions of the scan.
+ */
+static void
+ybcNewSelect(ForeignScanState *node, YbFdwExecState *ybc_state)
 {
 	ForeignScan *foreignScan = (ForeignScan *) node->ss.ps.plan;
 	EState      *estate      = node->ss.ps.state;
-	Relation    relation     = node->ss.ss_currentRelation;
+	Relation    relation     = ybc_state->relation;
 	TupleDesc   tupdesc      = RelationGetDescr(relation);
 
 	/* Planning function above should ensure target list is set */
-	List *target_attrs = foreignScan->fdw_private;
-
-	YbFdwExecState *ybc_state = NULL;
-	ListCell       *lc;
-
-	/* Do nothing in EXPLAIN (no ANALYZE) case.  node->fdw_state stays NULL. */
-	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
-		return;
+	List *target_attrs = linitial(foreignScan->fdw_private);
+	List *top_n        = lsecond(foreignScan->fdw_private);
 
-	/* Allocate and initialize YB scan state. */
-	ybc_state = (YbFdwExecState *) palloc0(sizeof(YbFdwExecState));
+	ListCell *lc;
 
-	node->fdw_state = (void *) ybc_state;
 	HandleYBStatus(YBCPgNewSelect(ybc_pg_session,
 	                              YBCGetDatabaseOid(relation),
 	                              RelationGetRelid(relation),
@@ -273,6 +726,17 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 	ResourceOwnerRememberYugaByteStmt(CurrentResourceOwner, ybc_state->handle);
 	ybc_state->stmt_owner = CurrentResourceOwner;
 
+	/* Let YugaByte compute the aggregates (see ybcGetForeignUpperPaths). */
+	if (foreignScan->scan.scanrelid == 0)
+	{
+		ybcSetGroupingTargets(foreignScan, ybc_state);
+		HandleYBStmtStatusWithOwner(YBCPgSetCatalogCacheVersion(ybc_state->handle,
+		                                                        yb_catalog_cache_version),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+		return;
+	}
+
 	/* Set scan targets. */
 	bool has_targets = false;
 	foreach(lc, target_attrs)
@@ -335,16 +799,167 @@ ybcBeginForeignScan(ForeignScanState *node, int eflags)
 		}
 	}
 
+	/* Set the scan conditions that YugaByte evaluates for every row read. */
+	foreach(lc, foreignScan->fdw_exprs)
+	{
+		OpExpr *opexpr = (OpExpr *) lfirst(lc);
+		Var    *var;
+		Const  *constant;
+		char   *opname = ybcGetPushdownOpName(opexpr, &var, &constant);
+		Assert(opname != NULL);
+
+		YBCPgTypeAttrs type_attrs = { var->vartypmod };
+		YBCPgExpr      condition  = NULL;
+		HandleYBStmtStatusWithOwner(YBCPgNewOperator(ybc_state->handle,
+		                                             opname,
+		                                             YBCDataTypeFromOidMod(InvalidAttrNumber,
+		                                                                   BOOLOID),
+		                                             &condition),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+		HandleYBStmtStatusWithOwner(YBCPgOperatorAppendArg(condition,
+		                                                   YBCNewColumnRef(ybc_state->handle,
+		                                                                   var->varattno,
+		                                                                   var->vartype,
+		                                                                   &type_attrs)),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+		HandleYBStmtStatusWithOwner(YBCPgOperatorAppendArg(condition,
+		                                                   YBCNewConstant(ybc_state->handle,
+		                                                                  constant->consttype,
+		                                                                  constant->constvalue,
+		                                                                  false /* is_null */)),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+		HandleYBStmtStatusWithOwner(YBCPgSelectAppendWhere(ybc_state->handle, condition),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+	}
+
+	/* Let every tablet return only its first rows (see ybcGetTopN). */
+	if (top_n != NIL)
+	{
+		for (int i = 1; i + 2 < list_length(top_n); i += 3)
+		{
+			AttrNumber        attnum = intVal(list_nth(top_n, i));
+			Form_pg_attribute attr   = TupleDescAttr(tupdesc, attnum - 1);
+
+			YBCPgTypeAttrs type_attrs = { attr->atttypmod };
+			YBCPgExpr      expr       = YBCNewColumnRef(ybc_state->handle,
+			                                            attnum,
+			                                            attr->atttypid,
+			                                            &type_attrs);
+			HandleYBStmtStatusWithOwner(YBCPgSelectAppendOrderBy(ybc_state->handle,
+			                                                     expr,
+			                                                     intVal(list_nth(top_n, i + 1)),
+			                                                     intVal(list_nth(top_n, i + 2))),
+			                            ybc_state->handle,
+			                            ybc_state->stmt_owner);
+		}
+		HandleYBStmtStatusWithOwner(YBCPgSelectSetTopNLimit(ybc_state->handle,
+		                                                    intVal(linitial(top_n))),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+	}
+
 	/* Set the current syscatalog version (will check that we are up to date) */
 	HandleYBStmtStatusWithOwner(YBCPgSetCatalogCacheVersion(ybc_state->handle,
 	                                                        yb_catalog_cache_version),
 	                            ybc_state->handle,
 	                            ybc_state->stmt_owner);
+}
+
+/*
+ * ybcStartNextScan
+ *		Execute the select of the next part of the table that this process reads. A scan that
+ *		is not divided among parallel workers has one part, the whole table. Returns false
+ *		when nothing is left to read.
+ */
+static bool
+ybcStartNextScan(ForeignScanState *node, YbFdwExecState *ybc_state)
+{
+	YbFdwParallelScanState *pscan = ybc_state->pscan;
+	uint32                 chunk  = 0;
+
+	if (pscan == NULL)
+	{
+		if (ybc_state->started)
+			return false;
+	}
+	else
+	{
+		chunk = pg_atomic_fetch_add_u32(&pscan->next_chunk, 1);
+		if (chunk >= pscan->num_chunks)
+			return false;
+	}
+	ybc_state->started = true;
+
+	ybcNewSelect(node, ybc_state);
+	if (pscan != NULL)
+	{
+		uint64 num_hash_codes = YBC_MAX_HASH_CODE + 1;
+		HandleYBStmtStatusWithOwner(YBCPgSelectSetHashCodeRange(ybc_state->handle,
+		                                                        chunk * num_hash_codes /
+		                                                        pscan->num_chunks,
+		                                                        (chunk + 1) * num_hash_codes /
+		                                                        pscan->num_chunks - 1),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+	}
 
 	/* Execute the select statement. */
 	HandleYBStmtStatusWithOwner(YBCPgExecSelect(ybc_state->handle),
 	                            ybc_state->handle,
 	                            ybc_state->stmt_owner);
+	return true;
+}
+
+/*
+ * ybcBeginForeignScan
+ *		Initiate access to the Yugabyte by allocating a Select handle.
+ */
+static void
+ybcBeginForeignScan(ForeignScanState *node, int eflags)
+{
+	YbFdwExecState *ybc_state = NULL;
+
+	/* Do nothing in EXPLAIN (no ANALYZE) case.  node->fdw_state stays NULL. */
+	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+		return;
+
+	/* Allocate and initialize YB scan state. */
+	ybc_state = (YbFdwExecState *) palloc0(sizeof(YbFdwExecState));
+	node->fdw_state = (void *) ybc_state;
+
+	/* A scan with no scan relation reads the only relation of the query. */
+	ForeignScan *foreignScan = (ForeignScan *) node->ss.ps.plan;
+	if (foreignScan->scan.scanrelid > 0)
+		ybc_state->relation = node->ss.ss_currentRelation;
+	else
+		ybc_state->relation = ExecOpenScanRelation(node->ss.ps.state,
+		                                           bms_singleton_member(foreignScan->fs_relids),
+		                                           eflags);
+
+	/*
+	 * A parallel scan claims its first part when it is iterated, after the shared state is
+	 * set up.
+	 */
+	if (!node->ss.ps.plan->parallel_aware)
+		ybcStartNextScan(node, ybc_state);
+}
+
+static void
+ybcFreeStatementObject(YbFdwExecState* yb_fdw_exec_state)
+{
+	/* If yb_fdw_exec_state is NULL, we are in EXPLAIN; nothing to do */
+	if (yb_fdw_exec_state != NULL && yb_fdw_exec_state->handle != NULL)
+	{
+		HandleYBStatus(YBCPgDeleteStatement(yb_fdw_exec_state->handle));
+		ResourceOwnerForgetYugaByteStmt(yb_fdw_exec_state->stmt_owner,
+										yb_fdw_exec_state->handle);
+		yb_fdw_exec_state->handle = NULL;
+		yb_fdw_exec_state->stmt_owner = NULL;
+	}
 }
 
 /*
@@ -367,48 +982,41 @@ ybcIterateForeignScan(ForeignScanState *node)
 	bool            *isnull = slot->tts_isnull;
 	YBCPgSysColumns syscols;
 
-	/* Fetch one row. */
-	HandleYBStmtStatusWithOwner(YBCPgDmlFetch(ybc_state->handle,
-	                                          tupdesc->natts,
-	                                          (uint64_t *) values,
-	                                          isnull,
-	                                          &syscols,
-	                                          &has_data),
-	                            ybc_state->handle,
-	                            ybc_state->stmt_owner);
-
-	/* If we have result(s) update the tuple slot. */
-	if (has_data)
+	while (ybc_state->handle != NULL || ybcStartNextScan(node, ybc_state))
 	{
-		HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
-		if (syscols.oid != InvalidOid)
+		/* Fetch one row. */
+		HandleYBStmtStatusWithOwner(YBCPgDmlFetch(ybc_state->handle,
+		                                          tupdesc->natts,
+		                                          (uint64_t *) values,
+		                                          isnull,
+		                                          &syscols,
+		                                          &has_data),
+		                            ybc_state->handle,
+		                            ybc_state->stmt_owner);
+
+		/* If we have result(s) update the tuple slot. */
+		if (has_data)
 		{
-			HeapTupleSetOid(tuple, syscols.oid);
-		}
+			HeapTuple tuple = heap_form_tuple(tupdesc, values, isnull);
+			if (syscols.oid != InvalidOid)
+			{
+				HeapTupleSetOid(tuple, syscols.oid);
+			}
+
+			slot = ExecStoreTuple(tuple, slot, InvalidBuffer, false);
 
-		slot = ExecStoreTuple(tuple, slot, InvalidBuffer, false);
+			/* Setup special columns in the slot */
+			slot->tts_ybctid = PointerGetDatum(syscols.ybctid);
+			break;
+		}
 
-		/* Setup special columns in the slot */
-		slot->tts_ybctid = PointerGetDatum(syscols.ybctid);
+		/* This part of the table is read, go on with the next one. */
+		ybcFreeStatementObject(ybc_state);
 	}
 
 	return slot;
 }
 
-static void
-ybcFreeStatementObject(YbFdwExecState* yb_fdw_exec_state)
-{
-	/* If yb_fdw_exec_state is NULL, we are in EXPLAIN; nothing to do */
-	if (yb_fdw_exec_state != NULL && yb_fdw_exec_state->handle != NULL)
-	{
-		HandleYBStatus(YBCPgDeleteStatement(yb_fdw_exec_state->handle));
-		ResourceOwnerForgetYugaByteStmt(yb_fdw_exec_state->stmt_owner,
-										yb_fdw_exec_state->handle);
-		yb_fdw_exec_state->handle = NULL;
-		yb_fdw_exec_state->stmt_owner = NULL;
-	}
-}
-
 /*
  * fileReScanForeignScan
  *		Rescan table, possibly with new parameters
@@ -421,8 +1029,13 @@ ybcReScanForeignScan(ForeignScanState *node)
 	/* Clear (delete) the previous select */
 	ybcFreeStatementObject(ybc_state);
 
-	/* Re-allocate and execute the select. */
-	ybcBeginForeignScan(node, 0 /* eflags */);
+	/*
+	 * Re-allocate and execute the select. A parallel scan claims the parts of the table again
+	 * after ybcReInitializeDSMForeignScan resets the shared state.
+	 */
+	ybc_state->started = false;
+	if (!node->ss.ps.plan->parallel_aware)
+		ybcStartNextScan(node, ybc_state);
 }
 
 /*
@@ -434,6 +1047,74 @@ ybcEndForeignScan(ForeignScanState *node)
 {
 	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
 	ybcFreeStatementObject(ybc_state);
+
+	/* Close the relation opened by ybcBeginForeignScan. */
+	if (ybc_state != NULL && ((Scan *) node->ss.ps.plan)->scanrelid == 0)
+		ExecCloseScanRelation(ybc_state->relation);
+}
+
+/* ------------------------------------------------------------------------- */
+/*  Parallel scan functions */
+
+/*
+ * ybcIsForeignScanParallelSafe
+ *		Whether the scan of the table could be divided among parallel workers. Only hash
+ *		partitioned user tables are divided, into ranges of hash codes. Workers read at the
+ *		read time of the leader, see InitializeParallelDSM.
+ */
+static bool
+ybcIsForeignScanParallelSafe(PlannerInfo *root, RelOptInfo *rel, RangeTblEntry *rte)
+{
+	YBCPgTableDesc ybc_table_desc      = NULL;
+	bool           is_hash_partitioned = false;
+
+	if (!YBCIsParallelScanEnabled() || rte->relid < FirstNormalObjectId)
+		return false;
+
+	HandleYBStatus(YBCPgGetTableDesc(ybc_pg_session, MyDatabaseId, rte->relid, &ybc_table_desc));
+	HandleYBTableDescStatus(YBCPgIsHashPartitionedTable(ybc_table_desc, &is_hash_partitioned),
+	                        ybc_table_desc);
+	HandleYBStatus(YBCPgDeleteTableDesc(ybc_table_desc));
+	return is_hash_partitioned;
+}
+
+static Size
+ybcEstimateDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt)
+{
+	return sizeof(YbFdwParallelScanState);
+}
+
+/*
+ * ybcInitializeDSMForeignScan
+ *		Divide the table into ranges of hash codes, several per participant, so the ones that
+ *		read faster claim more of them.
+ */
+static void
+ybcInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt, void *coordinate)
+{
+	YbFdwExecState         *ybc_state = (YbFdwExecState *) node->fdw_state;
+	YbFdwParallelScanState *pscan     = (YbFdwParallelScanState *) coordinate;
+
+	pscan->num_chunks = Min((uint32) (pcxt->nworkers + 1) * YBCGetParallelScanChunksPerWorker(),
+	                        YBC_MAX_HASH_CODE + 1);
+	pg_atomic_init_u32(&pscan->next_chunk, 0);
+	ybc_state->pscan = pscan;
+}
+
+static void
+ybcReInitializeDSMForeignScan(ForeignScanState *node, ParallelContext *pcxt, void *coordinate)
+{
+	YbFdwParallelScanState *pscan = (YbFdwParallelScanState *) coordinate;
+
+	pg_atomic_write_u32(&pscan->next_chunk, 0);
+}
+
+static void
+ybcInitializeWorkerForeignScan(ForeignScanState *node, shm_toc *toc, void *coordinate)
+{
+	YbFdwExecState *ybc_state = (YbFdwExecState *) node->fdw_state;
+
+	ybc_state->pscan = (YbFdwParallelScanState *) coordinate;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -456,10 +1137,17 @@ ybc_fdw_handler()
 	fdwroutine->ReScanForeignScan  = ybcReScanForeignScan;
 	fdwroutine->EndForeignScan     = ybcEndForeignScan;
 
+	fdwroutine->GetForeignUpperPaths = ybcGetForeignUpperPaths;
+
+	fdwroutine->IsForeignScanParallelSafe   = ybcIsForeignScanParallelSafe;
+	fdwroutine->EstimateDSMForeignScan      = ybcEstimateDSMForeignScan;
+	fdwroutine->InitializeDSMForeignScan    = ybcInitializeDSMForeignScan;
+	fdwroutine->ReInitializeDSMForeignScan  = ybcReInitializeDSMForeignScan;
+	fdwroutine->InitializeWorkerForeignScan = ybcInitializeWorkerForeignScan;
+
 	/* TODO: These are optional but we should support them eventually. */
 	/* fdwroutine->ExplainForeignScan = ybcExplainForeignScan; */
 	/* fdwroutine->AnalyzeForeignTable = ybcAnalyzeForeignTable; */
-	/* fdwroutine->IsForeignScanParallelSafe = ybcIsForeignScanParallelSafe; */
 
 	PG_RETURN_POINTER(fdwroutine);
 }
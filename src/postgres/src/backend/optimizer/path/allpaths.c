@@ -683,8 +683,14 @@ set_rel_consider_parallel(PlannerInfo *root, RelOptInfo *rel,
 
 			if (IsYugaByteEnabled())
 			{
-				/* If YB scan, disable parallelization for now. */
-				return;
+				/*
+				 * YB scans are parallel only if the YB FDW could divide them
+				 * among the workers.
+				 */
+				if (!IsYBRelationById(rte->relid) ||
+					!rel->fdwroutine->IsForeignScanParallelSafe ||
+					!rel->fdwroutine->IsForeignScanParallelSafe(root, rel, rte))
+					return;
 			}
 
 			/*
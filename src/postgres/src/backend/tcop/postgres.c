@@ -3690,7 +3690,7 @@ static void YBRefreshCache()
 
 	/* Clear and reload system catalog caches. */
 	ResetCatalogCaches();
-	YBPreloadRelCache();
+	YBPreloadRelCache(catalog_master_version);
 
 	/* Also invalidate the pggate cache. */
 	YBCPgInvalidateCache(ybc_pg_session);
@@ -33,6 +33,7 @@
 #include "access/htup_details.h"
 #include "access/sysattr.h"
 #include "access/xact.h"
+#include "access/ybcam.h"
 #include "catalog/pg_collation.h"
 #include "catalog/pg_constraint.h"
 #include "catalog/pg_operator.h"
@@ -47,6 +48,7 @@
 #include "storage/bufmgr.h"
 #include "utils/acl.h"
 #include "utils/builtins.h"
+#include "utils/datum.h"
 #include "utils/fmgroids.h"
 #include "utils/guc.h"
 #include "utils/inval.h"
@@ -242,6 +244,8 @@ static void ri_ReportViolation(const RI_ConstraintInfo *riinfo,
 				   Relation pk_rel, Relation fk_rel,
 				   HeapTuple violator, TupleDesc tupdesc,
 				   int queryno) pg_attribute_noreturn();
+static bool YBBatchForeignKeyCheck(const RI_ConstraintInfo *riinfo,
+					   Relation fk_rel, Relation pk_rel, HeapTuple new_row);
 
 
 /* ----------
@@ -387,6 +391,16 @@ RI_FKey_check(TriggerData *trigdata)
 			break;
 	}
 
+	/*
+	 * In YugaByte, the referenced keys of a PK table could be looked up in
+	 * batches, see YBFlushForeignKeyChecks().
+	 */
+	if (YBBatchForeignKeyCheck(riinfo, fk_rel, pk_rel, new_row))
+	{
+		heap_close(pk_rel, RowShareLock);
+		return PointerGetDatum(NULL);
+	}
+
 	if (SPI_connect() != SPI_OK_CONNECT)
 		elog(ERROR, "SPI_connect failed");
 
@@ -3207,3 +3221,190 @@ RI_FKey_trigger_type(Oid tgfoid)
 
 	return RI_TRIGGER_NONE;
 }
+
+
+/* ----------
+ * YugaByte batched foreign key checks
+ *
+ *	Checks of foreign keys that reference the whole primary key of a YugaByte
+ *	table are collected per constraint, and the referenced keys of a batch
+ *	are fetched at once by YBCFetchTuplesByPrimaryKey(), which reads the keys
+ *	of the same tablet in one RPC.  A batch is verified when it is full, and
+ *	the remaining ones when the after trigger events of the statement have
+ *	been fired.  Violations are reported as by ri_PerformCheck().
+ * ----------
+ */
+typedef struct YBForeignKeyCheckBatch
+{
+	const RI_ConstraintInfo *riinfo;
+	int			count;
+	Datum	   *values;			/* nkeys referenced key values for each check */
+	HeapTuple  *rows;			/* the referencing row of each check */
+} YBForeignKeyCheckBatch;
+
+/* Pending batches, allocated in yb_fk_check_context. */
+static MemoryContext yb_fk_check_context = NULL;
+static List *yb_fk_check_batches = NIL;
+
+static void
+YBForgetForeignKeyChecks(void *arg)
+{
+	yb_fk_check_context = NULL;
+	yb_fk_check_batches = NIL;
+}
+
+/*
+ * Whether the foreign key references the primary key of pk_rel, with the same
+ * column types on both sides.
+ */
+static bool
+YBReferencesPrimaryKey(const RI_ConstraintInfo *riinfo, Relation fk_rel, Relation pk_rel)
+{
+	Bitmapset  *pkattrs = RelationGetIndexAttrBitmap(pk_rel, INDEX_ATTR_BITMAP_PRIMARY_KEY);
+	bool		result = bms_num_members(pkattrs) == riinfo->nkeys;
+
+	for (int i = 0; result && i < riinfo->nkeys; i++)
+	{
+		result = bms_is_member(riinfo->pk_attnums[i] - FirstLowInvalidHeapAttributeNumber,
+							   pkattrs) &&
+			RIAttType(pk_rel, riinfo->pk_attnums[i]) == RIAttType(fk_rel, riinfo->fk_attnums[i]);
+	}
+	bms_free(pkattrs);
+	return result;
+}
+
+/*
+ * Look up the referenced keys of the batch and report the first violation.
+ */
+static void
+YBCheckForeignKeyBatch(YBForeignKeyCheckBatch *batch)
+{
+	const RI_ConstraintInfo *riinfo = batch->riinfo;
+	int			count = batch->count;
+	AttrNumber	attnums[RI_MAX_NUMKEYS];
+	FmgrInfo	eq_funcs[RI_MAX_NUMKEYS];
+	Oid			collations[RI_MAX_NUMKEYS];
+	Relation	pk_rel;
+	HeapTuple  *tuples;
+
+	if (count == 0)
+		return;
+
+	/* The checks are consumed even if one of them fails. */
+	batch->count = 0;
+
+	pk_rel = heap_open(riinfo->pk_relid, RowShareLock);
+	for (int i = 0; i < riinfo->nkeys; i++)
+	{
+		attnums[i] = riinfo->pk_attnums[i];
+		fmgr_info(get_opcode(riinfo->pp_eq_oprs[i]), &eq_funcs[i]);
+		collations[i] = TupleDescAttr(RelationGetDescr(pk_rel), attnums[i] - 1)->attcollation;
+	}
+
+	tuples = (HeapTuple *) palloc(count * sizeof(HeapTuple));
+	YBCFetchTuplesByPrimaryKey(pk_rel, count, riinfo->nkeys, attnums, batch->values,
+							   eq_funcs, collations, tuples);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (!HeapTupleIsValid(tuples[i]))
+		{
+			Relation	fk_rel = heap_open(riinfo->fk_relid, AccessShareLock);
+
+			ri_ReportViolation(riinfo, pk_rel, fk_rel, batch->rows[i],
+							   RelationGetDescr(fk_rel), RI_PLAN_CHECK_LOOKUPPK);
+		}
+		heap_freetuple(tuples[i]);
+	}
+	pfree(tuples);
+
+	/* The rows of the batch are not needed anymore. */
+	for (int i = 0; i < count; i++)
+		heap_freetuple(batch->rows[i]);
+
+	heap_close(pk_rel, RowShareLock);
+}
+
+/*
+ * Add the check of new_row to the batch of its constraint instead of checking
+ * it now. Returns false if the check could not be batched.
+ */
+static bool
+YBBatchForeignKeyCheck(const RI_ConstraintInfo *riinfo, Relation fk_rel, Relation pk_rel,
+					   HeapTuple new_row)
+{
+	int			batch_size = YBCGetForeignKeyCheckBatchSize();
+	YBForeignKeyCheckBatch *batch = NULL;
+	MemoryContext oldcontext;
+	ListCell   *lc;
+
+	if (batch_size < 2 || !IsYBRelation(pk_rel) ||
+		!YBReferencesPrimaryKey(riinfo, fk_rel, pk_rel))
+		return false;
+
+	if (yb_fk_check_context == NULL)
+	{
+		MemoryContextCallback *callback;
+
+		yb_fk_check_context = AllocSetContextCreate(TopTransactionContext,
+													"YB foreign key checks",
+													ALLOCSET_DEFAULT_SIZES);
+		callback = MemoryContextAlloc(yb_fk_check_context, sizeof(MemoryContextCallback));
+		callback->func = YBForgetForeignKeyChecks;
+		callback->arg = NULL;
+		MemoryContextRegisterResetCallback(yb_fk_check_context, callback);
+	}
+	oldcontext = MemoryContextSwitchTo(yb_fk_check_context);
+
+	foreach(lc, yb_fk_check_batches)
+	{
+		YBForeignKeyCheckBatch *candidate = (YBForeignKeyCheckBatch *) lfirst(lc);
+
+		if (candidate->riinfo == riinfo)
+		{
+			batch = candidate;
+			break;
+		}
+	}
+	if (batch == NULL)
+	{
+		batch = (YBForeignKeyCheckBatch *) palloc0(sizeof(YBForeignKeyCheckBatch));
+		batch->riinfo = riinfo;
+		batch->values = (Datum *) palloc(batch_size * riinfo->nkeys * sizeof(Datum));
+		batch->rows = (HeapTuple *) palloc(batch_size * sizeof(HeapTuple));
+		yb_fk_check_batches = lappend(yb_fk_check_batches, batch);
+	}
+
+	for (int i = 0; i < riinfo->nkeys; i++)
+	{
+		Form_pg_attribute attr = TupleDescAttr(RelationGetDescr(fk_rel),
+											   riinfo->fk_attnums[i] - 1);
+		bool		isnull;
+		Datum		value = heap_getattr(new_row, riinfo->fk_attnums[i],
+										 RelationGetDescr(fk_rel), &isnull);
+
+		/* ri_NullCheck() made sure the key has no nulls. */
+		Assert(!isnull);
+		batch->values[batch->count * riinfo->nkeys + i] =
+			datumCopy(value, attr->attbyval, attr->attlen);
+	}
+	batch->rows[batch->count++] = heap_copytuple(new_row);
+
+	MemoryContextSwitchTo(oldcontext);
+
+	if (batch->count >= batch_size)
+		YBCheckForeignKeyBatch(batch);
+	return true;
+}
+
+/*
+ * Verify the pending foreign key checks of YugaByte tables.
+ */
+void
+YBFlushForeignKeyChecks(void)
+{
+	ListCell   *lc;
+
+	foreach(lc, yb_fk_check_batches)
+		YBCheckForeignKeyBatch((YBForeignKeyCheckBatch *) lfirst(lc));
+}
@@ -1116,7 +1116,7 @@ equalPartitionDescs(PartitionKey key, PartitionDesc partdesc1,
  *  Note: We assume that any error happening here will fatal so as to not end
  *  up with partial information in the cache.
  */
-void YBPreloadRelCache()
+static void YBLoadRelCache()
 {
 	Relation      relation;
 	Oid           relid;
@@ -1569,6 +1569,29 @@ void YBPreloadRelCache()
 	criticalRelcachesBuilt = true;
 }
 
+/*
+ * Preload the relcache with the catalog data of the given catalog version.
+ * The catalog scans of the preload could be shared with the other backends of
+ * the node that preload their relcache at the same version (see
+ * ysql_catalog_cache_dir), so the version must not be newer than the catalog
+ * data read by the scans.
+ */
+void YBPreloadRelCache(uint64 catalog_version)
+{
+	YBCPgSetCatalogPreloadVersion(ybc_pg_session, catalog_version);
+	PG_TRY();
+	{
+		YBLoadRelCache();
+	}
+	PG_CATCH();
+	{
+		YBCPgSetCatalogPreloadVersion(ybc_pg_session, 0);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	YBCPgSetCatalogPreloadVersion(ybc_pg_session, 0);
+}
+
 /*
  *		RelationBuildDesc
  *
@@ -4116,7 +4139,11 @@ RelationCacheInitializePhase3(void)
 	 */
 	if (needNewCacheFile && IsYugaByteEnabled())
 	{
-		YBPreloadRelCache();
+		uint64 catalog_version = yb_catalog_cache_version;
+		if (catalog_version == YB_CATCACHE_VERSION_UNINITIALIZED)
+			YBCPgGetCatalogMasterVersion(ybc_pg_session,
+			                             (uint64_t *) &catalog_version);
+		YBPreloadRelCache(catalog_version);
 	}
 
 	/*
@@ -1449,7 +1449,7 @@ static struct config_bool ConfigureNamesBool[] =
 		},
 		&XactReadOnly,
 		false,
-		check_transaction_read_only, NULL, NULL
+		check_transaction_read_only, assign_transaction_read_only, NULL
 	},
 	{
 		{"default_transaction_deferrable", PGC_USERSET, CLIENT_CONN_STATEMENT,
@@ -2284,6 +2284,18 @@ static struct config_int ConfigureNamesInt[] =
 		NULL, NULL, NULL
 	},
 
+	{
+		{"yb_follower_read_staleness_ms", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets how far in the past read-only transactions read, "
+						 "so that they can be served by the nearest replica."),
+			gettext_noop("A value of 0 reads from leaders."),
+			GUC_UNIT_MS
+		},
+		&yb_follower_read_staleness_ms,
+		0, 0, INT_MAX,
+		NULL, NULL, NULL
+	},
+
 	{
 		{"lock_timeout", PGC_USERSET, CLIENT_CONN_STATEMENT,
 			gettext_noop("Sets the maximum allowed duration of any wait for a lock."),
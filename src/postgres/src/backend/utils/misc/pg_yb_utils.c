@@ -154,6 +154,18 @@ YBTransactionsEnabled()
 	return IsYugaByteEnabled() && cached_value;
 }
 
+int yb_follower_read_staleness_ms = 0;
+
+void
+YBSetFollowerReadStaleness(bool read_only)
+{
+	if (YBTransactionsEnabled())
+	{
+		YBCPgTxnManager_SetFollowerReadStaleness(
+			YBCGetPgTxnManager(), read_only ? yb_follower_read_staleness_ms : 0);
+	}
+}
+
 void
 YBReportFeatureUnsupported(const char *msg)
 {
@@ -280,6 +292,15 @@ YBInitPostgresBackend(
 			HandleYBStatus(YBCPgCreateSession(
 				/* pg_env */ NULL, user_name, &ybc_pg_session));
 		}
+		else
+		{
+			/*
+			 * Parallel workers connect to the database of the leader by OID,
+			 * and all their statements refer to the database by OID as well.
+			 */
+			HandleYBStatus(YBCPgCreateSession(
+				/* pg_env */ NULL, "", &ybc_pg_session));
+		}
 	}
 }
 
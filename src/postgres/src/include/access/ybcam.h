@@ -54,6 +54,18 @@ typedef struct YbScanDescData
 	bool			is_exec_done;
 
 	Relation index;
+
+	/*
+	 * Index tuples read ahead by a secondary index scan, together with the base table rows they
+	 * point to, which are fetched in batches. Batches grow up to fetch_max_size.
+	 */
+	int         fetch_max_size;
+	int         fetch_size;
+	int         fetch_count;
+	int         fetch_next;
+	IndexTuple *fetch_itups;
+	HeapTuple  *fetch_htups;
+	bool       *fetch_rechecks;
 } YbScanDescData;
 
 typedef struct YbScanDescData *YbScanDesc;
@@ -102,6 +114,13 @@ extern void ybc_index_beginscan(Relation index,
 								int nkeys,
 								ScanKey key);
 extern IndexTuple ybc_index_getnext(IndexScanDesc scan_desc, bool is_forward_scan);
+/*
+ * Same as ybc_index_getnext, but also returns the base table row of the index tuple in
+ * heap_tuple, which is NULL if the row does not exist. Base table rows are fetched in batches of
+ * up to YBCGetIndexFetchBatchSize() rows.
+ */
+extern IndexTuple ybc_index_getnext_batched(IndexScanDesc scan_desc, bool is_forward_scan,
+											HeapTuple *heap_tuple);
 extern void ybc_index_endscan(IndexScanDesc scan_desc);
 
 /* Number of rows assumed for a YB table if no size estimates exist */
@@ -121,5 +140,20 @@ extern void ybcIndexCostEstimate(IndexPath *path, Selectivity *selectivity,
  */
 extern HeapTuple YBCFetchTuple(Relation relation, Datum ybctid);
 
+/*
+ * Fetch tuples by their ybctids. tuples[i] is set to the tuple with ybctids[i] or NULL if there
+ * is no such tuple.
+ */
+extern void YBCFetchTuples(Relation relation, int count, Datum *ybctids, HeapTuple *tuples);
+
+/*
+ * Fetch tuples by their primary keys. values holds nkeys values of the primary key columns
+ * attnums for each of count keys, eq_funcs and collations are used to match the fetched tuples to
+ * the keys. tuples[i] is set to the tuple with the i-th key or NULL if there is no such tuple.
+ */
+extern void YBCFetchTuplesByPrimaryKey(Relation relation, int count, int nkeys,
+									   AttrNumber *attnums, Datum *values, FmgrInfo *eq_funcs,
+									   Oid *collations, HeapTuple *tuples);
+
 
 #endif							/* YBCAM_H */
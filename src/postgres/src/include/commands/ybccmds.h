@@ -35,7 +35,8 @@
 
 /*  Database Functions -------------------------------------------------------------------------- */
 
-extern void YBCCreateDatabase(Oid dboid, const char *dbname, Oid src_dboid, Oid next_oid);
+extern void YBCCreateDatabase(Oid dboid, const char *dbname, Oid src_dboid, Oid next_oid,
+							  bool colocated);
 
 extern void YBCDropDatabase(Oid dboid, const char *dbname);
 
@@ -54,6 +54,34 @@ extern Oid YBCExecuteSingleRowTxnInsert(Relation rel,
                                         TupleDesc tupleDesc,
                                         HeapTuple tuple);
 
+/*
+ * Bulk insert into a YugaByte table, used by COPY FROM.
+ *
+ * Unlike YBCExecuteInsert, rows are not written one by one. They are sent in
+ * batches, and several batches could be in flight at the same time. So the
+ * caller must not depend on the inserted rows until YBCEndBulkInsert, which
+ * waits for all of them and reports the first error. The table must not have
+ * secondary indexes, because ybctid of the inserted rows is not returned.
+ */
+typedef struct YBCBulkInsertStateData *YBCBulkInsertState;
+
+extern YBCBulkInsertState YBCBeginBulkInsert(Relation rel);
+extern Oid YBCBulkInsert(YBCBulkInsertState state,
+                         TupleDesc tupleDesc,
+                         HeapTuple tuple);
+extern void YBCEndBulkInsert(YBCBulkInsertState state);
+
+/*
+ * Bulk insert of index entries, i.e. values of the index columns and ybctid
+ * of the base table row, as done by YBCExecuteInsertIndex. Used to build an
+ * index over the rows of an existing table. Finished by YBCEndBulkInsert.
+ */
+extern YBCBulkInsertState YBCBeginBulkInsertIndex(Relation index);
+extern void YBCBulkInsertIndex(YBCBulkInsertState state,
+                               Datum *values,
+                               bool *isnull,
+                               Datum ybctid);
+
 /*
  * Insert a tuple into the an index's backing YugaByte index table.
  */
@@ -1724,6 +1724,24 @@ typedef struct NestLoopState
 	bool		nl_NeedNewOuter;
 	bool		nl_MatchedOuter;
 	TupleTableSlot *nl_NullInnerTupleSlot;
+
+	/*
+	 * YugaByte batched mode: outer tuples are collected in batches, and the
+	 * inner tuples of a whole batch are fetched by primary key at once.
+	 */
+	bool		yb_batched;
+	int			yb_batch_size;
+	int			yb_nkeys;
+	AttrNumber *yb_inner_attnums;	/* primary key columns of the inner rel */
+	AttrNumber *yb_outer_attnums;	/* outer columns equal to them */
+	FmgrInfo   *yb_eq_funcs;
+	Oid		   *yb_collations;
+	TupleTableSlot **yb_outer_slots;
+	HeapTuple  *yb_inner_tuples;	/* match of each outer tuple or NULL */
+	int			yb_num_outer;	/* number of outer tuples in the batch */
+	int			yb_next_outer;	/* next outer tuple of the batch to join */
+	bool		yb_outer_done;
+	MemoryContext yb_batch_context;
 } NestLoopState;
 
 /* ----------------
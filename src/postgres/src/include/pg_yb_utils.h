@@ -103,6 +103,19 @@ extern bool YBRelHasOldRowTriggers(Relation rel, CmdType operation);
  */
 extern bool YBTransactionsEnabled();
 
+/*
+ * YSQL variable that makes read-only transactions read that many milliseconds
+ * in the past from the nearest replica, 0 to read from leaders.
+ * e.g. 'SET yb_follower_read_staleness_ms=5000'.
+ */
+extern int yb_follower_read_staleness_ms;
+
+/*
+ * Passes the follower read staleness to the transaction manager, for a
+ * transaction with the given read-only status.
+ */
+extern void YBSetFollowerReadStaleness(bool read_only);
+
 /*
  * Given a status returned by YB C++ code, reports that status using ereport if
  * it is not OK.
@@ -0,0 +1,168 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <fstream>
+#include <iostream>
+
+#include <glog/logging.h>
+
+#include "yb/benchmarks/ycsb.h"
+#include "yb/benchmarks/ycsb_stores.h"
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+
+#include "yb/util/flags.h"
+#include "yb/util/logging.h"
+#include "yb/util/net/net_util.h"
+
+DEFINE_string(api, "ycql", "API of the benchmarked database: ycql, yedis or ysql.");
+
+DEFINE_string(workload, "A", "Standard YCSB workload: A, B, C, D, E or F.");
+
+DEFINE_string(key_distribution, "",
+              "Distribution of keys, overrides the one of the workload: uniform, zipfian or "
+              "latest.");
+
+DEFINE_string(master_addresses, "", "Addresses of masters, for ycql.");
+
+DEFINE_string(redis_addresses, "", "Comma separated addresses of Redis proxies, for yedis.");
+
+DEFINE_string(ysql_connection_string, "",
+              "PostgreSQL connection string, for ysql, e.g. \"host=h port=5433 user=postgres\".");
+
+DEFINE_string(table_name, "usertable", "Name of the ycql table.");
+
+DEFINE_int32(num_tablets, 16, "Number of tablets of the created ycql table.");
+
+DEFINE_bool(create_table, true, "Create the table before loading the records.");
+
+DEFINE_bool(load, true,
+            "Load the records before running the workload. Otherwise the records should be loaded "
+            "by the previous run with the same record count.");
+
+DEFINE_int64(record_count, 100000, "Number of records.");
+
+DEFINE_int32(num_threads, 16, "Number of client threads.");
+
+DEFINE_double(target_ops_per_sec, 0,
+              "Rate of operations, independent of their latency. Latencies are measured from the "
+              "time the operation was scheduled at. Zero means that each thread executes the next "
+              "operation as soon as the previous one finishes.");
+
+DEFINE_int32(duration_sec, 60, "Duration of the workload run.");
+
+DEFINE_int32(value_size_bytes, 100, "Size of the record value.");
+
+DEFINE_string(results_file, "", "File to write the results to in JSON format, stdout if empty.");
+
+namespace yb {
+namespace ycsb {
+
+Result<KeyDistribution> ParseKeyDistribution(const std::string& name) {
+  if (name == "uniform") {
+    return KeyDistribution::kUniform;
+  }
+  if (name == "zipfian") {
+    return KeyDistribution::kZipfian;
+  }
+  if (name == "latest") {
+    return KeyDistribution::kLatest;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", name);
+}
+
+Status RunYcsb() {
+  RunOptions options;
+  options.workload = VERIFY_RESULT(Workload::Standard(FLAGS_workload));
+  if (!FLAGS_key_distribution.empty()) {
+    options.workload.distribution = VERIFY_RESULT(ParseKeyDistribution(FLAGS_key_distribution));
+  }
+  options.record_count = FLAGS_record_count;
+  options.num_threads = FLAGS_num_threads;
+  options.target_ops_per_sec = FLAGS_target_ops_per_sec;
+  options.duration = MonoDelta::FromSeconds(FLAGS_duration_sec);
+  options.value_size = FLAGS_value_size_bytes;
+
+  std::unique_ptr<client::YBClient> client;
+  client::TableHandle table;
+  StoreFactory store_factory;
+  if (FLAGS_api == "ycql") {
+    client = VERIFY_RESULT(client::YBClientBuilder()
+        .add_master_server_addr(FLAGS_master_addresses)
+        .Build());
+    const client::YBTableName table_name("ycsb", FLAGS_table_name);
+    if (FLAGS_create_table) {
+      RETURN_NOT_OK(client->CreateNamespaceIfNotExists(table_name.namespace_name()));
+      RETURN_NOT_OK(CreateYqlTable(table_name, FLAGS_num_tablets, client.get(), &table));
+    } else {
+      RETURN_NOT_OK(table.Open(table_name, client.get()));
+    }
+    store_factory = YqlStoreFactory(client.get(), &table);
+  } else if (FLAGS_api == "yedis") {
+    // The Redis table is created with the cluster, e.g. by "yb-admin setup_redis_table".
+    if (options.workload.scan_proportion > 0) {
+      return STATUS(InvalidArgument, "Scans are not supported by yedis");
+    }
+    constexpr uint16_t kDefaultRedisPort = 6379;
+    store_factory = RedisStoreFactory(
+        VERIFY_RESULT(HostPort::ParseStrings(FLAGS_redis_addresses, kDefaultRedisPort)));
+  } else if (FLAGS_api == "ysql") {
+    if (FLAGS_create_table) {
+      RETURN_NOT_OK(CreateYsqlTable(FLAGS_ysql_connection_string));
+    }
+    store_factory = YsqlStoreFactory(FLAGS_ysql_connection_string);
+  } else {
+    return STATUS_FORMAT(InvalidArgument, "Unknown API: $0", FLAGS_api);
+  }
+
+  Runner runner(options, std::move(store_factory));
+  if (FLAGS_load) {
+    RETURN_NOT_OK(runner.Load());
+  } else {
+    runner.UseLoadedRecords();
+  }
+  RETURN_NOT_OK(runner.Run());
+
+  auto results = runner.ResultsJson();
+  if (FLAGS_results_file.empty()) {
+    std::cout << results << std::endl;
+  } else {
+    std::ofstream out(FLAGS_results_file);
+    out << results << std::endl;
+    if (!out) {
+      return STATUS_FORMAT(IOError, "Failed to write $0", FLAGS_results_file);
+    }
+  }
+  return Status::OK();
+}
+
+} // namespace ycsb
+} // namespace yb
+
+int main(int argc, char *argv[]) {
+  gflags::SetUsageMessage(
+      "Usage:\n"
+      "    yb_ycsb_tool --api ycql --master_addresses master1:port1,...,masterN:portN\n"
+      "    yb_ycsb_tool --api yedis --redis_addresses proxy1:port1,...,proxyN:portN\n"
+      "    yb_ycsb_tool --api ysql --ysql_connection_string \"host=h port=p user=postgres\"");
+  yb::ParseCommandLineFlags(&argc, &argv, true);
+  yb::InitGoogleLoggingSafe(argv[0]);
+
+  auto status = yb::ycsb::RunYcsb();
+  if (!status.ok()) {
+    LOG(ERROR) << "YCSB failed: " << status;
+    return 1;
+  }
+  return 0;
+}
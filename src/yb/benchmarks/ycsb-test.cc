@@ -0,0 +1,286 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <map>
+#include <mutex>
+
+#include <gtest/gtest.h>
+
+#include "yb/benchmarks/ycsb.h"
+#include "yb/benchmarks/ycsb_stores.h"
+
+#include "yb/client/client.h"
+#include "yb/client/table_handle.h"
+
+#include "yb/integration-tests/mini_cluster.h"
+#include "yb/integration-tests/yb_mini_cluster_test_base.h"
+
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+namespace yb {
+namespace ycsb {
+
+namespace {
+
+// Keeps the records in memory. Every stall_period-th operation takes stall_time.
+class MemoryStore : public Store {
+ public:
+  explicit MemoryStore(int stall_period = 0, MonoDelta stall_time = MonoDelta())
+      : stall_period_(stall_period), stall_time_(stall_time) {}
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    Operation();
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.count(key) ? Status::OK() : STATUS(NotFound, key);
+  }
+
+  CHECKED_STATUS Update(const std::string& key, const std::string& value) override {
+    return Insert(key, value);
+  }
+
+  CHECKED_STATUS Insert(const std::string& key, const std::string& value) override {
+    Operation();
+    std::lock_guard<std::mutex> lock(mutex_);
+    records_[key] = value;
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int count) override {
+    Operation();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = records_.lower_bound(start_key);
+    for (int i = 0; i != count && it != records_.end(); ++i) {
+      ++it;
+    }
+    return Status::OK();
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return records_.size();
+  }
+
+ private:
+  void Operation() {
+    if (stall_period_ && ++num_operations_ % stall_period_ == 0) {
+      SleepFor(stall_time_);
+    }
+  }
+
+  const int stall_period_;
+  const MonoDelta stall_time_;
+  int64_t num_operations_ = 0;
+  std::mutex mutex_;
+  std::map<std::string, std::string> records_;
+};
+
+StoreFactory MemoryStoreFactory(MemoryStore* store) {
+  // Stores are owned by the runner, so the shared one is wrapped.
+  class Wrapper : public Store {
+   public:
+    explicit Wrapper(MemoryStore* store) : store_(store) {}
+
+    CHECKED_STATUS Read(const std::string& key) override { return store_->Read(key); }
+    CHECKED_STATUS Update(const std::string& key, const std::string& value) override {
+      return store_->Update(key, value);
+    }
+    CHECKED_STATUS Insert(const std::string& key, const std::string& value) override {
+      return store_->Insert(key, value);
+    }
+    CHECKED_STATUS Scan(const std::string& start_key, int count) override {
+      return store_->Scan(start_key, count);
+    }
+
+   private:
+    MemoryStore* store_;
+  };
+  return [store]() -> Result<std::unique_ptr<Store>> {
+    return std::make_unique<Wrapper>(store);
+  };
+}
+
+} // namespace
+
+TEST(YcsbTest, StandardWorkloads) {
+  for (auto name : {"A", "B", "C", "D", "E", "F"}) {
+    auto workload = ASSERT_RESULT(Workload::Standard(name));
+    ASSERT_DOUBLE_EQ(1, workload.read_proportion + workload.update_proportion +
+                        workload.insert_proportion + workload.scan_proportion +
+                        workload.read_modify_write_proportion) << name;
+  }
+  ASSERT_EQ(KeyDistribution::kLatest, ASSERT_RESULT(Workload::Standard("D")).distribution);
+  ASSERT_NOK(Workload::Standard("G"));
+
+  auto workload = ASSERT_RESULT(Workload::Standard("E"));
+  std::mt19937_64 rng(42);
+  std::map<Operation, int> counts;
+  constexpr int kOperations = 10000;
+  for (int i = 0; i != kOperations; ++i) {
+    ++counts[workload.NextOperation(&rng)];
+  }
+  ASSERT_EQ(2, counts.size());
+  ASSERT_NEAR(kOperations * 0.95, counts[Operation::kScan], kOperations * 0.01);
+}
+
+TEST(YcsbTest, KeyChoosers) {
+  constexpr int64_t kNumKeys = 1000;
+  constexpr int kSamples = 100000;
+  std::mt19937_64 rng(42);
+
+  ZipfianGenerator zipfian;
+  std::vector<int> counts(kNumKeys);
+  for (int i = 0; i != kSamples; ++i) {
+    auto item = zipfian.Next(kNumKeys, &rng);
+    ASSERT_GE(item, 0);
+    ASSERT_LT(item, kNumKeys);
+    ++counts[item];
+  }
+  // The most popular item is chosen about 1 / zeta(1000) ~ 13% of times.
+  ASSERT_GT(counts[0], kSamples / 10);
+  ASSERT_GT(counts[0], counts[1]);
+  ASSERT_GT(counts[1], counts[kNumKeys / 2]);
+
+  // Growing number of items, the new items are rare.
+  for (int i = 0; i != kSamples; ++i) {
+    auto item = zipfian.Next(kNumKeys * 2, &rng);
+    ASSERT_LT(item, kNumKeys * 2);
+  }
+
+  auto latest = CreateKeyChooser(KeyDistribution::kLatest);
+  int recent = 0;
+  for (int i = 0; i != kSamples; ++i) {
+    auto key = latest->Next(kNumKeys, &rng);
+    ASSERT_GE(key, 0);
+    ASSERT_LT(key, kNumKeys);
+    recent += key >= kNumKeys - 10;
+  }
+  ASSERT_GT(recent, kSamples / 4);
+
+  for (auto distribution : {KeyDistribution::kUniform, KeyDistribution::kZipfian}) {
+    auto chooser = CreateKeyChooser(distribution);
+    int recent = 0;
+    for (int i = 0; i != kSamples; ++i) {
+      auto key = chooser->Next(kNumKeys, &rng);
+      ASSERT_GE(key, 0);
+      ASSERT_LT(key, kNumKeys);
+      recent += key >= kNumKeys - 10;
+    }
+    ASSERT_LT(recent, kSamples / 10) << distribution;
+  }
+}
+
+// Operations scheduled behind a stalled one should be accounted with the time they waited.
+TEST(YcsbTest, CoordinatedOmission) {
+  constexpr auto kStallTime = 50ms;
+  MemoryStore store(100 /* stall_period */, kStallTime);
+
+  RunOptions options;
+  options.workload = ASSERT_RESULT(Workload::Standard("C"));
+  options.record_count = 100;
+  options.num_threads = 1;
+  options.target_ops_per_sec = 200;
+  options.duration = 2s;
+  options.value_size = 10;
+  Runner runner(options, MemoryStoreFactory(&store));
+  ASSERT_OK(runner.Load());
+  ASSERT_EQ(options.record_count, store.size());
+  ASSERT_OK(runner.Run());
+
+  const auto& stats = runner.stats(Operation::kRead);
+  ASSERT_EQ(0, stats.errors());
+  ASSERT_NEAR(options.target_ops_per_sec * options.duration.ToSeconds(),
+              stats.latency().TotalCount(), 10);
+  constexpr auto kStallUs = std::chrono::duration_cast<std::chrono::microseconds>(kStallTime);
+  // Only 1% of operations stall, while about 10% of them wait for a stall.
+  ASSERT_LT(stats.service_time().ValueAtPercentile(95), kStallUs.count() / 5);
+  ASSERT_GE(stats.latency().ValueAtPercentile(95), kStallUs.count() / 5);
+
+  auto json = runner.ResultsJson();
+  LOG(INFO) << "Results: " << json;
+  ASSERT_NE(json.find("\"kRead\""), std::string::npos);
+  ASSERT_NE(json.find("\"throughput_ops_per_sec\""), std::string::npos);
+}
+
+TEST(YcsbTest, Inserts) {
+  MemoryStore store;
+  RunOptions options;
+  options.workload = ASSERT_RESULT(Workload::Standard("D"));
+  options.record_count = 1000;
+  options.num_threads = 4;
+  options.duration = 1s;
+  options.value_size = 10;
+  Runner runner(options, MemoryStoreFactory(&store));
+  ASSERT_OK(runner.Load());
+  ASSERT_OK(runner.Run());
+
+  auto inserts = runner.stats(Operation::kInsert).latency().TotalCount();
+  ASSERT_GT(inserts, 0);
+  ASSERT_EQ(options.record_count + inserts, store.size());
+  ASSERT_EQ(0, runner.stats(Operation::kRead).errors());
+}
+
+class YcsbMiniClusterTest : public YBMiniClusterTestBase<MiniCluster> {
+ protected:
+  void SetUp() override {
+    YBMiniClusterTestBase::SetUp();
+    MiniClusterOptions opts;
+    opts.num_tablet_servers = 3;
+    cluster_.reset(new MiniCluster(env_.get(), opts));
+    ASSERT_OK(cluster_->Start());
+    client_ = ASSERT_RESULT(cluster_->CreateClient());
+  }
+
+  void DoTearDown() override {
+    client_.reset();
+    YBMiniClusterTestBase::DoTearDown();
+  }
+
+  std::unique_ptr<client::YBClient> client_;
+};
+
+TEST_F(YcsbMiniClusterTest, YqlWorkloads) {
+  const client::YBTableName table_name("my_keyspace", "usertable");
+  ASSERT_OK(client_->CreateNamespaceIfNotExists(table_name.namespace_name()));
+  client::TableHandle table;
+  ASSERT_OK(CreateYqlTable(table_name, 3 /* num_tablets */, client_.get(), &table));
+
+  RunOptions options;
+  options.record_count = 1000;
+  options.num_threads = 4;
+  options.target_ops_per_sec = 400;
+  options.duration = 3s;
+  bool loaded = false;
+
+  for (auto name : {"A", "E", "F"}) {
+    options.workload = ASSERT_RESULT(Workload::Standard(name));
+    Runner workload_runner(options, YqlStoreFactory(client_.get(), &table));
+    if (loaded) {
+      workload_runner.UseLoadedRecords();
+    } else {
+      ASSERT_OK(workload_runner.Load());
+      loaded = true;
+    }
+    ASSERT_OK(workload_runner.Run());
+    LOG(INFO) << "Workload " << name << ": " << workload_runner.ResultsJson();
+    for (auto operation : kOperationList) {
+      ASSERT_EQ(0, workload_runner.stats(operation).errors()) << name << ", " << operation;
+    }
+  }
+}
+
+} // namespace ycsb
+} // namespace yb
@@ -0,0 +1,439 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/benchmarks/ycsb.h"
+
+#include <cmath>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "yb/util/jsonwriter.h"
+#include "yb/util/logging.h"
+#include "yb/util/random_util.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace ycsb {
+
+namespace {
+
+// Latencies above one minute are recorded as one minute.
+constexpr uint64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+uint64_t Fnv64(uint64_t value) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int i = 0; i != 8; ++i) {
+    hash ^= value & 0xff;
+    hash *= 0x100000001b3ULL;
+    value >>= 8;
+  }
+  return hash;
+}
+
+double Zeta(int64_t from, int64_t to, double theta) {
+  double result = 0;
+  for (int64_t i = from; i < to; ++i) {
+    result += 1 / std::pow(i + 1, theta);
+  }
+  return result;
+}
+
+void RecordLatency(HdrHistogram* histogram, MonoDelta delta) {
+  histogram->Increment(std::min<uint64_t>(std::max<int64_t>(delta.ToMicroseconds(), 0),
+                                          kMaxLatencyUs));
+}
+
+class UniformKeyChooser : public KeyChooser {
+ public:
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng) override {
+    return RandomUniformInt<int64_t>(0, num_keys - 1, rng);
+  }
+};
+
+// Popular items of the zipfian distribution are hashed, so they are not clustered at the
+// beginning of the key space.
+class ScrambledZipfianKeyChooser : public KeyChooser {
+ public:
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng) override {
+    return Fnv64(generator_.Next(num_keys, rng)) % num_keys;
+  }
+
+ private:
+  ZipfianGenerator generator_;
+};
+
+class LatestKeyChooser : public KeyChooser {
+ public:
+  int64_t Next(int64_t num_keys, std::mt19937_64* rng) override {
+    return num_keys - 1 - generator_.Next(num_keys, rng);
+  }
+
+ private:
+  ZipfianGenerator generator_;
+};
+
+void WriteHistogram(const HdrHistogram& histogram, JsonWriter* writer) {
+  writer->StartObject();
+  writer->String("min");
+  writer->Uint64(histogram.TotalCount() ? histogram.MinValue() : 0);
+  writer->String("mean");
+  writer->Double(histogram.TotalCount() ? histogram.MeanValue() : 0);
+  for (auto percentile : {50.0, 95.0, 99.0, 99.9}) {
+    std::ostringstream name;
+    name << "p" << percentile;
+    writer->String(name.str());
+    writer->Uint64(histogram.ValueAtPercentile(percentile));
+  }
+  writer->String("max");
+  writer->Uint64(histogram.MaxValue());
+  writer->EndObject();
+}
+
+} // namespace
+
+Result<Workload> Workload::Standard(const std::string& name) {
+  Workload result;
+  if (name == "A") {
+    // Update heavy.
+    result.read_proportion = 0.5;
+    result.update_proportion = 0.5;
+  } else if (name == "B") {
+    // Read mostly.
+    result.read_proportion = 0.95;
+    result.update_proportion = 0.05;
+  } else if (name == "C") {
+    // Read only.
+    result.read_proportion = 1;
+  } else if (name == "D") {
+    // Read latest.
+    result.read_proportion = 0.95;
+    result.insert_proportion = 0.05;
+    result.distribution = KeyDistribution::kLatest;
+  } else if (name == "E") {
+    // Short ranges.
+    result.scan_proportion = 0.95;
+    result.insert_proportion = 0.05;
+  } else if (name == "F") {
+    // Read-modify-write.
+    result.read_proportion = 0.5;
+    result.read_modify_write_proportion = 0.5;
+  } else {
+    return STATUS_FORMAT(InvalidArgument, "Unknown YCSB workload: $0", name);
+  }
+  return result;
+}
+
+Operation Workload::NextOperation(std::mt19937_64* rng) const {
+  double value = std::uniform_real_distribution<double>(0, 1)(*rng);
+  for (auto entry : {std::make_pair(read_proportion, Operation::kRead),
+                     std::make_pair(update_proportion, Operation::kUpdate),
+                     std::make_pair(insert_proportion, Operation::kInsert),
+                     std::make_pair(scan_proportion, Operation::kScan)}) {
+    if (value < entry.first) {
+      return entry.second;
+    }
+    value -= entry.first;
+  }
+  return read_modify_write_proportion > 0 ? Operation::kReadModifyWrite : Operation::kRead;
+}
+
+ZipfianGenerator::ZipfianGenerator(double theta)
+    : theta_(theta), alpha_(1 / (1 - theta)), zeta2_(Zeta(0, 2, theta)) {
+}
+
+void ZipfianGenerator::UpdateZeta(int64_t num_items) {
+  if (num_items > num_items_) {
+    zetan_ += Zeta(num_items_, num_items, theta_);
+  } else {
+    zetan_ = Zeta(0, num_items, theta_);
+  }
+  num_items_ = num_items;
+  eta_ = (1 - std::pow(2.0 / num_items_, 1 - theta_)) / (1 - zeta2_ / zetan_);
+}
+
+int64_t ZipfianGenerator::Next(int64_t num_items, std::mt19937_64* rng) {
+  if (num_items != num_items_) {
+    UpdateZeta(num_items);
+  }
+  double u = std::uniform_real_distribution<double>(0, 1)(*rng);
+  double uz = u * zetan_;
+  if (uz < 1) {
+    return 0;
+  }
+  if (uz < 1 + std::pow(0.5, theta_)) {
+    return std::min<int64_t>(1, num_items_ - 1);
+  }
+  auto result = static_cast<int64_t>(num_items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+  return std::min(result, num_items_ - 1);
+}
+
+std::unique_ptr<KeyChooser> CreateKeyChooser(KeyDistribution distribution) {
+  switch (distribution) {
+    case KeyDistribution::kUniform:
+      return std::make_unique<UniformKeyChooser>();
+    case KeyDistribution::kZipfian:
+      return std::make_unique<ScrambledZipfianKeyChooser>();
+    case KeyDistribution::kLatest:
+      return std::make_unique<LatestKeyChooser>();
+  }
+  FATAL_INVALID_ENUM_VALUE(KeyDistribution, distribution);
+}
+
+std::string KeyForIndex(int64_t key_index) {
+  return "user" + std::to_string(key_index);
+}
+
+OperationStats::OperationStats()
+    : latency_(kMaxLatencyUs, kLatencySignificantDigits),
+      service_time_(kMaxLatencyUs, kLatencySignificantDigits) {
+}
+
+void OperationStats::Record(MonoDelta latency, MonoDelta service_time) {
+  RecordLatency(&latency_, latency);
+  RecordLatency(&service_time_, service_time);
+}
+
+Runner::Runner(const RunOptions& options, StoreFactory store_factory)
+    : options_(options), store_factory_(std::move(store_factory)) {
+  for (size_t i = 0; i != kElementsInOperation; ++i) {
+    stats_.push_back(std::make_unique<OperationStats>());
+  }
+}
+
+Runner::~Runner() {
+}
+
+Status Runner::RunThreads(const std::function<Status(Store*, int)>& thread_body) {
+  std::vector<std::unique_ptr<Store>> stores;
+  for (int i = 0; i != options_.num_threads; ++i) {
+    stores.push_back(VERIFY_RESULT(store_factory_()));
+  }
+
+  std::mutex mutex;
+  Status result;
+  std::vector<std::thread> threads;
+  for (int i = 0; i != options_.num_threads; ++i) {
+    threads.emplace_back([i, &stores, &thread_body, &mutex, &result] {
+      auto status = thread_body(stores[i].get(), i);
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (result.ok()) {
+          result = status;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return result;
+}
+
+Status Runner::Load() {
+  LOG(INFO) << "Loading " << options_.record_count << " records";
+  next_insert_index_ = 0;
+  RETURN_NOT_OK(RunThreads([this](Store* store, int thread_index) -> Status {
+    std::mt19937_64 rng(RandomUniformInt<uint64_t>());
+    for (;;) {
+      auto key_index = next_insert_index_.fetch_add(1, std::memory_order_acq_rel);
+      if (key_index >= options_.record_count) {
+        return Status::OK();
+      }
+      RETURN_NOT_OK(store->Insert(KeyForIndex(key_index), NewValue(&rng)));
+    }
+  }));
+  UseLoadedRecords();
+  return Status::OK();
+}
+
+void Runner::UseLoadedRecords() {
+  next_insert_index_ = options_.record_count;
+  num_keys_ = options_.record_count;
+}
+
+Status Runner::Run() {
+  if (num_keys_.load(std::memory_order_acquire) == 0) {
+    return STATUS(IllegalState, "No records were loaded");
+  }
+  for (auto& stats : stats_) {
+    stats = std::make_unique<OperationStats>();
+  }
+  LOG(INFO) << "Running workload for " << options_.duration << " with " << options_.num_threads
+            << " threads, target rate: " << options_.target_ops_per_sec << " ops/sec";
+  auto start = MonoTime::Now();
+  RETURN_NOT_OK(RunThreads([this](Store* store, int thread_index) {
+    return RunThread(store, thread_index);
+  }));
+  elapsed_ = MonoTime::Now() - start;
+  return Status::OK();
+}
+
+Status Runner::RunThread(Store* store, int thread_index) {
+  std::mt19937_64 rng(RandomUniformInt<uint64_t>());
+  auto key_chooser = CreateKeyChooser(options_.workload.distribution);
+
+  // Each thread has its share of the target rate. Operations are scheduled in advance, so a slow
+  // one delays the following ones and their latency includes the time they were delayed by.
+  MonoDelta interval;
+  if (options_.target_ops_per_sec > 0) {
+    interval = MonoDelta::FromSeconds(options_.num_threads / options_.target_ops_per_sec);
+  }
+  const auto start = MonoTime::Now();
+  const auto deadline = start + options_.duration;
+  auto scheduled_start = start;
+  if (interval) {
+    scheduled_start += interval * thread_index / options_.num_threads;
+  }
+
+  for (;;) {
+    auto now = MonoTime::Now();
+    if (interval) {
+      if (scheduled_start >= deadline) {
+        break;
+      }
+      if (now < scheduled_start) {
+        SleepFor(scheduled_start - now);
+      }
+    } else {
+      if (now >= deadline) {
+        break;
+      }
+      scheduled_start = now;
+    }
+
+    auto operation = options_.workload.NextOperation(&rng);
+    auto actual_start = MonoTime::Now();
+    auto status = Execute(operation, store, key_chooser.get(), &rng);
+    auto finish = MonoTime::Now();
+    auto& stats = *stats_[static_cast<size_t>(operation)];
+    if (status.ok()) {
+      stats.Record(finish - scheduled_start, finish - actual_start);
+    } else {
+      stats.RecordError();
+      YB_LOG_EVERY_N_SECS(WARNING, 1) << "Thread " << thread_index << ", " << operation
+                                      << " failed: " << status;
+    }
+
+    if (interval) {
+      scheduled_start += interval;
+    }
+  }
+  return Status::OK();
+}
+
+Status Runner::Execute(
+    Operation operation, Store* store, KeyChooser* key_chooser, std::mt19937_64* rng) {
+  auto choose_key = [this, key_chooser, rng] {
+    return KeyForIndex(key_chooser->Next(num_keys_.load(std::memory_order_acquire), rng));
+  };
+  switch (operation) {
+    case Operation::kRead:
+      return store->Read(choose_key());
+    case Operation::kUpdate:
+      return store->Update(choose_key(), NewValue(rng));
+    case Operation::kInsert: {
+      auto key_index = next_insert_index_.fetch_add(1, std::memory_order_acq_rel);
+      RETURN_NOT_OK(store->Insert(KeyForIndex(key_index), NewValue(rng)));
+      // Keys are inserted concurrently, so the key of a lower index could be not inserted yet.
+      // Such keys are rare and reading them is not an error.
+      auto num_keys = num_keys_.load(std::memory_order_acquire);
+      while (num_keys <= key_index &&
+             !num_keys_.compare_exchange_weak(num_keys, key_index + 1)) {
+      }
+      return Status::OK();
+    }
+    case Operation::kScan:
+      return store->Scan(
+          choose_key(), RandomUniformInt(1, options_.workload.max_scan_length, rng));
+    case Operation::kReadModifyWrite: {
+      auto key = choose_key();
+      RETURN_NOT_OK(store->Read(key));
+      return store->Update(key, NewValue(rng));
+    }
+  }
+  FATAL_INVALID_ENUM_VALUE(Operation, operation);
+}
+
+std::string Runner::NewValue(std::mt19937_64* rng) const {
+  static const char kHexDigits[] = "0123456789abcdef";
+  std::string result(options_.value_size, '0');
+  for (auto& c : result) {
+    c = kHexDigits[RandomUniformInt(0, 15, rng)];
+  }
+  return result;
+}
+
+std::string Runner::ResultsJson() const {
+  std::stringstream out;
+  JsonWriter writer(&out, JsonWriter::PRETTY);
+  const auto& workload = options_.workload;
+  int64_t total_operations = 0;
+
+  writer.StartObject();
+  writer.String("workload");
+  writer.StartObject();
+  writer.String("read_proportion");
+  writer.Double(workload.read_proportion);
+  writer.String("update_proportion");
+  writer.Double(workload.update_proportion);
+  writer.String("insert_proportion");
+  writer.Double(workload.insert_proportion);
+  writer.String("scan_proportion");
+  writer.Double(workload.scan_proportion);
+  writer.String("read_modify_write_proportion");
+  writer.Double(workload.read_modify_write_proportion);
+  writer.String("distribution");
+  writer.String(ToString(workload.distribution));
+  writer.EndObject();
+  writer.String("record_count");
+  writer.Int64(options_.record_count);
+  writer.String("threads");
+  writer.Int(options_.num_threads);
+  writer.String("target_ops_per_sec");
+  writer.Double(options_.target_ops_per_sec);
+  writer.String("elapsed_sec");
+  writer.Double(elapsed_ ? elapsed_.ToSeconds() : 0);
+
+  writer.String("operations");
+  writer.StartObject();
+  for (auto operation : kOperationList) {
+    const auto& stats = this->stats(operation);
+    auto count = stats.latency().TotalCount();
+    if (count == 0 && stats.errors() == 0) {
+      continue;
+    }
+    total_operations += count;
+    writer.String(ToString(operation));
+    writer.StartObject();
+    writer.String("count");
+    writer.Uint64(count);
+    writer.String("errors");
+    writer.Int64(stats.errors());
+    writer.String("latency_us");
+    WriteHistogram(stats.latency(), &writer);
+    writer.String("service_time_us");
+    WriteHistogram(stats.service_time(), &writer);
+    writer.EndObject();
+  }
+  writer.EndObject();
+
+  writer.String("throughput_ops_per_sec");
+  writer.Double(elapsed_ ? total_operations / elapsed_.ToSeconds() : 0);
+  writer.EndObject();
+  return out.str();
+}
+
+} // namespace ycsb
+} // namespace yb
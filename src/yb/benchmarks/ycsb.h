@@ -0,0 +1,181 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_BENCHMARKS_YCSB_H
+#define YB_BENCHMARKS_YCSB_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "yb/util/enums.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace ycsb {
+
+YB_DEFINE_ENUM(Operation, (kRead)(kUpdate)(kInsert)(kScan)(kReadModifyWrite));
+YB_DEFINE_ENUM(KeyDistribution, (kUniform)(kZipfian)(kLatest));
+
+// Proportions of operations and distribution of keys, as in the core workloads of YCSB.
+struct Workload {
+  double read_proportion = 0;
+  double update_proportion = 0;
+  double insert_proportion = 0;
+  double scan_proportion = 0;
+  double read_modify_write_proportion = 0;
+  KeyDistribution distribution = KeyDistribution::kZipfian;
+  // Scan length is chosen uniformly from [1, max_scan_length].
+  int max_scan_length = 100;
+
+  // Returns one of the standard workloads "A" - "F".
+  static Result<Workload> Standard(const std::string& name);
+
+  Operation NextOperation(std::mt19937_64* rng) const;
+};
+
+// Chooses the index of an existing key for the next operation.
+class KeyChooser {
+ public:
+  virtual ~KeyChooser() {}
+
+  // Returns a key index in [0, num_keys).
+  virtual int64_t Next(int64_t num_keys, std::mt19937_64* rng) = 0;
+};
+
+// Zipfian distribution of item popularity, as described in "Quickly Generating Billion-Record
+// Synthetic Databases" by Gray et al. Item 0 is the most popular one.
+// The number of items could grow between calls, zeta is updated incrementally in this case.
+class ZipfianGenerator {
+ public:
+  static constexpr double kZipfianConstant = 0.99;
+
+  explicit ZipfianGenerator(double theta = kZipfianConstant);
+
+  int64_t Next(int64_t num_items, std::mt19937_64* rng);
+
+ private:
+  void UpdateZeta(int64_t num_items);
+
+  const double theta_;
+  const double alpha_;
+  const double zeta2_;
+  int64_t num_items_ = 0;
+  double zetan_ = 0;
+  double eta_ = 0;
+};
+
+// The distribution is:
+// kUniform - all keys are equally popular.
+// kZipfian - popular keys are scattered over the key space.
+// kLatest - the most recently inserted keys are the most popular ones.
+std::unique_ptr<KeyChooser> CreateKeyChooser(KeyDistribution distribution);
+
+// Operations of the benchmarked database. Should be used by one thread at a time, each thread of
+// the benchmark creates its own store.
+class Store {
+ public:
+  virtual ~Store() {}
+
+  virtual CHECKED_STATUS Read(const std::string& key) = 0;
+  virtual CHECKED_STATUS Update(const std::string& key, const std::string& value) = 0;
+  virtual CHECKED_STATUS Insert(const std::string& key, const std::string& value) = 0;
+  virtual CHECKED_STATUS Scan(const std::string& start_key, int count) = 0;
+};
+
+typedef std::function<Result<std::unique_ptr<Store>>()> StoreFactory;
+
+std::string KeyForIndex(int64_t key_index);
+
+struct RunOptions {
+  Workload workload;
+  // Number of keys inserted by Load.
+  int64_t record_count = 10000;
+  int num_threads = 16;
+  // Rate of operations in Run, that is kept independently of their latency. Zero means that each
+  // thread starts the next operation as soon as the previous one finishes.
+  double target_ops_per_sec = 0;
+  MonoDelta duration = MonoDelta::FromSeconds(60);
+  size_t value_size = 100;
+};
+
+// Latencies of one kind of operation.
+class OperationStats {
+ public:
+  OperationStats();
+
+  void Record(MonoDelta latency, MonoDelta service_time);
+  void RecordError() { errors_.fetch_add(1, std::memory_order_relaxed); }
+
+  // Time from the scheduled start of the operation to its end. With the target rate, operations
+  // delayed by the slow ones before them are accounted with the time they waited, so the result
+  // is not affected by coordinated omission.
+  const HdrHistogram& latency() const { return latency_; }
+  // Time from the actual start of the operation to its end.
+  const HdrHistogram& service_time() const { return service_time_; }
+  int64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+
+ private:
+  HdrHistogram latency_;
+  HdrHistogram service_time_;
+  std::atomic<int64_t> errors_{0};
+};
+
+// Runs the workload against a store, with a thread pool of num_threads.
+class Runner {
+ public:
+  Runner(const RunOptions& options, StoreFactory store_factory);
+  ~Runner();
+
+  // Inserts record_count keys.
+  CHECKED_STATUS Load();
+
+  // Runs the workload over record_count keys, that were loaded before.
+  void UseLoadedRecords();
+
+  // Executes the workload for the specified duration.
+  CHECKED_STATUS Run();
+
+  const OperationStats& stats(Operation operation) const {
+    return *stats_[static_cast<size_t>(operation)];
+  }
+
+  // Machine readable results of the last Run, in JSON format.
+  std::string ResultsJson() const;
+
+ private:
+  CHECKED_STATUS RunThreads(const std::function<Status(Store*, int)>& thread_body);
+  CHECKED_STATUS RunThread(Store* store, int thread_index);
+  CHECKED_STATUS Execute(Operation operation, Store* store, KeyChooser* key_chooser,
+                         std::mt19937_64* rng);
+  std::string NewValue(std::mt19937_64* rng) const;
+
+  const RunOptions options_;
+  const StoreFactory store_factory_;
+  // Keys with smaller indexes were inserted.
+  std::atomic<int64_t> num_keys_{0};
+  // The next index of inserted key.
+  std::atomic<int64_t> next_insert_index_{0};
+  std::vector<std::unique_ptr<OperationStats>> stats_;
+  MonoDelta elapsed_;
+};
+
+} // namespace ycsb
+} // namespace yb
+
+#endif // YB_BENCHMARKS_YCSB_H
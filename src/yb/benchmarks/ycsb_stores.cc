@@ -0,0 +1,213 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/benchmarks/ycsb_stores.h"
+
+#include "yb/client/client.h"
+#include "yb/client/session.h"
+#include "yb/client/table.h"
+#include "yb/client/table_handle.h"
+#include "yb/client/yb_op.h"
+
+#include "yb/common/partition.h"
+
+#include "yb/yql/pgwrapper/libpq_utils.h"
+#include "yb/yql/redis/redisserver/redis_client.h"
+
+#include "yb/util/format.h"
+
+namespace yb {
+namespace ycsb {
+
+namespace {
+
+class YqlStore : public Store {
+ public:
+  YqlStore(client::YBClient* client, const client::TableHandle* table)
+      : table_(*table), session_(client->NewSession()) {
+  }
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    auto op = table_.NewReadOp();
+    QLAddStringHashValue(op->mutable_request(), key);
+    table_.AddColumns({"k", "v"}, op->mutable_request());
+    return Execute(op);
+  }
+
+  CHECKED_STATUS Update(const std::string& key, const std::string& value) override {
+    return Write(table_.NewUpdateOp(), key, value);
+  }
+
+  CHECKED_STATUS Insert(const std::string& key, const std::string& value) override {
+    return Write(table_.NewInsertOp(), key, value);
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int count) override {
+    // Same as CQL "SELECT * FROM t WHERE token(k) >= token(?) LIMIT ?".
+    QLReadRequestPB key_request;
+    QLAddStringHashValue(&key_request, start_key);
+    std::string partition_key;
+    RETURN_NOT_OK(table_->partition_schema().EncodeKey(
+        key_request.hashed_column_values(), &partition_key));
+
+    auto op = table_.NewReadOp();
+    auto* req = op->mutable_request();
+    req->set_hash_code(PartitionSchema::DecodeMultiColumnHashValue(partition_key));
+    req->set_limit(count);
+    table_.AddColumns({"k", "v"}, req);
+    return Execute(op);
+  }
+
+ private:
+  CHECKED_STATUS Write(const client::YBqlWriteOpPtr& op, const std::string& key,
+                       const std::string& value) {
+    QLAddStringHashValue(op->mutable_request(), key);
+    table_.AddStringColumnValue(op->mutable_request(), "v", value);
+    return Execute(op);
+  }
+
+  template <class Op>
+  CHECKED_STATUS Execute(const std::shared_ptr<Op>& op) {
+    RETURN_NOT_OK(session_->ApplyAndFlush(op));
+    if (op->response().status() != QLResponsePB::YQL_STATUS_OK) {
+      return STATUS(RemoteError, op->response().error_message());
+    }
+    return Status::OK();
+  }
+
+  const client::TableHandle& table_;
+  const std::shared_ptr<client::YBSession> session_;
+};
+
+class RedisStore : public Store {
+ public:
+  explicit RedisStore(const HostPort& address) : client_(address.host(), address.port()) {}
+
+  ~RedisStore() {
+    client_.Disconnect();
+  }
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    return Execute({"GET", key});
+  }
+
+  CHECKED_STATUS Update(const std::string& key, const std::string& value) override {
+    return Execute({"SET", key, value});
+  }
+
+  CHECKED_STATUS Insert(const std::string& key, const std::string& value) override {
+    return Execute({"SET", key, value});
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int count) override {
+    return STATUS(NotSupported, "Range scans are not supported by Redis");
+  }
+
+ private:
+  CHECKED_STATUS Execute(redisserver::RedisCommand command) {
+    Status status = STATUS(TimedOut, "No reply");
+    client_.Send(std::move(command), [&status](const redisserver::RedisReply& reply) {
+      if (reply.get_type() == redisserver::RedisReplyType::kError) {
+        status = STATUS(RemoteError, reply.error());
+      } else {
+        status = Status::OK();
+      }
+    });
+    client_.Commit();
+    return status;
+  }
+
+  redisserver::RedisClient client_;
+};
+
+Result<pgwrapper::PGConnPtr> ConnectYsql(const std::string& connection_string) {
+  pgwrapper::PGConnPtr result(PQconnectdb(connection_string.c_str()));
+  if (PQstatus(result.get()) != ConnStatusType::CONNECTION_OK) {
+    return STATUS_FORMAT(NetworkError, "Connect failed: $0", PQerrorMessage(result.get()));
+  }
+  return result;
+}
+
+// Keys and values are alphanumeric, so they are used in the statements as is.
+class YsqlStore : public Store {
+ public:
+  explicit YsqlStore(pgwrapper::PGConnPtr conn) : conn_(std::move(conn)) {}
+
+  CHECKED_STATUS Read(const std::string& key) override {
+    return Fetch(Format("SELECT k, v FROM usertable WHERE k = '$0'", key));
+  }
+
+  CHECKED_STATUS Update(const std::string& key, const std::string& value) override {
+    return pgwrapper::Execute(
+        conn_.get(), Format("UPDATE usertable SET v = '$0' WHERE k = '$1'", value, key));
+  }
+
+  CHECKED_STATUS Insert(const std::string& key, const std::string& value) override {
+    return pgwrapper::Execute(
+        conn_.get(), Format("INSERT INTO usertable (k, v) VALUES ('$0', '$1')", key, value));
+  }
+
+  CHECKED_STATUS Scan(const std::string& start_key, int count) override {
+    return Fetch(Format("SELECT k, v FROM usertable WHERE k >= '$0' LIMIT $1", start_key, count));
+  }
+
+ private:
+  CHECKED_STATUS Fetch(const std::string& query) {
+    RETURN_NOT_OK(pgwrapper::Fetch(conn_.get(), query));
+    return Status::OK();
+  }
+
+  pgwrapper::PGConnPtr conn_;
+};
+
+} // namespace
+
+Status CreateYqlTable(const client::YBTableName& table_name,
+                      int num_tablets,
+                      client::YBClient* client,
+                      client::TableHandle* table) {
+  client::YBSchemaBuilder builder;
+  builder.AddColumn("k")->Type(BINARY)->HashPrimaryKey()->NotNull();
+  builder.AddColumn("v")->Type(BINARY)->NotNull();
+  return table->Create(table_name, num_tablets, client, &builder);
+}
+
+StoreFactory YqlStoreFactory(client::YBClient* client, const client::TableHandle* table) {
+  return [client, table]() -> Result<std::unique_ptr<Store>> {
+    return std::make_unique<YqlStore>(client, table);
+  };
+}
+
+StoreFactory RedisStoreFactory(const std::vector<HostPort>& addresses) {
+  auto next_address = std::make_shared<size_t>(0);
+  return [addresses, next_address]() -> Result<std::unique_ptr<Store>> {
+    if (addresses.empty()) {
+      return STATUS(InvalidArgument, "No Redis proxy addresses");
+    }
+    return std::make_unique<RedisStore>(addresses[(*next_address)++ % addresses.size()]);
+  };
+}
+
+Status CreateYsqlTable(const std::string& connection_string) {
+  auto conn = VERIFY_RESULT(ConnectYsql(connection_string));
+  return pgwrapper::Execute(conn.get(), "CREATE TABLE usertable (k TEXT PRIMARY KEY, v TEXT)");
+}
+
+StoreFactory YsqlStoreFactory(const std::string& connection_string) {
+  return [connection_string]() -> Result<std::unique_ptr<Store>> {
+    return std::make_unique<YsqlStore>(VERIFY_RESULT(ConnectYsql(connection_string)));
+  };
+}
+
+} // namespace ycsb
+} // namespace yb
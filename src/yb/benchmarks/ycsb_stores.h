@@ -0,0 +1,53 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_BENCHMARKS_YCSB_STORES_H
+#define YB_BENCHMARKS_YCSB_STORES_H
+
+#include <string>
+
+#include "yb/benchmarks/ycsb.h"
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+namespace ycsb {
+
+// Creates and opens a YQL table with hash partitioned binary key "k" and binary value "v".
+CHECKED_STATUS CreateYqlTable(const client::YBTableName& table_name,
+                              int num_tablets,
+                              client::YBClient* client,
+                              client::TableHandle* table);
+
+// Returns factory of stores working with a YQL table created by CreateYqlTable, through the
+// client. Scans read from the hash code of the start key, i.e. ranges of the CQL token.
+StoreFactory YqlStoreFactory(client::YBClient* client, const client::TableHandle* table);
+
+// Returns factory of stores working with the Redis proxies of the specified addresses.
+// Each store connects to one proxy, round-robin. Redis has no range scans, so scan operations
+// fail with NotSupported.
+StoreFactory RedisStoreFactory(const std::vector<HostPort>& addresses);
+
+// Creates a YSQL table from the PostgreSQL connection string, with text key "k" and value "v".
+CHECKED_STATUS CreateYsqlTable(const std::string& connection_string);
+
+// Returns factory of stores working with the table created by CreateYsqlTable, each store has
+// its own connection.
+StoreFactory YsqlStoreFactory(const std::string& connection_string);
+
+} // namespace ycsb
+} // namespace yb
+
+#endif // YB_BENCHMARKS_YCSB_STORES_H
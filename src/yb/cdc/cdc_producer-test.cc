@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/cdc/cdc_producer.h"
+#include "yb/common/schema.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/value.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace cdc {
+
+using docdb::DocKey;
+using docdb::PrimitiveValue;
+using docdb::SubDocKey;
+
+class CDCProducerTest : public YBTest {
+ protected:
+  void AddPair(const SubDocKey& key, const docdb::Value& value) {
+    auto* pair = write_batch_.add_write_pairs();
+    pair->set_key(key.EncodeWithoutHt().data());
+    pair->set_value(value.Encode());
+  }
+
+  const Schema schema_{{
+          ColumnSchema("k", DataType::INT32, /* is_nullable = */ false, /* is_hash_key = */ false),
+          ColumnSchema("v", DataType::STRING, true)
+      }, {
+          10_ColId,
+          20_ColId
+      }, 1};
+  docdb::KeyValueWriteBatchPB write_batch_;
+};
+
+TEST_F(CDCProducerTest, DecodeWriteBatch) {
+  DocKey row1({PrimitiveValue::Int32(1)});
+  DocKey row2({PrimitiveValue::Int32(2)});
+  AddPair(SubDocKey(row1, PrimitiveValue::SystemColumnId(docdb::SystemColumnIds::kLivenessColumn)),
+          docdb::Value(PrimitiveValue(docdb::ValueType::kNull)));
+  AddPair(SubDocKey(row1, PrimitiveValue(20_ColId)), docdb::Value(PrimitiveValue("one")));
+  AddPair(SubDocKey(row2), docdb::Value::Tombstone());
+
+  std::vector<CDCRecordPB> records;
+  ASSERT_OK(DecodeWriteBatch(write_batch_, schema_, 1000, &records));
+  ASSERT_EQ(2, records.size());
+
+  const auto& write = records[0];
+  ASSERT_EQ(CDCRecordPB::WRITE, write.operation());
+  ASSERT_EQ(1000, write.time());
+  ASSERT_EQ(1, write.key().fields().at("k").number_value());
+  ASSERT_EQ(1, write.changes().fields_size());
+  ASSERT_EQ("one", write.changes().fields().at("v").string_value());
+
+  const auto& del = records[1];
+  ASSERT_EQ(CDCRecordPB::DELETE, del.operation());
+  ASSERT_EQ(2, del.key().fields().at("k").number_value());
+  ASSERT_EQ(0, del.changes().fields_size());
+}
+
+// The log should be retained from the first intents of every transaction, that was not applied at
+// the committed checkpoint.
+TEST_F(CDCProducerTest, RetainIndex) {
+  CDCTabletState state;
+  state.pending[GenerateTransactionId()].first_op_index = 20;
+  state.applied.emplace_back(15, 5);
+  state.applied.emplace_back(25, 12);
+
+  state.CommitCheckpoint(10);
+  ASSERT_EQ(10, state.committed_index);
+  ASSERT_EQ(4, state.retain_index);
+  ASSERT_EQ(2, state.applied.size());
+
+  state.CommitCheckpoint(18);
+  ASSERT_EQ(11, state.retain_index);
+  ASSERT_EQ(1, state.applied.size());
+
+  state.CommitCheckpoint(30);
+  ASSERT_EQ(19, state.retain_index);
+  ASSERT_TRUE(state.applied.empty());
+
+  state.pending.clear();
+  state.CommitCheckpoint(30);
+  ASSERT_EQ(30, state.retain_index);
+}
+
+} // namespace cdc
+} // namespace yb
@@ -0,0 +1,321 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/cdc/cdc_producer.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+#include "yb/common/ql_value.h"
+#include "yb/common/schema.h"
+#include "yb/consensus/consensus.h"
+#include "yb/consensus/consensus.pb.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.pb.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/docdb/range_tombstones.h"
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_type.h"
+#include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/tablet_peer.h"
+
+namespace yb {
+namespace cdc {
+
+using docdb::PrimitiveValue;
+using docdb::ValueType;
+
+namespace {
+
+void QLValueToJson(const QLValuePB& value, google::protobuf::Value* out) {
+  switch (value.value_case()) {
+    case QLValuePB::VALUE_NOT_SET:
+      out->set_null_value(google::protobuf::NULL_VALUE);
+      return;
+    case QLValuePB::kInt8Value:
+      out->set_number_value(value.int8_value());
+      return;
+    case QLValuePB::kInt16Value:
+      out->set_number_value(value.int16_value());
+      return;
+    case QLValuePB::kInt32Value:
+      out->set_number_value(value.int32_value());
+      return;
+    case QLValuePB::kInt64Value:
+      out->set_number_value(value.int64_value());
+      return;
+    case QLValuePB::kUint32Value:
+      out->set_number_value(value.uint32_value());
+      return;
+    case QLValuePB::kFloatValue:
+      out->set_number_value(value.float_value());
+      return;
+    case QLValuePB::kDoubleValue:
+      out->set_number_value(value.double_value());
+      return;
+    case QLValuePB::kBoolValue:
+      out->set_bool_value(value.bool_value());
+      return;
+    case QLValuePB::kStringValue:
+      out->set_string_value(value.string_value());
+      return;
+    default:
+      out->set_string_value(QLValue(value).ToString());
+      return;
+  }
+}
+
+// Converts a primitive value to JSON, using the column type when it is known.
+void PrimitiveValueToJson(
+    const PrimitiveValue& value, const ColumnSchema* column, google::protobuf::Value* out) {
+  if (value.value_type() == ValueType::kTombstone) {
+    out->set_null_value(google::protobuf::NULL_VALUE);
+    return;
+  }
+  if (column && !docdb::IsObjectType(value.value_type())) {
+    QLValuePB ql_value;
+    PrimitiveValue::ToQLValuePB(value, column->type(), &ql_value);
+    QLValueToJson(ql_value, out);
+    return;
+  }
+  out->set_string_value(value.ToString());
+}
+
+void AddPrimaryKey(
+    const docdb::DocKey& doc_key, const Schema& schema, google::protobuf::Struct* key) {
+  auto* fields = key->mutable_fields();
+  auto add = [&schema, fields](const std::vector<PrimitiveValue>& group, size_t first_column) {
+    for (size_t i = 0; i != group.size(); ++i) {
+      const size_t idx = first_column + i;
+      const ColumnSchema* column = idx < schema.num_key_columns() ? &schema.column(idx) : nullptr;
+      auto name = column ? column->name() : "key_" + std::to_string(idx);
+      PrimitiveValueToJson(group[i], column, &(*fields)[name]);
+    }
+  };
+  add(doc_key.hashed_group(), 0);
+  add(doc_key.range_group(), doc_key.hashed_group().size());
+}
+
+// Decodes changes of a single column, or of an element of a collection column.
+void AddColumnChange(
+    const std::vector<PrimitiveValue>& subkeys, const docdb::Value& value, const Schema& schema,
+    CDCRecordPB* record) {
+  const ColumnSchema* column = nullptr;
+  std::string name;
+  if (subkeys[0].value_type() == ValueType::kColumnId) {
+    int idx = schema.find_column_by_id(subkeys[0].GetColumnId());
+    if (idx >= 0) {
+      column = &schema.column(idx);
+      name = column->name();
+    }
+  }
+  if (name.empty()) {
+    name = subkeys[0].ToString();
+  }
+  for (size_t i = 1; i != subkeys.size(); ++i) {
+    name += "[" + subkeys[i].ToString() + "]";
+    column = nullptr;
+  }
+  PrimitiveValueToJson(
+      value.primitive_value(), column, &(*record->mutable_changes()->mutable_fields())[name]);
+}
+
+// Applies a single decoded operation to the stream state, appending the records to send to resp.
+// Records are only sent for operations after the checkpoint the consumer resumes from.
+Status ProcessMessage(
+    const consensus::ReplicateMsg& msg, const Schema& schema, bool send, CDCTabletState* state,
+    GetChangesResponsePB* resp) {
+  const int64_t index = msg.id().index();
+  switch (msg.op_type()) {
+    case consensus::WRITE_OP: {
+      const auto& write_batch = msg.write_request().write_batch();
+      if (write_batch.write_pairs().empty()) {
+        return Status::OK();
+      }
+      if (!write_batch.transaction().transaction_id().empty()) {
+        auto id = VERIFY_RESULT(FullyDecodeTransactionId(
+            write_batch.transaction().transaction_id()));
+        auto it = state->pending.find(id);
+        if (it == state->pending.end()) {
+          it = state->pending.emplace(id, PendingTransaction()).first;
+          it->second.first_op_index = index;
+        }
+        return DecodeWriteBatch(write_batch, schema, msg.hybrid_time(), &it->second.records);
+      }
+      if (!send) {
+        return Status::OK();
+      }
+      std::vector<CDCRecordPB> records;
+      RETURN_NOT_OK(DecodeWriteBatch(write_batch, schema, msg.hybrid_time(), &records));
+      for (auto& record : records) {
+        resp->add_records()->Swap(&record);
+      }
+      return Status::OK();
+    }
+    case consensus::UPDATE_TRANSACTION_OP: {
+      const auto& transaction_state = msg.transaction_state();
+      auto id = VERIFY_RESULT(FullyDecodeTransactionId(transaction_state.transaction_id()));
+      auto it = state->pending.find(id);
+      if (it == state->pending.end()) {
+        return Status::OK();
+      }
+      switch (transaction_state.status()) {
+        case TransactionStatus::APPLYING:
+          if (index > state->committed_index) {
+            state->applied.emplace_back(index, it->second.first_op_index);
+          }
+          if (send) {
+            for (auto& record : it->second.records) {
+              record.set_time(transaction_state.commit_hybrid_time());
+              resp->add_records()->Swap(&record);
+            }
+          }
+          state->pending.erase(it);
+          return Status::OK();
+        case TransactionStatus::ABORTED: FALLTHROUGH_INTENDED;
+        case TransactionStatus::CLEANUP:
+          state->pending.erase(it);
+          return Status::OK();
+        default:
+          return Status::OK();
+      }
+    }
+    default:
+      return Status::OK();
+  }
+}
+
+} // namespace
+
+void CDCTabletState::CommitCheckpoint(int64_t index) {
+  committed_index = index;
+  retain_index = index;
+  applied.erase(
+      std::remove_if(applied.begin(), applied.end(),
+                     [index](const std::pair<int64_t, int64_t>& entry) {
+                       return entry.first <= index;
+                     }),
+      applied.end());
+  // Reading after retain_index should find the first intents of every transaction, that was not
+  // applied at the committed checkpoint.
+  for (const auto& entry : applied) {
+    retain_index = std::min(retain_index, entry.second - 1);
+  }
+  for (const auto& entry : pending) {
+    retain_index = std::min(retain_index, entry.second.first_op_index - 1);
+  }
+}
+
+Status DecodeWriteBatch(
+    const docdb::KeyValueWriteBatchPB& write_batch, const Schema& schema, uint64_t time,
+    std::vector<CDCRecordPB>* records) {
+  // Index of the record for each encoded document key, so all changes of a row in the batch go to
+  // the same record.
+  std::unordered_map<std::string, size_t> row_records;
+  for (const auto& kv_pair : write_batch.write_pairs()) {
+    if (docdb::IsRangeTombstoneKey(kv_pair.key())) {
+      continue;
+    }
+    auto doc_key_size = VERIFY_RESULT(
+        docdb::DocKey::EncodedSize(kv_pair.key(), docdb::DocKeyPart::WHOLE_DOC_KEY));
+    docdb::SubDocKey sub_doc_key;
+    RETURN_NOT_OK(sub_doc_key.FullyDecodeFromKeyWithOptionalHybridTime(kv_pair.key()));
+    docdb::Value value;
+    RETURN_NOT_OK(value.Decode(kv_pair.value()));
+
+    auto inserted = row_records.emplace(kv_pair.key().substr(0, doc_key_size), records->size());
+    if (inserted.second) {
+      records->emplace_back();
+      auto& record = records->back();
+      record.set_time(time);
+      record.set_operation(CDCRecordPB::WRITE);
+      AddPrimaryKey(sub_doc_key.doc_key(), schema, record.mutable_key());
+    }
+    auto& record = (*records)[inserted.first->second];
+
+    const auto& subkeys = sub_doc_key.subkeys();
+    if (subkeys.empty()) {
+      // Whole row is written, a tombstone deletes it.
+      if (value.value_type() == ValueType::kTombstone) {
+        record.set_operation(CDCRecordPB::DELETE);
+        record.clear_changes();
+      }
+      continue;
+    }
+    // The liveness column only marks that the row exists.
+    if (subkeys[0].value_type() == ValueType::kSystemColumnId) {
+      continue;
+    }
+    AddColumnChange(subkeys, value, schema, &record);
+  }
+  return Status::OK();
+}
+
+Status GetChanges(
+    const OpIdPB& from, const GetChangesLimits& limits, tablet::TabletPeer* tablet_peer,
+    CDCTabletState* state, GetChangesResponsePB* resp, GetChangesStats* stats) {
+  auto* tablet = tablet_peer->tablet();
+  auto* consensus = tablet_peer->consensus();
+  if (!tablet || !consensus) {
+    return STATUS_FORMAT(IllegalState, "Tablet $0 is not running", tablet_peer->tablet_id());
+  }
+  const Schema& schema = tablet->metadata()->schema();
+
+  const int64_t resume_index = from.index();
+  if (state->read_index < 0) {
+    state->committed_index = resume_index;
+    state->retain_index = resume_index;
+  }
+  int64_t index = resume_index;
+  if (state->read_index != resume_index) {
+    // Pending transactions are known at the last read position only, rebuild them.
+    state->pending.clear();
+    state->applied.clear();
+    index = std::min(resume_index, state->retain_index);
+  }
+
+  OpIdPB checkpoint = from;
+  bool has_more = true;
+  consensus::ReplicateMsgs msgs;
+  while (has_more && (index < resume_index || resp->records_size() < limits.max_records)) {
+    RETURN_NOT_OK(consensus->ReadReplicatedMessagesForCDC(
+        index, limits.max_batch_size_bytes, &msgs, &has_more));
+    if (msgs.empty()) {
+      break;
+    }
+    for (size_t i = 0; i != msgs.size(); ++i) {
+      const auto& msg = *msgs[i];
+      index = msg.id().index();
+      RETURN_NOT_OK(ProcessMessage(msg, schema, index > resume_index, state, resp));
+      state->read_index = index;
+      ++stats->ops_read;
+      if (index > resume_index) {
+        checkpoint = msg.id();
+        if (resp->records_size() >= limits.max_records) {
+          has_more = has_more || i + 1 != msgs.size();
+          break;
+        }
+      }
+    }
+  }
+
+  stats->records = resp->records_size();
+  *resp->mutable_checkpoint()->mutable_op_id() = checkpoint;
+  resp->set_has_more(has_more);
+  return Status::OK();
+}
+
+} // namespace cdc
+} // namespace yb
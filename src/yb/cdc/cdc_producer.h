@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CDC_CDC_PRODUCER_H
+#define YB_CDC_CDC_PRODUCER_H
+
+#include <stdint.h>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "yb/cdc/cdc_service.pb.h"
+#include "yb/common/transaction.h"
+#include "yb/consensus/consensus_fwd.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Schema;
+
+namespace docdb {
+class KeyValueWriteBatchPB;
+} // namespace docdb
+
+namespace tablet {
+class TabletPeer;
+} // namespace tablet
+
+namespace cdc {
+
+// Changes written by a transaction, that are sent once the transaction is applied.
+struct PendingTransaction {
+  // Index of the first operation that wrote intents of this transaction.
+  int64_t first_op_index = 0;
+  std::vector<CDCRecordPB> records;
+};
+
+// What the producer remembers about a stream on a tablet between GetChanges calls.
+//
+// Records of a transaction are only known when its intents are read from the log, while they are
+// sent when the transaction is applied, possibly many operations later. So the producer keeps the
+// transactions pending at the read position, and the log is retained from the first intents of
+// transactions pending at the committed checkpoint. When a consumer resumes from a checkpoint other
+// than the current read position, pending transactions are rebuilt by reading from there.
+struct CDCTabletState {
+  // Index of the last operation read into this state, -1 if nothing was read yet.
+  int64_t read_index = -1;
+
+  // Index of the checkpoint committed by the consumer.
+  int64_t committed_index = 0;
+
+  // Index of the first operation that should be retained in the log for this stream.
+  int64_t retain_index = 0;
+
+  std::unordered_map<TransactionId, PendingTransaction, TransactionIdHash> pending;
+
+  // Apply operation index and first intents operation index of transactions, that were applied
+  // after the committed checkpoint.
+  std::vector<std::pair<int64_t, int64_t>> applied;
+
+  // Updates committed_index and retain_index after the consumer commits a checkpoint.
+  void CommitCheckpoint(int64_t index);
+};
+
+// Limits of a single GetChanges call.
+struct GetChangesLimits {
+  uint32_t max_records;
+  int max_batch_size_bytes;
+};
+
+// Statistics of a single GetChanges call, used to update stream metrics.
+struct GetChangesStats {
+  size_t ops_read = 0;
+  size_t records = 0;
+};
+
+// Reads changes committed to the tablet after 'from' and appends them to resp, together with the
+// checkpoint to continue from.
+//
+// Completed writes of single shard operations and applied transactions are decoded into row
+// changes. Other operations only advance the checkpoint.
+CHECKED_STATUS GetChanges(
+    const OpIdPB& from, const GetChangesLimits& limits, tablet::TabletPeer* tablet_peer,
+    CDCTabletState* state, GetChangesResponsePB* resp, GetChangesStats* stats);
+
+// Decodes the write batch of a write operation into records, one per changed row. Exposed for
+// tests.
+CHECKED_STATUS DecodeWriteBatch(
+    const docdb::KeyValueWriteBatchPB& write_batch, const Schema& schema, uint64_t time,
+    std::vector<CDCRecordPB>* records);
+
+} // namespace cdc
+} // namespace yb
+
+#endif // YB_CDC_CDC_PRODUCER_H
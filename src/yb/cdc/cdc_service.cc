@@ -0,0 +1,355 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/cdc/cdc_service.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "yb/common/wire_protocol.h"
+#include "yb/consensus/consensus.h"
+#include "yb/consensus/log.h"
+#include "yb/rpc/rpc_context.h"
+#include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/tablet_peer.h"
+#include "yb/tserver/tablet_peer_lookup.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/oid_generator.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(cdc_max_batch_size_bytes, 4_MB,
+             "Maximum size of log operations read at once, while collecting changes for a "
+             "GetChanges call.");
+TAG_FLAG(cdc_max_batch_size_bytes, advanced);
+TAG_FLAG(cdc_max_batch_size_bytes, runtime);
+
+DEFINE_int32(cdc_max_records_per_call, 1000,
+             "Maximum number of records returned by a GetChanges call, when the consumer does "
+             "not specify it.");
+TAG_FLAG(cdc_max_records_per_call, advanced);
+TAG_FLAG(cdc_max_records_per_call, runtime);
+
+DEFINE_int32(cdc_wal_retention_time_secs, 4 * 3600,
+             "How long the log is retained for a CDC stream, that does not read changes, when "
+             "the stream was set up without a retention period.");
+TAG_FLAG(cdc_wal_retention_time_secs, advanced);
+TAG_FLAG(cdc_wal_retention_time_secs, runtime);
+
+METRIC_DEFINE_entity(cdc);
+
+METRIC_DEFINE_counter(cdc, cdc_ops_read, "CDC Operations Read",
+    yb::MetricUnit::kOperations,
+    "Number of log operations read for this CDC stream");
+METRIC_DEFINE_counter(cdc, cdc_records_sent, "CDC Records Sent",
+    yb::MetricUnit::kRows,
+    "Number of change records sent to consumers of this CDC stream");
+METRIC_DEFINE_counter(cdc, cdc_bytes_sent, "CDC Bytes Sent",
+    yb::MetricUnit::kBytes,
+    "Size of change records sent to consumers of this CDC stream");
+METRIC_DEFINE_counter(cdc, cdc_get_changes_calls, "CDC GetChanges Calls",
+    yb::MetricUnit::kRequests,
+    "Number of GetChanges calls served for this CDC stream");
+
+namespace yb {
+namespace cdc {
+
+using tablet::TabletPeer;
+
+namespace {
+
+void SetupErrorAndRespond(CDCErrorPB* error,
+                          const Status& status,
+                          CDCErrorPB::Code code,
+                          rpc::RpcContext* context) {
+  LOG(WARNING) << "Error handling CDCService RPC request from " << context->requestor_string()
+               << ": " << status;
+  StatusToPB(status, error->mutable_status());
+  error->set_code(code);
+  context->RespondSuccess();
+}
+
+} // namespace
+
+// Note, these macros assume the existence of local vars named 'context' and 'resp'.
+#define CDC_RETURN_ERROR(status, code) \
+  do { \
+    SetupErrorAndRespond(resp->mutable_error(), (status), (code), &context); \
+    return; \
+  } while (false)
+
+#define CDC_RETURN_NOT_OK(expr, code) \
+  do { \
+    Status _s = (expr); \
+    if (PREDICT_FALSE(!_s.ok())) { \
+      CDC_RETURN_ERROR(_s, code); \
+    } \
+  } while (false)
+
+struct CDCServiceImpl::TabletStream {
+  std::mutex mutex;
+  CDCTabletState state;
+  CoarseTimePoint last_active = CoarseMonoClock::Now();
+};
+
+struct CDCServiceImpl::Stream {
+  std::string subscriber_uuid;
+  std::string table_id;
+  CDCRecordType record_type;
+  CDCRecordFormat record_format;
+  CoarseMonoClock::Duration retention;
+
+  // Immutable after setup.
+  std::unordered_map<std::string, std::shared_ptr<TabletStream>> tablets;
+
+  scoped_refptr<MetricEntity> metric_entity;
+  scoped_refptr<Counter> ops_read;
+  scoped_refptr<Counter> records_sent;
+  scoped_refptr<Counter> bytes_sent;
+  scoped_refptr<Counter> get_changes_calls;
+};
+
+CDCServiceImpl::CDCServiceImpl(tserver::TabletPeerLookupIf* tablet_peer_lookup,
+                               TabletPeersProvider tablet_peers_provider,
+                               MetricRegistry* metric_registry,
+                               const scoped_refptr<MetricEntity>& metric_entity)
+    : CDCServiceIf(metric_entity),
+      tablet_peer_lookup_(CHECK_NOTNULL(tablet_peer_lookup)),
+      tablet_peers_provider_(std::move(tablet_peers_provider)),
+      metric_registry_(metric_registry) {
+}
+
+CDCServiceImpl::~CDCServiceImpl() {
+}
+
+std::vector<std::shared_ptr<TabletPeer>> CDCServiceImpl::TableTabletPeers(
+    const master::TableIdentifierPB& table) {
+  std::vector<std::shared_ptr<TabletPeer>> result;
+  for (auto& peer : tablet_peers_provider_()) {
+    const auto& metadata = peer->tablet_metadata();
+    if (!metadata) {
+      continue;
+    }
+    if (table.has_table_id() ? metadata->table_id() == table.table_id()
+                             : metadata->table_name() == table.table_name()) {
+      result.push_back(std::move(peer));
+    }
+  }
+  return result;
+}
+
+void CDCServiceImpl::SetupCDC(const SetupCDCRequestPB* req,
+                              SetupCDCResponsePB* resp,
+                              rpc::RpcContext context) {
+  std::vector<std::shared_ptr<TabletPeer>> peers;
+  if (req->tablets_size() > 0) {
+    for (const auto& tablet_id : req->tablets()) {
+      std::shared_ptr<TabletPeer> peer;
+      CDC_RETURN_NOT_OK(tablet_peer_lookup_->GetTabletPeer(tablet_id, &peer),
+                        CDCErrorPB::TABLET_NOT_FOUND);
+      peers.push_back(std::move(peer));
+    }
+  } else if (req->has_table()) {
+    peers = TableTabletPeers(req->table());
+    if (peers.empty()) {
+      CDC_RETURN_ERROR(
+          STATUS_FORMAT(NotFound, "No local tablets of table $0", req->table().ShortDebugString()),
+          CDCErrorPB::TABLE_NOT_FOUND);
+    }
+  } else {
+    CDC_RETURN_ERROR(STATUS(InvalidArgument, "Table or tablets should be specified"),
+                     CDCErrorPB::UNKNOWN_ERROR);
+  }
+
+  auto stream = std::make_shared<Stream>();
+  stream->subscriber_uuid = ObjectIdGenerator().Next();
+  stream->table_id = peers.front()->tablet_metadata()->table_id();
+  stream->record_type = req->record_type();
+  stream->record_format = req->has_record_format() ? req->record_format() : CDCRecordFormat::JSON;
+  stream->retention = std::chrono::seconds(
+      req->has_retention_sec() ? req->retention_sec() : FLAGS_cdc_wal_retention_time_secs);
+  for (const auto& peer : peers) {
+    stream->tablets.emplace(peer->tablet_id(), std::make_shared<TabletStream>());
+  }
+  if (metric_registry_) {
+    MetricEntity::AttributeMap attrs;
+    attrs["table_id"] = stream->table_id;
+    stream->metric_entity = METRIC_ENTITY_cdc.Instantiate(
+        metric_registry_, stream->subscriber_uuid, attrs);
+    stream->ops_read = METRIC_cdc_ops_read.Instantiate(stream->metric_entity);
+    stream->records_sent = METRIC_cdc_records_sent.Instantiate(stream->metric_entity);
+    stream->bytes_sent = METRIC_cdc_bytes_sent.Instantiate(stream->metric_entity);
+    stream->get_changes_calls = METRIC_cdc_get_changes_calls.Instantiate(stream->metric_entity);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    streams_.emplace(stream->subscriber_uuid, stream);
+  }
+  LOG(INFO) << "Set up CDC stream " << stream->subscriber_uuid << " for " << peers.size()
+            << " tablets of table " << stream->table_id;
+  resp->set_subscriber_uuid(stream->subscriber_uuid);
+  context.RespondSuccess();
+}
+
+void CDCServiceImpl::ListTablets(const ListTabletsRequestPB* req,
+                                 ListTabletsResponsePB* resp,
+                                 rpc::RpcContext context) {
+  if (!req->local_only()) {
+    CDC_RETURN_ERROR(STATUS(NotSupported, "Only local tablets could be listed"),
+                     CDCErrorPB::UNKNOWN_ERROR);
+  }
+  ServerRegistrationPB registration;
+  CDC_RETURN_NOT_OK(tablet_peer_lookup_->GetRegistration(&registration),
+                    CDCErrorPB::UNKNOWN_ERROR);
+  for (const auto& peer : TableTabletPeers(req->table())) {
+    auto* tablet = resp->add_tablets();
+    tablet->set_tablet_uuid(peer->tablet_id());
+    *tablet->mutable_tserver() = registration.private_rpc_addresses();
+  }
+  context.RespondSuccess();
+}
+
+CDCServiceImpl::StreamPtr CDCServiceImpl::FindStream(const std::string& subscriber_uuid) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = streams_.find(subscriber_uuid);
+  return it != streams_.end() ? it->second : nullptr;
+}
+
+void CDCServiceImpl::UpdateLogRetention(const std::shared_ptr<TabletPeer>& tablet_peer) {
+  auto* log = tablet_peer->log();
+  if (!log) {
+    return;
+  }
+  const auto now = CoarseMonoClock::Now();
+  int64_t min_index = std::numeric_limits<int64_t>::max();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& entry : streams_) {
+      const auto& stream = *entry.second;
+      auto it = stream.tablets.find(tablet_peer->tablet_id());
+      if (it == stream.tablets.end()) {
+        continue;
+      }
+      auto& tablet_stream = *it->second;
+      std::lock_guard<std::mutex> tablet_lock(tablet_stream.mutex);
+      if (tablet_stream.state.read_index < 0 ||
+          now - tablet_stream.last_active > stream.retention) {
+        continue;
+      }
+      min_index = std::min(min_index, tablet_stream.state.retain_index);
+    }
+  }
+  log->set_cdc_min_replicated_index(min_index);
+}
+
+void CDCServiceImpl::GetChanges(const GetChangesRequestPB* req,
+                                GetChangesResponsePB* resp,
+                                rpc::RpcContext context) {
+  auto stream = FindStream(req->subscriber_uuid());
+  if (!stream) {
+    CDC_RETURN_ERROR(STATUS_FORMAT(NotFound, "Unknown subscriber $0", req->subscriber_uuid()),
+                     CDCErrorPB::SUBSCRIBER_NOT_FOUND);
+  }
+  auto it = stream->tablets.find(req->tablet_uuid());
+  if (it == stream->tablets.end()) {
+    CDC_RETURN_ERROR(
+        STATUS_FORMAT(NotFound, "Tablet $0 is not in stream $1", req->tablet_uuid(),
+                      req->subscriber_uuid()),
+        CDCErrorPB::TABLET_NOT_FOUND);
+  }
+  std::shared_ptr<TabletPeer> tablet_peer;
+  CDC_RETURN_NOT_OK(tablet_peer_lookup_->GetTabletPeer(req->tablet_uuid(), &tablet_peer),
+                    CDCErrorPB::TABLET_NOT_FOUND);
+  CDC_RETURN_NOT_OK(tablet_peer->CheckRunning(), CDCErrorPB::TABLET_NOT_RUNNING);
+
+  auto& tablet_stream = *it->second;
+  GetChangesStats stats;
+  {
+    std::lock_guard<std::mutex> lock(tablet_stream.mutex);
+    tablet_stream.last_active = CoarseMonoClock::Now();
+    auto& state = tablet_stream.state;
+
+    OpIdPB from;
+    if (req->has_from_checkpoint()) {
+      from = req->from_checkpoint().op_id();
+    } else if (state.read_index >= 0) {
+      from.set_term(0);
+      from.set_index(state.read_index);
+    } else {
+      // New consumers start from the latest committed operation.
+      auto committed = tablet_peer->consensus()->GetLastOpId(consensus::COMMITTED_OPID);
+      CDC_RETURN_NOT_OK(committed.status(), CDCErrorPB::TABLET_NOT_RUNNING);
+      from = *committed;
+    }
+
+    GetChangesLimits limits = {
+      req->max_records() > 0 ? req->max_records()
+                             : static_cast<uint32_t>(FLAGS_cdc_max_records_per_call),
+      FLAGS_cdc_max_batch_size_bytes
+    };
+    auto status = cdc::GetChanges(from, limits, tablet_peer.get(), &state, resp, &stats);
+    if (!status.ok()) {
+      resp->Clear();
+      CDC_RETURN_ERROR(status, status.IsNotFound() ? CDCErrorPB::CHECKPOINT_TOO_OLD
+                                                   : CDCErrorPB::UNKNOWN_ERROR);
+    }
+    // Recomputed even without a new checkpoint, since the read could find new pending
+    // transactions.
+    state.CommitCheckpoint(req->has_commit_checkpoint() ? req->commit_checkpoint().op_id().index()
+                                                        : state.committed_index);
+  }
+  UpdateLogRetention(tablet_peer);
+
+  resp->set_record_type(stream->record_type);
+  resp->set_record_format(stream->record_format);
+  if (stream->metric_entity) {
+    stream->get_changes_calls->Increment();
+    stream->ops_read->IncrementBy(stats.ops_read);
+    stream->records_sent->IncrementBy(stats.records);
+    int64_t bytes = 0;
+    for (const auto& record : resp->records()) {
+      bytes += record.ByteSize();
+    }
+    stream->bytes_sent->IncrementBy(bytes);
+  }
+  context.RespondSuccess();
+}
+
+void CDCServiceImpl::GetCheckpoint(const GetCheckpointRequestPB* req,
+                                   GetCheckpointResponsePB* resp,
+                                   rpc::RpcContext context) {
+  auto stream = FindStream(req->subscriber_uuid());
+  if (!stream) {
+    CDC_RETURN_ERROR(STATUS_FORMAT(NotFound, "Unknown subscriber $0", req->subscriber_uuid()),
+                     CDCErrorPB::SUBSCRIBER_NOT_FOUND);
+  }
+  auto it = stream->tablets.find(req->tablet_uuid());
+  if (it == stream->tablets.end()) {
+    CDC_RETURN_ERROR(
+        STATUS_FORMAT(NotFound, "Tablet $0 is not in stream $1", req->tablet_uuid(),
+                      req->subscriber_uuid()),
+        CDCErrorPB::TABLET_NOT_FOUND);
+  }
+  {
+    std::lock_guard<std::mutex> lock(it->second->mutex);
+    auto* op_id = resp->mutable_checkpoint()->mutable_op_id();
+    op_id->set_term(0);
+    op_id->set_index(it->second->state.committed_index);
+  }
+  context.RespondSuccess();
+}
+
+} // namespace cdc
+} // namespace yb
@@ -0,0 +1,101 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CDC_CDC_SERVICE_H
+#define YB_CDC_CDC_SERVICE_H
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/cdc/cdc_producer.h"
+#include "yb/cdc/cdc_service.service.h"
+#include "yb/util/metrics.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+namespace tablet {
+class TabletPeer;
+} // namespace tablet
+
+namespace tserver {
+class TabletPeerLookupIf;
+} // namespace tserver
+
+namespace cdc {
+
+typedef std::function<std::vector<std::shared_ptr<tablet::TabletPeer>>()> TabletPeersProvider;
+
+// Change data capture service of a tablet server.
+//
+// A stream, identified by the subscriber UUID returned by SetupCDC, covers tablets of a table
+// hosted by this server. GetChanges tails the log of a tablet and returns committed row changes in
+// pages, with a checkpoint to continue from. The log of a tablet is retained from the earliest
+// checkpoint committed by its streams, unless a stream was not used for its retention period.
+//
+// Streams and checkpoints are kept in memory.
+class CDCServiceImpl : public CDCServiceIf {
+ public:
+  CDCServiceImpl(tserver::TabletPeerLookupIf* tablet_peer_lookup,
+                 TabletPeersProvider tablet_peers_provider,
+                 MetricRegistry* metric_registry,
+                 const scoped_refptr<MetricEntity>& metric_entity);
+
+  ~CDCServiceImpl();
+
+  void SetupCDC(const SetupCDCRequestPB* req,
+                SetupCDCResponsePB* resp,
+                rpc::RpcContext context) override;
+
+  void ListTablets(const ListTabletsRequestPB* req,
+                   ListTabletsResponsePB* resp,
+                   rpc::RpcContext context) override;
+
+  void GetChanges(const GetChangesRequestPB* req,
+                  GetChangesResponsePB* resp,
+                  rpc::RpcContext context) override;
+
+  void GetCheckpoint(const GetCheckpointRequestPB* req,
+                     GetCheckpointResponsePB* resp,
+                     rpc::RpcContext context) override;
+
+ private:
+  struct TabletStream;
+  struct Stream;
+  typedef std::shared_ptr<Stream> StreamPtr;
+
+  // Returns local tablets of the specified table.
+  std::vector<std::shared_ptr<tablet::TabletPeer>> TableTabletPeers(
+      const master::TableIdentifierPB& table);
+
+  StreamPtr FindStream(const std::string& subscriber_uuid);
+
+  // Recomputes the part of the log of the tablet, that is retained for CDC streams.
+  void UpdateLogRetention(const std::shared_ptr<tablet::TabletPeer>& tablet_peer);
+
+  tserver::TabletPeerLookupIf* const tablet_peer_lookup_;
+  const TabletPeersProvider tablet_peers_provider_;
+  MetricRegistry* const metric_registry_;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, StreamPtr> streams_;
+};
+
+} // namespace cdc
+} // namespace yb
+
+#endif // YB_CDC_CDC_SERVICE_H
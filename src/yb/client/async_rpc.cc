@@ -25,6 +25,8 @@
 
 #include "yb/util/cast.h"
 #include "yb/util/debug-util.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/logging.h"
 
 // TODO: do we need word Redis in following two metrics? ReadRpc and WriteRpc objects emitting
@@ -45,6 +47,13 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_client_time_to_send,
     "Time taken for a Write/Read rpc to be sent to the server", yb::MetricUnit::kMicroseconds,
     "Microseconds spent before sending the request to the server", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, hedged_reads_issued, "Hedged reads issued", yb::MetricUnit::kRequests,
+    "Number of reads that were duplicated to another replica because the first one did not "
+    "respond in time");
+METRIC_DEFINE_counter(
+    server, hedged_reads_won, "Hedged reads won", yb::MetricUnit::kRequests,
+    "Number of hedged reads whose answer was used instead of the one from the first replica");
 DECLARE_bool(rpc_dump_all_traces);
 DECLARE_bool(collect_end_to_end_traces);
 
@@ -58,6 +67,23 @@ DEFINE_bool(detect_duplicates_for_retryable_requests, true,
             "Enable tracking of write requests that prevents the same write from being applied "
                 "twice.");
 
+DEFINE_bool(enable_hedged_reads, false,
+            "Whether reads that could be served by any replica, such as consistent prefix reads, "
+            "are duplicated to the closest other replica when the first one does not respond in "
+            "time. The first valid answer is used.");
+TAG_FLAG(enable_hedged_reads, runtime);
+
+DEFINE_double(hedged_read_delay_percentile, 99.0,
+              "Percentile of the remote read latency after which an unanswered read is hedged.");
+TAG_FLAG(hedged_read_delay_percentile, advanced);
+TAG_FLAG(hedged_read_delay_percentile, runtime);
+
+DEFINE_int32(hedged_read_min_delay_ms, 5,
+             "Minimal delay before an unanswered read is hedged. Also used until enough remote "
+             "reads have been observed to compute the percentile.");
+TAG_FLAG(hedged_read_min_delay_ms, advanced);
+TAG_FLAG(hedged_read_min_delay_ms, runtime);
+
 DEFINE_CAPABILITY(PickReadTimeAtTabletServer, 0x8284d67b);
 
 using namespace std::placeholders;
@@ -97,7 +123,9 @@ AsyncRpcMetrics::AsyncRpcMetrics(const scoped_refptr<yb::MetricEntity>& entity)
       remote_read_rpc_time(METRIC_handler_latency_yb_client_read_remote.Instantiate(entity)),
       local_write_rpc_time(METRIC_handler_latency_yb_client_write_local.Instantiate(entity)),
       local_read_rpc_time(METRIC_handler_latency_yb_client_read_local.Instantiate(entity)),
-      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)) {
+      time_to_send(METRIC_handler_latency_yb_client_time_to_send.Instantiate(entity)),
+      hedged_reads_issued(METRIC_hedged_reads_issued.Instantiate(entity)),
+      hedged_reads_won(METRIC_hedged_reads_won.Instantiate(entity)) {
 }
 
 AsyncRpc::AsyncRpc(AsyncRpcData* data, YBConsistencyLevel yb_consistency_level)
@@ -159,13 +187,17 @@ const YBTable* AsyncRpc::table() const {
 void AsyncRpc::Finished(const Status& status) {
   Status new_status = status;
   if (tablet_invoker_.Done(&new_status)) {
-    ProcessResponseFromTserver(new_status);
-    batcher_->RemoveInFlightOpsAfterFlushing(ops_, new_status, MakeFlushExtraResult());
-    batcher_->CheckForFinishedFlush();
+    ProcessResponse(new_status);
     retained_self_.reset();
   }
 }
 
+void AsyncRpc::ProcessResponse(const Status& status) {
+  ProcessResponseFromTserver(status);
+  batcher_->RemoveInFlightOpsAfterFlushing(ops_, status, MakeFlushExtraResult());
+  batcher_->CheckForFinishedFlush();
+}
+
 void AsyncRpc::Failed(const Status& status) {
   std::string error_message = status.message().ToBuffer();
   auto redis_error_code = status.IsInvalidCommand() || status.IsInvalidArgument() ?
@@ -645,12 +677,115 @@ void ReadRpc::CallRemoteMethod() {
                        // Detailed explanation in WriteRpc::SendRpcToTserver.
   TRACE_TO(trace, "SendRpcToTserver");
   ADOPT_TRACE(trace.get());
+  hedge_armed_ = ShouldHedge();
+  if (hedge_armed_) {
+    std::lock_guard<std::mutex> lock(hedge_mutex_);
+    hedge_state_ = HedgeState::kScheduled;
+    hedge_task_id_ = retrier().messenger()->scheduler().Schedule(
+        [this, self = shared_from_this()](const Status& status) { SendHedge(status); },
+        HedgeDelay().ToSteadyDuration());
+  }
   tablet_invoker_.proxy()->ReadAsync(
-      req_, &resp_, PrepareController(),
+      req_, hedge_armed_ ? &primary_resp_ : &resp_, PrepareController(),
       std::bind(&ReadRpc::Finished, this, Status::OK()));
   TRACE_TO(trace, "RpcDispatched Asynchronously");
 }
 
+bool ReadRpc::ShouldHedge() const {
+  // Only the first attempt is hedged, retries are sent to the leader. A local primary call would
+  // keep using req_ after the hedge won, so it is not hedged either.
+  return FLAGS_enable_hedged_reads && num_attempts() == 1 &&
+         req_.consistency_level() == YBConsistencyLevel::CONSISTENT_PREFIX &&
+         !req_.has_transaction() && !tablet_invoker_.local_tserver_only() && !IsLocalCall();
+}
+
+MonoDelta ReadRpc::HedgeDelay() const {
+  // Don't trust the percentile until the histogram has seen some reads.
+  constexpr uint64_t kMinReadsForPercentile = 100;
+
+  auto result = MonoDelta::FromMilliseconds(FLAGS_hedged_read_min_delay_ms);
+  if (async_rpc_metrics_) {
+    auto* histogram = async_rpc_metrics_->remote_read_rpc_time->histogram();
+    if (histogram->TotalCount() >= kMinReadsForPercentile) {
+      result = std::max(result, MonoDelta::FromMicroseconds(
+          histogram->ValueAtPercentile(FLAGS_hedged_read_delay_percentile)));
+    }
+  }
+  return result;
+}
+
+void ReadRpc::SendHedge(const Status& status) {
+  if (!status.ok()) {
+    // Aborted because the primary call has already returned.
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(hedge_mutex_);
+    hedge_task_id_ = rpc::kUninitializedScheduledTaskId;
+    if (hedge_state_ != HedgeState::kScheduled || primary_done_) {
+      return;
+    }
+    hedge_state_ = HedgeState::kDone;
+    auto* ts = tablet_invoker_.SelectHedgeTabletServer();
+    if (!ts) {
+      return;
+    }
+    // req_ is not modified until one of the answers is processed, which requires hedge_mutex_.
+    hedge_req_.CopyFrom(req_);
+    hedge_controller_.set_timeout(retrier().controller().timeout());
+    hedge_state_ = HedgeState::kInFlight;
+    TRACE_TO(trace_, "Hedging read to $0", ts->ToString());
+    // Send the hedge outside of the lock, since its callback could be invoked synchronously.
+    hedge_proxy_ = ts->proxy();
+  }
+  if (async_rpc_metrics_) {
+    async_rpc_metrics_->hedged_reads_issued->Increment();
+  }
+  hedge_proxy_->ReadAsync(
+      hedge_req_, &hedge_resp_, &hedge_controller_,
+      [this, self = shared_from_this()] { HedgeFinished(); });
+}
+
+void ReadRpc::HedgeFinished() {
+  std::unique_lock<std::mutex> lock(hedge_mutex_);
+  hedge_state_ = HedgeState::kDone;
+  if (completed_) {
+    // The primary call has already provided the answer.
+    return;
+  }
+  if (hedge_controller_.status().ok() && !hedge_resp_.has_error()) {
+    completed_ = true;
+    hedge_won_ = true;
+    resp_.Swap(&hedge_resp_);
+    const bool primary_done = primary_done_;
+    lock.unlock();
+    TRACE_TO(trace_, "Hedged read won");
+    if (async_rpc_metrics_) {
+      async_rpc_metrics_->hedged_reads_won->Increment();
+    }
+    ProcessResponse(Status::OK());
+    if (primary_done) {
+      retained_self_.reset();
+    }
+    return;
+  }
+  VLOG(2) << ToString() << ": Hedged read failed: "
+          << (hedge_controller_.status().ok() ? hedge_resp_.error().ShortDebugString()
+                                              : hedge_controller_.status().ToString());
+  if (!primary_done_) {
+    return;
+  }
+  // The primary call has failed as well, handle its answer as usual.
+  completed_ = true;
+  resp_.Swap(&primary_resp_);
+  lock.unlock();
+  AsyncRpc::Finished(Status::OK());
+}
+
+const rpc::RpcController& ReadRpc::response_controller() const {
+  return hedge_won_ ? hedge_controller_ : retrier().controller();
+}
+
 void ReadRpc::Finished(const Status& status) {
   // It is possible that call succeeded, but failed to send response.
   // So in case of retry to should tell server that it could have metadata.
@@ -658,6 +793,27 @@ void ReadRpc::Finished(const Status& status) {
       req_.transaction().isolation() == IsolationLevel::SERIALIZABLE_ISOLATION) {
     req_.set_may_have_metadata(true);
   }
+  if (hedge_armed_) {
+    std::unique_lock<std::mutex> lock(hedge_mutex_);
+    primary_done_ = true;
+    if (completed_) {
+      // The hedged read has won, this call was the last user of this object.
+      lock.unlock();
+      retained_self_.reset();
+      return;
+    }
+    const bool valid = retrier().controller().status().ok() && !primary_resp_.has_error();
+    if (!valid && hedge_state_ == HedgeState::kInFlight) {
+      // Wait for the hedged read, it could still provide a valid answer.
+      return;
+    }
+    if (hedge_state_ == HedgeState::kScheduled) {
+      retrier().messenger()->scheduler().Abort(hedge_task_id_);
+      hedge_state_ = HedgeState::kDone;
+    }
+    completed_ = true;
+    resp_.Swap(&primary_resp_);
+  }
   AsyncRpc::Finished(status);
 }
 
@@ -727,7 +883,7 @@ void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
         const auto& ql_response = ql_op->response();
         if (ql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(response_controller().GetSidecar(
               ql_response.rows_data_sidecar(), &rows_data));
           ql_op->mutable_rows_data()->assign(util::to_char_ptr(rows_data.data()), rows_data.size());
         }
@@ -745,7 +901,7 @@ void ReadRpc::SwapRequestsAndResponses(bool skip_responses) {
         const auto& pgsql_response = pgsql_op->response();
         if (pgsql_response.has_rows_data_sidecar()) {
           Slice rows_data;
-          CHECK_OK(retrier().controller().GetSidecar(
+          CHECK_OK(response_controller().GetSidecar(
               pgsql_response.rows_data_sidecar(), &rows_data));
           down_cast<YBPgsqlReadOp*>(yb_op)->mutable_rows_data()->assign(
               util::to_char_ptr(rows_data.data()), rows_data.size());
@@ -18,7 +18,11 @@
 
 #include "yb/common/read_hybrid_time.h"
 
+#include "yb/gutil/thread_annotations.h"
+
 #include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/rpc_controller.h"
+#include "yb/rpc/scheduler.h"
 
 #include "yb/tserver/tserver_service.proxy.h"
 
@@ -44,6 +48,8 @@ struct AsyncRpcMetrics {
   scoped_refptr<Histogram> local_write_rpc_time;
   scoped_refptr<Histogram> local_read_rpc_time;
   scoped_refptr<Histogram> time_to_send;
+  scoped_refptr<Counter> hedged_reads_issued;
+  scoped_refptr<Counter> hedged_reads_won;
 };
 
 struct AsyncRpcData {
@@ -99,6 +105,9 @@ class AsyncRpc : public rpc::Rpc, public TabletRpc {
 
   void Failed(const Status& status) override;
 
+  // Processes the final response and hands the ops back to the batcher.
+  void ProcessResponse(const Status& status);
+
   // Is this a local call?
   bool IsLocalCall() const;
 
@@ -159,6 +168,10 @@ class WriteRpc : public AsyncRpcBase<tserver::WriteRequestPB, tserver::WriteResp
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  MonoDelta RetryDelay() const override {
+    return MonoDelta::FromMilliseconds(resp_.retry_after_ms());
+  }
 };
 
 class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadResponsePB> {
@@ -173,6 +186,47 @@ class ReadRpc : public AsyncRpcBase<tserver::ReadRequestPB, tserver::ReadRespons
   void SwapRequestsAndResponses(bool skip_responses);
   void CallRemoteMethod() override;
   void ProcessResponseFromTserver(const Status& status) override;
+
+  MonoDelta RetryDelay() const override {
+    return MonoDelta::FromMilliseconds(resp_.retry_after_ms());
+  }
+
+  // Whether the current attempt could be hedged, i.e. it accepts an answer from any replica.
+  bool ShouldHedge() const;
+
+  // Delay after which a read that has not been answered yet is hedged.
+  MonoDelta HedgeDelay() const;
+
+  void SendHedge(const Status& status);
+  void HedgeFinished();
+
+  // Controller that received the response being processed.
+  const rpc::RpcController& response_controller() const;
+
+  enum class HedgeState {
+    kNone,
+    kScheduled,
+    kInFlight,
+    kDone,
+  };
+
+  // When the first attempt of a read is hedged, its response is received into primary_resp_ and
+  // the hedge uses its own request, response and controller. The first valid answer is moved to
+  // resp_ and processed, the other one is dropped. This object is kept alive until both calls
+  // have returned.
+  bool hedge_armed_ = false;
+  std::mutex hedge_mutex_;
+  HedgeState hedge_state_ GUARDED_BY(hedge_mutex_) = HedgeState::kNone;
+  rpc::ScheduledTaskId hedge_task_id_ GUARDED_BY(hedge_mutex_) =
+      rpc::kUninitializedScheduledTaskId;
+  bool primary_done_ GUARDED_BY(hedge_mutex_) = false;
+  bool completed_ GUARDED_BY(hedge_mutex_) = false;
+  bool hedge_won_ = false;
+  tserver::ReadResponsePB primary_resp_;
+  tserver::ReadRequestPB hedge_req_;
+  tserver::ReadResponsePB hedge_resp_;
+  rpc::RpcController hedge_controller_;
+  std::shared_ptr<tserver::TabletServerServiceProxy> hedge_proxy_;
 };
 
 }  // namespace internal
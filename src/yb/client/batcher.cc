@@ -33,6 +33,7 @@
 #include "yb/client/batcher.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <set>
@@ -265,6 +266,69 @@ void Batcher::FlushAsync(StatusFunctor callback) {
 Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
   // As soon as we get the op, start looking up where it belongs,
   // so that when the user calls Flush, we are ready to go.
+  auto in_flight_op = VERIFY_RESULT(PrepareInFlightOp(std::move(yb_op)));
+  AddInFlightOps({in_flight_op});
+  VLOG(3) << "Looking up tablet for " << in_flight_op->yb_op->ToString();
+
+  if (in_flight_op->yb_op->tablet()) {
+    auto tablet = in_flight_op->yb_op->tablet();
+    TabletLookupFinished(std::move(in_flight_op), tablet);
+  } else {
+    // deadline_ is set in FlushAsync(), after all Add() calls are done, so
+    // here we're forced to create a new deadline.
+    auto deadline = ComputeDeadlineUnlocked();
+    client_->data_->meta_cache_->LookupTabletByKey(
+        in_flight_op->yb_op->table(), in_flight_op->partition_key, deadline,
+        std::bind(&Batcher::TabletLookupFinished, BatcherPtr(this), in_flight_op, _1));
+  }
+  return Status::OK();
+}
+
+Status Batcher::Add(const std::vector<shared_ptr<YBOperation>>& yb_ops) {
+  InFlightOps in_flight_ops;
+  in_flight_ops.reserve(yb_ops.size());
+  Status status;
+  for (const auto& yb_op : yb_ops) {
+    auto in_flight_op = PrepareInFlightOp(yb_op);
+    if (!in_flight_op.ok()) {
+      status = in_flight_op.status();
+      error_collector_->AddError(yb_op, status);
+      break;
+    }
+    in_flight_ops.push_back(std::move(*in_flight_op));
+  }
+  if (in_flight_ops.empty()) {
+    return status;
+  }
+  AddInFlightOps(in_flight_ops);
+
+  // Operations whose partition keys fall into the same partition of the table are destined for
+  // the same tablet, so they share a single lookup.
+  typedef std::pair<const YBTable*, const std::string*> PartitionRef;
+  std::map<PartitionRef, InFlightOps> lookups;
+  for (auto& in_flight_op : in_flight_ops) {
+    if (in_flight_op->yb_op->tablet()) {
+      auto tablet = in_flight_op->yb_op->tablet();
+      TabletLookupFinished(std::move(in_flight_op), tablet);
+      continue;
+    }
+    const auto* table = in_flight_op->yb_op->table();
+    const auto& partition_start = table->FindPartitionStart(in_flight_op->partition_key);
+    lookups[PartitionRef(table, &partition_start)].push_back(std::move(in_flight_op));
+  }
+  VLOG(3) << "Looking up " << lookups.size() << " tablets for " << yb_ops.size() << " ops";
+
+  auto deadline = ComputeDeadlineUnlocked();
+  for (auto& lookup : lookups) {
+    client_->data_->meta_cache_->LookupTabletByKey(
+        lookup.first.first, *lookup.first.second, deadline,
+        std::bind(&Batcher::TabletsLookupFinished, BatcherPtr(this), std::move(lookup.second),
+                  _1));
+  }
+  return status;
+}
+
+Result<InFlightOpPtr> Batcher::PrepareInFlightOp(shared_ptr<YBOperation> yb_op) {
   auto in_flight_op = std::make_shared<InFlightOp>();
   RETURN_NOT_OK(yb_op->GetPartitionKey(&in_flight_op->partition_key));
   in_flight_op->yb_op = yb_op;
@@ -302,31 +366,18 @@ Status Batcher::Add(shared_ptr<YBOperation> yb_op) {
         break;
     }
   }
-
-  AddInFlightOp(in_flight_op);
-  VLOG(3) << "Looking up tablet for " << in_flight_op->yb_op->ToString();
-
-  if (yb_op->tablet()) {
-    TabletLookupFinished(std::move(in_flight_op), yb_op->tablet());
-  } else {
-    // deadline_ is set in FlushAsync(), after all Add() calls are done, so
-    // here we're forced to create a new deadline.
-    auto deadline = ComputeDeadlineUnlocked();
-    client_->data_->meta_cache_->LookupTabletByKey(
-        in_flight_op->yb_op->table(), in_flight_op->partition_key, deadline,
-        std::bind(&Batcher::TabletLookupFinished, BatcherPtr(this), in_flight_op, _1));
-  }
-  return Status::OK();
+  return in_flight_op;
 }
 
-void Batcher::AddInFlightOp(const InFlightOpPtr& op) {
-  DCHECK_EQ(op->state, InFlightOpState::kLookingUpTablet);
-
+void Batcher::AddInFlightOps(const InFlightOps& ops) {
   std::lock_guard<simple_spinlock> l(mutex_);
   CHECK_EQ(state_, kGatheringOps);
-  CHECK(ops_.insert(op).second);
-  op->sequence_number_ = next_op_sequence_number_++;
-  ++outstanding_lookups_;
+  for (const auto& op : ops) {
+    DCHECK_EQ(op->state, InFlightOpState::kLookingUpTablet);
+    CHECK(ops_.insert(op).second);
+    op->sequence_number_ = next_op_sequence_number_++;
+  }
+  outstanding_lookups_ += ops.size();
 }
 
 bool Batcher::IsAbortedUnlocked() const {
@@ -354,38 +405,50 @@ void Batcher::MarkInFlightOpFailedUnlocked(const InFlightOpPtr& in_flight_op, co
 
 void Batcher::TabletLookupFinished(
     InFlightOpPtr op, const Result<internal::RemoteTabletPtr>& lookup_result) {
+  TabletsLookupFinished({std::move(op)}, lookup_result);
+}
+
+void Batcher::TabletsLookupFinished(
+    const InFlightOps& ops, const Result<internal::RemoteTabletPtr>& lookup_result) {
   // Acquire the batcher lock early to atomically:
   // 1. Test if the batcher was aborted, and
   // 2. Change the op state.
   {
     std::lock_guard<simple_spinlock> l(mutex_);
 
-    if (lookup_result.ok()) {
-      op->tablet = *lookup_result;
-    }
+    outstanding_lookups_ -= ops.size();
+    const bool aborted = IsAbortedUnlocked();
 
-    --outstanding_lookups_;
+    for (const auto& op : ops) {
+      if (lookup_result.ok()) {
+        op->tablet = *lookup_result;
+      }
 
-    if (IsAbortedUnlocked()) {
-      VLOG(1) << "Aborted batch: TabletLookupFinished for " << op->yb_op->ToString();
-      MarkInFlightOpFailedUnlocked(op, STATUS(Aborted, "Batch aborted"));
-      // 'op' is deleted by above function.
-      return;
-    }
+      if (aborted) {
+        VLOG(1) << "Aborted batch: TabletLookupFinished for " << op->yb_op->ToString();
+        MarkInFlightOpFailedUnlocked(op, STATUS(Aborted, "Batch aborted"));
+        // 'op' is deleted by above function.
+        continue;
+      }
 
-    VLOG(3) << "TabletLookupFinished for " << op->yb_op->ToString() << ": " << lookup_result
-            << ", outstanding lookups: " << outstanding_lookups_;
+      VLOG(3) << "TabletLookupFinished for " << op->yb_op->ToString() << ": " << lookup_result
+              << ", outstanding lookups: " << outstanding_lookups_;
 
-    if (lookup_result.ok()) {
-      std::lock_guard<simple_spinlock> l2(op->lock_);
-      CHECK_EQ(op->state, InFlightOpState::kLookingUpTablet);
-      CHECK(*lookup_result);
+      if (lookup_result.ok()) {
+        std::lock_guard<simple_spinlock> l2(op->lock_);
+        CHECK_EQ(op->state, InFlightOpState::kLookingUpTablet);
+        CHECK(*lookup_result);
 
-      op->state = InFlightOpState::kBufferedToTabletServer;
+        op->state = InFlightOpState::kBufferedToTabletServer;
+        op->group = GetOpGroup(op);
 
-      ops_queue_.push_back(op);
-    } else {
-      MarkInFlightOpFailedUnlocked(op, lookup_result.status());
+        ops_queue_.push_back(op);
+      } else {
+        MarkInFlightOpFailedUnlocked(op, lookup_result.status());
+      }
+    }
+    if (aborted) {
+      return;
     }
   }
 
@@ -404,32 +467,62 @@ void Batcher::TransactionReady(const Status& status, const BatcherPtr& self) {
   }
 }
 
-YB_DEFINE_ENUM(OpGroup, (kWrite)(kLeaderRead)(kConsistentPrefixRead));
-
 namespace {
 inline bool IsOkToReadFromFollower(const InFlightOpPtr& op) {
   return op->yb_op->type() == YBOperation::Type::REDIS_READ &&
          FLAGS_redis_allow_reads_from_followers;
 }
 
-inline bool IsQLConsistentPrefixRead(const InFlightOpPtr& op) {
-  return op->yb_op->type() == YBOperation::Type::QL_READ &&
-         std::static_pointer_cast<YBqlReadOp>(op->yb_op)->yb_consistency_level() ==
-         YBConsistencyLevel::CONSISTENT_PREFIX;
+inline bool IsConsistentPrefixRead(const InFlightOpPtr& op) {
+  switch (op->yb_op->type()) {
+    case YBOperation::Type::QL_READ:
+      return std::static_pointer_cast<YBqlReadOp>(op->yb_op)->yb_consistency_level() ==
+             YBConsistencyLevel::CONSISTENT_PREFIX;
+    case YBOperation::Type::PGSQL_READ:
+      return std::static_pointer_cast<YBPgsqlReadOp>(op->yb_op)->yb_consistency_level() ==
+             YBConsistencyLevel::CONSISTENT_PREFIX;
+    default:
+      return false;
+  }
 }
 } // namespace
 
-OpGroup GetOpGroup(const InFlightOpPtr& op) {
+OpGroup Batcher::GetOpGroup(const InFlightOpPtr& op) {
   if (!op->yb_op->read_only()) {
     return OpGroup::kWrite;
   }
-  if (IsOkToReadFromFollower(op) || IsQLConsistentPrefixRead(op)) {
+  if (IsOkToReadFromFollower(op) || IsConsistentPrefixRead(op)) {
     return OpGroup::kConsistentPrefixRead;
   }
 
   return OpGroup::kLeaderRead;
 }
 
+bool Batcher::CanCommitInOnePhaseUnlocked() const {
+  if (!commit_after_flush_ || ops_queue_.empty()) {
+    return false;
+  }
+  const RemoteTablet* tablet = nullptr;
+  int num_sidecars = 0;
+  for (const auto& op : ops_queue_) {
+    // Index maintenance is done by tablet servers in context of transaction.
+    const auto* table = op->yb_op->table();
+    if (op->yb_op->read_only() || !table->index_map().empty() || table->IsIndex()) {
+      return false;
+    }
+    if (tablet == nullptr) {
+      tablet = op->tablet.get();
+    } else if (tablet != op->tablet.get()) {
+      return false;
+    }
+    if (op->yb_op->returns_sidecar()) {
+      num_sidecars++;
+    }
+  }
+  // All ops should fit into one write, see FlushBuffersIfReady.
+  return num_sidecars < rpc::CallResponse::kMaxSidecarSlices;
+}
+
 void Batcher::FlushBuffersIfReady() {
   InFlightOps ops;
 
@@ -450,19 +543,27 @@ void Batcher::FlushBuffersIfReady() {
       return;
     }
 
+    if (ops_queue_.empty()) {
+      return;
+    }
+
     auto transaction = this->transaction();
     if (transaction) {
       force_consistent_read = true;
-      // If this Batcher is executed in context of transaction,
-      // then this transaction should initialize metadata used by RPC calls.
+      // When the whole transaction is a single write to one tablet, it is sent without
+      // transaction metadata, so neither intents nor the status tablet are involved.
+      //
+      // Otherwise this transaction should initialize metadata used by RPC calls.
       //
       // If transaction is not yet ready to do it, then it will notify as via provided when
       // it could be done.
-      if (!transaction->Prepare(ops_,
+      if (!(CanCommitInOnePhaseUnlocked() && transaction->TryCommitInOnePhase()) &&
+          !transaction->Prepare(ops_,
                                 force_consistent_read_,
                                 std::bind(&Batcher::TransactionReady, this, _1, BatcherPtr(this)),
                                 &transaction_metadata_,
-                                &may_have_metadata_)) {
+                                &may_have_metadata_,
+                                pipelined_flush_id_)) {
         return;
       }
     }
@@ -478,10 +579,8 @@ void Batcher::FlushBuffersIfReady() {
             ops.end(),
             [](const InFlightOpPtr& lhs, const InFlightOpPtr& rhs) {
     if (lhs->tablet.get() == rhs->tablet.get()) {
-      auto lgroup = GetOpGroup(lhs);
-      auto rgroup = GetOpGroup(rhs);
-      if (lgroup != rgroup) {
-        return lgroup < rgroup;
+      if (lhs->group != rhs->group) {
+        return lhs->group < rhs->group;
       }
       return lhs->sequence_number_ < rhs->sequence_number_;
     }
@@ -490,10 +589,10 @@ void Batcher::FlushBuffersIfReady() {
 
   // Now flush the ops for each tablet.
   auto start = ops.begin();
-  auto start_group = GetOpGroup(*start);
+  auto start_group = (**start).group;
   int num_sidecars = 0; // QL read ops and some QL write ops return rows in a sidecar.
   for (auto it = start; it != ops.end(); ++it) {
-    auto it_group = GetOpGroup(*it);
+    auto it_group = (**it).group;
     // Aggregate and flush the ops so far if either:
     //   - we reached the next tablet or group
     //   - we gathered more ops with rows result than we can handle in one call (kMaxSidecarSlices).
@@ -550,7 +649,7 @@ void Batcher::RequestFinished(const TabletId& tablet_id, RetryableRequestId requ
 }
 
 void Batcher::FlushBuffer(
-    RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
+    RemoteTablet* tablet, InFlightOps::iterator begin, InFlightOps::iterator end,
     const bool allow_local_calls_in_curr_thread, const bool need_consistent_read) {
   VLOG(3) << "FlushBuffersIfReady: already in flushing state, immediately flushing to "
           << tablet->tablet_id();
@@ -565,9 +664,12 @@ void Batcher::FlushBuffer(
 
   // Split the read operations according to consistency levels since based on consistency
   // levels the read algorithm would differ.
-  InFlightOps ops(begin, end);
+  //
+  // Ops are moved out of the sorted batch, FlushBuffersIfReady does not access them after
+  // the flush, so there is no need to touch the reference counters of shared pointers.
+  auto op_group = (**begin).group;
+  InFlightOps ops(std::make_move_iterator(begin), std::make_move_iterator(end));
   std::shared_ptr<AsyncRpc> rpc;
-  auto op_group = GetOpGroup(*begin);
   AsyncRpcData data{this, tablet, allow_local_calls_in_curr_thread, need_consistent_read,
                     std::move(ops)};
   switch (op_group) {
@@ -37,6 +37,7 @@
 #include <vector>
 
 #include "yb/client/async_rpc.h"
+#include "yb/client/in_flight_op.h"
 #include "yb/client/transaction.h"
 
 #include "yb/common/consistent_read_point.h"
@@ -111,6 +112,14 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // NOTE: If this returns not-OK, does not take ownership of 'write_op'.
   CHECKED_STATUS Add(std::shared_ptr<YBOperation> yb_op) WARN_UNUSED_RESULT;
 
+  // Add operations to the batch, like Add() called for each of them. Partition keys of all the
+  // operations are computed before the tablets are looked up, and operations that fall into the
+  // same partition share a single lookup.
+  //
+  // If an operation could not be added, the preceding ones are still added, the failure is
+  // reported to the error collector and returned.
+  CHECKED_STATUS Add(const std::vector<std::shared_ptr<YBOperation>>& yb_ops) WARN_UNUSED_RESULT;
+
   // Return true if any operations are still pending. An operation is no longer considered
   // pending once it has either errored or succeeded.  Operations are considering pending
   // as soon as they are added, even if Flush has not been called.
@@ -159,6 +168,13 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   void set_allow_local_calls_in_curr_thread(bool flag) { allow_local_calls_in_curr_thread_ = flag; }
 
+  // Notifies batcher that transaction will be committed right after this flush, so when all
+  // operations are writes to the same tablet the transaction could be committed in one phase.
+  void set_commit_after_flush(bool value) { commit_after_flush_ = value; }
+
+  // Marks this batch as a pipelined flush of the transaction, see YBSession::FlushPipelined.
+  void set_pipelined_flush_id(int64_t value) { pipelined_flush_id_ = value; }
+
   bool allow_local_calls_in_curr_thread() const { return allow_local_calls_in_curr_thread_; }
 
   const std::string& proxy_uuid() const;
@@ -181,8 +197,11 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   ~Batcher();
 
-  // Add an op to the in-flight set and increment the ref-count.
-  void AddInFlightOp(const InFlightOpPtr& op);
+  // Compute the partition key and hash code of the operation.
+  Result<InFlightOpPtr> PrepareInFlightOp(std::shared_ptr<YBOperation> yb_op);
+
+  // Add ops to the in-flight set and increment the ref-count.
+  void AddInFlightOps(const InFlightOps& ops);
 
   void RemoveInFlightOpsAfterFlushing(
       const InFlightOps& ops, const Status& status, FlushExtraResult flush_extra_result);
@@ -191,6 +210,9 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // processing wherever they are.
   bool IsAbortedUnlocked() const;
 
+  // Whether queued ops could be sent as one-phase commit of the transaction.
+  bool CanCommitInOnePhaseUnlocked() const;
+
   // Combines new error to existing ones. I.e. updates combined error with new status.
   void CombineErrorUnlocked(const InFlightOpPtr& in_flight_op, const Status& status)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -202,9 +224,12 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   void CheckForFinishedFlush();
+
+  static OpGroup GetOpGroup(const InFlightOpPtr& op);
+
   void FlushBuffersIfReady();
   void FlushBuffer(
-      RemoteTablet* tablet, InFlightOps::const_iterator begin, InFlightOps::const_iterator end,
+      RemoteTablet* tablet, InFlightOps::iterator begin, InFlightOps::iterator end,
       bool allow_local_calls_in_curr_thread, bool need_consistent_read);
 
   // Calls/Schedules flush_callback_ and resets it to free resources.
@@ -223,6 +248,8 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
 
   // Async Callbacks.
   void TabletLookupFinished(InFlightOpPtr op, const Result<internal::RemoteTabletPtr>& result);
+  void TabletsLookupFinished(
+      const InFlightOps& ops, const Result<internal::RemoteTabletPtr>& result);
 
   // Compute a new deadline based on timeout_. If no timeout_ has been set,
   // uses a hard-coded default and issues periodic warnings.
@@ -286,6 +313,11 @@ class Batcher : public RefCountedThreadSafe<Batcher> {
   // If true, we might allow the local calls to be run in the same IPC thread.
   bool allow_local_calls_in_curr_thread_ = true;
 
+  bool commit_after_flush_ = false;
+
+  // ID of the pipelined flush of the transaction, 0 if this batch is not pipelined.
+  int64_t pipelined_flush_id_ = 0;
+
   // The number of bytes used in the buffer for pending operations.
   AtomicInt<int64_t> buffer_bytes_used_;
 
@@ -83,6 +83,12 @@ DEFINE_test_flag(bool, assert_local_tablet_server_selected, false, "Verify that
 DEFINE_test_flag(string, assert_tablet_server_select_is_in_zone, "", "Verify that SelectTServer "
                  "selected a talet server in the AZ specified by this flag.");
 
+DEFINE_bool(closest_replica_prefers_read_replicas, true,
+            "Whether reads that accept any replica, such as consistent prefix reads, prefer read "
+            "replicas (observers) over voters of the tablet that are equally close to the "
+            "client, so that read traffic does not slow down writes.");
+TAG_FLAG(closest_replica_prefers_read_replicas, runtime);
+
 DECLARE_string(flagfile);
 
 namespace yb {
@@ -335,34 +341,28 @@ RemoteTabletServer* YBClient::Data::SelectTServer(RemoteTablet* rt,
           ret = filtered[0];
         }
       } else if (selection == CLOSEST_REPLICA) {
-        // Choose the closest replica.
-        bool local_zone_ts = false;
+        // Choose the closest replica: the local tserver, then one in the same zone, then one in the
+        // same region, then any. Among equally close replicas, read replicas are preferred, and
+        // the replica is picked at random to spread the load.
+        const bool prefer_read_replicas = FLAGS_closest_replica_prefers_read_replicas;
+        int best_rank = std::numeric_limits<int>::max();
+        vector<RemoteTabletServer*> best;
         for (RemoteTabletServer* rts : filtered) {
-          if (IsTabletServerLocal(*rts)) {
-            ret = rts;
-            // If the tserver is local, we are done here.
-            break;
-          } else if (cloud_info_pb_.has_placement_region() &&
-                     rts->cloud_info().has_placement_region() &&
-                     cloud_info_pb_.placement_region() == rts->cloud_info().placement_region()) {
-            if (cloud_info_pb_.has_placement_zone() && rts->cloud_info().has_placement_zone() &&
-                cloud_info_pb_.placement_zone() == rts->cloud_info().placement_zone()) {
-              // Note down that we have found a zone local tserver and continue looking for node
-              // local tserver.
-              ret = rts;
-              local_zone_ts = true;
-            } else if (!local_zone_ts) {
-              // Look for a region local tserver only if we haven't found a zone local tserver yet.
-              ret = rts;
-            }
+          int rank = static_cast<int>(TabletServerLocality(*rts)) * 2;
+          if (prefer_read_replicas && !rt->IsReadReplica(rts)) {
+            ++rank;
+          }
+          if (rank < best_rank) {
+            best_rank = rank;
+            best.clear();
+          }
+          if (rank == best_rank) {
+            best.push_back(rts);
           }
         }
 
-        // If ret is not null here, it should point to the closest replica from the client.
-
-        // Fallback to a random replica if none are local.
-        if (ret == nullptr && !filtered.empty()) {
-          ret = filtered[rand() % filtered.size()];
+        if (!best.empty()) {
+          ret = best[rand() % best.size()];
         }
       }
       break;
@@ -816,6 +816,20 @@ bool YBClient::Data::IsTabletServerLocal(const RemoteTabletServer& rts) const {
   return rts.HasHostFrom(local_host_names_);
 }
 
+ServerLocality YBClient::Data::TabletServerLocality(const RemoteTabletServer& rts) const {
+  if (IsTabletServerLocal(rts)) {
+    return ServerLocality::kLocal;
+  }
+  const auto& cloud_info = rts.cloud_info();
+  if (!cloud_info_pb_.has_placement_region() || !cloud_info.has_placement_region() ||
+      cloud_info_pb_.placement_region() != cloud_info.placement_region()) {
+    return ServerLocality::kRemote;
+  }
+  return cloud_info_pb_.has_placement_zone() && cloud_info.has_placement_zone() &&
+         cloud_info_pb_.placement_zone() == cloud_info.placement_zone()
+      ? ServerLocality::kSameZone : ServerLocality::kSameRegion;
+}
+
 namespace internal {
 
 // Gets a table's schema from the leader master. If the leader master
@@ -1023,6 +1037,7 @@ void GetTableSchemaRpc::Finished(const Status& status) {
       if (resp_.has_index_info()) {
         info_->index_info.emplace(resp_.index_info());
       }
+      info_->colocated = resp_.colocated();
       CHECK_GT(info_->table_id.size(), 0) << "Running against a too-old master";
     }
   }
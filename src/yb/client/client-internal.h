@@ -164,6 +164,9 @@ class YBClient::Data {
 
   bool IsTabletServerLocal(const internal::RemoteTabletServer& rts) const;
 
+  // Placement of the tablet server relative to this client.
+  ServerLocality TabletServerLocality(const internal::RemoteTabletServer& rts) const;
+
   // Returns a non-failed replica of the specified tablet based on the provided selection criteria
   // and tablet server blacklist.
   //
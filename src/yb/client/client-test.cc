@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <map>
 #include <thread>
 #include <set>
 #include <vector>
@@ -85,6 +86,7 @@
 #include "yb/util/capabilities.h"
 #include "yb/util/metrics.h"
 #include "yb/util/net/sockaddr.h"
+#include "yb/util/random_util.h"
 #include "yb/util/status.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
@@ -1664,6 +1666,87 @@ TEST_F(ClientTest, TestMasterLookupPermits) {
             client_->data_->meta_cache_->master_lookup_sem_.GetValue());
 }
 
+// Looks up tablets of several tables from concurrent threads, while the lookups add tablets to the
+// meta cache and new tablets snapshots are published.
+TEST_F(ClientTest, ConcurrentTabletLookups) {
+  constexpr int kNumTables = 4;
+  constexpr int kNumTabletsPerTable = 8;
+  constexpr int kNumThreads = 8;
+
+  std::vector<TableHandle> tables(kNumTables);
+  for (int i = 0; i != kNumTables; ++i) {
+    ASSERT_NO_FATALS(CreateTable(
+        YBTableName(Format("concurrent_lookups_$0", i)), kNumTabletsPerTable, &tables[i]));
+  }
+
+  auto* meta_cache = client_->data_->meta_cache_.get();
+  std::mutex mutex;
+  // Tablet found for each table and partition, all lookups should return the same tablet.
+  std::map<std::pair<int, std::string>, internal::RemoteTablet*> found_tablets;
+  std::atomic<int> num_lookups(0);
+  TestThreadHolder thread_holder;
+  for (int i = 0; i != kNumThreads; ++i) {
+    thread_holder.AddThreadFunctor(
+        [&tables, meta_cache, &mutex, &found_tablets, &num_lookups,
+         &stop = thread_holder.stop_flag()] {
+      while (!stop.load(std::memory_order_acquire)) {
+        const int table_idx = RandomUniformInt(0, kNumTables - 1);
+        const auto& table = tables[table_idx];
+        const auto& partitions = table->GetPartitions();
+        const auto& partition = partitions[RandomUniformInt<size_t>(0, partitions.size() - 1)];
+        auto tablet = ASSERT_RESULT(meta_cache->LookupTabletByKeyFuture(
+            table.get(), partition, CoarseMonoClock::Now() + 10s).get());
+        ASSERT_EQ(partition, tablet->partition().partition_key_start());
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          auto it = found_tablets.emplace(std::make_pair(table_idx, partition), tablet.get()).first;
+          ASSERT_EQ(it->second, tablet.get());
+        }
+        ++num_lookups;
+      }
+    });
+  }
+  thread_holder.WaitAndStop(5s);
+
+  LOG(INFO) << "Completed " << num_lookups.load() << " lookups";
+  ASSERT_EQ(kNumTables * kNumTabletsPerTable, found_tablets.size());
+}
+
+TEST(MetaCacheTest, TabletsByPartition) {
+  constexpr int kNumTablets = 300;
+  constexpr int kNumBatches = 3;
+  std::vector<std::string> keys;
+  for (int i = 0; i != kNumTablets; ++i) {
+    // The first partition starts with an empty key, as in hash partitioned tables.
+    keys.push_back(i == 0 ? std::string() : PartitionSchema::EncodeMultiColumnHashValue(i * 2));
+  }
+
+  internal::TabletsByPartition tablets_by_partition;
+  std::vector<internal::RemoteTabletPtr> tablets(kNumTablets);
+  // Batches interleave, so each of them is merged before, after and between existing entries.
+  for (int batch = 0; batch != kNumBatches; ++batch) {
+    std::vector<internal::RemoteTabletPtr> batch_tablets;
+    for (int i = kNumTablets - 1 - batch; i >= 0; i -= kNumBatches) {
+      PartitionPB partition_pb;
+      partition_pb.set_partition_key_start(keys[i]);
+      Partition partition;
+      Partition::FromPB(partition_pb, &partition);
+      tablets[i] = new internal::RemoteTablet(Format("tablet-$0", i), partition);
+      batch_tablets.push_back(tablets[i]);
+    }
+    tablets_by_partition.Insert(std::move(batch_tablets));
+  }
+
+  ASSERT_EQ(static_cast<size_t>(kNumTablets), tablets_by_partition.size());
+  for (int i = 0; i != kNumTablets; ++i) {
+    auto tablet = tablets_by_partition.Find(keys[i]);
+    ASSERT_NE(nullptr, tablet) << i;
+    ASSERT_EQ(tablets[i].get(), tablet->get()) << i;
+    ASSERT_EQ(nullptr, tablets_by_partition.Find(
+        PartitionSchema::EncodeMultiColumnHashValue(i * 2 + 1))) << i;
+  }
+}
+
 // Define callback for deadlock simulation, as well as various helper methods.
 namespace {
 
@@ -500,7 +500,8 @@ Status YBClient::CreateNamespace(const std::string& namespace_name,
                                  const std::string& creator_role_name,
                                  const std::string& namespace_id,
                                  const std::string& source_namespace_id,
-                                 const boost::optional<uint32_t>& next_pg_oid) {
+                                 const boost::optional<uint32_t>& next_pg_oid,
+                                 const bool colocated) {
   CreateNamespaceRequestPB req;
   CreateNamespaceResponsePB resp;
   req.set_name(namespace_name);
@@ -519,6 +520,7 @@ Status YBClient::CreateNamespace(const std::string& namespace_name,
   if (next_pg_oid) {
     req.set_next_pg_oid(*next_pg_oid);
   }
+  req.set_colocated(colocated);
   CALL_SYNC_LEADER_MASTER_RPC(req, resp, CreateNamespace);
   return Status::OK();
 }
@@ -1020,6 +1022,15 @@ void YBClient::LookupTabletById(const std::string& tablet_id,
       tablet_id, deadline, std::move(callback), use_cache);
 }
 
+boost::optional<ServerLocality> YBClient::TabletLeaderLocality(const TabletId& tablet_id) const {
+  auto tablet = data_->meta_cache_->LookupTabletByIdFastPath(tablet_id);
+  auto* leader = tablet ? tablet->LeaderTServer() : nullptr;
+  if (!leader) {
+    return boost::none;
+  }
+  return data_->TabletServerLocality(*leader);
+}
+
 HostPort YBClient::GetMasterLeaderAddress() {
   return data_->leader_master_hostport();
 }
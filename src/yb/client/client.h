@@ -81,6 +81,9 @@ template<class T> class scoped_refptr;
 
 YB_DEFINE_ENUM(GrantRevokeStatementType, (GRANT)(REVOKE));
 
+// Placement of a tablet server relative to the client, from the closest to the farthest.
+YB_DEFINE_ENUM(ServerLocality, (kLocal)(kSameZone)(kSameRegion)(kRemote));
+
 namespace yb {
 
 class CloudInfoPB;
@@ -298,7 +301,8 @@ class YBClient {
                                  const std::string& creator_role_name = "",
                                  const std::string& namespace_id = "",
                                  const std::string& source_namespace_id = "",
-                                 const boost::optional<uint32_t>& next_pg_oid = boost::none);
+                                 const boost::optional<uint32_t>& next_pg_oid = boost::none,
+                                 const bool colocated = false);
 
   // It calls CreateNamespace(), but before it checks that the namespace has NOT been yet
   // created. So, it prevents error 'namespace already exists'.
@@ -526,6 +530,10 @@ class YBClient {
                         LookupTabletCallback callback,
                         UseCache use_cache);
 
+  // Locality of the leader of the specified tablet, using only the tablet locations already in
+  // the meta cache. Returns none if the tablet or its leader is not known.
+  boost::optional<ServerLocality> TabletLeaderLocality(const TabletId& tablet_id) const;
+
   rpc::Messenger* messenger() const;
 
   const scoped_refptr<MetricEntity>& metric_entity() const;
@@ -559,6 +567,7 @@ class YBClient {
   friend class internal::TabletInvoker;
   friend class PlacementInfoTest;
 
+  FRIEND_TEST(ClientTest, ConcurrentTabletLookups);
   FRIEND_TEST(ClientTest, TestGetTabletServerBlacklist);
   FRIEND_TEST(ClientTest, TestMasterDown);
   FRIEND_TEST(ClientTest, TestMasterLookupPermits);
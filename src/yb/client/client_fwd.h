@@ -33,6 +33,8 @@ namespace client {
 
 class YBClient;
 
+class CoalescingSession;
+
 class YBError;
 typedef std::vector<std::unique_ptr<YBError>> CollectedErrors;
 
@@ -0,0 +1,138 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/client/coalescing_session.h"
+
+#include <unordered_map>
+
+#include "yb/client/client.h"
+#include "yb/client/error.h"
+#include "yb/client/session.h"
+
+#include "yb/rpc/messenger.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(client_coalescing_window_us, 200,
+             "How long operations applied to a coalescing session are buffered before they are "
+             "flushed together.");
+TAG_FLAG(client_coalescing_window_us, advanced);
+
+DEFINE_int32(client_coalescing_max_batch_size, 1000,
+             "Coalescing session flushes buffered operations immediately when their number "
+             "reaches this limit.");
+TAG_FLAG(client_coalescing_max_batch_size, advanced);
+
+namespace yb {
+namespace client {
+
+CoalescingSession::CoalescingSession(YBClient* client, MonoDelta window, size_t max_batch_size)
+    : client_(client),
+      window_(window.Initialized()
+                  ? window : MonoDelta::FromMicroseconds(FLAGS_client_coalescing_window_us)),
+      max_batch_size_(max_batch_size ? max_batch_size : FLAGS_client_coalescing_max_batch_size) {
+}
+
+CoalescingSession::~CoalescingSession() {
+  Flush();
+}
+
+void CoalescingSession::SetTimeout(MonoDelta timeout) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  timeout_ = timeout;
+}
+
+void CoalescingSession::ApplyAsync(YBOperationPtr yb_op, StatusFunctor callback) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!batch_.session) {
+    batch_.session = client_->NewSession();
+    if (timeout_.Initialized()) {
+      batch_.session->SetTimeout(timeout_);
+    }
+  }
+  auto status = batch_.session->Apply(yb_op);
+  if (!status.ok()) {
+    lock.unlock();
+    callback(status);
+    return;
+  }
+  batch_.ops.emplace_back(std::move(yb_op), std::move(callback));
+  if (batch_.ops.size() >= max_batch_size_) {
+    FlushUnlocked(&lock);
+    return;
+  }
+  if (batch_.ops.size() == 1) {
+    flush_task_id_ = client_->messenger()->scheduler().Schedule(
+        [self = shared_from_this(), batch_id = batch_id_](const Status&) {
+          self->FlushIfCurrent(batch_id);
+        },
+        window_.ToSteadyDuration());
+  }
+}
+
+void CoalescingSession::Flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  FlushUnlocked(&lock);
+}
+
+void CoalescingSession::FlushIfCurrent(uint64_t batch_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (batch_id != batch_id_) {
+    return;
+  }
+  // This task is running, so there is nothing to abort.
+  flush_task_id_ = rpc::kUninitializedScheduledTaskId;
+  FlushUnlocked(&lock);
+}
+
+void CoalescingSession::FlushUnlocked(std::unique_lock<std::mutex>* lock) {
+  Batch batch = std::move(batch_);
+  batch_ = Batch();
+  ++batch_id_;
+  auto flush_task_id = flush_task_id_;
+  flush_task_id_ = rpc::kUninitializedScheduledTaskId;
+  lock->unlock();
+
+  if (flush_task_id != rpc::kUninitializedScheduledTaskId) {
+    client_->messenger()->scheduler().Abort(flush_task_id);
+  }
+  if (batch.ops.empty()) {
+    return;
+  }
+
+  auto session = batch.session;
+  session->FlushAsync([batch = std::move(batch)](const Status& status) {
+    BatchFlushed(batch, status);
+  });
+}
+
+void CoalescingSession::BatchFlushed(const Batch& batch, const Status& status) {
+  std::unordered_map<const YBOperation*, Status> op_errors;
+  if (!status.ok()) {
+    for (const auto& error : batch.session->GetPendingErrors()) {
+      op_errors.emplace(&error->failed_op(), error->status());
+    }
+  }
+  for (const auto& op_and_callback : batch.ops) {
+    auto it = op_errors.find(op_and_callback.first.get());
+    if (it != op_errors.end()) {
+      op_and_callback.second(it->second);
+    } else {
+      // When the flush failed without errors attributed to operations, every operation failed.
+      op_and_callback.second(op_errors.empty() ? status : Status::OK());
+    }
+  }
+}
+
+} // namespace client
+} // namespace yb
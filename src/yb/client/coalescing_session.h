@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CLIENT_COALESCING_SESSION_H
+#define YB_CLIENT_COALESCING_SESSION_H
+
+#include <mutex>
+#include <vector>
+
+#include "yb/client/client_fwd.h"
+
+#include "yb/rpc/scheduler.h"
+
+#include "yb/util/async_util.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace client {
+
+// Group commit on the client side.
+//
+// Operations applied by many concurrent callers are buffered in a shared session and flushed
+// together, either when the coalescing window expires or when the batch grows large enough.
+// The batcher then groups them into per tablet RPCs, so a burst of tiny writes to the same
+// tablets results in a few larger RPCs instead of one RPC per operation.
+//
+// Each operation keeps its own callback, which is invoked with the status of that operation.
+//
+// This class is thread safe, unlike YBSession.
+class CoalescingSession : public std::enable_shared_from_this<CoalescingSession> {
+ public:
+  // window and max_batch_size default to the client_coalescing_window_us and
+  // client_coalescing_max_batch_size flags.
+  explicit CoalescingSession(
+      YBClient* client, MonoDelta window = MonoDelta(), size_t max_batch_size = 0);
+
+  ~CoalescingSession();
+
+  // Timeout used for the sessions created by this object.
+  void SetTimeout(MonoDelta timeout);
+
+  // Buffers yb_op, callback is invoked when the batch containing this operation is flushed.
+  void ApplyAsync(YBOperationPtr yb_op, StatusFunctor callback);
+
+  // Flushes buffered operations without waiting for the window to expire.
+  void Flush();
+
+ private:
+  struct Batch {
+    YBSessionPtr session;
+    std::vector<std::pair<YBOperationPtr, StatusFunctor>> ops;
+  };
+
+  void FlushIfCurrent(uint64_t batch_id);
+  void FlushUnlocked(std::unique_lock<std::mutex>* lock);
+
+  static void BatchFlushed(const Batch& batch, const Status& status);
+
+  YBClient* const client_;
+  const MonoDelta window_;
+  const size_t max_batch_size_;
+
+  std::mutex mutex_;
+  MonoDelta timeout_;
+  Batch batch_;
+  // Incremented on each flush, so a scheduled flush could find out that its batch was already
+  // flushed because it reached max_batch_size_.
+  uint64_t batch_id_ = 0;
+  rpc::ScheduledTaskId flush_task_id_ = rpc::kUninitializedScheduledTaskId;
+};
+
+} // namespace client
+} // namespace yb
+
+#endif // YB_CLIENT_COALESCING_SESSION_H
@@ -80,6 +80,10 @@ YB_DEFINE_ENUM(InFlightOpState,
     // remains in the 'ops_' set.
     (kRequestSent));
 
+// Kind of RPC an operation is sent with. Operations of different groups destined for the same
+// tablet are sent in separate RPCs.
+YB_DEFINE_ENUM(OpGroup, (kWrite)(kLeaderRead)(kConsistentPrefixRead));
+
 // An operation which has been submitted to the batcher and not yet completed.
 // The operation goes through a state machine as it progresses through the
 // various stages of a request. See the State enum for details.
@@ -113,6 +117,13 @@ struct InFlightOp {
   // order of operations. This is important when multiple operations act on the same row.
   int sequence_number_;
 
+  // Group of this operation, calculated once when the tablet lookup finishes so that sorting
+  // ops in FlushBuffersIfReady does not have to inspect yb_op on every comparison.
+  OpGroup group = OpGroup::kWrite;
+
+  // Write sent by a pipelined flush of a transaction, see YBSession::FlushPipelined.
+  bool pipelined = false;
+
   std::string ToString() const;
 };
 
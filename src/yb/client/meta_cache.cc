@@ -30,8 +30,11 @@
 // under the License.
 //
 
+#include <algorithm>
 #include <mutex>
 
+#include <boost/optional.hpp>
+
 #include <glog/logging.h>
 
 #include "yb/client/client.h"
@@ -48,6 +51,7 @@
 #include "yb/master/master.proxy.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/thread_pool.h"
 #include "yb/tserver/tserver_service.proxy.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/net/dns_resolver.h"
@@ -69,6 +73,16 @@ DEFINE_test_flag(bool, verify_all_replicas_alive, false,
 DEFINE_int32(retry_failed_replica_ms, 60 * 1000,
              "Time in milliseconds to wait for before retrying a failed replica");
 
+DEFINE_bool(prefetch_tablet_locations_on_table_open, true,
+            "Whether locations of all tablets received when a table is opened should be "
+            "placed in the meta cache, so first operations on the table do not have to look "
+            "them up from the master");
+
+DEFINE_int32(tablet_locations_refresh_interval_ms, 0,
+             "Interval in milliseconds between background refreshes of locations of all tablets "
+             "of opened tables. 0 to disable background refresh.");
+TAG_FLAG(tablet_locations_refresh_interval_ms, advanced);
+
 METRIC_DEFINE_histogram(
   server, dns_resolve_latency_during_init_proxy,
   "yb.client.MetaCache.InitProxy DNS Resolve",
@@ -195,6 +209,11 @@ string RemoteTabletServer::ToString() const {
   return ret;
 }
 
+HostPortPB RemoteTabletServer::GetDesiredHostPort(const CloudInfoPB& from) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return DesiredHostPort(public_rpc_hostports_, private_rpc_hostports_, cloud_info_pb_, from);
+}
+
 bool RemoteTabletServer::HasHostFrom(const std::unordered_set<std::string>& hosts) const {
   std::lock_guard<simple_spinlock> l(lock_);
   for (const auto& hp : private_rpc_hostports_) {
@@ -295,6 +314,16 @@ bool RemoteTablet::HasLeader() const {
   return LeaderTServer() != nullptr;
 }
 
+bool RemoteTablet::IsReadReplica(const RemoteTabletServer* server) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  for (const RemoteReplica& replica : replicas_) {
+    if (replica.ts == server) {
+      return replica.role == RaftPeerPB::READ_REPLICA;
+    }
+  }
+  return false;
+}
+
 void RemoteTablet::GetRemoteTabletServers(vector<RemoteTabletServer*>* servers) {
   DCHECK(servers->empty());
   std::lock_guard<simple_spinlock> l(lock_);
@@ -410,6 +439,14 @@ MetaCache::~MetaCache() {
 }
 
 void MetaCache::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    refresh_closing_ = true;
+    refreshed_tables_.clear();
+    if (refresh_task_id_ != rpc::kUninitializedScheduledTaskId) {
+      client_->messenger()->scheduler().Abort(refresh_task_id_);
+    }
+  }
   rpcs_.Shutdown();
 }
 
@@ -611,6 +648,29 @@ void LookupRpc::DoFinished(
   }
 }
 
+// Publishes tablets snapshot of the meta cache, see MetaCache::tablets_snapshot_.
+//
+// Keeps a reference on the owning metacache while alive.
+class MetaCache::PublishTabletsSnapshotTask : public rpc::ThreadPoolTask {
+ public:
+  explicit PublishTabletsSnapshotTask(MetaCache* meta_cache) : meta_cache_(meta_cache) {}
+
+  void Run() override {
+    meta_cache_->PublishTabletsSnapshot();
+  }
+
+  void Done(const Status& status) override {
+    // The thread pool is shutting down, so publish on this thread.
+    if (!status.ok()) {
+      meta_cache_->PublishTabletsSnapshot();
+    }
+    delete this;
+  }
+
+ private:
+  scoped_refptr<MetaCache> meta_cache_;
+};
+
 RemoteTabletPtr MetaCache::ProcessTabletLocations(
     const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations,
     const std::string* partition_group_start) {
@@ -619,13 +679,14 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
   RemoteTabletPtr result;
   bool first = true;
   std::vector<std::pair<LookupTabletCallback, internal::RemoteTabletPtr>> to_notify;
+  std::unordered_map<TableId, std::vector<RemoteTabletPtr>> new_tablets;
+  bool schedule_publish = false;
 
   {
     std::lock_guard<decltype(mutex_)> l(mutex_);
     for (const TabletLocationsPB& loc : locations) {
       for (const std::string& table_id : loc.table_ids()) {
         auto& table_data = tables_[table_id];
-        auto& tablets_by_key = table_data.tablets_by_partition;
         // First, update the tserver cache, needed for the Refresh calls below.
         for (const TabletLocationsPB_ReplicaPB& r : loc.replicas()) {
           UpdateTabletServerUnlocked(r.ts_info());
@@ -650,7 +711,7 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
           remote = new RemoteTablet(tablet_id, partition);
 
           CHECK(tablets_by_id_.emplace(tablet_id, remote).second);
-          CHECK(tablets_by_key.emplace(partition.partition_key_start(), remote).second);
+          new_tablets[table_id].push_back(remote);
         }
         remote->Refresh(ts_cache_, loc.replicas());
 
@@ -679,6 +740,24 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
         }
       }
     }
+
+    if (!new_tablets.empty()) {
+      for (auto& table_and_tablets : new_tablets) {
+        auto& tablets_by_partition = tables_[table_and_tablets.first].tablets_by_partition;
+        tablets_by_partition.Insert(std::move(table_and_tablets.second));
+        tables_to_publish_.insert(table_and_tablets.first);
+      }
+      if (!publish_tablets_snapshot_scheduled_) {
+        publish_tablets_snapshot_scheduled_ = true;
+        schedule_publish = true;
+      }
+    }
+  }
+
+  if (schedule_publish) {
+    // Lookups that don't find tablets in the current snapshot fall back to the locked path, so it
+    // is fine to publish the new one a bit later.
+    client_->messenger()->ThreadPool().Enqueue(new PublishTabletsSnapshotTask(this));
   }
 
   for (const auto& callback_and_remote_tablet : to_notify) {
@@ -689,6 +768,28 @@ RemoteTabletPtr MetaCache::ProcessTabletLocations(
   return result;
 }
 
+void MetaCache::PublishTabletsSnapshot() {
+  for (;;) {
+    TabletsSnapshot snapshot;
+    {
+      std::lock_guard<decltype(mutex_)> lock(mutex_);
+      if (tables_to_publish_.empty()) {
+        publish_tablets_snapshot_scheduled_ = false;
+        return;
+      }
+      for (const auto& table_id : tables_to_publish_) {
+        next_tablets_snapshot_[table_id] = std::make_shared<const TabletsByPartition>(
+            tables_[table_id].tablets_by_partition);
+      }
+      tables_to_publish_.clear();
+      snapshot = next_tablets_snapshot_;
+    }
+    // Publish outside of mutex_, since it waits for readers of the previous snapshot. Only one
+    // thread publishes at a time, so older snapshot does not replace newer one.
+    tablets_snapshot_.Set(std::move(snapshot));
+  }
+}
+
 void MetaCache::LookupFailed(
     const YBTable* table, const std::string& partition_group_start, const Status& status) {
   VLOG(1) << "Lookup for table " << table->id() << " and partition "
@@ -872,22 +973,143 @@ class LookupByKeyRpc : public LookupRpc {
   GetTableLocationsResponsePB resp_;
 };
 
-RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* table,
-                                                             const std::string& partition_key) {
-  auto it = tables_.find(table->id());
-  if (PREDICT_FALSE(it == tables_.end())) {
-    // No cache available for this table.
-    return nullptr;
+// Fetches locations of all tablets of the table, page by page, starting from the specified
+// partition key. Used to keep the cache fresh for opened tables.
+class RefreshTableLocationsRpc : public LookupRpc {
+ public:
+  static constexpr int kPageSize = 1000;
+
+  RefreshTableLocationsRpc(const scoped_refptr<MetaCache>& meta_cache,
+                           std::shared_ptr<const YBTable> table,
+                           MetaCache::PartitionKey partition_start,
+                           CoarseTimePoint deadline,
+                           Messenger* messenger,
+                           rpc::ProxyCache* proxy_cache)
+      : LookupRpc(meta_cache, deadline, messenger, proxy_cache),
+        table_(std::move(table)),
+        partition_start_(std::move(partition_start)) {
   }
 
-  DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
-  auto tablet_it = it->second.tablets_by_partition.find(partition_key);
-  if (PREDICT_FALSE(tablet_it == it->second.tablets_by_partition.end())) {
+  std::string ToString() const override {
+    return Format("RefreshTableLocations($0, $1, $2)",
+                  table_->name(), Slice(partition_start_).ToDebugHexString(), num_attempts());
+  }
+
+  void DoSendRpc() override {
+    req_.mutable_table()->set_table_id(table_->id());
+    req_.set_partition_key_start(partition_start_);
+    req_.set_max_returned_locations(kPageSize);
+
+    master_proxy()->GetTableLocationsAsync(
+        req_, &resp_, mutable_retrier()->mutable_controller(),
+        std::bind(&RefreshTableLocationsRpc::Finished, this, Status::OK()));
+  }
+
+ private:
+  void Finished(const Status& status) override {
+    DoFinished(status, resp_, nullptr /* partition_group_start */);
+  }
+
+  void Notify(const Status& status, const RemoteTabletPtr& result) override {
+    // Failure is already logged, and refresh will be retried in the next round.
+    if (!status.ok() || resp_.tablet_locations_size() < kPageSize) {
+      return;
+    }
+    const auto& next_start = resp_.tablet_locations(resp_.tablet_locations_size() - 1)
+        .partition().partition_key_end();
+    if (next_start.empty()) {
+      return;
+    }
+    rpc::StartRpc<RefreshTableLocationsRpc>(
+        meta_cache(), table_, next_start, retrier().deadline(), retrier().messenger(),
+        &retrier().proxy_cache());
+  }
+
+  // Table to refresh.
+  std::shared_ptr<const YBTable> table_;
+
+  // Partition key to start this page from.
+  MetaCache::PartitionKey partition_start_;
+
+  // Request body.
+  GetTableLocationsRequestPB req_;
+
+  // Response body.
+  GetTableLocationsResponsePB resp_;
+};
+
+void MetaCache::TableOpened(
+    const YBTable* table,
+    const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations) {
+  if (FLAGS_prefetch_tablet_locations_on_table_open && !locations.empty()) {
+    ProcessTabletLocations(locations, nullptr /* partition_group_start */);
+  }
+
+  if (FLAGS_tablet_locations_refresh_interval_ms <= 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(refresh_mutex_);
+  if (refresh_closing_) {
+    return;
+  }
+  refreshed_tables_[table->id()] = table->shared_from_this();
+  if (refresh_task_id_ == rpc::kUninitializedScheduledTaskId) {
+    ScheduleLocationsRefresh();
+  }
+}
+
+void MetaCache::ScheduleLocationsRefresh() {
+  refresh_task_id_ = client_->messenger()->scheduler().Schedule(
+      [self = scoped_refptr<MetaCache>(this)](const Status& status) {
+        self->RefreshLocations(status);
+      },
+      FLAGS_tablet_locations_refresh_interval_ms * 1ms);
+}
+
+void MetaCache::RefreshLocations(const Status& status) {
+  std::vector<std::shared_ptr<const YBTable>> tables;
+  {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    refresh_task_id_ = rpc::kUninitializedScheduledTaskId;
+    if (!status.ok() || refresh_closing_) {
+      return;
+    }
+    // Tables that were closed by the user are dropped from refresh.
+    for (auto it = refreshed_tables_.begin(); it != refreshed_tables_.end();) {
+      auto table = it->second.lock();
+      if (table) {
+        tables.push_back(std::move(table));
+        ++it;
+      } else {
+        it = refreshed_tables_.erase(it);
+      }
+    }
+    if (!refreshed_tables_.empty() && FLAGS_tablet_locations_refresh_interval_ms > 0) {
+      ScheduleLocationsRefresh();
+    }
+  }
+
+  auto deadline = CoarseMonoClock::Now() + client_->default_admin_operation_timeout();
+  for (auto& table : tables) {
+    VLOG(2) << "Refreshing locations of table " << table->name().ToString();
+    rpc::StartRpc<RefreshTableLocationsRpc>(
+        this, std::move(table), std::string(), deadline, client_->data_->messenger_,
+        client_->data_->proxy_cache_.get());
+  }
+}
+
+namespace {
+
+RemoteTabletPtr FindTabletByPartition(
+    const TabletsByPartition& tablets_by_partition, const std::string& partition_key) {
+  auto tablet = tablets_by_partition.Find(partition_key);
+  if (PREDICT_FALSE(!tablet)) {
     // No tablets with a start partition key lower than 'partition_key'.
     return nullptr;
   }
 
-  const auto& result = tablet_it->second;
+  const auto& result = *tablet;
 
   // Stale entries must be re-fetched.
   if (result->stale()) {
@@ -903,6 +1125,69 @@ RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* tabl
   return nullptr;
 }
 
+} // namespace
+
+const RemoteTabletPtr* TabletsByPartition::Find(const std::string& partition_start) const {
+  auto it = std::lower_bound(keys_.begin(), keys_.end(), partition_start);
+  if (it == keys_.end() || *it != partition_start) {
+    return nullptr;
+  }
+  return &tablets_[it - keys_.begin()];
+}
+
+void TabletsByPartition::Insert(std::vector<RemoteTabletPtr> tablets) {
+  std::sort(tablets.begin(), tablets.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs->partition().partition_key_start() < rhs->partition().partition_key_start();
+  });
+
+  // Merge from the back, so existing entries are moved directly to their final positions.
+  size_t old_size = tablets_.size();
+  size_t new_size = old_size + tablets.size();
+  keys_.resize(new_size);
+  tablets_.resize(new_size);
+  size_t left = tablets.size();
+  while (left != 0) {
+    const auto& key = tablets[left - 1]->partition().partition_key_start();
+    --new_size;
+    if (old_size != 0 && keys_[old_size - 1] > key) {
+      --old_size;
+      keys_[new_size] = std::move(keys_[old_size]);
+      tablets_[new_size] = std::move(tablets_[old_size]);
+    } else {
+      CHECK(old_size == 0 || keys_[old_size - 1] != key)
+          << "Duplicate partition start: " << Slice(key).ToDebugHexString();
+      --left;
+      keys_[new_size] = key;
+      tablets_[new_size] = std::move(tablets[left]);
+    }
+  }
+}
+
+RemoteTabletPtr MetaCache::LookupTabletByKeyFastPathUnlocked(const YBTable* table,
+                                                             const std::string& partition_key) {
+  auto it = tables_.find(table->id());
+  if (PREDICT_FALSE(it == tables_.end())) {
+    // No cache available for this table.
+    return nullptr;
+  }
+
+  DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
+  return FindTabletByPartition(it->second.tablets_by_partition, partition_key);
+}
+
+RemoteTabletPtr MetaCache::LookupTabletByKeyFastPath(const YBTable* table,
+                                                     const std::string& partition_key) {
+  auto snapshot = tablets_snapshot_.get();
+  auto it = snapshot->find(table->id());
+  if (PREDICT_FALSE(it == snapshot->end())) {
+    // No cache available for this table.
+    return nullptr;
+  }
+
+  DCHECK_EQ(partition_key, table->FindPartitionStart(partition_key));
+  return FindTabletByPartition(*it->second, partition_key);
+}
+
 template <class Lock>
 bool MetaCache::FastLookupTabletByKeyUnlocked(
     const YBTable* table,
@@ -929,8 +1214,11 @@ void MetaCache::LookupTabletByKey(const YBTable* table,
 
   rpc::Rpcs::Handle rpc;
   {
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    if (FastLookupTabletByKeyUnlocked(table, partition_start, callback, &lock)) {
+    // Fast path: lookup in the snapshot, without taking any locks.
+    auto result = LookupTabletByKeyFastPath(table, partition_start);
+    if (result && result->HasLeader()) {
+      VLOG(3) << "Fast lookup: found tablet " << result->tablet_id();
+      callback(result);
       return;
     }
   }
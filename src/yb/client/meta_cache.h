@@ -34,9 +34,11 @@
 #define YB_CLIENT_META_CACHE_H
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
@@ -49,14 +51,17 @@
 
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
+#include "yb/gutil/thread_annotations.h"
 
 #include "yb/rpc/rpc_fwd.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 
 #include "yb/tablet/metadata.pb.h"
 
 #include "yb/util/async_util.h"
 #include "yb/util/capabilities.h"
+#include "yb/util/concurrent_value.h"
 #include "yb/util/locks.h"
 #include "yb/util/monotime.h"
 #include "yb/util/semaphore.h"
@@ -142,6 +147,9 @@ class RemoteTabletServer {
 
   bool HasHostFrom(const std::unordered_set<std::string>& hosts) const;
 
+  // Returns host and port that should be used to connect this server from the given placement.
+  HostPortPB GetDesiredHostPort(const CloudInfoPB& from) const;
+
   // Returns the remote server's uuid.
   const std::string& permanent_uuid() const;
 
@@ -164,10 +172,11 @@ class RemoteTabletServer {
   DISALLOW_COPY_AND_ASSIGN(RemoteTabletServer);
 };
 
+// Replicas are stored per tablet, so fields are ordered to avoid padding.
 struct RemoteReplica {
   RemoteTabletServer* ts;
-  consensus::RaftPeerPB::Role role;
   MonoTime last_failed_time = MonoTime::kUninitialized;
+  consensus::RaftPeerPB::Role role;
   // The state of this replica. Only updated after calling GetTabletStatus.
   tablet::RaftGroupStatePB state = tablet::RaftGroupStatePB::UNKNOWN;
 
@@ -207,7 +216,6 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   RemoteTablet(std::string tablet_id,
                Partition partition)
       : tablet_id_(std::move(tablet_id)),
-        log_prefix_(Format("T $0: ", tablet_id_)),
         partition_(std::move(partition)),
         stale_(false) {
   }
@@ -257,6 +265,10 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
     return result;
   }
 
+  // Whether the replica hosted by the specified tablet server is a read replica, i.e. a non-voting
+  // observer.
+  bool IsReadReplica(const RemoteTabletServer* server) const;
+
   // Return true if the tablet currently has a known LEADER replica
   // (i.e the next call to LeaderTServer() is likely to return non-NULL)
   bool HasLeader() const;
@@ -279,7 +291,8 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
 
   std::string ToString() const;
 
-  const std::string& LogPrefix() const { return log_prefix_; }
+  // Built on demand, to avoid keeping a copy of the tablet id for each cached tablet.
+  std::string LogPrefix() const { return Format("T $0: ", tablet_id_); }
 
   MonoTime refresh_time() { return refresh_time_.load(std::memory_order_acquire); }
 
@@ -288,7 +301,6 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   std::string ReplicasAsStringUnlocked() const;
 
   const std::string tablet_id_;
-  const std::string log_prefix_;
   const Partition partition_;
 
   // All non-const members are protected by 'lock_'.
@@ -303,6 +315,29 @@ class RemoteTablet : public RefCountedThreadSafe<RemoteTablet> {
   DISALLOW_COPY_AND_ASSIGN(RemoteTablet);
 };
 
+// Tablets of a table, sorted by partition start key.
+//
+// Keys and tablets are stored in separate flat arrays, so a lookup is a binary search over
+// contiguous keys, and a copy of the whole set for the lookup snapshot does not allocate per
+// tablet.
+class TabletsByPartition {
+ public:
+  // Returns the tablet whose partition starts with partition_start, or nullptr if it is not cached.
+  const RemoteTabletPtr* Find(const std::string& partition_start) const;
+
+  // Adds tablets that are not in the set yet. Adding a batch at once moves each existing entry at
+  // most once.
+  void Insert(std::vector<RemoteTabletPtr> tablets);
+
+  size_t size() const {
+    return tablets_.size();
+  }
+
+ private:
+  std::vector<std::string> keys_;
+  std::vector<RemoteTabletPtr> tablets_;
+};
+
 // Manager of RemoteTablets and RemoteTabletServers. The client consults
 // this class to look up a given tablet or server.
 //
@@ -349,6 +384,9 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
                         LookupTabletCallback callback,
                         UseCache use_cache);
 
+  // Lookup the given tablet by id, only consulting local information.
+  RemoteTabletPtr LookupTabletByIdFastPath(const TabletId& tablet_id);
+
   // Return the local tablet server if available.
   RemoteTabletServer* local_tserver() const {
     return local_tserver_;
@@ -371,10 +409,17 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
       const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations,
       const std::string* partition_group_start);
 
+  // Called when the table is opened with locations of all its tablets. Populates the tablet
+  // caches and registers the table for background refresh of its tablet locations.
+  void TableOpened(
+      const YBTable* table,
+      const google::protobuf::RepeatedPtrField<master::TabletLocationsPB>& locations);
+
  private:
   friend class LookupRpc;
   friend class LookupByKeyRpc;
   friend class LookupByIdRpc;
+  friend class RefreshTableLocationsRpc;
 
   FRIEND_TEST(client::ClientTest, TestMasterLookupPermits);
 
@@ -383,7 +428,10 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   RemoteTabletPtr LookupTabletByKeyFastPathUnlocked(const YBTable* table,
                                                     const std::string& partition_key);
 
-  RemoteTabletPtr LookupTabletByIdFastPath(const TabletId& tablet_id);
+  // Same as above, but uses tablets_snapshot_, so does not require mutex_.
+  RemoteTabletPtr LookupTabletByKeyFastPath(const YBTable* table,
+                                            const std::string& partition_key);
+
 
   // Update our information about the given tablet server.
   //
@@ -405,6 +453,15 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
       const LookupTabletCallback& callback,
       Lock* lock);
 
+  class PublishTabletsSnapshotTask;
+
+  // Publishes tablets of all tables changed since the previous snapshot in a new snapshot, until
+  // no more tables are changed.
+  void PublishTabletsSnapshot();
+
+  void ScheduleLocationsRefresh() EXCLUSIVE_LOCKS_REQUIRED(refresh_mutex_);
+  void RefreshLocations(const Status& status);
+
   YBClient* const client_;
 
   boost::shared_mutex mutex_;
@@ -438,12 +495,29 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
   typedef std::string PartitionGroupKey;
 
   struct TableData {
-    std::unordered_map<PartitionKey, RemoteTabletPtr> tablets_by_partition;
+    TabletsByPartition tablets_by_partition;
     std::unordered_map<PartitionGroupKey, PartitionToLookupData> tablet_lookups_by_group;
   };
 
   std::unordered_map<TableId, TableData> tables_;
 
+  // Copy of tablets_by_partition of all tables, that is used by lookup fast path without taking
+  // mutex_. When tablets are added to the cache, a new snapshot is published by a task in the
+  // messenger thread pool, so RPC callbacks don't wait for readers of the previous snapshot.
+  // Tablets added while the task is queued or running are published together.
+  typedef std::unordered_map<TableId, std::shared_ptr<const TabletsByPartition>> TabletsSnapshot;
+
+  // Content of the last published snapshot. Protected by mutex_.
+  TabletsSnapshot next_tablets_snapshot_;
+
+  // Tables whose tablets were added after the last published snapshot. Protected by mutex_.
+  std::unordered_set<TableId> tables_to_publish_;
+
+  // Whether a PublishTabletsSnapshotTask is queued or running. Protected by mutex_.
+  bool publish_tablets_snapshot_scheduled_ = false;
+
+  ConcurrentValue<TabletsSnapshot> tablets_snapshot_;
+
   // Cache of tablets, keyed by tablet ID.
   //
   // Protected by lock_
@@ -455,6 +529,14 @@ class MetaCache : public RefCountedThreadSafe<MetaCache> {
 
   rpc::Rpcs rpcs_;
 
+  // Tables whose tablet locations are periodically refreshed in background.
+  std::mutex refresh_mutex_;
+  std::unordered_map<TableId, std::weak_ptr<const YBTable>> refreshed_tables_
+      GUARDED_BY(refresh_mutex_);
+  rpc::ScheduledTaskId refresh_task_id_ GUARDED_BY(refresh_mutex_) =
+      rpc::kUninitializedScheduledTaskId;
+  bool refresh_closing_ GUARDED_BY(refresh_mutex_) = false;
+
   DISALLOW_COPY_AND_ASSIGN(MetaCache);
 };
 
@@ -13,6 +13,7 @@
 
 #include <thread>
 
+#include "yb/client/coalescing_session.h"
 #include "yb/client/ql-dml-test-base.h"
 #include "yb/client/session.h"
 #include "yb/client/table_alterer.h"
@@ -29,6 +30,7 @@
 #include "yb/util/jsonreader.h"
 #include "yb/util/random.h"
 #include "yb/util/random_util.h"
+#include "yb/util/stopwatch.h"
 #include "yb/util/tostring.h"
 #include "yb/util/tsan_util.h"
 
@@ -39,6 +41,8 @@ DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(yb_num_shards_per_tserver);
 DECLARE_int64(db_block_cache_size_bytes);
 DECLARE_bool(flush_rocksdb_on_shutdown);
+DECLARE_bool(enable_hedged_reads);
+DECLARE_int32(hedged_read_min_delay_ms);
 
 using namespace std::literals;
 
@@ -1253,6 +1257,138 @@ TEST_F(QLDmlTest, ReadFollower) {
   ASSERT_TRUE(missing_rows.empty()) << "Missing rows: " << yb::ToString(missing_rows);
 }
 
+TEST_F(QLDmlTest, HedgedReadFollower) {
+  constexpr int kNumRows = RegularBuildVsSanitizers(1000, 200);
+
+  ASSERT_NO_FATALS(InsertRows(kNumRows));
+
+  // Hedge every read right away, so that both answers race against each other.
+  FLAGS_enable_hedged_reads = true;
+  FLAGS_hedged_read_min_delay_ms = 0;
+
+  auto must_see_all_rows_after_this_deadline = MonoTime::Now() + 5s * kTimeMultiplier;
+  auto session = NewSession();
+  for (size_t i = 0; i != kNumRows; ++i) {
+    for (;;) {
+      auto row = ReadRow(session, KeyForIndex(i), YBConsistencyLevel::CONSISTENT_PREFIX);
+      if (!row.ok() && row.status().IsNotFound()) {
+        ASSERT_LE(MonoTime::Now(), must_see_all_rows_after_this_deadline);
+        continue;
+      }
+      ASSERT_OK(row);
+      ASSERT_EQ(*row, ValueForIndex(i));
+      break;
+    }
+  }
+}
+
+TEST_F(QLDmlTest, ParallelScan) {
+  constexpr int kNumRows = RegularBuildVsSanitizers(2000, 500);
+
+  ASSERT_NO_FATALS(InsertRows(kNumRows));
+
+  TableIteratorOptions options;
+  options.columns = std::vector<std::string>{"r1", "c1"};
+  // Keep the queue short, so that streams have to wait for the consumer.
+  TableParallelScan scan(table_, options, 3 /* concurrency */, 2 /* max_queued_blocks */);
+  std::vector<bool> seen(kNumRows);
+  int num_rows = 0;
+  for (;;) {
+    auto block = ASSERT_RESULT(scan.Next());
+    if (!block) {
+      break;
+    }
+    for (const auto& row : block->rows()) {
+      const auto index = row.column(0).int32_value() / 2;
+      ASSERT_GE(index, 0);
+      ASSERT_LT(index, kNumRows);
+      ASSERT_FALSE(seen[index]) << "Duplicate row: " << index;
+      seen[index] = true;
+      ASSERT_EQ(row.column(1).int32_value(), ValueForIndex(index).c1);
+      ++num_rows;
+    }
+  }
+  ASSERT_EQ(num_rows, kNumRows);
+}
+
+// Microbenchmark for the batcher hot path: many small ops spread over all tablets are applied
+// to a single session and flushed together.
+TEST_F(QLDmlTest, BatcherThroughput) {
+  constexpr int kNumBatches = RegularBuildVsSanitizers(20, 5);
+  constexpr int kBatchSize = RegularBuildVsSanitizers(1000, 100);
+
+  auto session = NewSession();
+  LOG_TIMING(INFO, Format("Writing $0 batches of $1 rows", kNumBatches, kBatchSize)) {
+    for (int batch = 0; batch != kNumBatches; ++batch) {
+      for (int i = 0; i != kBatchSize; ++i) {
+        const auto index = batch * kBatchSize + i;
+        InsertRow(session, KeyForIndex(index), ValueForIndex(index));
+      }
+      ASSERT_OK(session->Flush());
+    }
+  }
+
+  LOG_TIMING(INFO, Format("Reading $0 batches of $1 rows", kNumBatches, kBatchSize)) {
+    for (int batch = 0; batch != kNumBatches; ++batch) {
+      std::vector<YBqlReadOpPtr> ops;
+      ops.reserve(kBatchSize);
+      for (int i = 0; i != kBatchSize; ++i) {
+        ops.push_back(SelectRow(session, kValueColumns, KeyForIndex(batch * kBatchSize + i)));
+      }
+      ASSERT_OK(session->Flush());
+      for (const auto& op : ops) {
+        ASSERT_EQ(QLResponsePB::YQL_STATUS_OK, op->response().status());
+      }
+    }
+  }
+}
+
+TEST_F(QLDmlTest, CoalescingSession) {
+  constexpr int kThreads = 8;
+  constexpr int kRowsPerThread = RegularBuildVsSanitizers(200, 50);
+
+  auto coalescing_session = std::make_shared<CoalescingSession>(
+      client_.get(), MonoDelta::FromMilliseconds(1), 100 /* max_batch_size */);
+  CountDownLatch latch(kThreads * kRowsPerThread);
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kThreads; ++t) {
+    threads.emplace_back([this, t, &coalescing_session, &latch, &failures] {
+      for (int i = 0; i != kRowsPerThread; ++i) {
+        const auto index = t * kRowsPerThread + i;
+        const auto key = KeyForIndex(index);
+        const auto value = ValueForIndex(index);
+        const auto op = table_.NewWriteOp(QLWriteRequestPB::QL_STMT_INSERT);
+        auto* const req = op->mutable_request();
+        QLAddInt32HashValue(req, key.h1);
+        QLAddStringHashValue(req, key.h2);
+        QLAddInt32RangeValue(req, key.r1);
+        QLAddStringRangeValue(req, key.r2);
+        table_.AddInt32ColumnValue(req, "c1", value.c1);
+        table_.AddStringColumnValue(req, "c2", value.c2);
+        coalescing_session->ApplyAsync(op, [&latch, &failures](const Status& status) {
+          if (!status.ok()) {
+            LOG(WARNING) << "Write failed: " << status;
+            ++failures;
+          }
+          latch.CountDown();
+        });
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_TRUE(latch.WaitFor(30s));
+  ASSERT_EQ(failures.load(), 0);
+
+  auto session = NewSession();
+  for (int index = 0; index != kThreads * kRowsPerThread; ++index) {
+    auto value = ASSERT_RESULT(ReadRow(session, KeyForIndex(index)));
+    ASSERT_EQ(value, ValueForIndex(index));
+  }
+}
+
 TEST_F(QLDmlTest, DeletePartialRangeKey) {
   auto session = NewSession();
   RowKey row_key{1, "a", 2, "b"};
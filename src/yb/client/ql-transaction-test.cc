@@ -58,6 +58,8 @@ DECLARE_int32(master_inject_latency_on_transactional_tablet_lookups_ms);
 DECLARE_int64(transaction_rpc_timeout_ms);
 DECLARE_bool(rocksdb_disable_compactions);
 DECLARE_int32(delay_init_tablet_peer_ms);
+DECLARE_uint64(stale_intents_cleanup_interval_ms);
+DECLARE_int32(transaction_status_tablet_locality_refresh_ms);
 
 namespace yb {
 namespace client {
@@ -125,6 +127,35 @@ TEST_F(QLTransactionTest, WriteSameKeyWithIntents) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, SingleShardCommit) {
+  {
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    ASSERT_RESULT(WriteRow(
+        session, 1 /* key */, 2 /* value */, WriteOpType::INSERT, Flush::kFalse));
+    ASSERT_OK(session->FlushAndCommitFuture().get());
+    // Single row write should not go through intents and the transaction coordinator.
+    ASSERT_EQ(0, CountIntents());
+    ASSERT_FALSE(HasTransactions());
+    VERIFY_ROW(CreateSession(), 1, 2);
+  }
+
+  {
+    // Rows of multiple tablets are written using regular transaction.
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    for (size_t r = 0; r != kNumRows; ++r) {
+      ASSERT_RESULT(WriteRow(
+          session, KeyForTransactionAndIndex(0, r), ValueForTransactionAndIndex(0, r, WriteOpType::INSERT),
+          WriteOpType::INSERT, Flush::kFalse));
+    }
+    ASSERT_OK(session->FlushAndCommitFuture().get());
+    ASSERT_NO_FATALS(VerifyData());
+  }
+
+  CheckNoRunningTransactions();
+}
+
 // Commit flags says whether we should commit write txn during this test.
 void QLTransactionTest::TestReadRestart(bool commit) {
   SetAtomicFlag(250000ULL, &FLAGS_max_clock_skew_usec);
@@ -175,6 +206,30 @@ void QLTransactionTest::TestReadRestart(bool commit) {
   ASSERT_OK(cluster_->RestartSync());
 }
 
+TEST_F(QLTransactionTest, PipelinedWrites) {
+  constexpr int kKeys = 20;
+  constexpr int kWritesPerKey = 3;
+
+  auto txn = CreateTransaction();
+  auto session = CreateSession(txn);
+  for (int key = 0; key != kKeys; ++key) {
+    // Later writes of the same key should overwrite earlier ones, even when they are in flight.
+    for (int i = 0; i != kWritesPerKey; ++i) {
+      ASSERT_RESULT(WriteRow(session, key, key * 10 + i, WriteOpType::INSERT, Flush::kFalse));
+      ASSERT_OK(session->FlushPipelined([](const Status& status) { return status; }));
+    }
+  }
+  // Read waits for writes to the tablet of the key.
+  VERIFY_ROW(session, 0, kWritesPerKey - 1);
+  ASSERT_OK(txn->CommitFuture().get());
+
+  auto read_session = CreateSession();
+  for (int key = 0; key != kKeys; ++key) {
+    VERIFY_ROW(read_session, key, key * 10 + kWritesPerKey - 1);
+  }
+  CheckNoRunningTransactions();
+}
+
 TEST_F(QLTransactionTest, ReadRestart) {
   TestReadRestart();
   CheckNoRunningTransactions();
@@ -409,6 +464,123 @@ TEST_F(QLTransactionTest, Heartbeat) {
   CheckNoRunningTransactions();
 }
 
+TEST_F(QLTransactionTest, ManyHeartbeats) {
+  // Heartbeats of concurrent transactions are batched per status tablet, check that all of them
+  // are kept alive.
+  constexpr size_t kTransactions = 20;
+  std::vector<YBTransactionPtr> transactions;
+  for (size_t i = 0; i != kTransactions; ++i) {
+    auto txn = CreateTransaction();
+    WriteRows(CreateSession(txn), i);
+    transactions.push_back(std::move(txn));
+  }
+  std::this_thread::sleep_for(GetTransactionTimeout() * 2);
+  for (auto& txn : transactions) {
+    ASSERT_OK(txn->CommitFuture().get());
+  }
+  VerifyData(kTransactions);
+  CheckNoRunningTransactions();
+}
+
+// Most heartbeats are handled in memory of the status tablet leader, check that a new leader does
+// not expire the transaction.
+TEST_F(QLTransactionTest, HeartbeatAfterStatusTabletLeaderChange) {
+  auto txn = CreateTransaction();
+  WriteRows(CreateSession(txn));
+  std::this_thread::sleep_for(GetTransactionTimeout());
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      if (peer->consensus() &&
+          peer->consensus()->GetLeaderStatus() != consensus::LeaderStatus::NOT_LEADER &&
+          peer->tablet()->transaction_coordinator() &&
+          peer->tablet()->transaction_coordinator()->test_count_transactions()) {
+        consensus::LeaderStepDownRequestPB req;
+        req.set_tablet_id(peer->tablet_id());
+        consensus::LeaderStepDownResponsePB resp;
+        ASSERT_OK(peer->consensus()->StepDown(&req, &resp));
+      }
+    }
+  }
+  std::this_thread::sleep_for(GetTransactionTimeout());
+  ASSERT_OK(txn->CommitFuture().get());
+  VerifyData();
+  CheckNoRunningTransactions();
+}
+
+// Checks that a client placed in the zone of a tablet server picks status tablets led by this
+// tablet server, and that only transactions of known farther status tablets are considered for
+// replacement.
+TEST_F(QLTransactionTest, PickStatusTabletInClientZone) {
+  FLAGS_transaction_status_tablet_locality_refresh_ms = 100;
+
+  // Make sure the transaction status table is created and its tablets are led.
+  WriteData();
+
+  std::vector<std::unordered_set<TabletId>> leaders(cluster_->num_tablet_servers());
+  for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+    std::vector<tablet::TabletPeerPtr> peers;
+    cluster_->mini_tablet_server(i)->server()->tablet_manager()->GetTabletPeers(&peers);
+    for (const auto& peer : peers) {
+      if (peer->consensus() &&
+          peer->consensus()->GetLeaderStatus() == consensus::LeaderStatus::LEADER_AND_READY &&
+          peer->tablet()->transaction_coordinator()) {
+        leaders[i].insert(peer->tablet_id());
+      }
+    }
+  }
+  size_t zone_idx = 0;
+  for (size_t i = 1; i != leaders.size(); ++i) {
+    if (leaders[i].size() > leaders[zone_idx].size()) {
+      zone_idx = i;
+    }
+  }
+  const auto& zone_leaders = leaders[zone_idx];
+  ASSERT_FALSE(zone_leaders.empty());
+
+  const auto& options = *cluster_->mini_tablet_server(zone_idx)->options();
+  CloudInfoPB cloud_info;
+  cloud_info.set_placement_cloud(options.placement_cloud());
+  cloud_info.set_placement_region(options.placement_region());
+  cloud_info.set_placement_zone(options.placement_zone());
+  YBClientBuilder builder;
+  builder.set_cloud_info_pb(cloud_info);
+  auto client = ASSERT_RESULT(cluster_->CreateClient(&builder));
+  TransactionManager manager(client.get(), clock_, client::LocalTabletFilter());
+
+  auto pick = [&manager]() -> Result<TabletId> {
+    std::promise<Result<TabletId>> promise;
+    manager.PickStatusTablet([&promise](const Result<TabletId>& result) {
+      promise.set_value(result);
+    });
+    return promise.get_future().get();
+  };
+
+  // Status tablet locations are loaded into the meta cache asynchronously after the first pick.
+  ASSERT_OK(WaitFor([&pick, &zone_leaders]() -> Result<bool> {
+    return zone_leaders.count(VERIFY_RESULT(pick())) != 0;
+  }, 10s, "Pick status tablet in client zone"));
+
+  for (int i = 0; i != 20; ++i) {
+    auto tablet_id = ASSERT_RESULT(pick());
+    ASSERT_EQ(zone_leaders.count(tablet_id), 1) << "Picked: " << tablet_id;
+  }
+
+  for (const auto& tablet_id : zone_leaders) {
+    ASSERT_FALSE(manager.HasCloserStatusTablet(tablet_id)) << tablet_id;
+  }
+  for (size_t i = 0; i != leaders.size(); ++i) {
+    if (i != zone_idx) {
+      for (const auto& tablet_id : leaders[i]) {
+        ASSERT_TRUE(manager.HasCloserStatusTablet(tablet_id)) << tablet_id;
+      }
+    }
+  }
+  // Transaction with status tablet whose leader is not known should not be replaced.
+  ASSERT_FALSE(manager.HasCloserStatusTablet("unknown-tablet"));
+}
+
 TEST_F(QLTransactionTest, Expire) {
   SetDisableHeartbeatInTests(true);
   auto txn = CreateTransaction();
@@ -820,6 +992,39 @@ TEST_F_EX(QLTransactionTest, IntentsCleanupAfterRestart, QLTransactionTestWithDi
   }, 10s, "Enough compactions happen"));
 }
 
+// Intents of aborted transactions, that are stored in the intents DB when it is opened, should be
+// cleaned in background even without compactions.
+TEST_F_EX(QLTransactionTest, StaleIntentsCleanupAfterRestart,
+          QLTransactionTestWithDisabledCompactions) {
+  SetAtomicFlag(0ULL, &FLAGS_max_clock_skew_usec); // To avoid read restart in this test.
+  FLAGS_transaction_disable_proactive_cleanup_in_tests = true;
+  FLAGS_aborted_intent_cleanup_ms = 1000; // 1 sec
+  FLAGS_stale_intents_cleanup_interval_ms = 0;
+
+  const int kTransactions = 10;
+
+  for (size_t i = 0; i != kTransactions; ++i) {
+    SCOPED_TRACE(Format("Transaction $0", i));
+    auto txn = CreateTransaction();
+    auto session = CreateSession(txn);
+    for (int row = 0; row != kNumRows; ++row) {
+      ASSERT_OK(WriteRow(session, i * kNumRows + row, row));
+    }
+    txn->Abort();
+  }
+
+  ASSERT_OK(WaitTransactionsCleaned());
+  ASSERT_OK(cluster_->FlushTablets());
+  ASSERT_GT(CountIntents(), 0);
+
+  FLAGS_stale_intents_cleanup_interval_ms = 100;
+  ASSERT_OK(cluster_->RestartSync());
+
+  ASSERT_OK(WaitFor([this] {
+    return CountIntents() == 0;
+  }, 10s * kTimeMultiplier, "Intents cleaned"));
+}
+
 TEST_F(QLTransactionTest, ResolveIntentsWriteReadBeforeAndAfterCommit) {
   SetAtomicFlag(0ULL, &FLAGS_max_clock_skew_usec); // To avoid read restart in this test.
   DisableApplyingIntents();
@@ -1027,28 +1232,31 @@ struct TransactionState {
     auto resp = status_future.get();
     ASSERT_OK(resp);
 
-    if (resp->status() == TransactionStatus::ABORTED) {
+    ASSERT_EQ(1, resp->status_size());
+    auto new_status = resp->status(0);
+    if (new_status == TransactionStatus::ABORTED) {
       ASSERT_TRUE(commit_future.valid());
       transaction = nullptr;
       return;
     }
 
-    auto new_time = HybridTime(resp->status_hybrid_time());
+    ASSERT_EQ(1, resp->status_hybrid_time_size());
+    auto new_time = HybridTime(resp->status_hybrid_time(0));
     if (last_status == TransactionStatus::PENDING) {
-      if (resp->status() == TransactionStatus::PENDING) {
+      if (new_status == TransactionStatus::PENDING) {
         ASSERT_GE(new_time, status_time);
       } else {
-        ASSERT_EQ(TransactionStatus::COMMITTED, resp->status());
+        ASSERT_EQ(TransactionStatus::COMMITTED, new_status);
         ASSERT_GT(new_time, status_time);
       }
     } else {
       ASSERT_EQ(last_status, TransactionStatus::COMMITTED);
-      ASSERT_EQ(resp->status(), TransactionStatus::COMMITTED)
-          << "Bad transaction status: " << TransactionStatus_Name(resp->status());
+      ASSERT_EQ(new_status, TransactionStatus::COMMITTED)
+          << "Bad transaction status: " << TransactionStatus_Name(new_status);
       ASSERT_EQ(status_time, new_time);
     }
     status_time = new_time;
-    last_status = resp->status();
+    last_status = new_status;
   }
 };
 
@@ -1110,7 +1318,7 @@ TEST_F(QLTransactionTest, StatusEvolution) {
       }
       tserver::GetTransactionStatusRequestPB req;
       req.set_tablet_id(state.metadata.status_tablet);
-      req.set_transaction_id(state.metadata.transaction_id.data,
+      req.add_transaction_id(state.metadata.transaction_id.data,
                              state.metadata.transaction_id.size());
       state.status_future = rpc::WrapRpcFuture<tserver::GetTransactionStatusResponsePB>(
           GetTransactionStatus, &rpcs)(
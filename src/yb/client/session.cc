@@ -54,6 +54,10 @@ void YBSession::SetReadPoint(const ReadHybridTime& read_time) {
   read_point_->SetReadTime(read_time, {} /* local_limits */);
 }
 
+ReadHybridTime YBSession::GetReadTime() {
+  return DCHECK_NOTNULL(read_point())->GetReadTime();
+}
+
 bool YBSession::IsRestartRequired() {
   auto rp = read_point();
   return rp && rp->IsRestartRequired();
@@ -131,6 +135,46 @@ std::future<Status> YBSession::FlushFuture() {
   return MakeFuture<Status>([this](auto callback) { this->FlushAsync(std::move(callback)); });
 }
 
+void YBSession::FlushAndCommitAsync(StatusFunctor callback) {
+  auto transaction = transaction_;
+  if (!transaction) {
+    callback(STATUS(IllegalState, "Commit of session without transaction"));
+    return;
+  }
+  if (batcher_) {
+    batcher_->set_commit_after_flush(true);
+  }
+  FlushAsync([transaction, callback = std::move(callback)](const Status& status) {
+    if (!status.ok()) {
+      callback(status);
+      return;
+    }
+    transaction->Commit(callback);
+  });
+}
+
+Status YBSession::FlushPipelined(PipelinedFlushVerifier verifier) {
+  auto transaction = transaction_;
+  if (!transaction) {
+    return STATUS(IllegalState, "Pipelined flush of session without transaction");
+  }
+  if (!batcher_) {
+    return Status::OK();
+  }
+  auto flush_id = transaction->PipelinedFlushStarted();
+  batcher_->set_pipelined_flush_id(flush_id);
+  FlushAsync([transaction, flush_id, verifier = std::move(verifier)](const Status& status) {
+    transaction->PipelinedFlushDone(flush_id, verifier(status));
+  });
+  return Status::OK();
+}
+
+std::future<Status> YBSession::FlushAndCommitFuture() {
+  return MakeFuture<Status>([this](auto callback) {
+    this->FlushAndCommitAsync(std::move(callback));
+  });
+}
+
 Status YBSession::ReadSync(std::shared_ptr<YBOperation> yb_op) {
   Synchronizer s;
   ReadAsync(std::move(yb_op), s.AsStatusFunctor());
@@ -200,15 +244,8 @@ Status YBSession::ApplyAndFlush(YBOperationPtr yb_op) {
 }
 
 Status YBSession::Apply(const std::vector<YBOperationPtr>& ops) {
-  auto& batcher = Batcher();
-  for (const auto& op : ops) {
-    Status s = batcher.Add(op);
-    if (!PREDICT_FALSE(s.ok())) {
-      error_collector_->AddError(op, s);
-      return s;
-    }
-  }
-  return Status::OK();
+  // Failures are reported to the error collector by the batcher.
+  return Batcher().Add(ops);
 }
 
 Status YBSession::ApplyAndFlush(
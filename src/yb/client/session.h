@@ -40,6 +40,9 @@ class ErrorCollector;
 YB_STRONGLY_TYPED_BOOL(VerifyResponse);
 YB_STRONGLY_TYPED_BOOL(Restart);
 
+// Invoked with the status of a pipelined flush, returns the status reported to the transaction.
+typedef std::function<Status(const Status&)> PipelinedFlushVerifier;
+
 // A YBSession belongs to a specific YBClient, and represents a context in
 // which all read/write data access should take place. Within a session,
 // multiple operations may be accumulated and batched together for better
@@ -100,6 +103,9 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
 
   void SetReadPoint(const ReadHybridTime& read_time);
 
+  // Returns the read time of the consistent read point used by the operations of this session.
+  ReadHybridTime GetReadTime();
+
   // Returns true if our current read point requires restart.
   bool IsRestartRequired();
 
@@ -175,6 +181,21 @@ class YBSession : public std::enable_shared_from_this<YBSession> {
   void FlushAsync(StatusFunctor callback);
   std::future<Status> FlushFuture();
 
+  // Flushes buffered operations and commits the transaction of this session.
+  // When all operations are writes to the same tablet and the transaction did not execute
+  // operations before, they are applied as a single tablet write, without writing intents and
+  // contacting the transaction status tablet.
+  void FlushAndCommitAsync(StatusFunctor callback);
+  std::future<Status> FlushAndCommitFuture();
+
+  // Flushes buffered write operations of the transaction of this session, without waiting for
+  // them to complete. Operations of the transaction sent later to the same tablets wait until
+  // these writes complete, and so does commit, that fails if the flush failed.
+  //
+  // verifier is invoked when the flush completes. It should check results of individual
+  // operations, that are not reported to the caller otherwise.
+  CHECKED_STATUS FlushPipelined(PipelinedFlushVerifier verifier);
+
   // Abort the unflushed or in-flight operations in the session.
   void Abort();
 
@@ -15,6 +15,7 @@
 
 #include "yb/client/client.h"
 #include "yb/client/client-internal.h"
+#include "yb/client/meta_cache.h"
 #include "yb/client/yb_op.h"
 
 #include "yb/master/master.pb.h"
@@ -101,6 +102,10 @@ const IndexInfo& YBTable::index_info() const {
   return *info_.index_info;
 }
 
+bool YBTable::colocated() const {
+  return info_.colocated;
+}
+
 const PartitionSchema& YBTable::partition_schema() const {
   return info_.partition_schema;
 }
@@ -247,6 +252,8 @@ Status YBTable::Open() {
   RETURN_NOT_OK_PREPEND(PBToClientTableType(resp.table_type(), &table_type_),
     strings::Substitute("Invalid table type for table '$0'", info_.table_name.ToString()));
 
+  client_->data_->meta_cache_->TableOpened(this, resp.tablet_locations());
+
   VLOG(1) << "Open Table " << info_.table_name.ToString() << ", found "
           << resp.tablet_locations_size() << " tablets";
   return Status::OK();
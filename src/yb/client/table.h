@@ -41,6 +41,7 @@ struct YBTableInfo {
   PartitionSchema partition_schema;
   IndexMap index_map;
   boost::optional<IndexInfo> index_info;
+  bool colocated = false;
 };
 
 // A YBTable represents a table on a particular cluster. It holds the current
@@ -83,6 +84,9 @@ class YBTable : public std::enable_shared_from_this<YBTable> {
   // For index table: information about this index.
   const IndexInfo& index_info() const;
 
+  // Is the table stored in the tablet shared by the tables of its colocated database?
+  bool colocated() const;
+
   //------------------------------------------------------------------------------------------------
   // CQL support
   // Create a new QL operation for this table.
@@ -300,6 +300,134 @@ void TableIterator::HandleError(const Status& status) {
   }
 }
 
+TableParallelScan::TableParallelScan(
+    const TableHandle& table, TableIteratorOptions options, size_t concurrency,
+    size_t max_queued_blocks)
+    : table_(&table), options_(std::move(options)), max_queued_blocks_(max_queued_blocks) {
+  if (!options_.columns) {
+    options_.columns = table.AllColumnNames();
+  }
+  concurrency = std::max<size_t>(
+      std::min(concurrency, table->GetPartitions().size()), 1);
+  running_streams_ = concurrency;
+  streams_.reserve(concurrency);
+  for (size_t i = 0; i != concurrency; ++i) {
+    streams_.emplace_back(&TableParallelScan::StreamLoop, this);
+  }
+}
+
+TableParallelScan::~TableParallelScan() {
+  Stop();
+  for (auto& stream : streams_) {
+    stream.join();
+  }
+}
+
+void TableParallelScan::Stop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stopped_ = true;
+  queue_.clear();
+  cond_.notify_all();
+}
+
+Result<boost::optional<QLRowBlock>> TableParallelScan::Next() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    RETURN_NOT_OK(status_);
+    if (!queue_.empty()) {
+      auto result = std::move(queue_.front());
+      queue_.pop_front();
+      cond_.notify_all();
+      return boost::optional<QLRowBlock>(std::move(result));
+    }
+    if (running_streams_ == 0 || stopped_) {
+      return boost::none;
+    }
+    cond_.wait(lock);
+  }
+}
+
+void TableParallelScan::StreamLoop() {
+  auto session = (*table_)->client()->NewSession();
+  session->SetTimeout(60s);
+  const size_t num_partitions = (*table_)->GetPartitions().size();
+  Status status;
+  for (;;) {
+    size_t partition_index;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (stopped_ || next_partition_ == num_partitions) {
+        break;
+      }
+      partition_index = next_partition_++;
+    }
+    status = ScanPartition(partition_index, session.get());
+    if (!status.ok()) {
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!status.ok() && status_.ok()) {
+    status_ = status;
+    stopped_ = true;
+  }
+  --running_streams_;
+  cond_.notify_all();
+}
+
+Status TableParallelScan::ScanPartition(size_t partition_index, YBSession* session) {
+  // Rows fetched from a tablet per request.
+  constexpr int kPageSize = 1024;
+
+  auto op = table_->NewReadOp();
+  auto req = op->mutable_request();
+  op->set_yb_consistency_level(options_.consistency);
+  if (options_.filter) {
+    options_.filter(*table_, req->mutable_where_expr()->mutable_condition());
+  }
+  if (options_.read_time) {
+    op->SetReadTime(options_.read_time);
+  }
+  table_->AddColumns(*options_.columns, req);
+  if (!op->RestrictToPartition(partition_index)) {
+    return Status::OK();
+  }
+  req->set_return_paging_state(true);
+  req->set_limit(kPageSize);
+
+  for (;;) {
+    RETURN_NOT_OK(session->ApplyAndFlush(op));
+    if (QLResponsePB::YQL_STATUS_OK != op->response().status()) {
+      return STATUS_FORMAT(RuntimeError, "Error for $0: $1", *op, op->response());
+    }
+    auto block = op->MakeRowBlock();
+    RETURN_NOT_OK(block);
+    if (!block->rows().empty() && !Push(std::move(*block))) {
+      return Status::OK();
+    }
+    // The request is bounded by the partition, so the paging state never points past it.
+    if (!op->response().has_paging_state()) {
+      return Status::OK();
+    }
+    auto paging_state = op->response().paging_state();
+    *req->mutable_paging_state() = std::move(paging_state);
+  }
+}
+
+bool TableParallelScan::Push(QLRowBlock block) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopped_ && queue_.size() >= max_queued_blocks_) {
+    cond_.wait(lock);
+  }
+  if (stopped_) {
+    return false;
+  }
+  queue_.push_back(std::move(block));
+  cond_.notify_all();
+  return true;
+}
+
 template <>
 void FilterBetweenImpl<int32_t>::operator()(
     const TableHandle& table, QLConditionPB* condition) const {
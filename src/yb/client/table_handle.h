@@ -14,6 +14,9 @@
 #ifndef YB_CLIENT_TABLE_HANDLE_H
 #define YB_CLIENT_TABLE_HANDLE_H
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
 #include <unordered_map>
 
 #include <boost/optional.hpp>
@@ -228,6 +231,45 @@ class TableRange {
   TableIteratorOptions options_;
 };
 
+// Scans the whole table with several concurrent streams, one partition at a time per stream,
+// paging through each partition. Blocks of rows are delivered through a bounded queue, in no
+// particular order across partitions. Rows within a partition keep their order.
+class TableParallelScan {
+ public:
+  // Up to concurrency streams are run. A stream does not fetch the next page while
+  // max_queued_blocks blocks are waiting to be consumed.
+  TableParallelScan(const TableHandle& table, TableIteratorOptions options,
+                    size_t concurrency = 4, size_t max_queued_blocks = 16);
+
+  ~TableParallelScan();
+
+  // Returns the next block of rows, or none when the whole table has been scanned.
+  Result<boost::optional<QLRowBlock>> Next();
+
+  // Stops the scan. Each stream stops after its outstanding page, and queued blocks are dropped.
+  void Stop();
+
+ private:
+  void StreamLoop();
+  CHECKED_STATUS ScanPartition(size_t partition_index, YBSession* session);
+
+  // Waits for space in the queue and pushes the block. Returns false if the scan was stopped.
+  bool Push(QLRowBlock block);
+
+  const TableHandle* table_;
+  TableIteratorOptions options_;
+  const size_t max_queued_blocks_;
+  std::vector<std::thread> streams_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::deque<QLRowBlock> queue_;
+  size_t next_partition_ = 0;
+  size_t running_streams_ = 0;
+  bool stopped_ = false;
+  Status status_;
+};
+
 YB_STRONGLY_TYPED_BOOL(Inclusive);
 
 template <class T>
@@ -63,6 +63,23 @@ void TabletInvoker::SelectTabletServerWithConsistentPrefix() {
   VLOG(1) << "Using tserver: " << yb::ToString(current_ts_);
 }
 
+RemoteTabletServer* TabletInvoker::SelectHedgeTabletServer() {
+  if (!current_ts_) {
+    return nullptr;
+  }
+  std::vector<RemoteTabletServer*> candidates;
+  auto* result = client_->data_->SelectTServer(tablet_.get(),
+                                               YBClient::ReplicaSelection::CLOSEST_REPLICA,
+                                               {current_ts_->permanent_uuid()},
+                                               &candidates);
+  if (result == nullptr || !result->InitProxy(client_).ok()) {
+    return nullptr;
+  }
+  VLOG(2) << "Tablet " << tablet_id_ << ": Hedging read from " << current_ts_->ToString()
+          << " to " << result->ToString();
+  return result;
+}
+
 void TabletInvoker::SelectLocalTabletServer() {
   current_ts_ = client_->data_->meta_cache_->local_tserver();
   VLOG(1) << "Using local tserver: " << current_ts_->ToString();
@@ -267,14 +284,17 @@ bool TabletInvoker::Done(Status* status) {
     VLOG(4) << "Retryable failure: " << *status
             << ", response: " << yb::ToString(rpc_->response_error());
 
+    const auto error_code = ErrorCode(rpc_->response_error());
     const bool leader_is_not_ready =
-        ErrorCode(rpc_->response_error()) ==
-            tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE ||
+        error_code == tserver::TabletServerErrorPB::LEADER_NOT_READY_TO_SERVE ||
         status->IsLeaderNotReadyToServe();
+    const bool write_throttled =
+        error_code == tserver::TabletServerErrorPB::WRITE_THROTTLED ||
+        error_code == tserver::TabletServerErrorPB::TABLET_OVERLOADED;
 
-    // If the leader just is not ready - let's retry the same tserver.
+    // If the leader just is not ready or throttles requests - let's retry the same tserver.
     // Else the leader became a follower and must be reset on retry.
-    if (!leader_is_not_ready) {
+    if (!leader_is_not_ready && !write_throttled) {
       followers_.insert(current_ts_);
     }
 
@@ -294,7 +314,7 @@ bool TabletInvoker::Done(Status* status) {
       // The whole operation is completed if we can't schedule a retry.
       return !FailToNewReplica(*status, rpc_->response_error()).ok();
     } else {
-      auto retry_status = retrier_->DelayedRetry(command_, *status);
+      auto retry_status = retrier_->DelayedRetry(command_, *status, rpc_->RetryDelay());
       if (!retry_status.ok()) {
         command_->Finished(retry_status);
       }
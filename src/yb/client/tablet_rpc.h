@@ -44,6 +44,9 @@ class TabletRpc {
   virtual const tserver::TabletServerErrorPB* response_error() const = 0;
   virtual void Failed(const Status& status) = 0;
   virtual void SendRpcToTserver() = 0;
+
+  // Minimal delay before retrying the failed rpc, requested by the server.
+  virtual MonoDelta RetryDelay() const { return MonoDelta::kZero; }
  protected:
   ~TabletRpc() {}
 };
@@ -75,6 +78,10 @@ class TabletInvoker {
   const RemoteTabletServer& current_ts() { return *current_ts_; }
   bool local_tserver_only() const { return local_tserver_only_; }
 
+  // Selects the closest replica other than the current one, to send a hedged read to. Returns
+  // nullptr if there is no such replica or its proxy could not be initialized.
+  RemoteTabletServer* SelectHedgeTabletServer();
+
  private:
   friend class TabletRpcTest;
   FRIEND_TEST(TabletRpcTest, TabletInvokerSelectTabletServerRace);
@@ -15,6 +15,7 @@
 
 #include "yb/client/transaction.h"
 
+#include <set>
 #include <unordered_set>
 
 #include "yb/client/async_rpc.h"
@@ -42,8 +43,13 @@ using namespace std::placeholders;
 
 DEFINE_uint64(transaction_heartbeat_usec, 500000, "Interval of transaction heartbeat in usec.");
 DEFINE_bool(transaction_disable_heartbeat_in_tests, false, "Disable heartbeat during test.");
+DEFINE_bool(transaction_batch_heartbeats, true,
+            "Send heartbeats of transactions coordinated by the same status tablet in batches.");
 DEFINE_bool(transaction_disable_proactive_cleanup_in_tests, false,
             "Disable cleanup of intents in abort path.");
+DEFINE_bool(transaction_single_shard_fast_path, true,
+            "Commit transaction, whose operations are all writes to the same tablet, in one "
+            "phase as a single non-transactional write.");
 DECLARE_uint64(max_clock_skew_usec);
 
 namespace yb {
@@ -170,7 +176,8 @@ class YBTransaction::Impl final {
                ForceConsistentRead force_consistent_read,
                Waiter waiter,
                TransactionMetadata* metadata,
-               bool* may_have_metadata) {
+               bool* may_have_metadata,
+               int64_t pipelined_flush_id) {
     VLOG_WITH_PREFIX(2) << "Prepare";
 
     bool has_tablets_without_metadata = false;
@@ -186,6 +193,17 @@ class YBTransaction::Impl final {
         return false;
       }
 
+      if (ShouldWaitForPipelinedWrites(ops, pipelined_flush_id)) {
+        if (waiter) {
+          pipelined_waiters_.push_back(std::move(waiter));
+        }
+        VLOG_WITH_PREFIX(2) << "Prepare, rejected (waiting for pipelined writes)";
+        return false;
+      }
+      if (pipelined_flush_id != 0) {
+        unsent_pipelined_flushes_.erase(pipelined_flush_id);
+      }
+
       bool single_tablet = true;
       internal::RemoteTablet* tablet = nullptr;
       for (const auto& op : ops) {
@@ -226,6 +244,10 @@ class YBTransaction::Impl final {
             !op->yb_op->read_only()) {
           it->second.metadata_state = InvolvedTabletMetadataState::MAY_EXIST;
         }
+        if (pipelined_flush_id != 0 && !op->yb_op->read_only()) {
+          op->pipelined = true;
+          ++it->second.pipelined_writes;
+        }
       }
 
       // For serializable isolation we never choose read time, since it always reads latest
@@ -247,6 +269,25 @@ class YBTransaction::Impl final {
     return true;
   }
 
+  bool TryCommitInOnePhase() {
+    if (!FLAGS_transaction_single_shard_fast_path) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Operations executed before, including reads, could conflict with ones that are executed
+    // now, so we could not write them without transaction.
+    if (state_.load(std::memory_order_acquire) != TransactionState::kRunning || child_ ||
+        !tablets_.empty() || last_pipelined_flush_id_ != 0 || read_point_.GetReadTime() ||
+        IsRestartRequired()) {
+      return false;
+    }
+    VLOG_WITH_PREFIX(1) << "Commit in one phase";
+    state_.store(TransactionState::kCommitted, std::memory_order_release);
+    one_phase_commit_ = true;
+    return true;
+  }
+
   void Flushed(
       const internal::InFlightOps& ops, const ReadHybridTime& used_read_time,
       const Status& status) {
@@ -254,6 +295,14 @@ class YBTransaction::Impl final {
         << "Flushed: " << yb::ToString(ops) << ", used_read_time: " << used_read_time
         << ", status: " << status;
 
+    // one_phase_commit_ is set before ops are sent, so it is safe to check it without lock.
+    if (one_phase_commit_) {
+      OnePhaseCommitFlushed(status);
+      return;
+    }
+
+    PipelinedWritesFlushed(ops);
+
     if (status.ok()) {
       std::lock_guard<std::mutex> lock(mutex_);
       if (used_read_time && metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
@@ -285,6 +334,17 @@ class YBTransaction::Impl final {
     auto transaction = transaction_->shared_from_this();
     {
       std::unique_lock<std::mutex> lock(mutex_);
+      if (one_phase_commit_) {
+        // Result of commit is the result of single write, so wait for it if it is in flight.
+        if (!one_phase_flushed_) {
+          commit_callback_ = std::move(callback);
+          return;
+        }
+        auto status = one_phase_status_;
+        lock.unlock();
+        callback(status);
+        return;
+      }
       auto status = CheckRunning(&lock);
       if (!status.ok()) {
         callback(status);
@@ -299,6 +359,20 @@ class YBTransaction::Impl final {
             IllegalState, "Commit of transaction that requires restart is not allowed"));
         return;
       }
+      if (pipelined_flushes_in_flight_ != 0) {
+        pipelined_waiters_.push_back([this, transaction, callback](const Status&) {
+          Commit(callback);
+        });
+        return;
+      }
+      if (!pipelined_status_.ok()) {
+        // Provisional writes of the transaction failed, so it could only be aborted.
+        status = pipelined_status_;
+        lock.unlock();
+        Abort();
+        callback(status);
+        return;
+      }
       state_.store(TransactionState::kCommitted, std::memory_order_release);
       commit_callback_ = std::move(callback);
       if (!ready_) {
@@ -315,6 +389,10 @@ class YBTransaction::Impl final {
     auto transaction = transaction_->shared_from_this();
     {
       std::unique_lock<std::mutex> lock(mutex_);
+      if (one_phase_commit_) {
+        // Single write is either applied or failed as a whole, so nothing to abort.
+        return;
+      }
       auto state = state_.load(std::memory_order_acquire);
       if (state != TransactionState::kRunning) {
         LOG_IF(DFATAL, state != TransactionState::kAborted) << "Abort of committed transaction";
@@ -341,7 +419,47 @@ class YBTransaction::Impl final {
 
   bool HasOperations() {
     std::lock_guard<std::mutex> lock(mutex_);
-    return !tablets_.empty();
+    return !tablets_.empty() || one_phase_commit_ || last_pipelined_flush_id_ != 0;
+  }
+
+  int64_t PipelinedFlushStarted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto flush_id = ++last_pipelined_flush_id_;
+    unsent_pipelined_flushes_.insert(flush_id);
+    ++pipelined_flushes_in_flight_;
+    return flush_id;
+  }
+
+  void PipelinedFlushDone(int64_t flush_id, const Status& status) {
+    VLOG_WITH_PREFIX(2) << "Pipelined flush " << flush_id << " done: " << status;
+    std::vector<Waiter> waiters;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      // The flush could fail before its operations were sent.
+      unsent_pipelined_flushes_.erase(flush_id);
+      --pipelined_flushes_in_flight_;
+      if (!status.ok() && pipelined_status_.ok()) {
+        pipelined_status_ = status;
+      }
+      waiters.swap(pipelined_waiters_);
+    }
+    for (const auto& waiter : waiters) {
+      waiter(Status::OK());
+    }
+  }
+
+  void WaitForPipelinedWrites(CommitCallback callback) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (pipelined_flushes_in_flight_ != 0) {
+      auto transaction = transaction_->shared_from_this();
+      pipelined_waiters_.push_back([this, transaction, callback](const Status&) {
+        WaitForPipelinedWrites(callback);
+      });
+      return;
+    }
+    auto status = pipelined_status_;
+    lock.unlock();
+    callback(status);
   }
 
   std::shared_future<TransactionMetadata> TEST_GetMetadata() {
@@ -438,6 +556,11 @@ class YBTransaction::Impl final {
     return metadata_.transaction_id;
   }
 
+  TabletId status_tablet_id() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return metadata_.status_tablet;
+  }
+
   ConsistentReadPoint& read_point() {
     return read_point_;
   }
@@ -450,6 +573,47 @@ class YBTransaction::Impl final {
     abort_handle_ = manager_->rpcs().InvalidHandle();
   }
 
+  // Operations are sent to a tablet in the order of flushes, so operations should wait while
+  // there are pipelined writes in flight to any of their tablets, or a pipelined flush started
+  // before them was not sent yet.
+  bool ShouldWaitForPipelinedWrites(
+      const std::unordered_set<internal::InFlightOpPtr>& ops, int64_t pipelined_flush_id) {
+    if (pipelined_flushes_in_flight_ == 0) {
+      return false;
+    }
+    if (!unsent_pipelined_flushes_.empty() &&
+        (pipelined_flush_id == 0 || *unsent_pipelined_flushes_.begin() < pipelined_flush_id)) {
+      return true;
+    }
+    for (const auto& op : ops) {
+      auto it = tablets_.find(op->tablet->tablet_id());
+      if (it != tablets_.end() && it->second.pipelined_writes != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void PipelinedWritesFlushed(const internal::InFlightOps& ops) {
+    std::vector<Waiter> waiters;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& op : ops) {
+        if (!op->pipelined) {
+          continue;
+        }
+        auto it = tablets_.find(op->tablet->tablet_id());
+        CHECK(it != tablets_.end());
+        if (--it->second.pipelined_writes == 0) {
+          waiters.swap(pipelined_waiters_);
+        }
+      }
+    }
+    for (const auto& waiter : waiters) {
+      waiter(Status::OK());
+    }
+  }
+
   void SetReadTimeIfNeeded(bool do_it) {
     if (!read_point_.GetReadTime() && do_it &&
         metadata_.isolation == IsolationLevel::SNAPSHOT_ISOLATION) {
@@ -505,6 +669,26 @@ class YBTransaction::Impl final {
         &commit_handle_);
   }
 
+  void OnePhaseCommitFlushed(const Status& status) {
+    CommitCallback callback;
+    bool release_status_tablet;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      one_phase_flushed_ = true;
+      one_phase_status_ = status;
+      callback = std::move(commit_callback_);
+      release_status_tablet = ready_;
+    }
+    // Status tablet could be already picked, for instance by transaction pool. Transaction is
+    // not registered anywhere else, so just abort it there instead of waiting for expiration.
+    if (release_status_tablet) {
+      DoAbort(Status::OK(), transaction_->shared_from_this());
+    }
+    if (callback) {
+      callback(status);
+    }
+  }
+
   void DoAbort(const Status& status, const YBTransactionPtr& transaction) {
     VLOG_WITH_PREFIX(1) << Format("Abort, status: $1", status);
 
@@ -694,6 +878,12 @@ class YBTransaction::Impl final {
       return;
     }
 
+    if (status == TransactionStatus::PENDING && FLAGS_transaction_batch_heartbeats) {
+      manager_->SendHeartbeat(
+          status_tablet_, id, std::bind(&Impl::HeartbeatDone, this, _1, _2, status, transaction));
+      return;
+    }
+
     tserver::UpdateTransactionRequestPB req;
     req.set_tablet_id(status_tablet_->tablet_id());
     req.set_propagated_hybrid_time(manager_->Now().ToUint64());
@@ -805,6 +995,10 @@ class YBTransaction::Impl final {
   bool ready_ = false;
   CommitCallback commit_callback_;
   Status error_;
+  // Transaction writes were sent to a single tablet as one non-transactional write.
+  bool one_phase_commit_ = false;
+  bool one_phase_flushed_ = false;
+  Status one_phase_status_;
   rpc::Rpcs::Handle heartbeat_handle_;
   rpc::Rpcs::Handle commit_handle_;
   rpc::Rpcs::Handle abort_handle_;
@@ -820,6 +1014,8 @@ class YBTransaction::Impl final {
 
   struct TabletState {
     InvolvedTabletMetadataState metadata_state = InvolvedTabletMetadataState::MISSING;
+    // Number of pipelined writes sent to this tablet, that did not complete yet.
+    size_t pipelined_writes = 0;
 
     void ToPB(TransactionInvolvedTabletPB* out) const {
       out->set_metadata_state(metadata_state);
@@ -841,7 +1037,8 @@ class YBTransaction::Impl final {
     }
 
     std::string ToString() const {
-      return Format("{ metadata_state $0 }", InvolvedTabletMetadataState_Name(metadata_state));
+      return Format("{ metadata_state $0 pipelined_writes $1 }",
+                    InvolvedTabletMetadataState_Name(metadata_state), pipelined_writes);
     }
   };
 
@@ -850,6 +1047,16 @@ class YBTransaction::Impl final {
   std::mutex mutex_;
   TabletStates tablets_;
   std::vector<Waiter> waiters_;
+
+  // Pipelined flushes, see YBSession::FlushPipelined.
+  int64_t last_pipelined_flush_id_ = 0;
+  size_t pipelined_flushes_in_flight_ = 0;
+  // Flushes whose operations were not sent yet.
+  std::set<int64_t> unsent_pipelined_flushes_;
+  Status pipelined_status_;
+  // Operations, commits and waits that are blocked by pipelined writes.
+  std::vector<Waiter> pipelined_waiters_;
+
   std::promise<TransactionMetadata> metadata_promise_;
   std::shared_future<TransactionMetadata> metadata_future_;
 };
@@ -873,9 +1080,15 @@ bool YBTransaction::Prepare(const std::unordered_set<internal::InFlightOpPtr>& o
                             ForceConsistentRead force_consistent_read,
                             Waiter waiter,
                             TransactionMetadata* metadata,
-                            bool* may_have_metadata) {
+                            bool* may_have_metadata,
+                            int64_t pipelined_flush_id) {
   return impl_->Prepare(
-      ops, force_consistent_read, std::move(waiter), metadata, may_have_metadata);
+      ops, force_consistent_read, std::move(waiter), metadata, may_have_metadata,
+      pipelined_flush_id);
+}
+
+bool YBTransaction::TryCommitInOnePhase() {
+  return impl_->TryCommitInOnePhase();
 }
 
 void YBTransaction::Flushed(
@@ -891,6 +1104,10 @@ const TransactionId& YBTransaction::id() const {
   return impl_->id();
 }
 
+TabletId YBTransaction::status_tablet_id() const {
+  return impl_->status_tablet_id();
+}
+
 const IsolationLevel YBTransaction::isolation() const {
   return impl_->isolation();
 }
@@ -903,6 +1120,24 @@ ConsistentReadPoint& YBTransaction::read_point() {
   return impl_->read_point();
 }
 
+int64_t YBTransaction::PipelinedFlushStarted() {
+  return impl_->PipelinedFlushStarted();
+}
+
+void YBTransaction::PipelinedFlushDone(int64_t flush_id, const Status& status) {
+  impl_->PipelinedFlushDone(flush_id, status);
+}
+
+void YBTransaction::WaitForPipelinedWrites(CommitCallback callback) {
+  impl_->WaitForPipelinedWrites(std::move(callback));
+}
+
+std::future<Status> YBTransaction::PipelinedWritesFuture() {
+  return MakeFuture<Status>([this](auto callback) {
+    impl_->WaitForPipelinedWrites(std::move(callback));
+  });
+}
+
 std::future<Status> YBTransaction::CommitFuture() {
   return MakeFuture<Status>([this](auto callback) { impl_->Commit(std::move(callback)); });
 }
@@ -75,17 +75,42 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   // This function is used to init metadata of Write/Read request.
   // If we don't have enough information, then the function returns false and stores
   // the waiter, which will be invoked when we obtain such information.
+  // Operations to tablets, that have pipelined writes in flight, wait for them in the same way.
+  // pipelined_flush_id is the ID returned by PipelinedFlushStarted if ops belong to a pipelined
+  // flush, 0 otherwise.
   bool Prepare(const std::unordered_set<internal::InFlightOpPtr>& ops,
                ForceConsistentRead force_consistent_read,
                Waiter waiter,
                TransactionMetadata* metadata,
-               bool* may_have_metadata);
+               bool* may_have_metadata,
+               int64_t pipelined_flush_id);
+
+  // Tries to commit this transaction in one phase. Should be invoked instead of Prepare, when
+  // the caller is going to send all operations of the transaction to a single tablet in one
+  // write, and commit afterwards. Succeeds only if the transaction did not execute operations
+  // before. In this case ops should be sent without transaction metadata, and result of this
+  // write is reported to the commit callback.
+  bool TryCommitInOnePhase();
 
   // Notifies transaction that specified ops were flushed with some status.
   void Flushed(
       const internal::InFlightOps& ops, const ReadHybridTime& used_read_time, const Status& status);
 
-  // Commits this transaction.
+  // Registers a flush of provisional writes, that the session does not wait for, see
+  // YBSession::FlushPipelined. Returns ID of the flush, that should be passed to Prepare.
+  int64_t PipelinedFlushStarted();
+
+  // Notifies transaction that the pipelined flush has completed with the specified status.
+  // The first failure of pipelined flushes fails commit of the transaction.
+  void PipelinedFlushDone(int64_t flush_id, const Status& status);
+
+  // Invokes callback when all pipelined flushes complete, with the first failure of them.
+  void WaitForPipelinedWrites(CommitCallback callback);
+
+  // Utility function for WaitForPipelinedWrites.
+  std::future<Status> PipelinedWritesFuture();
+
+  // Commits this transaction. Waits for pipelined flushes first.
   void Commit(CommitCallback callback);
 
   // Utility function for Commit.
@@ -97,6 +122,9 @@ class YBTransaction : public std::enable_shared_from_this<YBTransaction> {
   // Returns transaction ID.
   const TransactionId& id() const;
 
+  // Returns ID of the status tablet, or an empty string if it was not picked yet.
+  TabletId status_tablet_id() const;
+
   const ConsistentReadPoint& read_point() const;
   ConsistentReadPoint& read_point();
 
@@ -15,10 +15,20 @@
 
 #include "yb/client/transaction_manager.h"
 
+#include <mutex>
+#include <unordered_map>
+
+#include "yb/client/meta_cache.h"
+
+#include "yb/common/wire_protocol.h"
+
+#include "yb/gutil/thread_annotations.h"
+
 #include "yb/rpc/rpc.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/rpc/tasks_pool.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 #include "yb/util/thread_restrictions.h"
 
@@ -28,6 +38,21 @@
 
 #include "yb/master/master_defaults.h"
 
+#include "yb/tserver/tserver_service.pb.h"
+
+DEFINE_bool(transaction_prefer_closest_status_tablet, true,
+            "Whether a transaction picks a status tablet whose leader is the closest to the client, "
+            "i.e. on the same node, in the same zone or in the same region, when there is one.");
+TAG_FLAG(transaction_prefer_closest_status_tablet, runtime);
+
+DEFINE_int32(transaction_status_tablet_locality_refresh_ms, 1000,
+             "How often the transaction manager refreshes the leader locality of status tablets, "
+             "that is used to pick the closest status tablet.");
+TAG_FLAG(transaction_status_tablet_locality_refresh_ms, advanced);
+TAG_FLAG(transaction_status_tablet_locality_refresh_ms, runtime);
+
+using namespace std::literals;
+
 namespace yb {
 namespace client {
 
@@ -40,8 +65,76 @@ const YBTableName kTransactionTableName(master::kSystemNamespaceName, kTransacti
 // Resolved - final state, when all tablets are resolved and written to cache.
 YB_DEFINE_ENUM(TransactionTableStatus, (kExists)(kUpdating)(kResolved));
 
-void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>& tablets,
+// Leader locality of status tablets, as seen in the meta cache at some point.
+struct StatusTabletLocalities {
+  // Status tablets whose leaders are the closest to the client, empty if none of them is known to
+  // be in the same region.
+  std::vector<const TabletId*> closest;
+  ServerLocality closest_locality = ServerLocality::kRemote;
+  // Status tablets with known leaders.
+  std::unordered_map<TabletId, ServerLocality> leader_locality;
+};
+
+typedef std::shared_ptr<const StatusTabletLocalities> StatusTabletLocalitiesPtr;
+
+StatusTabletLocalitiesPtr ComputeLocalities(
+    YBClient* client, const std::vector<TabletId>& tablets) {
+  auto result = std::make_shared<StatusTabletLocalities>();
+  for (const auto& id : tablets) {
+    auto locality = client->TabletLeaderLocality(id);
+    if (!locality) {
+      continue;
+    }
+    result->leader_locality.emplace(id, *locality);
+    if (*locality == ServerLocality::kRemote) {
+      continue;
+    }
+    if (*locality < result->closest_locality) {
+      result->closest_locality = *locality;
+      result->closest.clear();
+    }
+    if (*locality == result->closest_locality) {
+      result->closest.push_back(&id);
+    }
+  }
+  return result;
+}
+
+struct TransactionTableState {
+  LocalTabletFilter local_tablet_filter;
+  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
+  std::vector<TabletId> tablets;
+
+  std::mutex localities_mutex;
+  StatusTabletLocalitiesPtr localities GUARDED_BY(localities_mutex);
+  CoarseTimePoint localities_refresh_time GUARDED_BY(localities_mutex);
+
+  // Returns leader locality of status tablets, that is refreshed once in
+  // transaction_status_tablet_locality_refresh_ms, so picking a status tablet does not look up
+  // every status tablet in the meta cache. Could return null while the first refresh is running.
+  // Should be called only after tablets are resolved.
+  StatusTabletLocalitiesPtr Localities(YBClient* client) {
+    const auto now = CoarseMonoClock::Now();
+    {
+      std::lock_guard<std::mutex> lock(localities_mutex);
+      if (now < localities_refresh_time) {
+        return localities;
+      }
+      // Other threads use the previous value while this one refreshes it.
+      localities_refresh_time =
+          now + FLAGS_transaction_status_tablet_locality_refresh_ms * 1ms;
+    }
+    auto result = ComputeLocalities(client, tablets);
+    std::lock_guard<std::mutex> lock(localities_mutex);
+    localities = result;
+    return result;
+  }
+};
+
+void InvokeCallback(YBClient* client, TransactionTableState* table_state,
                     const PickStatusTabletCallback& callback) {
+  const auto& filter = table_state->local_tablet_filter;
+  const auto& tablets = table_state->tablets;
   if (filter) {
     std::vector<const TabletId*> ids;
     ids.reserve(tablets.size());
@@ -55,15 +148,17 @@ void InvokeCallback(const LocalTabletFilter& filter, const std::vector<TabletId>
     }
     LOG(WARNING) << "No local transaction status tablet";
   }
+  if (FLAGS_transaction_prefer_closest_status_tablet) {
+    // Keep heartbeats and commits in the region of this client when possible.
+    auto localities = table_state->Localities(client);
+    if (localities && !localities->closest.empty()) {
+      callback(*RandomElement(localities->closest));
+      return;
+    }
+  }
   callback(RandomElement(tablets));
 }
 
-struct TransactionTableState {
-  LocalTabletFilter local_tablet_filter;
-  std::atomic<TransactionTableStatus> status{TransactionTableStatus::kExists};
-  std::vector<TabletId> tablets;
-};
-
 // Picks status tablet for transaction.
 class PickStatusTabletTask {
  public:
@@ -91,9 +186,19 @@ class PickStatusTabletTask {
         expected, TransactionTableStatus::kUpdating, std::memory_order_acq_rel)) {
       table_state_->tablets = tablets;
       table_state_->status.store(TransactionTableStatus::kResolved, std::memory_order_release);
+      if (FLAGS_transaction_prefer_closest_status_tablet) {
+        // Load locations of the status tablets into the meta cache, so that following picks could
+        // take their leaders into account.
+        const auto deadline =
+            CoarseMonoClock::Now() + client_->default_admin_operation_timeout();
+        for (const auto& tablet : tablets) {
+          client_->LookupTabletById(
+              tablet, deadline, [](const Result<internal::RemoteTabletPtr>&) {}, UseCache::kTrue);
+        }
+      }
     }
 
-    InvokeCallback(table_state_->local_tablet_filter, tablets, callback_);
+    InvokeCallback(client_, table_state_, callback_);
   }
 
   void Done(const Status& status) {
@@ -113,13 +218,14 @@ class PickStatusTabletTask {
 
 class InvokeCallbackTask {
  public:
-  InvokeCallbackTask(TransactionTableState* table_state,
+  InvokeCallbackTask(YBClient* client,
+                     TransactionTableState* table_state,
                      PickStatusTabletCallback callback)
-      : table_state_(table_state), callback_(std::move(callback)) {
+      : client_(client), table_state_(table_state), callback_(std::move(callback)) {
   }
 
   void Run() {
-    InvokeCallback(table_state_->local_tablet_filter, table_state_->tablets, callback_);
+    InvokeCallback(client_, table_state_, callback_);
   }
 
   void Done(const Status& status) {
@@ -130,6 +236,7 @@ class InvokeCallbackTask {
   }
 
  private:
+  YBClient* const client_;
   TransactionTableState* table_state_;
   PickStatusTabletCallback callback_;
 };
@@ -155,8 +262,9 @@ class TransactionManager::Impl {
   void PickStatusTablet(PickStatusTabletCallback callback) {
     if (table_state_.status.load(std::memory_order_acquire) == TransactionTableStatus::kResolved) {
       if (ThreadRestrictions::IsWaitAllowed()) {
-        InvokeCallback(table_state_.local_tablet_filter, table_state_.tablets, callback);
-      } else if (!invoke_callback_tasks_.Enqueue(&thread_pool_, &table_state_, callback)) {
+        InvokeCallback(client_, &table_state_, callback);
+      } else if (!invoke_callback_tasks_.Enqueue(
+                     &thread_pool_, client_, &table_state_, callback)) {
         callback(STATUS_FORMAT(ServiceUnavailable,
                               "Invoke callback queue overflow, number of tasks: $0",
                               invoke_callback_tasks_.size()));
@@ -168,6 +276,22 @@ class TransactionManager::Impl {
     }
   }
 
+  bool HasCloserStatusTablet(const TabletId& tablet_id) {
+    if (!FLAGS_transaction_prefer_closest_status_tablet ||
+        table_state_.status.load(std::memory_order_acquire) != TransactionTableStatus::kResolved) {
+      return false;
+    }
+    auto localities = table_state_.Localities(client_);
+    if (!localities || localities->closest.empty()) {
+      return false;
+    }
+    // A transaction whose status tablet leader is not known at the moment, e.g. because of a
+    // leader change, is kept.
+    auto it = localities->leader_locality.find(tablet_id);
+    return it != localities->leader_locality.end() &&
+           localities->closest_locality < it->second;
+  }
+
   const scoped_refptr<ClockBase>& clock() const {
     return clock_;
   }
@@ -192,12 +316,123 @@ class TransactionManager::Impl {
     clock_->Update(time);
   }
 
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     UpdateTransactionCallback callback) {
+    std::unique_lock<std::mutex> lock(heartbeats_mutex_);
+    if (heartbeats_closing_) {
+      return;
+    }
+    auto& batch = heartbeat_batches_[status_tablet->tablet_id()];
+    batch.status_tablet = status_tablet;
+    batch.queue.push_back({transaction_id, std::move(callback)});
+    if (!batch.in_flight) {
+      SendHeartbeats(status_tablet->tablet_id(), &batch, &lock);
+    }
+  }
+
   void Shutdown() {
+    {
+      std::lock_guard<std::mutex> lock(heartbeats_mutex_);
+      heartbeats_closing_ = true;
+      heartbeat_batches_.clear();
+    }
     rpcs_.Shutdown();
     thread_pool_.Shutdown();
   }
 
  private:
+  struct PendingHeartbeat {
+    TransactionId transaction_id;
+    UpdateTransactionCallback callback;
+  };
+
+  struct HeartbeatBatch {
+    internal::RemoteTabletPtr status_tablet;
+    std::vector<PendingHeartbeat> queue;
+    bool in_flight = false;
+  };
+
+  struct HeartbeatsInFlight {
+    TabletId status_tablet_id;
+    std::vector<PendingHeartbeat> heartbeats;
+    rpc::Rpcs::Handle handle;
+  };
+
+  void SendHeartbeats(
+      const TabletId& status_tablet_id, HeartbeatBatch* batch,
+      std::unique_lock<std::mutex>* lock) {
+    auto in_flight = std::make_shared<HeartbeatsInFlight>();
+    in_flight->status_tablet_id = status_tablet_id;
+    in_flight->heartbeats.swap(batch->queue);
+    in_flight->handle = rpcs_.InvalidHandle();
+    batch->in_flight = true;
+    auto status_tablet = batch->status_tablet;
+    lock->unlock();
+
+    tserver::UpdateTransactionRequestPB req;
+    req.set_tablet_id(in_flight->status_tablet_id);
+    req.set_propagated_hybrid_time(Now().ToUint64());
+    req.mutable_batched_states()->Reserve(in_flight->heartbeats.size());
+    for (const auto& heartbeat : in_flight->heartbeats) {
+      auto& state = *req.add_batched_states();
+      state.set_transaction_id(heartbeat.transaction_id.begin(), heartbeat.transaction_id.size());
+      state.set_status(TransactionStatus::PENDING);
+    }
+    VLOG(4) << "Sending " << in_flight->heartbeats.size() << " heartbeats to "
+            << in_flight->status_tablet_id;
+
+    rpcs_.RegisterAndStart(
+        UpdateTransactions(
+            TransactionRpcDeadline(),
+            status_tablet.get(),
+            client_,
+            &req,
+            [this, in_flight](const Status& status,
+                              const tserver::UpdateTransactionResponsePB& response) {
+              HeartbeatsDone(status, response, in_flight.get());
+            }),
+        &in_flight->handle);
+  }
+
+  void HeartbeatsDone(const Status& status,
+                      const tserver::UpdateTransactionResponsePB& response,
+                      HeartbeatsInFlight* in_flight) {
+    auto retained_self = rpcs_.Unregister(&in_flight->handle);
+    HybridTime propagated_hybrid_time;
+    if (response.has_propagated_hybrid_time()) {
+      propagated_hybrid_time = HybridTime(response.propagated_hybrid_time());
+      UpdateClock(propagated_hybrid_time);
+    }
+
+    // Callbacks could send new heartbeats, they are queued since this request is still
+    // considered in flight.
+    for (size_t i = 0; i != in_flight->heartbeats.size(); ++i) {
+      Status heartbeat_status;
+      if (!status.ok()) {
+        heartbeat_status = status;
+      } else if (i < static_cast<size_t>(response.batched_statuses_size())) {
+        heartbeat_status = StatusFromPB(response.batched_statuses(i));
+      } else {
+        heartbeat_status = STATUS_FORMAT(
+            IllegalState, "Missing heartbeat status, received $0 of $1",
+            response.batched_statuses_size(), in_flight->heartbeats.size());
+      }
+      in_flight->heartbeats[i].callback(heartbeat_status, propagated_hybrid_time);
+    }
+
+    std::unique_lock<std::mutex> lock(heartbeats_mutex_);
+    auto it = heartbeat_batches_.find(in_flight->status_tablet_id);
+    if (it == heartbeat_batches_.end()) {
+      return;
+    }
+    if (it->second.queue.empty()) {
+      heartbeat_batches_.erase(it);
+      return;
+    }
+    SendHeartbeats(it->first, &it->second, &lock);
+  }
+
   YBClient* const client_;
   scoped_refptr<ClockBase> clock_;
   TransactionTableState table_state_;
@@ -206,6 +441,10 @@ class TransactionManager::Impl {
   yb::rpc::TasksPool<PickStatusTabletTask> tasks_pool_;
   yb::rpc::TasksPool<InvokeCallbackTask> invoke_callback_tasks_;
   yb::rpc::Rpcs rpcs_;
+
+  std::mutex heartbeats_mutex_;
+  std::unordered_map<TabletId, HeartbeatBatch> heartbeat_batches_;
+  bool heartbeats_closing_ = false;
 };
 
 TransactionManager::TransactionManager(
@@ -221,6 +460,16 @@ void TransactionManager::PickStatusTablet(PickStatusTabletCallback callback) {
   impl_->PickStatusTablet(std::move(callback));
 }
 
+bool TransactionManager::HasCloserStatusTablet(const TabletId& tablet_id) {
+  return impl_->HasCloserStatusTablet(tablet_id);
+}
+
+void TransactionManager::SendHeartbeat(
+    const internal::RemoteTabletPtr& status_tablet, const TransactionId& transaction_id,
+    UpdateTransactionCallback callback) {
+  impl_->SendHeartbeat(status_tablet, transaction_id, std::move(callback));
+}
+
 YBClient* TransactionManager::client() const {
   return impl_->client();
 }
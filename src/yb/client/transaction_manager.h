@@ -20,9 +20,11 @@
 #include <memory>
 
 #include "yb/client/client_fwd.h"
+#include "yb/client/transaction_rpc.h"
 
 #include "yb/common/clock.h"
 #include "yb/common/hybrid_time.h"
+#include "yb/common/transaction.h"
 
 #include "yb/rpc/rpc_fwd.h"
 
@@ -42,6 +44,17 @@ class TransactionManager {
 
   void PickStatusTablet(PickStatusTabletCallback callback);
 
+  // Returns true if there is a status tablet whose leader is closer to this client than the leader
+  // of the specified one.
+  bool HasCloserStatusTablet(const TabletId& tablet_id);
+
+  // Sends heartbeat of specified transaction to its status tablet. While there is heartbeats
+  // request to this tablet in flight, heartbeats of other transactions are accumulated and
+  // sent in one request after it.
+  void SendHeartbeat(const internal::RemoteTabletPtr& status_tablet,
+                     const TransactionId& transaction_id,
+                     UpdateTransactionCallback callback);
+
   rpc::Rpcs& rpcs();
   YBClient* client() const;
 
@@ -96,6 +96,13 @@ class TransactionPool::Impl {
       // We create new transaction on each take request, does not matter whether is was
       // newly created or not. So number of transactions in pool will near average number of take
       // requests during transaction preparation.
+      // Drop ready transactions whose status tablet leader has moved away, while there is a
+      // closer status tablet. Otherwise every heartbeat and the commit of the transaction would
+      // cross regions.
+      while (!transactions_.empty() &&
+             manager_.HasCloserStatusTablet(transactions_.front().transaction->status_tablet_id())) {
+        Pop()->Abort();
+      }
       if (transactions_.empty()) {
         // Transaction is automatically prepared when batcher is executed, so we don't have to
         // prepare newly created transaction, since it is anyway too late.
@@ -114,7 +121,8 @@ class TransactionPool::Impl {
     IncrementGauge(gauge_preparing_);
     new_txn->Prepare({}, ForceConsistentRead::kFalse,
                      std::bind(&Impl::TransactionReady, this, new_txn, old_taken),
-                     nullptr /* metadata */, nullptr /* may_have_metadata */);
+                     nullptr /* metadata */, nullptr /* may_have_metadata */,
+                     0 /* pipelined_flush_id */);
     return result;
   }
 
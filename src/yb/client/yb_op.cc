@@ -364,6 +364,32 @@ void YBqlReadOp::SetHashCode(const uint16_t hash_code) {
   ql_read_request_->set_hash_code(hash_code);
 }
 
+bool YBqlReadOp::RestrictToPartition(size_t partition_index) {
+  const auto& partitions = table_->GetPartitions();
+  DCHECK_LT(partition_index, partitions.size());
+  DCHECK(ql_read_request_->hashed_column_values().empty());
+
+  int32_t hash_code = ql_read_request_->has_hash_code() ? ql_read_request_->hash_code() : 0;
+  int32_t max_hash_code = ql_read_request_->has_max_hash_code()
+      ? ql_read_request_->max_hash_code() : std::numeric_limits<uint16_t>::max();
+  const auto& partition_start = partitions[partition_index];
+  if (!partition_start.empty()) {
+    hash_code = std::max<int32_t>(
+        hash_code, PartitionSchema::DecodeMultiColumnHashValue(partition_start));
+  }
+  if (partition_index + 1 < partitions.size()) {
+    max_hash_code = std::min<int32_t>(
+        max_hash_code,
+        PartitionSchema::DecodeMultiColumnHashValue(partitions[partition_index + 1]) - 1);
+  }
+  if (hash_code > max_hash_code) {
+    return false;
+  }
+  ql_read_request_->set_hash_code(hash_code);
+  ql_read_request_->set_max_hash_code(max_hash_code);
+  return true;
+}
+
 Status YBqlReadOp::GetPartitionKey(string* partition_key) const {
   if (!ql_read_request_->hashed_column_values().empty()) {
     // If hashed columns are set, use them to compute the exact key and set the bounds
@@ -594,6 +620,9 @@ Status YBPgsqlReadOp::GetPartitionKey(string* partition_key) const {
       const uint16 hash_code = VERIFY_RESULT(docdb::DocKey::DecodeHash(ybctid.binary_value()));
       read_request_->set_hash_code(hash_code);
       *partition_key = PartitionSchema::EncodeMultiColumnHashValue(hash_code);
+    } else if (read_request_->has_hash_code() && table_->partition_schema().IsHashPartitioning()) {
+      // Scan of a hash code range starts from the tablet of its lower bound.
+      *partition_key = PartitionSchema::EncodeMultiColumnHashValue(read_request_->hash_code());
     } else {
       // Default to empty key, this will start a scan from the beginning.
       partition_key->clear();
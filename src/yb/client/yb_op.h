@@ -345,6 +345,11 @@ class YBqlReadOp : public YBqlOp {
   // Also sets the hash_code and max_hash_code in the request.
   virtual CHECKED_STATUS GetPartitionKey(std::string* partition_key) const override;
 
+  // Restricts a scan of the whole table to the hash codes of the partition_index-th partition of
+  // the table, intersecting them with the token range already set in the request, if any.
+  // Returns false if the intersection is empty.
+  bool RestrictToPartition(size_t partition_index);
+
   const YBConsistencyLevel yb_consistency_level() {
     return yb_consistency_level_;
   }
@@ -23,6 +23,7 @@
 using yb::util::VarInt;
 using yb::util::FastEncodeDescendingSignedVarInt;
 using yb::util::FastDecodeDescendingSignedVarInt;
+using yb::util::FastDecodeDescendingSignedVarInts;
 using yb::util::FormatBytesAsStr;
 using yb::util::FormatSliceAsStr;
 using yb::util::QuotesType;
@@ -87,14 +88,13 @@ char* DocHybridTime::EncodedInDocDbFormat(char* dest) const {
 Status DocHybridTime::DecodeFrom(Slice *slice) {
   const size_t previous_size = slice->size();
   {
+    // Generation number, microseconds and logical value.
     // Currently we just ignore the generation number as it should always be 0.
-    RETURN_NOT_OK(FastDecodeDescendingSignedVarInt(slice));
-    int64_t decoded_micros =
-        kYugaByteMicrosecondEpoch + VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
+    int64_t decoded[3];
+    RETURN_NOT_OK(FastDecodeDescendingSignedVarInts(slice, decoded, 3));
+    int64_t decoded_micros = kYugaByteMicrosecondEpoch + decoded[1];
 
-    int64_t decoded_logical = VERIFY_RESULT(FastDecodeDescendingSignedVarInt(slice));
-
-    hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(decoded_micros, decoded_logical);
+    hybrid_time_ = HybridTime::FromMicrosecondsAndLogicalValue(decoded_micros, decoded[2]);
   }
 
   const auto ptr_before_decoding_write_id = slice->data();
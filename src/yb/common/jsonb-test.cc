@@ -151,5 +151,34 @@ TEST(JsonbTest, TestArrays) {
   VerifyArray(document);
 }
 
+TEST(JsonbTest, TestObjectKeyLookup) {
+  constexpr int kNumKeys = 100;
+  std::string json = "{";
+  for (int i = 0; i < kNumKeys; i++) {
+    json += Format("$0\"k$1\" : $1", i == 0 ? "" : ", ", i);
+  }
+  json += ", \"\xc3\xa9\" : \"non-ascii\"}";
+  Jsonb jsonb;
+  ASSERT_OK(jsonb.FromString(json));
+
+  auto lookup = [&jsonb](const std::string& key, QLValue* result) {
+    QLJsonColumnOperationsPB json_ops;
+    auto* json_op = json_ops.add_json_operations();
+    json_op->set_json_operator(JsonOperatorPB::JSON_TEXT);
+    json_op->mutable_operand()->mutable_value()->set_string_value(key);
+    return jsonb.ApplyJsonbOperators(json_ops, result);
+  };
+
+  QLValue result;
+  for (int i = 0; i < kNumKeys; i++) {
+    ASSERT_OK(lookup(Format("k$0", i), &result));
+    ASSERT_EQ(to_string(i), result.string_value());
+  }
+  ASSERT_OK(lookup("\xc3\xa9", &result));
+  ASSERT_EQ("non-ascii", result.string_value());
+  ASSERT_OK(lookup("k100", &result));
+  ASSERT_TRUE(result.IsNull());
+}
+
 }  // namespace common
 }  // namespace yb
@@ -683,11 +683,10 @@ Status Jsonb::ApplyJsonbOperatorToObject(const Slice& jsonb, const QLJsonOperati
     RETURN_NOT_OK(GetObjectKey(mid, jsonb, metadata_begin_offset, data_begin_offset, &mid_key));
 
     if (mid_key == search_key_slice) {
-      RETURN_NOT_OK(GetObjectValue(mid, jsonb, sizeof(jsonb_header),
-                                   ComputeDataOffset(num_kv_pairs, kJBObject), num_kv_pairs,
-                                   result, element_metadata));
+      RETURN_NOT_OK(GetObjectValue(mid, jsonb, metadata_begin_offset, data_begin_offset,
+                                   num_kv_pairs, result, element_metadata));
       return Status::OK();
-    } else if (mid_key.ToBuffer() > search_key) {
+    } else if (mid_key.compare(search_key_slice) > 0) {
       high = mid - 1;
     } else {
       low = mid + 1;
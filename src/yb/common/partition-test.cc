@@ -39,6 +39,7 @@
 #include "yb/common/crc16.h"
 #include "yb/common/partial_row.h"
 #include "yb/common/partition.h"
+#include "yb/common/ql_value.h"
 #include "yb/common/row.h"
 #include "yb/common/schema.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
@@ -116,4 +117,31 @@ TEST(PartitionTest, TestRedisEncoding) {
   ASSERT_EQ(pk1, pk2);
 }
 
+// Keys of rows with hash columns of different lengths are encoded one after another, like a batch
+// of rows, so the buffer reused for the encoded hash columns should not leak between them.
+TEST(PartitionTest, TestMultiColumnHashEncoding) {
+  Schema schema({ ColumnSchema("h1", STRING, false, true), ColumnSchema("h2", INT64, false, true) },
+                { ColumnId(0), ColumnId(1) }, 2);
+  PartitionSchemaPB partition_schema_pb;
+  partition_schema_pb.set_hash_schema(PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA);
+  PartitionSchema partition_schema;
+  ASSERT_OK(PartitionSchema::FromPB(partition_schema_pb, schema, &partition_schema));
+
+  for (const auto& h1 : {string(1000, 'x'), string("a"), string(), string(100, 'y')}) {
+    google::protobuf::RepeatedPtrField<QLExpressionPB> hash_values;
+    hash_values.Add()->mutable_value()->set_string_value(h1);
+    hash_values.Add()->mutable_value()->set_int64_value(h1.size());
+    string expected_encoded_values;
+    for (const auto& value : hash_values) {
+      AppendToKey(value.value(), &expected_encoded_values);
+    }
+
+    string partition_key;
+    ASSERT_OK(partition_schema.EncodeKey(hash_values, &partition_key));
+    ASSERT_EQ(PartitionSchema::EncodeMultiColumnHashValue(
+                  YBPartition::HashColumnCompoundValue(expected_encoded_values)),
+              partition_key) << "h1 size: " << h1.size();
+  }
+}
+
 } // namespace yb
@@ -253,6 +253,24 @@ Status PartitionSchema::EncodeRedisKey(const Slice& slice, string* buf) const {
   return Status::OK();
 }
 
+namespace {
+
+// Encodes the hash column values into the 2-byte partition key. The values are encoded into a
+// buffer of the calling thread, that is reused for all the keys it encodes, so encoding the keys of
+// a large batch of rows does not allocate a temporary string per row.
+template <class Expressions>
+string EncodeHashColumnValues(const Expressions& hash_col_values) {
+  static thread_local string encoded_values;
+  encoded_values.clear();
+  for (const auto& col_expr_pb : hash_col_values) {
+    AppendToKey(col_expr_pb.value(), &encoded_values);
+  }
+  return PartitionSchema::EncodeMultiColumnHashValue(
+      YBPartition::HashColumnCompoundValue(encoded_values));
+}
+
+} // namespace
+
 Status PartitionSchema::EncodeKey(const RepeatedPtrField<QLExpressionPB>& hash_col_values,
                                   string* buf) const {
   if (!hash_schema_) {
@@ -260,15 +278,9 @@ Status PartitionSchema::EncodeKey(const RepeatedPtrField<QLExpressionPB>& hash_c
   }
 
   switch (*hash_schema_) {
-    case YBHashSchema::kMultiColumnHash: {
-      string tmp;
-      for (const auto &col_expr_pb : hash_col_values) {
-        AppendToKey(col_expr_pb.value(), &tmp);
-      }
-      const uint16_t hash_value = YBPartition::HashColumnCompoundValue(tmp);
-      *buf = EncodeMultiColumnHashValue(hash_value);
+    case YBHashSchema::kMultiColumnHash:
+      *buf = EncodeHashColumnValues(hash_col_values);
       return Status::OK();
-    }
     case YBHashSchema::kPgsqlHash:
       DLOG(FATAL) << "Illegal code path. PGSQL hash cannot be computed from CQL expression";
       break;
@@ -290,12 +302,7 @@ Status PartitionSchema::EncodeKey(const RepeatedPtrField<PgsqlExpressionPB>& has
     case YBHashSchema::kPgsqlHash: {
       // TODO(neil) Discussion is needed. PGSQL hash should be done appropriately.
       // For now, let's not doing anything. Just borrow code from multi column hashing style.
-      string tmp;
-      for (const auto &col_expr_pb : hash_col_values) {
-        AppendToKey(col_expr_pb.value(), &tmp);
-      }
-      const uint16_t hash_value = YBPartition::HashColumnCompoundValue(tmp);
-      *buf = EncodeMultiColumnHashValue(hash_value);
+      *buf = EncodeHashColumnValues(hash_col_values);
       return Status::OK();
     }
 
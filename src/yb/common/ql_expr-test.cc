@@ -0,0 +1,167 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/ql_expr.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+constexpr ColumnIdRep kIntColumn = 10;
+constexpr ColumnIdRep kStringColumn = 11;
+constexpr ColumnIdRep kMissingColumn = 12;
+
+void AddColumn(QLConditionPB* condition, ColumnIdRep column_id) {
+  condition->add_operands()->set_column_id(column_id);
+}
+
+void AddInt(QLConditionPB* condition, int32_t value) {
+  condition->add_operands()->mutable_value()->set_int32_value(value);
+}
+
+QLConditionPB* AddCondition(QLConditionPB* condition, QLOperator op) {
+  auto* result = condition->add_operands()->mutable_condition();
+  result->set_op(op);
+  return result;
+}
+
+QLConditionPB* AddComparison(QLConditionPB* condition, QLOperator op, int32_t value) {
+  auto* result = AddCondition(condition, op);
+  AddColumn(result, kIntColumn);
+  AddInt(result, value);
+  return result;
+}
+
+// Check that the compiled condition returns the same result as the interpreter for the row.
+void CheckSameResult(const QLConditionPB& condition, const QLTableRow& row) {
+  auto compiled = QLCompiledCondition::Compile(condition);
+  ASSERT_NE(compiled, nullptr) << condition.ShortDebugString();
+  bool expected = false;
+  QLExprExecutor executor;
+  auto expected_status = executor.EvalCondition(condition, row, &expected);
+  bool result = false;
+  auto status = compiled->Eval(row, &result);
+  ASSERT_EQ(expected_status.ok(), status.ok()) << condition.ShortDebugString() << ": "
+                                               << expected_status << " vs " << status;
+  if (status.ok()) {
+    ASSERT_EQ(expected, result) << condition.ShortDebugString() << " for " << row.ToString();
+  }
+}
+
+} // namespace
+
+TEST(QLCompiledConditionTest, SameAsInterpreter) {
+  std::vector<QLTableRow> rows(4);
+  for (int i = 0; i != 3; ++i) {
+    rows[i].AllocColumn(kIntColumn).value.set_int32_value(i * 5);
+    rows[i].AllocColumn(kStringColumn).value.set_string_value(i == 1 ? "b" : "a");
+  }
+  // The last row is empty, and the row before it has a null column.
+  rows[2].AllocColumn(kIntColumn).value.Clear();
+
+  std::vector<QLConditionPB> conditions;
+  for (auto op : {QL_OP_EQUAL, QL_OP_LESS_THAN, QL_OP_LESS_THAN_EQUAL, QL_OP_GREATER_THAN,
+                  QL_OP_GREATER_THAN_EQUAL, QL_OP_NOT_EQUAL}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kIntColumn);
+    AddInt(&condition, 5);
+    conditions.push_back(condition);
+  }
+  for (auto op : {QL_OP_BETWEEN, QL_OP_NOT_BETWEEN}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kIntColumn);
+    AddInt(&condition, 1);
+    AddInt(&condition, 7);
+    conditions.push_back(condition);
+  }
+  for (auto op : {QL_OP_IN, QL_OP_NOT_IN}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    AddColumn(&condition, kIntColumn);
+    auto* list = condition.add_operands()->mutable_value()->mutable_list_value();
+    list->add_elems()->set_int32_value(0);
+    list->add_elems()->set_int32_value(10);
+    conditions.push_back(condition);
+  }
+  for (auto op : {QL_OP_IS_NULL, QL_OP_IS_NOT_NULL}) {
+    for (auto column : {kIntColumn, kMissingColumn}) {
+      QLConditionPB condition;
+      condition.set_op(op);
+      AddColumn(&condition, column);
+      conditions.push_back(condition);
+    }
+  }
+  for (auto op : {QL_OP_EXISTS, QL_OP_NOT_EXISTS}) {
+    QLConditionPB condition;
+    condition.set_op(op);
+    conditions.push_back(condition);
+  }
+  {
+    // Values of different types are not comparable.
+    QLConditionPB condition;
+    condition.set_op(QL_OP_EQUAL);
+    AddColumn(&condition, kStringColumn);
+    AddInt(&condition, 5);
+    conditions.push_back(condition);
+  }
+  {
+    // k >= 5 AND NOT (k = 10 OR s = 'b')
+    QLConditionPB condition;
+    condition.set_op(QL_OP_AND);
+    AddComparison(&condition, QL_OP_GREATER_THAN_EQUAL, 5);
+    auto* or_condition = AddCondition(AddCondition(&condition, QL_OP_NOT), QL_OP_OR);
+    AddComparison(or_condition, QL_OP_EQUAL, 10);
+    auto* string_condition = AddCondition(or_condition, QL_OP_EQUAL);
+    AddColumn(string_condition, kStringColumn);
+    string_condition->add_operands()->mutable_value()->set_string_value("b");
+    conditions.push_back(condition);
+  }
+  {
+    // k < 5 OR (k > 0 AND k != 10) OR k IS NULL
+    QLConditionPB condition;
+    condition.set_op(QL_OP_OR);
+    AddComparison(&condition, QL_OP_LESS_THAN, 5);
+    auto* and_condition = AddCondition(&condition, QL_OP_AND);
+    AddComparison(and_condition, QL_OP_GREATER_THAN, 0);
+    AddComparison(and_condition, QL_OP_NOT_EQUAL, 10);
+    AddColumn(AddCondition(&condition, QL_OP_IS_NULL), kIntColumn);
+    conditions.push_back(condition);
+  }
+
+  for (const auto& condition : conditions) {
+    for (const auto& row : rows) {
+      ASSERT_NO_FATALS(CheckSameResult(condition, row));
+    }
+  }
+}
+
+TEST(QLCompiledConditionTest, NotCompiled) {
+  // Function calls are left to the interpreter.
+  QLConditionPB condition;
+  condition.set_op(QL_OP_EQUAL);
+  condition.add_operands()->mutable_bfcall()->set_opcode(0);
+  AddInt(&condition, 1);
+  ASSERT_EQ(QLCompiledCondition::Compile(condition), nullptr);
+
+  QLConditionPB like;
+  like.set_op(QL_OP_LIKE);
+  AddColumn(&like, kStringColumn);
+  AddInt(&like, 1);
+  ASSERT_EQ(QLCompiledCondition::Compile(like), nullptr);
+}
+
+} // namespace yb
@@ -331,6 +331,274 @@ CHECKED_STATUS QLExprExecutor::EvalCondition(const QLConditionPB& condition,
 
 //--------------------------------------------------------------------------------------------------
 
+std::unique_ptr<QLCompiledCondition> QLCompiledCondition::Compile(const QLConditionPB& condition) {
+  std::unique_ptr<QLCompiledCondition> result(new QLCompiledCondition());
+  if (!result->CompileCondition(condition, 1 /* depth */)) {
+    return nullptr;
+  }
+  return result;
+}
+
+bool QLCompiledCondition::CompileCondition(const QLConditionPB& condition, const int depth) {
+  if (depth > kMaxDepth) {
+    return false;
+  }
+
+  const auto& operands = condition.operands();
+  switch (condition.op()) {
+    case QL_OP_NOT:
+      if (operands.size() != 1 ||
+          operands.Get(0).expr_case() != QLExpressionPB::ExprCase::kCondition ||
+          !CompileCondition(operands.Get(0).condition(), depth + 1)) {
+        return false;
+      }
+      program_.push_back({OpCode::kNot, condition.op(), 0});
+      return true;
+
+    case QL_OP_AND: FALLTHROUGH_INTENDED;
+    case QL_OP_OR: {
+      if (operands.size() == 0) {
+        return false;
+      }
+      // Every operand but the last one is followed by a jump to the end, taken when its value
+      // decides the result.
+      const OpCode jump = condition.op() == QL_OP_AND ? OpCode::kJumpIfFalse : OpCode::kJumpIfTrue;
+      std::vector<size_t> jumps;
+      for (int i = 0; i < operands.size(); ++i) {
+        if (operands.Get(i).expr_case() != QLExpressionPB::ExprCase::kCondition ||
+            !CompileCondition(operands.Get(i).condition(), depth + 1)) {
+          return false;
+        }
+        if (i + 1 < operands.size()) {
+          jumps.push_back(program_.size());
+          program_.push_back({jump, condition.op(), 0});
+        }
+      }
+      for (const auto jump_index : jumps) {
+        program_[jump_index].arg = static_cast<int>(program_.size());
+      }
+      return true;
+    }
+
+    case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_NOT_NULL: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_TRUE: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_FALSE: FALLTHROUGH_INTENDED;
+    case QL_OP_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_LESS_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN: FALLTHROUGH_INTENDED;
+    case QL_OP_GREATER_THAN_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EQUAL: FALLTHROUGH_INTENDED;
+    case QL_OP_BETWEEN: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_BETWEEN: FALLTHROUGH_INTENDED;
+    case QL_OP_IN: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_IN: FALLTHROUGH_INTENDED;
+    case QL_OP_EXISTS: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_EXISTS: {
+      int expected_operands;
+      switch (condition.op()) {
+        case QL_OP_EXISTS: FALLTHROUGH_INTENDED;
+        case QL_OP_NOT_EXISTS:
+          expected_operands = operands.size();
+          break;
+        case QL_OP_IS_NULL: FALLTHROUGH_INTENDED;
+        case QL_OP_IS_NOT_NULL: FALLTHROUGH_INTENDED;
+        case QL_OP_IS_TRUE: FALLTHROUGH_INTENDED;
+        case QL_OP_IS_FALSE:
+          expected_operands = 1;
+          break;
+        case QL_OP_BETWEEN: FALLTHROUGH_INTENDED;
+        case QL_OP_NOT_BETWEEN:
+          expected_operands = 3;
+          break;
+        default:
+          expected_operands = 2;
+          break;
+      }
+      if (operands.size() != expected_operands) {
+        return false;
+      }
+      const int first_operand = static_cast<int>(operands_.size());
+      for (const auto& operand : operands) {
+        if (!AddOperand(operand)) {
+          return false;
+        }
+      }
+      program_.push_back({OpCode::kPredicate, condition.op(), first_operand});
+      return true;
+    }
+
+    case QL_OP_LIKE: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_LIKE: FALLTHROUGH_INTENDED;
+    case QL_OP_NOOP:
+      break;
+  }
+  return false;
+}
+
+bool QLCompiledCondition::AddOperand(const QLExpressionPB& expr) {
+  switch (expr.expr_case()) {
+    case QLExpressionPB::ExprCase::kValue:
+      operands_.push_back({&expr.value(), 0});
+      return true;
+    case QLExpressionPB::ExprCase::kColumnId:
+      operands_.push_back({nullptr, expr.column_id()});
+      return true;
+    default:
+      return false;
+  }
+}
+
+const QLValuePB& QLCompiledCondition::OperandValue(
+    const int index, const QLTableRow& table_row) const {
+  static const QLValuePB kNullValue;
+  const Operand& operand = operands_[index];
+  if (operand.value != nullptr) {
+    return *operand.value;
+  }
+  // A column missing from the row reads as null.
+  auto value = table_row.GetValue(operand.column_id);
+  return value ? *value : kNullValue;
+}
+
+CHECKED_STATUS QLCompiledCondition::Eval(const QLTableRow& table_row, bool* result) const {
+  // A predicate is only evaluated after the value of the previous one was consumed by a jump or
+  // decided the result, so a single register holds the value of the program.
+  bool value = false;
+  size_t pc = 0;
+  while (pc < program_.size()) {
+    const Instruction& instruction = program_[pc];
+    switch (instruction.code) {
+      case OpCode::kPredicate:
+        RETURN_NOT_OK(EvalPredicate(instruction, table_row, &value));
+        break;
+      case OpCode::kNot:
+        value = !value;
+        break;
+      case OpCode::kJumpIfFalse:
+        if (!value) {
+          pc = instruction.arg;
+          continue;
+        }
+        break;
+      case OpCode::kJumpIfTrue:
+        if (value) {
+          pc = instruction.arg;
+          continue;
+        }
+        break;
+    }
+    ++pc;
+  }
+  *result = value;
+  return Status::OK();
+}
+
+CHECKED_STATUS QLCompiledCondition::EvalPredicate(
+    const Instruction& instruction, const QLTableRow& table_row, bool* result) const {
+#define QL_EVALUATE_RELATIONAL_OP(op)                                                              \
+  do {                                                                                             \
+    const QLValuePB& left = OperandValue(instruction.arg, table_row);                              \
+    const QLValuePB& right = OperandValue(instruction.arg + 1, table_row);                         \
+    if (!Comparable(left, right))                                                                  \
+      return STATUS(RuntimeError, "values not comparable");                                        \
+    *result = left op right;                                                                       \
+    return Status::OK();                                                                           \
+  } while (false)
+
+#define QL_EVALUATE_BETWEEN(op1, op2, rel_op)                                                      \
+  do {                                                                                             \
+    const QLValuePB& value = OperandValue(instruction.arg, table_row);                             \
+    const QLValuePB& lower = OperandValue(instruction.arg + 1, table_row);                         \
+    const QLValuePB& upper = OperandValue(instruction.arg + 2, table_row);                         \
+    if (!Comparable(value, lower) || !Comparable(value, upper)) {                                  \
+      return STATUS(RuntimeError, "values not comparable");                                        \
+    }                                                                                              \
+    *result = value op1 lower rel_op value op2 upper;                                              \
+    return Status::OK();                                                                           \
+  } while (false)
+
+  switch (instruction.op) {
+    case QL_OP_IS_NULL:
+      *result = IsNull(OperandValue(instruction.arg, table_row));
+      return Status::OK();
+
+    case QL_OP_IS_NOT_NULL:
+      *result = !IsNull(OperandValue(instruction.arg, table_row));
+      return Status::OK();
+
+    case QL_OP_IS_TRUE: FALLTHROUGH_INTENDED;
+    case QL_OP_IS_FALSE: {
+      const QLValuePB& value = OperandValue(instruction.arg, table_row);
+      if (!value.has_bool_value()) {
+        return STATUS(RuntimeError, "not a bool value");
+      }
+      *result = value.bool_value() == (instruction.op == QL_OP_IS_TRUE);
+      return Status::OK();
+    }
+
+    case QL_OP_EQUAL:
+      QL_EVALUATE_RELATIONAL_OP(==);
+
+    case QL_OP_LESS_THAN:
+      QL_EVALUATE_RELATIONAL_OP(<);                                                      // NOLINT
+
+    case QL_OP_LESS_THAN_EQUAL:
+      QL_EVALUATE_RELATIONAL_OP(<=);
+
+    case QL_OP_GREATER_THAN:
+      QL_EVALUATE_RELATIONAL_OP(>);                                                      // NOLINT
+
+    case QL_OP_GREATER_THAN_EQUAL:
+      QL_EVALUATE_RELATIONAL_OP(>=);
+
+    case QL_OP_NOT_EQUAL:
+      QL_EVALUATE_RELATIONAL_OP(!=);
+
+    case QL_OP_BETWEEN:
+      QL_EVALUATE_BETWEEN(>=, <=, &&);
+
+    case QL_OP_NOT_BETWEEN:
+      QL_EVALUATE_BETWEEN(<, >, ||);
+
+    case QL_OP_EXISTS:
+      *result = !table_row.IsEmpty();
+      return Status::OK();
+
+    case QL_OP_NOT_EXISTS:
+      *result = table_row.IsEmpty();
+      return Status::OK();
+
+    case QL_OP_IN: FALLTHROUGH_INTENDED;
+    case QL_OP_NOT_IN: {
+      const QLValuePB& left = OperandValue(instruction.arg, table_row);
+      const QLValuePB& right = OperandValue(instruction.arg + 1, table_row);
+      bool found = false;
+      for (const QLValuePB& elem : right.list_value().elems()) {
+        if (!Comparable(elem, left)) {
+          return STATUS(RuntimeError, "values not comparable");
+        }
+        if (elem == left) {
+          found = true;
+          break;
+        }
+      }
+      *result = found == (instruction.op == QL_OP_IN);
+      return Status::OK();
+    }
+
+    default:
+      break;
+  }
+  return STATUS(RuntimeError, "Internal error: illegal or unknown operator");
+
+#undef QL_EVALUATE_RELATIONAL_OP
+#undef QL_EVALUATE_BETWEEN
+}
+
+//--------------------------------------------------------------------------------------------------
+
 bfpg::TSOpcode QLExprExecutor::GetTSWriteInstruction(const PgsqlExpressionPB& ql_expr) const {
   // "kSubDocInsert" instructs the tablet server to insert a new value or replace an existing value.
   if (ql_expr.has_tscall()) {
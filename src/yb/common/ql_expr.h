@@ -155,6 +155,55 @@ class QLTableRow {
   std::unordered_map<ColumnIdRep, QLTableColumn> col_map_;
 };
 
+// A QLConditionPB lowered into a flat program, to evaluate the same condition against many rows.
+// Operands are referenced in place, constants in the condition and column values in the row, so
+// no QLValue temporaries are created per row. Only conditions whose operands are constants and
+// column references are compiled, the others are evaluated by QLExprExecutor.
+class QLCompiledCondition {
+ public:
+  // Returns nullptr if the condition could not be compiled. The condition must outlive the result.
+  static std::unique_ptr<QLCompiledCondition> Compile(const QLConditionPB& condition);
+
+  // Evaluate the condition for the given row, with the same result as
+  // QLExprExecutor::EvalCondition().
+  CHECKED_STATUS Eval(const QLTableRow& table_row, bool* result) const;
+
+ private:
+  enum class OpCode : uint8_t {
+    kPredicate,   // Set the value to the result of op over the operands starting at arg.
+    kNot,         // Negate the value.
+    kJumpIfFalse, // AND: jump to arg if the value is false.
+    kJumpIfTrue,  // OR: jump to arg if the value is true.
+  };
+
+  struct Instruction {
+    OpCode code;
+    QLOperator op;
+    // Index of the first operand of a predicate, or the jump target.
+    int arg;
+  };
+
+  // Operand of a predicate, a constant or the value of a column.
+  struct Operand {
+    const QLValuePB* value;
+    ColumnIdRep column_id;
+  };
+
+  // Max nesting depth of compiled conditions.
+  static constexpr int kMaxDepth = 64;
+
+  QLCompiledCondition() {}
+
+  bool CompileCondition(const QLConditionPB& condition, int depth);
+  bool AddOperand(const QLExpressionPB& expr);
+  const QLValuePB& OperandValue(int index, const QLTableRow& table_row) const;
+  CHECKED_STATUS EvalPredicate(
+      const Instruction& instruction, const QLTableRow& table_row, bool* result) const;
+
+  std::vector<Instruction> program_;
+  std::vector<Operand> operands_;
+};
+
 class QLExprExecutor {
  public:
   // Public types.
@@ -16,6 +16,7 @@
 
 #include <memory>
 
+#include "yb/common/ql_expr.h"
 #include "yb/util/result.h"
 #include "yb/util/status.h"
 #include "yb/docdb/doc_key.h"
@@ -27,7 +28,6 @@ class PgsqlReadRequestPB;
 class PgsqlResponsePB;
 class QLReadRequestPB;
 class QLResponsePB;
-class QLTableRow;
 class Schema;
 
 namespace common {
@@ -92,8 +92,44 @@ class YQLRowwiseIteratorIf {
     return DoNextRow(schema(), table_row);
   }
 
+  // Read up to max_rows rows using the specified projection. Row objects already present in rows
+  // are cleared and reused, new ones are appended only when needed, so a caller that keeps the
+  // same vector across calls does not allocate per row. Returns the number of rows read, which is
+  // less than max_rows only when the iterator is exhausted.
+  //
+  // Once a batch is read the iterator is positioned after its last row, so GetTupleId() no longer
+  // refers to the rows of the batch. If include_tuple_id is true, the tuple id of every row is
+  // stored in the row itself as the PgSystemAttrNum::kYBTupleId column.
+  Result<size_t> NextBatch(const Schema& projection, size_t max_rows, bool include_tuple_id,
+                           std::vector<QLTableRow::SharedPtr>* rows) {
+    return DoNextBatch(projection, max_rows, include_tuple_id, rows);
+  }
+
  private:
   virtual CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) = 0;
+
+  // Default implementation reads the rows one by one. Iterators that are able to decode rows
+  // more efficiently in bulk should override it.
+  virtual Result<size_t> DoNextBatch(const Schema& projection, size_t max_rows,
+                                     bool include_tuple_id,
+                                     std::vector<QLTableRow::SharedPtr>* rows) {
+    size_t num_rows = 0;
+    while (num_rows < max_rows && VERIFY_RESULT(HasNext())) {
+      if (rows->size() <= num_rows) {
+        rows->push_back(std::make_shared<QLTableRow>());
+      }
+      QLTableRow* row = (*rows)[num_rows].get();
+      row->Clear();
+      if (include_tuple_id) {
+        const Slice tuple_id = VERIFY_RESULT(GetTupleId());
+        row->AllocColumn(static_cast<ColumnIdRep>(PgSystemAttrNum::kYBTupleId))
+            .value.set_binary_value(tuple_id.data(), tuple_id.size());
+      }
+      RETURN_NOT_OK(DoNextRow(projection, row));
+      ++num_rows;
+    }
+    return num_rows;
+  }
 };
 
 }  // namespace common
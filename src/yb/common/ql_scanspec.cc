@@ -15,6 +15,8 @@
 
 #include "yb/common/ql_scanspec.h"
 
+#include <algorithm>
+
 namespace yb {
 namespace common {
 
@@ -138,12 +140,16 @@ QLScanRange::QLScanRange(const Schema& schema, const QLConditionPB& condition)
       if (has_range_column) {
         QL_GET_COLUMN_VALUE_EXPR_ELSE_RETURN(col_expr, val_expr);
         // - <column> IN (<value>) --> min/max values = <value>
-        // IN arguments should have already been de-duplicated and ordered by the executor.
-        int in_size = val_expr->value().list_value().elems_size();
-        if (in_size > 0) {
+        // IN arguments are not required to be ordered, so min/max is searched among all of them.
+        const auto& elems = val_expr->value().list_value().elems();
+        if (!elems.empty()) {
           const ColumnId column_id(col_expr->column_id());
-          ranges_.at(column_id).min_value = val_expr->value().list_value().elems(0);
-          ranges_.at(column_id).max_value = val_expr->value().list_value().elems(in_size - 1);
+          auto minmax = std::minmax_element(
+              elems.begin(), elems.end(), [](const QLValuePB& lhs, const QLValuePB& rhs) {
+                return Compare(lhs, rhs) < 0;
+              });
+          ranges_.at(column_id).min_value = *minmax.first;
+          ranges_.at(column_id).max_value = *minmax.second;
         }
         has_in_range_options_ = true;
       }
@@ -309,10 +315,16 @@ QLScanSpec::QLScanSpec(const QLConditionPB* condition,
   if (executor_ == nullptr) {
     executor_ = std::make_shared<QLExprExecutor>();
   }
+  if (condition_ != nullptr) {
+    compiled_condition_ = QLCompiledCondition::Compile(*condition_);
+  }
 }
 
 // Evaluate the WHERE condition for the given row.
 CHECKED_STATUS QLScanSpec::Match(const QLTableRow& table_row, bool* match) const {
+  if (compiled_condition_ != nullptr) {
+    return compiled_condition_->Eval(table_row, match);
+  }
   if (condition_ != nullptr) {
     return executor_->EvalCondition(*condition_, table_row, match);
   }
@@ -120,6 +120,9 @@ class QLScanSpec : public YQLScanSpec {
   const QLConditionPB* condition_;
   const bool is_forward_scan_;
   QLExprExecutor::SharedPtr executor_;
+
+  // condition_ compiled for evaluation against many rows, nullptr if it could not be compiled.
+  std::unique_ptr<QLCompiledCondition> compiled_condition_;
 };
 
 //--------------------------------------------------------------------------------------------------
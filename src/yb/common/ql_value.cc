@@ -874,6 +874,21 @@ string QLValue::ToString() const {
 QLValue::InternalType type(const QLValuePB& v) {
   return v.value_case();
 }
+QLValue::InternalType PgsqlSumType(QLValue::InternalType arg_type) {
+  switch (arg_type) {
+    case QLValue::InternalType::kInt16Value: FALLTHROUGH_INTENDED;
+    case QLValue::InternalType::kInt32Value:
+      return QLValue::InternalType::kInt64Value;
+    case QLValue::InternalType::kInt64Value:
+      return QLValue::InternalType::kDecimalValue;
+    case QLValue::InternalType::kFloatValue: FALLTHROUGH_INTENDED;
+    case QLValue::InternalType::kDoubleValue: FALLTHROUGH_INTENDED;
+    case QLValue::InternalType::kDecimalValue:
+      return arg_type;
+    default:
+      return QLValue::InternalType::VALUE_NOT_SET;
+  }
+}
 bool IsNull(const QLValuePB& v) {
   return v.value_case() == QLValuePB::VALUE_NOT_SET;
 }
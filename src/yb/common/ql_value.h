@@ -478,6 +478,11 @@ bool BothNotNull(const QLValuePB& lhs, const QLValue& rhs);
 bool BothNull(const QLValuePB& lhs, const QLValue& rhs);
 int Compare(const QLValuePB& lhs, const QLValue& rhs);
 int Compare(const QLSeqValuePB& lhs, const QLSeqValuePB& rhs);
+
+// Type of SUM of YSQL values of the given type. As in Postgres, smaller integers are summed as
+// int64 and int64 as decimal, so the sum could not overflow. Returns VALUE_NOT_SET if values of
+// the type could not be summed.
+QLValue::InternalType PgsqlSumType(QLValue::InternalType arg_type);
 int Compare(const bool lhs, const bool rhs);
 
 #define YB_SET_INT_VALUE(ql_valuepb, input, bits) \
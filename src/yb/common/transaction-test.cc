@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/common/transaction.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+TEST(SharedTransactionStatusCacheTest, CommitTime) {
+  SharedTransactionStatusCache cache(100);
+  const auto id = GenerateTransactionId();
+  const auto ht = [](uint64_t micros) { return HybridTime::FromMicros(micros); };
+
+  ASSERT_FALSE(cache.GetCommitTime(id, ht(1000)).is_valid());
+
+  // Pending status is only known for times before the status time.
+  cache.Update(id, TransactionStatusResult(TransactionStatus::PENDING, ht(2000)));
+  ASSERT_EQ(HybridTime::kMin, cache.GetCommitTime(id, ht(1000)));
+  ASSERT_FALSE(cache.GetCommitTime(id, ht(2000)).is_valid());
+  ASSERT_FALSE(cache.GetCommitTime(id, ht(3000)).is_valid());
+
+  // Older pending status does not override newer one.
+  cache.Update(id, TransactionStatusResult(TransactionStatus::PENDING, ht(1500)));
+  ASSERT_EQ(HybridTime::kMin, cache.GetCommitTime(id, ht(1800)));
+
+  cache.Update(id, TransactionStatusResult(TransactionStatus::COMMITTED, ht(2500)));
+  ASSERT_EQ(HybridTime::kMin, cache.GetCommitTime(id, ht(2000)));
+  ASSERT_EQ(ht(2500), cache.GetCommitTime(id, ht(2500)));
+  ASSERT_EQ(ht(2500), cache.GetCommitTime(id, ht(3000)));
+
+  // Pending status received after commit is ignored.
+  cache.Update(id, TransactionStatusResult(TransactionStatus::PENDING, ht(2400)));
+  ASSERT_EQ(ht(2500), cache.GetCommitTime(id, ht(3000)));
+
+  cache.Erase(id);
+  ASSERT_FALSE(cache.GetCommitTime(id, ht(3000)).is_valid());
+
+  // Aborted transactions are not cached, since coordinator could report committed and already
+  // cleaned up transaction as aborted.
+  cache.Update(id, TransactionStatusResult::Aborted());
+  ASSERT_FALSE(cache.GetCommitTime(id, ht(3000)).is_valid());
+}
+
+TEST(SharedTransactionStatusCacheTest, Capacity) {
+  constexpr size_t kCapacity = 160;
+  SharedTransactionStatusCache cache(kCapacity);
+  for (int i = 0; i != 1000; ++i) {
+    cache.Update(GenerateTransactionId(),
+                 TransactionStatusResult(TransactionStatus::COMMITTED, HybridTime::FromMicros(i)));
+    ASSERT_LE(cache.TEST_size(), kCapacity);
+  }
+}
+
+} // namespace yb
@@ -52,6 +52,73 @@ TransactionStatusResult::TransactionStatusResult(TransactionStatus status_, Hybr
       << "Status: " << status << ", status_time: " << status_time;
 }
 
+SharedTransactionStatusCache::SharedTransactionStatusCache(size_t capacity)
+    : shard_capacity_(std::max<size_t>(capacity / kNumShards, 1)) {
+}
+
+SharedTransactionStatusCache::Shard& SharedTransactionStatusCache::ShardFor(
+    const TransactionId& id) {
+  return shards_[TransactionIdHash()(id) % kNumShards];
+}
+
+HybridTime SharedTransactionStatusCache::GetCommitTime(
+    const TransactionId& id, HybridTime global_limit) {
+  auto& shard = ShardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(id);
+  if (it == shard.entries.end()) {
+    return HybridTime::kInvalid;
+  }
+  const auto& entry = it->second;
+  if (entry.committed) {
+    return entry.status_time <= global_limit ? entry.status_time : HybridTime::kMin;
+  }
+  // Status time of a transaction that is committed after global_limit could be reported as its
+  // pending time, so only times strictly before it are known to be pending.
+  return global_limit < entry.status_time ? HybridTime::kMin : HybridTime::kInvalid;
+}
+
+void SharedTransactionStatusCache::Update(
+    const TransactionId& id, const TransactionStatusResult& result) {
+  const bool committed = result.status == TransactionStatus::COMMITTED;
+  if ((!committed && result.status != TransactionStatus::PENDING) ||
+      !result.status_time.is_valid() || result.status_time == HybridTime::kMax) {
+    return;
+  }
+  auto& shard = ShardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(id);
+  if (it != shard.entries.end()) {
+    auto& entry = it->second;
+    if (committed) {
+      entry = Entry{true, result.status_time};
+    } else if (!entry.committed) {
+      entry.status_time.MakeAtLeast(result.status_time);
+    }
+    return;
+  }
+  if (shard.entries.size() >= shard_capacity_) {
+    // Evicted entry would be requested from the coordinator again, so any of them could be dropped.
+    shard.entries.erase(shard.entries.begin());
+  }
+  shard.entries.emplace(id, Entry{committed, result.status_time});
+}
+
+void SharedTransactionStatusCache::Erase(const TransactionId& id) {
+  auto& shard = ShardFor(id);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.entries.erase(id);
+}
+
+size_t SharedTransactionStatusCache::TEST_size() {
+  size_t result = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.entries.size();
+  }
+  return result;
+}
+
 Result<TransactionId> FullyDecodeTransactionId(const Slice& slice) {
   return DoDecodeTransactionId(slice, true);
 }
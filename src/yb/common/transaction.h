@@ -16,6 +16,12 @@
 #ifndef YB_COMMON_TRANSACTION_H
 #define YB_COMMON_TRANSACTION_H
 
+#include <array>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include <boost/functional/hash.hpp>
 #include <boost/optional.hpp>
 #include <boost/uuid/uuid.hpp>
@@ -29,6 +35,7 @@
 #include "yb/util/monotime.h"
 #include "yb/util/logging.h"
 #include "yb/util/result.h"
+#include "yb/util/slice.h"
 #include "yb/util/strongly_typed_bool.h"
 #include "yb/util/uuid.h"
 
@@ -92,6 +99,65 @@ struct StatusRequest {
   TransactionStatusCallback callback;
 };
 
+// Caches transaction statuses received from transaction coordinators by readers of a tablet, so
+// they could be reused by other readers of the same tablet.
+// Only facts that stay true forever are stored: commit time of committed transactions and the
+// time the transaction was known to be pending until. Entries for a transaction should be dropped
+// when the transaction is applied or aborted, since its intents are removed at that point.
+//
+// This class is thread-safe.
+class SharedTransactionStatusCache {
+ public:
+  explicit SharedTransactionStatusCache(size_t capacity);
+
+  SharedTransactionStatusCache(const SharedTransactionStatusCache&) = delete;
+  void operator=(const SharedTransactionStatusCache&) = delete;
+
+  // Returns commit time of the transaction if it was committed by global_limit, HybridTime::kMin
+  // if it is known that the transaction was not committed by global_limit, or invalid hybrid time
+  // if the status of the transaction at global_limit is not known.
+  HybridTime GetCommitTime(const TransactionId& id, HybridTime global_limit);
+
+  // Remembers status received from the transaction coordinator.
+  void Update(const TransactionId& id, const TransactionStatusResult& result);
+
+  void Erase(const TransactionId& id);
+
+  size_t TEST_size();
+
+ private:
+  struct Entry {
+    // Whether the transaction is committed, if not then was pending until status_time.
+    bool committed;
+    HybridTime status_time;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::unordered_map<TransactionId, Entry, TransactionIdHash> entries;
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  Shard& ShardFor(const TransactionId& id);
+
+  const size_t shard_capacity_;
+  std::array<Shard, kNumShards> shards_;
+};
+
+// Result of looking up strong write intents in a key range, see
+// TransactionStatusManager::LookupStrongIntents.
+YB_DEFINE_ENUM(StrongIntentsInRange,
+               // There are no intents in the range.
+               (kNone)
+               // All intents in the range belong to the reading transaction.
+               (kOwnOnly)
+               // The range could contain intents of other transactions.
+               (kUnknown));
+
+// Intents DB records, i.e. pairs of intent key and value, sorted by key.
+typedef std::vector<std::pair<std::string, std::string>> IntentRecords;
+
 class RequestScope;
 
 class TransactionStatusManager {
@@ -114,12 +180,35 @@ class TransactionStatusManager {
   // 4. Any kind of network/timeout errors would be reflected in error passed to callback.
   virtual void RequestStatusAt(const StatusRequest& request) = 0;
 
+  // The same as RequestStatusAt for several transactions. Implementation could fetch statuses of
+  // transactions managed by the same status tablet using a single RPC.
+  virtual void RequestStatusesAt(const std::vector<StatusRequest>& requests) {
+    for (const auto& request : requests) {
+      RequestStatusAt(request);
+    }
+  }
+
   virtual boost::optional<TransactionMetadata> Metadata(const TransactionId& id) = 0;
 
   virtual void Abort(const TransactionId& id, TransactionStatusCallback callback) = 0;
 
   virtual void Cleanup(TransactionIdSet&& set) = 0;
 
+  // Returns cache of transaction statuses shared by all readers of the tablet, or nullptr if
+  // statuses should not be shared.
+  virtual SharedTransactionStatusCache* shared_status_cache() { return nullptr; }
+
+  // Looks up strong write intents with keys in the range [lower_bound, upper_bound) that could be
+  // seen by a reader, that registered its request before creating the intents DB iterator.
+  // Empty upper_bound means that the range is not limited.
+  // When the range contains only intents of the specified transaction, and they are known, their
+  // records are appended to records in the intents DB order, and kOwnOnly is returned.
+  virtual StrongIntentsInRange LookupStrongIntents(
+      const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+      IntentRecords* records) {
+    return StrongIntentsInRange::kUnknown;
+  }
+
  private:
   friend class RequestScope;
 
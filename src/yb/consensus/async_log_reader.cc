@@ -0,0 +1,161 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/async_log_reader.h"
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/log.h"
+#include "yb/consensus/log_reader.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(log_async_read_buffer_size_bytes, 16_MB,
+             "Size of the buffer that messages read ahead from the log to catch up a single "
+             "follower are kept in.");
+TAG_FLAG(log_async_read_buffer_size_bytes, advanced);
+TAG_FLAG(log_async_read_buffer_size_bytes, runtime);
+
+DEFINE_int32(log_async_read_chunk_size_bytes, 4_MB,
+             "Size of a single read from the log done to catch up a follower.");
+TAG_FLAG(log_async_read_chunk_size_bytes, advanced);
+TAG_FLAG(log_async_read_chunk_size_bytes, runtime);
+
+METRIC_DEFINE_counter(tablet, log_catch_up_read_bytes, "Bytes Read to Catch Up Followers",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes read ahead from the log to catch up followers that fell "
+                      "behind the log cache");
+
+METRIC_DEFINE_counter(tablet, log_catch_up_read_ops, "Operations Read to Catch Up Followers",
+                      yb::MetricUnit::kOperations,
+                      "Number of operations read ahead from the log to catch up followers that "
+                      "fell behind the log cache");
+
+METRIC_DEFINE_histogram(tablet, log_catch_up_read_latency, "Log Catch Up Read Latency",
+                        yb::MetricUnit::kMicroseconds,
+                        "Microseconds spent on reading a chunk of operations ahead from the log to "
+                        "catch up a follower",
+                        60000000LU, 2);
+
+namespace yb {
+namespace log {
+
+AsyncLogReader::AsyncLogReader(const scoped_refptr<Log>& log, ThreadPoolToken* pool_token,
+                               const scoped_refptr<MetricEntity>& metric_entity,
+                               std::function<void()> read_callback)
+    : log_(log), pool_token_(pool_token), read_callback_(std::move(read_callback)) {
+  if (metric_entity) {
+    read_bytes_ = METRIC_log_catch_up_read_bytes.Instantiate(metric_entity);
+    read_ops_ = METRIC_log_catch_up_read_ops.Instantiate(metric_entity);
+    read_latency_ = METRIC_log_catch_up_read_latency.Instantiate(metric_entity);
+  }
+}
+
+Status AsyncLogReader::Take(int64_t index, int64_t up_to, int64_t max_size_bytes,
+                            consensus::ReplicateMsgs* messages) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const bool positioned = buffer_.empty() ? read_index_ == index
+                                          : buffer_.front()->id().index() == index;
+  if (!positioned) {
+    buffer_.clear();
+    buffer_bytes_ = 0;
+    read_index_ = index;
+    status_ = Status::OK();
+  }
+  up_to_ = up_to;
+
+  if (!status_.ok()) {
+    auto status = std::move(status_);
+    status_ = Status::OK();
+    return status;
+  }
+
+  int64_t taken_bytes = 0;
+  bool taken_any = false;
+  while (!buffer_.empty() && buffer_.front()->id().index() <= up_to) {
+    const int64_t size = buffer_.front()->ByteSize();
+    if (taken_any && taken_bytes + size > max_size_bytes) {
+      break;
+    }
+    messages->push_back(std::move(buffer_.front()));
+    buffer_.pop_front();
+    buffer_bytes_ -= size;
+    taken_bytes += size;
+    taken_any = true;
+  }
+
+  ScheduleReadUnlocked();
+  return Status::OK();
+}
+
+bool AsyncLogReader::IsReading(int64_t index) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reading_ && buffer_.empty() && read_index_ == index;
+}
+
+void AsyncLogReader::ScheduleReadUnlocked() {
+  if (reading_ || !status_.ok() || read_index_ > up_to_ ||
+      buffer_bytes_ >= FLAGS_log_async_read_buffer_size_bytes) {
+    return;
+  }
+  reading_ = true;
+  auto status = pool_token_->SubmitFunc(
+      std::bind(&AsyncLogReader::Read, shared_from_this(), read_index_, up_to_));
+  if (!status.ok()) {
+    reading_ = false;
+    status_ = status;
+  }
+}
+
+void AsyncLogReader::Read(int64_t start, int64_t up_to) {
+  const auto start_time = MonoTime::Now();
+  consensus::ReplicateMsgs replicates;
+  auto status = log_->GetLogReader()->ReadReplicatesInRange(
+      start, up_to, FLAGS_log_async_read_chunk_size_bytes, &replicates);
+  int64_t bytes = 0;
+  for (const auto& msg : replicates) {
+    bytes += msg->ByteSize();
+  }
+  if (read_latency_) {
+    read_latency_->Increment(MonoTime::Now().GetDeltaSince(start_time).ToMicroseconds());
+    read_bytes_->IncrementBy(bytes);
+    read_ops_->IncrementBy(replicates.size());
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    reading_ = false;
+    // Otherwise the consumer moved to another position while we were reading.
+    if (start == read_index_) {
+      if (status.ok()) {
+        for (auto& msg : replicates) {
+          buffer_.push_back(std::move(msg));
+        }
+        buffer_bytes_ += bytes;
+        read_index_ += replicates.size();
+      } else {
+        status_ = status;
+      }
+    }
+    ScheduleReadUnlocked();
+  }
+
+  read_callback_();
+}
+
+} // namespace log
+} // namespace yb
@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_ASYNC_LOG_READER_H
+#define YB_CONSENSUS_ASYNC_LOG_READER_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "yb/consensus/consensus_fwd.h"
+
+#include "yb/gutil/ref_counted.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Counter;
+class Histogram;
+class MetricEntity;
+class ThreadPoolToken;
+
+namespace log {
+
+class Log;
+
+// Reads replicate messages from the log on a thread pool, ahead of their consumer. Used to catch up
+// a follower that fell behind the log cache without blocking the thread that prepares requests to
+// the follower on disk reads.
+//
+// Messages are read sequentially, in chunks of FLAGS_log_async_read_chunk_size_bytes, into a buffer
+// of up to FLAGS_log_async_read_buffer_size_bytes. Reading continues as the consumer takes messages
+// from the buffer.
+class AsyncLogReader : public std::enable_shared_from_this<AsyncLogReader> {
+ public:
+  // read_callback is invoked after each chunk is read, without any locks held.
+  AsyncLogReader(const scoped_refptr<Log>& log, ThreadPoolToken* pool_token,
+                 const scoped_refptr<MetricEntity>& metric_entity,
+                 std::function<void()> read_callback);
+
+  AsyncLogReader(const AsyncLogReader&) = delete;
+  void operator=(const AsyncLogReader&) = delete;
+
+  // Moves buffered messages starting at index to messages, while their total size does not exceed
+  // max_size_bytes, but at least one message. up_to is the last index that should be read, i.e.
+  // the last index before the ones available in the log cache.
+  //
+  // If the buffer does not start at index, it is dropped and reading restarts from index. Nothing
+  // is added to messages while the requested messages are being read.
+  //
+  // Returns the error of the last read, if it failed. The read is retried by the following call.
+  CHECKED_STATUS Take(int64_t index, int64_t up_to, int64_t max_size_bytes,
+                      consensus::ReplicateMsgs* messages);
+
+  // Whether the message at index is being read, i.e. it is not buffered yet, but will be soon.
+  bool IsReading(int64_t index) const;
+
+ private:
+  void ScheduleReadUnlocked();
+  void Read(int64_t start, int64_t up_to);
+
+  const scoped_refptr<Log> log_;
+  ThreadPoolToken* const pool_token_;
+  const std::function<void()> read_callback_;
+
+  scoped_refptr<Counter> read_bytes_;
+  scoped_refptr<Counter> read_ops_;
+  scoped_refptr<Histogram> read_latency_;
+
+  mutable std::mutex mutex_;
+  std::deque<consensus::ReplicateMsgPtr> buffer_;
+  int64_t buffer_bytes_ = 0;
+  // Index of the first message that is not buffered yet.
+  int64_t read_index_ = 0;
+  // Last index to read.
+  int64_t up_to_ = 0;
+  // Whether a read is in progress.
+  bool reading_ = false;
+  Status status_;
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_ASYNC_LOG_READER_H
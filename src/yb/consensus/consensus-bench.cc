@@ -0,0 +1,345 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/common/schema.h"
+#include "yb/common/wire_protocol-test-util.h"
+#include "yb/consensus/consensus-test-util.h"
+#include "yb/consensus/consensus_meta.h"
+#include "yb/consensus/log.h"
+#include "yb/consensus/peer_manager.h"
+#include "yb/consensus/quorum_util.h"
+#include "yb/consensus/raft_consensus.h"
+#include "yb/fs/fs_manager.h"
+#include "yb/gutil/strings/substitute.h"
+#include "yb/server/logical_clock.h"
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_util.h"
+#include "yb/util/threadpool.h"
+
+using namespace std::literals; // NOLINT
+using namespace yb::size_literals;
+
+DEFINE_int32(consensus_bench_num_tablets, 4, "Number of Raft groups hosted by each node.");
+DEFINE_int32(consensus_bench_num_peers, 3, "Number of nodes, i.e. peers in each Raft group.");
+DEFINE_int32(consensus_bench_duration_ms, 10000, "Duration of the load.");
+DEFINE_int32(consensus_bench_ops_in_flight, 16,
+             "Number of operations concurrently replicated by each Raft group.");
+DEFINE_int32(consensus_bench_payload_bytes, 1024, "Size of the payload of each operation.");
+DEFINE_int32(consensus_bench_network_delay_us, 500,
+             "Delay injected into each update request between peers, and into its response.");
+
+DECLARE_bool(enable_leader_failure_detection);
+
+METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_histogram(log_append_latency);
+METRIC_DECLARE_histogram(log_group_commit_latency);
+
+namespace yb {
+namespace consensus {
+
+using log::Log;
+using log::LogOptions;
+using strings::Substitute;
+
+namespace {
+
+const char* kTestTable = "TestTable";
+
+void DoNothing(std::shared_ptr<consensus::StateChangeContext> context) {
+}
+
+std::string HistogramToString(const HdrHistogram& histogram) {
+  return Format("count: $0, mean: $1us, p50: $2us, p95: $3us, p99: $4us, p99.9: $5us, max: $6us",
+                histogram.TotalCount(), histogram.MeanValue(), histogram.ValueAtPercentile(50),
+                histogram.ValueAtPercentile(95), histogram.ValueAtPercentile(99),
+                histogram.ValueAtPercentile(99.9), histogram.MaxValue());
+}
+
+// Server hosting a replica of every Raft group.
+struct Node {
+  std::shared_ptr<MemTracker> mem_tracker;
+  std::unique_ptr<FsManager> fs_manager;
+  std::unique_ptr<ThreadPool> raft_pool;
+  std::unique_ptr<ThreadPool> append_pool;
+  scoped_refptr<MetricEntity> metric_entity;
+};
+
+struct RaftGroup {
+  std::string tablet_id;
+  std::unique_ptr<TestPeerMapManager> peers;
+  std::vector<scoped_refptr<Log>> logs;
+  std::vector<std::unique_ptr<TestOperationFactory>> operation_factories;
+  std::shared_ptr<RaftConsensus> leader;
+
+  std::mutex mutex;
+  std::condition_variable cond;
+  int in_flight = 0;
+  int64_t committed = 0;
+};
+
+} // namespace
+
+// Runs in-process Raft groups, with network delay injected between their peers, and measures
+// throughput and commit latency of operations replicated by their leaders. Every node hosts a
+// replica of each group, and the last node is the leader of all of them.
+class ConsensusBench : public YBTest {
+ public:
+  ConsensusBench()
+      : clock_(server::LogicalClock::CreateStartingAt(HybridTime(0))),
+        schema_(GetSimpleTestSchema()) {
+    FLAGS_enable_leader_failure_detection = false;
+  }
+
+  ~ConsensusBench() {
+    for (auto& group : groups_) {
+      for (const auto& entry : group->peers->GetPeerMapCopy()) {
+        entry.second->Shutdown();
+      }
+      group->peers->Clear();
+      group->leader.reset();
+      group->operation_factories.clear();
+      group->logs.clear();
+    }
+    groups_.clear();
+    nodes_.clear();
+  }
+
+ protected:
+  Status BuildNodes() {
+    for (int i = 0; i < FLAGS_consensus_bench_num_peers; ++i) {
+      auto node = std::make_unique<Node>();
+      node->mem_tracker = MemTracker::CreateTracker(Substitute("node-$0", i));
+      auto path = GetTestPath(Substitute("node-$0-root", i));
+      FsManagerOpts opts;
+      opts.parent_mem_tracker = node->mem_tracker;
+      opts.wal_paths = { path };
+      opts.data_paths = { path };
+      opts.server_type = "tserver_test";
+      node->fs_manager = std::make_unique<FsManager>(env_.get(), opts);
+      RETURN_NOT_OK(node->fs_manager->CreateInitialFileSystemLayout());
+      RETURN_NOT_OK(node->fs_manager->Open());
+      RETURN_NOT_OK(ThreadPoolBuilder(Substitute("raft-$0", i)).Build(&node->raft_pool));
+      RETURN_NOT_OK(ThreadPoolBuilder(Substitute("append-$0", i)).Build(&node->append_pool));
+      // Shared by all replicas on the node, so log latencies are aggregated per node.
+      node->metric_entity = METRIC_ENTITY_tablet.Instantiate(
+          &metric_registry_, Substitute("node-$0", i));
+      nodes_.push_back(std::move(node));
+    }
+    return Status::OK();
+  }
+
+  Status BuildGroup(int group_idx) {
+    auto group = std::make_unique<RaftGroup>();
+    group->tablet_id = Substitute("tablet-$0", group_idx);
+    auto config = BuildRaftConfigPBForTests(FLAGS_consensus_bench_num_peers);
+    config.set_opid_index(kInvalidOpIdIndex);
+    group->peers = std::make_unique<TestPeerMapManager>(config);
+
+    ConsensusOptions options;
+    options.tablet_id = group->tablet_id;
+
+    for (int i = 0; i < config.peers_size(); ++i) {
+      auto& node = *nodes_[i];
+      const auto& peer_uuid = config.peers(i).permanent_uuid();
+
+      scoped_refptr<Log> log;
+      RETURN_NOT_OK(Log::Open(LogOptions(),
+                              group->tablet_id,
+                              node.fs_manager->GetFirstTabletWalDirOrDie(
+                                  kTestTable, group->tablet_id),
+                              node.fs_manager->uuid(),
+                              schema_,
+                              0, // schema_version
+                              node.metric_entity,
+                              node.append_pool.get(),
+                              &log));
+      group->logs.push_back(log);
+
+      std::unique_ptr<ConsensusMetadata> cmeta;
+      RETURN_NOT_OK(ConsensusMetadata::Create(node.fs_manager.get(), group->tablet_id, peer_uuid,
+                                              config, kMinimumTerm, &cmeta));
+
+      RaftPeerPB local_peer_pb;
+      RETURN_NOT_OK(GetRaftConfigMember(config, peer_uuid, &local_peer_pb));
+      auto proxy_factory = new LocalTestPeerProxyFactory(
+          group->peers.get(),
+          MonoDelta::FromMicroseconds(FLAGS_consensus_bench_network_delay_us));
+      auto operation_factory = std::make_unique<TestOperationFactory>();
+      auto parent_mem_tracker = MemTracker::FindOrCreateTracker(
+          Substitute("$0-$1", peer_uuid, group->tablet_id), node.mem_tracker);
+
+      gscoped_ptr<PeerMessageQueue> queue(
+          new PeerMessageQueue(node.metric_entity,
+                               log,
+                               parent_mem_tracker,
+                               local_peer_pb,
+                               group->tablet_id,
+                               clock_,
+                               node.raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)));
+
+      std::unique_ptr<ThreadPoolToken> pool_token(
+          node.raft_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT));
+
+      gscoped_ptr<PeerManager> peer_manager(
+          new PeerManager(group->tablet_id,
+                          peer_uuid,
+                          proxy_factory,
+                          queue.get(),
+                          pool_token.get(),
+                          log));
+
+      std::shared_ptr<RaftConsensus> peer(
+          new RaftConsensus(options,
+                            std::move(cmeta),
+                            gscoped_ptr<PeerProxyFactory>(proxy_factory).Pass(),
+                            queue.Pass(),
+                            peer_manager.Pass(),
+                            std::move(pool_token),
+                            node.metric_entity,
+                            peer_uuid,
+                            clock_,
+                            operation_factory.get(),
+                            log,
+                            parent_mem_tracker,
+                            Bind(&DoNothing),
+                            DEFAULT_TABLE_TYPE,
+                            nullptr /* retryable_requests */));
+
+      operation_factory->SetConsensus(peer.get());
+      group->operation_factories.push_back(std::move(operation_factory));
+      group->peers->AddPeer(peer_uuid, peer);
+    }
+
+    ConsensusBootstrapInfo boot_info;
+    for (const auto& entry : group->peers->GetPeerMapCopy()) {
+      RETURN_NOT_OK(entry.second->Start(boot_info));
+    }
+
+    RETURN_NOT_OK(group->peers->GetPeerByIdx(config.peers_size() - 1, &group->leader));
+    RETURN_NOT_OK(group->leader->EmulateElection());
+    RETURN_NOT_OK(group->leader->WaitUntilLeaderForTests(MonoDelta::FromSeconds(10)));
+
+    groups_.push_back(std::move(group));
+    return Status::OK();
+  }
+
+  // Keeps FLAGS_consensus_bench_ops_in_flight operations replicating in the group until stopped,
+  // then waits for the operations in flight to complete.
+  void RunLoad(RaftGroup* group) {
+    std::unique_lock<std::mutex> lock(group->mutex);
+    while (running_.load(std::memory_order_acquire)) {
+      if (group->in_flight >= FLAGS_consensus_bench_ops_in_flight) {
+        group->cond.wait_for(lock, 100ms);
+        continue;
+      }
+      ++group->in_flight;
+      lock.unlock();
+      Replicate(group);
+      lock.lock();
+    }
+    group->cond.wait(lock, [group] { return group->in_flight == 0; });
+  }
+
+  void Replicate(RaftGroup* group) {
+    auto msg = std::make_shared<ReplicateMsg>();
+    msg->set_op_type(NO_OP);
+    msg->mutable_noop_request()->mutable_payload_for_tests()->resize(
+        FLAGS_consensus_bench_payload_bytes);
+    msg->set_hybrid_time(clock_->Now().ToUint64());
+
+    auto start = MonoTime::Now();
+    auto round = group->leader->NewRound(
+        std::move(msg), [this, group, start](const Status& status, int64_t leader_term) {
+      CHECK_OK(status);
+      commit_latency_.Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+      std::lock_guard<std::mutex> lock(group->mutex);
+      --group->in_flight;
+      ++group->committed;
+      group->cond.notify_one();
+    });
+    ConsensusRounds rounds = { round };
+    CHECK_OK(group->leader->ReplicateBatch(&rounds));
+  }
+
+  void ReportLogLatency(const char* role, const Node& node) {
+    LOG(INFO) << role << " log append latency: " << HistogramToString(
+        *METRIC_log_append_latency.Instantiate(node.metric_entity)->histogram());
+    LOG(INFO) << role << " log group commit latency: " << HistogramToString(
+        *METRIC_log_group_commit_latency.Instantiate(node.metric_entity)->histogram());
+  }
+
+  scoped_refptr<server::Clock> clock_;
+  MetricRegistry metric_registry_;
+  const Schema schema_;
+  std::vector<std::unique_ptr<Node>> nodes_;
+  std::vector<std::unique_ptr<RaftGroup>> groups_;
+  std::atomic<bool> running_{true};
+  HdrHistogram commit_latency_{60000000LU, 2};
+};
+
+TEST_F(ConsensusBench, Replicate) {
+  ASSERT_OK(BuildNodes());
+  for (int i = 0; i < FLAGS_consensus_bench_num_tablets; ++i) {
+    ASSERT_OK(BuildGroup(i));
+  }
+
+  LOG(INFO) << "Running load on " << FLAGS_consensus_bench_num_tablets << " tablets with "
+            << FLAGS_consensus_bench_num_peers << " peers, "
+            << FLAGS_consensus_bench_ops_in_flight << " operations of "
+            << FLAGS_consensus_bench_payload_bytes << " bytes in flight per tablet, network delay "
+            << FLAGS_consensus_bench_network_delay_us << "us";
+
+  Stopwatch sw(Stopwatch::ALL_THREADS);
+  sw.start();
+  std::vector<std::thread> threads;
+  for (auto& group : groups_) {
+    threads.emplace_back([this, group = group.get()] { RunLoad(group); });
+  }
+
+  std::this_thread::sleep_for(FLAGS_consensus_bench_duration_ms * 1ms);
+  running_.store(false, std::memory_order_release);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  sw.stop();
+
+  int64_t total_ops = 0;
+  for (const auto& group : groups_) {
+    total_ops += group->committed;
+  }
+  ASSERT_GT(total_ops, 0);
+
+  const auto seconds = sw.elapsed().wall_seconds();
+  LOG(INFO) << "Ops/sec:           " << total_ops / seconds;
+  LOG(INFO) << "MB/sec:            "
+            << total_ops * FLAGS_consensus_bench_payload_bytes / seconds / 1_MB;
+  LOG(INFO) << "CPU per op:        "
+            << (sw.elapsed().user + sw.elapsed().system) / 1000.0 / total_ops << "us";
+  LOG(INFO) << "Commit latency:    " << HistogramToString(commit_latency_);
+  ReportLogLatency("Leader", *nodes_.back());
+  ReportLogLatency("Follower", *nodes_.front());
+}
+
+} // namespace consensus
+} // namespace yb
@@ -470,13 +470,16 @@ class TestPeerMapManager {
 // Allows to test remote peers by emulating an RPC.
 // Both the "remote" peer's RPC call and the caller peer's response are executed
 // asynchronously in a ThreadPool.
+// If network_delay is specified, both the update request and its response are delayed by it.
 class LocalTestPeerProxy : public TestPeerProxy {
  public:
   LocalTestPeerProxy(std::string peer_uuid, ThreadPool* pool,
-                     TestPeerMapManager* peers)
+                     TestPeerMapManager* peers,
+                     MonoDelta network_delay = MonoDelta::kZero)
       : TestPeerProxy(pool),
         peer_uuid_(std::move(peer_uuid)),
         peers_(peers),
+        network_delay_(network_delay),
         miss_comm_(false) {}
 
   void UpdateAsync(const ConsensusRequestPB* request,
@@ -529,6 +532,9 @@ class LocalTestPeerProxy : public TestPeerProxy {
 
   void SendUpdateRequest(ConsensusRequestPB request,
                          ConsensusResponsePB* response) {
+    if (network_delay_ > MonoDelta::kZero) {
+      SleepFor(network_delay_);
+    }
     // Give the other peer a clean response object to write to.
     ConsensusResponsePB other_peer_resp;
     std::shared_ptr<RaftConsensus> peer;
@@ -549,6 +555,9 @@ class LocalTestPeerProxy : public TestPeerProxy {
     }
 
     response->CopyFrom(other_peer_resp);
+    if (network_delay_ > MonoDelta::kZero) {
+      SleepFor(network_delay_);
+    }
     RespondOrMissResponse(&request, other_peer_resp, response, kUpdate);
   }
 
@@ -594,20 +603,22 @@ class LocalTestPeerProxy : public TestPeerProxy {
  private:
   const std::string peer_uuid_;
   TestPeerMapManager* const peers_;
+  const MonoDelta network_delay_;
   bool miss_comm_;
 };
 
 class LocalTestPeerProxyFactory : public PeerProxyFactory {
  public:
-  explicit LocalTestPeerProxyFactory(TestPeerMapManager* peers)
-    : peers_(peers) {
+  explicit LocalTestPeerProxyFactory(TestPeerMapManager* peers,
+                                     MonoDelta network_delay = MonoDelta::kZero)
+    : peers_(peers), network_delay_(network_delay) {
     CHECK_OK(ThreadPoolBuilder("test-peer-pool").set_max_threads(3).Build(&pool_));
     messenger_ = CHECK_RESULT(rpc::MessengerBuilder("test").Build());
   }
 
   PeerProxyPtr NewProxy(const consensus::RaftPeerPB& peer_pb) override {
     auto new_proxy = std::make_unique<LocalTestPeerProxy>(
-        peer_pb.permanent_uuid(), pool_.get(), peers_);
+        peer_pb.permanent_uuid(), pool_.get(), peers_, network_delay_);
     proxies_.push_back(new_proxy.get());
     return new_proxy;
   }
@@ -624,6 +635,7 @@ class LocalTestPeerProxyFactory : public PeerProxyFactory {
   gscoped_ptr<ThreadPool> pool_;
   std::unique_ptr<rpc::Messenger> messenger_;
   TestPeerMapManager* const peers_;
+  const MonoDelta network_delay_;
     // NOTE: There is no need to delete this on the dctor because proxies are externally managed
   vector<LocalTestPeerProxy*> proxies_;
 };
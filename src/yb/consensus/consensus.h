@@ -332,6 +332,15 @@ class Consensus {
     return result;
   }
 
+  // Reads committed operations following 'after_op_index', for change data capture. The total
+  // size of the returned operations is limited by max_size_bytes, but at least one operation is
+  // returned if any is committed. have_more_messages is set if not all committed operations were
+  // returned.
+  virtual CHECKED_STATUS ReadReplicatedMessagesForCDC(
+      int64_t after_op_index, int max_size_bytes, ReplicateMsgs* msgs, bool* have_more_messages) {
+    return STATUS(NotSupported, "Not implemented.");
+  }
+
   // Assuming we are the leader, wait until we have a valid leader lease (i.e. the old leader's
   // lease has expired, and we have replicated a new lease that has not expired yet).
   virtual CHECKED_STATUS WaitForLeaderLeaseImprecise(MonoTime deadline) = 0;
@@ -47,6 +47,8 @@ typedef std::unique_ptr<ConsensusServiceProxy> ConsensusServiceProxyPtr;
 class LeaderElection;
 typedef scoped_refptr<LeaderElection> LeaderElectionPtr;
 
+class MultiRaftHeartbeatBatcher;
+
 class PeerProxy;
 typedef std::unique_ptr<PeerProxy> PeerProxyPtr;
 
@@ -68,6 +70,9 @@ typedef int64_t ConsensusTerm;
 typedef std::shared_ptr<ReplicateMsg> ReplicateMsgPtr;
 typedef std::vector<ReplicateMsgPtr> ReplicateMsgs;
 
+typedef std::shared_ptr<std::string> SerializedReplicateMsgPtr;
+typedef std::vector<SerializedReplicateMsgPtr> SerializedReplicateMsgs;
+
 YB_STRONGLY_TYPED_BOOL(TEST_SuppressVoteRequest);
 YB_STRONGLY_TYPED_BOOL(PreElection);
 
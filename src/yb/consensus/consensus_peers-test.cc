@@ -57,6 +57,9 @@ using namespace std::chrono_literals;
 
 METRIC_DECLARE_entity(tablet);
 
+DECLARE_int32(consensus_max_in_flight_requests);
+DECLARE_int32(raft_heartbeat_interval_ms);
+
 namespace yb {
 namespace consensus {
 
@@ -73,6 +76,116 @@ const char* kTabletId = "test-peers-tablet";
 const char* kLeaderUuid = "peer-0";
 const char* kFollowerUuid = "peer-1";
 
+// Follower that could hold requests until they are released by the test, so several of them are
+// in flight at the same time. Held requests are processed in the order they were sent.
+class HoldingPeerProxy : public PeerProxy {
+ public:
+  explicit HoldingPeerProxy(ThreadPool* pool) : pool_(pool) {
+    last_received_.CopyFrom(MinimumOpId());
+  }
+
+  void UpdateAsync(const ConsensusRequestPB* request,
+                   RequestTriggerMode trigger_mode,
+                   ConsensusResponsePB* response,
+                   rpc::RpcController* controller,
+                   const rpc::ResponseCallback& callback) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    held_.push_back(HeldRequest{request, response, callback});
+    max_in_flight_ = std::max(max_in_flight_, held_.size());
+    if (!hold_) {
+      RespondAllUnlocked();
+    }
+  }
+
+  void RequestConsensusVoteAsync(const VoteRequestPB* request,
+                                 VoteResponsePB* response,
+                                 rpc::RpcController* controller,
+                                 const rpc::ResponseCallback& callback) override {
+    LOG(FATAL) << "Not implemented";
+  }
+
+  void Hold() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_ = true;
+  }
+
+  // Responds to all held requests and stops holding new ones.
+  void Release() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    hold_ = false;
+    RespondAllUnlocked();
+  }
+
+  // The request carrying the operation with the specified index is lost once, the follower
+  // responds to it with an error.
+  void LoseRequestWithOp(int64_t index) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lose_index_ = index;
+  }
+
+  size_t num_held() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return held_.size();
+  }
+
+  size_t max_in_flight() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_in_flight_;
+  }
+
+  int64_t last_received_index() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_received_.index();
+  }
+
+ private:
+  struct HeldRequest {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::ResponseCallback callback;
+  };
+
+  void RespondAllUnlocked() {
+    for (auto& held : held_) {
+      Process(*held.request, held.response);
+      WARN_NOT_OK(pool_->SubmitFunc(held.callback), "Submit failed");
+    }
+    held_.clear();
+  }
+
+  void Process(const ConsensusRequestPB& request, ConsensusResponsePB* response) {
+    response->Clear();
+    for (const auto& op : request.ops()) {
+      if (op.id().index() == lose_index_) {
+        lose_index_ = -1;
+        response->mutable_error()->set_code(tserver::TabletServerErrorPB::UNKNOWN_ERROR);
+        StatusToPB(STATUS(TimedOut, "Request lost"), response->mutable_error()->mutable_status());
+        return;
+      }
+    }
+    if (OpIdLessThan(last_received_, request.preceding_id())) {
+      ConsensusErrorPB* error = response->mutable_status()->mutable_error();
+      error->set_code(ConsensusErrorPB::PRECEDING_ENTRY_DIDNT_MATCH);
+      StatusToPB(STATUS(IllegalState, ""), error->mutable_status());
+    } else if (request.ops_size() > 0) {
+      last_received_.CopyFrom(request.ops(request.ops_size() - 1).id());
+    }
+    response->set_responder_uuid(kFollowerUuid);
+    response->set_responder_term(request.caller_term());
+    response->mutable_status()->mutable_last_received()->CopyFrom(last_received_);
+    response->mutable_status()->mutable_last_received_current_leader()->CopyFrom(last_received_);
+    response->mutable_status()->set_last_committed_idx(last_received_.index());
+  }
+
+  ThreadPool* const pool_;
+  std::mutex mutex_;
+  bool hold_ = false;
+  std::vector<HeldRequest> held_;
+  size_t max_in_flight_ = 0;
+  int64_t lose_index_ = -1;
+  OpId last_received_;
+};
+
 class ConsensusPeersTest : public YBTest {
  public:
   ConsensusPeersTest()
@@ -411,5 +524,85 @@ TEST_F(ConsensusPeersTest, TestDontSendOneRpcPerWriteWhenPeerIsDown) {
   ASSERT_LT(mock_proxy->update_count() - initial_update_count, 5);
 }
 
+class ConsensusPeersPipelineTest : public ConsensusPeersTest {
+ protected:
+  void SetUp() override {
+    FLAGS_consensus_max_in_flight_requests = 3;
+    FLAGS_raft_heartbeat_interval_ms = 100;
+    ConsensusPeersTest::SetUp();
+  }
+
+  // Creates a peer and waits until its first exchange with the follower succeeds.
+  void StartPeer() {
+    proxy_ = new HoldingPeerProxy(raft_pool_.get());
+    peer_ = ASSERT_RESULT(Peer::NewRemotePeer(
+        FakeRaftPeerPB(kFollowerUuid), kTabletId, kLeaderUuid, message_queue_.get(),
+        raft_pool_token_.get(), PeerProxyPtr(proxy_), nullptr /* consensus */,
+        messenger_.get()));
+    ASSERT_OK(peer_->SignalRequest(RequestTriggerMode::kAlwaysSend));
+    ASSERT_OK(WaitFor([this] {
+      return message_queue_->GetTrackedPeerForTests(kFollowerUuid).is_last_exchange_successful;
+    }, 10s, "First exchange"));
+  }
+
+  // Appends the operation and waits until the number of requests held by the follower reaches
+  // expected_held. A heartbeat could also be held, so there could be more of them.
+  void AppendAndWaitHeld(int index, size_t expected_held) {
+    AppendReplicateMessagesToQueue(message_queue_.get(), clock_, index, 1);
+    ASSERT_OK(peer_->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+    ASSERT_OK(WaitFor([this, expected_held] {
+      return proxy_->num_held() >= expected_held;
+    }, 10s, Format("Request with op $0 held", index)));
+  }
+
+  void TearDown() override {
+    if (peer_) {
+      peer_->Close();
+    }
+    ConsensusPeersTest::TearDown();
+  }
+
+  HoldingPeerProxy* proxy_ = nullptr;
+  PeerPtr peer_;
+};
+
+TEST_F(ConsensusPeersPipelineTest, PipelinedRequests) {
+  ASSERT_NO_FATALS(StartPeer());
+
+  proxy_->Hold();
+  for (int index = 1; index <= 3; ++index) {
+    ASSERT_NO_FATALS(AppendAndWaitHeld(index, index));
+  }
+
+  // The in flight limit is reached, so the next operation waits for responses.
+  AppendReplicateMessagesToQueue(message_queue_.get(), clock_, 4, 1);
+  ASSERT_OK(peer_->SignalRequest(RequestTriggerMode::kNonEmptyOnly));
+  SleepFor(200ms);
+  ASSERT_EQ(proxy_->num_held(), 3);
+
+  proxy_->Release();
+  WaitForMajorityReplicatedIndex(4);
+  ASSERT_EQ(proxy_->last_received_index(), 4);
+  ASSERT_EQ(proxy_->max_in_flight(), 3);
+}
+
+// The follower does not get one of the pipelined requests, so the leader should resend operations
+// after the last one acknowledged by the follower.
+TEST_F(ConsensusPeersPipelineTest, LostPipelinedRequest) {
+  ASSERT_NO_FATALS(StartPeer());
+
+  proxy_->Hold();
+  proxy_->LoseRequestWithOp(2);
+  for (int index = 1; index <= 3; ++index) {
+    ASSERT_NO_FATALS(AppendAndWaitHeld(index, index));
+  }
+
+  proxy_->Release();
+  WaitForMajorityReplicatedIndex(3);
+  ASSERT_OK(WaitFor([this] {
+    return proxy_->last_received_index() == 3;
+  }, 10s, "Follower caught up"));
+}
+
 }  // namespace consensus
 }  // namespace yb
@@ -48,6 +48,7 @@
 #include "yb/consensus/consensus_meta.h"
 #include "yb/consensus/consensus_queue.h"
 #include "yb/consensus/log.h"
+#include "yb/consensus/multi_raft_batcher.h"
 #include "yb/consensus/replicate_msgs_holder.h"
 
 #include "yb/gutil/map-util.h"
@@ -64,11 +65,13 @@
 #include "yb/util/monotime.h"
 #include "yb/util/net/dns_resolver.h"
 #include "yb/util/net/net_util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/status_callback.h"
 #include "yb/util/threadpool.h"
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
 
 DEFINE_int32(consensus_rpc_timeout_ms, 3000,
              "Timeout used for all consensus internal RPC communications.");
@@ -79,6 +82,25 @@ DEFINE_int32(max_wait_for_processresponse_before_closing_ms, 5000,
              "finish before returning proceding to close the Peer and return");
 TAG_FLAG(max_wait_for_processresponse_before_closing_ms, advanced);
 
+DEFINE_int32(consensus_max_in_flight_requests, 1,
+             "Max number of UpdateConsensus requests that the leader keeps in flight to a single "
+             "follower. Values above 1 pipeline requests, so replication to distant followers is "
+             "not limited to one batch per round trip.");
+TAG_FLAG(consensus_max_in_flight_requests, advanced);
+TAG_FLAG(consensus_max_in_flight_requests, runtime);
+
+DEFINE_int64(consensus_max_in_flight_bytes, 16_MB,
+             "Max total size of pipelined UpdateConsensus requests in flight to a single "
+             "follower.");
+TAG_FLAG(consensus_max_in_flight_bytes, advanced);
+TAG_FLAG(consensus_max_in_flight_bytes, runtime);
+
+DEFINE_bool(enable_multi_raft_heartbeat_batcher, false,
+            "Whether heartbeats of all tablets sent to the same tablet server should be "
+            "coalesced into a single MultiRaftUpdateConsensus RPC.");
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, advanced);
+TAG_FLAG(enable_multi_raft_heartbeat_batcher, runtime);
+
 DECLARE_int32(raft_heartbeat_interval_ms);
 
 DEFINE_test_flag(double, fault_crash_on_leader_request_fraction, 0.0,
@@ -105,6 +127,15 @@ using rpc::PeriodicTimer;
 using rpc::RpcController;
 using strings::Substitute;
 
+struct Peer::PipelinedCall {
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  rpc::RpcController controller;
+  ReplicateMsgsHolder msgs_holder;
+  PeerMessageQueue::PipelinedRequestInfo info;
+  size_t bytes = 0;
+};
+
 Result<PeerPtr> Peer::NewRemotePeer(const RaftPeerPB& peer_pb,
                                     const string& tablet_id,
                                     const string& leader_uuid,
@@ -161,6 +192,10 @@ Status Peer::SignalRequest(RequestTriggerMode trigger_mode) {
   // If there are new requests in the queue we'll get them on ProcessResponse().
   auto performing_lock = LockPerforming(std::try_to_lock);
   if (!performing_lock.owns_lock()) {
+    if (trigger_mode == RequestTriggerMode::kNonEmptyOnly &&
+        GetAtomicFlag(&FLAGS_consensus_max_in_flight_requests) > 1) {
+      return SignalPipelinedRequest();
+    }
     return Status::OK();
   }
 
@@ -218,9 +253,28 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   int64_t commit_index_before = request_.has_committed_index() ?
       request_.committed_index().index() : kMinimumOpIdIndex;
   ReplicateMsgsHolder msgs_holder;
-  Status s = queue_->RequestForPeer(
-      peer_pb_.permanent_uuid(), &request_, &msgs_holder, &needs_remote_bootstrap,
-      &member_type, &last_exchange_successful);
+  Status s;
+  {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    request_pipelined_ = GetAtomicFlag(&FLAGS_consensus_max_in_flight_requests) > 1;
+    PeerMessageQueue::PipelinedRequestInfo pipelined;
+    if (!pipeline_broken_ && !pipelined_calls_.empty()) {
+      pipelined.after_index = last_sent_index_;
+    }
+    s = queue_->RequestForPeer(
+        peer_pb_.permanent_uuid(), &request_, &msgs_holder, &needs_remote_bootstrap,
+        &member_type, &last_exchange_successful, request_pipelined_ ? &pipelined : nullptr);
+    if (NumOps(request_) > 0 && request_.preceding_id().index() < pipelined.after_index) {
+      // All operations were already sent by pipelined requests.
+      msgs_holder.Reset();
+    }
+    if (NumOps(request_) > 0) {
+      last_sent_index_ = LastOpIndex(request_);
+    } else if (!pipelined_calls_.empty()) {
+      // Responses to the pipelined requests will trigger the following requests.
+      trigger_mode = RequestTriggerMode::kNonEmptyOnly;
+    }
+  }
   int64_t commit_index_after = request_.has_committed_index() ?
       request_.committed_index().index() : kMinimumOpIdIndex;
 
@@ -291,7 +345,7 @@ void Peer::SendNextRequest(RequestTriggerMode trigger_mode) {
   request_.set_caller_uuid(leader_uuid_);
   request_.set_dest_uuid(peer_pb_.permanent_uuid());
 
-  const bool req_has_ops = (request_.ops_size() > 0) || (commit_index_after > commit_index_before);
+  const bool req_has_ops = NumOps(request_) > 0 || (commit_index_after > commit_index_before);
 
   // If the queue is empty, check if we were told to send a status-only message (which is what
   // happens during heartbeats). If not, just return.
@@ -329,6 +383,8 @@ std::unique_lock<simple_spinlock> Peer::StartProcessingUnlocked() {
 
 void Peer::ProcessResponse() {
   request_.mutable_ops()->ExtractSubrange(0, request_.ops().size(), nullptr /* elements */);
+  request_.mutable_serialized_ops()->ExtractSubrange(
+      0, request_.serialized_ops().size(), nullptr /* elements */);
 
   DCHECK(performing_mutex_.is_locked()) << "Got a response when nothing was pending";
   Status status = controller_.status();
@@ -341,6 +397,11 @@ void Peer::ProcessResponse() {
     return;
   }
 
+  if (!status.ok() || response_.has_error() || response_.status().has_error()) {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    pipeline_broken_ = true;
+  }
+
   if (!status.ok()) {
     if (status.IsRemoteError()) {
       // Most controller errors are caused by network issues or corner cases like shutdown and
@@ -381,7 +442,16 @@ void Peer::ProcessResponse() {
 
   failed_attempts_ = 0;
   bool more_pending = false;
-  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response_, &more_pending);
+  {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    PeerMessageQueue::PipelinedRequestInfo pipelined;
+    queue_->ResponseFromPeer(
+        peer_pb_.permanent_uuid(), response_, &more_pending,
+        request_pipelined_ ? &pipelined : nullptr);
+    if (pipelined_calls_.empty() && !response_.status().has_error()) {
+      pipeline_broken_ = false;
+    }
+  }
 
   if (more_pending) {
     processing_lock.unlock();
@@ -390,6 +460,158 @@ void Peer::ProcessResponse() {
   }
 }
 
+Status Peer::SignalPipelinedRequest() {
+  {
+    auto processing_lock = StartProcessingUnlocked();
+    if (!processing_lock.owns_lock()) {
+      return STATUS(IllegalState, "Peer was closed.");
+    }
+
+    if (state_ != kPeerRunning || failed_attempts_ > 0) {
+      return Status::OK();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(pipeline_mutex_);
+      if (!CanSendPipelinedRequestUnlocked()) {
+        return Status::OK();
+      }
+    }
+
+    // A single pending send picks up all operations appended so far.
+    if (pipelined_send_pending_.exchange(true, std::memory_order_acq_rel)) {
+      return Status::OK();
+    }
+
+    using_thread_pool_.fetch_add(1, std::memory_order_acq_rel);
+  }
+  auto status = raft_pool_token_->SubmitFunc(
+      std::bind(&Peer::SendPipelinedRequest, shared_from_this()));
+  using_thread_pool_.fetch_sub(1, std::memory_order_acq_rel);
+  if (!status.ok()) {
+    pipelined_send_pending_.store(false, std::memory_order_release);
+  }
+  return status;
+}
+
+bool Peer::CanSendPipelinedRequestUnlocked() const {
+  // The regular request is also in flight, so it is counted against the limit.
+  return !pipeline_broken_ &&
+         static_cast<int64_t>(pipelined_calls_.size()) + 1 <
+             GetAtomicFlag(&FLAGS_consensus_max_in_flight_requests) &&
+         static_cast<int64_t>(pipelined_bytes_) <
+             GetAtomicFlag(&FLAGS_consensus_max_in_flight_bytes);
+}
+
+void Peer::SendPipelinedRequest() {
+  pipelined_send_pending_.store(false, std::memory_order_release);
+
+  auto processing_lock = StartProcessingUnlocked();
+  if (!processing_lock.owns_lock()) {
+    return;
+  }
+
+  auto call = std::make_shared<PipelinedCall>();
+  {
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    if (!CanSendPipelinedRequestUnlocked()) {
+      return;
+    }
+
+    bool needs_remote_bootstrap = false;
+    bool last_exchange_successful = false;
+    RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
+    call->info.after_index = last_sent_index_;
+    call->info.own_leases = true;
+    auto s = queue_->RequestForPeer(
+        peer_pb_.permanent_uuid(), &call->request, &call->msgs_holder, &needs_remote_bootstrap,
+        &member_type, &last_exchange_successful, &call->info);
+    if (PREDICT_FALSE(!s.ok())) {
+      LOG_WITH_PREFIX(INFO) << "Could not obtain pipelined request from queue for peer: " << s;
+      return;
+    }
+
+    // Anything but replicating operations to a peer that is in sync with us is handled by the
+    // regular requests.
+    if (needs_remote_bootstrap || !last_exchange_successful ||
+        (member_type != RaftPeerPB::VOTER && member_type != RaftPeerPB::OBSERVER) ||
+        NumOps(call->request) == 0 ||
+        call->request.preceding_id().index() < call->info.after_index) {
+      return;
+    }
+
+    call->request.set_tablet_id(tablet_id_);
+    call->request.set_caller_uuid(leader_uuid_);
+    call->request.set_dest_uuid(peer_pb_.permanent_uuid());
+    call->bytes = call->request.ByteSize();
+
+    last_sent_index_ = LastOpIndex(call->request);
+    pipelined_bytes_ += call->bytes;
+    pipelined_calls_.push_back(call);
+  }
+
+  heartbeater_->Snooze();
+
+  MAYBE_FAULT(FLAGS_fault_crash_on_leader_request_fraction);
+
+  processing_lock.unlock();
+
+  proxy_->UpdateAsync(
+      &call->request, RequestTriggerMode::kNonEmptyOnly, &call->response, &call->controller,
+      std::bind(&Peer::ProcessPipelinedResponse, shared_from_this(), call));
+}
+
+void Peer::ProcessPipelinedResponse(const std::shared_ptr<PipelinedCall>& call) {
+  call->msgs_holder.Reset();
+  const auto& response = call->response;
+  Status status = call->controller.status();
+
+  auto processing_lock = StartProcessingUnlocked();
+  std::unique_lock<std::mutex> lock(pipeline_mutex_);
+  auto it = std::find(pipelined_calls_.begin(), pipelined_calls_.end(), call);
+  if (it != pipelined_calls_.end()) {
+    pipelined_bytes_ -= call->bytes;
+    pipelined_calls_.erase(it);
+  }
+
+  if (!processing_lock.owns_lock()) {
+    return;
+  }
+
+  if (status.ok() && response.has_error() &&
+      response.error().code() != tserver::TabletServerErrorPB::TABLET_NOT_FOUND) {
+    status = StatusFromPB(response.error().status());
+  } else if (status.ok() && response.status().has_error() &&
+             response.status().error().code() == consensus::ConsensusErrorPB::CANNOT_PREPARE) {
+    status = StatusFromPB(response.status().error().status());
+  }
+
+  if (!status.ok()) {
+    pipeline_broken_ = true;
+    if (call->controller.status().ok() || call->controller.status().IsRemoteError()) {
+      queue_->NotifyPeerIsResponsiveDespiteError(peer_pb_.permanent_uuid());
+    }
+    failed_attempts_++;
+    YB_LOG_WITH_PREFIX_EVERY_N_SECS(WARNING, 5) << "Pipelined request failed: " << status;
+    return;
+  }
+
+  bool more_pending = false;
+  queue_->ResponseFromPeer(peer_pb_.permanent_uuid(), response, &more_pending, &call->info);
+  if (response.has_error() || response.status().has_error()) {
+    pipeline_broken_ = true;
+  } else if (pipelined_calls_.empty() && !performing_mutex_.is_locked()) {
+    pipeline_broken_ = false;
+  }
+
+  lock.unlock();
+  processing_lock.unlock();
+
+  if (more_pending) {
+    WARN_NOT_OK(SignalRequest(RequestTriggerMode::kNonEmptyOnly), "Signal request failed");
+  }
+}
+
 Status Peer::SendRemoteBootstrapRequest() {
   YB_LOG_WITH_PREFIX_EVERY_N_SECS(INFO, 30) << "Sending request to remotely bootstrap";
   return raft_pool_token_->SubmitFunc([retain_self = shared_from_this()]() {
@@ -479,8 +701,10 @@ Peer::~Peer() {
   CHECK_EQ(state_, kPeerClosed) << "Peer cannot be implicitly closed";
 }
 
-RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy)
-    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)) {
+RpcPeerProxy::RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+                           std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher)
+    : hostport_(std::move(hostport)), consensus_proxy_(std::move(consensus_proxy)),
+      heartbeat_batcher_(std::move(heartbeat_batcher)) {
 }
 
 void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
@@ -488,6 +712,13 @@ void RpcPeerProxy::UpdateAsync(const ConsensusRequestPB* request,
                                ConsensusResponsePB* response,
                                rpc::RpcController* controller,
                                const rpc::ResponseCallback& callback) {
+  // Status only requests are mostly heartbeats of idle tablets.
+  if (heartbeat_batcher_ && NumOps(*request) == 0 &&
+      trigger_mode == RequestTriggerMode::kAlwaysSend &&
+      GetAtomicFlag(&FLAGS_enable_multi_raft_heartbeat_batcher)) {
+    heartbeat_batcher_->AddRequest(request, response, controller, callback);
+    return;
+  }
   controller->set_timeout(MonoDelta::FromMilliseconds(FLAGS_consensus_rpc_timeout_ms));
   consensus_proxy_->UpdateConsensusAsync(*request, response, controller, callback);
 }
@@ -530,7 +761,13 @@ RpcPeerProxyFactory::RpcPeerProxyFactory(
 PeerProxyPtr RpcPeerProxyFactory::NewProxy(const RaftPeerPB& peer_pb) {
   auto hostport = HostPortFromPB(DesiredHostPort(peer_pb, from_));
   auto proxy = std::make_unique<ConsensusServiceProxy>(proxy_cache_, hostport);
-  return std::make_unique<RpcPeerProxy>(std::move(hostport), std::move(proxy));
+  std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher;
+  if (messenger_) {
+    heartbeat_batcher = MultiRaftHeartbeatBatcher::ForDestination(
+        messenger_, proxy_cache_, hostport);
+  }
+  return std::make_unique<RpcPeerProxy>(
+      std::move(hostport), std::move(proxy), std::move(heartbeat_batcher));
 }
 
 RpcPeerProxyFactory::~RpcPeerProxyFactory() {}
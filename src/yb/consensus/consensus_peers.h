@@ -34,6 +34,7 @@
 #define YB_CONSENSUS_CONSENSUS_PEERS_H_
 
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <atomic>
@@ -118,6 +119,11 @@ namespace consensus {
 //        v                               v
 //  SignalRequest()                    return
 //
+// If FLAGS_consensus_max_in_flight_requests is above 1, SignalRequest() called while a request is
+// being processed could also send a pipelined request, carrying the operations following the ones
+// that are already in flight. Any failure stops pipelining until the peer catches up again, and
+// the next request resends operations after the last one acknowledged by the peer.
+//
 class Peer;
 typedef std::shared_ptr<Peer> PeerPtr;
 
@@ -176,8 +182,17 @@ class Peer : public std::enable_shared_from_this<Peer> {
   }
 
  private:
+  struct PipelinedCall;
+
   void SendNextRequest(RequestTriggerMode trigger_mode);
 
+  // Sends a request with the operations following the ones that are already in flight, if the
+  // in flight limits allow it.
+  CHECKED_STATUS SignalPipelinedRequest();
+  bool CanSendPipelinedRequestUnlocked() const;
+  void SendPipelinedRequest();
+  void ProcessPipelinedResponse(const std::shared_ptr<PipelinedCall>& call);
+
   // Signals that a response was received from the peer. This method does response handling that
   // requires IO or may block.
   void ProcessResponse();
@@ -231,6 +246,20 @@ class Peer : public std::enable_shared_from_this<Peer> {
   // single request outstanding at a time, and to wait for the outstanding requests at Close().
   AtomicTryMutex performing_mutex_;
 
+  // Whether request_ could be in flight together with pipelined requests.
+  bool request_pipelined_ = false;
+
+  // Protects the state of pipelined requests below. Acquired after peer_lock_.
+  std::mutex pipeline_mutex_;
+  std::vector<std::shared_ptr<PipelinedCall>> pipelined_calls_;
+  size_t pipelined_bytes_ = 0;
+  // Index of the last operation sent to the peer.
+  int64_t last_sent_index_ = 0;
+  // Set when a request fails while others could be in flight, so requests should be sent after
+  // the last operation acknowledged by the peer, rather than after last_sent_index_.
+  bool pipeline_broken_ = false;
+  std::atomic<bool> pipelined_send_pending_{false};
+
   // Heartbeater for remote peer implementations.  This will send status only requests to the remote
   // peers whenever we go more than 'FLAGS_raft_heartbeat_interval_ms' without sending actual data.
   std::shared_ptr<rpc::PeriodicTimer> heartbeater_;
@@ -316,7 +345,10 @@ class PeerProxyFactory {
 // PeerProxy implementation that does RPC calls
 class RpcPeerProxy : public PeerProxy {
  public:
-  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy);
+  // If heartbeat_batcher is specified, status only requests could be coalesced with heartbeats of
+  // other tablets, see FLAGS_enable_multi_raft_heartbeat_batcher.
+  RpcPeerProxy(HostPort hostport, ConsensusServiceProxyPtr consensus_proxy,
+               std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher = nullptr);
 
   virtual void UpdateAsync(const ConsensusRequestPB* request,
                            RequestTriggerMode trigger_mode,
@@ -349,6 +381,7 @@ class RpcPeerProxy : public PeerProxy {
  private:
   HostPort hostport_;
   ConsensusServiceProxyPtr consensus_proxy_;
+  std::shared_ptr<MultiRaftHeartbeatBatcher> heartbeat_batcher_;
 };
 
 // PeerProxyFactory implementation that generates RPCPeerProxies
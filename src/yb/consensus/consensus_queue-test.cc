@@ -30,6 +30,8 @@
 // under the License.
 //
 
+#include <numeric>
+
 #include <gtest/gtest.h>
 #include <gflags/gflags.h>
 
@@ -50,12 +52,18 @@
 #include "yb/fs/fs_manager.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/util/metrics.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/test_macros.h"
 #include "yb/util/test_util.h"
 #include "yb/util/threadpool.h"
 
 DECLARE_bool(enable_data_block_fsync);
 DECLARE_int32(consensus_max_batch_size_bytes);
+DECLARE_bool(consensus_adaptive_batch_size);
+DECLARE_int32(consensus_min_batch_size_bytes);
+DECLARE_int32(consensus_caught_up_max_batch_size_bytes);
+DECLARE_int32(consensus_catching_up_max_batch_size_bytes);
+DECLARE_int32(consensus_batch_target_round_trip_ms);
 
 METRIC_DECLARE_entity(tablet);
 
@@ -347,6 +355,47 @@ TEST_F(ConsensusQueueTest, TestGetPagedMessages) {
   ASSERT_FALSE(more_pending);
 }
 
+// Tests that batches grow for a lagging peer that responds quickly, when batches are sized
+// adaptively.
+TEST_F(ConsensusQueueTest, TestAdaptiveBatchSize) {
+  FLAGS_consensus_adaptive_batch_size = true;
+  FLAGS_consensus_min_batch_size_bytes = 10_KB;
+  FLAGS_consensus_caught_up_max_batch_size_bytes = 20_KB;
+  FLAGS_consensus_catching_up_max_batch_size_bytes = 40_KB;
+  FLAGS_consensus_batch_target_round_trip_ms = 10000;
+
+  queue_->Init(MinimumOpId());
+  queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(2));
+
+  ConsensusRequestPB request;
+  ConsensusResponsePB response;
+  response.set_responder_uuid(kPeerUuid);
+  bool more_pending = false;
+
+  UpdatePeerWatermarkToOp(&request, &response, MinimumOpId(), MinimumOpId(), &more_pending);
+  AppendReplicateMessagesToQueue(queue_.get(), clock_, 1, 100, 1_KB);
+
+  std::vector<int> batch_ops;
+  while (batch_ops.empty() || more_pending) {
+    ReplicateMsgsHolder refs;
+    bool needs_remote_bootstrap;
+    ASSERT_OK(queue_->RequestForPeer(kPeerUuid, &request, &refs, &needs_remote_bootstrap));
+    ASSERT_GT(request.ops_size(), 0);
+    batch_ops.push_back(request.ops_size());
+    SetLastReceivedAndLastCommitted(&response, request.ops(request.ops_size() - 1).id());
+    queue_->ResponseFromPeer(response.responder_uuid(), response, &more_pending);
+  }
+  LOG(INFO) << "Ops in batches: " << yb::ToString(batch_ops);
+
+  // The first batch is limited by the minimal batch size, following ones by the catching up limit.
+  ASSERT_GE(batch_ops.size(), 3);
+  ASSERT_LT(batch_ops[0], 10);
+  ASSERT_GT(batch_ops[1], 3 * batch_ops[0]);
+  ASSERT_EQ(100, std::accumulate(batch_ops.begin(), batch_ops.end(), 0));
+  ASSERT_EQ(FLAGS_consensus_catching_up_max_batch_size_bytes,
+            queue_->GetTrackedPeerForTests(kPeerUuid).batch_size_bytes);
+}
+
 TEST_F(ConsensusQueueTest, TestPeersDontAckBeyondWatermarks) {
   queue_->Init(MinimumOpId());
   queue_->SetLeaderMode(MinimumOpId(), MinimumOpId().term(), BuildRaftConfigPBForTests(3));
@@ -43,6 +43,8 @@
 #include <gflags/gflags.h>
 
 #include "yb/common/wire_protocol.h"
+#include "yb/consensus/async_log_reader.h"
+#include "yb/consensus/consensus_util.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/consensus/log_util.h"
@@ -82,6 +84,41 @@ DEFINE_int32(consensus_max_batch_size_bytes, 254_MB,
              "The maximum per-tablet RPC batch size when updating peers.");
 TAG_FLAG(consensus_max_batch_size_bytes, advanced);
 
+DEFINE_bool(consensus_adaptive_batch_size, false,
+            "Whether to size the batches sent to each peer from the measured round trip time and "
+            "throughput of the exchanges with that peer, instead of always filling batches up to "
+            "consensus_max_batch_size_bytes.");
+TAG_FLAG(consensus_adaptive_batch_size, advanced);
+TAG_FLAG(consensus_adaptive_batch_size, runtime);
+
+DEFINE_int32(consensus_min_batch_size_bytes, 64_KB,
+             "The minimal size of adaptively sized batches sent to peers.");
+TAG_FLAG(consensus_min_batch_size_bytes, advanced);
+TAG_FLAG(consensus_min_batch_size_bytes, runtime);
+
+DEFINE_int32(consensus_caught_up_max_batch_size_bytes, 4_MB,
+             "The maximal size of adaptively sized batches sent to peers that have received all "
+             "operations sent in the previous batch.");
+TAG_FLAG(consensus_caught_up_max_batch_size_bytes, advanced);
+TAG_FLAG(consensus_caught_up_max_batch_size_bytes, runtime);
+
+DEFINE_int32(consensus_catching_up_max_batch_size_bytes, 32_MB,
+             "The maximal size of adaptively sized batches sent to peers that are lagging behind "
+             "the leader.");
+TAG_FLAG(consensus_catching_up_max_batch_size_bytes, advanced);
+TAG_FLAG(consensus_catching_up_max_batch_size_bytes, runtime);
+
+DEFINE_int32(consensus_batch_target_round_trip_ms, 50,
+             "Adaptively sized batches are picked so that sending a batch and receiving the "
+             "response takes about this time at the measured throughput of the peer.");
+TAG_FLAG(consensus_batch_target_round_trip_ms, advanced);
+TAG_FLAG(consensus_batch_target_round_trip_ms, runtime);
+
+DEFINE_int64(consensus_batches_memory_limit_bytes, 1_GB,
+             "Server-wide limit for the sum of adaptive batch sizes of all peers. Batches of "
+             "peers stop growing when the limit is reached.");
+TAG_FLAG(consensus_batches_memory_limit_bytes, advanced);
+
 DEFINE_int32(follower_unavailable_considered_failed_sec, 300,
              "Seconds that a leader is unable to successfully heartbeat to a "
              "follower after which the follower is considered to be failed and "
@@ -97,11 +134,22 @@ TAG_FLAG(consensus_inject_latency_ms_in_notifications, unsafe);
 
 DECLARE_int32(rpc_max_message_size);
 
+DECLARE_bool(log_cache_serialize_replicates);
+
+DEFINE_bool(consensus_async_catch_up_reads, false,
+            "Whether operations needed by peers that fell behind the log cache are read from the "
+            "log ahead of the requests to such peers, on a separate thread, instead of being read "
+            "synchronously while the request is prepared.");
+TAG_FLAG(consensus_async_catch_up_reads, advanced);
+TAG_FLAG(consensus_async_catch_up_reads, runtime);
+
 DEFINE_bool(propagate_safe_time, true, "Propagate safe time to read from leader to followers");
 
 namespace yb {
 namespace consensus {
 
+const char kConsensusQueueParentTrackerId[] = "consensus_queue";
+
 using log::AsyncLogReader;
 using log::Log;
 using std::unique_ptr;
@@ -148,13 +196,23 @@ PeerMessageQueue::PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_ent
                                    const RaftPeerPB& local_peer_pb,
                                    const string& tablet_id,
                                    const server::ClockPtr& clock,
-                                   unique_ptr<ThreadPoolToken> raft_pool_token)
+                                   unique_ptr<ThreadPoolToken> raft_pool_token,
+                                   unique_ptr<ThreadPoolToken> raft_pool_read_token)
     : raft_pool_observers_token_(std::move(raft_pool_token)),
+      raft_pool_read_token_(std::move(raft_pool_read_token)),
+      log_(log),
+      metric_entity_(metric_entity),
       local_peer_pb_(local_peer_pb),
       local_peer_uuid_(local_peer_pb_.has_permanent_uuid() ? local_peer_pb_.permanent_uuid()
                                                            : string()),
       tablet_id_(tablet_id),
       log_cache_(metric_entity, log, server_tracker, local_peer_pb.permanent_uuid(), tablet_id),
+      batch_parent_tracker_(MemTracker::FindOrCreateTracker(
+          FLAGS_consensus_batches_memory_limit_bytes, kConsensusQueueParentTrackerId,
+          server_tracker)),
+      batch_tracker_(MemTracker::CreateTracker(
+          Format("$0-$1", kConsensusQueueParentTrackerId, tablet_id), batch_parent_tracker_,
+          AddToParent::kTrue, CreateMetrics::kFalse)),
       metrics_(metric_entity),
       clock_(clock) {
   DCHECK(local_peer_pb_.has_permanent_uuid());
@@ -235,10 +293,84 @@ PeerMessageQueue::TrackedPeer* PeerMessageQueue::TrackPeerUnlocked(const string&
   return tracked_peer;
 }
 
+int64_t PeerMessageQueue::BatchSizeLimitUnlocked(TrackedPeer* peer) {
+  if (peer->batch_size_bytes == 0 &&
+      !SetBatchSizeUnlocked(peer, GetAtomicFlag(&FLAGS_consensus_min_batch_size_bytes))) {
+    // Out of batch memory, the peer still gets batches of the minimal size, but they are not
+    // accounted.
+    return GetAtomicFlag(&FLAGS_consensus_min_batch_size_bytes);
+  }
+  return std::min<int64_t>(peer->batch_size_bytes, FLAGS_consensus_max_batch_size_bytes);
+}
+
+void PeerMessageQueue::UpdateBatchSizeUnlocked(
+    TrackedPeer* peer, const PipelinedRequestInfo* pipelined) {
+  // Weight of the latest exchange in the throughput estimation.
+  constexpr double kThroughputSmoothing = 0.3;
+
+  int64_t request_bytes;
+  CoarseTimePoint send_time;
+  if (pipelined && pipelined->send_time != CoarseTimePoint()) {
+    request_bytes = pipelined->request_bytes;
+    send_time = pipelined->send_time;
+  } else {
+    request_bytes = peer->last_request_bytes;
+    send_time = peer->last_request_send_time;
+    peer->last_request_bytes = 0;
+    peer->last_request_send_time = CoarseTimePoint();
+  }
+  if (request_bytes == 0 || send_time == CoarseTimePoint()) {
+    return;
+  }
+
+  const auto round_trip = std::max<MonoDelta>(CoarseMonoClock::Now() - send_time, 1ms);
+  const auto target_round_trip =
+      MonoDelta::FromMilliseconds(GetAtomicFlag(&FLAGS_consensus_batch_target_round_trip_ms));
+  // A batch that did not include all operations available for the peer shows how much the peer
+  // could take in a round trip, while a smaller one only tells that it was too big if it took
+  // longer than the target round trip.
+  if (!peer->catching_up && round_trip <= target_round_trip) {
+    return;
+  }
+
+  const double throughput = request_bytes / round_trip.ToSeconds();
+  peer->throughput_bytes_per_sec = peer->throughput_bytes_per_sec == 0
+      ? throughput
+      : peer->throughput_bytes_per_sec * (1 - kThroughputSmoothing) +
+            throughput * kThroughputSmoothing;
+
+  const int64_t max_batch_size = peer->catching_up
+      ? GetAtomicFlag(&FLAGS_consensus_catching_up_max_batch_size_bytes)
+      : GetAtomicFlag(&FLAGS_consensus_caught_up_max_batch_size_bytes);
+  const int64_t batch_size = std::max<int64_t>(
+      std::min<int64_t>(
+          peer->throughput_bytes_per_sec * target_round_trip.ToSeconds(), max_batch_size),
+      GetAtomicFlag(&FLAGS_consensus_min_batch_size_bytes));
+  if (!SetBatchSizeUnlocked(peer, batch_size)) {
+    YB_LOG_WITH_PREFIX_UNLOCKED_EVERY_N_SECS(INFO, 30)
+        << "Batch memory limit reached, keeping batch size of " << peer->uuid << " at "
+        << peer->batch_size_bytes << " instead of " << batch_size;
+  }
+}
+
+bool PeerMessageQueue::SetBatchSizeUnlocked(TrackedPeer* peer, int64_t batch_size) {
+  const int64_t delta = batch_size - peer->batch_size_bytes;
+  if (delta > 0) {
+    if (!batch_tracker_->TryConsume(delta)) {
+      return false;
+    }
+  } else if (delta < 0) {
+    batch_tracker_->Release(-delta);
+  }
+  peer->batch_size_bytes = batch_size;
+  return true;
+}
+
 void PeerMessageQueue::UntrackPeer(const string& uuid) {
   LockGuard lock(queue_lock_);
   TrackedPeer* peer = EraseKeyReturnValuePtr(&peers_map_, uuid);
   if (peer != nullptr) {
+    SetBatchSizeUnlocked(peer, 0);
     delete peer;
   }
 }
@@ -331,14 +463,19 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                         ReplicateMsgsHolder* msgs_holder,
                                         bool* needs_remote_bootstrap,
                                         RaftPeerPB::MemberType* member_type,
-                                        bool* last_exchange_successful) {
+                                        bool* last_exchange_successful,
+                                        PipelinedRequestInfo* pipelined) {
   DCHECK(request->ops().empty());
+  DCHECK(request->serialized_ops().empty());
 
   OpId preceding_id;
   MonoDelta unreachable_time = MonoDelta::kMin;
   bool is_voter = false;
   bool is_new;
   int64_t next_index;
+  int64_t batch_size_limit = FLAGS_consensus_max_batch_size_bytes;
+  std::shared_ptr<log::AsyncLogReader> async_reader;
+  const bool adaptive_batch_size = GetAtomicFlag(&FLAGS_consensus_adaptive_batch_size);
   HybridTime propagated_safe_time;
   {
     LockGuard lock(queue_lock_);
@@ -371,9 +508,15 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
 
       // Because of coarse clocks we subtract 2ms, to be sure that our local version of lease
       // does not expire after it expires at follower.
-      peer->last_leader_lease_expiration_sent_to_follower =
+      auto leader_lease_expiration =
           CoarseMonoClock::Now() + leader_lease_duration_ms * 1ms - kCoarseClockPrecision * 2;
-      peer->last_ht_lease_expiration_sent_to_follower = ht_lease_expiration_micros;
+      if (pipelined && pipelined->own_leases) {
+        pipelined->leader_lease_expiration = leader_lease_expiration;
+        pipelined->ht_lease_expiration = ht_lease_expiration_micros;
+      } else {
+        peer->last_leader_lease_expiration_sent_to_follower = leader_lease_expiration;
+        peer->last_ht_lease_expiration_sent_to_follower = ht_lease_expiration_micros;
+      }
     } else {
       request->clear_leader_lease_duration_ms();
       request->clear_ht_lease_expiration();
@@ -398,9 +541,27 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     if (last_exchange_successful) *last_exchange_successful = peer->is_last_exchange_successful;
     *needs_remote_bootstrap = peer->needs_remote_bootstrap;
     next_index = peer->next_index;
+    if (pipelined && pipelined->after_index >= next_index &&
+        pipelined->after_index < queue_state_.last_appended.index()) {
+      // Operations up to after_index are already in flight to the peer. When there is nothing
+      // after them, keep the peer's next index, so status only requests refer to an operation
+      // the peer already has.
+      next_index = pipelined->after_index + 1;
+    }
     if (peer->member_type == RaftPeerPB::VOTER) {
       is_voter = true;
     }
+    if (adaptive_batch_size) {
+      batch_size_limit = BatchSizeLimitUnlocked(peer);
+    }
+    if (raft_pool_read_token_ && GetAtomicFlag(&FLAGS_consensus_async_catch_up_reads)) {
+      if (!peer->async_reader) {
+        peer->async_reader = std::make_shared<log::AsyncLogReader>(
+            log_, raft_pool_read_token_.get(), metric_entity_,
+            std::bind(&PeerMessageQueue::NotifyObserversOfOperationsRead, this, uuid));
+      }
+      async_reader = peer->async_reader;
+    }
   }
 
   if (unreachable_time.ToSeconds() > FLAGS_follower_unavailable_considered_failed_sec) {
@@ -431,7 +592,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     DCHECK_LT(FLAGS_consensus_max_batch_size_bytes + 1_KB, FLAGS_rpc_max_message_size);
     // The batch of messages to send to the peer.
     ReplicateMsgs messages;
-    int max_batch_size = FLAGS_consensus_max_batch_size_bytes - request->ByteSize();
+    SerializedReplicateMsgs serialized;
+    const bool send_serialized = GetAtomicFlag(&FLAGS_log_cache_serialize_replicates);
+    int max_batch_size = batch_size_limit - request->ByteSize();
     bool have_more_messages = false;
 
     // We try to get the follower's next_index from our log.
@@ -439,7 +602,9 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
                                   max_batch_size,
                                   &messages,
                                   &preceding_id,
-                                  &have_more_messages);
+                                  &have_more_messages,
+                                  send_serialized ? &serialized : nullptr,
+                                  async_reader.get());
     if (PREDICT_FALSE(!s.ok())) {
       if (PREDICT_TRUE(s.IsNotFound())) {
         // It's normal to have a NotFound() here if a follower falls behind where the leader has
@@ -468,10 +633,19 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     // We use AddAllocated rather than copy, because we pin the log cache at the "all replicated"
     // point. At some point we may want to allow partially loading (and not pinning) earlier
     // messages. At that point we'll need to do something smarter here, like copy or ref-count.
-    for (const auto& msg : messages) {
-      request->mutable_ops()->AddAllocated(msg.get());
+    if (send_serialized) {
+      // Serialized messages are shared with the log cache and all other peers.
+      for (const auto& op : serialized) {
+        request->mutable_serialized_ops()->AddAllocated(op.get());
+      }
+      *msgs_holder = ReplicateMsgsHolder(
+          request->mutable_serialized_ops(), std::move(messages), std::move(serialized));
+    } else {
+      for (const auto& msg : messages) {
+        request->mutable_ops()->AddAllocated(msg.get());
+      }
+      *msgs_holder = ReplicateMsgsHolder(request->mutable_ops(), std::move(messages));
     }
-    *msgs_holder = ReplicateMsgsHolder(request->mutable_ops(), std::move(messages));
 
     if (propagated_safe_time && !have_more_messages) {
       // Get the current local safe time on the leader and propagate it to the follower.
@@ -481,17 +655,34 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
     }
 
     DCHECK_LE(request->ByteSize(), FLAGS_consensus_max_batch_size_bytes);
+
+    if (adaptive_batch_size) {
+      const auto request_bytes = request->ByteSize();
+      const auto now = CoarseMonoClock::Now();
+      LockGuard lock(queue_lock_);
+      auto peer = FindPtrOrNull(peers_map_, uuid);
+      if (peer) {
+        peer->catching_up = have_more_messages;
+        if (pipelined && pipelined->own_leases) {
+          pipelined->request_bytes = request_bytes;
+          pipelined->send_time = now;
+        } else {
+          peer->last_request_bytes = request_bytes;
+          peer->last_request_send_time = now;
+        }
+      }
+    }
   }
 
   DCHECK(preceding_id.IsInitialized());
   request->mutable_preceding_id()->CopyFrom(preceding_id);
 
   if (PREDICT_FALSE(VLOG_IS_ON(2))) {
-    if (request->ops_size() > 0) {
+    if (NumOps(*request) > 0) {
       VLOG_WITH_PREFIX_UNLOCKED(2) << "Sending request with operations to Peer: " << uuid
-          << ". Size: " << request->ops_size()
-          << ". From: " << request->ops(0).id().ShortDebugString() << ". To: "
-          << request->ops(request->ops_size() - 1).id().ShortDebugString();
+          << ". Size: " << NumOps(*request)
+          << ". From: " << request->preceding_id().index() + 1 << ". To: "
+          << LastOpIndex(*request);
       VLOG_WITH_PREFIX_UNLOCKED(3) << "Operations: " << yb::ToString(request->ops());
     } else {
       VLOG_WITH_PREFIX_UNLOCKED(2)
@@ -503,6 +694,27 @@ Status PeerMessageQueue::RequestForPeer(const string& uuid,
   return Status::OK();
 }
 
+Status PeerMessageQueue::ReadCommittedMessages(
+    int64_t after_op_index, int64_t committed_index, int max_size_bytes, ReplicateMsgs* msgs,
+    bool* have_more_messages) {
+  msgs->clear();
+  *have_more_messages = false;
+  if (after_op_index >= committed_index) {
+    return Status::OK();
+  }
+  OpId preceding_id;
+  RETURN_NOT_OK(log_cache_.ReadOps(
+      after_op_index, max_size_bytes, msgs, &preceding_id, have_more_messages));
+  // The log could contain operations that are not committed yet.
+  while (!msgs->empty() && msgs->back()->id().index() > committed_index) {
+    msgs->pop_back();
+  }
+  if (!msgs->empty() && msgs->back()->id().index() < committed_index) {
+    *have_more_messages = true;
+  }
+  return Status::OK();
+}
+
 Status PeerMessageQueue::GetRemoteBootstrapRequestForPeer(const string& uuid,
                                                           StartRemoteBootstrapRequestPB* req) {
   TrackedPeer* peer = nullptr;
@@ -744,7 +956,8 @@ void PeerMessageQueue::NotifyPeerIsResponsiveDespiteError(const std::string& pee
 
 void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
                                         const ConsensusResponsePB& response,
-                                        bool* more_pending) {
+                                        bool* more_pending,
+                                        const PipelinedRequestInfo* pipelined) {
   DCHECK(response.IsInitialized()) << "Error: Uninitialized: "
       << response.InitializationErrorString() << ". Response: " << response.ShortDebugString();
 
@@ -811,6 +1024,15 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     // Take a snapshot of the current peer status.
     TrackedPeer previous = *peer;
 
+    if (pipelined && previous.is_last_exchange_successful &&
+        status.last_received().term() == previous.last_received.term() &&
+        status.last_received().index() < previous.last_received.index()) {
+      // A response to an earlier request that arrived after the response to a later one.
+      peer->last_successful_communication_time = MonoTime::Now();
+      *more_pending = false;
+      return;
+    }
+
     // Update the peer status based on the response.
     peer->is_new = false;
     peer->last_known_committed_idx = status.last_committed_idx();
@@ -877,6 +1099,10 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
 
     peer->is_last_exchange_successful = true;
 
+    if (GetAtomicFlag(&FLAGS_consensus_adaptive_batch_size)) {
+      UpdateBatchSizeUnlocked(peer, pipelined);
+    }
+
     if (response.has_responder_term()) {
       // The peer must have responded with a term that is greater than or equal to the last known
       // term for that peer.
@@ -893,8 +1119,10 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
     }
 
     // If our log has the next request for the peer or if the peer's committed index is lower than
-    // our own, set 'more_pending' to true.
-    *more_pending = log_cache_.HasOpBeenWritten(peer->next_index) ||
+    // our own, set 'more_pending' to true. When the next operation is still being read from the log
+    // for the peer, the request is sent once it is read.
+    *more_pending = (log_cache_.HasOpBeenWritten(peer->next_index) &&
+                     !(peer->async_reader && peer->async_reader->IsReading(peer->next_index))) ||
         (peer->last_known_committed_idx < queue_state_.committed_index.index());
 
     mode_copy = queue_state_.mode;
@@ -909,11 +1137,21 @@ void PeerMessageQueue::ResponseFromPeer(const std::string& peer_uuid,
       }
       majority_replicated.op_id = queue_state_.majority_replicated_opid;
 
-      peer->last_leader_lease_expiration_received_by_follower =
-          peer->last_leader_lease_expiration_sent_to_follower;
+      if (pipelined && pipelined->own_leases) {
+        // Responses to pipelined requests could arrive out of order, so never move the received
+        // leases backwards.
+        peer->last_leader_lease_expiration_received_by_follower = std::max(
+            peer->last_leader_lease_expiration_received_by_follower,
+            pipelined->leader_lease_expiration);
+        peer->last_ht_lease_expiration_received_by_follower = std::max(
+            peer->last_ht_lease_expiration_received_by_follower, pipelined->ht_lease_expiration);
+      } else {
+        peer->last_leader_lease_expiration_received_by_follower =
+            peer->last_leader_lease_expiration_sent_to_follower;
 
-      peer->last_ht_lease_expiration_received_by_follower =
-          peer->last_ht_lease_expiration_sent_to_follower;
+        peer->last_ht_lease_expiration_received_by_follower =
+            peer->last_ht_lease_expiration_sent_to_follower;
+      }
 
       majority_replicated.leader_lease_expiration = LeaderLeaseExpirationWatermark();
 
@@ -981,12 +1219,18 @@ void PeerMessageQueue::DumpToHtml(std::ostream& out) const {
 }
 
 void PeerMessageQueue::ClearUnlocked() {
+  for (const auto& entry : peers_map_) {
+    SetBatchSizeUnlocked(entry.second, 0);
+  }
   STLDeleteValues(&peers_map_);
   queue_state_.state = State::kQueueClosed;
 }
 
 void PeerMessageQueue::Close() {
   raft_pool_observers_token_->Shutdown();
+  if (raft_pool_read_token_) {
+    raft_pool_read_token_->Shutdown();
+  }
   LockGuard lock(queue_lock_);
   ClearUnlocked();
 }
@@ -1074,6 +1318,23 @@ void PeerMessageQueue::NotifyObserversOfTermChange(int64_t term) {
               LogPrefixUnlocked() + "Unable to notify RaftConsensus of term change.");
 }
 
+void PeerMessageQueue::NotifyObserversOfOperationsRead(const std::string& uuid) {
+  WARN_NOT_OK(raft_pool_observers_token_->SubmitClosure(
+      Bind(&PeerMessageQueue::NotifyObserversOfOperationsReadTask, Unretained(this), uuid)),
+              LogPrefixUnlocked() + "Unable to notify RaftConsensus of operations read.");
+}
+
+void PeerMessageQueue::NotifyObserversOfOperationsReadTask(const std::string& uuid) {
+  std::vector<PeerMessageQueueObserver*> copy;
+  {
+    LockGuard lock(queue_lock_);
+    copy = observers_;
+  }
+  for (PeerMessageQueueObserver* observer : copy) {
+    observer->NotifyOperationsRead(uuid);
+  }
+}
+
 void PeerMessageQueue::NotifyObserversOfMajorityReplOpChangeTask(
     const MajorityReplicatedData& majority_replicated_data) {
   std::vector<PeerMessageQueueObserver*> copy;
@@ -1173,6 +1434,7 @@ bool PeerMessageQueue::CanPeerBecomeLeader(const std::string& peer_uuid) const {
 
 PeerMessageQueue::~PeerMessageQueue() {
   Close();
+  batch_tracker_->UnregisterFromParent();
 }
 
 string PeerMessageQueue::LogPrefixUnlocked() const {
@@ -152,6 +152,26 @@ class PeerMessageQueue {
     // Member type of this peer in the config.
     RaftPeerPB::MemberType member_type = RaftPeerPB::UNKNOWN_MEMBER_TYPE;
 
+    // Adaptive batch sizing state, see FLAGS_consensus_adaptive_batch_size.
+    //
+    // Current batch size limit for this peer, accounted in the queue batch memory tracker. 0 if it
+    // was not yet picked.
+    int64_t batch_size_bytes = 0;
+
+    // Smoothed throughput of the exchanges with this peer.
+    double throughput_bytes_per_sec = 0;
+
+    // Whether the last batch sent to the peer did not include all operations available for it.
+    bool catching_up = false;
+
+    // Size and send time of the last request that is not tracked by PipelinedRequestInfo.
+    int64_t last_request_bytes = 0;
+    CoarseTimePoint last_request_send_time;
+
+    // Reads operations that are no longer in the log cache ahead of the requests to the peer, see
+    // FLAGS_consensus_async_catch_up_reads.
+    std::shared_ptr<log::AsyncLogReader> async_reader;
+
    private:
     // The last term we saw from a given peer.
     // This is only used for sanity checking that a peer doesn't
@@ -159,13 +179,33 @@ class PeerMessageQueue {
     int64_t last_seen_term_ = 0;
   };
 
+  // Describes a request to a peer that could be in flight together with other requests to the
+  // same peer, see FLAGS_consensus_max_in_flight_requests.
+  struct PipelinedRequestInfo {
+    // If positive, operations are sent after this index rather than after the peer's next index,
+    // because earlier operations were already sent by requests that are still in flight.
+    int64_t after_index = 0;
+
+    // Whether the request carries its own lease expirations, below, instead of recording them as
+    // the last ones sent to the peer. Such leases are credited to the peer when the response to
+    // this particular request is received.
+    bool own_leases = false;
+    CoarseTimePoint leader_lease_expiration;
+    MicrosTime ht_lease_expiration = 0;
+
+    // Size and send time of the request, used to adapt the batch size of the peer.
+    int64_t request_bytes = 0;
+    CoarseTimePoint send_time;
+  };
+
   PeerMessageQueue(const scoped_refptr<MetricEntity>& metric_entity,
                    const scoped_refptr<log::Log>& log,
                    const std::shared_ptr<MemTracker>& server_tracker,
                    const RaftPeerPB& local_peer_pb,
                    const std::string& tablet_id,
                    const server::ClockPtr& clock,
-                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token);
+                   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token,
+                   std::unique_ptr<ThreadPoolToken> raft_pool_read_token = nullptr);
 
   // Initialize the queue.
   virtual void Init(const OpId& last_locally_replicated);
@@ -223,6 +263,9 @@ class PeerMessageQueue {
   // Assembles a request for a peer, adding entries past 'op_id' up to
   // 'consensus_max_batch_size_bytes'.
   //
+  // If pipelined is specified, the request could be sent while other requests to the peer are in
+  // flight, see PipelinedRequestInfo.
+  //
   // Returns OK if the request was assembled, or STATUS(NotFound, "") if the peer with 'uuid' was
   // not tracked, or if the queue is not in leader mode.
   //
@@ -241,7 +284,14 @@ class PeerMessageQueue {
       ReplicateMsgsHolder* msgs_holder,
       bool* needs_remote_bootstrap,
       RaftPeerPB::MemberType* member_type = nullptr,
-      bool* last_exchange_successful = nullptr);
+      bool* last_exchange_successful = nullptr,
+      PipelinedRequestInfo* pipelined = nullptr);
+
+  // Reads operations following 'after_op_index' up to 'committed_index', limited by
+  // max_size_bytes. Used by change data capture, that does not track a peer in the queue.
+  CHECKED_STATUS ReadCommittedMessages(
+      int64_t after_op_index, int64_t committed_index, int max_size_bytes, ReplicateMsgs* msgs,
+      bool* have_more_messages);
 
   // Fill in a StartRemoteBootstrapRequest for the specified peer.  If that peer should not remotely
   // bootstrap, returns a non-OK status.  On success, also internally resets
@@ -257,9 +307,14 @@ class PeerMessageQueue {
 
   // Updates the request queue with the latest response of a peer, returns whether this peer has
   // more requests pending.
+  //
+  // pipelined should be the same info as was passed to RequestForPeer(), if any. Responses to
+  // pipelined requests could arrive out of order, so a response reporting fewer received
+  // operations than the previous successful exchange with the peer is disregarded as stale.
   virtual void ResponseFromPeer(const std::string& peer_uuid,
                                 const ConsensusResponsePB& response,
-                                bool* more_pending);
+                                bool* more_pending,
+                                const PipelinedRequestInfo* pipelined = nullptr);
 
   // Closes the queue, peers are still allowed to call UntrackPeer() and ResponseFromPeer() but no
   // additional peers can be tracked or messages queued.
@@ -388,6 +443,9 @@ class PeerMessageQueue {
   void NotifyObserversOfTermChange(int64_t term);
   void NotifyObserversOfTermChangeTask(int64_t term);
 
+  void NotifyObserversOfOperationsRead(const std::string& uuid);
+  void NotifyObserversOfOperationsReadTask(const std::string& uuid);
+
   void NotifyObserversOfFailedFollower(const std::string& uuid,
                                        int64_t term,
                                        const std::string& reason);
@@ -412,6 +470,17 @@ class PeerMessageQueue {
 
   TrackedPeer* TrackPeerUnlocked(const std::string& uuid);
 
+  // Returns the maximal size of the next batch sent to the peer.
+  int64_t BatchSizeLimitUnlocked(TrackedPeer* peer);
+
+  // Adapts the batch size of the peer to the round trip time and size of the request that the peer
+  // just responded to.
+  void UpdateBatchSizeUnlocked(TrackedPeer* peer, const PipelinedRequestInfo* pipelined);
+
+  // Changes the batch size of the peer, keeping the memory tracker in sync. Returns false if the
+  // memory limit of the tracker does not allow to grow the batch.
+  bool SetBatchSizeUnlocked(TrackedPeer* peer, int64_t batch_size);
+
   // Checks that if the queue is in LEADER mode then all registered peers are in the active config.
   // Crashes with a FATAL log message if this invariant does not hold. If the queue is in NON_LEADER
   // mode, does nothing.
@@ -439,6 +508,13 @@ class PeerMessageQueue {
   // The pool token which executes observer notifications.
   std::unique_ptr<ThreadPoolToken> raft_pool_observers_token_;
 
+  // The pool token which executes reads of operations for peers that fell behind the log cache.
+  // Null if such reads are done synchronously.
+  std::unique_ptr<ThreadPoolToken> raft_pool_read_token_;
+
+  const scoped_refptr<log::Log> log_;
+  const scoped_refptr<MetricEntity> metric_entity_;
+
   // PB containing identifying information about the local peer.
   const RaftPeerPB local_peer_pb_;
   const yb::PeerId local_peer_uuid_;
@@ -461,6 +537,12 @@ class PeerMessageQueue {
 
   LogCache log_cache_;
 
+  // Tracks the memory of the batches that peers with adaptive batch sizes are allowed to have in
+  // flight. Its parent has the server-wide limit, so lagging peers of all tablets together could
+  // not exhaust the memory with huge batches.
+  std::shared_ptr<MemTracker> batch_parent_tracker_;
+  std::shared_ptr<MemTracker> batch_tracker_;
+
   Metrics metrics_;
 
   server::ClockPtr clock_;
@@ -506,6 +588,10 @@ class PeerMessageQueueObserver {
                                     int64_t term,
                                     const std::string& reason) = 0;
 
+  // Notify Consensus that operations that were not in the log cache were read for a peer, so a
+  // request carrying them could be sent.
+  virtual void NotifyOperationsRead(const std::string& peer_uuid) {}
+
   virtual ~PeerMessageQueueObserver() {}
 };
 
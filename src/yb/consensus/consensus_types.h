@@ -54,6 +54,11 @@ class ReplicaOperationFactory {
   virtual void SetPropagatedSafeTime(HybridTime ht) = 0;
   virtual bool ShouldApplyWrite() = 0;
 
+  // Called around a run of consecutive write operations that are applied one after another, so
+  // the factory could combine their writes.
+  virtual void StartApplyGroup() {}
+  virtual void FinishApplyGroup() {}
+
   virtual ~ReplicaOperationFactory() {}
 };
 
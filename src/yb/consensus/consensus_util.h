@@ -14,6 +14,8 @@
 #ifndef YB_CONSENSUS_CONSENSUS_UTIL_H
 #define YB_CONSENSUS_CONSENSUS_UTIL_H
 
+#include "yb/consensus/consensus.pb.h"
+
 #include "yb/util/enums.h"
 
 namespace yb {
@@ -31,6 +33,16 @@ YB_DEFINE_ENUM(
     // empty. This is used during heartbeats from leader to peers.
     (kAlwaysSend));
 
+// Number of operations in the request, including the serialized ones.
+inline int NumOps(const ConsensusRequestPB& request) {
+  return request.ops_size() + request.serialized_ops_size();
+}
+
+// Index of the last operation in the request, operations are consecutive and follow preceding_id.
+inline int64_t LastOpIndex(const ConsensusRequestPB& request) {
+  return request.preceding_id().index() + NumOps(request);
+}
+
 }  // namespace consensus
 }  // namespace yb
 
@@ -34,6 +34,7 @@
 #include <unistd.h>
 
 #include <algorithm>
+#include <thread>
 #include <vector>
 
 #include <boost/bind.hpp>
@@ -43,6 +44,7 @@
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log-test-base.h"
 #include "yb/consensus/log_index.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
@@ -51,6 +53,7 @@
 DEFINE_int32(num_batches, 10000,
              "Number of batches to write to/read from the Log in TestWriteManyBatches");
 
+DECLARE_string(log_compression_codec);
 DECLARE_int32(log_min_segments_to_retain);
 DECLARE_bool(never_fsync);
 DECLARE_bool(writable_file_use_fsync);
@@ -207,6 +210,59 @@ TEST_F(LogTest, TestMultipleEntriesInABatch) {
   ASSERT_OK(log_->Close());
 }
 
+// Segments written with different compression codecs should be readable by the same reader.
+TEST_F(LogTest, CompressedSegments) {
+  constexpr int kNumBatchesPerSegment = 10;
+  constexpr int kNumOpsPerBatch = 20;
+
+  std::vector<std::string> codecs = {"lz4"};
+  if (LogCompressionCodecFromString("zstd").ok()) {
+    codecs.push_back("zstd");
+  }
+  codecs.push_back("none");
+
+  FLAGS_log_compression_codec = "none";
+  BuildLog();
+
+  OpId op_id = MakeOpId(1, 1);
+  for (const auto& codec : codecs) {
+    for (int i = 0; i != kNumBatchesPerSegment; ++i) {
+      ASSERT_OK(AppendNoOpsToLogSync(clock_, log_.get(), &op_id, kNumOpsPerBatch));
+    }
+    FLAGS_log_compression_codec = codec;
+    ASSERT_OK(RollLog());
+  }
+  ASSERT_OK(log_->Close());
+
+  std::unique_ptr<LogReader> reader;
+  ASSERT_OK(LogReader::Open(fs_manager_->env(), nullptr, kTestTablet, tablet_wal_path_,
+                            fs_manager_->uuid(), nullptr, &reader));
+  SegmentSequence segments;
+  ASSERT_OK(reader->GetSegmentsSnapshot(&segments));
+  ASSERT_EQ(codecs.size() + 1, segments.size());
+
+  int64_t expected_index = 1;
+  for (size_t i = 0; i != segments.size(); ++i) {
+    auto expected_codec = LogCompressionCodecPB::NO_COMPRESSION;
+    if (i != 0) {
+      expected_codec = ASSERT_RESULT(LogCompressionCodecFromString(codecs[i - 1]));
+    }
+    ASSERT_EQ(expected_codec, segments[i]->header().compression_codec());
+    auto read_entries = segments[i]->ReadEntries();
+    ASSERT_OK(read_entries.status);
+    if (i + 1 == segments.size()) {
+      // Last segment is empty.
+      ASSERT_TRUE(read_entries.entries.empty());
+      continue;
+    }
+    ASSERT_EQ(kNumBatchesPerSegment * kNumOpsPerBatch, read_entries.entries.size());
+    for (const auto& entry : read_entries.entries) {
+      ASSERT_EQ(expected_index, entry->replicate().id().index());
+      ++expected_index;
+    }
+  }
+}
+
 // Tests that everything works properly with fsync enabled:
 // This also tests SyncDir() (see KUDU-261), which is called whenever
 // a new log segment is initialized.
@@ -299,6 +355,50 @@ TEST_F(LogTest, TestFsyncDataSize) {
   LOG(INFO)<< "Wrote " << size << " batches to log";
 }
 
+#if defined(__linux__)
+// Tests durable wal write using the sync group of the file system.
+TEST_F(LogTest, TestGroupSync) {
+  options_.durable_wal_write = true;
+  options_.group_sync = true;
+  BuildLog();
+
+  OpId opid;
+  opid.set_term(0);
+  opid.set_index(1);
+
+  ASSERT_OK(AppendNoOp(&opid));
+  ASSERT_OK(AppendNoOp(&opid));
+  ASSERT_OK(log_->Close());
+}
+
+TEST_F(LogTest, TestSyncGroupSharing) {
+  constexpr int kNumThreads = 8;
+  constexpr int kSyncsPerThread = 50;
+
+  const auto dir = GetTestPath("sync_group");
+  ASSERT_OK(Env::Default()->CreateDir(dir));
+  // Directories of the same file system share the group.
+  auto group = ASSERT_RESULT(LogSyncGroup::ForDirectory(dir));
+  ASSERT_EQ(group, ASSERT_RESULT(LogSyncGroup::ForDirectory(GetTestDataDirectory())));
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i != kNumThreads; ++i) {
+    threads.emplace_back([group] {
+      for (int j = 0; j != kSyncsPerThread; ++j) {
+        ASSERT_OK(group->Sync());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // Concurrent callers share syncs.
+  ASSERT_GT(group->num_syncs(), 0);
+  ASSERT_LE(group->num_syncs(), kNumThreads * kSyncsPerThread);
+  LOG(INFO) << "Syncs: " << group->num_syncs();
+}
+#endif
+
 // Regression test for part of KUDU-735:
 // if a log is not preallocated, we should properly track its on-disk size as we append to
 // it.
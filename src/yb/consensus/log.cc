@@ -42,6 +42,7 @@
 #include "yb/consensus/log_index.h"
 #include "yb/consensus/log_metrics.h"
 #include "yb/consensus/log_reader.h"
+#include "yb/consensus/log_sync_group.h"
 #include "yb/consensus/log_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/map-util.h"
@@ -49,12 +50,14 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/walltime.h"
+#include "yb/util/async_io.h"
 #include "yb/util/coding.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/env_util.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/io_scheduler.h"
 #include "yb/util/kernel_stack_watchdog.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
@@ -105,6 +108,18 @@ DEFINE_int32(consensus_log_scoped_watch_delay_append_threshold_ms, 1000,
 TAG_FLAG(consensus_log_scoped_watch_delay_append_threshold_ms, runtime);
 TAG_FLAG(consensus_log_scoped_watch_delay_append_threshold_ms, advanced);
 
+DEFINE_string(log_compression_codec, "none",
+              "Codec used to compress entry batches of new log segments: none, lz4 or zstd. "
+              "The codec is recorded in the segment header, so segments written with different "
+              "codecs could be read.");
+TAG_FLAG(log_compression_codec, runtime);
+TAG_FLAG(log_compression_codec, advanced);
+
+DEFINE_bool(log_async_writes, false,
+            "Write new log segments on the asynchronous I/O thread pool, so the appender thread "
+            "does not wait for the writes and fsyncs of a group before appending the next one.");
+TAG_FLAG(log_async_writes, advanced);
+
 // Fault/latency injection flags.
 // -----------------------------
 DEFINE_bool(log_inject_latency, false,
@@ -141,6 +156,17 @@ static bool ValidateLogsToRetain(const char* flagname, int value) {
 static bool dummy = google::RegisterFlagValidator(
     &FLAGS_log_min_segments_to_retain, &ValidateLogsToRetain);
 
+static bool ValidateLogCompressionCodec(const char* flagname, const std::string& value) {
+  auto codec = yb::log::LogCompressionCodecFromString(value);
+  if (codec.ok()) {
+    return true;
+  }
+  LOG(ERROR) << flagname << " value " << value << " is invalid: " << codec.status();
+  return false;
+}
+static bool log_compression_codec_dummy = google::RegisterFlagValidator(
+    &FLAGS_log_compression_codec, &ValidateLogCompressionCodec);
+
 static const char kSegmentPlaceholderFileTemplate[] = ".tmp.newsegmentXXXXXX";
 
 namespace yb {
@@ -184,6 +210,9 @@ class Log::Appender {
   void ProcessBatch(LogEntryBatch* entry_batch);
   void GroupWork();
 
+  // Invokes the callbacks of the batches with the result of their sync.
+  void RunCallbacks(const Status& status, std::vector<std::unique_ptr<LogEntryBatch>>* batches);
+
   Log* const log_;
 
   // Lock to protect access to thread_ during shutdown.
@@ -259,6 +288,22 @@ void Log::Appender::GroupWork() {
   }
   TRACE_EVENT1("log", "batch", "batch_size", sync_batch_.size());
 
+  if (log_->active_async_file_) {
+    // The callbacks are invoked by the asynchronous I/O pool once the group is synced, meanwhile
+    // this thread appends the next group.
+    auto batches = std::make_shared<std::vector<std::unique_ptr<LogEntryBatch>>>(
+        std::move(sync_batch_));
+    sync_batch_.clear();
+    log_->SyncAsync([this, batches, time_started = time_started_](const Status& status) {
+      if (log_->metrics_) {
+        log_->metrics_->group_commit_latency->Increment(
+            MonoTime::Now().GetDeltaSince(time_started).ToMicroseconds());
+      }
+      RunCallbacks(status, batches.get());
+    });
+    return;
+  }
+
   BOOST_SCOPE_EXIT(this_) {
     if (this_->log_->metrics_) {
       MonoTime time_now = MonoTime::Now();
@@ -268,19 +313,24 @@ void Log::Appender::GroupWork() {
     this_->sync_batch_.clear();
   } BOOST_SCOPE_EXIT_END;
 
-  Status s = log_->Sync();
-  if (PREDICT_FALSE(!s.ok())) {
-    LOG_WITH_PREFIX(DFATAL) << "Error syncing log: " << s;
-    for (std::unique_ptr<LogEntryBatch>& entry_batch : sync_batch_) {
+  RunCallbacks(log_->Sync(), &sync_batch_);
+  VLOG_WITH_PREFIX(1) << "Exiting AppendTask for tablet " << log_->tablet_id();
+}
+
+void Log::Appender::RunCallbacks(
+    const Status& status, std::vector<std::unique_ptr<LogEntryBatch>>* batches) {
+  if (PREDICT_FALSE(!status.ok())) {
+    LOG_WITH_PREFIX(DFATAL) << "Error syncing log: " << status;
+    for (std::unique_ptr<LogEntryBatch>& entry_batch : *batches) {
       if (!entry_batch->callback().is_null()) {
-        entry_batch->callback().Run(s);
+        entry_batch->callback().Run(status);
       }
     }
   } else {
     TRACE_EVENT0("log", "Callbacks");
-    VLOG_WITH_PREFIX(2) << "Synchronized " << sync_batch_.size() << " entry batches";
+    VLOG_WITH_PREFIX(2) << "Synchronized " << batches->size() << " entry batches";
     SCOPED_WATCH_STACK(FLAGS_consensus_log_scoped_watch_delay_callback_threshold_ms);
-    for (std::unique_ptr<LogEntryBatch>& entry_batch : sync_batch_) {
+    for (std::unique_ptr<LogEntryBatch>& entry_batch : *batches) {
       if (PREDICT_TRUE(!entry_batch->failed_to_append() && !entry_batch->callback().is_null())) {
         entry_batch->callback().Run(Status::OK());
       }
@@ -288,9 +338,8 @@ void Log::Appender::GroupWork() {
       // from memory trackers, and the callback of a later batch may want to use that memory.
       entry_batch.reset();
     }
-    sync_batch_.clear();
+    batches->clear();
   }
-  VLOG_WITH_PREFIX(1) << "Exiting AppendTask for tablet " << log_->tablet_id();
 }
 
 void Log::Appender::Shutdown() {
@@ -408,6 +457,16 @@ Status Log::Init() {
     YB_LOG_FIRST_N(INFO, 1) << "durable_wal_write is turned off. Buffered IO will be used for WAL.";
   }
 
+  if (options_.group_sync) {
+    auto sync_group = LogSyncGroup::ForDirectory(log_dir_);
+    if (sync_group.ok()) {
+      sync_group_ = std::move(*sync_group);
+    } else {
+      YB_LOG_FIRST_N(WARNING, 1) << "Failed to use WAL sync group, falling back to fsync: "
+                                 << sync_group.status();
+    }
+  }
+
   // We always create a new segment when the log starts.
   RETURN_NOT_OK(AsyncAllocateSegment());
   RETURN_NOT_OK(allocation_status_.Get());
@@ -583,6 +642,9 @@ Status Log::DoAppend(LogEntryBatch* entry_batch,
     if (metrics_) {
       metrics_->bytes_logged->IncrementBy(entry_batch_bytes);
     }
+    if (options_.io_scheduler) {
+      options_.io_scheduler->Charge(IoPriority::kWal, entry_batch_bytes);
+    }
 
     // Populate the offset and sequence number for the entry batch if we did a WAL write.
     entry_batch->offset_ = start_offset;
@@ -596,7 +658,11 @@ Status Log::DoAppend(LogEntryBatch* entry_batch,
   }
 
   CHECK_OK(UpdateIndexForBatch(*entry_batch));
-  UpdateFooterForBatch(entry_batch);
+  // Entries that are not written belong to earlier segments, so the footer of the active segment
+  // should not account for them.
+  if (!skip_wal_write) {
+    UpdateFooterForBatch(entry_batch);
+  }
 
   // We expect the caller to free the actual entries if caller_owns_operation is set.
   if (caller_owns_operation) {
@@ -650,58 +716,118 @@ Status Log::AllocateSegmentAndRollOver() {
   return RollOver();
 }
 
-Status Log::Sync() {
-  TRACE_EVENT0("log", "Sync");
-  SCOPED_LATENCY_METRIC(metrics_, sync_latency);
+bool Log::PrepareFsync() {
+  if (sync_disabled_) {
+    return false;
+  }
 
-  if (!sync_disabled_) {
-    if (PREDICT_FALSE(GetAtomicFlag(&FLAGS_log_inject_latency))) {
+  if (PREDICT_FALSE(GetAtomicFlag(&FLAGS_log_inject_latency))) {
       Random r(GetCurrentTimeMicros());
       int sleep_ms = r.Normal(GetAtomicFlag(&FLAGS_log_inject_latency_ms_mean),
                               GetAtomicFlag(&FLAGS_log_inject_latency_ms_stddev));
       if (sleep_ms > 0) {
-        LOG_WITH_PREFIX(INFO) << "Injecting " << sleep_ms << "ms of latency in Log::Sync()";
-        SleepFor(MonoDelta::FromMilliseconds(sleep_ms));
-      }
+      LOG_WITH_PREFIX(INFO) << "Injecting " << sleep_ms << "ms of latency in Log::Sync()";
+      SleepFor(MonoDelta::FromMilliseconds(sleep_ms));
     }
+  }
 
-    bool timed_or_data_limit_sync = false;
-    if (!durable_wal_write_ && periodic_sync_needed_.load()) {
-      if (interval_durable_wal_write_) {
-        if (MonoTime::Now() > periodic_sync_earliest_unsync_entry_time_
-            + interval_durable_wal_write_) {
-          timed_or_data_limit_sync = true;
-        }
+  bool timed_or_data_limit_sync = false;
+  if (!durable_wal_write_ && periodic_sync_needed_.load()) {
+    if (interval_durable_wal_write_) {
+      if (MonoTime::Now() > periodic_sync_earliest_unsync_entry_time_
+          + interval_durable_wal_write_) {
+        timed_or_data_limit_sync = true;
       }
-      if (bytes_durable_wal_write_mb_ > 0) {
-        if (periodic_sync_unsynced_bytes_ >= bytes_durable_wal_write_mb_ * 1_MB) {
-          timed_or_data_limit_sync = true;
-        }
+    }
+    if (bytes_durable_wal_write_mb_ > 0) {
+      if (periodic_sync_unsynced_bytes_ >= bytes_durable_wal_write_mb_ * 1_MB) {
+        timed_or_data_limit_sync = true;
       }
     }
+  }
+
+  if (durable_wal_write_ || timed_or_data_limit_sync) {
+    periodic_sync_needed_.store(false);
+    periodic_sync_unsynced_bytes_ = 0;
+    return true;
+  }
+  return false;
+}
+
+Status Log::Sync() {
+  TRACE_EVENT0("log", "Sync");
+  SCOPED_LATENCY_METRIC(metrics_, sync_latency);
 
-    if (durable_wal_write_ || timed_or_data_limit_sync) {
-      periodic_sync_needed_.store(false);
-      periodic_sync_unsynced_bytes_ = 0;
-      LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
+  if (PrepareFsync()) {
+    const auto start = MonoTime::Now();
+    LOG_SLOW_EXECUTION(WARNING, 50, "Fsync log took a long time") {
+      if (sync_group_) {
+        RETURN_NOT_OK(active_segment_->Flush());
+        RETURN_NOT_OK(sync_group_->Sync());
+      } else {
         RETURN_NOT_OK(active_segment_->Sync());
       }
     }
+    if (options_.io_scheduler) {
+      options_.io_scheduler->ReportSyncLatency(MonoTime::Now() - start);
+    }
   }
+  if (active_async_file_) {
+    // The reader should not see the entries before they are written.
+    RETURN_NOT_OK(active_async_file_->Wait());
+  }
+
+  SyncDone(active_segment_->written_offset(), last_appended_entry_op_id_);
+  return Status::OK();
+}
+
+void Log::SyncAsync(StdStatusCallback callback) {
+  TRACE_EVENT0("log", "SyncAsync");
+  const bool fsync = PrepareFsync();
+  const auto written_offset = active_segment_->written_offset();
+  const auto last_appended_entry_op_id = last_appended_entry_op_id_;
+  const auto start = MonoTime::Now();
+  active_async_file_->SubmitAsync(
+      [fsync, sync_group = sync_group_](WritableFile* file) -> Status {
+        if (!fsync) {
+          return Status::OK();
+        }
+        if (sync_group) {
+          RETURN_NOT_OK(file->Flush(WritableFile::FLUSH_ASYNC));
+          return sync_group->Sync();
+        }
+        return file->Sync();
+      },
+      [this, fsync, written_offset, last_appended_entry_op_id, start,
+       callback = std::move(callback)](const Status& status) {
+        if (metrics_) {
+          metrics_->sync_latency->Increment(MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+        }
+        if (fsync && status.ok() && options_.io_scheduler) {
+          options_.io_scheduler->ReportSyncLatency(MonoTime::Now() - start);
+        }
+        if (status.ok()) {
+          SyncDone(written_offset, last_appended_entry_op_id);
+        }
+        callback(status);
+      });
+}
 
+void Log::SyncDone(int64_t written_offset, const yb::OpId& last_appended_entry_op_id) {
   // Update the reader on how far it can read the active segment.
-  reader_->UpdateLastSegmentOffset(active_segment_->written_offset());
+  reader_->UpdateLastSegmentOffset(written_offset);
 
   {
     std::lock_guard<std::mutex> write_lock(last_synced_entry_op_id_mutex_);
-    last_synced_entry_op_id_.store(last_appended_entry_op_id_, std::memory_order_release);
+    last_synced_entry_op_id_.store(last_appended_entry_op_id, std::memory_order_release);
     last_synced_entry_op_id_cond_.notify_all();
   }
-
-  return Status::OK();
 }
 
 Status Log::GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const {
+  // Keep the operations that change data capture consumers did not read yet.
+  min_op_idx = std::min(min_op_idx, cdc_min_replicated_index());
+
   // Find the prefix of segments in the segment sequence that is guaranteed not to include
   // 'min_op_idx'.
   RETURN_NOT_OK(reader_->GetSegmentPrefixNotIncluding(min_op_idx, segments_to_gc));
@@ -941,6 +1067,10 @@ Status Log::Close() {
   // Allocation pool is used from appender pool, so we should shutdown appender first.
   appender_->Shutdown();
   allocation_pool_->Shutdown();
+  if (active_async_file_) {
+    // Callbacks of the queued syncs could need state_lock_.
+    WARN_NOT_OK(active_async_file_->Wait(), "Async log write failed");
+  }
 
   std::lock_guard<percpu_rwlock> l(state_lock_);
   switch (log_state_) {
@@ -1022,8 +1152,13 @@ Status Log::SwitchToAllocatedSegment() {
   }
 
   // Create a new segment.
-  gscoped_ptr<WritableLogSegment> new_segment(
-      new WritableLogSegment(new_segment_path, next_segment_file_));
+  std::shared_ptr<AsyncWritableFile> new_async_file;
+  if (FLAGS_log_async_writes) {
+    new_async_file = std::make_shared<AsyncWritableFile>(next_segment_file_);
+  }
+  gscoped_ptr<WritableLogSegment> new_segment(new WritableLogSegment(
+      new_segment_path,
+      new_async_file ? std::shared_ptr<WritableFile>(new_async_file) : next_segment_file_));
 
   // Set up the new header and footer.
   LogSegmentHeaderPB header;
@@ -1031,6 +1166,11 @@ Status Log::SwitchToAllocatedSegment() {
   header.set_minor_version(kLogMinorVersion);
   header.set_sequence_number(active_segment_sequence_number_);
   header.set_tablet_id(tablet_id_);
+  // Flag value is validated, so fall back to no compression only if it was changed concurrently.
+  auto compression_codec = LogCompressionCodecFromString(FLAGS_log_compression_codec);
+  if (compression_codec.ok()) {
+    header.set_compression_codec(*compression_codec);
+  }
 
   // Set up the new footer. This will be maintained as the segment is written.
   footer_builder_.Clear();
@@ -1044,6 +1184,10 @@ Status Log::SwitchToAllocatedSegment() {
   }
 
   RETURN_NOT_OK(new_segment->WriteHeaderAndOpen(header));
+  if (new_async_file) {
+    // The header should be on disk before the segment is opened for reading.
+    RETURN_NOT_OK(new_async_file->Wait());
+  }
   // Transform the currently-active segment into a readable one, since we need to be able to replay
   // the segments for other peers.
   {
@@ -1066,6 +1210,7 @@ Status Log::SwitchToAllocatedSegment() {
 
   // Now set 'active_segment_' to the new segment.
   active_segment_.reset(new_segment.release());
+  active_async_file_ = std::move(new_async_file);
   cur_max_segment_size_ = NextSegmentDesiredSize();
 
   allocation_state_ = kAllocationNotStarted;
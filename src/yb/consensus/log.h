@@ -34,6 +34,7 @@
 #define YB_CONSENSUS_LOG_H_
 
 #include <atomic>
+#include <limits>
 #include <map>
 #include <memory>
 #include <string>
@@ -58,6 +59,7 @@
 
 namespace yb {
 
+class AsyncWritableFile;
 class MetricEntity;
 class ThreadPool;
 
@@ -67,6 +69,7 @@ struct LogMetrics;
 class LogEntryBatch;
 class LogIndex;
 class LogReader;
+class LogSyncGroup;
 
 // Log interface, inspired by Raft's (logcabin) Log. Provides durability to YugaByte as a normal
 // Write Ahead Log and also plays the role of persistent storage for the consensus state machine.
@@ -210,6 +213,16 @@ class Log : public RefCountedThreadSafe<Log> {
   void GetMaxIndexesToSegmentSizeMap(int64_t min_op_idx,
                                      std::map<int64_t, int64_t>* max_idx_to_segment_size) const;
 
+  // Minimum operation index that is still needed by change data capture consumers. Segments
+  // containing it and later operations are not GCed, regardless of the min_op_idx passed to GC.
+  void set_cdc_min_replicated_index(int64_t index) {
+    cdc_min_replicated_index_.store(index, std::memory_order_release);
+  }
+
+  int64_t cdc_min_replicated_index() const {
+    return cdc_min_replicated_index_.load(std::memory_order_acquire);
+  }
+
   // Returns the file system location of the currently active WAL segment.
   const WritableLogSegment* ActiveSegmentForTests() const {
     return active_segment_.get();
@@ -335,6 +348,18 @@ class Log : public RefCountedThreadSafe<Log> {
 
   CHECKED_STATUS Sync();
 
+  // Like Sync, but the fsync is done by the asynchronous I/O thread pool, after the writes queued
+  // to active_async_file_. The callback is invoked on that pool once it is done.
+  void SyncAsync(StdStatusCallback callback);
+
+  // Returns true if the appended entries should be made durable now, and resets the periodic sync
+  // state in that case.
+  bool PrepareFsync();
+
+  // Called once the entries appended up to the given offset of the active segment were written
+  // and, if required, made durable.
+  void SyncDone(int64_t written_offset, const yb::OpId& last_appended_entry_op_id);
+
   // Helper method to get the segment sequence to GC based on the provided min_op_idx.
   CHECKED_STATUS GetSegmentsToGCUnlocked(int64_t min_op_idx, SegmentSequence* segments_to_gc) const;
 
@@ -367,6 +392,9 @@ class Log : public RefCountedThreadSafe<Log> {
   // The currently active segment being written.
   gscoped_ptr<WritableLogSegment> active_segment_;
 
+  // The file of the active segment, when it is written asynchronously (FLAGS_log_async_writes).
+  std::shared_ptr<AsyncWritableFile> active_async_file_;
+
   // The current (active) segment sequence number.
   uint64_t active_segment_sequence_number_;
 
@@ -426,6 +454,9 @@ class Log : public RefCountedThreadSafe<Log> {
   // If non-zero, sync if more than given amount of data to sync.
   int32_t bytes_durable_wal_write_mb_;
 
+  // If set, syncs are done by the group shared with logs of other tablets on the same file system.
+  std::shared_ptr<LogSyncGroup> sync_group_;
+
   // Keeps track of oldest entry which needs to be synced.
   MonoTime periodic_sync_earliest_unsync_entry_time_ = MonoTime::kMin;
 
@@ -461,6 +492,8 @@ class Log : public RefCountedThreadSafe<Log> {
   // Used in tests to declare all operations as safe.
   bool all_op_ids_safe_ = false;
 
+  std::atomic<int64_t> cdc_min_replicated_index_{std::numeric_limits<int64_t>::max()};
+
   const std::string log_prefix_;
 
   DISALLOW_COPY_AND_ASSIGN(Log);
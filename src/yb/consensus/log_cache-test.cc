@@ -41,6 +41,7 @@
 #include <boost/scope_exit.hpp>
 
 #include "yb/common/wire_protocol-test-util.h"
+#include "yb/consensus/async_log_reader.h"
 #include "yb/consensus/consensus-test-util.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_cache.h"
@@ -57,10 +58,12 @@ using std::atomic;
 using std::shared_ptr;
 using std::thread;
 
+DECLARE_bool(log_cache_serialize_replicates);
 DECLARE_int32(log_cache_size_limit_mb);
 DECLARE_int32(global_log_cache_size_limit_mb);
 
 METRIC_DECLARE_entity(tablet);
+METRIC_DECLARE_counter(log_catch_up_read_ops);
 
 using std::atomic;
 using std::vector;
@@ -186,6 +189,79 @@ TEST_F(LogCacheTest, TestAppendAndGetMessages) {
   EXPECT_EQ("3.21", OpIdToString(messages[0]->id()));
 }
 
+TEST_F(LogCacheTest, SerializedMessages) {
+  constexpr int kMaxSize = 8 * 1024 * 1024;
+  FLAGS_log_cache_serialize_replicates = true;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 20));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+
+  auto check_serialized = [this](int64_t after_index, size_t expected_size) {
+    ReplicateMsgs messages;
+    SerializedReplicateMsgs serialized;
+    OpId preceding;
+    ASSERT_OK(cache_->ReadOps(
+        after_index, kMaxSize, &messages, &preceding, nullptr /* have_more_messages */,
+        &serialized));
+    ASSERT_EQ(expected_size, messages.size());
+    ASSERT_EQ(messages.size(), serialized.size());
+    for (size_t i = 0; i != messages.size(); ++i) {
+      ReplicateMsg parsed;
+      ASSERT_TRUE(parsed.ParseFromString(*serialized[i]));
+      ASSERT_EQ(messages[i]->ShortDebugString(), parsed.ShortDebugString());
+    }
+  };
+
+  ASSERT_NO_FATALS(check_serialized(0, 20));
+
+  // Cached entries share the serialized message between reads.
+  {
+    ReplicateMsgs messages1, messages2;
+    SerializedReplicateMsgs serialized1, serialized2;
+    OpId preceding;
+    ASSERT_OK(cache_->ReadOps(10, kMaxSize, &messages1, &preceding, nullptr, &serialized1));
+    ASSERT_OK(cache_->ReadOps(10, kMaxSize, &messages2, &preceding, nullptr, &serialized2));
+    ASSERT_EQ(serialized1, serialized2);
+  }
+
+  // Messages read from disk are serialized as well.
+  cache_->EvictThroughOp(15);
+  ASSERT_NO_FATALS(check_serialized(5, 15));
+}
+
+// Tests that ops evicted from the cache are read ahead by the async reader, and ReadOps returns
+// them once they are read.
+TEST_F(LogCacheTest, AsyncReads) {
+  constexpr int kMaxSize = 8 * 1024 * 1024;
+  ASSERT_OK(AppendReplicateMessagesToCache(1, 100));
+  ASSERT_OK(log_->WaitUntilAllFlushed());
+  cache_->EvictThroughOp(50);
+
+  std::unique_ptr<ThreadPool> read_pool;
+  ASSERT_OK(ThreadPoolBuilder("read").Build(&read_pool));
+  auto read_token = read_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT);
+  std::atomic<int> num_reads(0);
+  auto reader = std::make_shared<log::AsyncLogReader>(
+      log_, read_token.get(), metric_entity_, [&num_reads] { ++num_reads; });
+
+  ReplicateMsgs messages;
+  OpId preceding;
+  bool have_more_messages = false;
+  ASSERT_OK(WaitFor([&]() -> Result<bool> {
+    RETURN_NOT_OK(cache_->ReadOps(
+        20, kMaxSize, &messages, &preceding, &have_more_messages, nullptr /* serialized */,
+        reader.get()));
+    if (messages.empty()) {
+      EXPECT_TRUE(have_more_messages);
+      return false;
+    }
+    return true;
+  }, 10s, "Ops read"));
+  ASSERT_GE(num_reads.load(), 1);
+  ASSERT_EQ(80, messages.size());
+  ASSERT_EQ("3.21", OpIdToString(messages[0]->id()));
+  ASSERT_EQ(30, METRIC_log_catch_up_read_ops.Instantiate(metric_entity_)->value());
+  read_token->Shutdown();
+}
 
 // Ensure that the cache always yields at least one message,
 // even if that message is larger than the batch size. This ensures
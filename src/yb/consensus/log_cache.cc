@@ -41,6 +41,7 @@
 #include <google/protobuf/wire_format_lite.h>
 #include <google/protobuf/wire_format_lite_inl.h>
 
+#include "yb/consensus/async_log_reader.h"
 #include "yb/consensus/log.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/gutil/bind.h"
@@ -48,6 +49,7 @@
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/util/atomic.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
@@ -70,6 +72,13 @@ DEFINE_int32(global_log_cache_size_limit_mb, 1024,
              "caching log entries across all tablets is kept under this threshold.");
 TAG_FLAG(global_log_cache_size_limit_mb, advanced);
 
+DEFINE_bool(log_cache_serialize_replicates, false,
+            "Serialize operations once, when they are appended to the log cache, and send the "
+            "serialized bytes to followers instead of serializing the operation for every "
+            "UpdateConsensus request. Should only be enabled when all tablet servers support it.");
+TAG_FLAG(log_cache_serialize_replicates, advanced);
+TAG_FLAG(log_cache_serialize_replicates, runtime);
+
 using strings::Substitute;
 
 namespace yb {
@@ -86,6 +95,12 @@ namespace {
 
 const std::string kParentMemTrackerId = "log_cache"s;
 
+SerializedReplicateMsgPtr SerializeMessage(const ReplicateMsg& msg) {
+  auto result = std::make_shared<std::string>();
+  msg.AppendToString(result.get());
+  return result;
+}
+
 }
 
 typedef vector<const ReplicateMsg*>::const_iterator MsgIter;
@@ -142,8 +157,13 @@ Result<LogCache::PrepareAppendResult> LogCache::PrepareAppendOperations(const Re
   PrepareAppendResult result;
   std::vector<CacheEntry> entries_to_insert;
   entries_to_insert.reserve(msgs.size());
+  const bool serialize = GetAtomicFlag(&FLAGS_log_cache_serialize_replicates);
   for (const auto& msg : msgs) {
-    CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()) };
+    CacheEntry e = { msg, static_cast<int64_t>(msg->SpaceUsedLong()), nullptr };
+    if (serialize) {
+      e.serialized = SerializeMessage(*msg);
+      e.mem_usage += e.serialized->capacity();
+    }
     result.mem_required += e.mem_usage;
     entries_to_insert.emplace_back(std::move(e));
   }
@@ -287,13 +307,23 @@ int64_t TotalByteSizeForMessage(const ReplicateMsg& msg) {
   return msg_size;
 }
 
+int64_t TotalByteSizeForEntry(
+    const ReplicateMsg& msg, const SerializedReplicateMsgPtr& serialized) {
+  if (!serialized) {
+    return TotalByteSizeForMessage(msg);
+  }
+  return google::protobuf::internal::WireFormatLite::LengthDelimitedSize(serialized->size()) + 1;
+}
+
 } // anonymous namespace
 
 Status LogCache::ReadOps(int64_t after_op_index,
                          int max_size_bytes,
                          ReplicateMsgs* messages,
                          OpId* preceding_op,
-                         bool* have_more_messages) {
+                         bool* have_more_messages,
+                         SerializedReplicateMsgs* serialized,
+                         log::AsyncLogReader* async_reader) {
   DCHECK_ONLY_NOTNULL(messages);
   DCHECK_ONLY_NOTNULL(preceding_op);
   DCHECK_GE(after_op_index, 0);
@@ -324,20 +354,46 @@ Status LogCache::ReadOps(int64_t after_op_index,
       l.unlock();
 
       ReplicateMsgs raw_replicate_ptrs;
-      RETURN_NOT_OK_PREPEND(
-        log_->GetLogReader()->ReadReplicatesInRange(
-            next_index, up_to, remaining_space, &raw_replicate_ptrs),
-        Substitute("Failed to read ops $0..$1", next_index, up_to));
+      if (async_reader) {
+        RETURN_NOT_OK_PREPEND(
+          async_reader->Take(next_index, up_to, remaining_space, &raw_replicate_ptrs),
+          Substitute("Failed to read ops $0..$1", next_index, up_to));
+        if (raw_replicate_ptrs.empty()) {
+          // The reader will notify when the ops are available.
+          if (have_more_messages) {
+            *have_more_messages = true;
+          }
+          return Status::OK();
+        }
+      } else {
+        RETURN_NOT_OK_PREPEND(
+          log_->GetLogReader()->ReadReplicatesInRange(
+              next_index, up_to, remaining_space, &raw_replicate_ptrs),
+          Substitute("Failed to read ops $0..$1", next_index, up_to));
+        LOG_WITH_PREFIX_UNLOCKED(INFO) << "Successfully read " << raw_replicate_ptrs.size()
+                                       << " ops from disk.";
+      }
+      // Serialize ops read from disk before reacquiring the lock.
+      SerializedReplicateMsgs raw_serialized;
+      if (serialized) {
+        raw_serialized.reserve(raw_replicate_ptrs.size());
+        for (const auto& msg : raw_replicate_ptrs) {
+          raw_serialized.push_back(SerializeMessage(*msg));
+        }
+      }
       l.lock();
-      LOG_WITH_PREFIX_UNLOCKED(INFO) << "Successfully read " << raw_replicate_ptrs.size() << " ops "
-                            << "from disk.";
 
-      for (auto& msg : raw_replicate_ptrs) {
+      for (size_t i = 0; i != raw_replicate_ptrs.size(); ++i) {
+        auto& msg = raw_replicate_ptrs[i];
         CHECK_EQ(next_index, msg->id().index());
 
-        remaining_space -= TotalByteSizeForMessage(*msg);
+        remaining_space -= serialized ? TotalByteSizeForEntry(*msg, raw_serialized[i])
+                                      : TotalByteSizeForMessage(*msg);
         if (remaining_space > 0 || messages->empty()) {
           messages->push_back(msg);
+          if (serialized) {
+            serialized->push_back(raw_serialized[i]);
+          }
           next_index++;
         } else if (have_more_messages) {
           *have_more_messages = true;
@@ -353,7 +409,7 @@ Status LogCache::ReadOps(int64_t after_op_index,
           continue;
         }
 
-        remaining_space -= TotalByteSizeForMessage(*msg);
+        remaining_space -= TotalByteSizeForEntry(*msg, iter->second.serialized);
         if (remaining_space < 0 && !messages->empty()) {
           if (have_more_messages) {
             *have_more_messages = true;
@@ -362,6 +418,11 @@ Status LogCache::ReadOps(int64_t after_op_index,
         }
 
         messages->push_back(msg);
+        if (serialized) {
+          // Entry could be appended while --log_cache_serialize_replicates was not set.
+          serialized->push_back(iter->second.serialized ? iter->second.serialized
+                                                        : SerializeMessage(*msg));
+        }
         next_index++;
       }
     }
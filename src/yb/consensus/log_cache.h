@@ -56,6 +56,7 @@ class MetricEntity;
 class MemTracker;
 
 namespace log {
+class AsyncLogReader;
 class Log;
 class LogReader;
 } // namespace log
@@ -98,11 +99,20 @@ class LogCache {
   // If the ops being requested are not available in the log, this will synchronously read these ops
   // from disk. Therefore, this function may take a substantial amount of time and should not be
   // called with important locks held, etc.
+  //
+  // If serialized is not null, it is filled with the serialized form of every returned message,
+  // shared with the cache, so that the same bytes could be sent to all peers.
+  //
+  // If async_reader is not null, ops that are not in the cache are taken from it instead of being
+  // read synchronously. Only the ops preceding the first one that async_reader has not read yet
+  // are returned in this case, and have_more_messages is set.
   CHECKED_STATUS ReadOps(int64_t after_op_index,
                  int max_size_bytes,
                  ReplicateMsgs* messages,
                  OpId* preceding_op,
-                 bool* have_more_messages = nullptr);
+                 bool* have_more_messages = nullptr,
+                 SerializedReplicateMsgs* serialized = nullptr,
+                 log::AsyncLogReader* async_reader = nullptr);
 
   // Append the operations into the log and the cache.  When the messages have completed writing
   // into the on-disk log, fires 'callback'.
@@ -161,6 +171,9 @@ class LogCache {
     // The cached value of msg->SpaceUsedLong(). This method is expensive
     // to compute, so we compute it only once upon insertion.
     int64_t mem_usage;
+    // msg serialized upon insertion when --log_cache_serialize_replicates is set, included in
+    // mem_usage.
+    SerializedReplicateMsgPtr serialized;
   };
 
   // Try to evict the oldest operations from the queue, stopping either when
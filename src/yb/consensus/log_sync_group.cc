@@ -0,0 +1,124 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/consensus/log_sync_group.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <unordered_map>
+
+#include <glog/logging.h>
+
+#include "yb/util/debug/trace_event.h"
+#include "yb/util/errno.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/thread_restrictions.h"
+
+namespace yb {
+namespace log {
+
+namespace {
+
+std::mutex groups_mutex;
+// Sync groups by the id of the device that contains their file system.
+std::unordered_map<dev_t, std::weak_ptr<LogSyncGroup>> groups;
+
+} // namespace
+
+Result<std::shared_ptr<LogSyncGroup>> LogSyncGroup::ForDirectory(const std::string& dir) {
+#if defined(__linux__)
+  struct stat st;
+  if (stat(dir.c_str(), &st) != 0) {
+    return STATUS(IOError, "Failed to stat " + dir, ErrnoToString(errno), errno);
+  }
+
+  std::lock_guard<std::mutex> lock(groups_mutex);
+  auto& weak_group = groups[st.st_dev];
+  auto group = weak_group.lock();
+  if (group) {
+    return group;
+  }
+  int fd = open(dir.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) {
+    return STATUS(IOError, "Failed to open " + dir, ErrnoToString(errno), errno);
+  }
+  group.reset(new LogSyncGroup(dir, fd));
+  weak_group = group;
+  LOG(INFO) << "Created WAL sync group for the file system of " << dir;
+  return group;
+#else
+  return STATUS(NotSupported, "WAL sync groups are only supported on Linux");
+#endif
+}
+
+LogSyncGroup::LogSyncGroup(std::string dir, int fd) : dir_(std::move(dir)), fd_(fd) {
+}
+
+LogSyncGroup::~LogSyncGroup() {
+  if (close(fd_) != 0) {
+    LOG(WARNING) << "Failed to close " << dir_ << ": " << ErrnoToString(errno);
+  }
+}
+
+Status LogSyncGroup::Sync() {
+  TRACE_EVENT0("log", "LogSyncGroup::Sync");
+  ThreadRestrictions::AssertIOAllowed();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto ticket = ++next_ticket_;
+  for (;;) {
+    if (!status_.ok() || synced_ticket_ >= ticket) {
+      return status_;
+    }
+    if (sync_in_progress_) {
+      cond_.wait(lock);
+      continue;
+    }
+    // All callers that got their tickets so far are covered by the sync started by this caller.
+    const auto covered_ticket = next_ticket_;
+    sync_in_progress_ = true;
+    lock.unlock();
+
+    Status status;
+#if defined(__linux__)
+    LOG_SLOW_EXECUTION(WARNING, 50, "syncfs for " + dir_ + " took a long time") {
+      if (syncfs(fd_) != 0) {
+        status = STATUS(IOError, "Failed to sync file system of " + dir_, ErrnoToString(errno),
+                        errno);
+      }
+    }
+#endif
+
+    lock.lock();
+    sync_in_progress_ = false;
+    ++num_syncs_;
+    if (status.ok()) {
+      synced_ticket_ = covered_ticket;
+    } else {
+      LOG(ERROR) << status;
+      status_ = status;
+    }
+    cond_.notify_all();
+  }
+}
+
+uint64_t LogSyncGroup::num_syncs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_syncs_;
+}
+
+} // namespace log
+} // namespace yb
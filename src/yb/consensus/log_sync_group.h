@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_CONSENSUS_LOG_SYNC_GROUP_H
+#define YB_CONSENSUS_LOG_SYNC_GROUP_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/util/result.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace log {
+
+// Makes WAL segments of all tablets located on the same file system durable with a single syncfs
+// call, instead of a separate fsync per tablet. Concurrent callers of Sync share the same syncfs
+// call, so with many tablets per tablet server the number of flushes issued to the disk does not
+// grow with the number of tablets.
+//
+// syncfs also flushes all other dirty data of the file system, so sync groups are best used when
+// WALs are located on disks that are separate from the data directories.
+class LogSyncGroup {
+ public:
+  // Returns the group of the file system that contains dir, creating it if necessary.
+  // Only supported on Linux.
+  static Result<std::shared_ptr<LogSyncGroup>> ForDirectory(const std::string& dir);
+
+  ~LogSyncGroup();
+
+  LogSyncGroup(const LogSyncGroup&) = delete;
+  void operator=(const LogSyncGroup&) = delete;
+
+  // Makes all data written to the files of the file system before this call durable. Callers
+  // should flush their user space buffers to the kernel before invoking it.
+  // A failed sync is reported to all following callers, since it is unknown what data was lost.
+  CHECKED_STATUS Sync();
+
+  // Number of syncfs calls made by the group, used in tests.
+  uint64_t num_syncs() const;
+
+ private:
+  LogSyncGroup(std::string dir, int fd);
+
+  const std::string dir_;
+  const int fd_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  // Tickets are assigned to Sync callers in the order of the calls. A caller is done once a sync,
+  // that was started after it got its ticket, has completed.
+  uint64_t next_ticket_ = 0;
+  uint64_t synced_ticket_ = 0;
+  bool sync_in_progress_ = false;
+  uint64_t num_syncs_ = 0;
+  Status status_;
+};
+
+} // namespace log
+} // namespace yb
+
+#endif // YB_CONSENSUS_LOG_SYNC_GROUP_H
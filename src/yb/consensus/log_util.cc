@@ -39,6 +39,11 @@
 
 #include <gflags/gflags.h>
 #include <glog/logging.h>
+#include <lz4.h>
+
+#ifdef ZSTD
+#include <zstd.h>
+#endif
 
 #include "yb/consensus/opid_util.h"
 #include "yb/fs/fs_manager.h"
@@ -79,6 +84,13 @@ DEFINE_int32(bytes_durable_wal_write_mb, 1,
              "If 0 fsysnc() is not called.");
 TAG_FLAG(bytes_durable_wal_write_mb, stable);
 
+DEFINE_bool(log_group_sync, false,
+            "Whether WAL syncs of all tablets located on the same file system are combined into "
+            "shared syncfs() calls, instead of calling fsync() for every tablet separately. "
+            "syncfs() also flushes other dirty data of the file system, so it is recommended "
+            "only when WALs are stored on separate disks. Only supported on Linux.");
+TAG_FLAG(log_group_sync, advanced);
+
 DEFINE_bool(log_preallocate_segments, true,
             "Whether the WAL should preallocate the entire segment before writing to it");
 TAG_FLAG(log_preallocate_segments, advanced);
@@ -124,6 +136,114 @@ const size_t kEntryHeaderSize = 12;
 const int kLogMajorVersion = 1;
 const int kLogMinorVersion = 0;
 
+namespace {
+
+// ZSTD level used for log entry batches, low levels are fast enough to compress on the append path.
+constexpr int kZstdCompressionLevel = 1;
+
+Status CompressEntryBatch(
+    LogCompressionCodecPB codec, const Slice& data, faststring* out) {
+  out->clear();
+  uint8_t size_buf[5]; // Max length of varint32.
+  auto size_end = InlineEncodeVarint32(size_buf, data.size());
+  out->append(size_buf, size_end - size_buf);
+  const size_t prefix_size = out->size();
+
+  switch (codec) {
+    case LogCompressionCodecPB::LZ4_COMPRESSION: {
+      const int bound = LZ4_compressBound(data.size());
+      out->resize(prefix_size + bound);
+      const int compressed_size = LZ4_compress_default(
+          data.cdata(), reinterpret_cast<char*>(out->data() + prefix_size), data.size(), bound);
+      if (compressed_size <= 0) {
+        return STATUS_FORMAT(RuntimeError, "LZ4 failed to compress $0 bytes", data.size());
+      }
+      out->resize(prefix_size + compressed_size);
+      return Status::OK();
+    }
+    case LogCompressionCodecPB::ZSTD_COMPRESSION: {
+#ifdef ZSTD
+      const size_t bound = ZSTD_compressBound(data.size());
+      out->resize(prefix_size + bound);
+      const size_t compressed_size = ZSTD_compress(
+          out->data() + prefix_size, bound, data.data(), data.size(), kZstdCompressionLevel);
+      if (ZSTD_isError(compressed_size)) {
+        return STATUS_FORMAT(
+            RuntimeError, "ZSTD failed to compress $0 bytes: $1", data.size(),
+            ZSTD_getErrorName(compressed_size));
+      }
+      out->resize(prefix_size + compressed_size);
+      return Status::OK();
+#else
+      return STATUS(NotSupported, "Built without ZSTD support");
+#endif
+    }
+    case LogCompressionCodecPB::NO_COMPRESSION:
+      break;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unexpected log compression codec: $0", codec);
+}
+
+Status UncompressEntryBatch(
+    LogCompressionCodecPB codec, const Slice& data, faststring* out) {
+  uint32_t uncompressed_size = 0;
+  auto compressed_start = GetVarint32Ptr(data.data(), data.end(), &uncompressed_size);
+  if (compressed_start == nullptr) {
+    return STATUS(Corruption, "Failed to decode uncompressed size of log entry batch");
+  }
+  const size_t compressed_size = data.end() - compressed_start;
+  out->resize(uncompressed_size);
+
+  switch (codec) {
+    case LogCompressionCodecPB::LZ4_COMPRESSION: {
+      const int decompressed_size = LZ4_decompress_safe(
+          reinterpret_cast<const char*>(compressed_start), reinterpret_cast<char*>(out->data()),
+          compressed_size, uncompressed_size);
+      if (decompressed_size < 0 || static_cast<uint32_t>(decompressed_size) != uncompressed_size) {
+        return STATUS_FORMAT(
+            Corruption, "LZ4 failed to uncompress log entry batch: $0 bytes instead of $1",
+            decompressed_size, uncompressed_size);
+      }
+      return Status::OK();
+    }
+    case LogCompressionCodecPB::ZSTD_COMPRESSION: {
+#ifdef ZSTD
+      const size_t decompressed_size = ZSTD_decompress(
+          out->data(), uncompressed_size, compressed_start, compressed_size);
+      if (ZSTD_isError(decompressed_size) || decompressed_size != uncompressed_size) {
+        return STATUS_FORMAT(
+            Corruption, "ZSTD failed to uncompress log entry batch of $0 bytes", uncompressed_size);
+      }
+      return Status::OK();
+#else
+      return STATUS(NotSupported, "Built without ZSTD support");
+#endif
+    }
+    case LogCompressionCodecPB::NO_COMPRESSION:
+      break;
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unexpected log compression codec: $0", codec);
+}
+
+} // namespace
+
+Result<LogCompressionCodecPB> LogCompressionCodecFromString(const std::string& name) {
+  if (name == "none") {
+    return LogCompressionCodecPB::NO_COMPRESSION;
+  }
+  if (name == "lz4") {
+    return LogCompressionCodecPB::LZ4_COMPRESSION;
+  }
+  if (name == "zstd") {
+#ifdef ZSTD
+    return LogCompressionCodecPB::ZSTD_COMPRESSION;
+#else
+    return STATUS(NotSupported, "Built without ZSTD support");
+#endif
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown log compression codec: $0", name);
+}
+
 // Maximum log segment header/footer size, in bytes (8 MB).
 const uint32_t kLogSegmentMaxHeaderOrFooterSize = 8 * 1024 * 1024;
 
@@ -135,6 +255,7 @@ LogOptions::LogOptions()
                                      MonoDelta::FromMilliseconds(
                                          FLAGS_interval_durable_wal_write_ms) : MonoDelta()),
       bytes_durable_wal_write_mb(FLAGS_bytes_durable_wal_write_mb),
+      group_sync(FLAGS_log_group_sync),
       preallocate_segments(FLAGS_log_preallocate_segments),
       async_preallocate_segments(FLAGS_log_async_preallocate_segments),
       env(Env::Default()) {
@@ -733,10 +854,18 @@ Status ReadableLogSegment::ReadEntryBatch(int64_t *offset,
   }
 
 
+  Slice batch_data = entry_batch_slice;
+  faststring uncompressed_buf;
+  if (header_.compression_codec() != LogCompressionCodecPB::NO_COMPRESSION) {
+    RETURN_NOT_OK_PREPEND(
+        UncompressEntryBatch(header_.compression_codec(), entry_batch_slice, &uncompressed_buf),
+        Substitute("Could not uncompress entry in byte range $0-$1",
+                   *offset, *offset + header.msg_length));
+    batch_data = Slice(uncompressed_buf.data(), uncompressed_buf.size());
+  }
+
   LogEntryBatchPB read_entry_batch;
-  s = pb_util::ParseFromArray(&read_entry_batch,
-                              entry_batch_slice.data(),
-                              header.msg_length);
+  s = pb_util::ParseFromArray(&read_entry_batch, batch_data.data(), batch_data.size());
 
   if (!s.ok()) return STATUS(Corruption, Substitute("Could parse PB. Cause: $0",
                                                     s.ToString()));
@@ -807,9 +936,14 @@ Status WritableLogSegment::WriteFooterAndClose(const LogSegmentFooterPB& footer)
 }
 
 
-Status WritableLogSegment::WriteEntryBatch(const Slice& data) {
+Status WritableLogSegment::WriteEntryBatch(const Slice& entry_batch_data) {
   DCHECK(is_header_written_);
   DCHECK(!is_footer_written_);
+  Slice data = entry_batch_data;
+  if (header_.compression_codec() != LogCompressionCodecPB::NO_COMPRESSION) {
+    RETURN_NOT_OK(CompressEntryBatch(header_.compression_codec(), data, &compressed_buffer_));
+    data = Slice(compressed_buffer_.data(), compressed_buffer_.size());
+  }
   uint8_t header_buf[kEntryHeaderSize];
 
   // First encode the length of the message.
@@ -48,9 +48,11 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/util/atomic.h"
 #include "yb/util/env.h"
+#include "yb/util/faststring.h"
 #include "yb/util/monotime.h"
 #include "yb/util/opid.h"
 #include "yb/util/restart_safe_clock.h"
+#include "yb/util/result.h"
 
 // Used by other classes, now part of the API.
 DECLARE_bool(durable_wal_write);
@@ -60,6 +62,8 @@ DECLARE_string(fs_data_dirs);
 
 namespace yb {
 
+class IoScheduler;
+
 namespace consensus {
 class ReplicateMsg;
 struct OpIdBiggerThanFunctor;
@@ -77,6 +81,9 @@ extern const size_t kEntryHeaderSize;
 extern const int kLogMajorVersion;
 extern const int kLogMinorVersion;
 
+// Returns the log compression codec with the specified name: none, lz4 or zstd.
+Result<LogCompressionCodecPB> LogCompressionCodecFromString(const std::string& name);
+
 class ReadableLogSegment;
 
 // Options for the State Machine/Write Ahead Log
@@ -95,6 +102,9 @@ struct LogOptions {
   // If non-zero, call fsync on a call to Append() if more than given amount of data to sync.
   int32_t bytes_durable_wal_write_mb;
 
+  // Whether to make the log durable using the LogSyncGroup of its file system.
+  bool group_sync;
+
   // Whether to fallocate segments before writing to them.
   bool preallocate_segments;
 
@@ -106,6 +116,10 @@ struct LogOptions {
 
   std::string peer_uuid;
 
+  // Scheduler of the disk of the log, charged with appends and told the latency of syncs, when
+  // not null.
+  std::shared_ptr<IoScheduler> io_scheduler;
+
   LogOptions();
 };
 
@@ -384,6 +398,12 @@ class WritableLogSegment {
     return writable_file_->Sync();
   }
 
+  // Passes the data buffered by the underlying writable file to the kernel, without waiting for it
+  // to become durable.
+  CHECKED_STATUS Flush() {
+    return writable_file_->Flush(WritableFile::FLUSH_ASYNC);
+  }
+
   // Returns true if the segment header has already been written to disk.
   bool IsHeaderWritten() const {
     return is_header_written_;
@@ -428,6 +448,9 @@ class WritableLogSegment {
   // The writable file to which this LogSegment will be written.
   const std::shared_ptr<WritableFile> writable_file_;
 
+  // Buffer for entry batches compressed using the codec specified by the header.
+  faststring compressed_buffer_;
+
   bool is_header_written_;
 
   bool is_footer_written_;
@@ -0,0 +1,171 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/consensus/multi_raft_batcher.h"
+
+#include <map>
+
+#include "yb/rpc/messenger.h"
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+
+using namespace std::literals;
+
+DEFINE_int32(multi_raft_heartbeat_window_ms, 10,
+             "Heartbeats sent to the same tablet server within this window are coalesced into a "
+             "single RPC, when enable_multi_raft_heartbeat_batcher is set.");
+TAG_FLAG(multi_raft_heartbeat_window_ms, advanced);
+TAG_FLAG(multi_raft_heartbeat_window_ms, runtime);
+
+DEFINE_int32(multi_raft_batch_size, 512,
+             "Max number of heartbeats coalesced into a single RPC.");
+TAG_FLAG(multi_raft_batch_size, advanced);
+TAG_FLAG(multi_raft_batch_size, runtime);
+
+DECLARE_int32(consensus_rpc_timeout_ms);
+
+namespace yb {
+namespace consensus {
+
+struct MultiRaftHeartbeatBatcher::Batch {
+  MultiRaftConsensusRequestPB request;
+  MultiRaftConsensusResponsePB response;
+  rpc::RpcController controller;
+  std::vector<Entry> entries;
+};
+
+std::shared_ptr<MultiRaftHeartbeatBatcher> MultiRaftHeartbeatBatcher::ForDestination(
+    rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport) {
+  typedef std::pair<rpc::ProxyCache*, HostPort> Key;
+  static std::mutex mutex;
+  static std::map<Key, std::weak_ptr<MultiRaftHeartbeatBatcher>> batchers;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& weak_batcher = batchers[Key(proxy_cache, hostport)];
+  auto result = weak_batcher.lock();
+  if (!result) {
+    for (auto it = batchers.begin(); it != batchers.end();) {
+      if (it->second.expired() && &it->second != &weak_batcher) {
+        it = batchers.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    result = std::make_shared<MultiRaftHeartbeatBatcher>(messenger, proxy_cache, hostport);
+    weak_batcher = result;
+  }
+  return result;
+}
+
+MultiRaftHeartbeatBatcher::MultiRaftHeartbeatBatcher(
+    rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport)
+    : messenger_(messenger), hostport_(hostport), proxy_(proxy_cache, hostport) {
+}
+
+MultiRaftHeartbeatBatcher::~MultiRaftHeartbeatBatcher() {
+  // Pending flushes hold a reference to the batcher, so there is nothing left to send.
+  DCHECK(entries_.empty());
+}
+
+void MultiRaftHeartbeatBatcher::AddRequest(const ConsensusRequestPB* request,
+                                           ConsensusResponsePB* response,
+                                           rpc::RpcController* controller,
+                                           rpc::ResponseCallback callback) {
+  std::vector<Entry> full_batch;
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(Entry{request, response, controller, std::move(callback)});
+    if (entries_.size() >= static_cast<size_t>(std::max(FLAGS_multi_raft_batch_size, 1))) {
+      full_batch.swap(entries_);
+    } else if (!flush_scheduled_) {
+      flush_scheduled_ = schedule_flush = true;
+    }
+  }
+
+  if (!full_batch.empty()) {
+    SendBatch(std::move(full_batch));
+  }
+
+  if (schedule_flush) {
+    // If the messenger is shutting down, the task is aborted, and the heartbeats are sent
+    // anyway, so their callbacks are invoked.
+    messenger_->scheduler().Schedule(
+        [self = shared_from_this()](const Status& status) { self->Flush(); },
+        FLAGS_multi_raft_heartbeat_window_ms * 1ms);
+  }
+}
+
+void MultiRaftHeartbeatBatcher::Flush() {
+  std::vector<Entry> entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_scheduled_ = false;
+    entries.swap(entries_);
+  }
+  if (!entries.empty()) {
+    SendBatch(std::move(entries));
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendBatch(std::vector<Entry> entries) {
+  if (entries.size() == 1) {
+    SendSeparately(&entries.front());
+    return;
+  }
+
+  auto batch = std::make_shared<Batch>();
+  batch->entries = std::move(entries);
+  batch->request.set_dest_uuid(batch->entries.front().request->dest_uuid());
+  for (const auto& entry : batch->entries) {
+    batch->request.add_consensus_request()->CopyFrom(*entry.request);
+  }
+  batch->controller.set_timeout(FLAGS_consensus_rpc_timeout_ms * 1ms);
+  proxy_.MultiRaftUpdateConsensusAsync(
+      batch->request, &batch->response, &batch->controller,
+      [self = shared_from_this(), batch] { self->BatchDone(batch); });
+}
+
+void MultiRaftHeartbeatBatcher::BatchDone(const std::shared_ptr<Batch>& batch) {
+  auto& responses = *batch->response.mutable_consensus_response();
+  if (!batch->controller.status().ok() || batch->response.has_error() ||
+      responses.size() != static_cast<int>(batch->entries.size())) {
+    YB_LOG_EVERY_N_SECS(WARNING, 10)
+        << "Failed to send " << batch->entries.size() << " heartbeats to "
+        << hostport_ << " in a single RPC: "
+        << (batch->controller.status().ok() ? batch->response.ShortDebugString()
+                                            : batch->controller.status().ToString())
+        << ", sending them separately";
+    for (auto& entry : batch->entries) {
+      SendSeparately(&entry);
+    }
+    return;
+  }
+
+  for (size_t i = 0; i != batch->entries.size(); ++i) {
+    auto& entry = batch->entries[i];
+    entry.response->Swap(responses.Mutable(i));
+    entry.callback();
+  }
+}
+
+void MultiRaftHeartbeatBatcher::SendSeparately(Entry* entry) {
+  entry->controller->set_timeout(FLAGS_consensus_rpc_timeout_ms * 1ms);
+  proxy_.UpdateConsensusAsync(
+      *entry->request, entry->response, entry->controller, std::move(entry->callback));
+}
+
+}  // namespace consensus
+}  // namespace yb
@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+#define YB_CONSENSUS_MULTI_RAFT_BATCHER_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "yb/consensus/consensus.pb.h"
+#include "yb/consensus/consensus.proxy.h"
+
+#include "yb/rpc/response_callback.h"
+#include "yb/rpc/rpc_fwd.h"
+
+#include "yb/util/net/net_util.h"
+
+namespace yb {
+namespace consensus {
+
+// Coalesces heartbeats of all tablets that are sent by this server to the same tablet server into
+// a single MultiRaftUpdateConsensus RPC. Heartbeats added within
+// FLAGS_multi_raft_heartbeat_window_ms of the first one are sent together.
+//
+// If the batch RPC fails, for instance because the remote server does not support it, heartbeats
+// of the batch are resent as regular UpdateConsensus RPCs.
+class MultiRaftHeartbeatBatcher : public std::enable_shared_from_this<MultiRaftHeartbeatBatcher> {
+ public:
+  // Returns the batcher for heartbeats sent to hostport, creating it if necessary.
+  static std::shared_ptr<MultiRaftHeartbeatBatcher> ForDestination(
+      rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport);
+
+  MultiRaftHeartbeatBatcher(
+      rpc::Messenger* messenger, rpc::ProxyCache* proxy_cache, const HostPort& hostport);
+
+  ~MultiRaftHeartbeatBatcher();
+
+  MultiRaftHeartbeatBatcher(const MultiRaftHeartbeatBatcher&) = delete;
+  void operator=(const MultiRaftHeartbeatBatcher&) = delete;
+
+  // Adds a heartbeat to the current batch. Has the same contract as PeerProxy::UpdateAsync: the
+  // request should stay valid until callback is invoked.
+  void AddRequest(const ConsensusRequestPB* request,
+                  ConsensusResponsePB* response,
+                  rpc::RpcController* controller,
+                  rpc::ResponseCallback callback);
+
+ private:
+  struct Entry {
+    const ConsensusRequestPB* request;
+    ConsensusResponsePB* response;
+    rpc::RpcController* controller;
+    rpc::ResponseCallback callback;
+  };
+
+  struct Batch;
+
+  void Flush();
+  void SendBatch(std::vector<Entry> entries);
+  void BatchDone(const std::shared_ptr<Batch>& batch);
+  void SendSeparately(Entry* entry);
+
+  rpc::Messenger* const messenger_;
+  const HostPort hostport_;
+  ConsensusServiceProxy proxy_;
+
+  std::mutex mutex_;
+  std::vector<Entry> entries_;
+  bool flush_scheduled_ = false;
+};
+
+}  // namespace consensus
+}  // namespace yb
+
+#endif // YB_CONSENSUS_MULTI_RAFT_BATCHER_H
@@ -237,7 +237,8 @@ shared_ptr<RaftConsensus> RaftConsensus::Create(
                            local_peer_pb,
                            options.tablet_id,
                            clock,
-                           raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL)));
+                           raft_pool->NewToken(ThreadPool::ExecutionMode::SERIAL),
+                           raft_pool->NewToken(ThreadPool::ExecutionMode::CONCURRENT)));
 
   DCHECK(local_peer_pb.has_permanent_uuid());
   const string& peer_uuid = local_peer_pb.permanent_uuid();
@@ -1090,6 +1091,10 @@ void RaftConsensus::NotifyTermChange(int64_t term) {
   WARN_NOT_OK(HandleTermAdvanceUnlocked(term), "Couldn't advance consensus term.");
 }
 
+void RaftConsensus::NotifyOperationsRead(const std::string& peer_uuid) {
+  peer_manager_->SignalRequest(RequestTriggerMode::kNonEmptyOnly);
+}
+
 void RaftConsensus::NotifyFailedFollower(const string& uuid,
                                          int64_t term,
                                          const std::string& reason) {
@@ -1154,6 +1159,16 @@ Status RaftConsensus::Update(ConsensusRequestPB* request,
                                 "is set to true.");
   }
 
+  // Operations serialized by the leader log cache are processed the same way as regular ones.
+  for (int i = 0; i != request->serialized_ops_size(); ++i) {
+    if (!request->add_ops()->ParseFromString(request->serialized_ops(i))) {
+      return STATUS_FORMAT(
+          Corruption, "Failed to parse serialized operation $0 of $1",
+          i, request->serialized_ops_size());
+    }
+  }
+  request->clear_serialized_ops();
+
   auto reject_mode = reject_mode_.load(std::memory_order_acquire);
   if (reject_mode != RejectMode::kNone) {
     if (reject_mode == RejectMode::kAll ||
@@ -2950,6 +2965,17 @@ uint64_t RaftConsensus::OnDiskSize() const {
   return state_->OnDiskSize();
 }
 
+Status RaftConsensus::ReadReplicatedMessagesForCDC(
+    int64_t after_op_index, int max_size_bytes, ReplicateMsgs* msgs, bool* have_more_messages) {
+  int64_t committed_index;
+  {
+    auto lock = state_->LockForRead();
+    committed_index = state_->GetCommittedOpIdUnlocked().index;
+  }
+  return queue_->ReadCommittedMessages(
+      after_op_index, committed_index, max_size_bytes, msgs, have_more_messages);
+}
+
 yb::OpId RaftConsensus::WaitForSafeOpIdToApply(const yb::OpId& op_id) {
   return log_->WaitForSafeOpIdToApply(op_id);
 }
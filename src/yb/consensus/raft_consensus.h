@@ -215,8 +215,14 @@ class RaftConsensus : public std::enable_shared_from_this<RaftConsensus>,
                             int64_t term,
                             const std::string& reason) override;
 
+  void NotifyOperationsRead(const std::string& peer_uuid) override;
+
   CHECKED_STATUS GetLastOpId(OpIdType type, OpId* id) override;
 
+  CHECKED_STATUS ReadReplicatedMessagesForCDC(
+      int64_t after_op_index, int max_size_bytes, ReplicateMsgs* msgs,
+      bool* have_more_messages) override;
+
   MicrosTime MajorityReplicatedHtLeaseExpiration(
       MicrosTime min_allowed, CoarseTimePoint deadline) const override;
 
@@ -841,6 +841,7 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
     max_allowed_op_id.index = std::numeric_limits<int64_t>::max();
   }
   auto leader_term = GetLeaderStateUnlocked().term;
+  bool apply_group_started = false;
 
   while (!pending_operations_.empty()) {
     auto round = pending_operations_.front();
@@ -864,11 +865,23 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
             << prev_id << " of " << committed_op_id;
         break;
       }
-    } else if (current_id.index > max_allowed_op_id.index ||
-               current_id.term > max_allowed_op_id.term) {
-      max_allowed_op_id = safe_op_id_waiter_->WaitForSafeOpIdToApply(current_id);
-      DCHECK_GE(max_allowed_op_id.index, current_id.index);
-      DCHECK_GE(max_allowed_op_id.term, current_id.term);
+      if (!apply_group_started) {
+        operation_factory_->StartApplyGroup();
+        apply_group_started = true;
+      }
+    } else {
+      // Other operations could depend on the state of the DB, so writes applied before them
+      // should be completed.
+      if (apply_group_started) {
+        operation_factory_->FinishApplyGroup();
+        apply_group_started = false;
+      }
+      if (current_id.index > max_allowed_op_id.index ||
+          current_id.term > max_allowed_op_id.term) {
+        max_allowed_op_id = safe_op_id_waiter_->WaitForSafeOpIdToApply(current_id);
+        DCHECK_GE(max_allowed_op_id.index, current_id.index);
+        DCHECK_GE(max_allowed_op_id.term, current_id.term);
+      }
     }
 
     pending_operations_.pop_front();
@@ -881,6 +894,10 @@ Status ReplicaState::ApplyPendingOperationsUnlocked(
     NotifyReplicationFinishedUnlocked(round, Status::OK(), leader_term);
   }
 
+  if (apply_group_started) {
+    operation_factory_->FinishApplyGroup();
+  }
+
   SetLastCommittedIndexUnlocked(prev_id);
 
   return Status::OK();
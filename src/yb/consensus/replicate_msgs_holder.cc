@@ -18,19 +18,31 @@ namespace consensus {
 
 ReplicateMsgsHolder::ReplicateMsgsHolder(
     google::protobuf::RepeatedPtrField<ReplicateMsg>* ops, ReplicateMsgs messages)
-    : ops_(ops), messages_(std::move(messages)) {
+    : ops_(ops), serialized_ops_(nullptr), messages_(std::move(messages)) {
+}
+
+ReplicateMsgsHolder::ReplicateMsgsHolder(
+    google::protobuf::RepeatedPtrField<std::string>* serialized_ops, ReplicateMsgs messages,
+    SerializedReplicateMsgs serialized)
+    : ops_(nullptr), serialized_ops_(serialized_ops), messages_(std::move(messages)),
+      serialized_(std::move(serialized)) {
 }
 
 ReplicateMsgsHolder::ReplicateMsgsHolder(ReplicateMsgsHolder&& rhs)
-    : ops_(rhs.ops_), messages_(std::move(rhs.messages_)) {
+    : ops_(rhs.ops_), serialized_ops_(rhs.serialized_ops_), messages_(std::move(rhs.messages_)),
+      serialized_(std::move(rhs.serialized_)) {
   rhs.ops_ = nullptr;
+  rhs.serialized_ops_ = nullptr;
 }
 
 void ReplicateMsgsHolder::operator=(ReplicateMsgsHolder&& rhs) {
   Reset();
   ops_ = rhs.ops_;
+  serialized_ops_ = rhs.serialized_ops_;
   messages_ = std::move(rhs.messages_);
+  serialized_ = std::move(rhs.serialized_);
   rhs.ops_ = nullptr;
+  rhs.serialized_ops_ = nullptr;
 }
 
 ReplicateMsgsHolder::~ReplicateMsgsHolder() {
@@ -42,8 +54,13 @@ void ReplicateMsgsHolder::Reset() {
     ops_->ExtractSubrange(0, ops_->size(), nullptr /* elements */);
     ops_ = nullptr;
   }
+  if (serialized_ops_) {
+    serialized_ops_->ExtractSubrange(0, serialized_ops_->size(), nullptr /* elements */);
+    serialized_ops_ = nullptr;
+  }
 
   messages_.clear();
+  serialized_.clear();
 }
 
 }  // namespace consensus
@@ -23,11 +23,16 @@ namespace consensus {
 
 class ReplicateMsgsHolder {
  public:
-  ReplicateMsgsHolder() : ops_(nullptr) {}
+  ReplicateMsgsHolder() : ops_(nullptr), serialized_ops_(nullptr) {}
 
   explicit ReplicateMsgsHolder(
       google::protobuf::RepeatedPtrField<ReplicateMsg>* ops, ReplicateMsgs messages);
 
+  // Holds serialized messages added to serialized_ops, in addition to the messages themselves.
+  ReplicateMsgsHolder(
+      google::protobuf::RepeatedPtrField<std::string>* serialized_ops, ReplicateMsgs messages,
+      SerializedReplicateMsgs serialized);
+
   ReplicateMsgsHolder(ReplicateMsgsHolder&& rhs);
   void operator=(ReplicateMsgsHolder&& rhs);
 
@@ -41,16 +46,19 @@ class ReplicateMsgsHolder {
 
   void ReleaseOps() {
     ops_ = nullptr;
+    serialized_ops_ = nullptr;
   }
 
  private:
   google::protobuf::RepeatedPtrField<ReplicateMsg>* ops_;
+  google::protobuf::RepeatedPtrField<std::string>* serialized_ops_;
 
   // Reference-counted pointers to any ReplicateMsgs which are in-flight to the peer. We may have
   // loaded these messages from the LogCache, in which case we are potentially sharing the same
   // object as other peers. Since the PB request_ itself can't hold reference counts, this holds
   // them.
   ReplicateMsgs messages_;
+  SerializedReplicateMsgs serialized_;
 };
 
 }  // namespace consensus
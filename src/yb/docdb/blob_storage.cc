@@ -0,0 +1,458 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/blob_storage.h"
+
+#include <inttypes.h>
+
+#include <unordered_map>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "yb/docdb/value.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/table_properties.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/crc32c.h"
+
+#include "yb/util/fast_varint.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(docdb_blob_value_threshold_bytes, 0,
+             "Compactions of the regular DB move values of at least this size to separate blob "
+             "files, so SST files only keep references to them and later compactions do not "
+             "rewrite them. 0 disables moving of new values to blob files.");
+TAG_FLAG(docdb_blob_value_threshold_bytes, advanced);
+
+DEFINE_int64(docdb_blob_file_size_bytes, 256_MB,
+             "Size of a blob file after which a new blob file is started.");
+TAG_FLAG(docdb_blob_file_size_bytes, advanced);
+
+DEFINE_double(docdb_blob_gc_live_ratio, 0.5,
+              "Blobs of a blob file are relocated by compactions once the fraction of bytes of "
+              "the file referenced by live SST files drops below this value.");
+TAG_FLAG(docdb_blob_gc_live_ratio, advanced);
+
+namespace yb {
+namespace docdb {
+
+const char* const kBlobReferencesProperty = "yb.blob.references";
+
+namespace {
+
+// Each record is the masked crc32c of the value followed by the value itself.
+constexpr size_t kRecordHeaderSize = 4;
+
+const char* const kBlobFileSuffix = ".blob";
+const char* const kBlobDirName = "blobs";
+
+} // namespace
+
+void BlobReference::AppendEncoded(std::string* out) const {
+  util::FastAppendUnsignedVarIntToStr(file_number, out);
+  util::FastAppendUnsignedVarIntToStr(offset, out);
+  util::FastAppendUnsignedVarIntToStr(size, out);
+}
+
+Result<BlobReference> BlobReference::Decode(Slice* slice) {
+  BlobReference result;
+  result.file_number = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(slice));
+  result.offset = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(slice));
+  result.size = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(slice));
+  return result;
+}
+
+std::string BlobReference::ToString() const {
+  return Format("{ file_number: $0 offset: $1 size: $2 }", file_number, offset, size);
+}
+
+Result<bool> DecodeBlobReferenceValue(
+    const Slice& value, size_t* control_fields_size, BlobReference* reference) {
+  Value control_fields;
+  Slice slice = value;
+  RETURN_NOT_OK(control_fields.DecodeControlFields(&slice));
+  if (DecodeValueType(slice) != ValueType::kBlobReference) {
+    return false;
+  }
+  *control_fields_size = slice.data() - value.data();
+  slice.consume_byte();
+  *reference = VERIFY_RESULT(BlobReference::Decode(&slice));
+  return true;
+}
+
+struct BlobStorage::BlobFile {
+  uint64_t number;
+  std::string name;
+  std::unique_ptr<rocksdb::RandomAccessFile> reader;
+  uint64_t size = 0;
+};
+
+Result<std::shared_ptr<BlobStorage>> BlobStorage::Open(
+    rocksdb::Env* env, const std::string& dir) {
+  std::shared_ptr<BlobStorage> result(new BlobStorage(env, dir));
+  RETURN_NOT_OK(result->Init());
+  return result;
+}
+
+std::string BlobStorage::DirForDb(const std::string& db_dir) {
+  return db_dir + "/" + kBlobDirName;
+}
+
+BlobStorage::BlobStorage(rocksdb::Env* env, std::string dir) : env_(env), dir_(std::move(dir)) {
+}
+
+BlobStorage::~BlobStorage() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  WARN_NOT_OK(CloseActiveFile(), "Failed to close blob file");
+}
+
+Status BlobStorage::Init() {
+  RETURN_NOT_OK(env_->CreateDirIfMissing(dir_));
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env_->GetChildren(dir_, &children));
+  const rocksdb::EnvOptions env_options;
+  for (const auto& child : children) {
+    if (!boost::ends_with(child, kBlobFileSuffix)) {
+      continue;
+    }
+    uint64_t number;
+    if (sscanf(child.c_str(), "%" SCNu64, &number) != 1) {
+      continue;
+    }
+    auto file = std::make_shared<BlobFile>();
+    file->number = number;
+    file->name = FileName(number);
+    RETURN_NOT_OK(env_->GetFileSize(file->name, &file->size));
+    RETURN_NOT_OK(env_->NewRandomAccessFile(file->name, &file->reader, env_options));
+    files_.emplace(number, std::move(file));
+    next_file_number_ = std::max(next_file_number_, number + 1);
+  }
+  // Files left by a previous process are never appended, since they could end with a partial
+  // record.
+  return Status::OK();
+}
+
+std::string BlobStorage::FileName(uint64_t number) const {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "/%06" PRIu64 "%s", number, kBlobFileSuffix);
+  return dir_ + buf;
+}
+
+size_t BlobStorage::value_threshold() const {
+  return std::max<int64_t>(FLAGS_docdb_blob_value_threshold_bytes, 0);
+}
+
+Result<BlobReference> BlobStorage::Append(const Slice& value) {
+  const size_t record_size = kRecordHeaderSize + value.size();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!writer_ || active_file_->size + record_size > FLAGS_docdb_blob_file_size_bytes) {
+    RETURN_NOT_OK(RollFile());
+  }
+
+  char header[kRecordHeaderSize];
+  rocksdb::EncodeFixed32(
+      header, rocksdb::crc32c::Mask(rocksdb::crc32c::Value(value.cdata(), value.size())));
+  Status s = writer_->Append(Slice(header, sizeof(header)));
+  if (s.ok()) {
+    s = writer_->Append(value);
+  }
+  if (!s.ok()) {
+    // The file may end with a partial record now, so stop appending to it.
+    WARN_NOT_OK(CloseActiveFile(), "Failed to close blob file");
+    return s;
+  }
+
+  BlobReference result;
+  result.file_number = active_file_->number;
+  result.offset = active_file_->size;
+  result.size = value.size();
+  active_file_->size += record_size;
+  return result;
+}
+
+Status BlobStorage::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return CloseActiveFile();
+}
+
+Status BlobStorage::Read(const BlobReference& reference, std::string* value) const {
+  BlobFilePtr file;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = files_.find(reference.file_number);
+    if (it == files_.end()) {
+      for (const auto& deleted_file : deleted_files_) {
+        if (deleted_file->number == reference.file_number) {
+          file = deleted_file;
+          break;
+        }
+      }
+    } else {
+      file = it->second;
+    }
+  }
+  if (!file) {
+    return STATUS_FORMAT(Corruption, "Missing blob file for $0", reference);
+  }
+
+  const size_t record_size = kRecordHeaderSize + reference.size;
+  std::unique_ptr<char[]> scratch(new char[record_size]);
+  Slice record;
+  RETURN_NOT_OK(file->reader->Read(reference.offset, record_size, &record, scratch.get()));
+  if (record.size() != record_size) {
+    return STATUS_FORMAT(Corruption, "Truncated blob $0 in $1", reference, file->name);
+  }
+  const uint32_t expected_crc = rocksdb::crc32c::Unmask(rocksdb::DecodeFixed32(record.cdata()));
+  record.remove_prefix(kRecordHeaderSize);
+  if (rocksdb::crc32c::Value(record.cdata(), record.size()) != expected_crc) {
+    return STATUS_FORMAT(Corruption, "Checksum mismatch for blob $0 in $1", reference, file->name);
+  }
+  value->assign(record.cdata(), record.size());
+  return Status::OK();
+}
+
+bool BlobStorage::ShouldRelocate(uint64_t file_number) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return relocate_.count(file_number) != 0;
+}
+
+Status BlobStorage::CreateCheckpoint(const std::string& dir) {
+  RETURN_NOT_OK(env_->CreateDirIfMissing(dir));
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (writer_) {
+    RETURN_NOT_OK(writer_->Sync());
+  }
+  for (const auto& p : files_) {
+    const auto& name = p.second->name;
+    RETURN_NOT_OK(env_->LinkFile(name, dir + name.substr(dir_.size())));
+  }
+  return Status::OK();
+}
+
+Status BlobStorage::RollFile() {
+  RETURN_NOT_OK(CloseActiveFile());
+
+  auto file = std::make_shared<BlobFile>();
+  file->number = next_file_number_++;
+  file->name = FileName(file->number);
+  const rocksdb::EnvOptions env_options;
+  RETURN_NOT_OK(env_->NewWritableFile(file->name, &writer_, env_options));
+  Status s = env_->NewRandomAccessFile(file->name, &file->reader, env_options);
+  if (!s.ok()) {
+    WARN_NOT_OK(writer_->Close(), "Failed to close " + file->name);
+    writer_.reset();
+    WARN_NOT_OK(env_->DeleteFile(file->name), "Failed to delete " + file->name);
+    return s;
+  }
+  files_.emplace(file->number, file);
+  active_file_ = std::move(file);
+  return Status::OK();
+}
+
+Status BlobStorage::CloseActiveFile() {
+  if (!writer_) {
+    return Status::OK();
+  }
+  Status s = writer_->Sync();
+  auto close_status = writer_->Close();
+  if (s.ok()) {
+    s = close_status;
+  }
+  writer_.reset();
+  active_file_.reset();
+  return s;
+}
+
+Status BlobStorage::CollectGarbage(
+    rocksdb::DB* db, const std::vector<std::string>& compaction_inputs) {
+  std::vector<uint64_t> candidates;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& p : files_) {
+      if (p.second != active_file_) {
+        candidates.push_back(p.first);
+      }
+    }
+  }
+
+  // Blob files written by concurrently running compactions are not referenced by live SST files
+  // until those compactions are installed, so files could only be deleted when the compaction
+  // that invoked this is the only running one. Files created after that are not candidates.
+  uint64_t running_compactions = 0;
+  const bool can_delete =
+      db->GetIntProperty(rocksdb::DB::Properties::kNumRunningCompactions, &running_compactions) &&
+      running_compactions <= 1;
+
+  rocksdb::TablePropertiesCollection props;
+  RETURN_NOT_OK(db->GetPropertiesOfAllTables(&props));
+  std::unordered_map<uint64_t, uint64_t> live_bytes;
+  for (const auto& p : props) {
+    const auto& user_props = p.second->user_collected_properties;
+    auto it = user_props.find(kBlobReferencesProperty);
+    if (it == user_props.end()) {
+      continue;
+    }
+    Slice encoded(it->second);
+    while (!encoded.empty()) {
+      auto file_number = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&encoded));
+      auto bytes = VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&encoded));
+      live_bytes[file_number] += bytes;
+    }
+  }
+
+  // SST files that are neither live nor inputs of the compaction that just completed belong to
+  // old versions, that could still be used by readers.
+  std::vector<std::string> children;
+  RETURN_NOT_OK(env_->GetChildren(db->GetName(), &children));
+  bool has_old_versions = false;
+  for (const auto& child : children) {
+    if (!boost::ends_with(child, ".sst")) {
+      continue;
+    }
+    const auto path = db->GetName() + "/" + child;
+    if (props.count(path) == 0 &&
+        std::find(compaction_inputs.begin(), compaction_inputs.end(), path) ==
+            compaction_inputs.end()) {
+      has_old_versions = true;
+      break;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Readers of old versions that could refer to the deleted files are gone.
+  if (!has_old_versions) {
+    deleted_files_.clear();
+  }
+  relocate_.clear();
+  for (auto number : candidates) {
+    auto it = files_.find(number);
+    if (it == files_.end()) {
+      continue;
+    }
+    auto live_it = live_bytes.find(number);
+    if (live_it == live_bytes.end()) {
+      if (!can_delete) {
+        continue;
+      }
+      // Inputs of the just completed compaction could still be used by readers, so the file is
+      // kept open until the next compaction finds no old versions.
+      LOG(INFO) << "Deleting unreferenced blob file " << it->second->name;
+      WARN_NOT_OK(env_->DeleteFile(it->second->name),
+                  "Failed to delete blob file " + it->second->name);
+      deleted_files_.push_back(std::move(it->second));
+      files_.erase(it);
+      continue;
+    }
+    if (live_it->second < it->second->size * FLAGS_docdb_blob_gc_live_ratio) {
+      relocate_.insert(number);
+    }
+  }
+  return Status::OK();
+}
+
+void BlobStorage::OnCompactionCompleted(
+    rocksdb::DB* db, const rocksdb::CompactionJobInfo& ci) {
+  if (!ci.status.ok()) {
+    return;
+  }
+  WARN_NOT_OK(CollectGarbage(db, ci.input_files), "Blob files garbage collection failed");
+}
+
+size_t BlobStorage::num_files() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return files_.size();
+}
+
+// ------------------------------------------------------------------------------------------------
+
+BlobResolvingIterator::BlobResolvingIterator(
+    std::unique_ptr<rocksdb::Iterator> iterator, BlobStorage* blob_storage)
+    : iterator_(std::move(iterator)), blob_storage_(blob_storage) {
+}
+
+bool BlobResolvingIterator::Valid() const {
+  return iterator_->Valid();
+}
+
+void BlobResolvingIterator::SeekToFirst() {
+  Reset();
+  iterator_->SeekToFirst();
+}
+
+void BlobResolvingIterator::SeekToLast() {
+  Reset();
+  iterator_->SeekToLast();
+}
+
+void BlobResolvingIterator::Seek(const Slice& target) {
+  Reset();
+  iterator_->Seek(target);
+}
+
+void BlobResolvingIterator::Next() {
+  Reset();
+  iterator_->Next();
+}
+
+void BlobResolvingIterator::Prev() {
+  Reset();
+  iterator_->Prev();
+}
+
+Slice BlobResolvingIterator::key() const {
+  return iterator_->key();
+}
+
+Slice BlobResolvingIterator::value() const {
+  if (!resolved_) {
+    resolved_ = true;
+    is_blob_ = false;
+    const auto raw_value = iterator_->value();
+    size_t control_fields_size = 0;
+    BlobReference reference;
+    auto is_blob = DecodeBlobReferenceValue(raw_value, &control_fields_size, &reference);
+    // Malformed values are returned as is, so the error is reported by the value decoding.
+    if (is_blob.ok() && *is_blob) {
+      is_blob_ = true;
+      std::string blob;
+      auto s = blob_storage_->Read(reference, &blob);
+      if (s.ok()) {
+        value_.assign(raw_value.cdata(), control_fields_size);
+        value_ += blob;
+      } else {
+        status_ = s;
+        value_.clear();
+      }
+    }
+  }
+  return is_blob_ ? Slice(value_) : iterator_->value();
+}
+
+Status BlobResolvingIterator::status() const {
+  if (!status_.ok()) {
+    return status_;
+  }
+  return iterator_->status();
+}
+
+Status BlobResolvingIterator::GetProperty(std::string prop_name, std::string* prop) {
+  return iterator_->GetProperty(std::move(prop_name), prop);
+}
+
+} // namespace docdb
+} // namespace yb
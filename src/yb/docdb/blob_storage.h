@@ -0,0 +1,171 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_BLOB_STORAGE_H
+#define YB_DOCDB_BLOB_STORAGE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/iterator.h"
+#include "yb/rocksdb/listener.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace docdb {
+
+// Name of the SST file property that contains the number of bytes referenced by the file in every
+// blob file, encoded as a sequence of varint pairs (blob file number, referenced bytes).
+extern const char* const kBlobReferencesProperty;
+
+// Location of the value stored in a blob file.
+struct BlobReference {
+  uint64_t file_number = 0;
+  uint64_t offset = 0;
+  uint64_t size = 0;
+
+  void AppendEncoded(std::string* out) const;
+  static Result<BlobReference> Decode(Slice* slice);
+
+  std::string ToString() const;
+};
+
+// If the encoded RocksDB value refers to a blob, returns the size of the value control fields
+// preceding the reference and fills reference.
+Result<bool> DecodeBlobReferenceValue(
+    const Slice& value, size_t* control_fields_size, BlobReference* reference);
+
+// Append-only storage of large regular DB values, located in the blobs subdirectory of the regular
+// DB. Compactions move large values to blob files, so that SST files only contain references to
+// them and later compactions do not rewrite the values again.
+//
+// Blob files are garbage collected using the kBlobReferencesProperty of live SST files after
+// every compaction: unreferenced files are deleted, while blobs from files with only a small
+// fraction of referenced bytes are relocated to the active blob file by following compactions.
+class BlobStorage : public rocksdb::EventListener {
+ public:
+  static Result<std::shared_ptr<BlobStorage>> Open(rocksdb::Env* env, const std::string& dir);
+
+  // Returns the blob storage directory of the regular DB located at db_dir.
+  static std::string DirForDb(const std::string& db_dir);
+
+  ~BlobStorage();
+
+  BlobStorage(const BlobStorage&) = delete;
+  void operator=(const BlobStorage&) = delete;
+
+  // Values with encoded size of at least this number of bytes are moved to blob files, 0 if
+  // compactions should not move new values to blob files.
+  size_t value_threshold() const;
+
+  // Appends the value to the active blob file.
+  Result<BlobReference> Append(const Slice& value);
+
+  // Makes all appended values durable and closes the active blob file. Invoked at the end of every
+  // compaction, so blob files are not shared with compactions that complete later, and could be
+  // garbage collected once the SST files referring to them are compacted away.
+  CHECKED_STATUS Flush();
+
+  CHECKED_STATUS Read(const BlobReference& reference, std::string* value) const;
+
+  // Whether blobs of the specified file should be moved to the active file by compactions.
+  bool ShouldRelocate(uint64_t file_number) const;
+
+  // Hard links all blob files to the specified directory.
+  CHECKED_STATUS CreateCheckpoint(const std::string& dir);
+
+  // Deletes blob files that are not referenced by the SST files of the db, and picks files that
+  // should be relocated. compaction_inputs are the files of the compaction that just completed.
+  CHECKED_STATUS CollectGarbage(
+      rocksdb::DB* db, const std::vector<std::string>& compaction_inputs);
+
+  void OnCompactionCompleted(rocksdb::DB* db, const rocksdb::CompactionJobInfo& ci) override;
+
+  size_t num_files() const;
+
+ private:
+  struct BlobFile;
+  typedef std::shared_ptr<BlobFile> BlobFilePtr;
+
+  BlobStorage(rocksdb::Env* env, std::string dir);
+
+  CHECKED_STATUS Init();
+
+  // Closes the active file and starts a new one.
+  CHECKED_STATUS RollFile();
+  CHECKED_STATUS CloseActiveFile();
+  std::string FileName(uint64_t number) const;
+
+  rocksdb::Env* const env_;
+  const std::string dir_;
+
+  mutable std::mutex mutex_;
+  std::map<uint64_t, BlobFilePtr> files_;
+  std::unique_ptr<rocksdb::WritableFile> writer_;
+  BlobFilePtr active_file_;
+  uint64_t next_file_number_ = 1;
+  std::unordered_set<uint64_t> relocate_;
+  // Files that were deleted from disk but are kept open, because readers of old RocksDB versions
+  // could still refer to them. Closed when no obsolete SST files remain.
+  std::vector<BlobFilePtr> deleted_files_;
+};
+
+// Iterator that replaces blob references in values of the regular DB with the values themselves.
+class BlobResolvingIterator : public rocksdb::Iterator {
+ public:
+  BlobResolvingIterator(std::unique_ptr<rocksdb::Iterator> iterator, BlobStorage* blob_storage);
+
+  bool Valid() const override;
+
+  void SeekToFirst() override;
+
+  void SeekToLast() override;
+
+  void Seek(const Slice& target) override;
+
+  void Next() override;
+
+  void Prev() override;
+
+  Slice key() const override;
+
+  Slice value() const override;
+
+  Status status() const override;
+
+  Status GetProperty(std::string prop_name, std::string* prop) override;
+
+ private:
+  void Reset() { resolved_ = false; }
+
+  std::unique_ptr<rocksdb::Iterator> iterator_;
+  BlobStorage* blob_storage_;
+
+  // State of the value at the current position, resolved lazily.
+  mutable bool resolved_ = false;
+  mutable bool is_blob_ = false;
+  mutable std::string value_;
+  mutable Status status_;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_BLOB_STORAGE_H
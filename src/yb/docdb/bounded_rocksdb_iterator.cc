@@ -0,0 +1,91 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/bounded_rocksdb_iterator.h"
+
+namespace yb {
+namespace docdb {
+
+BoundedRocksDbIterator::BoundedRocksDbIterator(
+    std::unique_ptr<rocksdb::Iterator> iterator, const KeyBounds* key_bounds)
+    : iterator_(std::move(iterator)), key_bounds_(key_bounds) {
+  DCHECK(key_bounds_);
+}
+
+bool BoundedRocksDbIterator::Valid() const {
+  return iterator_->Valid() && key_bounds_->IsWithinBounds(iterator_->key());
+}
+
+void BoundedRocksDbIterator::SeekToFirst() {
+  if (key_bounds_->lower.empty()) {
+    iterator_->SeekToFirst();
+  } else {
+    iterator_->Seek(key_bounds_->lower.AsSlice());
+  }
+}
+
+void BoundedRocksDbIterator::SeekToLast() {
+  if (key_bounds_->upper.empty()) {
+    iterator_->SeekToLast();
+    return;
+  }
+  iterator_->Seek(key_bounds_->upper.AsSlice());
+  if (iterator_->Valid()) {
+    iterator_->Prev();
+  } else {
+    iterator_->SeekToLast();
+  }
+}
+
+void BoundedRocksDbIterator::Seek(const Slice& target) {
+  if (!key_bounds_->lower.empty() && target.compare(key_bounds_->lower.AsSlice()) < 0) {
+    iterator_->Seek(key_bounds_->lower.AsSlice());
+  } else {
+    iterator_->Seek(target);
+  }
+}
+
+void BoundedRocksDbIterator::Next() {
+  iterator_->Next();
+}
+
+void BoundedRocksDbIterator::Prev() {
+  iterator_->Prev();
+}
+
+Slice BoundedRocksDbIterator::key() const {
+  return iterator_->key();
+}
+
+Slice BoundedRocksDbIterator::value() const {
+  return iterator_->value();
+}
+
+Status BoundedRocksDbIterator::status() const {
+  return iterator_->status();
+}
+
+Status BoundedRocksDbIterator::GetProperty(std::string prop_name, std::string* prop) {
+  return iterator_->GetProperty(std::move(prop_name), prop);
+}
+
+std::unique_ptr<rocksdb::Iterator> BoundIterator(
+    std::unique_ptr<rocksdb::Iterator> iterator, const KeyBounds* key_bounds) {
+  if (!key_bounds || !key_bounds->IsInitialized()) {
+    return iterator;
+  }
+  return std::make_unique<BoundedRocksDbIterator>(std::move(iterator), key_bounds);
+}
+
+} // namespace docdb
+} // namespace yb
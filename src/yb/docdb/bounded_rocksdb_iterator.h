@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_BOUNDED_ROCKSDB_ITERATOR_H
+#define YB_DOCDB_BOUNDED_ROCKSDB_ITERATOR_H
+
+#include <memory>
+
+#include "yb/docdb/doc_key.h"
+
+#include "yb/rocksdb/iterator.h"
+
+namespace yb {
+namespace docdb {
+
+// RocksDB iterator that only exposes keys within the specified key bounds. Used by tablets
+// produced by a split, whose RocksDB shares SST files with the sibling tablet.
+class BoundedRocksDbIterator : public rocksdb::Iterator {
+ public:
+  BoundedRocksDbIterator(
+      std::unique_ptr<rocksdb::Iterator> iterator, const KeyBounds* key_bounds);
+
+  bool Valid() const override;
+
+  void SeekToFirst() override;
+
+  void SeekToLast() override;
+
+  void Seek(const Slice& target) override;
+
+  void Next() override;
+
+  void Prev() override;
+
+  Slice key() const override;
+
+  Slice value() const override;
+
+  Status status() const override;
+
+  Status GetProperty(std::string prop_name, std::string* prop) override;
+
+ private:
+  std::unique_ptr<rocksdb::Iterator> iterator_;
+  const KeyBounds* key_bounds_;
+};
+
+// Wraps the iterator with BoundedRocksDbIterator if key_bounds are specified and initialized.
+std::unique_ptr<rocksdb::Iterator> BoundIterator(
+    std::unique_ptr<rocksdb::Iterator> iterator, const KeyBounds* key_bounds);
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_BOUNDED_ROCKSDB_ITERATOR_H
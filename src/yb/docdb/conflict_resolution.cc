@@ -22,6 +22,7 @@
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/range_tombstones.h"
 #include "yb/docdb/shared_lock_manager.h"
 
 #include "yb/util/countdown_latch.h"
@@ -276,12 +277,16 @@ class ConflictResolver {
     return Status::OK();
   }
 
+  // Statuses of all conflicting transactions are requested at once, so status manager could
+  // combine requests to the same status tablet.
   void FetchTransactionStatuses() {
     static const std::string kRequestReason = "conflict resolution"s;
     CountDownLatch latch(transactions_.size());
+    std::vector<StatusRequest> requests;
+    requests.reserve(transactions_.size());
     for (auto& i : transactions_) {
       auto& transaction = i;
-      StatusRequest request = {
+      requests.push_back(StatusRequest {
         &transaction.id,
         context_.GetResolutionHt(),
         context_.GetResolutionHt(),
@@ -302,9 +307,9 @@ class ConflictResolver {
           }
           latch.CountDown();
         }
-      };
-      status_manager().RequestStatusAt(request);
+      });
     }
+    status_manager().RequestStatusesAt(requests);
     latch.Wait();
   }
 
@@ -438,6 +443,16 @@ class TransactionConflictResolverContext : public ConflictResolverContext {
     if (strength == IntentStrength::kStrong && read_time_ != HybridTime::kMax) {
       Slice key_slice(intent_key_prefix->data());
 
+      if (resolver->doc_db().range_tombstones) {
+        for (const auto& tombstone : *resolver->doc_db().range_tombstones->Get()) {
+          if (tombstone.hybrid_time >= read_time_ && tombstone.Contains(key_slice)) {
+            conflicts_metric_->Increment();
+            return STATUS_FORMAT(TryAgain, "Range deletion after transaction start: $0 >= $1",
+                                 tombstone.hybrid_time, read_time_);
+          }
+        }
+      }
+
       // TODO(dtxn) reuse iterator
       auto value_iter = CreateRocksDBIterator(
           resolver->doc_db().regular,
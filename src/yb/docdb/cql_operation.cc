@@ -39,6 +39,7 @@ DEFINE_bool(ycql_consistent_transactional_paging, false,
             "page of results is never stale regardless of this flag.");
 
 DECLARE_bool(trace_docdb_calls);
+DECLARE_int32(docdb_scan_batch_size);
 
 namespace yb {
 namespace docdb {
@@ -1120,6 +1121,27 @@ Status QLReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   // Begin the normal fetch.
   int match_count = 0;
   bool static_dealt_with = true;
+
+  // Without static columns every row read is a regular row that is matched on its own, so rows
+  // can be fetched in batches. Every row adds at most one row to the result set, so bounding the
+  // batch by the remaining limit never reads past the row the paging state should point to.
+  if (!schema.has_statics() && !read_distinct_columns && FLAGS_docdb_scan_batch_size > 1) {
+    std::vector<QLTableRow::SharedPtr> rows;
+    while (resultset->rsrow_count() < row_count_limit) {
+      const size_t max_rows = std::min<size_t>(
+          FLAGS_docdb_scan_batch_size, row_count_limit - resultset->rsrow_count());
+      const size_t num_rows = VERIFY_RESULT(iter->NextBatch(
+          non_static_projection, max_rows, false /* include_tuple_id */, &rows));
+      for (size_t i = 0; i != num_rows; ++i) {
+        RETURN_NOT_OK(AddRowToResult(
+            spec, *rows[i], row_count_limit, offset, resultset, &match_count, &num_rows_skipped));
+      }
+      if (num_rows < max_rows) {
+        break;
+      }
+    }
+  }
+
   while (resultset->rsrow_count() < row_count_limit && VERIFY_RESULT(iter->HasNext())) {
     const bool last_read_static = iter->IsNextStaticColumn();
 
@@ -27,17 +27,29 @@ DEFINE_test_flag(bool, test_tserver_timeout, false,
 namespace yb {
 namespace docdb {
 
-DeadlineInfo::DeadlineInfo(CoarseTimePoint deadline) : deadline_(deadline) {}
+namespace {
 
-// Every 1024 iterations, check whether the deadline passed and if so, change deadline_passed_
-// before returning.
+thread_local const CancellationChecker* thread_cancellation_checker = nullptr;
+
+} // namespace
+
+DeadlineInfo::DeadlineInfo(CoarseTimePoint deadline) : deadline_(deadline) {
+  if (thread_cancellation_checker) {
+    cancellation_checker_ = *thread_cancellation_checker;
+  }
+}
+
+// Every 1024 iterations, check whether the deadline passed or the request was cancelled and if
+// so, change deadline_passed_ before returning.
 bool DeadlineInfo::CheckAndSetDeadlinePassed() {
   if (deadline_passed_) {
     return true;
   }
-  if ((PREDICT_FALSE(FLAGS_test_tserver_timeout) || (++counter_ & 1023) == 0)
-      && CoarseMonoClock::now() > deadline_) {
-    deadline_passed_ = true;
+  if (PREDICT_FALSE(FLAGS_test_tserver_timeout) || (++counter_ & 1023) == 0) {
+    if (CoarseMonoClock::now() > deadline_ ||
+        (cancellation_checker_ && cancellation_checker_())) {
+      deadline_passed_ = true;
+    }
   }
   return deadline_passed_;
 }
@@ -47,6 +59,15 @@ std::string DeadlineInfo::ToString() const {
                 CoarseMonoClock::now(), deadline_, counter_);
 }
 
+ScopedCancellationChecker::ScopedCancellationChecker(CancellationChecker checker)
+    : checker_(std::move(checker)), previous_(thread_cancellation_checker) {
+  thread_cancellation_checker = &checker_;
+}
+
+ScopedCancellationChecker::~ScopedCancellationChecker() {
+  thread_cancellation_checker = previous_;
+}
+
 void SimulateTimeoutIfTesting(CoarseTimePoint* deadline) {
   if (PREDICT_FALSE(FLAGS_test_tserver_timeout)) {
     *deadline = CoarseMonoClock::now() - 100ms;
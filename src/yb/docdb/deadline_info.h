@@ -14,11 +14,18 @@
 #ifndef YB_DOCDB_DEADLINE_INFO_H
 #define YB_DOCDB_DEADLINE_INFO_H
 
+#include <functional>
+
 #include "yb/util/monotime.h"
 
 namespace yb {
 namespace docdb {
 
+// Returns true when the request was cancelled, e.g. because its client disconnected.
+typedef std::function<bool()> CancellationChecker;
+
+// Periodically checks whether the deadline of the request passed, or the request was cancelled
+// according to the cancellation checker of the thread that created this object.
 class DeadlineInfo {
  public:
   explicit DeadlineInfo(CoarseTimePoint deadline);
@@ -27,10 +34,26 @@ class DeadlineInfo {
 
  private:
   CoarseTimePoint deadline_;
+  CancellationChecker cancellation_checker_;
   uint32_t counter_ = 0;
   bool deadline_passed_ = false;
 };
 
+// Sets the cancellation checker of the current thread for the lifetime of this object, so the
+// scans started by this thread stop when the request they serve is cancelled.
+class ScopedCancellationChecker {
+ public:
+  explicit ScopedCancellationChecker(CancellationChecker checker);
+  ~ScopedCancellationChecker();
+
+  ScopedCancellationChecker(const ScopedCancellationChecker&) = delete;
+  void operator=(const ScopedCancellationChecker&) = delete;
+
+ private:
+  CancellationChecker checker_;
+  const CancellationChecker* previous_;
+};
+
 // If test_tserver_timeout is true, set the deadline to now and sleep for 100ms to simulate a
 // tserver timeout.
 void SimulateTimeoutIfTesting(CoarseTimePoint* deadline);
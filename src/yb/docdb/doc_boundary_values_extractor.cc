@@ -161,6 +161,11 @@ class DocBoundaryValuesExtractor : public rocksdb::BoundaryValuesExtractor {
       // transaction.
       return Status::OK();
     }
+    if (user_key.size() >= 1 &&
+        static_cast<ValueType>(user_key[0]) == ValueType::kRangeTombstonePrefix) {
+      // Range tombstone records do not belong to any document.
+      return Status::OK();
+    }
 
     CHECK_NOTNULL(values);
     boost::container::small_vector<Slice, 20> slices;
@@ -256,5 +261,9 @@ rocksdb::UserBoundaryTag TagForRangeComponent(size_t index) {
   return PrimitiveBoundaryValue::TagForIndex(index);
 }
 
+rocksdb::UserBoundaryTag TagForDocHybridTime() {
+  return kDocHybridTimeTag;
+}
+
 } // namespace docdb
 } // namespace yb
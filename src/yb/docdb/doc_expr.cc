@@ -8,6 +8,7 @@
 
 #include "yb/docdb/subdocument.h"
 
+#include "yb/util/bfpg/tserver_opcodes.h"
 #include "yb/util/decimal.h"
 
 namespace yb {
@@ -16,6 +17,36 @@ namespace docdb {
 using yb::bfql::TSOpcode;
 using yb::util::Decimal;
 
+namespace {
+
+// Converts a YSQL value to the type of its SUM (see PgsqlSumType), so that it is summed and sent
+// back to Postgres as a value of the type of the aggregate.
+CHECKED_STATUS PromoteToPgsqlSumType(QLValue *value) {
+  if (value->IsNull()) {
+    return Status::OK();
+  }
+  switch (value->type()) {
+    case QLValue::InternalType::kInt16Value:
+      value->set_int64_value(value->int16_value());
+      return Status::OK();
+    case QLValue::InternalType::kInt32Value:
+      value->set_int64_value(value->int32_value());
+      return Status::OK();
+    case QLValue::InternalType::kInt64Value:
+      value->set_decimal_value(Decimal(util::VarInt(value->int64_value())).EncodeToComparable());
+      return Status::OK();
+    default:
+      break;
+  }
+  if (PgsqlSumType(value->type()) != value->type()) {
+    return STATUS_FORMAT(NotSupported, "Cannot find SUM of values of type $0",
+                         static_cast<int>(value->type()));
+  }
+  return Status::OK();
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 
 CHECKED_STATUS DocExprExecutor::EvalColumnRef(ColumnIdRep col_id,
@@ -32,8 +63,14 @@ CHECKED_STATUS DocExprExecutor::EvalColumnRef(ColumnIdRep col_id,
     return table_row->ReadColumn(col_id, result);
   }
 
-  // Read key of the given row.
+  // Read key of the given row. Rows read in batches carry their own key, otherwise it is taken
+  // from the current position of the iterator.
   if (col_id == static_cast<int>(PgSystemAttrNum::kYBTupleId)) {
+    const auto tuple_id = table_row->GetValue(col_id);
+    if (tuple_id) {
+      *result = *tuple_id;
+      return Status::OK();
+    }
     return GetTupleId(result);
   }
 
@@ -156,6 +193,57 @@ CHECKED_STATUS DocExprExecutor::EvalTSCall(const QLBCallPB& tscall,
 
 //--------------------------------------------------------------------------------------------------
 
+CHECKED_STATUS DocExprExecutor::EvalTSCall(const PgsqlBCallPB& tscall,
+                                           const QLTableRow::SharedPtrConst& table_row,
+                                           QLValue *result) {
+  bfpg::TSOpcode tsopcode = static_cast<bfpg::TSOpcode>(tscall.opcode());
+  switch (tsopcode) {
+    case bfpg::TSOpcode::kCount: {
+      // Postgres does not count NULL values of the argument. COUNT(*) is sent as a constant.
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      if (arg_result.IsNull()) {
+        if (result->IsNull()) {
+          result->set_int64_value(0);
+        }
+        return Status::OK();
+      }
+      return EvalCount(result);
+    }
+
+    case bfpg::TSOpcode::kSum: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      RETURN_NOT_OK(PromoteToPgsqlSumType(&arg_result));
+      return EvalSum(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kMin: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalMin(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kMax: {
+      QLValue arg_result;
+      RETURN_NOT_OK(EvalExpr(tscall.operands(0), table_row, &arg_result));
+      return EvalMax(arg_result, result);
+    }
+
+    case bfpg::TSOpcode::kAvg:
+      // The partial result of AVG could not be sent back in YSQL wire format. Postgres should
+      // request SUM and COUNT instead.
+      return STATUS(NotSupported, "AVG could not be evaluated by tablet server");
+
+    default:
+      break;
+  }
+
+  return QLExprExecutor::EvalTSCall(tscall, table_row, result);
+}
+
+//--------------------------------------------------------------------------------------------------
+
 CHECKED_STATUS DocExprExecutor::EvalCount(QLValue *aggr_count) {
   if (aggr_count->IsNull()) {
     aggr_count->set_int64_value(1);
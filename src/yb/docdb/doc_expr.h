@@ -36,6 +36,12 @@ class DocExprExecutor : public QLExprExecutor {
                                     const QLTableRow& table_row,
                                     QLValue *result) override;
 
+  // Evaluate call to tablet-server builtin operator of a YSQL expression. Only aggregate functions
+  // that produce mergeable partial results are supported.
+  virtual CHECKED_STATUS EvalTSCall(const PgsqlBCallPB& ql_expr,
+                                    const QLTableRow::SharedPtrConst& table_row,
+                                    QLValue *result) override;
+
   // Evaluate aggregate functions for each row.
   CHECKED_STATUS EvalCount(QLValue *aggr_count);
   CHECKED_STATUS EvalSum(const QLValue& val, QLValue *aggr_sum);
@@ -348,6 +348,58 @@ TEST(DocKeyTest, TestKeyMatching) {
   ASSERT_FALSE(may_match(EncodeSimpleSubDocKey(absent_key))) << "Key: " << absent_key;
 }
 
+TEST(DocKeyTest, TestRangePrefixKeyMatching) {
+  DocDbAwareFilterPolicy policy(
+      rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr, 1 /* num_range_components */);
+  DocDbAwareFilterPolicy hashed_policy(rocksdb::FilterPolicy::kDefaultFixedSizeFilterBits, nullptr);
+  ASSERT_STRNE(hashed_policy.Name(), policy.Name());
+
+  auto encode = [](const std::string& range1, const std::string& range2) {
+    return SubDocKey(
+        DocKey(0x1234, {PrimitiveValue("h")}, {PrimitiveValue(range1), PrimitiveValue(range2)}),
+        PrimitiveValue("c"), HybridTime::FromMicros(1000)).Encode().data();
+  };
+
+  std::unique_ptr<FilterBitsBuilder> builder(policy.GetFilterBitsBuilder());
+  ASSERT_NE(builder, nullptr);
+  for (const auto& range1 : {"a", "b", "c"}) {
+    builder->AddKey(policy.GetKeyTransformer()->Transform(encode(range1, "x")));
+  }
+  std::unique_ptr<const char[]> buf;
+  rocksdb::Slice filter = builder->Finish(&buf);
+  std::unique_ptr<FilterBitsReader> reader(policy.GetFilterBitsReader(filter));
+
+  auto may_match = [&](const std::string& key) {
+    return reader->MayMatch(policy.GetKeyTransformer()->Transform(key));
+  };
+
+  ASSERT_TRUE(may_match(encode("a", "x")));
+  // Only the first range component is used for filtering.
+  ASSERT_TRUE(may_match(encode("b", "y")));
+  ASSERT_FALSE(may_match(encode("d", "x")));
+
+  size_t num_decoded = 0;
+  auto key = DocKey(0x1234, {PrimitiveValue("h")}, {}).Encode();
+  auto hashed_size = ASSERT_RESULT(
+      DocKey::EncodedSize(key.AsSlice(), DocKeyPart::HASHED_PART_ONLY));
+  ASSERT_EQ(hashed_size, ASSERT_RESULT(EncodedHashAndRangePrefixSize(
+      key.AsSlice(), 1 /* num_range_components */, &num_decoded)));
+  ASSERT_EQ(0, num_decoded);
+
+  key = DocKey(0x1234, {PrimitiveValue("h")}, {PrimitiveValue("a"), PrimitiveValue("b")}).Encode();
+  ASSERT_EQ(hashed_size + PrimitiveValue("a").ToKeyBytes().size(),
+            ASSERT_RESULT(EncodedHashAndRangePrefixSize(
+                key.AsSlice(), 1 /* num_range_components */, &num_decoded)));
+  ASSERT_EQ(1, num_decoded);
+
+  ASSERT_TRUE(FilterKeyIsComplete(key.AsSlice(), 1 /* num_range_components */));
+  ASSERT_TRUE(FilterKeyIsComplete(
+      Slice(key.data().data(), hashed_size), 0 /* num_range_components */));
+  ASSERT_FALSE(FilterKeyIsComplete(
+      Slice(key.data().data(), hashed_size), 1 /* num_range_components */));
+  ASSERT_FALSE(FilterKeyIsComplete(key.AsSlice(), 3 /* num_range_components */));
+}
+
 TEST(DocKeyTest, TestWriteId) {
   SubDocKey subdoc_key(DocKey({PrimitiveValue("a"), PrimitiveValue(135)}),
                        DocHybridTime(1000000, 4091, 135));
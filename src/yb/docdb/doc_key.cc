@@ -848,11 +848,36 @@ class HashedComponentsExtractor : public rocksdb::FilterPolicy::KeyTransformer {
   }
 
   Slice Transform(Slice key) const override {
+    if (!key.empty() && key[0] == ValueTypeAsChar::kRangeTombstonePrefix) {
+      // Range tombstone records are not document keys, and are never looked up by bloom filter.
+      return Slice(key.data(), 1);
+    }
     auto size = CHECK_RESULT(DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY));
     return Slice(key.data(), size);
   }
 };
 
+class RangePrefixExtractor : public rocksdb::FilterPolicy::KeyTransformer {
+ public:
+  explicit RangePrefixExtractor(size_t num_range_components)
+      : num_range_components_(num_range_components) {}
+
+  RangePrefixExtractor(const RangePrefixExtractor&) = delete;
+  RangePrefixExtractor& operator=(const RangePrefixExtractor&) = delete;
+
+  Slice Transform(Slice key) const override {
+    auto size = EncodedHashAndRangePrefixSize(key, num_range_components_);
+    if (PREDICT_FALSE(!size.ok())) {
+      // Not a regular document key, so fall back to the hashed part that is always present.
+      return HashedComponentsExtractor::GetInstance().Transform(key);
+    }
+    return Slice(key.data(), *size);
+  }
+
+ private:
+  const size_t num_range_components_;
+};
+
 } // namespace
 
 
@@ -880,7 +905,24 @@ rocksdb::FilterPolicy::FilterType DocDbAwareFilterPolicy::GetFilterType() const
   return builtin_policy_->GetFilterType();
 }
 
+DocDbAwareFilterPolicy::DocDbAwareFilterPolicy(
+    size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components)
+    : name_(num_range_components == 0
+          ? "DocKeyHashedComponentsFilter"
+          : Format("DocKeyRangePrefixFilter$0", num_range_components)) {
+  builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
+      filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
+  if (num_range_components != 0) {
+    range_prefix_extractor_ = std::make_unique<RangePrefixExtractor>(num_range_components);
+  }
+}
+
+DocDbAwareFilterPolicy::~DocDbAwareFilterPolicy() = default;
+
 const rocksdb::FilterPolicy::KeyTransformer* DocDbAwareFilterPolicy::GetKeyTransformer() const {
+  if (range_prefix_extractor_) {
+    return range_prefix_extractor_.get();
+  }
   return &HashedComponentsExtractor::GetInstance();
 }
 
@@ -1003,6 +1045,34 @@ Result<bool> ClearRangeComponents(KeyBytes* out, AllowSpecial allow_special) {
   return true;
 }
 
+Result<size_t> EncodedHashAndRangePrefixSize(
+    const Slice& key, size_t num_range_components, size_t* num_decoded) {
+  auto prefix_size = VERIFY_RESULT(
+      DocKey::EncodedSize(key, DocKeyPart::HASHED_PART_ONLY, AllowSpecial::kTrue));
+  Slice input(key.data() + prefix_size, key.end());
+  size_t decoded = 0;
+  // Special values (e.g. kLowest / kHighest in scan bounds) and the end of the range group stop
+  // decoding.
+  while (decoded < num_range_components && !input.empty() &&
+         IsPrimitiveValueType(static_cast<ValueType>(input[0]))) {
+    RETURN_NOT_OK(PrimitiveValue::DecodeKey(&input, nullptr /* out */));
+    ++decoded;
+  }
+  if (num_decoded) {
+    *num_decoded = decoded;
+  }
+  return input.data() - key.data();
+}
+
+bool FilterKeyIsComplete(const Slice& key, size_t num_range_components) {
+  if (num_range_components == 0) {
+    return true;
+  }
+  size_t num_decoded = 0;
+  auto size = EncodedHashAndRangePrefixSize(key, num_range_components, &num_decoded);
+  return size.ok() && num_decoded == num_range_components;
+}
+
 Result<bool> HashedComponentsEqual(const Slice& lhs, const Slice& rhs) {
   DocKeyDecoder lhs_decoder(lhs);
   DocKeyDecoder rhs_decoder(rhs);
@@ -1063,5 +1133,11 @@ bool DocKeyBelongsTo(Slice doc_key, const Schema& schema) {
   return doc_key.starts_with(bytes);
 }
 
+const KeyBounds KeyBounds::kNoBounds;
+
+std::string KeyBounds::ToString() const {
+  return Format("{ lower: $0 upper: $1 }", lower, upper);
+}
+
 }  // namespace docdb
 }  // namespace yb
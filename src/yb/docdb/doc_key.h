@@ -347,6 +347,19 @@ Result<bool> ClearRangeComponents(KeyBytes* out, AllowSpecial allow_special = Al
 
 Result<bool> HashedComponentsEqual(const Slice& lhs, const Slice& rhs);
 
+// Returns size of the key prefix that consists of the hashed part of the key followed by at most
+// num_range_components first range components. Stops at the end of the range group or at the first
+// special value. The number of range components in the prefix is stored to num_decoded if
+// specified.
+Result<size_t> EncodedHashAndRangePrefixSize(
+    const Slice& key, size_t num_range_components, size_t* num_decoded = nullptr);
+
+// Returns true if a bloom filter built by DocDbAwareFilterPolicy with num_range_components could be
+// checked with the specified key, i.e. key has all num_range_components range components, so its
+// filter key is the same as the filter key of every stored key that starts with it. Prefixes with
+// less range components, like the hashed part of a key, have shorter filter keys than full keys.
+bool FilterKeyIsComplete(const Slice& key, size_t num_range_components);
+
 bool DocKeyBelongsTo(Slice doc_key, const Schema& schema);
 
 // Consume a group of document key components, ending with ValueType::kGroupEnd.
@@ -689,14 +702,17 @@ std::string BestEffortDocDBKeyToStr(const KeyBytes &key_bytes);
 std::string BestEffortDocDBKeyToStr(const rocksdb::Slice &slice);
 
 // This filter policy only takes into account hashed components of keys for filtering.
+// When num_range_components is not zero, the filter is built on the hashed components together with
+// up to num_range_components first range components of keys instead. Such a filter could only be
+// checked with keys that have all of those range components specified (see FilterKeyIsComplete).
 class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
  public:
-  explicit DocDbAwareFilterPolicy(size_t filter_block_size_bits, rocksdb::Logger* logger) {
-    builtin_policy_.reset(rocksdb::NewFixedSizeFilterPolicy(
-        filter_block_size_bits, rocksdb::FilterPolicy::kDefaultFixedSizeFilterErrorRate, logger));
-  }
+  DocDbAwareFilterPolicy(
+      size_t filter_block_size_bits, rocksdb::Logger* logger, size_t num_range_components = 0);
 
-  const char* Name() const override { return "DocKeyHashedComponentsFilter"; }
+  ~DocDbAwareFilterPolicy();
+
+  const char* Name() const override { return name_.c_str(); }
 
   void CreateFilter(const rocksdb::Slice* keys, int n, std::string* dst) const override;
 
@@ -711,13 +727,49 @@ class DocDbAwareFilterPolicy : public rocksdb::FilterPolicy {
   const KeyTransformer* GetKeyTransformer() const override;
 
  private:
+  // The name is stored in SST files to identify the filter, so filters built with different number
+  // of range components are never mixed up.
+  const std::string name_;
   std::unique_ptr<const rocksdb::FilterPolicy> builtin_policy_;
+  std::unique_ptr<const KeyTransformer> range_prefix_extractor_;
+};
+
+// Range of encoded keys [lower, upper) that belong to a tablet. Used by tablets produced by a split,
+// which share SST files with the parent tablet, to ignore the keys of the sibling tablet. Empty
+// bound means that the range is not limited from that side.
+struct KeyBounds {
+  KeyBytes lower;
+  KeyBytes upper;
+
+  static const KeyBounds kNoBounds;
+
+  KeyBounds() = default;
+  KeyBounds(const Slice& _lower, const Slice& _upper) : lower(_lower), upper(_upper) {}
+
+  bool IsWithinBounds(const Slice& key) const {
+    return (lower.empty() || key.compare(lower.AsSlice()) >= 0) &&
+           (upper.empty() || key.compare(upper.AsSlice()) < 0);
+  }
+
+  bool IsInitialized() const {
+    return !lower.empty() || !upper.empty();
+  }
+
+  std::string ToString() const;
 };
 
 // Combined DB to store regular records and intents.
 struct DocDB {
   rocksdb::DB* regular;
   rocksdb::DB* intents;
+  // Optional cache of decoded documents, used by non-transactional point reads.
+  DocRowCache* row_cache = nullptr;
+  // Optional bounds of the tablet keys, keys outside of them are not visible to readers.
+  const KeyBounds* key_bounds = nullptr;
+  // Optional storage of large regular DB values, referenced by values in the regular DB.
+  BlobStorage* blob_storage = nullptr;
+  // Optional range tombstones of the regular DB, entries deleted by them are hidden from readers.
+  const RangeTombstones* range_tombstones = nullptr;
 
   static DocDB FromRegular(rocksdb::DB* regular) {
     return {regular, nullptr /* intents */};
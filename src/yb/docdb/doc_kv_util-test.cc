@@ -115,6 +115,29 @@ TEST(DocKVUtilTest, ZeroEncodingAndDecoding) {
   }
 }
 
+TEST(DocKVUtilTest, ComplementZeroEncodingAndDecoding) {
+  rocksdb::Random rng(12345); // initialize with a fixed seed
+  const string kSuffix = "suffix";
+  for (int i = 0; i < 1000; ++i) {
+    int len = rng.Next() % 200;
+    string s;
+    s.reserve(len);
+    for (int j = 0; j < len; ++j) {
+      // Make sure terminator characters are frequent enough to be escaped in most strings.
+      s.push_back(rng.OneIn(8) ? '\xff' : static_cast<char>(rng.Next()));
+    }
+    string encoded_str;
+    ComplementZeroEncodeAndAppendStrToKey(s, &encoded_str);
+    encoded_str += kSuffix;
+    rocksdb::Slice slice(encoded_str);
+    string decoded_str;
+    ASSERT_OK(DecodeComplementZeroEncodedStr(&slice, &decoded_str));
+    ASSERT_EQ(s, decoded_str);
+    // Decoding stops right after the terminator.
+    ASSERT_EQ(kSuffix, slice.ToBuffer());
+  }
+}
+
 TEST(DocKVUtilTest, TableTTL) {
   Schema schema;
   EXPECT_TRUE(TableTTL(schema).Equals(Value::kMaxTtl));
@@ -114,6 +114,17 @@ void TerminateComplementZeroEncodedKeyStr(string *dest) {
   TerminateEncodedKeyStr<'\xff'>(dest);
 }
 
+template<char END_OF_STRING>
+inline void AppendDecodedChars(const char* begin, const char* end, string* result) {
+  const size_t old_size = result->size();
+  result->append(begin, end);
+  if (END_OF_STRING != '\0') {
+    for (auto i = result->begin() + old_size; i != result->end(); ++i) {
+      *i ^= END_OF_STRING;
+    }
+  }
+}
+
 template<char END_OF_STRING>
 Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   static_assert(END_OF_STRING == '\0' || END_OF_STRING == '\xff',
@@ -122,40 +133,43 @@ Status DecodeEncodedStr(rocksdb::Slice* slice, string* result) {
   const char* p = slice->cdata();
   const char* end = p + slice->size();
 
+  // Runs of characters between escape sequences are copied as a whole, so decoding a string
+  // without END_OF_STRING characters in it costs a single append.
   while (p != end) {
+    const char* next = static_cast<const char*>(memchr(p, END_OF_STRING, end - p));
+    if (next == nullptr) {
+      next = end;
+    }
+    if (result != nullptr) {
+      AppendDecodedChars<END_OF_STRING>(p, next, result);
+    }
+    p = next;
+    if (p == end) {
+      break;
+    }
+    ++p;
+    if (p == end) {
+      return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
+                                             END_OF_STRING));
+    }
     if (*p == END_OF_STRING) {
+      // Found two END_OF_STRING characters, this is the end of the encoded string.
       ++p;
-      if (p == end) {
-        return STATUS(Corruption, StringPrintf("Encoded string ends with only one \\0x%02x ",
-                                               END_OF_STRING));
-      }
-      if (*p == END_OF_STRING) {
-        // Found two END_OF_STRING characters, this is the end of the encoded string.
-        ++p;
-        break;
-      }
-      if (*p == END_OF_STRING_ESCAPE) {
-        // Character END_OF_STRING is encoded as AB.
-        if (result != nullptr) {
-          result->push_back(END_OF_STRING ^ END_OF_STRING);
-        }
-        ++p;
-      } else {
-        return STATUS(Corruption, StringPrintf(
-            "Invalid sequence in encoded string: "
-            R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
-            END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
-      }
-    } else {
+      break;
+    }
+    if (*p == END_OF_STRING_ESCAPE) {
+      // Character END_OF_STRING is encoded as AB.
       if (result != nullptr) {
-        result->push_back((*p) ^ END_OF_STRING);
+        result->push_back(END_OF_STRING ^ END_OF_STRING);
       }
       ++p;
+    } else {
+      return STATUS(Corruption, StringPrintf(
+          "Invalid sequence in encoded string: "
+          R"#(\0x%02x\0x%02x (must be either \0x%02x\0x%02x or \0x%02x\0x%02x))#",
+          END_OF_STRING, *p, END_OF_STRING, END_OF_STRING, END_OF_STRING, END_OF_STRING_ESCAPE));
     }
   }
-  if (result != nullptr) {
-    result->shrink_to_fit();
-  }
   slice->remove_prefix(p - slice->cdata());
   return Status::OK();
 }
@@ -11,6 +11,8 @@
 // under the License.
 //
 
+#include <algorithm>
+
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/rocksdb/db/compaction.h"
@@ -65,10 +67,20 @@ DocQLScanSpec::DocQLScanSpec(const Schema& schema,
 
     // Range options are only valid if all range columns are set (i.e. have one or more options).
     for (int i = 0; i < schema_.num_range_key_columns(); i++) {
-      if ((*range_options_)[i].empty()) {
+      auto& options = (*range_options_)[i];
+      if (options.empty()) {
         range_options_ = nullptr;
         break;
       }
+      // Order of primitive values matches order of their encoded keys, so sorting the options
+      // makes scan targets strictly increasing in scan direction. That lets the iterator move to
+      // the next target with a forward seek, which is cheap when targets are close to each other.
+      if (is_forward_scan_) {
+        std::sort(options.begin(), options.end());
+      } else {
+        std::sort(options.begin(), options.end(), std::greater<PrimitiveValue>());
+      }
+      options.erase(std::unique(options.begin(), options.end()), options.end());
     }
   }
 }
@@ -116,11 +128,8 @@ void DocQLScanSpec::InitRangeOptions(const QLConditionPB& condition) {
         int opt_size = options.elems_size();
         (*range_options_)[col_idx - num_hash_cols].reserve(opt_size);
 
-        // IN arguments should have been de-duplicated and ordered ascendingly by the executor.
-        bool is_reverse_order = is_forward_scan_ ^ (sortingType == ColumnSchema::kAscending);
-        for (int i = 0; i < opt_size; i++) {
-          int elem_idx = is_reverse_order ? opt_size - i - 1 : i;
-          const auto &elem = options.elems(elem_idx);
+        // Options are sorted in scan order and de-duplicated once all conditions are collected.
+        for (const auto& elem : options.elems()) {
           auto pv = PrimitiveValue::FromQLValuePB(elem, sortingType);
           (*range_options_)[col_idx - num_hash_cols].push_back(std::move(pv));
         }
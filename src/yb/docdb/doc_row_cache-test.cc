@@ -0,0 +1,137 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/doc_row_cache.h"
+#include "yb/docdb/docdb.h"
+
+#include "yb/util/mem_tracker.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class DocRowCacheTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    mem_tracker_ = MemTracker::CreateTracker("DocRowCacheTest");
+    cache_ = std::make_unique<DocRowCache>(
+        16 * 1024 * 1024, HybridTime::FromMicros(1000), mem_tracker_);
+  }
+
+  void TearDown() override {
+    cache_.reset();
+    ASSERT_EQ(0, mem_tracker_->consumption());
+    YBTest::TearDown();
+  }
+
+  static KeyBytes EncodedKey(const std::string& key) {
+    return DocKey({PrimitiveValue(key)}).Encode();
+  }
+
+  static KeyBytes EncodedSubKey(const std::string& key, const std::string& subkey) {
+    return SubDocKey(DocKey({PrimitiveValue(key)}), PrimitiveValue(subkey)).EncodeWithoutHt();
+  }
+
+  void Insert(const KeyBytes& key, const std::string& value, uint64_t read_micros) {
+    SubDocument doc{PrimitiveValue(value)};
+    doc.SetTtl(-1);
+    bool doc_found = true;
+    GetSubDocumentData data = { key.AsSlice(), &doc, &doc_found };
+    cache_->Insert(HybridTime::FromMicros(read_micros), data);
+  }
+
+  // Returns cached value for the key, or an empty string if the lookup failed.
+  std::string Lookup(const KeyBytes& key, uint64_t read_micros) {
+    SubDocument doc;
+    bool doc_found = false;
+    GetSubDocumentData data = { key.AsSlice(), &doc, &doc_found };
+    if (!cache_->Lookup(HybridTime::FromMicros(read_micros), data)) {
+      return std::string();
+    }
+    EXPECT_TRUE(doc_found);
+    return doc.GetString();
+  }
+
+  std::shared_ptr<MemTracker> mem_tracker_;
+  std::unique_ptr<DocRowCache> cache_;
+};
+
+TEST_F(DocRowCacheTest, LookupAndInvalidate) {
+  const auto key1 = EncodedKey("key1");
+  const auto key2 = EncodedKey("key2");
+  const auto subkey1 = EncodedSubKey("key1", "subkey");
+
+  Insert(key1, "value1", 2000);
+  Insert(subkey1, "subvalue1", 2000);
+  Insert(key2, "value2", 2000);
+  ASSERT_GT(mem_tracker_->consumption(), 0);
+
+  // Entries could not be used by reads before the time they were filled at.
+  ASSERT_EQ("", Lookup(key1, 1500));
+  ASSERT_EQ("value1", Lookup(key1, 2000));
+  ASSERT_EQ("value1", Lookup(key1, 3000));
+  ASSERT_EQ("subvalue1", Lookup(subkey1, 3000));
+
+  // Write to a subkey of the first document drops all entries of this document.
+  cache_->Invalidate(SubDocKey(DocKey({PrimitiveValue("key1")}), PrimitiveValue("other"),
+                               HybridTime::FromMicros(2500)).Encode().AsSlice(),
+                     HybridTime::FromMicros(2500));
+  ASSERT_EQ("", Lookup(key1, 3000));
+  ASSERT_EQ("", Lookup(subkey1, 3000));
+  ASSERT_EQ("value2", Lookup(key2, 3000));
+}
+
+TEST_F(DocRowCacheTest, SkipStaleInsert) {
+  const auto key = EncodedKey("key");
+
+  // Reads done before the time of this write could not fill the cache.
+  cache_->Invalidate(key.AsSlice(), HybridTime::FromMicros(3000));
+  Insert(key, "old_value", 2000);
+  ASSERT_EQ("", Lookup(key, 4000));
+
+  Insert(key, "new_value", 3000);
+  ASSERT_EQ("new_value", Lookup(key, 4000));
+
+  // Documents existing before the cache was created could be stale for reads done before that.
+  const auto other_key = EncodedKey("other_key");
+  Insert(other_key, "value", 500);
+  ASSERT_EQ("", Lookup(other_key, 4000));
+}
+
+TEST_F(DocRowCacheTest, SkipValuesWithTtl) {
+  const auto key = EncodedKey("key");
+  SubDocument doc{PrimitiveValue("value")};
+  doc.SetTtl(10);
+  bool doc_found = true;
+  GetSubDocumentData data = { key.AsSlice(), &doc, &doc_found };
+  cache_->Insert(HybridTime::FromMicros(2000), data);
+  ASSERT_EQ("", Lookup(key, 2000));
+  ASSERT_EQ(0, mem_tracker_->consumption());
+}
+
+TEST_F(DocRowCacheTest, Eviction) {
+  constexpr size_t kCapacity = 64 * 1024;
+  cache_ = std::make_unique<DocRowCache>(kCapacity, HybridTime::FromMicros(1000), mem_tracker_);
+  const std::string value(1024, 'x');
+  for (int i = 0; i != 1000; ++i) {
+    Insert(EncodedKey(Format("key$0", i)), value, 2000);
+    ASSERT_LE(mem_tracker_->consumption(), kCapacity);
+  }
+  ASSERT_EQ(value, Lookup(EncodedKey("key999"), 2000));
+  ASSERT_EQ("", Lookup(EncodedKey("key0"), 2000));
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,245 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_row_cache.h"
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.h"
+#include "yb/docdb/range_tombstones.h"
+
+#include "yb/gutil/hash/hash.h"
+
+#include "yb/rocksdb/write_batch.h"
+
+#include "yb/util/mem_tracker.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Approximate overhead of a node in std::map or std::list.
+constexpr size_t kNodeOverhead = 4 * sizeof(void*);
+
+size_t EstimatedSize(const PrimitiveValue& value) {
+  return sizeof(value) + (value.IsString() ? value.GetString().size() : 0);
+}
+
+// Returns estimated memory used by the document, or 0 if the document could not be cached.
+size_t CacheableSize(const SubDocument& doc) {
+  if (doc.IsPrimitive()) {
+    // Values with TTL expire without any write, so they could not be cached.
+    return doc.GetTtl() == -1 ? EstimatedSize(doc) : 0;
+  }
+  if (!IsObjectType(doc.value_type())) {
+    // Arrays and other special values are not cached.
+    return doc.value_type() == ValueType::kInvalid ? sizeof(doc) : 0;
+  }
+  size_t result = sizeof(doc);
+  if (doc.object_num_keys() == 0) {
+    return result;
+  }
+  for (const auto& child : doc.object_container()) {
+    auto child_size = CacheableSize(child.second);
+    if (child_size == 0) {
+      return 0;
+    }
+    result += kNodeOverhead + EstimatedSize(child.first) + child_size;
+  }
+  return result;
+}
+
+class InvalidateHandler : public rocksdb::WriteBatch::Handler {
+ public:
+  InvalidateHandler(DocRowCache* cache, HybridTime write_ht)
+      : cache_(cache), write_ht_(write_ht) {}
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    cache_->Invalidate(key, write_ht_);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    cache_->Invalidate(key, write_ht_);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    cache_->Invalidate(key, write_ht_);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    cache_->Invalidate(key, write_ht_);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Frontiers(const rocksdb::UserFrontiers& frontiers) override {
+    return Status::OK();
+  }
+
+ private:
+  DocRowCache* cache_;
+  HybridTime write_ht_;
+};
+
+} // namespace
+
+DocRowCache::DocRowCache(
+    size_t capacity_bytes, HybridTime initial_write_ht, std::shared_ptr<MemTracker> mem_tracker)
+    : shard_capacity_(capacity_bytes / kNumShards), mem_tracker_(std::move(mem_tracker)) {
+  for (auto& shard : shards_) {
+    shard.max_write_ht = initial_write_ht;
+  }
+}
+
+DocRowCache::~DocRowCache() {
+  mem_tracker_->Release(consumption());
+}
+
+bool DocRowCache::IsCacheableRequest(const GetSubDocumentData& data) {
+  return !data.return_type_only && !data.count_only && data.limit == 0 &&
+         !data.low_subkey->is_valid() && !data.high_subkey->is_valid() &&
+         data.low_index->is_empty() && data.high_index->is_empty() &&
+         data.exp.ttl == Value::kMaxTtl && data.exp.write_ht == HybridTime::kMin;
+}
+
+DocRowCache::Shard& DocRowCache::ShardFor(const Slice& doc_key) {
+  auto hash = Hash64StringWithSeed(
+      doc_key.cdata(), static_cast<uint32>(doc_key.size()), 0 /* seed */);
+  return shards_[hash % kNumShards];
+}
+
+bool DocRowCache::Lookup(HybridTime read_ht, const GetSubDocumentData& data) {
+  auto doc_key_size = DocKey::EncodedSize(data.subdocument_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return false;
+  }
+  auto& shard = ShardFor(Slice(data.subdocument_key.data(), *doc_key_size));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.entries.find(data.subdocument_key);
+  if (it == shard.entries.end()) {
+    return false;
+  }
+  auto& entry = it->second;
+  if (read_ht < entry.valid_from || entry.exp.always_override != data.exp.always_override) {
+    return false;
+  }
+  *data.result = entry.result;
+  *data.doc_found = entry.doc_found;
+  data.exp = entry.exp;
+  shard.lru.splice(shard.lru.end(), shard.lru, entry.lru_position);
+  return true;
+}
+
+void DocRowCache::Insert(HybridTime read_ht, const GetSubDocumentData& data) {
+  if (data.exp.ttl != Value::kMaxTtl) {
+    return;
+  }
+  size_t doc_size = *data.doc_found ? CacheableSize(*data.result) : sizeof(SubDocument);
+  if (doc_size == 0) {
+    return;
+  }
+  auto doc_key_size = DocKey::EncodedSize(data.subdocument_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return;
+  }
+  const size_t charge = sizeof(Entry) + 2 * kNodeOverhead + data.subdocument_key.size() + doc_size;
+  if (charge > shard_capacity_) {
+    return;
+  }
+
+  auto& shard = ShardFor(Slice(data.subdocument_key.data(), *doc_key_size));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (shard.max_write_ht > read_ht) {
+    // Some document of this shard was modified after read_ht, so the result could be stale for
+    // reads at later hybrid times.
+    return;
+  }
+  auto it = shard.entries.find(data.subdocument_key);
+  if (it != shard.entries.end()) {
+    Erase(&shard, it);
+  }
+  it = shard.entries.emplace(data.subdocument_key.ToBuffer(), Entry()).first;
+  auto& entry = it->second;
+  entry.result = *data.result;
+  entry.doc_found = *data.doc_found;
+  entry.exp = data.exp;
+  entry.valid_from = read_ht;
+  entry.charge = charge;
+  entry.lru_position = shard.lru.insert(shard.lru.end(), it);
+  shard.consumption += charge;
+  mem_tracker_->Consume(charge);
+
+  while (shard.consumption > shard_capacity_) {
+    Erase(&shard, shard.lru.front());
+  }
+}
+
+void DocRowCache::Invalidate(const Slice& encoded_key, HybridTime write_ht) {
+  if (IsRangeTombstoneKey(encoded_key)) {
+    // Range deletions are rare, so it is simpler to drop all documents.
+    InvalidateAll(write_ht);
+    return;
+  }
+  auto doc_key_size = DocKey::EncodedSize(encoded_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    LOG(DFATAL) << "Invalidate row cache for malformed key " << encoded_key.ToDebugHexString()
+                << ": " << doc_key_size.status();
+    InvalidateAll(write_ht);
+    return;
+  }
+  Slice doc_key(encoded_key.data(), *doc_key_size);
+  auto& shard = ShardFor(doc_key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.max_write_ht.MakeAtLeast(write_ht);
+  auto it = shard.entries.lower_bound(doc_key);
+  while (it != shard.entries.end() && Slice(it->first).starts_with(doc_key)) {
+    Erase(&shard, it++);
+  }
+}
+
+void DocRowCache::Invalidate(const rocksdb::WriteBatch& write_batch, HybridTime write_ht) {
+  InvalidateHandler handler(this, write_ht);
+  auto status = write_batch.Iterate(&handler);
+  LOG_IF(DFATAL, !status.ok()) << "Failed to invalidate row cache: " << status;
+}
+
+void DocRowCache::InvalidateAll(HybridTime write_ht) {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.max_write_ht.MakeAtLeast(write_ht);
+    while (!shard.lru.empty()) {
+      Erase(&shard, shard.lru.front());
+    }
+  }
+}
+
+void DocRowCache::Erase(Shard* shard, EntryMap::iterator it) {
+  shard->consumption -= it->second.charge;
+  mem_tracker_->Release(it->second.charge);
+  shard->lru.erase(it->second.lru_position);
+  shard->entries.erase(it);
+}
+
+size_t DocRowCache::consumption() const {
+  size_t result = 0;
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    result += shard.consumption;
+  }
+  return result;
+}
+
+}  // namespace docdb
+}  // namespace yb
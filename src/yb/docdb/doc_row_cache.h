@@ -0,0 +1,145 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_DOC_ROW_CACHE_H_
+#define YB_DOCDB_DOC_ROW_CACHE_H_
+
+#include <array>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/docdb/expiration.h"
+#include "yb/docdb/subdocument.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class WriteBatch;
+
+}  // namespace rocksdb
+
+namespace yb {
+
+class MemTracker;
+
+namespace docdb {
+
+struct GetSubDocumentData;
+
+// A per-tablet, memory-bounded cache of decoded documents used to serve hot point reads without
+// touching RocksDB. Entries are keyed by the encoded SubDocKey (without hybrid time) that was read.
+//
+// An entry filled by a read at hybrid time R is used to answer reads at any hybrid time >= R, as
+// long as no write to the same document has been applied since. To guarantee that, every write
+// applied to the regular RocksDB must be reported through Invalidate, and an entry is not added
+// when a write with hybrid time > R has already been reported for the same shard of the cache,
+// because in that case the value read at R could be stale for later reads.
+//
+// Only results that cannot change without a write (i.e. do not have TTL) are cached, and only
+// non-transactional reads use the cache.
+//
+// This class is thread-safe.
+class DocRowCache {
+ public:
+  // initial_write_ht should be not less than hybrid time of any write that was applied to the DB
+  // before this cache was created.
+  DocRowCache(
+      size_t capacity_bytes, HybridTime initial_write_ht,
+      std::shared_ptr<MemTracker> mem_tracker);
+
+  ~DocRowCache();
+
+  DocRowCache(const DocRowCache&) = delete;
+  void operator=(const DocRowCache&) = delete;
+
+  // Returns true if the result of GetSubDocument for the specified request could be cached.
+  static bool IsCacheableRequest(const GetSubDocumentData& data);
+
+  // Tries to fill result of the request from the cache. Returns true on success.
+  bool Lookup(HybridTime read_ht, const GetSubDocumentData& data);
+
+  // Adds result of the request, that was read at read_ht, to the cache.
+  void Insert(HybridTime read_ht, const GetSubDocumentData& data);
+
+  // Drops all entries of the document with the specified encoded key, since it was modified by
+  // a write at the specified hybrid time.
+  void Invalidate(const Slice& encoded_key, HybridTime write_ht);
+
+  // Invalidates all documents affected by the write batch applied to the regular DB.
+  void Invalidate(const rocksdb::WriteBatch& write_batch, HybridTime write_ht);
+
+  size_t consumption() const;
+
+ private:
+  struct Entry;
+
+  // Allows lookup of entries by Slice without allocating a string.
+  struct KeyLess {
+    typedef void is_transparent;
+
+    bool operator()(const std::string& lhs, const std::string& rhs) const {
+      return lhs < rhs;
+    }
+
+    bool operator()(const std::string& lhs, const Slice& rhs) const {
+      return Slice(lhs).compare(rhs) < 0;
+    }
+
+    bool operator()(const Slice& lhs, const std::string& rhs) const {
+      return lhs.compare(Slice(rhs)) < 0;
+    }
+  };
+
+  typedef std::map<std::string, Entry, KeyLess> EntryMap;
+  typedef std::list<EntryMap::iterator> LruList;
+
+  struct Entry {
+    SubDocument result;
+    bool doc_found = false;
+    Expiration exp;
+    HybridTime valid_from;
+    size_t charge = 0;
+    LruList::iterator lru_position;
+  };
+
+  struct Shard {
+    mutable std::mutex mutex;
+    EntryMap entries;
+    LruList lru;
+    size_t consumption = 0;
+    // Max hybrid time of writes reported for documents of this shard.
+    HybridTime max_write_ht;
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  Shard& ShardFor(const Slice& doc_key);
+
+  // Drops all entries, since any document could be modified by a write at write_ht.
+  void InvalidateAll(HybridTime write_ht);
+
+  void Erase(Shard* shard, EntryMap::iterator it);
+
+  const size_t shard_capacity_;
+  std::shared_ptr<MemTracker> mem_tracker_;
+  std::array<Shard, kNumShards> shards_;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_DOC_ROW_CACHE_H_
@@ -27,9 +27,15 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/util/flag_tags.h"
 
 #include "yb/yql/pggate/util/pg_doc_data.h"
 
+DEFINE_int32(docdb_scan_batch_size, 128,
+             "Maximum number of rows that read operations fetch from a DocRowwiseIterator at once. "
+             "Values less than or equal to 1 fetch rows one by one.");
+TAG_FLAG(docdb_scan_batch_size, advanced);
+
 using std::string;
 
 using yb::FormatRocksDBSliceAsStr;
@@ -258,7 +264,10 @@ Status DiscreteScanChoices::SeekToCurrentTarget(IntentAwareIterator* db_iter) {
   if (!FinishedWithScanChoices()) {
     if (is_forward_scan_) {
       VLOG(2) << __PRETTY_FUNCTION__ << " Seeking to " << current_scan_target_;
-      db_iter->Seek(current_scan_target_);
+      // Targets are visited in increasing order, so the iterator never has to move backward.
+      // Forward seek is a no-op when the iterator is already at the target (e.g. after reading
+      // the previous row of a dense IN-list) and uses nexts instead of a seek for close targets.
+      db_iter->SeekForward(&current_scan_target_);
     } else {
       auto tmp = current_scan_target_;
       tmp.AppendValueType(ValueType::kHighest);
@@ -453,6 +462,7 @@ Status DocRowwiseIterator::Init() {
   DocKeyEncoder(&iter_key_).CotableId(schema_.cotable_id());
   row_key_ = iter_key_;
   row_hash_key_ = row_key_;
+  db_iter_->SkipIntentsIfNoneInRange(row_key_, Slice() /* upper_bound */);
   VLOG(3) << __PRETTY_FUNCTION__ << " Seeking to " << row_key_;
   db_iter_->Seek(row_key_);
   row_ready_ = false;
@@ -495,15 +505,15 @@ Status DocRowwiseIterator::DoInit(const T& doc_spec) {
           << ", " << DocKey::DebugSliceToString(upper_doc_key.AsSlice());
 
   // TODO(bogdan): decide if this is a good enough heuristic for using blooms for scans.
-  const bool is_fixed_point_get =
-      !lower_doc_key.empty() &&
-      VERIFY_RESULT(HashedComponentsEqual(lower_doc_key, upper_doc_key));
+  const bool is_fixed_point_get = VERIFY_RESULT(BloomFilterKeysEqual(
+      lower_doc_key, upper_doc_key));
   const auto mode = is_fixed_point_get ? BloomFilterMode::USE_BLOOM_FILTER
                                        : BloomFilterMode::DONT_USE_BLOOM_FILTER;
 
   db_iter_ = CreateIntentAwareIterator(
       doc_db_, mode, lower_doc_key.AsSlice(), doc_spec.QueryId(), txn_op_context_,
       deadline_, read_time_, doc_spec.CreateFileFilter());
+  db_iter_->SkipIntentsIfNoneInRange(lower_doc_key, upper_doc_key);
 
   row_ready_ = false;
 
@@ -731,6 +741,41 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
     return STATUS(InternalError, "next row has not be prepared for reading");
   }
 
+  return FillRow(projection, nullptr /* column_keys */, table_row);
+}
+
+Result<size_t> DocRowwiseIterator::DoNextBatch(const Schema& projection, size_t max_rows,
+                                               bool include_tuple_id,
+                                               std::vector<QLTableRow::SharedPtr>* rows) {
+  VLOG(4) << __PRETTY_FUNCTION__ << " max_rows: " << max_rows;
+
+  std::vector<PrimitiveValue> column_keys;
+  column_keys.reserve(projection.num_columns() - projection.num_key_columns());
+  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+    column_keys.emplace_back(projection.column_id(i));
+  }
+
+  size_t num_rows = 0;
+  while (num_rows < max_rows && VERIFY_RESULT(HasNext())) {
+    if (rows->size() <= num_rows) {
+      rows->push_back(std::make_shared<QLTableRow>());
+    }
+    QLTableRow* row = (*rows)[num_rows].get();
+    row->Clear();
+    if (include_tuple_id) {
+      const Slice tuple_id = VERIFY_RESULT(GetTupleId());
+      row->AllocColumn(static_cast<ColumnIdRep>(PgSystemAttrNum::kYBTupleId))
+          .value.set_binary_value(tuple_id.data(), tuple_id.size());
+    }
+    RETURN_NOT_OK(FillRow(projection, &column_keys, row));
+    ++num_rows;
+  }
+  return num_rows;
+}
+
+Status DocRowwiseIterator::FillRow(const Schema& projection,
+                                   const std::vector<PrimitiveValue>* column_keys,
+                                   QLTableRow* table_row) {
   DocKeyDecoder decoder(row_key_);
   RETURN_NOT_OK(decoder.DecodeCotableId());
   bool has_hash_components = VERIFY_RESULT(decoder.DecodeHashCode());
@@ -749,13 +794,15 @@ Status DocRowwiseIterator::DoNextRow(const Schema& projection, QLTableRow* table
         "range", &decoder, table_row));
   }
 
-  for (size_t i = projection.num_key_columns(); i < projection.num_columns(); i++) {
+  const size_t num_key_columns = projection.num_key_columns();
+  for (size_t i = num_key_columns; i < projection.num_columns(); i++) {
     const auto& column_id = projection.column_id(i);
-    const auto ql_type = projection.column(i).type();
-    const SubDocument* column_value = row_.GetChild(PrimitiveValue(column_id));
+    const SubDocument* column_value =
+        column_keys ? row_.GetChild((*column_keys)[i - num_key_columns])
+                    : row_.GetChild(PrimitiveValue(column_id));
     if (column_value != nullptr) {
       QLTableColumn& column = table_row->AllocColumn(column_id);
-      SubDocument::ToQLValuePB(*column_value, ql_type, &column.value);
+      SubDocument::ToQLValuePB(*column_value, projection.column(i).type(), &column.value);
       column.ttl_seconds = column_value->GetTtl();
       if (column_value->IsWriteTimeSet()) {
         column.write_time = column_value->GetWriteTime();
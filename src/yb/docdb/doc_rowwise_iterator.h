@@ -157,6 +157,18 @@ class DocRowwiseIterator : public common::YQLRowwiseIteratorIf {
   // Read next row into a value map using the specified projection.
   CHECKED_STATUS DoNextRow(const Schema& projection, QLTableRow* table_row) override;
 
+  // Read up to max_rows rows into the given rows without going through the virtual
+  // HasNext/NextRow pair for each of them.
+  Result<size_t> DoNextBatch(const Schema& projection, size_t max_rows, bool include_tuple_id,
+                             std::vector<QLTableRow::SharedPtr>* rows) override;
+
+  // Populates table_row from the row prepared by HasNext. When column_keys is not null, it
+  // contains the subkeys of the non-key projection columns in projection order, so they don't have
+  // to be rebuilt for every row.
+  CHECKED_STATUS FillRow(const Schema& projection,
+                         const std::vector<PrimitiveValue>* column_keys,
+                         QLTableRow* table_row);
+
   const Schema& projection_;
   // Used to maintain ownership of projection_.
   // Separate field is used since ownership could be optional.
@@ -17,6 +17,7 @@
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/range_tombstones.h"
 #include "yb/docdb/value_type.h"
 #include "yb/rocksdb/db.h"
 #include "yb/server/hybrid_clock.h"
@@ -281,7 +282,7 @@ CHECKED_STATUS DocWriteBatch::SetPrimitiveInternal(
 
       // Update our local cache to record the fact that we're adding this subdocument, so that
       // future operations in this DocWriteBatch don't have to add it or look for it in RocksDB.
-      cache_.Put(KeyBytes(key_prefix_.AsSlice()), hybrid_time, ValueType::kObject);
+      cache_.Put(key_prefix_, hybrid_time, ValueType::kObject);
       subkey.AppendToKey(&key_prefix_);
     }
   }
@@ -344,17 +345,26 @@ Status DocWriteBatch::SetPrimitive(const DocPath& doc_path,
   DOCDB_DEBUG_LOG("Called with doc_path=$0, value=$1",
                   doc_path.ToString(), value.ToString());
 
-  std::function<std::unique_ptr<IntentAwareIterator>()> createrator =
-    [doc_path, query_id, deadline, read_ht, this]() {
-      return yb::docdb::CreateIntentAwareIterator(
-          doc_db_,
-          BloomFilterMode::USE_BLOOM_FILTER,
-          doc_path.encoded_doc_key().AsSlice(),
-          query_id,
-          /*txn_op_context*/ boost::none,
-          deadline,
-          read_ht);
-    };
+  // The iterator is created only when the write has to read the current state of the document,
+  // which is rare, while this function is called for every written column. The creator captures
+  // only two pointers, so the doc path is not copied and std::function does not allocate memory
+  // to store the creator.
+  struct IteratorArgs {
+    const DocPath& doc_path;
+    const ReadHybridTime& read_ht;
+    CoarseTimePoint deadline;
+    rocksdb::QueryId query_id;
+  } args = {doc_path, read_ht, deadline, query_id};
+  std::function<std::unique_ptr<IntentAwareIterator>()> createrator = [this, &args]() {
+    return yb::docdb::CreateIntentAwareIterator(
+        doc_db_,
+        BloomFilterMode::USE_BLOOM_FILTER,
+        args.doc_path.encoded_doc_key().AsSlice(),
+        args.query_id,
+        /*txn_op_context*/ boost::none,
+        args.deadline,
+        args.read_ht);
+  };
 
   LazyIterator iter(&createrator);
 
@@ -578,6 +588,12 @@ Status DocWriteBatch::ReplaceInList(
   }
 }
 
+void DocWriteBatch::DeleteRange(const Slice& lower, const Slice& upper) {
+  put_batch_.push_back(EncodeRangeTombstone(lower, upper));
+  // Documents of the range do not exist anymore.
+  cache_.Clear();
+}
+
 void DocWriteBatch::Clear() {
   put_batch_.clear();
   cache_.Clear();
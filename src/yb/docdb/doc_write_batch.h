@@ -184,6 +184,11 @@ class DocWriteBatch {
                         read_ht, deadline, query_id, user_timestamp);
   }
 
+  // Deletes all entries with keys in [lower, upper), where bounds are encoded document keys, that
+  // were written before or by this batch. A single range tombstone record is written, regardless
+  // of the number of deleted entries. Only supported by non-transactional writes.
+  void DeleteRange(const Slice& lower, const Slice& upper);
+
   void Clear();
   bool IsEmpty() const { return put_batch_.empty(); }
 
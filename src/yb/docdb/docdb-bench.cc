@@ -0,0 +1,288 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+// Benchmarks of the DocDB read and write paths on top of RocksDB. Tables are synthetic, with an
+// int64 key and a configurable number of string columns, values width and number of versions.
+// Every benchmark reports ops/sec and a latency histogram, for instance:
+//   docdb-bench --gtest_filter=DocDBBench.IntentAwareIteratorSeek --docdb_bench_num_rows=1000000
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "yb/common/transaction-test-util.h"
+
+#include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/docdb.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
+#include "yb/docdb/docdb_test_base.h"
+#include "yb/docdb/intent_aware_iterator.h"
+
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/random.h"
+#include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(docdb_bench_num_rows, 10000, "Number of rows of the synthetic table.");
+DEFINE_int32(docdb_bench_num_columns, 5, "Number of non-key columns of the synthetic table.");
+DEFINE_int32(docdb_bench_value_size, 32, "Size in bytes of every column value.");
+DEFINE_int32(docdb_bench_num_versions, 1, "Number of versions written for every row.");
+DEFINE_int32(docdb_bench_num_seeks, 10000, "Number of random seeks done by seek benchmarks.");
+DEFINE_double(docdb_bench_intents_fraction, 0.1,
+              "Fraction of rows that have provisional records of committed transactions in "
+              "benchmarks with intents.");
+DEFINE_bool(docdb_bench_flush, true, "Flush written rows to SST files before reading them.");
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Latencies are recorded in microseconds, up to a minute.
+constexpr int64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+constexpr int kKeyColumnId = 10;
+constexpr int kFirstValueColumnId = 20;
+
+// Number of distinct values written to every column.
+constexpr size_t kNumDistinctValues = 64;
+
+// Collects latencies of benchmarked operations and logs ops/sec and latency percentiles.
+class BenchStats {
+ public:
+  explicit BenchStats(std::string name)
+      : name_(std::move(name)), histogram_(kMaxLatencyUs, kLatencySignificantDigits),
+        start_(MonoTime::Now()) {}
+
+  ~BenchStats() {
+    Report();
+  }
+
+  // Invokes functor and records its latency, returns the status returned by functor.
+  template <class Functor>
+  Status Measure(const Functor& functor) {
+    auto op_start = MonoTime::Now();
+    Status status = functor();
+    histogram_.Increment(std::min((MonoTime::Now() - op_start).ToMicroseconds(), kMaxLatencyUs));
+    return status;
+  }
+
+ private:
+  void Report() const {
+    const auto elapsed = MonoTime::Now() - start_;
+    const auto count = histogram_.TotalCount();
+    LOG(INFO) << name_ << ": " << count << " ops in " << elapsed << ", "
+              << (elapsed.ToSeconds() > 0 ? count / elapsed.ToSeconds() : 0) << " ops/sec";
+    LOG(INFO) << name_ << " latency (us): mean " << histogram_.MeanValue()
+              << ", p50 " << histogram_.ValueAtPercentile(50)
+              << ", p95 " << histogram_.ValueAtPercentile(95)
+              << ", p99 " << histogram_.ValueAtPercentile(99)
+              << ", p99.9 " << histogram_.ValueAtPercentile(99.9)
+              << ", max " << histogram_.MaxValue();
+  }
+
+  const std::string name_;
+  HdrHistogram histogram_;
+  const MonoTime start_;
+};
+
+} // namespace
+
+class DocDBBench : public DocDBTestBase {
+ protected:
+  void SetUp() override {
+    DocDBTestBase::SetUp();
+
+    std::vector<ColumnSchema> columns = { ColumnSchema("k", DataType::INT64, false) };
+    std::vector<ColumnId> column_ids = { ColumnId(kKeyColumnId) };
+    std::vector<std::string> value_column_names;
+    for (int i = 0; i != FLAGS_docdb_bench_num_columns; ++i) {
+      value_column_names.push_back(Format("c$0", i));
+      columns.emplace_back(value_column_names.back(), DataType::STRING, true);
+      column_ids.emplace_back(kFirstValueColumnId + i);
+    }
+    schema_ = Schema(columns, column_ids, 1 /* key_columns */);
+    ASSERT_OK(schema_.CreateProjectionByNames(value_column_names, &projection_));
+
+    Random rnd(SeedRandom());
+    for (size_t i = 0; i != kNumDistinctValues; ++i) {
+      values_.push_back(RandomHumanReadableString(FLAGS_docdb_bench_value_size, &rnd));
+    }
+  }
+
+  static DocKey RowKey(int64_t row) {
+    return DocKey(PrimitiveValues(row));
+  }
+
+  HybridTime NextHybridTime() {
+    hybrid_time_ = hybrid_time_.AddMicroseconds(1);
+    return hybrid_time_;
+  }
+
+  // Adds all columns of the row to the write batch.
+  CHECKED_STATUS AddRow(int64_t row, DocWriteBatch* dwb) {
+    const auto encoded_key = RowKey(row).Encode();
+    for (int i = 0; i != FLAGS_docdb_bench_num_columns; ++i) {
+      RETURN_NOT_OK(dwb->SetPrimitive(
+          DocPath(encoded_key, PrimitiveValue(ColumnId(kFirstValueColumnId + i))),
+          PrimitiveValue(values_[(row + i) % values_.size()])));
+    }
+    return Status::OK();
+  }
+
+  // Writes every row of the table docdb_bench_num_versions times, one row per write, recording the
+  // latency of writes to stats if it is not null.
+  void WriteRows(BenchStats* stats) {
+    auto dwb = MakeDocWriteBatch();
+    for (int version = 0; version != FLAGS_docdb_bench_num_versions; ++version) {
+      for (int64_t row = 0; row != FLAGS_docdb_bench_num_rows; ++row) {
+        auto write = [this, row, &dwb] {
+          RETURN_NOT_OK(AddRow(row, &dwb));
+          return WriteToRocksDBAndClear(&dwb, NextHybridTime());
+        };
+        ASSERT_OK(stats ? stats->Measure(write) : write());
+      }
+    }
+  }
+
+  void LoadTable() {
+    ASSERT_NO_FATALS(WriteRows(nullptr /* stats */));
+    if (FLAGS_docdb_bench_flush) {
+      ASSERT_OK(FlushRocksDbAndWait());
+    }
+  }
+
+  // Writes provisional records of a committed transaction for docdb_bench_intents_fraction of
+  // rows.
+  void WriteIntents() {
+    if (FLAGS_docdb_bench_intents_fraction <= 0) {
+      return;
+    }
+    const int64_t step = std::max<int64_t>(1 / FLAGS_docdb_bench_intents_fraction, 1);
+    const auto txn_id = GenerateTransactionId();
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    SetCurrentTransactionId(txn_id);
+    auto dwb = MakeDocWriteBatch();
+    for (int64_t row = 0; row < FLAGS_docdb_bench_num_rows; row += step) {
+      ASSERT_OK(AddRow(row, &dwb));
+      ASSERT_OK(WriteToRocksDBAndClear(&dwb, NextHybridTime()));
+    }
+    ResetCurrentTransactionId();
+    txn_status_manager_.Commit(txn_id, NextHybridTime());
+    if (FLAGS_docdb_bench_flush) {
+      ASSERT_OK(FlushRocksDbAndWait());
+    }
+  }
+
+  void BenchmarkSeeks(const std::string& name, const TransactionOperationContextOpt& txn_context) {
+    auto iter = CreateIntentAwareIterator(
+        doc_db(), BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none /* user_key_for_filter */,
+        rocksdb::kDefaultQueryId, txn_context, CoarseTimePoint::max() /* deadline */,
+        ReadHybridTime::SingleTime(NextHybridTime()));
+    BenchStats stats(name);
+    for (int i = 0; i != FLAGS_docdb_bench_num_seeks; ++i) {
+      const auto key = RowKey(RandomUniformInt<int64_t>(0, FLAGS_docdb_bench_num_rows - 1));
+      ASSERT_OK(stats.Measure([&iter, &key]() -> Status {
+        iter->Seek(key);
+        if (!iter->valid()) {
+          return STATUS_FORMAT(NotFound, "Row not found: $0", key);
+        }
+        return iter->FetchKey().status();
+      }));
+    }
+  }
+
+  Schema schema_;
+  Schema projection_;
+  std::vector<std::string> values_;
+  HybridTime hybrid_time_ = HybridTime::FromMicros(1000);
+  TransactionStatusManagerMock txn_status_manager_;
+};
+
+TEST_F(DocDBBench, DocWriteBatchEncoding) {
+  auto dwb = MakeDocWriteBatch();
+  BenchStats stats("DocWriteBatch encoding");
+  for (int64_t row = 0; row != FLAGS_docdb_bench_num_rows; ++row) {
+    ASSERT_OK(stats.Measure([this, row, &dwb] {
+      dwb.Clear();
+      RETURN_NOT_OK(AddRow(row, &dwb));
+      rocksdb::WriteBatch rocksdb_write_batch;
+      return PopulateRocksDBWriteBatch(dwb, &rocksdb_write_batch, NextHybridTime());
+    }));
+  }
+}
+
+TEST_F(DocDBBench, Write) {
+  BenchStats stats("Write");
+  ASSERT_NO_FATALS(WriteRows(&stats));
+}
+
+TEST_F(DocDBBench, IntentAwareIteratorSeek) {
+  ASSERT_NO_FATALS(LoadTable());
+  ASSERT_NO_FATALS(BenchmarkSeeks("IntentAwareIterator seek", kNonTransactionalOperationContext));
+}
+
+TEST_F(DocDBBench, IntentAwareIteratorSeekWithIntents) {
+  ASSERT_NO_FATALS(LoadTable());
+  ASSERT_NO_FATALS(WriteIntents());
+  ASSERT_NO_FATALS(BenchmarkSeeks(
+      "IntentAwareIterator seek with intents",
+      TransactionOperationContext(GenerateTransactionId(), &txn_status_manager_)));
+}
+
+TEST_F(DocDBBench, DocRowwiseIteratorScan) {
+  ASSERT_NO_FATALS(LoadTable());
+  DocRowwiseIterator iter(
+      projection_, schema_, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::SingleTime(NextHybridTime()));
+  ASSERT_OK(iter.Init());
+
+  int64_t num_rows = 0;
+  {
+    BenchStats stats("DocRowwiseIterator scan");
+    QLTableRow row;
+    while (ASSERT_RESULT(iter.HasNext())) {
+      ASSERT_OK(stats.Measure([&iter, &row] {
+        return iter.NextRow(&row);
+      }));
+      ++num_rows;
+    }
+  }
+  ASSERT_EQ(FLAGS_docdb_bench_num_rows, num_rows);
+}
+
+TEST_F(DocDBBench, CompactionFilter) {
+  ASSERT_NO_FATALS(LoadTable());
+  ASSERT_OK(FlushRocksDbAndWait());
+  uint64_t sst_files_size = 0;
+  ASSERT_TRUE(rocksdb()->GetIntProperty(
+      rocksdb::DB::Properties::kTotalSstFilesSize, &sst_files_size));
+
+  // Only the latest version of every column is kept by the compaction.
+  SetHistoryCutoffHybridTime(NextHybridTime());
+  const auto num_entries = static_cast<int64_t>(FLAGS_docdb_bench_num_rows) *
+                           FLAGS_docdb_bench_num_columns * FLAGS_docdb_bench_num_versions;
+  const auto start = MonoTime::Now();
+  ASSERT_OK(FullyCompactDB(rocksdb()));
+  const auto elapsed = MonoTime::Now() - start;
+  LOG(INFO) << "Compaction: " << num_entries << " entries, " << sst_files_size << " bytes in "
+            << elapsed << ", " << num_entries / elapsed.ToSeconds() << " entries/sec, "
+            << sst_files_size / elapsed.ToSeconds() / 1_MB << " MB/sec";
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -17,21 +17,28 @@
 #include <string>
 
 #include "yb/rocksdb/db.h"
+#include "yb/rocksdb/perf_context.h"
+#include "yb/rocksdb/perf_level.h"
 #include "yb/rocksdb/status.h"
 #include "yb/rocksdb/util/statistics.h"
 
 #include "yb/common/hybrid_time.h"
+#include "yb/docdb/blob_storage.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/in_mem_docdb.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/storage_profile.h"
 #include "yb/gutil/stringprintf.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/server/hybrid_clock.h"
 #include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/deadline_info.h"
 
+#include "yb/util/fast_varint.h"
 #include "yb/util/minmax.h"
 #include "yb/util/path_util.h"
 #include "yb/util/size_literals.h"
@@ -58,6 +65,11 @@ using namespace std::chrono_literals;
 
 DECLARE_bool(use_docdb_aware_bloom_filter);
 DECLARE_int32(max_nexts_to_avoid_seek);
+DECLARE_bool(intents_db_use_prefix_hash_index);
+DECLARE_int64(docdb_blob_value_threshold_bytes);
+DECLARE_int32(regular_db_memtable_filter_bits);
+DECLARE_bool(docdb_skip_files_written_after_read_time);
+DECLARE_int32(docdb_bloom_filter_range_components);
 
 #define ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(str) ASSERT_NO_FATALS(AssertDocDbDebugDumpStrEq(str))
 
@@ -517,6 +529,139 @@ SubDocKey(DocKey([], ["mydockey", 123456]), ["subkey1"; HT{ physical: 3000 }]) -
       )#");
 }
 
+TEST_F(DocDBTest, KeyBounds) {
+  // Keys of the documents outside of the bounds, that remain in SST files shared with the sibling
+  // tablet after a split, should be invisible to readers and dropped by compactions.
+  const DocKey doc_key_a(PrimitiveValues("a"));
+  const DocKey doc_key_b(PrimitiveValues("b"));
+  const DocKey doc_key_c(PrimitiveValues("c"));
+  for (const auto* doc_key : {&doc_key_a, &doc_key_b, &doc_key_c}) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key->Encode(), "subkey"), PrimitiveValue("value"), 1000_usec_ht));
+  }
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  key_bounds_ = KeyBounds(doc_key_b.Encode().AsSlice(), doc_key_c.Encode().AsSlice());
+  VerifySubDocument(SubDocKey(doc_key_a), 2000_usec_ht, "");
+  VerifySubDocument(SubDocKey(doc_key_b), 2000_usec_ht, R"#(
+{
+  "subkey": "value"
+}
+      )#");
+  VerifySubDocument(SubDocKey(doc_key_c), 2000_usec_ht, "");
+
+  FullyCompactHistoryBefore(500_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+SubDocKey(DocKey([], ["b"]), ["subkey"; HT{ physical: 1000 }]) -> "value"
+      )#");
+}
+
+TEST_F(DocDBTest, BlobValues) {
+  // Large values are moved to blob files by compactions, and are resolved transparently by
+  // readers. Blob files that are no longer referenced by SST files are deleted.
+  FLAGS_docdb_blob_value_threshold_bytes = 100;
+  ASSERT_OK(DestroyRocksDB());
+  ASSERT_OK(OpenRocksDB());
+  ASSERT_NE(blob_storage(), nullptr);
+
+  const DocKey doc_key(PrimitiveValues("mydockey"));
+  const std::string large_value(200, 'x');
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key.Encode(), "large"), PrimitiveValue(large_value), 1000_usec_ht));
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key.Encode(), "small"), PrimitiveValue("value"), 1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  ASSERT_EQ(0, blob_storage()->num_files());
+
+  FullyCompactHistoryBefore(500_usec_ht);
+  ASSERT_EQ(1, blob_storage()->num_files());
+  const auto dump = DocDBDebugDumpToStr();
+  ASSERT_NE(std::string::npos, dump.find("blob reference")) << dump;
+  ASSERT_EQ(std::string::npos, dump.find(large_value)) << dump;
+  const auto expected_document = Format(R"#(
+{
+  "large": "$0",
+  "small": "value"
+}
+      )#", large_value);
+  VerifySubDocument(SubDocKey(doc_key), 2000_usec_ht, expected_document);
+
+  // References survive following compactions and reopening of the DB.
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key.Encode(), "other"), PrimitiveValue("value"), 3000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  FullyCompactHistoryBefore(3500_usec_ht);
+  ASSERT_OK(ReopenRocksDB());
+  ASSERT_EQ(1, blob_storage()->num_files());
+  VerifySubDocument(SubDocKey(doc_key, PrimitiveValue("large")), 4000_usec_ht, Format("\"$0\"", large_value));
+
+  // Overwritten value is dropped by the compaction, and its blob file is deleted after it.
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key.Encode(), "large"), PrimitiveValue("value"), 5000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  FullyCompactHistoryBefore(5500_usec_ht);
+  ASSERT_EQ(0, blob_storage()->num_files());
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+SubDocKey(DocKey([], ["mydockey"]), ["large"; HT{ physical: 5000 }]) -> "value"
+SubDocKey(DocKey([], ["mydockey"]), ["other"; HT{ physical: 3000 }]) -> "value"
+SubDocKey(DocKey([], ["mydockey"]), ["small"; HT{ physical: 1000 }]) -> "value"
+      )#");
+}
+
+TEST_F(DocDBTest, RangeTombstones) {
+  // A range tombstone hides all documents of the range that were written before it, and is
+  // dropped together with them by a major compaction after the history cutoff passes it.
+  const DocKey doc_key_a(PrimitiveValues("a"));
+  const DocKey doc_key_b1(PrimitiveValues("b1"));
+  const DocKey doc_key_b2(PrimitiveValues("b2"));
+  const DocKey doc_key_c(PrimitiveValues("c"));
+  for (const auto* doc_key : {&doc_key_a, &doc_key_b1, &doc_key_b2, &doc_key_c}) {
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key->Encode(), "subkey"), PrimitiveValue("value"), 1000_usec_ht));
+  }
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  auto dwb = MakeDocWriteBatch();
+  dwb.DeleteRange(doc_key_b1.Encode().AsSlice(), doc_key_c.Encode().AsSlice());
+  ASSERT_OK(WriteToRocksDB(dwb, 2000_usec_ht));
+
+  const std::string kDocument = R"#(
+{
+  "subkey": "value"
+}
+      )#";
+  for (auto i = 0; i != 2; ++i) {
+    // Tombstones are loaded from the DB when it is reopened.
+    if (i) {
+      ASSERT_OK(FlushRocksDbAndWait());
+      ASSERT_OK(ReopenRocksDB());
+    }
+    VerifySubDocument(SubDocKey(doc_key_b1), 1500_usec_ht, kDocument);
+    VerifySubDocument(SubDocKey(doc_key_b1), 2500_usec_ht, "");
+    VerifySubDocument(SubDocKey(doc_key_b2), 2500_usec_ht, "");
+    VerifySubDocument(SubDocKey(doc_key_a), 2500_usec_ht, kDocument);
+    VerifySubDocument(SubDocKey(doc_key_c), 2500_usec_ht, kDocument);
+  }
+
+  // Writes after the tombstone are visible.
+  ASSERT_OK(SetPrimitive(
+      DocPath(doc_key_b2.Encode(), "subkey"), PrimitiveValue("new_value"), 3000_usec_ht));
+  VerifySubDocument(SubDocKey(doc_key_b1), 3500_usec_ht, "");
+  VerifySubDocument(SubDocKey(doc_key_b2), 3500_usec_ht, R"#(
+{
+  "subkey": "new_value"
+}
+      )#");
+
+  ASSERT_OK(FlushRocksDbAndWait());
+  FullyCompactHistoryBefore(2500_usec_ht);
+  ASSERT_DOC_DB_DEBUG_DUMP_STR_EQ(R"#(
+SubDocKey(DocKey([], ["a"]), ["subkey"; HT{ physical: 1000 }]) -> "value"
+SubDocKey(DocKey([], ["b2"]), ["subkey"; HT{ physical: 3000 }]) -> "new_value"
+SubDocKey(DocKey([], ["c"]), ["subkey"; HT{ physical: 1000 }]) -> "value"
+      )#");
+}
+
 TEST_F(DocDBTest, SetPrimitiveQL) {
   const DocKey doc_key(PrimitiveValues("mydockey", 123456));
   SetupRocksDBState(doc_key.Encode());
@@ -982,6 +1127,121 @@ SubDocKey(DocKey([], ["k1"]), ["s2"; HT{ physical: 1000 }]) -> "v21"; ttl: 0.003
       )#");
 }
 
+namespace {
+
+rocksdb::TableProperties CollectFileProperties(
+    const std::vector<std::pair<HybridTime, Value>>& entries) {
+  DocDBTablePropertiesCollectorFactory factory;
+  std::unique_ptr<rocksdb::TablePropertiesCollector> collector(
+      factory.CreateTablePropertiesCollector(
+          {rocksdb::TablePropertiesCollectorFactory::Context::kUnknownColumnFamily}));
+  const DocKey doc_key(PrimitiveValues("k1"));
+  for (const auto& entry : entries) {
+    const auto key = SubDocKey(doc_key, PrimitiveValue("s1"), entry.first).Encode();
+    const auto value = entry.second.Encode();
+    EXPECT_OK(collector->AddUserKey(key.AsSlice(), value, rocksdb::kEntryPut, 0, 0));
+  }
+  rocksdb::TableProperties result;
+  EXPECT_OK(collector->Finish(&result.user_collected_properties));
+  return result;
+}
+
+} // namespace
+
+TEST_F(DocDBTest, ExpiredFileFilter) {
+  auto retention_policy = std::make_shared<ManualHistoryRetentionPolicy>();
+  DocDBExpiredFileFilter filter(retention_policy, nullptr /* range_tombstones */);
+
+  // Expires at 3ms.
+  const auto oldest = CollectFileProperties({
+      {1000_usec_ht, Value(PrimitiveValue("v1"), 2ms)},
+      {2000_usec_ht, Value(PrimitiveValue::kTombstone)}});
+  // Expires only according to the table TTL.
+  const auto middle = CollectFileProperties({{4000_usec_ht, Value(PrimitiveValue("v2"))}});
+  // Expires at 11ms.
+  const auto newest = CollectFileProperties({{10000_usec_ht, Value(PrimitiveValue("v3"), 1ms)}});
+  const std::vector<const rocksdb::TableProperties*> files = {&newest, &middle, &oldest};
+
+  retention_policy->SetHistoryCutoff(2000_usec_ht);
+  ASSERT_EQ(0, filter.NumExpiredOldestFiles(files));
+  retention_policy->SetHistoryCutoff(5000_usec_ht);
+  ASSERT_EQ(1, filter.NumExpiredOldestFiles(files));
+
+  retention_policy->SetTableTTLForTests(1ms);
+  retention_policy->SetHistoryCutoff(6000_usec_ht);
+  ASSERT_EQ(2, filter.NumExpiredOldestFiles(files));
+  retention_policy->SetHistoryCutoff(20000_usec_ht);
+  ASSERT_EQ(3, filter.NumExpiredOldestFiles(files));
+
+  // Expired entries could not be dropped while they could hide older entries of other files.
+  const auto overlapping = CollectFileProperties({{1500_usec_ht, Value(PrimitiveValue("v4"))}});
+  retention_policy->SetTableTTLForTests(Value::kMaxTtl);
+  retention_policy->SetHistoryCutoff(5000_usec_ht);
+  ASSERT_EQ(0, filter.NumExpiredOldestFiles({&overlapping, &middle, &oldest}));
+
+  // Files without properties are never dropped.
+  ASSERT_EQ(0, filter.NumExpiredOldestFiles({&newest, nullptr, &oldest}));
+}
+
+TEST_F(DocDBTest, ExpiredBytesFileFilter) {
+  auto retention_policy = std::make_shared<ManualHistoryRetentionPolicy>();
+  DocDBExpiredFileFilter filter(
+      retention_policy, nullptr /* range_tombstones */, DropExpiredFiles::kFalse,
+      0.5 /* expired_bytes_ratio */);
+
+  // Expires at 3s and 12s, the last value never expires.
+  auto properties = CollectFileProperties({
+      {1000000_usec_ht, Value(PrimitiveValue("v1"), 2s)},
+      {2000000_usec_ht, Value(PrimitiveValue("v2"), 10s)},
+      {3000000_usec_ht, Value(PrimitiveValue("v3"))}});
+  auto expiring_bytes = properties.user_collected_properties[kExpiringBytesProperty];
+  ASSERT_FALSE(expiring_bytes.empty());
+  Slice input(expiring_bytes);
+  ASSERT_EQ(3000000, ASSERT_RESULT(util::FastDecodeUnsignedVarInt(&input)));
+  const auto entry_bytes = ASSERT_RESULT(util::FastDecodeUnsignedVarInt(&input));
+  properties.raw_key_size = 3 * entry_bytes;
+
+  retention_policy->SetHistoryCutoff(2000000_usec_ht);
+  ASSERT_FALSE(filter.HasManyExpiredBytes(&properties));
+  retention_policy->SetHistoryCutoff(5000000_usec_ht);
+  ASSERT_FALSE(filter.HasManyExpiredBytes(&properties));
+  retention_policy->SetHistoryCutoff(20000000_usec_ht);
+  ASSERT_TRUE(filter.HasManyExpiredBytes(&properties));
+
+  // Expired files are not dropped when it is disabled.
+  ASSERT_EQ(0, filter.NumExpiredOldestFiles({&properties}));
+}
+
+TEST_F(DocDBTest, ObsoleteVersionsFileFilter) {
+  auto retention_policy = std::make_shared<ManualHistoryRetentionPolicy>();
+  DocDBExpiredFileFilter filter(
+      retention_policy, nullptr /* range_tombstones */, DropExpiredFiles::kFalse,
+      0 /* expired_bytes_ratio */, 0.5 /* obsolete_versions_ratio */);
+
+  // Versions are ordered from the newest to the oldest, as in SST files. Versions at 1s, 2s and 3s
+  // are overwritten at 2s, 3s and 4s, the TTL merge record at 5s does not overwrite the version at
+  // 4s.
+  auto properties = CollectFileProperties({
+      {5000000_usec_ht, Value(PrimitiveValue(ValueType::kObject), 10s,
+                              Value::kInvalidUserTimestamp, Value::kTtlFlag)},
+      {4000000_usec_ht, Value(PrimitiveValue("v4"))},
+      {3000000_usec_ht, Value(PrimitiveValue("v3"))},
+      {2000000_usec_ht, Value(PrimitiveValue("v2"))},
+      {1000000_usec_ht, Value(PrimitiveValue("v1"))}});
+  ASSERT_EQ("5", properties.user_collected_properties[kMaxVersionsPerKeyProperty]);
+  properties.num_entries = 5;
+
+  retention_policy->SetHistoryCutoff(3500000_usec_ht);
+  ASSERT_FALSE(filter.HasManyObsoleteVersions(&properties));
+  retention_policy->SetHistoryCutoff(4500000_usec_ht);
+  ASSERT_TRUE(filter.HasManyObsoleteVersions(&properties));
+  retention_policy->SetHistoryCutoff(10000000_usec_ht);
+  ASSERT_TRUE(filter.HasManyObsoleteVersions(&properties));
+
+  // Expired bytes check is disabled.
+  ASSERT_FALSE(filter.HasManyExpiredBytes(&properties));
+}
+
 // Compaction testing with TTL merge records for generic Redis collections.
 // Observe that because only collection-level merge records are supported,
 // all tests begin with initializing a vanilla collection and adding TTL over it.
@@ -2542,6 +2802,160 @@ TEST_F(DocDBTest, BloomFilterTest) {
   ASSERT_NO_FATALS(CheckBloom(2, &total_bloom_useful, 2, &total_table_iterators));
 }
 
+TEST_F(DocDBTest, MemTableFilter) {
+  FLAGS_regular_db_memtable_filter_bits = 8 * 1024;
+  ASSERT_OK(ReinitDBOptions());
+  rocksdb::SetPerfLevel(rocksdb::PerfLevel::kEnableCount);
+
+  DocKey key1(0, PrimitiveValues("key1"), PrimitiveValues());
+  DocKey key2(0, PrimitiveValues("key2"), PrimitiveValues());
+  HybridTime ht;
+  ASSERT_OK(ht.FromUint64(1000));
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(key1.Encode()), PrimitiveValue("value")));
+  ASSERT_OK(WriteToRocksDB(dwb, ht));
+
+  for (const auto* key : {&key1, &key2}) {
+    const bool expect_found = key == &key1;
+    rocksdb::perf_context.Reset();
+    SubDocument doc_from_rocksdb;
+    bool subdoc_found_in_rocksdb = false;
+    auto encoded_subdoc_key = SubDocKey(*key).EncodeWithoutHt();
+    GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
+    ASSERT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId,
+        boost::none /* txn_op_context */, CoarseTimePoint::max() /* deadline */));
+    ASSERT_EQ(expect_found, subdoc_found_in_rocksdb);
+    // The memtable is only checked against the filter, without being iterated, for key2.
+    if (expect_found) {
+      ASSERT_GT(rocksdb::perf_context.bloom_memtable_hit_count, 0);
+      ASSERT_EQ(rocksdb::perf_context.bloom_memtable_miss_count, 0);
+    } else {
+      ASSERT_EQ(rocksdb::perf_context.bloom_memtable_hit_count, 0);
+      ASSERT_GT(rocksdb::perf_context.bloom_memtable_miss_count, 0);
+    }
+  }
+}
+
+// Lookups of prefixes with less range components than the range prefix bloom filter key, like the
+// hashed part of strong intents, should not skip SST files and memtables with matching keys.
+TEST_F(DocDBTest, RangePrefixFilterShortKeys) {
+  FLAGS_docdb_bloom_filter_range_components = 1;
+  FLAGS_regular_db_memtable_filter_bits = 8 * 1024;
+  ASSERT_OK(ReinitDBOptions());
+
+  const DocKey flushed_key(0x1234, PrimitiveValues("h1"), PrimitiveValues("a"));
+  const DocKey memtable_key(0x5678, PrimitiveValues("h2"), PrimitiveValues("b"));
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(flushed_key.Encode()), PrimitiveValue("value")));
+  ASSERT_OK(WriteToRocksDB(dwb, 1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+  dwb.Clear();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(memtable_key.Encode()), PrimitiveValue("value")));
+  ASSERT_OK(WriteToRocksDB(dwb, 2000_usec_ht));
+
+  for (const auto* key : {&flushed_key, &memtable_key}) {
+    const auto encoded_key = key->Encode();
+    const auto hashed_size = ASSERT_RESULT(
+        DocKey::EncodedSize(encoded_key.AsSlice(), DocKeyPart::HASHED_PART_ONLY));
+    for (const Slice prefix : {Slice(encoded_key.data().data(), hashed_size),
+                               encoded_key.AsSlice()}) {
+      auto iter = CreateRocksDBIterator(
+          rocksdb(), BloomFilterMode::USE_BLOOM_FILTER, prefix, rocksdb::kDefaultQueryId);
+      iter->Seek(prefix);
+      ASSERT_TRUE(iter->Valid()) << key->ToString() << ", " << prefix.ToDebugHexString();
+      ASSERT_TRUE(iter->key().starts_with(prefix)) << key->ToString();
+    }
+  }
+}
+
+TEST_F(DocDBTest, DeadlineInfoCancellation) {
+  std::atomic<bool> cancelled{false};
+  DeadlineInfo not_cancellable(CoarseTimePoint::max());
+  boost::optional<DeadlineInfo> cancellable;
+  {
+    ScopedCancellationChecker cancellation_checker([&cancelled] { return cancelled.load(); });
+    cancellable.emplace(CoarseTimePoint::max());
+  }
+  for (int i = 0; i != 2048; ++i) {
+    ASSERT_FALSE(cancellable->CheckAndSetDeadlinePassed());
+  }
+  cancelled = true;
+  bool passed = false;
+  for (int i = 0; i != 1024 && !passed; ++i) {
+    ASSERT_FALSE(not_cancellable.CheckAndSetDeadlinePassed());
+    passed = cancellable->CheckAndSetDeadlinePassed();
+  }
+  ASSERT_TRUE(passed);
+}
+
+TEST_F(DocDBTest, StorageProfile) {
+  DocKey key(0, PrimitiveValues("key"), PrimitiveValues());
+  auto dwb = MakeDocWriteBatch();
+  ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue("value")));
+  ASSERT_OK(WriteToRocksDB(dwb, 1000_usec_ht));
+  ASSERT_OK(FlushRocksDbAndWait());
+
+  ScopedStorageProfile scoped_profile;
+  SubDocument doc_from_rocksdb;
+  bool subdoc_found_in_rocksdb = false;
+  auto encoded_subdoc_key = SubDocKey(key).EncodeWithoutHt();
+  GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
+  ASSERT_OK(GetSubDocument(
+      doc_db(), data, rocksdb::kDefaultQueryId, boost::none /* txn_op_context */,
+      CoarseTimePoint::max() /* deadline */));
+  ASSERT_TRUE(subdoc_found_in_rocksdb);
+  auto profile = scoped_profile.Finish();
+  LOG(INFO) << "Storage profile: " << profile.ToString();
+  ASSERT_GT(profile.seeks, 0);
+  ASSERT_GT(profile.block_reads + profile.block_cache_hits, 0);
+}
+
+TEST_F(DocDBTest, SkipFilesWrittenAfterReadTime) {
+  FLAGS_docdb_skip_files_written_after_read_time = true;
+  DocKey key(0, PrimitiveValues("key"), PrimitiveValues());
+  for (const auto& entry : {std::make_pair(1000_usec_ht, "v1"),
+                            std::make_pair(3000_usec_ht, "v2")}) {
+    auto dwb = MakeDocWriteBatch();
+    ASSERT_OK(dwb.SetPrimitive(DocPath(key.Encode()), PrimitiveValue(entry.second)));
+    ASSERT_OK(WriteToRocksDB(dwb, entry.first));
+    ASSERT_OK(FlushRocksDbAndWait());
+  }
+
+  // The file written at 3ms is only read when the global limit of the read time is not before it.
+  for (const auto& read_time : {
+      std::make_tuple(ReadHybridTime::SingleTime(2000_usec_ht), "v1", 1U),
+      std::make_tuple(ReadHybridTime::SingleTime(4000_usec_ht), "v2", 2U),
+      std::make_tuple(ReadHybridTime::Max(), "v2", 2U)}) {
+    const auto iterators_before =
+        options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS);
+    SubDocument doc_from_rocksdb;
+    bool subdoc_found_in_rocksdb = false;
+    auto encoded_subdoc_key = SubDocKey(key).EncodeWithoutHt();
+    GetSubDocumentData data = { encoded_subdoc_key, &doc_from_rocksdb, &subdoc_found_in_rocksdb };
+    ASSERT_OK(GetSubDocument(
+        doc_db(), data, rocksdb::kDefaultQueryId, boost::none /* txn_op_context */,
+        CoarseTimePoint::max() /* deadline */, std::get<0>(read_time)));
+    ASSERT_TRUE(subdoc_found_in_rocksdb);
+    ASSERT_EQ(std::get<1>(read_time), doc_from_rocksdb.GetString());
+    ASSERT_EQ(std::get<2>(read_time),
+              options().statistics->getTickerCount(rocksdb::NO_TABLE_CACHE_ITERATORS) -
+                  iterators_before);
+  }
+}
+
+TEST_F(DocDBTest, CompactionTimeWindows) {
+  DocDBCompactionTimeWindows time_windows(10ms);
+  ConsensusFrontier frontier;
+  frontier.set_hybrid_time(15000_usec_ht);
+  const auto window = time_windows.FileWindow(&frontier);
+  frontier.set_hybrid_time(19999_usec_ht);
+  ASSERT_EQ(window, time_windows.FileWindow(&frontier));
+  frontier.set_hybrid_time(20000_usec_ht);
+  ASSERT_EQ(window + 1, time_windows.FileWindow(&frontier));
+  ASSERT_EQ(0, time_windows.FileWindow(nullptr));
+}
+
 TEST_F(DocDBTest, MergingIterator) {
   // Test for the case described in https://yugabyte.atlassian.net/browse/ENG-1677.
 
@@ -3190,6 +3604,131 @@ TXN REV 30303030-3030-3030-3030-303030303032 HT{ physical: 5000 w: 2 } -> \
       )#");
 }
 
+TEST_F(DocDBTest, ApplyIntentsByBatches) {
+  constexpr int kNumSubKeys = 10;
+  const TransactionId txn_id = ASSERT_RESULT(FullyDecodeTransactionId("0000000000000001"));
+  const KeyBytes encoded_doc_key(DocKey(PrimitiveValues("mydockey", 123456)).Encode());
+
+  auto write_transaction = [this, &txn_id, &encoded_doc_key] {
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    SetCurrentTransactionId(txn_id);
+    for (int i = 0; i != kNumSubKeys; ++i) {
+      ASSERT_OK(SetPrimitive(
+          DocPath(encoded_doc_key, Format("subkey$0", i)), PrimitiveValue(Format("value$0", i)),
+          1000_usec_ht));
+    }
+    ResetCurrentTransactionId();
+  };
+
+  // Applies intents of the transaction by batches of the specified size, returns the number of
+  // batches.
+  auto apply_transaction = [this, &txn_id](size_t max_records) -> Result<size_t> {
+    ApplyTransactionState apply_state;
+    size_t num_batches = 0;
+    do {
+      rocksdb::WriteBatch regular_batch;
+      rocksdb::WriteBatch intents_batch;
+      RETURN_NOT_OK(PrepareApplyIntentsBatch(
+          txn_id, 2000_usec_ht, &regular_batch, intents_db(), &intents_batch, &apply_state,
+          max_records));
+      RETURN_NOT_OK(rocksdb()->Write(write_options(), &regular_batch));
+      RETURN_NOT_OK(intents_db()->Write(write_options(), &intents_batch));
+      ++num_batches;
+    } while (apply_state.active());
+    return num_batches;
+  };
+
+  write_transaction();
+  ASSERT_EQ(1, ASSERT_RESULT(apply_transaction(0 /* max_records */)));
+  const auto expected = DocDBDebugDumpToStr();
+  ASSERT_EQ(std::string::npos, expected.find("TXN REV"));
+
+  ASSERT_OK(DestroyRocksDB());
+  ASSERT_OK(OpenRocksDB());
+  write_transaction();
+  ASSERT_GE(ASSERT_RESULT(apply_transaction(3 /* max_records */)), kNumSubKeys / 3);
+  ASSERT_EQ(expected, DocDBDebugDumpToStr());
+}
+
+// Compares the cost of applying transactions, that looks up reverse index records by transaction
+// id and then every intent by its key, with and without the intents DB prefix hash index.
+TEST_F(DocDBTest, IntentsDBPrefixHashIndex) {
+  constexpr int kNumTransactions = 200;
+  constexpr int kNumRowsPerTransaction = 20;
+  constexpr int kNumIterations = 10;
+
+  std::vector<TransactionId> txn_ids;
+  for (int i = 0; i != kNumTransactions; ++i) {
+    txn_ids.push_back(GenerateTransactionId());
+  }
+
+  auto write_transactions = [this, &txn_ids] {
+    SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+    for (int i = 0; i != kNumTransactions; ++i) {
+      SetCurrentTransactionId(txn_ids[i]);
+      for (int j = 0; j != kNumRowsPerTransaction; ++j) {
+        const KeyBytes encoded_doc_key(
+            DocKey(PrimitiveValues(Format("row$0", j * kNumTransactions + i), 123456)).Encode());
+        ASSERT_OK(SetPrimitive(
+            DocPath(encoded_doc_key, "subkey"), PrimitiveValue(Format("value$0", i)),
+            1000_usec_ht));
+      }
+      // Keep the last transactions in the memtable, so both SST file and memtable lookups are
+      // covered.
+      if (i == kNumTransactions / 2) {
+        rocksdb::FlushOptions flush_options;
+        flush_options.wait = true;
+        ASSERT_OK(intents_db()->Flush(flush_options));
+      }
+    }
+    ResetCurrentTransactionId();
+  };
+
+  // Prepares apply batches of all transactions without writing them, so every iteration performs
+  // the same lookups. Batches of the first iteration are appended to 'batches'.
+  auto apply_transactions = [this, &txn_ids](std::string* batches) -> Result<MonoDelta> {
+    const auto start = MonoTime::Now();
+    for (int iteration = 0; iteration != kNumIterations; ++iteration) {
+      for (const auto& txn_id : txn_ids) {
+        rocksdb::WriteBatch regular_batch;
+        rocksdb::WriteBatch intents_batch;
+        RETURN_NOT_OK(PrepareApplyIntentsBatch(
+            txn_id, 2000_usec_ht, &regular_batch, intents_db(), &intents_batch));
+        if (iteration == 0) {
+          *batches += regular_batch.Data();
+          *batches += intents_batch.Data();
+        }
+      }
+    }
+    return MonoTime::Now() - start;
+  };
+
+  std::string expected_dump;
+  std::string expected_batches;
+  for (bool use_prefix_hash_index : {false, true}) {
+    FLAGS_intents_db_use_prefix_hash_index = use_prefix_hash_index;
+    ASSERT_OK(DestroyRocksDB());
+    ASSERT_OK(OpenRocksDB());
+    write_transactions();
+
+    std::string batches;
+    const auto elapsed = ASSERT_RESULT(apply_transactions(&batches));
+    LOG(INFO) << "Prefix hash index: " << use_prefix_hash_index << ", prepared "
+              << kNumIterations * kNumTransactions << " transaction applies in " << elapsed;
+
+    // Total order iteration over the intents DB is not affected by the prefix hash index.
+    const auto dump = DocDBDebugDumpToStr();
+    if (!use_prefix_hash_index) {
+      expected_dump = dump;
+      expected_batches = batches;
+      ASSERT_NE(std::string::npos, expected_dump.find("TXN REV"));
+    } else {
+      ASSERT_EQ(expected_dump, dump);
+      ASSERT_EQ(expected_batches, batches);
+    }
+  }
+}
+
 TEST_F(DocDBTest, ForceFlushedFrontier) {
   // We run with compactions disabled, because they may interefere with force-setting the OpId.
   ASSERT_OK(DisableCompactions());
@@ -24,6 +24,7 @@
 
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/cql_operation.h"
+#include "yb/docdb/doc_row_cache.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/docdb.h"
@@ -33,7 +34,9 @@
 #include "yb/docdb/docdb_util.h"
 #include "yb/docdb/intent.h"
 #include "yb/docdb/intent_aware_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/pgsql_operation.h"
+#include "yb/docdb/range_tombstones.h"
 #include "yb/docdb/shared_lock_manager.h"
 #include "yb/docdb/subdocument.h"
 #include "yb/docdb/value.h"
@@ -335,7 +338,7 @@ void PrepareNonTransactionWriteBatch(
 
 #ifndef NDEBUG
     // Debug-only: ensure all keys we get in Raft replication can be decoded.
-    {
+    if (!IsRangeTombstoneKey(kv_pair.key())) {
       SubDocKey subdoc_key;
       Status s = subdoc_key.FullyDecodeFromKeyWithOptionalHybridTime(kv_pair.key());
       CHECK(s.ok())
@@ -553,6 +556,47 @@ void SeekToLowerBound(const SliceKeyBound& lower_bound, IntentAwareIterator* ite
   }
 }
 
+// Converts value of the packed row column to the same form as if it was read from its own key.
+SubDocument PackedColumnToSubDocument(PrimitiveValue value, const DocHybridTime& write_time) {
+  value.SetTtl(-1);
+  value.SetWriteTime(write_time.hybrid_time().GetPhysicalValueMicros());
+  return SubDocument(std::move(value));
+}
+
+// Adds liveness column and all columns of the packed row to result.
+CHECKED_STATUS AddPackedColumns(
+    const Value& packed_row, const DocHybridTime& write_time, SubDocument* result) {
+  uint32_t schema_version;
+  PackedColumns columns;
+  RETURN_NOT_OK(DecodePackedRow(packed_row.packed_row(), &schema_version, &columns));
+  result->SetChild(PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn),
+                   PackedColumnToSubDocument(PrimitiveValue(), write_time));
+  for (auto& column : columns) {
+    result->SetChild(PrimitiveValue(column.first),
+                     PackedColumnToSubDocument(std::move(column.second), write_time));
+  }
+  return Status::OK();
+}
+
+// If key is a column of the packed row, that was added to result, moves its value to descendant.
+// So it would be overwritten by later writes of this column, or stay as is otherwise.
+CHECKED_STATUS TakePackedColumn(
+    const Slice& key, const GetSubDocumentData& data, SubDocument* descendant) {
+  Slice subkey = key;
+  subkey.remove_prefix(data.subdocument_key.size());
+  PrimitiveValue child;
+  RETURN_NOT_OK(child.DecodeFromKey(&subkey));
+  if (!subkey.empty()) {
+    return Status::OK();
+  }
+  auto* packed_column = data.result->GetChild(child);
+  if (packed_column != nullptr) {
+    *descendant = std::move(*packed_column);
+    data.result->DeleteChild(child);
+  }
+  return Status::OK();
+}
+
 // This function does not assume that object init_markers are present. If no init marker is present,
 // or if a tombstone is found at some level, it still looks for subkeys inside it if they have
 // larger timestamps.
@@ -575,6 +619,7 @@ CHECKED_STATUS BuildSubDocument(
     int64* num_values_observed) {
   VLOG(3) << "BuildSubDocument data: " << data << " read_time: " << iter->read_time()
           << " low_ts: " << low_ts;
+  bool has_packed_columns = false;
   while (iter->valid()) {
     if (data.deadline_info && data.deadline_info->CheckAndSetDeadlinePassed()) {
       return STATUS(Expired, "Deadline for query passed.");
@@ -644,6 +689,14 @@ CHECKED_STATUS BuildSubDocument(
         }
         if (is_collection) {
           *data.result = SubDocument(value_type);
+          if (doc_value.is_packed_row()) {
+            RETURN_NOT_OK(AddPackedColumns(doc_value, write_time, data.result));
+            has_packed_columns = true;
+          }
+        } else if (data.result->value_type() != ValueType::kInvalid) {
+          // The result could be already filled only from a packed row, when it was written
+          // before this tombstone.
+          *data.result = SubDocument(ValueType::kInvalid);
         }
 
         // If the subkey lower bound filters out the key we found, we want to skip to the lower
@@ -689,7 +742,7 @@ CHECKED_STATUS BuildSubDocument(
           return Status::OK();
         }
         if (data.low_index->CanInclude(*num_values_observed)) {
-          *data.result = SubDocument(doc_value.primitive_value());
+          *data.result = SubDocument(std::move(*doc_value.mutable_primitive_value()));
         }
         (*num_values_observed)++;
         VLOG(3) << "SeekOutOfSubDoc: " << SubDocKey::DebugSliceToString(key);
@@ -698,6 +751,9 @@ CHECKED_STATUS BuildSubDocument(
       }
     }
     SubDocument descendant{PrimitiveValue(ValueType::kInvalid)};
+    if (has_packed_columns) {
+      RETURN_NOT_OK(TakePackedColumn(key, data, &descendant));
+    }
     // TODO: what if the key we found is the same as before?
     //       We'll get into an infinite recursion then.
     {
@@ -759,10 +815,10 @@ CHECKED_STATUS BuildSubDocument(
         PrimitiveValue child;
         RETURN_NOT_OK(child.DecodeFromKey(&temp));
         if (temp.empty()) {
-          current->SetChild(child, std::move(descendant));
+          current->SetChild(std::move(child), std::move(descendant));
           break;
         }
-        current = current->GetOrAddChild(child).first;
+        current = current->GetOrAddChild(std::move(child)).first;
       }
     }
   }
@@ -857,10 +913,20 @@ yb::Status GetSubDocument(
   auto iter = CreateIntentAwareIterator(
       doc_db, BloomFilterMode::USE_BLOOM_FILTER, data.subdocument_key, query_id,
       txn_op_context, deadline, read_time);
+  if (iter->reads_intents()) {
+    // Intents that affect the subdocument could also be written for its ancestors, so check the
+    // range of the whole document.
+    const auto doc_key_size = VERIFY_RESULT(
+        DocKey::EncodedSize(data.subdocument_key, DocKeyPart::WHOLE_DOC_KEY));
+    const Slice doc_key(data.subdocument_key.data(), doc_key_size);
+    iter->SkipIntentsIfNoneInRange(doc_key, KeyBytes(doc_key, ValueTypeAsChar::kMaxByte));
+  }
   return GetSubDocument(iter.get(), data, nullptr /* projection */, SeekFwdSuffices::kFalse);
 }
 
-yb::Status GetSubDocument(
+namespace {
+
+yb::Status DoGetSubDocument(
     IntentAwareIterator *db_iter,
     const GetSubDocumentData& data,
     const std::vector<PrimitiveValue>* projection,
@@ -957,6 +1023,11 @@ yb::Status GetSubDocument(
   // Seed key_bytes with the subdocument key. For each subkey in the projection, build subdocument
   // and reuse key_bytes while appending the subkey.
   *data.result = SubDocument();
+  // Columns of the packed row are used unless overwritten by later writes of the same column.
+  SubDocument packed_columns;
+  if (doc_value.is_packed_row()) {
+    RETURN_NOT_OK(AddPackedColumns(doc_value, max_overwrite_ht, &packed_columns));
+  }
   KeyBytes key_bytes(data.subdocument_key);
   const size_t subdocument_key_size = key_bytes.size();
   for (const PrimitiveValue& subkey : *projection) {
@@ -969,6 +1040,12 @@ yb::Status GetSubDocument(
     IntentAwareIteratorPrefixScope prefix_scope(key_bytes, db_iter);
     db_iter->SeekForward(&key_bytes);
     SubDocument descendant(ValueType::kInvalid);
+    if (doc_value.is_packed_row()) {
+      auto* packed_column = packed_columns.GetChild(subkey);
+      if (packed_column != nullptr) {
+        descendant = std::move(*packed_column);
+      }
+    }
     int64 num_values_observed = 0;
     RETURN_NOT_OK(BuildSubDocument(
         db_iter, data.Adjusted(key_bytes, &descendant), max_overwrite_ht,
@@ -979,6 +1056,11 @@ yb::Status GetSubDocument(
     // Restore subdocument key by truncating the appended subkey.
     key_bytes.Truncate(subdocument_key_size);
   }
+  if (doc_value.is_packed_row()) {
+    // Packed row contains the liveness column, so the row exists even if all projected columns
+    // are null.
+    *data.doc_found = true;
+  }
   // Make sure the iterator is placed outside the whole document in the end.
   key_bytes.Truncate(dockey_size);
   key_bytes.AppendValueType(ValueType::kMaxByte);
@@ -986,6 +1068,29 @@ yb::Status GetSubDocument(
   return Status::OK();
 }
 
+} // namespace
+
+yb::Status GetSubDocument(
+    IntentAwareIterator *db_iter,
+    const GetSubDocumentData& data,
+    const std::vector<PrimitiveValue>* projection,
+    const SeekFwdSuffices seek_fwd_suffices) {
+  // The row cache does not position the iterator, so use it only when the caller does not rely
+  // on the iterator position after this call.
+  auto* row_cache = db_iter->row_cache();
+  if (row_cache == nullptr || projection != nullptr || seek_fwd_suffices ||
+      !DocRowCache::IsCacheableRequest(data)) {
+    return DoGetSubDocument(db_iter, data, projection, seek_fwd_suffices);
+  }
+  const auto read_ht = db_iter->read_time().read;
+  if (row_cache->Lookup(read_ht, data)) {
+    return Status::OK();
+  }
+  RETURN_NOT_OK(DoGetSubDocument(db_iter, data, projection, seek_fwd_suffices));
+  row_cache->Insert(read_ht, data);
+  return Status::OK();
+}
+
 // Note: Do not use if also retrieving other value, as some work will be repeated.
 // Assumes every value has a TTL, and the TTL is stored in the row with this key.
 // Also observe that tombstone checking only works because we assume the key has
@@ -1163,6 +1268,7 @@ void DocDBDebugDump(rocksdb::DB* rocksdb, ostream& out, StorageDbType db_type,
                     IncludeBinary include_binary) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = rocksdb::kDefaultQueryId;
+  read_opts.total_order_seek = true;
   auto iter = unique_ptr<rocksdb::Iterator>(rocksdb->NewIterator(read_opts));
   iter->SeekToFirst();
 
@@ -1250,18 +1356,23 @@ CHECKED_STATUS IntentToWriteRequest(
 Status PrepareApplyIntentsBatch(
     const TransactionId &transaction_id, HybridTime commit_ht,
     rocksdb::WriteBatch *regular_batch,
-    rocksdb::DB *intents_db, rocksdb::WriteBatch *intents_batch) {
+    rocksdb::DB *intents_db, rocksdb::WriteBatch *intents_batch,
+    ApplyTransactionState* apply_state, size_t max_records) {
+  // Both iterators stay within the prefix they were seeked to: the reverse index iterator scans
+  // records of a single transaction, and the intent iterator only checks that the exact intent key
+  // is present.
   Slice reverse_index_upperbound;
   auto reverse_index_iter = CreateRocksDBIterator(
       intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
-      nullptr /* read_filter */, &reverse_index_upperbound);
+      nullptr /* read_filter */, &reverse_index_upperbound, SeekMode::SAME_PREFIX_ONLY);
 
   std::unique_ptr<rocksdb::Iterator> intent_iter;
   // If we don't have regular_batch, it means that we just removing intents.
   // We don't need intent iterator, since reverse index iterator is enough in this case.
   if (regular_batch) {
     intent_iter = CreateRocksDBIterator(
-        intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId);
+        intents_db, BloomFilterMode::DONT_USE_BLOOM_FILTER, boost::none, rocksdb::kDefaultQueryId,
+        nullptr /* read_filter */, nullptr /* iterate_upper_bound */, SeekMode::SAME_PREFIX_ONLY);
   }
 
   KeyBytes txn_reverse_index_prefix;
@@ -1272,11 +1383,17 @@ Status PrepareApplyIntentsBatch(
   txn_reverse_index_upperbound.AppendValueType(ValueType::kMaxByte);
   reverse_index_upperbound = txn_reverse_index_upperbound.AsSlice();
 
-  reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  IntraTxnWriteId write_id = 0;
+  if (apply_state && apply_state->active()) {
+    reverse_index_iter->Seek(apply_state->key);
+    write_id = apply_state->write_id;
+  } else {
+    reverse_index_iter->Seek(txn_reverse_index_prefix.data());
+  }
 
   DocHybridTimeBuffer doc_ht_buffer;
 
-  IntraTxnWriteId write_id = 0;
+  size_t num_records = 0;
   while (reverse_index_iter->Valid()) {
     rocksdb::Slice key_slice(reverse_index_iter->key());
 
@@ -1290,6 +1407,13 @@ Status PrepareApplyIntentsBatch(
     // If the key ends at the transaction id then it is transaction metadata (status tablet,
     // isolation level etc.).
     if (key_slice.size() > txn_reverse_index_prefix.size()) {
+      if (apply_state && max_records != 0 && num_records == max_records) {
+        apply_state->key = key_slice.ToBuffer();
+        apply_state->write_id = write_id;
+        return Status::OK();
+      }
+      ++num_records;
+
       // Value of reverse index is a key of original intent record, so seek it and check match.
       if (regular_batch) {
         RETURN_NOT_OK(IntentToWriteRequest(
@@ -1298,6 +1422,10 @@ Status PrepareApplyIntentsBatch(
       }
 
       intents_batch->Delete(reverse_index_iter->value());
+    } else if (apply_state) {
+      // Metadata is required until the last batch, it is removed after the loop.
+      reverse_index_iter->Next();
+      continue;
     }
 
     intents_batch->Delete(reverse_index_iter->key());
@@ -1305,8 +1433,17 @@ Status PrepareApplyIntentsBatch(
     reverse_index_iter->Next();
   }
 
+  if (apply_state) {
+    intents_batch->Delete(txn_reverse_index_prefix.AsSlice());
+    *apply_state = ApplyTransactionState();
+  }
+
   return Status::OK();
 }
 
+std::string ApplyTransactionState::ToString() const {
+  return Format("{ key: $0 write_id: $1 }", Slice(key).ToDebugHexString(), write_id);
+}
+
 }  // namespace docdb
 }  // namespace yb
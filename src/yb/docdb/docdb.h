@@ -174,10 +174,34 @@ void PrepareTransactionWriteBatch(
     IsolationLevel isolation_level,
     IntraTxnWriteId* write_id);
 
+// Position in the reverse index of the transaction, where application of its intents should be
+// continued, when intents are applied by several batches.
+struct ApplyTransactionState {
+  // Reverse index key of the first intent that was not applied yet.
+  // Empty when application was not started yet or is already complete.
+  std::string key;
+
+  // Write id that should be used for the first intent that was not applied yet.
+  IntraTxnWriteId write_id = 0;
+
+  bool active() const {
+    return !key.empty();
+  }
+
+  std::string ToString() const;
+};
+
+// Fills regular_batch with records of the transaction intents, and intents_batch with removal of
+// those intents. If regular_batch is null, intents are just removed.
+// If apply_state is specified, processing starts from the position stored in it, and at most
+// max_records intents are processed (0 means unlimited). After that, apply_state contains the
+// position for the next batch, or is inactive if all intents of the transaction were processed.
+// Transaction metadata is removed only by the last batch.
 CHECKED_STATUS PrepareApplyIntentsBatch(
     const TransactionId& transaction_id, HybridTime commit_ht,
     rocksdb::WriteBatch* regular_batch,
-    rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch);
+    rocksdb::DB* intents_db, rocksdb::WriteBatch* intents_batch,
+    ApplyTransactionState* apply_state = nullptr, size_t max_records = 0);
 
 // A visitor class that could be overridden to consume results of scanning SubDocuments.
 // See e.g. SubDocumentBuildingVisitor (used in implementing GetSubDocument) as example usage.
@@ -328,6 +352,8 @@ class IndexBound {
     return is_lower_bound_ ? index_ <= curr_index : index_ >= curr_index;
   }
 
+  bool is_empty() const { return index_ == -1; }
+
   static const IndexBound& Empty();
 
  private:
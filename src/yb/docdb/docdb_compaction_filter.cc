@@ -13,19 +13,25 @@
 
 #include "yb/docdb/docdb_compaction_filter.h"
 
+#include <map>
 #include <memory>
 
+#include <boost/optional.hpp>
+
 #include <glog/logging.h>
 
 #include "yb/rocksdb/compaction_filter.h"
+#include "yb/util/fast_varint.h"
 #include "yb/util/string_util.h"
 
+#include "yb/docdb/blob_storage.h"
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/value.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/rocksutil/yb_rocksdb.h"
+#include "yb/server/hybrid_clock.h"
 
 using std::shared_ptr;
 using std::unique_ptr;
@@ -41,9 +47,15 @@ namespace docdb {
 
 DocDBCompactionFilter::DocDBCompactionFilter(
     HistoryRetentionDirective retention,
-    IsMajorCompaction is_major_compaction)
+    IsMajorCompaction is_major_compaction,
+    const KeyBounds* key_bounds,
+    BlobStorage* blob_storage,
+    RangeTombstonesSnapshot range_tombstones)
     : retention_(std::move(retention)),
-      is_major_compaction_(is_major_compaction) {
+      is_major_compaction_(is_major_compaction),
+      key_bounds_(key_bounds),
+      blob_storage_(blob_storage),
+      range_tombstones_(std::move(range_tombstones)) {
 }
 
 DocDBCompactionFilter::~DocDBCompactionFilter() {
@@ -81,6 +93,25 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
     return FilterDecision::kDiscard;
   }
 
+  // Range tombstones are kept by all tablets produced by a split. A major compaction drops entries
+  // deleted by the tombstone before the history cutoff, so the tombstone itself is not needed.
+  if (IsRangeTombstoneKey(key)) {
+    DocHybridTime tombstone_ht;
+    RETURN_NOT_OK(tombstone_ht.DecodeFromEnd(key));
+    return is_major_compaction_ && tombstone_ht.hybrid_time() <= history_cutoff
+        ? FilterDecision::kDiscard : FilterDecision::kKeep;
+  }
+
+  // Keys of the sibling tablet, that remain in SST files shared after a tablet split.
+  if (key_bounds_ && !key_bounds_->IsWithinBounds(key)) {
+    return FilterDecision::kDiscard;
+  }
+
+  // Older versions of the same key are deleted by the same tombstone, so they are also dropped.
+  if (VERIFY_RESULT(IsDeletedByRange(key))) {
+    return FilterDecision::kDiscard;
+  }
+
   auto same_bytes = strings::MemoryDifferencePos(
       key.data(), prev_subdoc_key_.data(), std::min(key.size(), prev_subdoc_key_.size()));
 
@@ -281,8 +312,64 @@ Result<FilterDecision> DocDBCompactionFilter::DoFilter(
   // compactions. However, we do need to update the overwrite hybrid time stack in this case (as we
   // just did), because this deletion (tombstone) entry might be the only reason for cleaning up
   // more entries appearing at earlier hybrid times.
-  return value_type == ValueType::kTombstone && is_major_compaction_ ? FilterDecision::kDiscard
-                                                                     : FilterDecision::kKeep;
+  if (value_type == ValueType::kTombstone && is_major_compaction_) {
+    return FilterDecision::kDiscard;
+  }
+
+  if (blob_storage_) {
+    RETURN_NOT_OK(UpdateBlobReference(existing_value, new_value, value_changed));
+  }
+  return FilterDecision::kKeep;
+}
+
+Result<bool> DocDBCompactionFilter::IsDeletedByRange(const Slice& key) const {
+  if (!range_tombstones_ || range_tombstones_->empty()) {
+    return false;
+  }
+  DocHybridTime doc_ht;
+  RETURN_NOT_OK(doc_ht.DecodeFromEnd(key));
+  for (const auto& tombstone : *range_tombstones_) {
+    if (tombstone.hybrid_time <= retention_.history_cutoff &&
+        doc_ht.hybrid_time() <= tombstone.hybrid_time && tombstone.Contains(key)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Status DocDBCompactionFilter::UpdateBlobReference(
+    const Slice& existing_value, std::string* new_value, bool* value_changed) {
+  // Value could already be replaced with a tombstone or updated TTL above.
+  const Slice value = *value_changed ? Slice(*new_value) : existing_value;
+  Slice tail = value;
+  Value control_fields;
+  RETURN_NOT_OK(control_fields.DecodeControlFields(&tail));
+
+  BlobReference reference;
+  if (DecodeValueType(tail) == ValueType::kBlobReference) {
+    Slice encoded_reference = tail;
+    encoded_reference.consume_byte();
+    reference = VERIFY_RESULT(BlobReference::Decode(&encoded_reference));
+    if (!blob_storage_->ShouldRelocate(reference.file_number)) {
+      return Status::OK();
+    }
+    std::string blob;
+    RETURN_NOT_OK(blob_storage_->Read(reference, &blob));
+    reference = VERIFY_RESULT(blob_storage_->Append(blob));
+  } else {
+    const auto threshold = blob_storage_->value_threshold();
+    if (threshold == 0 || tail.size() < threshold) {
+      return Status::OK();
+    }
+    reference = VERIFY_RESULT(blob_storage_->Append(tail));
+  }
+
+  std::string result(value.cdata(), tail.cdata() - value.cdata());
+  result.push_back(ValueTypeAsChar::kBlobReference);
+  reference.AppendEncoded(&result);
+  *new_value = std::move(result);
+  *value_changed = true;
+  return Status::OK();
 }
 
 void DocDBCompactionFilter::AssignPrevSubDocKey(
@@ -299,6 +386,10 @@ rocksdb::UserFrontierPtr DocDBCompactionFilter::GetLargestUserFrontier() const {
   return rocksdb::UserFrontierPtr(consensus_frontier);
 }
 
+Status DocDBCompactionFilter::CompactionFinished() {
+  return blob_storage_ ? blob_storage_->Flush() : Status::OK();
+}
+
 const char* DocDBCompactionFilter::Name() const {
   return "DocDBCompactionFilter";
 }
@@ -306,8 +397,10 @@ const char* DocDBCompactionFilter::Name() const {
 // ------------------------------------------------------------------------------------------------
 
 DocDBCompactionFilterFactory::DocDBCompactionFilterFactory(
-    std::shared_ptr<HistoryRetentionPolicy> retention_policy)
-    : retention_policy_(std::move(retention_policy)) {
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds,
+    BlobStorage* blob_storage, const RangeTombstones* range_tombstones)
+    : retention_policy_(std::move(retention_policy)), key_bounds_(key_bounds),
+      blob_storage_(blob_storage), range_tombstones_(range_tombstones) {
 }
 
 DocDBCompactionFilterFactory::~DocDBCompactionFilterFactory() {
@@ -317,13 +410,457 @@ unique_ptr<CompactionFilter> DocDBCompactionFilterFactory::CreateCompactionFilte
     const CompactionFilter::Context& context) {
   return std::make_unique<DocDBCompactionFilter>(
       retention_policy_->GetRetentionDirective(),
-      IsMajorCompaction(context.is_full_compaction));
+      IsMajorCompaction(context.is_full_compaction),
+      key_bounds_,
+      blob_storage_,
+      range_tombstones_ ? range_tombstones_->Get() : nullptr);
 }
 
 const char* DocDBCompactionFilterFactory::Name() const {
   return "DocDBCompactionFilterFactory";
 }
 
+Slice DocDBCompactionFilterFactory::KeyGroupPrefix(const Slice& user_key) const {
+  auto doc_key_size = DocKey::EncodedSize(user_key, DocKeyPart::WHOLE_DOC_KEY);
+  if (!doc_key_size.ok()) {
+    return Slice();
+  }
+  return Slice(user_key.data(), *doc_key_size);
+}
+
+// ------------------------------------------------------------------------------------------------
+
+const char* const kMinWriteHybridTimeProperty = "yb.docdb.min_write_ht";
+const char* const kMaxWriteHybridTimeProperty = "yb.docdb.max_write_ht";
+const char* const kMaxDefaultTtlWriteHybridTimeProperty = "yb.docdb.max_default_ttl_write_ht";
+const char* const kMaxExplicitExpirationProperty = "yb.docdb.max_explicit_expiration";
+const char* const kExpiringBytesProperty = "yb.docdb.expiring_bytes";
+const char* const kObsoleteVersionsProperty = "yb.docdb.obsolete_versions";
+const char* const kMaxVersionsPerKeyProperty = "yb.docdb.max_versions_per_key";
+
+namespace {
+
+// Amounts by physical time in microseconds, rounded up, so an entry is never considered to be
+// expired or overwritten earlier than it actually is. When there are too many distinct times, the
+// granularity is doubled.
+class TimeBuckets {
+ public:
+  void Add(uint64_t micros, uint64_t amount) {
+    buckets_[RoundUp(micros)] += amount;
+    while (buckets_.size() > kMaxBuckets) {
+      granularity_us_ *= 2;
+      std::map<uint64_t, uint64_t> merged;
+      for (const auto& p : buckets_) {
+        merged[RoundUp(p.first)] += p.second;
+      }
+      buckets_.swap(merged);
+    }
+  }
+
+  bool empty() const {
+    return buckets_.empty();
+  }
+
+  // Returns pairs of varints: time and amount, in increasing order of time.
+  std::string Encode() const {
+    std::string result;
+    for (const auto& p : buckets_) {
+      util::FastAppendUnsignedVarIntToStr(p.first, &result);
+      util::FastAppendUnsignedVarIntToStr(p.second, &result);
+    }
+    return result;
+  }
+
+ private:
+  uint64_t RoundUp(uint64_t micros) const {
+    return (micros + granularity_us_ - 1) / granularity_us_ * granularity_us_;
+  }
+
+  static constexpr size_t kMaxBuckets = 64;
+
+  std::map<uint64_t, uint64_t> buckets_;
+  uint64_t granularity_us_ = 1000000;
+};
+
+// Returns the sum of amounts of encoded TimeBuckets whose time is before cutoff_us, or none if the
+// encoding is broken.
+boost::optional<uint64_t> SumTimeBucketsBefore(Slice input, uint64_t cutoff_us) {
+  uint64_t result = 0;
+  while (!input.empty()) {
+    auto micros = util::FastDecodeUnsignedVarInt(&input);
+    auto amount = util::FastDecodeUnsignedVarInt(&input);
+    if (!micros.ok() || !amount.ok()) {
+      return boost::none;
+    }
+    if (*micros >= cutoff_us) {
+      break;
+    }
+    result += *amount;
+  }
+  return result;
+}
+
+struct FileExpirationInfo {
+  HybridTime min_write_ht = HybridTime::kMax;
+  HybridTime max_write_ht = HybridTime::kMin;
+  HybridTime max_default_ttl_write_ht = HybridTime::kMin;
+  HybridTime max_explicit_expiration = HybridTime::kMin;
+
+  // Returns the hybrid time after which all entries of the file are expired.
+  HybridTime Expiration(MonoDelta table_ttl) const {
+    if (max_default_ttl_write_ht == HybridTime::kMin) {
+      return max_explicit_expiration;
+    }
+    if (table_ttl.Equals(Value::kMaxTtl)) {
+      return HybridTime::kMax;
+    }
+    return std::max(
+        max_explicit_expiration,
+        server::HybridClock::AddPhysicalTimeToHybridTime(max_default_ttl_write_ht, table_ttl));
+  }
+};
+
+class DocDBTablePropertiesCollector : public rocksdb::TablePropertiesCollector {
+ public:
+  Status AddUserKey(const Slice& key, const Slice& value, rocksdb::EntryType type,
+                    rocksdb::SequenceNumber seq, uint64_t file_size) override {
+    if (type != rocksdb::kEntryPut) {
+      SetUnknown();
+      return Status::OK();
+    }
+    Slice key_without_ht = key;
+    auto doc_ht = DocHybridTime::DecodeFromEnd(&key_without_ht);
+    if (!doc_ht.ok()) {
+      SetUnknown();
+      return Status::OK();
+    }
+    const HybridTime ht = doc_ht->hybrid_time();
+    info_.min_write_ht = std::min(info_.min_write_ht, ht);
+    info_.max_write_ht.MakeAtLeast(ht);
+
+    if (IsRangeTombstoneKey(key)) {
+      // Range tombstones should be kept while the deleted entries could exist in other files.
+      info_.max_explicit_expiration = HybridTime::kMax;
+      return Status::OK();
+    }
+
+    size_t control_fields_size;
+    BlobReference reference;
+    auto is_blob = DecodeBlobReferenceValue(value, &control_fields_size, &reference);
+    if (is_blob.ok() && *is_blob) {
+      blob_bytes_[reference.file_number] += reference.size;
+    }
+
+    ValueType value_type;
+    uint64_t merge_flags = 0;
+    MonoDelta ttl;
+    if (!Value::DecodePrimitiveValueType(value, &value_type, &merge_flags, &ttl).ok() ||
+        merge_flags != 0) {
+      // TTL merge records change expiration of older entries, that could be in other files.
+      SetUnknown();
+      AddVersion(key_without_ht, ht, /* overwrites = */ false);
+      return Status::OK();
+    }
+    AddVersion(key_without_ht, ht, /* overwrites = */ true);
+    if (value_type == ValueType::kTombstone) {
+      info_.max_explicit_expiration.MakeAtLeast(ht);
+    } else if (ttl.Equals(Value::kMaxTtl)) {
+      info_.max_default_ttl_write_ht.MakeAtLeast(ht);
+    } else if (ttl.Equals(Value::kResetTtl)) {
+      info_.max_explicit_expiration = HybridTime::kMax;
+    } else {
+      const auto expiration = server::HybridClock::AddPhysicalTimeToHybridTime(ht, ttl);
+      info_.max_explicit_expiration.MakeAtLeast(expiration);
+      expiring_bytes_.Add(expiration.GetPhysicalValueMicros(), key.size() + value.size());
+    }
+    return Status::OK();
+  }
+
+  Status Finish(rocksdb::UserCollectedProperties* properties) override {
+    auto put = [properties](const char* name, HybridTime value) {
+      (*properties)[name] = std::to_string(value.ToUint64());
+    };
+    put(kMinWriteHybridTimeProperty, info_.min_write_ht);
+    put(kMaxWriteHybridTimeProperty, info_.max_write_ht);
+    put(kMaxDefaultTtlWriteHybridTimeProperty, info_.max_default_ttl_write_ht);
+    put(kMaxExplicitExpirationProperty, info_.max_explicit_expiration);
+    if (!blob_bytes_.empty()) {
+      std::string blob_references;
+      for (const auto& p : blob_bytes_) {
+        util::FastAppendUnsignedVarIntToStr(p.first, &blob_references);
+        util::FastAppendUnsignedVarIntToStr(p.second, &blob_references);
+      }
+      (*properties)[kBlobReferencesProperty] = std::move(blob_references);
+    }
+    if (!expiring_bytes_.empty()) {
+      (*properties)[kExpiringBytesProperty] = expiring_bytes_.Encode();
+    }
+    if (!obsolete_versions_.empty()) {
+      (*properties)[kObsoleteVersionsProperty] = obsolete_versions_.Encode();
+    }
+    (*properties)[kMaxVersionsPerKeyProperty] = std::to_string(max_versions_per_key_);
+    return Status::OK();
+  }
+
+  rocksdb::UserCollectedProperties GetReadableProperties() const override {
+    return {
+      {kMinWriteHybridTimeProperty, info_.min_write_ht.ToString()},
+      {kMaxWriteHybridTimeProperty, info_.max_write_ht.ToString()},
+      {kMaxDefaultTtlWriteHybridTimeProperty, info_.max_default_ttl_write_ht.ToString()},
+      {kMaxExplicitExpirationProperty, info_.max_explicit_expiration.ToString()},
+      {kMaxVersionsPerKeyProperty, std::to_string(max_versions_per_key_)},
+    };
+  }
+
+  const char* Name() const override {
+    return "DocDBTablePropertiesCollector";
+  }
+
+ private:
+  // Marks the file as never expiring and overlapping with any other file.
+  void SetUnknown() {
+    info_.min_write_ht = HybridTime::kMin;
+    info_.max_write_ht = HybridTime::kMax;
+    info_.max_explicit_expiration = HybridTime::kMax;
+  }
+
+  // Versions of the same key follow each other from the newest to the oldest, so a version is
+  // overwritten by the previous one, unless the previous one is a merge record. The version could
+  // be garbage collected once the overwriting one is before the history cutoff.
+  void AddVersion(const Slice& key_without_ht, HybridTime ht, bool overwrites) {
+    if (num_versions_ != 0 && key_without_ht == Slice(last_version_key_)) {
+      if (last_version_overwrites_) {
+        obsolete_versions_.Add(std::max(last_version_ht_, ht).GetPhysicalValueMicros(), 1);
+      }
+      ++num_versions_;
+    } else {
+      last_version_key_.assign(key_without_ht.cdata(), key_without_ht.size());
+      num_versions_ = 1;
+    }
+    max_versions_per_key_ = std::max(max_versions_per_key_, num_versions_);
+    last_version_ht_ = ht;
+    last_version_overwrites_ = overwrites;
+  }
+
+  FileExpirationInfo info_;
+  // Referenced bytes per blob file number.
+  std::map<uint64_t, uint64_t> blob_bytes_;
+  // Bytes of values with explicit TTL by expiration time.
+  TimeBuckets expiring_bytes_;
+  // Number of overwritten versions by the time of the version that overwrites them.
+  TimeBuckets obsolete_versions_;
+
+  std::string last_version_key_;
+  HybridTime last_version_ht_;
+  bool last_version_overwrites_ = false;
+  // Number of versions of last_version_key_ so far.
+  uint64_t num_versions_ = 0;
+  uint64_t max_versions_per_key_ = 0;
+};
+
+boost::optional<HybridTime> ParseHybridTimeProperty(
+    const rocksdb::UserCollectedProperties& properties, const char* name) {
+  auto it = properties.find(name);
+  if (it == properties.end()) {
+    return boost::none;
+  }
+  char* end = nullptr;
+  auto value = strtoull(it->second.c_str(), &end, 10);
+  if (end != it->second.c_str() + it->second.size()) {
+    return boost::none;
+  }
+  return HybridTime(value);
+}
+
+boost::optional<FileExpirationInfo> ParseFileExpirationInfo(
+    const rocksdb::TableProperties* properties) {
+  if (!properties) {
+    return boost::none;
+  }
+  const auto& user_properties = properties->user_collected_properties;
+  auto min_write_ht = ParseHybridTimeProperty(user_properties, kMinWriteHybridTimeProperty);
+  auto max_write_ht = ParseHybridTimeProperty(user_properties, kMaxWriteHybridTimeProperty);
+  auto max_default_ttl_write_ht = ParseHybridTimeProperty(
+      user_properties, kMaxDefaultTtlWriteHybridTimeProperty);
+  auto max_explicit_expiration = ParseHybridTimeProperty(
+      user_properties, kMaxExplicitExpirationProperty);
+  if (!min_write_ht || !max_write_ht || !max_default_ttl_write_ht || !max_explicit_expiration) {
+    return boost::none;
+  }
+  FileExpirationInfo result;
+  result.min_write_ht = *min_write_ht;
+  result.max_write_ht = *max_write_ht;
+  result.max_default_ttl_write_ht = *max_default_ttl_write_ht;
+  result.max_explicit_expiration = *max_explicit_expiration;
+  return result;
+}
+
+} // namespace
+
+rocksdb::TablePropertiesCollector*
+DocDBTablePropertiesCollectorFactory::CreateTablePropertiesCollector(
+    rocksdb::TablePropertiesCollectorFactory::Context context) {
+  return new DocDBTablePropertiesCollector();
+}
+
+const char* DocDBTablePropertiesCollectorFactory::Name() const {
+  return "DocDBTablePropertiesCollectorFactory";
+}
+
+DocDBExpiredFileFilter::DocDBExpiredFileFilter(
+    std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+    const RangeTombstones* range_tombstones,
+    DropExpiredFiles drop_expired_files,
+    double expired_bytes_ratio,
+    double obsolete_versions_ratio)
+    : retention_policy_(std::move(retention_policy)), range_tombstones_(range_tombstones),
+      drop_expired_files_(drop_expired_files), expired_bytes_ratio_(expired_bytes_ratio),
+      obsolete_versions_ratio_(obsolete_versions_ratio) {
+}
+
+size_t DocDBExpiredFileFilter::NumExpiredOldestFiles(
+    const std::vector<const rocksdb::TableProperties*>& files) {
+  if (!drop_expired_files_) {
+    return 0;
+  }
+  std::vector<FileExpirationInfo> infos;
+  infos.reserve(files.size());
+  for (const auto* properties : files) {
+    auto info = ParseFileExpirationInfo(properties);
+    if (!info) {
+      // Without properties we could not check that the remaining files do not overlap with the
+      // expired ones.
+      return 0;
+    }
+    infos.push_back(*info);
+  }
+  if (infos.empty() || infos.back().max_explicit_expiration == HybridTime::kMax) {
+    return 0;
+  }
+
+  const auto retention = retention_policy_->GetRetentionDirective();
+
+  // Files are ordered from the newest to the oldest, so expired files form a suffix.
+  size_t num_expired = 0;
+  while (num_expired < infos.size() &&
+         infos[infos.size() - num_expired - 1].Expiration(retention.table_ttl) <
+             retention.history_cutoff) {
+    ++num_expired;
+  }
+  // Dropping all files is also allowed, because there is nothing left to be hidden.
+  if (num_expired == infos.size() || num_expired == 0) {
+    return num_expired;
+  }
+
+  // min_write_ht[i] is the min write hybrid time of files [0, i].
+  std::vector<HybridTime> min_write_ht(infos.size());
+  min_write_ht[0] = infos[0].min_write_ht;
+  for (size_t i = 1; i != infos.size(); ++i) {
+    min_write_ht[i] = std::min(min_write_ht[i - 1], infos[i].min_write_ht);
+  }
+  HybridTime max_expired_write_ht = HybridTime::kMin;
+  std::vector<HybridTime> max_write_ht(num_expired);
+  for (size_t i = infos.size(); i != infos.size() - num_expired; --i) {
+    max_expired_write_ht.MakeAtLeast(infos[i - 1].max_write_ht);
+    max_write_ht[infos.size() - i] = max_expired_write_ht;
+  }
+  // Try the largest number of the oldest files first.
+  for (size_t count = num_expired; count > 0; --count) {
+    if (max_write_ht[count - 1] < min_write_ht[infos.size() - count - 1]) {
+      return count;
+    }
+  }
+  return 0;
+}
+
+bool DocDBExpiredFileFilter::IsFileDeleted(
+    const Slice& smallest_user_key, const Slice& largest_user_key,
+    const rocksdb::TableProperties* properties) {
+  if (!drop_expired_files_ || !range_tombstones_) {
+    return false;
+  }
+  auto tombstones = range_tombstones_->Get();
+  if (tombstones->empty()) {
+    return false;
+  }
+  auto info = ParseFileExpirationInfo(properties);
+  if (!info) {
+    return false;
+  }
+  // Retention directive is only requested for files that are candidates for deletion.
+  HybridTime history_cutoff;
+  for (const auto& tombstone : *tombstones) {
+    if (info->max_write_ht > tombstone.hybrid_time || !tombstone.Contains(smallest_user_key) ||
+        !tombstone.Contains(largest_user_key)) {
+      continue;
+    }
+    if (!history_cutoff.is_valid()) {
+      history_cutoff = retention_policy_->GetRetentionDirective().history_cutoff;
+    }
+    if (tombstone.hybrid_time <= history_cutoff) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DocDBExpiredFileFilter::HasManyExpiredBytes(const rocksdb::TableProperties* properties) {
+  if (expired_bytes_ratio_ <= 0 || !properties) {
+    return false;
+  }
+  const auto total_bytes = properties->raw_key_size + properties->raw_value_size;
+  const auto& user_properties = properties->user_collected_properties;
+  auto it = user_properties.find(kExpiringBytesProperty);
+  if (total_bytes == 0 || it == user_properties.end()) {
+    return false;
+  }
+
+  const auto history_cutoff_us =
+      retention_policy_->GetRetentionDirective().history_cutoff.GetPhysicalValueMicros();
+  auto expired_bytes = SumTimeBucketsBefore(it->second, history_cutoff_us);
+  return expired_bytes && *expired_bytes >= expired_bytes_ratio_ * total_bytes;
+}
+
+bool DocDBExpiredFileFilter::HasManyObsoleteVersions(const rocksdb::TableProperties* properties) {
+  if (obsolete_versions_ratio_ <= 0 || !properties || properties->num_entries == 0) {
+    return false;
+  }
+  const auto& user_properties = properties->user_collected_properties;
+  auto it = user_properties.find(kObsoleteVersionsProperty);
+  if (it == user_properties.end()) {
+    return false;
+  }
+
+  const auto history_cutoff_us =
+      retention_policy_->GetRetentionDirective().history_cutoff.GetPhysicalValueMicros();
+  auto obsolete_versions = SumTimeBucketsBefore(it->second, history_cutoff_us);
+  return obsolete_versions &&
+         *obsolete_versions >= obsolete_versions_ratio_ * properties->num_entries;
+}
+
+const char* DocDBExpiredFileFilter::Name() const {
+  return "DocDBExpiredFileFilter";
+}
+
+// ------------------------------------------------------------------------------------------------
+
+DocDBCompactionTimeWindows::DocDBCompactionTimeWindows(MonoDelta window)
+    : window_us_(std::max<int64_t>(window.ToMicroseconds(), 1)) {
+}
+
+uint64_t DocDBCompactionTimeWindows::FileWindow(const rocksdb::UserFrontier* largest_frontier) {
+  if (!largest_frontier) {
+    return 0;
+  }
+  const auto hybrid_time =
+      down_cast<const ConsensusFrontier*>(largest_frontier)->hybrid_time();
+  return hybrid_time.is_valid() ? hybrid_time.GetPhysicalValueMicros() / window_us_ : 0;
+}
+
+const char* DocDBCompactionTimeWindows::Name() const {
+  return "DocDBCompactionTimeWindows";
+}
+
 // ------------------------------------------------------------------------------------------------
 
 HistoryRetentionDirective ManualHistoryRetentionPolicy::GetRetentionDirective() {
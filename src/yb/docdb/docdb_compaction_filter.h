@@ -21,21 +21,25 @@
 #include <boost/container/small_vector.hpp>
 
 #include "yb/gutil/thread_annotations.h"
+#include "yb/util/monotime.h"
 #include "yb/util/strongly_typed_bool.h"
 
 #include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/table_properties.h"
 
 #include "yb/common/schema.h"
 #include "yb/common/hybrid_time.h"
 
 #include "yb/docdb/doc_key.h"
 #include "yb/docdb/expiration.h"
+#include "yb/docdb/range_tombstones.h"
 
 namespace yb {
 namespace docdb {
 
 YB_STRONGLY_TYPED_BOOL(IsMajorCompaction);
+YB_STRONGLY_TYPED_BOOL(DropExpiredFiles);
 
 struct Expiration;
 
@@ -59,7 +63,10 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
  public:
   DocDBCompactionFilter(
       HistoryRetentionDirective retention,
-      IsMajorCompaction is_major_compaction);
+      IsMajorCompaction is_major_compaction,
+      const KeyBounds* key_bounds,
+      BlobStorage* blob_storage,
+      RangeTombstonesSnapshot range_tombstones);
 
   ~DocDBCompactionFilter() override;
   rocksdb::FilterDecision Filter(
@@ -76,6 +83,9 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
   // ConsensusFrontier, so that it can be persisted in RocksDB metadata and recovered on bootstrap.
   rocksdb::UserFrontierPtr GetLargestUserFrontier() const override;
 
+  // Makes blobs written by this compaction durable before its output files are installed.
+  Status CompactionFinished() override;
+
  private:
   // Assigns prev_subdoc_key_ from memory addressed by data. The length of key is taken from
   // sub_key_ends_ and same_bytes are reused.
@@ -86,8 +96,19 @@ class DocDBCompactionFilter : public rocksdb::CompactionFilter {
       int level, const Slice& key, const Slice& existing_value, std::string* new_value,
       bool* value_changed);
 
+  // Moves a large value of the kept entry to the blob storage, or relocates its blob from a blob
+  // file that is mostly garbage.
+  CHECKED_STATUS UpdateBlobReference(
+      const Slice& existing_value, std::string* new_value, bool* value_changed);
+
+  // Whether the entry is deleted by a range tombstone, that is not newer than the history cutoff.
+  Result<bool> IsDeletedByRange(const Slice& key) const;
+
   const HistoryRetentionDirective retention_;
   const IsMajorCompaction is_major_compaction_;
+  const KeyBounds* key_bounds_;
+  BlobStorage* blob_storage_;
+  const RangeTombstonesSnapshot range_tombstones_;
 
   std::vector<char> prev_subdoc_key_;
 
@@ -153,14 +174,113 @@ class HistoryRetentionPolicy {
 
 class DocDBCompactionFilterFactory : public rocksdb::CompactionFilterFactory {
  public:
-  explicit DocDBCompactionFilterFactory(std::shared_ptr<HistoryRetentionPolicy> retention_policy);
+  // Keys outside of key_bounds, if specified, are dropped. Large values are moved to blob_storage,
+  // if specified. Entries deleted by range_tombstones before the history cutoff are dropped. All of
+  // them should outlive the factory.
+  DocDBCompactionFilterFactory(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy, const KeyBounds* key_bounds,
+      BlobStorage* blob_storage, const RangeTombstones* range_tombstones);
   ~DocDBCompactionFilterFactory() override;
   std::unique_ptr<rocksdb::CompactionFilter> CreateCompactionFilter(
       const rocksdb::CompactionFilter::Context& context) override;
   const char* Name() const override;
 
+  // DocDBCompactionFilter tracks overwrites within a document, so all keys of the document
+  // should be compacted by the same subcompaction.
+  Slice KeyGroupPrefix(const Slice& user_key) const override;
+
+ private:
+  std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  const KeyBounds* key_bounds_;
+  BlobStorage* blob_storage_;
+  const RangeTombstones* range_tombstones_;
+};
+
+// Names of SST file properties written by DocDBTablePropertiesCollectorFactory. Hybrid times are
+// stored as decimal representation of HybridTime::ToUint64.
+extern const char* const kMinWriteHybridTimeProperty;
+extern const char* const kMaxWriteHybridTimeProperty;
+// Max hybrid time of values that expire according to the table level TTL.
+extern const char* const kMaxDefaultTtlWriteHybridTimeProperty;
+// Max expiration time of values with explicit TTL and tombstones, HybridTime::kMax if some entry
+// never expires.
+extern const char* const kMaxExplicitExpirationProperty;
+// Size of values with explicit TTL by their expiration time, rounded up. Stored as pairs of
+// varints: expiration physical time in microseconds and number of bytes.
+extern const char* const kExpiringBytesProperty;
+// Number of versions of keys overwritten by a newer version of the same key in the same file, by
+// the time of the overwriting version, rounded up. Stored as pairs of varints: physical time in
+// microseconds and number of versions.
+extern const char* const kObsoleteVersionsProperty;
+// Max number of versions of a single key in the file.
+extern const char* const kMaxVersionsPerKeyProperty;
+
+// Collects write and expiration hybrid times of regular DB entries into SST file properties, that
+// are used by DocDBExpiredFileFilter. Also collects the number of referenced bytes of blob files
+// into kBlobReferencesProperty, that is used by the blob files garbage collection.
+class DocDBTablePropertiesCollectorFactory : public rocksdb::TablePropertiesCollectorFactory {
+ public:
+  rocksdb::TablePropertiesCollector* CreateTablePropertiesCollector(
+      rocksdb::TablePropertiesCollectorFactory::Context context) override;
+  const char* Name() const override;
+};
+
+// Finds the oldest SST files that could be dropped without compaction, because all their entries
+// are expired or deleted before the history cutoff, and entries of the remaining files are newer.
+// The latter guarantees that dropped entries do not hide older versions of the same documents.
+//
+// Also finds files of any age whose whole key range is deleted by a range tombstone before the
+// history cutoff, since older versions of their keys are deleted by the same tombstone.
+//
+// Files are not dropped when drop_expired_files is false. Independently of that, files whose
+// values with explicit TTL expired before the history cutoff make up at least
+// expired_bytes_ratio of their raw size are reported to be worth compacting. The same goes for
+// files in which versions overwritten before the history cutoff make up at least
+// obsolete_versions_ratio of their entries. Zero ratios disable these checks.
+class DocDBExpiredFileFilter : public rocksdb::ExpiredFileFilter {
+ public:
+  // range_tombstones is optional and should outlive the filter.
+  DocDBExpiredFileFilter(
+      std::shared_ptr<HistoryRetentionPolicy> retention_policy,
+      const RangeTombstones* range_tombstones,
+      DropExpiredFiles drop_expired_files = DropExpiredFiles::kTrue,
+      double expired_bytes_ratio = 0,
+      double obsolete_versions_ratio = 0);
+
+  size_t NumExpiredOldestFiles(const std::vector<const rocksdb::TableProperties*>& files) override;
+
+  bool IsFileDeleted(
+      const Slice& smallest_user_key, const Slice& largest_user_key,
+      const rocksdb::TableProperties* properties) override;
+
+  bool HasManyExpiredBytes(const rocksdb::TableProperties* properties) override;
+
+  bool HasManyObsoleteVersions(const rocksdb::TableProperties* properties) override;
+
+  const char* Name() const override;
+
  private:
   std::shared_ptr<HistoryRetentionPolicy> retention_policy_;
+  const RangeTombstones* range_tombstones_;
+  const DropExpiredFiles drop_expired_files_;
+  const double expired_bytes_ratio_;
+  const double obsolete_versions_ratio_;
+};
+
+// Assigns regular DB SST files to windows of the specified length by the physical component of the
+// latest hybrid time of the file, so universal compaction does not merge data of different windows.
+// Together with DocDBExpiredFileFilter it lets whole windows of time series data be dropped
+// without compacting them once they expire.
+class DocDBCompactionTimeWindows : public rocksdb::CompactionTimeWindows {
+ public:
+  explicit DocDBCompactionTimeWindows(MonoDelta window);
+
+  uint64_t FileWindow(const rocksdb::UserFrontier* largest_frontier) override;
+
+  const char* Name() const override;
+
+ private:
+  const uint64_t window_us_;
 };
 
 // A history retention policy that can be configured manually. Useful in tests. This class is
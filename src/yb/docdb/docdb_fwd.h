@@ -17,14 +17,18 @@
 namespace yb {
 namespace docdb {
 
+class BlobStorage;
 class DocPath;
+class DocRowCache;
 class DocWriteBatch;
 class IntentAwareIterator;
 class KeyValueWriteBatchPB;
 class QLWriteOperation;
 class PgsqlWriteOperation;
+class RangeTombstones;
 
 struct DocDB;
+struct KeyBounds;
 
 }  // namespace docdb
 }  // namespace yb
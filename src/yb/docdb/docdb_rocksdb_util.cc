@@ -16,17 +16,24 @@
 #include <thread>
 #include <memory>
 
+#include <boost/algorithm/string/predicate.hpp>
+
 #include "yb/common/transaction.h"
 
+#include "yb/rocksdb/db/compaction.h"
 #include "yb/rocksdb/rate_limiter.h"
+#include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/util/compression.h"
 
+#include "yb/docdb/doc_key.h"
 #include "yb/docdb/doc_ttl_util.h"
 #include "yb/docdb/intent_aware_iterator.h"
 #include "yb/rocksutil/yb_rocksdb.h"
 #include "yb/rocksutil/yb_rocksdb_logger.h"
 #include "yb/server/hybrid_clock.h"
+#include "yb/util/io_scheduler.h"
+#include "yb/util/priority_thread_pool.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/trace.h"
 #include "yb/gutil/sysinfo.h"
@@ -52,6 +59,34 @@ DEFINE_int32(rocksdb_universal_compaction_size_ratio, 20,
              "The percentage upto which files that are larger are include in a compaction.");
 DEFINE_int32(rocksdb_universal_compaction_min_merge_width, 4,
              "The minimum number of files in a single compaction run.");
+DEFINE_bool(rocksdb_allow_concurrent_memtable_write, true,
+            "Whether write batches of the same write group are inserted into the memtable in "
+            "parallel by their writers, instead of sequentially by the group leader.");
+DEFINE_int32(rocksdb_max_subcompactions, 1,
+             "Max number of parts that a single large compaction is split into by key ranges, "
+             "compacted in parallel threads. Each part produces its own output files.");
+DEFINE_bool(rocksdb_use_direct_reads, false,
+            "Whether SST files are read by user queries with O_DIRECT, bypassing the OS page "
+            "cache.");
+DEFINE_bool(rocksdb_use_direct_io_for_flush_and_compaction, false,
+            "Whether compactions read their input SST files and flushes and compactions write "
+            "their output SST files with O_DIRECT, so background I/O does not evict data used by "
+            "user queries from the OS page cache.");
+DEFINE_int64(rocksdb_compaction_readahead_size, -1,
+             "Size of reads done by compactions on their input files. -1 means 2MB when "
+             "rocksdb_use_direct_io_for_flush_and_compaction is set and no readahead otherwise.");
+DEFINE_uint64(rocksdb_bytes_per_sync, 1_MB,
+              "Number of bytes written to an SST file after which the OS is asked to start "
+              "writing them back to disk in the background. 0 turns it off.");
+DEFINE_bool(rocksdb_compact_flush_rate_limit_sharing_across_tablets, false,
+            "Whether rocksdb_compact_flush_rate_limit_bytes_per_sec is applied to compactions and "
+            "flushes of all tablets of the tablet server together, instead of each tablet.");
+DEFINE_int32(priority_thread_pool_size, -1,
+             "Max number of compactions running at the same time across all tablets of the "
+             "tablet server. Compactions are run in the order of their priority, that depends on "
+             "the number of files of the tablet and the compaction size. If -1, then "
+             "rocksdb_max_background_compactions is used. If 0, then compactions of each tablet "
+             "are scheduled in the RocksDB env thread pool.");
 DEFINE_int64(rocksdb_compact_flush_rate_limit_bytes_per_sec, 256_MB,
              "Use to control write rate of flush and compaction.");
 DEFINE_uint64(rocksdb_compaction_size_threshold_bytes, 2ULL * 1024 * 1024 * 1024,
@@ -77,12 +112,33 @@ DEFINE_int64(db_write_buffer_size, -1,
 DEFINE_int32(memstore_size_mb, 128,
              "Max size (in mb) of the memstore, before needing to flush.");
 
+DEFINE_uint64(memstore_huge_page_size, 0,
+              "Page size for huge pages backing memstore arenas, e.g. 2097152. Reserved huge pages "
+              "are used when available, otherwise transparent huge pages. 0 to use regular "
+              "allocations.");
+
 DEFINE_bool(use_docdb_aware_bloom_filter, true,
             "Whether to use the DocDbAwareFilterPolicy for both bloom storage and seeks.");
+DEFINE_int32(docdb_bloom_filter_range_components, 0,
+             "Number of leading range components of the document key to include into the "
+             "DocDbAwareFilterPolicy bloom filter key together with the hashed components. "
+             "Non-zero values allow scans that fix the hash key and a range key prefix to skip "
+             "SST files, but disable the bloom filter for lookups that fix less range components, "
+             "including all lookups in tables with less range key columns. "
+             "SST files written with a different value are read without bloom filter until "
+             "they are compacted.");
 DEFINE_int32(max_nexts_to_avoid_seek, 1,
              "The number of next calls to try before doing resorting to do a rocksdb seek.");
 DEFINE_bool(trace_docdb_calls, false, "Whether we should trace calls into the docdb.");
 DEFINE_bool(use_multi_level_index, true, "Whether to use multi-level data index.");
+DEFINE_bool(use_three_shared_parts_key_encoding, false,
+            "Whether to encode keys of SST data blocks using shared prefix, shared middle and "
+            "delta of the internal key suffix. SST files written with this encoding could not be "
+            "read by older versions.");
+
+DEFINE_bool(cache_index_and_filter_blocks_with_high_priority, true,
+            "Whether to add index and filter blocks directly to the multi-touch part of the block "
+            "cache, so they are not evicted by data blocks read by scans.");
 
 DEFINE_uint64(initial_seqno, 1ULL << 50, "Initial seqno for new RocksDB instances.");
 
@@ -91,6 +147,49 @@ DEFINE_int32(num_reserved_small_compaction_threads, -1, "Number of reserved smal
 
 DEFINE_bool(enable_ondisk_compression, true,
             "Determines whether SSTable compression is enabled or not.");
+DEFINE_string(rocksdb_compression_type, "snappy",
+              "Compression algorithm for SST files: snappy, zstd, zlib, lz4 or none. Has effect "
+              "only when enable_ondisk_compression is set.");
+DEFINE_int32(rocksdb_compression_level, -1,
+             "Compression level used with rocksdb_compression_type. -1 means the default level "
+             "of the algorithm.");
+DEFINE_string(rocksdb_flush_compression_type, "",
+              "Compression algorithm for SST files written by memtable flushes. Empty means "
+              "rocksdb_compression_type.");
+DEFINE_int32(rocksdb_flush_compression_level, -1,
+             "Compression level used with rocksdb_flush_compression_type.");
+DEFINE_string(rocksdb_bottommost_compression_type, "",
+              "Compression algorithm for the output of compactions that include the oldest SST "
+              "file of the tablet, i.e. for the largest files. Empty means "
+              "rocksdb_compression_type.");
+DEFINE_int32(rocksdb_bottommost_compression_level, -1,
+             "Compression level used with rocksdb_bottommost_compression_type.");
+DEFINE_int32(rocksdb_compression_max_dict_bytes, 0,
+             "Maximum size of the dictionary built for each SST file to compress its data blocks. "
+             "Only used with zstd compression, 0 disables dictionary compression.");
+DEFINE_int32(rocksdb_zstd_max_train_bytes, 0,
+             "Amount of data blocks collected for each SST file to train the zstd dictionary. "
+             "0 means that first rocksdb_compression_max_dict_bytes of data are used as a "
+             "dictionary without training.");
+DEFINE_bool(intents_db_use_prefix_hash_index, false,
+            "Whether the intents DB locates reverse index records by transaction id and intents "
+            "by document key through hash indexes instead of binary searching block indexes.");
+DEFINE_int32(intents_db_memtable_prefix_bloom_bits, 8 * 1024 * 1024,
+             "Size in bits of the prefix bloom filter of each intents DB memtable, used with "
+             "intents_db_use_prefix_hash_index. 0 disables the memtable prefix bloom filter.");
+DEFINE_int32(regular_db_memtable_filter_bits, 0,
+             "Size in bits of the bloom filter of document key hashed components maintained by "
+             "each regular DB memtable, used by point reads to skip memtables that do not contain "
+             "the document key. 0 disables the memtable filter. Requires "
+             "use_docdb_aware_bloom_filter.");
+DEFINE_bool(rocksdb_lazy_open_sst_files, false,
+            "Do not read table properties of SST files to initialize compaction statistics when "
+            "RocksDB is opened, so SST files are only opened on first access. Speeds up startup of "
+            "tablet servers with many tablets, at the cost of compaction picking ignoring the "
+            "number of deletions in the existing files.");
+DEFINE_bool(docdb_skip_files_written_after_read_time, true,
+            "Whether reads skip regular DB SST files, whose entries were all written after the "
+            "global limit of the read time, using the hybrid time boundaries of the files.");
 
 using std::shared_ptr;
 using std::string;
@@ -101,6 +200,7 @@ namespace yb {
 namespace docdb {
 
 std::shared_ptr<rocksdb::BoundaryValuesExtractor> DocBoundaryValuesExtractorInstance();
+rocksdb::UserBoundaryTag TagForDocHybridTime();
 
 Status SeekToValidKvAtTs(
     rocksdb::Iterator *iter,
@@ -331,6 +431,31 @@ void PerformRocksDBReverseSeek(
   }
 }
 
+Result<bool> BloomFilterKeysEqual(const Slice& lower_doc_key, const Slice& upper_doc_key) {
+  if (lower_doc_key.empty()) {
+    return false;
+  }
+  if (FLAGS_docdb_bloom_filter_range_components <= 0) {
+    return HashedComponentsEqual(lower_doc_key, upper_doc_key);
+  }
+  if (upper_doc_key.empty()) {
+    return false;
+  }
+  // The filter key of a bound is complete only if it has all docdb_bloom_filter_range_components
+  // range components. Tables with less range key columns are scanned without bloom filter, since a
+  // bound with all range columns of such a table could not be told apart from a prefix of a key of
+  // a table with more range columns (see FilterKeyIsComplete).
+  const size_t required_components = FLAGS_docdb_bloom_filter_range_components;
+  size_t lower_components = 0;
+  size_t upper_components = 0;
+  auto lower_size = VERIFY_RESULT(EncodedHashAndRangePrefixSize(
+      lower_doc_key, required_components, &lower_components));
+  auto upper_size = VERIFY_RESULT(EncodedHashAndRangePrefixSize(
+      upper_doc_key, required_components, &upper_components));
+  return lower_components == required_components && upper_components == required_components &&
+         Slice(lower_doc_key.data(), lower_size) == Slice(upper_doc_key.data(), upper_size);
+}
+
 namespace {
 
 rocksdb::ReadOptions PrepareReadOptions(
@@ -339,20 +464,57 @@ rocksdb::ReadOptions PrepareReadOptions(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    SeekMode seek_mode = SeekMode::TOTAL_ORDER) {
   rocksdb::ReadOptions read_opts;
   read_opts.query_id = query_id;
+  // Intents DB could have a prefix extractor, which should only be used by iterators that never
+  // leave the prefix of the seek key.
+  read_opts.total_order_seek = seek_mode == SeekMode::TOTAL_ORDER;
+  read_opts.prefix_same_as_start = seek_mode == SeekMode::SAME_PREFIX_ONLY;
   if (FLAGS_use_docdb_aware_bloom_filter &&
     bloom_filter_mode == BloomFilterMode::USE_BLOOM_FILTER) {
     DCHECK(user_key_for_filter);
-    read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
-        NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
+    // A key with less range components than the filter key has a shorter filter key than the
+    // stored keys that start with it, so checking it against the filter would skip SST files and
+    // memtables that contain such keys.
+    if (FilterKeyIsComplete(
+            user_key_for_filter.get(), std::max(FLAGS_docdb_bloom_filter_range_components, 0))) {
+      read_opts.table_aware_file_filter = rocksdb->GetOptions().table_factory->
+          NewTableAwareReadFileFilter(read_opts, user_key_for_filter.get());
+    }
   }
   read_opts.file_filter = std::move(file_filter);
   read_opts.iterate_upper_bound = iterate_upper_bound;
   return read_opts;
 }
 
+// Skips SST files whose entries were all written after max_ht, so they contain neither values
+// visible to the read nor values that would require the read to be restarted. It is valid for any
+// file, since compactions preserve the hybrid times of the entries.
+class ReadTimeFileFilter : public rocksdb::ReadFileFilter {
+ public:
+  ReadTimeFileFilter(HybridTime max_ht, std::shared_ptr<rocksdb::ReadFileFilter> file_filter)
+      : max_ht_(max_ht), file_filter_(std::move(file_filter)) {
+  }
+
+  bool Filter(const rocksdb::FdWithBoundaries& file) const override {
+    if (file_filter_ && !file_filter_->Filter(file)) {
+      return false;
+    }
+    const auto* smallest = file.smallest.user_value_with_tag(TagForDocHybridTime());
+    if (!smallest) {
+      return true;
+    }
+    DocHybridTime min_doc_ht;
+    return !min_doc_ht.FullyDecodeFrom(*smallest).ok() || min_doc_ht.hybrid_time() <= max_ht_;
+  }
+
+ private:
+  const HybridTime max_ht_;
+  const std::shared_ptr<rocksdb::ReadFileFilter> file_filter_;
+};
+
 } // namespace
 
 unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
@@ -361,9 +523,10 @@ unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
-    const Slice* iterate_upper_bound) {
+    const Slice* iterate_upper_bound,
+    SeekMode seek_mode) {
   rocksdb::ReadOptions read_opts = PrepareReadOptions(rocksdb, bloom_filter_mode,
-      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
+      user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound, seek_mode);
   return unique_ptr<rocksdb::Iterator>(rocksdb->NewIterator(read_opts));
 }
 
@@ -377,6 +540,11 @@ unique_ptr<IntentAwareIterator> CreateIntentAwareIterator(
     const ReadHybridTime& read_time,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter,
     const Slice* iterate_upper_bound) {
+  if (FLAGS_docdb_skip_files_written_after_read_time && read_time.global_limit.is_valid() &&
+      read_time.global_limit != HybridTime::kMax) {
+    file_filter = std::make_shared<ReadTimeFileFilter>(
+        read_time.global_limit, std::move(file_filter));
+  }
   // TODO(dtxn) do we need separate options for intents db?
   rocksdb::ReadOptions read_opts = PrepareReadOptions(doc_db.regular, bloom_filter_mode,
       user_key_for_filter, query_id, std::move(file_filter), iterate_upper_bound);
@@ -388,6 +556,38 @@ namespace {
 
 std::mutex rocksdb_flags_mutex;
 
+// Maps reverse index records to their transaction id prefix and intents to their document key.
+// Any other key, e.g. a weak intent on a part of the document key that could not be decoded as a
+// whole document key, is its own prefix. Since encoded document keys are self-delimiting, keys with
+// the same prefix form a contiguous range, as required by the hash index.
+class IntentsPrefixExtractor : public rocksdb::SliceTransform {
+ public:
+  static constexpr size_t kTransactionPrefixSize = 1 + TransactionId::static_size();
+
+  const char* Name() const override {
+    return "yb.IntentsPrefixExtractor";
+  }
+
+  Slice Transform(const Slice& key) const override {
+    if (key.empty()) {
+      return key;
+    }
+    if (key[0] == ValueTypeAsChar::kTransactionId) {
+      return key.size() >= kTransactionPrefixSize ? Slice(key.data(), kTransactionPrefixSize) : key;
+    }
+    auto size = DocKey::EncodedSize(key, DocKeyPart::WHOLE_DOC_KEY);
+    return size.ok() ? Slice(key.data(), *size) : key;
+  }
+
+  bool InDomain(const Slice& key) const override {
+    return true;
+  }
+
+  bool InRange(const Slice& prefix) const override {
+    return false;
+  }
+};
+
 // Auto initialize some of the RocksDB flags that are defaulted to -1.
 void AutoInitRocksDBFlags(rocksdb::Options* options) {
   const int kNumCpus = base::NumCPUs();
@@ -428,6 +628,71 @@ void AutoInitRocksDBFlags(rocksdb::Options* options) {
               << FLAGS_rocksdb_base_background_compactions;
   }
   options->base_background_compactions = FLAGS_rocksdb_base_background_compactions;
+  options->max_subcompactions = std::max(FLAGS_rocksdb_max_subcompactions, 1);
+}
+
+// Converts value of a compression type flag to compression type. Returns default_type for empty
+// value, unknown types and types not supported by this build.
+rocksdb::CompressionType CompressionTypeFromFlag(
+    const char* flag_name, const std::string& value, rocksdb::CompressionType default_type) {
+  if (value.empty()) {
+    return default_type;
+  }
+  rocksdb::CompressionType result;
+  if (boost::iequals(value, "snappy")) {
+    result = rocksdb::kSnappyCompression;
+  } else if (boost::iequals(value, "zstd")) {
+    result = rocksdb::kZSTD;
+  } else if (boost::iequals(value, "zlib")) {
+    result = rocksdb::kZlibCompression;
+  } else if (boost::iequals(value, "lz4")) {
+    result = rocksdb::kLZ4Compression;
+  } else if (boost::iequals(value, "none")) {
+    result = rocksdb::kNoCompression;
+  } else {
+    LOG(DFATAL) << "Unknown compression type in " << flag_name << ": " << value;
+    return default_type;
+  }
+  if (!rocksdb::CompressionTypeSupported(result)) {
+    LOG(WARNING) << "Compression type " << value << " specified in " << flag_name
+                 << " is not supported by this build, using "
+                 << rocksdb::CompressionTypeToString(default_type);
+    return default_type;
+  }
+  return result;
+}
+
+rocksdb::CompressionOptions CompressionOptionsFromFlags(int level) {
+  rocksdb::CompressionOptions result;
+  result.level = level;
+  result.max_dict_bytes = std::max(FLAGS_rocksdb_compression_max_dict_bytes, 0);
+  result.zstd_max_train_bytes = std::max(FLAGS_rocksdb_zstd_max_train_bytes, 0);
+  return result;
+}
+
+void InitCompressionOptions(rocksdb::Options* options) {
+  if (!FLAGS_enable_ondisk_compression) {
+    options->compression = rocksdb::kNoCompression;
+    return;
+  }
+
+  options->compression = CompressionTypeFromFlag(
+      "rocksdb_compression_type", FLAGS_rocksdb_compression_type,
+      rocksdb::Snappy_Supported() ? rocksdb::kSnappyCompression : rocksdb::kNoCompression);
+  options->compression_opts = CompressionOptionsFromFlags(FLAGS_rocksdb_compression_level);
+
+  options->flush_compression = CompressionTypeFromFlag(
+      "rocksdb_flush_compression_type", FLAGS_rocksdb_flush_compression_type,
+      rocksdb::kDisableCompressionOption);
+  // Flushed files are rewritten by compactions soon, so it does not make sense to spend time on
+  // building dictionary for them.
+  options->flush_compression_opts.level = FLAGS_rocksdb_flush_compression_level;
+
+  options->bottommost_compression = CompressionTypeFromFlag(
+      "rocksdb_bottommost_compression_type", FLAGS_rocksdb_bottommost_compression_type,
+      rocksdb::kDisableCompressionOption);
+  options->bottommost_compression_opts =
+      CompressionOptionsFromFlags(FLAGS_rocksdb_bottommost_compression_level);
 }
 
 } // namespace
@@ -444,6 +709,7 @@ void InitRocksDBOptions(
   options->info_log = std::make_shared<YBRocksDBLogger>(options->log_prefix);
   options->info_log_level = YBRocksDBLogger::ConvertToRocksDBLogLevel(FLAGS_minloglevel);
   options->initial_seqno = FLAGS_initial_seqno;
+  options->skip_stats_update_on_db_open = FLAGS_rocksdb_lazy_open_sst_files;
   options->boundary_extractor = DocBoundaryValuesExtractorInstance();
   options->memory_monitor = tablet_options.memory_monitor;
   if (FLAGS_db_write_buffer_size != -1) {
@@ -451,6 +717,7 @@ void InitRocksDBOptions(
   } else {
     options->write_buffer_size = FLAGS_memstore_size_mb * 1_MB;
   }
+  options->memtable_huge_page_size = FLAGS_memstore_huge_page_size;
   options->env = tablet_options.rocksdb_env;
   options->checkpoint_env = rocksdb::Env::Default();
 
@@ -458,8 +725,7 @@ void InitRocksDBOptions(
     options->num_reserved_small_compaction_threads = FLAGS_num_reserved_small_compaction_threads;
   }
 
-  options->compression = rocksdb::Snappy_Supported() && FLAGS_enable_ondisk_compression
-      ? rocksdb::kSnappyCompression : rocksdb::kNoCompression;
+  InitCompressionOptions(options);
 
   options->listeners.insert(
       options->listeners.end(), tablet_options.listeners.begin(),
@@ -469,8 +735,14 @@ void InitRocksDBOptions(
   rocksdb::BlockBasedTableOptions table_options;
   if (tablet_options.block_cache) {
     table_options.block_cache = tablet_options.block_cache;
+    table_options.persistent_block_cache = tablet_options.persistent_block_cache;
+    table_options.block_cache_compressed = tablet_options.block_cache_compressed;
+    table_options.block_cache_compressed_mem_tracker =
+        tablet_options.block_cache_compressed_mem_tracker;
     // Cache the bloom filters in the block cache.
     table_options.cache_index_and_filter_blocks = true;
+    table_options.cache_index_and_filter_blocks_with_high_priority =
+        FLAGS_cache_index_and_filter_blocks_with_high_priority;
   } else {
     table_options.no_block_cache = true;
     table_options.cache_index_and_filter_blocks = false;
@@ -483,7 +755,14 @@ void InitRocksDBOptions(
   // Set our custom bloom filter that is docdb aware.
   if (FLAGS_use_docdb_aware_bloom_filter) {
     table_options.filter_policy.reset(new DocDbAwareFilterPolicy(
-        table_options.filter_block_size * 8, options->info_log.get()));
+        table_options.filter_block_size * 8, options->info_log.get(),
+        std::max(FLAGS_docdb_bloom_filter_range_components, 0)));
+    if (FLAGS_regular_db_memtable_filter_bits > 0) {
+      auto memtable_filter = std::make_shared<rocksdb::MemTableFilterOptions>();
+      memtable_filter->filter_policy = table_options.filter_policy;
+      memtable_filter->num_bits = FLAGS_regular_db_memtable_filter_bits;
+      options->memtable_filter = std::move(memtable_filter);
+    }
   }
 
   if (FLAGS_use_multi_level_index) {
@@ -492,8 +771,32 @@ void InitRocksDBOptions(
     table_options.index_type = rocksdb::IndexType::kBinarySearch;
   }
 
+  if (FLAGS_use_three_shared_parts_key_encoding) {
+    table_options.data_block_key_value_encoding_format =
+        rocksdb::KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
+  }
+
+  options->use_direct_reads = FLAGS_rocksdb_use_direct_reads;
+  options->use_direct_io_for_flush_and_compaction =
+      FLAGS_rocksdb_use_direct_io_for_flush_and_compaction;
+  if (FLAGS_rocksdb_compaction_readahead_size >= 0) {
+    options->compaction_readahead_size = FLAGS_rocksdb_compaction_readahead_size;
+  } else if (FLAGS_rocksdb_use_direct_io_for_flush_and_compaction) {
+    options->compaction_readahead_size = 2_MB;
+  }
+  options->bytes_per_sync = FLAGS_rocksdb_bytes_per_sync;
+  if (FLAGS_rocksdb_use_direct_io_for_flush_and_compaction) {
+    // With direct writes every flush of the partially filled last page rewrites it, so let the
+    // writer accumulate whole pages instead of flushing after each data block.
+    table_options.skip_table_builder_flush = true;
+  }
+
   options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
 
+  // DocDB uses skip list memtables without in-place updates and merges, so write batches of
+  // a write group could be inserted concurrently.
+  options->allow_concurrent_memtable_write = FLAGS_rocksdb_allow_concurrent_memtable_write;
+
   // Compaction related options.
 
   // Enable universal style compactions.
@@ -518,10 +821,14 @@ void InitRocksDBOptions(
     options->compaction_options_universal.min_merge_width =
         FLAGS_rocksdb_universal_compaction_min_merge_width;
     options->compaction_size_threshold_bytes = FLAGS_rocksdb_compaction_size_threshold_bytes;
-    if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
+    if (tablet_options.rate_limiter) {
+      options->rate_limiter = tablet_options.rate_limiter;
+    } else if (FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec > 0) {
       options->rate_limiter.reset(
           rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
     }
+    options->priority_thread_pool_for_compactions =
+        tablet_options.priority_thread_pool_for_compactions;
   } else {
     options->level0_slowdown_writes_trigger = std::numeric_limits<int>::max();
     options->level0_stop_writes_trigger = std::numeric_limits<int>::max();
@@ -533,5 +840,99 @@ void InitRocksDBOptions(
   }
 }
 
+void InitIntentsDBOptions(rocksdb::Options* options) {
+  // Intents are not read through bloom filter aware file filters.
+  options->memtable_filter = nullptr;
+
+  if (!FLAGS_intents_db_use_prefix_hash_index) {
+    return;
+  }
+  // Plain and cuckoo tables, as well as hash based memtables, do not support total order
+  // iteration, that is required by intent aware iterators. So the block based table keeps its
+  // layout and only switches the data index to hash search.
+  options->prefix_extractor = std::make_shared<IntentsPrefixExtractor>();
+  options->memtable_prefix_bloom_bits = std::max(FLAGS_intents_db_memtable_prefix_bloom_bits, 0);
+  auto table_options = *static_cast<rocksdb::BlockBasedTableOptions*>(
+      options->table_factory->GetOptions());
+  table_options.index_type = rocksdb::IndexType::kHashSearch;
+  options->table_factory.reset(rocksdb::NewBlockBasedTableFactory(table_options));
+}
+
+std::unique_ptr<PriorityThreadPool> CreatePriorityThreadPoolForCompactions() {
+  if (FLAGS_rocksdb_disable_compactions || FLAGS_priority_thread_pool_size == 0) {
+    return nullptr;
+  }
+  int size = FLAGS_priority_thread_pool_size;
+  if (size < 0) {
+    rocksdb::Options options;
+    AutoInitRocksDBFlags(&options);
+    size = options.max_background_compactions;
+  }
+  LOG(INFO) << "Using priority thread pool for compactions with " << size << " running tasks";
+  return std::make_unique<PriorityThreadPool>(size);
+}
+
+std::shared_ptr<rocksdb::RateLimiter> CreateSharedCompactFlushRateLimiter() {
+  if (!FLAGS_rocksdb_compact_flush_rate_limit_sharing_across_tablets ||
+      FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec <= 0) {
+    return nullptr;
+  }
+  return std::shared_ptr<rocksdb::RateLimiter>(
+      rocksdb::NewGenericRateLimiter(FLAGS_rocksdb_compact_flush_rate_limit_bytes_per_sec));
+}
+
+namespace {
+
+// Flushes are written with high priority and compactions with low priority.
+class IoSchedulerRateLimiter : public rocksdb::RateLimiter {
+ public:
+  explicit IoSchedulerRateLimiter(std::shared_ptr<IoScheduler> io_scheduler)
+      : io_scheduler_(std::move(io_scheduler)) {}
+
+  // The rate is chosen by the scheduler.
+  void SetBytesPerSecond(int64_t bytes_per_second) override {}
+
+  void Request(const int64_t bytes, const rocksdb::Env::IOPriority pri) override {
+    io_scheduler_->Request(ToIoPriority(pri), bytes);
+    total_requests_[pri].fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  int64_t GetSingleBurstBytes() const override {
+    return io_scheduler_->burst_bytes();
+  }
+
+  int64_t GetTotalBytesThrough(
+      const rocksdb::Env::IOPriority pri = rocksdb::Env::IO_TOTAL) const override {
+    if (pri == rocksdb::Env::IO_TOTAL) {
+      return GetTotalBytesThrough(rocksdb::Env::IO_LOW) +
+             GetTotalBytesThrough(rocksdb::Env::IO_HIGH);
+    }
+    return io_scheduler_->total_bytes(ToIoPriority(pri));
+  }
+
+  int64_t GetTotalRequests(
+      const rocksdb::Env::IOPriority pri = rocksdb::Env::IO_TOTAL) const override {
+    if (pri == rocksdb::Env::IO_TOTAL) {
+      return GetTotalRequests(rocksdb::Env::IO_LOW) + GetTotalRequests(rocksdb::Env::IO_HIGH);
+    }
+    return total_requests_[pri].load(std::memory_order_acquire);
+  }
+
+ private:
+  static IoPriority ToIoPriority(rocksdb::Env::IOPriority pri) {
+    return pri == rocksdb::Env::IO_HIGH ? IoPriority::kFlush : IoPriority::kCompaction;
+  }
+
+  std::shared_ptr<IoScheduler> io_scheduler_;
+  std::atomic<int64_t> total_requests_[rocksdb::Env::IO_TOTAL] = {{0}, {0}};
+};
+
+} // namespace
+
+std::shared_ptr<rocksdb::RateLimiter> CreateIoSchedulerRateLimiter(
+    std::shared_ptr<IoScheduler> io_scheduler) {
+  return std::make_shared<IoSchedulerRateLimiter>(std::move(io_scheduler));
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -31,6 +31,9 @@
 #include "yb/util/slice.h"
 
 namespace yb {
+
+class IoScheduler;
+
 namespace docdb {
 
 class IntentAwareIterator;
@@ -102,9 +105,22 @@ enum class BloomFilterMode {
   DONT_USE_BLOOM_FILTER,
 };
 
-// It is only allowed to use bloom filters on scans within the same hashed components of the key,
-// because BloomFilterAwareIterator relies on it and ignores SST file completely if there are no
-// keys with the same hashed components as key specified for seek operation.
+// With SAME_PREFIX_ONLY the iterator may use the prefix hash index of the intents DB (see
+// InitIntentsDBOptions), so it is only positioned correctly while it stays within the prefix of the
+// key it was seeked to: a transaction id for reverse index records, or a document key for intents.
+enum class SeekMode {
+  TOTAL_ORDER,
+  SAME_PREFIX_ONLY,
+};
+
+// Returns true if all document keys in the [lower_doc_key, upper_doc_key] range have the same bloom
+// filter key, so the bloom filter could be used for the scan of this range. The filter key consists
+// of hashed components and --docdb_bloom_filter_range_components leading range components.
+Result<bool> BloomFilterKeysEqual(const Slice& lower_doc_key, const Slice& upper_doc_key);
+
+// It is only allowed to use bloom filters on scans within the same bloom filter key (see
+// BloomFilterKeysEqual), because BloomFilterAwareIterator relies on it and ignores SST file
+// completely if there are no keys with the same filter key as key specified for seek operation.
 // Note: bloom_filter_mode should be specified explicitly to avoid using it incorrectly by default.
 // user_key_for_filter is used with BloomFilterMode::USE_BLOOM_FILTER to exclude SST files which
 // have the same hashed components as (Sub)DocKey encoded in user_key_for_filter.
@@ -114,7 +130,8 @@ std::unique_ptr<rocksdb::Iterator> CreateRocksDBIterator(
     const boost::optional<const Slice>& user_key_for_filter,
     const rocksdb::QueryId query_id,
     std::shared_ptr<rocksdb::ReadFileFilter> file_filter = nullptr,
-    const Slice* iterate_upper_bound = nullptr);
+    const Slice* iterate_upper_bound = nullptr,
+    SeekMode seek_mode = SeekMode::TOTAL_ORDER);
 
 // Values and transactions committed later than high_ht can be skipped, so we won't spend time
 // for re-requesting pending transaction status if we already know it wasn't committed at high_ht.
@@ -137,6 +154,24 @@ void InitRocksDBOptions(
     const std::shared_ptr<rocksdb::Statistics>& statistics,
     const tablet::TabletOptions& tablet_options);
 
+// Adjusts 'options' initialized by InitRocksDBOptions for the intents DB. When
+// --intents_db_use_prefix_hash_index is set, reverse index records are hashed by transaction id and
+// intents by document key, both in SST file indexes and in memtable prefix blooms, so lookups by
+// transaction id and by intent key do not binary search the block index.
+void InitIntentsDBOptions(rocksdb::Options* options);
+
+// Creates the thread pool, that should be used for compactions of all tablets of the tablet
+// server. Returns nullptr, when compactions of each tablet should be scheduled separately.
+std::unique_ptr<PriorityThreadPool> CreatePriorityThreadPoolForCompactions();
+
+// Creates the rate limiter of compactions and flushes, that should be shared by all tablets of the
+// tablet server. Returns nullptr, when each tablet should use its own rate limiter.
+std::shared_ptr<rocksdb::RateLimiter> CreateSharedCompactFlushRateLimiter();
+
+// Creates the rate limiter of compactions and flushes of tablets on the disk of io_scheduler.
+std::shared_ptr<rocksdb::RateLimiter> CreateIoSchedulerRateLimiter(
+    std::shared_ptr<IoScheduler> io_scheduler);
+
 }  // namespace docdb
 }  // namespace yb
 
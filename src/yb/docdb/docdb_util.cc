@@ -15,6 +15,7 @@
 
 #include "yb/rocksdb/util/statistics.h"
 
+#include "yb/docdb/blob_storage.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb_util.h"
@@ -34,6 +35,8 @@ using yb::util::FormatBytesAsStr;
 using yb::util::ApplyEagerLineContinuation;
 using std::vector;
 
+DECLARE_int64(docdb_blob_value_threshold_bytes);
+
 namespace yb {
 namespace docdb {
 
@@ -55,13 +58,28 @@ Status DocDBRocksDBUtil::OpenRocksDB() {
     RETURN_NOT_OK(InitRocksDBDir());
   }
 
+  // Blob storage is only used by the regular DB.
+  auto regular_db_options = rocksdb_options_;
+  blob_storage_.reset();
+  if (FLAGS_docdb_blob_value_threshold_bytes > 0) {
+    RETURN_NOT_OK(rocksdb_options_.env->CreateDirIfMissing(rocksdb_dir_));
+    blob_storage_ = VERIFY_RESULT(BlobStorage::Open(
+        rocksdb_options_.env, BlobStorage::DirForDb(rocksdb_dir_)));
+    regular_db_options.listeners.push_back(blob_storage_);
+    regular_db_options.compaction_filter_factory = std::make_shared<DocDBCompactionFilterFactory>(
+        retention_policy_, &key_bounds_, blob_storage_.get(), &range_tombstones_);
+  }
+
   rocksdb::DB* rocksdb = nullptr;
-  RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options_, rocksdb_dir_, &rocksdb));
+  RETURN_NOT_OK(rocksdb::DB::Open(regular_db_options, rocksdb_dir_, &rocksdb));
   LOG(INFO) << "Opened RocksDB at " << rocksdb_dir_;
   rocksdb_.reset(rocksdb);
+  RETURN_NOT_OK(range_tombstones_.Load(rocksdb_.get()));
 
   rocksdb = nullptr;
-  RETURN_NOT_OK(rocksdb::DB::Open(rocksdb_options_, IntentsDBDir(), &rocksdb));
+  auto intents_db_options = rocksdb_options_;
+  InitIntentsDBOptions(&intents_db_options);
+  RETURN_NOT_OK(rocksdb::DB::Open(intents_db_options, IntentsDBDir(), &rocksdb));
   intents_db_.reset(rocksdb);
 
   return Status::OK();
@@ -76,7 +94,12 @@ Status DocDBRocksDBUtil::ReopenRocksDB() {
 Status DocDBRocksDBUtil::DestroyRocksDB() {
   intents_db_.reset();
   rocksdb_.reset();
+  blob_storage_.reset();
   LOG(INFO) << "Destroying RocksDB database at " << rocksdb_dir_;
+  const auto blob_dir = BlobStorage::DirForDb(rocksdb_dir_);
+  if (Env::Default()->FileExists(blob_dir)) {
+    RETURN_NOT_OK(Env::Default()->DeleteRecursively(blob_dir));
+  }
   RETURN_NOT_OK(rocksdb::DestroyDB(rocksdb_dir_, rocksdb_options_));
   RETURN_NOT_OK(rocksdb::DestroyDB(IntentsDBDir(), rocksdb_options_));
   return Status::OK();
@@ -93,7 +116,7 @@ Status DocDBRocksDBUtil::PopulateRocksDBWriteBatch(
     bool decode_dockey,
     bool increment_write_id) const {
   for (const auto& entry : dwb.key_value_pairs()) {
-    if (decode_dockey) {
+    if (decode_dockey && !IsRangeTombstoneKey(entry.first)) {
       SubDocKey subdoc_key;
       // We don't expect any invalid encoded keys in the write batch. However, these encoded keys
       // don't contain the HybridTime.
@@ -163,6 +186,9 @@ Status DocDBRocksDBUtil::WriteToRocksDB(
       doc_write_batch, &rocksdb_write_batch, hybrid_time, decode_dockey, increment_write_id));
 
   rocksdb::DB* db = current_txn_id_ ? intents_db_.get() : rocksdb_.get();
+  if (db == rocksdb_.get()) {
+    range_tombstones_.Update(rocksdb_write_batch);
+  }
   rocksdb::Status rocksdb_write_status = db->Write(write_options(), &rocksdb_write_batch);
 
   if (!rocksdb_write_status.ok()) {
@@ -186,7 +212,8 @@ Status DocDBRocksDBUtil::InitCommonRocksDBOptions() {
                             tablet_options);
   InitRocksDBWriteOptions(&write_options_);
   rocksdb_options_.compaction_filter_factory =
-      std::make_shared<docdb::DocDBCompactionFilterFactory>(retention_policy_);
+      std::make_shared<docdb::DocDBCompactionFilterFactory>(
+          retention_policy_, &key_bounds_, nullptr /* blob_storage */, &range_tombstones_);
   return Status::OK();
 }
 
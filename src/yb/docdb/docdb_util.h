@@ -22,6 +22,7 @@
 #include "yb/docdb/doc_write_batch.h"
 #include "yb/docdb/docdb_compaction_filter.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/range_tombstones.h"
 
 namespace yb {
 namespace docdb {
@@ -50,7 +51,13 @@ class DocDBRocksDBUtil {
 
   rocksdb::DB* rocksdb();
   rocksdb::DB* intents_db();
-  DocDB doc_db() { return {rocksdb(), intents_db()}; }
+  DocDB doc_db() {
+    return {rocksdb(), intents_db(), nullptr /* row_cache */, &key_bounds_, blob_storage_.get(),
+            &range_tombstones_};
+  }
+
+  // Blob storage of the regular DB, opened when docdb_blob_value_threshold_bytes is positive.
+  BlobStorage* blob_storage() { return blob_storage_.get(); }
 
   CHECKED_STATUS InitCommonRocksDBOptions();
 
@@ -188,6 +195,13 @@ class DocDBRocksDBUtil {
   std::shared_ptr<ManualHistoryRetentionPolicy> retention_policy_ {
       std::make_shared<ManualHistoryRetentionPolicy>() };
 
+  // Bounds applied by doc_db() readers and the compaction filter, not limited by default.
+  KeyBounds key_bounds_;
+
+  std::shared_ptr<BlobStorage> blob_storage_;
+
+  RangeTombstones range_tombstones_;
+
   rocksdb::WriteOptions write_options_;
   Schema schema_;
   boost::optional<TransactionId> current_txn_id_;
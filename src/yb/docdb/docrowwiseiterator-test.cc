@@ -16,11 +16,13 @@
 
 #include "yb/common/transaction-test-util.h"
 
+#include "yb/docdb/doc_ql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb_test_base.h"
 #include "yb/docdb/docdb_test_util.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/packed_row.h"
 
 #include "yb/server/hybrid_clock.h"
 
@@ -212,6 +214,94 @@ TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorTest) {
   }
 }
 
+TEST_F(DocRowwiseIteratorTest, PackedRow) {
+  // Row 1: packed row with null column e, later updates of columns on top of it.
+  {
+    PackedRowBuilder builder(/* schema_version = */ 1);
+    builder.AddColumn(30_ColId, PrimitiveValue("row1_c"));
+    builder.AddColumn(40_ColId, PrimitiveValue(10000));
+    ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey1), builder.Finish(),
+                           HybridTime::FromMicros(1000)));
+  }
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(50_ColId)),
+      PrimitiveValue("row1_e"), HybridTime::FromMicros(2000)));
+  ASSERT_OK(DeleteSubDoc(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)), HybridTime::FromMicros(3000)));
+
+  // Row 2: columns written before the packed row are overwritten by it.
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(500)));
+  {
+    PackedRowBuilder builder(/* schema_version = */ 1);
+    builder.AddColumn(40_ColId, PrimitiveValue(20000));
+    ASSERT_OK(SetPrimitive(DocPath(kEncodedDocKey2), builder.Finish(),
+                           HybridTime::FromMicros(1000)));
+  }
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  QLTableRow row;
+  QLValue value;
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(1500));
+    ASSERT_OK(iter.Init());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ("row1_c", value.string_value());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(10000, value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_TRUE(value.IsNull());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(20000, value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+
+  {
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(5000));
+    ASSERT_OK(iter.Init());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_TRUE(value.IsNull());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(10000, value.int64_value());
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_EQ("row1_e", value.string_value());
+
+    ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+    ASSERT_OK(iter.NextRow(&row));
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_TRUE(value.IsNull());
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(20000, value.int64_value());
+
+    ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+  }
+}
+
 TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorDeletedDocumentTest) {
   ASSERT_OK(SetPrimitive(
       DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
@@ -1037,5 +1127,266 @@ TEST_F(DocRowwiseIteratorTest, ScanWithinTheSameTxn) {
   ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
 }
 
+TEST_F(DocRowwiseIteratorTest, SkipIntentsIfNoneInRange) {
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+
+  TransactionStatusManagerMock txn_status_manager;
+
+  Result<TransactionId> txn = FullyDecodeTransactionId("0000000000000001");
+  ASSERT_OK(txn);
+
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(500)));
+
+  SetCurrentTransactionId(*txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c_t1"), HybridTime::FromMicros(600)));
+  ResetCurrentTransactionId();
+
+  const auto txn_context = TransactionOperationContext(*txn, &txn_status_manager);
+  const auto read_time = ReadHybridTime::FromMicros(1000);
+
+  {
+    // Range of the second row does not contain any intents, so they are skipped.
+    IntentAwareIterator iter(
+        doc_db(), rocksdb::ReadOptions(), CoarseTimePoint::max() /* deadline */, read_time,
+        txn_context);
+    ASSERT_TRUE(iter.reads_intents());
+    iter.SkipIntentsIfNoneInRange(
+        kEncodedDocKey2, KeyBytes(kEncodedDocKey2.AsSlice(), ValueTypeAsChar::kMaxByte));
+    ASSERT_FALSE(iter.reads_intents());
+    iter.Seek(kEncodedDocKey2);
+    ASSERT_TRUE(iter.valid());
+    ASSERT_TRUE(ASSERT_RESULT(iter.FetchKey()).starts_with(kEncodedDocKey2));
+  }
+
+  {
+    // The whole table range contains intents of the first row, so they have to be read.
+    IntentAwareIterator iter(
+        doc_db(), rocksdb::ReadOptions(), CoarseTimePoint::max() /* deadline */, read_time,
+        txn_context);
+    iter.SkipIntentsIfNoneInRange(Slice(), Slice());
+    ASSERT_TRUE(iter.reads_intents());
+  }
+
+  // The scan still returns the provisional record of the current transaction.
+  DocRowwiseIterator iter(
+      kProjectionForIteratorTests, kSchemaForIteratorTests, txn_context, doc_db(),
+      CoarseTimePoint::max() /* deadline */, read_time);
+  ASSERT_OK(iter.Init());
+
+  QLTableRow row;
+  QLValue value;
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(kProjectionForIteratorTests.column_id(0), &value));
+  ASSERT_EQ("row1_c_t1", value.string_value());
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(kProjectionForIteratorTests.column_id(0), &value));
+  ASSERT_EQ("row2_c", value.string_value());
+
+  ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+}
+
+namespace {
+
+// Reports all intents as belonging to the reading transaction, so they are read from memory.
+class OwnIntentsStatusManager : public TransactionStatusManagerMock {
+ public:
+  explicit OwnIntentsStatusManager(rocksdb::DB* intents_db) : intents_db_(intents_db) {}
+
+  StrongIntentsInRange LookupStrongIntents(
+      const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+      IntentRecords* records) override {
+    ++lookups_;
+    std::unique_ptr<rocksdb::Iterator> iter(intents_db_->NewIterator(rocksdb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      // Skip transaction metadata and reverse index records.
+      if (iter->key()[0] != ValueTypeAsChar::kTransactionId) {
+        records->emplace_back(iter->key().ToBuffer(), iter->value().ToBuffer());
+      }
+    }
+    return records->empty() ? StrongIntentsInRange::kNone : StrongIntentsInRange::kOwnOnly;
+  }
+
+  size_t lookups() const {
+    return lookups_;
+  }
+
+ private:
+  rocksdb::DB* intents_db_;
+  size_t lookups_ = 0;
+};
+
+} // namespace
+
+TEST_F(DocRowwiseIteratorTest, OwnIntentsFromMemory) {
+  SetTransactionIsolationLevel(IsolationLevel::SNAPSHOT_ISOLATION);
+
+  OwnIntentsStatusManager txn_status_manager(doc_db().intents);
+
+  Result<TransactionId> txn = FullyDecodeTransactionId("0000000000000001");
+  ASSERT_OK(txn);
+
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c"), HybridTime::FromMicros(500)));
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey2, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row2_c"), HybridTime::FromMicros(500)));
+
+  SetCurrentTransactionId(*txn);
+  ASSERT_OK(SetPrimitive(
+      DocPath(kEncodedDocKey1, PrimitiveValue(30_ColId)),
+      PrimitiveValue("row1_c_t1"), HybridTime::FromMicros(600)));
+  ResetCurrentTransactionId();
+
+  const auto txn_context = TransactionOperationContext(*txn, &txn_status_manager);
+  // Only registered readers could use the in-memory intents.
+  auto read_time = ReadHybridTime::FromMicros(1000);
+  read_time.serial_no = 1;
+
+  DocRowwiseIterator iter(
+      kProjectionForIteratorTests, kSchemaForIteratorTests, txn_context, doc_db(),
+      CoarseTimePoint::max() /* deadline */, read_time);
+  ASSERT_OK(iter.Init());
+  ASSERT_EQ(1, txn_status_manager.lookups());
+
+  // Provisional record of the transaction overrides the committed value.
+  QLTableRow row;
+  QLValue value;
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(kProjectionForIteratorTests.column_id(0), &value));
+  ASSERT_EQ("row1_c_t1", value.string_value());
+
+  ASSERT_TRUE(ASSERT_RESULT(iter.HasNext()));
+  ASSERT_OK(iter.NextRow(&row));
+  ASSERT_OK(row.GetValue(kProjectionForIteratorTests.column_id(0), &value));
+  ASSERT_EQ("row2_c", value.string_value());
+
+  ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+}
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorNextBatch) {
+  constexpr int kNumRows = 5;
+  std::vector<KeyBytes> doc_keys;
+  for (int i = 0; i != kNumRows; ++i) {
+    doc_keys.push_back(DocKey(PrimitiveValues(Format("row$0", i), i)).Encode());
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_keys.back(), PrimitiveValue(30_ColId)),
+        PrimitiveValue(Format("row$0_c", i)), HybridTime::FromMicros(1000)));
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_keys.back(), PrimitiveValue(40_ColId)),
+        PrimitiveValue(i * 10), HybridTime::FromMicros(1000)));
+  }
+
+  const Schema &schema = kSchemaForIteratorTests;
+  const Schema &projection = kProjectionForIteratorTests;
+  const auto tuple_id_column = static_cast<ColumnIdRep>(PgSystemAttrNum::kYBTupleId);
+
+  DocRowwiseIterator iter(
+      projection, schema, kNonTransactionalOperationContext, doc_db(),
+      CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+  ASSERT_OK(iter.Init());
+
+  std::vector<QLTableRow::SharedPtr> rows;
+  ASSERT_EQ(3, ASSERT_RESULT(iter.NextBatch(projection, 3, true /* include_tuple_id */, &rows)));
+  ASSERT_EQ(3, rows.size());
+  auto* first_row = rows[0].get();
+
+  // The last batch is shorter than requested because the iterator is exhausted, and it reuses the
+  // rows allocated by the previous one.
+  ASSERT_EQ(2, ASSERT_RESULT(iter.NextBatch(projection, 3, true /* include_tuple_id */, &rows)));
+  ASSERT_EQ(3, rows.size());
+  ASSERT_EQ(first_row, rows[0].get());
+
+  for (int i = 0; i != 2; ++i) {
+    const int row_index = 3 + i;
+    const auto& row = *rows[i];
+    QLValue value;
+
+    ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+    ASSERT_EQ(Format("row$0_c", row_index), value.string_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+    ASSERT_EQ(row_index * 10, value.int64_value());
+
+    ASSERT_OK(row.GetValue(projection.column_id(2), &value));
+    ASSERT_TRUE(value.IsNull());
+
+    auto tuple_id = row.GetValue(tuple_id_column);
+    ASSERT_TRUE(tuple_id);
+    ASSERT_EQ(doc_keys[row_index].data(), tuple_id->binary_value());
+  }
+
+  ASSERT_EQ(0, ASSERT_RESULT(iter.NextBatch(projection, 3, false /* include_tuple_id */, &rows)));
+  ASSERT_FALSE(ASSERT_RESULT(iter.HasNext()));
+}
+
+TEST_F(DocRowwiseIteratorTest, DocRowwiseIteratorUnsortedInList) {
+  const Schema schema({
+          ColumnSchema("h", DataType::INT32, /* is_nullable = */ false, /* is_hash_key = */ true),
+          ColumnSchema("r", DataType::INT64, false),
+          // Non-key columns
+          ColumnSchema("v", DataType::INT64, true)
+      }, {
+          10_ColId,
+          20_ColId,
+          30_ColId
+      }, 2);
+  constexpr DocKeyHash kHash = 0x1234;
+  const std::vector<PrimitiveValue> hashed_components{PrimitiveValue::Int32(1)};
+
+  for (int i = 0; i != 10; ++i) {
+    DocKey doc_key(kHash, hashed_components, {PrimitiveValue(i)});
+    ASSERT_OK(SetPrimitive(
+        DocPath(doc_key.Encode(), PrimitiveValue(30_ColId)), PrimitiveValue(i * 10),
+        HybridTime::FromMicros(1000)));
+  }
+
+  // IN-list is neither ordered nor de-duplicated.
+  QLConditionPB condition;
+  condition.set_op(QL_OP_IN);
+  condition.add_operands()->set_column_id(20);
+  auto* options = condition.add_operands()->mutable_value()->mutable_list_value();
+  for (int64_t value : {7, 2, 5, 2, 9}) {
+    options->add_elems()->set_int64_value(value);
+  }
+
+  Schema projection;
+  ASSERT_OK(schema.CreateProjectionByNames({"r", "v"}, &projection));
+
+  for (bool is_forward_scan : {true, false}) {
+    DocQLScanSpec spec(
+        schema, kHash, kHash, hashed_components, &condition, rocksdb::kDefaultQueryId,
+        is_forward_scan);
+    DocRowwiseIterator iter(
+        projection, schema, kNonTransactionalOperationContext, doc_db(),
+        CoarseTimePoint::max() /* deadline */, ReadHybridTime::FromMicros(2000));
+    ASSERT_OK(iter.Init(spec));
+
+    std::vector<int64_t> expected = {2, 5, 7, 9};
+    if (!is_forward_scan) {
+      std::reverse(expected.begin(), expected.end());
+    }
+    std::vector<int64_t> actual;
+    QLTableRow row;
+    QLValue value;
+    while (ASSERT_RESULT(iter.HasNext())) {
+      ASSERT_OK(iter.NextRow(&row));
+      ASSERT_OK(row.GetValue(projection.column_id(0), &value));
+      actual.push_back(value.int64_value());
+      ASSERT_OK(row.GetValue(projection.column_id(1), &value));
+      ASSERT_EQ(actual.back() * 10, value.int64_value());
+    }
+    ASSERT_EQ(expected, actual);
+  }
+}
+
 }  // namespace docdb
 }  // namespace yb
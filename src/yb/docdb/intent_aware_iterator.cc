@@ -13,6 +13,7 @@
 
 #include "yb/docdb/intent_aware_iterator.h"
 
+#include <algorithm>
 #include <future>
 #include <thread>
 #include <boost/optional/optional_io.hpp>
@@ -21,10 +22,14 @@
 #include "yb/common/hybrid_time.h"
 #include "yb/common/transaction.h"
 
+#include "yb/docdb/blob_storage.h"
+#include "yb/docdb/bounded_rocksdb_iterator.h"
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb-internal.h"
 #include "yb/docdb/intent.h"
+#include "yb/docdb/range_tombstones.h"
+#include "yb/docdb/storage_profile.h"
 #include "yb/docdb/value.h"
 
 #include "yb/server/hybrid_clock.h"
@@ -35,6 +40,10 @@ using namespace std::literals;
 DEFINE_bool(transaction_allow_rerequest_status_in_tests, true,
             "Allow rerequest transaction status when try again is received.");
 
+DEFINE_bool(skip_intents_for_intent_free_ranges, true,
+            "Whether transactional reads should check up front if the intents DB has any records "
+            "in the scanned key range, and read only the regular DB when it does not.");
+
 namespace yb {
 namespace docdb {
 
@@ -83,6 +92,14 @@ Result<HybridTime> TransactionStatusCache::GetCommitTime(const TransactionId& tr
 }
 
 Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId& transaction_id) {
+  auto* shared_cache = txn_status_manager_->shared_status_cache();
+  if (shared_cache) {
+    auto commit_time = shared_cache->GetCommitTime(transaction_id, read_time_.global_limit);
+    if (commit_time.is_valid()) {
+      return commit_time;
+    }
+  }
+
   HybridTime local_commit_time = GetLocalCommitTime(transaction_id);
   if (local_commit_time.is_valid()) {
     return local_commit_time;
@@ -127,6 +144,9 @@ Result<HybridTime> TransactionStatusCache::DoGetCommitTime(const TransactionId&
   VLOG(4) << "Transaction_id " << transaction_id << " at " << read_time_
           << ": status: " << TransactionStatus_Name(txn_status.status)
           << ", status_time: " << txn_status.status_time;
+  if (shared_cache) {
+    shared_cache->Update(transaction_id, txn_status);
+  }
   // There could be case when transaction was committed and applied between previous call to
   // GetLocalCommitTime, in this case coordinator does not know transaction and will respond
   // with ABORTED status. So we recheck whether it was committed locally.
@@ -218,6 +238,70 @@ std::string DebugDumpKeyToStr(const KeyBytes &key) {
   return DebugDumpKeyToStr(key.AsSlice());
 }
 
+// Iterates over intents DB records copied from the transaction participant, respecting the upper
+// bound of the intents DB iterator, that it replaces.
+class IntentRecordsIterator : public rocksdb::Iterator {
+ public:
+  IntentRecordsIterator(IntentRecords records, const Slice* upper_bound)
+      : records_(std::move(records)), upper_bound_(*upper_bound), position_(records_.size()) {}
+
+  bool Valid() const override {
+    return position_ < records_.size() && BelowUpperBound(records_[position_].first);
+  }
+
+  void SeekToFirst() override {
+    position_ = 0;
+  }
+
+  void SeekToLast() override {
+    auto it = upper_bound_.empty()
+        ? records_.end()
+        : std::lower_bound(records_.begin(), records_.end(), upper_bound_, KeyLess());
+    position_ = it == records_.begin() ? records_.size() : it - records_.begin() - 1;
+  }
+
+  void Seek(const Slice& target) override {
+    position_ = std::lower_bound(records_.begin(), records_.end(), target, KeyLess()) -
+                records_.begin();
+  }
+
+  void Next() override {
+    ++position_;
+  }
+
+  void Prev() override {
+    position_ = position_ == 0 ? records_.size() : position_ - 1;
+  }
+
+  Slice key() const override {
+    return records_[position_].first;
+  }
+
+  Slice value() const override {
+    return records_[position_].second;
+  }
+
+  Status status() const override {
+    return Status::OK();
+  }
+
+ private:
+  struct KeyLess {
+    bool operator()(const IntentRecords::value_type& lhs, const Slice& rhs) const {
+      return Slice(lhs.first).compare(rhs) < 0;
+    }
+  };
+
+  bool BelowUpperBound(const std::string& key) const {
+    return upper_bound_.empty() || Slice(key).compare(upper_bound_) < 0;
+  }
+
+  const IntentRecords records_;
+  // Bound of the intent aware iterator, that is changed by SetIntentUpperbound.
+  const Slice& upper_bound_;
+  size_t position_;
+};
+
 bool DebugHasHybridTime(const Slice& subdoc_key_encoded) {
   SubDocKey subdoc_key;
   CHECK(subdoc_key.FullyDecodeFromKeyWithOptionalHybridTime(subdoc_key_encoded).ok());
@@ -238,6 +322,7 @@ IntentAwareIterator::IntentAwareIterator(
       encoded_read_time_global_limit_(
           DocHybridTime(read_time_.global_limit, kMaxWriteId).EncodedInDocDbFormat()),
       txn_op_context_(txn_op_context),
+      row_cache_(txn_op_context ? nullptr : doc_db.row_cache),
       transaction_status_cache_(
           txn_op_context ? &txn_op_context->txn_status_manager : nullptr, read_time, deadline) {
   VLOG(4) << "IntentAwareIterator, read_time: " << read_time
@@ -249,8 +334,72 @@ IntentAwareIterator::IntentAwareIterator(
                                                 rocksdb::kDefaultQueryId,
                                                 nullptr /* file_filter */,
                                                 &intent_upperbound_);
+    intent_iter_ = BoundIterator(std::move(intent_iter_), doc_db.key_bounds);
+  }
+  iter_ = BoundIterator(
+      std::unique_ptr<rocksdb::Iterator>(doc_db.regular->NewIterator(read_opts)),
+      doc_db.key_bounds);
+  // Tombstones are taken after the RocksDB iterator, so they account for all visible writes.
+  auto range_tombstones =
+      doc_db.range_tombstones ? doc_db.range_tombstones->Get() : RangeTombstonesSnapshot();
+  if (range_tombstones && !range_tombstones->empty()) {
+    auto range_tombstone_iter = std::make_unique<RangeTombstoneIterator>(
+        std::move(iter_), std::move(range_tombstones), read_time_);
+    range_tombstone_iter_ = range_tombstone_iter.get();
+    iter_ = std::move(range_tombstone_iter);
+  }
+  if (doc_db.blob_storage) {
+    iter_ = std::make_unique<BlobResolvingIterator>(std::move(iter_), doc_db.blob_storage);
+  }
+}
+
+void IntentAwareIterator::SkipIntentsIfNoneInRange(const Slice& lower_bound,
+                                                   const Slice& upper_bound) {
+  if (!intent_iter_ || !status_.ok() || !FLAGS_skip_intents_for_intent_free_ranges) {
+    return;
+  }
+
+  // Transaction participant keeps transactions in memory until all requests registered before
+  // their intents were removed are complete. So a registered reader could check its in-memory
+  // index of intents instead of seeking the intents DB.
+  const bool registered_request = read_time_.serial_no != 0;
+  auto intents = StrongIntentsInRange::kUnknown;
+  if (registered_request) {
+    IntentRecords records;
+    intents = txn_op_context_->txn_status_manager.LookupStrongIntents(
+        txn_op_context_->transaction_id, lower_bound, upper_bound, &records);
+    if (intents == StrongIntentsInRange::kOwnOnly) {
+      // Intents of other transactions could be only outside of the range, so the following
+      // operations could read provisional records of this transaction from memory.
+      VLOG(4) << "Only own intents in range [" << SubDocKey::DebugSliceToString(lower_bound)
+              << ", " << SubDocKey::DebugSliceToString(upper_bound) << "): " << records.size();
+      intent_iter_ = std::make_unique<IntentRecordsIterator>(
+          std::move(records), &intent_upperbound_);
+      seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
+      resolved_intent_state_ = ResolvedIntentState::kNoIntent;
+      return;
+    }
   }
-  iter_.reset(doc_db.regular->NewIterator(read_opts));
+  if (intents == StrongIntentsInRange::kUnknown) {
+    // Intents iterator is pinned to the same DB state for its whole lifetime, so if it does not
+    // see any record in the range now, none of the following seeks within the range would find
+    // one.
+    ResetIntentUpperbound();
+    SeekIntentIter(lower_bound);
+    if (!intent_iter_->status().ok() ||
+        (intent_iter_->Valid() &&
+         (upper_bound.empty() || intent_iter_->key().compare(upper_bound) < 0))) {
+      // The next seek repositions the intent iterator, so there is nothing to restore here.
+      return;
+    }
+  }
+
+  VLOG(4) << "No intents in range [" << SubDocKey::DebugSliceToString(lower_bound) << ", "
+          << SubDocKey::DebugSliceToString(upper_bound) << "), reading regular DB only";
+  intent_iter_.reset();
+  seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
+  skip_future_intents_needed_ = false;
+  resolved_intent_state_ = ResolvedIntentState::kNoIntent;
 }
 
 void IntentAwareIterator::Seek(const DocKey &doc_key) {
@@ -437,7 +586,7 @@ void IntentAwareIterator::PrevSubDocKey(const KeyBytes& key_bytes) {
 
   if (intent_iter_) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(key_bytes));
+    SeekIntentIter(GetIntentPrefixForKeyWithoutHt(key_bytes));
     if (intent_iter_->Valid()) {
       intent_iter_->Prev();
     } else {
@@ -469,7 +618,7 @@ void IntentAwareIterator::PrevDocKey(const Slice& encoded_doc_key) {
 
   if (intent_iter_) {
     ResetIntentUpperbound();
-    ROCKSDB_SEEK(intent_iter_.get(), GetIntentPrefixForKeyWithoutHt(encoded_doc_key));
+    SeekIntentIter(GetIntentPrefixForKeyWithoutHt(encoded_doc_key));
     if (intent_iter_->Valid()) {
       intent_iter_->Prev();
     } else {
@@ -538,7 +687,7 @@ void IntentAwareIterator::SeekIntentIterIfNeeded() {
     case SeekIntentIterNeeded::kNoNeed:
       break;
     case SeekIntentIterNeeded::kSeek:
-      ROCKSDB_SEEK(intent_iter_.get(), seek_key_buffer_);
+      SeekIntentIter(seek_key_buffer_);
       SeekToSuitableIntent<Direction::kForward>();
       seek_intent_iter_needed_ = SeekIntentIterNeeded::kNoNeed;
       return;
@@ -608,6 +757,13 @@ Slice IntentAwareIterator::value() {
   }
 }
 
+HybridTime IntentAwareIterator::max_seen_ht() {
+  if (range_tombstone_iter_) {
+    return std::max(max_seen_ht_, range_tombstone_iter_->max_seen_ht());
+  }
+  return max_seen_ht_;
+}
+
 void IntentAwareIterator::SeekForwardRegular(const Slice& slice) {
   VLOG(4) << "SeekForwardRegular(" << SubDocKey::DebugSliceToString(slice) << ")";
   docdb::SeekForward(slice, iter_.get());
@@ -680,6 +836,11 @@ void IntentAwareIterator::UpdateResolvedIntentSubDocKeyEncoded() {
           << DebugDumpKeyToStr(resolved_intent_sub_doc_key_encoded_);
 }
 
+void IntentAwareIterator::SeekIntentIter(const Slice& key) {
+  ROCKSDB_SEEK(intent_iter_.get(), key);
+  RecordIntentSeek();
+}
+
 void IntentAwareIterator::SeekForwardToSuitableIntent(const KeyBytes &intent_key_prefix) {
   DOCDB_DEBUG_SCOPE_LOG(intent_key_prefix.ToString(),
                         std::bind(&IntentAwareIterator::DebugDump, this));
@@ -687,9 +848,9 @@ void IntentAwareIterator::SeekForwardToSuitableIntent(const KeyBytes &intent_key
       resolved_intent_key_prefix_.CompareTo(intent_key_prefix) >= 0) {
     return;
   }
-  // Use ROCKSDB_SEEK() to force re-seek of "intent_iter_" in case the iterator was invalid by the
+  // Use SeekIntentIter() to force re-seek of "intent_iter_" in case the iterator was invalid by the
   // previous intent upperbound, but the upperbound has changed therefore requiring re-seek.
-  ROCKSDB_SEEK(intent_iter_.get(), intent_key_prefix.AsSlice());
+  SeekIntentIter(intent_key_prefix.AsSlice());
   SeekToSuitableIntent<Direction::kForward>();
 }
 
@@ -32,6 +32,7 @@ class TransactionStatusManager;
 
 namespace docdb {
 
+class RangeTombstoneIterator;
 class Value;
 struct Expiration;
 
@@ -41,6 +42,8 @@ YB_DEFINE_ENUM(SeekIntentIterNeeded, (kNoNeed)(kSeek)(kSeekForward));
 
 // Caches transaction statuses fetched by single IntentAwareIterator.
 // Thread safety is not required, because IntentAwareIterator is used in a single thread only.
+// Statuses received from transaction coordinators are also shared with other readers of the
+// tablet through SharedTransactionStatusCache, when the status manager provides it.
 class TransactionStatusCache {
  public:
   TransactionStatusCache(TransactionStatusManager* txn_status_manager,
@@ -90,6 +93,19 @@ class IntentAwareIterator {
   IntentAwareIterator(const IntentAwareIterator& other) = delete;
   void operator=(const IntentAwareIterator& other) = delete;
 
+  // Checks whether the intents DB has any records with keys in [lower_bound, upper_bound), an
+  // empty upper_bound means the end of the regular key space. If it has none, the intent iterator
+  // is released and the following operations read the regular DB only. If the range contains only
+  // intents of the current transaction, that are known to the transaction participant, they are
+  // read from memory instead of the intents DB. Should be called before positioning the iterator.
+  void SkipIntentsIfNoneInRange(const Slice& lower_bound, const Slice& upper_bound);
+
+  // Returns true if this iterator reads provisional records from the intents DB.
+  bool reads_intents() const { return intent_iter_ != nullptr; }
+
+  // Cache of decoded documents that could be used by this iterator, nullptr if none.
+  DocRowCache* row_cache() const { return row_cache_; }
+
   // Seek to the smallest key which is greater or equal than doc_key.
   void Seek(const DocKey& doc_key);
 
@@ -142,7 +158,7 @@ class IntentAwareIterator {
   bool valid();
   Slice value();
   ReadHybridTime read_time() { return read_time_; }
-  HybridTime max_seen_ht() { return max_seen_ht_; }
+  HybridTime max_seen_ht();
 
   // Iterate through Next() until a row containing a full record (non merge record) is found.
   // The key is not guaranteed to stay the same. The key without hybrid time and value of the
@@ -199,6 +215,9 @@ class IntentAwareIterator {
   // If iterator already positioned far enough - does not perform seek.
   void SeekForwardToSuitableIntent(const KeyBytes &intent_key_prefix);
 
+  // Seeks intent_iter_ to key, accounting the seek in the storage profile of the current thread.
+  void SeekIntentIter(const Slice& key);
+
   // Seek intent sub-iterator forward (backward) to latest suitable intent for first available
   // key. Updates resolved_intent_XXX fields.
   // intent_iter_ will be positioned to first intent for the smallest (biggest) key
@@ -255,8 +274,11 @@ class IntentAwareIterator {
   const string encoded_read_time_local_limit_;
   const string encoded_read_time_global_limit_;
   const TransactionOperationContextOpt txn_op_context_;
+  DocRowCache* const row_cache_;
   std::unique_ptr<rocksdb::Iterator> intent_iter_;
   std::unique_ptr<rocksdb::Iterator> iter_;
+  // Wrapper of the regular DB iterator inside iter_, if there are range tombstones.
+  RangeTombstoneIterator* range_tombstone_iter_ = nullptr;
   // iter_valid_ is true if and only if iter_ is positioned at key which matches top prefix from
   // the stack and record time satisfies read_time_ criteria.
   bool iter_valid_ = false;
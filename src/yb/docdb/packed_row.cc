@@ -0,0 +1,65 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/packed_row.h"
+
+#include "yb/docdb/value.h"
+
+#include "yb/util/fast_varint.h"
+
+namespace yb {
+namespace docdb {
+
+PackedRowBuilder::PackedRowBuilder(uint32_t schema_version) : last_column_id_(0) {
+  util::FastAppendUnsignedVarIntToStr(schema_version, &encoded_);
+}
+
+void PackedRowBuilder::AddColumn(ColumnId column_id, const PrimitiveValue& value) {
+  DCHECK_GE(column_id, last_column_id_);
+  util::FastAppendUnsignedVarIntToStr(column_id - last_column_id_, &encoded_);
+  last_column_id_ = column_id;
+  const std::string encoded_value = value.ToValue();
+  util::FastAppendUnsignedVarIntToStr(encoded_value.size(), &encoded_);
+  encoded_.append(encoded_value);
+}
+
+Value PackedRowBuilder::Finish() {
+  return Value::PackedRow(std::move(encoded_));
+}
+
+Status DecodePackedRow(
+    const Slice& packed_row, uint32_t* schema_version, PackedColumns* columns) {
+  Slice input = packed_row;
+  *schema_version = static_cast<uint32_t>(VERIFY_RESULT(util::FastDecodeUnsignedVarInt(&input)));
+  columns->clear();
+  ColumnIdRep column_id = 0;
+  while (!input.empty()) {
+    // Column id delta and value size.
+    uint64_t header[2];
+    RETURN_NOT_OK(util::FastDecodeUnsignedVarInts(&input, header, 2));
+    column_id += header[0];
+    const auto value_size = header[1];
+    if (value_size > input.size()) {
+      return STATUS_FORMAT(
+          Corruption, "Not enough bytes for value of column $0 in packed row $1: $2 vs $3",
+          column_id, packed_row.ToDebugHexString(), value_size, input.size());
+    }
+    columns->emplace_back(ColumnId(column_id), PrimitiveValue());
+    RETURN_NOT_OK(columns->back().second.DecodeFromValue(Slice(input.data(), value_size)));
+    input.remove_prefix(value_size);
+  }
+  return Status::OK();
+}
+
+}  // namespace docdb
+}  // namespace yb
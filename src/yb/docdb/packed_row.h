@@ -0,0 +1,71 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_PACKED_ROW_H_
+#define YB_DOCDB_PACKED_ROW_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yb/common/schema.h"
+#include "yb/docdb/primitive_value.h"
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace docdb {
+
+class Value;
+
+// A packed row stores all non-key columns of a row as a single value of the document key, instead
+// of a separate key-value pair per column. It is written by inserts, so it overwrites all older
+// values of the row, i.e. it works like an object init marker with children. Later updates of
+// individual columns are written as usual and take precedence over the packed values, because
+// they have higher hybrid time.
+//
+// Encoded packed row (after ValueType::kPackedRow) has the following format:
+//     schema_version: varint
+//     for each non-null column in ascending order of column ids:
+//         column_id_delta: varint (difference with the previous column id, or column id itself)
+//         value_size: varint
+//         value: PrimitiveValue encoded as value
+//
+// Column ids are stored in the row, so it could be decoded without the schema of the version that
+// was used to write it.
+class PackedRowBuilder {
+ public:
+  explicit PackedRowBuilder(uint32_t schema_version);
+
+  // Columns should be added in ascending order of their ids.
+  void AddColumn(ColumnId column_id, const PrimitiveValue& value);
+
+  // Returns the value that contains all the added columns.
+  Value Finish();
+
+ private:
+  std::string encoded_;
+  ColumnId last_column_id_;
+};
+
+typedef std::vector<std::pair<ColumnId, PrimitiveValue>> PackedColumns;
+
+// Decodes packed row, i.e. the value returned by Value::packed_row(). Columns are returned in
+// ascending order of their ids.
+CHECKED_STATUS DecodePackedRow(
+    const Slice& packed_row, uint32_t* schema_version, PackedColumns* columns);
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif  // YB_DOCDB_PACKED_ROW_H_
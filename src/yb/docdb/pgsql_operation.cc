@@ -20,11 +20,31 @@
 
 #include "yb/docdb/doc_pgsql_scanspec.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
+#include "yb/docdb/packed_row.h"
 #include "yb/docdb/primitive_value_util.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/trace.h"
 
 DECLARE_bool(trace_docdb_calls);
+DECLARE_int32(docdb_scan_batch_size);
+
+DEFINE_bool(ysql_enable_blind_column_updates, true,
+            "Apply UPDATE by row id, that sets columns to constants, without reading the row.");
+TAG_FLAG(ysql_enable_blind_column_updates, advanced);
+
+DEFINE_bool(ysql_enable_packed_row, false,
+            "Write all columns of an inserted YSQL row as a single packed value. Tables with "
+            "packed rows could not be read by older versions.");
+TAG_FLAG(ysql_enable_packed_row, advanced);
+
+DEFINE_int32(ysql_scan_deadline_margin_ms, 1000,
+             "A YSQL scan, that could be continued from a paging state, stops this long before "
+             "the client deadline and returns rows read so far with a paging state.");
+TAG_FLAG(ysql_scan_deadline_margin_ms, advanced);
+TAG_FLAG(ysql_scan_deadline_margin_ms, runtime);
+
+using namespace std::literals;
 
 namespace yb {
 namespace docdb {
@@ -47,6 +67,28 @@ CHECKED_STATUS CreateProjection(const Schema& schema,
   return schema.CreateProjectionByIdsIgnoreMissing(column_ids, projection);
 }
 
+// Returns true if the update does not depend on the current row, i.e. it sets columns of the row,
+// that is identified by ybctid, to constant values and returns nothing but the ybctid. Existence
+// of the row is guaranteed by the YSQL layer, that has found ybctid.
+bool IsBlindUpdate(const PgsqlWriteRequestPB& request) {
+  if (request.stmt_type() != PgsqlWriteRequestPB::PGSQL_UPDATE ||
+      !request.has_ybctid_column_value() || request.has_where_expr()) {
+    return false;
+  }
+  for (const auto& column_value : request.column_new_values()) {
+    if (!column_value.expr().has_value()) {
+      return false;
+    }
+  }
+  for (const auto& target : request.targets()) {
+    if (!target.has_column_id() ||
+        target.column_id() != static_cast<int>(PgSystemAttrNum::kYBTupleId)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // namespace
 
 //--------------------------------------------------------------------------------------------------
@@ -82,6 +124,7 @@ Status PgsqlWriteOperation::Init(PgsqlWriteRequestPB* request, PgsqlResponsePB*
     }
   }
   encoded_doc_key_ = doc_key_->EncodeAsRefCntPrefix();
+  blind_update_ = FLAGS_ysql_enable_blind_column_updates && IsBlindUpdate(request_);
 
   return Status::OK();
 }
@@ -115,15 +158,9 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
   const MonoDelta ttl = Value::kMaxTtl;
   const UserTimeMicros user_timestamp = Value::kInvalidUserTimestamp;
 
-  // Add the appropriate liveness column.
-  if (encoded_doc_key_) {
-    const DocPath sub_path(encoded_doc_key_.as_slice(),
-                           PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
-    const auto value = Value(PrimitiveValue(), ttl, user_timestamp);
-    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
-        sub_path, value, data.read_time, data.deadline, request_.stmt_id()));
-  }
-
+  std::vector<std::pair<ColumnId, SubDocument>> column_values;
+  column_values.reserve(request_.column_values_size());
+  bool all_values_primitive = true;
   for (const auto& column_value : request_.column_values()) {
     // Get the column.
     if (!column_value.has_column_id()) {
@@ -141,13 +178,46 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
     // Evaluate column value.
     QLValue expr_result;
     RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
-    const SubDocument sub_doc =
-        SubDocument::FromQLValuePB(expr_result.value(), column->sorting_type());
+    column_values.emplace_back(
+        column_id, SubDocument::FromQLValuePB(expr_result.value(), column->sorting_type()));
+    const auto value_type = column_values.back().second.value_type();
+    all_values_primitive = all_values_primitive &&
+                           (IsPrimitiveValueType(value_type) || value_type == ValueType::kTombstone);
+  }
 
-    // Inserting into specified column.
-    DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_id));
-    RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
-        sub_path, sub_doc, data.read_time, data.deadline, request_.stmt_id(), ttl, user_timestamp));
+  if (FLAGS_ysql_enable_packed_row && encoded_doc_key_ && all_values_primitive &&
+      !schema_.table_properties().HasDefaultTimeToLive()) {
+    // The packed row is written as the value of the document key, so it also marks the row as
+    // existing instead of the liveness column.
+    std::sort(column_values.begin(), column_values.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    PackedRowBuilder packed_row(request_.schema_version());
+    for (const auto& column_value : column_values) {
+      // Null values are not stored in the packed row.
+      if (column_value.second.value_type() != ValueType::kTombstone) {
+        packed_row.AddColumn(column_value.first, column_value.second);
+      }
+    }
+    RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+        DocPath(encoded_doc_key_.as_slice()), packed_row.Finish(), data.read_time, data.deadline,
+        request_.stmt_id()));
+  } else {
+    // Add the appropriate liveness column.
+    if (encoded_doc_key_) {
+      const DocPath sub_path(encoded_doc_key_.as_slice(),
+                             PrimitiveValue::SystemColumnId(SystemColumnIds::kLivenessColumn));
+      const auto value = Value(PrimitiveValue(), ttl, user_timestamp);
+      RETURN_NOT_OK(data.doc_write_batch->SetPrimitive(
+          sub_path, value, data.read_time, data.deadline, request_.stmt_id()));
+    }
+
+    for (const auto& column_value : column_values) {
+      // Inserting into specified column.
+      DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_value.first));
+      RETURN_NOT_OK(data.doc_write_batch->InsertSubDocument(
+          sub_path, column_value.second, data.read_time, data.deadline, request_.stmt_id(), ttl,
+          user_timestamp));
+    }
   }
 
   RETURN_NOT_OK(PopulateResultSet(table_row));
@@ -158,7 +228,9 @@ Status PgsqlWriteOperation::ApplyInsert(const DocOperationApplyData& data) {
 
 Status PgsqlWriteOperation::ApplyUpdate(const DocOperationApplyData& data) {
   QLTableRow::SharedPtr table_row = std::make_shared<QLTableRow>();
-  RETURN_NOT_OK(ReadColumns(data, table_row));
+  if (!blind_update_) {
+    RETURN_NOT_OK(ReadColumns(data, table_row));
+  }
   // skipped is set to false if this operation produces some data to write.
   bool skipped = true;
 
@@ -181,12 +253,14 @@ Status PgsqlWriteOperation::ApplyUpdate(const DocOperationApplyData& data) {
       QLValue expr_result;
       RETURN_NOT_OK(EvalExpr(column_value.expr(), table_row, &expr_result));
 
-      // Compare with existing value.
+      // Compare with existing value, blind update does not know it and just overwrites the column.
       QLValue old_value;
-      RETURN_NOT_OK(EvalColumnRef(column_value.column_id(), table_row, &old_value));
+      if (!blind_update_) {
+        RETURN_NOT_OK(EvalColumnRef(column_value.column_id(), table_row, &old_value));
+      }
 
       // Inserting into specified column.
-      if (expr_result != old_value) {
+      if (blind_update_ || expr_result != old_value) {
         const SubDocument sub_doc =
           SubDocument::FromQLValuePB(expr_result.value(), column->sorting_type());
         DocPath sub_path(encoded_doc_key_.as_slice(), PrimitiveValue(column_id));
@@ -340,7 +414,15 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
   VLOG(4) << "Read, read time: " << read_time << ", txn: " << txn_op_context_;
 
   size_t row_count_limit = std::numeric_limits<std::size_t>::max();
-  if (request_.has_limit()) {
+  if (request_.has_top_n_limit()) {
+    // All rows of the tablet are read to find the first ones in the order of the request.
+    if (request_.top_n_limit() == 0) {
+      return Status::OK();
+    }
+    if (request_.is_aggregate() || request_.order_by().empty()) {
+      return STATUS(InvalidArgument, "Top-N read requires sort keys and no aggregates");
+    }
+  } else if (request_.has_limit()) {
     if (request_.limit() == 0) {
       return Status::OK();
     }
@@ -377,63 +459,123 @@ Status PgsqlReadOperation::Execute(const common::YQLStorageIf& ql_storage,
     TRACE("Initialized iterator");
   }
 
+  // The client receives a partial page instead of a timeout, when the scan takes too long.
+  // Aggregates and top-N reads could not be continued from a paging state.
+  const bool can_stop_early = request_.return_paging_state() && !request_.is_aggregate() &&
+                              !request_.has_top_n_limit() && deadline != CoarseTimePoint::max();
+  const auto scan_deadline =
+      deadline - GetAtomicFlag(&FLAGS_ysql_scan_deadline_margin_ms) * 1ms;
+  bool scan_time_exceeded = false;
+  auto check_scan_time = [can_stop_early, scan_deadline, &scan_time_exceeded] {
+    scan_time_exceeded = can_stop_early && CoarseMonoClock::now() >= scan_deadline;
+    return scan_time_exceeded;
+  };
+
   // Fetching data.
   int match_count = 0;
   QLTableRow::SharedPtr row = std::make_shared<QLTableRow>();
-  while (resultset->rsrow_count() < row_count_limit && VERIFY_RESULT(iter->HasNext())) {
-
-    row->Clear();
-
-    // If there is an index request, fetch ybbasectid from the index and use it as ybctid
-    // to fetch from the base table. Otherwise, fetch from the base table directly.
-    if (request_.has_index_request()) {
-      RETURN_NOT_OK(iter->NextRow(row.get()));
-      const auto& tuple_id = row->GetValue(ybbasectid_id);
-      SCHECK_NE(tuple_id, boost::none, Corruption, "ybbasectid not found in index row");
-      if (!VERIFY_RESULT(table_iter_->SeekTuple(tuple_id->binary_value()))) {
-        DocKey doc_key;
-        RETURN_NOT_OK(doc_key.DecodeFrom(tuple_id->binary_value()));
-        return STATUS_FORMAT(Corruption, "ybctid $0 not found in indexed table", doc_key);
+  if (!request_.has_index_request() && FLAGS_docdb_scan_batch_size > 1) {
+    // Every fetched row produces at most one result row, so bounding the batch by the remaining
+    // limit never reads past the row the paging state should point to.
+    std::vector<QLTableRow::SharedPtr> rows;
+    while (ResultRowCount(*resultset) < row_count_limit) {
+      const size_t max_rows = std::min<size_t>(
+          FLAGS_docdb_scan_batch_size, row_count_limit - ResultRowCount(*resultset));
+      const size_t num_rows = VERIFY_RESULT(
+          iter->NextBatch(projection, max_rows, true /* include_tuple_id */, &rows));
+      for (size_t i = 0; i != num_rows; ++i) {
+        RETURN_NOT_OK(ProcessRow(rows[i], resultset, &match_count));
+      }
+      if (num_rows < max_rows || check_scan_time()) {
+        break;
       }
-      row->Clear();
-      RETURN_NOT_OK(table_iter_->NextRow(projection, row.get()));
-    } else {
-      RETURN_NOT_OK(iter->NextRow(projection, row.get()));
     }
+  } else {
+    while (ResultRowCount(*resultset) < row_count_limit && VERIFY_RESULT(iter->HasNext())) {
+      row->Clear();
 
-    // Match the row with the where condition before adding to the row block.
-    bool is_match = true;
-    if (request_.has_where_expr()) {
-      QLValue match;
-      RETURN_NOT_OK(EvalExpr(request_.where_expr(), row, &match));
-      is_match = match.bool_value();
-    }
-    if (is_match) {
-      match_count++;
-      if (request_.is_aggregate()) {
-        RETURN_NOT_OK(EvalAggregate(row));
+      // If there is an index request, fetch ybbasectid from the index and use it as ybctid
+      // to fetch from the base table. Otherwise, fetch from the base table directly.
+      if (request_.has_index_request()) {
+        RETURN_NOT_OK(iter->NextRow(row.get()));
+        const auto& tuple_id = row->GetValue(ybbasectid_id);
+        SCHECK_NE(tuple_id, boost::none, Corruption, "ybbasectid not found in index row");
+        if (!VERIFY_RESULT(table_iter_->SeekTuple(tuple_id->binary_value()))) {
+          DocKey doc_key;
+          RETURN_NOT_OK(doc_key.DecodeFrom(tuple_id->binary_value()));
+          return STATUS_FORMAT(Corruption, "ybctid $0 not found in indexed table", doc_key);
+        }
+        row->Clear();
+        RETURN_NOT_OK(table_iter_->NextRow(projection, row.get()));
       } else {
-        RETURN_NOT_OK(PopulateResultSet(row, resultset));
+        RETURN_NOT_OK(iter->NextRow(projection, row.get()));
+      }
+
+      RETURN_NOT_OK(ProcessRow(row, resultset, &match_count));
+      if (check_scan_time()) {
+        break;
       }
     }
   }
 
+  // Paging state is computed before the groups are added to the result set, so reads with GROUP BY
+  // are paged by the number of groups found.
+  *restart_read_ht = iter->RestartReadHt();
+  RETURN_NOT_OK(SetPagingStateIfNecessary(iter, resultset, row_count_limit, scan_time_exceeded));
+  if (scan_time_exceeded) {
+    TRACE("Scan stopped before deadline after $0 rows", resultset->rsrow_count());
+  }
+
   if (request_.is_aggregate() && match_count > 0) {
     RETURN_NOT_OK(PopulateAggregate(row, resultset));
   }
 
+  if (request_.has_top_n_limit()) {
+    PopulateTopN(resultset);
+  }
+
   if (FLAGS_trace_docdb_calls) {
     TRACE("Fetched $0 rows.", resultset->rsrow_count());
   }
-  *restart_read_ht = iter->RestartReadHt();
 
-  return SetPagingStateIfNecessary(iter, resultset, row_count_limit);
+  return Status::OK();
+}
+
+size_t PgsqlReadOperation::ResultRowCount(const PgsqlResultSet& resultset) const {
+  // Every group of an aggregate read with GROUP BY produces one row in the result set. Rows of
+  // an aggregate read without GROUP BY are combined into a single row, so it is not limited.
+  return request_.group_by_exprs().empty() ? resultset.rsrow_count() : groups_.size();
+}
+
+Status PgsqlReadOperation::ProcessRow(const QLTableRow::SharedPtr& table_row,
+                                      PgsqlResultSet* resultset,
+                                      int* match_count) {
+  // Match the row with the where condition before adding to the row block.
+  bool is_match = true;
+  if (request_.has_where_expr()) {
+    QLValue match;
+    RETURN_NOT_OK(EvalExpr(request_.where_expr(), table_row, &match));
+    is_match = match.bool_value();
+  }
+  if (is_match) {
+    (*match_count)++;
+    if (request_.is_aggregate()) {
+      RETURN_NOT_OK(EvalAggregate(table_row));
+    } else if (request_.has_top_n_limit()) {
+      RETURN_NOT_OK(EvalTopN(table_row));
+    } else {
+      RETURN_NOT_OK(PopulateResultSet(table_row, resultset));
+    }
+  }
+  return Status::OK();
 }
 
 Status PgsqlReadOperation::SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                                      const PgsqlResultSet* resultset,
-                                                     const size_t row_count_limit) {
-  if (resultset->rsrow_count() >= row_count_limit && !request_.is_aggregate()) {
+                                                     const size_t row_count_limit,
+                                                     const bool scan_time_exceeded) {
+  if ((ResultRowCount(*resultset) >= row_count_limit || scan_time_exceeded) &&
+      (!request_.is_aggregate() || !request_.group_by_exprs().empty())) {
     SubDocKey next_row_key;
     RETURN_NOT_OK(iter->GetNextReadSubDocKey(&next_row_key));
     // When the "limit" number of rows are returned and we are asked to return the paging state,
@@ -475,22 +617,52 @@ Status PgsqlReadOperation::GetTupleId(QLValue *result) const {
 }
 
 Status PgsqlReadOperation::EvalAggregate(const QLTableRow::SharedPtr& table_row) {
-  if (aggr_result_.empty()) {
+  std::vector<QLValue>* aggr_result = &aggr_result_;
+  if (!request_.group_by_exprs().empty()) {
+    aggr_result = VERIFY_RESULT(FindOrAddGroup(table_row));
+  }
+  if (aggr_result->empty()) {
     int column_count = request_.targets().size();
-    aggr_result_.resize(column_count);
+    aggr_result->resize(column_count);
   }
 
   int aggr_index = 0;
   for (const PgsqlExpressionPB& expr : request_.targets()) {
-    RETURN_NOT_OK(EvalExpr(expr, table_row, &aggr_result_[aggr_index]));
+    RETURN_NOT_OK(EvalExpr(expr, table_row, &(*aggr_result)[aggr_index]));
     aggr_index++;
   }
   return Status::OK();
 }
 
+Result<std::vector<QLValue>*> PgsqlReadOperation::FindOrAddGroup(
+    const QLTableRow::SharedPtr& table_row) {
+  group_key_.Clear();
+  for (const PgsqlExpressionPB& expr : request_.group_by_exprs()) {
+    QLValue group_value;
+    RETURN_NOT_OK(EvalExpr(expr, table_row, &group_value));
+    PrimitiveValue::FromQLValuePB(group_value.value(), ColumnSchema::SortingType::kNotSpecified)
+        .AppendToKey(&group_key_);
+  }
+  auto it = group_index_.emplace(group_key_.data(), groups_.size()).first;
+  if (it->second == groups_.size()) {
+    groups_.emplace_back();
+  }
+  return &groups_[it->second];
+}
+
 Status PgsqlReadOperation::PopulateAggregate(const QLTableRow::SharedPtr& table_row,
                                              PgsqlResultSet *resultset) {
   int column_count = request_.targets().size();
+  if (!request_.group_by_exprs().empty()) {
+    for (const auto& group : groups_) {
+      PgsqlRSRow *rsrow = resultset->AllocateRSRow(column_count);
+      for (int rscol_index = 0; rscol_index < column_count; rscol_index++) {
+        *rsrow->rscol(rscol_index) = group[rscol_index];
+      }
+    }
+    return Status::OK();
+  }
+
   PgsqlRSRow *rsrow = resultset->AllocateRSRow(column_count);
   for (int rscol_index = 0; rscol_index < column_count; rscol_index++) {
     *rsrow->rscol(rscol_index) = aggr_result_[rscol_index];
@@ -498,6 +670,71 @@ Status PgsqlReadOperation::PopulateAggregate(const QLTableRow::SharedPtr& table_
   return Status::OK();
 }
 
+bool PgsqlReadOperation::TopNLess(
+    const std::vector<QLValue>& lhs, const std::vector<QLValue>& rhs) const {
+  for (int i = 0; i != request_.order_by_size(); ++i) {
+    const PgsqlOrderByPB& order_by = request_.order_by(i);
+    const bool lhs_null = lhs[i].IsNull();
+    const bool rhs_null = rhs[i].IsNull();
+    if (lhs_null || rhs_null) {
+      if (lhs_null != rhs_null) {
+        return lhs_null == order_by.nulls_first();
+      }
+      continue;
+    }
+    if (lhs[i] < rhs[i]) {
+      return !order_by.is_descending();
+    }
+    if (rhs[i] < lhs[i]) {
+      return order_by.is_descending();
+    }
+  }
+  return false;
+}
+
+Status PgsqlReadOperation::EvalTopN(const QLTableRow::SharedPtr& table_row) {
+  std::vector<QLValue> sort_keys(request_.order_by_size());
+  for (int i = 0; i != request_.order_by_size(); ++i) {
+    RETURN_NOT_OK(EvalExpr(request_.order_by(i).expr(), table_row, &sort_keys[i]));
+  }
+
+  auto less = [this](const TopNRow& lhs, const TopNRow& rhs) {
+    return TopNLess(lhs.sort_keys, rhs.sort_keys);
+  };
+  if (top_n_rows_.size() >= request_.top_n_limit()) {
+    // Targets are evaluated only for rows that make it into the heap.
+    if (!TopNLess(sort_keys, top_n_rows_.front().sort_keys)) {
+      return Status::OK();
+    }
+    std::pop_heap(top_n_rows_.begin(), top_n_rows_.end(), less);
+    top_n_rows_.pop_back();
+  }
+
+  TopNRow top_n_row;
+  top_n_row.sort_keys = std::move(sort_keys);
+  top_n_row.targets.resize(request_.targets_size());
+  for (int i = 0; i != request_.targets_size(); ++i) {
+    RETURN_NOT_OK(EvalExpr(request_.targets(i), table_row, &top_n_row.targets[i]));
+  }
+  top_n_rows_.push_back(std::move(top_n_row));
+  std::push_heap(top_n_rows_.begin(), top_n_rows_.end(), less);
+  return Status::OK();
+}
+
+void PgsqlReadOperation::PopulateTopN(PgsqlResultSet *resultset) {
+  std::sort_heap(top_n_rows_.begin(), top_n_rows_.end(),
+                 [this](const TopNRow& lhs, const TopNRow& rhs) {
+                   return TopNLess(lhs.sort_keys, rhs.sort_keys);
+                 });
+  for (auto& top_n_row : top_n_rows_) {
+    PgsqlRSRow *rsrow = resultset->AllocateRSRow(top_n_row.targets.size());
+    for (int i = 0; i != request_.targets_size(); ++i) {
+      *rsrow->rscol(i) = std::move(top_n_row.targets[i]);
+    }
+  }
+  top_n_rows_.clear();
+}
+
 Status PgsqlReadOperation::GetIntents(const Schema& schema, KeyValueWriteBatchPB* out) {
   auto pair = out->mutable_read_pairs()->Add();
 
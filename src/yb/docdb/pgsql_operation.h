@@ -14,6 +14,8 @@
 #ifndef YB_DOCDB_PGSQL_OPERATION_H
 #define YB_DOCDB_PGSQL_OPERATION_H
 
+#include <unordered_map>
+
 #include "yb/common/pgsql_resultset.h"
 #include "yb/common/ql_rowwise_iterator_interface.h"
 
@@ -47,7 +49,9 @@ class PgsqlWriteOperation :
 
   // Initialize PgsqlWriteOperation. Content of request will be swapped out by the constructor.
   CHECKED_STATUS Init(PgsqlWriteRequestPB* request, PgsqlResponsePB* response);
-  bool RequireReadSnapshot() const override { return request_.has_column_refs(); }
+  bool RequireReadSnapshot() const override {
+    return request_.has_column_refs() && !blind_update_;
+  }
   const PgsqlWriteRequestPB& request() const { return request_; }
   PgsqlResponsePB* response() const { return response_; }
 
@@ -97,6 +101,9 @@ class PgsqlWriteOperation :
   boost::optional<DocKey> doc_key_;
   RefCntPrefix encoded_doc_key_;
 
+  // Update that overwrites columns with constants, so could be applied without reading the row.
+  bool blind_update_ = false;
+
   // Rows result requested.
   PgsqlResultSet resultset_;
 };
@@ -125,19 +132,41 @@ class PgsqlReadOperation : public DocExprExecutor {
   CHECKED_STATUS GetIntents(const Schema& schema, KeyValueWriteBatchPB* out);
 
  private:
+  // Matches the row against the where condition and, if it matches, adds it to the result set or
+  // to the aggregate.
+  CHECKED_STATUS ProcessRow(const QLTableRow::SharedPtr& table_row,
+                            PgsqlResultSet* result_set,
+                            int* match_count);
+
   CHECKED_STATUS PopulateResultSet(const QLTableRow::SharedPtr& table_row,
                                    PgsqlResultSet *result_set);
 
   CHECKED_STATUS EvalAggregate(const QLTableRow::SharedPtr& table_row);
 
+  // Returns partial aggregates of the group, that the row belongs to, adding a new group if needed.
+  Result<std::vector<QLValue>*> FindOrAddGroup(const QLTableRow::SharedPtr& table_row);
+
+  // Number of result rows produced so far, that is compared against the limit of the request.
+  size_t ResultRowCount(const PgsqlResultSet& resultset) const;
+
   CHECKED_STATUS PopulateAggregate(const QLTableRow::SharedPtr& table_row,
                                    PgsqlResultSet *resultset);
 
-  // Checks whether we have processed enough rows for a page and sets the appropriate paging
-  // state in the response object.
+  // Adds the row to top_n_rows_ if it is among the first top_n_limit rows in the order of the
+  // request found so far.
+  CHECKED_STATUS EvalTopN(const QLTableRow::SharedPtr& table_row);
+
+  void PopulateTopN(PgsqlResultSet *resultset);
+
+  // Whether values of the sort keys lhs come before rhs in the order of the request.
+  bool TopNLess(const std::vector<QLValue>& lhs, const std::vector<QLValue>& rhs) const;
+
+  // Checks whether we have processed enough rows for a page, or the scan was stopped because it
+  // took too long, and sets the appropriate paging state in the response object.
   CHECKED_STATUS SetPagingStateIfNecessary(const common::YQLRowwiseIteratorIf* iter,
                                            const PgsqlResultSet* resultset,
-                                           const size_t row_count_limit);
+                                           const size_t row_count_limit,
+                                           const bool scan_time_exceeded);
 
   //------------------------------------------------------------------------------------------------
   const PgsqlReadRequestPB& request_;
@@ -145,6 +174,19 @@ class PgsqlReadOperation : public DocExprExecutor {
   PgsqlResponsePB response_;
   common::YQLRowwiseIteratorIf::UniPtr table_iter_;
   common::YQLRowwiseIteratorIf::UniPtr index_iter_;
+
+  // Partial aggregates of an aggregate read with GROUP BY, one entry per group in the order the
+  // groups were found. group_index_ maps encoded group-by values to a position in groups_.
+  std::vector<std::vector<QLValue>> groups_;
+  std::unordered_map<std::string, size_t> group_index_;
+  KeyBytes group_key_;
+
+  // Rows of a top-N read, kept as a heap with the last row in the order of the request on top.
+  struct TopNRow {
+    std::vector<QLValue> sort_keys;
+    std::vector<QLValue> targets;
+  };
+  std::vector<TopNRow> top_n_rows_;
 };
 
 }  // namespace docdb
@@ -59,6 +59,9 @@ using yb::util::DecodeDoubleFromKey;
     case ValueType::kJsonb: FALLTHROUGH_INTENDED; \
     case ValueType::kObject: FALLTHROUGH_INTENDED; \
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED; \
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED; \
+    case ValueType::kBlobReference: FALLTHROUGH_INTENDED; \
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisList: FALLTHROUGH_INTENDED;            \
     case ValueType::kRedisSet: FALLTHROUGH_INTENDED; \
     case ValueType::kRedisSortedSet: FALLTHROUGH_INTENDED;  \
@@ -218,6 +221,9 @@ string PrimitiveValue::ToString() const {
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kBlobReference: FALLTHROUGH_INTENDED;
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix:
       break;
     case ValueType::kLowest:
@@ -529,6 +535,9 @@ string PrimitiveValue::ToValue() const {
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kBlobReference: FALLTHROUGH_INTENDED;
     case ValueType::kTtl: FALLTHROUGH_INTENDED;
     case ValueType::kUserTimestamp: FALLTHROUGH_INTENDED;
     case ValueType::kColumnId: FALLTHROUGH_INTENDED;
@@ -626,7 +635,7 @@ Status PrimitiveValue::DecodeKey(rocksdb::Slice* slice, PrimitiveValue* out) {
           } else {
             PrimitiveValue pv;
             RETURN_NOT_OK(DecodeKey(slice, &pv));
-            out->frozen_val_->push_back(pv);
+            out->frozen_val_->push_back(std::move(pv));
           }
         }
       } else {
@@ -955,7 +964,7 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
           PrimitiveValue pv;
           // Frozen elems are encoded as keys even in values.
           RETURN_NOT_OK(pv.DecodeFromKey(&slice));
-          frozen_val_->push_back(pv);
+          frozen_val_->push_back(std::move(pv));
         }
       }
 
@@ -1079,6 +1088,9 @@ Status PrimitiveValue::DecodeFromValue(const rocksdb::Slice& rocksdb_slice) {
     case ValueType::kGroupEnd: FALLTHROUGH_INTENDED;
     case ValueType::kGroupEndDescending: FALLTHROUGH_INTENDED;
     case ValueType::kObsoleteIntentPrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kRangeTombstonePrefix: FALLTHROUGH_INTENDED;
+    case ValueType::kPackedRow: FALLTHROUGH_INTENDED;
+    case ValueType::kBlobReference: FALLTHROUGH_INTENDED;
     case ValueType::kUInt16Hash: FALLTHROUGH_INTENDED;
     case ValueType::kInvalid: FALLTHROUGH_INTENDED;
     case ValueType::kMergeFlags: FALLTHROUGH_INTENDED;
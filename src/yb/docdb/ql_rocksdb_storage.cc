@@ -18,9 +18,29 @@
 #include "yb/docdb/doc_expr.h"
 #include "yb/docdb/primitive_value_util.h"
 
+DEFINE_bool(use_low_block_cache_priority_for_scans, true,
+            "Whether reads that scan all rows of a hash partitioned tablet add blocks to the "
+            "block cache with low priority, so they do not evict the working set of other reads.");
+
 namespace yb {
 namespace docdb {
 
+namespace {
+
+// Returns query id that should be used by the read with the specified hash components.
+// The read of a hash partitioned table without hash components scans all rows of the tablet.
+rocksdb::QueryId ReadQueryId(
+    const Schema& schema, const std::vector<PrimitiveValue>& hashed_components,
+    rocksdb::QueryId query_id) {
+  if (FLAGS_use_low_block_cache_priority_for_scans && schema.num_hash_key_columns() > 0 &&
+      hashed_components.empty()) {
+    return rocksdb::kScanQueryId;
+  }
+  return query_id;
+}
+
+} // namespace
+
 QLRocksDBStorage::QLRocksDBStorage(const DocDB& doc_db)
     : doc_db_(doc_db) {
 }
@@ -89,7 +109,7 @@ Status QLRocksDBStorage::BuildYQLScanSpec(const QLReadRequestPB& request,
   // Construct the scan spec basing on the WHERE condition.
   spec->reset(new DocQLScanSpec(schema, hash_code, max_hash_code, hashed_components,
       request.has_where_expr() ? &request.where_expr().condition() : nullptr,
-      request.query_id(), request.is_forward_scan(),
+      ReadQueryId(schema, hashed_components, request.query_id()), request.is_forward_scan(),
       request.is_forward_scan() && include_static_columns, start_sub_doc_key.doc_key()));
   return Status::OK();
 }
@@ -158,7 +178,8 @@ Status QLRocksDBStorage::GetIterator(const PgsqlReadRequestPB& request,
     doc_iter = std::make_unique<DocRowwiseIterator>(
         projection, schema, txn_op_context, doc_db_, deadline, req_read_time);
     RETURN_NOT_OK(doc_iter->Init(DocPgsqlScanSpec(schema,
-                                                  request.stmt_id(),
+                                                  ReadQueryId(schema, hashed_components,
+                                                              request.stmt_id()),
                                                   hashed_components,
                                                   hash_code,
                                                   max_hash_code,
@@ -0,0 +1,299 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#include "yb/docdb/range_tombstones.h"
+
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/value.h"
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/write_batch.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// The smallest key that is greater than all range tombstone records.
+const char kRangeTombstonesEnd = ValueTypeAsChar::kRangeTombstonePrefix + 1;
+
+class UpdateHandler : public rocksdb::WriteBatch::Handler {
+ public:
+  explicit UpdateHandler(const RangeTombstoneVector* tombstones) : tombstones_(tombstones) {}
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    if (!IsRangeTombstoneKey(key)) {
+      Written(key);
+      return Status::OK();
+    }
+    auto tombstone = DecodeRangeTombstone(key, value);
+    if (!tombstone.ok()) {
+      LOG(DFATAL) << "Failed to decode range tombstone " << key.ToDebugHexString() << ": "
+                  << tombstone.status();
+      return Status::OK();
+    }
+    Mutable()->push_back(std::move(*tombstone));
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    Written(key);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    Written(key);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    Written(key);
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Frontiers(const rocksdb::UserFrontiers& frontiers) override {
+    return Status::OK();
+  }
+
+  // Returns the updated tombstones, or nullptr if the batch did not change them.
+  std::shared_ptr<RangeTombstoneVector> updated() const {
+    return updated_;
+  }
+
+ private:
+  RangeTombstoneVector* Mutable() {
+    if (!updated_) {
+      updated_ = std::make_shared<RangeTombstoneVector>(*tombstones_);
+      tombstones_ = updated_.get();
+    }
+    return updated_.get();
+  }
+
+  void Written(const Slice& key) {
+    if (tombstones_->empty()) {
+      return;
+    }
+    DocHybridTime doc_ht;
+    HybridTime write_ht = doc_ht.DecodeFromEnd(key).ok() ? doc_ht.hybrid_time() : HybridTime::kMax;
+    for (size_t i = 0; i != tombstones_->size(); ++i) {
+      const auto& tombstone = (*tombstones_)[i];
+      if (!tombstone.has_later_writes && write_ht > tombstone.hybrid_time &&
+          tombstone.Contains(key)) {
+        (*Mutable())[i].has_later_writes = true;
+      }
+    }
+  }
+
+  const RangeTombstoneVector* tombstones_;
+  std::shared_ptr<RangeTombstoneVector> updated_;
+};
+
+HybridTime MaxWriteHybridTime(const rocksdb::LiveFileMetaData& file) {
+  if (!file.largest.user_frontier) {
+    return HybridTime::kMax;
+  }
+  return static_cast<const ConsensusFrontier&>(*file.largest.user_frontier).hybrid_time();
+}
+
+} // namespace
+
+std::string RangeTombstone::ToString() const {
+  return Format("{ lower: $0 upper: $1 hybrid_time: $2 has_later_writes: $3 }",
+                BestEffortDocDBKeyToStr(lower), BestEffortDocDBKeyToStr(upper), hybrid_time,
+                has_later_writes);
+}
+
+std::pair<std::string, std::string> EncodeRangeTombstone(const Slice& lower, const Slice& upper) {
+  std::string key;
+  key.reserve(1 + lower.size());
+  key.push_back(ValueTypeAsChar::kRangeTombstonePrefix);
+  key.append(lower.cdata(), lower.size());
+  return {std::move(key), Value(PrimitiveValue(upper.ToBuffer())).Encode()};
+}
+
+Result<RangeTombstone> DecodeRangeTombstone(const Slice& key, const Slice& value) {
+  Slice lower = key;
+  RETURN_NOT_OK(lower.consume_byte(ValueTypeAsChar::kRangeTombstonePrefix));
+  RangeTombstone result;
+  result.hybrid_time = VERIFY_RESULT(DocHybridTime::DecodeFromEnd(&lower)).hybrid_time();
+  if (!lower.ends_with(ValueTypeAsChar::kHybridTime)) {
+    return STATUS_FORMAT(Corruption, "Bad range tombstone key: $0", key.ToDebugHexString());
+  }
+  lower.remove_suffix(1);
+  result.lower = KeyBytes(lower);
+
+  Value upper;
+  RETURN_NOT_OK(upper.Decode(value));
+  if (upper.value_type() != ValueType::kString) {
+    return STATUS_FORMAT(Corruption, "Bad range tombstone value: $0", value.ToDebugHexString());
+  }
+  result.upper = KeyBytes(upper.primitive_value().GetString());
+  return result;
+}
+
+Status RangeTombstones::Load(rocksdb::DB* db) {
+  auto tombstones = std::make_shared<RangeTombstoneVector>();
+  std::unique_ptr<rocksdb::Iterator> iter(db->NewIterator(rocksdb::ReadOptions()));
+  const char prefix = ValueTypeAsChar::kRangeTombstonePrefix;
+  for (iter->Seek(Slice(&prefix, 1)); iter->Valid() && IsRangeTombstoneKey(iter->key());
+       iter->Next()) {
+    tombstones->push_back(VERIFY_RESULT(DecodeRangeTombstone(iter->key(), iter->value())));
+  }
+  RETURN_NOT_OK(iter->status());
+
+  if (!tombstones->empty()) {
+    // Writes that were done after a tombstone could only be present in files with later writes.
+    std::vector<rocksdb::LiveFileMetaData> files;
+    db->GetLiveFilesMetaData(&files);
+    for (auto& tombstone : *tombstones) {
+      for (const auto& file : files) {
+        if (MaxWriteHybridTime(file) > tombstone.hybrid_time &&
+            tombstone.Overlaps(file.smallest.key, file.largest.key)) {
+          tombstone.has_later_writes = true;
+          break;
+        }
+      }
+      VLOG(1) << "Loaded range tombstone: " << tombstone.ToString();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  tombstones_ = std::move(tombstones);
+  return Status::OK();
+}
+
+void RangeTombstones::Update(const rocksdb::WriteBatch& write_batch) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  UpdateHandler handler(tombstones_.get());
+  auto status = write_batch.Iterate(&handler);
+  LOG_IF(DFATAL, !status.ok()) << "Failed to update range tombstones: " << status;
+  auto updated = handler.updated();
+  if (updated) {
+    tombstones_ = std::move(updated);
+  }
+}
+
+RangeTombstonesSnapshot RangeTombstones::Get() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return tombstones_;
+}
+
+RangeTombstoneIterator::RangeTombstoneIterator(
+    std::unique_ptr<rocksdb::Iterator> iterator, RangeTombstonesSnapshot tombstones,
+    const ReadHybridTime& read_time)
+    : iterator_(std::move(iterator)), tombstones_(std::move(tombstones)), read_time_(read_time) {
+}
+
+bool RangeTombstoneIterator::Valid() const {
+  return iterator_->Valid();
+}
+
+void RangeTombstoneIterator::SeekToFirst() {
+  iterator_->SeekToFirst();
+  SkipDeleted(/* forward= */ true);
+}
+
+void RangeTombstoneIterator::SeekToLast() {
+  iterator_->SeekToLast();
+  SkipDeleted(/* forward= */ false);
+}
+
+void RangeTombstoneIterator::Seek(const Slice& target) {
+  iterator_->Seek(target);
+  SkipDeleted(/* forward= */ true);
+}
+
+void RangeTombstoneIterator::Next() {
+  iterator_->Next();
+  SkipDeleted(/* forward= */ true);
+}
+
+void RangeTombstoneIterator::Prev() {
+  iterator_->Prev();
+  SkipDeleted(/* forward= */ false);
+}
+
+void RangeTombstoneIterator::SkipDeleted(bool forward) {
+  while (iterator_->Valid()) {
+    const auto key = iterator_->key();
+    if (IsRangeTombstoneKey(key)) {
+      if (forward) {
+        iterator_->Seek(Slice(&kRangeTombstonesEnd, 1));
+      } else {
+        // All tombstone records are adjacent, so step over them at once.
+        const char prefix = ValueTypeAsChar::kRangeTombstonePrefix;
+        iterator_->Seek(Slice(&prefix, 1));
+        iterator_->Prev();
+      }
+      continue;
+    }
+
+    DocHybridTime doc_ht;
+    if (!doc_ht.DecodeFromEnd(key).ok()) {
+      return;
+    }
+    const RangeTombstone* deleted_by = nullptr;
+    for (const auto& tombstone : *tombstones_) {
+      if (tombstone.hybrid_time < doc_ht.hybrid_time() || !tombstone.Contains(key)) {
+        continue;
+      }
+      if (tombstone.hybrid_time <= read_time_.read) {
+        // Prefer a tombstone that allows skipping the whole range.
+        if (!deleted_by || !tombstone.has_later_writes) {
+          deleted_by = &tombstone;
+        }
+      } else if (tombstone.hybrid_time <= read_time_.global_limit) {
+        max_seen_ht_.MakeAtLeast(tombstone.hybrid_time);
+      }
+    }
+    if (!deleted_by) {
+      return;
+    }
+
+    // Without later writes all entries of the range are deleted by the tombstone.
+    if (forward) {
+      if (deleted_by->has_later_writes) {
+        iterator_->Next();
+      } else {
+        iterator_->Seek(deleted_by->upper.AsSlice());
+      }
+    } else {
+      if (!deleted_by->has_later_writes) {
+        iterator_->Seek(deleted_by->lower.AsSlice());
+      }
+      iterator_->Prev();
+    }
+  }
+}
+
+Slice RangeTombstoneIterator::key() const {
+  return iterator_->key();
+}
+
+Slice RangeTombstoneIterator::value() const {
+  return iterator_->value();
+}
+
+Status RangeTombstoneIterator::status() const {
+  return iterator_->status();
+}
+
+Status RangeTombstoneIterator::GetProperty(std::string prop_name, std::string* prop) {
+  return iterator_->GetProperty(std::move(prop_name), prop);
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,156 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+
+#ifndef YB_DOCDB_RANGE_TOMBSTONES_H
+#define YB_DOCDB_RANGE_TOMBSTONES_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/common/hybrid_time.h"
+#include "yb/common/read_hybrid_time.h"
+
+#include "yb/docdb/key_bytes.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/rocksdb/iterator.h"
+
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class DB;
+class WriteBatch;
+
+}  // namespace rocksdb
+
+namespace yb {
+namespace docdb {
+
+// Deletion of all regular DB entries with keys in [lower, upper) written at or before hybrid_time.
+//
+// Range tombstones are stored in the regular DB as records with kRangeTombstonePrefix, followed by
+// the lower bound and the hybrid time of the deletion, so they are sorted before all documents.
+// The value of the record contains the upper bound encoded as a string primitive value.
+struct RangeTombstone {
+  KeyBytes lower;
+  KeyBytes upper;
+  HybridTime hybrid_time;
+
+  // Whether some key of the range could have been written after hybrid_time. When it is false,
+  // readers skip the whole range with a single seek.
+  bool has_later_writes = false;
+
+  bool Contains(const Slice& key) const {
+    return key.compare(lower.AsSlice()) >= 0 && key.compare(upper.AsSlice()) < 0;
+  }
+
+  bool Overlaps(const Slice& smallest, const Slice& largest) const {
+    return largest.compare(lower.AsSlice()) >= 0 && smallest.compare(upper.AsSlice()) < 0;
+  }
+
+  std::string ToString() const;
+};
+
+typedef std::vector<RangeTombstone> RangeTombstoneVector;
+typedef std::shared_ptr<const RangeTombstoneVector> RangeTombstonesSnapshot;
+
+// Returns true if the regular DB key is a range tombstone record.
+inline bool IsRangeTombstoneKey(const Slice& key) {
+  return !key.empty() && key[0] == ValueTypeAsChar::kRangeTombstonePrefix;
+}
+
+// Returns the encoded key (without hybrid time) and value of the range tombstone record for range
+// [lower, upper).
+std::pair<std::string, std::string> EncodeRangeTombstone(const Slice& lower, const Slice& upper);
+
+// Decodes the range tombstone record of the regular DB.
+Result<RangeTombstone> DecodeRangeTombstone(const Slice& key, const Slice& value);
+
+// In-memory set of range tombstones of the tablet regular DB.
+//
+// Tombstones are never removed from memory, even after a major compaction dropped their records
+// together with all the deleted entries, so the set is only shrunk by reopening the DB. Range
+// deletions are expected to be rare, so linear lookup is used.
+//
+// This class is thread-safe.
+class RangeTombstones {
+ public:
+  // Loads range tombstone records from the DB, that was just opened.
+  CHECKED_STATUS Load(rocksdb::DB* db);
+
+  // Registers tombstones and writes of the batch, that is about to be applied to the regular DB.
+  // Should be invoked before the actual write, so readers that see written entries also see their
+  // effect on tombstones.
+  void Update(const rocksdb::WriteBatch& write_batch);
+
+  // Immutable copy of the current tombstones. Should be taken after the RocksDB iterator that is
+  // filtered with it was created.
+  RangeTombstonesSnapshot Get() const;
+
+ private:
+  mutable std::mutex mutex_;
+  RangeTombstonesSnapshot tombstones_ = std::make_shared<RangeTombstoneVector>();
+};
+
+// Iterator that hides range tombstone records and entries deleted by range tombstones visible at
+// the read time. If the range of a tombstone was not modified after the deletion, then all its
+// entries are skipped with a single seek.
+class RangeTombstoneIterator : public rocksdb::Iterator {
+ public:
+  RangeTombstoneIterator(
+      std::unique_ptr<rocksdb::Iterator> iterator, RangeTombstonesSnapshot tombstones,
+      const ReadHybridTime& read_time);
+
+  bool Valid() const override;
+
+  void SeekToFirst() override;
+
+  void SeekToLast() override;
+
+  void Seek(const Slice& target) override;
+
+  void Next() override;
+
+  void Prev() override;
+
+  Slice key() const override;
+
+  Slice value() const override;
+
+  Status status() const override;
+
+  Status GetProperty(std::string prop_name, std::string* prop) override;
+
+  // Max hybrid time of tombstones that were ignored, because they are after the read time but
+  // within the uncertainty window, and would have deleted the returned entries otherwise.
+  HybridTime max_seen_ht() const { return max_seen_ht_; }
+
+ private:
+  // Moves the iterator in the specified direction until it points to an entry that is not deleted.
+  void SkipDeleted(bool forward);
+
+  std::unique_ptr<rocksdb::Iterator> iterator_;
+  RangeTombstonesSnapshot tombstones_;
+  const ReadHybridTime read_time_;
+  HybridTime max_seen_ht_ = HybridTime::kMin;
+};
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_RANGE_TOMBSTONES_H
@@ -1327,11 +1327,36 @@ Status RedisReadOperation::ExecuteHGetAllLikeCommands(ValueType value_type,
     data.count_only = !return_array_response;
   }
 
+  // Hashes and sets could be read page by page, each page starts after the last subkey of the
+  // previous one.
+  const bool paged = return_array_response && !has_cardinality_subkey &&
+                     request_.page_size() > 0;
+  KeyBytes low_sub_key_bound;
+  SliceKeyBound low_subkey;
+  if (paged) {
+    data.limit = request_.page_size();
+    if (request_.paging_state().has_last_subkey()) {
+      low_sub_key_bound = encoded_doc_key;
+      low_sub_key_bound.AppendRawBytes(request_.paging_state().last_subkey());
+      low_subkey = SliceKeyBound(low_sub_key_bound, BoundType::kExclusiveLower);
+      data.low_subkey = &low_subkey;
+    }
+  }
+
   RETURN_NOT_OK(GetSubDocument(iterator_.get(), data, /* projection */ nullptr,
                                SeekFwdSuffices::kFalse));
   if (return_array_response)
     response_.set_allocated_array_response(new RedisArrayPB());
 
+  if (paged && doc_found && IsObjectType(doc.value_type()) &&
+      doc.object_num_keys() >= request_.page_size()) {
+    KeyBytes last_subkey;
+    doc.object_container().rbegin()->first.AppendToKey(&last_subkey);
+    auto* paging_state = response_.mutable_paging_state();
+    paging_state->set_last_subkey(last_subkey.data());
+    paging_state->set_read_ht(read_time_.read.ToUint64());
+  }
+
   if (!doc_found) {
     response_.set_code(RedisResponsePB::OK);
     if (!return_array_response)
@@ -184,5 +184,34 @@ TEST_F(SharedLockManagerTest, LockConflicts) {
   tp.Shutdown();
 }
 
+// Keys of a batch are spread over multiple shards of the lock manager.
+TEST_F(SharedLockManagerTest, ManyKeysBatch) {
+  constexpr int kNumKeys = 100;
+  const IntentTypeSet kWrite({IntentType::kStrongWrite, IntentType::kStrongRead});
+  LockBatchEntries entries;
+  for (int i = 0; i != kNumKeys; ++i) {
+    entries.push_back({RefCntPrefix(Format("key_$0", i)), kWrite});
+  }
+  std::sort(entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.key.as_slice().compare(rhs.key.as_slice()) < 0;
+  });
+  auto entries_copy = entries;
+
+  LockBatch lb(&lm_, std::move(entries), CoarseTimePoint::max());
+  ASSERT_OK(lb.status());
+  ASSERT_EQ(kNumKeys, lb.size());
+
+  // Any key of the batch conflicts with the batch holding all of them.
+  for (int i = 0; i != kNumKeys; i += 9) {
+    LockBatch conflicting(&lm_, {{RefCntPrefix(Format("key_$0", i)), kWrite}},
+                          CoarseMonoClock::now() + 1ms);
+    ASSERT_FALSE(conflicting.status().ok());
+  }
+
+  lb.Reset();
+  LockBatch lb2(&lm_, std::move(entries_copy), CoarseMonoClock::now() + 1s);
+  ASSERT_OK(lb2.status());
+}
+
 } // namespace docdb
 } // namespace yb
@@ -13,8 +13,10 @@
 
 #include "yb/docdb/shared_lock_manager.h"
 
+#include <bitset>
 #include <vector>
 
+#include <boost/container/small_vector.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/scope_exit.hpp>
 #include <glog/logging.h>
@@ -22,11 +24,36 @@
 #include "yb/util/bytes_formatter.h"
 #include "yb/util/enums.h"
 #include "yb/util/logging.h"
+#include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 #include "yb/util/tostring.h"
 
 using std::string;
 
+METRIC_DEFINE_histogram(tablet, weak_read_lock_wait_duration,
+  "Weak Read Lock Wait Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent waiting for weak read locks on keys of this tablet.",
+  60000000LU, 2);
+
+METRIC_DEFINE_histogram(tablet, weak_write_lock_wait_duration,
+  "Weak Write Lock Wait Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent waiting for weak write locks on keys of this tablet.",
+  60000000LU, 2);
+
+METRIC_DEFINE_histogram(tablet, strong_read_lock_wait_duration,
+  "Strong Read Lock Wait Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent waiting for strong read locks on keys of this tablet.",
+  60000000LU, 2);
+
+METRIC_DEFINE_histogram(tablet, strong_write_lock_wait_duration,
+  "Strong Write Lock Wait Duration",
+  yb::MetricUnit::kMicroseconds,
+  "Time spent waiting for strong write locks on keys of this tablet.",
+  60000000LU, 2);
+
 namespace yb {
 namespace docdb {
 
@@ -107,16 +134,21 @@ struct LockedBatchEntry {
 
   std::condition_variable cond_var;
 
-  // Refcounting for garbage collection. Can only be used while the global mutex is locked.
-  // Global mutex resides in lock manager and the same for all LockBatchEntries.
+  // Refcounting for garbage collection. Can only be used while the mutex of the shard this entry
+  // belongs to is locked.
   size_t ref_count = 0;
 
+  // Index of the lock manager shard this entry belongs to, entries never move between shards.
+  size_t shard_idx = 0;
+
   // Number of holders for each type
   std::atomic<LockState> num_holding{0};
 
   std::atomic<size_t> num_waiters{0};
 
-  MUST_USE_RESULT bool Lock(IntentTypeSet lock, CoarseTimePoint deadline);
+  // Adds time spent waiting for the lock, if any, to wait_time.
+  MUST_USE_RESULT bool Lock(
+      IntentTypeSet lock, CoarseTimePoint deadline, CoarseMonoClock::Duration* wait_time);
 
   void Unlock(IntentTypeSet lock);
 
@@ -133,29 +165,46 @@ class SharedLockManager::Impl {
   MUST_USE_RESULT bool Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline);
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
+  void SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity);
+
   ~Impl() {
-    std::lock_guard<std::mutex> lock(global_mutex_);
-    LOG_IF(DFATAL, !locks_.empty()) << "Locks not empty in dtor: " << yb::ToString(locks_);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      LOG_IF(DFATAL, !shard.locks.empty())
+          << "Locks not empty in dtor: " << yb::ToString(shard.locks);
+    }
   }
 
  private:
   typedef std::unordered_map<RefCntPrefix, LockedBatchEntry*, RefCntPrefixHash> LockEntryMap;
 
-  // Make sure the entries exist in the locks_ map and return pointers so we can access
-  // them without holding the global lock. Returns a vector with pointers in the same order
-  // as the keys in the batch.
+  // Keys are distributed between shards by hash, so batches locking different keys don't
+  // contend on the same mutex to find their lock entries.
+  struct Shard {
+    // Taken only for very short duration, with no blocking wait.
+    std::mutex mutex;
+
+    LockEntryMap locks GUARDED_BY(mutex);
+    // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
+    std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries GUARDED_BY(mutex);
+    std::vector<LockedBatchEntry*> free_lock_entries GUARDED_BY(mutex);
+  };
+
+  static constexpr size_t kNumShards = 16;
+
+  // Make sure the entries exist in the lock maps of their shards and store pointers to them in
+  // the batch, so we can access them without holding shard locks.
   void Reserve(LockBatchEntries* batch);
 
   // Update refcounts and maybe collect garbage.
   void Cleanup(const LockBatchEntries& key_to_intent_type);
 
-  // The global mutex should be taken only for very short duration, with no blocking wait.
-  std::mutex global_mutex_;
+  void RecordWaitTime(IntentTypeSet intent_types, CoarseMonoClock::Duration wait_time);
+
+  std::array<Shard, kNumShards> shards_;
 
-  LockEntryMap locks_ GUARDED_BY(global_mutex_);
-  // Cache of lock entries, to avoid allocation/deallocation of heavy LockedBatchEntry.
-  std::vector<std::unique_ptr<LockedBatchEntry>> lock_entries_ GUARDED_BY(global_mutex_);
-  std::vector<LockedBatchEntry*> free_lock_entries_ GUARDED_BY(global_mutex_);
+  // Lock wait time histograms indexed by intent type, null when metrics are not enabled.
+  std::array<scoped_refptr<Histogram>, kIntentTypeMapSize> wait_time_histograms_;
 };
 
 const std::array<LockState, kIntentTypeSetMapSize> kIntentTypeSetMask = GenerateByMask(
@@ -180,7 +229,8 @@ std::string SharedLockManager::ToString(const LockState& state) {
   return result;
 }
 
-bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
+bool LockedBatchEntry::Lock(
+    IntentTypeSet lock_type, CoarseTimePoint deadline, CoarseMonoClock::Duration* wait_time) {
   size_t type_idx = lock_type.ToUIntPtr();
   auto& num_holding = this->num_holding;
   auto old_value = num_holding.load(std::memory_order_acquire);
@@ -194,8 +244,10 @@ bool LockedBatchEntry::Lock(IntentTypeSet lock_type, CoarseTimePoint deadline) {
       continue;
     }
     num_waiters.fetch_add(1, std::memory_order_release);
-    BOOST_SCOPE_EXIT(this_) {
+    auto wait_start = CoarseMonoClock::Now();
+    BOOST_SCOPE_EXIT(this_, wait_start, wait_time) {
       this_->num_waiters.fetch_sub(1, std::memory_order_release);
+      *wait_time += CoarseMonoClock::Now() - wait_start;
     } BOOST_SCOPE_EXIT_END;
     std::unique_lock<std::mutex> lock(mutex);
     old_value = num_holding.load(std::memory_order_acquire);
@@ -254,12 +306,19 @@ void LockedBatchEntry::Unlock(IntentTypeSet lock_types) {
 bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseTimePoint deadline) {
   TRACE("Locking a batch of $0 keys", key_to_intent_type->size());
   Reserve(key_to_intent_type);
+  // Keys of the batch are sorted, so locks are always acquired in the same order and batches
+  // could not deadlock, independently of how keys are distributed between shards.
   for (auto it = key_to_intent_type->begin(); it != key_to_intent_type->end(); ++it) {
     const auto& key_and_intent_type = *it;
     const auto intent_types = key_and_intent_type.intent_types;
     VLOG(4) << "Locking " << yb::ToString(intent_types) << ": "
             << key_and_intent_type.key.as_slice().ToDebugHexString();
-    if (!key_and_intent_type.locked->Lock(intent_types, deadline)) {
+    CoarseMonoClock::Duration wait_time = CoarseMonoClock::Duration::zero();
+    const bool locked = key_and_intent_type.locked->Lock(intent_types, deadline, &wait_time);
+    if (wait_time != CoarseMonoClock::Duration::zero()) {
+      RecordWaitTime(intent_types, wait_time);
+    }
+    if (!locked) {
       while (it != key_to_intent_type->begin()) {
         --it;
         it->locked->Unlock(it->intent_types);
@@ -273,21 +332,52 @@ bool SharedLockManager::Impl::Lock(LockBatchEntries* key_to_intent_type, CoarseT
   return true;
 }
 
+void SharedLockManager::Impl::RecordWaitTime(
+    IntentTypeSet intent_types, CoarseMonoClock::Duration wait_time) {
+  const auto wait_us = MonoDelta(wait_time).ToMicroseconds();
+  for (auto intent_type : intent_types) {
+    const auto& histogram = wait_time_histograms_[to_underlying(intent_type)];
+    if (histogram) {
+      histogram->Increment(wait_us);
+    }
+  }
+}
+
 void SharedLockManager::Impl::Reserve(LockBatchEntries* key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
-  for (auto& key_and_intent_type : *key_to_intent_type) {
-    auto& value = locks_[key_and_intent_type.key];
-    if (!value) {
-      if (!free_lock_entries_.empty()) {
-        value = free_lock_entries_.back();
-        free_lock_entries_.pop_back();
-      } else {
-        lock_entries_.emplace_back(std::make_unique<LockedBatchEntry>());
-        value = lock_entries_.back().get();
+  // Shards are visited in increasing order, and each shard mutex is taken once per batch.
+  boost::container::small_vector<size_t, 16> shard_indexes;
+  shard_indexes.reserve(key_to_intent_type->size());
+  std::bitset<kNumShards> used_shards;
+  for (const auto& key_and_intent_type : *key_to_intent_type) {
+    shard_indexes.push_back(RefCntPrefixHash()(key_and_intent_type.key) % kNumShards);
+    used_shards.set(shard_indexes.back());
+  }
+
+  for (size_t shard_idx = 0; shard_idx != kNumShards; ++shard_idx) {
+    if (!used_shards.test(shard_idx)) {
+      continue;
+    }
+    auto& shard = shards_[shard_idx];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (size_t i = 0; i != shard_indexes.size(); ++i) {
+      if (shard_indexes[i] != shard_idx) {
+        continue;
+      }
+      auto& key_and_intent_type = (*key_to_intent_type)[i];
+      auto& value = shard.locks[key_and_intent_type.key];
+      if (!value) {
+        if (!shard.free_lock_entries.empty()) {
+          value = shard.free_lock_entries.back();
+          shard.free_lock_entries.pop_back();
+        } else {
+          shard.lock_entries.emplace_back(std::make_unique<LockedBatchEntry>());
+          value = shard.lock_entries.back().get();
+          value->shard_idx = shard_idx;
+        }
       }
+      value->ref_count++;
+      key_and_intent_type.locked = value;
     }
-    value->ref_count++;
-    key_and_intent_type.locked = value;
   }
 }
 
@@ -302,15 +392,40 @@ void SharedLockManager::Impl::Unlock(const LockBatchEntries& key_to_intent_type)
 }
 
 void SharedLockManager::Impl::Cleanup(const LockBatchEntries& key_to_intent_type) {
-  std::lock_guard<std::mutex> lock(global_mutex_);
+  std::bitset<kNumShards> used_shards;
   for (const auto& item : key_to_intent_type) {
-    if (--(item.locked->ref_count) == 0) {
-      locks_.erase(item.key);
-      free_lock_entries_.push_back(item.locked);
+    used_shards.set(item.locked->shard_idx);
+  }
+
+  for (size_t shard_idx = 0; shard_idx != kNumShards; ++shard_idx) {
+    if (!used_shards.test(shard_idx)) {
+      continue;
+    }
+    auto& shard = shards_[shard_idx];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (const auto& item : key_to_intent_type) {
+      if (item.locked->shard_idx != shard_idx) {
+        continue;
+      }
+      if (--(item.locked->ref_count) == 0) {
+        shard.locks.erase(item.key);
+        shard.free_lock_entries.push_back(item.locked);
+      }
     }
   }
 }
 
+void SharedLockManager::Impl::SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity) {
+  wait_time_histograms_[to_underlying(IntentType::kWeakRead)] =
+      METRIC_weak_read_lock_wait_duration.Instantiate(metric_entity);
+  wait_time_histograms_[to_underlying(IntentType::kWeakWrite)] =
+      METRIC_weak_write_lock_wait_duration.Instantiate(metric_entity);
+  wait_time_histograms_[to_underlying(IntentType::kStrongRead)] =
+      METRIC_strong_read_lock_wait_duration.Instantiate(metric_entity);
+  wait_time_histograms_[to_underlying(IntentType::kStrongWrite)] =
+      METRIC_strong_write_lock_wait_duration.Instantiate(metric_entity);
+}
+
 SharedLockManager::SharedLockManager() : impl_(new Impl) {
 }
 
@@ -324,5 +439,9 @@ void SharedLockManager::Unlock(const LockBatchEntries& key_to_intent_type) {
   impl_->Unlock(key_to_intent_type);
 }
 
+void SharedLockManager::SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity) {
+  impl_->SetMetricEntity(metric_entity);
+}
+
 }  // namespace docdb
 }  // namespace yb
@@ -22,10 +22,14 @@
 
 #include "yb/docdb/shared_lock_manager_fwd.h"
 #include "yb/docdb/lock_batch.h"
+#include "yb/gutil/ref_counted.h"
 #include "yb/gutil/spinlock.h"
 #include "yb/util/cross_thread_mutex.h"
 
 namespace yb {
+
+class MetricEntity;
+
 namespace docdb {
 
 // This class manages six types of locks on string keys. On each key, the possibilities are:
@@ -34,6 +38,9 @@ namespace docdb {
 // - Multiple kStrongSerializableRead and kWeakSerializableRead
 // - Multiple kStrongSerializableWrite and kWeakSerializableWrite
 // - Multiple kWeakSnapshotWrite, kWeakSerializableRead, and kWeakSerializableWrite
+//
+// Keys are distributed between independent shards by hash. A shard mutex is taken only to find or
+// create lock entries, while locks themselves are acquired without any mutex when not contended.
 class SharedLockManager {
  public:
   SharedLockManager();
@@ -49,6 +56,9 @@ class SharedLockManager {
   // Release the batch of locks. Requires that the locks are held.
   void Unlock(const LockBatchEntries& key_to_intent_type);
 
+  // Enables lock wait time metrics. Should be called before the lock manager is used.
+  void SetMetricEntity(const scoped_refptr<MetricEntity>& metric_entity);
+
   // Whether or not the state is possible
   static std::string ToString(const LockState& state);
 
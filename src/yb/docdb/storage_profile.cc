@@ -0,0 +1,80 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/storage_profile.h"
+
+#include "yb/rocksdb/perf_context.h"
+
+#include "yb/util/format.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+thread_local uint64_t intent_seeks = 0;
+
+StorageProfile CurrentCounters() {
+  const auto& perf = rocksdb::perf_context;
+  StorageProfile result;
+  result.block_reads = perf.block_read_count;
+  result.block_cache_hits = perf.block_cache_hit_count;
+  result.bytes_read = perf.block_read_byte;
+  result.bloom_hits = perf.bloom_sst_hit_count;
+  result.bloom_misses = perf.bloom_sst_miss_count;
+  result.memtable_seeks = perf.seek_on_memtable_count;
+  result.seeks = perf.iter_seek_count;
+  result.nexts = perf.iter_next_count;
+  result.intent_seeks = intent_seeks;
+  return result;
+}
+
+} // namespace
+
+std::string StorageProfile::ToString() const {
+  return Format(
+      "{ block_reads: $0 block_cache_hits: $1 bytes_read: $2 bloom_hits: $3 bloom_misses: $4 "
+      "memtable_seeks: $5 seeks: $6 nexts: $7 intent_seeks: $8 time: $9 }",
+      block_reads, block_cache_hits, bytes_read, bloom_hits, bloom_misses, memtable_seeks, seeks,
+      nexts, intent_seeks, time);
+}
+
+ScopedStorageProfile::ScopedStorageProfile()
+    : start_(CurrentCounters()), start_time_(MonoTime::Now()) {
+}
+
+StorageProfile ScopedStorageProfile::Finish() const {
+  auto result = CurrentCounters();
+  // Perf context could be reset by other code in the meantime, in this case counters are lost.
+  auto delta = [](uint64_t end, uint64_t start) {
+    return end >= start ? end - start : 0;
+  };
+  result.block_reads = delta(result.block_reads, start_.block_reads);
+  result.block_cache_hits = delta(result.block_cache_hits, start_.block_cache_hits);
+  result.bytes_read = delta(result.bytes_read, start_.bytes_read);
+  result.bloom_hits = delta(result.bloom_hits, start_.bloom_hits);
+  result.bloom_misses = delta(result.bloom_misses, start_.bloom_misses);
+  result.memtable_seeks = delta(result.memtable_seeks, start_.memtable_seeks);
+  result.seeks = delta(result.seeks, start_.seeks);
+  result.nexts = delta(result.nexts, start_.nexts);
+  result.intent_seeks = delta(result.intent_seeks, start_.intent_seeks);
+  result.time = MonoTime::Now().GetDeltaSince(start_time_);
+  return result;
+}
+
+void RecordIntentSeek() {
+  ++intent_seeks;
+}
+
+} // namespace docdb
+} // namespace yb
@@ -0,0 +1,67 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_STORAGE_PROFILE_H
+#define YB_DOCDB_STORAGE_PROFILE_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include "yb/util/monotime.h"
+
+namespace yb {
+namespace docdb {
+
+// Storage work done while serving a request, i.e. whether its time went to block reads or block
+// cache hits, and how many seeks and nexts of regular and intents records it did.
+struct StorageProfile {
+  uint64_t block_reads = 0;
+  uint64_t block_cache_hits = 0;
+  uint64_t bytes_read = 0;
+  // Checks of SST bloom filters, that did not filter out the file.
+  uint64_t bloom_hits = 0;
+  // Checks of SST bloom filters, that filtered out the file.
+  uint64_t bloom_misses = 0;
+  uint64_t memtable_seeks = 0;
+  // Seeks of RocksDB iterators, in both regular and intents DBs.
+  uint64_t seeks = 0;
+  uint64_t nexts = 0;
+  // Seeks of intents DB iterators.
+  uint64_t intent_seeks = 0;
+  MonoDelta time;
+
+  std::string ToString() const;
+};
+
+// Collects the storage profile of the current thread between construction and Finish.
+// Uses RocksDB perf context, so work done by other threads on behalf of the same request is not
+// included.
+class ScopedStorageProfile {
+ public:
+  ScopedStorageProfile();
+
+  StorageProfile Finish() const;
+
+ private:
+  StorageProfile start_;
+  MonoTime start_time_;
+};
+
+// Should be called on each seek of intents DB iterator, to account it in the storage profile.
+void RecordIntentSeek();
+
+} // namespace docdb
+} // namespace yb
+
+#endif // YB_DOCDB_STORAGE_PROFILE_H
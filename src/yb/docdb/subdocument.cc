@@ -219,6 +219,20 @@ pair<SubDocument*, bool> SubDocument::GetOrAddChild(const PrimitiveValue& key) {
   }
 }
 
+pair<SubDocument*, bool> SubDocument::GetOrAddChild(PrimitiveValue&& key) {
+  DCHECK(IsObjectType(type_));
+  EnsureContainerAllocated();
+  auto& obj_container = object_container();
+  auto iter = obj_container.find(key);
+  if (iter == obj_container.end()) {
+    auto ret = obj_container.emplace(std::move(key), SubDocument());
+    CHECK(ret.second);
+    return make_pair(&ret.first->second, true);  // New subdocument created.
+  } else {
+    return make_pair(&iter->second, false);  // No new subdocument created.
+  }
+}
+
 void SubDocument::AddListElement(SubDocument&& value) {
   DCHECK_EQ(ValueType::kArray, type_);
   EnsureContainerAllocated();
@@ -238,6 +252,19 @@ void SubDocument::SetChild(const PrimitiveValue& key, SubDocument&& value) {
   }
 }
 
+void SubDocument::SetChild(PrimitiveValue&& key, SubDocument&& value) {
+  type_ = ValueType::kObject;
+  EnsureContainerAllocated();
+  auto& obj_container = object_container();
+  auto existing_element = obj_container.find(key);
+  if (existing_element == obj_container.end()) {
+    const bool inserted_value = obj_container.emplace(std::move(key), std::move(value)).second;
+    CHECK(inserted_value);
+  } else {
+    existing_element->second = std::move(value);
+  }
+}
+
 bool SubDocument::DeleteChild(const PrimitiveValue& key) {
   CHECK_EQ(ValueType::kObject, type_);
   if (!has_valid_object_container())
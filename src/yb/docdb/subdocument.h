@@ -139,6 +139,7 @@ class SubDocument : public PrimitiveValue {
   // @return A pair of the child at the requested subkey, and a boolean flag indicating whether a
   //         new child subdocument has been added.
   std::pair<SubDocument*, bool> GetOrAddChild(const PrimitiveValue& key);
+  std::pair<SubDocument*, bool> GetOrAddChild(PrimitiveValue&& key);
 
   // Add a list element child of the given value.
   void AddListElement(SubDocument&& value);
@@ -146,8 +147,11 @@ class SubDocument : public PrimitiveValue {
   // Set the child subdocument of an object to the given value.
   void SetChild(const PrimitiveValue& key, SubDocument&& value);
 
+  // Same as above, but moves the key into the object when a new child is added.
+  void SetChild(PrimitiveValue&& key, SubDocument&& value);
+
   void SetChildPrimitive(const PrimitiveValue& key, PrimitiveValue&& value) {
-    SetChild(key, SubDocument(value));
+    SetChild(key, SubDocument(std::move(value)));
   }
 
   void SetChildPrimitive(const PrimitiveValue& key, const PrimitiveValue& value) {
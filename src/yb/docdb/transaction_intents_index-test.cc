@@ -0,0 +1,217 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/doc_key.h"
+#include "yb/docdb/docdb.h"
+#include "yb/docdb/transaction_intents_index.h"
+
+#include "yb/rocksdb/write_batch.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace docdb {
+
+class TransactionIntentsIndexTest : public YBTest {
+ protected:
+  static KeyBytes RowKey(const std::string& row) {
+    return DocKey({PrimitiveValue(row)}).Encode();
+  }
+
+  static KeyBytes ColumnKey(const std::string& row, const std::string& column) {
+    return SubDocKey(DocKey({PrimitiveValue(row)}), PrimitiveValue(column)).EncodeWithoutHt();
+  }
+
+  static KeyBytes RangeEnd(const KeyBytes& key) {
+    KeyBytes result = key;
+    result.AppendValueType(ValueType::kMaxByte);
+    return result;
+  }
+
+  static KeyBytes IntentKey(const KeyBytes& key, IntentType intent_type) {
+    KeyBytes intent_key = key;
+    intent_key.AppendValueType(ValueType::kIntentTypeSet);
+    intent_key.AppendIntentTypeSet(IntentTypeSet({intent_type}));
+    intent_key.AppendValueType(ValueType::kHybridTime);
+    intent_key.AppendHybridTime(DocHybridTime(HybridTime::FromMicros(1000), 0));
+    return intent_key;
+  }
+
+  static void AddIntent(
+      const TransactionId& transaction_id, const KeyBytes& key, IntentType intent_type,
+      rocksdb::WriteBatch* write_batch, const Slice& value = Slice()) {
+    auto intent_key = IntentKey(key, intent_type);
+    write_batch->Put(intent_key.AsSlice(), value);
+
+    // Reverse index record.
+    KeyBytes reverse_key;
+    AppendTransactionKeyPrefix(transaction_id, &reverse_key);
+    reverse_key.AppendValueType(ValueType::kHybridTime);
+    reverse_key.AppendHybridTime(DocHybridTime(HybridTime::FromMicros(1000), 0));
+    write_batch->Put(reverse_key.AsSlice(), intent_key.AsSlice());
+  }
+
+  bool MayHaveStrongIntents(const KeyBytes& lower_bound, const KeyBytes& upper_bound) {
+    return index_.MayHaveStrongIntents(lower_bound.AsSlice(), upper_bound.AsSlice());
+  }
+
+  bool MayHaveIntentsInRow(const std::string& row) {
+    auto key = RowKey(row);
+    return MayHaveStrongIntents(key, RangeEnd(key));
+  }
+
+  StrongIntentsInRange Lookup(
+      const TransactionId& transaction_id, const KeyBytes& lower_bound,
+      const KeyBytes& upper_bound, IntentRecords* records) {
+    return index_.Lookup(transaction_id, lower_bound.AsSlice(), upper_bound.AsSlice(), records);
+  }
+
+  const TransactionId txn1_ = GenerateTransactionId();
+  const TransactionId txn2_ = GenerateTransactionId();
+  TransactionIntentsIndex index_{1024 * 1024, 1024};
+};
+
+TEST_F(TransactionIntentsIndexTest, Lookup) {
+  ASSERT_FALSE(MayHaveIntentsInRow("row1"));
+  ASSERT_FALSE(MayHaveStrongIntents(KeyBytes(), KeyBytes()));
+
+  rocksdb::WriteBatch write_batch;
+  KeyBytes metadata_key;
+  AppendTransactionKeyPrefix(txn1_, &metadata_key);
+  write_batch.Put(metadata_key.AsSlice(), "metadata");
+  AddIntent(txn1_, ColumnKey("row1", "column"), IntentType::kStrongWrite, &write_batch);
+  AddIntent(txn1_, RowKey("row1"), IntentType::kWeakWrite, &write_batch);
+  AddIntent(txn1_, ColumnKey("row2", "column"), IntentType::kStrongRead, &write_batch);
+  index_.Add(txn1_, write_batch);
+  ASSERT_GT(index_.consumption(), 0);
+
+  ASSERT_TRUE(MayHaveIntentsInRow("row1"));
+  ASSERT_TRUE(MayHaveStrongIntents(KeyBytes(), KeyBytes()));
+  // Read intents are not interesting for readers.
+  ASSERT_FALSE(MayHaveIntentsInRow("row2"));
+  // Weak intent of the row is not interesting for readers as well.
+  ASSERT_FALSE(MayHaveStrongIntents(RowKey("row1"), ColumnKey("row1", "column")));
+
+  // Intent of the column could affect reads of its subkeys.
+  auto subkey = SubDocKey(
+      DocKey({PrimitiveValue("row1")}), PrimitiveValue("column"), PrimitiveValue("subkey"));
+  ASSERT_TRUE(MayHaveStrongIntents(
+      subkey.EncodeWithoutHt(), RangeEnd(ColumnKey("row1", "column"))));
+
+  index_.Remove(txn1_);
+  ASSERT_FALSE(MayHaveIntentsInRow("row1"));
+  ASSERT_EQ(0, index_.consumption());
+}
+
+TEST_F(TransactionIntentsIndexTest, Unindexed) {
+  rocksdb::WriteBatch write_batch;
+  AddIntent(txn1_, ColumnKey("row1", "column"), IntentType::kStrongWrite, &write_batch);
+  index_.Add(txn1_, write_batch);
+
+  // Intents of unindexed transaction could be anywhere.
+  index_.AddUnindexed(txn2_);
+  ASSERT_TRUE(MayHaveIntentsInRow("row2"));
+  index_.Remove(txn2_);
+  ASSERT_FALSE(MayHaveIntentsInRow("row2"));
+  ASSERT_TRUE(MayHaveIntentsInRow("row1"));
+
+  // Transaction becomes unindexed when its intents do not fit into the index.
+  TransactionIntentsIndex keys_only_index(1024 * 1024, 0 /* max_transaction_records_bytes */);
+  keys_only_index.Add(txn1_, write_batch);
+  TransactionIntentsIndex small_index(
+      keys_only_index.consumption(), 0 /* max_transaction_records_bytes */);
+  auto may_have_intents_in_row = [&small_index](const std::string& row) {
+    return small_index.MayHaveStrongIntents(
+        RowKey(row).AsSlice(), RangeEnd(RowKey(row)).AsSlice());
+  };
+  small_index.Add(txn1_, write_batch);
+  ASSERT_FALSE(may_have_intents_in_row("row2"));
+  rocksdb::WriteBatch write_batch3;
+  AddIntent(txn1_, ColumnKey("row3", "column"), IntentType::kStrongWrite, &write_batch3);
+  small_index.Add(txn1_, write_batch3);
+  ASSERT_EQ(0, small_index.consumption());
+
+  // Only the range of known intents of unindexed transaction is affected.
+  ASSERT_TRUE(may_have_intents_in_row("row1"));
+  ASSERT_TRUE(may_have_intents_in_row("row2"));
+  ASSERT_TRUE(may_have_intents_in_row("row3"));
+  ASSERT_FALSE(may_have_intents_in_row("row0"));
+  ASSERT_FALSE(may_have_intents_in_row("row4"));
+
+  // Further intents of unindexed transaction are not added, but extend its range.
+  rocksdb::WriteBatch write_batch5;
+  AddIntent(txn1_, ColumnKey("row5", "column"), IntentType::kStrongWrite, &write_batch5);
+  small_index.Add(txn1_, write_batch5);
+  ASSERT_EQ(0, small_index.consumption());
+  ASSERT_TRUE(may_have_intents_in_row("row4"));
+  small_index.Remove(txn1_);
+  ASSERT_FALSE(may_have_intents_in_row("row1"));
+}
+
+TEST_F(TransactionIntentsIndexTest, OwnRecords) {
+  rocksdb::WriteBatch write_batch;
+  AddIntent(txn1_, ColumnKey("row1", "c1"), IntentType::kStrongWrite, &write_batch, "v1");
+  AddIntent(txn1_, ColumnKey("row1", "c2"), IntentType::kStrongWrite, &write_batch, "v2");
+  AddIntent(txn1_, RowKey("row1"), IntentType::kWeakWrite, &write_batch, "weak");
+  index_.Add(txn1_, write_batch);
+
+  // Reads of the transaction get its records, in the intents DB order.
+  IntentRecords records;
+  auto row1 = RowKey("row1");
+  ASSERT_EQ(StrongIntentsInRange::kOwnOnly, Lookup(txn1_, row1, RangeEnd(row1), &records));
+  ASSERT_EQ(2, records.size());
+  ASSERT_EQ(IntentKey(ColumnKey("row1", "c1"), IntentType::kStrongWrite).data(),
+            records[0].first);
+  ASSERT_EQ("v1", records[0].second);
+  ASSERT_EQ("v2", records[1].second);
+
+  // Record of the column is returned when reading its subkeys.
+  records.clear();
+  auto subkey = SubDocKey(
+      DocKey({PrimitiveValue("row1")}), PrimitiveValue("c2"), PrimitiveValue("subkey"));
+  ASSERT_EQ(StrongIntentsInRange::kOwnOnly, Lookup(
+      txn1_, subkey.EncodeWithoutHt(), RangeEnd(ColumnKey("row1", "c2")), &records));
+  ASSERT_EQ(1, records.size());
+  ASSERT_EQ("v2", records[0].second);
+
+  // Other transactions could not read them from memory.
+  records.clear();
+  ASSERT_EQ(StrongIntentsInRange::kUnknown, Lookup(txn2_, row1, RangeEnd(row1), &records));
+  ASSERT_EQ(StrongIntentsInRange::kNone,
+            Lookup(txn2_, RowKey("row2"), RangeEnd(RowKey("row2")), &records));
+
+  // Range with intents of another transaction is not resolved in memory.
+  rocksdb::WriteBatch write_batch2;
+  AddIntent(txn2_, ColumnKey("row1", "c3"), IntentType::kStrongWrite, &write_batch2, "v3");
+  index_.Add(txn2_, write_batch2);
+  ASSERT_EQ(StrongIntentsInRange::kUnknown, Lookup(txn1_, row1, RangeEnd(row1), &records));
+  index_.Remove(txn2_);
+  ASSERT_EQ(StrongIntentsInRange::kOwnOnly, Lookup(txn1_, row1, RangeEnd(row1), &records));
+
+  // Records that do not fit are dropped, but keys are still indexed.
+  rocksdb::WriteBatch big_batch;
+  AddIntent(txn1_, ColumnKey("row1", "c4"), IntentType::kStrongWrite, &big_batch,
+            std::string(2048, 'x'));
+  index_.Add(txn1_, big_batch);
+  records.clear();
+  ASSERT_EQ(StrongIntentsInRange::kUnknown, Lookup(txn1_, row1, RangeEnd(row1), &records));
+  ASSERT_TRUE(records.empty());
+  ASSERT_EQ(StrongIntentsInRange::kNone,
+            Lookup(txn1_, RowKey("row2"), RangeEnd(RowKey("row2")), &records));
+
+  index_.Remove(txn1_);
+  ASSERT_EQ(0, index_.consumption());
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,344 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/docdb/transaction_intents_index.h"
+
+#include <algorithm>
+
+#include "yb/docdb/intent.h"
+#include "yb/docdb/value_type.h"
+
+#include "yb/rocksdb/write_batch.h"
+
+namespace yb {
+namespace docdb {
+
+namespace {
+
+// Approximate overhead of a node in std::map, plus the reference to it from the transaction.
+constexpr size_t kKeyOverhead =
+    4 * sizeof(void*) + sizeof(std::vector<TransactionId>) + sizeof(TransactionId) + sizeof(void*);
+
+// Approximate overhead of a record node in std::map.
+constexpr size_t kRecordOverhead = 4 * sizeof(void*) + 2 * sizeof(std::string);
+
+} // namespace
+
+// Collects keys and records of strong write intents from the intents write batch.
+class TransactionIntentsIndex::Collector : public rocksdb::WriteBatch::Handler {
+ public:
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    // Transaction metadata and reverse index records are not intents.
+    if (key.empty() || key[0] == ValueTypeAsChar::kTransactionId) {
+      return Status::OK();
+    }
+    auto decoded_key = VERIFY_RESULT(DecodeIntentKey(key));
+    if (decoded_key.intent_types.Test(IntentType::kStrongWrite)) {
+      keys_.push_back(decoded_key.intent_prefix);
+      records_.emplace_back(key, value);
+      keys_charge_ += decoded_key.intent_prefix.size() + kKeyOverhead;
+      records_charge_ += key.size() + value.size() + kRecordOverhead;
+    }
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Status::OK();
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return Status::OK();
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Frontiers(const rocksdb::UserFrontiers& frontiers) override {
+    return Status::OK();
+  }
+
+  const std::vector<Slice>& keys() const {
+    return keys_;
+  }
+
+  const std::vector<std::pair<Slice, Slice>>& records() const {
+    return records_;
+  }
+
+  size_t keys_charge() const {
+    return keys_charge_;
+  }
+
+  size_t records_charge() const {
+    return records_charge_;
+  }
+
+ private:
+  std::vector<Slice> keys_;
+  std::vector<std::pair<Slice, Slice>> records_;
+  size_t keys_charge_ = 0;
+  size_t records_charge_ = 0;
+};
+
+TransactionIntentsIndex::TransactionIntentsIndex(
+    size_t capacity_bytes, size_t max_transaction_records_bytes)
+    : capacity_bytes_(capacity_bytes),
+      max_transaction_records_bytes_(max_transaction_records_bytes) {
+}
+
+void TransactionIntentsIndex::Add(
+    const TransactionId& transaction_id, const rocksdb::WriteBatch& write_batch) {
+  Collector collector;
+  auto status = write_batch.Iterate(&collector);
+  if (!status.ok()) {
+    LOG(DFATAL) << "Failed to index intents of " << transaction_id << ": " << status;
+    AddUnindexed(transaction_id);
+    return;
+  }
+
+  std::lock_guard<rw_spinlock> lock(mutex_);
+  auto unindexed_it = unindexed_.find(transaction_id);
+  if (unindexed_it != unindexed_.end()) {
+    for (const auto& key : collector.keys()) {
+      unindexed_it->second.Extend(key);
+    }
+    return;
+  }
+  auto& entry = transactions_[transaction_id];
+  const auto charge = collector.keys_charge();
+  if (consumption_ + charge > capacity_bytes_) {
+    VLOG(2) << "Intents of " << transaction_id << " do not fit into index";
+    UnindexedRange range;
+    for (const auto& it : entry.keys) {
+      range.Extend(it->first);
+    }
+    for (const auto& key : collector.keys()) {
+      range.Extend(key);
+    }
+    EraseKeysUnlocked(transaction_id, &entry);
+    transactions_.erase(transaction_id);
+    unindexed_.emplace(transaction_id, std::move(range));
+    return;
+  }
+  for (const auto& key : collector.keys()) {
+    auto it = keys_.find(key);
+    if (it == keys_.end()) {
+      it = keys_.emplace(key.ToBuffer(), std::vector<TransactionId>()).first;
+    }
+    it->second.push_back(transaction_id);
+    entry.keys.push_back(it);
+  }
+  entry.charge += charge;
+  consumption_ += charge;
+
+  if (!entry.has_records) {
+    return;
+  }
+  const auto records_charge = collector.records_charge();
+  if (entry.records_charge + records_charge > max_transaction_records_bytes_ ||
+      consumption_ + records_charge > capacity_bytes_) {
+    DropRecordsUnlocked(&entry);
+    return;
+  }
+  for (const auto& record : collector.records()) {
+    entry.records.emplace(record.first.ToBuffer(), record.second.ToBuffer());
+  }
+  entry.records_charge += records_charge;
+  entry.charge += records_charge;
+  consumption_ += records_charge;
+}
+
+void TransactionIntentsIndex::AddUnindexed(const TransactionId& transaction_id) {
+  std::lock_guard<rw_spinlock> lock(mutex_);
+  auto it = transactions_.find(transaction_id);
+  if (it != transactions_.end()) {
+    EraseKeysUnlocked(transaction_id, &it->second);
+    transactions_.erase(it);
+  }
+  unindexed_[transaction_id].unbounded = true;
+}
+
+void TransactionIntentsIndex::Remove(const TransactionId& transaction_id) {
+  std::lock_guard<rw_spinlock> lock(mutex_);
+  auto it = transactions_.find(transaction_id);
+  if (it != transactions_.end()) {
+    EraseKeysUnlocked(transaction_id, &it->second);
+    transactions_.erase(it);
+  }
+  unindexed_.erase(transaction_id);
+}
+
+void TransactionIntentsIndex::EraseKeysUnlocked(
+    const TransactionId& transaction_id, TransactionEntry* entry) {
+  for (const auto& it : entry->keys) {
+    auto& transactions = it->second;
+    auto pos = std::find(transactions.begin(), transactions.end(), transaction_id);
+    if (pos != transactions.end()) {
+      transactions.erase(pos);
+    }
+    if (transactions.empty()) {
+      keys_.erase(it);
+    }
+  }
+  entry->keys.clear();
+  entry->records.clear();
+  entry->records_charge = 0;
+  consumption_ -= entry->charge;
+  entry->charge = 0;
+}
+
+void TransactionIntentsIndex::DropRecordsUnlocked(TransactionEntry* entry) {
+  VLOG(3) << "Records of transaction do not fit into index";
+  entry->records.clear();
+  entry->has_records = false;
+  entry->charge -= entry->records_charge;
+  consumption_ -= entry->records_charge;
+  entry->records_charge = 0;
+}
+
+StrongIntentsInRange TransactionIntentsIndex::Lookup(
+    const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+    IntentRecords* records) const {
+  shared_lock<rw_spinlock> lock(mutex_);
+  for (const auto& id_and_range : unindexed_) {
+    if (id_and_range.second.Overlaps(lower_bound, upper_bound)) {
+      return StrongIntentsInRange::kUnknown;
+    }
+  }
+
+  // Intent key is its SubDocKey followed by the intent type and hybrid time, so the key of
+  // intent is in the range when it is in the range itself, or when it is a prefix of the lower
+  // bound, since the suffix could place the intent key after the lower bound.
+  std::vector<Slice> own_keys;
+  auto is_own = [&transaction_id, &own_keys](const KeyMap::value_type& key_entry) {
+    for (const auto& id : key_entry.second) {
+      if (id != transaction_id) {
+        return false;
+      }
+    }
+    own_keys.emplace_back(key_entry.first);
+    return true;
+  };
+  for (auto it = keys_.lower_bound(lower_bound);
+       it != keys_.end() && (upper_bound.empty() || Slice(it->first).compare(upper_bound) < 0);
+       ++it) {
+    if (!is_own(*it)) {
+      return StrongIntentsInRange::kUnknown;
+    }
+  }
+  if (!ForEachPrefixOfUnlocked(lower_bound, is_own)) {
+    return StrongIntentsInRange::kUnknown;
+  }
+  if (own_keys.empty()) {
+    return StrongIntentsInRange::kNone;
+  }
+
+  auto transaction_it = transactions_.find(transaction_id);
+  if (transaction_it == transactions_.end() || !transaction_it->second.has_records) {
+    return StrongIntentsInRange::kUnknown;
+  }
+  const auto& own_records = transaction_it->second.records;
+  const auto old_size = records->size();
+  for (const auto& key : own_keys) {
+    for (auto it = own_records.lower_bound(key);
+         it != own_records.end() && Slice(it->first).starts_with(key); ++it) {
+      if (it->first.size() > key.size() && IntentValueType(it->first[key.size()])) {
+        records->push_back(*it);
+      }
+    }
+  }
+  std::sort(records->begin() + old_size, records->end());
+  return StrongIntentsInRange::kOwnOnly;
+}
+
+bool TransactionIntentsIndex::MayHaveStrongIntents(
+    const Slice& lower_bound, const Slice& upper_bound) const {
+  IntentRecords records;
+  return Lookup(TransactionId(boost::uuids::nil_uuid()), lower_bound, upper_bound, &records) !=
+         StrongIntentsInRange::kNone;
+}
+
+template <class F>
+bool TransactionIntentsIndex::ForEachPrefixOfUnlocked(Slice key, const F& f) const {
+  for (;;) {
+    // Find the last entry that is not greater than the key.
+    auto it = keys_.upper_bound(key);
+    if (it == keys_.begin()) {
+      return true;
+    }
+    --it;
+    Slice entry(it->first);
+    if (key.starts_with(entry)) {
+      if (!f(*it)) {
+        return false;
+      }
+      if (entry.empty()) {
+        return true;
+      }
+      // Remaining prefixes of the key are shorter than this entry.
+      key = Slice(entry.data(), entry.size() - 1);
+      continue;
+    }
+    // All remaining candidates are less than this entry, so each of them is also a prefix of this
+    // entry. So only prefixes of the common part of the entry and the key should be checked.
+    size_t common = 0;
+    while (entry[common] == key[common]) {
+      ++common;
+    }
+    key = Slice(key.data(), common);
+  }
+}
+
+void TransactionIntentsIndex::UnindexedRange::Extend(const Slice& key) {
+  if (!has_keys) {
+    min_key = max_key = key.ToBuffer();
+    has_keys = true;
+  } else if (key.compare(Slice(min_key)) < 0) {
+    min_key = key.ToBuffer();
+  } else if (key.compare(Slice(max_key)) > 0) {
+    max_key = key.ToBuffer();
+  }
+}
+
+bool TransactionIntentsIndex::UnindexedRange::Overlaps(
+    const Slice& lower_bound, const Slice& upper_bound) const {
+  if (unbounded) {
+    return true;
+  }
+  if (!has_keys || (!upper_bound.empty() && Slice(min_key).compare(upper_bound) >= 0)) {
+    return false;
+  }
+  if (Slice(max_key).compare(lower_bound) >= 0) {
+    return true;
+  }
+  // Intents of the keys that are prefixes of the lower bound are in the range as well.
+  for (size_t len = lower_bound.size(); len-- > 0;) {
+    Slice prefix(lower_bound.data(), len);
+    if (prefix.compare(Slice(min_key)) < 0) {
+      return false;
+    }
+    if (prefix.compare(Slice(max_key)) <= 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t TransactionIntentsIndex::consumption() const {
+  shared_lock<rw_spinlock> lock(mutex_);
+  return consumption_;
+}
+
+}  // namespace docdb
+}  // namespace yb
@@ -0,0 +1,145 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_DOCDB_TRANSACTION_INTENTS_INDEX_H_
+#define YB_DOCDB_TRANSACTION_INTENTS_INDEX_H_
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/transaction.h"
+#include "yb/util/locks.h"
+#include "yb/util/slice.h"
+
+namespace rocksdb {
+
+class WriteBatch;
+
+}  // namespace rocksdb
+
+namespace yb {
+namespace docdb {
+
+// A per-tablet, memory-bounded in-memory index of keys that have strong write intents in the
+// intents DB, grouped by transaction. It allows readers to find out that a key range does not
+// contain any provisional record without seeking the intents DB. While the records of a
+// transaction are small enough, they are kept as well, so the transaction could read its own
+// provisional records from memory when the range does not contain intents of other transactions.
+//
+// Keys are added before the intents write batch is written to the DB, and should be removed only
+// when no reader could see intents of the transaction anymore.
+//
+// A transaction, whose intents are not known, is registered as unindexed. For instance, it could
+// be a transaction that wrote its intents before the index was created, or a transaction whose
+// intents did not fit into the index. Only the range between the smallest and the largest known
+// key of an unindexed transaction is reported as possibly containing intents, or any range if
+// none of its keys are known.
+//
+// This class is thread-safe.
+class TransactionIntentsIndex {
+ public:
+  // Records of a transaction are kept while their total size does not exceed
+  // max_transaction_records_bytes.
+  TransactionIntentsIndex(size_t capacity_bytes, size_t max_transaction_records_bytes);
+
+  TransactionIntentsIndex(const TransactionIntentsIndex&) = delete;
+  void operator=(const TransactionIntentsIndex&) = delete;
+
+  // Adds keys of strong write intents from the intents write batch of the specified transaction.
+  void Add(const TransactionId& transaction_id, const rocksdb::WriteBatch& write_batch);
+
+  // Marks transaction as unindexed, with intents anywhere, dropping its keys.
+  void AddUnindexed(const TransactionId& transaction_id);
+
+  // Removes all keys of the transaction, or unmarks it if it was unindexed.
+  void Remove(const TransactionId& transaction_id);
+
+  // See TransactionStatusManager::LookupStrongIntents.
+  StrongIntentsInRange Lookup(
+      const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+      IntentRecords* records) const;
+
+  // Returns false only if it is known that there are no strong write intents with keys in the
+  // range [lower_bound, upper_bound). Empty upper_bound means that the range is not limited.
+  bool MayHaveStrongIntents(const Slice& lower_bound, const Slice& upper_bound) const;
+
+  size_t consumption() const;
+
+ private:
+  // Allows lookup of keys by Slice without allocating a string.
+  struct KeyLess {
+    typedef void is_transparent;
+
+    bool operator()(const std::string& lhs, const std::string& rhs) const {
+      return lhs < rhs;
+    }
+
+    bool operator()(const std::string& lhs, const Slice& rhs) const {
+      return Slice(lhs).compare(rhs) < 0;
+    }
+
+    bool operator()(const Slice& lhs, const std::string& rhs) const {
+      return lhs.compare(Slice(rhs)) < 0;
+    }
+  };
+
+  // Maps key of intent (SubDocKey without hybrid time) to the transactions that have intents for
+  // it, one entry per intent.
+  typedef std::map<std::string, std::vector<TransactionId>, KeyLess> KeyMap;
+
+  class Collector;
+
+  struct TransactionEntry {
+    std::vector<KeyMap::iterator> keys;
+    // Strong write intent records of the transaction, valid only while has_records is true.
+    std::map<std::string, std::string, KeyLess> records;
+    bool has_records = true;
+    size_t records_charge = 0;
+    size_t charge = 0;
+  };
+
+  // Range of keys of strong write intents of an unindexed transaction.
+  struct UnindexedRange {
+    bool unbounded = false;
+    bool has_keys = false;
+    std::string min_key;
+    std::string max_key;
+
+    void Extend(const Slice& key);
+    bool Overlaps(const Slice& lower_bound, const Slice& upper_bound) const;
+  };
+
+  void EraseKeysUnlocked(const TransactionId& transaction_id, TransactionEntry* entry);
+
+  void DropRecordsUnlocked(TransactionEntry* entry);
+
+  // Invokes f for each key from the index, that is a prefix of the specified key, until it
+  // returns false. Returns false if iteration was stopped.
+  template <class F>
+  bool ForEachPrefixOfUnlocked(Slice key, const F& f) const;
+
+  const size_t capacity_bytes_;
+  const size_t max_transaction_records_bytes_;
+  mutable rw_spinlock mutex_;
+  KeyMap keys_;
+  std::unordered_map<TransactionId, TransactionEntry, TransactionIdHash> transactions_;
+  std::unordered_map<TransactionId, UnindexedRange, TransactionIdHash> unindexed_;
+  size_t consumption_ = 0;
+};
+
+}  // namespace docdb
+}  // namespace yb
+
+#endif // YB_DOCDB_TRANSACTION_INTENTS_INDEX_H_
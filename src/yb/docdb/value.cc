@@ -108,6 +108,28 @@ Status Value::DecodeControlFields(Slice* slice) {
 Status Value::Decode(const Slice& rocksdb_value) {
   Slice slice = rocksdb_value;
   RETURN_NOT_OK(DecodeControlFields(&slice));
+  if (DecodeValueType(slice) == ValueType::kPackedRow) {
+    slice.consume_byte();
+    if (slice.empty()) {
+      return STATUS_FORMAT(Corruption, "Empty packed row in $0", rocksdb_value.ToDebugHexString());
+    }
+    primitive_value_ = PrimitiveValue(ValueType::kObject);
+    packed_row_ = slice.ToBuffer();
+    blob_reference_.clear();
+    return Status::OK();
+  }
+  packed_row_.clear();
+  if (DecodeValueType(slice) == ValueType::kBlobReference) {
+    slice.consume_byte();
+    if (slice.empty()) {
+      return STATUS_FORMAT(
+          Corruption, "Empty blob reference in $0", rocksdb_value.ToDebugHexString());
+    }
+    primitive_value_ = PrimitiveValue();
+    blob_reference_ = slice.ToBuffer();
+    return Status::OK();
+  }
+  blob_reference_.clear();
   RETURN_NOT_OK_PREPEND(
       primitive_value_.DecodeFromValue(slice),
       Format("Failed to decode value in $0", rocksdb_value.ToDebugHexString()));
@@ -115,7 +137,14 @@ Status Value::Decode(const Slice& rocksdb_value) {
 }
 
 std::string Value::ToString() const {
-  std::string result = primitive_value_.ToString();
+  std::string result;
+  if (is_packed_row()) {
+    result = Format("packed row: $0", Slice(packed_row_).ToDebugHexString());
+  } else if (is_blob_reference()) {
+    result = Format("blob reference: $0", Slice(blob_reference_).ToDebugHexString());
+  } else {
+    result = primitive_value_.ToString();
+  }
   if (merge_flags_) {
     result += Format("; merge flags: $0", merge_flags_);
   }
@@ -165,6 +194,16 @@ void Value::EncodeAndAppend(std::string *value_bytes, const Slice* external_valu
     util::AppendBigEndianUInt64(user_timestamp_, value_bytes);
   }
   if (!external_value) {
+    if (is_packed_row()) {
+      value_bytes->push_back(ValueTypeAsChar::kPackedRow);
+      value_bytes->append(packed_row_);
+      return;
+    }
+    if (is_blob_reference()) {
+      value_bytes->push_back(ValueTypeAsChar::kBlobReference);
+      value_bytes->append(blob_reference_);
+      return;
+    }
     value_bytes->append(primitive_value_.ToValue());
   } else {
     value_bytes->append(external_value->cdata(), external_value->size());
@@ -188,6 +227,13 @@ Status Value::DecodePrimitiveValueType(
   return Status::OK();
 }
 
+Value Value::PackedRow(std::string packed_row) {
+  DCHECK(!packed_row.empty());
+  Value result(PrimitiveValue(ValueType::kObject));
+  result.packed_row_ = std::move(packed_row);
+  return result;
+}
+
 const Value& Value::Tombstone() {
   static const auto kTombstone = Value(PrimitiveValue::kTombstone);
   return kTombstone;
@@ -69,6 +69,23 @@ class Value {
 
   const uint64_t merge_flags() const { return merge_flags_; }
 
+  // Packed row is decoded as an object init marker, whose children are stored in the value itself.
+  // See packed_row.h for details.
+  static Value PackedRow(std::string packed_row);
+
+  bool is_packed_row() const { return !packed_row_.empty(); }
+
+  // Encoded columns of the packed row. Empty if this value is not a packed row.
+  const std::string& packed_row() const { return packed_row_; }
+
+  // Values stored in blob files are replaced by references to them in the regular DB, see
+  // blob_storage.h. Such values are resolved by the iterators over the regular DB, so a reference
+  // is only decoded when the raw RocksDB value is inspected.
+  bool is_blob_reference() const { return !blob_reference_.empty(); }
+
+  // Encoded BlobReference. Empty if this value is not a blob reference.
+  const std::string& blob_reference() const { return blob_reference_; }
+
   // Consume the merge_flags portion of the slice if it exists and return it.
   static CHECKED_STATUS DecodeMergeFlags(rocksdb::Slice* slice, uint64_t* merge_flags);
 
@@ -147,6 +164,13 @@ class Value {
   // If this value was written using a transaction,
   // this field stores the original intent doc hybrid time.
   DocHybridTime intent_doc_ht_;
+
+  // Encoded columns, when this value is a packed row. Never empty for a packed row, since it starts
+  // with the schema version.
+  std::string packed_row_;
+
+  // Encoded blob reference, when this value is stored in a blob file.
+  std::string blob_reference_;
 };
 
 }  // namespace docdb
@@ -33,6 +33,8 @@ namespace docdb {
     ((kLowest, 0)) \
     /* Obsolete intent prefix. Should be deleted when DBs in old format are gone. */ \
     ((kObsoleteIntentPrefix, 10)) \
+    /* Prefix of range tombstone records, that are stored in the regular DB before all documents. */ \
+    ((kRangeTombstonePrefix, 11)) \
     /* We use ASCII code 13 in order to have it before all other value types which can occur in */ \
     /* key, so intents will be written in the same order as original keys for which intents are */ \
     /* written. */ \
@@ -92,6 +94,10 @@ namespace docdb {
     ((kDoubleDescending, 'L'))  /* ASCII code 76 */ \
     ((kFloatDescending, 'M')) /* ASCII code 77 */ \
     ((kUInt32, 'O'))  /* ASCII code 78 */ \
+    /* Value of the document key that contains all columns of the row, see packed_row.h. */ \
+    ((kPackedRow, 'P'))  /* ASCII code 80 */ \
+    /* Reference to the value stored in a blob file of the regular DB, see blob_storage.h. */ \
+    ((kBlobReference, 'Q'))  /* ASCII code 81 */ \
     ((kString, 'S'))  /* ASCII code 83 */ \
     ((kTrue, 'T'))  /* ASCII code 84 */ \
     ((kTombstone, 'X'))  /* ASCII code 88 */ \
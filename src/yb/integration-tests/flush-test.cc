@@ -25,6 +25,7 @@ using namespace std::literals;
 
 DECLARE_int64(global_memstore_size_percentage);
 DECLARE_int64(global_memstore_size_mb_max);
+DECLARE_int32(global_memstore_soft_limit_percentage);
 DECLARE_int32(memstore_size_mb);
 
 namespace yb {
@@ -38,6 +39,7 @@ class FlushITest : public YBTest {
   FlushITest() {}
   void SetUp() override {
     FLAGS_memstore_size_mb = kTabletLimitMB;
+    FLAGS_global_memstore_soft_limit_percentage = soft_limit_percentage();
     // Set the global memstore to kServerLimitMB.
     FLAGS_global_memstore_size_percentage = 100;
     FLAGS_global_memstore_size_mb_max = kServerLimitMB;
@@ -67,6 +69,11 @@ class FlushITest : public YBTest {
   }
 
  protected:
+  // Disable flushing before the global memstore size is reached by default, so only the global
+  // limit triggers flushes.
+  virtual int soft_limit_percentage() const {
+    return 0;
+  }
 
   size_t TotalFlushes() {
     size_t total_flushes = 0;
@@ -110,5 +117,29 @@ TEST_F(FlushITest, TestFlushHappens) {
   ASSERT_GT(flushes_since_write, 0);
 }
 
+class FlushSoftLimitITest : public FlushITest {
+ protected:
+  int soft_limit_percentage() const override {
+    return kSoftLimitPercentage;
+  }
+
+  const int kSoftLimitPercentage = 50;
+};
+
+TEST_F(FlushSoftLimitITest, TestFlushBeforeGlobalLimit) {
+  auto* memory_monitor = cluster_->mini_tablet_server(0)->server()->tablet_manager()
+      ->memory_monitor();
+  ASSERT_EQ((kServerLimitMB << 20) * kSoftLimitPercentage / 100, memory_monitor->soft_limit());
+
+  const size_t total_flushes_before = TotalFlushes();
+  // Write more than the soft limit, but less than the global memstore size.
+  WriteAtLeast(memory_monitor->soft_limit() + 1);
+  ASSERT_OK(WaitFor(
+      [this, total_flushes_before] { return TotalFlushes() > total_flushes_before; },
+      60s, "Flush", 10ms));
+  LOG(INFO) << "Flushed " << TotalFlushes() - total_flushes_before << " times, memstore usage: "
+            << memory_monitor->memory_usage();
+}
+
 } // namespace tserver
 } // namespace yb
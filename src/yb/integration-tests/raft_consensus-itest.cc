@@ -83,9 +83,11 @@ DECLARE_int32(leader_lease_duration_ms);
 DECLARE_int32(ht_lease_duration_ms);
 DECLARE_int32(rpc_timeout);
 
+METRIC_DECLARE_entity(server);
 METRIC_DECLARE_entity(tablet);
 METRIC_DECLARE_counter(not_leader_rejections);
 METRIC_DECLARE_gauge_int64(raft_term);
+METRIC_DECLARE_histogram(handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus);
 
 namespace yb {
 namespace tserver {
@@ -2895,5 +2897,40 @@ TEST_F(RaftConsensusITest, TestRemovePreVoterServerSucceeds) {
   TestRemoveTserverInTransitionSucceeds(RaftPeerPB::PRE_OBSERVER);
 }
 
+// Heartbeats of idle tablets should be coalesced into MultiRaftUpdateConsensus RPCs, without
+// affecting replication.
+TEST_F(RaftConsensusITest, MultiRaftHeartbeatBatcher) {
+  ASSERT_NO_FATALS(BuildAndStart({
+      "--enable_multi_raft_heartbeat_batcher=true",
+      "--multi_raft_heartbeat_window_ms=100"}));
+
+  // Heartbeats are coalesced only when several tablets are replicated to the same server.
+  client::TableHandle table;
+  ASSERT_OK(table.Create(
+      YBTableName(kTableName.namespace_name(), "multi_raft_table"), 8 /* num_tablets */,
+      client::YBSchema(schema_), client_.get()));
+
+  ASSERT_OK(WaitFor([this]() -> Result<bool> {
+    for (int i = 0; i < cluster_->num_tablet_servers(); ++i) {
+      int64_t num_calls = 0;
+      RETURN_NOT_OK(cluster_->tablet_server(i)->GetInt64Metric(
+          &METRIC_ENTITY_server,
+          "yb.tabletserver",
+          &METRIC_handler_latency_yb_consensus_ConsensusService_MultiRaftUpdateConsensus,
+          "total_count",
+          &num_calls));
+      if (num_calls > 0) {
+        return true;
+      }
+    }
+    return false;
+  }, 30s, "Coalesced heartbeats"));
+
+  ASSERT_NO_FATALS(InsertTestRowsRemoteThread(
+      0, FLAGS_client_inserts_per_thread, FLAGS_client_num_batches_per_thread,
+      vector<CountDownLatch*>()));
+  ASSERT_ALL_REPLICAS_AGREE(FLAGS_client_inserts_per_thread);
+}
+
     }  // namespace tserver
 }  // namespace yb
@@ -628,6 +628,72 @@ void AsyncCopartitionTable::HandleResponse(int attempt) {
   LOG(INFO) << "master can't handle server responses yet";
 }
 
+// ============================================================================
+//  Class AsyncAddTableToTablet.
+// ============================================================================
+AsyncAddTableToTablet::AsyncAddTableToTablet(Master *master,
+                                             ThreadPool* callback_pool,
+                                             const scoped_refptr<TabletInfo>& tablet,
+                                             const scoped_refptr<TableInfo>& table)
+    : RetryingTSRpcTask(master,
+                        callback_pool,
+                        gscoped_ptr<TSPicker>(new PickLeaderReplica(tablet)),
+                        table.get()),
+      tablet_(tablet) {
+}
+
+string AsyncAddTableToTablet::description() const {
+  return tablet_->ToString() + " Add Table to Tablet RPC for table " + table_->ToString();
+}
+
+TabletId AsyncAddTableToTablet::tablet_id() const {
+  return tablet_->tablet_id();
+}
+
+TabletServerId AsyncAddTableToTablet::permanent_uuid() const {
+  return target_ts_desc_ != nullptr ? target_ts_desc_->permanent_uuid() : "";
+}
+
+bool AsyncAddTableToTablet::SendRequest(int attempt) {
+  auto l = table_->LockForRead();
+
+  tserver::ChangeMetadataRequestPB req;
+  req.set_dest_uuid(permanent_uuid());
+  req.set_tablet_id(tablet_->tablet_id());
+  req.set_propagated_hybrid_time(master_->clock()->Now().ToUint64());
+  auto& add_table = *req.mutable_add_table();
+  add_table.set_table_id(table_->id());
+  add_table.set_table_name(l->data().pb.name());
+  add_table.set_table_type(l->data().pb.table_type());
+  add_table.mutable_schema()->CopyFrom(l->data().pb.schema());
+  add_table.set_schema_version(l->data().pb.version());
+  add_table.mutable_partition_schema()->CopyFrom(l->data().pb.partition_schema());
+
+  l->Unlock();
+
+  ts_admin_proxy_->AlterSchemaAsync(req, &resp_, &rpc_, BindRpcCallback());
+  VLOG(1) << "Send add table to tablet request to " << permanent_uuid()
+          << " (attempt " << attempt << "):\n"
+          << req.DebugString();
+  return true;
+}
+
+void AsyncAddTableToTablet::HandleResponse(int attempt) {
+  if (resp_.has_error()) {
+    // The shared tablet could still be being created when the first colocated table is added to
+    // it, so all errors are retried until the deadline.
+    LOG(WARNING) << "TS " << permanent_uuid() << ": add table " << table_->ToString()
+                 << " failed for tablet " << tablet_->ToString() << ": "
+                 << StatusFromPB(resp_.error().status()).ToString();
+  } else {
+    TransitionToTerminalState(MonitoredTaskState::kRunning, MonitoredTaskState::kComplete);
+    VLOG(1) << "TS " << permanent_uuid() << ": added table " << table_->ToString()
+            << " to tablet " << tablet_->ToString();
+  }
+
+  server::UpdateClock(resp_, master_->clock());
+}
+
 // ============================================================================
 //  Class AsyncTruncate.
 // ============================================================================
@@ -360,6 +360,35 @@ class AsyncCopartitionTable : public RetryingTSRpcTask {
   tserver::CopartitionTableResponsePB resp_;
 };
 
+// Add a colocated table to the tablet shared by the tables of its namespace.
+//
+// The tablet server responds successfully if the table was already added, so the request is
+// retried until it succeeds.
+class AsyncAddTableToTablet : public RetryingTSRpcTask {
+ public:
+  AsyncAddTableToTablet(Master *master,
+                        ThreadPool* callback_pool,
+                        const scoped_refptr<TabletInfo>& tablet,
+                        const scoped_refptr<TableInfo>& table);
+
+  Type type() const override { return ASYNC_ADD_TABLE_TO_TABLET; }
+
+  std::string type_name() const override { return "Add Table to Tablet"; }
+
+  std::string description() const override;
+
+ private:
+  TabletId tablet_id() const override;
+
+  TabletServerId permanent_uuid() const;
+
+  void HandleResponse(int attempt) override;
+  bool SendRequest(int attempt) override;
+
+  scoped_refptr<TabletInfo> tablet_;
+  tserver::ChangeMetadataResponsePB resp_;
+};
+
 // Send a Truncate() RPC request.
 class AsyncTruncate : public RetryingTSRpcTask {
  public:
@@ -57,6 +57,40 @@ string TabletReplica::ToString() const {
                 consensus::RaftPeerPB_Role_Name(role));
 }
 
+// ================================================================================================
+// ShardedTabletInfoMap
+// ================================================================================================
+
+TabletInfoPtr ShardedTabletInfoMap::Find(const TabletId& tablet_id) const {
+  auto& shard = ShardFor(tablet_id);
+  shared_lock<rw_spinlock> l(shard.lock);
+  auto it = shard.tablets.find(tablet_id);
+  return it == shard.tablets.end() ? nullptr : it->second;
+}
+
+void ShardedTabletInfoMap::Set(const TabletInfoPtr& tablet) {
+  auto& shard = ShardFor(tablet->tablet_id());
+  std::lock_guard<rw_spinlock> l(shard.lock);
+  shard.tablets[tablet->tablet_id()] = tablet;
+}
+
+void ShardedTabletInfoMap::Erase(const TabletId& tablet_id) {
+  auto& shard = ShardFor(tablet_id);
+  std::lock_guard<rw_spinlock> l(shard.lock);
+  shard.tablets.erase(tablet_id);
+}
+
+void ShardedTabletInfoMap::Clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<rw_spinlock> l(shard.lock);
+    shard.tablets.clear();
+  }
+}
+
+ShardedTabletInfoMap::Shard& ShardedTabletInfoMap::ShardFor(const TabletId& tablet_id) const {
+  return shards_[std::hash<TabletId>()(tablet_id) % kNumShards];
+}
+
 // ================================================================================================
 // TabletInfo
 // ================================================================================================
@@ -74,6 +108,7 @@ void TabletInfo::SetReplicaLocations(ReplicaMap replica_locations) {
   std::lock_guard<simple_spinlock> l(lock_);
   last_update_time_ = MonoTime::Now();
   replica_locations_ = std::move(replica_locations);
+  ++replica_locations_version_;
 }
 
 void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
@@ -83,7 +118,32 @@ void TabletInfo::GetReplicaLocations(ReplicaMap* replica_locations) const {
 
 bool TabletInfo::AddToReplicaLocations(const TabletReplica& replica) {
   std::lock_guard<simple_spinlock> l(lock_);
-  return InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica);
+  if (!InsertIfNotPresent(&replica_locations_, replica.ts_desc->permanent_uuid(), replica)) {
+    return false;
+  }
+  ++replica_locations_version_;
+  return true;
+}
+
+uint64_t TabletInfo::replica_locations_version() const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  return replica_locations_version_;
+}
+
+std::shared_ptr<const TabletLocationsPB> TabletInfo::GetCachedLocations(
+    const TabletLocationsVersion& version) const {
+  std::lock_guard<simple_spinlock> l(lock_);
+  if (!(cached_locations_version_ == version)) {
+    return nullptr;
+  }
+  return cached_locations_;
+}
+
+void TabletInfo::SetCachedLocations(
+    std::shared_ptr<const TabletLocationsPB> locations, const TabletLocationsVersion& version) {
+  std::lock_guard<simple_spinlock> l(lock_);
+  cached_locations_ = std::move(locations);
+  cached_locations_version_ = version;
 }
 
 void TabletInfo::set_last_update_time(const MonoTime& ts) {
@@ -189,6 +249,11 @@ bool TableInfo::is_unique_index() const {
   return l->data().pb.is_unique_index();
 }
 
+bool TableInfo::colocated() const {
+  auto l = LockForRead();
+  return l->data().pb.colocated();
+}
+
 TableType TableInfo::GetTableType() const {
   auto l = LockForRead();
   return l->data().pb.table_type();
@@ -414,6 +479,10 @@ DeletedTableInfo::DeletedTableInfo(const TableInfo* table) : table_id_(table->id
   table->GetAllTablets(&tablets);
 
   for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+    // The tablet of a colocated table is owned by the parent table of its namespace.
+    if (tablet->table()->id() != table_id_) {
+      continue;
+    }
     auto tablet_lock = tablet->LockForRead();
     TabletInfo::ReplicaMap replica_locations;
     tablet->GetReplicaLocations(&replica_locations);
@@ -463,6 +532,11 @@ YQLDatabase NamespaceInfo::database_type() const {
   return l->data().pb.database_type();
 }
 
+bool NamespaceInfo::colocated() const {
+  auto l = LockForRead();
+  return l->data().pb.colocated();
+}
+
 std::string NamespaceInfo::ToString() const {
   return Substitute("$0 [id=$1]", name(), namespace_id_);
 }
@@ -35,7 +35,9 @@
 
 #include <shared_mutex>
 
+#include <array>
 #include <mutex>
+#include <unordered_map>
 
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/master.pb.h"
@@ -149,6 +151,21 @@ class TableInfo;
 
 typedef std::unordered_map<TabletServerId, MonoTime> LeaderStepDownFailureTimes;
 
+// Versions of the data the locations of a tablet are built from.
+struct TabletLocationsVersion {
+  // Version of the tablet metadata.
+  uint64_t metadata = 0;
+  // Version of the replica locations of the tablet.
+  uint64_t replica_locations = 0;
+  // Version of the tablet server registrations, see TSManager::registration_version.
+  uint64_t ts_registrations = 0;
+
+  bool operator==(const TabletLocationsVersion& rhs) const {
+    return metadata == rhs.metadata && replica_locations == rhs.replica_locations &&
+           ts_registrations == rhs.ts_registrations;
+  }
+};
+
 // The information about a single tablet which exists in the cluster,
 // including its state and locations.
 //
@@ -187,6 +204,16 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // Returns true iff the replica was inserted.
   bool AddToReplicaLocations(const TabletReplica& replica);
 
+  // Incremented each time the replica locations change.
+  uint64_t replica_locations_version() const;
+
+  // Returns the locations stored by SetCachedLocations, or nullptr if they were built from an
+  // other version of the data.
+  std::shared_ptr<const TabletLocationsPB> GetCachedLocations(
+      const TabletLocationsVersion& version) const;
+  void SetCachedLocations(
+      std::shared_ptr<const TabletLocationsPB> locations, const TabletLocationsVersion& version);
+
   // Accessors for the last time the replica locations were updated.
   void set_last_update_time(const MonoTime& ts);
   MonoTime last_update_time() const;
@@ -231,6 +258,13 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
   // Reported schema version (in-memory only).
   uint32_t reported_schema_version_ = 0;
 
+  uint64_t replica_locations_version_ = 0;
+
+  // Locations of this tablet last built by the catalog manager and the version of the data they
+  // were built from.
+  std::shared_ptr<const TabletLocationsPB> cached_locations_;
+  TabletLocationsVersion cached_locations_version_;
+
   LeaderStepDownFailureTimes leader_stepdown_failure_times_;
 
   DISALLOW_COPY_AND_ASSIGN(TabletInfo);
@@ -239,6 +273,36 @@ class TabletInfo : public RefCountedThreadSafe<TabletInfo>,
 typedef scoped_refptr<TabletInfo> TabletInfoPtr;
 typedef std::vector<TabletInfoPtr> TabletInfos;
 
+// Tablets by id, split into shards with their own locks. Lookups by concurrent tablet reports and
+// location requests only lock one shard, so they neither contend with each other nor with DDL
+// holding the catalog manager lock.
+//
+// The catalog manager mirrors every change of its tablet map here, while holding its lock.
+class ShardedTabletInfoMap {
+ public:
+  // Returns nullptr if there is no such tablet.
+  TabletInfoPtr Find(const TabletId& tablet_id) const;
+
+  // Adds the tablet, or replaces the tablet with the same id.
+  void Set(const TabletInfoPtr& tablet);
+
+  void Erase(const TabletId& tablet_id);
+
+  void Clear();
+
+ private:
+  struct Shard {
+    mutable rw_spinlock lock;
+    std::unordered_map<TabletId, TabletInfoPtr> tablets;
+  };
+
+  static constexpr size_t kNumShards = 32;
+
+  Shard& ShardFor(const TabletId& tablet_id) const;
+
+  mutable std::array<Shard, kNumShards> shards_;
+};
+
 // The data related to a table which is persisted on disk.
 // This portion of TableInfo is managed via CowObject.
 // It wraps the underlying protobuf to add useful accessors.
@@ -310,6 +374,9 @@ class TableInfo : public RefCountedThreadSafe<TableInfo>,
   bool is_local_index() const;
   bool is_unique_index() const;
 
+  // Whether the table is stored in the tablet shared by its colocated database.
+  bool colocated() const;
+
   // Return the table type of the table.
   TableType GetTableType() const;
 
@@ -446,6 +513,9 @@ class NamespaceInfo : public RefCountedThreadSafe<NamespaceInfo>,
 
   YQLDatabase database_type() const;
 
+  // Whether the tables of the namespace are stored in a single shared tablet.
+  bool colocated() const;
+
   std::string ToString() const override;
 
  private:
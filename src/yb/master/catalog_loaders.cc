@@ -89,6 +89,7 @@ Status TabletLoader::Visit(const TabletId& tablet_id, const SysTabletsEntryPB& m
     return STATUS_FORMAT(
         IllegalState, "Loaded tablet that already in map: $0", tablet->tablet_id());
   }
+  catalog_manager_->sharded_tablet_map_.Set(tablet);
 
   std::vector<TableId> table_ids;
   for (int k = 0; k < metadata.table_ids_size(); ++k) {
@@ -100,6 +100,80 @@ TEST(TableInfoTest, TestAssignmentRanges) {
   }
 }
 
+TEST(TabletInfoTest, TestCachedLocations) {
+  scoped_refptr<TableInfo> table(new TableInfo(CURRENT_TEST_NAME()));
+  vector<scoped_refptr<TabletInfo>> tablets;
+  CreateTable({}, 1, false, table.get(), &tablets);
+  auto& tablet = tablets[0];
+
+  TabletLocationsVersion version;
+  version.metadata = tablet->metadata().version();
+  version.replica_locations = tablet->replica_locations_version();
+  ASSERT_EQ(nullptr, tablet->GetCachedLocations(version));
+
+  auto locations = std::make_shared<TabletLocationsPB>();
+  locations->set_tablet_id(tablet->tablet_id());
+  tablet->SetCachedLocations(locations, version);
+  ASSERT_EQ(locations, tablet->GetCachedLocations(version));
+
+  // Locations are stale after the tablet servers registrations change.
+  auto ts_version = version;
+  ++ts_version.ts_registrations;
+  ASSERT_EQ(nullptr, tablet->GetCachedLocations(ts_version));
+
+  // After the replica locations change.
+  TabletReplica replica;
+  NewReplica(SetupTS("0000", "a").get(), tablet::RUNNING, consensus::RaftPeerPB::LEADER,
+             &replica);
+  ASSERT_TRUE(tablet->AddToReplicaLocations(replica));
+  ASSERT_NE(version.replica_locations, tablet->replica_locations_version());
+  version.replica_locations = tablet->replica_locations_version();
+  ASSERT_EQ(nullptr, tablet->GetCachedLocations(version));
+  tablet->SetCachedLocations(locations, version);
+  ASSERT_EQ(locations, tablet->GetCachedLocations(version));
+
+  // Adding an already known replica does not change the locations.
+  ASSERT_FALSE(tablet->AddToReplicaLocations(replica));
+  ASSERT_EQ(version.replica_locations, tablet->replica_locations_version());
+
+  // And after the tablet metadata changes.
+  {
+    auto l = tablet->LockForWrite();
+    l->mutable_data()->set_state(SysTabletsEntryPB::REPLACED, "Replaced");
+    l->Commit();
+  }
+  ASSERT_NE(version.metadata, tablet->metadata().version());
+}
+
+TEST(ShardedTabletInfoMapTest, TestFindSetErase) {
+  scoped_refptr<TableInfo> table(new TableInfo(CURRENT_TEST_NAME()));
+  vector<scoped_refptr<TabletInfo>> tablets;
+  CreateTable({"a", "b", "c"}, 1, false, table.get(), &tablets);
+
+  ShardedTabletInfoMap map;
+  for (const auto& tablet : tablets) {
+    ASSERT_EQ(nullptr, map.Find(tablet->tablet_id()));
+    map.Set(tablet);
+  }
+  for (const auto& tablet : tablets) {
+    ASSERT_EQ(tablet.get(), map.Find(tablet->tablet_id()).get());
+  }
+
+  // Replacing a tablet with the same id.
+  scoped_refptr<TabletInfo> replacement(new TabletInfo(table, tablets[0]->tablet_id()));
+  map.Set(replacement);
+  ASSERT_EQ(replacement.get(), map.Find(tablets[0]->tablet_id()).get());
+
+  map.Erase(tablets[1]->tablet_id());
+  ASSERT_EQ(nullptr, map.Find(tablets[1]->tablet_id()));
+  ASSERT_EQ(tablets[2].get(), map.Find(tablets[2]->tablet_id()).get());
+
+  map.Clear();
+  for (const auto& tablet : tablets) {
+    ASSERT_EQ(nullptr, map.Find(tablet->tablet_id()));
+  }
+}
+
 TEST(TestTSDescriptor, TestReplicaCreationsDecay) {
   TSDescriptor ts("test");
   ASSERT_EQ(0, ts.RecentReplicaCreations());
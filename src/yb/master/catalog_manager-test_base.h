@@ -81,9 +81,12 @@ void NewReplica(
   replica->ts_desc = ts_desc;
   replica->state = state;
   replica->role = role;
+  replica->member_type = role == consensus::RaftPeerPB::READ_REPLICA
+      ? consensus::RaftPeerPB::OBSERVER : consensus::RaftPeerPB::VOTER;
 }
 
-std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
+std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az,
+                                      const string& placement_uuid = "") {
   NodeInstancePB node;
   node.set_permanent_uuid(uuid);
 
@@ -96,6 +99,9 @@ std::shared_ptr<TSDescriptor> SetupTS(const string& uuid, const string& az) {
   ci->set_placement_cloud(default_cloud);
   ci->set_placement_region(default_region);
   ci->set_placement_zone(az);
+  if (!placement_uuid.empty()) {
+    reg.mutable_common()->set_placement_uuid(placement_uuid);
+  }
 
   std::shared_ptr<TSDescriptor> ts(new YB_EDITION_NS_PREFIX TSDescriptor(node.permanent_uuid()));
   CHECK_OK(ts->Register(node, reg, CloudInfoPB(), nullptr));
@@ -170,6 +176,12 @@ class TestLoadBalancerBase {
     PrepareTestState(ts_descs_multi_az);
     TestBalancingLeaders();
 
+    PrepareTestState(ts_descs_multi_az);
+    TestLeaderAffinity();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestBalancingLeadersByTabletLoad();
+
     PrepareTestState(ts_descs_single_az);
     TestMissingPlacementSingleAz();
 
@@ -179,6 +191,9 @@ class TestLoadBalancerBase {
 
     PrepareTestState(ts_descs_multi_az);
     TestLeaderOverReplication();
+
+    PrepareTestState(ts_descs_multi_az);
+    TestReadReplicaPlacement();
   }
 
  protected:
@@ -486,6 +501,57 @@ class TestLoadBalancerBase {
     ASSERT_EQ(0, cb_->get_total_over_replication());
   }
 
+  void TestReadReplicaPlacement() {
+    LOG(INFO) << "Testing with a read replica cluster";
+    replication_info_.mutable_live_replicas()->set_num_replicas(kNumReplicas);
+    auto* read_replica_placement = replication_info_.add_read_replicas();
+    read_replica_placement->set_num_replicas(1);
+    read_replica_placement->set_placement_uuid("read_replica");
+
+    // Add two empty tablet servers of the read replica cluster.
+    ts_descs_.push_back(SetupTS("3333", "a", "read_replica"));
+    ts_descs_.push_back(SetupTS("4444", "b", "read_replica"));
+
+    // Live replicas are not moved to the read replica cluster, even though it has less load.
+    SetCluster(ReplicaType::kLive, PlacementInfoPB());
+    ASSERT_OK(AnalyzeTablets());
+    string placeholder;
+    ASSERT_FALSE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &placeholder)));
+    ASSERT_EQ(0, cb_->get_total_under_replication());
+
+    // Every tablet is missing its read replica, added as an observer in the read replica cluster.
+    SetCluster(ReplicaType::kReadReplica, *read_replica_placement);
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(0, cb_->get_total_running_tablets());
+    const int num_tablets = tablets_.size();
+    ASSERT_EQ(num_tablets, cb_->get_total_under_replication());
+    ASSERT_EQ(consensus::RaftPeerPB::PRE_OBSERVER, cb_->GetDefaultMemberType());
+    std::set<TabletServerId> used_ts;
+    for (int i = 0; i != num_tablets; ++i) {
+      TabletServerId to_ts;
+      ASSERT_TRUE(ASSERT_RESULT(HandleAddReplicas(&placeholder, &placeholder, &to_ts)));
+      ASSERT_TRUE(to_ts == "3333" || to_ts == "4444") << to_ts;
+      used_ts.insert(to_ts);
+    }
+    ASSERT_EQ(2, used_ts.size());
+    ASSERT_EQ(0, cb_->get_total_under_replication());
+
+    // Once the observers are running, they are not counted against the live replicas.
+    for (int i = 0; i != num_tablets; ++i) {
+      AddRunningReplica(tablets_[i].get(), ts_descs_[3 + i % 2], false /* is_live */);
+    }
+    SetCluster(ReplicaType::kLive, PlacementInfoPB());
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+    ASSERT_EQ(consensus::RaftPeerPB::PRE_VOTER, cb_->GetDefaultMemberType());
+
+    SetCluster(ReplicaType::kReadReplica, *read_replica_placement);
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_EQ(num_tablets, cb_->get_total_running_tablets());
+    ASSERT_EQ(0, cb_->get_total_under_replication());
+    ASSERT_EQ(0, cb_->get_total_over_replication());
+  }
+
   void TestWithMissingTabletServers() {
     LOG(INFO) << "Testing with missing tablet servers";
     SetupClusterConfig({"a"}, &replication_info_);
@@ -668,6 +734,90 @@ class TestLoadBalancerBase {
     ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
   }
 
+  void TestLeaderAffinity() {
+    LOG(INFO) << "Testing moving leaders to the preferred zones";
+    // Prefer zone c, then zone b.
+    for (const string& zone : {"c", "b"}) {
+      auto* cloud_info = replication_info_.add_multi_affinitized_leaders()->add_zones();
+      cloud_info->set_placement_cloud(default_cloud);
+      cloud_info->set_placement_region(default_region);
+      cloud_info->set_placement_zone(zone);
+    }
+    for (const auto tablet : tablets_) {
+      MoveTabletLeader(tablet.get(), ts_descs_[0]);
+    }
+    LOG(INFO) << "Leader distribution: 4 0 0";
+
+    ASSERT_OK(AnalyzeTablets());
+
+    // All leaders should move from ts0 to ts2, the only tablet server in zone c.
+    string placeholder;
+    std::set<TabletId> moved_tablets;
+    for (int i = 0; i < tablets_.size(); ++i) {
+      string tablet_id;
+      TestMoveLeader(&tablet_id, ts_descs_[0]->permanent_uuid(), ts_descs_[2]->permanent_uuid());
+      moved_tablets.insert(tablet_id);
+    }
+    ASSERT_EQ(tablets_.size(), moved_tablets.size());
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    // With ts2 blacklisted, zone b is the most preferred zone with a tablet server for leaders.
+    blacklist_.add_hosts()->set_host(ts_descs_[2]->permanent_uuid());
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    for (int i = 0; i < tablets_.size(); ++i) {
+      TestMoveLeader(&placeholder, ts_descs_[0]->permanent_uuid(), ts_descs_[1]->permanent_uuid());
+    }
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+  }
+
+  void TestBalancingLeadersByTabletLoad() {
+    LOG(INFO) << "Testing moving leaders weighted by their tablet load";
+    // Leaders of tablets 0 and 3 are on ts0 and serve all the ops.
+    LOG(INFO) << "Leader distribution: 2 1 1";
+    TServerMetricsPB metrics;
+    for (int i = 0; i < tablets_.size(); ++i) {
+      auto* tablet_load = metrics.add_tablet_loads();
+      tablet_load->set_tablet_id(tablets_[i]->tablet_id());
+      tablet_load->set_read_ops_per_sec(i % 3 == 0 ? 400 : 0);
+    }
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->UpdateMetrics(metrics);
+    }
+
+    string placeholder, tablet_id;
+    // Unweighted, the distribution is as balanced as it can be.
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    // Weighted, leader loads are 3 0.5 0.5, so a hot leader should move off ts0. The loads are
+    // 1.5 2 0.5 after that, which is balanced enough.
+    FLAGS_load_balancer_use_tablet_load = true;
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    TestMoveLeader(&tablet_id, ts_descs_[0]->permanent_uuid(), "");
+    ASSERT_TRUE(tablet_id == tablets_[0]->tablet_id() || tablet_id == tablets_[3]->tablet_id())
+        << tablet_id;
+    ASSERT_FALSE(ASSERT_RESULT(HandleLeaderMoves(&placeholder, &placeholder, &placeholder)));
+
+    // The stepdown was not applied, so the next run finds the same distribution. The leader it
+    // already moved is in its cooldown, so the other hot leader should be moved instead.
+    ResetState();
+    ASSERT_OK(AnalyzeTablets());
+    string moved_tablet_id;
+    TestMoveLeader(&moved_tablet_id, ts_descs_[0]->permanent_uuid(), "");
+    ASSERT_NE(tablet_id, moved_tablet_id);
+
+    ASSERT_FALSE(cb_->GetRecentMoves().empty());
+    ASSERT_EQ(moved_tablet_id, cb_->GetRecentMoves().back().tablet_id);
+
+    FLAGS_load_balancer_use_tablet_load = false;
+    for (const auto& ts_desc : ts_descs_) {
+      ts_desc->ClearMetrics();
+    }
+  }
+
   void TestBalancingLeadersWithThreshold() {
     LOG(INFO) << "Testing moving overloaded leaders with threshold = 2";
     // Move all leaders to ts0.
@@ -859,7 +1009,8 @@ class TestLoadBalancerBase {
 
     TabletReplica replica;
     NewReplica(ts_desc.get(), tablet::RaftGroupStatePB::RUNNING,
-               consensus::RaftPeerPB::FOLLOWER, &replica);
+               is_live ? consensus::RaftPeerPB::FOLLOWER : consensus::RaftPeerPB::READ_REPLICA,
+               &replica);
     InsertOrDie(&replicas, ts_desc->permanent_uuid(), replica);
     tablet->SetReplicaLocations(replicas);
   }
@@ -886,6 +1037,17 @@ class TestLoadBalancerBase {
     tablet->SetReplicaLocations(replicas);
   }
 
+  // Recreates the load state for balancing the specified cluster.
+  void SetCluster(ReplicaType replica_type, const PlacementInfoPB& read_replica_placement) {
+    ResetState();
+    std::set<std::string> read_replica_placement_uuids;
+    for (const auto& placement : replication_info_.read_replicas()) {
+      read_replica_placement_uuids.insert(placement.placement_uuid());
+    }
+    cb_->state_->SetCluster(
+        replica_type, read_replica_placement, std::move(read_replica_placement_uuids));
+  }
+
   // Clear the tablets_added_ field from the state, used for testing.
   void ClearTabletsAddedForTest() {
     cb_->state_->tablets_added_.clear();
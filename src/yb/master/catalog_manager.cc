@@ -66,6 +66,7 @@
 #include <vector>
 
 #include <glog/logging.h>
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/optional.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include "yb/common/common_flags.h"
@@ -94,6 +95,7 @@
 #include "yb/master/master_util.h"
 #include "yb/master/system_tablet.h"
 #include "yb/master/sys_catalog.h"
+#include "yb/master/tablet_split_manager.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/ts_manager.h"
 #include "yb/master/async_rpc_tasks.h"
@@ -243,6 +245,16 @@ DEFINE_bool(
 DEFINE_test_flag(int32, simulate_slow_system_tablet_bootstrap_secs, 0,
     "Simulates a slow tablet bootstrap by adding a sleep before system tablet init.");
 
+DEFINE_bool(master_cache_tablet_locations, true,
+    "Whether to keep the locations built for a tablet, to answer location requests without "
+    "rebuilding them until the tablet, its replicas or the tablet servers change.");
+TAG_FLAG(master_cache_tablet_locations, advanced);
+
+DEFINE_int32(master_tablet_report_write_batch_size, 128,
+    "Maximum number of tablets from a single tablet report whose new state is written to the "
+    "sys catalog in one write.");
+TAG_FLAG(master_tablet_report_write_batch_size, advanced);
+
 namespace yb {
 namespace master {
 
@@ -379,6 +391,7 @@ CatalogManager::CatalogManager(Master* master)
       leader_ready_term_(-1),
       leader_lock_(RWMutex::Priority::PREFER_WRITING),
       load_balance_policy_(new YB_EDITION_NS_PREFIX ClusterLoadBalancer(this)),
+      tablet_split_manager_(std::make_unique<TabletSplitManager>(this)),
       permissions_manager_(std::make_unique<PermissionsManager>(this)) {
   yb::InitCommonFlags();
   CHECK_OK(ThreadPoolBuilder("leader-initialization")
@@ -513,6 +526,7 @@ void CatalogManager::LoadSysCatalogDataTask() {
     }
   }
 
+  partitions_version_.fetch_add(1, std::memory_order_acq_rel);
   std::lock_guard<simple_spinlock> l(state_lock_);
   leader_ready_term_ = term;
   LOG(INFO) << "Completed load of sys catalog in term " << term;
@@ -619,6 +633,7 @@ Status CatalogManager::RunLoaders() {
   table_names_map_.clear();
   table_ids_map_.clear();
   tablet_map_.clear();
+  sharded_tablet_map_.Clear();
 
   // Clear the namespace mappings.
   namespace_ids_map_.clear();
@@ -643,52 +658,22 @@ Status CatalogManager::RunLoaders() {
     ts_desc->set_has_tablet_report(false);
   }
 
-  // Visit tables and tablets, load them into memory.
-  // TODO(hector): Refactor this code.
-  LOG(INFO) << __func__ << ": Loading tables into memory.";
-  unique_ptr<TableLoader> table_loader(new TableLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(table_loader.get()), "Failed while visiting tables in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading tablets into memory.";
-  unique_ptr<TabletLoader> tablet_loader(new TabletLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(tablet_loader.get()), "Failed while visiting tablets in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading namespaces into memory.";
-  unique_ptr<NamespaceLoader> namespace_loader(new NamespaceLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(namespace_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading user-defined types into memory.";
-  unique_ptr<UDTypeLoader> udtype_loader(new UDTypeLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(udtype_loader.get()),
-      "Failed while visiting namespaces in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading cluster configuration into memory.";
-  unique_ptr<ClusterConfigLoader> config_loader(new ClusterConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(config_loader.get()), "Failed while visiting config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading roles into memory.";
-  unique_ptr<RoleLoader> role_loader(new RoleLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(role_loader.get()),
-      "Failed while visiting roles in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading Redis config into memory.";
-  unique_ptr<RedisConfigLoader> redis_config_loader(new RedisConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(redis_config_loader.get()),
-      "Failed while visiting redis config in sys catalog");
-
-  LOG(INFO) << __func__ << ": Loading sys config into memory.";
-  unique_ptr<SysConfigLoader> sys_config_loader(new SysConfigLoader(this));
-  RETURN_NOT_OK_PREPEND(
-      sys_catalog_->Visit(sys_config_loader.get()),
-      "Failed while visiting sys config in sys catalog");
+  // Load all entities into memory with a single scan of the sys catalog. Entries are ordered by
+  // type, so tables are loaded before the tablets that refer to them.
+  LOG(INFO) << __func__ << ": Loading sys catalog entries into memory.";
+  TableLoader table_loader(this);
+  TabletLoader tablet_loader(this);
+  NamespaceLoader namespace_loader(this);
+  UDTypeLoader udtype_loader(this);
+  ClusterConfigLoader config_loader(this);
+  RoleLoader role_loader(this);
+  RedisConfigLoader redis_config_loader(this);
+  SysConfigLoader sys_config_loader(this);
+  RETURN_NOT_OK(sys_catalog_->Visit(std::vector<VisitorBase*>{
+      &table_loader, &tablet_loader, &namespace_loader, &udtype_loader, &config_loader,
+      &role_loader, &redis_config_loader, &sys_config_loader}));
+  LOG(INFO) << __func__ << ": Loaded " << table_ids_map_.size() << " tables and "
+            << tablet_map_.size() << " tablets.";
 
   return Status::OK();
 }
@@ -910,6 +895,7 @@ Status CatalogManager::PrepareSysCatalogTable(int64_t term) {
     table->AddTablet(tablet.get());
 
     tablet_map_[tablet->tablet_id()] = tablet;
+    sharded_tablet_map_.Set(tablet);
 
     RETURN_NOT_OK(sys_catalog_->AddItem(tablet.get(), term));
     tablet->mutable_metadata()->CommitMutation();
@@ -1261,6 +1247,7 @@ Status CatalogManager::AbortTableCreation(TableInfo* table,
   for (const TabletId& tablet_id_to_erase : tablet_ids_to_erase) {
     CHECK_EQ(tablet_map_.erase(tablet_id_to_erase), 1)
         << "Unable to erase tablet " << tablet_id_to_erase << " from tablet map.";
+    sharded_tablet_map_.Erase(tablet_id_to_erase);
   }
 
   CHECK_EQ(table_names_map_.erase({table_namespace_id, table_name}), 1)
@@ -1273,12 +1260,12 @@ Status CatalogManager::AbortTableCreation(TableInfo* table,
 
 Status CatalogManager::ValidateTableReplicationInfo(const ReplicationInfoPB& replication_info) {
   // TODO(bogdan): add the actual subset rules, instead of just erroring out as not supported.
+  // Only the preferred zones for the leaders could be set per table.
   const auto& live_placement_info = replication_info.live_replicas();
   if (!(live_placement_info.placement_blocks().empty() &&
         live_placement_info.num_replicas() <= 0 &&
         live_placement_info.placement_uuid().empty()) ||
-      !replication_info.read_replicas().empty() ||
-      !replication_info.affinitized_leaders().empty()) {
+      !replication_info.read_replicas().empty()) {
     return STATUS(
         InvalidArgument,
         "Unsupported: cannot set table level replication info yet.");
@@ -1399,8 +1386,111 @@ Status CatalogManager::CreateCopartitionedTable(const CreateTableRequestPB req,
   return Status::OK();
 }
 
+Status CatalogManager::CreateColocatedUserTable(const CreateTableRequestPB& req,
+                                                CreateTableResponsePB* resp,
+                                                rpc::RpcContext* rpc,
+                                                const Schema& schema,
+                                                const PartitionSchema& partition_schema,
+                                                const NamespaceId& namespace_id,
+                                                IndexInfoPB* index_info) {
+  const char* const object_type = req.indexed_table_id().empty() ? "table" : "index";
+
+  scoped_refptr<TableInfo> table;
+  scoped_refptr<TabletInfo> tablet;
+  {
+    std::lock_guard<LockType> l(lock_);
+    TRACE("Acquired catalog manager lock");
+
+    const TableId parent_table_id = namespace_id + kColocatedParentTableIdSuffix;
+    scoped_refptr<TableInfo> parent_table = FindPtrOrNull(table_ids_map_, parent_table_id);
+    if (parent_table == nullptr) {
+      Status s = STATUS(NotFound, "The parent table of the colocated namespace does not exist",
+                        parent_table_id);
+      return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, s);
+    }
+    TabletInfos parent_tablets;
+    parent_table->GetAllTablets(&parent_tablets);
+    if (parent_tablets.size() != 1) {
+      Status s = STATUS_FORMAT(IllegalState, "Expected 1 tablet for $0, found $1",
+                               parent_table->ToString(), parent_tablets.size());
+      return SetupError(resp->mutable_error(), MasterErrorPB::UNKNOWN_ERROR, s);
+    }
+    tablet = parent_tablets[0];
+
+    // Verify that the table does not exist.
+    table = FindPtrOrNull(table_ids_map_, req.table_id());
+    if (table != nullptr) {
+      resp->set_table_id(table->id());
+      Status s = STATUS_SUBSTITUTE(AlreadyPresent,
+          "Object '$0.$1' already exists", GetNamespaceNameUnlocked(table), table->name());
+      return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_ALREADY_PRESENT, s);
+    }
+
+    RETURN_NOT_OK(CreateTableInMemory(req, schema, partition_schema, false /* create_tablets */,
+                                      namespace_id, {} /* partitions */, index_info,
+                                      nullptr /* tablets */, resp, &table));
+    table->mutable_metadata()->mutable_dirty()->pb.set_colocated(true);
+
+    auto tablet_lock = tablet->LockForWrite();
+    tablet_lock->mutable_data()->pb.add_table_ids(table->id());
+    table->AddTablet(tablet.get());
+
+    RETURN_NOT_OK(sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_));
+    tablet_lock->Commit();
+  }
+  TRACE("Inserted new table info into CatalogManager maps");
+
+  // Update the on-disk table state to "running".
+  table->mutable_metadata()->mutable_dirty()->pb.set_state(SysTablesEntryPB::RUNNING);
+  Status s = sys_catalog_->AddItem(table.get(), leader_ready_term_);
+  if (PREDICT_FALSE(!s.ok())) {
+    return AbortTableCreation(table.get(), {}, s.CloneAndPrepend(
+        Substitute("An error occurred while inserting to sys-tablets: $0", s.ToString())), resp);
+  }
+  TRACE("Wrote table to system table");
+
+  // Commit the in-memory state.
+  table->mutable_metadata()->CommitMutation();
+
+  // The table is not done being created until the shared tablet knows about it, see
+  // IsCreateTableDone().
+  SendAddTableToTabletRequest(tablet, table);
+
+  LOG(INFO) << "Successfully created colocated " << object_type << " " << table->ToString()
+            << " per request from " << RequestorString(rpc);
+  return Status::OK();
+}
+
+Status CatalogManager::CreateColocatedParentTable(const NamespaceId& namespace_id,
+                                                  rpc::RpcContext* rpc) {
+  CreateTableRequestPB req;
+  CreateTableResponsePB resp;
+  req.set_table_id(namespace_id + kColocatedParentTableIdSuffix);
+  req.set_name(namespace_id + kColocatedParentTableNameSuffix);
+  req.set_table_type(PGSQL_TABLE_TYPE);
+  req.mutable_namespace_()->set_id(namespace_id);
+  req.set_num_tablets(1);
+  req.mutable_partition_schema()->mutable_range_schema();
+
+  // The parent table only owns the shared tablet, its rows are never read or written. The tablet is
+  // transactional because the colocated tables are.
+  ColumnSchema key(kRedisKeyColumnName, BINARY, /* is_nullable */ false, /* is_hash_key */ false);
+  ColumnSchemaToPB(key, req.mutable_schema()->mutable_columns()->Add());
+  req.mutable_schema()->mutable_table_properties()->set_is_transactional(true);
+
+  Status s = CreateTable(&req, &resp, rpc);
+  if (!s.ok() && !s.IsAlreadyPresent()) {
+    return s.CloneAndPrepend("Error while creating colocated parent table");
+  }
+  return Status::OK();
+}
+
 namespace {
 
+bool IsColocatedParentTableId(const TableId& table_id) {
+  return boost::algorithm::ends_with(table_id, kColocatedParentTableIdSuffix);
+}
+
 CHECKED_STATUS ValidateCreateTableSchema(const Schema& schema, CreateTableResponsePB* resp) {
   if (schema.has_column_ids()) {
     return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_SCHEMA,
@@ -1790,6 +1880,13 @@ Status CatalogManager::CreateTable(const CreateTableRequestPB* orig_req,
       RETURN_NOT_OK(index_info_builder.ApplyColumnMapping(indexed_schema, schema));
     }
   }
+
+  if (ns->colocated() && req.table_type() == PGSQL_TABLE_TYPE &&
+      !IsColocatedParentTableId(req.table_id())) {
+    return CreateColocatedUserTable(req, resp, rpc, schema, partition_schema, namespace_id,
+                                    req.has_indexed_table_id() ? &index_info : nullptr);
+  }
+
   TSDescriptorVector all_ts_descs;
   master_->ts_manager()->GetAllLiveDescriptors(&all_ts_descs);
   s = CheckValidReplicationInfo(replication_info, all_ts_descs, partitions, resp);
@@ -1931,6 +2028,7 @@ Status CatalogManager::CreateTabletsFromTable(const vector<Partition>& partition
   table->AddTablets(*tablets);
   for (TabletInfo* tablet : *tablets) {
     InsertOrDie(&tablet_map_, tablet->tablet_id(), tablet);
+    sharded_tablet_map_.Set(tablet);
   }
   return Status::OK();
 }
@@ -2169,7 +2267,8 @@ Status CatalogManager::IsCreateTableDone(const IsCreateTableDoneRequestPB* req,
 
   // 2. Verify if the create is in-progress.
   TRACE("Verify if the table creation is in progress for $0", table->ToString());
-  resp->set_done(!table->IsCreateInProgress());
+  resp->set_done(!table->IsCreateInProgress() &&
+                 !table->HasTasks(MonitoredTask::ASYNC_ADD_TABLE_TO_TABLET));
 
   // 3. Set any current errors, if we are experiencing issues creating the table. This will be
   // bubbled up to the MasterService layer. If it is an error, it gets wrapped around in
@@ -2274,6 +2373,12 @@ TableInfo *CatalogManager::CreateTableInfo(const CreateTableRequestPB& req,
   metadata->set_version(0);
   metadata->set_next_column_id(ColumnId(schema.max_col_id() + 1));
   // TODO(bogdan): add back in replication_info once we allow overrides!
+  if (CatalogManagerUtil::HasLeaderAffinity(req.replication_info())) {
+    *metadata->mutable_replication_info()->mutable_affinitized_leaders() =
+        req.replication_info().affinitized_leaders();
+    *metadata->mutable_replication_info()->mutable_multi_affinitized_leaders() =
+        req.replication_info().multi_affinitized_leaders();
+  }
   // Use the Schema object passed in, since it has the column IDs already assigned,
   // whereas the user request PB does not.
   SchemaToPB(schema, metadata->mutable_schema());
@@ -2449,6 +2554,12 @@ Status CatalogManager::TruncateTable(const TableId& table_id,
         "The object '$0.$1' does not exist", GetNamespaceName(table), table->name());
     return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, s);
   }
+  if (l->data().pb.colocated()) {
+    // Truncating the shared tablet would remove the rows of all tables in the namespace.
+    Status s = STATUS_SUBSTITUTE(NotSupported, "Cannot truncate colocated $0 '$1.$2'",
+                                 table_type, GetNamespaceName(table), table->name());
+    return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_REQUEST, s);
+  }
 
   // Send a Truncate() request to each tablet in the table.
   SendTruncateTableRequest(table);
@@ -2578,6 +2689,7 @@ Status CatalogManager::DeleteTable(const DeleteTableRequestPB* req,
   for (int i = 0; i < table_locks.size(); i++) {
     table_locks[i]->Commit();
   }
+  partitions_version_.fetch_add(1, std::memory_order_acq_rel);
 
   // The table lock (l) and the global lock (lock_) must be released for the next call.
   for (int i = 0; i < deleted_tables.size(); i++) {
@@ -2940,6 +3052,10 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
     Status s = STATUS(NotFound, "The object was deleted", l->data().pb.state_msg());
     return SetupError(resp->mutable_error(), MasterErrorPB::OBJECT_NOT_FOUND, s);
   }
+  if (l->data().pb.colocated()) {
+    Status s = STATUS(NotSupported, "Cannot alter colocated table", table->name());
+    return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_REQUEST, s);
+  }
 
   bool has_changes = false;
   const TableName table_name = l->data().name();
@@ -3040,6 +3156,7 @@ Status CatalogManager::AlterTable(const AlterTableRequestPB* req,
   // Update the in-memory state.
   TRACE("Committing in-memory state");
   l->Commit();
+  partitions_version_.fetch_add(1, std::memory_order_acq_rel);
 
   SendAlterTableRequest(table);
 
@@ -3123,6 +3240,7 @@ Status CatalogManager::GetTableSchema(const GetTableSchemaRequestPB* req,
     resp->mutable_identifier()->mutable_namespace_()->set_name(nsinfo->name());
   }
   resp->set_version(l->data().pb.version());
+  resp->set_colocated(l->data().pb.colocated());
   resp->mutable_indexes()->CopyFrom(l->data().pb.indexes());
   if (l->data().pb.has_index_info()) {
     *resp->mutable_index_info() = l->data().pb.index_info();
@@ -3399,7 +3517,9 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
             << ts_desc->permanent_uuid() << "): " << report.DebugString();
   }
 
-  if (!ts_desc->has_tablet_report() && report.is_incremental()) {
+  // Incremental reports that follow the first part of a full report carry the rest of it.
+  if (!ts_desc->has_tablet_report() && report.is_incremental() &&
+      !ts_desc->has_partial_tablet_report()) {
     string msg = "Received an incremental tablet report when a full one was needed";
     LOG(WARNING) << "Invalid tablet report from " << ts_desc->permanent_uuid() << ": " << msg;
     // We should respond with success in order to send reply that we need full report.
@@ -3410,24 +3530,54 @@ Status CatalogManager::ProcessTabletReport(TSDescriptor* ts_desc,
   // the server should have, compare vs the ones being reported, and somehow mark
   // any that have been "lost" (eg somehow the tablet metadata got corrupted or something).
 
+  // Tablets that changed are written to the sys catalog in batches, so a report about many
+  // newly created tablets does not result in a Raft round trip per tablet.
+  // The pending tablets stay write-locked until their batch is written, so tablets are handled
+  // in the order of their ids. Other tablet servers and ProcessPendingAssignments lock multiple
+  // tablets in the same order, so they cannot deadlock with this report.
+  std::vector<const ReportedTabletPB*> sorted_tablets;
+  sorted_tablets.reserve(report.updated_tablets_size());
   for (const ReportedTabletPB& reported : report.updated_tablets()) {
-    ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
-    tablet_report->set_tablet_id(reported.tablet_id());
-    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, reported, tablet_report),
-                          Substitute("Error handling $0", reported.ShortDebugString()));
+    sorted_tablets.push_back(&reported);
   }
-
-  if (!ts_desc->has_tablet_report()) {
-    LOG(INFO) << ts_desc->permanent_uuid() << " now has full report for "
-              << report.updated_tablets_size() << " tablets.";
+  std::stable_sort(sorted_tablets.begin(), sorted_tablets.end(),
+                   [](const ReportedTabletPB* lhs, const ReportedTabletPB* rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
+  std::vector<ReportedTabletUpdate> pending_updates;
+  const size_t batch_size = std::max(FLAGS_master_tablet_report_write_batch_size, 1);
+  for (const ReportedTabletPB* reported : sorted_tablets) {
+    // Flush before handling the same tablet twice, since it is still locked otherwise.
+    if (pending_updates.size() >= batch_size ||
+        (!pending_updates.empty() &&
+         pending_updates.back().report->tablet_id() == reported->tablet_id())) {
+      RETURN_NOT_OK(PersistReportedTablets(&pending_updates));
+    }
+    ReportedTabletUpdatesPB *tablet_report = report_update->add_tablets();
+    tablet_report->set_tablet_id(reported->tablet_id());
+    RETURN_NOT_OK_PREPEND(HandleReportedTablet(ts_desc, *reported, tablet_report,
+                                               &pending_updates),
+                          Substitute("Error handling $0", reported->ShortDebugString()));
   }
+  RETURN_NOT_OK(PersistReportedTablets(&pending_updates));
 
-  if (!report.is_incremental()) {
-    if (report.updated_tablets_size() == 0) {
+  if (!report.is_incremental() || ts_desc->has_partial_tablet_report()) {
+    if (!report.is_incremental() && report.updated_tablets_size() == 0) {
       LOG(INFO) << ts_desc->permanent_uuid() << " sent full tablet report with 0 tablets.";
     }
     // Do not unset full tablet report missing for ts desc for an incremental case.
-    ts_desc->set_has_tablet_report(true);
+    if (report.remaining_tablet_count() > 0) {
+      VLOG(1) << ts_desc->permanent_uuid() << " sent part of full tablet report with "
+              << report.updated_tablets_size() << " tablets, "
+              << report.remaining_tablet_count() << " tablets remaining.";
+      ts_desc->set_has_partial_tablet_report(true);
+    } else {
+      if (!ts_desc->has_tablet_report()) {
+        LOG(INFO) << ts_desc->permanent_uuid() << " now has full report for "
+                  << report.updated_tablets_size() << " tablets.";
+      }
+      ts_desc->set_has_tablet_report(true);
+    }
   }
 
   if (report.updated_tablets_size() > 0) {
@@ -3455,16 +3605,53 @@ bool ShouldTransitionTabletToRunning(const ReportedTabletPB& report) {
 }
 }  // anonymous namespace
 
+Status CatalogManager::PersistReportedTablets(std::vector<ReportedTabletUpdate>* pending_updates) {
+  if (pending_updates->empty()) {
+    return Status::OK();
+  }
+  std::vector<TabletInfo*> tablets;
+  tablets.reserve(pending_updates->size());
+  for (const auto& update : *pending_updates) {
+    tablets.push_back(update.tablet.get());
+  }
+  // Take the updates away, so the locks are released even if the write fails.
+  auto updates = std::move(*pending_updates);
+  pending_updates->clear();
+
+  // We update the tablets each time that someone reports it.
+  // This shouldn't be very frequent and should only happen when something in fact changed.
+  Status s = sys_catalog_->UpdateItems(tablets, leader_ready_term_);
+  if (!s.ok()) {
+    LOG(WARNING) << "Error updating " << tablets.size() << " tablets: " << s.ToString();
+    return s;
+  }
+  for (auto& update : updates) {
+    update.tablet_lock->Commit();
+  }
+  partitions_version_.fetch_add(1, std::memory_order_acq_rel);
+
+  // Need to defer the AlterTable command to after we've committed the new tablet data,
+  // since the tablet report may also be updating the raft config, and the Alter Table
+  // request needs to know who the most recent leader is.
+  for (const auto& update : updates) {
+    if (update.needs_alter) {
+      SendAlterTabletRequest(update.tablet);
+    } else if (update.report->has_schema_version()) {
+      RETURN_NOT_OK(HandleTabletSchemaVersionReport(
+          update.tablet.get(), update.report->schema_version()));
+    }
+  }
+
+  return Status::OK();
+}
+
 Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
                                             const ReportedTabletPB& report,
-                                            ReportedTabletUpdatesPB *report_updates) {
+                                            ReportedTabletUpdatesPB *report_updates,
+                                            std::vector<ReportedTabletUpdate>* pending_updates) {
   TRACE_EVENT1("master", "HandleReportedTablet",
                "tablet_id", report.tablet_id());
-  scoped_refptr<TabletInfo> tablet;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    tablet = FindPtrOrNull(tablet_map_, report.tablet_id());
-  }
+  scoped_refptr<TabletInfo> tablet = sharded_tablet_map_.Find(report.tablet_id());
   RETURN_NOT_OK_PREPEND(CheckIsLeaderAndReady(),
       Substitute("This master is no longer the leader, unable to handle report for tablet $0",
                  report.tablet_id()));
@@ -3582,8 +3769,6 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
           << "Tablet in unexpected state: " << tablet->ToString()
           << ": " << tablet_lock->data().pb.ShortDebugString();
       // Mark the tablet as running
-      // TODO: we could batch the IO onto a background thread, or at least
-      // across multiple tablets in the same report.
       VLOG(1) << "Tablet " << tablet->ToString() << " is now online";
       tablet_lock->mutable_data()->set_state(SysTabletsEntryPB::RUNNING,
                                              "Tablet reported with an active leader");
@@ -3669,24 +3854,8 @@ Status CatalogManager::HandleReportedTablet(TSDescriptor* ts_desc,
   }
 
   table_lock->Unlock();
-  // We update the tablets each time that someone reports it.
-  // This shouldn't be very frequent and should only happen when something in fact changed.
-  Status s = sys_catalog_->UpdateItem(tablet.get(), leader_ready_term_);
-  if (!s.ok()) {
-    LOG(WARNING) << "Error updating tablets: " << s.ToString() << ". Tablet report was: "
-                 << report.ShortDebugString();
-    return s;
-  }
-  tablet_lock->Commit();
-
-  // Need to defer the AlterTable command to after we've committed the new tablet data,
-  // since the tablet report may also be updating the raft config, and the Alter Table
-  // request needs to know who the most recent leader is.
-  if (tablet_needs_alter) {
-    SendAlterTabletRequest(tablet);
-  } else if (report.has_schema_version()) {
-    RETURN_NOT_OK(HandleTabletSchemaVersionReport(tablet.get(), report.schema_version()));
-  }
+  pending_updates->push_back(ReportedTabletUpdate{
+      std::move(tablet), std::move(tablet_lock), &report, tablet_needs_alter});
 
   return Status::OK();
 }
@@ -3732,6 +3901,13 @@ Status CatalogManager::CreateNamespace(const CreateNamespaceRequestPB* req,
     if (req->has_database_type()) {
       metadata->set_database_type(req->database_type());
     }
+    if (req->colocated()) {
+      if (req->database_type() != YQL_DATABASE_PGSQL) {
+        s = STATUS(NotSupported, "Only YSQL databases can be colocated", req->name());
+        return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_REQUEST, s);
+      }
+      metadata->set_colocated(true);
+    }
 
     // For namespace created for a Postgres database, save the list of tables and indexes for
     // for the database that need to be copied.
@@ -3807,6 +3983,10 @@ Status CatalogManager::CreateNamespace(const CreateNamespaceRequestPB* req,
     RETURN_NOT_OK(CopyPgsqlSysTables(ns->id(), pgsql_tables, resp, rpc));
   }
 
+  if (req->colocated()) {
+    RETURN_NOT_OK(CreateColocatedParentTable(ns->id(), rpc));
+  }
+
   return Status::OK();
 }
 
@@ -4702,6 +4882,13 @@ void CatalogManager::SendCopartitionTabletRequest(const scoped_refptr<TabletInfo
   WARN_NOT_OK(call->Run(), "Failed to send copartition table request");
 }
 
+void CatalogManager::SendAddTableToTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                                                 const scoped_refptr<TableInfo>& table) {
+  auto call = std::make_shared<AsyncAddTableToTablet>(master_, worker_pool_.get(), tablet, table);
+  table->AddTask(call);
+  WARN_NOT_OK(call->Run(), "Failed to send add table to tablet request");
+}
+
 void CatalogManager::DeleteTabletReplicas(
     const TabletInfo* tablet,
     const std::string& msg) {
@@ -4722,6 +4909,10 @@ void CatalogManager::DeleteTabletsAndSendRequests(const scoped_refptr<TableInfo>
   string deletion_msg = "Table deleted at " + LocalTimeAsString();
 
   for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+    // The tablet of a colocated table is owned by the parent table of its namespace.
+    if (tablet->table()->id() != table->id()) {
+      continue;
+    }
     DeleteTabletReplicas(tablet.get(), deletion_msg);
 
     auto tablet_lock = tablet->LockForWrite();
@@ -4903,6 +5094,7 @@ void CatalogManager::HandleAssignCreatingTablet(TabletInfo* tablet,
   {
     std::lock_guard<LockType> l_maps(lock_);
     tablet_map_[replacement->tablet_id()] = replacement;
+    sharded_tablet_map_.Set(replacement);
   }
 
   // Mark old tablet as replaced.
@@ -4999,8 +5191,17 @@ Status CatalogManager::ProcessPendingAssignments(const TabletInfos& tablets) {
   VLOG(1) << "Processing pending assignments";
 
   // Take write locks on all tablets to be processed, and ensure that they are
-  // unlocked at the end of this scope.
+  // unlocked at the end of this scope. Tablets are locked in the order of their ids, the same
+  // order ProcessTabletReport uses.
+  std::vector<TabletInfo*> lock_order;
+  lock_order.reserve(tablets.size());
   for (const scoped_refptr<TabletInfo>& tablet : tablets) {
+    lock_order.push_back(tablet.get());
+  }
+  std::sort(lock_order.begin(), lock_order.end(), [](TabletInfo* lhs, TabletInfo* rhs) {
+    return lhs->tablet_id() < rhs->tablet_id();
+  });
+  for (TabletInfo* tablet : lock_order) {
     tablet->mutable_metadata()->StartMutation();
   }
   ScopedTabletInfoCommitter unlocker_in(&tablets);
@@ -5091,6 +5292,7 @@ Status CatalogManager::ProcessPendingAssignments(const TabletInfos& tablets) {
     for (const TabletId& tablet_id_to_remove : tablet_ids_to_remove) {
       CHECK_EQ(tablet_map_.erase(tablet_id_to_remove), 1)
           << "Unable to erase " << tablet_id_to_remove << " from tablet map.";
+      sharded_tablet_map_.Erase(tablet_id_to_remove);
     }
     return s;
   }
@@ -5391,6 +5593,29 @@ Status CatalogManager::ConsensusStateToTabletLocations(const consensus::Consensu
 
 Status CatalogManager::BuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
                                                TabletLocationsPB* locs_pb) {
+  if (!FLAGS_master_cache_tablet_locations || system_tablets_.count(tablet->id())) {
+    return DoBuildLocationsForTablet(tablet, locs_pb);
+  }
+
+  // Versions are read before the locations are built. So if the data changes meanwhile, the
+  // locations are cached with the older version and rebuilt by the next request.
+  TabletLocationsVersion version;
+  version.metadata = tablet->metadata().version();
+  version.replica_locations = tablet->replica_locations_version();
+  version.ts_registrations = master_->ts_manager()->registration_version();
+  auto cached_locations = tablet->GetCachedLocations(version);
+  if (cached_locations) {
+    *locs_pb = *cached_locations;
+    return Status::OK();
+  }
+
+  RETURN_NOT_OK(DoBuildLocationsForTablet(tablet, locs_pb));
+  tablet->SetCachedLocations(std::make_shared<TabletLocationsPB>(*locs_pb), version);
+  return Status::OK();
+}
+
+Status CatalogManager::DoBuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
+                                                 TabletLocationsPB* locs_pb) {
   {
     auto l_tablet = tablet->LockForRead();
     locs_pb->set_table_id(l_tablet->data().pb.table_id());
@@ -5478,12 +5703,9 @@ Status CatalogManager::GetTabletLocations(const TabletId& tablet_id, TabletLocat
   RETURN_NOT_OK(CheckOnline());
 
   locs_pb->mutable_replicas()->Clear();
-  scoped_refptr<TabletInfo> tablet_info;
-  {
-    boost::shared_lock<LockType> l(lock_);
-    if (!FindCopy(tablet_map_, tablet_id, &tablet_info)) {
-      return STATUS_SUBSTITUTE(NotFound, "Unknown tablet $0", tablet_id);
-    }
+  scoped_refptr<TabletInfo> tablet_info = sharded_tablet_map_.Find(tablet_id);
+  if (!tablet_info) {
+    return STATUS_SUBSTITUTE(NotFound, "Unknown tablet $0", tablet_id);
   }
 
   Status s = BuildLocationsForTablet(tablet_info, locs_pb);
@@ -5818,6 +6040,7 @@ Status CatalogManager::SetPreferredZones(
   auto l = cluster_config_->LockForWrite();
   auto replication_info = l->mutable_data()->pb.mutable_replication_info();
   replication_info->clear_affinitized_leaders();
+  replication_info->clear_multi_affinitized_leaders();
 
   Status s;
   for (const auto& cloud_info : req->preferred_zones()) {
@@ -5828,6 +6051,17 @@ Status CatalogManager::SetPreferredZones(
     }
     *replication_info->add_affinitized_leaders() = cloud_info;
   }
+  for (const auto& zones : req->multi_preferred_zones()) {
+    auto* preferred_zones = replication_info->add_multi_affinitized_leaders();
+    for (const auto& cloud_info : zones.zones()) {
+      s = CatalogManagerUtil::DoesPlacementInfoContainCloudInfo(replication_info->live_replicas(),
+                                                                cloud_info);
+      if (!s.ok()) {
+        return SetupError(resp->mutable_error(), MasterErrorPB::INVALID_CLUSTER_CONFIG, s);
+      }
+      *preferred_zones->add_zones() = cloud_info;
+    }
+  }
 
   l->mutable_data()->pb.set_version(l->mutable_data()->pb.version() + 1);
 
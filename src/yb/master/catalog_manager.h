@@ -33,6 +33,7 @@
 #ifndef YB_MASTER_CATALOG_MANAGER_H
 #define YB_MASTER_CATALOG_MANAGER_H
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <set>
@@ -93,6 +94,7 @@ class ClusterLoadBalancer;
 class Master;
 class SysCatalogTable;
 class TableInfo;
+class TabletSplitManager;
 class TSDescriptor;
 class ChangeEncryptionInfoRequestPB;
 class ChangeEncryptionInfoResponsePB;
@@ -366,6 +368,14 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
 
   void SetLoadBalancerEnabled(bool is_enabled);
 
+  ClusterLoadBalancer* load_balancer() { return load_balance_policy_.get(); }
+
+  // Incremented after each change of the tables or tablets visible in system.partitions, so the
+  // vtable could find out whether the rows it has built are still up to date.
+  uint64_t partitions_version() const {
+    return partitions_version_.load(std::memory_order_acquire);
+  }
+
   // Return the table info for the table with the specified UUID, if it exists.
   scoped_refptr<TableInfo> GetTableInfo(const TableId& table_id);
   scoped_refptr<TableInfo> GetTableInfoUnlocked(const TableId& table_id);
@@ -655,6 +665,18 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
                                           Schema schema,
                                           NamespaceId namespace_id);
 
+  // Create a table of a colocated namespace in the tablet shared by its tables.
+  CHECKED_STATUS CreateColocatedUserTable(const CreateTableRequestPB& req,
+                                          CreateTableResponsePB* resp,
+                                          rpc::RpcContext* rpc,
+                                          const Schema& schema,
+                                          const PartitionSchema& partition_schema,
+                                          const NamespaceId& namespace_id,
+                                          IndexInfoPB* index_info);
+
+  // Create the parent table that owns the tablet shared by the tables of a colocated namespace.
+  CHECKED_STATUS CreateColocatedParentTable(const NamespaceId& namespace_id, rpc::RpcContext* rpc);
+
   // Check that local host is present in master addresses for normal master process start.
   // On error, it could imply that master_addresses is incorrectly set for shell master startup
   // or that this master host info was missed in the master addresses and it should be
@@ -696,14 +718,37 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Builds the TabletLocationsPB for a tablet based on the provided TabletInfo.
   // Populates locs_pb and returns true on success.
   // Returns Status::ServiceUnavailable if tablet is not running.
+  //
+  // Locations are cached in the tablet and rebuilt only when the tablet metadata, its replica
+  // locations or the tablet server registrations change.
   CHECKED_STATUS BuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
                                          TabletLocationsPB* locs_pb);
 
+  // Builds the TabletLocationsPB without using the cache.
+  CHECKED_STATUS DoBuildLocationsForTablet(const scoped_refptr<TabletInfo>& tablet,
+                                           TabletLocationsPB* locs_pb);
+
+  // A reported tablet whose new state still has to be written to the sys catalog.
+  // The tablet stays write-locked until the batch containing it is persisted.
+  struct ReportedTabletUpdate {
+    scoped_refptr<TabletInfo> tablet;
+    std::unique_ptr<TabletInfo::lock_type> tablet_lock;
+    const ReportedTabletPB* report = nullptr;
+    bool needs_alter = false;
+  };
+
   // Handle one of the tablets in a tablet reported.
   // Requires that the lock is already held.
+  // If the sys catalog entry of the tablet has to be updated, the update is appended to
+  // pending_updates instead of being written, see PersistReportedTablets.
   CHECKED_STATUS HandleReportedTablet(TSDescriptor* ts_desc,
                                       const ReportedTabletPB& report,
-                                      ReportedTabletUpdatesPB *report_updates);
+                                      ReportedTabletUpdatesPB *report_updates,
+                                      std::vector<ReportedTabletUpdate>* pending_updates);
+
+  // Writes the updates collected by HandleReportedTablet in a single sys catalog write,
+  // commits them and sends the resulting alter requests. Clears pending_updates.
+  CHECKED_STATUS PersistReportedTablets(std::vector<ReportedTabletUpdate>* pending_updates);
 
   CHECKED_STATUS ResetTabletReplicasFromReportedConfig(const ReportedTabletPB& report,
                                                        const scoped_refptr<TabletInfo>& tablet,
@@ -797,6 +842,11 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   void SendCopartitionTabletRequest(const scoped_refptr<TabletInfo>& tablet,
                                     const scoped_refptr<TableInfo>& table);
 
+  // Start the background task to add a colocated table to the tablet shared by the tables of its
+  // namespace.
+  void SendAddTableToTabletRequest(const scoped_refptr<TabletInfo>& tablet,
+                                   const scoped_refptr<TableInfo>& table);
+
   // Send the "truncate table request" to all tablets of the specified table.
   void SendTruncateTableRequest(const scoped_refptr<TableInfo>& table);
 
@@ -942,6 +992,12 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Tablet maps: tablet-id -> TabletInfo
   TabletInfoMap tablet_map_;
 
+  // Copy of tablet_map_ used to look up tablets without lock_.
+  ShardedTabletInfoMap sharded_tablet_map_;
+
+  // See partitions_version(). Should be incremented after the change is committed.
+  std::atomic<uint64_t> partitions_version_{0};
+
   // Namespace maps: namespace-id -> NamespaceInfo and namespace-name -> NamespaceInfo
   typedef std::unordered_map<NamespaceName, scoped_refptr<NamespaceInfo> > NamespaceInfoMap;
   NamespaceInfoMap namespace_ids_map_;
@@ -1035,6 +1091,9 @@ class CatalogManager : public tserver::TabletPeerLookupIf {
   // Policy for load balancing tablets on tablet servers.
   std::unique_ptr<ClusterLoadBalancer> load_balance_policy_;
 
+  // Policy for picking the tablets that should be split.
+  std::unique_ptr<TabletSplitManager> tablet_split_manager_;
+
   // Tablet peer for the sys catalog tablet's peer.
   const std::shared_ptr<tablet::TabletPeer> tablet_peer() const;
 
@@ -39,6 +39,7 @@
 #include "yb/master/scoped_leader_shared_lock.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/master/cluster_balance.h"
+#include "yb/master/tablet_split_manager.h"
 #include "yb/util/flag_tags.h"
 
 using std::shared_ptr;
@@ -136,6 +137,7 @@ void CatalogManagerBgTasks::Run() {
         }
       } else {
         catalog_manager_->load_balance_policy_->RunLoadBalancer();
+        catalog_manager_->tablet_split_manager_->Run();
       }
     }
 
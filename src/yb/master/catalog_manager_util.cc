@@ -13,6 +13,9 @@
 
 #include "yb/master/catalog_manager_util.h"
 
+#include <algorithm>
+#include <limits>
+
 #include <gflags/gflags.h>
 
 #include "yb/util/flag_tags.h"
@@ -62,8 +65,15 @@ Status CatalogManagerUtil::IsLoadBalanced(const master::TSDescriptorVector& ts_d
 
 Status CatalogManagerUtil::AreLeadersOnPreferredOnly(const TSDescriptorVector& ts_descs,
                                                      const ReplicationInfoPB& replication_info) {
+  // When none of the tservers is in the most preferred zones, the leaders move to the next ones.
+  int best_rank = std::numeric_limits<int>::max();
+  for (const auto& ts_desc : ts_descs) {
+    best_rank = std::min(best_rank,
+                         GetLeaderAffinityRank(replication_info, ts_desc->placement_id()));
+  }
   for (const auto& ts_desc : ts_descs) {
-    if (!ts_desc->IsAcceptingLeaderLoad(replication_info) && ts_desc->leader_count() > 0) {
+    if (GetLeaderAffinityRank(replication_info, ts_desc->placement_id()) > best_rank &&
+        ts_desc->leader_count() > 0) {
       // This is a ts that shouldn't have leader load but does, return an error.
       return STATUS(
           IllegalState,
@@ -74,6 +84,36 @@ Status CatalogManagerUtil::AreLeadersOnPreferredOnly(const TSDescriptorVector& t
   return Status::OK();
 }
 
+bool CatalogManagerUtil::HasLeaderAffinity(const ReplicationInfoPB& replication_info) {
+  return !replication_info.affinitized_leaders().empty() ||
+         !replication_info.multi_affinitized_leaders().empty();
+}
+
+int CatalogManagerUtil::GetLeaderAffinityRank(const ReplicationInfoPB& replication_info,
+                                              const std::string& placement_id) {
+  auto contains = [&placement_id](const google::protobuf::RepeatedPtrField<CloudInfoPB>& zones) {
+    for (const auto& zone : zones) {
+      if (TSDescriptor::generate_placement_id(zone) == placement_id) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  if (replication_info.multi_affinitized_leaders().empty()) {
+    const auto& zones = replication_info.affinitized_leaders();
+    return zones.empty() || contains(zones) ? 0 : 1;
+  }
+  int rank = 0;
+  for (const auto& zones : replication_info.multi_affinitized_leaders()) {
+    if (contains(zones.zones())) {
+      return rank;
+    }
+    ++rank;
+  }
+  return rank;
+}
+
 Status CatalogManagerUtil::GetPerZoneTSDesc(const TSDescriptorVector& ts_descs,
                                             ZoneToDescMap* zone_to_ts) {
   if (zone_to_ts == nullptr) {
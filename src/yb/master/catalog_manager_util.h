@@ -34,10 +34,20 @@ class CatalogManagerUtil {
   static CHECKED_STATUS IsLoadBalanced(const TSDescriptorVector& ts_descs);
 
   // For the given set of descriptors, checks if every tserver that shouldn't have leader load
-  // actually has no leader load.
+  // actually has no leader load. Leaders should be in the most preferred zones that have one of
+  // the tservers.
   static CHECKED_STATUS AreLeadersOnPreferredOnly(const TSDescriptorVector& ts_descs,
                                                   const ReplicationInfoPB& replication_info);
 
+  // Whether the replication info sets preferred zones for the leaders.
+  static bool HasLeaderAffinity(const ReplicationInfoPB& replication_info);
+
+  // Returns the position of the zone with the given placement id in the leader preference order
+  // of the replication info, 0 being the most preferred. Zones that are not preferred come after
+  // all the preferred ones. Returns 0 for all zones when there are no preferred zones.
+  static int GetLeaderAffinityRank(const ReplicationInfoPB& replication_info,
+                                   const std::string& placement_id);
+
   // For the given set of descriptors, returns the map from each placement AZ to list of tservers
   // running in that zone.
   static CHECKED_STATUS GetPerZoneTSDesc(const TSDescriptorVector& ts_descs,
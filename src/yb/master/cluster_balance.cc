@@ -20,6 +20,7 @@
 
 #include "yb/consensus/quorum_util.h"
 #include "yb/master/master.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
 DEFINE_bool(enable_load_balancing,
@@ -60,6 +61,27 @@ DEFINE_int32(load_balancer_max_concurrent_moves,
              "Maximum number of tablet leaders on tablet servers to move in any one run of the "
              "load balancer.");
 
+DEFINE_bool(load_balancer_use_tablet_load, false,
+            "Weigh tablets by the read and write rates and the SST size reported for them by the "
+            "tablet servers, instead of counting all of them as the same load.");
+TAG_FLAG(load_balancer_use_tablet_load, advanced);
+
+DEFINE_double(load_balancer_tablet_ops_weight, 0.5,
+              "Share of the weight of a tablet that is proportional to its read and write rates, "
+              "when load_balancer_use_tablet_load is set.");
+TAG_FLAG(load_balancer_tablet_ops_weight, advanced);
+
+DEFINE_double(load_balancer_tablet_size_weight, 0.25,
+              "Share of the weight of a tablet that is proportional to its SST size, when "
+              "load_balancer_use_tablet_load is set.");
+TAG_FLAG(load_balancer_tablet_size_weight, advanced);
+
+DEFINE_int32(load_balancer_tablet_move_cooldown_sec, 300,
+             "Minimal time between two moves of the replicas or the leader of the same tablet, "
+             "when load_balancer_use_tablet_load is set. Prevents moving a tablet back and forth "
+             "when its load changes.");
+TAG_FLAG(load_balancer_tablet_move_cooldown_sec, advanced);
+
 DECLARE_int32(min_leader_stepdown_retry_interval_ms);
 
 namespace yb {
@@ -77,7 +99,10 @@ Status ClusterLoadBalancer::UpdateTabletInfo(TabletInfo* tablet) {
   // Set the placement information on a per-table basis, only once.
   if (!state_->placement_by_table_.count(table_id)) {
     PlacementInfoPB pb;
-    {
+    if (state_->replica_type_ == ReplicaType::kReadReplica) {
+      // Read replicas are only configured at the cluster level.
+      pb.CopyFrom(state_->read_replica_placement_);
+    } else {
       auto l = tablet->table()->LockForRead();
       // If we have a custom per-table placement policy, use that.
       if (l->data().pb.replication_info().has_live_replicas()) {
@@ -183,6 +208,37 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
   // At the start of the run, report LB state that might prevent it from running smoothly.
   ReportUnusualLoadBalancerState();
 
+  // Forget the tablets whose cooldown is over.
+  for (auto it = last_move_time_.begin(); it != last_move_time_.end();) {
+    if (!IsRecentlyMoved(it->first)) {
+      it = last_move_time_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  // Live replicas are balanced first, then the read replicas of each read replica cluster.
+  const auto read_replicas = GetReadReplicaPlacementInfos();
+  std::set<std::string> read_replica_placement_uuids;
+  for (const auto& placement : read_replicas) {
+    read_replica_placement_uuids.insert(placement.placement_uuid());
+  }
+
+  BalanceTables(ReplicaType::kLive, PlacementInfoPB(), read_replica_placement_uuids, options,
+                &remaining_adds, &remaining_removals, &remaining_leader_moves);
+  for (const auto& placement : read_replicas) {
+    if (remaining_adds == 0 && remaining_removals == 0) {
+      break;
+    }
+    BalanceTables(ReplicaType::kReadReplica, placement, read_replica_placement_uuids, options,
+                  &remaining_adds, &remaining_removals, &remaining_leader_moves);
+  }
+}
+
+void ClusterLoadBalancer::BalanceTables(
+    ReplicaType replica_type, const PlacementInfoPB& read_replica_placement,
+    const std::set<std::string>& read_replica_placement_uuids, Options* options,
+    int* remaining_adds, int* remaining_removals, int* remaining_leader_moves) {
   // Loop over all tables.
   for (const auto& table : GetTableMap()) {
 
@@ -192,6 +248,7 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
 
     ResetState();
     state_->options_ = options;
+    state_->SetCluster(replica_type, read_replica_placement, read_replica_placement_uuids);
 
     // Prepare the in-memory structures.
     YB_WARN_NOT_OK(AnalyzeTablets(table.first), "Skipping load balancing " + table.first);
@@ -202,7 +259,7 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
     TabletServerId out_to_ts;
 
     // Handle adding and moving replicas.
-    for (int i = 0; i < remaining_adds; ++i) {
+    for (int i = 0; i < *remaining_adds; ++i) {
       auto handle_add = HandleAddReplicas(&out_tablet_id, &out_from_ts, &out_to_ts);
       if (!handle_add.ok()) {
         LOG(WARNING) << "Skipping add replicas for " << table.first << ": "
@@ -212,11 +269,11 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       if (!*handle_add) {
         break;
       }
-      --remaining_adds;
+      --*remaining_adds;
     }
 
     // Handle cleanup after over-replication.
-    for (int i = 0; i < remaining_removals; ++i) {
+    for (int i = 0; i < *remaining_removals; ++i) {
       auto handle_remove = HandleRemoveReplicas(&out_tablet_id, &out_from_ts);
       if (!handle_remove.ok()) {
         LOG(WARNING) << "Skipping remove replicas for " << table.first << ": "
@@ -226,11 +283,11 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       if (!*handle_remove) {
         break;
       }
-      --remaining_removals;
+      --*remaining_removals;
     }
 
     // Handle tablet servers with too many leaders.
-    for (int i = 0; i < remaining_leader_moves; ++i) {
+    for (int i = 0; i < *remaining_leader_moves; ++i) {
       auto handle_leader = HandleLeaderMoves(&out_tablet_id, &out_from_ts, &out_to_ts);
       if (!handle_leader.ok()) {
         LOG(WARNING) << "Skipping leader moves for " << table.first << ": "
@@ -240,10 +297,10 @@ void ClusterLoadBalancer::RunLoadBalancer(Options* options) {
       if (!*handle_leader) {
         break;
       }
-      --remaining_leader_moves;
+      --*remaining_leader_moves;
     }
 
-    if (remaining_adds == 0 && remaining_removals == 0 && remaining_leader_moves == 0) {
+    if (*remaining_adds == 0 && *remaining_removals == 0 && *remaining_leader_moves == 0) {
       break;
     }
   }
@@ -268,6 +325,7 @@ void ClusterLoadBalancer::ResetState() {
 Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
   // Set the blacklist so we can also mark the tablet servers as we add them up.
   state_->SetBlacklist(GetServerBlacklist());
+  state_->leader_affinity_ = GetLeaderAffinity(table_uuid);
 
   // Loop over live tablet servers to set empty defaults, so we can also have info on those
   // servers that have yet to receive load (have heartbeated to the master, but have not been
@@ -309,6 +367,11 @@ Status ClusterLoadBalancer::AnalyzeTablets(const TableId& table_uuid) {
     }
   }
 
+  state_->ComputeTabletWeights();
+
+  // Only the tablet servers of the preferred zones take part in balancing the leaders.
+  state_->ApplyLeaderAffinity();
+
   // After updating the tablets and tablet servers, adjust the configured threshold if it is too
   // low for the given configuration.
   state_->AdjustLeaderBalanceThreshold();
@@ -457,7 +520,7 @@ void ClusterLoadBalancer::DumpSortedLoad() const {
   out << "Table load: ";
   for (int left = 0; left <= last_pos; ++left) {
     const TabletServerId& uuid = state_->sorted_load_[left];
-    int load = state_->GetLoad(uuid);
+    double load = state_->GetLoad(uuid);
     out << uuid << ":" << load << " ";
   }
   VLOG(1) << out.str();
@@ -494,7 +557,7 @@ Result<bool> ClusterLoadBalancer::GetLoadToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_load_[right];
-      int load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
+      double load_variance = state_->GetLoad(high_load_uuid) - state_->GetLoad(low_load_uuid);
 
       // Check for state change or end conditions.
       if (left == right || load_variance < state_->options_->kMinLoadVarianceToBalance) {
@@ -571,7 +634,14 @@ Result<bool> ClusterLoadBalancer::GetTabletToMove(
 
   bool same_placement = state_->per_ts_meta_[from_ts].descriptor->placement_id() ==
                         state_->per_ts_meta_[to_ts].descriptor->placement_id();
+  // Moving a tablet that weighs as much as the load difference between the two tablet servers
+  // would only swap their loads, so such tablets are skipped. This never happens when all tablets
+  // weigh 1.
+  const double load_variance = state_->GetLoad(from_ts) - state_->GetLoad(to_ts);
   for (const auto& tablet_id : non_over_replicated_tablets) {
+    if (state_->GetReplicaWeight(tablet_id) >= load_variance || IsRecentlyMoved(tablet_id)) {
+      continue;
+    }
     const auto& placement_info = GetPlacementByTablet(tablet_id);
     // TODO(bogdan): this should be augmented as well to allow dropping by one replica, if still
     // leaving us with more than the minimum.
@@ -631,7 +701,7 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
     for (int right = last_pos; right >= 0; --right) {
       const TabletServerId& low_load_uuid = state_->sorted_leader_load_[left];
       const TabletServerId& high_load_uuid = state_->sorted_leader_load_[right];
-      int load_variance =
+      double load_variance =
           state_->GetLeaderLoad(high_load_uuid) - state_->GetLeaderLoad(low_load_uuid);
 
       // Check for state change or end conditions.
@@ -654,30 +724,15 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
       std::set_intersection(leaders.begin(), leaders.end(), peers.begin(), peers.end(), itr);
 
       for (const auto& tablet_id : intersection) {
+        if (state_->GetLeaderWeight(tablet_id) >= load_variance || IsRecentlyMoved(tablet_id)) {
+          continue;
+        }
+        if (HasRecentLeaderStepdownFailure(tablet_id, low_load_uuid, current_time)) {
+          continue;
+        }
         *moving_tablet_id = tablet_id;
         *from_ts = high_load_uuid;
         *to_ts = low_load_uuid;
-
-        const auto& per_tablet_meta = state_->per_tablet_meta_;
-        const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
-        if (PREDICT_TRUE(tablet_meta_iter != per_tablet_meta.end())) {
-          const auto& tablet_meta = tablet_meta_iter->second;
-          const auto& stepdown_failures = tablet_meta.leader_stepdown_failures;
-          const auto stepdown_failure_iter = stepdown_failures.find(low_load_uuid);
-          if (stepdown_failure_iter != stepdown_failures.end()) {
-            const auto time_since_failure = current_time - stepdown_failure_iter->second;
-            if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
-              LOG(INFO) << "Cannot move tablet " << tablet_id << " leader from TS "
-                        << *from_ts << " to TS " << *to_ts << " yet: previous attempt with the same"
-                        << " intended leader failed only " << ToString(time_since_failure)
-                        << " ago (less " << "than " << FLAGS_min_leader_stepdown_retry_interval_ms
-                        << "ms).";
-            }
-            continue;
-          }
-        } else {
-          LOG(WARNING) << "Did not find load balancer metadata for tablet " << *moving_tablet_id;
-        }
         return true;
       }
     }
@@ -687,6 +742,53 @@ Result<bool> ClusterLoadBalancer::GetLeaderToMove(
   FATAL_ERROR("Load balancing algorithm reached invalid state!");
 }
 
+Result<bool> ClusterLoadBalancer::GetLeaderToMoveToAffinitizedZones(
+    TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts) {
+  const auto current_time = MonoTime::Now();
+  for (const auto& from_uuid : state_->non_affinitized_leader_servers_) {
+    for (const auto& tablet_id : state_->per_ts_meta_[from_uuid].leaders) {
+      if (IsRecentlyMoved(tablet_id)) {
+        continue;
+      }
+      // sorted_leader_load_ is sorted by leader load, so the least loaded server is picked.
+      for (const auto& to_uuid : state_->sorted_leader_load_) {
+        if (state_->per_ts_meta_[to_uuid].running_tablets.count(tablet_id) == 0 ||
+            HasRecentLeaderStepdownFailure(tablet_id, to_uuid, current_time)) {
+          continue;
+        }
+        *moving_tablet_id = tablet_id;
+        *from_ts = from_uuid;
+        *to_ts = to_uuid;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool ClusterLoadBalancer::HasRecentLeaderStepdownFailure(
+    const TabletId& tablet_id, const TabletServerId& to_ts, MonoTime now) const {
+  const auto& per_tablet_meta = state_->per_tablet_meta_;
+  const auto tablet_meta_iter = per_tablet_meta.find(tablet_id);
+  if (PREDICT_FALSE(tablet_meta_iter == per_tablet_meta.end())) {
+    LOG(WARNING) << "Did not find load balancer metadata for tablet " << tablet_id;
+    return false;
+  }
+  const auto& stepdown_failures = tablet_meta_iter->second.leader_stepdown_failures;
+  const auto stepdown_failure_iter = stepdown_failures.find(to_ts);
+  if (stepdown_failure_iter == stepdown_failures.end()) {
+    return false;
+  }
+  const auto time_since_failure = now - stepdown_failure_iter->second;
+  if (time_since_failure.ToMilliseconds() < FLAGS_min_leader_stepdown_retry_interval_ms) {
+    LOG(INFO) << "Cannot move tablet " << tablet_id << " leader to TS " << to_ts
+              << " yet: previous attempt with the same intended leader failed only "
+              << ToString(time_since_failure) << " ago (less than "
+              << FLAGS_min_leader_stepdown_retry_interval_ms << "ms).";
+  }
+  return true;
+}
+
 Result<bool> ClusterLoadBalancer::HandleRemoveReplicas(
     TabletId* out_tablet_id, TabletServerId* out_from_ts) {
   // Give high priority to removing tablets that are not respecting the placement policy.
@@ -766,7 +868,9 @@ Result<bool> ClusterLoadBalancer::HandleRemoveIfWrongPlacement(
 
 Result<bool> ClusterLoadBalancer::HandleLeaderMoves(
     TabletId* out_tablet_id, TabletServerId* out_from_ts, TabletServerId* out_to_ts) {
-  if (VERIFY_RESULT(GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts))) {
+  // Leaders outside of the preferred zones are moved first, in the order of preference.
+  if (VERIFY_RESULT(GetLeaderToMoveToAffinitizedZones(out_tablet_id, out_from_ts, out_to_ts)) ||
+      VERIFY_RESULT(GetLeaderToMove(out_tablet_id, out_from_ts, out_to_ts))) {
     RETURN_NOT_OK(MoveLeader(*out_tablet_id, *out_from_ts, *out_to_ts));
     return true;
   }
@@ -776,6 +880,7 @@ Result<bool> ClusterLoadBalancer::HandleLeaderMoves(
 Status ClusterLoadBalancer::MoveReplica(
     const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
   LOG(INFO) << Substitute("Moving tablet $0 from $1 to $2", tablet_id, from_ts, to_ts);
+  RecordMove("Move replica", tablet_id, from_ts, to_ts, state_->GetReplicaWeight(tablet_id));
   SendReplicaChanges(GetTabletMap().at(tablet_id), to_ts, true /* is_add */,
                      true /* should_remove_leader */);
   RETURN_NOT_OK(state_->AddReplica(tablet_id, to_ts));
@@ -784,6 +889,7 @@ Status ClusterLoadBalancer::MoveReplica(
 
 Status ClusterLoadBalancer::AddReplica(const TabletId& tablet_id, const TabletServerId& to_ts) {
   LOG(INFO) << Substitute("Adding tablet $0 to $1", tablet_id, to_ts);
+  RecordMove("Add replica", tablet_id, "", to_ts, state_->GetReplicaWeight(tablet_id));
   // This is an add operation, so the "should_remove_leader" flag is irrelevant.
   SendReplicaChanges(GetTabletMap().at(tablet_id), to_ts, true /* is_add */,
                      true /* should_remove_leader */);
@@ -793,6 +899,7 @@ Status ClusterLoadBalancer::AddReplica(const TabletId& tablet_id, const TabletSe
 Status ClusterLoadBalancer::RemoveReplica(
     const TabletId& tablet_id, const TabletServerId& ts_uuid, const bool stepdown_if_leader) {
   LOG(INFO) << Substitute("Removing replica $0 from tablet $1", ts_uuid, tablet_id);
+  RecordMove("Remove replica", tablet_id, ts_uuid, "", state_->GetReplicaWeight(tablet_id));
   SendReplicaChanges(GetTabletMap().at(tablet_id), ts_uuid, false /* is_add */,
                      true /* should_remove_leader */);
   return state_->RemoveReplica(tablet_id, ts_uuid);
@@ -801,12 +908,43 @@ Status ClusterLoadBalancer::RemoveReplica(
 Status ClusterLoadBalancer::MoveLeader(
     const TabletId& tablet_id, const TabletServerId& from_ts, const TabletServerId& to_ts) {
   LOG(INFO) << Substitute("Moving leader of $0 from TS $1 to $2", tablet_id, from_ts, to_ts);
+  RecordMove("Move leader", tablet_id, from_ts, to_ts, state_->GetLeaderWeight(tablet_id));
   SendReplicaChanges(GetTabletMap().at(tablet_id), from_ts, false /* is_add */,
                      false /* should_remove_leader */, to_ts);
 
   return state_->MoveLeader(tablet_id, from_ts, to_ts);
 }
 
+void ClusterLoadBalancer::RecordMove(
+    const char* action, const TabletId& tablet_id, const TabletServerId& from_ts,
+    const TabletServerId& to_ts, double weight) {
+  const auto now = MonoTime::Now();
+  if (FLAGS_load_balancer_use_tablet_load) {
+    last_move_time_[tablet_id] = now;
+  }
+
+  std::lock_guard<std::mutex> lock(recent_moves_mutex_);
+  recent_moves_.push_back(LoadBalancerMove{now, action, tablet_id, from_ts, to_ts, weight});
+  while (recent_moves_.size() > kMaxRecentMoves) {
+    recent_moves_.pop_front();
+  }
+}
+
+bool ClusterLoadBalancer::IsRecentlyMoved(const TabletId& tablet_id) const {
+  if (!FLAGS_load_balancer_use_tablet_load) {
+    return false;
+  }
+  auto it = last_move_time_.find(tablet_id);
+  return it != last_move_time_.end() &&
+         MonoTime::Now() - it->second <
+             MonoDelta::FromSeconds(FLAGS_load_balancer_tablet_move_cooldown_sec);
+}
+
+std::vector<LoadBalancerMove> ClusterLoadBalancer::GetRecentMoves() const {
+  std::lock_guard<std::mutex> lock(recent_moves_mutex_);
+  return std::vector<LoadBalancerMove>(recent_moves_.begin(), recent_moves_.end());
+}
+
 // CatalogManager indirection methods that are set as virtual to be bypassed in testing.
 //
 void ClusterLoadBalancer::GetAllReportedDescriptors(TSDescriptorVector* ts_descs) const {
@@ -845,14 +983,41 @@ const PlacementInfoPB& ClusterLoadBalancer::GetClusterPlacementInfo() const {
   return l->data().pb.replication_info().live_replicas();
 }
 
+google::protobuf::RepeatedPtrField<PlacementInfoPB>
+    ClusterLoadBalancer::GetReadReplicaPlacementInfos() const {
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  return l->data().pb.replication_info().read_replicas();
+}
+
 const BlacklistPB& ClusterLoadBalancer::GetServerBlacklist() const {
   auto l = catalog_manager_->cluster_config_->LockForRead();
   return l->data().pb.server_blacklist();
 }
 
+ReplicationInfoPB ClusterLoadBalancer::GetLeaderAffinity(const TableId& table_uuid) const {
+  ReplicationInfoPB result;
+  auto table = GetTableInfo(table_uuid);
+  if (table) {
+    auto l = table->LockForRead();
+    const auto& table_replication_info = l->data().pb.replication_info();
+    if (CatalogManagerUtil::HasLeaderAffinity(table_replication_info)) {
+      *result.mutable_affinitized_leaders() = table_replication_info.affinitized_leaders();
+      *result.mutable_multi_affinitized_leaders() =
+          table_replication_info.multi_affinitized_leaders();
+      return result;
+    }
+  }
+  auto l = catalog_manager_->cluster_config_->LockForRead();
+  const auto& replication_info = l->data().pb.replication_info();
+  *result.mutable_affinitized_leaders() = replication_info.affinitized_leaders();
+  *result.mutable_multi_affinitized_leaders() = replication_info.multi_affinitized_leaders();
+  return result;
+}
+
 bool ClusterLoadBalancer::SkipLoadBalancing(const TableInfo& table) const {
   // Skip load-balancing of system tables. They are virtual tables not hosted by tservers.
-  return catalog_manager_->IsSystemTable(table);
+  // Colocated tables are balanced through the parent table that owns their shared tablet.
+  return catalog_manager_->IsSystemTable(table) || table.colocated();
 }
 
 void ClusterLoadBalancer::CountPendingTasks(const TableId& table_uuid,
@@ -911,7 +1076,7 @@ void ClusterLoadBalancer::SendReplicaChanges(
 }
 
 consensus::RaftPeerPB::MemberType ClusterLoadBalancer::GetDefaultMemberType() {
-  return consensus::RaftPeerPB::PRE_VOTER;
+  return state_->NewReplicaMemberType();
 }
 
 Result<bool> ClusterLoadBalancer::IsConfigMemberInTransitionMode(const TabletId &tablet_id) const {
@@ -22,7 +22,9 @@
 #include <unordered_set>
 #include <vector>
 #include <atomic>
+#include <deque>
 #include <list>
+#include <mutex>
 
 #include "yb/master/catalog_manager.h"
 #include "yb/master/ts_descriptor.h"
@@ -38,6 +40,18 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 namespace yb {
 namespace master {
 
+// A change of the replicas or of the leader of a tablet issued by the load balancer.
+struct LoadBalancerMove {
+  MonoTime time;
+  std::string action;
+  TabletId tablet_id;
+  // Empty when the move only adds or removes a replica.
+  TabletServerId from_ts;
+  TabletServerId to_ts;
+  // Weight of the moved replica or leader in the load of the tablet servers.
+  double weight;
+};
+
 //  This class keeps state with regards to the full cluster load of tablets on tablet servers. We
 //  count a tablet towards a tablet server's load if it is either RUNNING, or is in the process of
 //  starting up, hence NOT_STARTED or BOOTSTRAPPING.
@@ -83,6 +97,9 @@ class ClusterLoadBalancer {
   // Sets whether to enable or disable the load balancer, on demand.
   void SetLoadBalancerEnabled(bool is_enabled) { is_enabled_ = is_enabled; }
 
+  // Returns the latest moves issued by the load balancer, oldest first.
+  std::vector<LoadBalancerMove> GetRecentMoves() const;
+
   //
   // Catalog manager indirection methods.
   //
@@ -106,9 +123,16 @@ class ClusterLoadBalancer {
   // Get the placement information from the cluster configuration.
   virtual const PlacementInfoPB& GetClusterPlacementInfo() const;
 
+  // Get the placement information of the read replica clusters from the cluster configuration.
+  virtual google::protobuf::RepeatedPtrField<PlacementInfoPB> GetReadReplicaPlacementInfos() const;
+
   // Get the blacklist information.
   virtual const BlacklistPB& GetServerBlacklist() const;
 
+  // Get the preferred zones for the leaders of the table: its own when it has them, the cluster
+  // ones otherwise.
+  virtual ReplicationInfoPB GetLeaderAffinity(const TableId& table_uuid) const;
+
   // Should skip load-balancing of this table?
   virtual bool SkipLoadBalancing(const TableInfo& table) const;
 
@@ -134,7 +158,8 @@ class ClusterLoadBalancer {
       scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid, const bool is_add,
       const bool should_remove_leader, const TabletServerId& new_leader_ts_uuid = "");
 
-  // Returns default member type for newly created replicas (PRE_VOTER).
+  // Returns default member type for newly created replicas: PRE_VOTER for live replicas and
+  // PRE_OBSERVER for read replicas.
   virtual consensus::RaftPeerPB::MemberType GetDefaultMemberType();
 
   //
@@ -192,7 +217,8 @@ class ClusterLoadBalancer {
   // Returns true if a move was actually made.
   Result<bool> HandleRemoveIfWrongPlacement(TabletId* out_tablet_id, TabletServerId* out_from_ts);
 
-  // Processes any tablet leaders that are on a highly loaded tablet server and need to be moved.
+  // Processes any tablet leaders that are in less preferred zones or on a highly loaded tablet
+  // server and need to be moved.
   //
   // Returns true if a move was actually made.
   virtual Result<bool> HandleLeaderMoves(
@@ -217,6 +243,20 @@ class ClusterLoadBalancer {
   Result<bool> GetLeaderToMove(
       TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
 
+  // Go through the leaders on non_affinitized_leader_servers_ and figure out which one to move to
+  // the least loaded tablet server of the preferred zones that has a running replica of it. Only
+  // the leadership moves, so the replicas of the tablet, and its fault tolerance, do not change.
+  //
+  // Returns true if we could find a leader to move and sets the three output parameters.
+  // Returns false otherwise.
+  Result<bool> GetLeaderToMoveToAffinitizedZones(
+      TabletId* moving_tablet_id, TabletServerId* from_ts, TabletServerId* to_ts);
+
+  // Whether moving the leader of the tablet to to_ts recently failed, so it should not be tried
+  // again yet.
+  bool HasRecentLeaderStepdownFailure(
+      const TabletId& tablet_id, const TabletServerId& to_ts, MonoTime now) const;
+
   // Issue the change config and modify the in-memory state for moving a replica from one tablet
   // server to another.
   CHECKED_STATUS MoveReplica(
@@ -274,6 +314,13 @@ class ClusterLoadBalancer {
   template <class ClusterLoadBalancerClass> friend class TestLoadBalancerBase;
 
  private:
+  // Balances replicas of the specified type across all tables, with at most the remaining number of
+  // adds, removals and leader moves, decrementing them by the number of operations issued.
+  void BalanceTables(
+      ReplicaType replica_type, const PlacementInfoPB& read_replica_placement,
+      const std::set<std::string>& read_replica_placement_uuids, Options* options,
+      int* remaining_adds, int* remaining_removals, int* remaining_leader_moves);
+
   // Returns true if at least one member in the tablet's configuration is transitioning into a
   // VOTER, but it's not a VOTER yet.
   Result<bool> IsConfigMemberInTransitionMode(const TabletId& tablet_id) const;
@@ -284,12 +331,32 @@ class ClusterLoadBalancer {
   // Report unusual state at the beginning of an LB run which may prevent LB from making moves.
   void ReportUnusualLoadBalancerState() const;
 
+  // Adds the move to recent_moves_ and, when tablets are weighted by their load, starts the
+  // cooldown of the tablet.
+  void RecordMove(
+      const char* action, const TabletId& tablet_id, const TabletServerId& from_ts,
+      const TabletServerId& to_ts, double weight);
+
+  // Whether the replicas or the leader of the tablet were moved less than
+  // load_balancer_tablet_move_cooldown_sec ago. Always false unless tablets are weighted by their
+  // load, as the load of a tablet changes when it moves and a tablet could otherwise be moved back
+  // and forth.
+  bool IsRecentlyMoved(const TabletId& tablet_id) const;
+
   // Random number generator for picking items at random from sets, using ReservoirSample.
   ThreadSafeRandom random_;
 
   // Controls whether to run the load balancing algorithm or not.
   std::atomic<bool> is_enabled_;
 
+  // Time of the last move of each tablet moved during its cooldown.
+  std::unordered_map<TabletId, MonoTime> last_move_time_;
+
+  static constexpr size_t kMaxRecentMoves = 100;
+
+  mutable std::mutex recent_moves_mutex_;
+  std::deque<LoadBalancerMove> recent_moves_;
+
   DISALLOW_COPY_AND_ASSIGN(ClusterLoadBalancer);
 };
 
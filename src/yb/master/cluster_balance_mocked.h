@@ -36,8 +36,22 @@ class ClusterLoadBalancerMocked : public ClusterLoadBalancer {
     return replication_info_.live_replicas();
   }
 
+  google::protobuf::RepeatedPtrField<PlacementInfoPB>
+      GetReadReplicaPlacementInfos() const override {
+    return replication_info_.read_replicas();
+  }
+
   const BlacklistPB& GetServerBlacklist() const override { return blacklist_; }
 
+  ReplicationInfoPB GetLeaderAffinity(const TableId& table_uuid) const override {
+    ReplicationInfoPB result;
+    *result.mutable_multi_affinitized_leaders() = replication_info_.multi_affinitized_leaders();
+    for (const auto& zone : affinitized_zones_) {
+      *result.add_affinitized_leaders() = zone;
+    }
+    return result;
+  }
+
   void SendReplicaChanges(scoped_refptr<TabletInfo> tablet, const TabletServerId& ts_uuid,
                           const bool is_add, const bool should_remove,
                           const TabletServerId& new_leader_uuid) override {
@@ -16,6 +16,8 @@
 
 #include <unordered_set>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 #include <memory>
 #include <set>
@@ -25,6 +27,7 @@
 #include <atomic>
 
 #include "yb/master/catalog_manager.h"
+#include "yb/master/catalog_manager_util.h"
 #include "yb/master/ts_descriptor.h"
 #include "yb/util/random.h"
 
@@ -48,6 +51,12 @@ DECLARE_int32(load_balancer_max_concurrent_removals);
 
 DECLARE_int32(load_balancer_max_concurrent_moves);
 
+DECLARE_bool(load_balancer_use_tablet_load);
+
+DECLARE_double(load_balancer_tablet_ops_weight);
+
+DECLARE_double(load_balancer_tablet_size_weight);
+
 namespace yb {
 namespace master {
 
@@ -67,6 +76,10 @@ struct cloud_hash {
 
 using AffinitizedZonesSet = unordered_set<CloudInfoPB, cloud_hash, cloud_equal_to>;
 
+// Type of the replicas balanced in a cluster of tablet servers: voting members of the Raft config
+// in the live cluster, or observers in a read replica cluster.
+YB_DEFINE_ENUM(ReplicaType, (kLive)(kReadReplica));
+
 struct CBTabletMetadata {
   bool is_missing_replicas() { return is_under_replicated || !under_replicated_placements.empty(); }
 
@@ -116,16 +129,27 @@ struct CBTabletMetadata {
   // Leader stepdown failures. We use this to prevent retrying the same leader stepdown too soon.
   LeaderStepDownFailureTimes leader_stepdown_failures;
 
+  // Read and write ops per second and SST file size of this tablet, the highest values reported
+  // by its replicas.
+  double ops_per_sec = 0;
+  uint64_t sst_file_size = 0;
+
+  // How much a replica and the leader of this tablet add to the load of their tablet server. Both
+  // are 1, unless load_balancer_use_tablet_load is set.
+  double replica_weight = 1;
+  double leader_weight = 1;
+
   std::string ToString() const {
     return Format("{ running: $0 starting: $1 is_under_replicated: $2 "
                       "under_replicated_placements: $3 is_over_replicated: $4 "
                       "over_replicated_tablet_servers: $5 wrong_placement_tablet_servers: $6 "
                       "blacklisted_tablet_servers: $7 leader_uuid: $8 "
-                      "leader_stepdown_failures: $9 }",
+                      "leader_stepdown_failures: $9 ",
                   running, starting, is_under_replicated, under_replicated_placements,
                   is_over_replicated, over_replicated_tablet_servers,
                   wrong_placement_tablet_servers, blacklisted_tablet_servers,
-                  leader_uuid, leader_stepdown_failures);
+                  leader_uuid, leader_stepdown_failures) +
+           Format("replica_weight: $0 leader_weight: $1 }", replica_weight, leader_weight);
   }
 };
 
@@ -187,8 +211,8 @@ class ClusterLoadState {
 
   // Comparators used for sorting by load.
   bool CompareByUuid(const TabletServerId& a, const TabletServerId& b) {
-    int load_a = GetLoad(a);
-    int load_b = GetLoad(b);
+    double load_a = GetLoad(a);
+    double load_b = GetLoad(b);
     if (load_a == load_b) {
       return a < b;
     } else {
@@ -225,18 +249,112 @@ class ClusterLoadState {
   };
 
   // Get the load for a certain TS.
-  int GetLoad(const TabletServerId& ts_uuid) const {
+  double GetLoad(const TabletServerId& ts_uuid) const {
     const auto& ts_meta = per_ts_meta_.at(ts_uuid);
-    return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    if (!FLAGS_load_balancer_use_tablet_load) {
+      return ts_meta.starting_tablets.size() + ts_meta.running_tablets.size();
+    }
+    double load = 0;
+    for (const auto& tablet_id : ts_meta.starting_tablets) {
+      load += GetReplicaWeight(tablet_id);
+    }
+    for (const auto& tablet_id : ts_meta.running_tablets) {
+      load += GetReplicaWeight(tablet_id);
+    }
+    return load;
   }
 
   // Get the load for a certain TS.
-  int GetLeaderLoad(const TabletServerId& ts_uuid) const {
-    return per_ts_meta_.at(ts_uuid).leaders.size();
+  double GetLeaderLoad(const TabletServerId& ts_uuid) const {
+    const auto& leaders = per_ts_meta_.at(ts_uuid).leaders;
+    if (!FLAGS_load_balancer_use_tablet_load) {
+      return leaders.size();
+    }
+    double load = 0;
+    for (const auto& tablet_id : leaders) {
+      load += GetLeaderWeight(tablet_id);
+    }
+    return load;
+  }
+
+  double GetReplicaWeight(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it == per_tablet_meta_.end() ? 1 : it->second.replica_weight;
+  }
+
+  double GetLeaderWeight(const TabletId& tablet_id) const {
+    auto it = per_tablet_meta_.find(tablet_id);
+    return it == per_tablet_meta_.end() ? 1 : it->second.leader_weight;
+  }
+
+  // Weighs the tablets of the table by the load their tablet servers reported for them, relative
+  // to the mean load of the tablets of the table. A tablet with the mean load weighs 1, so the
+  // weighted load of a tablet server stays comparable to its number of tablets.
+  //
+  // The part of the weight of a replica that is not attributed to its ops or its size is the same
+  // for all tablets, so some of the balancing by tablet count is kept. Leaders serve the ops, so
+  // the weight of a leader only depends on them.
+  void ComputeTabletWeights() {
+    if (!FLAGS_load_balancer_use_tablet_load || per_tablet_meta_.empty()) {
+      return;
+    }
+    double total_ops = 0;
+    double total_size = 0;
+    for (const auto& entry : per_tablet_meta_) {
+      total_ops += entry.second.ops_per_sec;
+      total_size += entry.second.sst_file_size;
+    }
+    const double mean_ops = total_ops / per_tablet_meta_.size();
+    const double mean_size = total_size / per_tablet_meta_.size();
+    const double ops_weight = std::max(0.0, FLAGS_load_balancer_tablet_ops_weight);
+    const double size_weight = std::max(0.0, FLAGS_load_balancer_tablet_size_weight);
+    const double count_weight = std::max(0.0, 1 - ops_weight - size_weight);
+    for (auto& entry : per_tablet_meta_) {
+      auto& tablet_meta = entry.second;
+      const double relative_ops = mean_ops > 0 ? tablet_meta.ops_per_sec / mean_ops : 1;
+      const double relative_size = mean_size > 0 ? tablet_meta.sst_file_size / mean_size : 1;
+      tablet_meta.replica_weight =
+          count_weight + ops_weight * relative_ops + size_weight * relative_size;
+      tablet_meta.leader_weight = std::max(0.0, 1 - ops_weight) + ops_weight * relative_ops;
+    }
   }
 
   void SetBlacklist(const BlacklistPB& blacklist) { blacklist_ = blacklist; }
 
+  // Sets the cluster balanced in this run. Live replicas are balanced across the tablet servers
+  // that are not in any read replica cluster. Read replicas of a cluster are balanced across the
+  // tablet servers with its placement uuid, following its placement.
+  void SetCluster(ReplicaType replica_type, const PlacementInfoPB& read_replica_placement,
+                  std::set<std::string> read_replica_placement_uuids) {
+    replica_type_ = replica_type;
+    read_replica_placement_ = read_replica_placement;
+    read_replica_placement_uuids_ = std::move(read_replica_placement_uuids);
+  }
+
+  bool IsTsInCluster(const TSDescriptor& ts_desc) const {
+    if (replica_type_ == ReplicaType::kLive) {
+      return !read_replica_placement_uuids_.count(ts_desc.placement_uuid());
+    }
+    return ts_desc.placement_uuid() == read_replica_placement_.placement_uuid();
+  }
+
+  // Whether the replica is balanced in this run. Observers are attributed to the read replica
+  // cluster of their tablet server.
+  bool IsReplicaInCluster(const TabletReplica& replica) const {
+    const bool observer = replica.member_type == consensus::RaftPeerPB::OBSERVER ||
+                          replica.member_type == consensus::RaftPeerPB::PRE_OBSERVER;
+    if (replica_type_ == ReplicaType::kLive) {
+      return !observer;
+    }
+    return observer && IsTsInCluster(*replica.ts_desc);
+  }
+
+  // Member type of the replicas added in this run.
+  consensus::RaftPeerPB::MemberType NewReplicaMemberType() const {
+    return replica_type_ == ReplicaType::kLive ? consensus::RaftPeerPB::PRE_VOTER
+                                               : consensus::RaftPeerPB::PRE_OBSERVER;
+  }
+
   // Update the per-tablet information for this tablet.
   Status UpdateTablet(TabletInfo* tablet) {
     const auto& tablet_id = tablet->id();
@@ -249,6 +367,13 @@ class ClusterLoadState {
     // Get replicas for this tablet.
     TabletInfo::ReplicaMap replica_map;
     GetReplicaLocations(tablet, &replica_map);
+    for (auto it = replica_map.begin(); it != replica_map.end();) {
+      if (IsReplicaInCluster(it->second)) {
+        ++it;
+      } else {
+        it = replica_map.erase(it);
+      }
+    }
     // Set state information for both the tablet and the tablet server replicas.
     for (const auto& replica : replica_map) {
       const auto& ts_uuid = replica.first;
@@ -268,6 +393,17 @@ class ClusterLoadState {
                                  ts_uuid);
       }
 
+      if (FLAGS_load_balancer_use_tablet_load) {
+        auto tablet_load = ts_meta_it->second.descriptor->GetTabletLoad(tablet_id);
+        if (tablet_load) {
+          tablet_meta.ops_per_sec = std::max(
+              tablet_meta.ops_per_sec,
+              tablet_load->read_ops_per_sec + tablet_load->write_ops_per_sec);
+          tablet_meta.sst_file_size = std::max(
+              tablet_meta.sst_file_size, tablet_load->sst_file_size);
+        }
+      }
+
       // Fill leader info.
       if (replica.second.role == consensus::RaftPeerPB::LEADER) {
         tablet_meta.leader_uuid = ts_uuid;
@@ -291,6 +427,11 @@ class ClusterLoadState {
       if (blacklisted_servers_.count(ts_uuid)) {
         tablet_meta.blacklisted_tablet_servers.insert(ts_uuid);
       }
+
+      // Live replicas placed on tablet servers of a read replica cluster should move back.
+      if (!IsTsInCluster(*ts_meta_it->second.descriptor)) {
+        tablet_meta.wrong_placement_tablet_servers.insert(ts_uuid);
+      }
     }
 
     // Only set the over-replication section if we need to.
@@ -377,6 +518,11 @@ class ClusterLoadState {
     auto& ts_meta = per_ts_meta_[ts_uuid];
     ts_meta.descriptor = ts_desc;
 
+    // Tablet servers of other clusters are only tracked to account for the replicas they host.
+    if (!IsTsInCluster(*ts_desc)) {
+      return;
+    }
+
     sorted_load_.push_back(ts_uuid);
 
     // Mark as blacklisted if it matches.
@@ -390,8 +536,9 @@ class ClusterLoadState {
     }
 
     // Add this tablet server for leader load-balancing only if it is not blacklisted and it has
-    // heartbeated recently enough to be considered responsive for leader balancing.
-    if (!is_blacklisted &&
+    // heartbeated recently enough to be considered responsive for leader balancing. Read replicas
+    // are never leaders.
+    if (!is_blacklisted && replica_type_ == ReplicaType::kLive &&
         ts_desc->TimeSinceHeartbeat().ToMilliseconds() <
         FLAGS_leader_balance_unresponsive_timeout_ms) {
       sorted_leader_load_.push_back(ts_uuid);
@@ -575,6 +722,31 @@ class ClusterLoadState {
     sort(sorted_leader_load_.begin(), sorted_leader_load_.end(), leader_count_comparator);
   }
 
+  int GetLeaderAffinityRank(const TabletServerId& ts_uuid) const {
+    return CatalogManagerUtil::GetLeaderAffinityRank(
+        leader_affinity_, per_ts_meta_.at(ts_uuid).descriptor->placement_id());
+  }
+
+  // Keeps in sorted_leader_load_ only the tablet servers of the most preferred zones that have a
+  // tablet server eligible for leader load. The other eligible tablet servers are moved to
+  // non_affinitized_leader_servers_, so their leaders are moved to the preferred zones.
+  void ApplyLeaderAffinity() {
+    if (!CatalogManagerUtil::HasLeaderAffinity(leader_affinity_)) {
+      return;
+    }
+    int best_rank = std::numeric_limits<int>::max();
+    for (const auto& ts_uuid : sorted_leader_load_) {
+      best_rank = std::min(best_rank, GetLeaderAffinityRank(ts_uuid));
+    }
+    auto non_affinitized_begin = std::stable_partition(
+        sorted_leader_load_.begin(), sorted_leader_load_.end(),
+        [this, best_rank](const TabletServerId& ts_uuid) {
+          return GetLeaderAffinityRank(ts_uuid) == best_rank;
+        });
+    non_affinitized_leader_servers_.assign(non_affinitized_begin, sorted_leader_load_.end());
+    sorted_leader_load_.erase(non_affinitized_begin, sorted_leader_load_.end());
+  }
+
   inline bool IsLeaderLoadBelowThreshold(const TabletServerId& ts_uuid) {
     return ((leader_balance_threshold_ > 0) &&
             (GetLeaderLoad(ts_uuid) <= leader_balance_threshold_));
@@ -656,6 +828,13 @@ class ClusterLoadState {
   // If affinitized leaders is enabled, stores leader load for affinitized nodes.
   vector<TabletServerId> sorted_leader_load_;
 
+  // The preferred zones for the leaders of the table, in the fields of ReplicationInfoPB.
+  ReplicationInfoPB leader_affinity_;
+
+  // Tablet servers eligible for leader load that are in less preferred zones than the tablet
+  // servers in sorted_leader_load_. All their leaders should move to the preferred zones.
+  vector<TabletServerId> non_affinitized_leader_servers_;
+
   unordered_map<TableId, TabletToTabletServerMap> pending_add_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_remove_replica_tasks_;
   unordered_map<TableId, TabletToTabletServerMap> pending_stepdown_leader_tasks_;
@@ -666,6 +845,11 @@ class ClusterLoadState {
   // The knobs we use for tweaking the flow of the algorithm.
   Options* options_;
 
+  // The cluster balanced in this run, see SetCluster.
+  ReplicaType replica_type_ = ReplicaType::kLive;
+  PlacementInfoPB read_replica_placement_;
+  std::set<std::string> read_replica_placement_uuids_;
+
  private:
   DISALLOW_COPY_AND_ASSIGN(ClusterLoadState);
 }; // ClusterLoadState
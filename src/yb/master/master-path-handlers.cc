@@ -45,6 +45,7 @@
 #include "yb/gutil/stringprintf.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/master/cluster_balance.h"
 #include "yb/master/master.h"
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
@@ -1158,6 +1159,45 @@ void MasterPathHandlers::HandleGetClusterConfig(
   << "<pre class=\"prettyprint\">" << config.DebugString() << "</pre>";
 }
 
+void MasterPathHandlers::HandleLoadBalancer(
+    const Webserver::WebRequest& req, stringstream* output) {
+  master_->catalog_manager()->AssertLeaderLockAcquiredForReading();
+
+  *output << std::setprecision(output_precision_);
+  *output << "<h1>Load Balancer</h1>\n";
+
+  *output << "<h2>Tablet Server Load</h2>\n";
+  vector<std::shared_ptr<TSDescriptor>> descs;
+  master_->ts_manager()->GetAllDescriptors(&descs);
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Server</th><th>Read ops/sec</th><th>Write ops/sec</th>"
+          << "<th>SST Files Size</th><th>Tablets With Reported Load</th></tr>\n";
+  for (const auto& desc : descs) {
+    *output << "  <tr><td>" << EscapeForHtmlToString(desc->permanent_uuid()) << "</td>"
+            << "<td>" << desc->read_ops_per_sec() << "</td>"
+            << "<td>" << desc->write_ops_per_sec() << "</td>"
+            << "<td>" << BytesToHumanReadable(desc->total_sst_file_size()) << "</td>"
+            << "<td>" << desc->num_tablet_loads() << "</td></tr>\n";
+  }
+  *output << "</table>\n";
+
+  *output << "<h2>Recent Moves</h2>\n";
+  auto moves = master_->catalog_manager()->load_balancer()->GetRecentMoves();
+  const auto now = MonoTime::Now();
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Seconds Ago</th><th>Action</th><th>Tablet</th><th>From</th><th>To</th>"
+          << "<th>Weight</th></tr>\n";
+  // Latest moves first.
+  for (auto it = moves.rbegin(); it != moves.rend(); ++it) {
+    *output << "  <tr><td>" << (now - it->time).ToSeconds() << "</td>"
+            << "<td>" << it->action << "</td>"
+            << "<td>" << EscapeForHtmlToString(it->tablet_id) << "</td>"
+            << "<td>" << EscapeForHtmlToString(it->from_ts) << "</td>"
+            << "<td>" << EscapeForHtmlToString(it->to_ts) << "</td>"
+            << "<td>" << it->weight << "</td></tr>\n";
+  }
+  *output << "</table>\n";
+}
 
 Status MasterPathHandlers::Register(Webserver* server) {
   bool is_styled = true;
@@ -1201,6 +1241,11 @@ Status MasterPathHandlers::Register(Webserver* server) {
       "/cluster-config", "Cluster Config",
       std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
       false);
+  cb = std::bind(&MasterPathHandlers::HandleLoadBalancer, this, _1, _2);
+  server->RegisterPathHandler(
+      "/load-balancer", "Load Balancer",
+      std::bind(&MasterPathHandlers::CallIfLeaderOrPrintRedirect, this, _1, _2, cb), is_styled,
+      false);
   return Status::OK();
 }
 
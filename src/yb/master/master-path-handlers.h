@@ -156,6 +156,7 @@ class MasterPathHandlers {
   void HandleGetTserverStatus(const Webserver::WebRequest& req,
                           std::stringstream* output);
   void HandleGetClusterConfig(const Webserver::WebRequest& req, std::stringstream* output);
+  void HandleLoadBalancer(const Webserver::WebRequest& req, std::stringstream* output);
 
   // Calcuates number of leaders/followers per table.
   void CalculateTabletMap(TabletCountMap* tablet_map);
@@ -187,7 +187,7 @@ void MasterServiceImpl::TSHeartbeat(const TSHeartbeatRequestPB* req,
     }
   }
 
-  if (!ts_desc->has_tablet_report()) {
+  if (!ts_desc->has_tablet_report() && !ts_desc->has_partial_tablet_report()) {
     resp->set_needs_full_tablet_report(true);
   }
 
@@ -444,6 +444,40 @@ TEST_F(SysCatalogTest, TestTabletInfoCommit) {
   }
 }
 
+// Visit tables and tablets with a single scan of the sys catalog.
+TEST_F(SysCatalogTest, TestVisitMultipleEntryTypes) {
+  scoped_refptr<TableInfo> table(new TableInfo("abc"));
+  scoped_refptr<TabletInfo> tablet(CreateTablet(table.get(), "123", "a", "b"));
+
+  SysCatalogTable* sys_catalog = master_->catalog_manager()->sys_catalog();
+  {
+    auto l = table->LockForWrite();
+    l->mutable_data()->pb.set_name("testtb");
+    l->mutable_data()->pb.set_state(SysTablesEntryPB::RUNNING);
+    SchemaToPB(Schema(), l->mutable_data()->pb.mutable_schema());
+    ASSERT_OK(sys_catalog->AddItem(table.get(), kLeaderTerm));
+    l->Commit();
+  }
+  {
+    auto l = tablet->LockForWrite();
+    ASSERT_OK(sys_catalog->AddItem(tablet.get(), kLeaderTerm));
+    l->Commit();
+  }
+
+  TestTableLoader table_loader;
+  TestTabletLoader tablet_loader;
+  ASSERT_OK(sys_catalog->Visit(std::vector<VisitorBase*>{&table_loader, &tablet_loader}));
+  ASSERT_EQ(1 + kNumSystemTables, table_loader.tables.size());
+  ASSERT_EQ(1 + kNumSystemTables, tablet_loader.tablets.size());
+  ASSERT_TRUE(MetadatasEqual(table.get(), table_loader.tables[table->id()]));
+  ASSERT_TRUE(MetadatasEqual(tablet.get(), tablet_loader.tablets[tablet->id()]));
+
+  // Visiting only tablets gives the same result as visiting them together with the tables.
+  TestTabletLoader only_tablet_loader;
+  ASSERT_OK(sys_catalog->Visit(&only_tablet_loader));
+  ASSERT_EQ(tablet_loader.tablets.size(), only_tablet_loader.tablets.size());
+}
+
 class TestClusterConfigLoader : public Visitor<PersistentClusterConfigInfo> {
  public:
   TestClusterConfigLoader() {}
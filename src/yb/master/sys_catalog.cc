@@ -511,6 +511,8 @@ Status SysCatalogTable::OpenTablet(const scoped_refptr<tablet::RaftGroupMetadata
                                                      tablet->GetMetricEntity(),
                                                      raft_pool(),
                                                      tablet_prepare_pool(),
+                                                     nullptr /* apply_pool */,
+                                                     nullptr /* txn_apply_pool */,
                                                      nullptr /* retryable_requests */),
                         "Failed to Init() TabletPeer");
 
@@ -629,9 +631,27 @@ void SysCatalogTable::InitLocalRaftPeerPB() {
 }
 
 Status SysCatalogTable::Visit(VisitorBase* visitor) {
+  return Visit(std::vector<VisitorBase*>{visitor});
+}
+
+Status SysCatalogTable::Visit(const std::vector<VisitorBase*>& visitors) {
   TRACE_EVENT0("master", "Visitor::VisitAll");
 
-  const int8_t tables_entry = visitor->entry_type();
+  // Visitors indexed by the entry type they handle.
+  std::vector<VisitorBase*> visitor_by_type;
+  for (auto* visitor : visitors) {
+    const size_t type = visitor->entry_type();
+    if (type >= visitor_by_type.size()) {
+      visitor_by_type.resize(type + 1);
+    }
+    DCHECK(!visitor_by_type[type]) << "Duplicate visitor for entry type " << type;
+    visitor_by_type[type] = visitor;
+  }
+  if (visitor_by_type.empty()) {
+    return Status::OK();
+  }
+  const int max_entry_type = visitor_by_type.size() - 1;
+
   const int type_col_idx = schema_.find_column(kSysCatalogTableColType);
   const int entry_id_col_idx = schema_.find_column(kSysCatalogTableColId);
   const int metadata_col_idx = schema_.find_column(kSysCatalogTableColMetadata);
@@ -649,12 +669,21 @@ Status SysCatalogTable::Visit(VisitorBase* visitor) {
   while (VERIFY_RESULT((**iter).HasNext())) {
     RETURN_NOT_OK((**iter).NextRow(&value_map));
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(type_col_idx), &entry_type));
-    if (entry_type.int8_value() != tables_entry) {
+    const int type = entry_type.int8_value();
+    // The entry type is the first key column, so there is nothing left to visit.
+    if (type > max_entry_type) {
+      break;
+    }
+    VisitorBase* visitor = type >= 0 ? visitor_by_type[type] : nullptr;
+    if (!visitor) {
       continue;
     }
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(entry_id_col_idx), &entry_id));
     RETURN_NOT_OK(value_map.GetValue(schema_with_ids_.column_id(metadata_col_idx), &metadata));
-    RETURN_NOT_OK(visitor->Visit(entry_id.binary_value(), metadata.binary_value()));
+    RETURN_NOT_OK_PREPEND(
+        visitor->Visit(entry_id.binary_value(), metadata.binary_value()),
+        Format("Failed while visiting $0 in sys catalog", SysRowEntry::Type_Name(
+            static_cast<SysRowEntry::Type>(type))));
   }
   return Status::OK();
 }
@@ -152,6 +152,11 @@ class SysCatalogTable {
 
   CHECKED_STATUS Visit(VisitorBase* visitor);
 
+  // Scans the sys catalog once, passing each entry to the visitor registered for its type.
+  // Entries are ordered by type, so e.g. all tables are visited before the first tablet.
+  // The scan stops after the last entry of the highest visited type.
+  CHECKED_STATUS Visit(const std::vector<VisitorBase*>& visitors);
+
   // Copy the content of a co-located table in sys catalog.
   CHECKED_STATUS CopyPgsqlTable(const TableId& source_table_id,
                                 const TableId& target_table_id,
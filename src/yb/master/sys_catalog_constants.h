@@ -42,6 +42,11 @@ static const char* const kSysCatalogTableColType = "entry_type";
 static const char* const kSysCatalogTableColId = "entry_id";
 static const char* const kSysCatalogTableColMetadata = "metadata";
 
+// The parent table of a colocated namespace owns the tablet shared by all its tables. Its id and
+// name are the namespace id followed by these suffixes.
+static const char* const kColocatedParentTableIdSuffix = ".colocated.parent.uuid";
+static const char* const kColocatedParentTableNameSuffix = ".colocated.parent.tablename";
+
 static const char* const kDefaultCassandraUsername = "cassandra";
 static const char* const kDefaultCassandraPassword = "cassandra";
 
@@ -0,0 +1,95 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/common/partition.h"
+#include "yb/master/tablet_split_manager.h"
+#include "yb/util/test_util.h"
+
+DECLARE_int64(tablet_split_size_threshold_bytes);
+DECLARE_double(tablet_split_ops_threshold);
+
+namespace yb {
+namespace master {
+
+namespace {
+
+TabletSplitManager::TabletSplitInput MakeInput(
+    const TabletId& tablet_id, uint16_t hash_start, uint16_t hash_end,
+    uint64_t sst_file_size, double ops_per_sec) {
+  TabletSplitManager::TabletSplitInput input;
+  input.tablet_id = tablet_id;
+  input.hash_schema = PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA;
+  if (hash_start != 0) {
+    input.partition.set_partition_key_start(PartitionSchema::EncodeMultiColumnHashValue(hash_start));
+  }
+  if (hash_end != 0) {
+    input.partition.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(hash_end));
+  }
+  input.load.sst_file_size = sst_file_size;
+  input.load.read_ops_per_sec = ops_per_sec;
+  return input;
+}
+
+} // namespace
+
+TEST(TabletSplitManagerTest, GetSplitPartitionKey) {
+  PartitionPB partition;
+  auto key = ASSERT_RESULT(TabletSplitManager::GetSplitPartitionKey(
+      PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA, partition));
+  ASSERT_EQ(0x8000, PartitionSchema::DecodeMultiColumnHashValue(key));
+
+  partition.set_partition_key_start(PartitionSchema::EncodeMultiColumnHashValue(0x1000));
+  partition.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(0x2000));
+  key = ASSERT_RESULT(TabletSplitManager::GetSplitPartitionKey(
+      PartitionSchemaPB::PGSQL_HASH_SCHEMA, partition));
+  ASSERT_EQ(0x1800, PartitionSchema::DecodeMultiColumnHashValue(key));
+
+  // A single hash value cannot be split.
+  partition.set_partition_key_end(PartitionSchema::EncodeMultiColumnHashValue(0x1001));
+  ASSERT_NOK(TabletSplitManager::GetSplitPartitionKey(
+      PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA, partition));
+
+  ASSERT_NOK(TabletSplitManager::GetSplitPartitionKey(
+      PartitionSchemaPB::REDIS_HASH_SCHEMA, PartitionPB()));
+}
+
+TEST(TabletSplitManagerTest, SelectSplitCandidates) {
+  FLAGS_tablet_split_size_threshold_bytes = 1000;
+  FLAGS_tablet_split_ops_threshold = 100;
+
+  std::vector<TabletSplitManager::TabletSplitInput> inputs = {
+      MakeInput("small", 0, 0x4000, 10, 1),
+      MakeInput("large", 0x4000, 0x8000, 3000, 1),
+      MakeInput("hot", 0x8000, 0xc000, 10, 500),
+      MakeInput("unsplittable", 0xc000, 0xc001, 5000, 1),
+  };
+
+  auto candidates = TabletSplitManager::SelectSplitCandidates(inputs, 10);
+  ASSERT_EQ(2, candidates.size());
+  // The hot tablet exceeds its threshold the most, so it comes first.
+  ASSERT_EQ("hot", candidates[0].tablet_id);
+  ASSERT_EQ(0xa000, PartitionSchema::DecodeMultiColumnHashValue(
+      candidates[0].split_partition_key));
+  ASSERT_EQ("large", candidates[1].tablet_id);
+  ASSERT_EQ(0x6000, PartitionSchema::DecodeMultiColumnHashValue(
+      candidates[1].split_partition_key));
+
+  candidates = TabletSplitManager::SelectSplitCandidates(inputs, 1);
+  ASSERT_EQ(1, candidates.size());
+  ASSERT_EQ("hot", candidates[0].tablet_id);
+}
+
+} // namespace master
+} // namespace yb
@@ -0,0 +1,188 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/master/tablet_split_manager.h"
+
+#include <algorithm>
+
+#include "yb/common/partition.h"
+
+#include "yb/master/catalog_entity_info.h"
+#include "yb/master/catalog_manager.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(enable_automatic_tablet_splitting, false,
+            "Whether the master leader picks the tablets that should be split because of their "
+            "size or their load.");
+TAG_FLAG(enable_automatic_tablet_splitting, experimental);
+
+DEFINE_int64(tablet_split_size_threshold_bytes, 10LL * 1024 * 1024 * 1024,
+             "SST size above which a tablet should be split.");
+TAG_FLAG(tablet_split_size_threshold_bytes, advanced);
+
+DEFINE_double(tablet_split_ops_threshold, 10000,
+              "Read and write operations per second on the leader above which a tablet should be "
+              "split.");
+TAG_FLAG(tablet_split_ops_threshold, advanced);
+
+DEFINE_int32(tablet_split_max_per_run, 1,
+             "Maximum number of tablets picked for splitting in one run of the catalog manager "
+             "background tasks.");
+TAG_FLAG(tablet_split_max_per_run, advanced);
+
+DEFINE_int32(tablet_split_cooldown_sec, 600,
+             "Minimal time between two picks of the same tablet for splitting.");
+TAG_FLAG(tablet_split_cooldown_sec, advanced);
+
+namespace yb {
+namespace master {
+
+namespace {
+
+// How much the load of the tablet exceeds the split thresholds, a value of 1 or more means that
+// the tablet should be split.
+double SplitScore(const TSDescriptor::TabletLoad& load) {
+  double score = 0;
+  if (FLAGS_tablet_split_size_threshold_bytes > 0) {
+    score = static_cast<double>(load.sst_file_size) / FLAGS_tablet_split_size_threshold_bytes;
+  }
+  if (FLAGS_tablet_split_ops_threshold > 0) {
+    score = std::max(
+        score,
+        (load.read_ops_per_sec + load.write_ops_per_sec) / FLAGS_tablet_split_ops_threshold);
+  }
+  return score;
+}
+
+} // namespace
+
+void TabletSplitManager::Run() {
+  if (!FLAGS_enable_automatic_tablet_splitting) {
+    return;
+  }
+
+  const auto now = MonoTime::Now();
+  const auto cooldown = MonoDelta::FromSeconds(FLAGS_tablet_split_cooldown_sec);
+  for (auto it = last_pick_time_.begin(); it != last_pick_time_.end();) {
+    if (now - it->second >= cooldown) {
+      it = last_pick_time_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  std::vector<scoped_refptr<TableInfo>> tables;
+  catalog_manager_->GetAllTables(&tables, true /* includeOnlyRunningTables */);
+  std::vector<TabletSplitInput> inputs;
+  for (const auto& table : tables) {
+    if (catalog_manager_->IsSystemTable(*table) || table->colocated()) {
+      continue;
+    }
+    PartitionSchemaPB partition_schema;
+    {
+      auto l = table->LockForRead();
+      partition_schema = l->data().pb.partition_schema();
+    }
+    if (!partition_schema.has_hash_schema()) {
+      continue;
+    }
+
+    std::vector<scoped_refptr<TabletInfo>> tablets;
+    table->GetAllTablets(&tablets);
+    for (const auto& tablet : tablets) {
+      if (last_pick_time_.count(tablet->id())) {
+        continue;
+      }
+      TabletInfo::ReplicaMap replicas;
+      tablet->GetReplicaLocations(&replicas);
+      for (const auto& replica : replicas) {
+        if (replica.second.role != consensus::RaftPeerPB::LEADER) {
+          continue;
+        }
+        auto load = replica.second.ts_desc->GetTabletLoad(tablet->id());
+        if (load) {
+          auto l = tablet->LockForRead();
+          inputs.push_back(TabletSplitInput{
+              tablet->id(), partition_schema.hash_schema(), l->data().pb.partition(), *load});
+        }
+        break;
+      }
+    }
+  }
+
+  last_candidates_ = SelectSplitCandidates(inputs, FLAGS_tablet_split_max_per_run);
+  for (const auto& candidate : last_candidates_) {
+    last_pick_time_[candidate.tablet_id] = now;
+    LOG(INFO) << "Tablet " << candidate.tablet_id << " should be split at partition key "
+              << Slice(candidate.split_partition_key).ToDebugHexString() << ": "
+              << candidate.reason;
+  }
+}
+
+std::vector<TabletSplitManager::SplitCandidate> TabletSplitManager::SelectSplitCandidates(
+    const std::vector<TabletSplitInput>& inputs, size_t max_candidates) {
+  std::vector<std::pair<double, const TabletSplitInput*>> scored_inputs;
+  for (const auto& input : inputs) {
+    auto score = SplitScore(input.load);
+    if (score >= 1) {
+      scored_inputs.emplace_back(score, &input);
+    }
+  }
+  std::sort(scored_inputs.begin(), scored_inputs.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.first > rhs.first;
+  });
+
+  std::vector<SplitCandidate> result;
+  for (const auto& scored_input : scored_inputs) {
+    if (result.size() >= max_candidates) {
+      break;
+    }
+    const auto& input = *scored_input.second;
+    auto split_partition_key = GetSplitPartitionKey(input.hash_schema, input.partition);
+    if (!split_partition_key.ok()) {
+      VLOG(1) << "Cannot split tablet " << input.tablet_id << ": " << split_partition_key.status();
+      continue;
+    }
+    result.push_back(SplitCandidate{
+        input.tablet_id, std::move(*split_partition_key),
+        Format("SST size: $0, read ops/s: $1, write ops/s: $2",
+               input.load.sst_file_size, input.load.read_ops_per_sec,
+               input.load.write_ops_per_sec)});
+  }
+  return result;
+}
+
+Result<std::string> TabletSplitManager::GetSplitPartitionKey(
+    PartitionSchemaPB::HashSchema hash_schema, const PartitionPB& partition) {
+  if (hash_schema != PartitionSchemaPB::MULTI_COLUMN_HASH_SCHEMA &&
+      hash_schema != PartitionSchemaPB::PGSQL_HASH_SCHEMA) {
+    return STATUS_FORMAT(NotSupported, "Cannot pick split key for hash schema $0",
+                         PartitionSchemaPB::HashSchema_Name(hash_schema));
+  }
+  const auto& key_start = partition.partition_key_start();
+  const auto& key_end = partition.partition_key_end();
+  const uint32_t hash_start =
+      key_start.empty() ? 0 : PartitionSchema::DecodeMultiColumnHashValue(key_start);
+  const uint32_t hash_end = key_end.empty()
+      ? PartitionSchema::kMaxPartitionKey + 1
+      : PartitionSchema::DecodeMultiColumnHashValue(key_end);
+  if (hash_end < hash_start + 2) {
+    return STATUS_FORMAT(IllegalState, "Hash range [$0, $1) is too small to split",
+                         hash_start, hash_end);
+  }
+  return PartitionSchema::EncodeMultiColumnHashValue(hash_start + (hash_end - hash_start) / 2);
+}
+
+} // namespace master
+} // namespace yb
@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+#ifndef YB_MASTER_TABLET_SPLIT_MANAGER_H
+#define YB_MASTER_TABLET_SPLIT_MANAGER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/common/common.pb.h"
+#include "yb/common/entity_ids.h"
+#include "yb/master/ts_descriptor.h"
+#include "yb/util/monotime.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace master {
+
+class CatalogManager;
+
+// Automatic tablet splitting policy.
+//
+// Picks the tablets that grew too large or too hot, using the SST size and the read and write
+// rates their leaders report in heartbeats, and the partition key at which each of them should be
+// split. The number of tablets picked per run and how often the same tablet could be picked again
+// are throttled.
+//
+// Splitting the picked tablets needs a replicated split operation on the tablet servers, which does
+// not exist yet, so for now they are logged and exposed through last_candidates().
+class TabletSplitManager {
+ public:
+  // A tablet and the load reported by its leader.
+  struct TabletSplitInput {
+    TabletId tablet_id;
+    PartitionSchemaPB::HashSchema hash_schema;
+    PartitionPB partition;
+    TSDescriptor::TabletLoad load;
+  };
+
+  struct SplitCandidate {
+    TabletId tablet_id;
+    // The first partition key of the second child tablet.
+    std::string split_partition_key;
+    std::string reason;
+  };
+
+  explicit TabletSplitManager(CatalogManager* catalog_manager)
+      : catalog_manager_(catalog_manager) {}
+
+  // Picks the tablets of the user tables that should be split. Called by the catalog manager
+  // background tasks on the master leader.
+  void Run();
+
+  // The tablets picked by the last run.
+  const std::vector<SplitCandidate>& last_candidates() const { return last_candidates_; }
+
+  // Returns the tablets among inputs that exceed the split thresholds, the most loaded first, at
+  // most max_candidates of them. Tablets that could not be split are skipped.
+  static std::vector<SplitCandidate> SelectSplitCandidates(
+      const std::vector<TabletSplitInput>& inputs, size_t max_candidates);
+
+  // Returns the partition key in the middle of the hash range of the partition. Only hash
+  // partitioned tablets are supported: the rows of a range partitioned tablet are not spread
+  // uniformly over its key range, so the tablet server would have to pick the key.
+  static Result<std::string> GetSplitPartitionKey(
+      PartitionSchemaPB::HashSchema hash_schema, const PartitionPB& partition);
+
+ private:
+  CatalogManager* const catalog_manager_;
+
+  // When each tablet was last picked, for the tablet_split_cooldown_sec throttling.
+  std::unordered_map<TabletId, MonoTime> last_pick_time_;
+
+  std::vector<SplitCandidate> last_candidates_;
+};
+
+} // namespace master
+} // namespace yb
+
+#endif // YB_MASTER_TABLET_SPLIT_MANAGER_H
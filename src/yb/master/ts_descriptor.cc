@@ -40,6 +40,7 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/consensus/consensus.proxy.h"
 #include "yb/gutil/strings/substitute.h"
+#include "yb/master/catalog_manager_util.h"
 #include "yb/master/master.pb.h"
 #include "yb/tserver/tserver_admin.proxy.h"
 #include "yb/tserver/tserver_service.proxy.h"
@@ -48,6 +49,13 @@
 namespace yb {
 namespace master {
 
+namespace {
+
+// Weight of the latest reported rates of a tablet in its smoothed rates.
+constexpr double kTabletLoadSmoothingFactor = 0.3;
+
+} // namespace
+
 Result<TSDescriptorPtr> TSDescriptor::RegisterNew(
     const NodeInstancePB& instance,
     const TSRegistrationPB& registration,
@@ -103,6 +111,7 @@ Status TSDescriptor::RegisterUnlocked(
   latest_seqno_ = instance.instance_seqno();
   // After re-registering, make the TS re-report its tablets.
   has_tablet_report_ = false;
+  has_partial_tablet_report_ = false;
 
   registration_.reset(new TSRegistrationPB(registration));
   placement_id_ = generate_placement_id(registration.common().cloud_info());
@@ -158,6 +167,17 @@ bool TSDescriptor::has_tablet_report() const {
 void TSDescriptor::set_has_tablet_report(bool has_report) {
   std::lock_guard<rw_spinlock> l(lock_);
   has_tablet_report_ = has_report;
+  has_partial_tablet_report_ = false;
+}
+
+bool TSDescriptor::has_partial_tablet_report() const {
+  std::shared_lock<rw_spinlock> l(lock_);
+  return has_partial_tablet_report_;
+}
+
+void TSDescriptor::set_has_partial_tablet_report(bool has_partial_report) {
+  std::lock_guard<rw_spinlock> l(lock_);
+  has_partial_tablet_report_ = has_partial_report;
 }
 
 void TSDescriptor::DecayRecentReplicaCreationsUnlocked() {
@@ -242,7 +262,7 @@ Result<HostPort> TSDescriptor::GetHostPortUnlocked() const {
 }
 
 bool TSDescriptor::IsAcceptingLeaderLoad(const ReplicationInfoPB& replication_info) const {
-  return true;
+  return CatalogManagerUtil::GetLeaderAffinityRank(replication_info, placement_id()) == 0;
 }
 
 void TSDescriptor::UpdateMetrics(const TServerMetricsPB& metrics) {
@@ -253,6 +273,33 @@ void TSDescriptor::UpdateMetrics(const TServerMetricsPB& metrics) {
   ts_metrics_.read_ops_per_sec = metrics.read_ops_per_sec();
   ts_metrics_.write_ops_per_sec = metrics.write_ops_per_sec();
   ts_metrics_.uptime_seconds = metrics.uptime_seconds();
+
+  // Rates are smoothed, so a short burst on a tablet does not make the load balancer move it.
+  std::unordered_map<std::string, TabletLoad> tablet_loads;
+  for (const auto& tablet_load_pb : metrics.tablet_loads()) {
+    auto& tablet_load = tablet_loads[tablet_load_pb.tablet_id()];
+    tablet_load.read_ops_per_sec = tablet_load_pb.read_ops_per_sec();
+    tablet_load.write_ops_per_sec = tablet_load_pb.write_ops_per_sec();
+    tablet_load.sst_file_size = tablet_load_pb.sst_file_size();
+    auto it = ts_metrics_.tablet_loads.find(tablet_load_pb.tablet_id());
+    if (it != ts_metrics_.tablet_loads.end()) {
+      tablet_load.read_ops_per_sec = kTabletLoadSmoothingFactor * tablet_load.read_ops_per_sec +
+          (1 - kTabletLoadSmoothingFactor) * it->second.read_ops_per_sec;
+      tablet_load.write_ops_per_sec = kTabletLoadSmoothingFactor * tablet_load.write_ops_per_sec +
+          (1 - kTabletLoadSmoothingFactor) * it->second.write_ops_per_sec;
+    }
+  }
+  ts_metrics_.tablet_loads = std::move(tablet_loads);
+}
+
+boost::optional<TSDescriptor::TabletLoad> TSDescriptor::GetTabletLoad(
+    const std::string& tablet_id) const {
+  std::shared_lock<rw_spinlock> l(lock_);
+  auto it = ts_metrics_.tablet_loads.find(tablet_id);
+  if (it == ts_metrics_.tablet_loads.end()) {
+    return boost::none;
+  }
+  return it->second;
 }
 
 bool TSDescriptor::HasTabletDeletePending() const {
@@ -37,6 +37,9 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+
+#include <boost/optional.hpp>
 
 #include "yb/gutil/gscoped_ptr.h"
 
@@ -108,8 +111,14 @@ class TSDescriptor {
   int64_t latest_seqno() const;
 
   bool has_tablet_report() const;
+  // Also ends the partial tablet report, if any.
   void set_has_tablet_report(bool has_report);
 
+  // Whether this instance has started to send a full tablet report split into several reports,
+  // and has not sent all of its tablets yet.
+  bool has_partial_tablet_report() const;
+  void set_has_partial_tablet_report(bool has_partial_report);
+
   // Returns TSRegistrationPB for this TSDescriptor.
   TSRegistrationPB GetRegistration() const;
 
@@ -129,7 +138,8 @@ class TSDescriptor {
 
   bool IsRunningOn(const HostPortPB& hp) const;
 
-  // Should this ts have any leader load on it.
+  // Should this ts have any leader load on it, i.e. is it in the most preferred zones for the
+  // leaders.
   virtual bool IsAcceptingLeaderLoad(const ReplicationInfoPB& replication_info) const;
 
   // Return an RPC proxy to a service.
@@ -234,6 +244,23 @@ class TSDescriptor {
     ts_metrics_.ClearMetrics();
   }
 
+  // Load of a tablet replica, smoothed over the heartbeats that reported it.
+  struct TabletLoad {
+    double read_ops_per_sec = 0;
+    double write_ops_per_sec = 0;
+    uint64_t sst_file_size = 0;
+  };
+
+  // Returns the load of the replica of tablet_id hosted by this tablet server, or none if the
+  // tablet server did not report it.
+  boost::optional<TabletLoad> GetTabletLoad(const std::string& tablet_id) const;
+
+  // Number of tablets whose load was reported by this tablet server.
+  size_t num_tablet_loads() const {
+    std::shared_lock<rw_spinlock> l(lock_);
+    return ts_metrics_.tablet_loads.size();
+  }
+
   // Set of methods to keep track of pending tablet deletes for a tablet server. We use them to
   // avoid assigning more tablets to a tserver that might be potentially unresponsive.
   bool HasTabletDeletePending() const;
@@ -290,6 +317,8 @@ class TSDescriptor {
 
     uint64_t uptime_seconds = 0;
 
+    std::unordered_map<std::string, TabletLoad> tablet_loads;
+
     void ClearMetrics() {
       total_memory_usage = 0;
       total_sst_file_size = 0;
@@ -297,6 +326,7 @@ class TSDescriptor {
       read_ops_per_sec = 0;
       write_ops_per_sec = 0;
       uptime_seconds = 0;
+      tablet_loads.clear();
     }
   };
 
@@ -313,6 +343,9 @@ class TSDescriptor {
   // Set to true once this instance has reported all of its tablets.
   bool has_tablet_report_;
 
+  // See has_partial_tablet_report().
+  bool has_partial_tablet_report_ = false;
+
   // The number of times this tablet server has recently been selected to create a
   // tablet replica. This value decays back to 0 over time.
   double recent_replica_creations_;
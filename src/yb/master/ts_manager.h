@@ -32,6 +32,7 @@
 #ifndef YB_MASTER_TS_MANAGER_H
 #define YB_MASTER_TS_MANAGER_H
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -129,6 +130,12 @@ class TSManager {
   static bool IsTsBlacklisted(const TSDescriptorPtr& ts,
                               const BlacklistSet blacklist);
 
+  // Incremented on each registration of a tablet server, so data built from the registrations
+  // could find out that it is stale.
+  uint64_t registration_version() const {
+    return registration_version_.load(std::memory_order_acquire);
+  }
+
  private:
 
   void GetDescriptors(std::function<bool(const TSDescriptorPtr&)> condition,
@@ -139,6 +146,8 @@ class TSManager {
   typedef std::unordered_map<std::string, TSDescriptorPtr> TSDescriptorMap;
   TSDescriptorMap servers_by_id_;
 
+  std::atomic<uint64_t> registration_version_{0};
+
   DISALLOW_COPY_AND_ASSIGN(TSManager);
 };
 
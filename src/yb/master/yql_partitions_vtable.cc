@@ -16,6 +16,14 @@
 #include "yb/common/ql_value.h"
 #include "yb/master/catalog_manager.h"
 #include "yb/master/master_util.h"
+#include "yb/master/ts_manager.h"
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(use_cache_for_partitions_vtable, true,
+            "Keep the rows of system.partitions and rebuild them only when tables, tablets or "
+            "tablet servers change.");
+TAG_FLAG(use_cache_for_partitions_vtable, advanced);
 
 namespace yb {
 namespace master {
@@ -26,7 +34,39 @@ YQLPartitionsVTable::YQLPartitionsVTable(const Master* const master)
 
 Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
                                          std::unique_ptr<QLRowBlock>* vtable) const {
-  vtable->reset(new QLRowBlock(schema_));
+  if (!FLAGS_use_cache_for_partitions_vtable) {
+    vtable->reset(new QLRowBlock(schema_));
+    return GenerateData(vtable->get());
+  }
+
+  // Versions are read before the data, so a change made while the rows are built invalidates them.
+  const auto partitions_version = master_->catalog_manager()->partitions_version();
+  const auto registration_version = master_->ts_manager()->registration_version();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (cache_ && cache_partitions_version_ == partitions_version &&
+        cache_registration_version_ == registration_version) {
+      vtable->reset(new QLRowBlock(*cache_));
+      return Status::OK();
+    }
+  }
+
+  auto rows = std::make_shared<QLRowBlock>(schema_);
+  RETURN_NOT_OK(GenerateData(rows.get()));
+  vtable->reset(new QLRowBlock(*rows));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A concurrent read could have already cached newer rows.
+  if (!cache_ || (partitions_version >= cache_partitions_version_ &&
+                  registration_version >= cache_registration_version_)) {
+    cache_ = std::move(rows);
+    cache_partitions_version_ = partitions_version;
+    cache_registration_version_ = registration_version;
+  }
+  return Status::OK();
+}
+
+Status YQLPartitionsVTable::GenerateData(QLRowBlock* vtable) const {
   std::vector<scoped_refptr<TableInfo> > tables;
   CatalogManager* catalog_manager = master_->catalog_manager();
   catalog_manager->GetAllTables(&tables, true /* includeOnlyRunningTables */);
@@ -54,7 +94,7 @@ Status YQLPartitionsVTable::RetrieveData(const QLReadRequestPB& request,
         continue;
       }
 
-      QLRow& row = (*vtable)->Extend();
+      QLRow& row = vtable->Extend();
       RETURN_NOT_OK(SetColumnValue(kKeyspaceName, nsInfo->name(), &row));
       RETURN_NOT_OK(SetColumnValue(kTableName, table->name(), &row));
 
@@ -14,6 +14,8 @@
 #ifndef YB_MASTER_YQL_PARTITIONS_VTABLE_H
 #define YB_MASTER_YQL_PARTITIONS_VTABLE_H
 
+#include <mutex>
+
 #include "yb/master/master.h"
 #include "yb/master/yql_virtual_table.h"
 
@@ -29,6 +31,15 @@ class YQLPartitionsVTable : public YQLVirtualTable {
  protected:
   Schema CreateSchema() const;
  private:
+  // Builds the rows for all running YCQL tables.
+  CHECKED_STATUS GenerateData(QLRowBlock* vtable) const;
+
+  // Rows built by GenerateData, rebuilt when tables, tablets or tablet servers change.
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<const QLRowBlock> cache_;  // Protected by mutex_.
+  mutable uint64_t cache_partitions_version_ = 0;  // Protected by mutex_.
+  mutable uint64_t cache_registration_version_ = 0;  // Protected by mutex_.
+
   static constexpr const char* const kKeyspaceName = "keyspace_name";
   static constexpr const char* const kTableName = "table_name";
   static constexpr const char* const kStartKey = "start_key";
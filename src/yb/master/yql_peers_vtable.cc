@@ -17,8 +17,17 @@
 
 #include "yb/master/ts_descriptor.h"
 
+#include "yb/master/ts_manager.h"
+
 #include "yb/rpc/messenger.h"
 
+#include "yb/util/flag_tags.h"
+
+DEFINE_bool(use_cache_for_peers_vtable, true,
+            "Keep the rows of system.peers and rebuild them only when the set of live tablet "
+            "servers or their registrations change.");
+TAG_FLAG(use_cache_for_peers_vtable, advanced);
+
 namespace yb {
 namespace master {
 
@@ -63,8 +72,48 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
 
   const auto& proxy_uuid = request.proxy_uuid();
 
+  auto peers = VERIFY_RESULT(GetPeers(descs));
+
   // Populate the YQL rows.
   vtable->reset(new QLRowBlock(schema_));
+  for (size_t i = 0; i != peers->rows->row_count(); ++i) {
+    // The system.peers table has one entry for each of its peers, whereas there is no entry for
+    // the node that the CQL client connects to. In this case, this node is the 'remote_endpoint'
+    // in QLReadRequestPB since that is address of the CQL proxy which sent this request. As a
+    // result, skip 'remote_endpoint' in the results.
+    const auto& ts_info = peers->ts_infos[i];
+    if (!proxy_uuid.empty()) {
+      if (ts_info.tserver_instance().permanent_uuid() == proxy_uuid) {
+        continue;
+      }
+    } else {
+      // In case of old proxy, fallback to old endpoint based mechanism.
+      if (util::RemoteEndpointMatchesTServer(ts_info, remote_endpoint)) {
+        continue;
+      }
+    }
+    RETURN_NOT_OK((*vtable)->AddRow(peers->rows->row(i)));
+  }
+
+  return Status::OK();
+}
+
+Result<std::shared_ptr<const PeersVTable::Peers>> PeersVTable::GetPeers(
+    const std::vector<std::shared_ptr<TSDescriptor>>& descs) const {
+  auto peers = std::make_shared<Peers>();
+  peers->permanent_uuids.reserve(descs.size());
+  for (const auto& desc : descs) {
+    peers->permanent_uuids.push_back(desc->permanent_uuid());
+  }
+  // Read the version before the registrations, so a concurrent registration is not missed.
+  peers->registration_version = master_->ts_manager()->registration_version();
+  if (FLAGS_use_cache_for_peers_vtable) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (peers_ && peers_->registration_version == peers->registration_version &&
+        peers_->permanent_uuids == peers->permanent_uuids) {
+      return peers_;
+    }
+  }
 
   struct Entry {
     size_t index;
@@ -77,36 +126,22 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
 
   size_t index = 0;
   for (const auto& desc : descs) {
-    size_t current_index = index++;
-
     // This is thread safe since all operations are reads.
-    TSInformationPB ts_info = desc->GetTSInformationPB();
-
-    if (!proxy_uuid.empty()) {
-      if (desc->permanent_uuid() == proxy_uuid) {
-        continue;
-      }
-    } else {
-      // In case of old proxy, fallback to old endpoint based mechanism.
-      if (util::RemoteEndpointMatchesTServer(ts_info, remote_endpoint)) {
-        continue;
-      }
-    }
-
-    entries.push_back({current_index, std::move(ts_info)});
+    entries.push_back({index++, desc->GetTSInformationPB()});
     auto& entry = entries.back();
     entry.ts_ips = util::GetPublicPrivateIPFutures(entry.ts_info, resolver_.get());
   }
 
-  for (const auto& entry : entries) {
-    // The system.peers table has one entry for each of its peers, whereas there is no entry for
-    // the node that the CQL client connects to. In this case, this node is the 'remote_endpoint'
-    // in QLReadRequestPB since that is address of the CQL proxy which sent this request. As a
-    // result, skip 'remote_endpoint' in the results.
+  peers->rows = std::make_unique<QLRowBlock>(schema_);
+  peers->ts_infos.reserve(entries.size());
+  // Rows are not cached when an address could not be resolved, so it is retried by the next read.
+  bool resolved_all = true;
+  for (auto& entry : entries) {
     auto private_ip = entry.ts_ips.private_ip_future.get();
     if (!private_ip.ok()) {
       LOG(ERROR) << "Failed to get private ip from " << entry.ts_info.ShortDebugString()
                  << ": " << private_ip.status();
+      resolved_all = false;
       continue;
     }
 
@@ -114,12 +149,13 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
     if (!public_ip.ok()) {
       LOG(ERROR) << "Failed to get public ip from " << entry.ts_info.ShortDebugString()
                  << ": " << public_ip.status();
+      resolved_all = false;
       continue;
     }
 
     // Need to use only 1 rpc address per node since system.peers has only 1 entry for each host,
     // so pick the first one.
-    QLRow &row = (*vtable)->Extend();
+    QLRow &row = peers->rows->Extend();
     RETURN_NOT_OK(SetColumnValue(kPeer, *public_ip, &row));
     RETURN_NOT_OK(SetColumnValue(kRPCAddress, *public_ip, &row));
     RETURN_NOT_OK(SetColumnValue(kPreferredIp, *private_ip, &row));
@@ -142,9 +178,15 @@ Status PeersVTable::RetrieveData(const QLReadRequestPB& request,
     // Tokens.
     RETURN_NOT_OK(SetColumnValue(
         kTokens, util::GetTokensValue(entry.index, descs.size()), &row));
+
+    peers->ts_infos.push_back(std::move(entry.ts_info));
   }
 
-  return Status::OK();
+  if (FLAGS_use_cache_for_peers_vtable && resolved_all) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peers_ = peers;
+  }
+  return peers;
 }
 
 Schema PeersVTable::CreateSchema() const {
@@ -14,6 +14,8 @@
 #ifndef YB_MASTER_YQL_PEERS_VTABLE_H
 #define YB_MASTER_YQL_PEERS_VTABLE_H
 
+#include <mutex>
+
 #include "yb/master/yql_virtual_table.h"
 
 #include "yb/util/net/net_fwd.h"
@@ -29,9 +31,26 @@ class PeersVTable : public YQLVirtualTable {
                               std::unique_ptr<QLRowBlock>* vtable) const;
 
  private:
+  // Rows for all live tablet servers, before skipping the server that sent the request.
+  struct Peers {
+    std::vector<std::string> permanent_uuids;
+    uint64_t registration_version = 0;
+    // Rows and the info of the tablet servers they were built for.
+    std::unique_ptr<QLRowBlock> rows;
+    std::vector<TSInformationPB> ts_infos;
+  };
+
   Schema CreateSchema() const;
 
+  // Returns the rows for the given live tablet servers. Rows are rebuilt, resolving the addresses
+  // of tablet servers, only when the set of live tablet servers or their registrations change.
+  Result<std::shared_ptr<const Peers>> GetPeers(
+      const std::vector<std::shared_ptr<TSDescriptor>>& descs) const;
+
   std::unique_ptr<Resolver> resolver_;
+
+  mutable std::mutex mutex_;
+  mutable std::shared_ptr<const Peers> peers_;  // Protected by mutex_.
 };
 
 }  // namespace master
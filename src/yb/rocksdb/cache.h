@@ -37,6 +37,7 @@
 #define STORAGE_ROCKSDB_INCLUDE_CACHE_H_
 
 #include <stdint.h>
+#include <functional>
 #include <memory>
 #include "yb/util/slice.h"
 #include "yb/rocksdb/status.h"
@@ -73,6 +74,10 @@ constexpr QueryId kDefaultQueryId = 0;
 constexpr QueryId kInMultiTouchId = -1;
 // Query ids to represent values that should not be in any cache.
 constexpr QueryId kNoCacheQueryId = -2;
+// Query ids to represent values read by scans. Such values are added to the single-touch cache
+// with low priority, i.e. they are the first to be evicted, and accesses by scans do not move
+// values to the multi-touch cache. So a scan does not evict the working set of other queries.
+constexpr QueryId kScanQueryId = -3;
 
 class Cache {
  public:
@@ -190,6 +195,16 @@ class Cache {
 
   virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
 
+  // Invoked for an entry that the cache drops to stay within its capacity, right before the entry's
+  // deleter is called and outside of the cache locks. It is not invoked for entries that are erased,
+  // replaced by a newer value or released when the cache is destroyed.
+  typedef std::function<void(const Slice& key, void* value,
+                             void (*deleter)(const Slice& key, void* value))> EvictionCallback;
+
+  // Sets the callback invoked for evicted entries, replacing the previous one. An empty callback
+  // disables it.
+  virtual void SetEvictionCallback(EvictionCallback eviction_callback) {}
+
  private:
   void LRU_Remove(Handle* e);
   void LRU_Append(Handle* e);
@@ -30,6 +30,7 @@
 
 #include "yb/util/slice.h"
 #include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/status.h"
 
 namespace rocksdb {
 
@@ -101,8 +102,9 @@ class CompactionFilter {
   // in existence and operating concurrently.
   //
   // The last paragraph is not true if you set max_subcompactions to more than
-  // 1. In that case, subcompaction from multiple threads may call a single
-  // CompactionFilter concurrently.
+  // 1 and supply a single CompactionFilter instance. In that case, subcompaction from multiple
+  // threads may call a single CompactionFilter concurrently. Filters created by a factory are
+  // created for each subcompaction.
   virtual FilterDecision Filter(int level,
                                 const Slice& key,
                                 const Slice& existing_value,
@@ -141,6 +143,10 @@ class CompactionFilter {
   // compaction filter into the version edit metadata. See DocDBCompactionFilter.
   virtual UserFrontierPtr GetLargestUserFrontier() const { return nullptr; }
 
+  // Invoked after the filter has processed all keys of a successful (sub)compaction, before its
+  // output is installed.
+  virtual Status CompactionFinished() { return Status::OK(); }
+
   // Returns a name that identifies this compaction filter.
   // The name will be printed to LOG file on start up for diagnosis.
   virtual const char* Name() const = 0;
@@ -157,6 +163,67 @@ class CompactionFilterFactory {
 
   // Returns a name that identifies this compaction filter factory.
   virtual const char* Name() const = 0;
+
+  // Returns the prefix of the user key, such that all keys with the same prefix should be
+  // processed by the same compaction filter. It is used to align subcompaction boundaries, so
+  // a filter that has to see related keys together never gets only a part of them.
+  // Returns empty slice if the key could not be used as a subcompaction boundary.
+  virtual Slice KeyGroupPrefix(const Slice& user_key) const {
+    return user_key;
+  }
+};
+
+struct TableProperties;
+
+// Used by universal compaction to find the oldest SST files that contain only expired data, so
+// they could be deleted without being read and rewritten by a compaction.
+class ExpiredFileFilter {
+ public:
+  virtual ~ExpiredFileFilter() {}
+
+  // Files are ordered from the newest to the oldest. Properties are nullptr for files that are not
+  // loaded to the table cache. Returns the number of the oldest files that could be deleted.
+  virtual size_t NumExpiredOldestFiles(const std::vector<const TableProperties*>& files) = 0;
+
+  // Returns true if all entries of the file with the specified key range were deleted, so the file
+  // could be deleted regardless of its age. Only invoked for files that are already open.
+  virtual bool IsFileDeleted(
+      const Slice& smallest_user_key, const Slice& largest_user_key,
+      const TableProperties* properties) {
+    return false;
+  }
+
+  // Returns true if so many entries of the file are expired that it is worth rewriting the file
+  // to reclaim their space, even though the file could not be dropped as a whole. Only invoked
+  // for files that are already open.
+  virtual bool HasManyExpiredBytes(const TableProperties* properties) {
+    return false;
+  }
+
+  // Returns true if the file contains so many versions of keys overwritten by newer versions in the
+  // same file, that it is worth rewriting the file to garbage collect them. Only invoked for files
+  // that are already open.
+  virtual bool HasManyObsoleteVersions(const TableProperties* properties) {
+    return false;
+  }
+
+  // Returns a name that identifies this filter.
+  virtual const char* Name() const = 0;
+};
+
+// Assigns SST files to time windows. Universal compaction does not compact files of different
+// windows together, so entries of old windows remain in their own files, that could be dropped as a
+// whole by ExpiredFileFilter once they expire.
+class CompactionTimeWindows {
+ public:
+  virtual ~CompactionTimeWindows() {}
+
+  // Returns the window of the file with the specified largest frontier, that could be nullptr.
+  // Files are compacted together only if they are adjacent and belong to the same window.
+  virtual uint64_t FileWindow(const UserFrontier* largest_frontier) = 0;
+
+  // Returns a name that identifies this object.
+  virtual const char* Name() const = 0;
 };
 
 }  // namespace rocksdb
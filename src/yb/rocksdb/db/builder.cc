@@ -27,6 +27,8 @@
 #include <deque>
 #include <vector>
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/db/compaction_iterator.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/filename.h"
@@ -46,6 +48,8 @@
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 
+DECLARE_bool(rocksdb_async_sst_writes);
+
 namespace rocksdb {
 
 class TableFactory;
@@ -91,7 +95,9 @@ namespace {
       return s;
     }
     file->SetIOPriority(io_priority);
-    file_writer->reset(new WritableFileWriter(std::move(file), env_options));
+    EnvOptions writer_options = env_options;
+    writer_options.async_writes = FLAGS_rocksdb_async_sst_writes;
+    file_writer->reset(new WritableFileWriter(std::move(file), writer_options));
     return Status::OK();
   }
 } // anonymous namespace
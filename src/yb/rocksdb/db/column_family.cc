@@ -138,6 +138,13 @@ Status CheckCompressionSupported(const ColumnFamilyOptions& cf_options) {
           " is not linked with the binary.");
     }
   }
+  for (auto type : {cf_options.flush_compression, cf_options.bottommost_compression}) {
+    if (type != kDisableCompressionOption && !CompressionTypeSupported(type)) {
+      return STATUS(InvalidArgument,
+          "Compression type " + CompressionTypeToString(type) +
+          " is not linked with the binary.");
+    }
+  }
   return Status::OK();
 }
 
@@ -273,12 +273,28 @@ Compaction::~Compaction() {
   }
 }
 
+bool Compaction::UseBottommostCompression() const {
+  return bottommost_level_ && cfd_ != nullptr &&
+         cfd_->ioptions()->bottommost_compression != kDisableCompressionOption;
+}
+
+CompressionType Compaction::output_compression() const {
+  return UseBottommostCompression() ? cfd_->ioptions()->bottommost_compression
+                                    : output_compression_;
+}
+
+const CompressionOptions& Compaction::output_compression_opts() const {
+  DCHECK_ONLY_NOTNULL(cfd_);
+  return UseBottommostCompression() ? cfd_->ioptions()->bottommost_compression_opts
+                                    : cfd_->ioptions()->compression_opts;
+}
+
 bool Compaction::InputCompressionMatchesOutput() const {
   int base_level = IsCompactionStyleUniversal()
       ? -1
       : input_version_->storage_info()->base_level();
   bool matches = (GetCompressionType(*cfd_->ioptions(), start_level_,
-                                     base_level) == output_compression_);
+                                     base_level) == output_compression());
   if (matches) {
     TEST_SYNC_POINT("Compaction::InputCompressionMatchesOutput:Matches");
     return true;
@@ -534,7 +550,8 @@ bool Compaction::ShouldFormSubcompactions() const {
   if (cfd_->ioptions()->compaction_style == kCompactionStyleLevel) {
     return start_level_ == 0 && !IsOutputLevelEmpty();
   } else if (IsCompactionStyleUniversal()) {
-    return number_levels_ > 1 && output_level_ > 0;
+    // With a single level, output files of all subcompactions form one sorted run in level 0.
+    return number_levels_ == 1 || output_level_ > 0;
   } else {
     return false;
   }
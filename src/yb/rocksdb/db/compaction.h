@@ -176,8 +176,12 @@ class Compaction {
   // Maximum size of files to build during this compaction.
   uint64_t max_output_file_size() const { return max_output_file_size_; }
 
-  // What compression for output
-  CompressionType output_compression() const { return output_compression_; }
+  // What compression for output. Takes bottommost_compression option into account, so should be
+  // used once the input version is set.
+  CompressionType output_compression() const;
+
+  // Compression options to use with output_compression().
+  const CompressionOptions& output_compression_opts() const;
 
   // Whether need to write output file to second DB path.
   uint32_t output_path_id() const { return output_path_id_; }
@@ -218,6 +222,9 @@ class Compaction {
   // Is this compaction creating a file in the bottom most level?
   bool bottommost_level() { return bottommost_level_; }
 
+  // Whether output of this compaction should be compressed using bottommost_compression.
+  bool UseBottommostCompression() const;
+
   // Does this compaction include all sst files?
   bool is_full_compaction() { return is_full_compaction_; }
 
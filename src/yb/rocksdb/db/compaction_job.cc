@@ -74,8 +74,20 @@
 #include "yb/rocksdb/util/sync_point.h"
 #include "yb/rocksdb/util/thread_status_util.h"
 
+#include "yb/util/priority_thread_pool.h"
+
+DECLARE_bool(rocksdb_async_sst_writes);
+
 namespace rocksdb {
 
+namespace {
+
+// Number of keys taken from each level 0 input file per subcompaction, when generating
+// subcompaction boundaries.
+constexpr size_t kSplitKeysPerSubcompaction = 4;
+
+} // namespace
+
 // Maintains state for each sub-compaction
 struct CompactionJob::SubcompactionState {
   Compaction* compaction;
@@ -120,6 +132,8 @@ struct CompactionJob::SubcompactionState {
   uint64_t num_output_records;
   CompactionJobStats compaction_job_stats;
   uint64_t approx_size;
+  // Largest user frontier provided by the compaction filter of this subcompaction.
+  UserFrontierPtr largest_user_frontier;
 
   SubcompactionState(Compaction* c, Slice* _start, Slice* _end,
                      uint64_t size = 0)
@@ -236,7 +250,7 @@ CompactionJob::CompactionJob(
     FileNumbersProvider* file_numbers_provider,
     std::shared_ptr<Cache> table_cache, EventLogger* event_logger,
     bool paranoid_file_checks, bool measure_io_stats, const std::string& dbname,
-    CompactionJobStats* compaction_job_stats)
+    CompactionJobStats* compaction_job_stats, yb::PriorityThreadPoolSuspender* suspender)
     : job_id_(job_id),
       compact_(new CompactionState(compaction)),
       compaction_job_stats_(compaction_job_stats),
@@ -247,6 +261,7 @@ CompactionJob::CompactionJob(
       env_(db_options.env),
       versions_(versions),
       shutting_down_(shutting_down),
+      suspender_(suspender),
       log_buffer_(log_buffer),
       db_directory_(db_directory),
       output_directory_(output_directory),
@@ -392,6 +407,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
         for (size_t i = 0; i < num_files; i++) {
           bounds.emplace_back(flevel->files[i].smallest.key);
           bounds.emplace_back(flevel->files[i].largest.key);
+          AddSplitKeys(flevel->files[i].fd);
         }
       } else {
         // For all other levels add the smallest/largest key in the level to
@@ -411,6 +427,13 @@ void CompactionJob::GenSubcompactionBoundaries() {
     }
   }
 
+  // Universal compaction usually has a few large overlapping files in level 0, so their
+  // boundaries are not enough to split the compaction. Also use keys that split those files
+  // into parts of similar size.
+  for (const auto& key : split_keys_) {
+    bounds.emplace_back(key);
+  }
+
   std::sort(bounds.begin(), bounds.end(),
     [cfd_comparator] (const Slice& a, const Slice& b) -> bool {
       return cfd_comparator->Compare(ExtractUserKey(a), ExtractUserKey(b)) < 0;
@@ -454,6 +477,7 @@ void CompactionJob::GenSubcompactionBoundaries() {
                                     : std::numeric_limits<double>::max();
 
   if (subcompactions > 1) {
+    auto* filter_factory = cfd->ioptions()->compaction_filter_factory;
     // Greedily add ranges to the subcompaction until the sum of the ranges'
     // sizes becomes >= the expected mean size of a subcompaction
     sum = 0;
@@ -465,7 +489,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
         continue;
       }
       if (sum >= mean) {
-        boundaries_.emplace_back(ExtractUserKey(ranges[i].range.limit));
+        Slice boundary = ExtractUserKey(ranges[i].range.limit);
+        if (filter_factory) {
+          // Keys that should be seen by the same compaction filter are not split between
+          // subcompactions.
+          boundary = filter_factory->KeyGroupPrefix(boundary);
+        }
+        if (boundary.empty() ||
+            (!boundaries_.empty() && cfd_comparator->Compare(boundary, boundaries_.back()) <= 0)) {
+          continue;
+        }
+        boundaries_.emplace_back(boundary);
         sizes_.emplace_back(sum);
         subcompactions--;
         sum = 0;
@@ -478,6 +512,23 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
 }
 
+void CompactionJob::AddSplitKeys(const FileDescriptor& fd) {
+  auto* cfd = compact_->compaction->column_family_data();
+  TableCache::TableReaderWithHandle trwh;
+  auto status = cfd->table_cache()->GetTableReaderForIterator(
+      ReadOptions::kDefault, env_options_, cfd->internal_comparator(), fd, &trwh,
+      nullptr /* file_read_hist */, true /* for_compaction */);
+  if (status.ok()) {
+    status = trwh.table_reader->GetSplitKeys(
+        db_options_.max_subcompactions * kSplitKeysPerSubcompaction, &split_keys_);
+  }
+  if (!status.ok()) {
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log,
+        "[%s] Failed to get split keys of file %" PRIu64 ": %s",
+        cfd->GetName().c_str(), fd.GetNumber(), status.ToString().c_str());
+  }
+}
+
 Result<FileNumbersHolder> CompactionJob::Run() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_COMPACTION_RUN);
@@ -524,6 +575,14 @@ Result<FileNumbersHolder> CompactionJob::Run() {
     }
   }
 
+  for (auto& state : compact_->sub_compact_states) {
+    if (state.largest_user_frontier) {
+      UpdateUserFrontier(
+          &largest_user_frontier_, std::move(state.largest_user_frontier),
+          UpdateUserValueType::kLargest);
+    }
+  }
+
   TablePropertiesCollection tp;
   for (const auto& state : compact_->sub_compact_states) {
     for (const auto& output : state.outputs) {
@@ -655,8 +714,9 @@ void CompactionJob::ProcessKeyValueCompaction(
 
   if (compaction_filter) {
     // This is used to persist the history cutoff hybrid time chosen for the DocDB compaction
-    // filter.
-    largest_user_frontier_ = compaction_filter->GetLargestUserFrontier();
+    // filter. Subcompactions are run concurrently, so frontiers are merged after all of them
+    // complete.
+    sub_compact->largest_user_frontier = compaction_filter->GetLargestUserFrontier();
   }
 
   MergeHelper merge(
@@ -714,6 +774,11 @@ void CompactionJob::ProcessKeyValueCompaction(
       RecordDroppedKeys(c_iter_stats, &sub_compact->compaction_job_stats);
       c_iter->ResetRecordCounts();
       RecordCompactionIOStats();
+      // Suspender is shared by all subcompactions of the job, so only the job with a single
+      // subcompaction could be paused.
+      if (suspender_ && compact_->sub_compact_states.size() == 1) {
+        suspender_->PauseIfNecessary();
+      }
     }
 
     // Open output file if necessary
@@ -771,6 +836,11 @@ void CompactionJob::ProcessKeyValueCompaction(
     status = STATUS(ShutdownInProgress,
         "Database shutdown or Column family drop during compaction");
   }
+  if (status.ok() && compaction_filter) {
+    // Output files are installed only after all subcompactions complete, so data written by the
+    // filter outside of them just has to be durable by then.
+    status = compaction_filter->CompactionFinished();
+  }
   if (status.ok() && sub_compact->builder != nullptr) {
     status = FinishCompactionOutputFile(input->status(), sub_compact);
   }
@@ -1045,7 +1115,9 @@ Status CompactionJob::OpenCompactionOutputFile(
       if (preallocation_block_size > 0) {
         (*writable_file)->SetPreallocationBlockSize(preallocation_block_size);
       }
-      writer->reset(new WritableFileWriter(std::move(*writable_file), env_options));
+      EnvOptions writer_options = env_options;
+      writer_options.async_writes = FLAGS_rocksdb_async_sst_writes;
+      writer->reset(new WritableFileWriter(std::move(*writable_file), writer_options));
     };
 
     const bool is_split_sst = cfd->ioptions()->table_factory->IsSplitSstForWriteSupported();
@@ -1065,12 +1137,14 @@ Status CompactionJob::OpenCompactionOutputFile(
   // data is going to be found
   bool skip_filters =
       cfd->ioptions()->optimize_filters_for_hits && bottommost_level_;
+  auto output_compression = sub_compact->compaction->output_compression();
+  TEST_SYNC_POINT_CALLBACK("CompactionJob::OpenCompactionOutputFile:output_compression",
+                           &output_compression);
   sub_compact->builder.reset(NewTableBuilder(
       *cfd->ioptions(), cfd->internal_comparator(),
       cfd->int_tbl_prop_collector_factories(), cfd->GetID(),
       sub_compact->base_outfile.get(), sub_compact->data_outfile.get(),
-      sub_compact->compaction->output_compression(), cfd->ioptions()->compression_opts,
-      skip_filters));
+      output_compression, sub_compact->compaction->output_compression_opts(), skip_filters));
   LogFlush(db_options_.info_log);
   return Status::OK();
 }
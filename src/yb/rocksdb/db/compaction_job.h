@@ -61,6 +61,12 @@
 #include "yb/rocksdb/util/stop_watch.h"
 #include "yb/rocksdb/util/thread_local.h"
 
+namespace yb {
+
+class PriorityThreadPoolSuspender;
+
+}
+
 namespace rocksdb {
 
 using yb::Result;
@@ -88,7 +94,8 @@ class CompactionJob {
                 std::shared_ptr<Cache> table_cache, EventLogger* event_logger,
                 bool paranoid_file_checks, bool measure_io_stats,
                 const std::string& dbname,
-                CompactionJobStats* compaction_job_stats);
+                CompactionJobStats* compaction_job_stats,
+                yb::PriorityThreadPoolSuspender* suspender = nullptr);
 
   ~CompactionJob();
 
@@ -110,6 +117,8 @@ class CompactionJob {
 
   void AggregateStatistics();
   void GenSubcompactionBoundaries();
+  // Adds keys that split the specified input file to split_keys_.
+  void AddSplitKeys(const FileDescriptor& fd);
 
   // update the thread status for starting a compaction.
   void ReportStartedCompaction(Compaction* compaction);
@@ -155,6 +164,8 @@ class CompactionJob {
   Env* env_;
   VersionSet* versions_;
   std::atomic<bool>* shutting_down_;
+  // Used to pause compaction in favor of compactions with higher priority, could be null.
+  yb::PriorityThreadPoolSuspender* suspender_;
   LogBuffer* log_buffer_;
   Directory* db_directory_;
   Directory* output_directory_;
@@ -181,6 +192,10 @@ class CompactionJob {
   bool bottommost_level_;
   bool paranoid_file_checks_;
   bool measure_io_stats_;
+  // Keys that split input files into parts of similar size, used to generate subcompaction
+  // boundaries. Should not be changed after boundaries_ are generated, since they could
+  // point into these keys.
+  std::vector<std::string> split_keys_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<Slice> boundaries_;
   // Stores the approx size of keys covered in the range of each subcompaction
@@ -35,8 +35,10 @@
 
 #include <gflags/gflags.h>
 
+#include "yb/rocksdb/compaction_filter.h"
 #include "yb/rocksdb/db/column_family.h"
 #include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/table/table_reader.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/statistics.h"
@@ -1162,6 +1164,27 @@ struct UniversalCompactionPicker::SortedRun {
     assert(compensated_file_size > 0);
     // Allowed either one of level and file.
     assert((level != 0) != (file != nullptr));
+    if (file) {
+      files.push_back(file);
+    }
+  }
+
+  // Level 0 files produced by the same compaction have overlapping sequence number ranges, while
+  // files produced by different compactions and flushes do not. So such files, i.e. outputs of
+  // subcompactions, form a single sorted run and should be compacted together.
+  bool ShouldContain(FileMetaData* older_file) const {
+    return level == 0 && older_file->largest.seqno >= file->smallest.seqno;
+  }
+
+  void AddOlderFile(FileMetaData* older_file) {
+    files.push_back(older_file);
+    size += older_file->fd.GetTotalFileSize();
+    compensated_file_size += older_file->compensated_file_size;
+    being_compacted = being_compacted || older_file->being_compacted;
+    // file is used to check whether the next older file belongs to this sorted run.
+    if (older_file->smallest.seqno < file->smallest.seqno) {
+      file = older_file;
+    }
   }
 
   void Dump(char* out_buf, size_t out_buf_size,
@@ -1172,9 +1195,11 @@ struct UniversalCompactionPicker::SortedRun {
                     size_t sorted_run_count) const;
 
   int level;
-  // `file` Will be null for level > 0. For level = 0, the sorted run is
-  // for this file.
+  // `file` Will be null for level > 0. For level = 0, it is the file with the smallest sequence
+  // number in the sorted run.
   FileMetaData* file;
+  // Files of level 0 sorted run, from the newest to the oldest.
+  std::vector<FileMetaData*> files;
   // For level > 0, `size` and `compensated_file_size` are sum of sizes all
   // files in the level. `being_compacted` should be the same for all files
   // in a non-zero level. Use the value here.
@@ -1188,13 +1213,17 @@ void UniversalCompactionPicker::SortedRun::Dump(char* out_buf,
                                                 bool print_path) const {
   if (level == 0) {
     assert(file != nullptr);
-    if (file->fd.GetPathId() == 0 || !print_path) {
-      snprintf(out_buf, out_buf_size, "file %" PRIu64, file->fd.GetNumber());
+    auto* first_file = files.front();
+    if (files.size() > 1) {
+      snprintf(out_buf, out_buf_size, "file %" PRIu64 " and %" ROCKSDB_PRIszt " more",
+               first_file->fd.GetNumber(), files.size() - 1);
+    } else if (first_file->fd.GetPathId() == 0 || !print_path) {
+      snprintf(out_buf, out_buf_size, "file %" PRIu64, first_file->fd.GetNumber());
     } else {
       snprintf(out_buf, out_buf_size, "file %" PRIu64
                                       "(path "
                                       "%" PRIu32 ")",
-               file->fd.GetNumber(), file->fd.GetPathId());
+               first_file->fd.GetNumber(), first_file->fd.GetPathId());
     }
   } else {
     snprintf(out_buf, out_buf_size, "level %d", level);
@@ -1208,9 +1237,9 @@ void UniversalCompactionPicker::SortedRun::DumpSizeInfo(
     snprintf(out_buf, out_buf_size,
              "file %" PRIu64 "[%" ROCKSDB_PRIszt
              "] "
-             "with size %" PRIu64 " (compensated size %" PRIu64 ")",
-             file->fd.GetNumber(), sorted_run_count, file->fd.GetTotalFileSize(),
-             file->compensated_file_size);
+             "with size %" PRIu64 " (compensated size %" PRIu64 ") in %" ROCKSDB_PRIszt " files",
+             files.front()->fd.GetNumber(), sorted_run_count, size, compensated_file_size,
+             files.size());
   } else {
     snprintf(out_buf, out_buf_size,
              "level %d[%" ROCKSDB_PRIszt
@@ -1225,8 +1254,23 @@ std::vector<std::vector<UniversalCompactionPicker::SortedRun>>
                                                    const ImmutableCFOptions& ioptions,
                                                    uint64_t max_file_size) {
   std::vector<std::vector<SortedRun>> ret(1);
+  uint64_t prev_window = 0;
   for (FileMetaData* f : vstorage.LevelFiles(0)) {
+    // Files of different time windows are never compacted together, so each window starts a new
+    // sequence.
+    if (ioptions.compaction_time_windows) {
+      const auto window = ioptions.compaction_time_windows->FileWindow(
+          f->largest.user_frontier.get());
+      if (window != prev_window && !ret.back().empty()) {
+        ret.emplace_back();
+      }
+      prev_window = window;
+    }
     if (f->fd.GetTotalFileSize() <= max_file_size) {
+      if (!ret.back().empty() && ret.back().back().ShouldContain(f)) {
+        ret.back().back().AddOlderFile(f);
+        continue;
+      }
       ret.back().emplace_back(0, f, f->fd.GetTotalFileSize(), f->compensated_file_size,
           f->being_compacted);
     // If last sequence is empty it means that there are multiple too-large-to-compact files in
@@ -1353,6 +1397,14 @@ Compaction* UniversalCompactionPicker::PickCompaction(
     const MutableCFOptions& mutable_cf_options,
     VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
+  if (ioptions_.expired_file_filter) {
+    Compaction* result = PickExpiredFilesDeletion(
+        cf_name, mutable_cf_options, vstorage, log_buffer);
+    if (result != nullptr) {
+      return result;
+    }
+  }
+
   std::vector<std::vector<SortedRun>> sorted_runs = CalculateSortedRuns(
       *vstorage,
       ioptions_,
@@ -1364,6 +1416,12 @@ Compaction* UniversalCompactionPicker::PickCompaction(
       return result;
     }
   }
+
+  // Expired entries and overwritten versions are rewritten only when there is nothing more
+  // important to compact.
+  if (ioptions_.expired_file_filter) {
+    return PickExpiredBytesCompaction(cf_name, mutable_cf_options, vstorage, log_buffer);
+  }
   return nullptr;
 }
 
@@ -1494,6 +1552,123 @@ Compaction* UniversalCompactionPicker::DoPickCompaction(
   return c;
 }
 
+Compaction* UniversalCompactionPicker::PickExpiredFilesDeletion(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const int kLevel0 = 0;
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(kLevel0);
+  if (level_files.empty()) {
+    return nullptr;
+  }
+
+  // Only properties of files that are already open are used, so no I/O is done here.
+  std::vector<std::shared_ptr<const TableProperties>> properties_holders;
+  std::vector<const TableProperties*> properties;
+  properties_holders.reserve(level_files.size());
+  properties.reserve(level_files.size());
+  for (const auto* f : level_files) {
+    properties_holders.push_back(
+        f->fd.table_reader ? f->fd.table_reader->GetTableProperties() : nullptr);
+    properties.push_back(properties_holders.back().get());
+  }
+  const size_t num_expired = level_files.back()->being_compacted ? 0 : std::min(
+      ioptions_.expired_file_filter->NumExpiredOldestFiles(properties), level_files.size());
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  auto pick_file = [&inputs, &cf_name, log_buffer](FileMetaData* f, const char* reason) {
+    inputs[0].files.push_back(f);
+    char tmp_fsize[16];
+    AppendHumanBytes(f->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+    LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking %s file %" PRIu64
+                              " with size %s for deletion",
+                  cf_name.c_str(), reason, f->fd.GetNumber(), tmp_fsize);
+  };
+  size_t num_picked_oldest = 0;
+  for (size_t i = level_files.size(); i != level_files.size() - num_expired; --i) {
+    auto* f = level_files[i - 1];
+    if (f->being_compacted) {
+      break;
+    }
+    pick_file(f, "expired");
+    ++num_picked_oldest;
+  }
+  // Files whose entries were deleted could be dropped regardless of their position.
+  for (size_t i = 0; i != level_files.size() - num_picked_oldest; ++i) {
+    auto* f = level_files[i];
+    if (!f->being_compacted && properties[i] &&
+        ioptions_.expired_file_filter->IsFileDeleted(
+            f->smallest.key.user_key(), f->largest.key.user_key(), properties[i])) {
+      pick_file(f, "deleted");
+    }
+  }
+  if (inputs[0].files.empty()) {
+    return nullptr;
+  }
+
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), 0, 0, 0, 0,
+      kNoCompression, {}, /* is manual */ false, vstorage->CompactionScore(kLevel0),
+      /* is deletion compaction */ true, CompactionReason::kUniversalExpiredFiles);
+  level0_compactions_in_progress_.insert(c);
+  return c;
+}
+
+Compaction* UniversalCompactionPicker::PickExpiredBytesCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    VersionStorageInfo* vstorage, LogBuffer* log_buffer) {
+  const int kLevel0 = 0;
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(kLevel0);
+
+  // Start from the oldest file, since its entries are the most likely to be expired or
+  // overwritten before the history cutoff.
+  auto* filter = ioptions_.expired_file_filter;
+  FileMetaData* picked = nullptr;
+  CompactionReason reason = CompactionReason::kUniversalExpiredBytes;
+  for (auto it = level_files.rbegin(); it != level_files.rend(); ++it) {
+    auto* f = *it;
+    if (f->being_compacted || !f->fd.table_reader) {
+      continue;
+    }
+    auto properties = f->fd.table_reader->GetTableProperties();
+    if (!properties) {
+      continue;
+    }
+    if (filter->HasManyExpiredBytes(properties.get())) {
+      picked = f;
+      break;
+    }
+    if (filter->HasManyObsoleteVersions(properties.get())) {
+      picked = f;
+      reason = CompactionReason::kUniversalObsoleteVersions;
+      break;
+    }
+  }
+  if (picked == nullptr) {
+    return nullptr;
+  }
+
+  char tmp_fsize[16];
+  AppendHumanBytes(picked->fd.GetTotalFileSize(), tmp_fsize, sizeof(tmp_fsize));
+  LOG_TO_BUFFER(log_buffer, "[%s] Universal: picking file %" PRIu64
+                            " with size %s for %s compaction",
+                cf_name.c_str(), picked->fd.GetNumber(), tmp_fsize,
+                reason == CompactionReason::kUniversalExpiredBytes
+                    ? "expired bytes" : "obsolete versions");
+
+  std::vector<CompactionInputFiles> inputs(1);
+  inputs[0].level = kLevel0;
+  inputs[0].files.push_back(picked);
+  const uint32_t path_id = GetPathId(ioptions_, picked->fd.GetTotalFileSize());
+  Compaction* c = new Compaction(
+      vstorage, mutable_cf_options, std::move(inputs), kLevel0,
+      mutable_cf_options.MaxFileSizeForLevel(kLevel0), LLONG_MAX, path_id,
+      GetCompressionType(ioptions_, kLevel0, 1), /* grandparents */ {}, /* is manual */ false,
+      vstorage->CompactionScore(kLevel0), /* is deletion compaction */ false, reason);
+  level0_compactions_in_progress_.insert(c);
+  return c;
+}
+
 uint32_t UniversalCompactionPicker::GetPathId(
     const ImmutableCFOptions& ioptions, uint64_t file_size) {
   // Two conditions need to be satisfied:
@@ -1688,8 +1863,9 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalReadAmp(
   for (size_t i = start_index; i < first_index_after; i++) {
     auto& picking_sr = sorted_runs[i];
     if (picking_sr.level == 0) {
-      FileMetaData* picking_file = picking_sr.file;
-      inputs[0].files.push_back(picking_file);
+      for (auto* picking_file : picking_sr.files) {
+        inputs[0].files.push_back(picking_file);
+      }
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
@@ -1814,8 +1990,9 @@ Compaction* UniversalCompactionPicker::PickCompactionUniversalSizeAmp(
   for (size_t loop = start_index; loop < sorted_runs.size(); loop++) {
     auto& picking_sr = sorted_runs[loop];
     if (picking_sr.level == 0) {
-      FileMetaData* f = picking_sr.file;
-      inputs[0].files.push_back(f);
+      for (auto* f : picking_sr.files) {
+        inputs[0].files.push_back(f);
+      }
     } else {
       auto& files = inputs[picking_sr.level - start_level].files;
       for (auto* f : vstorage->LevelFiles(picking_sr.level)) {
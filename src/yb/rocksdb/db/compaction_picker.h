@@ -266,6 +266,18 @@ class UniversalCompactionPicker : public CompactionPicker {
       LogBuffer* log_buffer,
       const std::vector<SortedRun>& sorted_runs);
 
+  // Pick deletion of the oldest files that contain only expired data, according to
+  // expired_file_filter.
+  Compaction* PickExpiredFilesDeletion(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
+  // Pick compaction of a single file with a large share of expired data or overwritten versions,
+  // according to expired_file_filter, so their space is reclaimed.
+  Compaction* PickExpiredBytesCompaction(
+      const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+      VersionStorageInfo* vstorage, LogBuffer* log_buffer);
+
   // Pick Universal compaction to limit read amplification
   Compaction* PickCompactionUniversalReadAmp(
       const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
@@ -474,6 +474,81 @@ TEST_F(CompactionPickerTest, AllowsTrivialMoveUniversal) {
   ASSERT_TRUE(compaction->is_trivial_move());
 }
 
+// Output files of subcompactions have overlapping sequence number ranges and should be picked
+// together, as a single sorted run.
+TEST_F(CompactionPickerTest, UniversalSubcompactionOutputsAsSingleSortedRun) {
+  const uint64_t kFileSize = 100000;
+
+  ioptions_.compaction_options_universal.max_merge_width = 5;
+  ioptions_.compaction_options_universal.max_size_amplification_percent = 1000;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+
+  Add(0, 1U, "150", "200", kFileSize, 0, 400, 450);
+  Add(0, 2U, "201", "250", kFileSize, 0, 300, 350);
+  Add(0, 3U, "260", "300", kFileSize, 0, 200, 250);
+  Add(0, 4U, "100", "300", kFileSize, 0, 150, 190);
+  // Outputs of a single compaction.
+  Add(0, 5U, "100", "150", kFileSize, 0, 1, 100);
+  Add(0, 6U, "151", "200", kFileSize, 0, 2, 99);
+  Add(0, 7U, "201", "250", kFileSize, 0, 5, 90);
+
+  UpdateVersionStorageInfo();
+
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(7U, compaction->num_input_files(0));
+}
+
+namespace {
+
+class TestCompactionTimeWindows : public CompactionTimeWindows {
+ public:
+  uint64_t FileWindow(const UserFrontier* largest_frontier) override {
+    return largest_frontier ?
+        down_cast<const test::TestUserFrontier*>(largest_frontier)->Value() / 100 : 0;
+  }
+
+  const char* Name() const override {
+    return "TestCompactionTimeWindows";
+  }
+};
+
+} // namespace
+
+TEST_F(CompactionPickerTest, UniversalTimeWindows) {
+  const uint64_t kFileSize = 100000;
+  const std::vector<uint64_t> kFrontiers = {250, 240, 230, 150, 140, 130, 120};
+
+  TestCompactionTimeWindows time_windows;
+  ioptions_.compaction_time_windows = &time_windows;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, icmp_.get());
+
+  NewVersionStorage(1, kCompactionStyleUniversal);
+  for (size_t i = 0; i != kFrontiers.size(); ++i) {
+    const auto key = ToString(100 + i);
+    Add(0, static_cast<uint32_t>(i + 1), key.c_str(), key.c_str(), kFileSize, 0,
+        (kFrontiers.size() - i) * 10, (kFrontiers.size() - i) * 10 + 5);
+    files_.back()->largest.user_frontier = test::TestUserFrontier(kFrontiers[i]).Clone();
+  }
+  UpdateVersionStorageInfo();
+
+  // The newest window does not have enough files to trigger a compaction, while files of the older
+  // one are compacted without the newer files.
+  std::unique_ptr<Compaction> compaction(
+      universal_compaction_picker.PickCompaction(
+          cf_name_, mutable_cf_options_, vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(4U, compaction->num_input_files(0));
+  for (size_t i = 0; i != compaction->num_input_files(0); ++i) {
+    ASSERT_EQ(i + 4, compaction->input(0, i)->fd.GetNumber());
+  }
+}
+
 TEST_F(CompactionPickerTest, NeedsCompactionFIFO) {
   NewVersionStorage(1, kCompactionStyleFIFO);
   const int kFileCount =
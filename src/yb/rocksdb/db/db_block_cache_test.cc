@@ -23,12 +23,50 @@
 #include <cstdlib>
 #include <gflags/gflags.h>
 #include "yb/rocksdb/db/db_test_util.h"
+#include "yb/rocksdb/persistent_block_cache.h"
 #include "yb/rocksdb/port/stack_trace.h"
 
+#include "yb/util/mem_tracker.h"
+
 DECLARE_double(cache_single_touch_ratio);
 
 namespace rocksdb {
 
+namespace {
+
+// Counts the lookups served by the wrapped persistent block cache.
+class CountingPersistentBlockCache : public PersistentBlockCache {
+ public:
+  explicit CountingPersistentBlockCache(std::shared_ptr<PersistentBlockCache> target)
+      : target_(std::move(target)) {}
+
+  Status Insert(const Slice& key, const Slice& data) override {
+    return target_->Insert(key, data);
+  }
+
+  Status Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) override {
+    Status s = target_->Lookup(key, data, size);
+    ++(s.ok() ? hits : misses);
+    return s;
+  }
+
+  size_t GetCapacity() const override { return target_->GetCapacity(); }
+
+  size_t GetUsage() const override { return target_->GetUsage(); }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    target_->SetMetrics(entity);
+  }
+
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+
+ private:
+  std::shared_ptr<PersistentBlockCache> target_;
+};
+
+} // namespace
+
 class DBBlockCacheTest : public DBTestBase {
  private:
   size_t miss_count_ = 0;
@@ -185,6 +223,50 @@ TEST_F(DBBlockCacheTest, TestWithoutCompressedBlockCache) {
   }
 }
 
+TEST_F(DBBlockCacheTest, TestWithPersistentBlockCache) {
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  InitTable(options);
+
+  PersistentBlockCacheOptions persistent_cache_options;
+  persistent_cache_options.env = Env::Default();
+  persistent_cache_options.path = dbname_ + "_persistent_block_cache";
+  persistent_cache_options.capacity = 1_MB;
+  persistent_cache_options.segment_size = 64_KB;
+  std::shared_ptr<PersistentBlockCache> target;
+  ASSERT_OK(NewPersistentBlockCache(persistent_cache_options, &target));
+  auto persistent_cache = std::make_shared<CountingPersistentBlockCache>(target);
+
+  // Blocks are evicted from the block cache as soon as they are released.
+  std::shared_ptr<Cache> cache = NewLRUCache(0, 0, false);
+  table_options.block_cache = cache;
+  table_options.persistent_block_cache = persistent_cache;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  const std::string value(kValueSize, 'a');
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(ToString(i)));
+  }
+  ASSERT_EQ(0U, persistent_cache->hits.load());
+  ASSERT_GE(persistent_cache->misses.load(), kNumBlocks);
+  ASSERT_EQ(0U, cache->GetUsage());
+  // Evicted blocks were spilled to the persistent block cache.
+  const size_t usage = persistent_cache->GetUsage();
+  ASSERT_GT(usage, kNumBlocks * kValueSize);
+
+  // Now every block is read from the persistent block cache, and it is not written again.
+  const size_t misses = persistent_cache->misses.load();
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    ASSERT_EQ(value, Get(ToString(i)));
+  }
+  ASSERT_EQ(misses, persistent_cache->misses.load());
+  ASSERT_GE(persistent_cache->hits.load(), kNumBlocks);
+  ASSERT_EQ(usage, persistent_cache->GetUsage());
+
+  Close();
+}
+
 #ifdef SNAPPY
 TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   ReadOptions read_options;
@@ -248,6 +330,34 @@ TEST_F(DBBlockCacheTest, TestWithCompressedBlockCache) {
   delete iter;
   iter = nullptr;
 }
+
+TEST_F(DBBlockCacheTest, TestCompressedBlockCacheMemTracker) {
+  ReadOptions read_options;
+  auto table_options = GetTableOptions();
+  auto options = GetOptions(table_options);
+  options.compression = CompressionType::kSnappyCompression;
+  InitTable(options);
+
+  auto mem_tracker = yb::MemTracker::CreateTracker("CompressedBlockCache");
+  std::shared_ptr<Cache> compressed_cache = NewLRUCache(0, 0, false);
+  table_options.block_cache = NewLRUCache(0, 0, false);
+  table_options.block_cache_compressed = compressed_cache;
+  table_options.block_cache_compressed_mem_tracker = mem_tracker;
+  options.table_factory.reset(new BlockBasedTableFactory(table_options));
+  Reopen(options);
+  ASSERT_EQ(0, mem_tracker->consumption());
+
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(read_options));
+    iter->Seek(ToString(i));
+    ASSERT_OK(iter->status());
+  }
+  // Blocks kept in the compressed block cache are tracked by its memory tracker.
+  ASSERT_LT(0, compressed_cache->GetUsage());
+  ASSERT_LT(0, mem_tracker->consumption());
+
+  Close();
+}
 #endif
 
 }  // namespace rocksdb
@@ -36,7 +36,9 @@
 #include <algorithm>
 #include <climits>
 #include <cstdio>
+#include <deque>
 #include <map>
+#include <numeric>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -121,6 +123,9 @@
 #include "yb/rocksdb/util/thread_status_util.h"
 #include "yb/rocksdb/util/xfunc.h"
 
+#include "yb/util/format.h"
+#include "yb/util/priority_thread_pool.h"
+
 DEFINE_bool(dump_dbimpl_info, false, "Dump RocksDB info during constructor.");
 DEFINE_bool(flush_rocksdb_on_shutdown, true,
             "Safely flush RocksDB when instance is destroyed, disabled for crash tests.");
@@ -131,6 +136,59 @@ namespace rocksdb {
 
 const char kDefaultColumnFamilyName[] = "default";
 
+namespace {
+
+// Small compaction is run before the large compaction of a DB that has up to this number of
+// level 0 files more, since small compactions reduce the number of files faster.
+constexpr int kSmallCompactionPriorityBonus = 5;
+
+} // namespace
+
+class DBImpl::CompactionTask : public yb::PriorityThreadPoolTask {
+ public:
+  CompactionTask(DBImpl* db, bool large) : db_(db), large_(large) {}
+
+  void Run(const Status& status, yb::PriorityThreadPoolSuspender* suspender) override {
+    if (!status.ok()) {
+      InstrumentedMutexLock l(&db_->mutex_);
+      db_->bg_compaction_scheduled_--;
+      db_->bg_cv_.SignalAll();
+      return;
+    }
+    suspender_ = suspender;
+    IOSTATS_SET_THREAD_POOL_ID(Env::Priority::LOW);
+    db_->BackgroundCallCompaction(nullptr, this);
+  }
+
+  int Priority() const override {
+    return db_->CompactionPriority(large_.load(std::memory_order_acquire));
+  }
+
+  bool BelongsTo(void* key) const override {
+    return key == db_;
+  }
+
+  std::string ToString() const override {
+    return yb::Format("{ compaction db: $0 large: $1 }", db_->GetName(), large_.load());
+  }
+
+  // Invoked when it becomes known what compaction is run by this task.
+  void SetLarge(bool large) {
+    large_.store(large, std::memory_order_release);
+  }
+
+  yb::PriorityThreadPoolSuspender* suspender() const {
+    return suspender_;
+  }
+
+ private:
+  DBImpl* const db_;
+  // Until the task is started we assume that it will run a large compaction only when there are
+  // no small compactions in the queue.
+  std::atomic<bool> large_;
+  yb::PriorityThreadPoolSuspender* suspender_ = nullptr;
+};
+
 struct DBImpl::WriteContext {
   boost::container::small_vector<std::unique_ptr<SuperVersion>, 8> superversions_to_free_;
   autovector<MemTable*> memtables_to_free_;
@@ -209,7 +267,7 @@ DBOptions SanitizeOptions(const std::string& dbname, const DBOptions& src) {
     result.db_paths.emplace_back(dbname, std::numeric_limits<uint64_t>::max());
   }
 
-  if (result.compaction_readahead_size > 0) {
+  if (result.compaction_readahead_size > 0 || result.use_direct_io_for_flush_and_compaction) {
     result.new_table_reader_for_compaction_inputs = true;
   }
 
@@ -232,6 +290,11 @@ Status SanitizeOptionsByTable(
 }
 
 CompressionType GetCompressionFlush(const ImmutableCFOptions& ioptions) {
+  // Compression explicitly requested for flushes takes priority.
+  if (ioptions.flush_compression != kDisableCompressionOption) {
+    return ioptions.flush_compression;
+  }
+
   // Compressing memtable flushes might not help unless the sequential load
   // optimization is used for leveled compaction. Otherwise the CPU and
   // latency overhead is not offset by saving much space.
@@ -254,6 +317,11 @@ CompressionType GetCompressionFlush(const ImmutableCFOptions& ioptions) {
   }
 }
 
+const CompressionOptions& GetCompressionOptionsFlush(const ImmutableCFOptions& ioptions) {
+  return ioptions.flush_compression != kDisableCompressionOption
+      ? ioptions.flush_compression_opts : ioptions.compression_opts;
+}
+
 void DumpSupportInfo(Logger* logger) {
   RLOG(InfoLogLevel::INFO_LEVEL, logger, "Compression algorithms supported:");
   RLOG(InfoLogLevel::INFO_LEVEL, logger, "\tSnappy supported: %d",
@@ -309,6 +377,8 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
       next_job_id_(1),
       has_unpersisted_data_(false),
       env_options_(db_options_),
+      env_options_for_compaction_(
+          db_options_.env->OptimizeForCompactionTableWrite(env_options_, db_options_)),
 #ifndef ROCKSDB_LITE
       wal_manager_(db_options_, env_options_),
 #endif  // ROCKSDB_LITE
@@ -344,6 +414,9 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname)
 void DBImpl::CancelAllBackgroundWork(bool wait) {
   InstrumentedMutexLock l(&mutex_);
   shutting_down_.store(true, std::memory_order_release);
+  if (db_options_.priority_thread_pool_for_compactions) {
+    bg_compaction_scheduled_ -= db_options_.priority_thread_pool_for_compactions->Remove(this);
+  }
   bg_cv_.SignalAll();
   if (!wait) {
     return;
@@ -1491,7 +1564,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
         s = BuildTable(dbname_,
                        env_,
                        *cfd->ioptions(),
-                       env_options_,
+                       env_options_for_compaction_,
                        cfd->table_cache(),
                        iter.get(),
                        &meta,
@@ -1501,7 +1574,7 @@ Status DBImpl::WriteLevel0TableForRecovery(int job_id, ColumnFamilyData* cfd,
                        snapshot_seqs,
                        earliest_write_conflict_snapshot,
                        GetCompressionFlush(*cfd->ioptions()),
-                       cfd->ioptions()->compression_opts,
+                       GetCompressionOptionsFlush(*cfd->ioptions()),
                        paranoid_file_checks,
                        cfd->internal_stats(),
                        db_options_.boundary_extractor.get(),
@@ -1566,11 +1639,12 @@ Result<FileNumbersHolder> DBImpl::FlushMemTableToOutputFile(
   }
 
   FlushJob flush_job(
-      dbname_, cfd, db_options_, mutable_cf_options, env_options_,
+      dbname_, cfd, db_options_, mutable_cf_options, env_options_for_compaction_,
       versions_.get(), &mutex_, &shutting_down_, snapshot_seqs,
       earliest_write_conflict_snapshot, mem_table_flush_filter, pending_outputs_.get(),
       job_context, log_buffer, directories_.GetDbDir(), directories_.GetDataDir(0U),
-      GetCompressionFlush(*cfd->ioptions()), stats_, &event_logger_);
+      GetCompressionFlush(*cfd->ioptions()), GetCompressionOptionsFlush(*cfd->ioptions()),
+      stats_, &event_logger_);
 
   FileMetaData file_meta;
 
@@ -1959,7 +2033,7 @@ Status DBImpl::CompactFilesImpl(
 
   assert(is_snapshot_supported_ || snapshots_.empty());
   CompactionJob compaction_job(
-      job_context->job_id, c.get(), db_options_, env_options_, versions_.get(),
+      job_context->job_id, c.get(), db_options_, env_options_for_compaction_, versions_.get(),
       &shutting_down_, log_buffer, directories_.GetDbDir(),
       directories_.GetDataDir(c->output_path_id()), stats_, &mutex_, &bg_error_,
       snapshot_seqs, earliest_write_conflict_snapshot, pending_outputs_.get(), table_cache_,
@@ -2661,6 +2735,14 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
     return;
   }
 
+  if (db_options_.priority_thread_pool_for_compactions) {
+    UpdateCompactionPriority();
+    while (bg_compaction_scheduled_ < bg_compactions_allowed &&
+           unscheduled_compactions_ > 0 && SubmitCompactionTask()) {
+    }
+    return;
+  }
+
   while (bg_compaction_scheduled_ < bg_compactions_allowed &&
          unscheduled_compactions_ > 0) {
     CompactionArg* ca = new CompactionArg;
@@ -2673,6 +2755,40 @@ void DBImpl::MaybeScheduleFlushOrCompaction() {
   }
 }
 
+bool DBImpl::SubmitCompactionTask() {
+  std::unique_ptr<yb::PriorityThreadPoolTask> task(
+      new CompactionTask(this, small_compaction_queue_.empty()));
+  auto status = db_options_.priority_thread_pool_for_compactions->Submit(&task);
+  if (!status.ok()) {
+    RLOG(InfoLogLevel::WARN_LEVEL, db_options_.info_log, "Failed to submit compaction: %s",
+         status.ToString().c_str());
+    return false;
+  }
+  bg_compaction_scheduled_++;
+  unscheduled_compactions_--;
+  return true;
+}
+
+void DBImpl::UpdateCompactionPriority() {
+  mutex_.AssertHeld();
+  int stall_risk = std::numeric_limits<int>::min() / 2;
+  for (auto cfd : *versions_->GetColumnFamilySet()) {
+    if (cfd->IsDropped() || cfd->current() == nullptr) {
+      continue;
+    }
+    stall_risk = std::max(
+        stall_risk,
+        cfd->current()->storage_info()->l0_delay_trigger_count() -
+            cfd->GetLatestMutableCFOptions()->level0_slowdown_writes_trigger);
+  }
+  compaction_stall_risk_.store(stall_risk, std::memory_order_release);
+}
+
+int DBImpl::CompactionPriority(bool large) const {
+  return compaction_stall_risk_.load(std::memory_order_acquire) +
+         (large ? 0 : kSmallCompactionPriorityBonus);
+}
+
 int DBImpl::BGCompactionsAllowed() const {
   if (write_controller_.NeedSpeedupCompaction()) {
     return db_options_.max_background_compactions;
@@ -2920,7 +3036,7 @@ void DBImpl::BackgroundCallFlush() {
   }
 }
 
-void DBImpl::BackgroundCallCompaction(void* arg) {
+void DBImpl::BackgroundCallCompaction(void* arg, CompactionTask* compaction_task) {
   bool made_progress = false;
   ManualCompaction* m = reinterpret_cast<ManualCompaction*>(arg);
   JobContext job_context(next_job_id_.fetch_add(1), true);
@@ -2933,7 +3049,8 @@ void DBImpl::BackgroundCallCompaction(void* arg) {
     assert(bg_compaction_scheduled_);
     Status s;
     {
-      auto file_numbers_holder = BackgroundCompaction(&made_progress, &job_context, &log_buffer, m);
+      auto file_numbers_holder = BackgroundCompaction(
+          &made_progress, &job_context, &log_buffer, m, compaction_task);
       s = yb::ResultToStatus(file_numbers_holder);
       TEST_SYNC_POINT("BackgroundCallCompaction:1");
       WaitAfterBackgroundError(s, "compaction", &log_buffer);
@@ -2986,7 +3103,8 @@ void DBImpl::BackgroundCallCompaction(void* arg) {
 }
 
 Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
-    bool* made_progress, JobContext* job_context, LogBuffer* log_buffer, void* arg) {
+    bool* made_progress, JobContext* job_context, LogBuffer* log_buffer, void* arg,
+    CompactionTask* compaction_task) {
   ManualCompaction* manual_compaction =
       reinterpret_cast<ManualCompaction*>(arg);
   *made_progress = false;
@@ -3077,6 +3195,10 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
       return Status::OK();
     }
 
+    if (compaction_task) {
+      compaction_task->SetLarge(is_large_compaction);
+    }
+
     if (is_large_compaction) {
       num_running_large_compactions_++;
       TEST_SYNC_POINT("DBImpl:BackgroundCompaction:LargeCompaction");
@@ -3112,8 +3234,8 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
     // file if there is alive snapshot pointing to it
     assert(c->num_input_files(1) == 0);
     assert(c->level() == 0);
-    assert(c->column_family_data()->ioptions()->compaction_style ==
-           kCompactionStyleFIFO);
+    assert(c->column_family_data()->ioptions()->compaction_style == kCompactionStyleFIFO ||
+           c->column_family_data()->ioptions()->compaction_style == kCompactionStyleUniversal);
 
     compaction_job_stats.num_input_files = c->num_input_files(0);
 
@@ -3199,14 +3321,14 @@ Result<FileNumbersHolder> DBImpl::BackgroundCompaction(
 
     assert(is_snapshot_supported_ || snapshots_.empty());
     CompactionJob compaction_job(
-        job_context->job_id, c.get(), db_options_, env_options_,
+        job_context->job_id, c.get(), db_options_, env_options_for_compaction_,
         versions_.get(), &shutting_down_, log_buffer, directories_.GetDbDir(),
         directories_.GetDataDir(c->output_path_id()), stats_, &mutex_,
         &bg_error_, snapshot_seqs, earliest_write_conflict_snapshot,
         pending_outputs_.get(), table_cache_, &event_logger_,
         c->mutable_cf_options()->paranoid_file_checks,
         c->mutable_cf_options()->compaction_measure_io_stats, dbname_,
-        &compaction_job_stats);
+        &compaction_job_stats, compaction_task ? compaction_task->suspender() : nullptr);
     compaction_job.Prepare();
 
     mutex_.Unlock();
@@ -3598,9 +3720,6 @@ std::vector<Status> DBImpl::MultiGet(
   }
   mutex_.Unlock();
 
-  // Contain a list of merge operations if merge occurs.
-  MergeContext merge_context;
-
   // Note: this always resizes the values array
   size_t num_keys = keys.size();
   std::vector<Status> stat_list(num_keys);
@@ -3610,42 +3729,68 @@ std::vector<Status> DBImpl::MultiGet(
   uint64_t bytes_read = 0;
   PERF_TIMER_STOP(get_snapshot_time);
 
-  // For each of the given keys, apply the entire "get" process as follows:
-  // First look in the memtable, then in the immutable memtable (if any).
-  // s is both in/out. When in, s could either be OK or MergeInProgress.
-  // merge_operands will contain the sequence of merges in the latter case.
-  for (size_t i = 0; i < num_keys; ++i) {
-    merge_context.Clear();
-    Status& s = stat_list[i];
-    std::string* value = &(*values)[i];
-
-    LookupKey lkey(keys[i], snapshot);
-    auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family[i]);
-    auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
-    assert(mgd_iter != multiget_cf_data.end());
-    auto mgd = mgd_iter->second;
-    auto super_version = mgd->super_version;
-    bool skip_memtable =
-        (read_options.read_tier == kPersistedTier && has_unpersisted_data_);
-    bool done = false;
+  // Keys are processed grouped by column family and sorted by user key, so table files of each
+  // column family are visited once for all keys, in key order.
+  std::vector<size_t> order(num_keys);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&column_family, &keys](size_t lhs, size_t rhs) {
+    auto lhs_cfd = down_cast<ColumnFamilyHandleImpl*>(column_family[lhs])->cfd();
+    auto rhs_cfd = down_cast<ColumnFamilyHandleImpl*>(column_family[rhs])->cfd();
+    if (lhs_cfd->GetID() != rhs_cfd->GetID()) {
+      return lhs_cfd->GetID() < rhs_cfd->GetID();
+    }
+    return lhs_cfd->user_comparator()->Compare(keys[lhs], keys[rhs]) < 0;
+  });
+
+  // For each of the given keys, first look in the memtable, then in the immutable memtable
+  // (if any). Keys that are not resolved by memtables are looked up in table files together.
+  // Status is both in/out. When in, it could either be OK or MergeInProgress.
+  // merge_context will contain the sequence of merges in the latter case.
+  std::deque<MultiGetKeyContext> key_contexts;
+  std::vector<MultiGetKeyContext*> pending;
+  SuperVersion* pending_super_version = nullptr;
+  bool skip_memtable =
+      (read_options.read_tier == kPersistedTier && has_unpersisted_data_);
+  for (size_t i = 0; i <= num_keys; ++i) {
+    SuperVersion* super_version = nullptr;
+    if (i != num_keys) {
+      auto cfh = down_cast<ColumnFamilyHandleImpl*>(column_family[order[i]]);
+      auto mgd_iter = multiget_cf_data.find(cfh->cfd()->GetID());
+      assert(mgd_iter != multiget_cf_data.end());
+      super_version = mgd_iter->second->super_version;
+    }
+    if (!pending.empty() && pending_super_version != super_version) {
+      PERF_TIMER_GUARD(get_from_output_files_time);
+      pending_super_version->current->MultiGet(read_options, pending);
+      // TODO(?): RecordTick(stats_, MEMTABLE_MISS)?
+      pending.clear();
+    }
+    pending_super_version = super_version;
+    if (i == num_keys) {
+      break;
+    }
+
+    const size_t index = order[i];
+    Status& s = stat_list[index];
+    std::string* value = &(*values)[index];
+    key_contexts.emplace_back(keys[index], snapshot, value, &s);
+    auto& key_context = key_contexts.back();
     if (!skip_memtable) {
-      if (super_version->mem->Get(lkey, value, &s, &merge_context)) {
-        done = true;
+      if (super_version->mem->Get(key_context.lkey, value, &s, &key_context.merge_context)) {
         // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
-      } else if (super_version->imm->Get(lkey, value, &s, &merge_context)) {
-        done = true;
+        continue;
+      }
+      if (super_version->imm->Get(key_context.lkey, value, &s, &key_context.merge_context)) {
         // TODO(?): RecordTick(stats_, MEMTABLE_HIT)?
+        continue;
       }
     }
-    if (!done) {
-      PERF_TIMER_GUARD(get_from_output_files_time);
-      super_version->current->Get(read_options, lkey, value, &s,
-                                  &merge_context);
-      // TODO(?): RecordTick(stats_, MEMTABLE_MISS)?
-    }
+    pending.push_back(&key_context);
+  }
 
-    if (s.ok()) {
-      bytes_read += value->size();
+  for (size_t i = 0; i < num_keys; ++i) {
+    if (stat_list[i].ok()) {
+      bytes_read += (*values)[i].size();
     }
   }
 
@@ -3839,6 +3984,10 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
     return STATUS(InvalidArgument,
         "Non zero sequence numbers are not supported");
   }
+  if (file_info->frontiers) {
+    meta.smallest.user_frontier = file_info->frontiers->Smallest().Clone();
+    meta.largest.user_frontier = file_info->frontiers->Largest().Clone();
+  }
 
   std::string db_base_fname;
   std::string db_data_fname;
@@ -3913,6 +4062,9 @@ Status DBImpl::AddFile(ColumnFamilyHandle* column_family,
         VersionEdit edit;
         edit.SetColumnFamily(cfd->GetID());
         edit.AddCleanedFile(0, meta);
+        if (file_info->frontiers) {
+          edit.UpdateFlushedFrontier(file_info->frontiers->Largest().Clone());
+        }
 
         status = versions_->LogAndApply(
             cfd, mutable_cf_options, &edit, &mutex_, directories_.GetDbDir());
@@ -4589,8 +4741,9 @@ Status DBImpl::WriteImpl(const WriteOptions& write_options,
     // 3. Deletes or SingleDeletes are not okay if filtering deletes
     //    (controlled by both batch and memtable setting)
     // 4. Merges are not okay
-    // 5. YugaByte-specific user-specified sequence numbers are currently not compatible with
-    //    parallel memtable writes.
+    //
+    // User frontiers of write batches are merged into the memtable under its frontiers mutex, so
+    // they are compatible with parallel memtable writes.
     //
     // Rules 1..3 are enforced by checking the options
     // during startup (CheckConcurrentWritesSupported), so if
@@ -598,10 +598,23 @@ class DBImpl : public DB {
   static void BGWorkFlush(void* db);
   static void UnscheduleCallback(void* arg);
   void WaitAfterBackgroundError(const Status& s, const char* job_name, LogBuffer* log_buffer);
-  void BackgroundCallCompaction(void* arg);
+  class CompactionTask;
+
+  void BackgroundCallCompaction(void* arg, CompactionTask* compaction_task = nullptr);
   void BackgroundCallFlush();
   Result<FileNumbersHolder> BackgroundCompaction(
-      bool* made_progress, JobContext* job_context, LogBuffer* log_buffer, void* m = 0);
+      bool* made_progress, JobContext* job_context, LogBuffer* log_buffer, void* m = 0,
+      CompactionTask* compaction_task = nullptr);
+
+  // Submits automatic compaction to priority_thread_pool_for_compactions.
+  bool SubmitCompactionTask();
+
+  // Updates state used to calculate priority of compaction tasks of this DB.
+  // REQUIRES: mutex held
+  void UpdateCompactionPriority();
+
+  // Priority of the compaction task of this DB in priority_thread_pool_for_compactions.
+  int CompactionPriority(bool large) const;
   Result<FileNumbersHolder> BackgroundFlush(
       bool* made_progress, JobContext* job_context, LogBuffer* log_buffer);
 
@@ -844,6 +857,10 @@ class DBImpl : public DB {
   // stores the number of large compaction that are currently running
   int num_running_large_compactions_;
 
+  // Max number of level 0 files above level0_slowdown_writes_trigger among column families,
+  // negative when writes are not slowed down. Used for priority of compaction tasks.
+  std::atomic<int> compaction_stall_risk_{std::numeric_limits<int>::min() / 2};
+
   // number of background memtable flush jobs, submitted to the HIGH pool
   int bg_flush_scheduled_;
 
@@ -911,6 +928,9 @@ class DBImpl : public DB {
   // The options to access storage files
   const EnvOptions env_options_;
 
+  // The options to write table files by flush and compaction.
+  const EnvOptions env_options_for_compaction_;
+
 #ifndef ROCKSDB_LITE
   WalManager wal_manager_;
 #endif  // ROCKSDB_LITE
@@ -247,6 +247,7 @@ inline bool DBIter::ParseKey(ParsedInternalKey* ikey) {
 
 void DBIter::Next() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_next_count, 1);
 
   if (direction_ == kReverse) {
     FindNextUserKey();
@@ -445,6 +446,7 @@ void DBIter::MergeValuesNewToOld() {
 
 void DBIter::Prev() {
   assert(valid_);
+  PERF_COUNTER_ADD(iter_prev_count, 1);
   if (direction_ == kForward) {
     ReverseToBackward();
   }
@@ -741,6 +743,7 @@ void DBIter::FindParseableKey(ParsedInternalKey* ikey, Direction direction) {
 
 void DBIter::Seek(const Slice& target) {
   StopWatch sw(env_, statistics_, DB_SEEK);
+  PERF_COUNTER_ADD(iter_seek_count, 1);
   saved_key_.Clear();
   // now savved_key is used to store internal key.
   saved_key_.SetInternalKey(target, sequence_);
@@ -777,6 +780,7 @@ void DBIter::SeekToFirst() {
   }
   direction_ = kForward;
   ClearSavedValue();
+  PERF_COUNTER_ADD(iter_seek_count, 1);
 
   {
     PERF_TIMER_GUARD(seek_internal_seek_time);
@@ -808,6 +812,7 @@ void DBIter::SeekToLast() {
   }
   direction_ = kReverse;
   ClearSavedValue();
+  PERF_COUNTER_ADD(iter_seek_count, 1);
 
   {
     PERF_TIMER_GUARD(seek_internal_seek_time);
@@ -38,6 +38,8 @@
 #include <alloca.h>
 #endif
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/db/filename.h"
 #include "yb/rocksdb/db/dbformat.h"
 #include "yb/rocksdb/db/db_impl.h"
@@ -90,6 +92,8 @@
 #include "yb/rocksdb/util/xfunc.h"
 #include "yb/util/tsan_util.h"
 
+DECLARE_uint64(rocksdb_iterator_max_readahead_size);
+
 namespace rocksdb {
 
 #ifndef ROCKSDB_LITE
@@ -1294,6 +1298,57 @@ TEST_F(DBTest, IterSingle) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBTest, IterReadahead) {
+  google::FlagSaver flag_saver;
+  Options options = CurrentOptions();
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 1024;
+  table_options.no_block_cache = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.env = env_;
+  DestroyAndReopen(options);
+
+  constexpr int kNumKeys = 2000;
+  Random rnd(301);
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(Put(Key(i), RandomString(&rnd, 100)));
+  }
+  ASSERT_OK(Flush());
+
+  env_->count_random_reads_ = true;
+  Reopen(options);
+
+  auto scan = [this] {
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    EXPECT_OK(iter->status());
+    return count;
+  };
+
+  env_->random_read_counter_.Reset();
+  env_->random_prefetch_counter_.Reset();
+  ASSERT_EQ(kNumKeys, scan());
+  const int num_reads = env_->random_read_counter_.Read();
+  const int num_prefetches = env_->random_prefetch_counter_.Read();
+  // Readahead grows exponentially, so there are much less prefetches than data block reads.
+  ASSERT_GT(num_prefetches, 0);
+  ASSERT_LT(num_prefetches * 10, num_reads);
+
+  // Point reads do not trigger readahead.
+  env_->random_prefetch_counter_.Reset();
+  for (int i = 0; i < kNumKeys; i += 100) {
+    ASSERT_NE("NOT_FOUND", Get(Key(i)));
+  }
+  ASSERT_EQ(0, env_->random_prefetch_counter_.Read());
+
+  FLAGS_rocksdb_iterator_max_readahead_size = 0;
+  ASSERT_EQ(kNumKeys, scan());
+  ASSERT_EQ(0, env_->random_prefetch_counter_.Read());
+}
+
 TEST_F(DBTest, IterMulti) {
   do {
     CreateAndReopenWithCF({"pikachu"}, CurrentOptions());
@@ -5094,6 +5149,61 @@ TEST_F(DBTest, MultiGetEmpty) {
   } while (ChangeCompactOptions());
 }
 
+TEST_F(DBTest, MultiGetAcrossFiles) {
+  do {
+    Options options = CurrentOptions();
+    BlockBasedTableOptions table_options;
+    table_options.block_size = 256;
+    table_options.filter_policy.reset(NewBloomFilterPolicy(10, false));
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    CreateAndReopenWithCF({"pikachu"}, options);
+
+    constexpr int kNumKeys = 200;
+    // Older versions of all keys end up in the bottommost files.
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_OK(Put(1, Key(i), "old" + ToString(i)));
+    }
+    ASSERT_OK(Flush(1));
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[1], nullptr, nullptr));
+    // Two more files with updates and deletions, and some changes left in the memtable.
+    for (int i = 0; i < kNumKeys; i += 3) {
+      ASSERT_OK(Put(1, Key(i), "new" + ToString(i)));
+    }
+    ASSERT_OK(Flush(1));
+    for (int i = 1; i < kNumKeys; i += 5) {
+      ASSERT_OK(Delete(1, Key(i)));
+    }
+    ASSERT_OK(Flush(1));
+    for (int i = 0; i < kNumKeys; i += 7) {
+      ASSERT_OK(Put(1, Key(i), "mem" + ToString(i)));
+    }
+
+    // Look up keys in reverse order, with duplicates and keys that do not exist.
+    std::vector<std::string> key_strings;
+    for (int i = kNumKeys + 10; i-- > 0;) {
+      key_strings.push_back(Key(i));
+      if (i % 50 == 0) {
+        key_strings.push_back(Key(i));
+      }
+    }
+    std::vector<Slice> keys(key_strings.begin(), key_strings.end());
+    std::vector<ColumnFamilyHandle*> cfs(keys.size(), handles_[1]);
+    std::vector<std::string> values;
+    std::vector<Status> s = db_->MultiGet(ReadOptions(), cfs, keys, &values);
+    ASSERT_EQ(keys.size(), s.size());
+    ASSERT_EQ(keys.size(), values.size());
+    for (size_t i = 0; i != keys.size(); ++i) {
+      std::string expected = Get(1, key_strings[i]);
+      if (expected == "NOT_FOUND") {
+        ASSERT_TRUE(s[i].IsNotFound()) << key_strings[i] << ": " << s[i].ToString();
+      } else {
+        ASSERT_OK(s[i]);
+        ASSERT_EQ(expected, values[i]) << key_strings[i];
+      }
+    }
+  } while (ChangeCompactOptions());
+}
+
 TEST_F(DBTest, BlockBasedTablePrefixIndexTest) {
   // create a DB with block prefix index
   BlockBasedTableOptions table_options;
@@ -5322,6 +5432,40 @@ TEST_F(DBTest, ConcurrentMemtableNotSupported) {
   ASSERT_NOK(db_->CreateColumnFamily(cf_options, "name", &handle));
 }
 
+TEST_F(DBTest, ConcurrentMemtableWriteWithFrontiers) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumBatchesPerThread = 100;
+
+  Options options = CurrentOptions();
+  options.allow_concurrent_memtable_write = true;
+  options.create_if_missing = true;
+  DestroyAndReopen(options);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kNumThreads; ++t) {
+    threads.emplace_back([this, t] {
+      for (int i = 0; i != kNumBatchesPerThread; ++i) {
+        const int value = 1 + t * kNumBatchesPerThread + i;
+        WriteBatch batch;
+        test::TestUserFrontiers frontiers(value, value);
+        batch.SetFrontiers(&frontiers);
+        batch.Put(Key(value), std::to_string(value));
+        ASSERT_OK(dbfull()->Write(WriteOptions(), &batch));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_OK(dbfull()->TEST_FlushMemTable(true));
+  ASSERT_EQ(kNumThreads * kNumBatchesPerThread,
+            down_cast<test::TestUserFrontier&>(*dbfull()->GetFlushedFrontier()).Value());
+  for (int value = 1; value <= kNumThreads * kNumBatchesPerThread; ++value) {
+    ASSERT_EQ(std::to_string(value), Get(Key(value)));
+  }
+}
+
 #endif  // ROCKSDB_LITE
 
 TEST_F(DBTest, SanitizeNumThreads) {
@@ -7832,6 +7976,103 @@ TEST_F(DBTest, FailWhenCompressionNotSupportedTest) {
   }
 }
 
+TEST_F(DBTest, ZSTDDictionaryCompression) {
+  if (!ZSTD_Supported()) {
+    return;
+  }
+  // Values share structure across blocks, but are not repeated within a single small block, which
+  // is a case where the per file dictionary helps.
+  const std::vector<std::string> kWords = {
+      "\"customer_id\": ", "\"order_status\": \"delivered\"", "\"shipping_address\": ",
+      "\"payment_method\": \"credit_card\"", "\"created_at\": \"2018-", "\"items\": [",
+      "\"discount_code\": null", "\"warehouse\": \"us-west-2\""};
+  Random rnd(301);
+  std::vector<std::string> values;
+  for (int i = 0; i < 2000; ++i) {
+    std::string value = "{";
+    for (int j = 0; j < 6; ++j) {
+      value += kWords[rnd.Uniform(static_cast<int>(kWords.size()))];
+      value += ToString(rnd.Next() % 100000) + ", ";
+    }
+    values.push_back(value + "}");
+  }
+
+  auto build_and_check = [this, &values](uint32_t max_dict_bytes, uint32_t zstd_max_train_bytes) {
+    Options options = CurrentOptions();
+    options.compression = kZSTD;
+    options.compression_opts.max_dict_bytes = max_dict_bytes;
+    options.compression_opts.zstd_max_train_bytes = zstd_max_train_bytes;
+    options.disable_auto_compactions = true;
+    BlockBasedTableOptions table_options;
+    table_options.block_size = 1024;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    for (size_t i = 0; i != values.size(); ++i) {
+      EXPECT_OK(Put(Key(static_cast<int>(i)), values[i]));
+    }
+    EXPECT_OK(Flush());
+    Reopen(options);
+    for (size_t i = 0; i != values.size(); ++i) {
+      EXPECT_EQ(values[i], Get(Key(static_cast<int>(i))));
+    }
+    return TotalSize();
+  };
+
+  const auto size_without_dict = build_and_check(0, 0);
+  const auto size_with_raw_dict = build_and_check(16 * 1024, 0);
+  const auto size_with_trained_dict = build_and_check(16 * 1024, 256 * 1024);
+  ASSERT_LT(size_with_raw_dict, size_without_dict);
+  ASSERT_LT(size_with_trained_dict, size_without_dict);
+}
+
+TEST_F(DBTest, FlushAndBottommostCompression) {
+  if (!Snappy_Supported() || !Zlib_Supported()) {
+    return;
+  }
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleUniversal;
+  options.num_levels = 1;
+  options.level0_file_num_compaction_trigger = 2;
+  options.compression = kSnappyCompression;
+  options.flush_compression = kNoCompression;
+  options.bottommost_compression = kZlibCompression;
+  options.bottommost_compression_opts.level = 9;
+  DestroyAndReopen(options);
+
+  std::atomic<int> num_flushes(0);
+  std::atomic<int> num_compaction_outputs(0);
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "FlushJob::WriteLevel0Table:output_compression", [&](void* arg) {
+        auto* compression = reinterpret_cast<CompressionType*>(arg);
+        ASSERT_EQ(kNoCompression, *compression);
+        num_flushes.fetch_add(1);
+      });
+  rocksdb::SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::OpenCompactionOutputFile:output_compression", [&](void* arg) {
+        auto* compression = reinterpret_cast<CompressionType*>(arg);
+        ASSERT_EQ(kZlibCompression, *compression);
+        num_compaction_outputs.fetch_add(1);
+      });
+  rocksdb::SyncPoint::GetInstance()->EnableProcessing();
+
+  Random rnd(301);
+  for (int i = 0; i < 2; ++i) {
+    for (int j = 0; j < 100; ++j) {
+      ASSERT_OK(Put(Key(i * 100 + j), RandomString(&rnd, 100)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  rocksdb::SyncPoint::GetInstance()->DisableProcessing();
+  rocksdb::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(2, num_flushes.load());
+  ASSERT_GT(num_compaction_outputs.load(), 0);
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+}
+
 #ifndef ROCKSDB_LITE
 TEST_F(DBTest, RowCache) {
   Options options = CurrentOptions();
@@ -89,7 +89,8 @@ FlushJob::FlushJob(const std::string& dbname, ColumnFamilyData* cfd,
                    FileNumbersProvider* file_numbers_provider,
                    JobContext* job_context, LogBuffer* log_buffer,
                    Directory* db_directory, Directory* output_file_directory,
-                   CompressionType output_compression, Statistics* stats,
+                   CompressionType output_compression,
+                   const CompressionOptions& output_compression_opts, Statistics* stats,
                    EventLogger* event_logger)
     : dbname_(dbname),
       cfd_(cfd),
@@ -108,6 +109,7 @@ FlushJob::FlushJob(const std::string& dbname, ColumnFamilyData* cfd,
       db_directory_(db_directory),
       output_file_directory_(output_file_directory),
       output_compression_(output_compression),
+      output_compression_opts_(output_compression_opts),
       stats_(stats),
       event_logger_(event_logger) {
   // Update the thread status to indicate flush.
@@ -291,7 +293,7 @@ Result<FileNumbersHolder> FlushJob::WriteLevel0Table(
                      existing_snapshots_,
                      earliest_write_conflict_snapshot_,
                      output_compression_,
-                     cfd_->ioptions()->compression_opts,
+                     output_compression_opts_,
                      mutable_cf_options_.paranoid_file_checks,
                      cfd_->internal_stats(),
                      db_options_.boundary_extractor.get(),
@@ -86,7 +86,8 @@ class FlushJob {
            FileNumbersProvider* file_number_provider,
            JobContext* job_context, LogBuffer* log_buffer,
            Directory* db_directory, Directory* output_file_directory,
-           CompressionType output_compression, Statistics* stats,
+           CompressionType output_compression,
+           const CompressionOptions& output_compression_opts, Statistics* stats,
            EventLogger* event_logger);
 
   ~FlushJob();
@@ -117,6 +118,7 @@ class FlushJob {
   Directory* db_directory_;
   Directory* output_file_directory_;
   CompressionType output_compression_;
+  CompressionOptions output_compression_opts_;
   Statistics* stats_;
   EventLogger* event_logger_;
   TableProperties table_properties_;
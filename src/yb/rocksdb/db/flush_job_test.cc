@@ -111,7 +111,8 @@ TEST_F(FlushJobTest, Empty) {
                      db_options_, *cfd->GetLatestMutableCFOptions(),
                      env_options_, versions_.get(), &mutex_, &shutting_down_,
                      {}, kMaxSequenceNumber, MemTableFilter(), &file_numbers_provider,
-                     &job_context, nullptr, nullptr, nullptr, kNoCompression, nullptr,
+                     &job_context, nullptr, nullptr, nullptr, kNoCompression,
+                     CompressionOptions(), nullptr,
                      &event_logger);
   ASSERT_OK(yb::ResultToStatus(flush_job.Run()));
   job_context.Clean();
@@ -158,7 +159,8 @@ TEST_F(FlushJobTest, NonEmpty) {
                      db_options_, *cfd->GetLatestMutableCFOptions(),
                      env_options_, versions_.get(), &mutex_, &shutting_down_,
                      {}, kMaxSequenceNumber, MemTableFilter(), &file_numbers_provider,
-                     &job_context, nullptr, nullptr, nullptr, kNoCompression, nullptr,
+                     &job_context, nullptr, nullptr, nullptr, kNoCompression,
+                     CompressionOptions(), nullptr,
                      &event_logger);
   FileMetaData fd;
   mutex_.Lock();
@@ -227,7 +229,8 @@ TEST_F(FlushJobTest, Snapshots) {
                      db_options_, *cfd->GetLatestMutableCFOptions(),
                      env_options_, versions_.get(), &mutex_, &shutting_down_,
                      snapshots, kMaxSequenceNumber, MemTableFilter(), &file_numbers_provider,
-                     &job_context, nullptr, nullptr, nullptr, kNoCompression, nullptr,
+                     &job_context, nullptr, nullptr, nullptr, kNoCompression,
+                     CompressionOptions(), nullptr,
                      &event_logger);
   mutex_.Lock();
   ASSERT_OK(ResultToStatus(flush_job.Run()));
@@ -37,6 +37,7 @@
 #include "yb/rocksdb/merge_operator.h"
 #include "yb/rocksdb/slice_transform.h"
 #include "yb/rocksdb/table/internal_iterator.h"
+#include "yb/rocksdb/table/iterator_wrapper.h"
 #include "yb/rocksdb/table/merger.h"
 #include "yb/rocksdb/util/arena.h"
 #include "yb/rocksdb/util/coding.h"
@@ -64,6 +65,7 @@ MemTableOptions::MemTableOptions(
         mutable_cf_options.memtable_prefix_bloom_probes),
     memtable_prefix_bloom_huge_page_tlb_size(
         mutable_cf_options.memtable_prefix_bloom_huge_page_tlb_size),
+    memtable_huge_page_size(mutable_cf_options.memtable_huge_page_size),
     inplace_update_support(ioptions.inplace_update_support),
     inplace_update_num_locks(mutable_cf_options.inplace_update_num_locks),
     inplace_callback(ioptions.inplace_callback),
@@ -85,7 +87,7 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
       moptions_(ioptions, mutable_cf_options),
       refs_(0),
       kArenaBlockSize(OptimizeBlockSize(moptions_.arena_block_size)),
-      arena_(moptions_.arena_block_size, 0),
+      arena_(moptions_.arena_block_size, moptions_.memtable_huge_page_size),
       allocator_(&arena_, write_buffer),
       table_(ioptions.memtable_factory->CreateMemTableRep(
           comparator_, &allocator_, ioptions.prefix_extractor,
@@ -118,6 +120,15 @@ MemTable::MemTable(const InternalKeyComparator& cmp,
         ioptions.info_log));
   }
 
+  if (ioptions.memtable_filter && ioptions.memtable_filter->num_bits > 0) {
+    const auto& filter_options = *ioptions.memtable_filter;
+    filter_key_transformer_ = filter_options.filter_policy
+        ? filter_options.filter_policy->GetKeyTransformer() : nullptr;
+    key_filter_.reset(new DynamicBloom(
+        &allocator_, filter_options.num_bits, ioptions.bloom_locality,
+        filter_options.num_probes, nullptr, 0 /* huge_page_tlb_size */, ioptions.info_log));
+  }
+
   if (moptions_.mem_tracker) {
     arena_.SetMemTracker(moptions_.mem_tracker);
   }
@@ -344,10 +355,30 @@ class MemTableIterator : public InternalIterator {
 InternalIterator* MemTable::NewIterator(const ReadOptions& read_options,
                                         Arena* arena) {
   assert(arena != nullptr);
+  if (read_options.table_aware_file_filter &&
+      !read_options.table_aware_file_filter->FilterMemTable(*this)) {
+    return NewEmptyInternalIterator(arena);
+  }
   auto mem = arena->AllocateAligned(sizeof(MemTableIterator));
   return new (mem) MemTableIterator(*this, read_options, arena);
 }
 
+Slice MemTable::FilterKey(const Slice& user_key) const {
+  return filter_key_transformer_ ? filter_key_transformer_->Transform(user_key) : user_key;
+}
+
+bool MemTable::FilterKeyMayMatch(const Slice& user_key) const {
+  if (!key_filter_) {
+    return true;
+  }
+  if (!key_filter_->MayContain(FilterKey(user_key))) {
+    PERF_COUNTER_ADD(bloom_memtable_miss_count, 1);
+    return false;
+  }
+  PERF_COUNTER_ADD(bloom_memtable_hit_count, 1);
+  return true;
+}
+
 port::RWMutex* MemTable::GetLock(const Slice& key) {
   static murmur_hash hash;
   return &locks_[hash(key) % locks_.size()];
@@ -438,6 +469,10 @@ void MemTable::Add(SequenceNumber s, ValueType type,
       prefix_bloom_->Add(prefix_extractor_->Transform(key));
     }
 
+    if (key_filter_) {
+      key_filter_->Add(FilterKey(key));
+    }
+
     // The first sequence number inserted into the memtable.
     // Multiple occurences of the same sequence number in the write batch are allowed
     // as long as they touch different keys.
@@ -465,6 +500,10 @@ void MemTable::Add(SequenceNumber s, ValueType type,
       prefix_bloom_->AddConcurrently(prefix_extractor_->Transform(key));
     }
 
+    if (key_filter_) {
+      key_filter_->AddConcurrently(FilterKey(key));
+    }
+
     // atomically update first_seqno_ and earliest_seqno_.
     uint64_t cur_seq_num = first_seqno_.load(std::memory_order_relaxed);
     while ((cur_seq_num == 0 || s < cur_seq_num) &&
@@ -474,7 +513,7 @@ void MemTable::Add(SequenceNumber s, ValueType type,
         earliest_seqno_.load(std::memory_order_relaxed);
     while (
         (cur_earliest_seqno == kMaxSequenceNumber || s < cur_earliest_seqno) &&
-        !first_seqno_.compare_exchange_weak(cur_earliest_seqno, s)) {
+        !earliest_seqno_.compare_exchange_weak(cur_earliest_seqno, s)) {
     }
   }
 
@@ -30,6 +30,7 @@
 #include <deque>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -70,6 +71,7 @@ struct MemTableOptions {
   uint32_t memtable_prefix_bloom_bits;
   uint32_t memtable_prefix_bloom_probes;
   size_t memtable_prefix_bloom_huge_page_tlb_size;
+  size_t memtable_huge_page_size;
   bool inplace_update_support;
   size_t inplace_update_num_locks;
   UpdateStatus (*inplace_callback)(char* existing_value,
@@ -180,6 +182,7 @@ class MemTable {
   // arena: If not null, the arena needs to be used to allocate the Iterator.
   //        Calling ~Iterator of the iterator will destroy all the states but
   //        those allocated in arena.
+  // Returns an empty iterator if read_options.table_aware_file_filter rejects this memtable.
   InternalIterator* NewIterator(const ReadOptions& read_options, Arena* arena);
 
   // Add an entry into memtable that maps key to value at the
@@ -213,6 +216,10 @@ class MemTable {
     return Get(key, value, s, merge_context, &seq);
   }
 
+  // Returns false if the memtable key filter guarantees that there are no keys matching user_key
+  // after key transformation of the filter policy, true otherwise or if there is no key filter.
+  bool FilterKeyMayMatch(const Slice& user_key) const;
+
   // Attempts to update the new_value inplace, else does normal Add
   // Pseudocode
   //   if key exists in current memtable && prev_value is of type kTypeValue
@@ -341,13 +348,18 @@ class MemTable {
 
   const MemTableOptions* GetMemTableOptions() const { return &moptions_; }
 
+  // Could be invoked concurrently by parallel memtable writers.
   void UpdateFrontiers(const UserFrontiers& value) {
+    std::lock_guard<std::mutex> lock(frontiers_mutex_);
     if (frontiers_) {
       frontiers_->MergeFrontiers(value);
     } else {
       frontiers_ = value.Clone();
     }
   }
+
+  // Should not be invoked concurrently with writes to this memtable, i.e. is used for immutable
+  // memtables only.
   const UserFrontiers* Frontiers() const { return frontiers_.get(); }
 
   std::string ToString() const;
@@ -358,6 +370,8 @@ class MemTable {
   friend class MemTableBackwardIterator;
   friend class MemTableList;
 
+  Slice FilterKey(const Slice& user_key) const;
+
   KeyComparator comparator_;
   const MemTableOptions moptions_;
   int refs_;
@@ -401,10 +415,15 @@ class MemTable {
   const SliceTransform* const prefix_extractor_;
   std::unique_ptr<DynamicBloom> prefix_bloom_;
 
+  // Bloom filter of keys added to this memtable, transformed by filter_key_transformer_.
+  const FilterPolicy::KeyTransformer* filter_key_transformer_ = nullptr;
+  std::unique_ptr<DynamicBloom> key_filter_;
+
   std::atomic<FlushState> flush_state_;
 
   Env* env_;
 
+  std::mutex frontiers_mutex_;
   std::unique_ptr<UserFrontiers> frontiers_;
 
   // Returns a heuristic flush decision
@@ -412,6 +412,52 @@ Status TableCache::Get(const ReadOptions& options,
   return s;
 }
 
+void TableCache::MultiGet(const ReadOptions& options,
+                          const InternalKeyComparatorPtr& internal_comparator,
+                          const FileDescriptor& fd, TableMultiGetKey* keys, size_t num_keys,
+                          HistogramImpl* file_read_hist, bool skip_filters) {
+#ifndef ROCKSDB_LITE
+  // Row cache is maintained per key by Get.
+  if (ioptions_.row_cache) {
+    for (size_t i = 0; i != num_keys; ++i) {
+      keys[i].status = Get(options, internal_comparator, fd, keys[i].internal_key,
+                           keys[i].get_context, file_read_hist, skip_filters);
+    }
+    return;
+  }
+#endif  // ROCKSDB_LITE
+
+  TableReader* t = fd.table_reader;
+  Status s;
+  Cache::Handle* handle = nullptr;
+  if (!t) {
+    s = FindTable(env_options_, internal_comparator, fd, &handle,
+                  options.query_id, options.read_tier == kBlockCacheTier /* no_io */,
+                  true /* record_read_stats */, file_read_hist, skip_filters);
+    if (s.ok()) {
+      t = GetTableReaderFromHandle(handle);
+    }
+  }
+  if (s.ok()) {
+    t->MultiGet(options, keys, num_keys, skip_filters);
+    if (handle != nullptr) {
+      ReleaseHandle(handle);
+    }
+    return;
+  }
+
+  const bool may_exist = options.read_tier == kBlockCacheTier && s.IsIncomplete();
+  for (size_t i = 0; i != num_keys; ++i) {
+    if (may_exist) {
+      // Couldn't find Table in cache but treat as kFound if no_io set
+      keys[i].get_context->MarkKeyMayExist();
+      keys[i].status = Status::OK();
+    } else {
+      keys[i].status = s;
+    }
+  }
+}
+
 Status TableCache::GetTableProperties(
     const EnvOptions& env_options,
     const InternalKeyComparatorPtr& internal_comparator, const FileDescriptor& fd,
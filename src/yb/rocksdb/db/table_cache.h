@@ -104,6 +104,13 @@ class TableCache {
              GetContext* get_context, HistogramImpl* file_read_hist = nullptr,
              bool skip_filters = false);
 
+  // Looks up multiple keys in the specified file, with the same semantics as Get for each key.
+  // The table reader is looked up once for all keys.
+  void MultiGet(const ReadOptions& options,
+                const InternalKeyComparatorPtr& internal_comparator,
+                const FileDescriptor& file_fd, TableMultiGetKey* keys, size_t num_keys,
+                HistogramImpl* file_read_hist = nullptr, bool skip_filters = false);
+
   // Evict any entry for the specified file number
   static void Evict(Cache* cache, uint64_t file_number);
 
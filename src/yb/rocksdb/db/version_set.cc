@@ -999,6 +999,154 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+void Version::MultiGet(const ReadOptions& read_options,
+                       const std::vector<MultiGetKeyContext*>& keys) {
+  std::deque<GetContext> get_contexts;
+  // Indexes of keys that are not resolved yet, in the order of keys.
+  std::vector<size_t> pending;
+  pending.reserve(keys.size());
+  for (size_t i = 0; i != keys.size(); ++i) {
+    auto& key = *keys[i];
+    assert(key.status->ok() || key.status->IsMergeInProgress());
+    get_contexts.emplace_back(
+        user_comparator(), merge_operator_, info_log_, db_statistics_,
+        key.status->ok() ? GetContext::kNotFound : GetContext::kMerge, key.lkey.user_key(),
+        key.value, nullptr /* value_found */, &key.merge_context, this->env_);
+    pending.push_back(i);
+  }
+
+  std::vector<bool> resolved(keys.size());
+  std::vector<TableMultiGetKey> batch;
+  std::vector<size_t> batch_indexes;
+  auto add_to_batch = [&](size_t index) {
+    batch.push_back(TableMultiGetKey{
+        keys[index]->lkey.internal_key(), &get_contexts[index], Status::OK()});
+    batch_indexes.push_back(index);
+  };
+  auto lookup_batch = [&](FdWithBoundaries* f, int level, bool is_file_last_in_level) {
+    if (batch.empty()) {
+      return;
+    }
+    table_cache_->MultiGet(
+        read_options, internal_comparator(), f->fd, batch.data(), batch.size(),
+        cfd_->internal_stats()->GetFileReadHist(level),
+        IsFilterSkipped(level, is_file_last_in_level));
+    for (size_t i = 0; i != batch.size(); ++i) {
+      const size_t index = batch_indexes[i];
+      auto& key = *keys[index];
+      if (!batch[i].status.ok()) {
+        *key.status = batch[i].status;
+        resolved[index] = true;
+        continue;
+      }
+      switch (get_contexts[index].State()) {
+        case GetContext::kNotFound: FALLTHROUGH_INTENDED;
+        case GetContext::kMerge:
+          // Keep searching in other files
+          break;
+        case GetContext::kFound:
+          if (level == 0) {
+            RecordTick(db_statistics_, GET_HIT_L0);
+          } else if (level == 1) {
+            RecordTick(db_statistics_, GET_HIT_L1);
+          } else {
+            RecordTick(db_statistics_, GET_HIT_L2_AND_UP);
+          }
+          *key.status = Status::OK();
+          resolved[index] = true;
+          break;
+        case GetContext::kDeleted:
+          // Use empty error message for speed
+          *key.status = STATUS(NotFound, "");
+          resolved[index] = true;
+          break;
+        case GetContext::kCorrupt:
+          *key.status = STATUS(Corruption, "corrupted key for ", key.lkey.user_key());
+          resolved[index] = true;
+          break;
+      }
+    }
+    batch.clear();
+    batch_indexes.clear();
+  };
+  auto remove_resolved = [&pending, &resolved] {
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [&resolved](size_t index) { return resolved[index]; }),
+                  pending.end());
+  };
+
+  const auto& ucmp = *user_comparator();
+  const auto num_levels = storage_info_.num_non_empty_levels_;
+  for (int level = 0; level < num_levels && !pending.empty(); ++level) {
+    auto& file_level = storage_info_.level_files_brief_[level];
+    if (level == 0) {
+      // Level 0 files could overlap, so each of them is checked for all pending keys, starting
+      // from the newest one.
+      for (size_t i = 0; i != file_level.num_files && !pending.empty(); ++i) {
+        auto* f = &file_level.files[i];
+        for (auto index : pending) {
+          const auto user_key = keys[index]->lkey.user_key();
+          if (ucmp.Compare(user_key, f->smallest.user_key()) >= 0 &&
+              ucmp.Compare(user_key, f->largest.user_key()) <= 0) {
+            add_to_batch(index);
+          }
+        }
+        lookup_batch(f, level, i + 1 == file_level.num_files);
+        remove_resolved();
+      }
+      continue;
+    }
+
+    // Files of other levels do not overlap, and keys are sorted, so keys that belong to the same
+    // file are adjacent.
+    size_t batch_file = file_level.num_files;
+    for (auto index : pending) {
+      const auto& lkey = keys[index]->lkey;
+      size_t file_index = FindFile(*internal_comparator(), file_level, lkey.internal_key());
+      if (file_index < file_level.num_files &&
+          ucmp.Compare(lkey.user_key(), file_level.files[file_index].smallest.user_key()) < 0) {
+        file_index = file_level.num_files;
+      }
+      if (file_index != batch_file) {
+        if (batch_file != file_level.num_files) {
+          lookup_batch(&file_level.files[batch_file], level,
+                       batch_file + 1 == file_level.num_files);
+        }
+        batch_file = file_index;
+      }
+      if (file_index != file_level.num_files) {
+        add_to_batch(index);
+      }
+    }
+    if (batch_file != file_level.num_files) {
+      lookup_batch(&file_level.files[batch_file], level, batch_file + 1 == file_level.num_files);
+    }
+    remove_resolved();
+  }
+
+  for (auto index : pending) {
+    auto& key = *keys[index];
+    if (GetContext::kMerge != get_contexts[index].State()) {
+      *key.status = STATUS(NotFound, ""); // Use an empty error message for speed
+      continue;
+    }
+    if (!merge_operator_) {
+      *key.status = STATUS(InvalidArgument, "merge_operator is not properly initialized.");
+      continue;
+    }
+    // merge_operands are in saver and we hit the beginning of the key history
+    // do a final merge of nullptr and operands;
+    if (merge_operator_->FullMerge(key.lkey.user_key(), nullptr,
+                                   key.merge_context.GetOperands(), key.value, info_log_)) {
+      *key.status = Status::OK();
+    } else {
+      RecordTick(db_statistics_, NUMBER_MERGE_FAILURES);
+      *key.status = STATUS(Corruption, "could not perform end-of-key merge for ",
+                           key.lkey.user_key());
+    }
+  }
+}
+
 bool Version::IsFilterSkipped(int level, bool is_file_last_in_level) {
   // Reaching the bottom level implies misses at all upper levels, so we'll
   // skip checking the filters when we predict a hit.
@@ -2080,7 +2228,8 @@ VersionSet::VersionSet(const std::string& dbname, const DBOptions* db_options,
       dbname_(dbname),
       db_options_(db_options),
       env_options_(storage_options),
-      env_options_compactions_(env_options_) {}
+      env_options_compactions_(
+          db_options->env->OptimizeForCompactionTableRead(env_options_, *db_options)) {}
 
 VersionSet::~VersionSet() {
   // we need to delete column_family_set_ because its destructor depends on
@@ -2847,7 +2996,11 @@ Status VersionSet::Import(const std::string& source_dir,
                              seqno);
       }
       files.push_back(filemeta);
-      segments.emplace_back(filemeta.smallest.seqno, filemeta.largest.seqno);
+      // Files added with DB::AddFile have all their keys at sequence number 0. Their key ranges
+      // do not overlap, so they could not conflict with each other.
+      if (filemeta.largest.seqno != 0) {
+        segments.emplace_back(filemeta.smallest.seqno, filemeta.largest.seqno);
+      }
     }
   }
   if (!status.IsEndOfFile()) {
@@ -2867,8 +3020,8 @@ Status VersionSet::Import(const std::string& source_dir,
   std::sort(segments.begin(), segments.end(), [](const auto& lhs, const auto& rhs) {
     return lhs.first < rhs.first;
   });
-  auto prev = segments.front();
-  for (size_t i = 1; i != segments.size(); ++i) {
+  for (size_t i = 1; i < segments.size(); ++i) {
+    const auto& prev = segments[i - 1];
     const auto& segment = segments[i];
     if (segment.first <= prev.second) {
       return STATUS_FORMAT(Corruption,
@@ -2878,7 +3031,6 @@ Status VersionSet::Import(const std::string& source_dir,
                            segment.first,
                            segment.second);
     }
-    prev = segment;
   }
 
   std::vector<std::string> revert_list;
@@ -3543,7 +3695,7 @@ InternalIterator* VersionSet::MakeInputIterator(Compaction* c) {
         // Create concatenating iterator for the files from this level
         list[num++] = NewTwoLevelIterator(
             new LevelFileIteratorState(
-                cfd->table_cache(), read_options, env_options_,
+                cfd->table_cache(), read_options, env_options_compactions_,
                 cfd->internal_comparator(),
                 nullptr /* no per level latency histogram */,
                 true /* for_compaction */, false /* prefix enabled */,
@@ -47,6 +47,7 @@
 #include <vector>
 
 #include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/merge_context.h"
 #include "yb/rocksdb/db/version_builder.h"
 #include "yb/rocksdb/db/version_edit.h"
 #include "yb/rocksdb/port/port.h"
@@ -435,6 +436,23 @@ class VersionStorageInfo {
   void operator=(const VersionStorageInfo&) = delete;
 };
 
+// Key looked up by Version::MultiGet.
+struct MultiGetKeyContext {
+  MultiGetKeyContext(const Slice& user_key, SequenceNumber snapshot, std::string* value_,
+                     Status* status_)
+      : lkey(user_key, snapshot), value(value_), status(status_) {}
+
+  MultiGetKeyContext(const MultiGetKeyContext&) = delete;
+  void operator=(const MultiGetKeyContext&) = delete;
+
+  LookupKey lkey;
+  std::string* value;
+  // Should be OK or MergeInProgress before the lookup, in the latter case merge_context contains
+  // operands found in memtables.
+  Status* status;
+  MergeContext merge_context;
+};
+
 class Version {
  public:
   // Append to *iters a sequence of iterators that will
@@ -464,6 +482,13 @@ class Version {
            bool* value_found = nullptr, bool* key_exists = nullptr,
            SequenceNumber* seq = nullptr);
 
+  // Looks up multiple keys with the same semantics as Get for each of them. Each table file is
+  // visited once for all keys that could be stored in it.
+  // Keys should be sorted by user key.
+  //
+  // REQUIRES: lock is not held
+  void MultiGet(const ReadOptions& read_options, const std::vector<MultiGetKeyContext*>& keys);
+
   // Loads some stats information from files. Call without mutex held. It needs
   // to be called before applying the version to the version set.
   void PrepareApply(const MutableCFOptions& mutable_cf_options,
@@ -811,8 +836,8 @@ class VersionSet {
   // env options for all reads and writes except compactions
   const EnvOptions& env_options_;
 
-  // env options used for compactions. This is a copy of
-  // env_options_ but with readaheads set to readahead_compactions_.
+  // env options used for compaction inputs. This is a copy of
+  // env_options_ but with direct reads when use_direct_io_for_flush_and_compaction is set.
   const EnvOptions env_options_compactions_;
 
   // No copying allowed
@@ -108,6 +108,13 @@ struct EnvOptions {
   // If false, fallocate() calls are bypassed
   bool allow_fallocate = true;
 
+  // If true, then open files for reading with O_DIRECT, bypassing the OS page cache.
+  bool use_direct_reads = false;
+
+  // If true, then open files for writing with O_DIRECT, bypassing the OS page cache.
+  // Data is written from aligned buffers, see WritableFile::UseOSBuffer.
+  bool use_direct_writes = false;
+
   // If true, set the FD_CLOEXEC on open fd.
   bool set_fd_cloexec = true;
 
@@ -136,6 +143,10 @@ struct EnvOptions {
 
   // If not nullptr, write rate limiting is enabled for flush and compaction
   RateLimiter* rate_limiter = nullptr;
+
+  // If true, WritableFileWriter writes its buffer in background, on the asynchronous I/O thread
+  // pool, while the next buffer is filled. Only used with OS buffered I/O.
+  bool async_writes = false;
 };
 
 // RocksDBFileFactory is the implementation of all NewxxxFile Env methods as well as any methods
@@ -457,6 +468,15 @@ class Env {
   // files. Default implementation returns the copy of the same object.
   virtual EnvOptions OptimizeForManifestWrite(const EnvOptions& env_options)
       const;
+  // OptimizeForCompactionTableWrite will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for writing table files by flush and
+  // compaction.
+  virtual EnvOptions OptimizeForCompactionTableWrite(const EnvOptions& env_options,
+                                                     const DBOptions& db_options) const;
+  // OptimizeForCompactionTableRead will create a new EnvOptions object that is a copy of the
+  // EnvOptions in the parameters, but is optimized for reading table files by compaction.
+  virtual EnvOptions OptimizeForCompactionTableRead(const EnvOptions& env_options,
+                                                    const DBOptions& db_options) const;
 
   // Returns the status of all threads that belong to the current Env.
   virtual Status GetThreadList(std::vector<ThreadStatus>* thread_list) {
@@ -564,6 +584,13 @@ class RandomAccessFile : public File {
 
   virtual void Hint(AccessPattern pattern) {}
 
+  // Asks the system to start reading n bytes at offset in background, so the following reads
+  // of this range do not wait for the storage. Does not block and does not return the data.
+  // If the system does not support it, then this is a noop.
+  virtual Status Prefetch(uint64_t offset, size_t n) {
+    return Status::OK();
+  }
+
   // Remove any kind of caching of data from the offset to offset+length
   // of this file. If the length is 0, then it refers to the end of file.
   // If the system is not caching the file contents, then this is a noop.
@@ -1095,6 +1122,10 @@ class RandomAccessFileWrapper : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { return target_->Hint(pattern); }
 
+  Status Prefetch(uint64_t offset, size_t n) override {
+    return target_->Prefetch(offset, n);
+  }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return target_->InvalidateCache(offset, length);
   }
@@ -1132,6 +1163,11 @@ class WritableFileWrapper : public WritableFile {
     return target_->PositionedAppend(data, offset);
   }
   Status Truncate(uint64_t size) override { return target_->Truncate(size); }
+  bool UseOSBuffer() const override { return target_->UseOSBuffer(); }
+  bool UseDirectIO() const override { return target_->UseDirectIO(); }
+  size_t GetRequiredBufferAlignment() const override {
+    return target_->GetRequiredBufferAlignment();
+  }
   Status Close() override { return target_->Close(); }
   Status Flush() override { return target_->Flush(); }
   Status Sync() override { return target_->Sync(); }
@@ -59,6 +59,12 @@ struct ImmutableCFOptions {
 
   CompactionFilterFactory* compaction_filter_factory;
 
+  ExpiredFileFilter* expired_file_filter;
+
+  CompactionTimeWindows* compaction_time_windows;
+
+  const MemTableFilterOptions* memtable_filter;
+
   bool inplace_update_support;
 
   UpdateStatus (*inplace_callback)(char* existing_value,
@@ -111,6 +117,14 @@ struct ImmutableCFOptions {
 
   CompressionOptions compression_opts;
 
+  CompressionType flush_compression;
+
+  CompressionOptions flush_compression_opts;
+
+  CompressionType bottommost_compression;
+
+  CompressionOptions bottommost_compression_opts;
+
   bool level_compaction_dynamic_level_bytes;
 
   Options::AccessHint access_hint_on_compaction_start;
@@ -70,6 +70,12 @@ enum class CompactionReason {
   kUniversalSortedRunNum,
   // [FIFO] total size > max_table_files_size
   kFIFOMaxSize,
+  // [Universal] oldest files contain only expired data
+  kUniversalExpiredFiles,
+  // [Universal] file contains a large share of expired data
+  kUniversalExpiredBytes,
+  // [Universal] file contains many versions overwritten before the history cutoff
+  kUniversalObsoleteVersions,
   // Manual compaction
   kManualCompaction,
   // DB::SuggestCompactRange() marked files for compaction
@@ -22,11 +22,17 @@
 namespace rocksdb {
 
 // Counts the total memory of the registered write_buffers, and notifies the
-// callback if the limit is exceeded.
+// callback if the limit is exceeded. When a soft limit is set, the callback is
+// notified once the memory usage reaches it, so memory could be freed before
+// the limit is hit.
 class MemoryMonitor {
  public:
   explicit MemoryMonitor(size_t limit, std::function<void()> exceeded_callback)
-    : limit_(limit), exceeded_callback_(std::move(exceeded_callback)) {}
+    : MemoryMonitor(limit, 0 /* soft_limit */, std::move(exceeded_callback)) {}
+
+  MemoryMonitor(size_t limit, size_t soft_limit, std::function<void()> exceeded_callback)
+    : limit_(limit), soft_limit_(soft_limit),
+      exceeded_callback_(std::move(exceeded_callback)) {}
 
   ~MemoryMonitor() {}
 
@@ -36,13 +42,19 @@ class MemoryMonitor {
 
   size_t limit() const { return limit_; }
 
+  size_t soft_limit() const { return soft_limit_; }
+
   bool Exceeded() const {
     return Exceeded(memory_usage());
   }
 
+  bool SoftLimitExceeded() const {
+    return SoftLimitExceeded(memory_usage());
+  }
+
   void ReservedMem(size_t mem) {
     auto new_value = memory_used_.fetch_add(mem, std::memory_order_release) + mem;
-    if (UNLIKELY(Exceeded(new_value))) {
+    if (UNLIKELY(Exceeded(new_value) || SoftLimitExceeded(new_value))) {
       exceeded_callback_();
     }
   }
@@ -61,7 +73,12 @@ class MemoryMonitor {
     return limit() > 0 && size >= limit();
   }
 
+  bool SoftLimitExceeded(size_t size) const {
+    return soft_limit() > 0 && size >= soft_limit();
+  }
+
   const size_t limit_;
+  const size_t soft_limit_;
   const std::function<void()> exceeded_callback_;
   std::atomic<size_t> memory_used_ {0};
 
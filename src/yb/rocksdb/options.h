@@ -45,6 +45,7 @@
 namespace yb {
 
 class MemTracker;
+class PriorityThreadPool;
 
 }
 
@@ -54,6 +55,8 @@ class BoundaryValuesExtractor;
 class Cache;
 class CompactionFilter;
 class CompactionFilterFactory;
+class CompactionTimeWindows;
+class ExpiredFileFilter;
 class Comparator;
 class Env;
 enum InfoLogLevel : unsigned char;
@@ -88,8 +91,13 @@ enum CompressionType : char {
   kBZip2Compression = 0x3,
   kLZ4Compression = 0x4,
   kLZ4HCCompression = 0x5,
-  // zstd format is not finalized yet so it's subject to changes.
+  kZSTD = 0x7,
+  // Files written by older versions with the experimental zstd support. Blocks of this type are
+  // still readable, but kZSTD should be used for new files.
   kZSTDNotFinalCompression = 0x40,
+  // Not a real compression type. Used as a value of the flush and bottommost compression options
+  // to specify that the general compression setting should be used instead.
+  kDisableCompressionOption = static_cast<char>(0xff),
 };
 
 enum CompactionStyle : char {
@@ -163,9 +171,25 @@ struct CompressionOptions {
   int window_bits;
   int level;
   int strategy;
-  CompressionOptions() : window_bits(-14), level(-1), strategy(0) {}
-  CompressionOptions(int wbits, int _lev, int _strategy)
-      : window_bits(wbits), level(_lev), strategy(_strategy) {}
+
+  // Maximum size of the dictionary used to prime the compression library for data blocks of an
+  // SST file. The dictionary is built separately for each file from its first data blocks and is
+  // stored in a meta block of that file. Currently only supported by kZSTD.
+  // 0 means that dictionary compression is disabled.
+  uint32_t max_dict_bytes;
+
+  // Amount of data blocks to buffer per SST file to build the dictionary. When it is non-zero,
+  // the dictionary of max_dict_bytes is trained from the buffered blocks by the zstd dictionary
+  // trainer. Otherwise the first max_dict_bytes of buffered data are used as a raw dictionary.
+  // It is recommended to use about 100x of max_dict_bytes.
+  uint32_t zstd_max_train_bytes;
+
+  CompressionOptions()
+      : window_bits(-14), level(-1), strategy(0), max_dict_bytes(0), zstd_max_train_bytes(0) {}
+  CompressionOptions(int wbits, int _lev, int _strategy, uint32_t _max_dict_bytes = 0,
+                     uint32_t _zstd_max_train_bytes = 0)
+      : window_bits(wbits), level(_lev), strategy(_strategy), max_dict_bytes(_max_dict_bytes),
+        zstd_max_train_bytes(_zstd_max_train_bytes) {}
 };
 
 enum UpdateStatus {    // Return status For inplace update callback
@@ -174,6 +198,20 @@ enum UpdateStatus {    // Return status For inplace update callback
   UPDATED         = 2, // No inplace update. Merged value set
 };
 
+// Options of the memtable key filter - a bloom filter of the keys added to the memtable, built
+// with the key transformer of the filter policy. Allows point reads to skip memtables that do not
+// contain the key, like the SST file bloom filters do.
+struct MemTableFilterOptions {
+  // Filter policy that provides the key transformer, should be the same as used for SST files.
+  std::shared_ptr<const FilterPolicy> filter_policy;
+
+  // Number of bits of the filter, the filter is disabled when 0.
+  uint32_t num_bits = 0;
+
+  // Number of hash probes per key.
+  uint32_t num_probes = 6;
+};
+
 struct DbPath {
   std::string path;
   uint64_t target_size;  // Target size of total files under the path, in byte.
@@ -265,6 +303,23 @@ struct ColumnFamilyOptions {
   // Default: nullptr
   std::shared_ptr<CompactionFilterFactory> compaction_filter_factory;
 
+  // Allows universal compaction to delete the oldest SST files that contain only expired data,
+  // without compacting them.
+  //
+  // Default: nullptr
+  std::shared_ptr<ExpiredFileFilter> expired_file_filter;
+
+  // If set, universal compaction only compacts together adjacent SST files of the same time window.
+  //
+  // Default: nullptr
+  std::shared_ptr<CompactionTimeWindows> compaction_time_windows;
+
+  // If set, memtables maintain a bloom filter of the added keys, that is checked by point reads
+  // using table_aware_file_filter.
+  //
+  // Default: nullptr
+  std::shared_ptr<const MemTableFilterOptions> memtable_filter;
+
   // -------------------
   // Parameters that affect performance
 
@@ -376,6 +431,29 @@ struct ColumnFamilyOptions {
   // different options for compression algorithms
   CompressionOptions compression_opts;
 
+  // Compression algorithm for files produced by memtable flushes. Flushed data is usually rewritten
+  // soon by compactions, so a fast algorithm could be preferred here.
+  // kDisableCompressionOption means that the algorithm is chosen in the same way as for other
+  // files, i.e. by compression and compression_per_level.
+  //
+  // Default: kDisableCompressionOption
+  CompressionType flush_compression;
+
+  // Compression options used with flush_compression, when it is set.
+  CompressionOptions flush_compression_opts;
+
+  // Compression algorithm for the output of compactions into the bottommost level. For universal
+  // compaction that is the output of compactions that include the oldest file, i.e. the largest
+  // files of the DB, where a stronger compression pays off the most.
+  // kDisableCompressionOption means that the algorithm is chosen in the same way as for other
+  // files.
+  //
+  // Default: kDisableCompressionOption
+  CompressionType bottommost_compression;
+
+  // Compression options used with bottommost_compression, when it is set.
+  CompressionOptions bottommost_compression_opts;
+
   // If non-nullptr, use the specified function to determine the
   // prefixes for keys.  These prefixes will be placed in the filter.
   // Depending on the workload, this can reduce the number of read-IOP
@@ -759,6 +837,14 @@ struct ColumnFamilyOptions {
   // Dynamically changeable through SetOptions() API
   size_t memtable_prefix_bloom_huge_page_tlb_size;
 
+  // Page size for huge pages backing the memtable arena. If 0, arena blocks are allocated with
+  // malloc. Otherwise arena blocks are rounded up to a multiple of it, and allocated from the
+  // reserved huge page pool (MAP_HUGETLB) when possible, or else from memory aligned to it and
+  // advised for transparent huge pages (MADV_HUGEPAGE).
+  //
+  // Dynamically changeable through SetOptions() API
+  size_t memtable_huge_page_size;
+
   // Control locality of bloom filter probes to improve cache miss rate.
   // This option only applies to memtable prefix bloom and plaintable
   // prefix bloom. It essentially limits every bloom checking to one cache line.
@@ -1100,6 +1186,16 @@ struct DBOptions {
   // If false, fallocate() calls are bypassed
   bool allow_fallocate;
 
+  // Use O_DIRECT for reading table files by user queries, bypassing the OS page cache.
+  // Default: false
+  bool use_direct_reads;
+
+  // Use O_DIRECT for reading compaction inputs and for writing flush and compaction outputs.
+  // Foreground reads are not affected, see use_direct_reads. Setting it forces
+  // new_table_reader_for_compaction_inputs to true, so compaction gets its own file descriptors.
+  // Default: false
+  bool use_direct_io_for_flush_and_compaction;
+
   // Disable child process inherit open files. Default: true
   bool is_fd_close_on_exec;
 
@@ -1337,6 +1433,14 @@ struct DBOptions {
 
   // Specific mem tracker for block based tables created by this RocksDB instance.
   std::shared_ptr<yb::MemTracker> block_based_table_mem_tracker;
+
+  // Thread pool shared by multiple RocksDB instances, that should be used for automatic
+  // compactions instead of the LOW priority thread pool of env. It runs compactions of all
+  // instances in the order of their priority, and could pause a running large compaction in favor
+  // of a compaction with higher priority. max_background_compactions is still applied to each
+  // instance.
+  // Default: nullptr
+  yb::PriorityThreadPool* priority_thread_pool_for_compactions = nullptr;
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -1393,6 +1497,9 @@ class TableAwareReadFileFilter {
  public:
   virtual bool Filter(TableReader*) const = 0;
 
+  // Whether the memtable could contain keys matching the read, the memtable is skipped otherwise.
+  virtual bool FilterMemTable(const MemTable&) const { return true; }
+
  protected:
   virtual ~TableAwareReadFileFilter() {}
 };
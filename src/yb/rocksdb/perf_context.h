@@ -106,6 +106,12 @@ struct PerfContext {
   uint64_t bloom_sst_hit_count;
   // total number of SST table bloom misses
   uint64_t bloom_sst_miss_count;
+  // total number of DB iterator Next() calls
+  uint64_t iter_next_count;
+  // total number of DB iterator Prev() calls
+  uint64_t iter_prev_count;
+  // total number of DB iterator seeks, including SeekToFirst() and SeekToLast()
+  uint64_t iter_seek_count;
 };
 
 #if defined(NPERF_CONTEXT) || defined(IOS_CROSS_COMPILE)
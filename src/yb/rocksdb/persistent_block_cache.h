@@ -0,0 +1,108 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+// A PersistentBlockCache is a second cache tier for uncompressed blocks, kept in files on a local
+// device. It is meant to sit behind the in-memory block cache when table files live on slow or
+// remote storage: blocks evicted from the in-memory cache are written to it, and a block cache miss
+// is served from it before falling back to the table file.
+//
+// The builtin implementation is log structured. Blocks are appended to fixed size segment files
+// and located through an in-memory index. When the cache is full, the oldest segment is dropped
+// together with all blocks it contains. Blocks are written by a background thread, so inserting a
+// block evicted from the in-memory cache never waits for the device. The index is not persisted, so
+// the content of the cache does not survive a restart.
+
+#ifndef YB_ROCKSDB_PERSISTENT_BLOCK_CACHE_H
+#define YB_ROCKSDB_PERSISTENT_BLOCK_CACHE_H
+
+#include <memory>
+#include <string>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/rocksdb/status.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class MemTracker;
+class MetricEntity;
+
+} // namespace yb
+
+namespace rocksdb {
+
+using namespace yb::size_literals;
+
+class Env;
+
+struct PersistentBlockCacheOptions {
+  // Env used to access the cache files.
+  Env* env = nullptr;
+
+  // Directory for the cache files. It is created if missing, and cache files left there by a
+  // previous process are removed.
+  std::string path;
+
+  // Maximum disk space used by the cache files.
+  size_t capacity = 0;
+
+  // Size of a single cache file. Space is reclaimed one file at a time, so it should be a small
+  // fraction of the capacity. Blocks larger than a file are never cached.
+  size_t segment_size = 64_MB;
+
+  // Maximum total size of the blocks waiting for the background writer. Blocks inserted while the
+  // writer is that far behind are dropped.
+  size_t max_pending_write_bytes = 16_MB;
+
+  // If set, memory used by the in-memory index is accounted to a child of this tracker.
+  std::shared_ptr<yb::MemTracker> mem_tracker;
+};
+
+class PersistentBlockCache {
+ public:
+  PersistentBlockCache() {}
+  virtual ~PersistentBlockCache() {}
+
+  // Queues a copy of data to be stored under key, it can be looked up right away. Does nothing if
+  // key is already cached. Returns Busy and drops the block if too much data is waiting to be
+  // written.
+  virtual Status Insert(const Slice& key, const Slice& data) = 0;
+
+  // Looks up key. Returns NotFound if it is not cached, otherwise fills *data and *size with a copy
+  // of the cached block.
+  virtual Status Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) = 0;
+
+  // Returns the maximum disk space used by the cache.
+  virtual size_t GetCapacity() const = 0;
+
+  // Returns the disk space currently used by the cache.
+  virtual size_t GetUsage() const = 0;
+
+  virtual void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) = 0;
+
+  // Waits until all queued blocks are written or failed.
+  virtual void TEST_WaitForPendingWrites() = 0;
+
+ private:
+  // No copying allowed
+  PersistentBlockCache(const PersistentBlockCache&);
+  void operator=(const PersistentBlockCache&);
+};
+
+// Creates a log structured persistent block cache, see the comment at the top of this file.
+extern Status NewPersistentBlockCache(const PersistentBlockCacheOptions& options,
+                                      std::shared_ptr<PersistentBlockCache>* cache);
+
+}  // namespace rocksdb
+
+#endif  // YB_ROCKSDB_PERSISTENT_BLOCK_CACHE_H
@@ -21,6 +21,7 @@
 #ifndef ROCKSDB_INCLUDE_ROCKSDB_SST_FILE_WRITER_H
 #define ROCKSDB_INCLUDE_ROCKSDB_SST_FILE_WRITER_H
 
+#include <memory>
 #include <string>
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/immutable_options.h"
@@ -29,6 +30,7 @@
 namespace rocksdb {
 
 class Comparator;
+class UserFrontiers;
 
 // Table Properties that are specific to tables created by SstFileWriter.
 struct ExternalSstFilePropertyNames {
@@ -65,6 +67,9 @@ struct ExternalSstFileInfo {
   bool is_split_sst;               // is SST split into metadata and data file(s)
   uint64_t num_entries;            // number of entries in file
   int32_t version;                 // file version
+  // Optional frontiers of the data in the file. If set, they are stored in the file metadata by
+  // DB::AddFile and the flushed frontier of the DB is updated with the largest one.
+  std::shared_ptr<const UserFrontiers> frontiers;
 };
 
 // SstFileWriter is used to create sst files that can be added to database later
@@ -47,6 +47,7 @@ namespace rocksdb {
 
 // -- Block-based Table
 class FlushBlockPolicyFactory;
+class PersistentBlockCache;
 class RandomAccessFile;
 struct TableReaderOptions;
 struct TableBuilderOptions;
@@ -79,6 +80,19 @@ YB_DEFINE_ENUM(IndexType,
   (kMultiLevelBinarySearch)
 );
 
+YB_DEFINE_ENUM(KeyValueEncodingFormat,
+  // Each key is stored as the number of bytes shared with the previous key of the block followed by
+  // the rest of the key.
+  (kKeyDeltaEncodingSharedPrefix)
+
+  // In addition to the shared prefix, a key could reuse a run of bytes located at the same position
+  // in the previous key, and the internal key suffix (sequence number and value type) is stored as
+  // a delta from the suffix of the previous key. For DocDB it means that the DocKey is shared by
+  // prefix, while the DocHybridTime of the next column of the same row is shared by the middle
+  // part. Applicable only to blocks of internal keys, i.e. data blocks.
+  (kKeyDeltaEncodingThreeSharedParts)
+);
+
 // For advanced user only
 struct BlockBasedTableOptions {
   // @flush_block_policy_factory creates the instances of flush block policy.
@@ -97,6 +111,11 @@ struct BlockBasedTableOptions {
   // Note: Fixed-size bloom filter data blocks are never pre-loaded.
   bool cache_index_and_filter_blocks = false;
 
+  // If cache_index_and_filter_blocks is true and this is true, index and filter blocks are added
+  // directly to the multi-touch part of the block cache, so they are not evicted by data blocks
+  // that were accessed once, for instance by a scan.
+  bool cache_index_and_filter_blocks_with_high_priority = false;
+
   IndexType index_type = IndexType::kMultiLevelBinarySearch;
 
   // Influence the behavior when kHashSearch is used.
@@ -123,6 +142,16 @@ struct BlockBasedTableOptions {
   // If NULL, rocksdb will not use a compressed block cache.
   std::shared_ptr<Cache> block_cache_compressed = nullptr;
 
+  // If non-NULL, memory of blocks read for block_cache_compressed is tracked by this tracker
+  // instead of the memory tracker of the table.
+  std::shared_ptr<yb::MemTracker> block_cache_compressed_mem_tracker = nullptr;
+
+  // If non-NULL, uncompressed blocks evicted from block_cache are written to this cache, and it is
+  // consulted on block cache misses before reading the table file.
+  // NOTE: the block cache only spills to the persistent block cache of the latest table factory
+  // created with it.
+  std::shared_ptr<PersistentBlockCache> persistent_block_cache = nullptr;
+
   // Approximate size of user data packed per block, in bytes. Note that the
   // block size specified here corresponds to uncompressed data.  The
   // actual size of the unit read from disk may be smaller if
@@ -163,6 +192,13 @@ struct BlockBasedTableOptions {
   // Default: true
   bool use_delta_encoding = true;
 
+  // Encoding of keys in data blocks. Has effect only when use_delta_encoding is true.
+  // Tables written with kKeyDeltaEncodingThreeSharedParts could not be read by older versions.
+  //
+  // Default: kKeyDeltaEncodingSharedPrefix
+  KeyValueEncodingFormat data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
+
   // If non-nullptr, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
@@ -70,6 +70,40 @@ static inline const char* DecodeEntry(const char* p, const char* limit,
   return p;
 }
 
+struct ThreeSharedPartsEntry {
+  uint32_t shared_prefix;
+  uint32_t non_shared_1;
+  uint32_t flags;
+  uint32_t shared_middle;
+  uint32_t non_shared_2;
+  uint32_t value_length;
+};
+
+// Decodes header of the block entry encoded using kKeyDeltaEncodingThreeSharedParts.
+// Returns pointer to the key delta or nullptr in case of error.
+static inline const char* DecodeThreeSharedPartsEntry(const char* p, const char* limit,
+                                                      ThreeSharedPartsEntry* entry) {
+  uint32_t non_shared_1_and_flags;
+  if ((p = GetVarint32Ptr(p, limit, &entry->shared_prefix)) == nullptr) return nullptr;
+  if ((p = GetVarint32Ptr(p, limit, &non_shared_1_and_flags)) == nullptr) return nullptr;
+  entry->non_shared_1 = non_shared_1_and_flags >> kThreeSharedPartsNumFlags;
+  entry->flags = non_shared_1_and_flags & ((1u << kThreeSharedPartsNumFlags) - 1);
+  if (entry->flags & kThreeSharedPartsHasSharedMiddle) {
+    if ((p = GetVarint32Ptr(p, limit, &entry->shared_middle)) == nullptr) return nullptr;
+    if ((p = GetVarint32Ptr(p, limit, &entry->non_shared_2)) == nullptr) return nullptr;
+  } else {
+    entry->shared_middle = 0;
+    entry->non_shared_2 = 0;
+  }
+  if ((p = GetVarint32Ptr(p, limit, &entry->value_length)) == nullptr) return nullptr;
+
+  if (static_cast<uint64_t>(limit - p) <
+          static_cast<uint64_t>(entry->non_shared_1) + entry->non_shared_2 + entry->value_length) {
+    return nullptr;
+  }
+  return p;
+}
+
 void BlockIter::Next() {
   assert(Valid());
   ParseNextKey();
@@ -98,7 +132,8 @@ void BlockIter::Prev() {
 
 void BlockIter::Initialize(const Comparator* comparator, const char* data,
                            uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-                           BlockPrefixIndex* prefix_index) {
+                           BlockPrefixIndex* prefix_index,
+                           KeyValueEncodingFormat key_value_encoding_format) {
   DCHECK(data_ == nullptr); // Ensure it is called only once
   DCHECK_GT(num_restarts, 0); // Ensure the param is valid
 
@@ -110,6 +145,7 @@ void BlockIter::Initialize(const Comparator* comparator, const char* data,
   restart_index_ = num_restarts_;
   hash_index_ = hash_index;
   prefix_index_ = prefix_index;
+  key_value_encoding_format_ = key_value_encoding_format;
 }
 
 
@@ -177,6 +213,10 @@ bool BlockIter::ParseNextKey() {
     return false;
   }
 
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    return ParseNextThreeSharedPartsKey(p, limit);
+  }
+
   // Decode next entry
   uint32_t shared, non_shared, value_length;
   p = DecodeEntry(p, limit, &shared, &non_shared, &value_length);
@@ -193,12 +233,95 @@ bool BlockIter::ParseNextKey() {
       key_.TrimAppend(shared, p, non_shared);
     }
     value_ = Slice(p + non_shared, value_length);
-    while (restart_index_ + 1 < num_restarts_ &&
-           GetRestartPoint(restart_index_ + 1) < current_) {
-      ++restart_index_;
+    UpdateRestartIndex();
+    return true;
+  }
+}
+
+bool BlockIter::ParseNextThreeSharedPartsKey(const char* p, const char* limit) {
+  ThreeSharedPartsEntry entry;
+  p = DecodeThreeSharedPartsEntry(p, limit, &entry);
+  if (p == nullptr) {
+    CorruptionError();
+    return false;
+  }
+
+  if (entry.shared_prefix == 0 && entry.flags == 0) {
+    // Whole key is stored in the block, so we could use it directly.
+    key_.SetKey(Slice(p, entry.non_shared_1), false /* copy */);
+    value_ = Slice(p + entry.non_shared_1, entry.value_length);
+    UpdateRestartIndex();
+    return true;
+  }
+
+  const Slice last_key = key_.GetKey();
+  size_t last_key_size = last_key.size();
+  uint64_t suffix = 0;
+  if (entry.flags & kThreeSharedPartsHasSuffixDelta) {
+    if (last_key_size < kThreeSharedPartsSuffixSize) {
+      CorruptionError();
+      return false;
+    }
+    last_key_size -= kThreeSharedPartsSuffixSize;
+    suffix = DecodeFixed64(last_key.cdata() + last_key_size);
+  }
+  const size_t middle_start = static_cast<size_t>(entry.shared_prefix) + entry.non_shared_1;
+  if (entry.shared_prefix > last_key_size ||
+      (entry.shared_middle != 0 && middle_start + entry.shared_middle > last_key_size)) {
+    CorruptionError();
+    return false;
+  }
+
+  const char* key_delta = p;
+  p += entry.non_shared_1 + entry.non_shared_2;
+  if (entry.flags & kThreeSharedPartsHasSuffixDelta) {
+    uint64_t suffix_delta;
+    if ((p = GetVarint64Ptr(p, limit, &suffix_delta)) == nullptr ||
+        static_cast<uint32_t>(limit - p) < entry.value_length) {
+      CorruptionError();
+      return false;
     }
+    suffix += static_cast<uint64_t>(ZigZagDecode64(suffix_delta));
+  }
+
+  key_buffer_.assign(last_key.cdata(), entry.shared_prefix);
+  key_buffer_.append(key_delta, entry.non_shared_1);
+  key_buffer_.append(last_key.cdata() + middle_start, entry.shared_middle);
+  key_buffer_.append(key_delta + entry.non_shared_1, entry.non_shared_2);
+  if (entry.flags & kThreeSharedPartsHasSuffixDelta) {
+    PutFixed64(&key_buffer_, suffix);
+  }
+  key_.SetKey(key_buffer_);
+  value_ = Slice(p, entry.value_length);
+  UpdateRestartIndex();
+  return true;
+}
+
+void BlockIter::UpdateRestartIndex() {
+  while (restart_index_ + 1 < num_restarts_ &&
+         GetRestartPoint(restart_index_ + 1) < current_) {
+    ++restart_index_;
+  }
+}
+
+bool BlockIter::DecodeRestartPointKey(uint32_t offset, Slice* key) {
+  const char* limit = data_ + restarts_;
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    ThreeSharedPartsEntry entry;
+    const char* key_ptr = DecodeThreeSharedPartsEntry(data_ + offset, limit, &entry);
+    if (key_ptr == nullptr || entry.shared_prefix != 0 || entry.flags != 0) {
+      return false;
+    }
+    *key = Slice(key_ptr, entry.non_shared_1);
     return true;
   }
+  uint32_t shared, non_shared, value_length;
+  const char* key_ptr = DecodeEntry(data_ + offset, limit, &shared, &non_shared, &value_length);
+  if (key_ptr == nullptr || shared != 0) {
+    return false;
+  }
+  *key = Slice(key_ptr, non_shared);
+  return true;
 }
 
 // Binary search in restart array to find the first restart point
@@ -210,15 +333,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
   while (left < right) {
     uint32_t mid = (left + right + 1) / 2;
     uint32_t region_offset = GetRestartPoint(mid);
-    uint32_t shared, non_shared, value_length;
-    const char* key_ptr =
-        DecodeEntry(data_ + region_offset, data_ + restarts_, &shared,
-                    &non_shared, &value_length);
-    if (key_ptr == nullptr || (shared != 0)) {
+    Slice mid_key;
+    if (!DecodeRestartPointKey(region_offset, &mid_key)) {
       CorruptionError();
       return false;
     }
-    Slice mid_key(key_ptr, non_shared);
     int cmp = Compare(mid_key, target);
     if (cmp < 0) {
       // Key at "mid" is smaller than "target". Therefore all
@@ -241,14 +360,11 @@ bool BlockIter::BinarySeek(const Slice& target, uint32_t left, uint32_t right,
 // Return -1 if error.
 int BlockIter::CompareBlockKey(uint32_t block_index, const Slice& target) {
   uint32_t region_offset = GetRestartPoint(block_index);
-  uint32_t shared, non_shared, value_length;
-  const char* key_ptr = DecodeEntry(data_ + region_offset, data_ + restarts_,
-                                    &shared, &non_shared, &value_length);
-  if (key_ptr == nullptr || (shared != 0)) {
+  Slice block_key;
+  if (!DecodeRestartPointKey(region_offset, &block_key)) {
     CorruptionError();
     return 1;  // Return target is smaller
   }
-  Slice block_key(key_ptr, non_shared);
   return Compare(block_key, target);
 }
 
@@ -334,7 +450,14 @@ bool BlockIter::PrefixSeek(const Slice& target, uint32_t* index) {
 
 uint32_t Block::NumRestarts() const {
   assert(size_ >= 2*sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & ~kThreeSharedPartsBlockFlag;
+}
+
+KeyValueEncodingFormat Block::key_value_encoding_format() const {
+  assert(size_ >= 2*sizeof(uint32_t));
+  return (DecodeFixed32(data_ + size_ - sizeof(uint32_t)) & kThreeSharedPartsBlockFlag)
+      ? KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts
+      : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix;
 }
 
 Block::Block(BlockContents&& contents)
@@ -378,12 +501,13 @@ InternalIterator* Block::NewIterator(const Comparator* cmp, BlockIter* iter,
     BlockPrefixIndex* prefix_index_ptr =
         total_order_seek ? nullptr : prefix_index_.get();
 
+    const auto key_value_encoding_format = this->key_value_encoding_format();
     if (iter != nullptr) {
       iter->Initialize(cmp, data_, restart_offset_, num_restarts,
-                    hash_index_ptr, prefix_index_ptr);
+                    hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     } else {
       iter = new BlockIter(cmp, data_, restart_offset_, num_restarts,
-                           hash_index_ptr, prefix_index_ptr);
+                           hash_index_ptr, prefix_index_ptr, key_value_encoding_format);
     }
   }
 
@@ -65,6 +65,7 @@ class Block {
     return size_;
   }
   uint32_t NumRestarts() const;
+  KeyValueEncodingFormat key_value_encoding_format() const;
   CompressionType compression_type() const {
     return contents_.compression_type;
   }
@@ -115,19 +116,24 @@ class BlockIter : public InternalIterator {
         restart_index_(0),
         status_(Status::OK()),
         hash_index_(nullptr),
-        prefix_index_(nullptr) {}
+        prefix_index_(nullptr),
+        key_value_encoding_format_(KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix) {}
 
   BlockIter(const Comparator* comparator, const char* data, uint32_t restarts,
        uint32_t num_restarts, BlockHashIndex* hash_index,
-       BlockPrefixIndex* prefix_index)
+       BlockPrefixIndex* prefix_index,
+       KeyValueEncodingFormat key_value_encoding_format =
+           KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix)
       : BlockIter() {
     Initialize(comparator, data, restarts, num_restarts,
-        hash_index, prefix_index);
+        hash_index, prefix_index, key_value_encoding_format);
   }
 
   void Initialize(const Comparator* comparator, const char* data,
       uint32_t restarts, uint32_t num_restarts, BlockHashIndex* hash_index,
-      BlockPrefixIndex* prefix_index);
+      BlockPrefixIndex* prefix_index,
+      KeyValueEncodingFormat key_value_encoding_format =
+          KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix);
 
   void SetStatus(Status s) {
     status_ = s;
@@ -180,6 +186,9 @@ class BlockIter : public InternalIterator {
   Status status_;
   BlockHashIndex* hash_index_;
   BlockPrefixIndex* prefix_index_;
+  KeyValueEncodingFormat key_value_encoding_format_;
+  // Used to restore keys encoded using kKeyDeltaEncodingThreeSharedParts.
+  std::string key_buffer_;
 
   inline int Compare(const Slice& a, const Slice& b) const {
     return comparator_->Compare(a, b);
@@ -210,6 +219,14 @@ class BlockIter : public InternalIterator {
 
   bool ParseNextKey();
 
+  bool ParseNextThreeSharedPartsKey(const char* p, const char* limit);
+
+  void UpdateRestartIndex();
+
+  // Decodes the key of the entry at the restart point with the specified offset.
+  // Returns false if the entry is corrupted.
+  bool DecodeRestartPointKey(uint32_t offset, Slice* key);
+
   bool BinarySeek(const Slice& target, uint32_t left, uint32_t right,
                   uint32_t* index);
 
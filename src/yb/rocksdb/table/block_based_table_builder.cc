@@ -110,6 +110,7 @@ bool GoodCompressionRatio(size_t compressed_size, size_t raw_size) {
 Slice CompressBlock(const Slice& raw,
                     const CompressionOptions& compression_options,
                     CompressionType* type, uint32_t format_version,
+                    const CompressionDict* compression_dict,
                     std::string* compressed_output) {
   if (*type == kNoCompression) {
     return raw;
@@ -161,9 +162,10 @@ Slice CompressBlock(const Slice& raw,
         return *compressed_output;
       }
       break;     // fall back to no compression.
+    case kZSTD:
     case kZSTDNotFinalCompression:
       if (ZSTD_Compress(compression_options, raw.cdata(), raw.size(),
-                        compressed_output) &&
+                        compressed_output, compression_dict) &&
           GoodCompressionRatio(compressed_output->size(), raw.size())) {
         return *compressed_output;
       }
@@ -299,6 +301,24 @@ struct BlockBasedTableBuilder::Rep {
   std::string compressed_output;
   std::unique_ptr<FlushBlockPolicy> flush_block_policy;
 
+  // Dictionary compression, see CompressionOptions::max_dict_bytes. In the buffered state data
+  // blocks are kept in memory together with their keys, until enough data is collected to build
+  // the dictionary. Index entries for them are added when they are written out.
+  enum class State {
+    kBuffered,
+    kUnbuffered,
+  };
+  struct BufferedDataBlock {
+    std::string contents;
+    std::vector<std::string> keys;
+  };
+  State state = State::kUnbuffered;
+  std::vector<BufferedDataBlock> buffered_data_blocks;
+  std::vector<std::string> current_block_keys;
+  size_t buffered_data_size = 0;
+  size_t buffer_limit = 0;
+  std::unique_ptr<CompressionDict> compression_dict;
+
   std::vector<std::unique_ptr<IntTblPropCollector>> table_properties_collectors;
 
   yb::MemTrackerPtr mem_tracker;
@@ -352,7 +372,8 @@ BlockBasedTableBuilder::Rep::Rep(
       filter_block_builder(skip_filters ? nullptr : CreateFilterBlockBuilder(
           _ioptions, table_options, filter_type)),
       data_block_builder(table_options.block_restart_interval,
-                 table_options.use_delta_encoding),
+                 table_options.use_delta_encoding,
+                 table_options.data_block_key_value_encoding_format),
       internal_prefix_transform(_ioptions.prefix_extractor),
       filter_key_transformer(table_opt.filter_policy ?
           table_opt.filter_policy->GetKeyTransformer() : nullptr),
@@ -376,6 +397,14 @@ BlockBasedTableBuilder::Rep::Rep(
         "BlockBasedTableBuilder", _ioptions.mem_tracker);
   }
 
+  // Block-based filter is built per data block at its offset, so it could not be used with
+  // buffered data blocks.
+  if (compression_type == kZSTD && ZSTD_Supported() && compression_opts.max_dict_bytes > 0 &&
+      filter_type != FilterType::kBlockBasedFilter) {
+    state = State::kBuffered;
+    buffer_limit = std::max(compression_opts.max_dict_bytes, compression_opts.zstd_max_train_bytes);
+  }
+
   metadata_writer = std::make_shared<FileWriterWithOffsetAndCachePrefix>();
   metadata_writer->writer = metadata_file;
   if (data_file != nullptr) {
@@ -475,7 +504,12 @@ void BlockBasedTableBuilder::Add(const Slice& key, const Slice& value) {
   r->props.raw_key_size += key.size();
   r->props.raw_value_size += value.size();
 
-  r->data_index_builder->OnKeyAdded(key);
+  if (r->state == Rep::State::kBuffered) {
+    // Index builder is notified when the block is written out.
+    r->current_block_keys.push_back(key.ToBuffer());
+  } else {
+    r->data_index_builder->OnKeyAdded(key);
+  }
 
   NotifyCollectTableCollectorsOnAdd(key, value, r->data_writer->offset,
       r->table_properties_collectors,
@@ -486,12 +520,85 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   Rep* const r = rep_;
   assert(!r->closed);
   if (!ok()) return;
-  size_t data_block_size = 0;
 
-  if (!r->data_block_builder.empty()) {
-    data_block_size = WriteBlock(&r->data_block_builder, &r->data_pending_handle,
-        r->data_writer.get());
+  if (r->state == Rep::State::kBuffered) {
+    BufferDataBlock(next_block_first_key);
+    return;
+  }
+
+  WriteDataBlock(r->data_block_builder.Finish(), &r->last_key, next_block_first_key);
+  r->data_block_builder.Reset();
+}
+
+void BlockBasedTableBuilder::BufferDataBlock(const Slice& next_block_first_key) {
+  Rep* const r = rep_;
+  r->buffered_data_blocks.emplace_back();
+  auto& block = r->buffered_data_blocks.back();
+  block.contents = r->data_block_builder.Finish().ToBuffer();
+  block.keys = std::move(r->current_block_keys);
+  r->current_block_keys.clear();
+  r->data_block_builder.Reset();
+  r->buffered_data_size += block.contents.size();
+
+  if (r->buffered_data_size >= r->buffer_limit) {
+    EnterUnbuffered(next_block_first_key);
   }
+}
+
+void BlockBasedTableBuilder::EnterUnbuffered(const Slice& next_block_first_key) {
+  Rep* const r = rep_;
+  DCHECK(r->state == Rep::State::kBuffered);
+  r->state = Rep::State::kUnbuffered;
+
+  std::string samples;
+  std::vector<size_t> sample_sizes;
+  samples.reserve(r->buffered_data_size);
+  sample_sizes.reserve(r->buffered_data_blocks.size());
+  for (const auto& block : r->buffered_data_blocks) {
+    samples.append(block.contents);
+    sample_sizes.push_back(block.contents.size());
+  }
+
+  const auto& opts = r->compression_opts;
+  std::string dict;
+  if (opts.zstd_max_train_bytes > 0) {
+    dict = ZSTD_TrainDictionary(samples, sample_sizes, opts.max_dict_bytes);
+    if (dict.empty()) {
+      RLOG(InfoLogLevel::DEBUG_LEVEL, r->ioptions.info_log,
+          "Failed to train compression dictionary on %" ROCKSDB_PRIszt " samples, using raw "
+          "content dictionary", sample_sizes.size());
+    }
+  }
+  if (dict.empty()) {
+    samples.resize(std::min<size_t>(samples.size(), opts.max_dict_bytes));
+    dict = std::move(samples);
+  }
+  if (!dict.empty()) {
+    r->compression_dict = std::make_unique<CompressionDict>(std::move(dict), opts);
+  }
+
+  for (size_t i = 0; i != r->buffered_data_blocks.size(); ++i) {
+    auto& block = r->buffered_data_blocks[i];
+    for (const auto& key : block.keys) {
+      r->data_index_builder->OnKeyAdded(key);
+    }
+    const Slice block_next_key = i + 1 < r->buffered_data_blocks.size()
+        ? Slice(r->buffered_data_blocks[i + 1].keys.front()) : next_block_first_key;
+    WriteDataBlock(block.contents, &block.keys.back(), block_next_key);
+    if (!ok()) break;
+  }
+  r->buffered_data_blocks.clear();
+  r->buffered_data_blocks.shrink_to_fit();
+  r->buffered_data_size = 0;
+}
+
+void BlockBasedTableBuilder::WriteDataBlock(const Slice& raw_block_contents,
+                                            std::string* last_key,
+                                            const Slice& next_block_first_key) {
+  Rep* const r = rep_;
+  const size_t data_block_size = WriteBlock(
+      raw_block_contents, &r->data_pending_handle, r->data_writer.get(),
+      r->compression_dict.get());
   if (!ok()) return;
 
   if (!r->table_options.skip_table_builder_flush) {
@@ -514,7 +621,7 @@ void BlockBasedTableBuilder::FlushDataBlock(const Slice& next_block_first_key) {
   // "the r" as the key for the index block entry since it is >= all
   // entries in the first block and < all entries in subsequent
   // blocks.
-  r->data_index_builder->AddIndexEntry(&r->last_key,
+  r->data_index_builder->AddIndexEntry(last_key,
       next_block_first_key.empty() ? nullptr : &next_block_first_key,
       r->data_pending_handle);
   while (r->data_index_builder->ShouldFlush()) {
@@ -561,17 +668,10 @@ void BlockBasedTableBuilder::FlushFilterBlock(const Slice& next_block_first_key)
       is_last_flush ? nullptr : &next_block_first_key,  r->filter_pending_handle);
 }
 
-size_t BlockBasedTableBuilder::WriteBlock(BlockBuilder* block,
-                                          BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
-  size_t block_size = WriteBlock(block->Finish(), handle, writer_info);
-  block->Reset();
-  return block_size;
-}
-
 size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
                                           BlockHandle* handle,
-                                          FileWriterWithOffsetAndCachePrefix* writer_info) {
+                                          FileWriterWithOffsetAndCachePrefix* writer_info,
+                                          const CompressionDict* compression_dict) {
   // File format contains a sequence of blocks where each block has:
   //    block_data: uint8[n]
   //    type: uint8
@@ -584,7 +684,7 @@ size_t BlockBasedTableBuilder::WriteBlock(const Slice& raw_block_contents,
   if (raw_block_contents.size() < kCompressionSizeLimit) {
     block_contents =
         CompressBlock(raw_block_contents, r->compression_opts, &type,
-                      r->table_options.format_version, &r->compressed_output);
+                      r->table_options.format_version, compression_dict, &r->compressed_output);
   } else {
     RecordTick(r->ioptions.statistics, NUMBER_BLOCK_NOT_COMPRESSED);
     type = kNoCompression;
@@ -701,6 +801,11 @@ Status BlockBasedTableBuilder::Finish() {
   if (!r->data_block_builder.empty()) {
     FlushDataBlock(end_slice);  // no more data block
   }
+  if (r->state == Rep::State::kBuffered && ok()) {
+    // File is smaller than the amount of data required for the dictionary, build it from what
+    // we have.
+    EnterUnbuffered(end_slice);
+  }
   if (r->filter_block_builder != nullptr) {
     FlushFilterBlock(end_slice);  // no more filter block
   }
@@ -717,8 +822,9 @@ Status BlockBasedTableBuilder::Finish() {
   // Write meta blocks and metaindex block with the following order.
   //    1. [meta block: filter]
   //    2. [other meta blocks]
-  //    3. [meta block: properties]
-  //    4. [metaindex block]
+  //    3. [meta block: compression dictionary]
+  //    4. [meta block: properties]
+  //    5. [metaindex block]
   // write meta blocks
   MetaIndexBuilder meta_index_builder;
   for (const auto& item : r->data_index_blocks.meta_blocks) {
@@ -727,6 +833,13 @@ Status BlockBasedTableBuilder::Finish() {
     meta_index_builder.Add(item.first, block_handle);
   }
 
+  if (ok() && r->compression_dict != nullptr) {
+    BlockHandle compression_dict_block_handle;
+    WriteRawBlock(r->compression_dict->raw(), kNoCompression, &compression_dict_block_handle,
+                  r->metadata_writer.get());
+    meta_index_builder.Add(block_based_table::kCompressionDictBlock, compression_dict_block_handle);
+  }
+
   if (ok()) {
     if (r->filter_block_builder != nullptr) {
       // Add mapping from "<filter_block_prefix>.Name" to location of either filter block or
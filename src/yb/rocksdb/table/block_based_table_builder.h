@@ -39,6 +39,7 @@ namespace rocksdb {
 
 class BlockBuilder;
 class BlockHandle;
+class CompressionDict;
 class WritableFile;
 struct BlockBasedTableOptions;
 
@@ -106,13 +107,10 @@ class BlockBasedTableBuilder : public TableBuilder {
   struct FileWriterWithOffsetAndCachePrefix;
 
   bool ok() const { return status().ok(); }
-  // Call block's Finish() method and then write the finalize block contents to
-  // file. Returns number of bytes written to file.
-  size_t WriteBlock(BlockBuilder* block, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
   // Directly write block content to the file. Returns number of bytes written to file.
   size_t WriteBlock(const Slice& block_contents, BlockHandle* handle,
-      FileWriterWithOffsetAndCachePrefix* writer_info);
+      FileWriterWithOffsetAndCachePrefix* writer_info,
+      const CompressionDict* compression_dict = nullptr);
   size_t WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle,
       FileWriterWithOffsetAndCachePrefix* writer_info);
   Status InsertBlockInCache(const Slice& block_contents,
@@ -130,6 +128,19 @@ class BlockBasedTableBuilder : public TableBuilder {
   // REQUIRES: Finish(), Abandon() have not been called.
   void FlushDataBlock(const Slice& next_block_first_key);
 
+  // Write data block contents to the data file and add an index entry for it. last_key is the
+  // last key of the block and could be modified by this method.
+  void WriteDataBlock(const Slice& raw_block_contents, std::string* last_key,
+                      const Slice& next_block_first_key);
+
+  // Keep the current data block in memory until enough data is buffered to build the compression
+  // dictionary.
+  void BufferDataBlock(const Slice& next_block_first_key);
+
+  // Build the compression dictionary from buffered data blocks, then write them out using the
+  // dictionary. All subsequent data blocks are written directly.
+  void EnterUnbuffered(const Slice& next_block_first_key);
+
   // Flush the current filter block into disk. next_block_first_key should be nullptr if this is the
   // last block written to disk.
   // REQUIRES: Finish(), Abandon() have not been called.
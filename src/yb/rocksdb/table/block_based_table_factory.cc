@@ -31,6 +31,7 @@
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/flush_block_policy.h"
 #include "yb/rocksdb/cache.h"
+#include "yb/rocksdb/persistent_block_cache.h"
 #include "yb/rocksdb/table/block_based_table_builder.h"
 #include "yb/rocksdb/table/block_based_table_reader.h"
 #include "yb/rocksdb/table/format.h"
@@ -49,6 +50,13 @@ BlockBasedTableFactory::BlockBasedTableFactory(
   } else if (table_options_.block_cache == nullptr) {
     table_options_.block_cache = NewLRUCache(8 << 20);
   }
+  if (table_options_.block_cache != nullptr && table_options_.persistent_block_cache != nullptr) {
+    table_options_.block_cache->SetEvictionCallback(
+        BlockBasedTable::PersistentBlockCacheEvictionCallback(
+            table_options_.persistent_block_cache));
+  } else {
+    table_options_.persistent_block_cache.reset();
+  }
   if (table_options_.block_size_deviation < 0 ||
       table_options_.block_size_deviation > 100) {
     table_options_.block_size_deviation = 0;
@@ -136,6 +144,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks: %d\n",
            table_options_.cache_index_and_filter_blocks);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  cache_index_and_filter_blocks_with_high_priority: %d\n",
+           table_options_.cache_index_and_filter_blocks_with_high_priority);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  index_type: %d\n",
            yb::to_underlying(table_options_.index_type));
   ret.append(buffer);
@@ -165,6 +176,15 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
              table_options_.block_cache_compressed->GetCapacity());
     ret.append(buffer);
   }
+  snprintf(buffer, kBufferSize, "  persistent_block_cache: %p\n",
+           table_options_.persistent_block_cache.get());
+  ret.append(buffer);
+  if (table_options_.persistent_block_cache) {
+    snprintf(buffer, kBufferSize,
+             "  persistent_block_cache_size: %" ROCKSDB_PRIszt "\n",
+             table_options_.persistent_block_cache->GetCapacity());
+    ret.append(buffer);
+  }
   snprintf(buffer, kBufferSize, "  block_size: %" ROCKSDB_PRIszt "\n",
            table_options_.block_size);
   ret.append(buffer);
@@ -177,6 +197,9 @@ std::string BlockBasedTableFactory::GetPrintableTableOptions() const {
   snprintf(buffer, kBufferSize, "  index_block_restart_interval: %d\n",
            table_options_.index_block_restart_interval);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  data_block_key_value_encoding_format: %s\n",
+           ToString(table_options_.data_block_key_value_encoding_format).c_str());
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  filter_policy: %s\n",
            table_options_.filter_policy == nullptr ?
              "nullptr" : table_options_.filter_policy->Name());
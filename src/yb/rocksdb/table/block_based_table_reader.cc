@@ -27,7 +27,10 @@
 #include <utility>
 #include <cinttypes>
 
+#include <boost/optional.hpp>
+
 #include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/db/memtable.h"
 
 #include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/comparator.h"
@@ -35,6 +38,7 @@
 #include "yb/rocksdb/filter_policy.h"
 #include "yb/rocksdb/iterator.h"
 #include "yb/rocksdb/options.h"
+#include "yb/rocksdb/persistent_block_cache.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/table.h"
 #include "yb/rocksdb/table_properties.h"
@@ -56,6 +60,7 @@
 #include "yb/rocksdb/table/two_level_iterator.h"
 
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/compression.h"
 #include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/perf_context_imp.h"
 #include "yb/rocksdb/util/stop_watch.h"
@@ -66,6 +71,11 @@
 #include "yb/util/atomic.h"
 #include "yb/util/mem_tracker.h"
 
+DEFINE_uint64(rocksdb_iterator_max_readahead_size, 256 * 1024,
+              "Max number of bytes of data blocks that are prefetched by an SST file iterator, "
+              "after it detects sequential reads. The readahead starts with 8KB and doubles on "
+              "every prefetch. 0 turns it off.");
+
 namespace rocksdb {
 
 extern const uint64_t kBlockBasedTableMagicNumber;
@@ -226,6 +236,8 @@ struct BlockBasedTable::Rep {
   BlockHandle filter_handle;
 
   std::shared_ptr<const TableProperties> table_properties;
+  // Dictionary for data blocks, set only for files written with dictionary compression.
+  std::unique_ptr<UncompressionDict> uncompression_dict;
   IndexType index_type;
   bool hash_index_allow_collision;
   bool whole_key_filtering;
@@ -254,6 +266,9 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
         block_type_(block_type) {}
 
   InternalIterator* NewSecondaryIterator(const Slice& index_value) override {
+    if (block_type_ == BlockType::kData) {
+      MaybeReadahead(index_value);
+    }
     return table_->NewDataBlockIterator(read_options_, index_value, block_type_);
   }
 
@@ -272,8 +287,58 @@ class BlockBasedTable::BlockEntryIteratorState : public TwoLevelIteratorState {
   const ReadOptions read_options_;
   const bool skip_filters_;
   const BlockType block_type_;
+
+  // Readahead state. When data blocks are requested in the file order for several times in a row,
+  // we ask the file to prefetch the following readahead_size_ bytes, so the next blocks are read
+  // without waiting for the storage. Readahead size grows up to the configured limit while reads
+  // stay sequential, and is reset by a non-sequential read, e.g. after seek.
+  void MaybeReadahead(const Slice& index_value);
+
+  static constexpr size_t kInitialReadaheadSize = 8 * 1024;
+  static constexpr int kSequentialReadsBeforeReadahead = 2;
+
+  uint64_t next_block_offset_ = std::numeric_limits<uint64_t>::max();
+  int num_sequential_reads_ = 0;
+  size_t readahead_size_ = kInitialReadaheadSize;
+  uint64_t readahead_limit_ = 0;
 };
 
+constexpr size_t BlockBasedTable::BlockEntryIteratorState::kInitialReadaheadSize;
+constexpr int BlockBasedTable::BlockEntryIteratorState::kSequentialReadsBeforeReadahead;
+
+void BlockBasedTable::BlockEntryIteratorState::MaybeReadahead(const Slice& index_value) {
+  const size_t max_readahead_size = FLAGS_rocksdb_iterator_max_readahead_size;
+  if (max_readahead_size == 0 || read_options_.read_tier == kBlockCacheTier) {
+    return;
+  }
+  BlockHandle handle;
+  Slice input = index_value;
+  if (!handle.DecodeFrom(&input).ok()) {
+    return;
+  }
+
+  const uint64_t block_end = handle.offset() + handle.size() + kBlockTrailerSize;
+  if (handle.offset() == next_block_offset_) {
+    ++num_sequential_reads_;
+  } else {
+    num_sequential_reads_ = 0;
+    readahead_size_ = kInitialReadaheadSize;
+    readahead_limit_ = 0;
+  }
+  next_block_offset_ = block_end;
+
+  if (num_sequential_reads_ < kSequentialReadsBeforeReadahead || block_end < readahead_limit_) {
+    return;
+  }
+  readahead_size_ = std::min(readahead_size_, max_readahead_size);
+  // Readahead is best effort, the following reads would fetch the data anyway.
+  WARN_NOT_OK(table_->GetBlockReader(BlockType::kData)->reader->Prefetch(
+                  block_end, readahead_size_),
+              "Data block readahead failed");
+  readahead_limit_ = block_end + readahead_size_;
+  readahead_size_ = std::min(readahead_size_ * 2, max_readahead_size);
+}
+
 
 class BlockBasedTable::IndexIteratorHolder {
  public:
@@ -345,6 +410,10 @@ bool BloomFilterAwareFileFilter::Filter(TableReader* reader) const {
   }
 }
 
+bool BloomFilterAwareFileFilter::FilterMemTable(const MemTable& memtable) const {
+  return memtable.FilterKeyMayMatch(user_key_);
+}
+
 namespace {
 // Return True if table_properties has `user_prop_name` has a `true` value
 // or it doesn't contain this property (for backward compatible).
@@ -438,6 +507,22 @@ Status BlockBasedTable::Open(const ImmutableCFOptions& ioptions,
     }
   }
 
+  // Read the compression dictionary.
+  BlockHandle compression_dict_handle;
+  if (FindMetaBlock(meta_iter.get(), block_based_table::kCompressionDictBlock,
+                    &compression_dict_handle).ok()) {
+    BlockContents compression_dict_block;
+    s = ReadBlockContents(
+        rep->base_reader_with_cache_prefix->reader.get(), rep->footer, ReadOptions::kDefault,
+        compression_dict_handle, &compression_dict_block, rep->ioptions.env, rep->mem_tracker,
+        false /* do_uncompress */);
+    if (!s.ok()) {
+      return s;
+    }
+    rep->uncompression_dict = std::make_unique<UncompressionDict>(
+        compression_dict_block.data.ToBuffer());
+  }
+
   // Read the properties
   bool found_properties_block = true;
   s = SeekToPropertiesBlock(meta_iter.get(), &found_properties_block);
@@ -683,12 +768,61 @@ Tickers GetBlockCacheHitTicker(BlockType block_type) {
 
 } // namespace
 
+Cache::EvictionCallback BlockBasedTable::PersistentBlockCacheEvictionCallback(
+    std::shared_ptr<PersistentBlockCache> persistent_block_cache) {
+  return [persistent_block_cache](
+      const Slice& key, void* value, void (*deleter)(const Slice& key, void* value)) {
+    // Filters and index readers are cached with other deleters and are not spilled.
+    if (deleter != &DeleteCachedEntry<Block>) {
+      return;
+    }
+    auto block = static_cast<Block*>(value);
+    if (block->compression_type() != kNoCompression) {
+      return;
+    }
+    // Failures are accounted in the persistent block cache metrics, the block is just dropped.
+    persistent_block_cache->Insert(key, Slice(block->data(), block->size()));
+  };
+}
+
+Status BlockBasedTable::GetDataBlockFromPersistentCache(
+    const Slice& block_cache_key, Cache* block_cache,
+    PersistentBlockCache* persistent_block_cache, Statistics* statistics,
+    const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
+    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+  if (persistent_block_cache == nullptr || block_cache == nullptr) {
+    return Status::OK();
+  }
+
+  std::unique_ptr<char[]> data;
+  size_t size = 0;
+  if (!persistent_block_cache->Lookup(block_cache_key, &data, &size).ok()) {
+    return Status::OK();
+  }
+
+  block->value = new Block(BlockContents(
+      std::move(data), size, true /* cachable */, kNoCompression, mem_tracker));
+  Status s;
+  if (read_options.fill_cache) {
+    s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
+                            block->value->usable_size(), &DeleteCachedEntry<Block>,
+                            &block->cache_handle, statistics);
+    if (!s.ok()) {
+      delete block->value;
+      block->value = nullptr;
+    }
+  }
+  return s;
+}
+
 Status BlockBasedTable::GetDataBlockFromCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
-    Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
+    Cache* block_cache, Cache* block_cache_compressed,
+    PersistentBlockCache* persistent_block_cache, Statistics* statistics,
     const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
     uint32_t format_version, BlockType block_type,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const UncompressionDict* uncompression_dict) {
   Status s;
   Block* compressed_block = nullptr;
   Cache::Handle* block_cache_compressed_handle = nullptr;
@@ -710,7 +844,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
   assert(block->cache_handle == nullptr && block->value == nullptr);
 
   if (block_cache_compressed == nullptr) {
-    return s;
+    return GetDataBlockFromPersistentCache(
+        block_cache_key, block_cache, persistent_block_cache, statistics, read_options, block,
+        mem_tracker);
   }
 
   assert(!compressed_block_cache_key.empty());
@@ -720,7 +856,9 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // uncompressed cache
   if (block_cache_compressed_handle == nullptr) {
     RecordTick(statistics, BLOCK_CACHE_COMPRESSED_MISS);
-    return s;
+    return GetDataBlockFromPersistentCache(
+        block_cache_key, block_cache, persistent_block_cache, statistics, read_options, block,
+        mem_tracker);
   }
 
   // found compressed block
@@ -732,7 +870,7 @@ Status BlockBasedTable::GetDataBlockFromCache(
   // Retrieve the uncompressed contents into a new buffer
   BlockContents contents;
   s = UncompressBlockContents(compressed_block->data(), compressed_block->size(), &contents,
-                              format_version, mem_tracker);
+                              format_version, mem_tracker, uncompression_dict);
 
   // Insert uncompressed block into block cache
   if (s.ok()) {
@@ -758,9 +896,10 @@ Status BlockBasedTable::GetDataBlockFromCache(
 Status BlockBasedTable::PutDataBlockToCache(
     const Slice& block_cache_key, const Slice& compressed_block_cache_key,
     Cache* block_cache, Cache* block_cache_compressed,
-    const ReadOptions& read_options, Statistics* statistics,
+    QueryId query_id, Statistics* statistics,
     CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-    const std::shared_ptr<yb::MemTracker>& mem_tracker) {
+    const std::shared_ptr<yb::MemTracker>& mem_tracker,
+    const UncompressionDict* uncompression_dict) {
   assert(raw_block->compression_type() == kNoCompression ||
          block_cache_compressed != nullptr);
 
@@ -769,7 +908,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   BlockContents contents;
   if (raw_block->compression_type() != kNoCompression) {
     s = UncompressBlockContents(raw_block->data(), raw_block->size(), &contents,
-                                format_version, mem_tracker);
+                                format_version, mem_tracker, uncompression_dict);
   }
   if (!s.ok()) {
     delete raw_block;
@@ -787,7 +926,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   // Release the hold on the compressed cache entry immediately.
   if (block_cache_compressed != nullptr && raw_block != nullptr &&
       raw_block->cachable()) {
-    s = block_cache_compressed->Insert(compressed_block_cache_key, read_options.query_id, raw_block,
+    s = block_cache_compressed->Insert(compressed_block_cache_key, query_id, raw_block,
                                        raw_block->usable_size(), &DeleteCachedEntry<Block>);
     if (s.ok()) {
       // Avoid the following code to delete this cached block.
@@ -802,7 +941,7 @@ Status BlockBasedTable::PutDataBlockToCache(
   // insert into uncompressed block cache
   assert((block->value->compression_type() == kNoCompression));
   if (block_cache != nullptr && block->value->cachable()) {
-    s = block_cache->Insert(block_cache_key, read_options.query_id, block->value,
+    s = block_cache->Insert(block_cache_key, query_id, block->value,
                             block->value->usable_size(),
                             &DeleteCachedEntry<Block>, &block->cache_handle, statistics);
     if (!s.ok()) {
@@ -900,6 +1039,14 @@ Slice BlockBasedTable::GetFilterKeyFromUserKey(const Slice &user_key) const {
       rep_->filter_key_transformer->Transform(user_key) : user_key;
 }
 
+QueryId BlockBasedTable::IndexAndFilterCacheQueryId(QueryId query_id) const {
+  if (query_id == kNoCacheQueryId ||
+      !rep_->table_options.cache_index_and_filter_blocks_with_high_priority) {
+    return query_id;
+  }
+  return kInMultiTouchId;
+}
+
 BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     const QueryId query_id,
     bool no_io,
@@ -978,7 +1125,7 @@ BlockBasedTable::CachableEntry<FilterBlockReader> BlockBasedTable::GetFilter(
     filter = ReadFilterBlock(*filter_block_handle, rep_, &filter_size);
     if (filter != nullptr) {
       assert(filter_size > 0);
-      Status s = block_cache->Insert(filter_block_cache_key, query_id,
+      Status s = block_cache->Insert(filter_block_cache_key, IndexAndFilterCacheQueryId(query_id),
                                      filter, filter_size,
                                      &DeleteCachedEntry<FilterBlockReader>, &cache_handle,
                                      statistics);
@@ -1044,7 +1191,8 @@ InternalIterator* BlockBasedTable::NewIndexIterator(
     std::unique_ptr<IndexReader> index_reader_unique;
     Status s = CreateDataBlockIndexReader(&index_reader_unique);
     if (s.ok()) {
-      s = block_cache->Insert(key, read_options.query_id, index_reader_unique.get(),
+      s = block_cache->Insert(key, IndexAndFilterCacheQueryId(read_options.query_id),
+                              index_reader_unique.get(),
                               index_reader_unique->usable_size(),
                               &DeleteCachedEntry<IndexReader>, &cache_handle, statistics);
     }
@@ -1104,6 +1252,9 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   Cache* block_cache = rep_->table_options.block_cache.get();
   Cache* block_cache_compressed =
       rep_->table_options.block_cache_compressed.get();
+  // Reading the persistent block cache is I/O too.
+  PersistentBlockCache* persistent_block_cache =
+      no_io ? nullptr : rep_->table_options.persistent_block_cache.get();
   CachableEntry<Block> block;
 
   BlockHandle handle;
@@ -1122,6 +1273,9 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
   }
 
   FileReaderWithCachePrefix* reader = GetBlockReader(block_type);
+  // Only data blocks are compressed with the dictionary.
+  const UncompressionDict* uncompression_dict =
+      block_type == BlockType::kData ? rep_->uncompression_dict.get() : nullptr;
 
   // If either block cache is enabled, we'll try to read from it.
   if (block_cache != nullptr || block_cache_compressed != nullptr) {
@@ -1141,22 +1295,31 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     }
 
     s = GetDataBlockFromCache(
-        key, ckey, block_cache, block_cache_compressed, statistics, ro, &block,
-        rep_->table_options.format_version, block_type, rep_->mem_tracker);
+        key, ckey, block_cache, block_cache_compressed, persistent_block_cache, statistics, ro,
+        &block, rep_->table_options.format_version, block_type, rep_->mem_tracker,
+        uncompression_dict);
 
     if (block.value == nullptr && !no_io && ro.fill_cache) {
       std::unique_ptr<Block> raw_block;
       {
         StopWatch sw(rep_->ioptions.env, statistics, READ_BLOCK_GET_MICROS);
+        // Compressed blocks are kept in block_cache_compressed, so they are tracked separately.
+        const auto& raw_block_mem_tracker =
+            block_cache_compressed != nullptr &&
+                rep_->table_options.block_cache_compressed_mem_tracker
+            ? rep_->table_options.block_cache_compressed_mem_tracker : rep_->mem_tracker;
         s = block_based_table::ReadBlockFromFile(
             reader->reader.get(), rep_->footer, ro, handle, &raw_block, rep_->ioptions.env,
-            rep_->mem_tracker, block_cache_compressed == nullptr);
+            raw_block_mem_tracker, block_cache_compressed == nullptr, uncompression_dict);
       }
 
       if (s.ok()) {
+        const auto query_id = block_type == BlockType::kIndex
+            ? IndexAndFilterCacheQueryId(ro.query_id) : ro.query_id;
         s = PutDataBlockToCache(key, ckey, block_cache, block_cache_compressed,
-                                ro, statistics, &block, raw_block.release(),
-                                rep_->table_options.format_version, rep_->mem_tracker);
+                                query_id, statistics, &block, raw_block.release(),
+                                rep_->table_options.format_version, rep_->mem_tracker,
+                                uncompression_dict);
       }
     }
   }
@@ -1175,7 +1338,7 @@ InternalIterator* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
     std::unique_ptr<Block> block_value;
     s = block_based_table::ReadBlockFromFile(
         reader->reader.get(), rep_->footer, ro, handle, &block_value, rep_->ioptions.env,
-        rep_->mem_tracker);
+        rep_->mem_tracker, true /* do_uncompress */, uncompression_dict);
     if (s.ok()) {
       block.value = block_value.release();
     }
@@ -1419,6 +1582,90 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& intern
   return s;
 }
 
+void BlockBasedTable::MultiGet(const ReadOptions& read_options, TableMultiGetKey* keys,
+                               size_t num_keys, bool skip_filters) {
+  // Block-based filter is checked per data block, so there is nothing to check in advance.
+  if (skip_filters || rep_->filter_type == FilterType::kBlockBasedFilter) {
+    TableReader::MultiGet(read_options, keys, num_keys, skip_filters);
+    return;
+  }
+
+  std::vector<TableMultiGetKey*> candidates;
+  candidates.reserve(num_keys);
+  for (size_t i = 0; i != num_keys; ++i) {
+    auto& key = keys[i];
+    key.status = Status::OK();
+    Slice filter_key = GetFilterKeyFromInternalKey(key.internal_key);
+    CachableEntry<FilterBlockReader> filter_entry = GetFilter(
+        read_options.query_id, read_options.read_tier == kBlockCacheTier, &filter_key);
+    const bool may_match = NonBlockBasedFilterKeyMayMatch(filter_entry.value, filter_key);
+    filter_entry.Release(rep_->table_options.block_cache.get());
+    if (may_match) {
+      candidates.push_back(&key);
+    } else {
+      RecordTick(rep_->ioptions.statistics, BLOOM_FILTER_USEFUL);
+    }
+  }
+
+  if (candidates.empty()) {
+    return;
+  }
+
+  IndexIteratorHolder iiter_holder(this, read_options);
+  InternalIterator& iiter = *iiter_holder.iter();
+  if (!iiter.status().ok()) {
+    for (auto* key : candidates) {
+      key->status = iiter.status();
+    }
+    return;
+  }
+
+  // Data block of the previous lookup, kept pinned while next keys are stored in it.
+  boost::optional<BlockIter> biter;
+  std::string biter_handle;
+  for (auto* key : candidates) {
+    Status s;
+    bool done = false;
+    for (iiter.Seek(key->internal_key); iiter.Valid() && !done; iiter.Next()) {
+      Slice data_block_handle = iiter.value();
+      if (!biter || data_block_handle != Slice(biter_handle)) {
+        biter.emplace();
+        NewDataBlockIterator(read_options, data_block_handle, BlockType::kData, biter.get_ptr());
+        biter_handle = data_block_handle.ToBuffer();
+      }
+
+      if (read_options.read_tier == kBlockCacheTier && biter->status().IsIncomplete()) {
+        // Couldn't get block from block_cache.
+        key->get_context->MarkKeyMayExist();
+        biter.reset();
+        break;
+      }
+      if (!biter->status().ok()) {
+        s = biter->status();
+        biter.reset();
+        break;
+      }
+
+      for (biter->Seek(key->internal_key); biter->Valid(); biter->Next()) {
+        ParsedInternalKey parsed_key;
+        if (!ParseInternalKey(biter->key(), &parsed_key)) {
+          s = STATUS(Corruption, Slice());
+        }
+
+        if (!key->get_context->SaveValue(parsed_key, biter->value())) {
+          done = true;
+          break;
+        }
+      }
+      s = biter->status();
+    }
+    if (s.ok()) {
+      s = iiter.status();
+    }
+    key->status = s;
+  }
+}
+
 Status BlockBasedTable::Prefetch(const Slice* const begin,
                                  const Slice* const end) {
   auto& comparator = *rep_->comparator;
@@ -1481,8 +1728,8 @@ bool BlockBasedTable::TEST_KeyInCache(const ReadOptions& options,
       GetCacheKey(rep_->data_reader_with_cache_prefix->cache_key_prefix, handle, cache_key_storage);
   Slice ckey;
 
-  s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, options, &block,
-      rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker);
+  s = GetDataBlockFromCache(cache_key, ckey, block_cache, nullptr, nullptr, nullptr, options,
+      &block, rep_->table_options.format_version, BlockType::kData, rep_->mem_tracker);
   assert(s.ok());
   bool in_cache = block.value != nullptr;
   if (in_cache) {
@@ -1580,6 +1827,33 @@ Status BlockBasedTable::CreateDataBlockIndexReader(
   }
 }
 
+Status BlockBasedTable::GetSplitKeys(size_t max_keys, std::vector<std::string>* keys) {
+  if (max_keys == 0 || !rep_->table_properties) {
+    return Status::OK();
+  }
+  const uint64_t num_data_blocks = rep_->table_properties->num_data_blocks;
+  if (num_data_blocks < 2) {
+    return Status::OK();
+  }
+  const uint64_t stride = std::max<uint64_t>(num_data_blocks / (max_keys + 1), 1);
+  unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
+  uint64_t block_idx = 0;
+  for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+    // Index entry key is not less than the last key of its block, so it splits the file after the
+    // block.
+    if (++block_idx % stride == 0) {
+      if (block_idx >= num_data_blocks) {
+        break;
+      }
+      keys->push_back(index_iter->key().ToString());
+      if (keys->size() >= max_keys) {
+        break;
+      }
+    }
+  }
+  return index_iter->status();
+}
+
 uint64_t BlockBasedTable::ApproximateOffsetOf(const Slice& key) {
   unique_ptr<InternalIterator> index_iter(NewIndexIterator(ReadOptions::kDefault));
 
@@ -29,6 +29,7 @@
 #include <utility>
 #include <string>
 
+#include "yb/rocksdb/cache.h"
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/statistics.h"
 #include "yb/rocksdb/status.h"
@@ -51,6 +52,8 @@ class FullFilterBlockReader;
 class Footer;
 class InternalKeyComparator;
 class Iterator;
+class PersistentBlockCache;
+class UncompressionDict;
 class RandomAccessFile;
 class TableCache;
 class TableReader;
@@ -93,6 +96,8 @@ class BloomFilterAwareFileFilter : public TableAwareReadFileFilter {
 
   bool Filter(TableReader* reader) const override;
 
+  bool FilterMemTable(const MemTable& memtable) const override;
+
  private:
   const ReadOptions read_options_;
   const std::string user_key_;
@@ -133,6 +138,11 @@ class BlockBasedTable : public TableReader {
                      PrefetchFilter prefetch_filter = PrefetchFilter::YES,
                      bool skip_filters = false);
 
+  // Returns a block cache eviction callback that writes uncompressed blocks evicted from the block
+  // cache to persistent_block_cache, so that GetDataBlockFromCache could find them there later.
+  static Cache::EvictionCallback PersistentBlockCacheEvictionCallback(
+      std::shared_ptr<PersistentBlockCache> persistent_block_cache);
+
   bool IsSplitSst() const override { return true; }
 
   void SetDataFileReader(unique_ptr<RandomAccessFileReader>&& data_file) override;
@@ -151,6 +161,11 @@ class BlockBasedTable : public TableReader {
   Status Get(const ReadOptions& readOptions, const Slice& key,
              GetContext* get_context, bool skip_filters = false) override;
 
+  // Checks filters for all keys first, then looks up keys that may be present using the same
+  // index iterator, reusing the data block when adjacent keys are stored in it.
+  void MultiGet(const ReadOptions& read_options, TableMultiGetKey* keys, size_t num_keys,
+                bool skip_filters = false) override;
+
   // Pre-fetch the disk blocks that correspond to the key range specified by
   // (kbegin, kend). The call will return return error status in the event of
   // IO or iteration error.
@@ -164,6 +179,9 @@ class BlockBasedTable : public TableReader {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) override;
 
+  // Picks keys of data index entries that are evenly distributed among data blocks.
+  Status GetSplitKeys(size_t max_keys, std::vector<std::string>* keys) override;
+
   // Returns true if the block for the specified key is in cache.
   // REQUIRES: key is in this table && block cache enabled
   bool TEST_KeyInCache(const ReadOptions& options, const Slice& key);
@@ -239,15 +257,25 @@ class BlockBasedTable : public TableReader {
   InternalIterator* NewIndexIterator(const ReadOptions& read_options,
                                      BlockIter* input_iter = nullptr);
 
-  // Read block cache from block caches (if set): block_cache and
-  // block_cache_compressed.
+  // Read block cache from block caches (if set): block_cache, block_cache_compressed and
+  // persistent_block_cache.
   // On success, Status::OK with be returned and @block will be populated with
   // pointer to the block as well as its block handle.
   static Status GetDataBlockFromCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
-      Cache* block_cache, Cache* block_cache_compressed, Statistics* statistics,
+      Cache* block_cache, Cache* block_cache_compressed,
+      PersistentBlockCache* persistent_block_cache, Statistics* statistics,
       const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       uint32_t format_version, BlockType block_type,
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const UncompressionDict* uncompression_dict = nullptr);
+
+  // Looks up a block that was spilled to persistent_block_cache and moves it back to block_cache.
+  // A failed lookup is treated as a miss, so the block is read from the file then.
+  static Status GetDataBlockFromPersistentCache(
+      const Slice& block_cache_key, Cache* block_cache,
+      PersistentBlockCache* persistent_block_cache, Statistics* statistics,
+      const ReadOptions& read_options, BlockBasedTable::CachableEntry<Block>* block,
       const std::shared_ptr<yb::MemTracker>& mem_tracker);
 
   // Put a raw block (maybe compressed) to the corresponding block caches.
@@ -258,12 +286,14 @@ class BlockBasedTable : public TableReader {
   //
   // REQUIRES: raw_block is heap-allocated. PutDataBlockToCache() will be
   // responsible for releasing its memory if error occurs.
+  // Blocks are added to the caches with the specified query_id.
   static Status PutDataBlockToCache(
       const Slice& block_cache_key, const Slice& compressed_block_cache_key,
       Cache* block_cache, Cache* block_cache_compressed,
-      const ReadOptions& read_options, Statistics* statistics,
+      QueryId query_id, Statistics* statistics,
       CachableEntry<Block>* block, Block* raw_block, uint32_t format_version,
-      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+      const UncompressionDict* uncompression_dict = nullptr);
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -301,6 +331,9 @@ class BlockBasedTable : public TableReader {
 
   FileReaderWithCachePrefix* GetBlockReader(BlockType block_type);
 
+  // Returns query id that should be used to add index or filter block to the block cache.
+  QueryId IndexAndFilterCacheQueryId(QueryId query_id) const;
+
   explicit BlockBasedTable(Rep* rep) : rep_(rep) {}
 
   // Helper functions for DumpTable()
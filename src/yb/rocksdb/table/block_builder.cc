@@ -40,10 +40,29 @@
 //     value: char[value_length]
 // shared_bytes == 0 for restart points.
 //
+// When KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts is used, an entry has the form:
+//     shared_prefix_bytes: varint32
+//     (unshared_1_bytes << 2) | flags: varint32
+//     [shared_middle_bytes: varint32]   -- if flags & kThreeSharedPartsHasSharedMiddle
+//     [unshared_2_bytes: varint32]      -- if flags & kThreeSharedPartsHasSharedMiddle
+//     value_length: varint32
+//     key_delta_1: char[unshared_1_bytes]
+//     key_delta_2: char[unshared_2_bytes]
+//     [suffix_delta: zigzag varint64]   -- if flags & kThreeSharedPartsHasSuffixDelta
+//     value: char[value_length]
+// The key is restored as: shared prefix of the previous key, key_delta_1, shared_middle_bytes of
+// the previous key starting at the same offset, key_delta_2. If flags & kThreeSharedPartsHasSuffixDelta, these
+// parts form the key without its last 8 bytes (internal key suffix), they are taken from the
+// previous key without its suffix, and the suffix is the suffix of the previous key plus
+// suffix_delta. Restart points are stored with zero shared bytes and flags, so such an entry
+// contains the whole key as is.
+//
 // The trailer of the block has the form:
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+// num_restarts has kThreeSharedPartsBlockFlag set, when keys of the block use
+// kKeyDeltaEncodingThreeSharedParts.
 
 #include "yb/rocksdb/table/block_builder.h"
 
@@ -53,13 +72,18 @@
 
 #include "yb/rocksdb/comparator.h"
 #include "yb/rocksdb/db/dbformat.h"
+#include "yb/rocksdb/table/format.h"
 #include "yb/rocksdb/util/coding.h"
 
 namespace rocksdb {
 
-BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding)
+BlockBuilder::BlockBuilder(int block_restart_interval, bool use_delta_encoding,
+                           KeyValueEncodingFormat key_value_encoding_format)
     : block_restart_interval_(block_restart_interval),
       use_delta_encoding_(use_delta_encoding),
+      key_value_encoding_format_(
+          use_delta_encoding ? key_value_encoding_format
+                             : KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix),
       restarts_(),
       counter_(0),
       finished_(false) {
@@ -110,21 +134,38 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, static_cast<uint32_t>(restarts_.size()));
+  uint32_t num_restarts = static_cast<uint32_t>(restarts_.size());
+  if (key_value_encoding_format_ == KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts) {
+    num_restarts |= kThreeSharedPartsBlockFlag;
+  }
+  PutFixed32(&buffer_, num_restarts);
   finished_ = true;
   return Slice(buffer_);
 }
 
 void BlockBuilder::Add(const Slice& key, const Slice& value) {
-  Slice last_key_piece(last_key_);
   assert(!finished_);
   assert(counter_ <= block_restart_interval_);
-  size_t shared = 0;  // number of bytes shared with prev key
   if (counter_ >= block_restart_interval_) {
     // Restart compression
     restarts_.push_back(static_cast<uint32_t>(buffer_.size()));
     counter_ = 0;
-  } else if (use_delta_encoding_) {
+  }
+  switch (key_value_encoding_format_) {
+    case KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix:
+      AddWithSharedPrefix(key, value);
+      break;
+    case KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts:
+      AddWithThreeSharedParts(key, value);
+      break;
+  }
+  counter_++;
+}
+
+void BlockBuilder::AddWithSharedPrefix(const Slice& key, const Slice& value) {
+  Slice last_key_piece(last_key_);
+  size_t shared = 0;  // number of bytes shared with prev key
+  if (counter_ != 0 && use_delta_encoding_) {
     // See how much sharing to do with previous string
     const size_t min_length = std::min(last_key_piece.size(), key.size());
     while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
@@ -146,7 +187,82 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   last_key_.resize(shared);
   last_key_.append(key.cdata() + shared, non_shared);
   assert(Slice(last_key_) == key);
-  counter_++;
+}
+
+void BlockBuilder::AddWithThreeSharedParts(const Slice& key, const Slice& value) {
+  const Slice last_key(last_key_);
+  size_t key_size = key.size();
+  size_t last_key_size = last_key.size();
+  uint32_t flags = 0;
+  uint64_t suffix_delta = 0;
+  size_t shared_prefix = 0;
+  size_t middle_start = 0;
+  size_t shared_middle = 0;
+
+  if (counter_ != 0) {
+    if (key_size >= kThreeSharedPartsSuffixSize && last_key_size >= kThreeSharedPartsSuffixSize) {
+      const uint64_t suffix = DecodeFixed64(key.end() - kThreeSharedPartsSuffixSize);
+      const uint64_t last_suffix = DecodeFixed64(last_key.end() - kThreeSharedPartsSuffixSize);
+      suffix_delta = ZigZagEncode64(static_cast<int64_t>(suffix - last_suffix));
+      // Store the suffix as is, when its delta is not shorter.
+      if (VarintLength(suffix_delta) < static_cast<int>(kThreeSharedPartsSuffixSize)) {
+        flags |= kThreeSharedPartsHasSuffixDelta;
+        key_size -= kThreeSharedPartsSuffixSize;
+        last_key_size -= kThreeSharedPartsSuffixSize;
+      }
+    }
+
+    const size_t min_length = std::min(last_key_size, key_size);
+    while (shared_prefix < min_length && last_key[shared_prefix] == key[shared_prefix]) {
+      ++shared_prefix;
+    }
+
+    // Find the longest run of bytes that match the bytes at the same positions of the last key.
+    size_t pos = shared_prefix;
+    while (pos < min_length) {
+      if (key[pos] != last_key[pos]) {
+        ++pos;
+        continue;
+      }
+      const size_t run_start = pos;
+      while (pos < min_length && key[pos] == last_key[pos]) {
+        ++pos;
+      }
+      if (pos - run_start > shared_middle) {
+        middle_start = run_start;
+        shared_middle = pos - run_start;
+      }
+    }
+    if (shared_middle >= kThreeSharedPartsMinSharedMiddle) {
+      flags |= kThreeSharedPartsHasSharedMiddle;
+    } else {
+      middle_start = key_size;
+      shared_middle = 0;
+    }
+  } else {
+    middle_start = key_size;
+  }
+
+  const size_t non_shared_1 = middle_start - shared_prefix;
+  const size_t middle_end = middle_start + shared_middle;
+  const size_t non_shared_2 = key_size - middle_end;
+
+  PutVarint32(&buffer_, static_cast<uint32_t>(shared_prefix));
+  PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_1 << kThreeSharedPartsNumFlags | flags));
+  if (flags & kThreeSharedPartsHasSharedMiddle) {
+    PutVarint32(&buffer_, static_cast<uint32_t>(shared_middle));
+    PutVarint32(&buffer_, static_cast<uint32_t>(non_shared_2));
+  }
+  PutVarint32(&buffer_, static_cast<uint32_t>(value.size()));
+
+  buffer_.append(key.cdata() + shared_prefix, non_shared_1);
+  buffer_.append(key.cdata() + middle_end, non_shared_2);
+  if (flags & kThreeSharedPartsHasSuffixDelta) {
+    PutVarint64(&buffer_, suffix_delta);
+  }
+  buffer_.append(value.cdata(), value.size());
+
+  last_key_.assign(key.cdata(), key.size());
 }
 
 }  // namespace rocksdb
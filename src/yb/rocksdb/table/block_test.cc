@@ -135,6 +135,82 @@ TEST_F(BlockTest, SimpleTest) {
   delete iter;
 }
 
+namespace {
+
+// Generates sorted internal keys similar to DocDB keys of wide rows: the same document key for all
+// columns of the row, followed by the column id and the hybrid time with the write id.
+void GenerateDocDBLikeKVs(std::vector<std::string>* keys, std::vector<std::string>* values,
+                          int num_rows, int num_columns) {
+  Random rnd(303);
+  SequenceNumber seq = 1ULL << 50;
+  for (int row = 0; row < num_rows; ++row) {
+    const std::string doc_key = "doc_key_" + GenerateKey(row, row % 7, 16, &rnd);
+    char hybrid_time[8];
+    EncodeFixed64(hybrid_time, (1ULL << 60) - row * 1000);
+    for (int column = 0; column < num_columns; ++column) {
+      std::string user_key = doc_key;
+      user_key.push_back(static_cast<char>('A' + column));
+      user_key.append(hybrid_time, sizeof(hybrid_time));
+      user_key.push_back(static_cast<char>(column));
+      user_key.push_back(10);
+      keys->push_back(InternalKey(user_key, seq++, kTypeValue).Encode().ToString());
+      values->push_back(RandomString(&rnd, 10));
+    }
+  }
+}
+
+} // namespace
+
+TEST_F(BlockTest, ThreeSharedPartsEncoding) {
+  InternalKeyComparator comparator(BytewiseComparator());
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  GenerateDocDBLikeKVs(&keys, &values, 1000, 10);
+
+  size_t shared_prefix_size = 0;
+  for (auto format : {KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix,
+                      KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts}) {
+    BlockBuilder builder(16, true /* use_delta_encoding */, format);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      builder.Add(keys[i], values[i]);
+    }
+    BlockContents contents;
+    contents.data = builder.Finish();
+    contents.cachable = false;
+    if (format == KeyValueEncodingFormat::kKeyDeltaEncodingSharedPrefix) {
+      shared_prefix_size = contents.data.size();
+    } else {
+      ASSERT_LT(contents.data.size(), shared_prefix_size * 3 / 4);
+    }
+    Block reader(std::move(contents));
+    ASSERT_EQ(format, reader.key_value_encoding_format());
+
+    std::unique_ptr<InternalIterator> iter(reader.NewIterator(&comparator));
+    size_t count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); ++count, iter->Next()) {
+      ASSERT_EQ(keys[count], iter->key().ToString());
+      ASSERT_EQ(values[count], iter->value().ToString());
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(keys.size(), count);
+
+    for (iter->SeekToLast(); iter->Valid(); iter->Prev()) {
+      --count;
+      ASSERT_EQ(keys[count], iter->key().ToString());
+    }
+    ASSERT_EQ(0, count);
+
+    Random rnd(304);
+    for (int i = 0; i < 1000; ++i) {
+      const size_t index = rnd.Uniform(static_cast<int>(keys.size()));
+      iter->Seek(keys[index]);
+      ASSERT_TRUE(iter->Valid());
+      ASSERT_EQ(keys[index], iter->key().ToString());
+      ASSERT_EQ(values[index], iter->value().ToString());
+    }
+  }
+}
+
 // return the block contents
 BlockContents GetBlockContents(std::unique_ptr<BlockBuilder> *builder,
                                const std::vector<std::string> &keys,
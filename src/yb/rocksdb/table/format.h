@@ -41,6 +41,7 @@ namespace rocksdb {
 
 class Block;
 class RandomAccessFile;
+class UncompressionDict;
 struct ReadOptions;
 
 // the length of the magic number in bytes.
@@ -203,6 +204,21 @@ Status ReadFooterFromFile(RandomAccessFileReader* file, uint64_t file_size,
 // 1-byte type + 32-bit crc
 static const size_t kBlockTrailerSize = 5;
 
+// Set in the num_restarts field at the end of a block, that has keys encoded using
+// KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts.
+static const uint32_t kThreeSharedPartsBlockFlag = 1u << 31;
+
+// Flags of a kKeyDeltaEncodingThreeSharedParts entry, see block_builder.cc for its format.
+static const uint32_t kThreeSharedPartsHasSharedMiddle = 1;
+static const uint32_t kThreeSharedPartsHasSuffixDelta = 2;
+static const uint32_t kThreeSharedPartsNumFlags = 2;
+
+// Size of the internal key suffix, i.e. packed sequence number and value type.
+static const size_t kThreeSharedPartsSuffixSize = 8;
+
+// Shared middle is used only when it saves more bytes than its encoding takes.
+static const size_t kThreeSharedPartsMinSharedMiddle = 3;
+
 class TrackedAllocation {
  public:
   TrackedAllocation();
@@ -245,13 +261,16 @@ struct BlockContents {
 
 // Read the block identified by "handle" from "file".  On failure
 // return non-OK.  On success fill *result and return OK.
+// uncompression_dict should be specified for data blocks of files written with dictionary
+// compression.
 extern Status ReadBlockContents(RandomAccessFileReader* file,
                                 const Footer& footer,
                                 const ReadOptions& options,
                                 const BlockHandle& handle,
                                 BlockContents* contents, Env* env,
                                 const std::shared_ptr<yb::MemTracker>& mem_tracker,
-                                bool do_uncompress);
+                                bool do_uncompress,
+                                const UncompressionDict* uncompression_dict = nullptr);
 
 // The 'data' points to the raw block contents read in from file.
 // This method allocates a new heap buffer and the raw block
@@ -263,7 +282,8 @@ extern Status ReadBlockContents(RandomAccessFileReader* file,
 extern Status UncompressBlockContents(const char* data, size_t n,
                                       BlockContents* contents,
                                       uint32_t compress_format_version,
-                                      const std::shared_ptr<yb::MemTracker>& mem_tracker);
+                                      const std::shared_ptr<yb::MemTracker>& mem_tracker,
+                                      const UncompressionDict* uncompression_dict = nullptr);
 
 // Implementation details follow.  Clients should ignore,
 
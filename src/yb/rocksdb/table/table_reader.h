@@ -25,7 +25,10 @@
 #define ROCKSDB_TABLE_TABLE_READER_H
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "yb/rocksdb/status.h"
 #include "yb/util/slice.h"
 
 namespace rocksdb {
@@ -38,6 +41,13 @@ struct TableProperties;
 class GetContext;
 class InternalIterator;
 
+// Key looked up by TableReader::MultiGet, status is filled by the lookup.
+struct TableMultiGetKey {
+  Slice internal_key;
+  GetContext* get_context;
+  Status status;
+};
+
 // A Table is a sorted map from strings to strings.  Tables are
 // immutable and persistent.  A Table may be safely accessed from
 // multiple threads without external synchronization.
@@ -72,6 +82,13 @@ class TableReader {
   // be close to the file length.
   virtual uint64_t ApproximateOffsetOf(const Slice& key) = 0;
 
+  // Fills keys with up to max_keys internal keys that split the file into parts of approximately
+  // the same size, in increasing order. Used to find boundaries of subcompactions. Default
+  // implementation does not provide any keys.
+  virtual Status GetSplitKeys(size_t max_keys, std::vector<std::string>* keys) {
+    return Status::OK();
+  }
+
   // Set up the table for Compaction. Might change some parameters with
   // posix_fadvise
   virtual void SetupForCompaction() = 0;
@@ -98,6 +115,16 @@ class TableReader {
   virtual Status Get(const ReadOptions& readOptions, const Slice& internal_key,
                      GetContext* get_context, bool skip_filters = false) = 0;
 
+  // Looks up num_keys keys with the same semantics as Get, storing the result of each lookup
+  // in its status. Keys should be sorted in internal key order, so implementation could reuse
+  // index and data blocks between adjacent keys.
+  virtual void MultiGet(const ReadOptions& read_options, TableMultiGetKey* keys, size_t num_keys,
+                        bool skip_filters = false) {
+    for (size_t i = 0; i != num_keys; ++i) {
+      keys[i].status = Get(read_options, keys[i].internal_key, keys[i].get_context, skip_filters);
+    }
+  }
+
   // Prefetch data corresponding to a give range of keys
   // Typically this functionality is required for table implementations that
   // persists the data on a non volatile storage medium like disk/SSD
@@ -212,15 +212,12 @@ int SstFileReader::ShowAllCompressionSizes(size_t block_size) {
       std::make_pair(CompressionType::kLZ4Compression, "kLZ4Compression"));
   compress_type.insert(
       std::make_pair(CompressionType::kLZ4HCCompression, "kLZ4HCCompression"));
-  compress_type.insert(std::make_pair(CompressionType::kZSTDNotFinalCompression,
-                                      "kZSTDNotFinalCompression"));
+  compress_type.insert(std::make_pair(CompressionType::kZSTD, "kZSTD"));
 
   fprintf(stdout, "Block Size: %" ROCKSDB_PRIszt "\n", block_size);
 
-  for (CompressionType i = CompressionType::kNoCompression;
-       i <= CompressionType::kZSTDNotFinalCompression;
-       i = (i == kLZ4HCCompression) ? kZSTDNotFinalCompression
-                                    : CompressionType(i + 1)) {
+  for (const auto& type_and_name : compress_type) {
+    const CompressionType i = type_and_name.first;
     CompressionOptions compress_opt;
     TableBuilderOptions tb_opts(imoptions,
                                 ikc,
@@ -229,7 +226,7 @@ int SstFileReader::ShowAllCompressionSizes(size_t block_size) {
                                 compress_opt,
                                 false);
     uint64_t file_size = CalculateCompressedTableSize(tb_opts, block_size);
-    fprintf(stdout, "Compression: %s", compress_type.find(i)->second);
+    fprintf(stdout, "Compression: %s", type_and_name.second);
     fprintf(stdout, " Size: %" PRIu64 "\n", file_size);
   }
   return 0;
@@ -70,6 +70,7 @@ Arena::Arena(size_t block_size, size_t huge_page_size)
   aligned_alloc_ptr_ = inline_block_;
   unaligned_alloc_ptr_ = inline_block_ + alloc_bytes_remaining_;
 #ifdef MAP_HUGETLB
+  huge_page_size_ = huge_page_size;
   hugetlb_size_ = huge_page_size;
   if (hugetlb_size_ && kBlockSize > hugetlb_size_) {
     hugetlb_size_ = ((kBlockSize - 1U) / hugetlb_size_ + 1U) * hugetlb_size_;
@@ -110,7 +111,7 @@ char* Arena::AllocateFallback(size_t bytes, bool aligned) {
 #ifdef MAP_HUGETLB
   if (hugetlb_size_) {
     size = hugetlb_size_;
-    block_head = AllocateFromHugePage(size);
+    block_head = AllocateFromHugePage(size, huge_page_size_);
   }
 #endif
   if (!block_head) {
@@ -130,9 +131,46 @@ char* Arena::AllocateFallback(size_t bytes, bool aligned) {
   }
 }
 
-char* Arena::AllocateFromHugePage(size_t bytes) {
 #ifdef MAP_HUGETLB
-  if (hugetlb_size_ == 0) {
+namespace {
+
+// Maps anonymous memory aligned to the huge page size and advises the kernel to back it with
+// transparent huge pages. Used when there are no reserved huge pages for MAP_HUGETLB.
+void* MapTransparentHugePages(size_t bytes, size_t huge_page_size) {
+#ifdef MADV_HUGEPAGE
+  if ((huge_page_size & (huge_page_size - 1)) != 0) {
+    return nullptr;
+  }
+  // Map one more huge page, so the aligned range fits in, then unmap the extra head and tail.
+  const size_t mapped_bytes = bytes + huge_page_size;
+  void* addr = mmap(nullptr, mapped_bytes, (PROT_READ | PROT_WRITE),
+                    (MAP_PRIVATE | MAP_ANONYMOUS), -1, 0);
+  if (addr == MAP_FAILED) {
+    return nullptr;
+  }
+  const auto start = reinterpret_cast<uintptr_t>(addr);
+  const auto aligned_start = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+  const auto aligned_end = aligned_start + bytes;
+  if (aligned_start != start) {
+    munmap(addr, aligned_start - start);
+  }
+  if (aligned_end != start + mapped_bytes) {
+    munmap(reinterpret_cast<void*>(aligned_end), start + mapped_bytes - aligned_end);
+  }
+  // Failure is not fatal, the memory is then backed by regular pages.
+  madvise(reinterpret_cast<void*>(aligned_start), bytes, MADV_HUGEPAGE);
+  return reinterpret_cast<void*>(aligned_start);
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace
+#endif  // MAP_HUGETLB
+
+char* Arena::AllocateFromHugePage(size_t bytes, size_t huge_page_size) {
+#ifdef MAP_HUGETLB
+  if (huge_page_size == 0) {
     return nullptr;
   }
   // already reserve space in huge_blocks_ before calling mmap().
@@ -145,10 +183,14 @@ char* Arena::AllocateFromHugePage(size_t bytes) {
                     (MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB), 0, 0);
 
   if (addr == MAP_FAILED) {
-    return nullptr;
+    addr = MapTransparentHugePages(bytes, huge_page_size);
+    if (addr == nullptr) {
+      return nullptr;
+    }
   }
   // the following shouldn't throw because of the above reserve()
   huge_blocks_.emplace_back(MmapInfo(addr, bytes));
+  Consumed(bytes);
   return reinterpret_cast<char*>(addr);
 #else
   return nullptr;
@@ -168,7 +210,7 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
         ((bytes - 1U) / huge_page_size + 1U) * huge_page_size;
     assert(reserved_size >= bytes);
 
-    char* addr = AllocateFromHugePage(reserved_size);
+    char* addr = AllocateFromHugePage(reserved_size, huge_page_size);
     if (addr == nullptr) {
       RWARN(logger, "AllocateAligned fail to allocate huge TLB pages: %s",
            strerror(errno));
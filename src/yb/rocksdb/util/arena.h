@@ -62,7 +62,9 @@ class Arena : public Allocator {
 
   // huge_page_size: if 0, don't use huge page TLB. If > 0 (should set to the
   // supported hugepage size of the system), block allocation will try huge
-  // page TLB first. If allocation fails, will fall back to normal case.
+  // page TLB first, then transparent huge pages. If allocation fails, will
+  // fall back to normal case. Blocks allocated from huge pages are accounted
+  // in MemoryAllocatedBytes() and the mem tracker as well.
   explicit Arena(size_t block_size = kMinBlockSize, size_t huge_page_size = 0);
   ~Arena();
 
@@ -133,9 +135,13 @@ class Arena : public Allocator {
   size_t alloc_bytes_remaining_ = 0;
 
 #ifdef MAP_HUGETLB
+  // Size of blocks allocated from huge pages, a multiple of huge_page_size_.
   size_t hugetlb_size_ = 0;
+  size_t huge_page_size_ = 0;
 #endif  // MAP_HUGETLB
-  char* AllocateFromHugePage(size_t bytes);
+  // Allocates bytes, a multiple of huge_page_size, from the reserved huge page pool, falling back
+  // to transparent huge pages. Returns nullptr when both are unavailable.
+  char* AllocateFromHugePage(size_t bytes, size_t huge_page_size);
   char* AllocateFallback(size_t bytes, bool aligned);
   char* AllocateNewBlock(size_t block_bytes);
 
@@ -25,6 +25,8 @@
 #include "yb/rocksdb/util/random.h"
 #include "yb/rocksdb/util/testharness.h"
 
+#include "yb/util/mem_tracker.h"
+
 namespace rocksdb {
 
 namespace {
@@ -203,6 +205,30 @@ TEST_F(ArenaTest, Simple) {
   SimpleTest(0);
   SimpleTest(kHugePageSize);
 }
+
+// Blocks allocated from huge pages, reserved or transparent, are aligned to the huge page size
+// and accounted by the mem tracker.
+TEST_F(ArenaTest, HugePageMemTracker) {
+  auto mem_tracker = yb::MemTracker::CreateTracker("HugePageArena");
+  {
+    Arena arena(Arena::kMinBlockSize, kHugePageSize);
+    arena.SetMemTracker(mem_tracker);
+    const size_t kEntrySize = Arena::kMinBlockSize / 8;
+    // Fill the inline block, so the next allocation starts a new block.
+    arena.AllocateAligned(Arena::kInlineSize);
+    char* block = arena.AllocateAligned(kEntrySize);
+    memset(block, 1, kEntrySize);
+    ASSERT_EQ(arena.MemoryAllocatedBytes(), mem_tracker->consumption());
+    if (arena.MemoryAllocatedBytes() == kHugePageSize + Arena::kInlineSize) {
+      ASSERT_EQ(0, reinterpret_cast<uintptr_t>(block) % kHugePageSize);
+    }
+    for (int i = 0; i != 10000; ++i) {
+      memset(arena.Allocate(kEntrySize), 2, kEntrySize);
+    }
+    ASSERT_EQ(arena.MemoryAllocatedBytes(), mem_tracker->consumption());
+  }
+  ASSERT_EQ(0, mem_tracker->consumption());
+}
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
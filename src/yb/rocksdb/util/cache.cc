@@ -78,6 +78,8 @@ namespace {
 // that are accessed multiple times by different queries.
 // query_id == kNoCacheQueryId means that this Handle is not going to be added
 // into the cache.
+// query_id == kScanQueryId means that this Handle was added by a scan. It is put to the oldest
+// end of the single touch LRU, and lookups by scans do not move it to the multi touch cache.
 
 struct LRUHandle {
   void* value;
@@ -92,6 +94,7 @@ struct LRUHandle {
   bool in_cache;      // true, if this entry is referenced by the hash table
   uint32_t hash;      // Hash of key(); used for fast sharding and comparisons
   QueryId query_id;  // Query id that added the value to the cache.
+  bool evicted;       // true, if this entry was dropped to keep the cache within its capacity
   char key_data[1];   // Beginning of key
 
   Slice key() const {
@@ -104,8 +107,12 @@ struct LRUHandle {
     }
   }
 
-  void Free(yb::CacheMetrics* metrics) {
+  void Free(yb::CacheMetrics* metrics,
+            const Cache::EvictionCallback* eviction_callback = nullptr) {
     assert((refs == 1 && in_cache) || (refs == 0 && !in_cache));
+    if (evicted && eviction_callback != nullptr) {
+      (*eviction_callback)(key(), value, deleter);
+    }
     (*deleter)(key(), value);
     if (metrics != nullptr) {
       if (GetSubCacheType() == MULTI_TOUCH) {
@@ -170,7 +177,8 @@ class HandleTable {
     }
 
     LRUHandle* val = Lookup(h->key(), h->hash);
-    if (val != nullptr && (val->GetSubCacheType() == MULTI_TOUCH || val->query_id != h->query_id)) {
+    if (val != nullptr && h->query_id != kScanQueryId &&
+        (val->GetSubCacheType() == MULTI_TOUCH || val->query_id != h->query_id)) {
       h->query_id = kInMultiTouchId;
       return MULTI_TOUCH;
     }
@@ -305,6 +313,8 @@ class LRUSubCache {
 
   void LRU_Remove(LRUHandle* e);
   void LRU_Append(LRUHandle *e);
+  // Adds the handle as the oldest entry, so it is the first one to be evicted.
+  void LRU_Prepend(LRUHandle *e);
 
  private:
   // Dummy heads of single-touch and multi-touch LRU list.
@@ -352,6 +362,16 @@ void LRUSubCache::LRU_Append(LRUHandle *e) {
   lru_usage_ += e->charge;
 }
 
+void LRUSubCache::LRU_Prepend(LRUHandle *e) {
+  assert(e->next == nullptr);
+  assert(e->prev == nullptr);
+  e->prev = &lru_;
+  e->next = lru_.next;
+  e->prev->next = e;
+  e->next->prev = e;
+  lru_usage_ += e->charge;
+}
+
 // A single shard of sharded cache.
 class LRUCache {
  public:
@@ -369,6 +389,11 @@ class LRUCache {
     table_.SetMetrics(metrics);
   }
 
+  void SetEvictionCallback(std::shared_ptr<const Cache::EvictionCallback> eviction_callback) {
+    MutexLock l(&mutex_);
+    eviction_callback_ = std::move(eviction_callback);
+  }
+
   // Set the flag to reject insertion if cache if full.
   void SetStrictCapacityLimit(bool strict_capacity_limit);
 
@@ -430,6 +455,9 @@ class LRUCache {
 
   HandleTable table_;
 
+  // Invoked for entries dropped by EvictFromLRU, protected by mutex_.
+  std::shared_ptr<const Cache::EvictionCallback> eviction_callback_;
+
   shared_ptr<yb::CacheMetrics> metrics_;
 };
 
@@ -477,6 +505,11 @@ void LRUCache::LRU_Remove(LRUHandle* e) {
 }
 
 void LRUCache::LRU_Append(LRUHandle* e) {
+  if (e->query_id == kScanQueryId) {
+    // Values read by scans have low priority, so they are evicted before other values.
+    GetSubCache(e->GetSubCacheType())->LRU_Prepend(e);
+    return;
+  }
   // Make "e" newest entry by inserting just before lru_
   GetSubCache(e->GetSubCacheType())->LRU_Append(e);
 }
@@ -492,6 +525,7 @@ void LRUCache::EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
     sub_cache->LRU_Remove(old);
     table_.Remove(old->key(), old->hash);
     old->in_cache = false;
+    old->evicted = true;
     Unref(old);
     sub_cache->DecrementUsage(old->charge);
     deleted->push_back(old);
@@ -500,6 +534,7 @@ void LRUCache::EvictFromLRU(size_t charge, autovector<LRUHandle*>* deleted,
 
 void LRUCache::SetCapacity(size_t capacity) {
   autovector<LRUHandle*> last_reference_list;
+  std::shared_ptr<const Cache::EvictionCallback> eviction_callback;
   {
     MutexLock l(&mutex_);
     single_touch_sub_cache_.SetCapacity(
@@ -507,11 +542,14 @@ void LRUCache::SetCapacity(size_t capacity) {
     multi_touch_sub_cache_.SetCapacity(capacity - single_touch_sub_cache_.Capacity());
     EvictFromLRU(0, &last_reference_list, SINGLE_TOUCH);
     EvictFromLRU(0, &last_reference_list, MULTI_TOUCH);
+    if (!last_reference_list.empty()) {
+      eviction_callback = eviction_callback_;
+    }
   }
   // we free the entries here outside of mutex for
   // performance reasons
   for (auto entry : last_reference_list) {
-    entry->Free(metrics_.get());
+    entry->Free(metrics_.get(), eviction_callback.get());
   }
 }
 
@@ -522,66 +560,76 @@ void LRUCache::SetStrictCapacityLimit(bool strict_capacity_limit) {
 
 Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash, const QueryId query_id,
                                 Statistics* statistics)  {
-  MutexLock l(&mutex_);
-  LRUHandle* e = table_.Lookup(key, hash);
-  if (e != nullptr) {
-    assert(e->in_cache);
-    // Since the entry is now referenced externally, cannot be evicted, so remove from LRU.
-    if (e->refs == 1) {
-      LRU_Remove(e);
-    }
-    // Increase the number of references and move to state 1. (in cache and not in LRU)
-    e->refs++;
-
-    // Now the handle will be added to the multi touch pool only if it exists.
-    if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
-        e->query_id != query_id) {
-      autovector<LRUHandle*> multi_touch_eviction_list;
-      EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
-      for (auto entry : multi_touch_eviction_list) {
-        entry->Free(metrics_.get());
+  LRUHandle* e;
+  autovector<LRUHandle*> multi_touch_eviction_list;
+  std::shared_ptr<const Cache::EvictionCallback> eviction_callback;
+  {
+    MutexLock l(&mutex_);
+    e = table_.Lookup(key, hash);
+    if (e != nullptr) {
+      assert(e->in_cache);
+      // Since the entry is now referenced externally, cannot be evicted, so remove from LRU.
+      if (e->refs == 1) {
+        LRU_Remove(e);
       }
-      // Cannot have any single touch elements in this case.
-      assert(FLAGS_cache_single_touch_ratio != 0);
-      if (!strict_capacity_limit_ ||
-          multi_touch_sub_cache_.Usage() - multi_touch_sub_cache_.LRU_Usage() + e->charge <=
-          multi_touch_sub_cache_.Capacity()) {
-        e->query_id = kInMultiTouchId;
-        single_touch_sub_cache_.DecrementUsage(e->charge);
-        multi_touch_sub_cache_.IncrementUsage(e->charge);
-       if (metrics_) {
-         metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
-         metrics_->single_touch_cache_usage->DecrementBy(e->charge);
-       }
+      // Increase the number of references and move to state 1. (in cache and not in LRU)
+      e->refs++;
+
+      // Now the handle will be added to the multi touch pool only if it exists.
+      if (FLAGS_cache_single_touch_ratio < 1 && e->GetSubCacheType() != MULTI_TOUCH &&
+          e->query_id != query_id && query_id != kScanQueryId) {
+        EvictFromLRU(e->charge, &multi_touch_eviction_list, MULTI_TOUCH);
+        if (!multi_touch_eviction_list.empty()) {
+          eviction_callback = eviction_callback_;
+        }
+        // Cannot have any single touch elements in this case.
+        assert(FLAGS_cache_single_touch_ratio != 0);
+        if (!strict_capacity_limit_ ||
+            multi_touch_sub_cache_.Usage() - multi_touch_sub_cache_.LRU_Usage() + e->charge <=
+            multi_touch_sub_cache_.Capacity()) {
+          e->query_id = kInMultiTouchId;
+          single_touch_sub_cache_.DecrementUsage(e->charge);
+          multi_touch_sub_cache_.IncrementUsage(e->charge);
+         if (metrics_) {
+           metrics_->multi_touch_cache_usage->IncrementBy(e->charge);
+           metrics_->single_touch_cache_usage->DecrementBy(e->charge);
+         }
+        }
       }
-    }
-    if (statistics != nullptr) {
-      // overall cache hit
-      RecordTick(statistics, BLOCK_CACHE_HIT);
-      // total bytes read from cache
-      RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
-      if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
-        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
-        RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
-      } else if (e->GetSubCacheType() == SubCacheType::MULTI_TOUCH) {
-        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
-        RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+      if (statistics != nullptr) {
+        // overall cache hit
+        RecordTick(statistics, BLOCK_CACHE_HIT);
+        // total bytes read from cache
+        RecordTick(statistics, BLOCK_CACHE_BYTES_READ, e->charge);
+        if (e->GetSubCacheType() == SubCacheType::SINGLE_TOUCH) {
+          RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_HIT);
+          RecordTick(statistics, BLOCK_CACHE_SINGLE_TOUCH_BYTES_READ, e->charge);
+        } else if (e->GetSubCacheType() == SubCacheType::MULTI_TOUCH) {
+          RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_HIT);
+          RecordTick(statistics, BLOCK_CACHE_MULTI_TOUCH_BYTES_READ, e->charge);
+        }
+      }
+    } else {
+      if (statistics != nullptr) {
+        RecordTick(statistics, BLOCK_CACHE_MISS);
       }
     }
-  } else {
-    if (statistics != nullptr) {
-      RecordTick(statistics, BLOCK_CACHE_MISS);
+
+    if (metrics_ != nullptr) {
+      metrics_->lookups->Increment();
+      bool was_hit = (e != nullptr);
+      if (was_hit) {
+        metrics_->cache_hits->Increment();
+      } else {
+        metrics_->cache_misses->Increment();
+      }
     }
   }
 
-  if (metrics_ != nullptr) {
-    metrics_->lookups->Increment();
-    bool was_hit = (e != nullptr);
-    if (was_hit) {
-      metrics_->cache_hits->Increment();
-    } else {
-      metrics_->cache_misses->Increment();
-    }
+  // Free the evicted entries outside of mutex, so that the eviction callback does not block other
+  // accesses to this shard.
+  for (auto entry : multi_touch_eviction_list) {
+    entry->Free(metrics_.get(), eviction_callback.get());
   }
   return reinterpret_cast<Cache::Handle*>(e);
 }
@@ -592,6 +640,7 @@ void LRUCache::Release(Cache::Handle* handle) {
   }
   LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
   bool last_reference = false;
+  std::shared_ptr<const Cache::EvictionCallback> eviction_callback;
   {
     MutexLock l(&mutex_);
     LRUSubCache* sub_cache = GetSubCache(e->GetSubCacheType());
@@ -607,9 +656,11 @@ void LRUCache::Release(Cache::Handle* handle) {
         // take this opportunity and remove the item
         table_.Remove(e->key(), e->hash);
         e->in_cache = false;
+        e->evicted = true;
         Unref(e);
         sub_cache->DecrementUsage(e->charge);
         last_reference = true;
+        eviction_callback = eviction_callback_;
       } else {
         // put the item on the list to be potentially freed.
         LRU_Append(e);
@@ -619,7 +670,7 @@ void LRUCache::Release(Cache::Handle* handle) {
 
   // free outside of mutex
   if (last_reference) {
-    e->Free(metrics_.get());
+    e->Free(metrics_.get(), eviction_callback.get());
   }
 }
 
@@ -637,6 +688,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
                     new char[sizeof(LRUHandle) - 1 + key.size()]);
   Status s;
   autovector<LRUHandle*> last_reference_list;
+  std::shared_ptr<const Cache::EvictionCallback> eviction_callback;
 
   e->value = value;
   e->deleter = deleter;
@@ -650,6 +702,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   e->in_cache = true;
   // Adding query id to the handle.
   e->query_id = query_id;
+  e->evicted = false;
   memcpy(e->key_data, key.data(), key.size());
 
   {
@@ -663,11 +716,17 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
       subcache_type = MULTI_TOUCH;
     } else if (FLAGS_cache_single_touch_ratio == 1) {
       // If there is no multi touch cache, default to single cache.
+      if (e->query_id == kInMultiTouchId) {
+        e->query_id = kDefaultQueryId;
+      }
       subcache_type = SINGLE_TOUCH;
     } else {
       subcache_type = table_.GetSubCacheTypeCandidate(e);
     }
     EvictFromLRU(charge, &last_reference_list, subcache_type);
+    if (!last_reference_list.empty()) {
+      eviction_callback = eviction_callback_;
+    }
     LRUSubCache* sub_cache = GetSubCache(subcache_type);
     // If the cache no longer has any more space in the given pool.
     if (strict_capacity_limit_ &&
@@ -732,7 +791,7 @@ Status LRUCache::Insert(const Slice& key, uint32_t hash, const QueryId query_id,
   // we free the entries here outside of mutex for
   // performance reasons
   for (auto entry : last_reference_list) {
-    entry->Free(metrics_.get());
+    entry->Free(metrics_.get(), eviction_callback.get());
   }
 
   return s;
@@ -785,7 +844,8 @@ class ShardedLRUCache : public Cache {
   }
 
   bool IsValidQueryId(const QueryId query_id) {
-    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId;
+    return query_id >= 0 || query_id == kInMultiTouchId || query_id == kNoCacheQueryId ||
+           query_id == kScanQueryId;
   }
 
  public:
@@ -921,6 +981,17 @@ class ShardedLRUCache : public Cache {
       shards_[s].SetMetrics(metrics_);
     }
   }
+
+  void SetEvictionCallback(EvictionCallback eviction_callback) override {
+    std::shared_ptr<const EvictionCallback> shared_callback;
+    if (eviction_callback) {
+      shared_callback = std::make_shared<const EvictionCallback>(std::move(eviction_callback));
+    }
+    int num_shards = 1 << num_shard_bits_;
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].SetEvictionCallback(shared_callback);
+    }
+  }
 };
 
 }  // end anonymous namespace
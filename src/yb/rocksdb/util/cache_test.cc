@@ -23,6 +23,7 @@
 
 #include "yb/rocksdb/cache.h"
 
+#include <algorithm>
 #include <forward_list>
 #include <vector>
 #include <string>
@@ -463,6 +464,29 @@ TEST_F(CacheTest, EvictionPolicyMultiTouch) {
   ASSERT_LT(kCacheSize * FLAGS_cache_single_touch_ratio, cache_->GetUsage());
 }
 
+TEST_F(CacheTest, EvictionPolicyScan) {
+  const int kCapacity = 100;
+  auto cache = NewLRUCache(kCapacity, 0, true);
+  const int kNumEntries = kCapacity * FLAGS_cache_single_touch_ratio / 2;
+  for (int i = 0; i < kNumEntries; i++) {
+    ASSERT_OK(Insert(cache, i, i + 1, 1, kTestQueryId));
+  }
+
+  // Entries added by a scan are evicted first, so they do not evict entries added by other reads.
+  for (int i = 0; i < kCapacity * 10; i++) {
+    ASSERT_OK(Insert(cache, 1000 + i, 2000 + i, 1, kScanQueryId));
+  }
+  for (int i = 0; i < kNumEntries; i++) {
+    ASSERT_EQ(i + 1, Lookup(cache, i, kTestQueryId));
+  }
+  ASSERT_EQ(2000 + kCapacity * 10 - 1, Lookup(cache, 1000 + kCapacity * 10 - 1, kScanQueryId));
+
+  // Lookup done by a scan does not move entry to multi touch cache.
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 0, 1, kScanQueryId));
+  ASSERT_FALSE(LookupAndCheckInMultiTouch(cache, 0, 1, kTestQueryId));
+  ASSERT_TRUE(LookupAndCheckInMultiTouch(cache, 0, 1, kTestQueryId + 1));
+}
+
 TEST_F(CacheTest, HeavyEntries) {
   // Add a bunch of light and heavy entries and then count the combined
   // size of items still in the cache, which must be approximately the
@@ -490,6 +514,38 @@ TEST_F(CacheTest, HeavyEntries) {
   ASSERT_LE(cached_weight, kCacheSize + kCacheSize/10);
 }
 
+TEST_F(CacheTest, EvictionCallback) {
+  std::vector<int> evicted_keys;
+  cache_->SetEvictionCallback(
+      [&evicted_keys](const Slice& key, void* value, void (*deleter)(const Slice&, void*)) {
+        ASSERT_EQ(&CacheTest::Deleter, deleter);
+        ASSERT_EQ(DecodeKey(key) + 1, DecodeValue(value));
+        evicted_keys.push_back(DecodeKey(key));
+      });
+
+  Insert(100, 101);
+  Insert(200, 201);
+  // Erased and replaced entries are not reported as evicted.
+  Erase(100);
+  Insert(200, 201);
+  ASSERT_TRUE(evicted_keys.empty());
+  ASSERT_EQ(2U, deleted_keys_.size());
+
+  for (int i = 0; i < kCacheSize + 100; i++) {
+    Insert(1000 + i, 1001 + i);
+  }
+  ASSERT_EQ(-1, Lookup(200));
+  ASSERT_NE(evicted_keys.end(), std::find(evicted_keys.begin(), evicted_keys.end(), 200));
+  // Every evicted entry is deleted after the callback.
+  ASSERT_EQ(2U + evicted_keys.size(), deleted_keys_.size());
+
+  // An empty callback disables notifications.
+  cache_->SetEvictionCallback(nullptr);
+  const size_t num_evicted = evicted_keys.size();
+  Insert(5000, 5001);
+  ASSERT_EQ(num_evicted, evicted_keys.size());
+}
+
 TEST_F(CacheTest, NewId) {
   uint64_t a = cache_->NewId();
   uint64_t b = cache_->NewId();
@@ -25,7 +25,9 @@
 
 #include <algorithm>
 #include <limits>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "yb/rocksdb/options.h"
 #include "yb/rocksdb/util/coding.h"
@@ -49,6 +51,7 @@
 
 #if defined(ZSTD)
 #include <zstd.h>
+#include <zdict.h>
 #endif
 
 namespace rocksdb {
@@ -102,6 +105,7 @@ inline bool CompressionTypeSupported(CompressionType compression_type) {
       return LZ4_Supported();
     case kLZ4HCCompression:
       return LZ4_Supported();
+    case kZSTD:
     case kZSTDNotFinalCompression:
       return ZSTD_Supported();
     default:
@@ -124,8 +128,12 @@ inline std::string CompressionTypeToString(CompressionType compression_type) {
       return "LZ4";
     case kLZ4HCCompression:
       return "LZ4HC";
-    case kZSTDNotFinalCompression:
+    case kZSTD:
       return "ZSTD";
+    case kZSTDNotFinalCompression:
+      return "ZSTDNotFinal";
+    case kDisableCompressionOption:
+      return "DisableOption";
     default:
       assert(false);
       return "";
@@ -620,8 +628,102 @@ inline bool LZ4HC_Compress(const CompressionOptions& opts,
   return false;
 }
 
+// Level used for kZSTD, when compression level is not specified in CompressionOptions.
+constexpr int kZSTDDefaultCompressionLevel = 3;
+
+inline int ZSTD_CompressionLevel(const CompressionOptions& opts) {
+  return opts.level < 0 ? kZSTDDefaultCompressionLevel : opts.level;
+}
+
+// Dictionary used to compress data blocks of a single SST file, see
+// CompressionOptions::max_dict_bytes. Digested form of the dictionary is prepared once and then
+// reused for all blocks.
+class CompressionDict {
+ public:
+  CompressionDict(std::string dict, const CompressionOptions& opts) : dict_(std::move(dict)) {
+#ifdef ZSTD
+    zstd_cdict_ = ZSTD_createCDict(dict_.data(), dict_.size(), ZSTD_CompressionLevel(opts));
+#endif
+  }
+
+  ~CompressionDict() {
+#ifdef ZSTD
+    ZSTD_freeCDict(zstd_cdict_);
+#endif
+  }
+
+  CompressionDict(const CompressionDict&) = delete;
+  void operator=(const CompressionDict&) = delete;
+
+  const std::string& raw() const { return dict_; }
+
+#ifdef ZSTD
+  const ZSTD_CDict* zstd_cdict() const { return zstd_cdict_; }
+#endif
+
+ private:
+  std::string dict_;
+#ifdef ZSTD
+  ZSTD_CDict* zstd_cdict_ = nullptr;
+#endif
+};
+
+// Dictionary used to uncompress data blocks of a single SST file. It is shared by all readers of
+// the file.
+class UncompressionDict {
+ public:
+  explicit UncompressionDict(std::string dict) : dict_(std::move(dict)) {
+#ifdef ZSTD
+    zstd_ddict_ = ZSTD_createDDict(dict_.data(), dict_.size());
+#endif
+  }
+
+  ~UncompressionDict() {
+#ifdef ZSTD
+    ZSTD_freeDDict(zstd_ddict_);
+#endif
+  }
+
+  UncompressionDict(const UncompressionDict&) = delete;
+  void operator=(const UncompressionDict&) = delete;
+
+  const std::string& raw() const { return dict_; }
+
+#ifdef ZSTD
+  const ZSTD_DDict* zstd_ddict() const { return zstd_ddict_; }
+#endif
+
+ private:
+  std::string dict_;
+#ifdef ZSTD
+  ZSTD_DDict* zstd_ddict_ = nullptr;
+#endif
+};
+
+// Trains a dictionary of at most max_dict_bytes on the samples concatenated in samples, sizes of
+// individual samples are specified by sample_sizes.
+// Returns empty string when the dictionary could not be trained, e.g. there is too few samples.
+inline std::string ZSTD_TrainDictionary(const std::string& samples,
+                                        const std::vector<size_t>& sample_sizes,
+                                        size_t max_dict_bytes) {
+#ifdef ZSTD
+  std::string dict(max_dict_bytes, '\0');
+  size_t dict_size = ZDICT_trainFromBuffer(
+      &dict[0], max_dict_bytes, samples.data(), sample_sizes.data(),
+      static_cast<unsigned>(sample_sizes.size()));
+  if (ZDICT_isError(dict_size)) {
+    return std::string();
+  }
+  dict.resize(dict_size);
+  return dict;
+#endif
+  return std::string();
+}
+
+// Used for both kZSTD and kZSTDNotFinalCompression, they have the same block format.
 inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
-                          size_t length, ::std::string* output) {
+                          size_t length, ::std::string* output,
+                          const CompressionDict* dict = nullptr) {
 #ifdef ZSTD
   if (length > std::numeric_limits<uint32_t>::max()) {
     // Can't compress more than 4GB
@@ -633,9 +735,17 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 
   size_t compressBound = ZSTD_compressBound(length);
   output->resize(static_cast<size_t>(output_header_len + compressBound));
-  size_t outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
-                                input, length, opts.level);
-  if (outlen == 0) {
+  size_t outlen;
+  if (dict != nullptr && dict->zstd_cdict() != nullptr) {
+    ZSTD_CCtx* context = ZSTD_createCCtx();
+    outlen = ZSTD_compress_usingCDict(context, &(*output)[output_header_len], compressBound,
+                                      input, length, dict->zstd_cdict());
+    ZSTD_freeCCtx(context);
+  } else {
+    outlen = ZSTD_compress(&(*output)[output_header_len], compressBound,
+                           input, length, ZSTD_CompressionLevel(opts));
+  }
+  if (outlen == 0 || ZSTD_isError(outlen)) {
     return false;
   }
   output->resize(output_header_len + outlen);
@@ -645,7 +755,7 @@ inline bool ZSTD_Compress(const CompressionOptions& opts, const char* input,
 }
 
 inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
-                             int* decompress_size) {
+                             int* decompress_size, const UncompressionDict* dict = nullptr) {
 #ifdef ZSTD
   uint32_t output_len = 0;
   if (!compression::GetDecompressedSizeInfo(&input_data, &input_length,
@@ -653,12 +763,21 @@ inline char* ZSTD_Uncompress(const char* input_data, size_t input_length,
     return nullptr;
   }
 
-  char* output = new char[output_len];
-  size_t actual_output_length =
-      ZSTD_decompress(output, output_len, input_data, input_length);
-  assert(actual_output_length == output_len);
+  std::unique_ptr<char[]> output(new char[output_len]);
+  size_t actual_output_length;
+  if (dict != nullptr && dict->zstd_ddict() != nullptr) {
+    ZSTD_DCtx* context = ZSTD_createDCtx();
+    actual_output_length = ZSTD_decompress_usingDDict(
+        context, output.get(), output_len, input_data, input_length, dict->zstd_ddict());
+    ZSTD_freeDCtx(context);
+  } else {
+    actual_output_length = ZSTD_decompress(output.get(), output_len, input_data, input_length);
+  }
+  if (ZSTD_isError(actual_output_length) || actual_output_length != output_len) {
+    return nullptr;
+  }
   *decompress_size = static_cast<int>(actual_output_length);
-  return output;
+  return output.release();
 #endif
   return nullptr;
 }
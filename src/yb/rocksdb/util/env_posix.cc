@@ -577,6 +577,16 @@ class PosixEnv : public Env {
 };
 
 class PosixRocksDBFileFactory : public RocksDBFileFactory {
+ private:
+  // Returns the flag for open() that bypasses the OS page cache when direct I/O is requested.
+  static int DirectIOFlag(bool use_direct_io) {
+#ifdef OS_LINUX
+    return use_direct_io ? O_DIRECT : 0;
+#else
+    return 0;
+#endif
+  }
+
  public:
   PosixRocksDBFileFactory() {}
 
@@ -610,12 +620,12 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     int fd;
     {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_RDONLY);
+      fd = open(fname.c_str(), O_RDONLY | DirectIOFlag(options.use_direct_reads));
     }
     SetFD_CLOEXEC(fd, &options);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
-    } else if (options.use_mmap_reads && sizeof(void*) >= 8) {
+    } else if (options.use_mmap_reads && !options.use_direct_reads && sizeof(void*) >= 8) {
       // Use of mmap for random reads has been removed because it
       // kills performance when storage is fast.
       // Use mmap when virtual address-space is plentiful.
@@ -644,7 +654,8 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     int fd = -1;
     do {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+      fd = open(fname.c_str(), O_CREAT | O_RDWR | O_TRUNC | DirectIOFlag(options.use_direct_writes),
+                0644);
     } while (fd < 0 && errno == EINTR);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
@@ -660,7 +671,7 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
           checkedDiskForMmap_ = true;
         }
       }
-      if (options.use_mmap_writes && !forceMmapOff) {
+      if (options.use_mmap_writes && !options.use_direct_writes && !forceMmapOff) {
         *result = std::make_unique<PosixMmapFile>(fname, fd, page_size_, options);
       } else {
         // disable mmap writes
@@ -681,7 +692,7 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
     int fd = -1;
     do {
       IOSTATS_TIMER_GUARD(open_nanos);
-      fd = open(old_fname.c_str(), O_RDWR, 0644);
+      fd = open(old_fname.c_str(), O_RDWR | DirectIOFlag(options.use_direct_writes), 0644);
     } while (fd < 0 && errno == EINTR);
     if (fd < 0) {
       s = STATUS_IO_ERROR(fname, errno);
@@ -703,7 +714,7 @@ class PosixRocksDBFileFactory : public RocksDBFileFactory {
           checkedDiskForMmap_ = true;
         }
       }
-      if (options.use_mmap_writes && !forceMmapOff) {
+      if (options.use_mmap_writes && !options.use_direct_writes && !forceMmapOff) {
         *result = std::make_unique<PosixMmapFile>(fname, fd, page_size_, options);
       } else {
         // disable mmap writes
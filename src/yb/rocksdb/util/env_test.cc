@@ -46,6 +46,7 @@
 #include "yb/rocksdb/env.h"
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/file_reader_writer.h"
 #include "yb/rocksdb/util/log_buffer.h"
 #include "yb/rocksdb/util/mutexlock.h"
 #include "yb/util/string_util.h"
@@ -808,6 +809,56 @@ TEST_F(EnvPosixTest, InvalidateCache) {
   // Delete the file
   ASSERT_OK(env_->DeleteFile(fname));
 }
+
+TEST_F(EnvPosixTest, DirectIO) {
+  EnvOptions soptions;
+  soptions.use_mmap_writes = false;
+  soptions.use_direct_writes = true;
+  soptions.use_direct_reads = true;
+  std::string fname = test::TmpDir() + "/" + "testfile";
+
+  unique_ptr<WritableFile> wfile;
+  Status s = env_->NewWritableFile(fname, &wfile, soptions);
+  if (!s.ok()) {
+    // Some file systems, for instance tmpfs, do not support O_DIRECT.
+    LOG(INFO) << "Skipping test, direct I/O is not supported: " << s.ToString();
+    return;
+  }
+  ASSERT_FALSE(wfile->UseOSBuffer());
+
+  // Write unaligned chunks, flushing in between, so the writer has to rewrite padded pages.
+  std::string data;
+  Random rnd(301);
+  {
+    WritableFileWriter writer(std::move(wfile), soptions);
+    for (size_t len : {100, 5000, 4096, 1}) {
+      std::string chunk = RandomString(&rnd, static_cast<int>(len));
+      ASSERT_OK(writer.Append(chunk));
+      ASSERT_OK(writer.Flush());
+      data += chunk;
+    }
+    ASSERT_OK(writer.Sync(false));
+    ASSERT_OK(writer.Close());
+  }
+
+  uint64_t file_size = 0;
+  ASSERT_OK(env_->GetFileSize(fname, &file_size));
+  ASSERT_EQ(data.size(), file_size);
+
+  unique_ptr<RandomAccessFile> file;
+  ASSERT_OK(env_->NewRandomAccessFile(fname, &file, soptions));
+  std::vector<char> scratch(data.size());
+  Slice result;
+  ASSERT_OK(file->Read(0, data.size(), &result, scratch.data()));
+  ASSERT_EQ(data, result.ToBuffer());
+  ASSERT_OK(file->Read(4000, 200, &result, scratch.data()));
+  ASSERT_EQ(data.substr(4000, 200), result.ToBuffer());
+  // Read that crosses the end of file returns the remaining data only.
+  ASSERT_OK(file->Read(data.size() - 10, 100, &result, scratch.data()));
+  ASSERT_EQ(data.substr(data.size() - 10), result.ToBuffer());
+
+  ASSERT_OK(env_->DeleteFile(fname));
+}
 #endif  // not TRAVIS
 #endif  // OS_LINUX
 
@@ -26,6 +26,8 @@
 #include <algorithm>
 #include <mutex>
 
+#include <gflags/gflags.h>
+
 #include "yb/rocksdb/port/port.h"
 #include "yb/rocksdb/util/histogram.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
@@ -33,6 +35,10 @@
 #include "yb/rocksdb/util/rate_limiter.h"
 #include "yb/rocksdb/util/sync_point.h"
 
+DEFINE_bool(rocksdb_async_sst_writes, false,
+            "Write SST files produced by flushes and compactions on the asynchronous I/O thread "
+            "pool, so the next block is built while the previous one is being written.");
+
 namespace rocksdb {
 
 Status SequentialFileReader::Read(size_t n, Slice* result, char* scratch) {
@@ -122,7 +128,10 @@ Status WritableFileWriter::Append(const Slice& data) {
   } else {
     // Writing directly to file bypassing the buffer
     assert(buf_.CurrentSize() == 0);
-    s = WriteBuffered(src, left);
+    s = WaitAsyncWrites();
+    if (s.ok()) {
+      s = WriteBuffered(src, left);
+    }
   }
 
   TEST_KILL_RANDOM("WritableFileWriter::Append:1", rocksdb_kill_odds);
@@ -146,10 +155,14 @@ Status WritableFileWriter::Close() {
   }
 
   s = Flush();  // flush cache to OS
+  Status interim = WaitAsyncWrites();
+  if (!interim.ok() && s.ok()) {
+    s = interim;
+  }
 
   // In unbuffered mode we write whole pages so
   // we need to let the file know where data ends.
-  Status interim = writable_file_->Truncate(filesize_);
+  interim = writable_file_->Truncate(filesize_);
   if (!interim.ok() && s.ok()) {
     s = interim;
   }
@@ -172,6 +185,11 @@ Status WritableFileWriter::Flush() {
   TEST_KILL_RANDOM("WritableFileWriter::Flush:0",
                    rocksdb_kill_odds * REDUCE_ODDS2);
 
+  if (async_queue_) {
+    // The flush of the OS buffer and the range sync are queued after the write.
+    return buf_.CurrentSize() > 0 ? WriteBufferedAsync() : async_queue_->status();
+  }
+
   if (buf_.CurrentSize() > 0) {
     if (use_os_buffer_) {
       s = WriteBuffered(buf_.BufferStart(), buf_.CurrentSize());
@@ -189,17 +207,26 @@ Status WritableFileWriter::Flush() {
     return s;
   }
 
-  // sync OS cache to disk for every bytes_per_sync_
-  // TODO: give log file and sst file different options (log
-  // files could be potentially cached in OS for their whole
-  // life time, thus we might not want to flush at all).
-
-  // We try to avoid sync to the last 1MB of data. For two reasons:
-  // (1) avoid rewrite the same page that is modified later.
-  // (2) for older version of OS, write can block while writing out
-  //     the page.
-  // Xfs does neighbor page flushing outside of the specified ranges. We
-  // need to make sure sync range is far from the write offset.
+  uint64_t sync_offset, sync_nbytes;
+  if (NextRangeSync(&sync_offset, &sync_nbytes)) {
+    s = RangeSync(sync_offset, sync_nbytes);
+  }
+
+  return s;
+}
+
+// sync OS cache to disk for every bytes_per_sync_
+// TODO: give log file and sst file different options (log
+// files could be potentially cached in OS for their whole
+// life time, thus we might not want to flush at all).
+
+// We try to avoid sync to the last 1MB of data. For two reasons:
+// (1) avoid rewrite the same page that is modified later.
+// (2) for older version of OS, write can block while writing out
+//     the page.
+// Xfs does neighbor page flushing outside of the specified ranges. We
+// need to make sure sync range is far from the write offset.
+bool WritableFileWriter::NextRangeSync(uint64_t* offset, uint64_t* nbytes) {
   if (!direct_io_ && bytes_per_sync_) {
     const uint64_t kBytesNotSyncRange = 1024 * 1024;  // recent 1MB is not synced.
     const uint64_t kBytesAlignWhenSync = 4 * 1024;    // Align 4KB.
@@ -209,17 +236,21 @@ Status WritableFileWriter::Flush() {
       assert(offset_sync_to >= last_sync_size_);
       if (offset_sync_to > 0 &&
           offset_sync_to - last_sync_size_ >= bytes_per_sync_) {
-        s = RangeSync(last_sync_size_, offset_sync_to - last_sync_size_);
+        *offset = last_sync_size_;
+        *nbytes = offset_sync_to - last_sync_size_;
         last_sync_size_ = offset_sync_to;
+        return true;
       }
     }
   }
-
-  return s;
+  return false;
 }
 
 Status WritableFileWriter::Sync(bool use_fsync) {
   Status s = Flush();
+  if (s.ok()) {
+    s = WaitAsyncWrites();
+  }
   if (!s.ok()) {
     return s;
   }
@@ -245,7 +276,10 @@ Status WritableFileWriter::SyncWithoutFlush(bool use_fsync) {
       "WritableFile::IsSyncThreadSafe() is false");
   }
   TEST_SYNC_POINT("WritableFileWriter::SyncWithoutFlush:1");
-  Status s = SyncInternal(use_fsync);
+  Status s = WaitAsyncWrites();
+  if (s.ok()) {
+    s = SyncInternal(use_fsync);
+  }
   TEST_SYNC_POINT("WritableFileWriter::SyncWithoutFlush:2");
   return s;
 }
@@ -317,6 +351,35 @@ Status WritableFileWriter::WriteBuffered(const char* data, size_t size) {
   return s;
 }
 
+Status WritableFileWriter::WriteBufferedAsync() {
+  // Only one buffer is written at a time, so the spare one is free after the wait.
+  RETURN_NOT_OK(WaitAsyncWrites());
+  std::swap(buf_, spare_buf_);
+  buf_.Size(0);
+
+  const char* data = spare_buf_.BufferStart();
+  const size_t size = spare_buf_.CurrentSize();
+  // Rate limiter tokens are taken here, so flushes and compactions are throttled as before.
+  for (size_t left = size; left > 0;) {
+    left -= RequestToken(left, false);
+  }
+  IOSTATS_ADD(bytes_written, size);
+
+  uint64_t sync_offset = 0, sync_nbytes = 0;
+  const bool range_sync = NextRangeSync(&sync_offset, &sync_nbytes);
+  WritableFile* file = writable_file_.get();
+  async_queue_->Submit([file, data, size, range_sync, sync_offset, sync_nbytes]() -> Status {
+    RETURN_NOT_OK(file->Append(Slice(data, size)));
+    RETURN_NOT_OK(file->Flush());
+    return range_sync ? file->RangeSync(sync_offset, sync_nbytes) : Status::OK();
+  });
+  return Status::OK();
+}
+
+Status WritableFileWriter::WaitAsyncWrites() {
+  return async_queue_ ? async_queue_->Wait() : Status::OK();
+}
+
 
 // This flushes the accumulated data in the buffer. We pad data with zeros if
 // necessary to the whole page.
@@ -464,6 +527,8 @@ class ReadaheadRandomAccessFile : public RandomAccessFile {
 
   void Hint(AccessPattern pattern) override { file_->Hint(pattern); }
 
+  Status Prefetch(uint64_t offset, size_t n) override { return file_->Prefetch(offset, n); }
+
   Status InvalidateCache(size_t offset, size_t length) override {
     return file_->InvalidateCache(offset, length);
   }
@@ -29,6 +29,7 @@
 #include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/statistics.h"
 #include "yb/rocksdb/port/port.h"
+#include "yb/util/async_io.h"
 
 namespace rocksdb {
 
@@ -103,6 +104,8 @@ class RandomAccessFileReader {
 
   Status Read(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
+  Status Prefetch(uint64_t offset, size_t n) { return file_->Prefetch(offset, n); }
+
   RandomAccessFile* file() { return file_.get(); }
 };
 
@@ -110,7 +113,12 @@ class RandomAccessFileReader {
 class WritableFileWriter {
  private:
   std::unique_ptr<WritableFile> writable_file_;
+  // Writes buffers in background when async writes are enabled. Declared after writable_file_, so
+  // it waits for the queued writes before the file is destroyed.
+  std::unique_ptr<yb::AsyncIoQueue> async_queue_;
   AlignedBuffer           buf_;
+  // Buffer being written by async_queue_.
+  AlignedBuffer           spare_buf_;
   size_t                  max_buffer_size_;
   // Actually written data size can be used for truncate
   // not counting padding data
@@ -145,6 +153,11 @@ class WritableFileWriter {
 
     buf_.Alignment(writable_file_->GetRequiredBufferAlignment());
     buf_.AllocateNewBuffer(65536);
+    if (options.async_writes && use_os_buffer_ && !direct_io_) {
+      async_queue_.reset(new yb::AsyncIoQueue());
+      spare_buf_.Alignment(buf_.Alignment());
+      spare_buf_.AllocateNewBuffer(buf_.Capacity());
+    }
   }
 
   WritableFileWriter(const WritableFileWriter&) = delete;
@@ -180,7 +193,13 @@ class WritableFileWriter {
   Status WriteUnbuffered();
   // Normal write
   Status WriteBuffered(const char* data, size_t size);
+  // Queues write of the buffer to async_queue_, and switches to the spare buffer.
+  Status WriteBufferedAsync();
+  // Waits for the writes queued by WriteBufferedAsync.
+  Status WaitAsyncWrites();
   Status RangeSync(uint64_t offset, uint64_t nbytes);
+  // Returns true if the range [*offset, *offset + *nbytes) should be synced after a flush.
+  bool NextRangeSync(uint64_t* offset, uint64_t* nbytes);
   size_t RequestToken(size_t bytes, bool align);
   Status SyncInternal(bool use_fsync);
 };
@@ -139,6 +139,46 @@ TEST_F(WritableFileWriterTest, AppendStatusReturn) {
   ASSERT_NOK(writer->Append(std::string(2 * kMb, 'b')));
 }
 
+TEST_F(WritableFileWriterTest, AsyncWrites) {
+  class FakeWF : public WritableFile {
+   public:
+    explicit FakeWF(std::string* content) : content_(content) {}
+
+    Status Append(const Slice& data) override {
+      content_->append(data.cdata(), data.size());
+      return Status::OK();
+    }
+    Status Close() override { return Status::OK(); }
+    Status Flush() override { return Status::OK(); }
+    Status Sync() override { return Status::OK(); }
+
+   protected:
+    std::string* content_;
+  };
+
+  std::string content;
+  EnvOptions env_options;
+  env_options.async_writes = true;
+  env_options.writable_file_max_buffer_size = kMb / 4;
+  unique_ptr<WritableFileWriter> writer(
+      new WritableFileWriter(unique_ptr<FakeWF>(new FakeWF(&content)), env_options));
+  Random r(301);
+  std::string expected;
+  for (int i = 0; i < 1000; i++) {
+    // Mostly small appends, that are buffered, and sometimes ones larger than the buffer.
+    size_t size = r.OneIn(50) ? kMb / 2 + r.Uniform(kMb) : r.Uniform(4096);
+    std::string piece(size, 'a' + i % 26);
+    ASSERT_OK(writer->Append(piece));
+    expected += piece;
+    if (r.OneIn(10)) {
+      ASSERT_OK(writer->Flush());
+    }
+  }
+  ASSERT_OK(writer->Close());
+  ASSERT_EQ(expected.size(), content.size());
+  ASSERT_TRUE(expected == content);
+}
+
 }  // namespace rocksdb
 
 int main(int argc, char** argv) {
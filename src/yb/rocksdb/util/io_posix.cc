@@ -42,6 +42,7 @@
 #endif
 #include "yb/rocksdb/port/port.h"
 #include "yb/util/slice.h"
+#include "yb/rocksdb/util/aligned_buffer.h"
 #include "yb/rocksdb/util/coding.h"
 #include "yb/rocksdb/util/iostats_context_imp.h"
 #include "yb/rocksdb/util/posix_logger.h"
@@ -155,14 +156,57 @@ static size_t GetUniqueIdFromFile(int fd, char* id, size_t max_size) {
  */
 PosixRandomAccessFile::PosixRandomAccessFile(const std::string& fname, int fd,
                                              const EnvOptions& options)
-    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer) {
+    : filename_(fname), fd_(fd), use_os_buffer_(options.use_os_buffer),
+      use_direct_io_(options.use_direct_reads) {
   assert(!options.use_mmap_reads || sizeof(void*) < 8);
 }
 
 PosixRandomAccessFile::~PosixRandomAccessFile() { close(fd_); }
 
+Status PosixRandomAccessFile::ReadDirect(uint64_t offset, size_t n, Slice* result,
+                                         char* scratch) const {
+  const size_t alignment = kDirectIOAlignment;
+  const uint64_t aligned_offset = TruncateToPageBoundary(alignment, offset);
+  const size_t offset_advance = offset - aligned_offset;
+  const size_t size = Roundup(offset_advance + n, alignment);
+
+  AlignedBuffer buf;
+  buf.Alignment(alignment);
+  buf.AllocateNewBuffer(size);
+
+  size_t read = 0;
+  while (read < size) {
+    ssize_t r = pread(fd_, buf.Destination(), size - read,
+                      static_cast<off_t>(aligned_offset + read));
+    if (r < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      *result = Slice();
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    if (r == 0) {
+      break;
+    }
+    read += r;
+    buf.Size(read);
+    // Only the last read could return less than requested, when it reaches the end of file.
+    if (read % alignment != 0) {
+      break;
+    }
+  }
+
+  size_t copied = read > offset_advance ? buf.Read(scratch, offset_advance, n) : 0;
+  *result = Slice(scratch, copied);
+  return Status::OK();
+}
+
 Status PosixRandomAccessFile::Read(uint64_t offset, size_t n, Slice* result,
                                    char* scratch) const {
+  if (use_direct_io_) {
+    return ReadDirect(offset, n, result, scratch);
+  }
+
   Status s;
   ssize_t r = -1;
   size_t left = n;
@@ -223,6 +267,22 @@ void PosixRandomAccessFile::Hint(AccessPattern pattern) {
   }
 }
 
+Status PosixRandomAccessFile::Prefetch(uint64_t offset, size_t n) {
+#ifndef OS_LINUX
+  return Status::OK();
+#else
+  if (use_direct_io_) {
+    // Reads bypass the OS page cache, so there is nowhere to prefetch to.
+    return Status::OK();
+  }
+  int ret = Fadvise(fd_, static_cast<off_t>(offset), n, POSIX_FADV_WILLNEED);
+  if (ret == 0) {
+    return Status::OK();
+  }
+  return STATUS_IO_ERROR(filename_, ret);
+#endif
+}
+
 Status PosixRandomAccessFile::InvalidateCache(size_t offset, size_t length) {
 #ifndef OS_LINUX
   return Status::OK();
@@ -517,7 +577,7 @@ Status PosixMmapFile::Allocate(uint64_t offset, uint64_t len) {
  */
 PosixWritableFile::PosixWritableFile(const std::string& fname, int fd,
                                      const EnvOptions& options)
-    : filename_(fname), fd_(fd), filesize_(0) {
+    : filename_(fname), fd_(fd), filesize_(0), use_direct_io_(options.use_direct_writes) {
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   allow_fallocate_ = options.allow_fallocate;
   fallocate_with_keep_size_ = options.fallocate_with_keep_size;
@@ -549,6 +609,38 @@ Status PosixWritableFile::Append(const Slice& data) {
   return Status::OK();
 }
 
+Status PosixWritableFile::PositionedAppend(const Slice& data, uint64_t offset) {
+  assert(use_direct_io_);
+  assert(offset <= std::numeric_limits<off_t>::max());
+  const char* src = data.cdata();
+  size_t left = data.size();
+  while (left != 0) {
+    ssize_t done = pwrite(fd_, src, left, static_cast<off_t>(offset));
+    if (done < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return STATUS_IO_ERROR(filename_, errno);
+    }
+    left -= done;
+    src += done;
+    offset += done;
+  }
+  filesize_ = std::max<uint64_t>(filesize_, offset);
+  return Status::OK();
+}
+
+Status PosixWritableFile::Truncate(uint64_t size) {
+  if (!use_direct_io_) {
+    return Status::OK();
+  }
+  if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+    return STATUS_IO_ERROR(filename_, errno);
+  }
+  filesize_ = size;
+  return Status::OK();
+}
+
 Status PosixWritableFile::Close() {
   Status s;
 
@@ -41,6 +41,9 @@ namespace rocksdb {
 
 #define STATUS_IO_ERROR(context, err_number) STATUS(IOError, (context), strerror(err_number))
 
+// Alignment of offsets, sizes and buffers for files opened with O_DIRECT.
+constexpr size_t kDirectIOAlignment = 4096;
+
 class PosixSequentialFile : public SequentialFile {
  private:
   std::string filename_;
@@ -63,6 +66,11 @@ class PosixRandomAccessFile : public RandomAccessFile {
   std::string filename_;
   int fd_;
   bool use_os_buffer_;
+  bool use_direct_io_;
+
+  // Reads into the aligned buffer and copies the requested range to scratch, since O_DIRECT
+  // requires offset, size and memory address to be aligned.
+  Status ReadDirect(uint64_t offset, size_t n, Slice* result, char* scratch) const;
 
  public:
   PosixRandomAccessFile(const std::string& fname, int fd,
@@ -75,6 +83,7 @@ class PosixRandomAccessFile : public RandomAccessFile {
   virtual size_t GetUniqueId(char* id, size_t max_size) const override;
 #endif
   virtual void Hint(AccessPattern pattern) override;
+  virtual Status Prefetch(uint64_t offset, size_t n) override;
   virtual Status InvalidateCache(size_t offset, size_t length) override;
 };
 
@@ -83,6 +92,7 @@ class PosixWritableFile : public WritableFile {
   const std::string filename_;
   int fd_;
   uint64_t filesize_;
+  bool use_direct_io_;
 #ifdef ROCKSDB_FALLOCATE_PRESENT
   bool allow_fallocate_;
   bool fallocate_with_keep_size_;
@@ -94,10 +104,15 @@ class PosixWritableFile : public WritableFile {
   ~PosixWritableFile();
 
   // Means Close() will properly take care of truncate
-  // and it does not need any additional information
-  virtual Status Truncate(uint64_t size) override { return Status::OK(); }
+  // and it does not need any additional information.
+  // With direct I/O the last page is written padded, so the file is truncated to the actual size.
+  virtual Status Truncate(uint64_t size) override;
   virtual Status Close() override;
   virtual Status Append(const Slice& data) override;
+  // Used with direct I/O, when WritableFileWriter writes whole aligned pages from its buffer.
+  virtual Status PositionedAppend(const Slice& data, uint64_t offset) override;
+  virtual bool UseOSBuffer() const override { return !use_direct_io_; }
+  virtual size_t GetRequiredBufferAlignment() const override { return kDirectIOAlignment; }
   virtual Status Flush() override;
   virtual Status Sync() override;
   virtual Status Fsync() override;
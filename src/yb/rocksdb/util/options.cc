@@ -59,6 +59,9 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       merge_operator(options.merge_operator.get()),
       compaction_filter(options.compaction_filter),
       compaction_filter_factory(options.compaction_filter_factory.get()),
+      expired_file_filter(options.expired_file_filter.get()),
+      compaction_time_windows(options.compaction_time_windows.get()),
+      memtable_filter(options.memtable_filter.get()),
       inplace_update_support(options.inplace_update_support),
       inplace_callback(options.inplace_callback),
       info_log(options.info_log.get()),
@@ -81,6 +84,10 @@ ImmutableCFOptions::ImmutableCFOptions(const Options& options)
       compression(options.compression),
       compression_per_level(options.compression_per_level),
       compression_opts(options.compression_opts),
+      flush_compression(options.flush_compression),
+      flush_compression_opts(options.flush_compression_opts),
+      bottommost_compression(options.bottommost_compression),
+      bottommost_compression_opts(options.bottommost_compression_opts),
       level_compaction_dynamic_level_bytes(
           options.level_compaction_dynamic_level_bytes),
       access_hint_on_compaction_start(options.access_hint_on_compaction_start),
@@ -99,11 +106,16 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       merge_operator(nullptr),
       compaction_filter(nullptr),
       compaction_filter_factory(nullptr),
+      expired_file_filter(nullptr),
+      compaction_time_windows(nullptr),
+      memtable_filter(nullptr),
       write_buffer_size(4_MB), // Option expects bytes.
       max_write_buffer_number(2),
       min_write_buffer_number_to_merge(1),
       max_write_buffer_number_to_maintain(0),
       compression(Snappy_Supported() ? kSnappyCompression : kNoCompression),
+      flush_compression(kDisableCompressionOption),
+      bottommost_compression(kDisableCompressionOption),
       prefix_extractor(nullptr),
       num_levels(7),
       level0_file_num_compaction_trigger(4),
@@ -140,6 +152,7 @@ ColumnFamilyOptions::ColumnFamilyOptions()
       memtable_prefix_bloom_bits(0),
       memtable_prefix_bloom_probes(6),
       memtable_prefix_bloom_huge_page_tlb_size(0),
+      memtable_huge_page_size(0),
       bloom_locality(0),
       max_successive_merges(0),
       min_partial_merge_operands(2),
@@ -154,6 +167,9 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       merge_operator(options.merge_operator),
       compaction_filter(options.compaction_filter),
       compaction_filter_factory(options.compaction_filter_factory),
+      expired_file_filter(options.expired_file_filter),
+      compaction_time_windows(options.compaction_time_windows),
+      memtable_filter(options.memtable_filter),
       write_buffer_size(options.write_buffer_size),
       max_write_buffer_number(options.max_write_buffer_number),
       min_write_buffer_number_to_merge(
@@ -163,6 +179,10 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       compression(options.compression),
       compression_per_level(options.compression_per_level),
       compression_opts(options.compression_opts),
+      flush_compression(options.flush_compression),
+      flush_compression_opts(options.flush_compression_opts),
+      bottommost_compression(options.bottommost_compression),
+      bottommost_compression_opts(options.bottommost_compression_opts),
       prefix_extractor(options.prefix_extractor),
       num_levels(options.num_levels),
       level0_file_num_compaction_trigger(
@@ -209,6 +229,7 @@ ColumnFamilyOptions::ColumnFamilyOptions(const Options& options)
       memtable_prefix_bloom_probes(options.memtable_prefix_bloom_probes),
       memtable_prefix_bloom_huge_page_tlb_size(
           options.memtable_prefix_bloom_huge_page_tlb_size),
+      memtable_huge_page_size(options.memtable_huge_page_size),
       bloom_locality(options.bloom_locality),
       max_successive_merges(options.max_successive_merges),
       min_partial_merge_operands(options.min_partial_merge_operands),
@@ -265,6 +286,8 @@ DBOptions::DBOptions()
       allow_mmap_reads(false),
       allow_mmap_writes(false),
       allow_fallocate(true),
+      use_direct_reads(false),
+      use_direct_io_for_flush_and_compaction(false),
       is_fd_close_on_exec(true),
       skip_log_error_on_recovery(false),
       stats_dump_period_sec(600),
@@ -324,6 +347,9 @@ void DBOptions::Dump(Logger* log) const {
   RHEADER(log, "       Options.allow_os_buffer: %d", allow_os_buffer);
   RHEADER(log, "      Options.allow_mmap_reads: %d", allow_mmap_reads);
   RHEADER(log, "      Options.allow_fallocate: %d", allow_fallocate);
+  RHEADER(log, "      Options.use_direct_reads: %d", use_direct_reads);
+  RHEADER(log, "      Options.use_direct_io_for_flush_and_compaction: %d",
+      use_direct_io_for_flush_and_compaction);
   RHEADER(log, "     Options.allow_mmap_writes: %d", allow_mmap_writes);
   RHEADER(log, "         Options.create_missing_column_families: %d",
       create_missing_column_families);
@@ -427,6 +453,12 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compaction_filter ? compaction_filter->Name() : "None");
   RHEADER(log, "       Options.compaction_filter_factory: %s",
       compaction_filter_factory ? compaction_filter_factory->Name() : "None");
+  RHEADER(log, "       Options.expired_file_filter: %s",
+      expired_file_filter ? expired_file_filter->Name() : "None");
+  RHEADER(log, "       Options.compaction_time_windows: %s",
+      compaction_time_windows ? compaction_time_windows->Name() : "None");
+  RHEADER(log, "       Options.memtable_filter_bits: %" PRIu32,
+      memtable_filter ? memtable_filter->num_bits : 0);
   RHEADER(log, "        Options.memtable_factory: %s", memtable_factory->Name());
   RHEADER(log, "           Options.table_factory: %s", table_factory->Name());
   RHEADER(log, "           table_factory options: %s",
@@ -456,6 +488,20 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
       compression_opts.level);
   RHEADER(log, "              Options.compression_opts.strategy: %d",
       compression_opts.strategy);
+  RHEADER(log, "        Options.compression_opts.max_dict_bytes: %" PRIu32,
+      compression_opts.max_dict_bytes);
+  RHEADER(log, "  Options.compression_opts.zstd_max_train_bytes: %" PRIu32,
+      compression_opts.zstd_max_train_bytes);
+  RHEADER(log, "                   Options.flush_compression: %s",
+      CompressionTypeToString(flush_compression).c_str());
+  RHEADER(log, "           Options.flush_compression_opts.level: %d",
+      flush_compression_opts.level);
+  RHEADER(log, "              Options.bottommost_compression: %s",
+      CompressionTypeToString(bottommost_compression).c_str());
+  RHEADER(log, "      Options.bottommost_compression_opts.level: %d",
+      bottommost_compression_opts.level);
+  RHEADER(log, "Options.bottommost_compression_opts.max_dict_bytes: %" PRIu32,
+      bottommost_compression_opts.max_dict_bytes);
   RHEADER(log, "     Options.level0_file_num_compaction_trigger: %d",
       level0_file_num_compaction_trigger);
   RHEADER(log, "         Options.level0_slowdown_writes_trigger: %d",
@@ -545,6 +591,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   RHEADER(log,
       "  Options.memtable_prefix_bloom_huge_page_tlb_size: %" ROCKSDB_PRIszt,
          memtable_prefix_bloom_huge_page_tlb_size);
+  RHEADER(log, "                 Options.memtable_huge_page_size: %" ROCKSDB_PRIszt,
+         memtable_huge_page_size);
   RHEADER(log, "                          Options.bloom_locality: %d",
       bloom_locality);
 
@@ -557,6 +557,8 @@ bool ParseMemtableOptions(const std::string& name, const std::string& value,
   } else if (name == "memtable_prefix_bloom_huge_page_tlb_size") {
     new_options->memtable_prefix_bloom_huge_page_tlb_size =
       ParseSizeT(value);
+  } else if (name == "memtable_huge_page_size") {
+    new_options->memtable_huge_page_size = ParseSizeT(value);
   } else if (name == "max_successive_merges") {
     new_options->max_successive_merges = ParseSizeT(value);
   } else if (name == "filter_deletes") {
@@ -741,6 +743,44 @@ Status StringToMap(const std::string& opts_str,
   return Status::OK();
 }
 
+// Parses compression options in the format:
+// window_bits:level:strategy[:max_dict_bytes[:zstd_max_train_bytes]]
+Status ParseCompressionOptions(const std::string& name, const std::string& value,
+                               CompressionOptions* compression_opts) {
+  size_t start = 0;
+  size_t end = value.find(':');
+  if (end == std::string::npos) {
+    return STATUS(InvalidArgument,
+        "unable to parse the specified CF option " + name);
+  }
+  compression_opts->window_bits = ParseInt(value.substr(start, end - start));
+  start = end + 1;
+  end = value.find(':', start);
+  if (end == std::string::npos) {
+    return STATUS(InvalidArgument,
+        "unable to parse the specified CF option " + name);
+  }
+  compression_opts->level = ParseInt(value.substr(start, end - start));
+  start = end + 1;
+  if (start >= value.size()) {
+    return STATUS(InvalidArgument,
+        "unable to parse the specified CF option " + name);
+  }
+  end = value.find(':', start);
+  compression_opts->strategy = ParseInt(value.substr(start, end - start));
+  if (end == std::string::npos) {
+    return Status::OK();
+  }
+  start = end + 1;
+  end = value.find(':', start);
+  compression_opts->max_dict_bytes = ParseUint32(value.substr(start, end - start));
+  if (end == std::string::npos) {
+    return Status::OK();
+  }
+  compression_opts->zstd_max_train_bytes = ParseUint32(value.substr(end + 1));
+  return Status::OK();
+}
+
 Status ParseColumnFamilyOption(const std::string& name,
                                const std::string& org_value,
                                ColumnFamilyOptions* new_options,
@@ -803,29 +843,11 @@ Status ParseColumnFamilyOption(const std::string& name,
       }
       new_options->memtable_factory.reset(new_mem_factory.release());
     } else if (name == "compression_opts") {
-      size_t start = 0;
-      size_t end = value.find(':');
-      if (end == std::string::npos) {
-        return STATUS(InvalidArgument,
-            "unable to parse the specified CF option " + name);
-      }
-      new_options->compression_opts.window_bits =
-          ParseInt(value.substr(start, end - start));
-      start = end + 1;
-      end = value.find(':', start);
-      if (end == std::string::npos) {
-        return STATUS(InvalidArgument,
-            "unable to parse the specified CF option " + name);
-      }
-      new_options->compression_opts.level =
-          ParseInt(value.substr(start, end - start));
-      start = end + 1;
-      if (start >= value.size()) {
-        return STATUS(InvalidArgument,
-            "unable to parse the specified CF option " + name);
-      }
-      new_options->compression_opts.strategy =
-          ParseInt(value.substr(start, value.size() - start));
+      return ParseCompressionOptions(name, value, &new_options->compression_opts);
+    } else if (name == "flush_compression_opts") {
+      return ParseCompressionOptions(name, value, &new_options->flush_compression_opts);
+    } else if (name == "bottommost_compression_opts") {
+      return ParseCompressionOptions(name, value, &new_options->bottommost_compression_opts);
     } else if (name == "compaction_options_fifo") {
       new_options->compaction_options_fifo.max_table_files_size =
           ParseUint64(value);
@@ -1425,6 +1447,7 @@ ColumnFamilyOptions BuildColumnFamilyOptions(
       mutable_cf_options.memtable_prefix_bloom_probes;
   cf_opts.memtable_prefix_bloom_huge_page_tlb_size =
       mutable_cf_options.memtable_prefix_bloom_huge_page_tlb_size;
+  cf_opts.memtable_huge_page_size = mutable_cf_options.memtable_huge_page_size;
   cf_opts.max_successive_merges = mutable_cf_options.max_successive_merges;
   cf_opts.filter_deletes = mutable_cf_options.filter_deletes;
   cf_opts.inplace_update_num_locks =
@@ -128,6 +128,9 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
        "kLZ4HCCompression:"
        "kZSTDNotFinalCompression"},
       {"compression_opts", "4:5:6"},
+      {"flush_compression", "kLZ4Compression"},
+      {"bottommost_compression", "kZSTD"},
+      {"bottommost_compression_opts", "4:19:6:16384:1638400"},
       {"num_levels", "7"},
       {"level0_file_num_compaction_trigger", "8"},
       {"level0_slowdown_writes_trigger", "9"},
@@ -157,6 +160,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
       {"memtable_prefix_bloom_bits", "26"},
       {"memtable_prefix_bloom_probes", "27"},
       {"memtable_prefix_bloom_huge_page_tlb_size", "28"},
+      {"memtable_huge_page_size", "2097152"},
       {"bloom_locality", "29"},
       {"max_successive_merges", "30"},
       {"min_partial_merge_operands", "31"},
@@ -223,6 +227,13 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.compression_opts.window_bits, 4);
   ASSERT_EQ(new_cf_opt.compression_opts.level, 5);
   ASSERT_EQ(new_cf_opt.compression_opts.strategy, 6);
+  ASSERT_EQ(new_cf_opt.compression_opts.max_dict_bytes, 0U);
+  ASSERT_EQ(new_cf_opt.flush_compression, kLZ4Compression);
+  ASSERT_EQ(new_cf_opt.flush_compression_opts.level, CompressionOptions().level);
+  ASSERT_EQ(new_cf_opt.bottommost_compression, kZSTD);
+  ASSERT_EQ(new_cf_opt.bottommost_compression_opts.level, 19);
+  ASSERT_EQ(new_cf_opt.bottommost_compression_opts.max_dict_bytes, 16384U);
+  ASSERT_EQ(new_cf_opt.bottommost_compression_opts.zstd_max_train_bytes, 1638400U);
   ASSERT_EQ(new_cf_opt.num_levels, 7);
   ASSERT_EQ(new_cf_opt.level0_file_num_compaction_trigger, 8);
   ASSERT_EQ(new_cf_opt.level0_slowdown_writes_trigger, 9);
@@ -255,6 +266,7 @@ TEST_F(OptionsTest, GetOptionsFromMapTest) {
   ASSERT_EQ(new_cf_opt.memtable_prefix_bloom_bits, 26U);
   ASSERT_EQ(new_cf_opt.memtable_prefix_bloom_probes, 27U);
   ASSERT_EQ(new_cf_opt.memtable_prefix_bloom_huge_page_tlb_size, 28U);
+  ASSERT_EQ(new_cf_opt.memtable_huge_page_size, 2097152U);
   ASSERT_EQ(new_cf_opt.bloom_locality, 29U);
   ASSERT_EQ(new_cf_opt.max_successive_merges, 30U);
   ASSERT_EQ(new_cf_opt.min_partial_merge_operands, 31U);
@@ -1617,8 +1629,8 @@ void InitDefault(BlockBasedTableOptions*) {}
 
 Status GetFromString(BlockBasedTableOptions* source, BlockBasedTableOptions* destination) {
   const char* const kOptionsString =
-      "cache_index_and_filter_blocks=1;index_type=kHashSearch;"
-      "checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
+      "cache_index_and_filter_blocks=1;cache_index_and_filter_blocks_with_high_priority=1;"
+      "index_type=kHashSearch;checksum=kxxHash;hash_index_allow_collision=1;no_block_cache=1;"
       "block_cache=1M;block_cache_compressed=1k;block_size=1024;filter_block_size=16384;"
       "block_size_deviation=8;block_restart_interval=4; "
       "index_block_restart_interval=4;index_block_size=16384;min_keys_per_index_block=16;"
@@ -1628,8 +1640,10 @@ Status GetFromString(BlockBasedTableOptions* source, BlockBasedTableOptions* des
 
   RETURN_NOT_OK(GetBlockBasedTableOptionsFromString(*source, kOptionsString, destination));
 
-  // This option is not setable:
+  // These options are not setable:
   destination->use_delta_encoding = false;
+  destination->data_block_key_value_encoding_format =
+      KeyValueEncodingFormat::kKeyDeltaEncodingThreeSharedParts;
 
   EXPECT_NE(nullptr, destination->block_cache.get());
   EXPECT_NE(nullptr, destination->block_cache_compressed.get());
@@ -1683,6 +1697,8 @@ Status GetFromString(DBOptions* source, DBOptions* destination) {
       "allow_mmap_writes=true;"
       "stats_dump_period_sec=70127;"
       "allow_fallocate=true;"
+      "use_direct_reads=false;"
+      "use_direct_io_for_flush_and_compaction=false;"
       "allow_mmap_reads=true;"
       "max_log_file_size=4607;"
       "random_access_max_buffer_size=1048576;"
@@ -1723,6 +1739,7 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
       "bloom_locality=8016;"
       "target_file_size_base=4294976376;"
       "memtable_prefix_bloom_huge_page_tlb_size=2557;"
+      "memtable_huge_page_size=3145;"
       "max_successive_merges=5497;"
       "max_sequential_skip_in_iterations=4294971408;"
       "arena_block_size=1893;"
@@ -1735,6 +1752,8 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
       "max_bytes_for_level_multiplier=60;"
       "memtable_factory=SkipListFactory;"
       "compression=kNoCompression;"
+      "flush_compression=kSnappyCompression;"
+      "bottommost_compression=kZSTD;"
       "min_partial_merge_operands=7576;"
       "level0_stop_writes_trigger=33;"
       "num_levels=99;"
@@ -1769,6 +1788,8 @@ Status GetFromString(ColumnFamilyOptions* source, ColumnFamilyOptions* destinati
   destination->compaction_pri = CompactionPri::kOldestSmallestSeqFirst;
   destination->compaction_options_universal = CompactionOptionsUniversal();
   destination->compression_opts = CompressionOptions();
+  destination->flush_compression_opts = CompressionOptions();
+  destination->bottommost_compression_opts = CompressionOptions();
   destination->hard_rate_limit = 0;
   destination->soft_rate_limit = 0;
   destination->compaction_options_fifo = CompactionOptionsFIFO();
@@ -1948,6 +1969,9 @@ TEST_F(OptionsParserTest, ColumnFamilyOptionsAllFieldsSettable) {
       BLACKLIST_ENTRY(ColumnFamilyOptions, merge_operator),
       BLACKLIST_ENTRY(ColumnFamilyOptions, compaction_filter),
       BLACKLIST_ENTRY(ColumnFamilyOptions, compaction_filter_factory),
+      BLACKLIST_ENTRY(ColumnFamilyOptions, expired_file_filter),
+      BLACKLIST_ENTRY(ColumnFamilyOptions, compaction_time_windows),
+      BLACKLIST_ENTRY(ColumnFamilyOptions, memtable_filter),
       BLACKLIST_ENTRY(ColumnFamilyOptions, compression_per_level),
       BLACKLIST_ENTRY(ColumnFamilyOptions, prefix_extractor),
       BLACKLIST_ENTRY(ColumnFamilyOptions, max_bytes_for_level_multiplier_additional),
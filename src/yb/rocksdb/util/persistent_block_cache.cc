@@ -0,0 +1,453 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/persistent_block_cache.h"
+
+#include <inttypes.h>
+
+#include <deque>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/port/port.h"
+#include "yb/rocksdb/util/coding.h"
+#include "yb/rocksdb/util/crc32c.h"
+#include "yb/rocksdb/util/mutexlock.h"
+#include "yb/rocksdb/util/sync_point.h"
+
+#include "yb/util/cache_metrics.h"
+#include "yb/util/logging.h"
+#include "yb/util/mem_tracker.h"
+#include "yb/util/metrics.h"
+
+namespace rocksdb {
+
+namespace {
+
+// Each record is the masked crc32c of the block followed by the block itself.
+constexpr size_t kRecordHeaderSize = 4;
+
+// Rough per entry overhead of the index: the hash table node and the key copy kept by the segment.
+constexpr size_t kIndexEntryOverhead = 64;
+
+const char* const kSegmentFileSuffix = ".pbc";
+
+std::string SegmentFileName(const std::string& path, uint64_t number) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "/%06" PRIu64 "%s", number, kSegmentFileSuffix);
+  return path + buf;
+}
+
+struct Segment {
+  std::string file_name;
+  // Only set while the segment is being written.
+  std::unique_ptr<WritableFile> writer;
+  std::unique_ptr<RandomAccessFile> reader;
+  size_t size = 0;
+  // Keys of the records appended to this segment, used to clean up the index when the segment is
+  // dropped.
+  std::vector<std::string> keys;
+};
+
+typedef std::shared_ptr<Segment> SegmentPtr;
+
+struct RecordLocation {
+  // Readers hold a reference to the segment, so a concurrently dropped segment stays readable
+  // until they are done.
+  SegmentPtr segment;
+  uint64_t offset;
+  size_t size;
+};
+
+class LogStructuredBlockCache : public PersistentBlockCache {
+ public:
+  explicit LogStructuredBlockCache(const PersistentBlockCacheOptions& options)
+      : options_(options), write_cond_(&mutex_), writes_done_cond_(&mutex_) {
+    if (options_.mem_tracker) {
+      mem_tracker_ = yb::MemTracker::FindOrCreateTracker(
+          "PersistentBlockCache", options_.mem_tracker);
+    }
+  }
+
+  ~LogStructuredBlockCache() {
+    {
+      MutexLock l(&mutex_);
+      closing_ = true;
+      write_cond_.SignalAll();
+      writes_done_cond_.SignalAll();
+    }
+    if (writer_thread_) {
+      writer_thread_->join();
+    }
+    // Blocks that were not written yet are just dropped.
+    if (mem_tracker_) {
+      mem_tracker_->Release(pending_bytes_);
+    }
+    while (!segments_.empty()) {
+      DropOldestSegment();
+    }
+  }
+
+  Status Init() {
+    RETURN_NOT_OK(options_.env->CreateDirIfMissing(options_.path));
+    // The index is not persisted, so files left by a previous process cannot be used.
+    std::vector<std::string> children;
+    RETURN_NOT_OK(options_.env->GetChildren(options_.path, &children));
+    for (const auto& child : children) {
+      if (boost::ends_with(child, kSegmentFileSuffix)) {
+        RETURN_NOT_OK(options_.env->DeleteFile(options_.path + "/" + child));
+      }
+    }
+    writer_thread_.reset(new std::thread(&LogStructuredBlockCache::BackgroundWrite, this));
+    return Status::OK();
+  }
+
+  Status Insert(const Slice& key, const Slice& data) override {
+    const size_t record_size = kRecordHeaderSize + data.size();
+    if (record_size > options_.segment_size) {
+      IncrementInsertFailures();
+      return STATUS(Incomplete, "Block does not fit into a persistent block cache segment");
+    }
+
+    std::string key_str = key.ToBuffer();
+    {
+      MutexLock l(&mutex_);
+      if (index_.count(key_str) || pending_.count(key_str)) {
+        return Status::OK();
+      }
+      if (pending_bytes_ + data.size() > options_.max_pending_write_bytes) {
+        if (metrics_) {
+          metrics_->dropped_inserts->Increment();
+        }
+        return STATUS(Busy, "Too many blocks are waiting to be written to persistent block cache");
+      }
+      pending_bytes_ += data.size();
+    }
+
+    // The copy is made outside of the mutex, the slot for it is already reserved.
+    auto block = std::make_shared<const std::string>(data.cdata(), data.size());
+    if (mem_tracker_) {
+      mem_tracker_->Consume(data.size());
+    }
+    MutexLock l(&mutex_);
+    if (!pending_.emplace(key_str, block).second) {
+      // Inserted concurrently.
+      ReleasePendingBytes(data.size());
+      return Status::OK();
+    }
+    write_queue_.push_back(std::move(key_str));
+    write_cond_.Signal();
+    return Status::OK();
+  }
+
+  Status Lookup(const Slice& key, std::unique_ptr<char[]>* data, size_t* size) override {
+    RecordLocation location;
+    PendingBlock pending_block;
+    {
+      MutexLock l(&mutex_);
+      const std::string key_str = key.ToBuffer();
+      auto it = index_.find(key_str);
+      if (it != index_.end()) {
+        location = it->second;
+      } else {
+        auto pending_it = pending_.find(key_str);
+        if (pending_it == pending_.end()) {
+          if (metrics_) {
+            metrics_->cache_misses->Increment();
+          }
+          return STATUS(NotFound, "Block is not in persistent block cache");
+        }
+        pending_block = pending_it->second;
+      }
+    }
+
+    if (pending_block) {
+      data->reset(new char[pending_block->size()]);
+      memcpy(data->get(), pending_block->data(), pending_block->size());
+      *size = pending_block->size();
+      if (metrics_) {
+        metrics_->cache_hits->Increment();
+      }
+      return Status::OK();
+    }
+
+    const size_t record_size = kRecordHeaderSize + location.size;
+    std::unique_ptr<char[]> scratch(new char[record_size]);
+    Slice record;
+    Status s = location.segment->reader->Read(location.offset, record_size, &record, scratch.get());
+    if (s.ok() && record.size() != record_size) {
+      s = STATUS_FORMAT(Corruption, "Truncated persistent block cache record in $0",
+                        location.segment->file_name);
+    }
+    if (s.ok()) {
+      const uint32_t expected = crc32c::Unmask(DecodeFixed32(record.cdata()));
+      if (crc32c::Value(record.cdata() + kRecordHeaderSize, location.size) != expected) {
+        s = STATUS_FORMAT(Corruption, "Persistent block cache record checksum mismatch in $0",
+                          location.segment->file_name);
+      }
+    }
+    if (!s.ok()) {
+      if (metrics_) {
+        metrics_->cache_misses->Increment();
+      }
+      return s;
+    }
+
+    data->reset(new char[location.size]);
+    memcpy(data->get(), record.cdata() + kRecordHeaderSize, location.size);
+    *size = location.size;
+    if (metrics_) {
+      metrics_->cache_hits->Increment();
+    }
+    return Status::OK();
+  }
+
+  size_t GetCapacity() const override {
+    return options_.capacity;
+  }
+
+  size_t GetUsage() const override {
+    MutexLock l(&mutex_);
+    return usage_;
+  }
+
+  void SetMetrics(const scoped_refptr<yb::MetricEntity>& entity) override {
+    metrics_ = std::make_shared<yb::PersistentBlockCacheMetrics>(entity);
+    MutexLock l(&mutex_);
+    metrics_->cache_usage->set_value(usage_);
+  }
+
+  void TEST_WaitForPendingWrites() override {
+    MutexLock l(&mutex_);
+    while (!pending_.empty() && !closing_) {
+      writes_done_cond_.Wait();
+    }
+  }
+
+ private:
+  typedef std::shared_ptr<const std::string> PendingBlock;
+
+  static size_t IndexEntryCharge(const std::string& key) {
+    return 2 * key.size() + sizeof(RecordLocation) + kIndexEntryOverhead;
+  }
+
+  void IncrementInsertFailures() {
+    if (metrics_) {
+      metrics_->insert_failures->Increment();
+    }
+  }
+
+  void ReleasePendingBytes(size_t size) {
+    pending_bytes_ -= size;
+    if (mem_tracker_) {
+      mem_tracker_->Release(size);
+    }
+  }
+
+  // Body of the writer thread. Blocks stay in pending_, so they can be looked up, until they are
+  // added to the index.
+  void BackgroundWrite() {
+    MutexLock l(&mutex_);
+    while (true) {
+      while (write_queue_.empty() && !closing_) {
+        write_cond_.Wait();
+      }
+      if (closing_) {
+        return;
+      }
+
+      std::string key = std::move(write_queue_.front());
+      write_queue_.pop_front();
+      PendingBlock block = pending_[key];
+
+      // We don't need to hold the lock while writing the record.
+      mutex_.Unlock();
+      TEST_SYNC_POINT("LogStructuredBlockCache::BackgroundWrite:BeforeWrite");
+      RecordLocation location;
+      Status s = WriteRecord(*block, &location);
+      mutex_.Lock();
+
+      pending_.erase(key);
+      ReleasePendingBytes(block->size());
+      if (s.ok()) {
+        usage_ += kRecordHeaderSize + block->size();
+        if (mem_tracker_) {
+          mem_tracker_->Consume(IndexEntryCharge(key));
+        }
+        index_.emplace(key, location);
+        location.segment->keys.push_back(std::move(key));
+        if (metrics_) {
+          metrics_->inserts->Increment();
+          metrics_->cache_usage->set_value(usage_);
+        }
+      } else {
+        YB_LOG_EVERY_N_SECS(WARNING, 10)
+            << "Failed to write to persistent block cache: " << s.ToString();
+        IncrementInsertFailures();
+      }
+      if (pending_.empty()) {
+        writes_done_cond_.SignalAll();
+      }
+    }
+  }
+
+  // Appends a record with data to the active segment, starting a new one if needed. Only called by
+  // the writer thread, without holding mutex_.
+  Status WriteRecord(const std::string& data, RecordLocation* location) {
+    const size_t record_size = kRecordHeaderSize + data.size();
+    if (active_segment_ == nullptr || active_segment_->size + record_size > options_.segment_size) {
+      RETURN_NOT_OK(RollSegment());
+    }
+
+    char header[kRecordHeaderSize];
+    EncodeFixed32(header, crc32c::Mask(crc32c::Value(data.data(), data.size())));
+    WritableFile* writer = active_segment_->writer.get();
+    Status s = writer->Append(Slice(header, sizeof(header)));
+    if (s.ok()) {
+      s = writer->Append(data);
+    }
+    if (s.ok()) {
+      s = writer->Flush();
+    }
+    if (!s.ok()) {
+      // The segment may end with a partial record now, so stop appending to it.
+      CloseActiveSegment();
+      return s;
+    }
+
+    *location = RecordLocation{segments_.back(), active_segment_->size, data.size()};
+    active_segment_->size += record_size;
+    return Status::OK();
+  }
+
+  // Finishes the segment being written, it stays readable until dropped.
+  void CloseActiveSegment() {
+    if (active_segment_ == nullptr) {
+      return;
+    }
+    WARN_NOT_OK(active_segment_->writer->Close(),
+                "Failed to close persistent block cache file " + active_segment_->file_name);
+    active_segment_->writer.reset();
+    active_segment_ = nullptr;
+  }
+
+  bool NeedsSpaceForSegment() {
+    MutexLock l(&mutex_);
+    return usage_ + options_.segment_size > options_.capacity;
+  }
+
+  // Starts a new segment, dropping the oldest ones to make room for it.
+  Status RollSegment() {
+    CloseActiveSegment();
+    while (!segments_.empty() && NeedsSpaceForSegment()) {
+      DropOldestSegment();
+    }
+
+    auto segment = std::make_shared<Segment>();
+    segment->file_name = SegmentFileName(options_.path, next_segment_number_++);
+    const EnvOptions env_options;
+    RETURN_NOT_OK(options_.env->NewWritableFile(segment->file_name, &segment->writer, env_options));
+    Status s = options_.env->NewRandomAccessFile(
+        segment->file_name, &segment->reader, env_options);
+    if (!s.ok()) {
+      WARN_NOT_OK(segment->writer->Close(), "Failed to close " + segment->file_name);
+      WARN_NOT_OK(options_.env->DeleteFile(segment->file_name),
+                  "Failed to delete " + segment->file_name);
+      return s;
+    }
+    segments_.push_back(segment);
+    active_segment_ = segment.get();
+    return Status::OK();
+  }
+
+  void DropOldestSegment() {
+    SegmentPtr segment = std::move(segments_.front());
+    segments_.pop_front();
+    if (segment.get() == active_segment_) {
+      CloseActiveSegment();
+    }
+
+    {
+      MutexLock l(&mutex_);
+      size_t evicted = 0;
+      for (const auto& key : segment->keys) {
+        auto it = index_.find(key);
+        if (it != index_.end() && it->second.segment == segment) {
+          index_.erase(it);
+          ++evicted;
+        }
+        if (mem_tracker_) {
+          mem_tracker_->Release(IndexEntryCharge(key));
+        }
+      }
+      usage_ -= segment->size;
+      if (metrics_) {
+        metrics_->evictions->IncrementBy(evicted);
+        metrics_->cache_usage->set_value(usage_);
+      }
+    }
+    // Concurrent lookups keep the file open, so it can be deleted right away.
+    WARN_NOT_OK(options_.env->DeleteFile(segment->file_name),
+                "Failed to delete persistent block cache file " + segment->file_name);
+  }
+
+  const PersistentBlockCacheOptions options_;
+  std::shared_ptr<yb::MemTracker> mem_tracker_;
+  std::shared_ptr<yb::PersistentBlockCacheMetrics> metrics_;
+
+  // mutex_ protects the following state.
+  mutable port::Mutex mutex_;
+  // Signalled when a block is queued or the cache is closing.
+  port::CondVar write_cond_;
+  // Signalled when all queued blocks are written.
+  port::CondVar writes_done_cond_;
+  std::unordered_map<std::string, RecordLocation> index_;
+  // Blocks waiting for the writer thread, write_queue_ has their keys in insertion order.
+  std::unordered_map<std::string, PendingBlock> pending_;
+  std::deque<std::string> write_queue_;
+  size_t pending_bytes_ = 0;
+  size_t usage_ = 0;
+  bool closing_ = false;
+
+  // The following state is only accessed by the writer thread, and by the destructor once the
+  // writer thread is joined. Keys of a segment are appended under mutex_.
+  // Segments from the oldest to the newest one, which is the one being written if any.
+  std::deque<SegmentPtr> segments_;
+  Segment* active_segment_ = nullptr;
+  uint64_t next_segment_number_ = 0;
+  std::unique_ptr<std::thread> writer_thread_;
+};
+
+} // namespace
+
+Status NewPersistentBlockCache(const PersistentBlockCacheOptions& options,
+                               std::shared_ptr<PersistentBlockCache>* cache) {
+  if (options.env == nullptr || options.path.empty()) {
+    return STATUS(InvalidArgument, "Persistent block cache requires an env and a path");
+  }
+  if (options.capacity == 0 || options.segment_size == 0) {
+    return STATUS(InvalidArgument, "Persistent block cache capacity and segment size must be set");
+  }
+  PersistentBlockCacheOptions effective_options = options;
+  effective_options.segment_size = std::min(options.segment_size, options.capacity);
+  auto result = std::make_shared<LogStructuredBlockCache>(effective_options);
+  RETURN_NOT_OK(result->Init());
+  *cache = std::move(result);
+  return Status::OK();
+}
+
+}  // namespace rocksdb
@@ -0,0 +1,170 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksdb/persistent_block_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/util/sync_point.h"
+#include "yb/rocksdb/util/testharness.h"
+#include "yb/rocksdb/util/testutil.h"
+
+namespace rocksdb {
+
+class PersistentBlockCacheTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    options_.env = Env::Default();
+    options_.path = test::TmpDir() + "/persistent_block_cache_test";
+    options_.capacity = 64_KB;
+    options_.segment_size = 16_KB;
+    ASSERT_OK(NewPersistentBlockCache(options_, &cache_));
+  }
+
+  void TearDown() override {
+    cache_.reset();
+  }
+
+  std::string Lookup(const std::string& key) {
+    std::unique_ptr<char[]> data;
+    size_t size = 0;
+    Status s = cache_->Lookup(key, &data, &size);
+    if (!s.ok()) {
+      EXPECT_TRUE(s.IsNotFound()) << s.ToString();
+      return "NOT_FOUND";
+    }
+    return std::string(data.get(), size);
+  }
+
+  std::string Key(int i) {
+    return "key" + std::to_string(i);
+  }
+
+  PersistentBlockCacheOptions options_;
+  std::shared_ptr<PersistentBlockCache> cache_;
+};
+
+TEST_F(PersistentBlockCacheTest, InsertAndLookup) {
+  ASSERT_EQ("NOT_FOUND", Lookup("a"));
+  ASSERT_OK(cache_->Insert("a", "value_a"));
+  ASSERT_OK(cache_->Insert("b", "value_b"));
+  ASSERT_EQ("value_a", Lookup("a"));
+  ASSERT_EQ("value_b", Lookup("b"));
+
+  // A key that is already cached is not rewritten.
+  cache_->TEST_WaitForPendingWrites();
+  ASSERT_EQ("value_a", Lookup("a"));
+  const size_t usage = cache_->GetUsage();
+  ASSERT_OK(cache_->Insert("a", "other_value"));
+  ASSERT_EQ("value_a", Lookup("a"));
+  ASSERT_EQ(usage, cache_->GetUsage());
+}
+
+TEST_F(PersistentBlockCacheTest, OversizedBlock) {
+  ASSERT_TRUE(cache_->Insert("a", std::string(options_.segment_size, 'x')).IsIncomplete());
+  ASSERT_EQ("NOT_FOUND", Lookup("a"));
+  ASSERT_EQ(0U, cache_->GetUsage());
+}
+
+TEST_F(PersistentBlockCacheTest, DropsOldestSegments) {
+  Random rnd(301);
+  std::vector<std::string> values;
+  constexpr int kNumBlocks = 64;
+  // 4 blocks fit into a segment, so the blocks take 4 times more space than the capacity.
+  for (int i = 0; i < kNumBlocks; ++i) {
+    values.push_back(RandomString(&rnd, 4_KB - 64));
+    ASSERT_OK(cache_->Insert(Key(i), values.back()));
+    ASSERT_LE(cache_->GetUsage(), cache_->GetCapacity());
+  }
+  cache_->TEST_WaitForPendingWrites();
+
+  int num_cached = 0;
+  for (int i = 0; i < kNumBlocks; ++i) {
+    auto value = Lookup(Key(i));
+    if (value != "NOT_FOUND") {
+      ASSERT_EQ(values[i], value);
+      ++num_cached;
+    } else {
+      // Only the oldest blocks are dropped.
+      ASSERT_EQ(0, num_cached) << "Block " << i << " dropped after newer blocks were kept";
+    }
+  }
+  ASSERT_GE(num_cached, 3 * 4);
+  ASSERT_LE(num_cached, 4 * 4);
+  ASSERT_EQ(values.back(), Lookup(Key(kNumBlocks - 1)));
+}
+
+#ifndef NDEBUG
+TEST_F(PersistentBlockCacheTest, DropsBlocksWhenWriterIsBehind) {
+  cache_.reset();
+  options_.max_pending_write_bytes = 8_KB;
+  ASSERT_OK(NewPersistentBlockCache(options_, &cache_));
+
+  // Keep the writer thread from writing anything until the test is done inserting.
+  SyncPoint::GetInstance()->LoadDependency({
+      {"PersistentBlockCacheTest::DropsBlocksWhenWriterIsBehind:Inserted",
+       "LogStructuredBlockCache::BackgroundWrite:BeforeWrite"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  const std::string value(3_KB, 'x');
+  ASSERT_OK(cache_->Insert(Key(0), value));
+  ASSERT_OK(cache_->Insert(Key(1), value));
+  ASSERT_TRUE(cache_->Insert(Key(2), value).IsBusy());
+
+  // Queued blocks are served from memory before they are written.
+  ASSERT_EQ(value, Lookup(Key(0)));
+  ASSERT_EQ(value, Lookup(Key(1)));
+  ASSERT_EQ("NOT_FOUND", Lookup(Key(2)));
+  ASSERT_EQ(0U, cache_->GetUsage());
+
+  TEST_SYNC_POINT("PersistentBlockCacheTest::DropsBlocksWhenWriterIsBehind:Inserted");
+  cache_->TEST_WaitForPendingWrites();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->LoadDependency({});
+
+  ASSERT_EQ(2 * (value.size() + 4), cache_->GetUsage());
+  ASSERT_EQ(value, Lookup(Key(0)));
+  ASSERT_EQ(value, Lookup(Key(1)));
+
+  // There is room in the queue again.
+  ASSERT_OK(cache_->Insert(Key(2), value));
+  cache_->TEST_WaitForPendingWrites();
+  ASSERT_EQ(value, Lookup(Key(2)));
+}
+#endif  // NDEBUG
+
+TEST_F(PersistentBlockCacheTest, RemovesStaleFiles) {
+  ASSERT_OK(cache_->Insert("a", "value_a"));
+  cache_.reset();
+
+  // Files left by a process that did not shut down cleanly.
+  const std::string stale_file = options_.path + "/000000.pbc";
+  const std::string other_file = options_.path + "/other";
+  ASSERT_OK(WriteStringToFile(options_.env, "stale", stale_file));
+  ASSERT_OK(WriteStringToFile(options_.env, "other", other_file));
+
+  ASSERT_OK(NewPersistentBlockCache(options_, &cache_));
+  ASSERT_EQ("NOT_FOUND", Lookup("a"));
+  ASSERT_TRUE(options_.env->FileExists(stale_file).IsNotFound());
+  ASSERT_OK(options_.env->FileExists(other_file));
+  ASSERT_OK(options_.env->DeleteFile(other_file));
+}
+
+}  // namespace rocksdb
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -31,6 +31,17 @@ class DB;
 
 namespace checkpoint {
 
+struct CheckpointOptions {
+  // Whether memtables are flushed before collecting live files. Without a flush, creating a
+  // checkpoint does not stall writes, but it only contains the data up to the flushed frontier of
+  // the DB, so the following operations should be replayed from the log.
+  bool flush_memtable = true;
+
+  // Optional previous checkpoint of the same DB. Table files that are already present there are
+  // linked from it, so a checkpoint to another file system only copies new table files.
+  std::string base_checkpoint_dir;
+};
+
   // Builds an openable snapshot of RocksDB on the same disk, which
   // accepts an output directory on the same disk, and under the directory
   // (1) hard-linked SST files pointing to existing live SST files
@@ -40,6 +51,9 @@ namespace checkpoint {
   // The directory will be an absolute path
   CHECKED_STATUS CreateCheckpoint(DB* db, const std::string& checkpoint_dir);
 
+  CHECKED_STATUS CreateCheckpoint(
+      DB* db, const std::string& checkpoint_dir, const CheckpointOptions& options);
+
 }  // namespace checkpoint
 }  // namespace rocksdb
 #endif  // !ROCKSDB_LITE
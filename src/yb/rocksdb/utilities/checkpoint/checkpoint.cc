@@ -51,6 +51,11 @@ namespace checkpoint {
 // The directory should not already exist and will be created by this API.
 // The directory will be an absolute path
 Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
+  return CreateCheckpoint(db, checkpoint_dir, CheckpointOptions());
+}
+
+Status CreateCheckpoint(
+    DB* db, const std::string& checkpoint_dir, const CheckpointOptions& options) {
   if (!db->GetCheckpointEnv()->IsPlainText()) {
     return STATUS(InvalidArgument, "db's checkpoint env is not plaintext.");
   }
@@ -71,7 +76,7 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
   s = db->DisableFileDeletions();
   if (s.ok()) {
     // this will return live_files prefixed with "/"
-    s = db->GetLiveFiles(live_files, &manifest_file_size, true);
+    s = db->GetLiveFiles(live_files, &manifest_file_size, options.flush_memtable);
   }
   // if we have more than one column family, we need to also get WAL files
   if (s.ok()) {
@@ -112,6 +117,22 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
     // * if it's kDescriptorFile, limit the size to manifest_file_size
     // * always copy if cross-device link
     bool is_table_file = type == kTableFile || type == kTableSBlockFile;
+    if (is_table_file && !options.base_checkpoint_dir.empty()) {
+      // Table files are immutable and their numbers are never reused, so a file with the same name
+      // in the previous checkpoint has the same contents.
+      std::string base_fname = options.base_checkpoint_dir + src_fname;
+      if (db->GetCheckpointEnv()->FileExists(base_fname).ok()) {
+        RLOG(db->GetOptions().info_log, "Hard Linking %s from base checkpoint", src_fname.c_str());
+        s = db->GetCheckpointEnv()->LinkFile(base_fname, full_private_path + src_fname);
+        if (s.ok()) {
+          continue;
+        }
+        if (!s.IsNotSupported()) {
+          break;
+        }
+        s = Status::OK();
+      }
+    }
     if (is_table_file && same_fs) {
       RLOG(db->GetOptions().info_log, "Hard Linking %s", src_fname.c_str());
       s = db->GetCheckpointEnv()->LinkFile(db->GetName() + src_fname,
@@ -134,8 +155,9 @@ Status CreateCheckpoint(DB* db, const std::string& checkpoint_dir) {
   // Link WAL files. Copy exact size of last one because it is the only one
   // that has changes after the last flush.
   for (size_t i = 0; s.ok() && i < wal_size; ++i) {
+    // Without a memtable flush, all alive log files are needed to recover unflushed data.
     if ((live_wal_files[i]->Type() == kAliveLogFile) &&
-        (live_wal_files[i]->StartSequence() >= sequence_number)) {
+        (!options.flush_memtable || live_wal_files[i]->StartSequence() >= sequence_number)) {
       if (i + 1 == wal_size) {
         RLOG(db->GetOptions().info_log, "Copying %s",
              live_wal_files[i]->PathName().c_str());
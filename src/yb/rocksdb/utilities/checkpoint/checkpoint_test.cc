@@ -281,6 +281,59 @@ TEST_F(DBTest, GetSnapshotLink) {
     dbname_ = test::TmpDir(env_) + "/db_test";
 }
 
+TEST_F(DBTest, CheckpointWithoutFlush) {
+  Options options = CurrentOptions();
+  const std::string snapshot_name = test::TmpDir(env_) + "/snapshot";
+  const std::string incremental_name = test::TmpDir(env_) + "/snapshot_incremental";
+  ASSERT_OK(DestroyDB(snapshot_name, options));
+  env_->DeleteDir(snapshot_name);
+  ASSERT_OK(DestroyDB(incremental_name, options));
+  env_->DeleteDir(incremental_name);
+
+  // Writes skip the WAL, as if the log was kept outside of RocksDB.
+  WriteOptions wo;
+  wo.disableWAL = true;
+  ASSERT_OK(Put("a", "v1", wo));
+  ASSERT_OK(Flush());
+  ASSERT_OK(Put("b", "v1", wo));
+
+  std::string live_before;
+  ASSERT_TRUE(db_->GetProperty("rocksdb.num-files-at-level0", &live_before));
+
+  checkpoint::CheckpointOptions checkpoint_options;
+  checkpoint_options.flush_memtable = false;
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, snapshot_name, checkpoint_options));
+
+  // The memtable was not flushed, so the checkpoint only contains flushed data.
+  std::string live_after;
+  ASSERT_TRUE(db_->GetProperty("rocksdb.num-files-at-level0", &live_after));
+  ASSERT_EQ(live_before, live_after);
+  ASSERT_EQ("v1", Get("b"));
+
+  options.create_if_missing = false;
+  DB* snapshot_db = nullptr;
+  std::string result;
+  ASSERT_OK(DB::Open(options, snapshot_name, &snapshot_db));
+  ASSERT_OK(snapshot_db->Get(ReadOptions(), "a", &result));
+  ASSERT_EQ("v1", result);
+  ASSERT_TRUE(snapshot_db->Get(ReadOptions(), "b", &result).IsNotFound());
+  delete snapshot_db;
+
+  // The next checkpoint links the file shared with the previous one from it.
+  ASSERT_OK(Flush());
+  checkpoint_options.base_checkpoint_dir = snapshot_name;
+  ASSERT_OK(checkpoint::CreateCheckpoint(db_, incremental_name, checkpoint_options));
+  ASSERT_OK(DB::Open(options, incremental_name, &snapshot_db));
+  ASSERT_OK(snapshot_db->Get(ReadOptions(), "a", &result));
+  ASSERT_EQ("v1", result);
+  ASSERT_OK(snapshot_db->Get(ReadOptions(), "b", &result));
+  ASSERT_EQ("v1", result);
+  delete snapshot_db;
+
+  ASSERT_OK(DestroyDB(snapshot_name, options));
+  ASSERT_OK(DestroyDB(incremental_name, options));
+}
+
 TEST_F(DBTest, CheckpointCF) {
   Options options = CurrentOptions();
   CreateAndReopenWithCF({"one", "two", "three", "four", "five"}, options);
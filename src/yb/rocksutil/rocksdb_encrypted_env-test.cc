@@ -0,0 +1,198 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/db/filename.h"
+#include "yb/rocksdb/statistics.h"
+
+#include "yb/rocksutil/rocksdb_encrypted_file_factory.h"
+
+#include "yb/util/coding.h"
+#include "yb/util/faststring.h"
+#include "yb/util/format.h"
+#include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/universe_key_manager.h"
+
+using namespace yb::size_literals;
+
+namespace yb {
+
+class RocksDBEncryptedEnvTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    encrypted_env_ = NewRocksDBEncryptedEnv(&universe_key_manager_);
+  }
+
+  void TearDown() override {
+    db_.reset();
+    YBTest::TearDown();
+  }
+
+  // Adds a new universe key version and makes it the latest one.
+  void RotateUniverseKey(const std::string& version_id) {
+    auto key = ASSERT_RESULT(EncryptionParams::NewRandom());
+    registry_.set_encryption_enabled(true);
+    key->ToPB(&(*registry_.mutable_universe_keys())[version_id]);
+    registry_.set_latest_version_id(version_id);
+    universe_key_manager_.SetUniverseKeyRegistry(registry_);
+  }
+
+  void OpenDB(rocksdb::Env* env, const std::string& name) {
+    db_.reset();
+    options_.create_if_missing = true;
+    options_.env = env;
+    options_.statistics = rocksdb::CreateDBStatistics();
+    rocksdb::DB* db = nullptr;
+    ASSERT_OK(rocksdb::DB::Open(options_, GetTestPath(name), &db));
+    db_.reset(db);
+  }
+
+  // Writes num_flushes SST files of keys [0, num_keys).
+  void WriteKeys(int num_keys, int num_flushes) {
+    for (int flush = 0; flush != num_flushes; ++flush) {
+      for (int i = 0; i != num_keys; ++i) {
+        ASSERT_OK(db_->Put(rocksdb::WriteOptions(), Key(i), Value(i, flush)));
+      }
+      ASSERT_OK(db_->Flush(rocksdb::FlushOptions()));
+    }
+  }
+
+  void CheckKeys(int num_keys, int flush) {
+    for (int i = 0; i != num_keys; ++i) {
+      std::string value;
+      ASSERT_OK(db_->Get(rocksdb::ReadOptions(), Key(i), &value));
+      ASSERT_EQ(Value(i, flush), value);
+    }
+  }
+
+  static std::string Key(int i) {
+    return Format("key_$0", i);
+  }
+
+  static std::string Value(int i, int flush) {
+    return Format("value_$0_$1_$2", i, flush, std::string(100, 'x'));
+  }
+
+  // Returns the universe key version of the SST file and its data file, or empty string if they
+  // are plaintext.
+  std::string UniverseKeyIdOfSst(const rocksdb::LiveFileMetaData& file) {
+    std::string result;
+    const auto base_path = file.db_path + file.name;
+    for (const auto& path : {base_path, rocksdb::TableBaseToDataFileName(base_path)}) {
+      faststring raw;
+      CHECK_OK(ReadFileToString(env_.get(), path, &raw));
+      const size_t pb_offset = kEncryptionMagicSize + sizeof(uint32_t);
+      if (!HasEncryptionMagic(Slice(raw))) {
+        return std::string();
+      }
+      EncryptionHeaderPB header;
+      CHECK(header.ParseFromArray(
+          raw.data() + pb_offset, DecodeFixed32(raw.data() + kEncryptionMagicSize)));
+      CHECK(result.empty() || result == header.universe_key_id());
+      result = header.universe_key_id();
+    }
+    return result;
+  }
+
+  std::vector<std::string> UniverseKeyIdsOfSsts() {
+    std::vector<rocksdb::LiveFileMetaData> files;
+    db_->GetLiveFilesMetaData(&files);
+    std::vector<std::string> result;
+    for (const auto& file : files) {
+      result.push_back(UniverseKeyIdOfSst(file));
+    }
+    return result;
+  }
+
+  UniverseKeyManager universe_key_manager_;
+  UniverseKeyRegistryPB registry_;
+  std::unique_ptr<rocksdb::Env> encrypted_env_;
+  rocksdb::Options options_;
+  std::unique_ptr<rocksdb::DB> db_;
+};
+
+TEST_F(RocksDBEncryptedEnvTest, FlushAndCompaction) {
+  constexpr int kNumKeys = 1000;
+  constexpr int kNumFlushes = 3;
+  RotateUniverseKey("v1");
+  OpenDB(encrypted_env_.get(), "db");
+  ASSERT_FALSE(encrypted_env_->IsPlainText());
+  WriteKeys(kNumKeys, kNumFlushes);
+  ASSERT_EQ(std::vector<std::string>(kNumFlushes, "v1"), UniverseKeyIdsOfSsts());
+  CheckKeys(kNumKeys, kNumFlushes - 1);
+
+  // Blocks are decrypted below the block cache, so the second pass is served by the cache.
+  auto hits = options_.statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT);
+  CheckKeys(kNumKeys, kNumFlushes - 1);
+  ASSERT_GT(options_.statistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT), hits + kNumKeys / 2);
+
+  // Compaction re-encrypts the data with the latest universe key.
+  RotateUniverseKey("v2");
+  ASSERT_OK(db_->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(std::vector<std::string>(1, "v2"), UniverseKeyIdsOfSsts());
+  CheckKeys(kNumKeys, kNumFlushes - 1);
+
+  OpenDB(encrypted_env_.get(), "db");
+  CheckKeys(kNumKeys, kNumFlushes - 1);
+}
+
+// Files of the database written before encryption was enabled stay readable, and are encrypted
+// when rewritten.
+TEST_F(RocksDBEncryptedEnvTest, EnableEncryption) {
+  constexpr int kNumKeys = 1000;
+  OpenDB(rocksdb::Env::Default(), "db");
+  WriteKeys(kNumKeys, 2);
+  ASSERT_EQ(std::vector<std::string>(2, ""), UniverseKeyIdsOfSsts());
+
+  RotateUniverseKey("v1");
+  OpenDB(encrypted_env_.get(), "db");
+  CheckKeys(kNumKeys, 1);
+  ASSERT_OK(db_->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(std::vector<std::string>(1, "v1"), UniverseKeyIdsOfSsts());
+  CheckKeys(kNumKeys, 1);
+}
+
+// Compares the time of flushes and a full compaction with and without encryption.
+TEST_F(RocksDBEncryptedEnvTest, BenchmarkCompaction) {
+  const int kNumKeys = AllowSlowTests() ? 1000000 : 100000;
+  constexpr int kNumFlushes = 4;
+  RotateUniverseKey("v1");
+
+  auto run = [this, kNumKeys](rocksdb::Env* env, const std::string& name) {
+    OpenDB(env, name);
+    auto start = MonoTime::Now();
+    WriteKeys(kNumKeys, kNumFlushes);
+    auto compaction_start = MonoTime::Now();
+    CHECK_OK(db_->CompactRange(rocksdb::CompactRangeOptions(), nullptr, nullptr));
+    auto compaction_time = MonoTime::Now() - compaction_start;
+    LOG(INFO) << name << ": writes with flushes: " << compaction_start - start
+              << ", compaction: " << compaction_time;
+    db_.reset();
+    return compaction_time;
+  };
+
+  auto plaintext_time = run(rocksdb::Env::Default(), "plaintext");
+  auto encrypted_time = run(encrypted_env_.get(), "encrypted");
+  LOG(INFO) << "Compaction encryption overhead: "
+            << (encrypted_time.ToSeconds() / plaintext_time.ToSeconds() - 1) * 100 << "%";
+}
+
+} // namespace yb
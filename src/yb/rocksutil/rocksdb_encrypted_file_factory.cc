@@ -0,0 +1,214 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rocksutil/rocksdb_encrypted_file_factory.h"
+
+#include "yb/util/universe_key_manager.h"
+
+namespace yb {
+
+namespace {
+
+// Offsets of the users of encrypted files exclude the header.
+class RocksDBEncryptedSequentialFile : public rocksdb::SequentialFileWrapper {
+ public:
+  RocksDBEncryptedSequentialFile(std::unique_ptr<rocksdb::SequentialFile> file,
+                                 BlockAccessCipherStreamPtr stream)
+      : SequentialFileWrapper(std::move(file)), stream_(std::move(stream)) {}
+
+  CHECKED_STATUS Read(size_t n, Slice* result, char* scratch) override {
+    RETURN_NOT_OK(SequentialFileWrapper::Read(n, result, scratch));
+    RETURN_NOT_OK(stream_->Decrypt(offset_, result->data(), scratch, result->size()));
+    *result = Slice(scratch, result->size());
+    offset_ += result->size();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Skip(uint64_t n) override {
+    RETURN_NOT_OK(SequentialFileWrapper::Skip(n));
+    offset_ += n;
+    return Status::OK();
+  }
+
+  CHECKED_STATUS InvalidateCache(size_t offset, size_t length) override {
+    return SequentialFileWrapper::InvalidateCache(offset + kEncryptionHeaderSize, length);
+  }
+
+ private:
+  BlockAccessCipherStreamPtr stream_;
+  uint64_t offset_ = 0;
+};
+
+class RocksDBEncryptedRandomAccessFile : public rocksdb::RandomAccessFileWrapper {
+ public:
+  RocksDBEncryptedRandomAccessFile(std::unique_ptr<rocksdb::RandomAccessFile> file,
+                                   BlockAccessCipherStreamPtr stream)
+      : RandomAccessFileWrapper(std::move(file)), stream_(std::move(stream)) {}
+
+  CHECKED_STATUS Read(uint64_t offset, size_t n, Slice* result, char* scratch) const override {
+    RETURN_NOT_OK(RandomAccessFileWrapper::Read(
+        offset + kEncryptionHeaderSize, n, result, scratch));
+    RETURN_NOT_OK(stream_->Decrypt(offset, result->data(), scratch, result->size()));
+    *result = Slice(scratch, result->size());
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Prefetch(uint64_t offset, size_t n) override {
+    return RandomAccessFileWrapper::Prefetch(offset + kEncryptionHeaderSize, n);
+  }
+
+  CHECKED_STATUS InvalidateCache(size_t offset, size_t length) override {
+    return RandomAccessFileWrapper::InvalidateCache(offset + kEncryptionHeaderSize, length);
+  }
+
+ private:
+  BlockAccessCipherStreamPtr stream_;
+};
+
+class RocksDBEncryptedWritableFile : public rocksdb::WritableFileWrapper {
+ public:
+  RocksDBEncryptedWritableFile(std::unique_ptr<rocksdb::WritableFile> file,
+                               BlockAccessCipherStreamPtr stream)
+      : WritableFileWrapper(std::move(file)), stream_(std::move(stream)) {}
+
+  CHECKED_STATUS Append(const Slice& data) override {
+    buffer_.resize(data.size());
+    RETURN_NOT_OK(stream_->Encrypt(offset_, data.data(), &buffer_[0], data.size()));
+    RETURN_NOT_OK(WritableFileWrapper::Append(buffer_));
+    offset_ += data.size();
+    return Status::OK();
+  }
+
+  // The header is a whole page, so aligned direct writes stay aligned.
+  CHECKED_STATUS PositionedAppend(const Slice& data, uint64_t offset) override {
+    buffer_.resize(data.size());
+    RETURN_NOT_OK(stream_->Encrypt(offset, data.data(), &buffer_[0], data.size()));
+    RETURN_NOT_OK(WritableFileWrapper::PositionedAppend(buffer_, offset + kEncryptionHeaderSize));
+    offset_ = offset + data.size();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Truncate(uint64_t size) override {
+    return WritableFileWrapper::Truncate(size + kEncryptionHeaderSize);
+  }
+
+  uint64_t GetFileSize() override {
+    return WritableFileWrapper::GetFileSize() - kEncryptionHeaderSize;
+  }
+
+  CHECKED_STATUS InvalidateCache(size_t offset, size_t length) override {
+    return WritableFileWrapper::InvalidateCache(offset + kEncryptionHeaderSize, length);
+  }
+
+ protected:
+  CHECKED_STATUS Allocate(uint64_t offset, uint64_t len) override {
+    return WritableFileWrapper::Allocate(offset + kEncryptionHeaderSize, len);
+  }
+
+  CHECKED_STATUS RangeSync(uint64_t offset, uint64_t nbytes) override {
+    return WritableFileWrapper::RangeSync(offset + kEncryptionHeaderSize, nbytes);
+  }
+
+ private:
+  BlockAccessCipherStreamPtr stream_;
+  // Plaintext offset of the next append.
+  uint64_t offset_ = 0;
+  std::string buffer_;
+};
+
+} // namespace
+
+Result<BlockAccessCipherStreamPtr> RocksDBEncryptedFileFactory::ReadHeader(
+    const rocksdb::RandomAccessFile& file) {
+  char header[kEncryptionHeaderSize];
+  Slice header_slice;
+  RETURN_NOT_OK(file.Read(0, kEncryptionHeaderSize, &header_slice, header));
+  return CipherStreamFromHeader(header_slice, universe_key_manager_);
+}
+
+Status RocksDBEncryptedFileFactory::NewSequentialFile(
+    const std::string& fname, std::unique_ptr<rocksdb::SequentialFile>* result,
+    const rocksdb::EnvOptions& options) {
+  // Sequential file could not return to the beginning, so the header is read separately.
+  std::unique_ptr<rocksdb::RandomAccessFile> header_file;
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::NewRandomAccessFile(fname, &header_file, options));
+  auto stream = VERIFY_RESULT(ReadHeader(*header_file));
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::NewSequentialFile(fname, result, options));
+  if (stream) {
+    RETURN_NOT_OK((*result)->Skip(kEncryptionHeaderSize));
+    *result = std::make_unique<RocksDBEncryptedSequentialFile>(
+        std::move(*result), std::move(stream));
+  }
+  return Status::OK();
+}
+
+Status RocksDBEncryptedFileFactory::NewRandomAccessFile(
+    const std::string& fname, std::unique_ptr<rocksdb::RandomAccessFile>* result,
+    const rocksdb::EnvOptions& options) {
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::NewRandomAccessFile(fname, result, options));
+  auto stream = VERIFY_RESULT(ReadHeader(**result));
+  if (stream) {
+    *result = std::make_unique<RocksDBEncryptedRandomAccessFile>(
+        std::move(*result), std::move(stream));
+  }
+  return Status::OK();
+}
+
+Status RocksDBEncryptedFileFactory::NewWritableFile(
+    const std::string& fname, std::unique_ptr<rocksdb::WritableFile>* result,
+    const rocksdb::EnvOptions& options) {
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::NewWritableFile(fname, result, options));
+  return WrapWritableFile(result);
+}
+
+Status RocksDBEncryptedFileFactory::ReuseWritableFile(
+    const std::string& fname, const std::string& old_fname,
+    std::unique_ptr<rocksdb::WritableFile>* result, const rocksdb::EnvOptions& options) {
+  // The reused file is overwritten from the beginning, so it gets a new header and key.
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::ReuseWritableFile(fname, old_fname, result, options));
+  return WrapWritableFile(result);
+}
+
+Status RocksDBEncryptedFileFactory::WrapWritableFile(
+    std::unique_ptr<rocksdb::WritableFile>* result) {
+  std::string header;
+  auto stream = VERIFY_RESULT(CreateNewFileCipherStream(universe_key_manager_, &header));
+  if (stream) {
+    RETURN_NOT_OK((*result)->Append(header));
+    *result = std::make_unique<RocksDBEncryptedWritableFile>(
+        std::move(*result), std::move(stream));
+  }
+  return Status::OK();
+}
+
+Status RocksDBEncryptedFileFactory::GetFileSize(const std::string& fname, uint64_t* size) {
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::GetFileSize(fname, size));
+  std::unique_ptr<rocksdb::RandomAccessFile> file;
+  RETURN_NOT_OK(RocksDBFileFactoryWrapper::NewRandomAccessFile(
+      fname, &file, rocksdb::EnvOptions()));
+  // Only the magic is checked, so the size is known even before the universe key is received.
+  char magic[kEncryptionMagicSize];
+  Slice magic_slice;
+  RETURN_NOT_OK(file->Read(0, sizeof(magic), &magic_slice, magic));
+  if (HasEncryptionMagic(magic_slice)) {
+    *size -= kEncryptionHeaderSize;
+  }
+  return Status::OK();
+}
+
+std::unique_ptr<rocksdb::Env> NewRocksDBEncryptedEnv(UniverseKeyManager* universe_key_manager) {
+  return rocksdb::Env::NewRocksDBDefaultEnv(std::make_unique<RocksDBEncryptedFileFactory>(
+      rocksdb::Env::DefaultFileFactory(), universe_key_manager));
+}
+
+} // namespace yb
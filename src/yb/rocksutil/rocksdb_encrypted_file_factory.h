@@ -0,0 +1,75 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_ROCKSUTIL_ROCKSDB_ENCRYPTED_FILE_FACTORY_H
+#define YB_ROCKSUTIL_ROCKSDB_ENCRYPTED_FILE_FACTORY_H
+
+#include <memory>
+#include <string>
+
+#include "yb/rocksdb/env.h"
+
+#include "yb/util/encryption_util.h"
+
+namespace yb {
+
+class UniverseKeyManager;
+
+// RocksDB counterpart of EncryptedFileFactory, used for SST files, manifests and the other files
+// of RocksDB. Files are decrypted below the block cache, so cached blocks are plaintext and a
+// cache hit costs the same as without encryption.
+class RocksDBEncryptedFileFactory : public rocksdb::RocksDBFileFactoryWrapper {
+ public:
+  RocksDBEncryptedFileFactory(rocksdb::RocksDBFileFactory* file_factory,
+                              UniverseKeyManager* universe_key_manager)
+      : RocksDBFileFactoryWrapper(file_factory), universe_key_manager_(universe_key_manager) {}
+
+  CHECKED_STATUS NewSequentialFile(const std::string& fname,
+                                   std::unique_ptr<rocksdb::SequentialFile>* result,
+                                   const rocksdb::EnvOptions& options) override;
+
+  CHECKED_STATUS NewRandomAccessFile(const std::string& fname,
+                                     std::unique_ptr<rocksdb::RandomAccessFile>* result,
+                                     const rocksdb::EnvOptions& options) override;
+
+  CHECKED_STATUS NewWritableFile(const std::string& fname,
+                                 std::unique_ptr<rocksdb::WritableFile>* result,
+                                 const rocksdb::EnvOptions& options) override;
+
+  CHECKED_STATUS ReuseWritableFile(const std::string& fname,
+                                   const std::string& old_fname,
+                                   std::unique_ptr<rocksdb::WritableFile>* result,
+                                   const rocksdb::EnvOptions& options) override;
+
+  CHECKED_STATUS GetFileSize(const std::string& fname, uint64_t* size) override;
+
+  bool IsPlainText() const override {
+    return false;
+  }
+
+ private:
+  // Returns the cipher stream of the file, or nullptr if it is plaintext.
+  Result<BlockAccessCipherStreamPtr> ReadHeader(const rocksdb::RandomAccessFile& file);
+
+  CHECKED_STATUS WrapWritableFile(std::unique_ptr<rocksdb::WritableFile>* result);
+
+  UniverseKeyManager* universe_key_manager_;
+};
+
+// Returns the env that stores files through RocksDBEncryptedFileFactory over the default file
+// factory.
+std::unique_ptr<rocksdb::Env> NewRocksDBEncryptedEnv(UniverseKeyManager* universe_key_manager);
+
+} // namespace yb
+
+#endif // YB_ROCKSUTIL_ROCKSDB_ENCRYPTED_FILE_FACTORY_H
@@ -14,6 +14,10 @@
 #ifndef YB_RPC_CALL_DATA_H
 #define YB_RPC_CALL_DATA_H
 
+#include <stdlib.h>
+
+#include <algorithm>
+
 namespace yb {
 namespace rpc {
 
@@ -63,6 +67,11 @@ struct CallData {
     return size_;
   }
 
+  // Drops data after new_size bytes, allocated memory is not released.
+  void Shrink(size_t new_size) {
+    size_ = std::min(size_, new_size);
+  }
+
  private:
   char* data_;
   size_t size_;
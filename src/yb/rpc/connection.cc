@@ -68,6 +68,13 @@ METRIC_DEFINE_histogram(
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Granularity of call timeouts, call could time out up to kExpirationTick later than requested.
+const auto kExpirationTick = 5ms;
+
+} // namespace
+
 ///
 /// Connection
 ///
@@ -80,6 +87,7 @@ Connection::Connection(Reactor* reactor,
       stream_(std::move(stream)),
       direction_(direction),
       last_activity_time_(CoarseMonoClock::Now()),
+      expiration_wheel_(kExpirationTick, last_activity_time_),
       rpc_metrics_(rpc_metrics),
       context_(std::move(context)) {
   const auto metric_entity = reactor->messenger()->metric_entity();
@@ -128,6 +136,7 @@ void Connection::Shutdown(const Status& status) {
     outbound_data_being_processed_.swap(outbound_data_to_process_);
     shutdown_status_ = status;
   }
+  shut_down_.store(true, std::memory_order_release);
 
   // Clear any calls which have been sent and were awaiting a response.
   for (auto& v : awaiting_response_) {
@@ -185,26 +194,21 @@ void Connection::HandleTimeout(ev::timer& watcher, int revents) {  // NOLINT
     }
   }
 
-  while (!expiration_queue_.empty() && expiration_queue_.top().time <= now) {
-    auto& top = expiration_queue_.top();
-    auto call = top.call.lock();
-    auto handle = top.handle;
-    expiration_queue_.pop();
+  expiration_wheel_.Advance(now, [this](const ExpirationEntry& entry) {
+    auto call = entry.call.lock();
     if (call && !call->IsFinished()) {
       call->SetTimedOut();
-      if (handle != std::numeric_limits<size_t>::max()) {
-        stream_->Cancelled(handle);
+      if (entry.handle != std::numeric_limits<size_t>::max()) {
+        stream_->Cancelled(entry.handle);
       }
       auto i = awaiting_response_.find(call->call_id());
       if (i != awaiting_response_.end()) {
         i->second.reset();
       }
     }
-  }
+  });
 
-  if (!expiration_queue_.empty()) {
-    deadline = std::min(deadline, expiration_queue_.top().time);
-  }
+  deadline = std::min(deadline, expiration_wheel_.NextExpiration());
 
   if (deadline != CoarseTimePoint::max()) {
     StartTimer(deadline - now, &timer_);
@@ -220,12 +224,15 @@ void Connection::QueueOutboundCall(const OutboundCallPtr& call) {
   // Set up the timeout timer.
   const MonoDelta& timeout = call->controller()->timeout();
   if (timeout.Initialized()) {
-    auto expires_at = CoarseMonoClock::Now() + timeout.ToSteadyDuration();
-    auto reschedule = expiration_queue_.empty() || expiration_queue_.top().time > expires_at;
-    expiration_queue_.push({expires_at, call, handle});
-    if (reschedule && (stream_->IsConnected() ||
-                       expires_at < last_activity_time_ + FLAGS_rpc_connection_timeout_ms * 1ms)) {
-      StartTimer(timeout.ToSteadyDuration(), &timer_);
+    auto now = CoarseMonoClock::Now();
+    auto expires_at = now + timeout.ToSteadyDuration();
+    auto old_expiration = expiration_wheel_.NextExpiration();
+    expiration_wheel_.Insert(expires_at, ExpirationEntry{call, handle});
+    auto new_expiration = expiration_wheel_.NextExpiration();
+    if (new_expiration < old_expiration &&
+        (stream_->IsConnected() ||
+         new_expiration < last_activity_time_ + FLAGS_rpc_connection_timeout_ms * 1ms)) {
+      StartTimer(std::max<CoarseDuration>(new_expiration - now, CoarseDuration::zero()), &timer_);
     }
   }
 
@@ -252,7 +259,7 @@ size_t Connection::DoQueueOutboundData(OutboundDataPtr outbound_data, bool batch
     Shutdown(s);
     return std::numeric_limits<size_t>::max();
   }
-  auto result = stream_->Send(std::move(outbound_data));
+  auto result = stream_->Send(context_->PrepareOutboundData(this, std::move(outbound_data)));
   s = context_->ReportPendingWriteBytes(stream_->GetPendingWriteBytes());
   if (!s.ok()) {
     Shutdown(s);
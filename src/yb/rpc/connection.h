@@ -37,7 +37,6 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
-#include <queue>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -64,6 +63,7 @@
 #include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/status.h"
 #include "yb/util/strongly_typed_bool.h"
+#include "yb/util/timer_wheel.h"
 
 namespace yb {
 namespace rpc {
@@ -127,6 +127,12 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // same Status).
   void Shutdown(const Status& status);
 
+  // Whether Shutdown() was called, e.g. because the remote side closed the connection.
+  // Could be called from any thread.
+  bool IsShutdown() const {
+    return shut_down_.load(std::memory_order_acquire);
+  }
+
   // Queue a new call to be made. If the queueing fails, the call will be
   // marked failed.
   // Takes ownership of the 'call' object regardless of whether it succeeds or fails.
@@ -225,6 +231,9 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   // outbound_data_queue_lock_.
   Status shutdown_status_;
 
+  // Set upon Shutdown(), could be read without lock from any thread.
+  std::atomic<bool> shut_down_{false};
+
   // We instantiate and store this metric instance at the level of connection, but not at the level
   // of the class emitting metrics (OutboundTransfer) as recommended in metrics.h. This is on
   // purpose, because OutboundTransfer is instantiated each time we need to send payload over a
@@ -234,21 +243,13 @@ class Connection final : public StreamContext, public std::enable_shared_from_th
   scoped_refptr<Histogram> handler_latency_outbound_transfer_;
 
   struct ExpirationEntry {
-    CoarseTimePoint time;
     std::weak_ptr<OutboundCall> call;
     // See Stream::Send for details.
     size_t handle;
   };
 
-  struct CompareExpiration {
-    bool operator()(const ExpirationEntry& lhs, const ExpirationEntry& rhs) const {
-      return rhs.time < lhs.time;
-    }
-  };
-
-  std::priority_queue<ExpirationEntry,
-                      std::vector<ExpirationEntry>,
-                      CompareExpiration> expiration_queue_;
+  // Call timeouts. Finished calls are not removed, they are skipped when expired.
+  TimerWheel<ExpirationEntry, CoarseTimePoint> expiration_wheel_;
   ev::timer timer_;
 
   simple_spinlock outbound_data_queue_lock_;
@@ -78,6 +78,12 @@ class ConnectionContext {
   virtual void UpdateLastRead(const ConnectionPtr& connection);
 
   virtual void UpdateLastWrite(const ConnectionPtr& connection) {}
+
+  // Invoked in reactor thread before data is sent, allows context to transform it, for instance
+  // compress.
+  virtual OutboundDataPtr PrepareOutboundData(Connection* connection, OutboundDataPtr data) {
+    return data;
+  }
 };
 
 class ConnectionContextBase : public ConnectionContext {
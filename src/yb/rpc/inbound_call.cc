@@ -41,12 +41,14 @@
 #include "yb/rpc/rpc_introspection.pb.h"
 #include "yb/rpc/rpc_metrics.h"
 #include "yb/rpc/serialization.h"
+#include "yb/rpc/service_if.h"
 #include "yb/rpc/service_pool.h"
 
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/metrics.h"
+#include "yb/util/sampled_trace.h"
 #include "yb/util/trace.h"
 #include "yb/util/memory/memory.h"
 
@@ -101,6 +103,11 @@ InboundCall::~InboundCall() {
 void InboundCall::NotifyTransferred(const Status& status, Connection* conn) {
   if (status.ok()) {
     TRACE_TO(trace_, "Transfer finished");
+    timing_.time_response_transferred = MonoTime::Now();
+    if (response_latency_ && timing_.time_response_queued.Initialized()) {
+      response_latency_->Increment(
+          (timing_.time_response_transferred - timing_.time_response_queued).ToMicroseconds());
+    }
   } else {
     YB_LOG_EVERY_N_SECS(WARNING, 10) << LogPrefix() << "Connection torn down before " << ToString()
                                      << " could send its response: " << status.ToString();
@@ -138,6 +145,7 @@ void InboundCall::RecordCallReceived() {
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_received.Initialized()) << "Already marked as received";
   VLOG_WITH_PREFIX(4) << "Received";
   timing_.time_received = MonoTime::Now();
+  SAMPLED_TRACE_TO(trace_, "rpc.call_received", 0);
 }
 
 void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_time) {
@@ -146,8 +154,17 @@ void InboundCall::RecordHandlingStarted(scoped_refptr<Histogram> incoming_queue_
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_handled.Initialized()) << "Already marked as started";
   timing_.time_handled = MonoTime::Now();
   VLOG_WITH_PREFIX(4) << "Handling";
-  incoming_queue_time->Increment(
-      timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds());
+  auto queue_time_us = timing_.time_handled.GetDeltaSince(timing_.time_received).ToMicroseconds();
+  incoming_queue_time->Increment(queue_time_us);
+  SAMPLED_TRACE_TO(trace_, "rpc.handling_started", queue_time_us);
+}
+
+void InboundCall::RecordCallParsed() {
+  timing_.time_parsed = MonoTime::Now();
+}
+
+void InboundCall::RecordCallQueued() {
+  timing_.time_queued = MonoTime::Now();
 }
 
 MonoDelta InboundCall::GetTimeInQueue() const {
@@ -159,9 +176,51 @@ void InboundCall::RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_t
   LOG_IF_WITH_PREFIX(DFATAL, timing_.time_completed.Initialized()) << "Already marked as completed";
   timing_.time_completed = MonoTime::Now();
   VLOG_WITH_PREFIX(4) << "Completed handling";
+  auto handler_run_time_us = (timing_.time_completed - timing_.time_handled).ToMicroseconds();
   if (handler_run_time) {
-    handler_run_time->Increment((timing_.time_completed - timing_.time_handled).ToMicroseconds());
+    handler_run_time->Increment(handler_run_time_us);
   }
+  SAMPLED_TRACE_TO(trace_, "rpc.handling_completed", handler_run_time_us);
+}
+
+void InboundCall::RecordHandlingCompleted(const RpcMethodMetrics& metrics) {
+  RecordHandlingCompleted(metrics.handler_latency);
+  if (timing_.time_queued.Initialized()) {
+    if (metrics.dispatch_latency) {
+      metrics.dispatch_latency->Increment(
+          (timing_.time_queued - timing_.time_received).ToMicroseconds());
+    }
+    if (metrics.queue_latency && timing_.time_handled.Initialized()) {
+      metrics.queue_latency->Increment(
+          (timing_.time_handled - timing_.time_queued).ToMicroseconds());
+    }
+  }
+  response_latency_ = metrics.response_latency;
+}
+
+void InboundCall::DumpTimingPB(RpcCallTimingPB* pb) const {
+  if (timing_.time_parsed.Initialized()) {
+    pb->set_parsed_micros((timing_.time_parsed - timing_.time_received).ToMicroseconds());
+  }
+  if (timing_.time_queued.Initialized()) {
+    pb->set_queued_micros((timing_.time_queued - timing_.time_received).ToMicroseconds());
+  }
+  pb->set_handling_started(processing_started_.load(std::memory_order_acquire));
+}
+
+std::string InboundCall::TimingToString() const {
+  auto delta = [](const MonoTime& from, const MonoTime& to) -> std::string {
+    if (!from.Initialized() || !to.Initialized()) {
+      return "n/a";
+    }
+    return Format("$0us", (to - from).ToMicroseconds());
+  };
+  return Format("parse: $0, dispatch: $1, queue: $2, handler: $3, respond: $4",
+                delta(timing_.time_received, timing_.time_parsed),
+                delta(timing_.time_parsed, timing_.time_queued),
+                delta(timing_.time_queued, timing_.time_handled),
+                delta(timing_.time_handled, timing_.time_completed),
+                delta(timing_.time_completed, timing_.time_response_queued));
 }
 
 bool InboundCall::ClientTimedOut() const {
@@ -173,9 +232,19 @@ bool InboundCall::ClientTimedOut() const {
   return deadline < CoarseMonoClock::now();
 }
 
+bool InboundCall::ClientDisconnected() const {
+  return conn_ && conn_->IsShutdown();
+}
+
 void InboundCall::QueueResponse(bool is_success) {
   TRACE_TO(trace_, is_success ? "Queueing success response" : "Queueing failure response");
+  timing_.time_response_queued = MonoTime::Now();
   LogTrace();
+  SAMPLED_TRACE_TO(trace_, "rpc.response_queued", is_success);
+  SampledTrace::CaptureIfSlow(
+      trace_->id(), timing_.time_received, MonoTime::Now(), [this] {
+    return Format("$0, $1", ToString(), TimingToString());
+  });
   bool expected = false;
   if (responded_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
     connection()->context().QueueResponse(connection(), shared_from(this));
@@ -57,6 +57,7 @@
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/size_class_pool.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 
@@ -75,13 +76,18 @@ namespace rpc {
 
 class DumpRunningRpcsRequestPB;
 class RpcCallInProgressPB;
+class RpcCallTimingPB;
 class RpcCallDetailsPB;
 class CQLCallDetailsPB;
 
 struct InboundCallTiming {
   MonoTime time_received;   // Time the call was first accepted.
+  MonoTime time_parsed;     // Time the call header was parsed.
+  MonoTime time_queued;     // Time the call was queued to the service.
   MonoTime time_handled;    // Time the call handler was kicked off.
   MonoTime time_completed;  // Time the call handler completed.
+  MonoTime time_response_queued;       // Time the response was queued to the connection.
+  MonoTime time_response_transferred;  // Time the response was written to the socket.
 };
 
 class InboundCallHandler {
@@ -121,6 +127,11 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // Not thread-safe. Should only be called by the current "owner" thread.
   void RecordCallReceived();
 
+  // When the call header was parsed and the call was queued to the service.
+  // Not thread-safe. Should only be called by the current "owner" thread.
+  void RecordCallParsed();
+  void RecordCallQueued();
+
   // When RPC call Handle() was called on the server side.
   // Updates the Histogram with time elapsed since the call was received,
   // and should only be called once on a given instance.
@@ -133,11 +144,18 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // Not thread-safe. Should only be called by the current "owner" thread.
   void RecordHandlingCompleted(scoped_refptr<Histogram> handler_run_time);
 
+  // Same as above, but also updates latency breakdown histograms of the called method.
+  void RecordHandlingCompleted(const RpcMethodMetrics& metrics);
+
   // Return true if the deadline set by the client has already elapsed.
   // In this case, the server may stop processing the call, since the
   // call response will be ignored anyway.
   bool ClientTimedOut() const;
 
+  // Return true if the connection the call was received on is closed, so the response could not
+  // be delivered and the server may stop processing the call.
+  bool ClientDisconnected() const;
+
   // Return an upper bound on the client timeout deadline. This does not
   // account for transmission delays between the client and the server.
   // If the client did not specify a deadline, returns MonoTime::Max().
@@ -172,7 +190,7 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   template <class T, class ...Args>
   static std::shared_ptr<T> Create(Args&&... args) {
-    auto result = std::make_shared<T>(std::forward<Args>(args)...);
+    auto result = std::allocate_shared<T>(SizeClassAllocator<T>(), std::forward<Args>(args)...);
     result->RecordCallReceived();
     return result;
   }
@@ -198,6 +216,13 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
 
   void QueueResponse(bool is_success);
 
+  // Fills timing of the call for rpcz. Only stages recorded by the reactor thread are dumped,
+  // since it is the thread which dumps running calls.
+  void DumpTimingPB(RpcCallTimingPB* pb) const;
+
+  // Returns latency breakdown of the call, should be invoked after handling was completed.
+  std::string TimingToString() const;
+
   // The serialized bytes of the request param protobuf. Set by ParseFrom().
   // This references memory held by 'transfer_'.
   Slice serialized_request_;
@@ -211,6 +236,9 @@ class InboundCall : public RpcCall, public MPSCQueueEntry<InboundCall> {
   // Timing information related to this RPC call.
   InboundCallTiming timing_;
 
+  // Updated when response is transferred, set by RecordHandlingCompleted.
+  scoped_refptr<Histogram> response_latency_;
+
   std::atomic<bool> processing_started_{false};
 
   std::atomic<bool> responded_{false};
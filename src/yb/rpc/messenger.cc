@@ -69,6 +69,7 @@
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
 #include "yb/util/net/socket.h"
+#include "yb/util/os-util.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/threadpool.h"
@@ -94,6 +95,34 @@ DEFINE_int64(outbound_rpc_memory_limit, 0, "Outbound RPC memory limit");
 
 DEFINE_int32(rpc_queue_limit, 10000, "Queue limit for rpc server");
 DEFINE_int32(rpc_workers_limit, 256, "Workers limit for rpc server");
+DEFINE_int32(rpc_low_priority_workers_percentage, 25,
+             "Workers limit for low priority (bulk) rpc calls, as a percentage of "
+             "rpc_workers_limit. Low priority calls are executed by a separate thread pool, "
+             "so they could not occupy all workers of latency sensitive calls.");
+TAG_FLAG(rpc_low_priority_workers_percentage, advanced);
+
+DEFINE_string(rpc_reactor_cpus, "",
+              "Cpus to pin reactor threads to, in the taskset format, e.g. 0-3,8. "
+              "Reactors of a messenger are pinned one per cpu, round robin. "
+              "Empty means that reactors are not pinned.");
+TAG_FLAG(rpc_reactor_cpus, advanced);
+DEFINE_string(rpc_worker_cpus, "",
+              "Cpus that normal and low priority rpc workers are restricted to, in the taskset "
+              "format. Empty means no restriction.");
+TAG_FLAG(rpc_worker_cpus, advanced);
+DEFINE_string(rpc_high_priority_worker_cpus, "",
+              "Cpus that high priority rpc workers, i.e. consensus service, are restricted to, in "
+              "the taskset format. Together with log_append_cpus it could be used to reserve cpus "
+              "for consensus and WAL, by excluding them from rpc_reactor_cpus and rpc_worker_cpus. "
+              "Empty means no restriction.");
+TAG_FLAG(rpc_high_priority_worker_cpus, advanced);
+
+static bool rpc_reactor_cpus_dummy = google::RegisterFlagValidator(
+    &FLAGS_rpc_reactor_cpus, &yb::ValidateCpuListFlag);
+static bool rpc_worker_cpus_dummy = google::RegisterFlagValidator(
+    &FLAGS_rpc_worker_cpus, &yb::ValidateCpuListFlag);
+static bool rpc_high_priority_worker_cpus_dummy = google::RegisterFlagValidator(
+    &FLAGS_rpc_high_priority_worker_cpus, &yb::ValidateCpuListFlag);
 
 DEFINE_int32(socket_receive_buffer_size, 0, "Socket receive buffer size, 0 to use default");
 
@@ -379,23 +408,36 @@ rpc::ThreadPool& Messenger::ThreadPool(ServicePriority priority) {
     case ServicePriority::kNormal:
       return *normal_thread_pool_;
     case ServicePriority::kHigh:
-      auto high_priority_thread_pool = high_priority_thread_pool_.get();
-      if (high_priority_thread_pool) {
-        return *high_priority_thread_pool;
-      }
-      std::lock_guard<std::mutex> lock(mutex_high_priority_thread_pool_);
-      high_priority_thread_pool = high_priority_thread_pool_.get();
-      if (high_priority_thread_pool) {
-        return *high_priority_thread_pool;
-      }
-      const ThreadPoolOptions& options = normal_thread_pool_->options();
-      high_priority_thread_pool_.reset(new rpc::ThreadPool(
-          name_ + "-high-pri", options.queue_limit, options.max_workers));
-      return *high_priority_thread_pool_.get();
+      return LazyThreadPool(
+          &high_priority_thread_pool_, "-high-pri", 100,
+          CpuListFromFlag(FLAGS_rpc_high_priority_worker_cpus));
+    case ServicePriority::kLow:
+      return LazyThreadPool(
+          &low_priority_thread_pool_, "-low-pri", FLAGS_rpc_low_priority_workers_percentage,
+          normal_thread_pool_->options().cpus);
   }
   FATAL_INVALID_ENUM_VALUE(ServicePriority, priority);
 }
 
+rpc::ThreadPool& Messenger::LazyThreadPool(
+    AtomicUniquePtr<rpc::ThreadPool>* pool, const char* suffix, int workers_percentage,
+    std::vector<int> cpus) {
+  auto result = pool->get();
+  if (result) {
+    return *result;
+  }
+  std::lock_guard<std::mutex> lock(mutex_lazy_thread_pools_);
+  result = pool->get();
+  if (result) {
+    return *result;
+  }
+  const ThreadPoolOptions& options = normal_thread_pool_->options();
+  size_t max_workers = std::max<size_t>(options.max_workers * workers_percentage / 100, 1);
+  pool->reset(new rpc::ThreadPool(
+      name_ + suffix, options.queue_limit, max_workers, std::move(cpus)));
+  return *pool->get();
+}
+
 // Register a new RpcService to handle inbound requests.
 Status Messenger::RegisterService(const string& service_name,
                                   const scoped_refptr<RpcService>& service) {
@@ -411,9 +453,11 @@ Status Messenger::RegisterService(const string& service_name,
 
 void Messenger::ShutdownThreadPools() {
   normal_thread_pool_->Shutdown();
-  auto high_priority_thread_pool = high_priority_thread_pool_.get();
-  if (high_priority_thread_pool) {
-    high_priority_thread_pool->Shutdown();
+  for (auto* pool : {&high_priority_thread_pool_, &low_priority_thread_pool_}) {
+    auto thread_pool = pool->get();
+    if (thread_pool) {
+      thread_pool->Shutdown();
+    }
   }
 }
 
@@ -544,7 +588,8 @@ Messenger::Messenger(const MessengerBuilder &bld)
       metric_entity_(bld.metric_entity_),
       io_thread_pool_(name_, FLAGS_io_thread_pool_size),
       scheduler_(&io_thread_pool_.io_service()),
-      normal_thread_pool_(new rpc::ThreadPool(name_, bld.queue_limit_, bld.workers_limit_)),
+      normal_thread_pool_(new rpc::ThreadPool(
+          name_, bld.queue_limit_, bld.workers_limit_, CpuListFromFlag(FLAGS_rpc_worker_cpus))),
       rpc_metrics_(new RpcMetrics(bld.metric_entity_)),
       num_connections_to_server_(bld.num_connections_to_server_) {
 #ifndef NDEBUG
@@ -317,6 +317,13 @@ class Messenger : public ProxyContext {
 
   bool TEST_ShouldArtificiallyRejectOutgoingCallsTo(const IpAddress &remote);
 
+  // Returns thread pool stored in pool, creating it if necessary.
+  // Created pool has the same queue limit as the normal thread pool, and workers_percentage of
+  // its workers, restricted to cpus.
+  rpc::ThreadPool& LazyThreadPool(
+      AtomicUniquePtr<rpc::ThreadPool>* pool, const char* suffix, int workers_percentage,
+      std::vector<int> cpus);
+
   const std::string name_;
 
   ConnectionContextFactoryPtr connection_context_factory_;
@@ -365,11 +372,15 @@ class Messenger : public ProxyContext {
   // Thread pools that are used by services running in this messenger.
   std::unique_ptr<rpc::ThreadPool> normal_thread_pool_;
 
-  std::mutex mutex_high_priority_thread_pool_;
+  // Protects creation of lazily created thread pools.
+  std::mutex mutex_lazy_thread_pools_;
 
   // This could be used for high-priority services such as Consensus.
   AtomicUniquePtr<rpc::ThreadPool> high_priority_thread_pool_;
 
+  // Used for bulk calls of normal priority services, see ServiceIf::IsLowPriority.
+  AtomicUniquePtr<rpc::ThreadPool> low_priority_thread_pool_;
+
   std::unique_ptr<RpcMetrics> rpc_metrics_;
 
   // Use this IP address as base address for outbound connections from messenger.
@@ -335,7 +335,18 @@ void OutboundCall::set_state(State new_state) {
   }
 }
 
+void OutboundCall::SetConnectionLoad(std::shared_ptr<OutboundConnectionLoad> load) {
+  load->calls.fetch_add(1, std::memory_order_acq_rel);
+  load->bytes.fetch_add(request_size(), std::memory_order_acq_rel);
+  connection_load_ = std::move(load);
+}
+
 void OutboundCall::InvokeCallback() {
+  if (connection_load_) {
+    connection_load_->calls.fetch_sub(1, std::memory_order_acq_rel);
+    connection_load_->bytes.fetch_sub(request_size(), std::memory_order_acq_rel);
+    connection_load_.reset();
+  }
   if (callback_thread_pool_) {
     callback_task_.SetOutboundCall(shared_from(this));
     callback_thread_pool_->Enqueue(&callback_task_);
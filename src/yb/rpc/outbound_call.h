@@ -32,6 +32,7 @@
 #ifndef YB_RPC_OUTBOUND_CALL_H_
 #define YB_RPC_OUTBOUND_CALL_H_
 
+#include <atomic>
 #include <deque>
 #include <string>
 #include <vector>
@@ -113,6 +114,12 @@ inline bool operator==(const ConnectionId& lhs, const ConnectionId& rhs) {
   return lhs.remote() == rhs.remote() && lhs.idx() == rhs.idx() && lhs.protocol() == rhs.protocol();
 }
 
+// Load of an outbound connection, used by Proxy to pick the least loaded connection.
+struct OutboundConnectionLoad {
+  std::atomic<size_t> calls{0};
+  std::atomic<size_t> bytes{0};
+};
+
 // Container for OutboundCall metrics
 struct OutboundCallMetrics {
   explicit OutboundCallMetrics(const scoped_refptr<MetricEntity>& metric_entity);
@@ -279,6 +286,13 @@ class OutboundCall : public RpcCall {
     hostname_ = hostname;
   }
 
+  // Accounts this call in the load of its connection, until the call is finished.
+  void SetConnectionLoad(std::shared_ptr<OutboundConnectionLoad> load);
+
+  size_t request_size() const {
+    return buffer_.size();
+  }
+
   void InvokeCallbackSync();
 
   ////////////////////////////////////////////////////////////
@@ -378,6 +392,9 @@ class OutboundCall : public RpcCall {
 
   std::shared_ptr<OutboundCallMetrics> outbound_call_metrics_;
 
+  // Load of the connection this call is accounted in, released when callback is invoked.
+  std::shared_ptr<OutboundConnectionLoad> connection_load_;
+
   RemoteMethodPool* remote_method_pool_;
 
   RpcMetrics* rpc_metrics_;
@@ -475,6 +475,26 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
           "  yb::MetricUnit::kMicroseconds,\n"
           "  \"Microseconds spent handling $rpc_full_name$() RPC requests\",\n"
           "  60000000LU, 2);\n"
+          "\n"
+          "METRIC_DEFINE_histogram(server, dispatch_latency_$rpc_full_name_plainchars$,\n"
+          "  \"$rpc_full_name$ RPC Dispatch Time\",\n"
+          "  yb::MetricUnit::kMicroseconds,\n"
+          "  \"Microseconds from receiving $rpc_full_name$() RPC requests until they were \"\n"
+          "  \"queued to the service\",\n"
+          "  60000000LU, 2);\n"
+          "\n"
+          "METRIC_DEFINE_histogram(server, queue_latency_$rpc_full_name_plainchars$,\n"
+          "  \"$rpc_full_name$ RPC Queue Time\",\n"
+          "  yb::MetricUnit::kMicroseconds,\n"
+          "  \"Microseconds $rpc_full_name$() RPC requests spent in the service queue\",\n"
+          "  60000000LU, 2);\n"
+          "\n"
+          "METRIC_DEFINE_histogram(server, response_latency_$rpc_full_name_plainchars$,\n"
+          "  \"$rpc_full_name$ RPC Response Time\",\n"
+          "  yb::MetricUnit::kMicroseconds,\n"
+          "  \"Microseconds from queueing $rpc_full_name$() RPC responses until they were \"\n"
+          "  \"written to the socket\",\n"
+          "  60000000LU, 2);\n"
           "\n");
         subs->Pop();
       }
@@ -515,8 +535,7 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         "            metrics_[$metric_enum_key$]) :\n"
         "        ::yb::rpc::RpcContext(\n"
         "            yb_call, \n"
-        "            std::make_shared<$request$>(),\n"
-        "            std::make_shared<$response$>(),\n"
+        "            ::yb::rpc::MakeRpcCallPBs<$request$, $response$>(),\n"
         "            metrics_[$metric_enum_key$]);\n"
         "    if (!rpc_context.responded()) {\n"
         "      const auto* req = static_cast<const $request$*>(rpc_context.request_pb());\n"
@@ -553,6 +572,12 @@ class CodeGenerator : public ::google::protobuf::compiler::CodeGenerator {
         Print(printer, *subs,
           "  metrics_[$metric_enum_key$].handler_latency = \n"
           "      METRIC_handler_latency_$rpc_full_name_plainchars$.Instantiate(entity);\n"
+          "  metrics_[$metric_enum_key$].dispatch_latency = \n"
+          "      METRIC_dispatch_latency_$rpc_full_name_plainchars$.Instantiate(entity);\n"
+          "  metrics_[$metric_enum_key$].queue_latency = \n"
+          "      METRIC_queue_latency_$rpc_full_name_plainchars$.Instantiate(entity);\n"
+          "  metrics_[$metric_enum_key$].response_latency = \n"
+          "      METRIC_response_latency_$rpc_full_name_plainchars$.Instantiate(entity);\n"
         );
 
         subs->Pop();
@@ -32,10 +32,12 @@
 
 #include "yb/rpc/proxy.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -54,12 +56,37 @@
 #include "yb/util/net/sockaddr.h"
 #include "yb/util/net/socket.h"
 #include "yb/util/countdown_latch.h"
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_class_pool.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/user.h"
 
+using namespace yb::size_literals;
+
 DEFINE_int32(num_connections_to_server, 8,
              "Number of underlying connections to each server");
 
+DEFINE_int32(max_connections_to_server, 16,
+             "Max number of underlying connections to each server. When all connections have "
+             "at least rpc_outstanding_calls_to_open_connection outstanding calls, extra "
+             "connections are opened up to this limit");
+
+DEFINE_int32(rpc_outstanding_calls_to_open_connection, 32,
+             "Number of outstanding calls on the least loaded connection, that triggers opening "
+             "of an extra connection to the server");
+TAG_FLAG(rpc_outstanding_calls_to_open_connection, advanced);
+TAG_FLAG(rpc_outstanding_calls_to_open_connection, runtime);
+
+DEFINE_int32(num_bulk_connections_to_server, 1,
+             "Number of underlying connections to each server used for bulk transfers. "
+             "0 to send bulk transfers over regular connections");
+
+DEFINE_uint64(rpc_bulk_transfer_min_request_size, 1_MB,
+              "Calls with requests of at least this size are sent over bulk connections");
+TAG_FLAG(rpc_bulk_transfer_min_request_size, advanced);
+TAG_FLAG(rpc_bulk_transfer_min_request_size, runtime);
+
 DEFINE_int32(proxy_resolve_cache_ms, 5000,
              "Time in milliseconds to cache resolution result in Proxy");
 
@@ -72,6 +99,15 @@ using std::shared_ptr;
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Connection index is stored as uint8_t in ConnectionId.
+constexpr int kMaxConnectionIndex = std::numeric_limits<uint8_t>::max();
+constexpr int kMaxConnections = 128;
+constexpr size_t kOutstandingCallMinBytes = 4_KB;
+
+} // namespace
+
 Proxy::Proxy(ProxyContext* context, const HostPort& remote, const Protocol* protocol)
     : context_(context),
       remote_(remote),
@@ -84,9 +120,20 @@ Proxy::Proxy(ProxyContext* context, const HostPort& remote, const Protocol* prot
       latency_hist_(ScopedDnsTracker::active_metric()),
       // Use the context->num_connections_to_server() here as opposed to directly reading the
       // FLAGS_num_connections_to_server, because the flag value could have changed since then.
-      num_connections_to_server_(context_->num_connections_to_server()) {
+      num_connections_to_server_(context_->num_connections_to_server()),
+      max_connections_to_server_(std::max(
+          num_connections_to_server_, std::min(FLAGS_max_connections_to_server, kMaxConnections))),
+      num_bulk_connections_(std::max(std::min(
+          FLAGS_num_bulk_connections_to_server,
+          kMaxConnectionIndex + 1 - max_connections_to_server_), 0)),
+      active_connections_(num_connections_to_server_) {
   VLOG(1) << "Create proxy to " << remote << " with num_connections_to_server="
-          << num_connections_to_server_;
+          << num_connections_to_server_ << ", max_connections_to_server="
+          << max_connections_to_server_;
+  connections_load_.reserve(max_connections_to_server_);
+  for (int i = 0; i != max_connections_to_server_; ++i) {
+    connections_load_.push_back(std::make_shared<OutboundConnectionLoad>());
+  }
   if (context_->parent_mem_tracker()) {
     mem_tracker_ = MemTracker::FindOrCreateTracker(
         "Queueing", context_->parent_mem_tracker());
@@ -146,21 +193,23 @@ void Proxy::DoAsyncRequest(const RemoteMethod* method,
 
   controller->call_ =
       call_local_service_ ?
-      std::make_shared<LocalOutboundCall>(method,
-                                          outbound_call_metrics_,
-                                          resp,
-                                          controller,
-                                          &context_->rpc_metrics(),
-                                          std::move(callback)) :
-      std::make_shared<OutboundCall>(method,
-                                     outbound_call_metrics_,
-                                     resp,
-                                     controller,
-                                     &context_->rpc_metrics(),
-                                     std::move(callback),
-                                     GetCallbackThreadPool(
-                                         force_run_callback_on_reactor,
-                                         controller->invoke_callback_mode()));
+      std::allocate_shared<LocalOutboundCall>(SizeClassAllocator<LocalOutboundCall>(),
+                                              method,
+                                              outbound_call_metrics_,
+                                              resp,
+                                              controller,
+                                              &context_->rpc_metrics(),
+                                              std::move(callback)) :
+      std::allocate_shared<OutboundCall>(SizeClassAllocator<OutboundCall>(),
+                                         method,
+                                         outbound_call_metrics_,
+                                         resp,
+                                         controller,
+                                         &context_->rpc_metrics(),
+                                         std::move(callback),
+                                         GetCallbackThreadPool(
+                                             force_run_callback_on_reactor,
+                                             controller->invoke_callback_mode()));
   auto call = controller->call_.get();
   Status s = call->SetRequestParam(req, mem_tracker_);
   if (PREDICT_FALSE(!s.ok())) {
@@ -272,12 +321,54 @@ void Proxy::ResolveDone(
 }
 
 void Proxy::QueueCall(RpcController* controller, const Endpoint& endpoint) {
-  uint8_t idx = num_calls_.fetch_add(1) % num_connections_to_server_;
+  const auto& call = controller->call_;
+  size_t idx;
+  if (num_bulk_connections_ &&
+      (controller->bulk_transfer() ||
+       call->request_size() >= FLAGS_rpc_bulk_transfer_min_request_size)) {
+    idx = max_connections_to_server_ +
+          num_bulk_calls_.fetch_add(1, std::memory_order_relaxed) % num_bulk_connections_;
+  } else {
+    idx = PickConnection();
+    call->SetConnectionLoad(connections_load_[idx]);
+  }
   ConnectionId conn_id(endpoint, idx, protocol_);
   controller->call_->SetConnectionId(conn_id, &remote_.host());
   context_->QueueOutboundCall(controller->call_);
 }
 
+size_t Proxy::PickConnection() {
+  auto active = active_connections_.load(std::memory_order_acquire);
+  // Start from the next connection in round robin order, so idle connections are used evenly.
+  const size_t start = num_calls_.fetch_add(1, std::memory_order_relaxed);
+  size_t best_idx = 0;
+  size_t best_load = std::numeric_limits<size_t>::max();
+  size_t best_calls = 0;
+  for (int i = 0; i != active; ++i) {
+    const size_t idx = (start + i) % active;
+    const auto& load = *connections_load_[idx];
+    const size_t calls = load.calls.load(std::memory_order_acquire);
+    // Size of the response is not known in advance, so each outstanding call has minimal cost.
+    const size_t current_load = load.bytes.load(std::memory_order_acquire) +
+                                calls * kOutstandingCallMinBytes;
+    if (current_load < best_load) {
+      best_idx = idx;
+      best_load = current_load;
+      best_calls = calls;
+    }
+  }
+
+  if (static_cast<int64_t>(best_calls) >= FLAGS_rpc_outstanding_calls_to_open_connection &&
+      active < max_connections_to_server_ &&
+      active_connections_.compare_exchange_strong(active, active + 1)) {
+    VLOG(1) << "Open extra connection " << active << " to " << remote_
+            << ", outstanding calls: " << best_calls;
+    return active;
+  }
+
+  return best_idx;
+}
+
 void Proxy::NotifyFailed(RpcController* controller, const Status& status) {
   // We should retain reference to call, so it would not be destroyed during SetFailed.
   auto call = controller->call_;
@@ -36,6 +36,7 @@
 #include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <boost/lockfree/queue.hpp>
 
@@ -167,6 +168,9 @@ class Proxy {
   void ResolveDone(const boost::system::error_code& ec, const Resolver::results_type& entries);
   void NotifyAllFailed(const Status& status);
   void QueueCall(RpcController* controller, const Endpoint& endpoint);
+  // Returns index of the least loaded connection, opening extra connection when all of them are
+  // loaded.
+  size_t PickConnection();
   ThreadPool *GetCallbackThreadPool(
       bool force_run_callback_on_reactor, InvokeCallbackMode invoke_callback_mode);
 
@@ -198,6 +202,16 @@ class Proxy {
   // Number of outbound connections to create per each destination server address.
   int num_connections_to_server_;
 
+  // Connections with indexes [0, max_connections_to_server_) are used for regular calls,
+  // first active_connections_ of them are currently in use.
+  // Connections with indexes [max_connections_to_server_,
+  // max_connections_to_server_ + num_bulk_connections_) are used for bulk transfers.
+  int max_connections_to_server_;
+  int num_bulk_connections_;
+  std::atomic<int> active_connections_;
+  std::atomic<size_t> num_bulk_calls_{0};
+  std::vector<std::shared_ptr<OutboundConnectionLoad>> connections_load_;
+
   MemTrackerPtr mem_tracker_;
 };
 
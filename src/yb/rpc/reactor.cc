@@ -62,6 +62,8 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/memory/memory.h"
 #include "yb/util/monotime.h"
+#include "yb/util/os-util.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/thread_restrictions.h"
@@ -70,10 +72,25 @@
 #include "yb/util/net/socket.h"
 
 using namespace std::literals;
+using namespace yb::size_literals;
+
+DEFINE_int32(rpc_outbound_batch_window_us, 0,
+             "Outbound calls are accumulated for up to this number of microseconds, so calls "
+             "queued close to each other are written to the connection with a single write. "
+             "0 to send calls as soon as possible");
+TAG_FLAG(rpc_outbound_batch_window_us, advanced);
+TAG_FLAG(rpc_outbound_batch_window_us, runtime);
+
+DEFINE_uint64(rpc_outbound_batch_max_bytes, 64_KB,
+              "Outbound calls are sent without waiting for the batch window when requests of "
+              "accumulated calls have at least this size");
+TAG_FLAG(rpc_outbound_batch_max_bytes, advanced);
+TAG_FLAG(rpc_outbound_batch_max_bytes, runtime);
 
 DECLARE_string(local_ip_for_outbound_sockets);
 DECLARE_int32(num_connections_to_server);
 DECLARE_int32(socket_receive_buffer_size);
+DECLARE_string(rpc_reactor_cpus);
 
 namespace yb {
 namespace rpc {
@@ -122,6 +139,7 @@ Reactor::Reactor(Messenger* messenger,
                  const MessengerBuilder &bld)
     : messenger_(messenger),
       name_(StringPrintf("%s_R%03d", messenger->name().c_str(), index)),
+      index_(index),
       log_prefix_(name_ + ": "),
       loop_(kDefaultLibEvFlags),
       cur_time_(CoarseMonoClock::Now()),
@@ -137,7 +155,8 @@ Reactor::Reactor(Messenger* messenger,
                       << ", coarse timer granularity: " << yb::ToString(coarse_timer_granularity_);
 
   process_outbound_queue_task_ =
-      MakeFunctorReactorTask(std::bind(&Reactor::ProcessOutboundQueue, this), SOURCE_LOCATION());
+      MakeFunctorReactorTask(
+          std::bind(&Reactor::ProcessOutboundQueue, this, false /* force */), SOURCE_LOCATION());
 }
 
 Reactor::~Reactor() {
@@ -161,6 +180,9 @@ Status Reactor::Init() {
   timer_.start(ToSeconds(coarse_timer_granularity_),
                ToSeconds(coarse_timer_granularity_));
 
+  outbound_batch_timer_.set(loop_);
+  outbound_batch_timer_.set<Reactor, &Reactor::OutboundBatchTimerHandler>(this);
+
   // Create Reactor thread.
   const std::string group_name = messenger_->name() + "_reactor";
   return yb::Thread::Create(group_name, group_name, &Reactor::RunThread, this, &thread_);
@@ -210,6 +232,11 @@ void Reactor::ShutdownInternal() {
   stopping_ = true;
   stop_start_time_ = CoarseMonoClock::Now();
 
+  if (outbound_batch_timer_active_) {
+    outbound_batch_timer_.stop();
+    outbound_batch_timer_active_ = false;
+  }
+
   // Tear down any outbound TCP connections.
   VLOG_WITH_PREFIX(1) << "tearing down outbound TCP connections...";
   decltype(client_conns_) client_conns = std::move(client_conns_);
@@ -477,6 +504,13 @@ bool Reactor::IsCurrentThreadOrStartedClosing() const {
 void Reactor::RunThread() {
   ThreadRestrictions::SetWaitAllowed(false);
   ThreadRestrictions::SetIOAllowed(false);
+  auto cpus = CpuListFromFlag(FLAGS_rpc_reactor_cpus);
+  if (!cpus.empty()) {
+    // Pinned before the loop is started, so buffers of connections are first touched, hence
+    // allocated, on the NUMA node of this cpu.
+    std::vector<int> reactor_cpus = { cpus[index_ % cpus.size()] };
+    WARN_NOT_OK(SetCurrentThreadCpuAffinity(reactor_cpus), LogPrefix() + "Failed to pin reactor");
+  }
   DVLOG_WITH_PREFIX(6) << "Calling Reactor::RunThread()...";
   loop_.run(/* flags */ 0);
   VLOG_WITH_PREFIX(1) << "thread exiting.";
@@ -664,11 +698,44 @@ void Reactor::DestroyConnection(Connection *conn, const Status &conn_status) {
   ShutdownConnection(retained_conn);
 }
 
-void Reactor::ProcessOutboundQueue() {
+void Reactor::OutboundBatchTimerHandler(ev::timer& watcher, int revents) { // NOLINT
+  DCHECK(IsCurrentThread());
+  outbound_batch_timer_active_ = false;
+
+  if (EV_ERROR & revents) {
+    LOG_WITH_PREFIX(WARNING) << "Reactor got an error in the outbound batch timer handler.";
+  }
+
+  ProcessOutboundQueue(true /* force */);
+}
+
+void Reactor::ProcessOutboundQueue(bool force) {
   CHECK(processing_outbound_queue_.empty()) << yb::ToString(processing_outbound_queue_);
+  std::chrono::steady_clock::duration delay = std::chrono::steady_clock::duration::zero();
   {
     std::lock_guard<simple_spinlock> lock(outbound_queue_lock_);
-    outbound_queue_.swap(processing_outbound_queue_);
+    const auto window = FLAGS_rpc_outbound_batch_window_us;
+    if (!force && window > 0 && !outbound_queue_.empty() &&
+        outbound_queue_bytes_ < FLAGS_rpc_outbound_batch_max_bytes) {
+      delay = outbound_queue_start_ + window * 1us - std::chrono::steady_clock::now();
+    }
+    if (delay <= std::chrono::steady_clock::duration::zero()) {
+      outbound_queue_.swap(processing_outbound_queue_);
+      outbound_queue_bytes_ = 0;
+      outbound_queue_flush_scheduled_ = false;
+    }
+  }
+  if (delay > std::chrono::steady_clock::duration::zero()) {
+    if (!outbound_batch_timer_active_) {
+      outbound_batch_timer_active_ = true;
+      outbound_batch_timer_.start(
+          std::chrono::duration_cast<std::chrono::duration<double>>(delay).count(), 0);
+    }
+    return;
+  }
+  if (outbound_batch_timer_active_) {
+    outbound_batch_timer_.stop();
+    outbound_batch_timer_active_ = false;
   }
   if (processing_outbound_queue_.empty()) {
     return;
@@ -696,13 +763,26 @@ void Reactor::QueueOutboundCall(OutboundCallPtr call) {
   DVLOG_WITH_PREFIX(3) << "Queueing outbound call "
                        << call->ToString() << " to remote " << call->conn_id().remote();
 
-  bool was_empty = false;
+  bool schedule = false;
   bool closing = false;
   {
     std::lock_guard<simple_spinlock> lock(outbound_queue_lock_);
     if (!outbound_queue_stopped_) {
-      was_empty = outbound_queue_.empty();
+      const bool batching = FLAGS_rpc_outbound_batch_window_us > 0;
+      if (outbound_queue_.empty()) {
+        schedule = true;
+        if (batching) {
+          outbound_queue_start_ = std::chrono::steady_clock::now();
+        }
+      }
       outbound_queue_.push_back(call);
+      outbound_queue_bytes_ += call->request_size();
+      // Batch is big enough, so flush it without waiting for batch window.
+      if (batching && !outbound_queue_flush_scheduled_ &&
+          outbound_queue_bytes_ >= FLAGS_rpc_outbound_batch_max_bytes) {
+        outbound_queue_flush_scheduled_ = true;
+        schedule = true;
+      }
     } else {
       closing = true;
     }
@@ -711,7 +791,7 @@ void Reactor::QueueOutboundCall(OutboundCallPtr call) {
     call->Transferred(AbortedError(), nullptr /* conn */);
     return;
   }
-  if (was_empty) {
+  if (schedule) {
     auto scheduled = ScheduleReactorTask(process_outbound_queue_task_);
     LOG_IF_WITH_PREFIX(WARNING, !scheduled) << "Failed to schedule process outbound queue task";
   }
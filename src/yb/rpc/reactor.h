@@ -309,6 +309,9 @@ class Reactor {
   // libev callback for handling timer events in our epoll thread.
   void TimerHandler(ev::timer &watcher, int revents); // NOLINT
 
+  // libev callback invoked when outbound batch window expires.
+  void OutboundBatchTimerHandler(ev::timer &watcher, int revents); // NOLINT
+
   // This may be called from another thread.
   const std::string &name() const { return name_; }
 
@@ -408,7 +411,9 @@ class Reactor {
   // etc. This is called from within the thread.
   void ShutdownInternal();
 
-  void ProcessOutboundQueue();
+  // Sends queued outbound calls. When outbound batching is enabled, waits until the batch window
+  // expires or enough calls are queued, unless force is true.
+  void ProcessOutboundQueue(bool force);
 
   void CheckReadyToStop();
 
@@ -426,6 +431,9 @@ class Reactor {
 
   const std::string name_;
 
+  // Index of this reactor in its messenger.
+  const int index_;
+
   const std::string log_prefix_;
 
   mutable simple_spinlock pending_tasks_mtx_;
@@ -456,6 +464,10 @@ class Reactor {
   // Handles the periodic timer.
   ev::timer timer_;
 
+  // Flushes outbound queue when batch window expires.
+  ev::timer outbound_batch_timer_;
+  bool outbound_batch_timer_active_ = false;
+
   // Scheduled (but not yet run) delayed tasks.
   std::set<std::shared_ptr<DelayedTask>> scheduled_tasks_;
 
@@ -493,6 +505,13 @@ class Reactor {
 
   std::vector<OutboundCallPtr> outbound_queue_;
 
+  // Total request size of calls in outbound_queue_, time when the first of them was queued, and
+  // whether flush of outbound_queue_ was already scheduled. Used by outbound batching.
+  // Protected by outbound_queue_lock_.
+  size_t outbound_queue_bytes_ = 0;
+  std::chrono::steady_clock::time_point outbound_queue_start_;
+  bool outbound_queue_flush_scheduled_ = false;
+
   // Outbound calls currently being processed. Only accessed on the reactor thread. Could be a local
   // variable, but implemented as a member field as an optimization to avoid memory allocation.
   std::vector<OutboundCallPtr> processing_outbound_queue_;
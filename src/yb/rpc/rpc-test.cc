@@ -44,12 +44,17 @@
 
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/join.h"
+#include "yb/rpc/rpc_compression.h"
+#include "yb/rpc/rpc_metrics.h"
 #include "yb/rpc/serialization.h"
 #include "yb/util/countdown_latch.h"
 #include "yb/util/env.h"
 #include "yb/util/test_util.h"
 
 METRIC_DECLARE_histogram(handler_latency_yb_rpc_test_CalculatorService_Sleep);
+METRIC_DECLARE_histogram(dispatch_latency_yb_rpc_test_CalculatorService_Sleep);
+METRIC_DECLARE_histogram(queue_latency_yb_rpc_test_CalculatorService_Sleep);
+METRIC_DECLARE_histogram(response_latency_yb_rpc_test_CalculatorService_Sleep);
 METRIC_DECLARE_histogram(rpc_incoming_queue_time);
 
 DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
@@ -57,7 +62,15 @@ DEFINE_int32(rpc_test_connection_keepalive_num_iterations, 1,
 
 DECLARE_uint64(rpc_connection_timeout_ms);
 DECLARE_int32(num_connections_to_server);
+DECLARE_int32(max_connections_to_server);
+DECLARE_int32(num_bulk_connections_to_server);
+DECLARE_int32(rpc_outstanding_calls_to_open_connection);
+DECLARE_int32(rpc_outbound_batch_window_us);
+DECLARE_uint64(rpc_outbound_batch_max_bytes);
 DECLARE_bool(enable_rpc_keepalive);
+DECLARE_int32(rpc_max_message_size);
+DECLARE_string(rpc_compression_codec);
+DECLARE_int32(rpc_compression_min_size);
 
 using namespace std::chrono_literals;
 using std::string;
@@ -363,6 +376,78 @@ TEST_F(TestRpc, TestConnectionHeartbeating) {
   }
 }
 
+// Test that proxy opens extra connection under load, and uses separate connection for bulk calls.
+TEST_F(TestRpc, TestExtraConnections) {
+  constexpr int kCalls = 8;
+
+  FLAGS_num_connections_to_server = 1;
+  FLAGS_max_connections_to_server = 2;
+  FLAGS_num_bulk_connections_to_server = 1;
+  FLAGS_rpc_outstanding_calls_to_open_connection = 2;
+
+  // Single reactor, so all connections are visible in its metrics.
+  MessengerOptions messenger_options = { 1, 10s };
+  TestServerOptions options;
+  options.messenger_options = messenger_options;
+  HostPort server_addr;
+  StartTestServer(&server_addr, options);
+
+  std::unique_ptr<Messenger> client_messenger = CreateMessenger("Client", messenger_options);
+  Proxy p(client_messenger.get(), server_addr);
+
+  CountDownLatch latch(kCalls);
+  std::vector<RpcController> controllers(kCalls);
+  std::vector<rpc_test::SleepResponsePB> responses(kCalls);
+  rpc_test::SleepRequestPB req;
+  req.set_sleep_micros(100000);
+  for (int i = 0; i != kCalls; ++i) {
+    p.AsyncRequest(CalculatorServiceMethods::SleepMethod(), req, &responses[i], &controllers[i],
+                   [&latch]() { latch.CountDown(); });
+  }
+  latch.Wait();
+  for (auto& controller : controllers) {
+    ASSERT_OK(controller.status());
+  }
+  ASSERT_NO_FATALS(CheckClientMessengerConnections(client_messenger.get(), 2));
+
+  RpcController controller;
+  controller.set_bulk_transfer(true);
+  rpc_test::SleepResponsePB resp;
+  ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::SleepMethod(), req, &resp, &controller));
+  ASSERT_NO_FATALS(CheckClientMessengerConnections(client_messenger.get(), 3));
+}
+
+// Test that calls are delivered when outbound calls are batched.
+TEST_F(TestRpc, TestOutboundBatching) {
+  constexpr int kCalls = 100;
+  FLAGS_rpc_outbound_batch_window_us = 1000;
+  FLAGS_rpc_outbound_batch_max_bytes = 1_KB;
+
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  std::unique_ptr<Messenger> client_messenger = CreateMessenger("Client");
+  Proxy p(client_messenger.get(), server_addr);
+
+  // Single call is sent after batch window expires.
+  ASSERT_OK(DoTestSyncCall(&p, CalculatorServiceMethods::AddMethod()));
+
+  CountDownLatch latch(kCalls);
+  std::vector<RpcController> controllers(kCalls);
+  std::vector<rpc_test::AddResponsePB> responses(kCalls);
+  rpc_test::AddRequestPB req;
+  req.set_x(1);
+  req.set_y(2);
+  for (int i = 0; i != kCalls; ++i) {
+    p.AsyncRequest(CalculatorServiceMethods::AddMethod(), req, &responses[i], &controllers[i],
+                   [&latch]() { latch.CountDown(); });
+  }
+  latch.Wait();
+  for (int i = 0; i != kCalls; ++i) {
+    ASSERT_OK(controllers[i].status());
+    ASSERT_EQ(3, responses[i].result());
+  }
+}
+
 // Test that the RpcSidecar transfers the expected messages.
 TEST_F(TestRpc, TestRpcSidecar) {
   // Set up server.
@@ -386,6 +471,55 @@ TEST_F(TestRpc, TestRpcSidecar) {
 
   sizes.push_back(333);
   DoTestSidecar(&p, sizes, Status::kRemoteError);
+
+  // A response that does not fit into an RPC message is replaced with an error.
+  FLAGS_rpc_max_message_size = 1_MB;
+  DoTestSidecar(&p, {2_MB}, Status::kRemoteError);
+  DoTestSidecar(&p, {123});
+}
+
+// Test that calls and responses are delivered over connections with compression.
+TEST_F(TestRpc, TestCompression) {
+  HostPort server_addr;
+  StartTestServer(&server_addr);
+  FLAGS_rpc_compression_min_size = 128;
+
+  for (const auto* codec : {"lz4", "zstd"}) {
+    if (!RpcCompressionCodecFromString(codec).ok()) {
+      LOG(INFO) << "Codec not supported: " << codec;
+      continue;
+    }
+    FLAGS_rpc_compression_codec = codec;
+    std::unique_ptr<Messenger> client_messenger = CreateMessenger("Client");
+    Proxy p(client_messenger.get(), server_addr);
+
+    const auto& metrics = client_messenger->rpc_metrics();
+    const auto input_bytes_before = metrics.rpc_compression_input_bytes->value();
+    const auto output_bytes_before = metrics.rpc_compression_output_bytes->value();
+
+    // Small frames are sent raw, compressible frames compressed, random ones raw after
+    // unsuccessful compression.
+    std::string random_data(4_KB, 0);
+    for (auto& c : random_data) {
+      c = RandomUniformInt(0, 255);
+    }
+    for (const auto& data : {std::string("small"), std::string(1_MB, 'X'), random_data}) {
+      rpc_test::EchoRequestPB req;
+      req.set_data(data);
+      rpc_test::EchoResponsePB resp;
+      RpcController controller;
+      controller.set_timeout(30s);
+      ASSERT_OK(p.SyncRequest(CalculatorServiceMethods::EchoMethod(), req, &resp, &controller));
+      ASSERT_EQ(data, resp.data());
+    }
+    DoTestSidecar(&p, {123, 456});
+
+    const auto input_bytes = metrics.rpc_compression_input_bytes->value() - input_bytes_before;
+    const auto output_bytes = metrics.rpc_compression_output_bytes->value() - output_bytes_before;
+    LOG(INFO) << codec << ": " << input_bytes << " => " << output_bytes;
+    ASSERT_GT(input_bytes, 1_MB);
+    ASSERT_LT(output_bytes, input_bytes / 2);
+  }
 }
 
 // Test that timeouts are properly handled.
@@ -575,6 +709,19 @@ TEST_F(TestRpc, TestRpcHandlerLatencyMetric) {
   ASSERT_GE(latency_histogram->MaxValueForTests(), sleep_micros);
   ASSERT_TRUE(latency_histogram->MinValueForTests() == latency_histogram->MaxValueForTests());
 
+  // Latency breakdown is recorded for each call.
+  for (auto* prototype : {&METRIC_dispatch_latency_yb_rpc_test_CalculatorService_Sleep,
+                          &METRIC_queue_latency_yb_rpc_test_CalculatorService_Sleep}) {
+    auto histogram = down_cast<Histogram*>(FindOrDie(metric_map, prototype).get());
+    ASSERT_EQ(1, histogram->TotalCount()) << prototype->name();
+  }
+  // Response latency is recorded after the response is written, so client could receive the
+  // response earlier.
+  auto response_histogram = down_cast<Histogram*>(FindOrDie(
+      metric_map, &METRIC_response_latency_yb_rpc_test_CalculatorService_Sleep).get());
+  ASSERT_OK(WaitFor([response_histogram] { return response_histogram->TotalCount() == 1; },
+                    5s, "Response latency recorded"));
+
   // TODO: Implement an incoming queue latency test.
   // For now we just assert that the metric exists.
   YB_ASSERT_TRUE(FindOrDie(metric_map, &METRIC_rpc_incoming_queue_time));
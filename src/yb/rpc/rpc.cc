@@ -113,6 +113,11 @@ bool RpcRetrier::HandleResponse(
 
 Status RpcRetrier::DelayedRetry(
     RpcCommand* rpc, const Status& why_status, BackoffStrategy strategy) {
+  return DelayedRetry(rpc, why_status, MonoDelta::kZero, strategy);
+}
+
+Status RpcRetrier::DelayedRetry(
+    RpcCommand* rpc, const Status& why_status, MonoDelta min_delay, BackoffStrategy strategy) {
   if (!why_status.ok() && (last_error_.ok() || last_error_.IsTimedOut())) {
     last_error_ = why_status;
   }
@@ -145,7 +150,8 @@ Status RpcRetrier::DelayedRetry(
 
   auto retain_rpc = rpc->shared_from_this();
   task_id_ = messenger_->ScheduleOnReactor(
-      std::bind(&RpcRetrier::DoRetry, this, rpc, _1), MonoDelta::FromMilliseconds(num_ms),
+      std::bind(&RpcRetrier::DoRetry, this, rpc, _1),
+      std::max(MonoDelta::FromMilliseconds(num_ms), min_delay),
       SOURCE_LOCATION(), messenger_);
 
   // Scheduling state can be changed only in this method, so we expected both
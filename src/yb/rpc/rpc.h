@@ -116,6 +116,11 @@ class RpcRetrier {
       RpcCommand* rpc, const Status& why_status,
       BackoffStrategy strategy = BackoffStrategy::kLinear);
 
+  // Same as above, but waits at least min_delay, e.g. the delay requested by the server.
+  CHECKED_STATUS DelayedRetry(
+      RpcCommand* rpc, const Status& why_status, MonoDelta min_delay,
+      BackoffStrategy strategy = BackoffStrategy::kLinear);
+
   RpcController* mutable_controller() { return &controller_; }
   const RpcController& controller() const { return controller_; }
 
@@ -0,0 +1,273 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/rpc/rpc_compression.h"
+
+#include <gflags/gflags.h>
+#include <lz4.h>
+
+#ifdef ZSTD
+#include <zstd.h>
+#endif
+
+#include "yb/gutil/endian.h"
+
+#include "yb/rpc/constants.h"
+#include "yb/rpc/rpc_metrics.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/monotime.h"
+
+DEFINE_int32(rpc_compression_min_size, 1024,
+             "RPC frames with payload smaller than this number of bytes are sent uncompressed "
+             "over connections with compression.");
+TAG_FLAG(rpc_compression_min_size, advanced);
+TAG_FLAG(rpc_compression_min_size, runtime);
+
+namespace yb {
+namespace rpc {
+
+namespace {
+
+// ZSTD level used for RPC frames, they are compressed on the reactor thread so should be fast.
+constexpr int kZstdCompressionLevel = 1;
+constexpr size_t kUncompressedSizeLength = 4;
+constexpr size_t kCodecLength = 1;
+constexpr size_t kCompressedTrailerLength = kUncompressedSizeLength + kCodecLength;
+
+// Returns size of compressed data or 0 if data could not be compressed into out_capacity bytes.
+size_t Compress(RpcCompressionCodec codec, const char* input, size_t size, char* out,
+                size_t out_capacity) {
+  switch (codec) {
+    case RpcCompressionCodec::kLz4: {
+      const int compressed_size = LZ4_compress_default(input, out, size, out_capacity);
+      return compressed_size > 0 ? compressed_size : 0;
+    }
+    case RpcCompressionCodec::kZstd: {
+#ifdef ZSTD
+      const size_t compressed_size = ZSTD_compress(
+          out, out_capacity, input, size, kZstdCompressionLevel);
+      return ZSTD_isError(compressed_size) ? 0 : compressed_size;
+#else
+      return 0;
+#endif
+    }
+    case RpcCompressionCodec::kNone:
+      return 0;
+  }
+  FATAL_INVALID_ENUM_VALUE(RpcCompressionCodec, codec);
+}
+
+Status Decompress(RpcCompressionCodec codec, const char* input, size_t size, char* out,
+                  size_t uncompressed_size) {
+  switch (codec) {
+    case RpcCompressionCodec::kLz4: {
+      const int decompressed_size = LZ4_decompress_safe(input, out, size, uncompressed_size);
+      if (decompressed_size < 0 ||
+          static_cast<size_t>(decompressed_size) != uncompressed_size) {
+        return STATUS_FORMAT(
+            Corruption, "LZ4 failed to uncompress RPC frame: $0 bytes instead of $1",
+            decompressed_size, uncompressed_size);
+      }
+      return Status::OK();
+    }
+    case RpcCompressionCodec::kZstd: {
+#ifdef ZSTD
+      const size_t decompressed_size = ZSTD_decompress(out, uncompressed_size, input, size);
+      if (ZSTD_isError(decompressed_size) || decompressed_size != uncompressed_size) {
+        return STATUS_FORMAT(
+            Corruption, "ZSTD failed to uncompress RPC frame of $0 bytes", uncompressed_size);
+      }
+      return Status::OK();
+#else
+      return STATUS(NotSupported, "Built without ZSTD support");
+#endif
+    }
+    case RpcCompressionCodec::kNone:
+      break;
+  }
+  return STATUS_FORMAT(Corruption, "Unexpected RPC frame codec: $0", codec);
+}
+
+class CompressedOutboundData : public OutboundData {
+ public:
+  CompressedOutboundData(OutboundDataPtr data, RpcCompressionCodec codec, RpcMetrics* metrics)
+      : data_(std::move(data)), codec_(codec), metrics_(metrics) {}
+
+  void Transferred(const Status& status, Connection* conn) override {
+    data_->Transferred(status, conn);
+  }
+
+  void Serialize(boost::container::small_vector_base<RefCntBuffer>* output) override;
+
+  std::string ToString() const override {
+    return data_->ToString();
+  }
+
+  bool DumpPB(const DumpRunningRpcsRequestPB& req, RpcCallInProgressPB* resp) override {
+    return data_->DumpPB(req, resp);
+  }
+
+  bool IsFinished() const override {
+    return data_->IsFinished();
+  }
+
+  bool IsHeartbeat() const override {
+    return data_->IsHeartbeat();
+  }
+
+ private:
+  // Returns false if frame was not compressed.
+  bool TryCompress(const boost::container::small_vector_base<RefCntBuffer>& frame,
+                   size_t payload_size,
+                   boost::container::small_vector_base<RefCntBuffer>* output);
+
+  OutboundDataPtr data_;
+  const RpcCompressionCodec codec_;
+  RpcMetrics* const metrics_;
+};
+
+void CompressedOutboundData::Serialize(
+    boost::container::small_vector_base<RefCntBuffer>* output) {
+  boost::container::small_vector<RefCntBuffer, 4> frame;
+  data_->Serialize(&frame);
+
+  size_t size = 0;
+  for (const auto& buffer : frame) {
+    size += buffer.size();
+  }
+  DCHECK_GE(frame.front().size(), kMsgLengthPrefixLength);
+  const size_t payload_size = size - kMsgLengthPrefixLength;
+
+  if (payload_size > kCompressedTrailerLength &&
+      payload_size >= implicit_cast<size_t>(FLAGS_rpc_compression_min_size) &&
+      TryCompress(frame, payload_size, output)) {
+    return;
+  }
+
+  // Send frame as is, just account trailer in its length.
+  static const char kRawTrailer[kCodecLength] = { static_cast<char>(RpcCompressionCodec::kNone) };
+  static const RefCntBuffer raw_trailer(kRawTrailer, kCodecLength);
+  NetworkByteOrder::Store32(frame.front().data(), payload_size + kCodecLength);
+  for (auto& buffer : frame) {
+    output->push_back(std::move(buffer));
+  }
+  output->push_back(raw_trailer);
+}
+
+bool CompressedOutboundData::TryCompress(
+    const boost::container::small_vector_base<RefCntBuffer>& frame, size_t payload_size,
+    boost::container::small_vector_base<RefCntBuffer>* output) {
+  auto start = MonoTime::Now();
+
+  // Codecs require contiguous input, so payload split between several buffers (i.e. response
+  // with sidecars) is concatenated first.
+  RefCntBuffer joined;
+  const char* input = frame.front().data() + kMsgLengthPrefixLength;
+  if (frame.size() > 1) {
+    joined = RefCntBuffer(payload_size);
+    char* out = joined.data();
+    memcpy(out, input, frame.front().size() - kMsgLengthPrefixLength);
+    out += frame.front().size() - kMsgLengthPrefixLength;
+    for (size_t i = 1; i != frame.size(); ++i) {
+      memcpy(out, frame[i].data(), frame[i].size());
+      out += frame[i].size();
+    }
+    input = joined.data();
+  }
+
+  // Compressed frame is useful only when it is smaller than the raw one.
+  const size_t max_compressed_size = payload_size - kCompressedTrailerLength;
+  RefCntBuffer result(kMsgLengthPrefixLength + payload_size + kCodecLength);
+  char* compressed = result.data() + kMsgLengthPrefixLength;
+  size_t compressed_size = Compress(
+      codec_, input, payload_size, compressed, max_compressed_size);
+
+  if (metrics_->rpc_compression_input_bytes) {
+    metrics_->rpc_compression_input_bytes->IncrementBy(payload_size);
+    metrics_->rpc_compression_output_bytes->IncrementBy(
+        compressed_size ? compressed_size + kCompressedTrailerLength
+                        : payload_size + kCodecLength);
+    metrics_->rpc_compression_time_us->IncrementBy(
+        MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  }
+
+  if (compressed_size == 0) {
+    return false;
+  }
+
+  char* trailer = compressed + compressed_size;
+  NetworkByteOrder::Store32(trailer, payload_size);
+  trailer[kUncompressedSizeLength] = static_cast<char>(codec_);
+  const size_t frame_size = compressed_size + kCompressedTrailerLength;
+  NetworkByteOrder::Store32(result.data(), frame_size);
+  result.Shrink(kMsgLengthPrefixLength + frame_size);
+  output->push_back(std::move(result));
+  return true;
+}
+
+} // namespace
+
+Result<RpcCompressionCodec> RpcCompressionCodecFromString(const std::string& name) {
+  if (name == "none") {
+    return RpcCompressionCodec::kNone;
+  }
+  if (name == "lz4") {
+    return RpcCompressionCodec::kLz4;
+  }
+  if (name == "zstd") {
+#ifdef ZSTD
+    return RpcCompressionCodec::kZstd;
+#else
+    return STATUS(NotSupported, "Built without ZSTD support");
+#endif
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown RPC compression codec: $0", name);
+}
+
+OutboundDataPtr CompressOutboundData(
+    OutboundDataPtr data, RpcCompressionCodec codec, RpcMetrics* metrics) {
+  return std::make_shared<CompressedOutboundData>(std::move(data), codec, metrics);
+}
+
+Status DecompressCallData(CallData* call_data, RpcMetrics* metrics) {
+  const size_t size = call_data->size();
+  if (size < kCodecLength) {
+    return STATUS_FORMAT(Corruption, "RPC frame is too short: $0", size);
+  }
+  const char* data = call_data->data();
+  auto codec = static_cast<RpcCompressionCodec>(data[size - kCodecLength]);
+  if (codec == RpcCompressionCodec::kNone) {
+    call_data->Shrink(size - kCodecLength);
+    return Status::OK();
+  }
+  if (size < kCompressedTrailerLength) {
+    return STATUS_FORMAT(Corruption, "Compressed RPC frame is too short: $0", size);
+  }
+
+  auto start = MonoTime::Now();
+  const size_t compressed_size = size - kCompressedTrailerLength;
+  const size_t uncompressed_size = NetworkByteOrder::Load32(data + compressed_size);
+  CallData uncompressed(uncompressed_size);
+  RETURN_NOT_OK(Decompress(codec, data, compressed_size, uncompressed.data(), uncompressed_size));
+  *call_data = std::move(uncompressed);
+
+  if (metrics->rpc_decompression_time_us) {
+    metrics->rpc_decompression_time_us->IncrementBy(
+        MonoTime::Now().GetDeltaSince(start).ToMicroseconds());
+  }
+  return Status::OK();
+}
+
+} // namespace rpc
+} // namespace yb
@@ -0,0 +1,54 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_RPC_RPC_COMPRESSION_H
+#define YB_RPC_RPC_COMPRESSION_H
+
+#include <string>
+
+#include "yb/rpc/call_data.h"
+#include "yb/rpc/rpc_fwd.h"
+#include "yb/rpc/outbound_data.h"
+
+#include "yb/util/enums.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace rpc {
+
+struct RpcMetrics;
+
+// Compression codec of YB RPC connection. It is selected by the client and sent to the server in
+// the connection header, then both sides use it for all frames of this connection.
+YB_DEFINE_ENUM(RpcCompressionCodec, (kNone)(kLz4)(kZstd));
+
+Result<RpcCompressionCodec> RpcCompressionCodecFromString(const std::string& name);
+
+// On a connection with compression every non empty frame has a trailer:
+// - raw frame: [payload][kNone]
+// - compressed frame: [compressed payload][uncompressed size, 4 bytes][codec]
+// Frames smaller than rpc_compression_min_size, or ones that do not shrink, are sent raw.
+// The trailer is used instead of a prefix, so raw frames are sent without copying their payload.
+
+// Wraps data, so its frame is serialized in the format above.
+OutboundDataPtr CompressOutboundData(
+    OutboundDataPtr data, RpcCompressionCodec codec, RpcMetrics* metrics);
+
+// Replaces content of call_data with the original payload of a frame received on a connection
+// with compression.
+CHECKED_STATUS DecompressCallData(CallData* call_data, RpcMetrics* metrics);
+
+} // namespace rpc
+} // namespace yb
+
+#endif // YB_RPC_RPC_COMPRESSION_H
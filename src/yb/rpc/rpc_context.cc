@@ -48,17 +48,32 @@
 #include "yb/util/metrics.h"
 #include "yb/util/trace.h"
 #include "yb/util/debug/trace_event.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int32(rpc_pooled_pbs_max_bytes, 64_KB,
+             "Request and response protobufs of an inbound call are reused by later calls, when "
+             "their total serialized size is at most this number of bytes. 0 disables reuse.");
+TAG_FLAG(rpc_pooled_pbs_max_bytes, advanced);
 
 using google::protobuf::Message;
-DECLARE_int32(rpc_max_message_size);
 
 namespace yb {
 namespace rpc {
 
 using std::shared_ptr;
 
+bool ShouldRecycleRpcCallPBs(size_t request_bytes, const Message& response) {
+  auto max_bytes = FLAGS_rpc_pooled_pbs_max_bytes;
+  // Size of the response is cached when it is serialized.
+  return max_bytes > 0 &&
+         request_bytes + response.GetCachedSize() <= static_cast<size_t>(max_bytes);
+}
+
 namespace {
 
 // Wrapper for a protobuf message which lazily converts to JSON when
@@ -127,12 +142,8 @@ RpcContext::RpcContext(std::shared_ptr<LocalYBInboundCall> call,
 }
 
 void RpcContext::RespondSuccess() {
-  if (response_pb_->ByteSize() > FLAGS_rpc_max_message_size) {
-    RespondFailure(STATUS_FORMAT(InvalidArgument, "RPC message too long: $0 vs $1",
-                                 response_pb_->ByteSize(), FLAGS_rpc_max_message_size));
-    return;
-  }
-  call_->RecordHandlingCompleted(metrics_.handler_latency);
+  // The size of the response is checked against rpc_max_message_size during serialization.
+  call_->RecordHandlingCompleted(metrics_);
   TRACE_EVENT_ASYNC_END2("rpc_call", "RPC", this,
                          "response", TracePb(*response_pb_),
                          "trace", trace()->DumpToString(true));
@@ -141,7 +152,7 @@ void RpcContext::RespondSuccess() {
 }
 
 void RpcContext::RespondFailure(const Status &status) {
-  call_->RecordHandlingCompleted(metrics_.handler_latency);
+  call_->RecordHandlingCompleted(metrics_);
   TRACE_EVENT_ASYNC_END2("rpc_call", "RPC", this,
                          "status", status.ToString(),
                          "trace", trace()->DumpToString(true));
@@ -150,7 +161,7 @@ void RpcContext::RespondFailure(const Status &status) {
 }
 
 void RpcContext::RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Status& status) {
-  call_->RecordHandlingCompleted(metrics_.handler_latency);
+  call_->RecordHandlingCompleted(metrics_);
   TRACE_EVENT_ASYNC_END2("rpc_call", "RPC", this,
                          "status", status.ToString(),
                          "trace", trace()->DumpToString(true));
@@ -160,7 +171,7 @@ void RpcContext::RespondRpcFailure(ErrorStatusPB_RpcErrorCodePB err, const Statu
 
 void RpcContext::RespondApplicationError(int error_ext_id, const std::string& message,
                                          const Message& app_error_pb) {
-  call_->RecordHandlingCompleted(metrics_.handler_latency);
+  call_->RecordHandlingCompleted(metrics_);
   TRACE_EVENT_ASYNC_END2("rpc_call", "RPC", this,
                          "response", TracePb(app_error_pb),
                          "trace", trace()->DumpToString(true));
@@ -200,6 +211,18 @@ CoarseTimePoint RpcContext::GetClientDeadline() const {
   return call_->GetClientDeadline();
 }
 
+bool RpcContext::Cancelled() const {
+  return call_->ClientDisconnected();
+}
+
+MonoDelta RpcContext::GetTimeInQueue() const {
+  return call_->GetTimeInQueue();
+}
+
+size_t RpcContext::serialized_request_size() const {
+  return call_ ? call_->serialized_request().size() : 0;
+}
+
 Trace* RpcContext::trace() {
   return call_->trace();
 }
@@ -38,7 +38,9 @@
 #include "yb/rpc/local_call.h"
 #include "yb/rpc/rpc_header.pb.h"
 #include "yb/rpc/service_if.h"
+#include "yb/util/object_pool.h"
 #include "yb/util/ref_cnt_buffer.h"
+#include "yb/util/size_class_pool.h"
 #include "yb/util/status.h"
 
 namespace google {
@@ -61,6 +63,40 @@ namespace rpc {
 
 class YBInboundCall;
 
+// Request and response protobufs of an inbound call, allocated in a single block.
+template <class Request, class Response>
+struct RpcCallPBs {
+  Request request;
+  Response response;
+  // Size of the serialized request, the request was parsed from.
+  size_t request_bytes = 0;
+};
+
+// Returns true if the protobufs are small enough to be kept in a pool after the call.
+// Uses serialized sizes, that are already known after the call, as a cheap bound of the memory
+// retained by the protobufs, instead of walking them.
+bool ShouldRecycleRpcCallPBs(size_t request_bytes, const google::protobuf::Message& response);
+
+// Returns request and response protobufs for an inbound call. They are taken from a per-CPU pool of
+// protobufs of this call type, and cleared when returned to it, so the memory of their fields and
+// repeated fields is reused by the next call.
+template <class Request, class Response>
+std::shared_ptr<RpcCallPBs<Request, Response>> MakeRpcCallPBs() {
+  typedef RpcCallPBs<Request, Response> PBs;
+  // Never destroyed, since calls could be processed during shutdown.
+  static ThreadSafeObjectPool<PBs>* pool = new ThreadSafeObjectPool<PBs>([] { return new PBs; });
+  return std::shared_ptr<PBs>(pool->Take(), [](PBs* pbs) {
+    if (!ShouldRecycleRpcCallPBs(pbs->request_bytes, pbs->response)) {
+      delete pbs;
+      return;
+    }
+    pbs->request.Clear();
+    pbs->response.Clear();
+    pbs->request_bytes = 0;
+    pool->Release(pbs);
+  }, SizeClassAllocator<PBs>());
+}
+
 // The context provided to a generated ServiceIf. This provides
 // methods to respond to the RPC. In the future, this will also
 // include methods to access information about the caller: e.g
@@ -78,6 +114,17 @@ class RpcContext {
   RpcContext(std::shared_ptr<LocalYBInboundCall> call,
              RpcMethodMetrics metrics);
 
+  template <class Request, class Response>
+  RpcContext(std::shared_ptr<YBInboundCall> call,
+             const std::shared_ptr<RpcCallPBs<Request, Response>>& pbs,
+             RpcMethodMetrics metrics)
+      : RpcContext(std::move(call),
+                   std::shared_ptr<google::protobuf::Message>(pbs, &pbs->request),
+                   std::shared_ptr<google::protobuf::Message>(pbs, &pbs->response),
+                   std::move(metrics)) {
+    pbs->request_bytes = serialized_request_size();
+  }
+
   RpcContext(RpcContext&& rhs)
       : call_(std::move(rhs.call_)),
         request_pb_(std::move(rhs.request_pb_)),
@@ -197,6 +244,12 @@ class RpcContext {
   // If the client did not specify a deadline, returns MonoTime::Max().
   CoarseTimePoint GetClientDeadline() const;
 
+  // Whether the client disconnected, so nobody will receive the response of this call.
+  bool Cancelled() const;
+
+  // Time the call spent in the service queue before its handler was started.
+  MonoDelta GetTimeInQueue() const;
+
   // Panic the server. This logs a fatal error with the given message, and
   // also includes the current RPC request, requestor, trace information, etc,
   // to make it easier to debug.
@@ -214,6 +267,8 @@ class RpcContext {
   std::string ToString() const;
 
  private:
+  size_t serialized_request_size() const;
+
   std::shared_ptr<YBInboundCall> call_;
   std::shared_ptr<const google::protobuf::Message> request_pb_;
   std::shared_ptr<google::protobuf::Message> response_pb_;
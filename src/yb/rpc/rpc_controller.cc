@@ -70,6 +70,7 @@ void RpcController::Swap(RpcController* other) {
   std::swap(allow_local_calls_in_curr_thread_, other->allow_local_calls_in_curr_thread_);
   std::swap(call_, other->call_);
   std::swap(invoke_callback_mode_, other->invoke_callback_mode_);
+  std::swap(bulk_transfer_, other->bulk_transfer_);
 }
 
 void RpcController::Reset() {
@@ -143,6 +143,11 @@ class RpcController {
 
   InvokeCallbackMode invoke_callback_mode() { return invoke_callback_mode_; }
 
+  // Marks the call as a bulk transfer, i.e. a call with large request or response.
+  // Such calls are sent over separate connections, so they don't delay other calls.
+  void set_bulk_transfer(bool value) { bulk_transfer_ = value; }
+  bool bulk_transfer() const { return bulk_transfer_; }
+
   // Return the configured timeout.
   MonoDelta timeout() const;
 
@@ -167,6 +172,7 @@ class RpcController {
   OutboundCallPtr call_;
   bool allow_local_calls_in_curr_thread_ = false;
   InvokeCallbackMode invoke_callback_mode_ = InvokeCallbackMode::kThreadPool;
+  bool bulk_transfer_ = false;
 
   DISALLOW_COPY_AND_ASSIGN(RpcController);
 };
@@ -117,7 +117,9 @@ YB_STRONGLY_TYPED_BOOL(ReadBufferFull);
 typedef int64_t ScheduledTaskId;
 const ScheduledTaskId kInvalidTaskId = -1;
 
-YB_DEFINE_ENUM(ServicePriority, (kNormal)(kHigh));
+// kLow is not a service level priority, it is used for bulk calls of normal priority services,
+// see ServiceIf::IsLowPriority.
+YB_DEFINE_ENUM(ServicePriority, (kNormal)(kHigh)(kLow));
 
 } // namespace rpc
 } // namespace yb
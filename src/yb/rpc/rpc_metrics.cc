@@ -43,6 +43,29 @@ METRIC_DEFINE_counter(server, rpc_outbound_calls_created,
                       yb::MetricUnit::kRequests,
                       "Number of created RPC outbound calls.");
 
+METRIC_DEFINE_counter(server, rpc_compression_input_bytes,
+                      "Bytes of RPC frames before compression.",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes of RPC frames large enough to be compressed, before "
+                      "compression. Together with rpc_compression_output_bytes gives compression "
+                      "ratio.");
+
+METRIC_DEFINE_counter(server, rpc_compression_output_bytes,
+                      "Bytes of RPC frames after compression.",
+                      yb::MetricUnit::kBytes,
+                      "Number of bytes of RPC frames large enough to be compressed, after "
+                      "compression.");
+
+METRIC_DEFINE_counter(server, rpc_compression_time_us,
+                      "Time spent compressing RPC frames.",
+                      yb::MetricUnit::kMicroseconds,
+                      "Microseconds spent by reactor threads compressing RPC frames.");
+
+METRIC_DEFINE_counter(server, rpc_decompression_time_us,
+                      "Time spent uncompressing RPC frames.",
+                      yb::MetricUnit::kMicroseconds,
+                      "Microseconds spent by reactor threads uncompressing RPC frames.");
+
 namespace yb {
 namespace rpc {
 
@@ -54,6 +77,10 @@ RpcMetrics::RpcMetrics(const scoped_refptr<MetricEntity>& metric_entity) {
     inbound_calls_created = METRIC_rpc_inbound_calls_created.Instantiate(metric_entity);
     outbound_calls_alive = METRIC_rpc_outbound_calls_alive.Instantiate(metric_entity, 0);
     outbound_calls_created = METRIC_rpc_outbound_calls_created.Instantiate(metric_entity);
+    rpc_compression_input_bytes = METRIC_rpc_compression_input_bytes.Instantiate(metric_entity);
+    rpc_compression_output_bytes = METRIC_rpc_compression_output_bytes.Instantiate(metric_entity);
+    rpc_compression_time_us = METRIC_rpc_compression_time_us.Instantiate(metric_entity);
+    rpc_decompression_time_us = METRIC_rpc_decompression_time_us.Instantiate(metric_entity);
   }
 }
 
@@ -28,6 +28,10 @@ struct RpcMetrics {
   scoped_refptr<Counter> inbound_calls_created;
   scoped_refptr<AtomicGauge<int64_t>> outbound_calls_alive;
   scoped_refptr<Counter> outbound_calls_created;
+  scoped_refptr<Counter> rpc_compression_input_bytes;
+  scoped_refptr<Counter> rpc_compression_output_bytes;
+  scoped_refptr<Counter> rpc_compression_time_us;
+  scoped_refptr<Counter> rpc_decompression_time_us;
 };
 
 } // namespace rpc
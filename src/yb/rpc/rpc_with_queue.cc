@@ -15,6 +15,8 @@
 
 #include "yb/rpc/rpc_with_queue.h"
 
+#include <algorithm>
+
 #include "yb/rpc/connection.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/reactor.h"
@@ -65,15 +67,42 @@ void ConnectionContextWithQueue::Enqueue(std::shared_ptr<QueueableInboundCall> c
     first_without_reply_.store(call.get(), std::memory_order_release);
   }
   if (size <= max_concurrent_calls_) {
+    StartCalls(reactor);
+  }
+}
+
+void ConnectionContextWithQueue::StartCalls(Reactor* reactor) {
+  bool has_blocked_calls = false;
+  const size_t end = std::min(calls_queue_.size(), max_concurrent_calls_);
+  for (size_t i = replies_being_sent_; i != end; ++i) {
+    const auto& call = calls_queue_[i];
+    if (call->started()) {
+      continue;
+    }
+    bool blocked = false;
+    for (size_t j = replies_being_sent_; j != i; ++j) {
+      const auto& other = *calls_queue_[j];
+      if (!other.has_reply() && call->ConflictsWith(other)) {
+        blocked = true;
+        break;
+      }
+    }
+    if (blocked) {
+      has_blocked_calls = true;
+      continue;
+    }
+    call->SetStarted();
     reactor->messenger()->QueueInboundCall(call);
   }
+  has_blocked_calls_.store(has_blocked_calls, std::memory_order_release);
 }
 
 void ConnectionContextWithQueue::Shutdown(const Status& status) {
   // Could erase calls, that we did not start to process yet.
-  if (calls_queue_.size() > max_concurrent_calls_) {
-    calls_queue_.erase(calls_queue_.begin() + max_concurrent_calls_, calls_queue_.end());
-  }
+  calls_queue_.erase(
+      std::remove_if(calls_queue_.begin(), calls_queue_.end(),
+                     [](const auto& call) { return !call->started(); }),
+      calls_queue_.end());
 
   for (auto& call : calls_queue_) {
     call->Abort(status);
@@ -95,9 +124,9 @@ void ConnectionContextWithQueue::CallProcessed(InboundCall* call) {
 
   calls_queue_.pop_front();
   --replies_being_sent_;
-  if (calls_queue_.size() >= max_concurrent_calls_) {
-    auto call_ptr = calls_queue_[max_concurrent_calls_ - 1];
-    reactor->messenger()->QueueInboundCall(call_ptr);
+  if (calls_queue_.size() >= max_concurrent_calls_ ||
+      has_blocked_calls_.load(std::memory_order_acquire)) {
+    StartCalls(reactor);
   }
   if (Idle() && idle_listener_) {
     idle_listener_();
@@ -112,7 +141,11 @@ void ConnectionContextWithQueue::QueueResponse(const ConnectionPtr& conn,
                                                InboundCallPtr call) {
   QueueableInboundCall* queueable_call = down_cast<QueueableInboundCall*>(call.get());
   queueable_call->SetHasReply();
-  if (queueable_call == first_without_reply_.load(std::memory_order_acquire)) {
+  // Calls blocked by this one could be started now, it is done by FlushOutboundQueue.
+  // If has_blocked_calls_ is set concurrently, the blocked call is started by the flush
+  // triggered by the first call without reply, which is always scheduled.
+  if (queueable_call == first_without_reply_.load(std::memory_order_acquire) ||
+      has_blocked_calls_.load(std::memory_order_acquire)) {
     auto scheduled = conn->reactor()->ScheduleReactorTask(flush_outbound_queue_task_);
     LOG_IF(WARNING, !scheduled) << "Failed to schedule flush outbound queue";
   }
@@ -121,6 +154,10 @@ void ConnectionContextWithQueue::QueueResponse(const ConnectionPtr& conn,
 void ConnectionContextWithQueue::FlushOutboundQueue(Connection* conn) {
   DCHECK(conn->reactor()->IsCurrentThread());
 
+  if (has_blocked_calls_.load(std::memory_order_acquire)) {
+    StartCalls(conn->reactor());
+  }
+
   const size_t begin = replies_being_sent_;
   size_t end = begin;
   for (;;) {
@@ -53,7 +53,18 @@ class QueueableInboundCall : public InboundCall {
   // `weight_in_bytes` function is used to determine how many bytes consumes this call.
   size_t weight_in_bytes() const { return weight_in_bytes_; }
 
+  // Whether this call should not be processed concurrently with the other call, that was received
+  // before it. Such call is started only after the other call has its reply.
+  virtual bool ConflictsWith(const QueueableInboundCall& other) const {
+    return false;
+  }
+
+  // Accessed only in the reactor thread.
+  bool started() const { return started_; }
+  void SetStarted() { started_ = true; }
+
  private:
+  bool started_ = false;
   std::atomic<bool> has_reply_{false};
   std::atomic<bool> aborted_{false};
   const size_t weight_in_bytes_;
@@ -91,6 +102,9 @@ class ConnectionContextWithQueue : public ConnectionContextBase {
   void ListenIdle(IdleListener listener) override { idle_listener_ = std::move(listener); }
 
   void CallProcessed(InboundCall* call);
+  // Starts processing of calls that fit into max_concurrent_calls_ and do not conflict with calls
+  // received before them.
+  void StartCalls(Reactor* reactor);
   void FlushOutboundQueue(Connection* conn);
   void FlushOutboundQueueAborted(const Status& status);
 
@@ -104,6 +118,7 @@ class ConnectionContextWithQueue : public ConnectionContextBase {
   // After that there are calls that are being processed.
   // first_without_reply_ points to the first of them.
   // There are not more than max_concurrent_calls_ entries in first two groups.
+  // Calls that conflict with calls before them are not started before those calls have reply.
   // After end of queue there are calls that we received but processing did not start for them.
   std::deque<std::shared_ptr<QueueableInboundCall>> calls_queue_;
   std::shared_ptr<ReactorTask> flush_outbound_queue_task_;
@@ -111,6 +126,9 @@ class ConnectionContextWithQueue : public ConnectionContextBase {
   // First call that does not have reply yet.
   std::atomic<QueueableInboundCall*> first_without_reply_{nullptr};
   std::atomic<uint64_t> processed_call_count_{0};
+  // Whether some calls were not started because of conflicts, so a reply to any call should try
+  // to start them.
+  std::atomic<bool> has_blocked_calls_{false};
   IdleListener idle_listener_;
 };
 
@@ -15,30 +15,34 @@
 
 #include "yb/rpc/scheduler.h"
 
+#include <unordered_map>
+
 #include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/mem_fun.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-
 #include <glog/logging.h>
 
 #include "yb/util/status.h"
+#include "yb/util/timer_wheel.h"
 
+using namespace std::literals;
 using namespace std::placeholders;
-using boost::multi_index::const_mem_fun;
-using boost::multi_index::hashed_unique;
-using boost::multi_index::ordered_non_unique;
 
 namespace yb {
 namespace rpc {
 
+namespace {
+
+// Granularity of scheduled tasks, i.e. task could be executed up to kTick later than requested.
+const auto kTick = 1ms;
+
+} // namespace
+
 class Scheduler::Impl {
  public:
   explicit Impl(IoService* io_service)
-      : io_service_(*io_service), strand_(*io_service), timer_(*io_service) {}
+      : io_service_(*io_service), strand_(*io_service), timer_(*io_service),
+        wheel_(kTick, std::chrono::steady_clock::now()) {}
 
   ~Impl() {
     Shutdown();
@@ -48,11 +52,11 @@ class Scheduler::Impl {
 
   void Abort(ScheduledTaskId task_id) {
     strand_.dispatch([this, task_id] {
-      auto& index = tasks_.get<IdTag>();
-      auto it = index.find(task_id);
-      if (it != index.end()) {
-        io_service_.post([task = *it] { task->Run(STATUS(Aborted, "Task aborted")); });
-        index.erase(it);
+      // Entry in wheel_ is left as is, and is skipped when expires.
+      auto it = tasks_.find(task_id);
+      if (it != tasks_.end()) {
+        io_service_.post([task = it->second] { task->Run(STATUS(Aborted, "Task aborted")); });
+        tasks_.erase(it);
       }
     });
   }
@@ -68,10 +72,11 @@ class Scheduler::Impl {
         auto status = STATUS(ServiceUnavailable, "Scheduler is shutting down", "", ESHUTDOWN);
         // Abort all scheduled tasks. It is ok to run task earlier than it was scheduled because
         // we pass error status to it.
-        for (auto task : tasks_) {
-          io_service_.post([task, status] { task->Run(status); });
+        for (const auto& id_and_task : tasks_) {
+          io_service_.post([task = id_and_task.second, status] { task->Run(status); });
         }
         tasks_.clear();
+        wheel_.Clear([](ScheduledTaskId) {});
       });
     }
   }
@@ -85,9 +90,10 @@ class Scheduler::Impl {
         return;
       }
 
-      auto pair = tasks_.insert(task);
+      auto pair = tasks_.emplace(task->id(), task);
       CHECK(pair.second);
-      if (pair.first == tasks_.begin()) {
+      wheel_.Insert(task->time(), task->id());
+      if (wheel_.NextExpiration() < timer_expiration_) {
         StartTimer();
       }
     });
@@ -104,10 +110,11 @@ class Scheduler::Impl {
  private:
   void StartTimer() {
     DCHECK(strand_.running_in_this_thread());
-    DCHECK(!tasks_.empty());
+    DCHECK(!wheel_.empty());
 
+    timer_expiration_ = wheel_.NextExpiration();
     boost::system::error_code ec;
-    timer_.expires_at((*tasks_.begin())->time(), ec);
+    timer_.expires_at(timer_expiration_, ec);
     LOG_IF(ERROR, ec) << "Reschedule timer failed: " << ec.message();
     ++timer_counter_;
     timer_.async_wait(strand_.wrap(std::bind(&Impl::HandleTimer, this, _1)));
@@ -121,42 +128,34 @@ class Scheduler::Impl {
       LOG_IF(ERROR, ec != boost::asio::error::operation_aborted) << "Wait failed: " << ec.message();
       return;
     }
+    timer_expiration_ = SteadyTimePoint::max();
     if (closing_.load(std::memory_order_acquire)) {
       return;
     }
 
-    auto now = std::chrono::steady_clock::now();
-    while (!tasks_.empty() && (*tasks_.begin())->time() <= now) {
-      io_service_.post([task = *tasks_.begin()] { task->Run(Status::OK()); });
-      tasks_.erase(tasks_.begin());
-    }
+    wheel_.Advance(std::chrono::steady_clock::now(), [this](ScheduledTaskId id) {
+      auto it = tasks_.find(id);
+      // Task could be already aborted.
+      if (it != tasks_.end()) {
+        io_service_.post([task = it->second] { task->Run(Status::OK()); });
+        tasks_.erase(it);
+      }
+    });
 
-    if (!tasks_.empty()) {
+    if (!wheel_.empty()) {
       StartTimer();
     }
   }
 
-  class IdTag;
-
-  typedef boost::multi_index_container<
-      std::shared_ptr<ScheduledTaskBase>,
-      boost::multi_index::indexed_by<
-          ordered_non_unique<
-              const_mem_fun<ScheduledTaskBase, SteadyTimePoint, &ScheduledTaskBase::time>
-          >,
-          hashed_unique<
-              boost::multi_index::tag<IdTag>,
-              const_mem_fun<ScheduledTaskBase, ScheduledTaskId, &ScheduledTaskBase::id>
-          >
-      >
-  > Tasks;
-
   IoService& io_service_;
   std::atomic<ScheduledTaskId> id_ = {0};
-  Tasks tasks_;
-  // Strand that protects tasks_ and timer_ fields.
+  std::unordered_map<ScheduledTaskId, std::shared_ptr<ScheduledTaskBase>> tasks_;
+  // Strand that protects tasks_, wheel_, timer_ and timer_expiration_ fields.
   boost::asio::io_service::strand strand_;
   boost::asio::steady_timer timer_;
+  TimerWheel<ScheduledTaskId, SteadyTimePoint> wheel_;
+  // Time when timer_ is set to fire, max when timer_ is not started.
+  SteadyTimePoint timer_expiration_ = SteadyTimePoint::max();
   int timer_counter_ = 0;
   std::atomic<bool> closing_ = {false};
 };
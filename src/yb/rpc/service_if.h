@@ -58,6 +58,14 @@ struct RpcMethodMetrics {
   ~RpcMethodMetrics();
 
   scoped_refptr<Histogram> handler_latency;
+
+  // Latency breakdown of YB RPC calls, could be null for other protocols.
+  // Time from receiving the call until it was queued to the service, i.e. time spent in reactor.
+  scoped_refptr<Histogram> dispatch_latency;
+  // Time from queueing the call until its handler was started, i.e. time spent in service queue.
+  scoped_refptr<Histogram> queue_latency;
+  // Time from queueing the response until it was written to the socket.
+  scoped_refptr<Histogram> response_latency;
 };
 
 // Handles incoming messages that initiate an RPC.
@@ -68,6 +76,12 @@ class ServiceIf {
 
   virtual void Shutdown();
   virtual std::string service_name() const = 0;
+
+  // Returns true if call is a bulk call, that should be queued separately and executed by the
+  // low priority thread pool, so it does not delay latency sensitive calls to this service.
+  virtual bool IsLowPriority(const InboundCall& call) const {
+    return false;
+  }
 };
 
 }  // namespace rpc
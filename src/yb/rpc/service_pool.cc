@@ -120,9 +120,11 @@ class ServicePoolImpl final : public InboundCallHandler {
                   ThreadPool* thread_pool,
                   Scheduler* scheduler,
                   ServiceIfPtr service,
-                  const scoped_refptr<MetricEntity>& entity)
+                  const scoped_refptr<MetricEntity>& entity,
+                  ThreadPool* low_priority_thread_pool)
       : max_queued_calls_(max_tasks),
         thread_pool_(*thread_pool),
+        low_priority_thread_pool_(low_priority_thread_pool),
         scheduler_(*scheduler),
         service_(std::move(service)),
         incoming_queue_time_(METRIC_rpc_incoming_queue_time.Instantiate(entity)),
@@ -164,11 +166,14 @@ class ServicePoolImpl final : public InboundCallHandler {
 
   void Enqueue(InboundCallPtr call) {
     TRACE_TO(call->trace(), "Inserting onto call queue");
+    call->RecordCallQueued();
 
-    auto queued_calls = queued_calls_.fetch_add(1, std::memory_order_acq_rel);
+    const bool low_priority = IsLowPriority(*call);
+    auto& queued_calls_counter = QueuedCalls(low_priority);
+    auto queued_calls = queued_calls_counter.fetch_add(1, std::memory_order_acq_rel);
     if (queued_calls >= max_queued_calls_) {
-      queued_calls_.fetch_sub(1, std::memory_order_relaxed);
-      Overflow(call, "service", queued_calls);
+      queued_calls_counter.fetch_sub(1, std::memory_order_relaxed);
+      Overflow(call, low_priority ? "low priority service" : "service", queued_calls);
       return;
     }
 
@@ -179,7 +184,7 @@ class ServicePoolImpl final : public InboundCallHandler {
       ScheduleCheckTimeout(call_deadline);
     }
 
-    thread_pool_.Enqueue(call->BindTask(this));
+    GetThreadPool(low_priority).Enqueue(call->BindTask(this));
   }
 
   const Counter* RpcsTimedOutInQueueMetricForTests() const {
@@ -216,9 +221,10 @@ class ServicePoolImpl final : public InboundCallHandler {
       return;
     }
 
-    queued_calls_.fetch_sub(1, std::memory_order_relaxed);
+    const bool low_priority = IsLowPriority(*call);
+    QueuedCalls(low_priority).fetch_sub(1, std::memory_order_relaxed);
     if (status.IsServiceUnavailable()) {
-      Overflow(call, "global", thread_pool_.options().queue_limit);
+      Overflow(call, "global", GetThreadPool(low_priority).options().queue_limit);
       return;
     }
     YB_LOG_EVERY_N_SECS(WARNING, 1)
@@ -247,7 +253,7 @@ class ServicePoolImpl final : public InboundCallHandler {
 
       if (incoming->TryStartProcessing()) {
         if (queued) {
-          queued_calls_.fetch_sub(1, std::memory_order_relaxed);
+          QueuedCalls(IsLowPriority(*incoming)).fetch_sub(1, std::memory_order_relaxed);
         }
         service_->Handle(std::move(incoming));
       }
@@ -264,9 +270,21 @@ class ServicePoolImpl final : public InboundCallHandler {
   }
 
  private:
+  bool IsLowPriority(const InboundCall& call) const {
+    return low_priority_thread_pool_ != nullptr && service_->IsLowPriority(call);
+  }
+
+  std::atomic<size_t>& QueuedCalls(bool low_priority) {
+    return low_priority ? queued_low_priority_calls_ : queued_calls_;
+  }
+
+  ThreadPool& GetThreadPool(bool low_priority) {
+    return low_priority ? *low_priority_thread_pool_ : thread_pool_;
+  }
+
   void TimedOut(InboundCall* call, const char* error_message, Counter* metric) {
     if (call->RespondTimedOutIfPending(error_message)) {
-      queued_calls_.fetch_sub(1, std::memory_order_relaxed);
+      QueuedCalls(IsLowPriority(*call)).fetch_sub(1, std::memory_order_relaxed);
       metric->Increment();
     }
   }
@@ -290,7 +308,10 @@ class ServicePoolImpl final : public InboundCallHandler {
       return false;
     }
 
-    return incoming->GetTimeInQueue().ToMilliseconds() > FLAGS_max_time_in_queue_ms;
+    // Low priority calls are dropped as soon as server is under backpressure, to free resources
+    // for latency sensitive calls.
+    return IsLowPriority(*incoming) ||
+           incoming->GetTimeInQueue().ToMilliseconds() > FLAGS_max_time_in_queue_ms;
   }
 
   void CheckTimeout(ScheduledTaskId task_id, CoarseTimePoint time, const Status& status) {
@@ -371,6 +392,7 @@ class ServicePoolImpl final : public InboundCallHandler {
 
   const size_t max_queued_calls_;
   ThreadPool& thread_pool_;
+  ThreadPool* const low_priority_thread_pool_;
   Scheduler& scheduler_;
   ServiceIfPtr service_;
   scoped_refptr<Histogram> incoming_queue_time_;
@@ -380,6 +402,7 @@ class ServicePoolImpl final : public InboundCallHandler {
   // Have to use CoarseDuration here, since CoarseTimePoint does not work with clang + libstdc++
   std::atomic<CoarseDuration> last_backpressure_at_{CoarseTimePoint().time_since_epoch()};
   std::atomic<size_t> queued_calls_{0};
+  std::atomic<size_t> queued_low_priority_calls_{0};
 
   // It is too expensive to update timeout priority queue when each call is received.
   // So we are doing the following trick.
@@ -424,9 +447,11 @@ ServicePool::ServicePool(size_t max_tasks,
                          ThreadPool* thread_pool,
                          Scheduler* scheduler,
                          ServiceIfPtr service,
-                         const scoped_refptr<MetricEntity>& metric_entity)
+                         const scoped_refptr<MetricEntity>& metric_entity,
+                         ThreadPool* low_priority_thread_pool)
     : impl_(new ServicePoolImpl(
-        max_tasks, thread_pool, scheduler, std::move(service), metric_entity)) {
+        max_tasks, thread_pool, scheduler, std::move(service), metric_entity,
+        low_priority_thread_pool)) {
 }
 
 ServicePool::~ServicePool() {
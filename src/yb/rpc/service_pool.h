@@ -57,13 +57,17 @@ namespace rpc {
 
 // A pool of threads that handle new incoming RPC calls.
 // Also includes a queue that calls get pushed onto for handling by the pool.
+// When low_priority_thread_pool is specified, calls that service reports as low priority are
+// queued separately, with their own limit, and executed by low_priority_thread_pool.
+// They are also dropped first when the server is under backpressure.
 class ServicePool : public RpcService {
  public:
   ServicePool(size_t max_tasks,
               ThreadPool* thread_pool,
               Scheduler* scheduler,
               ServiceIfPtr service,
-              const scoped_refptr<MetricEntity>& metric_entity);
+              const scoped_refptr<MetricEntity>& metric_entity,
+              ThreadPool* low_priority_thread_pool = nullptr);
   virtual ~ServicePool();
 
   // Shut down the queue and the thread pool.
@@ -146,6 +146,7 @@ Status TcpStream::TryWrite() {
 
 TcpStream::FillIovResult TcpStream::FillIov(iovec* out) {
   int index = 0;
+  size_t total_bytes = 0;
   size_t offset = send_position_;
   bool only_heartbeats = true;
   for (auto& data : sending_) {
@@ -167,14 +168,15 @@ TcpStream::FillIovResult TcpStream::FillIov(iovec* out) {
 
       out[index].iov_base = bytes.data() + offset;
       out[index].iov_len = bytes.size() - offset;
+      total_bytes += out[index].iov_len;
       offset = 0;
       if (++index == kMaxIov) {
-        return FillIovResult{index, only_heartbeats};
+        return FillIovResult{index, total_bytes, only_heartbeats};
       }
     }
   }
 
-  return FillIovResult{index, only_heartbeats};
+  return FillIovResult{index, total_bytes, only_heartbeats};
 }
 
 Status TcpStream::DoWrite() {
@@ -227,6 +229,12 @@ Status TcpStream::DoWrite() {
         context_->Transferred(data, Status::OK());
       }
     }
+
+    // A short write means that the socket send buffer is full, so the next write would fail with
+    // EAGAIN. Wait for the socket to become writable instead of spending a syscall on it.
+    if (static_cast<size_t>(written) < fill_result.bytes) {
+      break;
+    }
   }
 
   return Status::OK();
@@ -289,12 +297,12 @@ Status TcpStream::ReadHandler() {
       if (received.status().error_code() == ESHUTDOWN) {
         VLOG_WITH_PREFIX(1) << "Shut down by remote end.";
       } else {
-        YB_LOG_WITH_PREFIX_EVERY_N(INFO, 50) << " Recv failed: " << received;
+        YB_LOG_WITH_PREFIX_EVERY_N(INFO, 50) << " Recv failed: " << received.status();
       }
       return received.status();
     }
     // Exit the loop if we did not receive anything.
-    if (!received.get()) {
+    if (!received->received) {
       return Status::OK();
     }
     // If we were not able to process next call exit loop.
@@ -303,33 +311,40 @@ Status TcpStream::ReadHandler() {
     if (!continue_receiving.ok()) {
       return continue_receiving.status();
     }
-    if (!continue_receiving.get()) {
+    // The socket is level triggered, so when it was drained we will be notified about new data,
+    // and there is no need to spend a syscall on a receive that would fail with EAGAIN.
+    if (!continue_receiving.get() || received->drained) {
       return Status::OK();
     }
   }
 }
 
-Result<bool> TcpStream::Receive() {
+Result<TcpStream::ReceiveResult> TcpStream::Receive() {
   auto iov = ReadBuffer().PrepareAppend();
   if (!iov.ok()) {
     if (iov.status().IsBusy()) {
       read_buffer_full_ = true;
-      return false;
+      return ReceiveResult{false, false};
     }
     return iov.status();
   }
   read_buffer_full_ = false;
 
+  size_t capacity = 0;
+  for (const auto& vec : *iov) {
+    capacity += vec.iov_len;
+  }
+
   auto nread = socket_.Recvv(iov.get_ptr());
   if (!nread.ok()) {
     if (Socket::IsTemporarySocketError(nread.status())) {
-      return false;
+      return ReceiveResult{false, true};
     }
     return nread.status();
   }
 
   ReadBuffer().DataAppended(*nread);
-  return *nread != 0;
+  return ReceiveResult{*nread != 0, static_cast<size_t>(*nread) < capacity};
 }
 
 void TcpStream::ParseReceived() {
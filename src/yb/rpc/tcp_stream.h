@@ -42,9 +42,18 @@ class TcpStream : public Stream {
  private:
   struct FillIovResult {
     int len;
+    size_t bytes;
     bool only_heartbeats;
   };
 
+  struct ReceiveResult {
+    // Whether any data was received.
+    bool received;
+    // Whether less data than the read buffer could take was available, i.e. the socket was
+    // drained and the next receive would fail with EAGAIN.
+    bool drained;
+  };
+
   CHECKED_STATUS Start(bool connect, ev::loop_ref* loop, StreamContext* context) override;
   void Close() override;
   void Shutdown(const Status& status) override;
@@ -73,7 +82,7 @@ class TcpStream : public Stream {
   CHECKED_STATUS ReadHandler();
   CHECKED_STATUS WriteHandler(bool just_connected);
 
-  Result<bool> Receive();
+  Result<ReceiveResult> Receive();
   // Try to parse received data and process it.
   Result<bool> TryProcessReceived();
 
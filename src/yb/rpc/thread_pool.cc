@@ -24,6 +24,7 @@
 #include <cds/container/basket_queue.h>
 #include <cds/gc/dhp.h>
 
+#include "yb/util/os-util.h"
 #include "yb/util/thread.h"
 
 namespace yb {
@@ -94,6 +95,10 @@ class Worker {
   // does not have free hands (worker queue empty)
   void Execute() {
     Thread::current_thread()->SetUserData(share_);
+    if (!share_->options.cpus.empty()) {
+      WARN_NOT_OK(SetCurrentThreadCpuAffinity(share_->options.cpus),
+                  "Failed to set rpc worker cpu affinity");
+    }
     while (!stop_requested_) {
       ThreadPoolTask* task = nullptr;
       if (PopTask(&task)) {
@@ -18,6 +18,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "yb/gutil/port.h"
 
@@ -44,6 +45,8 @@ struct ThreadPoolOptions {
   std::string name;
   size_t queue_limit;
   size_t max_workers;
+  // Cpus that workers are restricted to, empty means no restriction.
+  std::vector<int> cpus;
 };
 
 class ThreadPool {
@@ -26,6 +26,7 @@
 #include "yb/rpc/serialization.h"
 
 #include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/memory/memory.h"
@@ -46,6 +47,12 @@ DEFINE_int32(rpc_max_message_size, 255_MB,
 
 DEFINE_bool(enable_rpc_keepalive, true, "Whether to enable RPC keepalive mechanism");
 
+DEFINE_string(rpc_compression_codec, "none",
+              "Compression codec requested for outbound RPC connections: none, lz4 or zstd. "
+              "Servers that do not support RPC compression reject such connections, so it should "
+              "be enabled only after all servers are upgraded.");
+TAG_FLAG(rpc_compression_codec, advanced);
+
 using std::placeholders::_1;
 DECLARE_int32(rpc_slow_query_threshold_ms);
 DECLARE_uint64(rpc_connection_timeout_ms);
@@ -57,14 +64,44 @@ constexpr const auto kHeartbeatsPerTimeoutPeriod = 3;
 
 namespace {
 
-// One byte after YugaByte is reserved for future use. It could control type of connection.
-const char kConnectionHeaderBytes[] = "YB\1";
-const size_t kConnectionHeaderSize = sizeof(kConnectionHeaderBytes) - 1;
+// One byte after YugaByte controls type of connection, it is 1 + compression codec.
+// So connections without compression have the same header as before compression was introduced.
+const char kConnectionHeaderPrefix[] = "YB";
+const size_t kConnectionHeaderPrefixSize = sizeof(kConnectionHeaderPrefix) - 1;
+const size_t kConnectionHeaderSize = kConnectionHeaderPrefixSize + 1;
+
+OutboundDataPtr ConnectionHeader(RpcCompressionCodec codec) {
+  static const std::vector<OutboundDataPtr> headers = [] {
+    std::vector<OutboundDataPtr> result;
+    for (auto codec : kRpcCompressionCodecList) {
+      std::string header(kConnectionHeaderPrefix, kConnectionHeaderPrefixSize);
+      header.push_back(static_cast<char>(1 + static_cast<int>(codec)));
+      result.push_back(std::make_shared<StringOutboundData>(header, "ConnectionHeader"));
+    }
+    return result;
+  }();
+  return headers[static_cast<size_t>(codec)];
+}
+
+Result<RpcCompressionCodec> ParseConnectionHeader(const Slice& slice) {
+  if (!slice.starts_with(kConnectionHeaderPrefix, kConnectionHeaderPrefixSize) ||
+      slice[kConnectionHeaderPrefixSize] < 1 ||
+      slice[kConnectionHeaderPrefixSize] > kRpcCompressionCodecMapSize) {
+    return STATUS_FORMAT(NetworkError,
+                         "Invalid connection header: $0",
+                         slice.ToDebugHexString());
+  }
+  return static_cast<RpcCompressionCodec>(slice[kConnectionHeaderPrefixSize] - 1);
+}
 
-OutboundDataPtr ConnectionHeaderInstance() {
-  static OutboundDataPtr result(
-      new StringOutboundData(kConnectionHeaderBytes, kConnectionHeaderSize, "ConnectionHeader"));
-  return result;
+RpcCompressionCodec RequestedCompressionCodec() {
+  auto codec = RpcCompressionCodecFromString(FLAGS_rpc_compression_codec);
+  if (!codec.ok()) {
+    YB_LOG_EVERY_N_SECS(WARNING, 60)
+        << "Bad rpc_compression_codec, using no compression: " << codec.status();
+    return RpcCompressionCodec::kNone;
+  }
+  return *codec;
 }
 
 const char kEmptyMsgLengthPrefix[kMsgLengthPrefixLength] = {0};
@@ -117,6 +154,22 @@ uint64_t YBConnectionContext::ExtractCallId(InboundCall* call) {
   return down_cast<YBInboundCall*>(call)->call_id();
 }
 
+Status YBConnectionContext::PrepareCallData(const ConnectionPtr& connection, CallData* call_data) {
+  if (compression_ == RpcCompressionCodec::kNone) {
+    return Status::OK();
+  }
+  return DecompressCallData(call_data, &connection->rpc_metrics());
+}
+
+OutboundDataPtr YBConnectionContext::PrepareOutboundData(
+    Connection* connection, OutboundDataPtr data) {
+  // Heartbeats are empty frames, they are skipped by parser, so sent as is.
+  if (compression_ == RpcCompressionCodec::kNone || data->IsHeartbeat()) {
+    return data;
+  }
+  return CompressOutboundData(std::move(data), compression_, &connection->rpc_metrics());
+}
+
 void YBInboundConnectionContext::Shutdown(const Status& status) {
   if (timer_.is_active()) {
     timer_.stop();
@@ -132,11 +185,7 @@ Result<ProcessDataResult> YBInboundConnectionContext::ProcessCalls(
     }
 
     Slice slice(static_cast<const char*>(data[0].iov_base), data[0].iov_len);
-    if (!slice.starts_with(kConnectionHeaderBytes, kConnectionHeaderSize)) {
-      return STATUS_FORMAT(NetworkError,
-                           "Invalid connection header: $0",
-                           slice.ToDebugHexString());
-    }
+    compression_ = VERIFY_RESULT(ParseConnectionHeader(slice));
     state_ = RpcConnectionPB::OPEN;
     IoVecs data_copy(data);
     data_copy[0].iov_len -= kConnectionHeaderSize;
@@ -154,12 +203,15 @@ Status YBInboundConnectionContext::HandleCall(
   auto reactor = connection->reactor();
   DCHECK(reactor->IsCurrentThread());
 
+  RETURN_NOT_OK(PrepareCallData(connection, call_data));
+
   auto call = InboundCall::Create<YBInboundCall>(connection, call_processed_listener());
 
   Status s = call->ParseFrom(call_tracker(), call_data);
   if (!s.ok()) {
     return s;
   }
+  call->RecordCallParsed();
 
   s = Store(call.get());
   if (!s.ok()) {
@@ -302,6 +354,12 @@ Status YBInboundCall::SerializeResponseBuffer(const google::protobuf::MessageLit
     absolute_sidecar_offset += car.size();
   }
 
+  // Checked here, so that the size of the response does not have to be calculated separately.
+  if (absolute_sidecar_offset > static_cast<uint32_t>(FLAGS_rpc_max_message_size)) {
+    return STATUS_FORMAT(InvalidArgument, "RPC message too long: $0 vs $1",
+                         absolute_sidecar_offset, FLAGS_rpc_max_message_size);
+  }
+
   int additional_size = absolute_sidecar_offset - protobuf_msg_size;
 
   size_t message_size = 0;
@@ -346,6 +404,7 @@ bool YBInboundCall::DumpPB(const DumpRunningRpcsRequestPB& req,
   }
   resp->set_micros_elapsed(MonoTime::Now().GetDeltaSince(timing_.time_received)
       .ToMicroseconds());
+  DumpTimingPB(resp->mutable_timing());
   return true;
 }
 
@@ -359,7 +418,7 @@ void YBInboundCall::LogTrace() const {
       // TODO: consider pushing this onto another thread since it may be slow.
       // The traces may also be too large to fit in a log message.
       LOG(WARNING) << ToString() << " took " << total_time << "ms (client timeout "
-                   << header_.timeout_millis() << "ms).";
+                   << header_.timeout_millis() << "ms), " << TimingToString() << ".";
       std::string s = trace_->DumpToString(true);
       if (!s.empty()) {
         LOG(WARNING) << "Trace:\n" << s;
@@ -371,7 +430,7 @@ void YBInboundCall::LogTrace() const {
   if (PREDICT_FALSE(
           FLAGS_rpc_dump_all_traces ||
           total_time > FLAGS_rpc_slow_query_threshold_ms)) {
-    LOG(INFO) << ToString() << " took " << total_time << "ms. Trace:";
+    LOG(INFO) << ToString() << " took " << total_time << "ms, " << TimingToString() << ". Trace:";
     trace_->Dump(&LOG(INFO), true);
   }
 }
@@ -451,7 +510,12 @@ void YBInboundCall::Respond(const MessageLite& response, bool is_success) {
   TRACE_EVENT_FLOW_END0("rpc", "InboundCall", this);
   Status s = SerializeResponseBuffer(response, is_success);
   if (PREDICT_FALSE(!s.ok())) {
-    // TODO: test error case, serialize error response instead
+    if (is_success) {
+      // The response could not be sent, e.g. because it is too long, so respond with the error.
+      ResetRpcSidecars();
+      RespondFailure(ErrorStatusPB::ERROR_APPLICATION, s);
+      return;
+    }
     LOG(DFATAL) << "Unable to serialize response: " << s.ToString();
   }
 
@@ -468,6 +532,7 @@ void YBOutboundConnectionContext::Shutdown(const Status& status) {
 
 Status YBOutboundConnectionContext::HandleCall(
     const ConnectionPtr& connection, CallData* call_data) {
+  RETURN_NOT_OK(PrepareCallData(connection, call_data));
   return connection->HandleCallResponse(call_data);
 }
 
@@ -481,7 +546,10 @@ void YBOutboundConnectionContext::Connected(const ConnectionPtr& connection) {
 }
 
 void YBOutboundConnectionContext::AssignConnection(const ConnectionPtr& connection) {
-  connection->QueueOutboundData(ConnectionHeaderInstance());
+  auto codec = RequestedCompressionCodec();
+  connection->QueueOutboundData(ConnectionHeader(codec));
+  // Header itself is sent uncompressed, so codec is assigned after it is queued.
+  compression_ = codec;
 }
 
 Result<ProcessDataResult> YBOutboundConnectionContext::ProcessCalls(
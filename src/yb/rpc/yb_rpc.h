@@ -19,6 +19,7 @@
 #include "yb/rpc/binary_call_parser.h"
 #include "yb/rpc/circular_read_buffer.h"
 #include "yb/rpc/connection_context.h"
+#include "yb/rpc/rpc_compression.h"
 #include "yb/rpc/rpc_with_call_id.h"
 
 namespace yb {
@@ -36,7 +37,16 @@ class YBConnectionContext : public ConnectionContextWithCallId, public BinaryCal
  protected:
   BinaryCallParser& parser() { return parser_; }
 
+  // Uncompresses call data received over connection with compression.
+  CHECKED_STATUS PrepareCallData(const ConnectionPtr& connection, CallData* call_data);
+
+  // Compression codec used by this connection, it is selected by the client and sent to the
+  // server in the connection header. So it is set after the header is sent or received.
+  RpcCompressionCodec compression_ = RpcCompressionCodec::kNone;
+
  private:
+  OutboundDataPtr PrepareOutboundData(Connection* connection, OutboundDataPtr data) override;
+
   uint64_t ExtractCallId(InboundCall* call) override;
 
   StreamReadBuffer& ReadBuffer() override {
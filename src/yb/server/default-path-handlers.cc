@@ -241,9 +241,36 @@ static void WriteMetricsAsJson(const MetricRegistry* const metrics,
               "Couldn't write JSON metrics over HTTP");
 }
 
+// Arguments:
+// metrics - comma separated substrings of the written metric names.
+// entities - comma separated substrings of the types or ids of the written metric entities.
+// aggregate - sum up metrics of tablets per table, true by default.
+// skip_zero - skip metrics with zero values, false by default.
 static void WriteForPrometheus(const MetricRegistry* const metrics,
-                               const Webserver::WebRequest& req, std::stringstream* output) {
-  PrometheusWriter writer(output);
+                               const Webserver::WebRequest& req, std::ostream* output) {
+  MetricPrometheusOptions opts;
+  {
+    const string* arg = FindOrNull(req.parsed_args, "metrics");
+    if (arg != nullptr) {
+      SplitStringUsing(*arg, ",", &opts.metrics);
+    }
+  }
+  {
+    const string* arg = FindOrNull(req.parsed_args, "entities");
+    if (arg != nullptr) {
+      SplitStringUsing(*arg, ",", &opts.entities);
+    }
+  }
+  {
+    string arg = FindWithDefault(req.parsed_args, "aggregate", "true");
+    opts.aggregate_tablets = ParseLeadingBoolValue(arg.c_str(), true);
+  }
+  {
+    string arg = FindWithDefault(req.parsed_args, "skip_zero", "false");
+    opts.skip_zero_values = ParseLeadingBoolValue(arg.c_str(), false);
+  }
+
+  PrometheusWriter writer(output, opts);
   WARN_NOT_OK(metrics->WriteForPrometheus(&writer), "Couldn't write text metrics for Prometheus");
 }
 
@@ -262,7 +289,7 @@ void AddDefaultPathHandlers(Webserver* webserver) {
 
 void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* const metrics) {
   Webserver::PathHandlerCallback callback = std::bind(WriteMetricsAsJson, metrics, _1, _2);
-  Webserver::PathHandlerCallback prometheus_callback = std::bind(
+  Webserver::StreamingPathHandlerCallback prometheus_callback = std::bind(
       WriteForPrometheus, metrics, _1, _2);
   bool not_styled = false;
   bool not_on_nav_bar = false;
@@ -272,8 +299,7 @@ void RegisterMetricsJsonHandler(Webserver* webserver, const MetricRegistry* cons
   // monitoring software which expects the old name.
   webserver->RegisterPathHandler("/jsonmetricz", "Metrics", callback, not_styled, not_on_nav_bar);
 
-  webserver->RegisterPathHandler(
-      "/prometheus-metrics", "Metrics", prometheus_callback, not_styled, not_on_nav_bar);
+  webserver->RegisterStreamingPathHandler("/prometheus-metrics", "Metrics", prometheus_callback);
 }
 
 } // namespace yb
@@ -31,6 +31,8 @@
 //
 
 #include <algorithm>
+#include <thread>
+
 #include <glog/logging.h>
 #include <gtest/gtest.h>
 
@@ -216,5 +218,51 @@ TEST_F(HybridClockTest, CompareHybridClocksToDelta) {
       MonoDelta::FromMicroseconds(1)));
 }
 
+// A logical value overflow carries into the physical component instead of wrapping around.
+TEST(MockHybridClockTest, LogicalOverflow) {
+  MockClock mock_clock;
+  scoped_refptr<HybridClock> clock(new HybridClock(mock_clock.AsClock()));
+  ASSERT_OK(clock->Init());
+  clock->Update(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(
+      1000, HybridTime::kLogicalBitMask - 1));
+  ASSERT_EQ(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(
+                1000, HybridTime::kLogicalBitMask),
+            clock->Now());
+  ASSERT_EQ(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1001, 0), clock->Now());
+  ASSERT_EQ(HybridClock::HybridTimeFromMicrosecondsAndLogicalValue(1001, 1), clock->Now());
+}
+
+// Measures Now() throughput when many threads read the clock concurrently, checking that each
+// thread observes strictly increasing values.
+TEST_F(HybridClockTest, NowContention) {
+  const int num_threads = std::max(4U, std::thread::hardware_concurrency());
+  std::atomic<bool> stop(false);
+  std::atomic<uint64_t> total_reads(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i != num_threads; ++i) {
+    threads.emplace_back([this, &stop, &total_reads] {
+      HybridTime prev = HybridTime::kMin;
+      uint64_t reads = 0;
+      while (!stop.load(std::memory_order_acquire)) {
+        auto now = clock_->Now();
+        ASSERT_GT(now, prev);
+        prev = now;
+        ++reads;
+      }
+      total_reads += reads;
+    });
+  }
+
+  const auto kDuration = MonoDelta::FromSeconds(3);
+  SleepFor(kDuration);
+  stop = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  LOG(INFO) << num_threads << " threads: " << total_reads.load() << " reads, "
+            << total_reads.load() / kDuration.ToSeconds() << " reads/sec";
+}
+
 }  // namespace server
 }  // namespace yb
@@ -108,34 +108,6 @@ class HybridClock : public Clock {
   const PhysicalClockPtr& TEST_clock() { return clock_; }
 
  private:
-  struct HybridClockComponents {
-    // The last clock read/update, in microseconds.
-    MicrosTime last_usec = 0;
-
-    // The next logical value to be assigned to a hybrid time.
-    LogicalTimeComponent logical = 0;
-
-    HybridClockComponents() noexcept {}
-
-    HybridClockComponents(MicrosTime last_usec_, LogicalTimeComponent logical_)
-        : last_usec(last_usec_),
-          logical(logical_) {
-    }
-
-    HybridClockComponents(HybridClockComponents&& other) = default;
-    HybridClockComponents(const HybridClockComponents& other) = default;
-
-    bool operator< (const HybridClockComponents& o) const {
-      return last_usec < o.last_usec || (last_usec == o.last_usec && logical < o.logical);
-    }
-
-    bool operator<= (const HybridClockComponents& o) const {
-      return last_usec < o.last_usec || (last_usec == o.last_usec && logical <= o.logical);
-    }
-
-    void HandleLogicalComponentOverflow();
-  };
-
   enum State {
     kNotInitialized,
     kInitialized
@@ -148,7 +120,13 @@ class HybridClock : public Clock {
   uint64_t ErrorForMetrics();
 
   PhysicalClockPtr clock_;
-  std::atomic<HybridClockComponents> components_{HybridClockComponents(0, 0)};
+
+  // The last clock read/update in the physical bits and the next logical value to be assigned
+  // in the logical bits, i.e. the next hybrid time that could be handed out without reading the
+  // physical clock. Packing both into a single word keeps the atomic lock-free, and lets a read
+  // that does not advance the physical time claim a logical value with a single fetch_add. A
+  // logical overflow naturally carries into the physical bits.
+  std::atomic<HybridTimeRepr> next_hybrid_time_{0};
   State state_ = kNotInitialized;
 
   // Clock metrics are set to detach to their last value. This means
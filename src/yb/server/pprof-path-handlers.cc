@@ -63,10 +63,12 @@
 #include "yb/gutil/sysinfo.h"
 #include "yb/server/webserver.h"
 #include "yb/util/env.h"
+#include "yb/util/flame_graph.h"
 #include "yb/util/logging.h"
 #include "yb/util/monotime.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/status.h"
+#include "yb/util/url-coding.h"
 
 DECLARE_bool(enable_process_lifetime_heap_profiling);
 DECLARE_string(heap_profile_path);
@@ -165,6 +167,91 @@ static void PprofCpuProfileHandler(const Webserver::WebRequest& req, stringstrea
 #endif
 }
 
+// Writes the flame graph as inline SVG, or in the collapsed format of flamegraph.pl when
+// format=folded is requested. With the 'raw' argument the page is sent as plain text.
+static void WriteFlameGraph(const Webserver::WebRequest& req, const FlameGraph& graph,
+                            const string& title, const string& unit, stringstream* output) {
+  const bool raw = ContainsKey(req.parsed_args, "raw");
+  if (FindWithDefault(req.parsed_args, "format", "svg") == "folded") {
+    if (!raw) {
+      *output << "<pre>";
+    }
+    std::stringstream folded;
+    graph.WriteFolded(&folded);
+    *output << (raw ? folded.str() : EscapeForHtmlToString(folded.str()));
+    if (!raw) {
+      *output << "</pre>";
+    }
+    return;
+  }
+  graph.WriteSvg(title, unit, output);
+}
+
+// Runs the CPU profiler for the requested number of seconds, and returns the samples
+// as a symbolized flame graph.
+static void CpuFlameGraphHandler(const Webserver::WebRequest& req, stringstream* output) {
+#ifndef TCMALLOC_ENABLED
+  (*output) << "CPU profiling is not available without tcmalloc.";
+#else
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), PPROF_DEFAULT_SAMPLE_SECS);
+  string tmp_prof_file_name = strings::Substitute(
+      "/tmp/yb_cpu_flamegraph.$0.$1", getpid(), rand());
+
+  LOG(INFO) << "Starting a cpu profile for flame graph:"
+            << " profiler file name=" << tmp_prof_file_name
+            << " seconds=" << seconds;
+
+  if (!ProfilerStart(tmp_prof_file_name.c_str())) {
+    (*output) << "Unable to start cpu profile, another one could be in progress.";
+    return;
+  }
+  SleepFor(MonoDelta::FromSeconds(seconds));
+  ProfilerStop();
+
+  Env* env = Env::Default();
+  faststring profile;
+  Status s = ReadFileToString(env, tmp_prof_file_name, &profile);
+  WARN_NOT_OK(env->DeleteFile(tmp_prof_file_name), "Failed to delete cpu profile");
+  FlameGraph graph;
+  if (s.ok()) {
+    s = graph.AddCpuProfile(Slice(profile));
+  }
+  if (!s.ok()) {
+    (*output) << "Unable to read cpu profile: " << EscapeForHtmlToString(s.ToString());
+    return;
+  }
+  WriteFlameGraph(
+      req, graph, strings::Substitute("CPU profile, $0 seconds", seconds), "samples", output);
+#endif
+}
+
+// Records lock contention for the requested number of seconds, and returns the wait time
+// aggregated by the stack that acquired the lock, as a flame graph.
+static void ContentionFlameGraphHandler(const Webserver::WebRequest& req, stringstream* output) {
+  string secs_str = FindWithDefault(req.parsed_args, "seconds", "");
+  int32_t seconds = ParseLeadingInt32Value(secs_str.c_str(), PPROF_DEFAULT_SAMPLE_SECS);
+  int64_t discarded_samples = 0;
+  std::vector<ContentionSample> samples;
+
+  StartSynchronizationProfiling();
+  SleepFor(MonoDelta::FromSeconds(seconds));
+  StopSynchronizationProfiling();
+  CollectSynchronizationProfile(&samples, &discarded_samples);
+
+  const double micros_per_cycle = 1e6 / base::CyclesPerSecond();
+  FlameGraph graph;
+  for (const auto& sample : samples) {
+    graph.AddStack(sample.stack.frames(), sample.stack.num_frames(),
+                   static_cast<int64_t>(sample.cycles * micros_per_cycle));
+  }
+  WriteFlameGraph(
+      req, graph,
+      strings::Substitute("Lock contention, $0 seconds, $1 discarded samples",
+                          seconds, discarded_samples),
+      "us", output);
+}
+
 // pprof asks for the url /pprof/growth to get heap-profiling delta (growth) information.
 // The server should respond by calling:
 // MallocExtension::instance()->GetHeapGrowthStacks(&output);
@@ -269,6 +356,11 @@ void AddPprofPathHandlers(Webserver* webserver) {
   webserver->RegisterPathHandler("/pprof/profile", "", PprofCpuProfileHandler, false, false);
   webserver->RegisterPathHandler("/pprof/symbol", "", PprofSymbolHandler, false, false);
   webserver->RegisterPathHandler("/pprof/contention", "", PprofContentionHandler, false, false);
+
+  // Flame graphs, that could be viewed in a browser.
+  webserver->RegisterPathHandler("/pprof/flamegraph", "", CpuFlameGraphHandler, true, false);
+  webserver->RegisterPathHandler(
+      "/pprof/contention_flamegraph", "", ContentionFlameGraphHandler, true, false);
 }
 
 } // namespace yb
@@ -131,9 +131,14 @@ Status RpcServer::RegisterService(size_t queue_limit,
   string service_name = service->service_name();
 
   rpc::ThreadPool& thread_pool = messenger_->ThreadPool(priority);
+  // Only normal priority services separate their bulk calls, consensus and other high priority
+  // services are not expected to have them.
+  rpc::ThreadPool* low_priority_thread_pool = priority == rpc::ServicePriority::kNormal
+      ? &messenger_->ThreadPool(rpc::ServicePriority::kLow) : nullptr;
 
   scoped_refptr<rpc::ServicePool> service_pool(new rpc::ServicePool(
-      queue_limit, &thread_pool, &messenger_->scheduler(), std::move(service), metric_entity));
+      queue_limit, &thread_pool, &messenger_->scheduler(), std::move(service), metric_entity,
+      low_priority_thread_pool));
   RETURN_NOT_OK(messenger_->RegisterService(service_name, service_pool));
   return Status::OK();
 }
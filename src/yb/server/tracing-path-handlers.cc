@@ -46,6 +46,7 @@
 #include "yb/gutil/strings/escaping.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/debug/trace_event_impl.h"
+#include "yb/util/sampled_trace.h"
 
 namespace yb {
 namespace server {
@@ -70,7 +71,8 @@ enum Handler {
   kBeginRecording,
   kGetBufferPercentFull,
   kEndRecording,
-  kSimpleDump
+  kSimpleDump,
+  kSampledSlowRequests
 };
 
 namespace {
@@ -236,6 +238,9 @@ Status DoHandleRequest(Handler handler,
     case kSimpleDump:
       HandleTraceJsonPage(req.parsed_args, output);
       break;
+    case kSampledSlowRequests:
+      SampledTrace::DumpCaptured(output);
+      break;
   }
 
   return Status::OK();
@@ -269,7 +274,8 @@ void TracingPathHandlers::RegisterHandlers(Webserver* server) {
     { "/tracing/json/begin_recording", kBeginRecording },
     { "/tracing/json/get_buffer_percent_full", kGetBufferPercentFull },
     { "/tracing/json/end_recording", kEndRecording },
-    { "/tracing/json/simple_dump", kSimpleDump } };
+    { "/tracing/json/simple_dump", kSimpleDump },
+    { "/tracing/sampled_slow_requests", kSampledSlowRequests } };
 
   typedef pair<string, Handler> HandlerPair;
   for (const HandlerPair& e : handlers) {
@@ -35,6 +35,7 @@
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 #include "yb/gutil/stringprintf.h"
@@ -181,4 +182,28 @@ TEST_F(WebserverTest, TestStaticFiles) {
   ASSERT_EQ("Remote error: HTTP 403", s.ToString(/* no file/line */ false));
 }
 
+// Test that the output of a streaming handler, that is larger than the chunk buffer, is received
+// completely.
+TEST_F(WebserverTest, TestStreamingPathHandler) {
+  server_->RegisterStreamingPathHandler(
+      "/stream", "Stream", [](const Webserver::WebRequest& req, std::ostream* output) {
+    int lines = std::stoi(FindWithDefault(req.parsed_args, "lines", "0"));
+    for (int i = 0; i != lines; ++i) {
+      *output << "line " << i << "\n";
+    }
+  });
+
+  constexpr int kLines = 50000;
+  string expected;
+  for (int i = 0; i != kLines; ++i) {
+    expected += strings::Substitute("line $0\n", i);
+  }
+  ASSERT_OK(curl_.FetchURL(
+      strings::Substitute("http://$0/stream?lines=$1", ToString(addr_), kLines), &buf_));
+  ASSERT_EQ(expected, buf_.ToString());
+
+  ASSERT_OK(curl_.FetchURL(strings::Substitute("http://$0/stream", ToString(addr_)), &buf_));
+  ASSERT_EQ("", buf_.ToString());
+}
+
 } // namespace yb
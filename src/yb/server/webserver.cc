@@ -50,6 +50,7 @@
 #include <functional>
 #include <map>
 #include <mutex>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -93,6 +94,63 @@ using std::make_pair;
 
 using namespace std::placeholders;
 
+namespace {
+
+// Writes the buffered output to the connection with chunked transfer encoding, so the size of the
+// whole response does not have to be known in advance.
+class ChunkedConnectionBuffer : public std::streambuf {
+ public:
+  explicit ChunkedConnectionBuffer(struct sq_connection* connection) : connection_(connection) {
+    setp(buffer_, buffer_ + sizeof(buffer_));
+  }
+
+  // Writes the rest of the output and the terminating chunk.
+  void Finish() {
+    if (WriteChunk()) {
+      sq_printf(connection_, "0\r\n\r\n");
+    }
+  }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (!WriteChunk()) {
+      return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+    }
+    return traits_type::not_eof(ch);
+  }
+
+  int sync() override {
+    return WriteChunk() ? 0 : -1;
+  }
+
+ private:
+  bool WriteChunk() {
+    if (failed_) {
+      return false;
+    }
+    size_t size = pptr() - pbase();
+    if (size == 0) {
+      return true;
+    }
+    setp(buffer_, buffer_ + sizeof(buffer_));
+    // The client could disconnect, then the rest of the output is dropped.
+    failed_ = sq_printf(connection_, "%zx\r\n", size) <= 0 ||
+              sq_write(connection_, buffer_, size) != static_cast<int>(size) ||
+              sq_printf(connection_, "\r\n") <= 0;
+    return !failed_;
+  }
+
+  struct sq_connection* const connection_;
+  bool failed_ = false;
+  char buffer_[64 * 1024];
+};
+
+} // namespace
+
 Webserver::Webserver(const WebserverOptions& opts, const std::string& server_name)
   : opts_(opts),
     context_(nullptr),
@@ -359,6 +417,18 @@ int Webserver::RunPathHandler(const PathHandler& handler,
     }
   }
 
+  if (handler.streaming_callback()) {
+    sq_printf(connection, "HTTP/1.1 200 OK\r\n"
+              "Content-Type: text/plain\r\n"
+              "Transfer-Encoding: chunked\r\n"
+              "\r\n");
+    ChunkedConnectionBuffer buffer(connection);
+    std::ostream output(&buffer);
+    handler.streaming_callback()(req, &output);
+    buffer.Finish();
+    return 1;
+  }
+
   if (!handler.is_styled() || ContainsKey(req.parsed_args, "raw")) {
     use_style = false;
   }
@@ -404,6 +474,19 @@ void Webserver::RegisterPathHandler(const string& path,
   it->second->AddCallback(callback);
 }
 
+void Webserver::RegisterStreamingPathHandler(const string& path,
+                                             const string& alias,
+                                             const StreamingPathHandlerCallback& callback) {
+  std::lock_guard<boost::shared_mutex> lock(lock_);
+  auto it = path_handlers_.find(path);
+  if (it == path_handlers_.end()) {
+    it = path_handlers_.insert(make_pair(
+        path, new PathHandler(false /* is_styled */, false /* is_on_nav_bar */, alias, ""))).first;
+  }
+  DCHECK(!it->second->streaming_callback()) << "Duplicate streaming handler for " << path;
+  it->second->SetStreamingCallback(callback);
+}
+
 const char* const PAGE_HEADER = "<!DOCTYPE html>"
 "<html>"
 "  <head>"
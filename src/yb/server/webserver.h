@@ -87,6 +87,9 @@ class Webserver : public WebCallbackRegistry {
                                    bool is_on_nav_bar = true,
                                    const std::string icon = "") override;
 
+  virtual void RegisterStreamingPathHandler(const std::string& path, const std::string& alias,
+                                            const StreamingPathHandlerCallback& callback) override;
+
   // Change the footer HTML to be displayed at the bottom of all styled web pages.
   void set_footer_html(const std::string& html);
 
@@ -107,11 +110,16 @@ class Webserver : public WebCallbackRegistry {
       callbacks_.push_back(callback);
     }
 
+    void SetStreamingCallback(const StreamingPathHandlerCallback& callback) {
+      streaming_callback_ = callback;
+    }
+
     bool is_styled() const { return is_styled_; }
     bool is_on_nav_bar() const { return is_on_nav_bar_; }
     const std::string& alias() const { return alias_; }
     const std::string& icon() const { return icon_; }
     const std::vector<PathHandlerCallback>& callbacks() const { return callbacks_; }
+    const StreamingPathHandlerCallback& streaming_callback() const { return streaming_callback_; }
 
    private:
     // If true, the page appears is rendered styled.
@@ -128,6 +136,9 @@ class Webserver : public WebCallbackRegistry {
 
     // List of callbacks to render output for this page, called in order.
     std::vector<PathHandlerCallback> callbacks_;
+
+    // If set, renders the page instead of callbacks_, writing it to the connection as it goes.
+    StreamingPathHandlerCallback streaming_callback_;
   };
 
   bool static_pages_available() const;
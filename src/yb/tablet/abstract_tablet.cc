@@ -98,15 +98,16 @@ Status AbstractTablet::HandlePgsqlReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(CreatePagingStateForRead(
       pgsql_read_request, resultset.rsrow_count(), &result->response));
 
-  // TODO(neil) The clients' request should indicate what encoding method should be used. When
-  // multi-shard is used to process more complicated queries, proxy-server might prefer a different
-  // encoding. For now, we'll call PgsqlSerialize() without checking encoding method.
   result->response.set_status(PgsqlResponsePB::PGSQL_STATUS_OK);
 
-  // Serializing data for PgGate API.
+  // Serializing data for PgGate API, in the encoding requested by the client.
   CHECK(!pgsql_read_request.has_rsrow_desc()) << "Row description is not needed";
   TRACE("Start Serialize");
-  RETURN_NOT_OK(pggate::PgDocData::WriteTuples(resultset, &result->rows_data));
+  if (pgsql_read_request.columnar_result()) {
+    RETURN_NOT_OK(pggate::PgDocData::WriteColumnarTuples(resultset, &result->rows_data));
+  } else {
+    RETURN_NOT_OK(pggate::PgDocData::WriteTuples(resultset, &result->rows_data));
+  }
   TRACE("Done Serialize");
 
   return Status::OK();
@@ -0,0 +1,97 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/admission_controller.h"
+
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+
+DECLARE_int32(tablet_max_inflight_requests);
+DECLARE_int32(tablet_admission_read_weight);
+DECLARE_int32(tablet_admission_write_weight);
+
+namespace yb {
+namespace tablet {
+
+class AdmissionControllerTest : public YBTest {
+ protected:
+  std::shared_ptr<AdmissionController> controller_ = std::make_shared<AdmissionController>();
+};
+
+TEST_F(AdmissionControllerTest, ShedByDeadline) {
+  {
+    AdmissionTicket ticket;
+    ASSERT_OK(controller_->Admit(AdmissionKind::kRead, CoarseTimePoint::max(), &ticket));
+    ASSERT_EQ(1, controller_->InFlight(AdmissionKind::kRead));
+    std::this_thread::sleep_for(100ms);
+  }
+  ASSERT_EQ(0, controller_->InFlight(AdmissionKind::kRead));
+  ASSERT_GE(controller_->ServiceTime(AdmissionKind::kRead), 100ms);
+
+  AdmissionTicket ticket;
+  auto status = controller_->Admit(
+      AdmissionKind::kRead, CoarseMonoClock::now() + 10ms, &ticket);
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+  ASSERT_EQ(0, controller_->InFlight(AdmissionKind::kRead));
+
+  // Writes were not served yet, so their service time is unknown.
+  ASSERT_OK(controller_->Admit(AdmissionKind::kWrite, CoarseMonoClock::now() + 10ms, &ticket));
+  ASSERT_OK(controller_->Admit(AdmissionKind::kRead, CoarseMonoClock::now() + 10s, &ticket));
+  ASSERT_EQ(0, controller_->InFlight(AdmissionKind::kWrite));
+  ASSERT_EQ(1, controller_->InFlight(AdmissionKind::kRead));
+}
+
+TEST_F(AdmissionControllerTest, WeightedLimit) {
+  FLAGS_tablet_max_inflight_requests = 8;
+  FLAGS_tablet_admission_read_weight = 1;
+  FLAGS_tablet_admission_write_weight = 3;
+
+  // Reads use the whole limit while there are no writes.
+  std::vector<AdmissionTicket> reads(8);
+  for (auto& ticket : reads) {
+    ASSERT_OK(controller_->Admit(AdmissionKind::kRead, CoarseTimePoint::max(), &ticket));
+  }
+  AdmissionTicket ticket;
+  ASSERT_TRUE(controller_->Admit(
+      AdmissionKind::kRead, CoarseTimePoint::max(), &ticket).IsServiceUnavailable());
+
+  // Writes are still admitted up to their share.
+  std::vector<AdmissionTicket> writes(6);
+  for (auto& ticket : writes) {
+    ASSERT_OK(controller_->Admit(AdmissionKind::kWrite, CoarseTimePoint::max(), &ticket));
+  }
+  ASSERT_TRUE(controller_->Admit(
+      AdmissionKind::kWrite, CoarseTimePoint::max(), &ticket).IsServiceUnavailable());
+
+  // Released read slots go to writes, until reads are back to their share.
+  reads.resize(2);
+  ASSERT_TRUE(controller_->Admit(
+      AdmissionKind::kRead, CoarseTimePoint::max(), &ticket).IsServiceUnavailable());
+  reads.pop_back();
+  ASSERT_OK(controller_->Admit(AdmissionKind::kWrite, CoarseTimePoint::max(), &ticket));
+  ASSERT_EQ(1, controller_->InFlight(AdmissionKind::kRead));
+  ASSERT_EQ(7, controller_->InFlight(AdmissionKind::kWrite));
+
+  // Reads are admitted within their share, even when the limit is reached.
+  reads.emplace_back();
+  ASSERT_OK(controller_->Admit(AdmissionKind::kRead, CoarseTimePoint::max(), &reads.back()));
+}
+
+} // namespace tablet
+} // namespace yb
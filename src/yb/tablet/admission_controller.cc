@@ -0,0 +1,144 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/admission_controller.h"
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/format.h"
+
+DEFINE_double(tablet_admission_service_time_factor, 1.0,
+              "Requests whose remaining deadline is less than the measured service time of the "
+              "tablet multiplied by this factor are rejected before being served. 0 to disable.");
+TAG_FLAG(tablet_admission_service_time_factor, advanced);
+TAG_FLAG(tablet_admission_service_time_factor, runtime);
+
+DEFINE_int32(tablet_max_inflight_requests, 0,
+             "Max number of read and write requests served by a tablet at the same time. Requests "
+             "over the limit are rejected, so clients retry them later. 0 for no limit.");
+TAG_FLAG(tablet_max_inflight_requests, advanced);
+TAG_FLAG(tablet_max_inflight_requests, runtime);
+
+DEFINE_int32(tablet_admission_read_weight, 1,
+             "Weight of reads in the split of --tablet_max_inflight_requests between reads and "
+             "writes.");
+TAG_FLAG(tablet_admission_read_weight, advanced);
+TAG_FLAG(tablet_admission_read_weight, runtime);
+
+DEFINE_int32(tablet_admission_write_weight, 1,
+             "Weight of writes in the split of --tablet_max_inflight_requests between reads and "
+             "writes.");
+TAG_FLAG(tablet_admission_write_weight, advanced);
+TAG_FLAG(tablet_admission_write_weight, runtime);
+
+namespace yb {
+namespace tablet {
+
+namespace {
+
+// Weight of the last sample in the moving average of the service time is 1 / kServiceTimeDivisor.
+constexpr int64_t kServiceTimeDivisor = 8;
+
+AdmissionKind OtherKind(AdmissionKind kind) {
+  return kind == AdmissionKind::kRead ? AdmissionKind::kWrite : AdmissionKind::kRead;
+}
+
+int64_t Share(AdmissionKind kind, int64_t limit) {
+  const int64_t read_weight = std::max(FLAGS_tablet_admission_read_weight, 0);
+  const int64_t write_weight = std::max(FLAGS_tablet_admission_write_weight, 0);
+  const int64_t total_weight = read_weight + write_weight;
+  if (total_weight == 0) {
+    return limit / 2;
+  }
+  return limit * (kind == AdmissionKind::kRead ? read_weight : write_weight) / total_weight;
+}
+
+} // namespace
+
+AdmissionTicket::AdmissionTicket(AdmissionTicket&& rhs)
+    : controller_(std::move(rhs.controller_)), kind_(rhs.kind_), start_(rhs.start_) {
+}
+
+AdmissionTicket& AdmissionTicket::operator=(AdmissionTicket&& rhs) {
+  Release();
+  controller_ = std::move(rhs.controller_);
+  kind_ = rhs.kind_;
+  start_ = rhs.start_;
+  return *this;
+}
+
+void AdmissionTicket::Release() {
+  if (controller_) {
+    controller_->Release(kind_, CoarseMonoClock::now() - start_);
+    controller_.reset();
+  }
+}
+
+Status AdmissionController::Admit(
+    AdmissionKind kind, CoarseTimePoint deadline, AdmissionTicket* ticket) {
+  auto& own = state(kind);
+  const auto now = CoarseMonoClock::now();
+  const auto service_time_factor = FLAGS_tablet_admission_service_time_factor;
+  if (service_time_factor > 0 && deadline != CoarseTimePoint::max()) {
+    const auto service_time = std::chrono::microseconds(static_cast<int64_t>(
+        own.service_time_us.load(std::memory_order_relaxed) * service_time_factor));
+    if (deadline - now < service_time) {
+      return STATUS_FORMAT(
+          TimedOut, "$0 cannot be served before its deadline, remaining: $1, service time: $2",
+          kind, MonoDelta(deadline - now), MonoDelta(service_time));
+    }
+  }
+
+  const int64_t in_flight = own.in_flight.fetch_add(1, std::memory_order_acq_rel) + 1;
+  const int64_t limit = FLAGS_tablet_max_inflight_requests;
+  if (limit > 0 && in_flight > Share(kind, limit)) {
+    const auto other_kind = OtherKind(kind);
+    const int64_t other_in_flight = state(other_kind).in_flight.load(std::memory_order_acquire);
+    // Over its share, a kind only uses slots that are not used by the other kind.
+    if (in_flight + other_in_flight > limit) {
+      own.in_flight.fetch_sub(1, std::memory_order_acq_rel);
+      return STATUS_FORMAT(
+          ServiceUnavailable, "Too many requests in flight, $0: $1, $2: $3, limit: $4",
+          kind, in_flight - 1, other_kind, other_in_flight, limit);
+    }
+  }
+
+  ticket->Release();
+  ticket->controller_ = shared_from_this();
+  ticket->kind_ = kind;
+  ticket->start_ = now;
+  return Status::OK();
+}
+
+void AdmissionController::Release(AdmissionKind kind, CoarseDuration service_time) {
+  auto& own = state(kind);
+  own.in_flight.fetch_sub(1, std::memory_order_acq_rel);
+
+  const int64_t sample = std::max<int64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(service_time).count(), 1);
+  // Concurrent updates could lose a sample, which is fine for an estimate.
+  const int64_t old_value = own.service_time_us.load(std::memory_order_relaxed);
+  const int64_t new_value = old_value == 0
+      ? sample : old_value + (sample - old_value) / kServiceTimeDivisor;
+  own.service_time_us.store(new_value, std::memory_order_relaxed);
+}
+
+CoarseDuration AdmissionController::ServiceTime(AdmissionKind kind) const {
+  return std::chrono::microseconds(state(kind).service_time_us.load(std::memory_order_relaxed));
+}
+
+int64_t AdmissionController::InFlight(AdmissionKind kind) const {
+  return state(kind).in_flight.load(std::memory_order_acquire);
+}
+
+} // namespace tablet
+} // namespace yb
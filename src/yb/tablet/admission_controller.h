@@ -0,0 +1,106 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_ADMISSION_CONTROLLER_H
+#define YB_TABLET_ADMISSION_CONTROLLER_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+#include "yb/util/enums.h"
+#include "yb/util/monotime.h"
+#include "yb/util/status.h"
+
+namespace yb {
+namespace tablet {
+
+YB_DEFINE_ENUM(AdmissionKind, (kRead)(kWrite));
+
+class AdmissionController;
+
+// Keeps a request admitted by AdmissionController in flight. The request is considered served when
+// the ticket is released or destroyed.
+class AdmissionTicket {
+ public:
+  AdmissionTicket() = default;
+  AdmissionTicket(AdmissionTicket&& rhs);
+  AdmissionTicket& operator=(AdmissionTicket&& rhs);
+  ~AdmissionTicket() { Release(); }
+
+  AdmissionTicket(const AdmissionTicket&) = delete;
+  void operator=(const AdmissionTicket&) = delete;
+
+  void Release();
+
+ private:
+  friend class AdmissionController;
+
+  std::shared_ptr<AdmissionController> controller_;
+  AdmissionKind kind_ = AdmissionKind::kRead;
+  CoarseTimePoint start_;
+};
+
+// Decides whether a tablet should start serving a request.
+//
+// A request is shed when its remaining deadline cannot cover the service time measured for
+// requests of the same kind, since the result would not reach the client in time anyway.
+//
+// When --tablet_max_inflight_requests is set, requests in flight are limited, and the limit is
+// split between reads and writes by --tablet_admission_read_weight and
+// --tablet_admission_write_weight. A kind may always use its own share, and may use more while
+// the total number of requests in flight is under the limit. So the total could temporarily exceed
+// the limit, while the other kind releases the slots it used over its share.
+class AdmissionController : public std::enable_shared_from_this<AdmissionController> {
+ public:
+  AdmissionController() = default;
+
+  AdmissionController(const AdmissionController&) = delete;
+  void operator=(const AdmissionController&) = delete;
+
+  // Admits a request with the specified deadline, filling ticket. Returns TimedOut when the request
+  // cannot be served before its deadline, and ServiceUnavailable when too many requests are in
+  // flight.
+  CHECKED_STATUS Admit(AdmissionKind kind, CoarseTimePoint deadline, AdmissionTicket* ticket);
+
+  // Moving average of the time it took to serve requests of the specified kind.
+  CoarseDuration ServiceTime(AdmissionKind kind) const;
+
+  int64_t InFlight(AdmissionKind kind) const;
+
+ private:
+  friend class AdmissionTicket;
+
+  struct KindState {
+    std::atomic<int64_t> in_flight{0};
+    // Moving average of the service time, in microseconds. 0 until the first request is served.
+    std::atomic<int64_t> service_time_us{0};
+  };
+
+  void Release(AdmissionKind kind, CoarseDuration service_time);
+
+  KindState& state(AdmissionKind kind) {
+    return states_[to_underlying(kind)];
+  }
+
+  const KindState& state(AdmissionKind kind) const {
+    return states_[to_underlying(kind)];
+  }
+
+  std::array<KindState, kAdmissionKindMapSize> states_;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_ADMISSION_CONTROLLER_H
@@ -0,0 +1,73 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <gtest/gtest.h>
+
+#include "yb/tablet/hot_key_tracker.h"
+
+#include "yb/util/test_util.h"
+
+namespace yb {
+namespace tablet {
+
+class HotKeyTrackerTest : public YBTest {
+};
+
+TEST_F(HotKeyTrackerTest, TopKeys) {
+  HotKeyTracker tracker(/* capacity= */ 8, /* sampling_interval= */ 1);
+  for (int i = 0; i != 100; ++i) {
+    tracker.Record("hot");
+    if (i % 2 == 0) {
+      tracker.Record("warm");
+    }
+    // Each cold key is seen once, so they keep evicting each other.
+    tracker.Record("cold" + std::to_string(i));
+  }
+
+  ASSERT_EQ(250, tracker.total_count());
+  auto top = tracker.TopKeys(2);
+  ASSERT_EQ(2, top.size());
+  ASSERT_EQ("hot", top[0].key);
+  ASSERT_GE(top[0].count, 100);
+  ASSERT_EQ("warm", top[1].key);
+  ASSERT_GE(top[1].count, 50);
+  ASSERT_EQ(8, tracker.TopKeys(10).size());
+
+  tracker.Reset();
+  ASSERT_EQ(0, tracker.total_count());
+  ASSERT_TRUE(tracker.TopKeys(10).empty());
+}
+
+TEST_F(HotKeyTrackerTest, Sampling) {
+  constexpr uint32_t kInterval = 16;
+  constexpr int kAccesses = 100000;
+  HotKeyTracker tracker(/* capacity= */ 8, kInterval);
+  for (int i = 0; i != kAccesses; ++i) {
+    tracker.Record("key");
+  }
+  // Counts are scaled by the sampling interval, so they estimate the real number of accesses.
+  auto top = tracker.TopKeys(1);
+  ASSERT_EQ(1, top.size());
+  ASSERT_GT(top[0].count, kAccesses / 2);
+  ASSERT_LT(top[0].count, kAccesses * 2);
+}
+
+TEST_F(HotKeyTrackerTest, Disabled) {
+  HotKeyTracker tracker(/* capacity= */ 8, /* sampling_interval= */ 0);
+  tracker.Record("key");
+  ASSERT_EQ(0, tracker.total_count());
+  ASSERT_TRUE(tracker.TopKeys(1).empty());
+}
+
+} // namespace tablet
+} // namespace yb
@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tablet/hot_key_tracker.h"
+
+#include <algorithm>
+
+#include "yb/util/random_util.h"
+
+namespace yb {
+namespace tablet {
+
+HotKeyTracker::HotKeyTracker(size_t capacity, uint32_t sampling_interval)
+    : capacity_(std::max<size_t>(capacity, 1)), sampling_interval_(sampling_interval) {
+  counts_.reserve(capacity_);
+}
+
+bool HotKeyTracker::Sampled() {
+  // Accesses are sampled at random intervals of sampling_interval_ on average, so periodic access
+  // patterns do not skew the sample. The counter is shared by all trackers used by the thread.
+  static thread_local int64_t countdown = 0;
+  if (--countdown > 0) {
+    return false;
+  }
+  countdown = sampling_interval_ > 1 ? RandomUniformInt<int64_t>(1, 2 * sampling_interval_ - 1)
+                                     : 1;
+  return true;
+}
+
+void HotKeyTracker::RecordSampled(Slice key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++total_count_;
+  auto it = counts_.find(key.ToBuffer());
+  if (it != counts_.end()) {
+    ++it->second.first;
+    return;
+  }
+  if (counts_.size() < capacity_) {
+    counts_.emplace(key.ToBuffer(), std::make_pair(1, 0));
+    return;
+  }
+  auto min_it = std::min_element(counts_.begin(), counts_.end(), [](const auto& lhs,
+                                                                    const auto& rhs) {
+    return lhs.second.first < rhs.second.first;
+  });
+  const auto min_count = min_it->second.first;
+  counts_.erase(min_it);
+  counts_.emplace(key.ToBuffer(), std::make_pair(min_count + 1, min_count));
+}
+
+std::vector<HotKey> HotKeyTracker::TopKeys(size_t limit) const {
+  std::vector<HotKey> result;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(counts_.size());
+    for (const auto& entry : counts_) {
+      result.push_back(HotKey{entry.first, entry.second.first * sampling_interval_,
+                              entry.second.second * sampling_interval_});
+    }
+  }
+  std::sort(result.begin(), result.end(), [](const HotKey& lhs, const HotKey& rhs) {
+    return lhs.count > rhs.count;
+  });
+  if (result.size() > limit) {
+    result.resize(limit);
+  }
+  return result;
+}
+
+uint64_t HotKeyTracker::total_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_count_ * sampling_interval_;
+}
+
+void HotKeyTracker::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  counts_.clear();
+  total_count_ = 0;
+}
+
+} // namespace tablet
+} // namespace yb
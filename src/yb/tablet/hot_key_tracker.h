@@ -0,0 +1,86 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TABLET_HOT_KEY_TRACKER_H
+#define YB_TABLET_HOT_KEY_TRACKER_H
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/slice.h"
+
+namespace yb {
+namespace tablet {
+
+struct HotKey {
+  std::string key;
+  // Estimated number of accesses to the key, scaled by the sampling interval.
+  uint64_t count;
+  // Max overestimation of count.
+  uint64_t error;
+};
+
+// Tracks approximately the most frequently accessed keys, using the space-saving algorithm over
+// a sample of accesses.
+//
+// Only one of sampling_interval accesses is sampled, so the cost of an access that is not sampled
+// is a thread local counter decrement. At most capacity keys are tracked. When a sampled key is
+// not tracked and there is no room for it, it replaces the tracked key with the lowest count and
+// inherits its count, which becomes the error of the new key.
+class HotKeyTracker {
+ public:
+  HotKeyTracker(size_t capacity, uint32_t sampling_interval);
+
+  HotKeyTracker(const HotKeyTracker&) = delete;
+  void operator=(const HotKeyTracker&) = delete;
+
+  // Whether the current access should be recorded. Callers that have to compute the key check it
+  // first, and call RecordSampled only for sampled accesses.
+  bool ShouldRecord() {
+    return sampling_interval_ != 0 && Sampled();
+  }
+
+  void RecordSampled(Slice key);
+
+  void Record(Slice key) {
+    if (ShouldRecord()) {
+      RecordSampled(key);
+    }
+  }
+
+  // Returns up to limit tracked keys, in order of decreasing count.
+  std::vector<HotKey> TopKeys(size_t limit) const;
+
+  // Total number of sampled accesses, scaled by the sampling interval.
+  uint64_t total_count() const;
+
+  void Reset();
+
+ private:
+  bool Sampled();
+
+  const size_t capacity_;
+  const uint32_t sampling_interval_;
+
+  mutable std::mutex mutex_;
+  // Maps tracked key to its count and error, in sampled accesses.
+  std::unordered_map<std::string, std::pair<uint64_t, uint64_t>> counts_;
+  uint64_t total_count_ = 0;
+};
+
+} // namespace tablet
+} // namespace yb
+
+#endif // YB_TABLET_HOT_KEY_TRACKER_H
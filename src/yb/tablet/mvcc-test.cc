@@ -46,6 +46,8 @@
 using namespace std::literals;
 using std::vector;
 
+DECLARE_bool(mvcc_lock_free_safe_time);
+
 using yb::server::LogicalClock;
 
 namespace yb {
@@ -128,6 +130,24 @@ TEST_F(MvccTest, Abort) {
   ASSERT_EQ(now, manager_.SafeTime(now));
 }
 
+TEST_F(MvccTest, PendingFollowerSideOperations) {
+  ASSERT_FALSE(manager_.HasPendingFollowerSideOperations());
+
+  HybridTime follower_ht = clock_->Now();
+  manager_.AddPending(&follower_ht);
+  ASSERT_TRUE(manager_.HasPendingFollowerSideOperations());
+
+  HybridTime leader_ht;
+  manager_.AddPending(&leader_ht);
+  ASSERT_TRUE(manager_.HasPendingFollowerSideOperations());
+
+  manager_.Replicated(follower_ht);
+  ASSERT_FALSE(manager_.HasPendingFollowerSideOperations());
+
+  manager_.Replicated(leader_ht);
+  ASSERT_FALSE(manager_.HasPendingFollowerSideOperations());
+}
+
 void MvccTest::RunRandomizedTest(bool use_ht_lease) {
   constexpr size_t kTotalOperations = 20000;
   enum class Op { kAdd, kReplicated, kAborted };
@@ -320,5 +340,49 @@ TEST_F(MvccTest, WaitForSafeTime) {
   ASSERT_FALSE(manager_.SafeTime(ht3, CoarseMonoClock::now() + 100ms, HybridTime::kMax));
 }
 
+// Measures the rate of safe time reads against a tablet that is concurrently written to.
+TEST_F(MvccTest, SafeTimeReadThroughput) {
+  constexpr int kNumReaders = 8;
+  const auto kTestTime = 2s;
+
+  for (bool lock_free : {false, true}) {
+    FLAGS_mvcc_lock_free_safe_time = lock_free;
+    std::atomic<bool> stop(false);
+    std::atomic<size_t> reads(0);
+    std::atomic<size_t> writes(0);
+    std::vector<std::thread> threads;
+    threads.emplace_back([this, &stop, &writes] {
+      while (!stop.load(std::memory_order_acquire)) {
+        HybridTime ht;
+        manager_.AddPending(&ht);
+        manager_.Replicated(ht);
+        writes.fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+    for (int i = 0; i != kNumReaders; ++i) {
+      threads.emplace_back([this, &stop, &reads] {
+        HybridTime last_safe_time = HybridTime::kMin;
+        size_t local_reads = 0;
+        while (!stop.load(std::memory_order_acquire)) {
+          auto safe_time = manager_.SafeTime(HybridTime::kMax);
+          ASSERT_GE(safe_time, last_safe_time);
+          last_safe_time = safe_time;
+          ++local_reads;
+        }
+        reads.fetch_add(local_reads, std::memory_order_relaxed);
+      });
+    }
+    std::this_thread::sleep_for(kTestTime);
+    stop.store(true, std::memory_order_release);
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    const auto seconds = std::chrono::duration<double>(kTestTime).count();
+    LOG(INFO) << (lock_free ? "Lock-free" : "Locked") << " safe time: "
+              << reads.load() / seconds << " reads/sec, " << writes.load() / seconds
+              << " writes/sec";
+  }
+}
+
 } // namespace tablet
 } // namespace yb
@@ -34,8 +34,18 @@
 
 #include <sstream>
 
+#include <gflags/gflags.h>
+
+#include "yb/util/atomic.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 
+DEFINE_bool(mvcc_lock_free_safe_time, true,
+            "Whether safe time could be computed without acquiring the MVCC manager mutex, from "
+            "the state published by the last operation change.");
+TAG_FLAG(mvcc_lock_free_safe_time, advanced);
+TAG_FLAG(mvcc_lock_free_safe_time, runtime);
+
 namespace yb {
 namespace tablet {
 
@@ -62,8 +72,10 @@ void MvccManager::Replicated(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty()) << LogPrefix();
     CHECK_EQ(queue_.front(), ht) << LogPrefix();
+    StartUpdate();
     PopFront(&lock);
     last_replicated_ = ht;
+    FinishUpdate();
   }
   cond_.notify_all();
 }
@@ -75,7 +87,9 @@ void MvccManager::Aborted(HybridTime ht) {
     std::lock_guard<std::mutex> lock(mutex_);
     CHECK(!queue_.empty()) << LogPrefix();
     if (queue_.front() == ht) {
+      StartUpdate();
       PopFront(&lock);
+      FinishUpdate();
     } else {
       aborted_.push(ht);
       return;
@@ -97,12 +111,28 @@ void MvccManager::PopFront(std::lock_guard<std::mutex>* lock) {
   }
 }
 
+void MvccManager::StartUpdate() const {
+  version_.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void MvccManager::FinishUpdate() const {
+  published_queue_front_.store(
+      queue_.empty() ? HybridTime::kInvalid.ToUint64() : queue_.front().ToUint64(),
+      std::memory_order_relaxed);
+  published_last_replicated_.store(last_replicated_.ToUint64(), std::memory_order_relaxed);
+  published_max_ht_lease_seen_.store(max_ht_lease_seen_.ToUint64(), std::memory_order_relaxed);
+  version_.fetch_add(1, std::memory_order_release);
+}
+
 void MvccManager::AddPending(HybridTime* ht) {
   const bool is_follower_side = ht->is_valid();
   std::lock_guard<std::mutex> lock(mutex_);
+  // The clock is read after lock-free readers are notified about the change, see version_.
+  StartUpdate();
   if (is_follower_side) {
     // This must be a follower-side transaction with already known hybrid time.
     VLOG_WITH_PREFIX(1) << "AddPending(" << *ht << ")";
+    max_follower_side_pending_ = std::max(max_follower_side_pending_, *ht);
   } else {
     // Otherwise this is a new transaction and we must assign a new hybrid_time. We assign one in
     // the present.
@@ -135,6 +165,7 @@ void MvccManager::AddPending(HybridTime* ht) {
           max_safe_time_returned_with_lease_.safe_time,
           max_safe_time_returned_without_lease_.safe_time,
           max_safe_time_returned_for_follower_.safe_time,
+          HybridTime(max_safe_time_returned_lock_free_.load(std::memory_order_acquire)),
           last_replicated_,
           last_ht_in_queue});
 
@@ -191,6 +222,7 @@ void MvccManager::AddPending(HybridTime* ht) {
     }
   }
   queue_.push_back(*ht);
+  FinishUpdate();
 }
 
 void MvccManager::SetLastReplicated(HybridTime ht) {
@@ -198,7 +230,9 @@ void MvccManager::SetLastReplicated(HybridTime ht) {
 
   {
     std::lock_guard<std::mutex> lock(mutex_);
+    StartUpdate();
     last_replicated_ = ht;
+    FinishUpdate();
   }
   cond_.notify_all();
 }
@@ -281,10 +315,55 @@ HybridTime MvccManager::SafeTimeForFollower(
 HybridTime MvccManager::SafeTime(HybridTime min_allowed,
                                  CoarseTimePoint deadline,
                                  HybridTime ht_lease) const {
+  if (FLAGS_mvcc_lock_free_safe_time) {
+    auto result = TryGetSafeTimeLockFree(min_allowed, ht_lease);
+    if (result) {
+      return result;
+    }
+  }
   std::unique_lock<std::mutex> lock(mutex_);
   return DoGetSafeTime(min_allowed, deadline, ht_lease, &lock);
 }
 
+HybridTime MvccManager::TryGetSafeTimeLockFree(HybridTime min_allowed, HybridTime ht_lease) const {
+  if (!ht_lease.is_valid() || min_allowed > ht_lease) {
+    // Let the slow path report the error.
+    return HybridTime::kInvalid;
+  }
+
+  const auto version = version_.load(std::memory_order_acquire);
+  if (version & 1) {
+    return HybridTime::kInvalid;
+  }
+  const HybridTime queue_front(published_queue_front_.load(std::memory_order_relaxed));
+  const HybridTime last_replicated(published_last_replicated_.load(std::memory_order_relaxed));
+  const HybridTime max_ht_lease_seen(published_max_ht_lease_seen_.load(std::memory_order_relaxed));
+
+  // Only a lease that is not newer than the max one seen could be handled here, since the max
+  // lease is updated under the mutex.
+  const bool has_lease = ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros;
+  if (has_lease && ht_lease > max_ht_lease_seen) {
+    return HybridTime::kInvalid;
+  }
+
+  HybridTime result = queue_front ? queue_front.Decremented() : clock_->Now();
+  if (has_lease && result > max_ht_lease_seen) {
+    result = max_ht_lease_seen;
+  }
+  result = std::max(result, last_replicated);
+
+  // Makes sure that the clock was read before the version is checked again.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (version_.load(std::memory_order_relaxed) != version || result < min_allowed) {
+    return HybridTime::kInvalid;
+  }
+
+  UpdateAtomicMax(&max_safe_time_returned_lock_free_, result.ToUint64());
+  VLOG_WITH_PREFIX(3) << "TryGetSafeTimeLockFree(" << min_allowed << ", " << ht_lease
+                      << "), result = " << result;
+  return result;
+}
+
 HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
                                       const CoarseTimePoint deadline,
                                       const HybridTime ht_lease,
@@ -294,8 +373,10 @@ HybridTime MvccManager::DoGetSafeTime(const HybridTime min_allowed,
   CHECK_LE(min_allowed, ht_lease) << LogPrefix();
 
   const bool has_lease = ht_lease.GetPhysicalValueMicros() < kMaxHybridTimePhysicalMicros;
-  if (has_lease) {
-    max_ht_lease_seen_ = std::max(ht_lease, max_ht_lease_seen_);
+  if (has_lease && ht_lease > max_ht_lease_seen_) {
+    StartUpdate();
+    max_ht_lease_seen_ = ht_lease;
+    FinishUpdate();
   }
 
   HybridTime result;
@@ -361,5 +442,12 @@ HybridTime MvccManager::LastReplicatedHybridTime() const {
   return last_replicated_;
 }
 
+bool MvccManager::HasPendingFollowerSideOperations() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Operations are replicated in order of their hybrid times, so all operations before the first
+  // one in the queue are already replicated or aborted.
+  return !queue_.empty() && max_follower_side_pending_ >= queue_.front();
+}
+
 }  // namespace tablet
 }  // namespace yb
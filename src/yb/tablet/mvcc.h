@@ -32,6 +32,7 @@
 #ifndef YB_TABLET_MVCC_H_
 #define YB_TABLET_MVCC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <deque>
@@ -126,12 +127,28 @@ class MvccManager {
   // Returns time of last replicated operation.
   HybridTime LastReplicatedHybridTime() const;
 
+  // Whether there are pending operations that were added with already known hybrid time, i.e.
+  // operations received from a leader, including a previous leader of the current leader. Such
+  // operations do not hold locks in the shared lock manager.
+  bool HasPendingFollowerSideOperations() const;
+
  private:
   HybridTime DoGetSafeTime(HybridTime min_allowed,
                            CoarseTimePoint deadline,
                            HybridTime ht_lease,
                            std::unique_lock<std::mutex>* lock) const;
 
+  // Tries to compute safe time without taking the mutex, from the state published by the last
+  // change made under the mutex. Returns invalid hybrid time if the state is being changed
+  // concurrently, the safe time would have to wait for min_allowed, or ht_lease is greater than
+  // the max hybrid time leader lease seen, so the slow path should be used instead.
+  HybridTime TryGetSafeTimeLockFree(HybridTime min_allowed, HybridTime ht_lease) const;
+
+  // StartUpdate and FinishUpdate surround changes of the state used by lock-free readers of safe
+  // time. Should be called with mutex_ held.
+  void StartUpdate() const;
+  void FinishUpdate() const;
+
   const std::string& LogPrefix() const { return prefix_; }
   void PopFront(std::lock_guard<std::mutex>* lock);
 
@@ -149,6 +166,9 @@ class MvccManager {
 
   HybridTime last_replicated_ = HybridTime::kMin;
 
+  // Max hybrid time of operations added with already known hybrid time.
+  HybridTime max_follower_side_pending_ = HybridTime::kMin;
+
   // If we are a follower, this is the latest safe time sent by the leader to us. If we are the
   // leader, this is a safe time that gets updated every time the majority-replicated watermarks
   // change.
@@ -162,6 +182,21 @@ class MvccManager {
   mutable SafeTimeWithSource max_safe_time_returned_with_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_without_lease_;
   mutable SafeTimeWithSource max_safe_time_returned_for_follower_ { HybridTime::kMin };
+
+  // Sequence number of changes of the state below. It is odd while the state is being changed, so
+  // lock-free readers that observed different or odd values before and after reading the state
+  // and the clock fall back to the mutex. AddPending also makes it odd while reading the clock, so
+  // a lock-free reader could not return a safe time past the hybrid time of a concurrently added
+  // operation.
+  mutable std::atomic<uint64_t> version_{0};
+  // Copies of queue_.front() (invalid when the queue is empty), last_replicated_ and
+  // max_ht_lease_seen_ for lock-free readers.
+  mutable std::atomic<uint64_t> published_queue_front_{HybridTime::kInvalid.ToUint64()};
+  mutable std::atomic<uint64_t> published_last_replicated_{HybridTime::kMin.ToUint64()};
+  mutable std::atomic<uint64_t> published_max_ht_lease_seen_{HybridTime::kMin.ToUint64()};
+
+  // Max safe time returned by lock-free readers, for sanity checks.
+  mutable std::atomic<uint64_t> max_safe_time_returned_lock_free_{HybridTime::kMin.ToUint64()};
 };
 
 }  // namespace tablet
@@ -45,6 +45,7 @@
 #include "yb/consensus/opid_util.h"
 #include "yb/util/auto_release_pool.h"
 #include "yb/util/locks.h"
+#include "yb/util/size_class_pool.h"
 #include "yb/util/status.h"
 #include "yb/util/memory/arena.h"
 
@@ -62,7 +63,10 @@ YB_DEFINE_ENUM(OperationType,
 // Base class for transactions.  There are different implementations for different types (Write,
 // AlterSchema, etc.) OperationDriver implementations use Operations along with Consensus to execute
 // and replicate operations in a consensus configuration.
-class Operation {
+//
+// Operations and their states are allocated from SizeClassPool, since they are created for each
+// operation.
+class Operation : public SizeClassPooled {
  public:
   enum TraceType {
     NO_TRACE_TXNS = 0,
@@ -128,7 +132,7 @@ class Operation {
   const OperationType operation_type_;
 };
 
-class OperationState {
+class OperationState : public SizeClassPooled {
  public:
   OperationState(const OperationState&) = delete;
   void operator=(const OperationState&) = delete;
@@ -159,6 +163,11 @@ class OperationState {
     completion_clbk_ = std::move(completion_clbk);
   }
 
+  // Releases the callback, so it could be wrapped by another one.
+  std::unique_ptr<OperationCompletionCallback> TakeCompletionCallback() {
+    return std::move(completion_clbk_);
+  }
+
   // Sets a heap object to be managed by this transaction's AutoReleasePool.
   template<class T>
   T* AddToAutoReleasePool(T* t) {
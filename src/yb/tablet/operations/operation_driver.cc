@@ -40,6 +40,7 @@
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
 #include "yb/tablet/operations/operation_tracker.h"
+#include "yb/tablet/operations/write_operation.h"
 #include "yb/util/debug-util.h"
 #include "yb/util/debug/trace_event.h"
 #include "yb/util/flag_tags.h"
@@ -67,6 +68,34 @@ using consensus::DriverType;
 using log::Log;
 using server::Clock;
 
+// Completes the operation it wraps the callback of, and then all operations coalesced into it.
+class CoalescedCompletionCallback : public OperationCompletionCallback {
+ public:
+  explicit CoalescedCompletionCallback(std::unique_ptr<OperationCompletionCallback> original)
+      : original_(std::move(original)) {}
+
+  void Add(OperationDriver* driver) {
+    coalesced_.emplace_back(driver);
+  }
+
+  void OperationCompleted() override {
+    if (original_) {
+      if (code_ != tserver::TabletServerErrorPB::UNKNOWN_ERROR) {
+        original_->set_error(status_, code_);
+      }
+      original_->CompleteWithStatus(status_);
+    }
+    for (const auto& driver : coalesced_) {
+      driver->CompleteCoalesced(status_);
+    }
+    coalesced_.clear();
+  }
+
+ private:
+  std::unique_ptr<OperationCompletionCallback> original_;
+  std::vector<scoped_refptr<OperationDriver>> coalesced_;
+};
+
 ////////////////////////////////////////////////////////////
 // OperationDriver
 ////////////////////////////////////////////////////////////
@@ -76,12 +105,14 @@ OperationDriver::OperationDriver(OperationTracker *operation_tracker,
                                  Log* log,
                                  Preparer* preparer,
                                  OperationOrderVerifier* order_verifier,
-                                 TableType table_type)
+                                 TableType table_type,
+                                 ThreadPoolToken* completion_token)
     : operation_tracker_(operation_tracker),
       consensus_(consensus),
       log_(log),
       preparer_(preparer),
       order_verifier_(order_verifier),
+      completion_token_(completion_token),
       trace_(new Trace()),
       start_time_(MonoTime::Now()),
       replication_state_(NOT_REPLICATING),
@@ -448,18 +479,78 @@ void OperationDriver::ApplyTask(int64_t leader_term) {
   {
     CHECK_OK(operation_->Apply(leader_term));
 
-    Finalize();
+    // Changes of the operation could be not written yet, when it is applied as part of a group.
+    auto* tablet = state()->tablet();
+    if (!tablet || !tablet->DeferFinalizeUntilGroupWritten([ref] { ref->Finalize(); })) {
+      Finalize();
+    }
   }
 }
 
 void OperationDriver::Finalize() {
   ADOPT_TRACE(trace());
 
+  // Changes have to become visible in log order, so that part is done inline. Responding to the
+  // client does not need to hold up applying the following operations of the tablet.
   operation_->Finish(Operation::COMMITTED);
+  if (completion_token_ && operation_type() == OperationType::kWrite) {
+    scoped_refptr<OperationDriver> ref(this);
+    auto status = completion_token_->SubmitFunc([ref] { ref->CompleteFinalized(); });
+    if (status.ok()) {
+      return;
+    }
+    VLOG(1) << "Completing operation inline: " << status;
+  }
+  CompleteFinalized();
+}
+
+void OperationDriver::CompleteFinalized() {
+  ADOPT_TRACE(trace());
+
   mutable_state()->CompleteWithStatus(Status::OK());
   operation_tracker_->Release(this);
 }
 
+bool OperationDriver::TryCoalesce(OperationDriver* other, size_t max_request_bytes) {
+  if (operation_type() != OperationType::kWrite ||
+      other->operation_type() != OperationType::kWrite) {
+    return false;
+  }
+  {
+    std::lock_guard<simple_spinlock> lock(lock_);
+    if (prepare_state_ != NOT_PREPARED || replication_state_ != NOT_REPLICATING) {
+      return false;
+    }
+  }
+  auto* operation = down_cast<WriteOperation*>(operation_.get());
+  auto* other_operation = down_cast<WriteOperation*>(other->operation_.get());
+  if (!operation->Coalesce(other_operation, max_request_bytes)) {
+    return false;
+  }
+  if (!coalesced_callback_) {
+    auto callback = std::make_unique<CoalescedCompletionCallback>(
+        mutable_state()->TakeCompletionCallback());
+    coalesced_callback_ = callback.get();
+    mutable_state()->set_completion_callback(std::move(callback));
+  }
+  {
+    // From now on the other operation is replicated by this one, so it could not be aborted
+    // separately.
+    std::lock_guard<simple_spinlock> lock(other->lock_);
+    other->replication_state_ = REPLICATING;
+  }
+  coalesced_callback_->Add(other);
+  VLOG_WITH_PREFIX(4) << "Coalesced " << other->ToString();
+  return true;
+}
+
+void OperationDriver::CompleteCoalesced(const Status& status) {
+  ADOPT_TRACE(trace());
+  TRACE("CompleteCoalesced($0)", status.ToString());
+  operation_->Finish(status.ok() ? Operation::COMMITTED : Operation::ABORTED);
+  mutable_state()->CompleteWithStatus(status);
+  operation_tracker_->Release(this);
+}
 
 std::string OperationDriver::StateString(ReplicationState repl_state,
                                            PrepareState prep_state) {
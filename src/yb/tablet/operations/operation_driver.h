@@ -40,11 +40,13 @@
 #include "yb/gutil/walltime.h"
 #include "yb/tablet/operations/operation.h"
 #include "yb/util/lockfree.h"
+#include "yb/util/size_class_pool.h"
 #include "yb/util/status.h"
 #include "yb/util/trace.h"
 
 namespace yb {
 class ThreadPool;
+class ThreadPoolToken;
 
 namespace log {
 class Log;
@@ -54,6 +56,7 @@ namespace tablet {
 class MvccManager;
 class OperationOrderVerifier;
 class OperationTracker;
+class CoalescedCompletionCallback;
 class OperationDriver;
 class Preparer;
 
@@ -105,7 +108,8 @@ class Preparer;
 // This class is thread safe.
 class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
                         public consensus::ConsensusAppendCallback,
-                        public MPSCQueueEntry<OperationDriver> {
+                        public MPSCQueueEntry<OperationDriver>,
+                        public SizeClassPooled {
 
  public:
   // Construct OperationDriver. OperationDriver does not take ownership
@@ -115,7 +119,8 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
                   log::Log* log,
                   Preparer* preparer,
                   OperationOrderVerifier* order_verifier,
-                  TableType table_type_);
+                  TableType table_type_,
+                  ThreadPoolToken* completion_token);
 
   // Perform any non-constructor initialization. Sets the operation
   // that will be executed.
@@ -205,8 +210,14 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
     return operation_ ? state()->request()->SpaceUsed() : 0;
   }
 
+  // Tries to replicate the operation of the other leader-side driver as part of the operation of
+  // this one. Both drivers should not be prepared yet. On success the other driver is completed with
+  // the status of this one, once this one completes.
+  bool TryCoalesce(OperationDriver* other, size_t max_request_bytes);
+
  private:
   friend class RefCountedThreadSafe<OperationDriver>;
+  friend class CoalescedCompletionCallback;
   enum ReplicationState {
     // The operation has not yet been sent to consensus for replication
     NOT_REPLICATING,
@@ -245,6 +256,14 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   // appended to the WAL.
   void Finalize();
 
+  // Completes the operation that was coalesced into the operation of another driver, when the
+  // latter completes with the specified status.
+  void CompleteCoalesced(const Status& status);
+
+  // Responds to the client and releases the operation from the tracker, after its changes were
+  // made visible by Finalize.
+  void CompleteFinalized();
+
   // Returns the mutable state of the operation being executed by
   // this driver.
   OperationState* mutable_state();
@@ -260,6 +279,10 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   Preparer* const preparer_;
   OperationOrderVerifier* const order_verifier_;
 
+  // Serial token of the tablet on the shared apply pool, used to complete applied write operations
+  // off the thread that applies the next ones. Completion is done inline when null.
+  ThreadPoolToken* const completion_token_;
+
   Status operation_status_;
 
   // Lock that synchronizes access to the operation's state.
@@ -297,6 +320,10 @@ class OperationDriver : public RefCountedThreadSafe<OperationDriver>,
   MvccManager* mvcc_ = nullptr;
   HybridTime propagated_safe_time_;
 
+  // Completion callback that also completes operations coalesced into this one, set by the first
+  // successful TryCoalesce. Owned by the operation state.
+  CoalescedCompletionCallback* coalesced_callback_ = nullptr;
+
   DISALLOW_COPY_AND_ASSIGN(OperationDriver);
 };
 
@@ -147,6 +147,37 @@ void WriteOperation::Finish(OperationResult result) {
   }
 }
 
+bool WriteOperation::CanBeCoalesced() const {
+  const auto* request = state()->request();
+  if (state()->kind() != docdb::OperationKind::kWrite || request == nullptr ||
+      !request->has_write_batch() || request->has_transaction_meta() ||
+      request->has_client_id1() || request->has_client_id2()) {
+    return false;
+  }
+  const auto& write_batch = request->write_batch();
+  return !write_batch.has_transaction() && !write_batch.may_have_metadata() &&
+         write_batch.read_pairs().empty();
+}
+
+bool WriteOperation::Coalesce(WriteOperation* other, size_t max_request_bytes) {
+  if (!CanBeCoalesced() || !other->CanBeCoalesced()) {
+    return false;
+  }
+  auto* write_batch = request()->mutable_write_batch();
+  auto* other_write_batch = other->request()->mutable_write_batch();
+  if (static_cast<size_t>(request()->ByteSize() + other_write_batch->ByteSize()) >
+          max_request_bytes) {
+    return false;
+  }
+  auto* write_pairs = write_batch->mutable_write_pairs();
+  write_pairs->Reserve(write_pairs->size() + other_write_batch->write_pairs_size());
+  for (auto& pair : *other_write_batch->mutable_write_pairs()) {
+    write_pairs->Add()->Swap(&pair);
+  }
+  other_write_batch->clear_write_pairs();
+  return true;
+}
+
 string WriteOperation::ToString() const {
   MonoTime now(MonoTime::Now());
   MonoDelta d = now.GetDeltaSince(start_time_);
@@ -217,7 +248,11 @@ void WriteOperationState::UpdateRequestFromConsensusRound() {
 }
 
 void WriteOperationState::Commit() {
-  tablet()->mvcc_manager()->Replicated(hybrid_time_);
+  // Operation that was coalesced into another one does not have hybrid time, since its writes
+  // were replicated and applied by the other operation.
+  if (hybrid_time_.is_valid()) {
+    tablet()->mvcc_manager()->Replicated(hybrid_time_);
+  }
   ReleaseDocDbLocks();
 
   // After committing, we may respond to the RPC and delete the
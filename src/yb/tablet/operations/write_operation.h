@@ -276,6 +276,17 @@ class WriteOperation : public Operation {
     return doc_ops_;
   }
 
+  // Whether writes of this operation could be replicated together with writes of other
+  // operations, as a single write batch. Only non-transactional writes that are not tracked as
+  // retryable requests are eligible, since retryable requests and transactions are tracked per
+  // replicated operation.
+  bool CanBeCoalesced() const;
+
+  // Moves writes of the other operation to the write batch of this operation, if both are eligible
+  // and the size of the resulting request does not exceed max_request_bytes. Returns true on
+  // success.
+  bool Coalesce(WriteOperation* other, size_t max_request_bytes);
+
   static void StartSynchronization(
       std::unique_ptr<WriteOperation> operation, const Status& status) {
     // We release here, because DoStartSynchronization takes ownership on this.
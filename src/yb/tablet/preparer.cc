@@ -23,13 +23,31 @@
 #include "yb/consensus/consensus.h"
 #include "yb/tablet/preparer.h"
 #include "yb/tablet/operations/operation_driver.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/threadpool.h"
 #include "yb/util/lockfree.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
 
 DEFINE_int32(max_group_replicate_batch_size, 16,
              "Maximum number of operations to submit to consensus for replication in a batch.");
 
+DEFINE_bool(enable_write_coalescing, false,
+            "Whether consecutive non-transactional writes that are prepared in one batch on the "
+            "leader should be replicated as a single Raft operation.");
+TAG_FLAG(enable_write_coalescing, advanced);
+TAG_FLAG(enable_write_coalescing, runtime);
+
+DEFINE_int32(max_coalesced_write_request_bytes, 256_KB,
+             "Maximum size of a write request produced by coalescing of concurrent writes.");
+TAG_FLAG(max_coalesced_write_request_bytes, advanced);
+TAG_FLAG(max_coalesced_write_request_bytes, runtime);
+
+DEFINE_test_flag(int32, delay_prepare_task_ms, 0,
+                 "Delay before a prepare task starts processing queued operations.");
+
 using std::vector;
 
 namespace yb {
@@ -154,6 +172,9 @@ Status PreparerImpl::Submit(OperationDriver* operation_driver) {
 
 void PreparerImpl::Run() {
   VLOG(2) << "Starting prepare task:" << this;
+  if (FLAGS_delay_prepare_task_ms > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS_delay_prepare_task_ms));
+  }
   for (;;) {
     while (OperationDriver *item = queue_.Pop()) {
       active_tasks_.fetch_sub(1, std::memory_order_release);
@@ -193,6 +214,16 @@ void PreparerImpl::ProcessItem(OperationDriver* item) {
                                   operation_type == OperationType::kEmpty;
     const int64_t bound_term = apply_separately ? -1 : item->consensus_round()->bound_term();
 
+    // Writes of the operation could be replicated as part of the previous one, when both are small
+    // non-transactional writes. The previous operation then completes both of them.
+    if (operation_type == OperationType::kWrite &&
+        GetAtomicFlag(&FLAGS_enable_write_coalescing) && !leader_side_batch_.empty() &&
+        bound_term == leader_side_batch_.back()->consensus_round()->bound_term() &&
+        leader_side_batch_.back()->TryCoalesce(
+            item, GetAtomicFlag(&FLAGS_max_coalesced_write_request_bytes))) {
+      return;
+    }
+
     // Don't add more than the max number of operations to a batch, and also don't add
     // operations bound to different terms, so as not to fail unrelated operations
     // unnecessarily in case of a bound term mismatch.
@@ -37,6 +37,7 @@
 #include "yb/common/ql_protocol_util.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/ref_counted.h"
+#include "yb/gutil/strings/util.h"
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet-test-util.h"
 
@@ -108,6 +109,39 @@ TEST_F(TestRaftGroupMetadata, TestLoadFromSuperBlock) {
             << superblock_pb_1.DebugString();
 }
 
+TEST_F(TestRaftGroupMetadata, TestCreateSubtablet) {
+  QLWriteRequestPB req;
+  for (int i = 0; i != 10; ++i) {
+    BuildPartialRow(i, i, "foo", &req);
+    ASSERT_OK(writer_->Write(&req));
+  }
+
+  auto tablet = harness_->tablet();
+  const docdb::KeyBounds key_bounds(Slice("G\x80\x00", 3), Slice());
+  Partition partition;
+  auto subtablet_metadata = ASSERT_RESULT(tablet->CreateSubtablet(
+      "subtablet", partition, key_bounds));
+  ASSERT_EQ(key_bounds.lower.data(), subtablet_metadata->lower_bound_key());
+  ASSERT_EQ("", subtablet_metadata->upper_bound_key());
+  ASSERT_EQ(tablet->metadata()->table_id(), subtablet_metadata->table_id());
+  ASSERT_NE(tablet->metadata()->rocksdb_dir(), subtablet_metadata->rocksdb_dir());
+
+  // Memtable was flushed and SST files are shared with the new tablet.
+  std::vector<std::string> children;
+  ASSERT_OK(Env::Default()->GetChildren(subtablet_metadata->rocksdb_dir(), &children));
+  ASSERT_TRUE(std::any_of(children.begin(), children.end(), [](const std::string& name) {
+    return HasSuffixString(name, ".sst");
+  })) << yb::ToString(children);
+
+  // Superblock is persisted.
+  scoped_refptr<RaftGroupMetadata> loaded;
+  ASSERT_OK(RaftGroupMetadata::Load(tablet->metadata()->fs_manager(), "subtablet", &loaded));
+  ASSERT_EQ(key_bounds.lower.data(), loaded->lower_bound_key());
+
+  // The same tablet could not be created twice.
+  ASSERT_NOK(tablet->CreateSubtablet("subtablet", partition, key_bounds));
+}
+
 
 } // namespace tablet
 } // namespace yb
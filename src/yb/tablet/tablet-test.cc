@@ -32,6 +32,8 @@
 
 #include <time.h>
 
+#include <thread>
+
 #include <glog/logging.h>
 
 #include "yb/client/table.h"
@@ -39,11 +41,14 @@
 #include "yb/common/row.h"
 #include "yb/common/ql_rowwise_iterator_interface.h"
 
+#include "yb/docdb/consensus_frontier.h"
+
 #include "yb/gutil/stl_util.h"
 #include "yb/gutil/strings/join.h"
 #include "yb/tablet/local_tablet_writer.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet-test-base.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/util/slice.h"
 #include "yb/util/test_macros.h"
 
@@ -52,6 +57,14 @@
 
 #include "yb/util/enums.h"
 
+DECLARE_bool(tablet_adaptive_write_throttling);
+DECLARE_int32(tablet_write_throttling_refresh_interval_ms);
+DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
+DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_int32(snapshot_restore_max_concurrent_file_copies);
+DECLARE_bool(snapshot_restore_disable_hard_links);
+DECLARE_bool(tablet_group_apply_writes);
+
 using std::shared_ptr;
 using std::unordered_set;
 
@@ -214,5 +227,115 @@ TYPED_TEST(TestTablet, TestFlushedOpId) {
   ASSERT_EQ(id.index, start_index + 2*kCount);
 }
 
+TYPED_TEST(TestTablet, TestWriteThrottlingRatio) {
+  FLAGS_tablet_adaptive_write_throttling = true;
+  FLAGS_tablet_write_throttling_refresh_interval_ms = 0;
+  FLAGS_rocksdb_level0_slowdown_writes_trigger = 1;
+  FLAGS_rocksdb_level0_stop_writes_trigger = 5;
+
+  auto tablet = this->tablet().get();
+  LocalTabletWriter writer(tablet);
+  ASSERT_EQ(tablet->WriteThrottlingRatio(), 0);
+
+  // Throttling grows linearly from 1 SST file to 5 SST files.
+  for (int i = 0; i != 3; ++i) {
+    ASSERT_OK(this->InsertTestRow(&writer, i, 0));
+    ASSERT_OK(tablet->Flush(FlushMode::kSync));
+  }
+  ASSERT_DOUBLE_EQ(tablet->WriteThrottlingRatio(), 0.5);
+
+  FLAGS_tablet_adaptive_write_throttling = false;
+  ASSERT_EQ(tablet->WriteThrottlingRatio(), 0);
+}
+
+TYPED_TEST(TestTablet, TestRestoreCheckpoint) {
+  FLAGS_snapshot_restore_max_concurrent_file_copies = 3;
+  auto tablet = this->tablet().get();
+  const int64_t kCount = 100;
+  int64_t next_key = 0;
+
+  // Files are hard linked into the tablet, or copied in parallel if links are disabled.
+  for (bool disable_hard_links : {false, true}) {
+    SCOPED_TRACE(Format("Disable hard links: $0", disable_hard_links));
+    FLAGS_snapshot_restore_disable_hard_links = disable_hard_links;
+    for (int i = 0; i != 3; ++i) {
+      this->InsertTestRows(next_key, kCount, 0);
+      next_key += kCount;
+      ASSERT_OK(tablet->Flush(FlushMode::kSync));
+    }
+    const auto checkpoint_dir = this->GetTestPath(Format("checkpoint_$0", disable_hard_links));
+    ASSERT_OK(tablet->CreateCheckpoint(checkpoint_dir));
+    const auto checkpoint_rows = next_key;
+
+    this->InsertTestRows(next_key, kCount, 0);
+    next_key += kCount;
+    ASSERT_OK(tablet->Flush(FlushMode::kSync));
+
+    docdb::ConsensusFrontier frontier;
+    auto op_id = ASSERT_RESULT(tablet->MaxPersistentOpId()).regular;
+    ++op_id.index;
+    frontier.set_op_id(op_id);
+    frontier.set_hybrid_time(tablet->clock()->Now());
+    ASSERT_OK(tablet->RestoreCheckpoint(checkpoint_dir, frontier));
+
+    vector<string> rows;
+    ASSERT_OK(this->IterateToStringList(&rows));
+    ASSERT_EQ(checkpoint_rows, rows.size());
+    next_key = checkpoint_rows;
+  }
+}
+
+TYPED_TEST(TestTablet, LimitReadUncertainty) {
+  auto tablet = this->tablet().get();
+  auto& narrowed = *tablet->metrics()->narrowed_read_uncertainty_windows;
+  const auto read_time = ReadHybridTime::FromMicros(1000);
+  auto limited = read_time;
+  limited.local_limit = read_time.global_limit = HybridTime::FromMicros(2000);
+
+  // Safe time above the local limit does not change it.
+  tablet->LimitReadUncertainty(HybridTime::FromMicros(3000), &limited);
+  ASSERT_EQ(HybridTime::FromMicros(2000), limited.local_limit);
+  ASSERT_EQ(0, narrowed.value());
+
+  tablet->LimitReadUncertainty(HybridTime::FromMicros(1500), &limited);
+  ASSERT_EQ(HybridTime::FromMicros(1500), limited.local_limit);
+  ASSERT_EQ(HybridTime::FromMicros(2000), limited.global_limit);
+  ASSERT_EQ(1, narrowed.value());
+
+  // Local limit is never below the read time.
+  tablet->LimitReadUncertainty(HybridTime::FromMicros(500), &limited);
+  ASSERT_EQ(read_time.read, limited.local_limit);
+  ASSERT_EQ(2, narrowed.value());
+}
+
+// Writes applied by a thread other than the one that started the apply group are not grouped.
+TYPED_TEST(TestTablet, ApplyGroupOwnedByApplyThread) {
+  FLAGS_tablet_group_apply_writes = true;
+  auto tablet = this->tablet().get();
+  tablet->StartApplyGroup();
+
+  std::thread other_thread([this, tablet] {
+    LocalTabletWriter writer(tablet);
+    ASSERT_OK(this->InsertTestRow(&writer, 1, 0));
+  });
+  other_thread.join();
+
+  vector<string> rows;
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(1, rows.size());
+
+  // Write of the thread that started the group is accumulated until the group is finished.
+  LocalTabletWriter writer(tablet);
+  ASSERT_OK(this->InsertTestRow(&writer, 2, 0));
+  rows.clear();
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(1, rows.size());
+
+  tablet->FinishApplyGroup();
+  rows.clear();
+  ASSERT_OK(this->IterateToStringList(&rows));
+  ASSERT_EQ(2, rows.size());
+}
+
 } // namespace tablet
 } // namespace yb
@@ -53,6 +53,7 @@
 #include "yb/rocksdb/write_batch.h"
 #include "yb/rocksdb/util/file_util.h"
 
+#include "yb/client/coalescing_session.h"
 #include "yb/client/error.h"
 #include "yb/client/table.h"
 #include "yb/client/transaction.h"
@@ -70,9 +71,11 @@
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/opid_util.h"
 
+#include "yb/docdb/blob_storage.h"
 #include "yb/docdb/conflict_resolution.h"
 #include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/cql_operation.h"
+#include "yb/docdb/doc_row_cache.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/docdb.pb.h"
@@ -83,6 +86,8 @@
 #include "yb/docdb/lock_batch.h"
 #include "yb/docdb/pgsql_operation.h"
 #include "yb/docdb/primitive_value.h"
+#include "yb/docdb/primitive_value_util.h"
+#include "yb/docdb/range_tombstones.h"
 #include "yb/docdb/redis_operation.h"
 
 #include "yb/gutil/atomicops.h"
@@ -113,11 +118,22 @@
 #include "yb/util/locks.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/net/rate_limiter.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/slice.h"
 #include "yb/util/stopwatch.h"
+#include "yb/util/threadpool.h"
 #include "yb/util/trace.h"
 #include "yb/util/url-coding.h"
 
+using namespace yb::size_literals;  // NOLINT.
+
+DEFINE_bool(limit_read_uncertainty_by_safe_time, true,
+            "Limit the uncertainty window of strongly consistent reads on the leader by the safe "
+            "time of the tablet, so writes concurrent with the read do not cause read restarts.");
+TAG_FLAG(limit_read_uncertainty_by_safe_time, advanced);
+TAG_FLAG(limit_read_uncertainty_by_safe_time, runtime);
+
 DEFINE_bool(tablet_do_dup_key_checks, true,
             "Whether to check primary keys for duplicate on insertion. "
             "Use at your own risk!");
@@ -150,13 +166,115 @@ DEFINE_int32(intents_flush_max_delay_ms, 2000,
              "Max time to wait for regular db to flush during flush of intents. "
              "After this time flush of regular db will be forced.");
 
+DEFINE_int64(docdb_row_cache_size_bytes, 0,
+             "Per-tablet memory limit for the cache of decoded documents used to serve "
+             "non-transactional point reads. 0 disables the cache.");
+TAG_FLAG(docdb_row_cache_size_bytes, advanced);
+
+DEFINE_bool(tablet_drop_expired_sst_files, false,
+            "Delete the oldest regular DB SST files, that contain only data expired before the "
+            "history cutoff, without compacting them.");
+TAG_FLAG(tablet_drop_expired_sst_files, advanced);
+
+DEFINE_double(tablet_expired_bytes_compaction_ratio, 0,
+              "When positive, a regular DB SST file is compacted on its own once values with "
+              "explicit TTL, that expired before the history cutoff, make up at least this "
+              "fraction of its raw size. 0 disables such compactions.");
+TAG_FLAG(tablet_expired_bytes_compaction_ratio, advanced);
+
+DEFINE_double(tablet_obsolete_versions_compaction_ratio, 0,
+              "When positive, a regular DB SST file is compacted on its own once versions of keys, "
+              "that were overwritten in the same file before the history cutoff, make up at least "
+              "this fraction of its entries. 0 disables such compactions.");
+TAG_FLAG(tablet_obsolete_versions_compaction_ratio, advanced);
+
+DEFINE_int64(tablet_compaction_time_window_sec, 0,
+             "When positive, regular DB compactions only merge SST files whose latest hybrid "
+             "times fall into the same time window of this length, so data of old windows stays "
+             "in separate files, that are dropped as a whole once expired when "
+             "tablet_drop_expired_sst_files is set. 0 disables time windows.");
+TAG_FLAG(tablet_compaction_time_window_sec, advanced);
+
+DEFINE_bool(tablet_group_apply_writes, false,
+            "Write regular DB changes of consecutive non-transactional write operations, "
+            "that are committed together, into RocksDB with a single write.");
+TAG_FLAG(tablet_group_apply_writes, advanced);
+
+DEFINE_int32(txn_max_apply_batch_records, 100000,
+             "Max number of intents applied by one batch, when committed transaction is applied. "
+             "Intents of bigger transactions are applied by several batches in background. "
+             "0 means unlimited.");
+TAG_FLAG(txn_max_apply_batch_records, advanced);
+
 DEFINE_test_flag(
     bool, tablet_verify_flushed_frontier_after_modifying, false,
     "After modifying the flushed frontier in RocksDB, verify that the restored value of it "
     "is as expected. Used for testing.");
 
+DEFINE_int32(snapshot_restore_max_concurrent_file_copies, 4,
+             "Maximum number of files copied at the same time when a snapshot is restored to a "
+             "tablet. Only files that could not be hard linked into the tablet are copied.");
+TAG_FLAG(snapshot_restore_max_concurrent_file_copies, advanced);
+
+DEFINE_int64(snapshot_restore_rate_limit_bytes_per_sec, 0,
+             "Maximum rate of copying files by snapshot restores, shared by all restores running "
+             "on this server. 0 means unlimited.");
+
+DEFINE_test_flag(bool, snapshot_restore_disable_hard_links, false,
+                 "Copy files of restored snapshots instead of hard linking them.");
+
+DEFINE_int32(tablet_hot_keys_capacity, 32,
+             "Number of the most frequently read and written keys tracked per tablet.");
+TAG_FLAG(tablet_hot_keys_capacity, advanced);
+
+DEFINE_int32(tablet_hot_keys_sampling_interval, 64,
+             "One of this number of key reads and writes are sampled by the tracker of the most "
+             "frequently accessed keys of a tablet, on average. 0 disables the tracking. Takes "
+             "effect when tablets are opened.");
+TAG_FLAG(tablet_hot_keys_sampling_interval, advanced);
+
+DEFINE_bool(tablet_adaptive_write_throttling, false,
+            "Slow down writes gradually while flushes and compactions fall behind, by rejecting a "
+            "growing fraction of write requests on tablet leaders with a retry delay, instead of "
+            "stalling writes in RocksDB. rocksdb_level0_slowdown_writes_trigger and "
+            "rocksdb_level0_stop_writes_trigger are then used as the bounds of the range of SST "
+            "file counts in which writes are throttled. Takes effect when tablets are opened.");
+TAG_FLAG(tablet_adaptive_write_throttling, advanced);
+
+DEFINE_int32(tablet_write_throttling_immutable_memtables_soft_limit, 2,
+             "Number of immutable memtables of a DB that are waiting for flush, at which adaptive "
+             "write throttling starts to reject writes.");
+TAG_FLAG(tablet_write_throttling_immutable_memtables_soft_limit, advanced);
+
+DEFINE_int32(tablet_write_throttling_immutable_memtables_hard_limit, 4,
+             "Number of immutable memtables of a DB that are waiting for flush, at which adaptive "
+             "write throttling rejects all writes.");
+TAG_FLAG(tablet_write_throttling_immutable_memtables_hard_limit, advanced);
+
+DEFINE_uint64(tablet_write_throttling_pending_compaction_bytes_soft_limit, 64_GB,
+              "Estimated number of bytes that compactions need to rewrite, at which adaptive write "
+              "throttling starts to reject writes. 0 to ignore pending compaction bytes.");
+TAG_FLAG(tablet_write_throttling_pending_compaction_bytes_soft_limit, advanced);
+
+DEFINE_uint64(tablet_write_throttling_pending_compaction_bytes_hard_limit, 256_GB,
+              "Estimated number of bytes that compactions need to rewrite, at which adaptive write "
+              "throttling rejects all writes.");
+TAG_FLAG(tablet_write_throttling_pending_compaction_bytes_hard_limit, advanced);
+
+DEFINE_int32(tablet_write_throttling_refresh_interval_ms, 100,
+             "How often the write throttling ratio of a tablet is recomputed from RocksDB "
+             "statistics.");
+TAG_FLAG(tablet_write_throttling_refresh_interval_ms, advanced);
+
+DEFINE_bool(tablet_coalesce_index_writes, false,
+            "Whether index writes of non-transactional tables are coalesced across concurrent "
+            "write operations of a tablet, so they are sent to the index tablets in larger "
+            "batches.");
+TAG_FLAG(tablet_coalesce_index_writes, advanced);
+
 DECLARE_int32(rocksdb_level0_slowdown_writes_trigger);
 DECLARE_int32(rocksdb_level0_stop_writes_trigger);
+DECLARE_int64(docdb_blob_value_threshold_bytes);
 
 using namespace std::placeholders;
 
@@ -300,12 +418,148 @@ CHECKED_STATUS EmitRocksDbMetricsAsPrometheus(
   return Status::OK();
 }
 
+// Number of files being copied by snapshot restores on this server, that share the rate limit.
+std::atomic<int> num_restore_file_copies{0};
+
+struct FileToCopy {
+  std::string source;
+  std::string target;
+};
+
+// Places files of the checkpoint directory into the DB directory, except the excluded
+// subdirectory. Files are hard linked when possible, so SST files are placed directly without
+// reading them. Files that could not be linked, for instance because the checkpoint is on another
+// device, are added to files_to_copy.
+Status PlaceCheckpointFiles(
+    rocksdb::Env* env, const std::string& source_dir, const std::string& target_dir,
+    const std::string& excluded_subdir, std::vector<FileToCopy>* files_to_copy) {
+  RETURN_NOT_OK_PREPEND(env->CreateDirIfMissing(target_dir),
+                        Format("Cannot create directory: $0", target_dir));
+  std::vector<std::string> files;
+  RETURN_NOT_OK_PREPEND(env->GetChildren(source_dir, &files),
+                        Format("Cannot get list of files for directory: $0", source_dir));
+  for (const auto& file : files) {
+    if (file == "." || file == ".." || file == excluded_subdir) {
+      continue;
+    }
+    auto source = JoinPathSegments(source_dir, file);
+    auto target = JoinPathSegments(target_dir, file);
+    if (env->DirExists(source)) {
+      RETURN_NOT_OK(PlaceCheckpointFiles(
+          env, source, target, std::string() /* excluded_subdir */, files_to_copy));
+      continue;
+    }
+    // Files left from the previous state of the tablet, like blob files, are replaced.
+    if (env->FileExists(target).ok()) {
+      RETURN_NOT_OK_PREPEND(env->DeleteFile(target), Format("Cannot delete file: $0", target));
+    }
+    if (!FLAGS_snapshot_restore_disable_hard_links && env->LinkFile(source, target).ok()) {
+      continue;
+    }
+    files_to_copy->push_back({std::move(source), std::move(target)});
+  }
+  return Status::OK();
+}
+
+Status CopyCheckpointFile(rocksdb::Env* env, const FileToCopy& file) {
+  constexpr size_t kCopyChunkSize = 1_MB;
+
+  std::unique_ptr<rocksdb::SequentialFile> source;
+  RETURN_NOT_OK(env->NewSequentialFile(file.source, &source, rocksdb::EnvOptions()));
+  std::unique_ptr<rocksdb::WritableFile> target;
+  RETURN_NOT_OK(env->NewWritableFile(file.target, &target, rocksdb::EnvOptions()));
+
+  num_restore_file_copies.fetch_add(1, std::memory_order_acq_rel);
+  BOOST_SCOPE_EXIT(void) {
+    num_restore_file_copies.fetch_sub(1, std::memory_order_acq_rel);
+  } BOOST_SCOPE_EXIT_END;
+  RateLimiter rate_limiter;
+  if (FLAGS_snapshot_restore_rate_limit_bytes_per_sec > 0) {
+    rate_limiter.SetTargetRateUpdater([]() -> uint64_t {
+      return FLAGS_snapshot_restore_rate_limit_bytes_per_sec /
+             std::max(num_restore_file_copies.load(std::memory_order_acquire), 1);
+    });
+  }
+  rate_limiter.Init();
+
+  std::string buffer(kCopyChunkSize, 0);
+  for (;;) {
+    Slice chunk;
+    RETURN_NOT_OK(source->Read(buffer.size(), &chunk, &buffer[0]));
+    if (chunk.empty()) {
+      break;
+    }
+    RETURN_NOT_OK(target->Append(chunk));
+    rate_limiter.UpdateDataSizeAndMaybeSleep(chunk.size());
+  }
+  RETURN_NOT_OK(target->Fsync());
+  return target->Close();
+}
+
+// Copies files using up to snapshot_restore_max_concurrent_file_copies threads.
+Status CopyCheckpointFiles(rocksdb::Env* env, const std::vector<FileToCopy>& files) {
+  std::mutex mutex;
+  Status result;
+  auto copy = [env, &mutex, &result](const FileToCopy& file) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!result.ok()) {
+        return;
+      }
+    }
+    auto status = CopyCheckpointFile(env, file);
+    if (!status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (result.ok()) {
+        result = status.CloneAndPrepend(Format("Cannot copy file: $0", file.source));
+      }
+    }
+  };
+
+  const int max_copies = std::min<int>(
+      files.size(), FLAGS_snapshot_restore_max_concurrent_file_copies);
+  if (max_copies <= 1) {
+    for (const auto& file : files) {
+      copy(file);
+    }
+    return result;
+  }
+
+  std::unique_ptr<ThreadPool> pool;
+  RETURN_NOT_OK(ThreadPoolBuilder("restore-copy").set_max_threads(max_copies).Build(&pool));
+  for (const auto& file : files) {
+    auto status = pool->SubmitFunc([&copy, &file] { copy(file); });
+    if (!status.ok()) {
+      pool->Wait();
+      return status;
+    }
+  }
+  pool->Wait();
+  return result;
+}
+
 } // namespace
 
 string DocDbOpIds::ToString() const {
   return Format("{ regular: $0 intents: $1 }", regular, intents);
 }
 
+namespace {
+
+// Tablet that has an active apply group in the current thread, see Tablet::StartApplyGroup.
+thread_local const Tablet* tablet_with_active_apply_group = nullptr;
+
+} // namespace
+
+struct Tablet::ApplyGroup {
+  rocksdb::WriteBatch write_batch;
+  docdb::ConsensusFrontiers frontiers;
+  HybridTime min_hybrid_time;
+  HybridTime max_hybrid_time = HybridTime::kMin;
+  // Finalizers of operations applied as part of this group, in the order of apply.
+  std::vector<std::function<void()>> deferred_finalizers;
+};
+
 Tablet::Tablet(
     const scoped_refptr<RaftGroupMetadata>& metadata,
     const std::shared_future<client::YBClient*> &client_future,
@@ -332,8 +586,14 @@ Tablet::Tablet(
       tablet_options_(tablet_options),
       client_future_(client_future),
       local_tablet_filter_(std::move(local_tablet_filter)),
-      log_prefix_suffix_(std::move(log_prefix_suffix)) {
+      log_prefix_suffix_(std::move(log_prefix_suffix)),
+      hot_read_keys_(std::max(FLAGS_tablet_hot_keys_capacity, 0),
+                     std::max(FLAGS_tablet_hot_keys_sampling_interval, 0)),
+      hot_write_keys_(std::max(FLAGS_tablet_hot_keys_capacity, 0),
+                      std::max(FLAGS_tablet_hot_keys_sampling_interval, 0)),
+      admission_controller_(std::make_shared<AdmissionController>()) {
   CHECK(schema()->has_column_ids());
+  key_bounds_ = docdb::KeyBounds(metadata_->lower_bound_key(), metadata_->upper_bound_key());
 
   if (metric_registry) {
     MetricEntity::AttributeMap attrs;
@@ -352,7 +612,7 @@ Tablet::Tablet(
     });
 
     metric_entity_->AddExternalPrometheusMetricsCb(
-        [rocksdb_statistics, attrs](PrometheusWriter* pw) {
+        [rocksdb_statistics](PrometheusWriter* pw, const MetricEntity::AttributeMap& attrs) {
       auto s = EmitRocksDbMetricsAsPrometheus(rocksdb_statistics, pw, attrs);
       if (!s.ok()) {
         YB_LOG_EVERY_N(WARNING, 100) << "Failed to get Prometheus metrics: " << s.ToString();
@@ -360,6 +620,7 @@ Tablet::Tablet(
     });
 
     metrics_.reset(new TabletMetrics(metric_entity_));
+    shared_lock_manager_.SetMetricEntity(metric_entity_);
 
     mem_tracker_->SetMetricEntity(metric_entity_);
   }
@@ -490,6 +751,20 @@ Result<bool> Tablet::IntentsDbFlushFilter(const rocksdb::MemTable& memtable) {
   return false;
 }
 
+bool Tablet::PendingAppliesFlushFilter(const rocksdb::MemTable& memtable) {
+  auto frontiers = memtable.Frontiers();
+  if (!frontiers) {
+    return true;
+  }
+  const auto& largest = down_cast<const docdb::ConsensusFrontier&>(frontiers->Largest());
+  std::lock_guard<std::mutex> lock(pending_applies_mutex_);
+  if (pending_applies_.empty() || largest.op_id().index < *pending_applies_.begin()) {
+    return true;
+  }
+  flush_delayed_by_applies_.store(true, std::memory_order_release);
+  return false;
+}
+
 std::string Tablet::LogPrefix() const {
   return Format("T $0$1: ", tablet_id(), log_prefix_suffix_);
 }
@@ -506,23 +781,63 @@ Status Tablet::OpenKeyValueTablet() {
 
   // Install the history cleanup handler. Note that TabletRetentionPolicy is going to hold a raw ptr
   // to this tablet. So, we ensure that rocksdb_ is reset before this tablet gets destroyed.
+  retention_policy_ = make_shared<TabletRetentionPolicy>(this);
+
+  const string db_dir = metadata()->rocksdb_dir();
+  RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
+
+  // Existing blob files remain referenced after separation of new values was disabled.
+  const auto blob_dir = docdb::BlobStorage::DirForDb(db_dir);
+  blob_storage_.reset();
+  if (FLAGS_docdb_blob_value_threshold_bytes > 0 || rocksdb_options.env->FileExists(blob_dir).ok()) {
+    blob_storage_ = VERIFY_RESULT(docdb::BlobStorage::Open(rocksdb_options.env, blob_dir));
+    rocksdb_options.listeners.push_back(blob_storage_);
+  }
+  range_tombstones_ = std::make_unique<docdb::RangeTombstones>();
   rocksdb_options.compaction_filter_factory = make_shared<DocDBCompactionFilterFactory>(
-      make_shared<TabletRetentionPolicy>(this));
+      retention_policy_, &key_bounds_, blob_storage_.get(), range_tombstones_.get());
+  rocksdb_options.table_properties_collector_factories.push_back(
+      make_shared<docdb::DocDBTablePropertiesCollectorFactory>());
+  // Redis TTL merge records change expiration of older values, so a file could not be considered
+  // to be expired by its own contents. Compacting files with many expired values is still safe,
+  // because the compaction filter decides what is actually expired.
+  const docdb::DropExpiredFiles drop_expired_files(
+      FLAGS_tablet_drop_expired_sst_files && table_type_ != TableType::REDIS_TABLE_TYPE);
+  if (drop_expired_files || FLAGS_tablet_expired_bytes_compaction_ratio > 0 ||
+      FLAGS_tablet_obsolete_versions_compaction_ratio > 0) {
+    rocksdb_options.expired_file_filter = make_shared<docdb::DocDBExpiredFileFilter>(
+        retention_policy_, range_tombstones_.get(), drop_expired_files,
+        FLAGS_tablet_expired_bytes_compaction_ratio,
+        FLAGS_tablet_obsolete_versions_compaction_ratio);
+  }
+  if (FLAGS_tablet_compaction_time_window_sec > 0) {
+    rocksdb_options.compaction_time_windows = make_shared<docdb::DocDBCompactionTimeWindows>(
+        MonoDelta::FromSeconds(FLAGS_tablet_compaction_time_window_sec));
+  }
 
   rocksdb_options.mem_table_flush_filter_factory = MakeMemTableFlushFilterFactory([this] {
+    rocksdb::MemTableFilter filter;
     if (mem_table_flush_filter_factory_) {
-      return mem_table_flush_filter_factory_();
+      filter = mem_table_flush_filter_factory_();
     }
-    return rocksdb::MemTableFilter();
+    return [this, filter](const rocksdb::MemTable& memtable) -> Result<bool> {
+      if (!PendingAppliesFlushFilter(memtable)) {
+        return false;
+      }
+      return filter ? filter(memtable) : true;
+    };
   });
 
+  {
+    // Applies that were in progress are not related to the DB that is being opened.
+    std::lock_guard<std::mutex> lock(pending_applies_mutex_);
+    pending_applies_.clear();
+  }
+
   rocksdb_options.disable_auto_compactions = true;
   rocksdb_options.level0_slowdown_writes_trigger = std::numeric_limits<int>::max();
   rocksdb_options.level0_stop_writes_trigger = std::numeric_limits<int>::max();
 
-  const string db_dir = metadata()->rocksdb_dir();
-  RETURN_NOT_OK(CreateTabletDirectories(db_dir, metadata()->fs_manager()));
-
   LOG(INFO) << "Opening RocksDB at: " << db_dir;
   rocksdb::DB* db = nullptr;
   rocksdb::Status rocksdb_open_status = rocksdb::DB::Open(rocksdb_options, db_dir, &db);
@@ -535,6 +850,7 @@ Status Tablet::OpenKeyValueTablet() {
     return STATUS(IllegalState, rocksdb_open_status.ToString());
   }
   regular_db_.reset(db);
+  RETURN_NOT_OK(range_tombstones_->Load(regular_db_.get()));
 
   if (transaction_participant_) {
     LOG_WITH_PREFIX(INFO) << "Opening intents DB at: " << db_dir + kIntentsDBSuffix;
@@ -542,6 +858,10 @@ Status Tablet::OpenKeyValueTablet() {
       return std::bind(&Tablet::IntentsDbFlushFilter, this, _1);
     });
     rocksdb_options.listeners.clear();
+    rocksdb_options.table_properties_collector_factories.clear();
+    rocksdb_options.expired_file_filter = nullptr;
+    rocksdb_options.compaction_time_windows = nullptr;
+    docdb::InitIntentsDBOptions(&rocksdb_options);
 
     rocksdb_options.compaction_filter_factory =
         FLAGS_tablet_do_compaction_cleanup_for_intents ?
@@ -556,13 +876,14 @@ Status Tablet::OpenKeyValueTablet() {
     intents_db_.reset(intents_db);
   }
 
-  ql_storage_.reset(new docdb::QLRocksDBStorage({regular_db_.get(), intents_db_.get()}));
+  ql_storage_.reset(new docdb::QLRocksDBStorage(doc_db()));
   if (transaction_participant_) {
     transaction_participant_->SetDB(intents_db_.get());
   }
 
   // Don't allow reads at timestamps lower than the highest history cutoff of a past compaction.
   auto regular_flushed_frontier = regular_db_->GetFlushedFrontier();
+  HybridTime flushed_ht = HybridTime::kMin;
   if (regular_flushed_frontier) {
     const auto& regular_flushed_largest =
         static_cast<const docdb::ConsensusFrontier&>(*regular_flushed_frontier);
@@ -570,6 +891,17 @@ Status Tablet::OpenKeyValueTablet() {
       std::lock_guard<std::mutex> lock(active_readers_mutex_);
       earliest_read_time_allowed_ = regular_flushed_largest.history_cutoff();
     }
+    flushed_ht = regular_flushed_largest.hybrid_time();
+  }
+
+  row_cache_.reset();
+  if (FLAGS_docdb_row_cache_size_bytes > 0) {
+    // Entries could be added only by reads that happen after all writes already present in the DB.
+    auto initial_write_ht = clock_->Now();
+    initial_write_ht.MakeAtLeast(flushed_ht);
+    row_cache_ = std::make_unique<docdb::DocRowCache>(
+        FLAGS_docdb_row_cache_size_bytes, initial_write_ht,
+        MemTracker::FindOrCreateTracker("RowCache", mem_tracker_));
   }
 
   LOG_WITH_PREFIX(INFO) << "Successfully opened a RocksDB database at " << db_dir
@@ -580,11 +912,16 @@ Status Tablet::OpenKeyValueTablet() {
 
 Status Tablet::EnableCompactions() {
   Status regular_db_status;
+  // With adaptive write throttling writes are slowed down by the tablet leader, so RocksDB keeps
+  // write stalls disabled.
+  const bool stall_writes = !FLAGS_tablet_adaptive_write_throttling;
   std::unordered_map<std::string, std::string> new_options = {
       { "level0_slowdown_writes_trigger"s,
-        std::to_string(FLAGS_rocksdb_level0_slowdown_writes_trigger)},
+        std::to_string(stall_writes ? FLAGS_rocksdb_level0_slowdown_writes_trigger
+                                    : std::numeric_limits<int>::max())},
       { "level0_stop_writes_trigger"s,
-        std::to_string(FLAGS_rocksdb_level0_stop_writes_trigger)},
+        std::to_string(stall_writes ? FLAGS_rocksdb_level0_stop_writes_trigger
+                                    : std::numeric_limits<int>::max())},
   };
   if (regular_db_) {
     WARN_WITH_PREFIX_NOT_OK(
@@ -652,7 +989,7 @@ void Tablet::Shutdown() {
 
 Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
     const Schema &projection, const boost::optional<TransactionId>& transaction_id,
-    const TableId& table_id) const {
+    const TableId& table_id, const ReadHybridTime& read_hybrid_time) const {
   if (state_ != kOpen) {
     return STATUS_FORMAT(IllegalState, "Tablet in wrong state: $0", state_);
   }
@@ -672,11 +1009,11 @@ Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> Tablet::NewRowIterator(
   RETURN_NOT_OK(schema.GetMappedReadProjection(projection, mapped_projection.get()));
 
   auto txn_op_ctx = CreateTransactionOperationContext(transaction_id);
-  auto read_time = ReadHybridTime::SingleTime(SafeTime(RequireLease::kFalse));
+  auto read_time = read_hybrid_time
+      ? read_hybrid_time : ReadHybridTime::SingleTime(SafeTime(RequireLease::kFalse));
   auto result = std::make_unique<DocRowwiseIterator>(
       std::move(mapped_projection), schema, txn_op_ctx,
-      docdb::DocDB{regular_db_.get(), intents_db_.get()},
-      CoarseTimePoint::max() /* deadline */, read_time, &pending_op_counter_);
+      doc_db(), CoarseTimePoint::max() /* deadline */, read_time, &pending_op_counter_);
   RETURN_NOT_OK(result->Init());
   return std::move(result);
 }
@@ -706,14 +1043,89 @@ void Tablet::ApplyRowOperations(WriteOperationState* operation_state) {
           ? operation_state->consensus_round()->replicate_msg()->write_request().write_batch()
           // Bootstrap case.
           : operation_state->request()->write_batch();
+  RecordHotWriteKeys(put_batch);
+
+  yb::OpId op_id(operation_state->op_id().term(), operation_state->op_id().index());
+  if (ActiveApplyGroup()) {
+    if (!put_batch.has_transaction()) {
+      if (!put_batch.write_pairs().empty()) {
+        auto& group = *apply_group_;
+        auto hybrid_time = operation_state->hybrid_time();
+        if (group.write_batch.Count() == 0) {
+          group.frontiers.Smallest().set_op_id(op_id);
+          group.frontiers.Smallest().set_hybrid_time(hybrid_time);
+          group.min_hybrid_time = hybrid_time;
+        }
+        group.frontiers.Largest().set_op_id(op_id);
+        group.frontiers.Largest().set_hybrid_time(hybrid_time);
+        group.max_hybrid_time.MakeAtLeast(hybrid_time);
+        PrepareNonTransactionWriteBatch(put_batch, hybrid_time, &group.write_batch);
+      }
+      return;
+    }
+    // Intents are written to another DB, but operations should still be finalized in order.
+    WriteApplyGroup();
+  }
 
   docdb::ConsensusFrontiers frontiers;
-  set_op_id({operation_state->op_id().term(), operation_state->op_id().index()}, &frontiers);
+  set_op_id(op_id, &frontiers);
   set_hybrid_time(operation_state->hybrid_time(), &frontiers);
   ApplyKeyValueRowOperations(put_batch, &frontiers, operation_state->hybrid_time());
 }
 
-Status Tablet::CreateCheckpoint(const std::string& dir) {
+void Tablet::StartApplyGroup() {
+  if (!FLAGS_tablet_group_apply_writes || !regular_db_) {
+    return;
+  }
+  DCHECK(tablet_with_active_apply_group == nullptr);
+  if (!apply_group_) {
+    apply_group_ = std::make_unique<ApplyGroup>();
+  }
+  tablet_with_active_apply_group = this;
+}
+
+void Tablet::FinishApplyGroup() {
+  if (!ActiveApplyGroup()) {
+    return;
+  }
+  WriteApplyGroup();
+  tablet_with_active_apply_group = nullptr;
+}
+
+bool Tablet::DeferFinalizeUntilGroupWritten(std::function<void()> finalize) {
+  auto* group = ActiveApplyGroup();
+  if (!group || (group->write_batch.Count() == 0 && group->deferred_finalizers.empty())) {
+    return false;
+  }
+  group->deferred_finalizers.push_back(std::move(finalize));
+  return true;
+}
+
+Tablet::ApplyGroup* Tablet::ActiveApplyGroup() const {
+  // Other threads, e.g. the preparer applying an operation that was replicated before it was
+  // prepared, do not see the group and write their operations directly.
+  return tablet_with_active_apply_group == this ? apply_group_.get() : nullptr;
+}
+
+void Tablet::WriteApplyGroup() {
+  auto& group = *apply_group_;
+  if (group.write_batch.Count() != 0) {
+    // Invalidating the row cache with the max hybrid time of the group is conservative, while
+    // flush stats should track the oldest write.
+    flush_stats_->AboutToWriteToDb(group.min_hybrid_time);
+    WriteBatch(&group.frontiers, group.max_hybrid_time, &group.write_batch, regular_db_.get());
+    group.write_batch.Clear();
+    group.max_hybrid_time = HybridTime::kMin;
+  }
+  auto finalizers = std::move(group.deferred_finalizers);
+  group.deferred_finalizers.clear();
+  for (const auto& finalize : finalizers) {
+    finalize();
+  }
+}
+
+Result<DocDbOpIds> Tablet::CreateCheckpoint(
+    const std::string& dir, FlushMemtables flush_memtables, const std::string& base_dir) {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
 
@@ -733,12 +1145,30 @@ Status Tablet::CreateCheckpoint(const std::string& dir) {
   RETURN_NOT_OK_PREPEND(metadata()->fs_manager()->CreateDirIfMissing(parent_dir),
                         Format("Unable to create checkpoints directory $0", parent_dir));
 
-  // Order does not matter because we flush both DBs and does not have parallel writes.
+  // Flushed frontiers only move forward, so the checkpoint contains at least the operations up to
+  // the ones flushed at this point.
+  auto op_ids = VERIFY_RESULT(MaxPersistentOpId());
+
+  rocksdb::checkpoint::CheckpointOptions options;
+  options.flush_memtable = flush_memtables;
+
+  // Order does not matter. With flushing, both DBs contain all operations. Without it, each DB
+  // contains operations up to its own flushed frontier, the same state as after a crash, which
+  // tablet bootstrap recovers from by replaying the log.
   if (intents_db_) {
-    status = rocksdb::checkpoint::CreateCheckpoint(intents_db_.get(), temp_intents_dir);
+    if (!base_dir.empty()) {
+      options.base_checkpoint_dir = JoinPathSegments(base_dir, kIntentsSubdir);
+    }
+    status = rocksdb::checkpoint::CreateCheckpoint(intents_db_.get(), temp_intents_dir, options);
   }
   if (status.ok()) {
-    status = rocksdb::checkpoint::CreateCheckpoint(regular_db_.get(), dir);
+    options.base_checkpoint_dir = base_dir;
+    status = rocksdb::checkpoint::CreateCheckpoint(regular_db_.get(), dir, options);
+  }
+  // Blob files referenced by the checkpointed SST files are linked after them, since blob files
+  // are only deleted after the SST files referring to them are compacted away.
+  if (status.ok() && blob_storage_) {
+    status = blob_storage_->CreateCheckpoint(docdb::BlobStorage::DirForDb(dir));
   }
   if (status.ok() && intents_db_) {
     status = Env::Default()->RenameFile(temp_intents_dir, final_intents_dir);
@@ -748,11 +1178,67 @@ Status Tablet::CreateCheckpoint(const std::string& dir) {
     LOG_WITH_PREFIX(WARNING) << "Create checkpoint status: " << status;
     return STATUS_FORMAT(IllegalState, "Unable to create checkpoint: $0", status);
   }
-  LOG_WITH_PREFIX(INFO) << "Checkpoint created in " << dir;
+  LOG_WITH_PREFIX(INFO) << "Checkpoint created in " << dir << ", flushed op ids: " << op_ids.ToString();
 
   last_rocksdb_checkpoint_dir_ = dir;
 
-  return Status::OK();
+  return op_ids;
+}
+
+Result<scoped_refptr<RaftGroupMetadata>> Tablet::CreateSubtablet(
+    const TabletId& tablet_id, const Partition& partition, const docdb::KeyBounds& key_bounds) {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  if (!regular_db_) {
+    return STATUS(NotSupported,
+                  "Tablet does not have a RocksDB (could be a transaction status tablet)");
+  }
+
+  // Both bounds of the new tablet should lie within [key_bounds_.lower, key_bounds_.upper].
+  auto within_tablet = [this](const docdb::KeyBytes& key) {
+    return (key_bounds_.lower.empty() || key_bounds_.lower <= key) &&
+           (key_bounds_.upper.empty() || key <= key_bounds_.upper);
+  };
+  if ((key_bounds.lower.empty() && !key_bounds_.lower.empty()) ||
+      (key_bounds.upper.empty() && !key_bounds_.upper.empty()) ||
+      (!key_bounds.lower.empty() && !within_tablet(key_bounds.lower)) ||
+      (!key_bounds.upper.empty() && !within_tablet(key_bounds.upper))) {
+    return STATUS_FORMAT(InvalidArgument, "Key bounds $0 are not within tablet key bounds $1",
+                         key_bounds, key_bounds_);
+  }
+
+  auto subtablet_metadata = VERIFY_RESULT(metadata_->CreateSubtabletMetadata(
+      tablet_id, partition, key_bounds.lower.data(), key_bounds.upper.data()));
+  const auto& rocksdb_dir = subtablet_metadata->rocksdb_dir();
+  RETURN_NOT_OK_PREPEND(metadata_->fs_manager()->CreateDirIfMissing(DirName(rocksdb_dir)),
+                        Format("Unable to create directory for $0", rocksdb_dir));
+
+  std::lock_guard<std::mutex> lock(create_checkpoint_lock_);
+
+  // Checkpoint flushes memtables and hard links all live SST files into the new directories.
+  Status status;
+  if (intents_db_) {
+    status = rocksdb::checkpoint::CreateCheckpoint(
+        intents_db_.get(), rocksdb_dir + kIntentsDBSuffix);
+  }
+  if (status.ok()) {
+    status = rocksdb::checkpoint::CreateCheckpoint(regular_db_.get(), rocksdb_dir);
+  }
+  if (status.ok() && blob_storage_) {
+    status = blob_storage_->CreateCheckpoint(docdb::BlobStorage::DirForDb(rocksdb_dir));
+  }
+  if (!status.ok()) {
+    LOG_WITH_PREFIX(WARNING) << "Create subtablet " << tablet_id << " status: " << status;
+    WARN_NOT_OK(subtablet_metadata->DeleteTabletData(TABLET_DATA_DELETED, yb::OpId()),
+                "Failed to delete subtablet data");
+    WARN_NOT_OK(subtablet_metadata->DeleteSuperBlock(), "Failed to delete subtablet superblock");
+    return STATUS_FORMAT(IllegalState, "Unable to create subtablet: $0", status);
+  }
+
+  LOG_WITH_PREFIX(INFO) << "Created subtablet " << tablet_id << " with key bounds "
+                        << key_bounds.ToString() << " in " << rocksdb_dir;
+  return subtablet_metadata;
 }
 
 void Tablet::PrepareTransactionWriteBatch(
@@ -780,6 +1266,8 @@ void Tablet::PrepareTransactionWriteBatch(
   yb::docdb::PrepareTransactionWriteBatch(
       put_batch, hybrid_time, rocksdb_write_batch, transaction_id, isolation_level, &write_id);
   transaction_participant()->UpdateLastWriteId(transaction_id, write_id);
+  // Intents should be indexed before they are written, so readers never miss them in the index.
+  transaction_participant()->IndexIntents(transaction_id, *rocksdb_write_batch);
 }
 
 void Tablet::ApplyKeyValueRowOperations(const KeyValueWriteBatchPB& put_batch,
@@ -816,11 +1304,18 @@ void Tablet::WriteBatch(const rocksdb::UserFrontiers* frontiers,
   InitRocksDBWriteOptions(&write_options);
 
   flush_stats_->AboutToWriteToDb(hybrid_time);
+  if (dest_db == regular_db_.get()) {
+    range_tombstones_->Update(*write_batch);
+  }
   auto rocksdb_write_status = dest_db->Write(write_options, write_batch);
   if (!rocksdb_write_status.ok()) {
     LOG_WITH_PREFIX(FATAL) << "Failed to write a batch with " << write_batch->Count()
                            << " operations into RocksDB: " << rocksdb_write_status;
   }
+
+  if (row_cache_ && dest_db == regular_db_.get()) {
+    row_cache_->Invalidate(*write_batch, hybrid_time);
+  }
 }
 
 namespace {
@@ -878,6 +1373,57 @@ Status Tablet::KeyValueBatchFromRedisWriteBatch(WriteOperation* operation) {
   return Status::OK();
 }
 
+namespace {
+
+CHECKED_STATUS HashedComponents(
+    const google::protobuf::RepeatedPtrField<QLExpressionPB>& hashed_column_values,
+    const Schema& schema, std::vector<docdb::PrimitiveValue>* components) {
+  return docdb::QLKeyColumnValuesToPrimitiveValues(
+      hashed_column_values, schema, 0, schema.num_hash_key_columns(), components);
+}
+
+CHECKED_STATUS HashedComponents(
+    const google::protobuf::RepeatedPtrField<PgsqlExpressionPB>& hashed_column_values,
+    const Schema& schema, std::vector<docdb::PrimitiveValue>* components) {
+  return docdb::InitKeyColumnPrimitiveValues(hashed_column_values, schema, 0, components);
+}
+
+} // namespace
+
+void Tablet::RecordHotWriteKeys(const KeyValueWriteBatchPB& put_batch) {
+  Slice last_doc_key;
+  for (const auto& pair : put_batch.write_pairs()) {
+    // Writes of different columns of the same row are usually adjacent, and are counted once.
+    if (!last_doc_key.empty() && Slice(pair.key()).starts_with(last_doc_key)) {
+      continue;
+    }
+    if (!hot_write_keys_.ShouldRecord()) {
+      last_doc_key = Slice();
+      continue;
+    }
+    auto doc_key_size = docdb::DocKey::EncodedSize(pair.key(), docdb::DocKeyPart::WHOLE_DOC_KEY);
+    if (!doc_key_size.ok()) {
+      continue;
+    }
+    last_doc_key = Slice(pair.key().data(), *doc_key_size);
+    hot_write_keys_.RecordSampled(last_doc_key);
+  }
+}
+
+template <class Values>
+void Tablet::RecordHotReadKey(
+    const Schema& schema, uint32_t hash_code, const Values& hashed_column_values) {
+  if (hashed_column_values.empty() || !hot_read_keys_.ShouldRecord()) {
+    return;
+  }
+  std::vector<docdb::PrimitiveValue> components;
+  if (!HashedComponents(hashed_column_values, schema, &components).ok()) {
+    return;
+  }
+  hot_read_keys_.RecordSampled(
+      docdb::DocKey(schema, hash_code, std::move(components)).Encode().AsSlice());
+}
+
 Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
                                       const ReadHybridTime& read_time,
                                       const RedisReadRequestPB& redis_read_request,
@@ -887,9 +1433,23 @@ Status Tablet::HandleRedisReadRequest(CoarseTimePoint deadline,
   RETURN_NOT_OK(scoped_read_operation);
 
   ScopedTabletMetricsTracker metrics_tracker(metrics_->redis_read_latency);
+  ScopedStorageProfileTracker storage_profile_tracker(metrics_.get());
 
+  if (redis_read_request.has_key_value() && hot_read_keys_.ShouldRecord()) {
+    hot_read_keys_.RecordSampled(docdb::DocKey::EncodedFromRedisKey(
+        redis_read_request.key_value().hash_code(),
+        redis_read_request.key_value().key()).AsSlice());
+  }
+
+  // Pages after the first one are read at the time of the first page. It is not newer than
+  // read_time, so the tablet is already safe to read at it.
+  const auto effective_read_time = redis_read_request.paging_state().has_read_ht()
+      ? ReadHybridTime::FromUint64(redis_read_request.paging_state().read_ht())
+      : read_time;
   docdb::RedisReadOperation doc_op(
-      redis_read_request, {regular_db_.get(), intents_db_.get()}, deadline, read_time);
+      redis_read_request, {regular_db_.get(), intents_db_.get(), row_cache_.get(), &key_bounds_,
+                           blob_storage_.get(), range_tombstones_.get()},
+      deadline, effective_read_time);
   RETURN_NOT_OK(doc_op.Execute());
   *response = std::move(doc_op.response());
   return Status::OK();
@@ -906,12 +1466,16 @@ Status Tablet::HandleQLReadRequest(
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
   ScopedTabletMetricsTracker metrics_tracker(metrics_->ql_read_latency);
+  ScopedStorageProfileTracker storage_profile_tracker(metrics_.get());
 
   if (metadata()->schema_version() != ql_read_request.schema_version()) {
     result->response.set_status(QLResponsePB::YQL_STATUS_SCHEMA_VERSION_MISMATCH);
     return Status::OK();
   }
 
+  RecordHotReadKey(
+      SchemaRef(), ql_read_request.hash_code(), ql_read_request.hashed_column_values());
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
@@ -1050,7 +1614,7 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
   client::YBClient* client = nullptr;
   client::YBSessionPtr session;
   client::YBTransactionPtr txn;
-  std::vector<std::pair<std::shared_ptr<client::YBqlWriteOp>, QLWriteOperation*>> index_ops;
+  QLIndexOps index_ops;
   const ChildTransactionDataPB* child_transaction_data = nullptr;
   for (auto& doc_op : operation->doc_ops()) {
     auto* write_op = static_cast<QLWriteOperation*>(doc_op.get());
@@ -1059,7 +1623,10 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
     }
     if (!client) {
       client = client_future_.get();
-      session = std::make_shared<YBSession>(client);
+      if (write_op->request().has_child_transaction_data() ||
+          !FLAGS_tablet_coalesce_index_writes) {
+        session = std::make_shared<YBSession>(client);
+      }
       if (write_op->request().has_child_transaction_data()) {
         child_transaction_data = &write_op->request().child_transaction_data();
         if (!transaction_manager_) {
@@ -1107,20 +1674,27 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
       shared_ptr<client::YBqlWriteOp> index_op(index_table->NewQLWrite());
       index_op->mutable_request()->Swap(&pair.second);
       index_op->mutable_request()->MergeFrom(pair.second);
-      status = session->Apply(index_op);
-      if (!status.ok()) {
-        operation->state()->CompleteWithStatus(status);
-        return;
+      if (session) {
+        status = session->Apply(index_op);
+        if (!status.ok()) {
+          operation->state()->CompleteWithStatus(status);
+          return;
+        }
       }
       index_ops.emplace_back(std::move(index_op), write_op);
     }
   }
 
-  if (!session) {
+  if (!client) {
     CompleteQLWriteBatch(std::move(operation), Status::OK());
     return;
   }
 
+  if (!session) {
+    ApplyCoalescedQLIndexWrites(std::move(operation), client, std::move(index_ops));
+    return;
+  }
+
   session->FlushAsync(
       [this, op = operation.release(), session, txn, index_ops = std::move(index_ops)]
           (const Status& status) {
@@ -1170,6 +1744,70 @@ void Tablet::UpdateQLIndexes(std::unique_ptr<WriteOperation> operation) {
   });
 }
 
+void Tablet::ApplyCoalescedQLIndexWrites(
+    std::unique_ptr<WriteOperation> operation, client::YBClient* client, QLIndexOps index_ops) {
+  std::shared_ptr<client::CoalescingSession> session;
+  {
+    std::lock_guard<std::mutex> lock(index_writes_session_mutex_);
+    if (!index_writes_session_) {
+      index_writes_session_ = std::make_shared<client::CoalescingSession>(client);
+    }
+    session = index_writes_session_;
+  }
+
+  struct IndexWrites {
+    std::unique_ptr<WriteOperation> operation;
+    QLIndexOps index_ops;
+    std::atomic<size_t> outstanding_ops{0};
+    std::mutex mutex;
+    Status status;
+  };
+  auto index_writes = std::make_shared<IndexWrites>();
+  index_writes->operation = std::move(operation);
+  index_writes->index_ops = std::move(index_ops);
+  index_writes->outstanding_ops = index_writes->index_ops.size();
+
+  // Copy the ops since the last callback may complete the operation while ops are being applied.
+  std::vector<std::shared_ptr<client::YBqlWriteOp>> ops;
+  ops.reserve(index_writes->index_ops.size());
+  for (const auto& pair : index_writes->index_ops) {
+    ops.push_back(pair.first);
+  }
+  for (auto& index_op : ops) {
+    session->ApplyAsync(std::move(index_op), [this, index_writes](const Status& status) {
+      if (!status.ok()) {
+        std::lock_guard<std::mutex> lock(index_writes->mutex);
+        // Return just the first error seen.
+        if (index_writes->status.ok()) {
+          index_writes->status = status;
+        }
+      }
+      if (--index_writes->outstanding_ops != 0) {
+        return;
+      }
+
+      std::unique_ptr<WriteOperation> operation = std::move(index_writes->operation);
+      if (!index_writes->status.ok()) {
+        operation->state()->CompleteWithStatus(index_writes->status);
+        return;
+      }
+
+      // Check the responses of the index write ops.
+      for (const auto& pair : index_writes->index_ops) {
+        auto* response = pair.second->response();
+        DCHECK_ONLY_NOTNULL(response);
+        auto* index_response = pair.first->mutable_response();
+        if (index_response->status() != QLResponsePB::YQL_STATUS_OK) {
+          response->set_status(index_response->status());
+          response->set_error_message(std::move(*index_response->mutable_error_message()));
+        }
+      }
+
+      CompleteQLWriteBatch(std::move(operation), Status::OK());
+    });
+  }
+}
+
 //--------------------------------------------------------------------------------------------------
 // PGSQL Request Processing.
 Status Tablet::HandlePgsqlReadRequest(
@@ -1182,6 +1820,7 @@ Status Tablet::HandlePgsqlReadRequest(
   RETURN_NOT_OK(scoped_read_operation);
   // TODO(neil) Work on metrics for PGSQL.
   // ScopedTabletMetricsTracker metrics_tracker(metrics_->pgsql_read_latency);
+  ScopedStorageProfileTracker storage_profile_tracker(metrics_.get());
 
   const tablet::TableInfo* table_info =
       VERIFY_RESULT(metadata_->GetTableInfo(pgsql_read_request.table_id()));
@@ -1192,6 +1831,15 @@ Status Tablet::HandlePgsqlReadRequest(
     return Status::OK();
   }
 
+  if (pgsql_read_request.has_ybctid_column_value()) {
+    if (hot_read_keys_.ShouldRecord()) {
+      hot_read_keys_.RecordSampled(pgsql_read_request.ybctid_column_value().value().binary_value());
+    }
+  } else {
+    RecordHotReadKey(table_info->schema, pgsql_read_request.hash_code(),
+                     pgsql_read_request.partition_column_values());
+  }
+
   Result<TransactionOperationContextOpt> txn_op_ctx =
       CreateTransactionOperationContext(transaction_metadata);
   RETURN_NOT_OK(txn_op_ctx);
@@ -1208,14 +1856,18 @@ CHECKED_STATUS Tablet::CreatePagingStateForRead(const PgsqlReadRequestPB& pgsql_
   // key of the next tablet. Do so only if the request has no row count limit, or there is and we
   // haven't hit it, or we are asked to return paging state even when we have hit the limit.
   // Otherwise, leave the paging state empty which means we are completely done reading for the
-  // whole SELECT statement.
+  // whole SELECT statement. A scan of a hash code range is also done when the next tablet starts
+  // past its upper bound.
   if (pgsql_read_request.partition_column_values().empty() &&
       pgsql_read_request.ybctid_column_value().value().binary_value().empty() &&
       !response->has_paging_state() &&
       (!pgsql_read_request.has_limit() || row_count < pgsql_read_request.limit() ||
        pgsql_read_request.return_paging_state())) {
     const string& next_partition_key = metadata_->partition().partition_key_end();
-    if (!next_partition_key.empty()) {
+    if (!next_partition_key.empty() &&
+        (!pgsql_read_request.has_max_hash_code() ||
+         PartitionSchema::DecodeMultiColumnHashValue(next_partition_key) <=
+             pgsql_read_request.max_hash_code())) {
       response->mutable_paging_state()->set_next_partition_key(next_partition_key);
     }
   }
@@ -1369,14 +2021,35 @@ Status Tablet::ImportData(const std::string& source_dir) {
 // We apply intents using by iterating over whole transaction reverse index.
 // Using value of reverse index record we find original intent record and apply it.
 // After that we delete both intent record and reverse index record.
-// TODO(dtxn) use separate thread for applying intents.
-// TODO(dtxn) use multiple batches when applying really big transaction.
-Status Tablet::ApplyIntents(const TransactionApplyData& data) {
+// Big transactions are applied by several batches, each of them contains at most
+// txn_max_apply_batch_records intents.
+Status Tablet::ApplyIntents(
+    const TransactionApplyData& data, docdb::ApplyTransactionState* apply_state) {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_operation);
+
+  const bool was_active = apply_state->active();
   rocksdb::WriteBatch regular_write_batch;
   rocksdb::WriteBatch intents_write_batch;
-  RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
+  auto status = docdb::PrepareApplyIntentsBatch(
       data.transaction_id, data.commit_ht,
-      &regular_write_batch, intents_db_.get(), &intents_write_batch));
+      &regular_write_batch, intents_db_.get(), &intents_write_batch,
+      apply_state, std::max(FLAGS_txn_max_apply_batch_records, 0));
+  if (!status.ok()) {
+    // Background apply of this transaction is stopped, so it should not delay flushes anymore.
+    // Intents that were not applied are kept in the intents DB.
+    if (was_active) {
+      PendingApplyFinished(data.op_id.index());
+    }
+    return status;
+  }
+
+  // Should be registered before the first batch is written, so it would not be flushed.
+  if (!was_active && apply_state->active()) {
+    VLOG_WITH_PREFIX(2) << "Apply " << data.transaction_id << " by several batches";
+    std::lock_guard<std::mutex> lock(pending_applies_mutex_);
+    pending_applies_.insert(data.op_id.index());
+  }
 
   // data.hybrid_time contains transaction commit time.
   // We don't set transaction field of put_batch, otherwise we would write another bunch of intents.
@@ -1385,9 +2058,34 @@ Status Tablet::ApplyIntents(const TransactionApplyData& data) {
   set_hybrid_time(data.log_ht, &frontiers);
   WriteBatch(&frontiers, data.commit_ht, &regular_write_batch, regular_db_.get());
   WriteBatch(&frontiers, data.commit_ht, &intents_write_batch, intents_db_.get());
+
+  if (was_active && !apply_state->active()) {
+    PendingApplyFinished(data.op_id.index());
+  }
   return Status::OK();
 }
 
+void Tablet::PendingApplyFinished(int64_t op_index) {
+  bool flush_delayed = false;
+  {
+    std::lock_guard<std::mutex> lock(pending_applies_mutex_);
+    // Could be missing if the DB was replaced by truncate or restore in the meantime.
+    auto it = pending_applies_.find(op_index);
+    if (it != pending_applies_.end()) {
+      pending_applies_.erase(it);
+    }
+    if (pending_applies_.empty()) {
+      flush_delayed = flush_delayed_by_applies_.exchange(false, std::memory_order_acq_rel);
+    }
+  }
+  // Memtables rejected by the flush filter would not be picked again until the next flush.
+  if (flush_delayed) {
+    rocksdb::FlushOptions options;
+    options.wait = false;
+    WARN_NOT_OK(regular_db_->Flush(options), "Flush after transaction apply failed");
+  }
+}
+
 CHECKED_STATUS Tablet::RemoveIntents(const TransactionId& id) {
   rocksdb::WriteBatch intents_write_batch;
   RETURN_NOT_OK(docdb::PrepareApplyIntentsBatch(
@@ -1660,6 +2358,75 @@ Result<bool> Tablet::HasSSTables() const {
   return !live_files_metadata.empty();
 }
 
+namespace {
+
+// Returns the fraction of writes to reject for the value, growing linearly from 0 at soft_limit
+// to 1 at hard_limit.
+double ThrottlingRatio(uint64_t value, uint64_t soft_limit, uint64_t hard_limit) {
+  if (soft_limit == 0 || value <= soft_limit) {
+    return 0;
+  }
+  if (value >= hard_limit) {
+    return 1;
+  }
+  return static_cast<double>(value - soft_limit) / (hard_limit - soft_limit);
+}
+
+double DbWriteThrottlingRatio(rocksdb::DB* db) {
+  double result = 0;
+  std::string num_sst_files_str;
+  uint64_t num_sst_files = 0;
+  if (db->GetProperty(rocksdb::DB::Properties::kNumFilesAtLevelPrefix + "0", &num_sst_files_str) &&
+      safe_strtou64(num_sst_files_str, &num_sst_files)) {
+    result = std::max(result, ThrottlingRatio(
+        num_sst_files, std::max(FLAGS_rocksdb_level0_slowdown_writes_trigger, 0),
+        std::max(FLAGS_rocksdb_level0_stop_writes_trigger, 0)));
+  }
+  uint64_t num_immutable_memtables = 0;
+  if (db->GetIntProperty(
+          rocksdb::DB::Properties::kNumImmutableMemTable, &num_immutable_memtables)) {
+    result = std::max(result, ThrottlingRatio(
+        num_immutable_memtables,
+        std::max(FLAGS_tablet_write_throttling_immutable_memtables_soft_limit, 0),
+        std::max(FLAGS_tablet_write_throttling_immutable_memtables_hard_limit, 0)));
+  }
+  uint64_t pending_compaction_bytes = 0;
+  if (db->GetIntProperty(
+          rocksdb::DB::Properties::kEstimatePendingCompactionBytes, &pending_compaction_bytes)) {
+    result = std::max(result, ThrottlingRatio(
+        pending_compaction_bytes, FLAGS_tablet_write_throttling_pending_compaction_bytes_soft_limit,
+        FLAGS_tablet_write_throttling_pending_compaction_bytes_hard_limit));
+  }
+  return result;
+}
+
+} // namespace
+
+double Tablet::WriteThrottlingRatio() {
+  if (!FLAGS_tablet_adaptive_write_throttling) {
+    return 0;
+  }
+
+  std::unique_lock<std::mutex> lock(write_throttling_mutex_, std::try_to_lock);
+  auto now = CoarseMonoClock::Now();
+  // Concurrent writers use the cached ratio while it is being recomputed.
+  if (lock.owns_lock() && now >= write_throttling_refresh_time_) {
+    ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+    if (scoped_read_operation.ok()) {
+      double ratio = 0;
+      for (auto* db : {regular_db_.get(), intents_db_.get()}) {
+        if (db) {
+          ratio = std::max(ratio, DbWriteThrottlingRatio(db));
+        }
+      }
+      write_throttling_ratio_.store(ratio, std::memory_order_release);
+      write_throttling_refresh_time_ =
+          now + FLAGS_tablet_write_throttling_refresh_interval_ms * 1ms;
+    }
+  }
+  return write_throttling_ratio_.load(std::memory_order_acquire);
+}
+
 Result<DocDbOpIds> Tablet::MaxPersistentOpId() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
@@ -1682,6 +2449,23 @@ Result<DocDbOpIds> Tablet::MaxPersistentOpId() const {
   return result;
 }
 
+Status Tablet::PrewarmSstFiles() {
+  ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
+  RETURN_NOT_OK(scoped_read_operation);
+
+  if (!regular_db_) {
+    return Status::OK();
+  }
+
+  // The iterator opens all SST files through the table cache, while seeking to the first key reads
+  // the top level index block and first data block of every file.
+  rocksdb::ReadOptions read_options;
+  read_options.query_id = rocksdb::kDefaultQueryId;
+  std::unique_ptr<rocksdb::Iterator> iter(regular_db_->NewIterator(read_options));
+  iter->SeekToFirst();
+  return iter->status();
+}
+
 Result<HybridTime> Tablet::MaxPersistentHybridTime() const {
   ScopedPendingOperation scoped_read_operation(&pending_op_counter_);
   RETURN_NOT_OK(scoped_read_operation);
@@ -1774,7 +2558,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
     if (isolation_level == IsolationLevel::NON_TRANSACTIONAL) {
       auto now = clock_->Now();
       auto result = VERIFY_RESULT(docdb::ResolveOperationConflicts(
-          operation->doc_ops(), now, { regular_db_.get(), intents_db_.get() },
+          operation->doc_ops(), now, doc_db(),
           transaction_participant_.get()));
       if (now != result) {
         clock_->Update(result);
@@ -1802,7 +2586,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
       RETURN_NOT_OK(docdb::ResolveTransactionConflicts(
           operation->doc_ops(), *write_batch, clock_->Now(),
           read_time ? read_time.read : HybridTime::kMax,
-          { regular_db_.get(), intents_db_.get() }, transaction_participant_.get(),
+          doc_db(), transaction_participant_.get(),
           metrics_->transaction_conflicts.get()));
 
       if (!read_time) {
@@ -1823,7 +2607,12 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
       ? read_op.read_time()
       // When need_read_snapshot is false, this time is used only to write TTL field of record.
       : ReadHybridTime::SingleTime(clock_->Now());
-
+  // The read time picked on this tablet is reported to the client as used read time, that applies
+  // to all tablets, so only a read time picked by the client is narrowed.
+  if (prepare_result.need_read_snapshot && !allow_immediate_read_restart &&
+      GetAtomicFlag(&FLAGS_limit_read_uncertainty_by_safe_time)) {
+    LimitReadUncertainty(SafeTime(RequireLease::kTrue), &real_read_time);
+  }
 
   // We expect all read operations for this transaction to be done in ExecuteDocWriteOperation.
   // Once read_txn goes out of scope, the read point is deregistered.
@@ -1836,7 +2625,7 @@ Status Tablet::StartDocWriteOperation(WriteOperation* operation) {
   for (;;) {
     RETURN_NOT_OK(docdb::ExecuteDocWriteOperation(
         operation->doc_ops(), operation->deadline(), real_read_time,
-        { regular_db_.get(), intents_db_.get() }, write_batch,
+        doc_db(), write_batch,
         table_type_ == TableType::REDIS_TABLE_TYPE
             ? InitMarkerBehavior::kRequired
             : InitMarkerBehavior::kOptional,
@@ -2011,6 +2800,31 @@ uint64_t Tablet::GetTotalSSTFileSizes() const {
   return regular_db_->GetTotalSSTFileSize();
 }
 
+uint64_t Tablet::GetMemTablesSize(const std::string& property) const {
+  ScopedPendingOperation scoped_operation(&pending_op_counter_);
+  std::lock_guard<rw_spinlock> lock(component_lock_);
+
+  if (!pending_op_counter_.IsReady()) {
+    return 0;
+  }
+  uint64_t result = 0;
+  for (auto* db : {regular_db_.get(), intents_db_.get()}) {
+    uint64_t size = 0;
+    if (db && db->GetIntProperty(property, &size)) {
+      result += size;
+    }
+  }
+  return result;
+}
+
+uint64_t Tablet::GetActiveMemTablesSize() const {
+  return GetMemTablesSize(rocksdb::DB::Properties::kCurSizeActiveMemTable);
+}
+
+uint64_t Tablet::GetAllMemTablesSize() const {
+  return GetMemTablesSize(rocksdb::DB::Properties::kCurSizeAllMemTables);
+}
+
 uint64_t Tablet::GetUncompressedSSTFileSizes() const {
   ScopedPendingOperation scoped_operation(&pending_op_counter_);
   std::lock_guard<rw_spinlock> lock(component_lock_);
@@ -2080,6 +2894,70 @@ Status Tablet::CreateReadIntents(
   return Status::OK();
 }
 
+void Tablet::LimitReadUncertainty(HybridTime safe_time, ReadHybridTime* read_time) {
+  if (!safe_time.is_valid()) {
+    return;
+  }
+  const auto local_limit = std::max(safe_time, read_time->read);
+  if (local_limit < read_time->local_limit) {
+    read_time->local_limit = local_limit;
+    metrics_->narrowed_read_uncertainty_windows->Increment();
+  }
+}
+
+bool Tablet::CanServeLeaseProtectedRead(
+    const google::protobuf::RepeatedPtrField<QLReadRequestPB>& ql_batch,
+    const google::protobuf::RepeatedPtrField<PgsqlReadRequestPB>& pgsql_batch,
+    HybridTime read_ht) {
+  if (!ht_lease_provider_ || (ql_batch.empty() && pgsql_batch.empty())) {
+    return false;
+  }
+  auto ht_lease = ht_lease_provider_(0 /* min_allowed */, CoarseTimePoint::max() /* deadline */);
+  if (!ht_lease || ht_lease < read_ht) {
+    return false;
+  }
+  // Writes that lock their keys after this point get hybrid time from the clock later than now,
+  // so they are not visible at read_ht.
+  if (read_ht > clock_->Now()) {
+    return false;
+  }
+  // Operations replicated from the previous leader don't hold locks, so we cannot check whether
+  // they overlap the read keys.
+  if (mvcc_.HasPendingFollowerSideOperations()) {
+    return false;
+  }
+
+  docdb::KeyValueWriteBatchPB write_batch;
+  for (const auto& ql_read : ql_batch) {
+    if (ql_read.hashed_column_values().empty()) {
+      return false;
+    }
+    docdb::QLReadOperation doc_op(ql_read, TransactionOperationContextOpt());
+    if (!doc_op.GetIntents(SchemaRef(), &write_batch).ok()) {
+      return false;
+    }
+  }
+  for (const auto& pgsql_read : pgsql_batch) {
+    if (pgsql_read.partition_column_values().empty()) {
+      return false;
+    }
+    docdb::PgsqlReadOperation doc_op(pgsql_read, TransactionOperationContextOpt());
+    if (!doc_op.GetIntents(SchemaRef(), &write_batch).ok()) {
+      return false;
+    }
+  }
+
+  // Pending writes hold locks on the keys they write until they are applied, so if we could lock
+  // the read keys without waiting, no pending write overlaps them. The locks are released right
+  // away, since we only need to know that read_ht is safe for these keys.
+  auto prepare_result = docdb::PrepareDocWriteOperation(
+      {} /* doc_write_ops */, write_batch.read_pairs(), nullptr /* write_lock_latency */,
+      IsolationLevel::NON_TRANSACTIONAL, docdb::OperationKind::kRead,
+      metadata_->schema().table_properties().is_transactional(),
+      CoarseTimePoint::min() /* deadline */, &shared_lock_manager_);
+  return prepare_result.ok();
+}
+
 bool Tablet::ShouldApplyWrite() {
   return !regular_db_->NeedsDelay();
 }
@@ -2134,16 +3012,22 @@ Status Tablet::RestoreCheckpoint(const std::string& dir, const docdb::ConsensusF
     }
   }
 
-  s = rocksdb::CopyDirectory(rocksdb_options.env, dir, db_dir, rocksdb::CreateIfMissing::kTrue);
+  // Files of the checkpoint are placed directly into the DB directory, and only the ones that
+  // could not be hard linked are copied. The intents DB is reopened empty, as before, since its
+  // flushed frontier is not reset to the restore operation.
+  auto start = MonoTime::Now();
+  std::vector<FileToCopy> files_to_copy;
+  s = PlaceCheckpointFiles(rocksdb_options.env, dir, db_dir, kIntentsSubdir, &files_to_copy);
+  if (s.ok()) {
+    s = CopyCheckpointFiles(rocksdb_options.env, files_to_copy);
+  }
   if (PREDICT_FALSE(!s.ok())) {
     LOG_WITH_PREFIX(WARNING) << "Copy checkpoint files status: " << s;
     return STATUS(IllegalState, "Unable to copy checkpoint files", s.ToString());
   }
-
-  if (!intents_db_dir.empty()) {
-    auto intents_tmp_dir = JoinPathSegments(dir, tablet::kIntentsSubdir);
-    rocksdb_options.env->RenameFile(intents_db_dir, intents_db_dir);
-  }
+  LOG_WITH_PREFIX(INFO) << "Placed checkpoint files from " << dir << " in "
+                        << MonoTime::Now().GetDeltaSince(start) << ", copied: "
+                        << files_to_copy.size();
 
   // Reopen database from copied checkpoint.
   // Note: db_dir == metadata()->rocksdb_dir() is still valid db dir.
@@ -32,8 +32,10 @@
 #ifndef YB_TABLET_TABLET_H_
 #define YB_TABLET_TABLET_H_
 
+#include <functional>
 #include <iosfwd>
 #include <map>
+#include <set>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -54,6 +56,7 @@
 
 #include "yb/docdb/docdb.pb.h"
 #include "yb/docdb/docdb_compaction_filter.h"
+#include "yb/docdb/docdb_fwd.h"
 #include "yb/docdb/doc_operation.h"
 #include "yb/docdb/ql_rocksdb_storage.h"
 #include "yb/docdb/shared_lock_manager.h"
@@ -65,6 +68,8 @@
 #include "yb/rpc/rpc_fwd.h"
 
 #include "yb/tablet/abstract_tablet.h"
+#include "yb/tablet/admission_controller.h"
+#include "yb/tablet/hot_key_tracker.h"
 #include "yb/tablet/lock_manager.h"
 #include "yb/tablet/tablet_options.h"
 #include "yb/tablet/mvcc.h"
@@ -96,6 +101,7 @@ class RowChangeList;
 
 namespace docdb {
 class ConsensusFrontier;
+class QLWriteOperation;
 }
 
 namespace log {
@@ -125,6 +131,7 @@ class WriteOperationState;
 using docdb::LockBatch;
 
 YB_STRONGLY_TYPED_BOOL(IncludeIntents);
+YB_STRONGLY_TYPED_BOOL(FlushMemtables);
 
 class TabletFlushStats : public rocksdb::EventListener {
  public:
@@ -246,7 +253,8 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   CHECKED_STATUS ImportData(const std::string& source_dir);
 
-  CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) override;
+  CHECKED_STATUS ApplyIntents(
+      const TransactionApplyData& data, docdb::ApplyTransactionState* apply_state) override;
 
   CHECKED_STATUS RemoveIntents(const TransactionId& id) override;
 
@@ -285,6 +293,21 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Apply all of the row operations associated with this transaction.
   void ApplyRowOperations(WriteOperationState* operation_state);
 
+  // Starts a group of write operations that are applied one after another by the caller thread.
+  // Regular DB changes of non-transactional write operations applied by this thread while the group
+  // is active are accumulated in a single RocksDB write batch, that is written by FinishApplyGroup.
+  // Operations applied by other threads are written directly.
+  // Does nothing unless --tablet_group_apply_writes is set.
+  void StartApplyGroup();
+
+  // Writes changes accumulated by the current apply group and finalizes operations that were
+  // waiting for it, in the order they were applied.
+  void FinishApplyGroup();
+
+  // Returns true if the operation just applied by the caller thread could not be finalized until
+  // changes of its apply group are written. In this case finalize will be invoked by the group.
+  bool DeferFinalizeUntilGroupWritten(std::function<void()> finalize);
+
   // Apply a set of RocksDB row operations.
   // If rocksdb_write_batch is specified it could contain preencoded RocksDB operations.
   void ApplyKeyValueRowOperations(
@@ -349,14 +372,36 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   //------------------------------------------------------------------------------------------------
   // Create a RocksDB checkpoint in the provided directory. Only used when table_type_ ==
   // YQL_TABLE_TYPE.
-  CHECKED_STATUS CreateCheckpoint(const std::string& dir);
+  // Without flushing memtables, the checkpoint does not stall writes but only contains operations
+  // up to the returned op ids, and the following ones should be replayed from the log.
+  // Table files already present in base_dir, a previous checkpoint of this tablet, are linked
+  // from there, so that only new files are copied.
+  Result<DocDbOpIds> CreateCheckpoint(
+      const std::string& dir, FlushMemtables flush_memtables = FlushMemtables::kTrue,
+      const std::string& base_dir = std::string());
+
+  // Creates metadata and RocksDB directories of a new tablet that owns the specified partition and
+  // key bounds, which should lie within the bounds of this tablet. SST files are shared with this
+  // tablet using hard links, keys outside of key_bounds are ignored by reads of the new tablet and
+  // dropped by its compactions. Only used when table_type_ == YQL_TABLE_TYPE.
+  Result<scoped_refptr<RaftGroupMetadata>> CreateSubtablet(
+      const TabletId& tablet_id, const Partition& partition, const docdb::KeyBounds& key_bounds);
+
+  const docdb::KeyBounds& key_bounds() const { return key_bounds_; }
+
+  docdb::DocDB doc_db() const {
+    return { regular_db_.get(), intents_db_.get(), nullptr /* row_cache */, &key_bounds_,
+             blob_storage_.get(), range_tombstones_.get() };
+  }
 
   // Create a new row iterator which yields the rows as of the current MVCC
-  // state of this tablet.
+  // state of this tablet, or as of read_hybrid_time if it is specified. The caller is responsible
+  // for waiting until the safe time reaches the specified read time.
   // The returned iterator is not initialized.
   Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
       const Schema &projection, const boost::optional<TransactionId>& transaction_id,
-      const TableId& table_id = "") const;
+      const TableId& table_id = "",
+      const ReadHybridTime& read_hybrid_time = ReadHybridTime()) const;
   Result<std::unique_ptr<common::YQLRowwiseIteratorIf>> NewRowIterator(
       const TableId& table_id) const;
 
@@ -418,6 +463,15 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // May be NULL in unit tests, etc.
   TabletMetrics* metrics() { return metrics_.get(); }
 
+  // Trackers of the most frequently read and written keys, at DocKey granularity. Reads are tracked
+  // by the key they look up, if any, i.e. the hashed part of the key for CQL and PGSQL requests
+  // that specify it.
+  const HotKeyTracker& hot_read_keys() const { return hot_read_keys_; }
+  const HotKeyTracker& hot_write_keys() const { return hot_write_keys_; }
+
+  // Decides whether the tablet should start serving a read or write request.
+  AdmissionController& admission_controller() { return *admission_controller_; }
+
   // Return handle to the metric entity of this tablet.
   const scoped_refptr<MetricEntity>& GetMetricEntity() const { return metric_entity_; }
 
@@ -429,6 +483,17 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   // Returns true if a RocksDB-backed tablet has any SSTables.
   Result<bool> HasSSTables() const;
 
+  // Returns the fraction of write requests, from 0 to 1, that the leader should reject to slow down
+  // writes while flushes and compactions fall behind. Grows linearly with the number of SST files,
+  // immutable memtables and pending compaction bytes between their soft and hard limits.
+  // Always 0 when adaptive write throttling is disabled.
+  double WriteThrottlingRatio();
+
+  // Opens table readers of all SST files of the regular DB, loading their top level index block and
+  // first data block into the block cache. Filter blocks are only read by point lookups, so they
+  // are not loaded.
+  CHECKED_STATUS PrewarmSstFiles();
+
   // Returns the maximum persistent op id from all SSTables in RocksDB.
   // First for regular records and second for intents.
   Result<DocDbOpIds> MaxPersistentOpId() const;
@@ -492,6 +557,24 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
       const google::protobuf::RepeatedPtrField<PgsqlReadRequestPB>& pgsql_batch,
       docdb::KeyValueWriteBatchPB* out);
 
+  // Whether the given non-transactional reads could be served at read_ht, without waiting for
+  // safe time. This is the case when the majority-replicated hybrid time leader lease covers
+  // read_ht, read_ht is not in the future, and no pending operation could write to the keys read,
+  // i.e. read_ht is safe for these keys even if it is not safe for the whole tablet.
+  //
+  // Only reads of single rows, i.e. with all hash key columns specified, are supported.
+  bool CanServeLeaseProtectedRead(
+      const google::protobuf::RepeatedPtrField<QLReadRequestPB>& ql_batch,
+      const google::protobuf::RepeatedPtrField<PgsqlReadRequestPB>& pgsql_batch,
+      HybridTime read_ht);
+
+  // Limits the uncertainty window of read_time by safe_time, the safe time of this tablet at the
+  // moment the read arrived, but not below the read time itself.
+  // Writes that were not applied at that moment are concurrent with the read, so they could not
+  // be observed by its client before the read started and do not require a read restart.
+  // safe_time should be lease protected, i.e. obtained with RequireLease::kTrue.
+  void LimitReadUncertainty(HybridTime safe_time, ReadHybridTime* read_time);
+
   // Returns last committed write index.
   // The main purpose of this method is to make correct log cleanup when tablet does not have
   // writes.
@@ -502,6 +585,14 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   uint64_t GetTotalSSTFileSizes() const;
   uint64_t GetUncompressedSSTFileSizes() const;
 
+  // Returns the total size of active memtables of the tablet DBs, i.e. memory that would be freed
+  // by a flush scheduled now.
+  uint64_t GetActiveMemTablesSize() const;
+
+  // Returns the total size of all memtables of the tablet DBs, including immutable memtables that
+  // are waiting to be flushed.
+  uint64_t GetAllMemTablesSize() const;
+
   void SetHybridTimeLeaseProvider(HybridTimeLeaseProvider provider) {
     ht_lease_provider_ = std::move(provider);
   }
@@ -672,6 +763,18 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
 
   std::unique_ptr<rocksdb::DB> intents_db_;
 
+  // Cache of decoded documents for hot point reads, nullptr if disabled.
+  std::unique_ptr<docdb::DocRowCache> row_cache_;
+
+  // Bounds of the keys that belong to this tablet, initialized for tablets produced by a split.
+  docdb::KeyBounds key_bounds_;
+
+  // Storage of large regular DB values, nullptr if values of this tablet are never separated.
+  std::shared_ptr<docdb::BlobStorage> blob_storage_;
+
+  // Range tombstones of the regular DB.
+  std::unique_ptr<docdb::RangeTombstones> range_tombstones_;
+
   std::unique_ptr<common::YQLStorageIf> ql_storage_;
 
   // This is for docdb fine-grained locking.
@@ -711,11 +814,33 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   boost::optional<client::TransactionManager> transaction_manager_;
   boost::optional<client::YBMetaDataCache> metadata_cache_;
 
+  // Session that batches non-transactional index writes across write operations, created on
+  // first use.
+  std::mutex index_writes_session_mutex_;
+  std::shared_ptr<client::CoalescingSession> index_writes_session_;
+
   // Created only if it is a unique index tablet.
   boost::optional<Schema> unique_index_key_schema_;
 
   std::atomic<int64_t> last_committed_write_index_{0};
 
+  // Write operations accumulated by the current apply group, accessed only by the thread that
+  // started the group (see ActiveApplyGroup).
+  struct ApplyGroup;
+  std::unique_ptr<ApplyGroup> apply_group_;
+
+  // Op indexes of transaction applies that have intents not applied yet. Regular DB memtables
+  // that contain writes of such applies are not flushed, so the apply would be replayed from the
+  // beginning after restart.
+  std::mutex pending_applies_mutex_;
+  std::multiset<int64_t> pending_applies_;
+  std::atomic<bool> flush_delayed_by_applies_{false};
+
+  // Last computed WriteThrottlingRatio and the time when it should be recomputed.
+  std::mutex write_throttling_mutex_;
+  std::atomic<double> write_throttling_ratio_{0};
+  CoarseTimePoint write_throttling_refresh_time_ GUARDED_BY(write_throttling_mutex_);
+
   // Remembers he HybridTime of the oldest write that is still not scheduled to
   // be flushed in RocksDB.
   std::shared_ptr<TabletFlushStats> flush_stats_;
@@ -726,17 +851,56 @@ class Tablet : public AbstractTablet, public TransactionIntentApplier {
   HybridTime DoGetSafeTime(
       RequireLease require_lease, HybridTime min_allowed, CoarseTimePoint deadline) const override;
 
+  // Index write ops and the write operations they update the indexes for.
+  using QLIndexOps =
+      std::vector<std::pair<std::shared_ptr<client::YBqlWriteOp>, docdb::QLWriteOperation*>>;
+
   void UpdateQLIndexes(std::unique_ptr<WriteOperation> operation);
+  // Applies the non-transactional index writes of operation through the coalescing session shared
+  // by the concurrent write operations of this tablet.
+  void ApplyCoalescedQLIndexWrites(
+      std::unique_ptr<WriteOperation> operation, client::YBClient* client, QLIndexOps index_ops);
   void CompleteQLWriteBatch(std::unique_ptr<WriteOperation> operation, const Status& status);
 
   Result<bool> IntentsDbFlushFilter(const rocksdb::MemTable& memtable);
 
+  // Sums the integer rocksdb property with the specified name over the tablet DBs.
+  uint64_t GetMemTablesSize(const std::string& property) const;
+
+  // Records sampled doc keys written by the write batch to hot_write_keys_.
+  void RecordHotWriteKeys(const docdb::KeyValueWriteBatchPB& put_batch);
+
+  // Records the doc key with the specified hash and hashed components, if they could be
+  // determined, to hot_read_keys_.
+  template <class Values>
+  void RecordHotReadKey(
+      const Schema& schema, uint32_t hash_code, const Values& hashed_column_values);
+
+  // Returns true if the regular DB memtable does not contain writes of incomplete applies.
+  bool PendingAppliesFlushFilter(const rocksdb::MemTable& memtable);
+
+  // Invoked when background apply of the transaction with apply operation at op_index is complete
+  // or stopped.
+  void PendingApplyFinished(int64_t op_index);
+
+  // Returns the apply group if it was started by the caller thread, nullptr otherwise.
+  ApplyGroup* ActiveApplyGroup() const;
+
+  // Writes changes accumulated by the apply group and runs deferred finalizers.
+  void WriteApplyGroup();
+
   std::function<rocksdb::MemTableFilter()> mem_table_flush_filter_factory_;
 
   client::LocalTabletFilter local_tablet_filter_;
 
   std::string log_prefix_suffix_;
 
+  HotKeyTracker hot_read_keys_;
+  HotKeyTracker hot_write_keys_;
+
+  // Shared with tickets of the admitted requests, that could outlive the tablet.
+  std::shared_ptr<AdmissionController> admission_controller_;
+
   DISALLOW_COPY_AND_ASSIGN(Tablet);
 };
 
@@ -38,11 +38,14 @@
 #include "yb/consensus/log_util.h"
 #include "yb/consensus/opid_util.h"
 #include "yb/consensus/consensus-test-util.h"
+#include "yb/consensus/retryable_requests.h"
+#include "yb/docdb/consensus_frontier.h"
 #include "yb/server/logical_clock.h"
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet_bootstrap_if.h"
 #include "yb/tablet/tablet-test-util.h"
 #include "yb/tablet/tablet_metadata.h"
+#include "yb/tablet/transaction_participant.h"
 #include "yb/util/tostring.h"
 #include "yb/tablet/tablet_options.h"
 
@@ -76,6 +79,60 @@ using server::Clock;
 using server::LogicalClock;
 using tserver::WriteRequestPB;
 
+// Participant context of a tablet that is only bootstrapped, so it never runs transactions.
+class BootstrapParticipantContext : public TransactionParticipantContext {
+ public:
+  BootstrapParticipantContext(std::string permanent_uuid, scoped_refptr<Clock> clock)
+      : permanent_uuid_(std::move(permanent_uuid)), clock_(std::move(clock)) {}
+
+  const std::string& permanent_uuid() const override {
+    return permanent_uuid_;
+  }
+
+  const std::string& tablet_id() const override {
+    return tablet_id_;
+  }
+
+  const std::shared_future<client::YBClient*>& client_future() const override {
+    return client_future_;
+  }
+
+  const server::ClockPtr& clock_ptr() const override {
+    return clock_;
+  }
+
+  bool Enqueue(rpc::ThreadPoolTask* task) override {
+    return false;
+  }
+
+  bool EnqueueTransactionApply(rpc::ThreadPoolTask* task) override {
+    return false;
+  }
+
+  HybridTime Now() override {
+    return clock_->Now();
+  }
+
+  void UpdateClock(HybridTime hybrid_time) override {
+    clock_->Update(hybrid_time);
+  }
+
+  bool IsLeader() override {
+    return false;
+  }
+
+  void SubmitUpdateTransaction(
+      std::unique_ptr<UpdateTxnOperationState> state, int64_t term) override {
+    LOG(FATAL) << "Unexpected transaction update during bootstrap";
+  }
+
+ private:
+  const std::string permanent_uuid_;
+  const std::string tablet_id_ = log::kTestTablet;
+  const std::shared_future<client::YBClient*> client_future_;
+  const server::ClockPtr clock_;
+};
+
 class BootstrapTest : public LogTestBase {
  protected:
 
@@ -87,6 +144,12 @@ class BootstrapTest : public LogTestBase {
 
   Status LoadTestRaftGroupMetadata(scoped_refptr<RaftGroupMetadata>* meta) {
     Schema schema = SchemaBuilder(schema_).Build();
+    if (transactional_) {
+      TableProperties table_properties = schema.table_properties();
+      table_properties.SetTransactional(true);
+      RETURN_NOT_OK(schema.Reset(
+          schema.columns(), schema.column_ids(), schema.num_key_columns(), table_properties));
+    }
     std::pair<PartitionSchema, Partition> partition = CreateDefaultPartition(schema);
 
     RETURN_NOT_OK(RaftGroupMetadata::LoadOrCreate(
@@ -130,10 +193,11 @@ class BootstrapTest : public LogTestBase {
         log_anchor_registry,
         tablet_options,
         std::string(), // log_prefix_suffix
-        nullptr, // transaction_participant_context
+        transaction_participant_context_,
         client::LocalTabletFilter(),
         nullptr, // transaction_coordinator_context
-        append_pool_.get()};
+        append_pool_.get(),
+        retryable_requests_};
     RETURN_NOT_OK(BootstrapTablet(data, tablet, &log_, boot_info));
     return Status::OK();
   }
@@ -170,6 +234,40 @@ class BootstrapTest : public LogTestBase {
       VLOG(1) << result;
     }
   }
+
+  // Creates a transactional test tablet, and writes a log of num_segments segments with
+  // ops_per_segment retryable writes each. Sets last_op_id to the id of the last operation.
+  void WriteRetryableRequestsLog(int num_segments, int ops_per_segment, OpId* last_op_id) {
+    transactional_ = true;
+    BuildLog();
+    OpId committed_op_id = MakeOpId(0, 0);
+    for (int i = 0; i != num_segments; ++i) {
+      for (int j = 0; j != ops_per_segment; ++j) {
+        const OpId op_id = MakeOpId(1, current_index_);
+        auto replicate = std::make_shared<ReplicateMsg>();
+        replicate->set_op_type(consensus::WRITE_OP);
+        replicate->mutable_id()->CopyFrom(op_id);
+        replicate->mutable_committed_op_id()->CopyFrom(committed_op_id);
+        replicate->set_hybrid_time(clock_->Now().ToUint64());
+        auto* write_request = replicate->mutable_write_request();
+        AddKVToPB(current_index_, 0, "insert", write_request->mutable_write_batch());
+        write_request->set_tablet_id(log::kTestTablet);
+        write_request->set_client_id1(1);
+        write_request->set_client_id2(1);
+        write_request->set_request_id(current_index_);
+        write_request->set_min_running_request_id(0);
+        AppendReplicateBatch(replicate);
+        committed_op_id = op_id;
+        ++current_index_;
+      }
+      ASSERT_OK(RollLog());
+    }
+    *last_op_id = committed_op_id;
+  }
+
+  bool transactional_ = false;
+  TransactionParticipantContext* transaction_participant_context_ = nullptr;
+  consensus::RetryableRequests* retryable_requests_ = nullptr;
 };
 
 // Tests a normal bootstrap scenario.
@@ -305,6 +403,96 @@ TEST_F(BootstrapTest, TestOperationOverwriting) {
             results[0]);
 }
 
+// Tests that segments with operations flushed to RocksDB are not replayed, while the tablet state
+// and the last operation of the log are still recovered.
+TEST_F(BootstrapTest, SkipFlushedSegments) {
+  constexpr int kNumSegments = 3;
+  constexpr int kOpsPerSegment = 3;
+
+  BuildLog();
+  OpId committed_op_id = MakeOpId(0, 0);
+  for (int i = 0; i != kNumSegments; ++i) {
+    for (int j = 0; j != kOpsPerSegment; ++j) {
+      const OpId op_id = MakeOpId(1, current_index_);
+      AppendReplicateBatch(op_id, committed_op_id, {TupleForAppend(current_index_, 0, "insert")});
+      committed_op_id = op_id;
+      ++current_index_;
+    }
+    ASSERT_OK(RollLog());
+  }
+  const OpId last_op_id = committed_op_id;
+
+  {
+    ConsensusBootstrapInfo boot_info;
+    shared_ptr<TabletClass> tablet;
+    ASSERT_OK(BootstrapTestTablet(&tablet, &boot_info));
+    ASSERT_OK(tablet->Flush(FlushMode::kSync));
+    ASSERT_OPID_EQ(last_op_id, boot_info.last_id);
+    tablet->Shutdown();
+    ASSERT_OK(log_->Close());
+  }
+
+  scoped_refptr<RaftGroupMetadata> meta;
+  ASSERT_OK(LoadTestRaftGroupMetadata(&meta));
+
+  // Last operation is not committed, so all segments but the last one are skipped.
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(RunBootstrapOnTestTablet(meta, &tablet, &boot_info));
+  ASSERT_OPID_EQ(last_op_id, boot_info.last_id);
+  ASSERT_EQ(1, boot_info.orphaned_replicates.size());
+  ASSERT_OPID_EQ(last_op_id, boot_info.orphaned_replicates[0]->id());
+
+  vector<string> results;
+  IterateTabletRows(tablet.get(), &results);
+  ASSERT_EQ(kNumSegments * kOpsPerSegment - 1, results.size());
+}
+
+// Tests that segments of a transactional tablet that hold operations with retryable requests, which
+// did not expire yet, are replayed even when they are flushed to both RocksDB instances.
+TEST_F(BootstrapTest, KeepRetryableRequestsOfTransactionalTablet) {
+  constexpr int kNumSegments = 3;
+  constexpr int kOpsPerSegment = 3;
+
+  BootstrapParticipantContext participant_context(
+      fs_manager_->uuid(), LogicalClock::CreateStartingAt(HybridTime::kInitial));
+  transaction_participant_context_ = &participant_context;
+  OpId last_op_id;
+  ASSERT_NO_FATALS(WriteRetryableRequestsLog(kNumSegments, kOpsPerSegment, &last_op_id));
+
+  {
+    ConsensusBootstrapInfo boot_info;
+    shared_ptr<TabletClass> tablet;
+    ASSERT_OK(BootstrapTestTablet(&tablet, &boot_info));
+    ASSERT_NE(nullptr, tablet->transaction_participant());
+    ASSERT_OK(tablet->Flush(FlushMode::kSync));
+    // Nothing is written to the intents DB, so make its flushed frontier match the regular one.
+    auto frontier = tablet->TEST_db()->GetFlushedFrontier();
+    ASSERT_TRUE(frontier);
+    ASSERT_OK(tablet->ModifyFlushedFrontier(
+        down_cast<docdb::ConsensusFrontier&>(*frontier),
+        rocksdb::FrontierModificationMode::kUpdate));
+    ASSERT_OK(tablet->Flush(FlushMode::kSync));
+    ASSERT_OPID_EQ(last_op_id, boot_info.last_id);
+    tablet->Shutdown();
+    ASSERT_OK(log_->Close());
+  }
+
+  scoped_refptr<RaftGroupMetadata> meta;
+  ASSERT_OK(LoadTestRaftGroupMetadata(&meta));
+
+  consensus::RetryableRequests retryable_requests;
+  retryable_requests_ = &retryable_requests;
+  ConsensusBootstrapInfo boot_info;
+  shared_ptr<TabletClass> tablet;
+  ASSERT_OK(RunBootstrapOnTestTablet(meta, &tablet, &boot_info));
+  ASSERT_OPID_EQ(last_op_id, boot_info.last_id);
+
+  // All committed requests are restored, including the ones in segments flushed to RocksDB.
+  ASSERT_EQ(kNumSegments * kOpsPerSegment - 1, retryable_requests.TEST_Counts().replicated);
+  tablet->Shutdown();
+}
+
 // Test that we do not crash when a consensus-only operation has a hybrid_time that is higher than a
 // hybrid_time assigned to a write operation that follows it in the log.
 // TODO: this must not happen in YB. Ensure this is not happening and update the test.
@@ -31,10 +31,14 @@
 //
 #include "yb/tablet/tablet_bootstrap.h"
 
+#include <future>
+#include <limits>
+
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/log_reader.h"
 #include "yb/consensus/retryable_requests.h"
+#include "yb/gutil/walltime.h"
 
 #include "yb/server/hybrid_clock.h"
 #include "yb/tablet/tablet.h"
@@ -68,6 +72,7 @@ DEFINE_test_flag(double, fault_crash_during_log_replay, 0.0,
                  "after processing a log entry during log replay.");
 
 DECLARE_uint64(max_clock_sync_error_usec);
+DECLARE_int32(retryable_request_timeout_secs);
 
 DEFINE_bool(force_recover_flushed_frontier, false,
             "Could be used to ignore the flushed frontier metadata from RocksDB manifest and "
@@ -75,6 +80,16 @@ DEFINE_bool(force_recover_flushed_frontier, false,
 TAG_FLAG(force_recover_flushed_frontier, hidden);
 TAG_FLAG(force_recover_flushed_frontier, advanced);
 
+DEFINE_bool(skip_flushed_log_segments_during_bootstrap, true,
+            "Do not read closed WAL segments whose operations were all flushed to RocksDB during "
+            "bootstrap. Only takes effect when WAL files are not rewritten during bootstrap.");
+TAG_FLAG(skip_flushed_log_segments_during_bootstrap, advanced);
+
+DEFINE_bool(read_ahead_log_segments_during_bootstrap, true,
+            "Read and decode the next WAL segment on a separate thread, while the current one is "
+            "being replayed during bootstrap.");
+TAG_FLAG(read_ahead_log_segments_during_bootstrap, advanced);
+
 namespace yb {
 namespace tablet {
 
@@ -292,6 +307,30 @@ bool ReplayState::CanApply(LogEntryPB* entry) {
   return consensus::OpIdCompare(entry->replicate().id(), committed_op_id) <= 0;
 }
 
+// Returns the number of leading segments that do not have to be read during bootstrap, because all
+// their operations have index not greater than flushed_index, and they were closed before
+// max_close_time_micros.
+//
+// A segment is skipped only when the following segment is closed and contains operations, so
+// the last operation of the log, that is used to initialize consensus, is always replayed.
+static size_t NumFlushedSegments(
+    const log::SegmentSequence& segments, int64_t flushed_index, int64_t max_close_time_micros) {
+  size_t result = 0;
+  while (result + 1 < segments.size()) {
+    const auto& segment = *segments[result];
+    const auto& next_segment = *segments[result + 1];
+    if (!segment.HasFooter() || !segment.footer().has_max_replicate_index() ||
+        segment.footer().max_replicate_index() > flushed_index ||
+        segment.footer().close_timestamp_micros() > max_close_time_micros ||
+        !next_segment.HasFooter() || !next_segment.footer().has_max_replicate_index() ||
+        next_segment.footer().max_replicate_index() < 0) {
+      break;
+    }
+    ++result;
+  }
+  return result;
+}
+
 // ============================================================================
 //  Class TabletBootstrap.
 // ============================================================================
@@ -551,6 +590,7 @@ Status TabletBootstrap::RemoveRecoveryDir() {
 Status TabletBootstrap::OpenNewLog() {
   auto log_options = LogOptions();
   log_options.env = GetEnv();
+  log_options.io_scheduler = tablet_options_.wal_io_scheduler;
   RETURN_NOT_OK(Log::Open(log_options,
                           tablet_->tablet_id(),
                           tablet_->metadata()->wal_dir(),
@@ -844,42 +884,62 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   // old log.
   RETURN_NOT_OK_PREPEND(OpenNewLog(), "Failed to open new log");
 
-  int segment_count = 0;
-  yb::OpId last_committed_op_id;
-  RestartSafeCoarseTimePoint last_entry_time;
-  for (const scoped_refptr<ReadableLogSegment>& segment : segments) {
-    auto read_result = segment->ReadEntries();
-    last_committed_op_id = std::max(last_committed_op_id, read_result.committed_op_id);
-    for (int entry_idx = 0; entry_idx < read_result.entries.size(); ++entry_idx) {
-      Status s = HandleEntry(
-          read_result.entry_metadata[entry_idx], &state, &read_result.entries[entry_idx]);
-      if (!s.ok()) {
-        LOG(INFO) << "Dumping replay state to log";
-        DumpReplayStateToLog(state);
-        RETURN_NOT_OK_PREPEND(s, DebugInfo(tablet_->tablet_id(),
-                                           segment->header().sequence_number(),
-                                           entry_idx, segment->path(),
-                                           *read_result.entries[entry_idx]));
-      }
+  size_t first_segment = 0;
+  if (skip_wal_rewrite_ && FLAGS_skip_flushed_log_segments_during_bootstrap) {
+    auto flushed_index = state.regular_stored_op_id.index();
+    auto max_close_time_micros = std::numeric_limits<int64_t>::max();
+    if (tablet_->transaction_participant()) {
+      // Operations that were not flushed to the intents DB are replayed as well.
+      flushed_index = std::min(flushed_index, state.intents_stored_op_id.index());
     }
-    if (!read_result.entry_metadata.empty()) {
-      last_entry_time = read_result.entry_metadata.back().entry_time;
+    if (data_.retryable_requests) {
+      // Flushed operations are replayed to restore retryable requests, so only segments that were
+      // closed before requests expired could be skipped.
+      max_close_time_micros =
+          GetCurrentTimeMicros() - FLAGS_retryable_request_timeout_secs * 1000000LL;
     }
+    first_segment = NumFlushedSegments(segments, flushed_index, max_close_time_micros);
+    if (first_segment != 0) {
+      const auto& skipped_footer = segments[first_segment - 1]->footer();
+      LOG_WITH_PREFIX(INFO)
+          << "Skipping " << first_segment << " log segments with operations up to "
+          << skipped_footer.max_replicate_index() << " flushed to RocksDB";
+      // The entry with the index of the last flushed regular operation would raise the committed
+      // op id to at least that op id, see HandleReplicateMessage.
+      if (state.regular_stored_op_id.index() <= skipped_footer.max_replicate_index()) {
+        state.UpdateCommittedOpId(state.regular_stored_op_id);
+      }
+    }
+  }
+
+  // Decoding the next segment overlaps with replaying the current one.
+  const bool read_ahead = FLAGS_read_ahead_log_segments_during_bootstrap;
+  auto read_segment = [&segments](size_t idx) {
+    return std::async(std::launch::async, [segment = segments[idx]] {
+      return segment->ReadEntries();
+    });
+  };
+  std::future<log::ReadEntriesResult> next_read_result;
+  if (read_ahead && first_segment < segments.size()) {
+    next_read_result = read_segment(first_segment);
+  }
 
-    // If the LogReader failed to read for some reason, we'll still try to replay as many entries as
-    // possible, and then fail with Corruption.
-    // TODO: this is sort of scary -- why doesn't LogReader expose an entry-by-entry iterator-like
-    // API instead? Seems better to avoid exposing the idea of segments to callers.
-    if (PREDICT_FALSE(!read_result.status.ok())) {
-      return STATUS_FORMAT(Corruption,
-                           "Error reading Log Segment of tablet $0: $1 "
-                               "(Read up to entry $2 of segment $3, in path $4)",
-                           tablet_->tablet_id(),
-                           read_result.status,
-                           read_result.entries.size(),
-                           segment->header().sequence_number(),
-                           segment->path());
+  int segment_count = first_segment;
+  yb::OpId last_committed_op_id;
+  RestartSafeCoarseTimePoint last_entry_time;
+  for (size_t segment_idx = first_segment; segment_idx != segments.size(); ++segment_idx) {
+    const auto& segment = segments[segment_idx];
+    log::ReadEntriesResult read_result;
+    if (read_ahead) {
+      read_result = next_read_result.get();
+      if (segment_idx + 1 != segments.size()) {
+        next_read_result = read_segment(segment_idx + 1);
+      }
+    } else {
+      read_result = segment->ReadEntries();
     }
+    RETURN_NOT_OK(PlaySegment(
+        segment, &read_result, &state, &last_committed_op_id, &last_entry_time));
 
     // TODO: could be more granular here and log during the segments as well, plus give info about
     // number of MB processed, but this is better than nothing.
@@ -891,6 +951,17 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
     segment_count++;
   }
 
+  if (first_segment != 0 && OpIdEquals(state.prev_op_id, MinimumOpId())) {
+    // Footers of the following segments claimed they contain operations, but none was found.
+    // Replay the skipped segments, so the last operation of the log is known.
+    LOG_WITH_PREFIX(WARNING) << "No operations found after skipped log segments, replaying them";
+    for (size_t segment_idx = 0; segment_idx != first_segment; ++segment_idx) {
+      auto read_result = segments[segment_idx]->ReadEntries();
+      RETURN_NOT_OK(PlaySegment(
+          segments[segment_idx], &read_result, &state, &last_committed_op_id, &last_entry_time));
+    }
+  }
+
   if (state.UpdateCommittedFromStored()) {
     state.ApplyCommittedPendingReplicates(
         std::bind(&TabletBootstrap::HandleEntryPair, this, &state, _1, _2));
@@ -947,6 +1018,45 @@ Status TabletBootstrap::PlaySegments(ConsensusBootstrapInfo* consensus_info) {
   return Status::OK();
 }
 
+Status TabletBootstrap::PlaySegment(
+    const scoped_refptr<ReadableLogSegment>& segment, log::ReadEntriesResult* read_result,
+    ReplayState* state, yb::OpId* last_committed_op_id,
+    RestartSafeCoarseTimePoint* last_entry_time) {
+  *last_committed_op_id = std::max(*last_committed_op_id, read_result->committed_op_id);
+  for (int entry_idx = 0; entry_idx < read_result->entries.size(); ++entry_idx) {
+    Status s = HandleEntry(
+        read_result->entry_metadata[entry_idx], state, &read_result->entries[entry_idx]);
+    if (!s.ok()) {
+      LOG(INFO) << "Dumping replay state to log";
+      DumpReplayStateToLog(*state);
+      RETURN_NOT_OK_PREPEND(s, DebugInfo(tablet_->tablet_id(),
+                                         segment->header().sequence_number(),
+                                         entry_idx, segment->path(),
+                                         *read_result->entries[entry_idx]));
+    }
+  }
+  if (!read_result->entry_metadata.empty()) {
+    *last_entry_time = read_result->entry_metadata.back().entry_time;
+  }
+
+  // If the LogReader failed to read for some reason, we'll still try to replay as many entries as
+  // possible, and then fail with Corruption.
+  // TODO: this is sort of scary -- why doesn't LogReader expose an entry-by-entry iterator-like
+  // API instead? Seems better to avoid exposing the idea of segments to callers.
+  if (PREDICT_FALSE(!read_result->status.ok())) {
+    return STATUS_FORMAT(Corruption,
+                         "Error reading Log Segment of tablet $0: $1 "
+                             "(Read up to entry $2 of segment $3, in path $4)",
+                         tablet_->tablet_id(),
+                         read_result->status,
+                         read_result->entries.size(),
+                         segment->header().sequence_number(),
+                         segment->path());
+  }
+
+  return Status::OK();
+}
+
 void TabletBootstrap::PlayWriteRequest(ReplicateMsg* replicate_msg) {
   DCHECK(replicate_msg->has_hybrid_time());
 
@@ -111,6 +111,12 @@ class TabletBootstrap {
   // accepting writes from clients.
   CHECKED_STATUS PlaySegments(consensus::ConsensusBootstrapInfo* results);
 
+  // Replays entries read from the specified segment.
+  CHECKED_STATUS PlaySegment(
+      const scoped_refptr<log::ReadableLogSegment>& segment, log::ReadEntriesResult* read_result,
+      ReplayState* state, yb::OpId* last_committed_op_id,
+      RestartSafeCoarseTimePoint* last_entry_time);
+
   void PlayWriteRequest(consensus::ReplicateMsg* replicate_msg);
 
   CHECKED_STATUS PlayUpdateTransactionRequest(
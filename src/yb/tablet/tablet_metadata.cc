@@ -186,12 +186,20 @@ Status KvStoreInfo::LoadTablesFromPB(
 Status KvStoreInfo::LoadFromPB(const KvStoreInfoPB& pb, TableId primary_table_id) {
   kv_store_id = KvStoreId(pb.kv_store_id());
   rocksdb_dir = pb.rocksdb_dir();
+  lower_bound_key = pb.lower_bound_key();
+  upper_bound_key = pb.upper_bound_key();
   return LoadTablesFromPB(pb.tables(), primary_table_id);
 }
 
 void KvStoreInfo::ToPB(TableId primary_table_id, KvStoreInfoPB* pb) const {
   pb->set_kv_store_id(kv_store_id.ToString());
   pb->set_rocksdb_dir(rocksdb_dir);
+  if (!lower_bound_key.empty()) {
+    pb->set_lower_bound_key(lower_bound_key);
+  }
+  if (!upper_bound_key.empty()) {
+    pb->set_upper_bound_key(upper_bound_key);
+  }
 
   // Putting primary table first, then all other tables.
   const auto& it = tables.find(primary_table_id);
@@ -309,6 +317,38 @@ Status RaftGroupMetadata::LoadOrCreate(FsManager* fs_manager,
   }
 }
 
+Result<scoped_refptr<RaftGroupMetadata>> RaftGroupMetadata::CreateSubtabletMetadata(
+    const RaftGroupId& raft_group_id, const Partition& partition,
+    const std::string& lower_bound_key, const std::string& upper_bound_key) const {
+  if (fs_manager_->env()->FileExists(fs_manager_->GetRaftGroupMetadataPath(raft_group_id))) {
+    return STATUS(AlreadyPresent, "Raft group already exists", raft_group_id);
+  }
+
+  RaftGroupReplicaSuperBlockPB superblock;
+  ToSuperBlock(&superblock);
+
+  const auto tablet_dir = Substitute("tablet-$0", raft_group_id);
+  superblock.set_raft_group_id(raft_group_id);
+  partition.ToPB(superblock.mutable_partition());
+  superblock.set_wal_dir(JoinPathSegments(DirName(wal_dir_), tablet_dir));
+  superblock.set_tablet_data_state(TabletDataState::TABLET_DATA_READY);
+  superblock.clear_tombstone_last_logged_opid();
+
+  auto* kv_store = superblock.mutable_kv_store();
+  kv_store->set_kv_store_id(raft_group_id);
+  kv_store->set_rocksdb_dir(JoinPathSegments(DirName(rocksdb_dir()), tablet_dir));
+  kv_store->clear_rocksdb_files();
+  kv_store->clear_snapshot_files();
+  kv_store->set_lower_bound_key(lower_bound_key);
+  kv_store->set_upper_bound_key(upper_bound_key);
+
+  scoped_refptr<RaftGroupMetadata> result(new RaftGroupMetadata(fs_manager_, raft_group_id));
+  RETURN_NOT_OK(result->LoadFromSuperBlock(superblock));
+  result->state_ = kInitialized;
+  RETURN_NOT_OK(result->Flush());
+  return result;
+}
+
 template <class TablesMap>
 CHECKED_STATUS MakeTableNotFound(const TableId& table_id, const RaftGroupId& raft_group_id,
                                  const TablesMap& tables) {
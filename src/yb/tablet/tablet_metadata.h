@@ -134,6 +134,11 @@ struct KvStoreInfo {
   // `rocksdb_dir + kIntentsDBSuffix` path.
   std::string rocksdb_dir;
 
+  // Encoded bounds of the keys that belong to this KV-store: [lower_bound_key, upper_bound_key).
+  // Empty bound means no limit from that side.
+  std::string lower_bound_key;
+  std::string upper_bound_key;
+
   // Map of tables sharing this KV-store indexed by the table id.
   // If pieces of the same table live in the same Raft group they should be located in different
   // KV-stores.
@@ -181,6 +186,13 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata> {
                                   const std::string& data_root_dir = std::string(),
                                   const std::string& wal_root_dir = std::string());
 
+  // Create metadata for a Raft group produced by splitting this Raft group. It shares the tables
+  // of this Raft group, has the specified partition and key bounds, and its data and WAL
+  // directories are located next to the directories of this Raft group.
+  Result<scoped_refptr<RaftGroupMetadata>> CreateSubtabletMetadata(
+      const RaftGroupId& raft_group_id, const Partition& partition,
+      const std::string& lower_bound_key, const std::string& upper_bound_key) const;
+
   // Load existing metadata from disk.
   static CHECKED_STATUS Load(FsManager* fs_manager,
                              const RaftGroupId& raft_group_id,
@@ -289,6 +301,10 @@ class RaftGroupMetadata : public RefCountedThreadSafe<RaftGroupMetadata> {
 
   std::string rocksdb_dir() const { return kv_store_.rocksdb_dir; }
 
+  std::string lower_bound_key() const { return kv_store_.lower_bound_key; }
+
+  std::string upper_bound_key() const { return kv_store_.upper_bound_key; }
+
   std::string wal_dir() const { return wal_dir_; }
 
   // Returns the data root dir for this Raft group, for example:
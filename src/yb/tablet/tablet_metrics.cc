@@ -74,6 +74,16 @@ METRIC_DEFINE_histogram(
     tablet, write_lock_latency, "Write lock latency", yb::MetricUnit::kMicroseconds,
     "Time taken to acquire key locks for a write operation", 60000000LU, 2);
 
+METRIC_DEFINE_histogram(
+    tablet, read_queue_time, "Read queue time", yb::MetricUnit::kMicroseconds,
+    "Time read requests to this tablet spent in the RPC queue before being handled",
+    60000000LU, 2);
+
+METRIC_DEFINE_histogram(
+    tablet, write_queue_time, "Write queue time", yb::MetricUnit::kMicroseconds,
+    "Time write requests to this tablet spent in the RPC queue before being handled",
+    60000000LU, 2);
+
 METRIC_DEFINE_gauge_uint32(tablet, compact_rs_running,
   "RowSet Compactions Running",
   yb::MetricUnit::kMaintenanceOperations,
@@ -114,6 +124,22 @@ METRIC_DEFINE_counter(tablet, leader_memory_pressure_rejections,
   yb::MetricUnit::kRequests,
   "Number of RPC requests rejected due to memory pressure while LEADER.");
 
+METRIC_DEFINE_counter(tablet, write_throttling_rejections,
+  "Write Throttling Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of write requests rejected by adaptive write throttling while LEADER.");
+
+METRIC_DEFINE_counter(tablet, admission_deadline_rejections,
+  "Admission Deadline Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of requests rejected because their remaining deadline could not cover the service "
+  "time of the tablet.");
+
+METRIC_DEFINE_counter(tablet, admission_overload_rejections,
+  "Admission Overload Rejections",
+  yb::MetricUnit::kRequests,
+  "Number of requests rejected because too many requests were in flight for the tablet.");
+
 METRIC_DEFINE_counter(tablet, transaction_conflicts,
   "Distributed Transaction Conflicts",
   yb::MetricUnit::kRequests,
@@ -129,6 +155,69 @@ METRIC_DEFINE_counter(tablet, restart_read_requests,
   yb::MetricUnit::kRequests,
   "Number of read requests that require restart.");
 
+METRIC_DEFINE_counter(tablet, narrowed_read_uncertainty_windows,
+  "Narrowed Read Uncertainty Windows",
+  yb::MetricUnit::kRequests,
+  "Number of reads, whose uncertainty window was limited by the tablet safe time. Each of them "
+  "avoids restarts caused by writes, that were concurrent with the read.");
+
+METRIC_DEFINE_counter(tablet, docdb_block_reads,
+  "DocDB Block Reads",
+  yb::MetricUnit::kBlocks,
+  "Number of SST blocks read from disk by reads.");
+
+METRIC_DEFINE_counter(tablet, docdb_block_cache_hits,
+  "DocDB Block Cache Hits",
+  yb::MetricUnit::kBlocks,
+  "Number of SST blocks found in the block cache by reads.");
+
+METRIC_DEFINE_counter(tablet, docdb_bytes_read,
+  "DocDB Bytes Read",
+  yb::MetricUnit::kBytes,
+  "Number of bytes of SST blocks read from disk by reads.");
+
+METRIC_DEFINE_counter(tablet, docdb_bloom_hits,
+  "DocDB Bloom Filter Hits",
+  yb::MetricUnit::kProbes,
+  "Number of SST bloom filter checks by reads, that did not filter out the file.");
+
+METRIC_DEFINE_counter(tablet, docdb_bloom_misses,
+  "DocDB Bloom Filter Misses",
+  yb::MetricUnit::kProbes,
+  "Number of SST bloom filter checks by reads, that filtered out the file.");
+
+METRIC_DEFINE_counter(tablet, docdb_memtable_seeks,
+  "DocDB Memtable Seeks",
+  yb::MetricUnit::kOperations,
+  "Number of memtable seeks done by reads.");
+
+METRIC_DEFINE_counter(tablet, docdb_seeks,
+  "DocDB Seeks",
+  yb::MetricUnit::kOperations,
+  "Number of RocksDB iterator seeks done by reads, in both regular and intents DBs.");
+
+METRIC_DEFINE_counter(tablet, docdb_nexts,
+  "DocDB Nexts",
+  yb::MetricUnit::kOperations,
+  "Number of RocksDB iterator nexts done by reads.");
+
+METRIC_DEFINE_counter(tablet, docdb_intent_seeks,
+  "DocDB Intent Seeks",
+  yb::MetricUnit::kOperations,
+  "Number of intents DB iterator seeks done by reads.");
+
+METRIC_DEFINE_counter(tablet, lease_protected_reads,
+  "Lease Protected Read Requests",
+  yb::MetricUnit::kRequests,
+  "Number of strongly consistent read requests served under the leader lease without waiting "
+  "for safe time.");
+
+METRIC_DEFINE_counter(tablet, safe_time_reads,
+  "Safe Time Read Requests",
+  yb::MetricUnit::kRequests,
+  "Number of strongly consistent read requests served at safe time, while lease protected reads "
+  "are enabled.");
+
 using strings::Substitute;
 
 namespace yb {
@@ -140,12 +229,29 @@ TabletMetrics::TabletMetrics(const scoped_refptr<MetricEntity>& entity)
     MINIT(redis_read_latency),
     MINIT(ql_read_latency),
     MINIT(write_lock_latency),
+    MINIT(read_queue_time),
+    MINIT(write_queue_time),
     MINIT(write_op_duration_client_propagated_consistency),
     MINIT(not_leader_rejections),
     MINIT(leader_memory_pressure_rejections),
+    MINIT(write_throttling_rejections),
+    MINIT(admission_deadline_rejections),
+    MINIT(admission_overload_rejections),
     MINIT(transaction_conflicts),
     MINIT(expired_transactions),
-    MINIT(restart_read_requests) {
+    MINIT(restart_read_requests),
+    MINIT(narrowed_read_uncertainty_windows),
+    MINIT(lease_protected_reads),
+    MINIT(docdb_block_reads),
+    MINIT(docdb_block_cache_hits),
+    MINIT(docdb_bytes_read),
+    MINIT(docdb_bloom_hits),
+    MINIT(docdb_bloom_misses),
+    MINIT(docdb_memtable_seeks),
+    MINIT(docdb_seeks),
+    MINIT(docdb_nexts),
+    MINIT(docdb_intent_seeks),
+    MINIT(safe_time_reads) {
 }
 #undef MINIT
 
@@ -155,5 +261,22 @@ ScopedTabletMetricsTracker::ScopedTabletMetricsTracker(scoped_refptr<Histogram>
 ScopedTabletMetricsTracker::~ScopedTabletMetricsTracker() {
   latency_->Increment(MonoTime::Now().GetDeltaSince(start_time_).ToMicroseconds());
 }
+
+ScopedStorageProfileTracker::ScopedStorageProfileTracker(TabletMetrics* metrics)
+    : metrics_(metrics) {}
+
+ScopedStorageProfileTracker::~ScopedStorageProfileTracker() {
+  const auto profile = profile_.Finish();
+  metrics_->docdb_block_reads->IncrementBy(profile.block_reads);
+  metrics_->docdb_block_cache_hits->IncrementBy(profile.block_cache_hits);
+  metrics_->docdb_bytes_read->IncrementBy(profile.bytes_read);
+  metrics_->docdb_bloom_hits->IncrementBy(profile.bloom_hits);
+  metrics_->docdb_bloom_misses->IncrementBy(profile.bloom_misses);
+  metrics_->docdb_memtable_seeks->IncrementBy(profile.memtable_seeks);
+  metrics_->docdb_seeks->IncrementBy(profile.seeks);
+  metrics_->docdb_nexts->IncrementBy(profile.nexts);
+  metrics_->docdb_intent_seeks->IncrementBy(profile.intent_seeks);
+  TRACE("Storage profile: $0", profile.ToString());
+}
 } // namespace tablet
 } // namespace yb
@@ -32,6 +32,8 @@
 #ifndef YB_TABLET_TABLET_METRICS_H
 #define YB_TABLET_TABLET_METRICS_H
 
+#include "yb/docdb/storage_profile.h"
+
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
 
@@ -57,14 +59,31 @@ struct TabletMetrics {
   scoped_refptr<Histogram> redis_read_latency;
   scoped_refptr<Histogram> ql_read_latency;
   scoped_refptr<Histogram> write_lock_latency;
+  scoped_refptr<Histogram> read_queue_time;
+  scoped_refptr<Histogram> write_queue_time;
   scoped_refptr<Histogram> write_op_duration_client_propagated_consistency;
   scoped_refptr<Histogram> write_op_duration_commit_wait_consistency;
 
   scoped_refptr<Counter> not_leader_rejections;
   scoped_refptr<Counter> leader_memory_pressure_rejections;
+  scoped_refptr<Counter> write_throttling_rejections;
+  scoped_refptr<Counter> admission_deadline_rejections;
+  scoped_refptr<Counter> admission_overload_rejections;
   scoped_refptr<Counter> transaction_conflicts;
   scoped_refptr<Counter> expired_transactions;
   scoped_refptr<Counter> restart_read_requests;
+  scoped_refptr<Counter> narrowed_read_uncertainty_windows;
+  scoped_refptr<Counter> lease_protected_reads;
+  scoped_refptr<Counter> docdb_block_reads;
+  scoped_refptr<Counter> docdb_block_cache_hits;
+  scoped_refptr<Counter> docdb_bytes_read;
+  scoped_refptr<Counter> docdb_bloom_hits;
+  scoped_refptr<Counter> docdb_bloom_misses;
+  scoped_refptr<Counter> docdb_memtable_seeks;
+  scoped_refptr<Counter> docdb_seeks;
+  scoped_refptr<Counter> docdb_nexts;
+  scoped_refptr<Counter> docdb_intent_seeks;
+  scoped_refptr<Counter> safe_time_reads;
 };
 
 class ScopedTabletMetricsTracker {
@@ -77,6 +96,18 @@ class ScopedTabletMetricsTracker {
   MonoTime start_time_;
 };
 
+// Collects the storage profile of a read served by the current thread. On destruction adds it to
+// the tablet metrics and to the trace of the request, so it is shown in slow query logs.
+class ScopedStorageProfileTracker {
+ public:
+  explicit ScopedStorageProfileTracker(TabletMetrics* metrics);
+  ~ScopedStorageProfileTracker();
+
+ private:
+  TabletMetrics* metrics_;
+  docdb::ScopedStorageProfile profile_;
+};
+
 } // namespace tablet
 } // namespace yb
 #endif /* YB_TABLET_TABLET_METRICS_H */
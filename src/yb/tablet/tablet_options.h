@@ -24,18 +24,34 @@ class Cache;
 class EventListener;
 class MemoryMonitor;
 class Env;
+class PersistentBlockCache;
+class RateLimiter;
 }
 
 namespace yb {
 class Env;
+class IoScheduler;
+class MemTracker;
+class PriorityThreadPool;
 namespace tablet {
 
 struct TabletOptions {
   std::shared_ptr<rocksdb::Cache> block_cache;
+  // Second-tier cache for blocks evicted from block_cache, when not null.
+  std::shared_ptr<rocksdb::PersistentBlockCache> persistent_block_cache;
+  // Cache of compressed blocks consulted on block_cache misses, when not null.
+  std::shared_ptr<rocksdb::Cache> block_cache_compressed;
+  std::shared_ptr<MemTracker> block_cache_compressed_mem_tracker;
   std::shared_ptr<rocksdb::MemoryMonitor> memory_monitor;
   std::vector<std::shared_ptr<rocksdb::EventListener>> listeners;
   yb::Env* env = Env::Default();
   rocksdb::Env* rocksdb_env = rocksdb::Env::Default();
+  // Shared by all tablets, when not null.
+  std::shared_ptr<rocksdb::RateLimiter> rate_limiter;
+  // Scheduler of the disk of the WALs, when not null.
+  std::shared_ptr<IoScheduler> wal_io_scheduler;
+  // Thread pool for compactions of all tablets, not owned.
+  PriorityThreadPool* priority_thread_pool_for_compactions = nullptr;
 };
 
 } // namespace tablet
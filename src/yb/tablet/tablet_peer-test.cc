@@ -67,6 +67,8 @@ METRIC_DECLARE_entity(tablet);
 DECLARE_int32(log_min_seconds_to_retain);
 
 DECLARE_bool(quick_leader_election_on_create);
+DECLARE_bool(enable_write_coalescing);
+DECLARE_int32(delay_prepare_task_ms);
 
 namespace yb {
 namespace tablet {
@@ -114,6 +116,7 @@ class TabletPeerTest : public YBTabletTest,
 
     ASSERT_OK(ThreadPoolBuilder("raft").Build(&raft_pool_));
     ASSERT_OK(ThreadPoolBuilder("prepare").Build(&tablet_prepare_pool_));
+    ASSERT_OK(ThreadPoolBuilder("apply").Build(&apply_pool_));
 
     rpc::MessengerBuilder builder(CURRENT_TEST_NAME());
     messenger_ = ASSERT_RESULT(builder.Build());
@@ -176,6 +179,8 @@ class TabletPeerTest : public YBTabletTest,
                                            metric_entity_,
                                            raft_pool_.get(),
                                            tablet_prepare_pool_.get(),
+                                           apply_pool_.get(),
+                                           nullptr /* txn_apply_pool */,
                                            nullptr /* retryable_requests */));
   }
 
@@ -291,6 +296,7 @@ class TabletPeerTest : public YBTabletTest,
   std::unique_ptr<rpc::ProxyCache> proxy_cache_;
   std::unique_ptr<ThreadPool> raft_pool_;
   std::unique_ptr<ThreadPool> tablet_prepare_pool_;
+  std::unique_ptr<ThreadPool> apply_pool_;
   std::unique_ptr<ThreadPool> append_pool_;
   std::shared_ptr<TabletPeer> tablet_peer_;
   TableType table_type_;
@@ -457,6 +463,44 @@ TEST_P(TabletPeerTest, TestActiveOperationPreventsLogGC) {
   ASSERT_EQ(5, segments.size());
 }
 
+// Ensure that concurrent writes are applied and completed when they are coalesced into fewer Raft
+// operations.
+TEST_P(TabletPeerTest, CoalescedWrites) {
+  FLAGS_enable_write_coalescing = true;
+  // Writes are queued while the prepare task is delayed, so they are prepared in batches.
+  FLAGS_delay_prepare_task_ms = 100;
+  ConsensusBootstrapInfo info;
+  ASSERT_OK(StartPeer(info));
+
+  constexpr int kNumWrites = 100;
+  const auto initial_index = tablet_peer_->log()->GetLatestEntryOpId().index;
+  std::vector<WriteRequestPB> requests(kNumWrites);
+  std::vector<WriteResponsePB> responses(kNumWrites);
+  CountDownLatch latch(kNumWrites);
+  for (int i = 0; i != kNumWrites; ++i) {
+    GenerateSequentialInsertRequest(&requests[i]);
+    auto operation_state = std::make_unique<WriteOperationState>(
+        tablet_peer_->tablet(), &requests[i], &responses[i]);
+    operation_state->set_completion_callback(
+        std::make_unique<LatchWriteCallback>(&latch, &responses[i]));
+    tablet_peer_->WriteAsync(std::move(operation_state), 1, CoarseTimePoint::max());
+  }
+  latch.Wait();
+
+  for (const auto& response : responses) {
+    ASSERT_FALSE(response.has_error()) << response.ShortDebugString();
+  }
+  const auto num_operations = tablet_peer_->log()->GetLatestEntryOpId().index - initial_index;
+  LOG(INFO) << kNumWrites << " writes were replicated in " << num_operations << " operations";
+  ASSERT_LT(num_operations, kNumWrites);
+
+  auto iter = tablet()->NewRowIterator(client_schema_, boost::none);
+  ASSERT_OK(iter);
+  std::vector<std::string> rows;
+  ASSERT_OK(IterateToStringList(iter->get(), &rows));
+  ASSERT_EQ(kNumWrites, rows.size());
+}
+
 TEST_P(TabletPeerTest, TestGCEmptyLog) {
   ConsensusBootstrapInfo info;
   ASSERT_OK(tablet_peer_->Start(info));
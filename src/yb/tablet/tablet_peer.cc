@@ -88,6 +88,11 @@ using namespace std::placeholders;
 using std::shared_ptr;
 using std::string;
 
+DEFINE_bool(async_operation_completion, true,
+            "Whether applied write operations are completed, i.e. responded to, on the apply pool "
+            "instead of the thread applying the operations of the tablet.");
+TAG_FLAG(async_operation_completion, advanced);
+
 DEFINE_test_flag(int32, delay_init_tablet_peer_ms, 0,
                  "Wait before executing init tablet peer for specified amount of milliseconds.");
 
@@ -170,6 +175,8 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
                                   const scoped_refptr<MetricEntity> &metric_entity,
                                   ThreadPool* raft_pool,
                                   ThreadPool* tablet_prepare_pool,
+                                  ThreadPool* apply_pool,
+                                  rpc::ThreadPool* txn_apply_pool,
                                   consensus::RetryableRequests* retryable_requests) {
 
   DCHECK(tablet) << "A TabletPeer must be provided with a Tablet";
@@ -193,6 +200,7 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
     // "Publish" the log pointer so it can be retrieved using the log() accessor.
     log_atomic_ = log.get();
     service_thread_pool_ = &messenger->ThreadPool();
+    txn_apply_pool_ = txn_apply_pool;
 
     tablet->SetMemTableFlushFilterFactory([log] {
       auto index = log->GetLatestEntryOpId().index;
@@ -275,6 +283,9 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
     });
 
     prepare_thread_ = std::make_unique<Preparer>(consensus_.get(), tablet_prepare_pool);
+    if (apply_pool && FLAGS_async_operation_completion) {
+      apply_token_ = apply_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+    }
 
     consensus_->SetMajorityReplicatedListener([mvcc_manager, ht_lease_provider] {
       auto ht_lease = ht_lease_provider(/* min_allowed */ 0, /* deadline */ CoarseTimePoint::max());
@@ -296,6 +307,10 @@ Status TabletPeer::InitTabletPeer(const shared_ptr<TabletClass> &tablet,
     tablet_->transaction_coordinator()->Start();
   }
 
+  if (tablet_->transaction_participant()) {
+    tablet_->transaction_participant()->Start();
+  }
+
   TRACE("TabletPeer::Init() finished");
   VLOG_WITH_PREFIX(2) << "Peer Initted";
 
@@ -385,6 +400,10 @@ void TabletPeer::CompleteShutdown() {
     operation_tracker_.WaitForAllToFinish();
   }
 
+  if (apply_token_) {
+    apply_token_->Shutdown();
+  }
+
   if (prepare_thread_) {
     prepare_thread_->Stop();
   }
@@ -406,6 +425,7 @@ void TabletPeer::CompleteShutdown() {
     has_consensus_.store(false, std::memory_order_release);
     consensus_.reset();
     prepare_thread_.reset();
+    apply_token_.reset();
     tablet_.reset();
     auto state = state_.load(std::memory_order_acquire);
     LOG_IF_WITH_PREFIX(DFATAL, state != RaftGroupStatePB::QUIESCING) <<
@@ -839,6 +859,14 @@ bool TabletPeer::ShouldApplyWrite() {
   return tablet_->ShouldApplyWrite();
 }
 
+void TabletPeer::StartApplyGroup() {
+  tablet_->StartApplyGroup();
+}
+
+void TabletPeer::FinishApplyGroup() {
+  tablet_->FinishApplyGroup();
+}
+
 consensus::Consensus* TabletPeer::consensus() const {
   std::lock_guard<simple_spinlock> lock(lock_);
   return consensus_.get();
@@ -924,7 +952,8 @@ scoped_refptr<OperationDriver> TabletPeer::CreateOperationDriver() {
       log_.get(),
       prepare_thread_.get(),
       &operation_order_verifier_,
-      tablet_->table_type()));
+      tablet_->table_type(),
+      apply_token_.get()));
 }
 
 int64_t TabletPeer::LeaderTerm() const {
@@ -993,5 +1022,16 @@ bool TabletPeer::Enqueue(rpc::ThreadPoolTask* task) {
   return thread_pool->Enqueue(task);
 }
 
+bool TabletPeer::EnqueueTransactionApply(rpc::ThreadPoolTask* task) {
+  rpc::ThreadPool* thread_pool = txn_apply_pool_.load(std::memory_order_acquire);
+  if (!thread_pool) {
+    return false;
+  }
+
+  // Task is done with error status if the pool is shutting down.
+  thread_pool->Enqueue(task);
+  return true;
+}
+
 }  // namespace tablet
 }  // namespace yb
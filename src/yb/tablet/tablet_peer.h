@@ -82,6 +82,7 @@ class UpdateTransactionResponsePB;
 class MaintenanceManager;
 class MaintenanceOp;
 class ThreadPool;
+class ThreadPoolToken;
 
 namespace tablet {
 
@@ -118,6 +119,8 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
                                 const scoped_refptr<MetricEntity> &metric_entity,
                                 ThreadPool* raft_pool,
                                 ThreadPool* tablet_prepare_pool,
+                                ThreadPool* apply_pool,
+                                rpc::ThreadPool* txn_apply_pool,
                                 consensus::RetryableRequests* retryable_requests);
 
   // Starts the TabletPeer, making it available for Write()s. If this
@@ -179,6 +182,10 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
   // Returns false if it is preferable to don't apply write operation.
   bool ShouldApplyWrite() override;
 
+  void StartApplyGroup() override;
+
+  void FinishApplyGroup() override;
+
   consensus::Consensus* consensus() const;
 
   std::shared_ptr<consensus::Consensus> shared_consensus() const;
@@ -279,6 +286,8 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
 
   bool Enqueue(rpc::ThreadPoolTask* task) override;
 
+  bool EnqueueTransactionApply(rpc::ThreadPoolTask* task) override;
+
   const std::shared_future<client::YBClient*>& client_future() const override {
     return client_future_;
   }
@@ -393,6 +402,10 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
 
   std::unique_ptr<Preparer> prepare_thread_;
 
+  // Serial token on the apply pool shared by all tablets, that completes applied operations of
+  // this tablet in order.
+  std::unique_ptr<ThreadPoolToken> apply_token_;
+
   scoped_refptr<server::Clock> clock_;
 
   scoped_refptr<log::LogAnchorRegistry> log_anchor_registry_;
@@ -414,6 +427,8 @@ class TabletPeer : public consensus::ReplicaOperationFactory,
 
   std::atomic<rpc::ThreadPool*> service_thread_pool_{nullptr};
 
+  std::atomic<rpc::ThreadPool*> txn_apply_pool_{nullptr};
+
   std::atomic<size_t> preparing_operations_{0};
 
  private:
@@ -48,6 +48,7 @@
 #include "yb/tserver/tserver_service.pb.h"
 
 #include "yb/util/enums.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/kernel_stack_watchdog.h"
 #include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
@@ -61,6 +62,15 @@ DEFINE_double(transaction_max_missed_heartbeat_periods, 10.0 * yb::kTimeMultipli
               "microseconds is transaction_heartbeat_usec times "
               "transaction_max_missed_heartbeat_periods. The value passed to this flag may be "
               "fractional.");
+DEFINE_double(transaction_heartbeat_replication_periods, 3.0,
+              "Heartbeat periods after which a heartbeat of a pending transaction is replicated by "
+              "the transaction coordinator. Other heartbeats only update the state kept in memory "
+              "of the leader. It is limited by half of "
+              "transaction_max_missed_heartbeat_periods, so a new leader, that only knows "
+              "replicated heartbeats, does not expire live transactions. Zero means that every "
+              "heartbeat is replicated.");
+TAG_FLAG(transaction_heartbeat_replication_periods, advanced);
+TAG_FLAG(transaction_heartbeat_replication_periods, runtime);
 DEFINE_uint64(transaction_check_interval_usec, 500000, "Transaction check interval in usec.");
 DEFINE_uint64(transaction_resend_applying_interval_usec, 5000000,
               "Transaction resend applying interval in usec.");
@@ -81,6 +91,16 @@ std::chrono::microseconds GetTransactionTimeout() {
 
 namespace {
 
+// Minimal time since the last replicated heartbeat of a pending transaction, after which a new
+// heartbeat is replicated.
+std::chrono::microseconds HeartbeatReplicationInterval() {
+  const double periods = std::min(
+      GetAtomicFlag(&FLAGS_transaction_heartbeat_replication_periods),
+      GetAtomicFlag(&FLAGS_transaction_max_missed_heartbeat_periods) / 2);
+  return std::chrono::microseconds(static_cast<int64_t>(
+      std::max(periods, 0.0) * GetAtomicFlag(&FLAGS_transaction_heartbeat_usec)));
+}
+
 struct NotifyApplyingData {
   TabletId tablet;
   TransactionId transaction;
@@ -128,7 +148,8 @@ class TransactionState {
       : context_(*context),
         id_(id),
         log_prefix_(BuildLogPrefix(parent_log_prefix, id)),
-        last_touch_(last_touch) {
+        last_touch_(last_touch),
+        replicated_touch_(last_touch) {
   }
 
   ~TransactionState() {
@@ -143,7 +164,8 @@ class TransactionState {
   }
 
   // Time when we last heard from transaction. I.e. hybrid time of replicated raft log entry
-  // that updates status of this transaction.
+  // that updates status of this transaction, or on leader time of the last heartbeat that was
+  // handled in memory only.
   HybridTime last_touch() const {
     return last_touch_;
   }
@@ -160,9 +182,9 @@ class TransactionState {
 
   // Returns debug string this representation of this class.
   std::string ToString() const {
-    return Format("{ id: $0 last_touch: $1 status: $2 unnotified_tablets: $3 replicating: $4 "
-                  " request_queue: $5 }",
-                  to_string(id_), last_touch_, TransactionStatus_Name(status_),
+    return Format("{ id: $0 last_touch: $1 replicated_touch: $2 status: $3 "
+                  "unnotified_tablets: $4 replicating: $5 request_queue: $6 }",
+                  to_string(id_), last_touch_, replicated_touch_, TransactionStatus_Name(status_),
                   unnotified_tablets_, replicating_, request_queue_);
   }
 
@@ -249,13 +271,14 @@ class TransactionState {
   CHECKED_STATUS GetStatus(tserver::GetTransactionStatusResponsePB* response) const {
     if (status_ == TransactionStatus::COMMITTED ||
         status_ == TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS) {
-      response->set_status(TransactionStatus::COMMITTED);
-      response->set_status_hybrid_time(commit_time_.ToUint64());
+      response->add_status(TransactionStatus::COMMITTED);
+      response->add_status_hybrid_time(commit_time_.ToUint64());
     } else if (status_ == TransactionStatus::ABORTED) {
-      response->set_status(TransactionStatus::ABORTED);
+      response->add_status(TransactionStatus::ABORTED);
+      response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
     } else {
       CHECK_EQ(TransactionStatus::PENDING, status_);
-      response->set_status(TransactionStatus::PENDING);
+      response->add_status(TransactionStatus::PENDING);
       HybridTime status_ht = context_.coordinator_context().clock().Now();
       if (replicating_) {
         auto replicating_status = replicating_->request()->status();
@@ -268,7 +291,7 @@ class TransactionState {
         }
       }
       status_ht = std::min(status_ht, context_.coordinator_context().HtLeaseExpiration());
-      response->set_status_hybrid_time(status_ht.Decremented().ToUint64());
+      response->add_status_hybrid_time(status_ht.Decremented().ToUint64());
     }
     return Status::OK();
   }
@@ -424,12 +447,31 @@ class TransactionState {
       return;
     }
 
+    if (state.status() == TransactionStatus::PENDING && HandleHeartbeatInMemory()) {
+      context_.CompleteWithStatus(std::move(request), Status::OK());
+      return;
+    }
+
     VLOG_WITH_PREFIX(4) << Format("DoHandle, replicating = $0", replicating_);
     replicating_ = request.get();
     auto submitted = context_.SubmitUpdateTransaction(std::move(request));
     CHECK(submitted);
   }
 
+  // Heartbeat only has to be replicated, when a new leader could expire the transaction knowing
+  // just the replicated heartbeats. Otherwise it is enough to remember it in memory of leader.
+  // Returns true if heartbeat was handled.
+  bool HandleHeartbeatInMemory() {
+    auto now = context_.coordinator_context().clock().Now();
+    const int64_t passed =
+        now.GetPhysicalValueMicros() - replicated_touch_.GetPhysicalValueMicros();
+    if (std::chrono::microseconds(passed) >= HeartbeatReplicationInterval()) {
+      return false;
+    }
+    last_touch_ = std::max(last_touch_, now);
+    return true;
+  }
+
   CHECKED_STATUS HandleCommit() {
     auto hybrid_time = context_.coordinator_context().clock().Now();
     if (ExpiredAt(hybrid_time)) {
@@ -499,7 +541,7 @@ class TransactionState {
       return status;
     }
 
-    last_touch_ = data.hybrid_time;
+    SetReplicatedTouch(data.hybrid_time);
     commit_time_ = data.hybrid_time;
     VLOG_WITH_PREFIX(4) << "Commit time: " << commit_time_;
     status_ = TransactionStatus::COMMITTED;
@@ -524,7 +566,7 @@ class TransactionState {
           << TransactionStatus_Name(status_) << ", request: " << data.state.ShortDebugString();
       CHECK_EQ(status_, TransactionStatus::PENDING);
     }
-    last_touch_ = data.hybrid_time;
+    SetReplicatedTouch(data.hybrid_time);
     status_ = TransactionStatus::APPLIED_IN_ALL_INVOLVED_TABLETS;
     return Status::OK();
   }
@@ -542,7 +584,7 @@ class TransactionState {
                               << TransactionStatus_Name(status_);
       return Status::OK();
     }
-    last_touch_ = data.hybrid_time;
+    SetReplicatedTouch(data.hybrid_time);
     first_entry_raft_index_ = data.op_id.index();
     return Status::OK();
   }
@@ -563,6 +605,11 @@ class TransactionState {
     return Status::OK();
   }
 
+  void SetReplicatedTouch(HybridTime hybrid_time) {
+    last_touch_ = hybrid_time;
+    replicated_touch_ = hybrid_time;
+  }
+
   void NotifyAbortWaiters(const Result<TransactionStatusResult>& result) {
     for (auto& waiter : abort_waiters_) {
       waiter(result);
@@ -575,6 +622,8 @@ class TransactionState {
   const std::string log_prefix_;
   TransactionStatus status_ = TransactionStatus::PENDING;
   HybridTime last_touch_;
+  // Hybrid time of the last replicated raft log entry that updates status of this transaction.
+  HybridTime replicated_touch_;
   // It should match last_touch_, but it is possible that because of some code errors it
   // would not be so. To add stability we introduce a separate field for it.
   HybridTime commit_time_;
@@ -656,20 +705,25 @@ class TransactionCoordinator::Impl : public TransactionStateContext {
     rpcs_.Shutdown();
   }
 
-  CHECKED_STATUS GetStatus(const std::string& transaction_id,
+  CHECKED_STATUS GetStatus(const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
                            tserver::GetTransactionStatusResponsePB* response) {
-    auto id = FullyDecodeTransactionId(transaction_id);
-    if (!id.ok()) {
-      return std::move(id.status());
+    std::vector<TransactionId> ids;
+    ids.reserve(transaction_ids.size());
+    for (const auto& transaction_id : transaction_ids) {
+      ids.push_back(VERIFY_RESULT(FullyDecodeTransactionId(transaction_id)));
     }
 
     std::lock_guard<std::mutex> lock(managed_mutex_);
-    auto it = managed_transactions_.find(*id);
-    if (it == managed_transactions_.end()) {
-      response->set_status(TransactionStatus::ABORTED);
-      return Status::OK();
+    for (const auto& id : ids) {
+      auto it = managed_transactions_.find(id);
+      if (it == managed_transactions_.end()) {
+        response->add_status(TransactionStatus::ABORTED);
+        response->add_status_hybrid_time(HybridTime::kMax.ToUint64());
+        continue;
+      }
+      RETURN_NOT_OK(it->GetStatus(response));
     }
-    return it->GetStatus(response);
+    return Status::OK();
   }
 
   void Abort(const std::string& transaction_id, int64_t term, TransactionAbortCallback callback) {
@@ -1060,9 +1114,10 @@ void TransactionCoordinator::Shutdown() {
   impl_->Shutdown();
 }
 
-Status TransactionCoordinator::GetStatus(const std::string& transaction_id,
-                                         tserver::GetTransactionStatusResponsePB* response) {
-  return impl_->GetStatus(transaction_id, response);
+Status TransactionCoordinator::GetStatus(
+    const google::protobuf::RepeatedPtrField<std::string>& transaction_ids,
+    tserver::GetTransactionStatusResponsePB* response) {
+  return impl_->GetStatus(transaction_ids, response);
 }
 
 void TransactionCoordinator::Abort(const std::string& transaction_id,
@@ -15,12 +15,16 @@
 
 #include "yb/tablet/transaction_participant.h"
 
+#include <map>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/ordered_index.hpp>
 
 #include <boost/optional/optional.hpp>
 
@@ -33,8 +37,11 @@
 
 #include "yb/docdb/docdb_rocksdb_util.h"
 #include "yb/docdb/docdb.h"
+#include "yb/docdb/transaction_intents_index.h"
 
+#include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc.h"
+#include "yb/rpc/scheduler.h"
 #include "yb/rpc/thread_pool.h"
 
 #include "yb/tablet/operations/update_txn_operation.h"
@@ -47,6 +54,7 @@
 #include "yb/util/random_util.h"
 
 DECLARE_uint64(aborted_intent_cleanup_ms);
+DECLARE_int32(aborted_intent_cleanup_max_batch_size);
 
 using namespace std::literals;
 using namespace std::placeholders;
@@ -55,6 +63,24 @@ DEFINE_uint64(transaction_delay_status_reply_usec_in_tests, 0,
               "For tests only. Delay handling status reply by specified amount of usec.");
 DEFINE_double(transaction_ignore_applying_probability_in_tests, 0,
               "Probability to ignore APPLYING update in tests.");
+DEFINE_uint64(transaction_status_cache_capacity, 10000,
+              "Max number of transaction statuses received from coordinators, that are cached "
+              "and shared by all readers of a tablet. 0 to disable the cache.");
+DEFINE_uint64(transaction_intents_index_capacity_bytes, 16 * 1024 * 1024,
+              "Max memory used by the in-memory index of keys that have provisional records in "
+              "a tablet, that allows reads to skip the intents DB. 0 to disable the index.");
+DEFINE_uint64(transaction_intents_index_max_records_bytes, 64 * 1024,
+              "Max size of provisional records of a transaction, that are kept in the in-memory "
+              "index of the tablet, so reads of the transaction resolve its own writes without "
+              "seeking the intents DB. 0 to keep only keys.");
+DEFINE_uint64(stale_intents_cleanup_interval_ms, 10000,
+              "Interval between checks for transactions, that have stored intents for longer "
+              "than aborted_intent_cleanup_ms, so their intents are removed if they are aborted "
+              "without waiting for compaction of the intents DB. 0 to disable the checks.");
+DEFINE_uint64(stale_intents_cleanup_compaction_threshold, 0,
+              "Number of transactions with stale intents removed by the background cleanup, "
+              "after which the intents DB is compacted to purge their tombstones. "
+              "0 to disable such compactions.");
 
 namespace yb {
 namespace tablet {
@@ -130,6 +156,11 @@ class RunningTransaction;
 
 typedef std::shared_ptr<RunningTransaction> RunningTransactionPtr;
 
+// Status requests of running transactions collected to be sent by a single RPC per status tablet.
+// Each entry contains transaction and serial no of its request.
+typedef std::map<TabletId, std::vector<std::pair<RunningTransactionPtr, int64_t>>>
+    StatusRequestBatches;
+
 class RunningTransactionContext {
  public:
   RunningTransactionContext(TransactionParticipantContext* participant_context,
@@ -195,15 +226,22 @@ class RemoveIntentsTask : public rpc::ThreadPoolTask {
   RunningTransactionPtr transaction_;
 };
 
+// Invoked when cleanup is finished, with transactions whose intents were removed.
+typedef std::function<void(const TransactionIdSet&)> CleanupAbortsCallback;
+
 class CleanupAbortsTask : public rpc::ThreadPoolTask {
  public:
   CleanupAbortsTask(TransactionIntentApplier* applier,
                      TransactionIdSet&& transactions_to_cleanup,
                      TransactionParticipantContext* participant_context,
-                     TransactionStatusManager* status_manager)
+                     TransactionStatusManager* status_manager,
+                     docdb::TransactionIntentsIndex* intents_index,
+                     CleanupAbortsCallback callback)
       : applier_(applier), transactions_to_cleanup_(std::move(transactions_to_cleanup)),
         participant_context_(*participant_context),
-        status_manager_(*status_manager) {}
+        status_manager_(*status_manager),
+        intents_index_(intents_index),
+        callback_(std::move(callback)) {}
 
   void Prepare(std::shared_ptr<CleanupAbortsTask> cleanup_task) {
     retain_self_ = std::move(cleanup_task);
@@ -231,23 +269,36 @@ class CleanupAbortsTask : public rpc::ThreadPoolTask {
       return;
     }
 
-    for (const TransactionId transaction_id : transactions_to_cleanup_) {
+    for (auto it = transactions_to_cleanup_.begin(); it != transactions_to_cleanup_.end();) {
       // If transaction is committed, no action required
       // TODO(dtxn) : Do batch processing of transactions,
       // because LocalCommitTime will acquire lock per each call.
-      auto commit_time = status_manager_.LocalCommitTime(transaction_id);
+      auto commit_time = status_manager_.LocalCommitTime(*it);
       if (commit_time.is_valid()) {
-        transactions_to_cleanup_.erase(transaction_id);
+        it = transactions_to_cleanup_.erase(it);
+      } else {
+        ++it;
       }
     }
 
-    WARN_NOT_OK(applier_->RemoveIntents(transactions_to_cleanup_),
-                "RemoveIntents for transaction cleanup in compaction failed.");
+    auto status = applier_->RemoveIntents(transactions_to_cleanup_);
+    WARN_NOT_OK(status, "RemoveIntents for transaction cleanup in compaction failed.");
+    // Some of aborted transactions could be registered in the intents index as unindexed, since
+    // they wrote intents before the tablet was opened.
+    if (status.ok() && intents_index_) {
+      for (const auto& transaction_id : transactions_to_cleanup_) {
+        intents_index_->Remove(transaction_id);
+      }
+    }
+    intents_removed_ = status.ok();
     LOG(INFO) << "Number of aborted transactions cleaned up: " << transactions_to_cleanup_.size()
               << " of " << initial_number_of_transactions;
   }
 
   void Done(const Status& status) override {
+    if (callback_) {
+      callback_(intents_removed_ ? transactions_to_cleanup_ : TransactionIdSet());
+    }
     transactions_to_cleanup_.clear();
     retain_self_ = nullptr;
   }
@@ -320,6 +371,9 @@ class CleanupAbortsTask : public rpc::ThreadPoolTask {
   TransactionIdSet transactions_to_cleanup_;
   TransactionParticipantContext& participant_context_;
   TransactionStatusManager& status_manager_;
+  docdb::TransactionIntentsIndex* intents_index_;
+  CleanupAbortsCallback callback_;
+  bool intents_removed_ = false;
   std::shared_ptr<CleanupAbortsTask> retain_self_;
   std::mutex mutex_;
   std::condition_variable cond_;
@@ -368,9 +422,11 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     local_commit_time_ = time;
   }
 
+  // When batches is specified, the RPC is not sent but added to batches instead.
   void RequestStatusAt(client::YBClient* client,
                        const StatusRequest& request,
-                       std::unique_lock<std::mutex>* lock) {
+                       std::unique_lock<std::mutex>* lock,
+                       StatusRequestBatches* batches = nullptr) {
     DCHECK_LT(request.global_limit_ht, HybridTime::kMax);
     DCHECK_LE(request.read_ht, request.global_limit_ht);
 
@@ -394,6 +450,10 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     auto request_id = context_.NextRequestIdUnlocked();
     auto shared_self = shared_from_this();
     lock->unlock();
+    if (batches) {
+      (*batches)[metadata_.status_tablet].emplace_back(std::move(shared_self), request_id);
+      return;
+    }
     SendStatusRequest(client, request_id, shared_self);
   }
 
@@ -424,33 +484,11 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     return metadata_.ToString();
   }
 
- private:
-  static boost::optional<TransactionStatus> GetStatusAt(
-      HybridTime time,
-      HybridTime last_known_status_hybrid_time,
-      TransactionStatus last_known_status) {
-    switch (last_known_status) {
-      case TransactionStatus::ABORTED:
-        return TransactionStatus::ABORTED;
-      case TransactionStatus::COMMITTED:
-        return last_known_status_hybrid_time > time
-            ? TransactionStatus::PENDING
-            : TransactionStatus::COMMITTED;
-      case TransactionStatus::PENDING:
-        if (last_known_status_hybrid_time >= time) {
-          return TransactionStatus::PENDING;
-        }
-        return boost::none;
-      default:
-        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
-    }
-  }
-
   void SendStatusRequest(
       client::YBClient* client, int64_t serial_no, const RunningTransactionPtr& shared_self) {
     tserver::GetTransactionStatusRequestPB req;
     req.set_tablet_id(metadata_.status_tablet);
-    req.set_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
+    req.add_transaction_id(metadata_.transaction_id.begin(), metadata_.transaction_id.size());
     req.set_propagated_hybrid_time(context_.participant_context_.Now().ToUint64());
     context_.rpcs_.RegisterAndStart(
         client::GetTransactionStatus(
@@ -458,14 +496,16 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
             nullptr /* tablet */,
             client,
             &req,
-            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, serial_no,
-                      shared_self)),
+            std::bind(&RunningTransaction::StatusReceived, this, client, _1, _2, 0 /* index */,
+                      serial_no, shared_self)),
         &get_status_handle_);
   }
 
+  // Handles response to status request, index is position of this transaction in the response.
   void StatusReceived(client::YBClient* client,
                       const Status& status,
                       const tserver::GetTransactionStatusResponsePB& response,
+                      int index,
                       int64_t serial_no,
                       const RunningTransactionPtr& shared_self) {
     auto delay_usec = FLAGS_transaction_delay_status_reply_usec_in_tests;
@@ -473,15 +513,38 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
       delayer_.Delay(
           MonoTime::Now() + MonoDelta::FromMicroseconds(delay_usec),
           std::bind(&RunningTransaction::DoStatusReceived, this, client, status, response,
-                    serial_no, shared_self));
+                    index, serial_no, shared_self));
     } else {
-      DoStatusReceived(client, status, response, serial_no, shared_self);
+      DoStatusReceived(client, status, response, index, serial_no, shared_self);
+    }
+  }
+
+ private:
+  static boost::optional<TransactionStatus> GetStatusAt(
+      HybridTime time,
+      HybridTime last_known_status_hybrid_time,
+      TransactionStatus last_known_status) {
+    switch (last_known_status) {
+      case TransactionStatus::ABORTED:
+        return TransactionStatus::ABORTED;
+      case TransactionStatus::COMMITTED:
+        return last_known_status_hybrid_time > time
+            ? TransactionStatus::PENDING
+            : TransactionStatus::COMMITTED;
+      case TransactionStatus::PENDING:
+        if (last_known_status_hybrid_time >= time) {
+          return TransactionStatus::PENDING;
+        }
+        return boost::none;
+      default:
+        FATAL_INVALID_ENUM_VALUE(TransactionStatus, last_known_status);
     }
   }
 
   void DoStatusReceived(client::YBClient* client,
                         const Status& status,
                         const tserver::GetTransactionStatusResponsePB& response,
+                        int index,
                         int64_t serial_no,
                         const RunningTransactionPtr& shared_self) {
     if (response.has_propagated_hybrid_time()) {
@@ -492,28 +555,33 @@ class RunningTransaction : public std::enable_shared_from_this<RunningTransactio
     decltype(status_waiters_) status_waiters;
     HybridTime time_of_status;
     TransactionStatus transaction_status;
-    const bool ok = status.ok();
+    const bool ok = status.ok() && index < response.status_size();
     int64_t new_request_id = -1;
     {
       std::unique_lock<std::mutex> lock(context_.mutex_);
       if (!ok) {
         status_waiters_.swap(status_waiters);
         lock.unlock();
+        auto error = status.ok()
+            ? STATUS_FORMAT(IllegalState, "Status of $0 missing in response: $1",
+                            id(), response.ShortDebugString())
+            : status;
         for (const auto& waiter : status_waiters) {
-          waiter.callback(status);
+          waiter.callback(error);
         }
         return;
       }
 
-      DCHECK(response.has_status_hybrid_time() ||
-             response.status() == TransactionStatus::ABORTED);
-      time_of_status = response.has_status_hybrid_time()
-          ? HybridTime(response.status_hybrid_time())
+      const auto response_status = response.status(index);
+      DCHECK(index < response.status_hybrid_time_size() ||
+             response_status == TransactionStatus::ABORTED);
+      time_of_status = index < response.status_hybrid_time_size()
+          ? HybridTime(response.status_hybrid_time(index))
           : HybridTime::kMax;
       if (last_known_status_hybrid_time_ <= time_of_status) {
         last_known_status_hybrid_time_ = time_of_status;
-        last_known_status_ = response.status();
-        if (response.status() == TransactionStatus::ABORTED) {
+        last_known_status_ = response_status;
+        if (response_status == TransactionStatus::ABORTED) {
           if (!local_commit_time_ && remove_intents_task_.Prepare(shared_self)) {
             context_.participant_context_.Enqueue(&remove_intents_task_);
             VLOG_WITH_PREFIX(1) << "Transaction should be aborted: " << id();
@@ -657,13 +725,47 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       : RunningTransactionContext(context, applier),
         log_prefix_(Format("T $0 P $1: ", context->tablet_id(), context->permanent_uuid())) {
     LOG_WITH_PREFIX(INFO) << "Start";
+    if (FLAGS_transaction_status_cache_capacity > 0) {
+      shared_status_cache_ = std::make_unique<SharedTransactionStatusCache>(
+          FLAGS_transaction_status_cache_capacity);
+    }
+    if (FLAGS_transaction_intents_index_capacity_bytes > 0) {
+      intents_index_ = std::make_unique<docdb::TransactionIntentsIndex>(
+          FLAGS_transaction_intents_index_capacity_bytes,
+          FLAGS_transaction_intents_index_max_records_bytes);
+    }
   }
 
   ~Impl() {
+    {
+      // Waits for the running cleanup round. The scheduled task does not run the cleanup after
+      // this point, so it is not waited for, since the scheduler could be shut down and never run
+      // its abort callback.
+      std::lock_guard<std::mutex> task_lock(stale_intents_task_->mutex);
+      stale_intents_task_->impl = nullptr;
+    }
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      closing_.store(true, std::memory_order_release);
+      if (stale_intents_task_id_ != rpc::kUninitializedScheduledTaskId) {
+        client()->messenger()->scheduler().Abort(stale_intents_task_id_);
+      }
+      pending_applies_cond_.wait(lock, [this] { return pending_applies_ == 0; });
+      stale_intents_cond_.wait(lock, [this] { return !stale_intents_cleanup_running_; });
+    }
     transactions_.clear();
     rpcs_.Shutdown();
   }
 
+  void Start(TransactionStatusManager* status_manager) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    status_manager_ = status_manager;
+    if (!closing_.load(std::memory_order_acquire) &&
+        FLAGS_stale_intents_cleanup_interval_ms > 0) {
+      ScheduleStaleIntentsCleanup();
+    }
+  }
+
   // Adds new running transaction.
   void Add(const TransactionMetadataPB& data, bool may_have_metadata,
            rocksdb::WriteBatch *write_batch) {
@@ -701,8 +803,10 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       auto data_copy = data;
       // We use hybrid time only for backward compatibility, actually wall time is required.
       data_copy.set_metadata_write_time(GetCurrentTimeMicros());
-      auto value = data.SerializeAsString();
+      auto value = data_copy.SerializeAsString();
       write_batch->Put(key.data(), value);
+      std::lock_guard<std::mutex> lock(mutex_);
+      UpdateStoredTransactionUnlocked(metadata->transaction_id, data_copy.metadata_write_time());
     }
   }
 
@@ -747,6 +851,20 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return std::make_pair(transaction.metadata(), transaction.last_write_id());
   }
 
+  void IndexIntents(const TransactionId& id, const rocksdb::WriteBatch& write_batch) {
+    if (intents_index_) {
+      intents_index_->Add(id, write_batch);
+    }
+  }
+
+  StrongIntentsInRange LookupStrongIntents(
+      const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+      IntentRecords* records) {
+    return intents_index_
+        ? intents_index_->Lookup(transaction_id, lower_bound, upper_bound, records)
+        : StrongIntentsInRange::kUnknown;
+  }
+
   void UpdateLastWriteId(const TransactionId& id, IntraTxnWriteId value) {
     std::lock_guard<std::mutex> lock(mutex_);
     auto it = transactions_.find(id);
@@ -767,6 +885,24 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     lock_and_iterator.transaction().RequestStatusAt(client(), request, &lock_and_iterator.lock);
   }
 
+  void RequestStatusesAt(const std::vector<StatusRequest>& requests) {
+    StatusRequestBatches batches;
+    for (const auto& request : requests) {
+      auto lock_and_iterator = LockAndFindOrLoad(*request.id, *request.reason, request.must_exist);
+      if (!lock_and_iterator.found()) {
+        request.callback(
+            STATUS_FORMAT(NotFound, "Request status of unknown transaction: $0", *request.id));
+        continue;
+      }
+      lock_and_iterator.transaction().RequestStatusAt(
+          client(), request, &lock_and_iterator.lock, &batches);
+    }
+
+    for (auto& batch : batches) {
+      SendStatusRequests(batch.first, std::move(batch.second));
+    }
+  }
+
   // Registers request, giving him newly allocated id and returning this id.
   int64_t RegisterRequest() {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -800,6 +936,9 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     while (!cleanup_queue_.empty() && cleanup_queue_.front().request_id < min_request) {
       const auto& id = cleanup_queue_.front().transaction_id;
       transactions_.erase(id);
+      if (intents_index_) {
+        intents_index_->Remove(id);
+      }
       VLOG_WITH_PREFIX(2) << "Cleaned from queue: " << id;
       cleanup_queue_.pop_front();
     }
@@ -875,11 +1014,15 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return status;
   }
 
-  void Cleanup(TransactionIdSet&& set, TransactionStatusManager* status_manager) {
+  void Cleanup(TransactionIdSet&& set, TransactionStatusManager* status_manager,
+               CleanupAbortsCallback callback = CleanupAbortsCallback()) {
     auto cleanup_aborts_task = std::make_shared<CleanupAbortsTask>(
-        &applier_, std::move(set), &participant_context_, status_manager);
+        &applier_, std::move(set), &participant_context_, status_manager, intents_index_.get(),
+        std::move(callback));
     cleanup_aborts_task->Prepare(cleanup_aborts_task);
-    participant_context_.Enqueue(cleanup_aborts_task.get());
+    if (!participant_context_.Enqueue(cleanup_aborts_task.get())) {
+      cleanup_aborts_task->Done(STATUS(Aborted, "Thread pool is not available"));
+    }
   }
 
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data) {
@@ -896,11 +1039,35 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
         return Status::OK();
       }
 
+      if (lock_and_iterator.transaction().local_commit_time().is_valid()) {
+        // Intents of this transaction are already being applied in background, status tablet
+        // will be notified when it is done.
+        VLOG_WITH_PREFIX(2) << Format("Apply of transaction in progress: $0", data);
+        return Status::OK();
+      }
+
       lock_and_iterator.transaction().SetLocalCommitTime(data.commit_ht);
     }
 
-    CHECK_OK(applier_.ApplyIntents(data));
+    // The first batch is applied synchronously, so small transactions are applied at once.
+    // The rest of intents of a big transaction are applied in background. Until that is done,
+    // the transaction is kept as committed, so readers could resolve its remaining intents.
+    docdb::ApplyTransactionState apply_state;
+    CHECK_OK(applier_.ApplyIntents(data, &apply_state));
+    if (apply_state.active()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_applies_;
+      }
+      ScheduleApply(data, std::move(apply_state));
+      return Status::OK();
+    }
 
+    CompleteApply(data);
+    return Status::OK();
+  }
+
+  void CompleteApply(const TransactionApplyData& data) {
     {
       auto lock_and_iterator = LockAndFindOrLoad(data.transaction_id, "apply"s);
       if (lock_and_iterator.found()) {
@@ -909,7 +1076,6 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     }
 
     NotifyApplied(data);
-    return Status::OK();
   }
 
   void NotifyApplied(const TransactionApplyData& data) {
@@ -965,12 +1131,17 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
 
   void SetDB(rocksdb::DB* db) {
     db_ = db;
+    RegisterStoredTransactions();
   }
 
   TransactionParticipantContext* participant_context() const {
     return &participant_context_;
   }
 
+  SharedTransactionStatusCache* shared_status_cache() const {
+    return shared_status_cache_.get();
+  }
+
   size_t TEST_GetNumRunningTransactions() {
     std::lock_guard<std::mutex> lock(mutex_);
     VLOG(4) << "Transactions: " << yb::ToString(transactions_);
@@ -987,6 +1158,118 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       >
   > Transactions;
 
+  // Transaction that has metadata stored in the intents DB, with the wall time in microseconds
+  // when it was written, or when the transaction was last found not to be aborted.
+  struct StoredTransaction {
+    TransactionId id;
+    MicrosecondsInt64 check_time;
+  };
+
+  struct CheckTimeTag;
+
+  typedef boost::multi_index_container<StoredTransaction,
+      boost::multi_index::indexed_by <
+          boost::multi_index::hashed_unique <
+              boost::multi_index::member<StoredTransaction, TransactionId, &StoredTransaction::id>
+          >,
+          boost::multi_index::ordered_non_unique <
+              boost::multi_index::tag<CheckTimeTag>,
+              boost::multi_index::member<
+                  StoredTransaction, MicrosecondsInt64, &StoredTransaction::check_time>
+          >
+      >
+  > StoredTransactions;
+
+  void UpdateStoredTransactionUnlocked(const TransactionId& id, MicrosecondsInt64 check_time) {
+    auto it = stored_transactions_.find(id);
+    if (it == stored_transactions_.end()) {
+      stored_transactions_.insert(StoredTransaction{id, check_time});
+    } else {
+      stored_transactions_.modify(it, [check_time](StoredTransaction& transaction) {
+        transaction.check_time = check_time;
+      });
+    }
+  }
+
+  void ScheduleStaleIntentsCleanup() {
+    stale_intents_task_id_ = client()->messenger()->scheduler().Schedule(
+        [task = stale_intents_task_](const Status& status) {
+          std::lock_guard<std::mutex> lock(task->mutex);
+          if (task->impl) {
+            task->impl->CleanupStaleIntents(status);
+          }
+        },
+        std::chrono::milliseconds(FLAGS_stale_intents_cleanup_interval_ms));
+  }
+
+  // Intents of aborted transactions are removed by the status requests of readers and by
+  // compaction of the intents DB. Aborts whose notification was lost and that are not touched by
+  // readers would otherwise stay until the next compaction, so transactions that have intents
+  // stored for longer than aborted_intent_cleanup_ms are checked here, oldest first.
+  void CleanupStaleIntents(const Status& status) {
+    TransactionIdSet set;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!status.ok() || closing_.load(std::memory_order_acquire)) {
+        VLOG_WITH_PREFIX(1) << "Stale intents cleanup stopped: " << status;
+        stale_intents_task_id_ = rpc::kUninitializedScheduledTaskId;
+        stale_intents_cond_.notify_all();
+        return;
+      }
+      if (!stale_intents_cleanup_running_) {
+        auto now = GetCurrentTimeMicros();
+        auto check_time_limit =
+            now - static_cast<MicrosecondsInt64>(FLAGS_aborted_intent_cleanup_ms) * 1000;
+        auto& index = stored_transactions_.get<CheckTimeTag>();
+        while (!index.empty() && index.begin()->check_time < check_time_limit &&
+               set.size() < static_cast<size_t>(FLAGS_aborted_intent_cleanup_max_batch_size)) {
+          set.insert(index.begin()->id);
+          // Transactions that are found to be not aborted will be checked again after the same
+          // interval.
+          index.modify(index.begin(), [now](StoredTransaction& transaction) {
+            transaction.check_time = now;
+          });
+        }
+        stale_intents_cleanup_running_ = !set.empty();
+      }
+      ScheduleStaleIntentsCleanup();
+    }
+    if (set.empty()) {
+      return;
+    }
+    VLOG_WITH_PREFIX(2) << "Check transactions with stale intents: " << yb::ToString(set);
+    Cleanup(std::move(set), status_manager_, [this](const TransactionIdSet& removed) {
+      StaleIntentsCleanupDone(removed);
+    });
+  }
+
+  void StaleIntentsCleanupDone(const TransactionIdSet& removed) {
+    bool compact = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (const auto& id : removed) {
+        stored_transactions_.erase(id);
+      }
+      removed_since_compaction_ += removed.size();
+      if (FLAGS_stale_intents_cleanup_compaction_threshold > 0 &&
+          removed_since_compaction_ >= FLAGS_stale_intents_cleanup_compaction_threshold &&
+          !closing_.load(std::memory_order_acquire)) {
+        removed_since_compaction_ = 0;
+        compact = true;
+      }
+    }
+    if (compact) {
+      LOG_WITH_PREFIX(INFO) << "Compact intents DB after stale intents cleanup";
+      rocksdb::CompactRangeOptions options;
+      options.exclusive_manual_compaction = false;
+      WARN_NOT_OK(db_->CompactRange(options, nullptr, nullptr),
+                  LogPrefix() + "Compaction after stale intents cleanup failed");
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    stale_intents_cleanup_running_ = false;
+    stale_intents_cond_.notify_all();
+  }
+
   // Tries to remove transaction with specified id.
   // Returns true if transaction is not exists after call to this method, otherwise returns false.
   // Which means that transaction will be removed later.
@@ -999,9 +1282,19 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   }
 
   bool RemoveUnlocked(const Transactions::iterator& it) {
+    // Intents of the transaction are applied or removed at this point.
+    stored_transactions_.erase((**it).id());
     if (running_requests_.empty()) {
       TransactionId txn_id = (**it).id();
       transactions_.erase(it);
+      // Intents of the transaction are either applied or removed at this point, so readers don't
+      // need its status anymore.
+      if (shared_status_cache_) {
+        shared_status_cache_->Erase(txn_id);
+      }
+      if (intents_index_) {
+        intents_index_->Remove(txn_id);
+      }
       VLOG_WITH_PREFIX(2) << "Cleaned transaction: " << txn_id
                           << ", left: " << transactions_.size();
       return true;
@@ -1103,6 +1396,11 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
       iter->Prev();
     }
 
+    // Intents of the loaded transaction were written before, so they are not known to the index.
+    if (intents_index_) {
+      intents_index_->AddUnindexed(id);
+    }
+
     std::unique_lock<std::mutex> lock(mutex_);
     auto it = transactions_.insert(std::make_shared<RunningTransaction>(
         std::move(*metadata), next_write_id, this)).first;
@@ -1110,6 +1408,145 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
     return LockAndFindOrLoadResult{std::move(lock), it};
   }
 
+  // Sends single status request for all specified transactions, that have the same status tablet.
+  void SendStatusRequests(
+      const TabletId& status_tablet,
+      std::vector<std::pair<RunningTransactionPtr, int64_t>> transactions) {
+    if (transactions.size() == 1) {
+      const auto& transaction = transactions.front();
+      transaction.first->SendStatusRequest(client(), transaction.second, transaction.first);
+      return;
+    }
+
+    tserver::GetTransactionStatusRequestPB req;
+    req.set_tablet_id(status_tablet);
+    for (const auto& transaction : transactions) {
+      const auto& id = transaction.first->id();
+      req.add_transaction_id(id.begin(), id.size());
+    }
+    req.set_propagated_hybrid_time(participant_context_.Now().ToUint64());
+
+    auto handle = rpcs_.Prepare();
+    if (handle == rpcs_.InvalidHandle()) {
+      tserver::GetTransactionStatusResponsePB response;
+      for (const auto& transaction : transactions) {
+        transaction.first->StatusReceived(
+            client(), STATUS(Aborted, "Transaction participant is shutting down"), response,
+            0 /* index */, transaction.second, transaction.first);
+      }
+      return;
+    }
+
+    VLOG_WITH_PREFIX(4) << "Request statuses of " << transactions.size() << " transactions from "
+                        << status_tablet;
+    auto shared_transactions =
+        std::make_shared<std::vector<std::pair<RunningTransactionPtr, int64_t>>>(
+            std::move(transactions));
+    auto* yb_client = client();
+    *handle = client::GetTransactionStatus(
+        TransactionRpcDeadline(),
+        nullptr /* tablet */,
+        yb_client,
+        &req,
+        [this, handle, yb_client, shared_transactions](
+            const Status& status, const tserver::GetTransactionStatusResponsePB& response) {
+          int index = 0;
+          for (const auto& transaction : *shared_transactions) {
+            transaction.first->StatusReceived(
+                yb_client, status, response, index, transaction.second, transaction.first);
+            ++index;
+          }
+          rpcs_.Unregister(handle);
+        });
+    (**handle).SendRpc();
+  }
+
+  // Intents present in the DB when it is opened were written before the index was created, so all
+  // transactions that have metadata in the DB are registered as unindexed.
+  // Also registers them for the stale intents cleanup, with the time their metadata was written.
+  void RegisterStoredTransactions() {
+    auto iter = docdb::CreateRocksDBIterator(db_,
+                                             docdb::BloomFilterMode::DONT_USE_BLOOM_FILTER,
+                                             boost::none,
+                                             rocksdb::kDefaultQueryId);
+    docdb::KeyBytes key;
+    key.AppendValueType(docdb::ValueType::kTransactionId);
+    iter->Seek(key.AsSlice());
+    size_t num_transactions = 0;
+    while (iter->Valid() && iter->key().starts_with(key.AsSlice())) {
+      Slice id_slice = iter->key();
+      id_slice.consume_byte();
+      auto id = DecodeTransactionId(&id_slice);
+      if (!id.ok()) {
+        LOG_WITH_PREFIX(DFATAL) << "Failed to decode transaction id from "
+                                << iter->key().ToDebugHexString() << ": " << id.status();
+        break;
+      }
+      if (intents_index_) {
+        intents_index_->AddUnindexed(*id);
+      }
+      TransactionMetadataPB metadata_pb;
+      MicrosecondsInt64 write_time = 0;
+      if (metadata_pb.ParseFromArray(iter->value().cdata(), iter->value().size())) {
+        write_time = metadata_pb.metadata_write_time();
+        if (!write_time) {
+          write_time = HybridTime(metadata_pb.deprecated_start_hybrid_time())
+              .GetPhysicalValueMicros();
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        UpdateStoredTransactionUnlocked(*id, write_time);
+      }
+      ++num_transactions;
+      docdb::KeyBytes next_key;
+      AppendTransactionKeyPrefix(*id, &next_key);
+      next_key.AppendValueType(docdb::ValueType::kMaxByte);
+      iter->Seek(next_key.AsSlice());
+    }
+    LOG_IF_WITH_PREFIX(INFO, num_transactions != 0)
+        << "Transactions with intents written before tablet was opened: " << num_transactions;
+  }
+
+  class ApplyIntentsTask;
+
+  void ScheduleApply(const TransactionApplyData& data, docdb::ApplyTransactionState apply_state);
+
+  // Applies the next batch of intents of the transaction, that is applied in background.
+  // Returns true if there are more intents to apply.
+  bool ApplyNextBatch(const TransactionApplyData& data, docdb::ApplyTransactionState* apply_state) {
+    if (closing_.load(std::memory_order_acquire)) {
+      ApplyFinished();
+      return false;
+    }
+
+    auto status = applier_.ApplyIntents(data, apply_state);
+    if (!status.ok()) {
+      // Intents that were not applied are kept, so the rest of the transaction is applied when
+      // apply is retried after restart.
+      LOG_WITH_PREFIX(WARNING) << "Failed to apply intents of " << data.transaction_id << " from "
+                               << apply_state->ToString() << ": " << status;
+      ApplyFinished();
+      return false;
+    }
+
+    if (apply_state->active()) {
+      return true;
+    }
+
+    CompleteApply(data);
+    ApplyFinished();
+    return false;
+  }
+
+  // Invoked when background apply of the transaction is complete or stopped.
+  void ApplyFinished() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--pending_applies_ == 0) {
+      pending_applies_cond_.notify_all();
+    }
+  }
+
   client::YBClient* client() const {
     return participant_context_.client_future().get();
   }
@@ -1136,8 +1573,93 @@ class TransactionParticipant::Impl : public RunningTransactionContext {
   // Queue of transaction ids that should be cleaned, paired with request that should be completed
   // in order to be able to do clean.
   std::deque<CleanupQueueEntry> cleanup_queue_;
+
+  std::unique_ptr<SharedTransactionStatusCache> shared_status_cache_;
+
+  std::unique_ptr<docdb::TransactionIntentsIndex> intents_index_;
+
+  // Number of transactions that are being applied in background.
+  size_t pending_applies_ = 0;
+  std::condition_variable pending_applies_cond_;
+  std::atomic<bool> closing_{false};
+
+  TransactionStatusManager* status_manager_ = nullptr;
+  StoredTransactions stored_transactions_;
+  rpc::ScheduledTaskId stale_intents_task_id_ = rpc::kUninitializedScheduledTaskId;
+  // Shared with the scheduled stale intents cleanup, that could outlive the participant.
+  struct StaleIntentsTask {
+    explicit StaleIntentsTask(Impl* impl_) : impl(impl_) {}
+
+    std::mutex mutex;
+    Impl* impl;
+  };
+  std::shared_ptr<StaleIntentsTask> stale_intents_task_ =
+      std::make_shared<StaleIntentsTask>(this);
+  bool stale_intents_cleanup_running_ = false;
+  size_t removed_since_compaction_ = 0;
+  std::condition_variable stale_intents_cond_;
+};
+
+// Applies the next batch of intents of a big transaction, and schedules the following one.
+class TransactionParticipant::Impl::ApplyIntentsTask : public rpc::ThreadPoolTask {
+ public:
+  ApplyIntentsTask(Impl* impl, const TransactionApplyData& data,
+                   docdb::ApplyTransactionState apply_state)
+      : impl_(*impl), data_(data), apply_state_(std::move(apply_state)) {}
+
+  void Prepare(std::shared_ptr<ApplyIntentsTask> task) {
+    retain_self_ = std::move(task);
+  }
+
+  void Run() override {
+    if (impl_.ApplyNextBatch(data_, &apply_state_)) {
+      impl_.ScheduleApply(data_, std::move(apply_state_));
+    }
+  }
+
+  // Used when the thread pool is not available.
+  void RunInPlace() {
+    while (impl_.ApplyNextBatch(data_, &apply_state_)) {}
+    retain_self_ = nullptr;
+  }
+
+  void Done(const Status& status) override {
+    if (!status.ok()) {
+      // Task was dropped without running, for instance because of thread pool shutdown.
+      LOG_WITH_PREFIX(WARNING) << "Apply of " << data_.transaction_id << " from "
+                               << apply_state_.ToString() << " was not run: " << status;
+      impl_.ApplyFinished();
+    }
+    retain_self_ = nullptr;
+  }
+
+  virtual ~ApplyIntentsTask() {}
+
+ private:
+  const std::string& LogPrefix() const {
+    return impl_.LogPrefix();
+  }
+
+  Impl& impl_;
+  TransactionApplyData data_;
+  docdb::ApplyTransactionState apply_state_;
+  std::shared_ptr<ApplyIntentsTask> retain_self_;
 };
 
+void TransactionParticipant::Impl::ScheduleApply(
+    const TransactionApplyData& data, docdb::ApplyTransactionState apply_state) {
+  VLOG_WITH_PREFIX(4) << "Schedule apply of " << data.transaction_id << " from "
+                      << apply_state.ToString();
+  auto task = std::make_shared<ApplyIntentsTask>(this, data, std::move(apply_state));
+  task->Prepare(task);
+  if (participant_context_.EnqueueTransactionApply(task.get())) {
+    return;
+  }
+
+  // Thread pool is not available, for instance during bootstrap, so apply the rest in place.
+  task->RunInPlace();
+}
+
 TransactionParticipant::TransactionParticipant(
     TransactionParticipantContext* context, TransactionIntentApplier* applier)
     : impl_(new Impl(context, applier)) {
@@ -1165,10 +1687,25 @@ void TransactionParticipant::UpdateLastWriteId(const TransactionId& id, IntraTxn
   return impl_->UpdateLastWriteId(id, value);
 }
 
+void TransactionParticipant::IndexIntents(
+    const TransactionId& id, const rocksdb::WriteBatch& write_batch) {
+  impl_->IndexIntents(id, write_batch);
+}
+
+StrongIntentsInRange TransactionParticipant::LookupStrongIntents(
+    const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+    IntentRecords* records) {
+  return impl_->LookupStrongIntents(transaction_id, lower_bound, upper_bound, records);
+}
+
 HybridTime TransactionParticipant::LocalCommitTime(const TransactionId& id) {
   return impl_->LocalCommitTime(id);
 }
 
+SharedTransactionStatusCache* TransactionParticipant::shared_status_cache() {
+  return impl_->shared_status_cache();
+}
+
 size_t TransactionParticipant::TEST_CountIntents() const {
   return impl_->TEST_CountIntents();
 }
@@ -1177,6 +1714,10 @@ void TransactionParticipant::RequestStatusAt(const StatusRequest& request) {
   return impl_->RequestStatusAt(request);
 }
 
+void TransactionParticipant::RequestStatusesAt(const std::vector<StatusRequest>& requests) {
+  return impl_->RequestStatusesAt(requests);
+}
+
 int64_t TransactionParticipant::RegisterRequest() {
   return impl_->RegisterRequest();
 }
@@ -1211,6 +1752,10 @@ void TransactionParticipant::SetDB(rocksdb::DB* db) {
   impl_->SetDB(db);
 }
 
+void TransactionParticipant::Start() {
+  impl_->Start(this);
+}
+
 TransactionParticipantContext* TransactionParticipant::context() const {
   return impl_->participant_context();
 }
@@ -49,6 +49,12 @@ namespace yb {
 class HybridTime;
 class TransactionMetadataPB;
 
+namespace docdb {
+
+struct ApplyTransactionState;
+
+}
+
 namespace tserver {
 
 class TransactionStatePB;
@@ -74,7 +80,11 @@ struct TransactionApplyData {
 // Interface to object that should apply intents in RocksDB when transaction is applying.
 class TransactionIntentApplier {
  public:
-  virtual CHECKED_STATUS ApplyIntents(const TransactionApplyData& data) = 0;
+  // Applies intents of the transaction, continuing from the position stored in apply_state.
+  // Big transactions are applied by several calls, in this case apply_state is updated to the
+  // position where the next call should continue. Otherwise apply_state is inactive on return.
+  virtual CHECKED_STATUS ApplyIntents(
+      const TransactionApplyData& data, docdb::ApplyTransactionState* apply_state) = 0;
   virtual CHECKED_STATUS RemoveIntents(const TransactionId& transaction_id) = 0;
   virtual CHECKED_STATUS RemoveIntents(const TransactionIdSet& transactions) = 0;
   virtual HybridTime ApplierSafeTime(HybridTime min_allowed, CoarseTimePoint deadline) = 0;
@@ -90,6 +100,12 @@ class TransactionParticipantContext {
   virtual const std::shared_future<client::YBClient*>& client_future() const = 0;
   virtual const server::ClockPtr& clock_ptr() const = 0;
   virtual bool Enqueue(rpc::ThreadPoolTask* task) = 0;
+
+  // Enqueues background apply of transaction intents to the dedicated pool.
+  // Returns false if the pool is not available, the task is not invoked in this case.
+  // Otherwise Done of the task is always invoked, with error status if the task was dropped
+  // without running.
+  virtual bool EnqueueTransactionApply(rpc::ThreadPoolTask* task) = 0;
   virtual HybridTime Now() = 0;
   virtual void UpdateClock(HybridTime hybrid_time) = 0;
   virtual bool IsLeader() = 0;
@@ -119,16 +135,28 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void UpdateLastWriteId(const TransactionId& id, IntraTxnWriteId value);
 
+  // Adds strong write intents from the intents write batch of the transaction to the in-memory
+  // index. Should be invoked before the write batch is written to the DB.
+  void IndexIntents(const TransactionId& id, const rocksdb::WriteBatch& write_batch);
+
+  StrongIntentsInRange LookupStrongIntents(
+      const TransactionId& transaction_id, const Slice& lower_bound, const Slice& upper_bound,
+      IntentRecords* records) override;
+
   HybridTime LocalCommitTime(const TransactionId& id) override;
 
   void RequestStatusAt(const StatusRequest& request) override;
 
+  void RequestStatusesAt(const std::vector<StatusRequest>& requests) override;
+
   void Abort(const TransactionId& id, TransactionStatusCallback callback) override;
 
   void Handle(std::unique_ptr<tablet::UpdateTxnOperationState> request, int64_t term);
 
   void Cleanup(TransactionIdSet&& set) override;
 
+  SharedTransactionStatusCache* shared_status_cache() override;
+
   CHECKED_STATUS ProcessApply(const TransactionApplyData& data);
 
   // Used to pass arguments to ProcessReplicated.
@@ -144,6 +172,9 @@ class TransactionParticipant : public TransactionStatusManager {
 
   void SetDB(rocksdb::DB* db);
 
+  // Starts background cleanup of intents of transactions that were aborted long ago.
+  void Start();
+
   TransactionParticipantContext* context() const;
 
   size_t TEST_GetNumRunningTransactions() const;
@@ -0,0 +1,113 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <map>
+
+#include "yb/docdb/consensus_frontier.h"
+#include "yb/rocksdb/db.h"
+#include "yb/tools/bulk_load_sorter.h"
+#include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+using namespace yb::size_literals;
+
+namespace yb {
+namespace tools {
+
+class BulkLoadSorterTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    options_.create_if_missing = true;
+    rocksdb::DB* db = nullptr;
+    ASSERT_OK(rocksdb::DB::Open(options_, GetTestPath("db"), &db));
+    db_.reset(db);
+  }
+
+  void TearDown() override {
+    db_.reset();
+    YBTest::TearDown();
+  }
+
+  std::map<std::string, std::string> ReadAll() {
+    std::map<std::string, std::string> result;
+    std::unique_ptr<rocksdb::Iterator> iter(db_->NewIterator(rocksdb::ReadOptions()));
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      result.emplace(iter->key().ToBuffer(), iter->value().ToBuffer());
+    }
+    EXPECT_OK(iter->status());
+    return result;
+  }
+
+  rocksdb::Options options_;
+  std::unique_ptr<rocksdb::DB> db_;
+};
+
+TEST_F(BulkLoadSorterTest, SortAndIngest) {
+  constexpr int kNumBatches = 50;
+  constexpr int kRecordsPerBatch = 20;
+  constexpr int kNumKeys = 300;
+  constexpr size_t kNumFiles = 3;
+
+  BulkLoadSorter sorter(options_, GetTestPath("sort"), 4_KB);
+  ASSERT_OK(sorter.Init());
+
+  // Keys are added in random order, and most of them several times.
+  std::map<std::string, std::string> expected;
+  for (int i = 0; i != kNumBatches; ++i) {
+    rocksdb::WriteBatch write_batch;
+    for (int j = 0; j != kRecordsPerBatch; ++j) {
+      const auto key = Format("key$0", RandomUniformInt(0, kNumKeys - 1));
+      const auto value = Format("value$0_$1", i, j);
+      write_batch.Put(key, value);
+      expected[key] = value;
+    }
+    ASSERT_OK(sorter.Add(write_batch));
+  }
+  ASSERT_GT(sorter.num_runs(), 1);
+
+  docdb::ConsensusFrontiers frontiers;
+  docdb::set_hybrid_time(HybridTime::FromMicros(1000), &frontiers);
+  ASSERT_OK(sorter.Finish(db_.get(), kNumFiles, &frontiers));
+
+  ASSERT_EQ(expected, ReadAll());
+
+  std::vector<rocksdb::LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  ASSERT_GT(files.size(), 1);
+  ASSERT_LE(files.size(), kNumFiles);
+  for (const auto& file : files) {
+    ASSERT_EQ(0, file.largest.seqno);
+  }
+
+  auto flushed_frontier = db_->GetFlushedFrontier();
+  ASSERT_TRUE(flushed_frontier.get() != nullptr);
+  ASSERT_EQ(HybridTime::FromMicros(1000),
+            down_cast<docdb::ConsensusFrontier&>(*flushed_frontier).hybrid_time());
+
+  // Work directory is removed after the files are added.
+  ASSERT_FALSE(Env::Default()->FileExists(GetTestPath("sort")));
+}
+
+TEST_F(BulkLoadSorterTest, RejectsDeletes) {
+  BulkLoadSorter sorter(options_, GetTestPath("sort"), 4_KB);
+  ASSERT_OK(sorter.Init());
+  rocksdb::WriteBatch write_batch;
+  write_batch.Delete("key");
+  ASSERT_TRUE(sorter.Add(write_batch).IsNotSupported());
+}
+
+} // namespace tools
+} // namespace yb
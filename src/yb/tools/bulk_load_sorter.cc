@@ -0,0 +1,364 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/tools/bulk_load_sorter.h"
+
+#include <algorithm>
+#include <queue>
+
+#include "yb/rocksdb/env.h"
+#include "yb/rocksdb/immutable_options.h"
+#include "yb/rocksdb/metadata.h"
+#include "yb/rocksdb/sst_file_writer.h"
+#include "yb/rocksdb/util/coding.h"
+
+#include "yb/util/env.h"
+#include "yb/util/format.h"
+#include "yb/util/path_util.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+namespace yb {
+namespace tools {
+
+namespace {
+
+// Each run record is the fixed32 key size and the fixed32 value size followed by the key and the
+// value.
+constexpr size_t kRunRecordHeaderSize = 8;
+
+// Run files are written by chunks of this size.
+constexpr size_t kRunWriteBufferSize = 1_MB;
+
+} // namespace
+
+class BulkLoadSorter::Collector : public rocksdb::WriteBatch::Handler {
+ public:
+  explicit Collector(Records* records) : records_(records) {}
+
+  size_t bytes() const {
+    return bytes_;
+  }
+
+  CHECKED_STATUS PutCF(uint32_t column_family_id, const Slice& key, const Slice& value) override {
+    records_->push_back({key.ToBuffer(), value.ToBuffer()});
+    bytes_ += key.size() + value.size();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS DeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return STATUS(NotSupported, "Bulk load does not support deletes");
+  }
+
+  CHECKED_STATUS SingleDeleteCF(uint32_t column_family_id, const Slice& key) override {
+    return STATUS(NotSupported, "Bulk load does not support deletes");
+  }
+
+  CHECKED_STATUS MergeCF(uint32_t column_family_id, const Slice& key,
+                         const Slice& value) override {
+    return STATUS(NotSupported, "Bulk load does not support merges");
+  }
+
+  CHECKED_STATUS Frontiers(const rocksdb::UserFrontiers&) override {
+    return Status::OK();
+  }
+
+ private:
+  Records* const records_;
+  size_t bytes_ = 0;
+};
+
+// Reads records of a run file in the order they were written.
+class BulkLoadSorter::RunReader {
+ public:
+  RunReader(rocksdb::Env* env, std::string file_name)
+      : env_(env), file_name_(std::move(file_name)) {}
+
+  CHECKED_STATUS Open() {
+    RETURN_NOT_OK(env_->NewSequentialFile(file_name_, &file_, rocksdb::EnvOptions()));
+    return Next();
+  }
+
+  bool Valid() const {
+    return valid_;
+  }
+
+  const Record& record() const {
+    return record_;
+  }
+
+  CHECKED_STATUS Next() {
+    char header[kRunRecordHeaderSize];
+    Slice header_slice;
+    RETURN_NOT_OK(file_->Read(sizeof(header), &header_slice, header));
+    if (header_slice.empty()) {
+      valid_ = false;
+      return Status::OK();
+    }
+    if (header_slice.size() != sizeof(header)) {
+      return STATUS_FORMAT(Corruption, "Truncated record header in $0", file_name_);
+    }
+    const size_t key_size = rocksdb::DecodeFixed32(header_slice.cdata());
+    const size_t value_size = rocksdb::DecodeFixed32(header_slice.cdata() + 4);
+    RETURN_NOT_OK(ReadString(key_size, &record_.key));
+    RETURN_NOT_OK(ReadString(value_size, &record_.value));
+    valid_ = true;
+    return Status::OK();
+  }
+
+ private:
+  CHECKED_STATUS ReadString(size_t size, std::string* out) {
+    scratch_.resize(size);
+    Slice result;
+    RETURN_NOT_OK(file_->Read(size, &result, &scratch_[0]));
+    if (result.size() != size) {
+      return STATUS_FORMAT(Corruption, "Truncated record in $0", file_name_);
+    }
+    out->assign(result.cdata(), result.size());
+    return Status::OK();
+  }
+
+  rocksdb::Env* const env_;
+  const std::string file_name_;
+  std::unique_ptr<rocksdb::SequentialFile> file_;
+  std::string scratch_;
+  Record record_;
+  bool valid_ = false;
+};
+
+// Merges sorted runs and the sorted buffer. Runs are ordered from the oldest to the newest one, and
+// the buffer is newer than all runs.
+class BulkLoadSorter::Merger {
+ public:
+  Merger(std::vector<std::unique_ptr<RunReader>> runs, const Records* buffer)
+      : runs_(std::move(runs)), buffer_(buffer) {
+    for (size_t i = 0; i <= runs_.size(); ++i) {
+      if (SourceValid(i)) {
+        heap_.push(i);
+      }
+    }
+  }
+
+  bool Valid() const {
+    return !heap_.empty();
+  }
+
+  const Record& record() const {
+    return SourceRecord(heap_.top());
+  }
+
+  // Moves to the next key, skipping older records with the current key.
+  CHECKED_STATUS Next() {
+    const std::string key = record().key;
+    while (!heap_.empty() && SourceRecord(heap_.top()).key == key) {
+      const size_t source = heap_.top();
+      heap_.pop();
+      RETURN_NOT_OK(SourceNext(source));
+      if (SourceValid(source)) {
+        heap_.push(source);
+      }
+    }
+    return Status::OK();
+  }
+
+ private:
+  bool SourceValid(size_t source) const {
+    return source < runs_.size() ? runs_[source]->Valid() : buffer_position_ < buffer_->size();
+  }
+
+  const Record& SourceRecord(size_t source) const {
+    return source < runs_.size() ? runs_[source]->record() : (*buffer_)[buffer_position_];
+  }
+
+  CHECKED_STATUS SourceNext(size_t source) {
+    if (source < runs_.size()) {
+      return runs_[source]->Next();
+    }
+    ++buffer_position_;
+    return Status::OK();
+  }
+
+  // Orders sources by their current keys, and the newest source first for the same key.
+  class Greater {
+   public:
+    explicit Greater(const Merger* merger) : merger_(merger) {}
+
+    bool operator()(size_t lhs, size_t rhs) const {
+      const int cmp = merger_->SourceRecord(lhs).key.compare(merger_->SourceRecord(rhs).key);
+      return cmp != 0 ? cmp > 0 : lhs < rhs;
+    }
+
+   private:
+    const Merger* merger_;
+  };
+
+  std::vector<std::unique_ptr<RunReader>> runs_;
+  const Records* buffer_;
+  size_t buffer_position_ = 0;
+  std::priority_queue<size_t, std::vector<size_t>, Greater> heap_{Greater(this)};
+};
+
+BulkLoadSorter::BulkLoadSorter(
+    const rocksdb::Options& options, std::string work_dir, size_t buffer_size)
+    : options_(options), work_dir_(std::move(work_dir)), buffer_size_(buffer_size) {
+}
+
+BulkLoadSorter::~BulkLoadSorter() {
+}
+
+Status BulkLoadSorter::Init() {
+  auto env = Env::Default();
+  if (env->FileExists(work_dir_)) {
+    RETURN_NOT_OK(env->DeleteRecursively(work_dir_));
+  }
+  return env->CreateDir(work_dir_);
+}
+
+Status BulkLoadSorter::Add(const rocksdb::WriteBatch& write_batch) {
+  Records records;
+  Collector collector(&records);
+  RETURN_NOT_OK(write_batch.Iterate(&collector));
+  const size_t bytes = collector.bytes();
+
+  Records run;
+  size_t run_index;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer_.insert(buffer_.end(), std::make_move_iterator(records.begin()),
+                   std::make_move_iterator(records.end()));
+    buffer_bytes_ += bytes;
+    total_bytes_ += bytes;
+    if (buffer_bytes_ < buffer_size_) {
+      return Status::OK();
+    }
+    run.swap(buffer_);
+    buffer_bytes_ = 0;
+    // Runs are numbered in the order their records were added, so the merge knows which record
+    // is the latest one.
+    run_index = num_runs_++;
+  }
+
+  SortAndDeduplicate(&run);
+  return WriteRun(run_index, run);
+}
+
+void BulkLoadSorter::SortAndDeduplicate(Records* records) {
+  std::stable_sort(records->begin(), records->end(), [](const Record& lhs, const Record& rhs) {
+    return lhs.key < rhs.key;
+  });
+  // Move the last record of each group of equal keys to the front of the group.
+  auto out = records->begin();
+  for (auto it = records->begin(); it != records->end();) {
+    auto next = it + 1;
+    while (next != records->end() && next->key == it->key) {
+      it = next++;
+    }
+    if (out != it) {
+      *out = std::move(*it);
+    }
+    ++out;
+    it = next;
+  }
+  records->erase(out, records->end());
+}
+
+std::string BulkLoadSorter::RunFileName(size_t run_index) const {
+  return JoinPathSegments(work_dir_, Format("run-$0", run_index));
+}
+
+Status BulkLoadSorter::WriteRun(size_t run_index, const Records& records) {
+  std::unique_ptr<rocksdb::WritableFile> file;
+  const auto file_name = RunFileName(run_index);
+  RETURN_NOT_OK(options_.env->NewWritableFile(file_name, &file, rocksdb::EnvOptions()));
+  std::string buffer;
+  buffer.reserve(kRunWriteBufferSize);
+  for (const auto& record : records) {
+    rocksdb::PutFixed32(&buffer, static_cast<uint32_t>(record.key.size()));
+    rocksdb::PutFixed32(&buffer, static_cast<uint32_t>(record.value.size()));
+    buffer += record.key;
+    buffer += record.value;
+    if (buffer.size() >= kRunWriteBufferSize) {
+      RETURN_NOT_OK(file->Append(buffer));
+      buffer.clear();
+    }
+  }
+  if (!buffer.empty()) {
+    RETURN_NOT_OK(file->Append(buffer));
+  }
+  LOG(INFO) << "Wrote " << records.size() << " sorted records to " << file_name;
+  return file->Close();
+}
+
+size_t BulkLoadSorter::num_runs() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_runs_;
+}
+
+Status BulkLoadSorter::Finish(
+    rocksdb::DB* db, size_t num_files, const rocksdb::UserFrontiers* frontiers) {
+  // All writers are done at this point, so the state could be accessed without the lock.
+  SortAndDeduplicate(&buffer_);
+  std::vector<std::unique_ptr<RunReader>> runs;
+  for (size_t i = 0; i != num_runs_; ++i) {
+    runs.push_back(std::make_unique<RunReader>(options_.env, RunFileName(i)));
+    RETURN_NOT_OK(runs.back()->Open());
+  }
+  Merger merger(std::move(runs), &buffer_);
+
+  std::shared_ptr<const rocksdb::UserFrontiers> file_frontiers;
+  if (frontiers) {
+    file_frontiers = frontiers->Clone();
+  }
+  const size_t target_file_size = std::max<size_t>(total_bytes_ / std::max<size_t>(num_files, 1), 1);
+  const rocksdb::ImmutableCFOptions ioptions(options_);
+  rocksdb::SstFileWriter writer(rocksdb::EnvOptions(), ioptions, options_.comparator);
+  size_t num_written_files = 0;
+  size_t file_bytes = 0;
+  bool file_open = false;
+
+  auto finish_file = [&]() -> Status {
+    rocksdb::ExternalSstFileInfo file_info;
+    RETURN_NOT_OK(writer.Finish(&file_info));
+    file_open = false;
+    file_info.frontiers = file_frontiers;
+    LOG(INFO) << "Adding " << file_info.file_path << " with " << file_info.num_entries
+              << " records";
+    return db->AddFile(&file_info, true /* move_file */);
+  };
+
+  while (merger.Valid()) {
+    if (!file_open) {
+      RETURN_NOT_OK(writer.Open(JoinPathSegments(work_dir_, Format("$0.sst", num_written_files))));
+      ++num_written_files;
+      file_bytes = 0;
+      file_open = true;
+    }
+    const auto& record = merger.record();
+    RETURN_NOT_OK(writer.Add(record.key, record.value));
+    file_bytes += record.key.size() + record.value.size();
+    RETURN_NOT_OK(merger.Next());
+    if (file_bytes >= target_file_size && num_written_files < num_files && merger.Valid()) {
+      RETURN_NOT_OK(finish_file());
+    }
+  }
+  if (file_open) {
+    RETURN_NOT_OK(finish_file());
+  }
+
+  buffer_.clear();
+  return Env::Default()->DeleteRecursively(work_dir_);
+}
+
+} // namespace tools
+} // namespace yb
@@ -0,0 +1,89 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_TOOLS_BULK_LOAD_SORTER_H
+#define YB_TOOLS_BULK_LOAD_SORTER_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/rocksdb/db.h"
+#include "yb/rocksdb/options.h"
+#include "yb/rocksdb/write_batch.h"
+
+#include "yb/util/status.h"
+
+namespace yb {
+namespace tools {
+
+// Sorts the records produced by bulk load for a single tablet and writes them to final SST files
+// that are added to the tablet RocksDB with DB::AddFile, so records are written to disk at most
+// twice: once to a sorted run when the buffer is full, and once to the final SST file.
+//
+// Records are buffered in memory until the buffer size is exceeded, then the buffer is sorted and
+// spilled to a run file in the work directory. Finish merges the runs with the rest of the buffer.
+// When several records have the same key, the one added last wins, as with memtable writes.
+class BulkLoadSorter {
+ public:
+  BulkLoadSorter(const rocksdb::Options& options, std::string work_dir, size_t buffer_size);
+  ~BulkLoadSorter();
+
+  BulkLoadSorter(const BulkLoadSorter&) = delete;
+  void operator=(const BulkLoadSorter&) = delete;
+
+  // Creates an empty work directory, removing files left there by a previous run.
+  CHECKED_STATUS Init();
+
+  // Adds all records of the write batch. It should contain only puts. Thread safe.
+  CHECKED_STATUS Add(const rocksdb::WriteBatch& write_batch);
+
+  // Writes all added records to at most num_files SST files, adds them to db and removes the work
+  // directory. frontiers, if specified, are stored in the metadata of every added file.
+  CHECKED_STATUS Finish(
+      rocksdb::DB* db, size_t num_files, const rocksdb::UserFrontiers* frontiers = nullptr);
+
+  size_t num_runs() const;
+
+ private:
+  struct Record {
+    std::string key;
+    std::string value;
+  };
+  typedef std::vector<Record> Records;
+
+  class Collector;
+  class RunReader;
+  class Merger;
+
+  // Sorts records by key, keeping only the last added record for each key.
+  static void SortAndDeduplicate(Records* records);
+
+  CHECKED_STATUS WriteRun(size_t run_index, const Records& records);
+  std::string RunFileName(size_t run_index) const;
+
+  const rocksdb::Options options_;
+  const std::string work_dir_;
+  const size_t buffer_size_;
+
+  mutable std::mutex mutex_;
+  Records buffer_;
+  size_t buffer_bytes_ = 0;
+  size_t total_bytes_ = 0;
+  size_t num_runs_ = 0;
+};
+
+} // namespace tools
+} // namespace yb
+
+#endif // YB_TOOLS_BULK_LOAD_SORTER_H
@@ -28,12 +28,14 @@
 #include "yb/common/schema.h"
 #include "yb/common/wire_protocol.h"
 #include "yb/common/ql_protocol.pb.h"
+#include "yb/docdb/consensus_frontier.h"
 #include "yb/docdb/docdb.h"
 #include "yb/docdb/cql_operation.h"
 #include "yb/docdb/doc_operation.h"
 #include "yb/rpc/messenger.h"
 #include "yb/rpc/rpc_controller.h"
 #include "yb/tools/bulk_load_docdb_util.h"
+#include "yb/tools/bulk_load_sorter.h"
 #include "yb/tools/bulk_load_utils.h"
 #include "yb/tools/yb-generate_partitions.h"
 #include "yb/tserver/tserver_service.proxy.h"
@@ -84,6 +86,13 @@ DEFINE_int32(bulk_load_max_background_flushes, 2, "Number of flushes to perform
 DEFINE_uint64(bulk_load_num_files_per_tablet, 5,
               "Determines how to compact the data of a tablet to ensure we have only a certain "
               "number of sst files per tablet");
+DEFINE_bool(bulk_load_ingest_sorted_files, false,
+            "Sort rows of each tablet externally and write them directly to at most "
+            "bulk_load_num_files_per_tablet SST files, which are added to the tablet RocksDB "
+            "with AddFile, instead of writing rows through memtables and compacting flushed files.");
+DEFINE_int64(bulk_load_sort_buffer_size_bytes, 1_GB,
+             "Amount of row data buffered in memory before it is sorted and spilled to disk, when "
+             "bulk_load_ingest_sorted_files is set");
 
 namespace yb {
 namespace tools {
@@ -93,7 +102,8 @@ namespace {
 class BulkLoadTask : public Runnable {
  public:
   BulkLoadTask(vector<pair<TabletId, string>> rows, BulkLoadDocDBUtil *db_fixture,
-               const YBTable *table, YBPartitionGenerator *partition_generator);
+               BulkLoadSorter *sorter, const YBTable *table,
+               YBPartitionGenerator *partition_generator);
   void Run();
  private:
   CHECKED_STATUS PopulateColumnValue(const string &column,
@@ -107,6 +117,8 @@ class BulkLoadTask : public Runnable {
                            YBPartitionGenerator *const partition_generator);
   vector<pair<TabletId, string>> rows_;
   BulkLoadDocDBUtil *const db_fixture_;
+  // Set when rows are ingested as sorted files instead of being written to db_fixture_.
+  BulkLoadSorter *const sorter_;
   const YBTable *const table_;
   YBPartitionGenerator *const partition_generator_;
 };
@@ -131,12 +143,14 @@ class BulkLoad {
                                         vector<pair<TabletId, string>> rows);
   CHECKED_STATUS RetryableSubmit(vector<pair<TabletId, string>> rows);
   CHECKED_STATUS CompactFiles();
+  CHECKED_STATUS IngestSortedFiles();
 
   std::unique_ptr<YBClient> client_;
   shared_ptr<YBTable> table_;
   unique_ptr<YBPartitionGenerator> partition_generator_;
   gscoped_ptr<ThreadPool> thread_pool_;
   unique_ptr<BulkLoadDocDBUtil> db_fixture_;
+  unique_ptr<BulkLoadSorter> sorter_;
 };
 
 CompactionTask::CompactionTask(const vector<string>& sst_filenames, BulkLoadDocDBUtil* db_fixture)
@@ -157,10 +171,11 @@ void CompactionTask::Run() {
 }
 
 BulkLoadTask::BulkLoadTask(vector<pair<TabletId, string>> rows,
-                           BulkLoadDocDBUtil *db_fixture, const YBTable *table,
-                           YBPartitionGenerator *partition_generator)
+                           BulkLoadDocDBUtil *db_fixture, BulkLoadSorter *sorter,
+                           const YBTable *table, YBPartitionGenerator *partition_generator)
     : rows_(std::move(rows)),
       db_fixture_(db_fixture),
+      sorter_(sorter),
       table_(table),
       partition_generator_(partition_generator) {
 }
@@ -177,6 +192,15 @@ void BulkLoadTask::Run() {
                        &doc_write_batch, partition_generator_));
   }
 
+  if (sorter_) {
+    rocksdb::WriteBatch rocksdb_write_batch;
+    CHECK_OK(db_fixture_->PopulateRocksDBWriteBatch(
+        doc_write_batch, &rocksdb_write_batch, HybridTime::FromMicros(kYugaByteMicrosecondEpoch),
+        /* decode_dockey */ false, /* increment_write_id */ false));
+    CHECK_OK(sorter_->Add(rocksdb_write_batch));
+    return;
+  }
+
   // Flush the batch.
   CHECK_OK(db_fixture_->WriteToRocksDB(
       doc_write_batch, HybridTime::FromMicros(kYugaByteMicrosecondEpoch),
@@ -301,7 +325,8 @@ Status BulkLoadTask::InsertRow(const string &row,
 
 Status BulkLoad::RetryableSubmit(vector<pair<TabletId, string>> rows) {
   auto runnable = std::make_shared<BulkLoadTask>(
-      std::move(rows), db_fixture_.get(), table_.get(), partition_generator_.get());
+      std::move(rows), db_fixture_.get(), sorter_.get(), table_.get(),
+      partition_generator_.get());
 
   Status s;
   do {
@@ -362,6 +387,16 @@ Status BulkLoad::CompactFiles() {
   return Status::OK();
 }
 
+Status BulkLoad::IngestSortedFiles() {
+  // All rows are written at the same hybrid time, and there is no Raft log entry for them.
+  docdb::ConsensusFrontiers frontiers;
+  docdb::set_hybrid_time(HybridTime::FromMicros(kYugaByteMicrosecondEpoch), &frontiers);
+  RETURN_NOT_OK(sorter_->Finish(
+      db_fixture_->rocksdb(), FLAGS_bulk_load_num_files_per_tablet, &frontiers));
+  sorter_.reset();
+  return Status::OK();
+}
+
 Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
                                         vector<pair<TabletId, string>> rows) {
   if (!db_fixture_) {
@@ -375,11 +410,15 @@ Status BulkLoad::FinishTabletProcessing(const TabletId &tablet_id,
   // Wait for all tasks for the tablet to complete.
   thread_pool_->Wait();
 
-  // Now flush the DB.
-  RETURN_NOT_OK(db_fixture_->FlushRocksDbAndWait());
+  if (sorter_) {
+    RETURN_NOT_OK(IngestSortedFiles());
+  } else {
+    // Now flush the DB.
+    RETURN_NOT_OK(db_fixture_->FlushRocksDbAndWait());
 
-  // Perform the necessary compactions.
-  RETURN_NOT_OK(CompactFiles());
+    // Perform the necessary compactions.
+    RETURN_NOT_OK(CompactFiles());
+  }
 
   if (!FLAGS_export_files) {
     return Status::OK();
@@ -457,6 +496,11 @@ CHECKED_STATUS BulkLoad::InitDBUtil(const TabletId &tablet_id) {
                                           FLAGS_bulk_load_max_background_flushes));
   RETURN_NOT_OK(db_fixture_->InitRocksDBOptions());
   RETURN_NOT_OK(db_fixture_->DisableCompactions()); // This opens rocksdb.
+  if (FLAGS_bulk_load_ingest_sorted_files) {
+    sorter_.reset(new BulkLoadSorter(db_fixture_->options(), db_fixture_->rocksdb_dir() + ".sort",
+                                     FLAGS_bulk_load_sort_buffer_size_bytes));
+    RETURN_NOT_OK(sorter_->Init());
+  }
   return Status::OK();
 }
 
@@ -59,14 +59,34 @@ DEFINE_int32(checksum_timeout_sec, 120,
              "before timing out.");
 DEFINE_int32(checksum_scan_concurrency, 4,
              "Number of concurrent checksum scans to execute per tablet server.");
+DEFINE_bool(checksum_snapshot, true,
+            "Should the checksum scanner use a snapshot scan, i.e. checksum all replicas at the "
+            "same hybrid time.");
+DEFINE_uint64(checksum_snapshot_hybrid_time, ChecksumOptions::kCurrentHybridTime,
+              "Hybrid time to use for snapshot checksum scans, defaults to the current hybrid "
+              "time of a tablet server. Should be newer than the history retention interval "
+              "of the tablet servers, when all scans are started.");
+
+constexpr uint64_t ChecksumOptions::kCurrentHybridTime;
 
 ChecksumOptions::ChecksumOptions()
     : timeout(MonoDelta::FromSeconds(FLAGS_checksum_timeout_sec)),
-      scan_concurrency(FLAGS_checksum_scan_concurrency) {}
+      scan_concurrency(FLAGS_checksum_scan_concurrency),
+      use_snapshot(FLAGS_checksum_snapshot),
+      snapshot_hybrid_time(FLAGS_checksum_snapshot_hybrid_time) {}
 
 ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency)
     : timeout(std::move(timeout)),
-      scan_concurrency(scan_concurrency) {}
+      scan_concurrency(scan_concurrency),
+      use_snapshot(FLAGS_checksum_snapshot),
+      snapshot_hybrid_time(FLAGS_checksum_snapshot_hybrid_time) {}
+
+ChecksumOptions::ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot,
+                                 uint64_t snapshot_hybrid_time)
+    : timeout(std::move(timeout)),
+      scan_concurrency(scan_concurrency),
+      use_snapshot(use_snapshot),
+      snapshot_hybrid_time(snapshot_hybrid_time) {}
 
 YsckCluster::~YsckCluster() {
 }
@@ -183,30 +203,46 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
   typedef std::unordered_map<std::string, TableResults> ReplicaResultMap;
   typedef std::unordered_map<std::string, ReplicaResultMap> TabletResultMap;
 
-  // Initialize reporter with the number of replicas being queried.
-  explicit ChecksumResultReporter(int num_tablet_replicas)
-      : responses_(num_tablet_replicas) {
+  // Initialize reporter with the number of results expected for each tablet, i.e. the number
+  // of replicas being queried.
+  explicit ChecksumResultReporter(std::unordered_map<std::string, int> expected_results)
+      : responses_(TotalResults(expected_results)),
+        expected_results_(std::move(expected_results)) {
   }
 
   // Write an entry to the result map indicating a response from the remote.
+  // When all replicas of the tablet have reported, the result of the tablet is logged, so
+  // divergent tablets are reported without waiting for the whole cluster to be checksummed.
   void ReportResult(const std::string& tablet_id,
                     const std::string& replica_uuid,
                     const Status& status,
                     uint64_t checksum) {
-    std::lock_guard<simple_spinlock> guard(lock_);
-    unordered_map<string, TableResults>& replica_results =
-        LookupOrInsert(&checksums_, tablet_id, unordered_map<string, TableResults>());
-    if (replica_results.find(replica_uuid) == replica_results.end()) {
-      TableResults table_results(1, ResultPair(status, checksum));
-      replica_results[replica_uuid] = table_results;
-    } else {
-      replica_results[replica_uuid].push_back(ResultPair(status, checksum));
+    std::string tablet_result;
+    bool mismatch = false;
+    {
+      std::lock_guard<simple_spinlock> guard(lock_);
+      unordered_map<string, TableResults>& replica_results =
+          LookupOrInsert(&checksums_, tablet_id, unordered_map<string, TableResults>());
+      if (replica_results.find(replica_uuid) == replica_results.end()) {
+        TableResults table_results(1, ResultPair(status, checksum));
+        replica_results[replica_uuid] = table_results;
+      } else {
+        replica_results[replica_uuid].push_back(ResultPair(status, checksum));
+      }
+      if (++reported_results_[tablet_id] == FindWithDefault(expected_results_, tablet_id, 0)) {
+        tablet_result = TabletResult(tablet_id, replica_results, &mismatch);
+      }
+    }
+    if (mismatch) {
+      LOG(ERROR) << tablet_result;
+    } else if (!tablet_result.empty()) {
+      LOG(INFO) << tablet_result;
     }
     responses_.CountDown();
   }
 
   // Blocks until either the number of results plus errors reported equals
-  // num_tablet_replicas (from the constructor), or until the timeout expires,
+  // the expected number of results (from the constructor), or until the timeout expires,
   // whichever comes first.
   // Returns false if the timeout expired before all responses came in.
   // Otherwise, returns true.
@@ -229,10 +265,49 @@ class ChecksumResultReporter : public RefCountedThreadSafe<ChecksumResultReporte
   void HandleResponse(const std::string& tablet_id, const std::string& replica_uuid,
                       const Status& status, uint64_t checksum);
 
+  static int TotalResults(const std::unordered_map<std::string, int>& expected_results) {
+    int result = 0;
+    for (const auto& entry : expected_results) {
+      result += entry.second;
+    }
+    return result;
+  }
+
+  static std::string TabletResult(const std::string& tablet_id,
+                                  const ReplicaResultMap& replica_results,
+                                  bool* mismatch) {
+    int num_errors = 0;
+    bool seen_first_checksum = false;
+    uint64_t first_checksum = 0;
+    for (const auto& replica : replica_results) {
+      for (const ResultPair& result : replica.second) {
+        if (!result.first.ok()) {
+          ++num_errors;
+        } else if (!seen_first_checksum) {
+          seen_first_checksum = true;
+          first_checksum = result.second;
+        } else if (result.second != first_checksum) {
+          *mismatch = true;
+        }
+      }
+    }
+    if (*mismatch) {
+      return Format(">> Mismatch found in tablet $0", tablet_id);
+    }
+    if (num_errors != 0) {
+      return Format("T $0: $1 replica errors", tablet_id, num_errors);
+    }
+    return Format("T $0: $1 replicas match, checksum: $2",
+                  tablet_id, replica_results.size(), first_checksum);
+  }
+
   CountDownLatch responses_;
-  mutable simple_spinlock lock_; // Protects 'checksums_'.
+  const std::unordered_map<std::string, int> expected_results_;
+  mutable simple_spinlock lock_; // Protects 'checksums_' and 'reported_results_'.
   // checksums_ is an unordered_map of { tablet_id : { replica_uuid : checksum } }.
   TabletResultMap checksums_;
+  // Number of results reported for each tablet.
+  std::unordered_map<std::string, int> reported_results_;
 };
 
 // Queue of tablet replicas for an individual tablet server.
@@ -324,7 +399,7 @@ Status Ysck::ChecksumData(const vector<string>& tables,
   typedef unordered_map<shared_ptr<YsckTabletServer>, TabletQueue> TabletServerQueueMap;
 
   TabletServerQueueMap tablet_server_queues;
-  scoped_refptr<ChecksumResultReporter> reporter(new ChecksumResultReporter(num_tablet_replicas));
+  std::unordered_map<std::string, int> expected_results;
 
   // Create a queue of checksum callbacks grouped by the tablet server.
   for (const TabletTableMap::value_type& entry : tablet_table_map) {
@@ -337,9 +412,23 @@ Status Ysck::ChecksumData(const vector<string>& tables,
         const TabletQueue& queue =
             LookupOrInsertNewSharedPtr(&tablet_server_queues, ts, num_tablet_replicas);
         CHECK_EQ(QUEUE_SUCCESS, queue->Put(make_pair(table->schema(), tablet->id())));
+        ++expected_results[tablet->id()];
       }
     }
   }
+  scoped_refptr<ChecksumResultReporter> reporter(
+      new ChecksumResultReporter(std::move(expected_results)));
+
+  // All replicas are checksummed at the same hybrid time, so they are expected to match even if
+  // the tablets are being written.
+  if (options.use_snapshot &&
+      options.snapshot_hybrid_time == ChecksumOptions::kCurrentHybridTime &&
+      !tablet_server_queues.empty()) {
+    const shared_ptr<YsckTabletServer>& ts = tablet_server_queues.begin()->first;
+    RETURN_NOT_OK_PREPEND(ts->CurrentHybridTime(&options.snapshot_hybrid_time),
+                          Substitute("Failed to get current hybrid time from $0", ts->uuid()));
+    LOG(INFO) << "Using snapshot hybrid time: " << options.snapshot_hybrid_time;
+  }
 
   // Kick off checksum scans in parallel. For each tablet server, we start
   // scan_concurrency scans. Each callback then initiates one additional
@@ -53,16 +53,28 @@ namespace tools {
 // Options for checksum scans.
 struct ChecksumOptions {
  public:
+  // A snapshot hybrid time of this value means to use the current hybrid time of a tablet server.
+  static constexpr uint64_t kCurrentHybridTime = 0;
 
   ChecksumOptions();
 
   ChecksumOptions(MonoDelta timeout, int scan_concurrency);
 
+  ChecksumOptions(MonoDelta timeout, int scan_concurrency, bool use_snapshot,
+                  uint64_t snapshot_hybrid_time);
+
   // The maximum total time to wait for results to come back from all replicas.
   MonoDelta timeout;
 
   // The maximum number of concurrent checksum scans to run per tablet server.
   int scan_concurrency;
+
+  // Whether all replicas are checksummed at the same hybrid time, so they could be compared while
+  // the tablets are being written.
+  bool use_snapshot;
+
+  // The hybrid time to checksum at, if use_snapshot is set.
+  uint64_t snapshot_hybrid_time;
 };
 
 // Representation of a tablet replica on a tablet server.
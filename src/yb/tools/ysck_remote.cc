@@ -146,7 +146,13 @@ class ChecksumStepper {
   void SendRequest() {
     req_.set_tablet_id(tablet_id_);
     req_.set_consistency_level(YBConsistencyLevel::CONSISTENT_PREFIX);
-    rpc_.set_timeout(GetDefaultTimeout());
+    if (options_.use_snapshot) {
+      req_.set_read_hybrid_time(options_.snapshot_hybrid_time);
+    }
+    // The whole tablet is checksummed by one request, so it could take as long as the checksum
+    // of the whole cluster.
+    rpc_.set_timeout(options_.timeout.ToMilliseconds() > FLAGS_timeout_ms
+        ? options_.timeout : GetDefaultTimeout());
     auto handler = std::make_unique<ChecksumCallbackHandler>(this);
     rpc::ResponseCallback cb = std::bind(&ChecksumCallbackHandler::Run, handler.get());
     proxy_->ChecksumAsync(req_, &resp_, &rpc_, cb);
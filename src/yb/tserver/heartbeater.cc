@@ -33,6 +33,7 @@
 #include "yb/tserver/heartbeater.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <mutex>
 
@@ -48,6 +49,7 @@
 #include "yb/server/server_base.proxy.h"
 #include "yb/server/webserver.h"
 #include "yb/tablet/tablet.h"
+#include "yb/tablet/tablet_metrics.h"
 #include "yb/tserver/tablet_server.h"
 #include "yb/tserver/tablet_server_options.h"
 #include "yb/tserver/ts_tablet_manager.h"
@@ -75,6 +77,11 @@ DEFINE_int32(heartbeat_max_failures_before_backoff, 3,
              "rather than retrying.");
 TAG_FLAG(heartbeat_max_failures_before_backoff, advanced);
 
+DEFINE_bool(heartbeat_report_tablet_loads, true,
+            "Whether to report the read and write rates and the SST size of each tablet to the "
+            "master, to let the load balancer weigh tablets by their load.");
+TAG_FLAG(heartbeat_report_tablet_loads, advanced);
+
 DEFINE_bool(tserver_disable_heartbeat_test_only, false, "Should heartbeat be disabled");
 TAG_FLAG(tserver_disable_heartbeat_test_only, unsafe);
 TAG_FLAG(tserver_disable_heartbeat_test_only, hidden);
@@ -125,6 +132,12 @@ class Heartbeater::Thread {
   void SetupCommonField(master::TSToMasterCommonPB* common);
   bool IsCurrentThread() const;
   uint64_t CalculateUptime();
+  // Adds the load of the tablet since the previous metrics submission, which was interval_sec
+  // seconds ago, to metrics. Stores the current ops of the tablet to tablet_ops.
+  void AddTabletLoad(
+      tablet::Tablet* tablet, uint64_t sst_file_size, double interval_sec,
+      std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>>* tablet_ops,
+      master::TServerMetricsPB* metrics);
 
   const std::string& LogPrefix() const {
     return log_prefix_;
@@ -168,6 +181,10 @@ class Heartbeater::Thread {
   // True once at least one heartbeat has been sent.
   bool has_heartbeated_ = false;
 
+  // True when the last acknowledged tablet report did not include all changed tablets, so the
+  // next heartbeat should be sent without waiting for the interval.
+  bool has_remaining_tablets_to_report_ = false;
+
   // The number of heartbeats which have failed in a row.
   // This is tracked so as to back-off heartbeating.
   int consecutive_failed_heartbeats_ = 0;
@@ -190,6 +207,9 @@ class Heartbeater::Thread {
   uint64_t prev_reads_ = 0;
   uint64_t prev_writes_ = 0;
 
+  // Stores the read and write ops of each tablet, for computing per tablet iops.
+  std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>> prev_tablet_ops_;
+
   MonoTime start_time_;
 
   rpc::Rpcs rpcs_;
@@ -335,7 +355,8 @@ int Heartbeater::Thread::GetMillisUntilNextHeartbeat() const {
   // If the master needs something from us, we should immediately
   // send another heartbeat with that info, rather than waiting for the interval.
   if (last_hb_response_.needs_reregister() ||
-      last_hb_response_.needs_full_tablet_report()) {
+      last_hb_response_.needs_full_tablet_report() ||
+      has_remaining_tablets_to_report_) {
     return GetMinimumHeartbeatMillis();
   }
 
@@ -349,6 +370,33 @@ uint64_t Heartbeater::Thread::CalculateUptime() {
   return uptime_seconds;
 }
 
+void Heartbeater::Thread::AddTabletLoad(
+    tablet::Tablet* tablet, uint64_t sst_file_size, double interval_sec,
+    std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>>* tablet_ops,
+    master::TServerMetricsPB* metrics) {
+  auto* tablet_metrics = tablet->metrics();
+  uint64_t num_reads = tablet_metrics->ql_read_latency->TotalCount() +
+                       tablet_metrics->redis_read_latency->TotalCount();
+  uint64_t num_writes =
+      tablet_metrics->write_op_duration_client_propagated_consistency->TotalCount() +
+      tablet_metrics->write_op_duration_commit_wait_consistency->TotalCount();
+  const auto& tablet_id = tablet->tablet_id();
+  (*tablet_ops)[tablet_id] = std::make_pair(num_reads, num_writes);
+
+  auto* tablet_load = metrics->add_tablet_loads();
+  tablet_load->set_tablet_id(tablet_id);
+  tablet_load->set_sst_file_size(sst_file_size);
+  // Rates of a tablet that was not seen by the previous submission are unknown, so they are
+  // reported by the next one.
+  auto it = prev_tablet_ops_.find(tablet_id);
+  if (it != prev_tablet_ops_.end() && interval_sec > 0) {
+    tablet_load->set_read_ops_per_sec(
+        num_reads >= it->second.first ? (num_reads - it->second.first) / interval_sec : 0);
+    tablet_load->set_write_ops_per_sec(
+        num_writes >= it->second.second ? (num_writes - it->second.second) / interval_sec : 0);
+  }
+}
+
 Status Heartbeater::Thread::TryHeartbeat() {
   master::TSHeartbeatRequestPB req;
 
@@ -388,19 +436,28 @@ Status Heartbeater::Thread::TryHeartbeat() {
     }
 #endif
 
+    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
+    double_t div = diff.ToSeconds();
+
     // Get the Total SST file sizes and set it in the proto buf
     std::vector<shared_ptr<yb::tablet::TabletPeer> > tablet_peers;
     uint64_t total_file_sizes = 0;
     uint64_t uncompressed_file_sizes = 0;
+    std::unordered_map<TabletId, std::pair<uint64_t, uint64_t>> tablet_ops;
     server_->tablet_manager()->GetTabletPeers(&tablet_peers);
     for (auto it = tablet_peers.begin(); it != tablet_peers.end(); it++) {
       shared_ptr<yb::tablet::TabletPeer> tablet_peer = *it;
       if (tablet_peer) {
         shared_ptr<yb::tablet::TabletClass> tablet_class = tablet_peer->shared_tablet();
-        total_file_sizes += (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        uint64_t file_sizes = (tablet_class) ? tablet_class->GetTotalSSTFileSizes() : 0;
+        total_file_sizes += file_sizes;
         uncompressed_file_sizes += (tablet_class) ? tablet_class->GetUncompressedSSTFileSizes() : 0;
+        if (tablet_class && tablet_class->metrics() && FLAGS_heartbeat_report_tablet_loads) {
+          AddTabletLoad(tablet_class.get(), file_sizes, div, &tablet_ops, req.mutable_metrics());
+        }
       }
     }
+    prev_tablet_ops_ = std::move(tablet_ops);
     req.mutable_metrics()->set_total_sst_file_size(total_file_sizes);
     req.mutable_metrics()->set_uncompressed_sst_file_size(uncompressed_file_sizes);
 
@@ -414,9 +471,6 @@ Status Heartbeater::Thread::TryHeartbeat() {
     uint64_t num_writes = (writes_hist != nullptr) ? writes_hist->TotalCount() : 0;
 
     // Calculate the read and write ops per second.
-    MonoDelta diff = MonoTime::Now() - prev_tserver_metrics_submission_;
-    double_t div = diff.ToSeconds();
-
     double rops_per_sec = (div > 0 && num_reads > 0) ?
         (static_cast<double>(num_reads - prev_reads_) / div) : 0;
 
@@ -499,6 +553,7 @@ Status Heartbeater::Thread::TryHeartbeat() {
 
   // TODO: Handle TSHeartbeatResponsePB (e.g. deleted tablets and schema changes)
   server_->tablet_manager()->MarkTabletReportAcknowledged(req.tablet_report());
+  has_remaining_tablets_to_report_ = req.tablet_report().remaining_tablet_count() > 0;
 
   // Update the master's YSQL catalog version (i.e. if there were schema changes for YSQL objects).
   if (last_hb_response_.has_ysql_catalog_version()) {
@@ -32,6 +32,9 @@
 
 #include "yb/tserver/remote_bootstrap_client.h"
 
+#include <unordered_set>
+
+#include <boost/scope_exit.hpp>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 
@@ -59,9 +62,11 @@
 #include "yb/util/env_util.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/io_scheduler.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/net/rate_limiter.h"
 #include "yb/util/size_literals.h"
+#include "yb/util/threadpool.h"
 
 using namespace yb::size_literals;
 
@@ -115,6 +120,11 @@ DEFINE_int64(remote_bootstrap_rate_limit_bytes_per_sec, 256_MB,
              "the total limit will be 2 * remote_bootstrap_rate_limit_bytes_per_sec because a "
              "tserver or master can act both as a sender and receiver at the same time.");
 
+DEFINE_int32(remote_bootstrap_max_concurrent_file_downloads, 4,
+             "Maximum number of RocksDB files downloaded at the same time by a remote bootstrap "
+             "session. The transmission rate of the session is shared between them.");
+TAG_FLAG(remote_bootstrap_max_concurrent_file_downloads, advanced);
+
 DEFINE_int32(bytes_remote_bootstrap_durable_write_mb, 8,
              "Explicitly call fsync after downloading the specified amount of data in MB "
              "during a remote bootstrap session. If 0 fsync() is not called.");
@@ -394,6 +404,9 @@ Status RemoteBootstrapClient::Start(const string& bootstrap_peer_uuid,
     // Replace wal_dir in the received superblock with our assigned wal_dir.
     superblock_->set_wal_dir(meta_->wal_dir());
   }
+  if (ts_manager != nullptr) {
+    io_scheduler_ = ts_manager->IoSchedulerForRootDir(meta_->data_root_dir());
+  }
 
   started_ = true;
   auto old_count = n_started_.fetch_add(1, std::memory_order_acq_rel);
@@ -610,19 +623,24 @@ Status RemoteBootstrapClient::DownloadFile(
   auto file_path = JoinPathSegments(dir, file_pb.name());
   RETURN_NOT_OK(fs_manager_->env()->CreateDirs(DirName(file_path)));
 
+  std::string linked_file;
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     auto it = inode2file_.find(file_pb.inode());
     if (it != inode2file_.end()) {
-      VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
-                          << " => " << it->second;
-      auto link_status = fs_manager_->env()->LinkFile(it->second, file_path);
-      if (link_status.ok()) {
-        return Status::OK();
-      }
-      // TODO fallback to copy.
-      LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << it->second
-                             << ": " << link_status;
+      linked_file = it->second;
+    }
+  }
+  if (!linked_file.empty()) {
+    VLOG_WITH_PREFIX(2) << "File with the same inode already found: " << file_path
+                        << " => " << linked_file;
+    auto link_status = fs_manager_->env()->LinkFile(linked_file, file_path);
+    if (link_status.ok()) {
+      return Status::OK();
     }
+    // TODO fallback to copy.
+    LOG_WITH_PREFIX(ERROR) << "Failed to link file: " << file_path << " => " << linked_file
+                           << ": " << link_status;
   }
 
   WritableFileOptions opts;
@@ -637,6 +655,7 @@ Status RemoteBootstrapClient::DownloadFile(
   VLOG_WITH_PREFIX(2) << "Downloaded file " << file_path;
 
   if (file_pb.inode() != 0) {
+    std::lock_guard<std::mutex> lock(inode2file_mutex_);
     inode2file_.emplace(file_pb.inode(), file_path);
   }
 
@@ -664,14 +683,23 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
 
   RETURN_NOT_OK(CreateTabletDirectories(rocksdb_dir, meta_->fs_manager()));
 
+  // Files sharing an inode with an earlier file are hard links to it, so they are created after
+  // all other files are downloaded.
+  std::vector<const tablet::FilePB*> files;
+  std::vector<const tablet::FilePB*> links;
+  std::unordered_set<uint64_t> inodes;
+  for (auto const& file_pb : new_sb->kv_store().rocksdb_files()) {
+    if (file_pb.inode() != 0 && !inodes.insert(file_pb.inode()).second) {
+      links.push_back(&file_pb);
+    } else {
+      files.push_back(&file_pb);
+    }
+  }
+  RETURN_NOT_OK(DownloadFilesConcurrently(files, rocksdb_dir));
   DataIdPB data_id;
   data_id.set_type(DataIdPB::ROCKSDB_FILE);
-  for (auto const& file_pb : new_sb->kv_store().rocksdb_files()) {
-    auto start = MonoTime::Now();
-    RETURN_NOT_OK(DownloadFile(file_pb, rocksdb_dir, &data_id));
-    auto elapsed = MonoTime::Now().GetDeltaSince(start);
-    LOG(INFO) << "Downloaded file " << file_pb.name() << " of size " << file_pb.size_bytes()
-              << " in " << elapsed.ToSeconds() << " seconds";
+  for (const auto* file_pb : links) {
+    RETURN_NOT_OK(DownloadFile(*file_pb, rocksdb_dir, &data_id));
   }
 
   // To avoid adding new file type to remote bootstrap we move intents as subdir of regular DB.
@@ -690,6 +718,55 @@ Status RemoteBootstrapClient::DownloadRocksDBFiles() {
   return Status::OK();
 }
 
+Status RemoteBootstrapClient::DownloadFilesConcurrently(
+    const std::vector<const tablet::FilePB*>& files, const std::string& dir) {
+  std::mutex mutex;
+  Status result;
+  auto download = [this, &dir, &mutex, &result](const tablet::FilePB& file_pb) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!result.ok()) {
+        return;
+      }
+    }
+    DataIdPB data_id;
+    data_id.set_type(DataIdPB::ROCKSDB_FILE);
+    auto start = MonoTime::Now();
+    auto status = DownloadFile(file_pb, dir, &data_id);
+    if (!status.ok()) {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (result.ok()) {
+        result = status;
+      }
+      return;
+    }
+    auto elapsed = MonoTime::Now().GetDeltaSince(start);
+    LOG_WITH_PREFIX(INFO) << "Downloaded file " << file_pb.name() << " of size "
+                          << file_pb.size_bytes() << " in " << elapsed.ToSeconds() << " seconds";
+  };
+
+  const int max_streams = std::min<int>(
+      files.size(), FLAGS_remote_bootstrap_max_concurrent_file_downloads);
+  if (max_streams <= 1) {
+    for (const auto* file_pb : files) {
+      download(*file_pb);
+    }
+    return result;
+  }
+
+  std::unique_ptr<ThreadPool> pool;
+  RETURN_NOT_OK(ThreadPoolBuilder("rb-download").set_max_threads(max_streams).Build(&pool));
+  for (const auto* file_pb : files) {
+    auto status = pool->SubmitFunc([&download, file_pb] { download(*file_pb); });
+    if (!status.ok()) {
+      pool->Wait();
+      return status;
+    }
+  }
+  pool->Wait();
+  return result;
+}
+
 Status RemoteBootstrapClient::DownloadWAL(uint64_t wal_segment_seqno) {
   VLOG_WITH_PREFIX(1) << "Downloading WAL segment with seqno " << wal_segment_seqno;
   DataIdPB data_id;
@@ -751,13 +828,20 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
 
   std::unique_ptr<RateLimiter> rate_limiter;
 
+  ++active_downloads_;
+  BOOST_SCOPE_EXIT_TPL(this_) {
+    --this_->active_downloads_;
+  } BOOST_SCOPE_EXIT_END;
   if (FLAGS_remote_bootstrap_rate_limit_bytes_per_sec > 0) {
-    static auto rate_updater = []() {
+    auto rate_updater = [this]() {
+      const auto active_downloads = std::max(active_downloads_.load(), 1);
       if (n_started_.load(std::memory_order_acquire) < 1) {
         YB_LOG_EVERY_N(ERROR, 100) << "Invalid number of remote bootstrap sessions: " << n_started_;
-        return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec);
+        return static_cast<uint64_t>(
+            FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / active_downloads);
       }
-      return static_cast<uint64_t>(FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / n_started_);
+      return static_cast<uint64_t>(
+          FLAGS_remote_bootstrap_rate_limit_bytes_per_sec / n_started_ / active_downloads);
     };
 
     rate_limiter = std::make_unique<RateLimiter>(rate_updater);
@@ -768,6 +852,8 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
 
   rpc::RpcController controller;
   controller.set_timeout(MonoDelta::FromMilliseconds(session_idle_timeout_millis_));
+  // Chunks are large, so don't let them delay other calls to the same server.
+  controller.set_bulk_transfer(true);
   FetchDataRequestPB req;
 
   bool done = false;
@@ -797,6 +883,9 @@ Status RemoteBootstrapClient::DownloadFile(const DataIdPB& data_id,
                           Substitute("Error validating data item $0", data_id.ShortDebugString()));
 
     // Write the data.
+    if (io_scheduler_) {
+      io_scheduler_->Request(IoPriority::kBootstrap, resp.chunk().data().size());
+    }
     RETURN_NOT_OK(appendable->Append(resp.chunk().data()));
     VLOG(3) << "resp size: " << resp.ByteSize()
             << ", chunk size: " << resp.chunk().data().size();
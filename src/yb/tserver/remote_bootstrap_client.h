@@ -35,6 +35,7 @@
 #include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -53,6 +54,7 @@ namespace yb {
 class BlockIdPB;
 class FsManager;
 class HostPort;
+class IoScheduler;
 
 namespace consensus {
 class ConsensusMetadata;
@@ -134,6 +136,7 @@ class RemoteBootstrapClient {
  protected:
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestBeginEndSession);
   FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles);
+  FRIEND_TEST(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesSequentially);
 
   // Extract the embedded Status message from the given ErrorStatusPB.
   // The given ErrorStatusPB must extend RemoteBootstrapErrorPB.
@@ -223,7 +226,20 @@ class RemoteBootstrapClient {
   bool succeeded_;
 
  private:
-  std::unordered_map<uint64_t, std::string> inode2file_;
+  // Downloads the given RocksDB files using up to
+  // remote_bootstrap_max_concurrent_file_downloads concurrent streams.
+  CHECKED_STATUS DownloadFilesConcurrently(
+      const std::vector<const tablet::FilePB*>& files, const std::string& dir);
+
+  std::mutex inode2file_mutex_;
+  std::unordered_map<uint64_t, std::string> inode2file_;  // Protected by inode2file_mutex_.
+
+  // Number of files of this session that are being downloaded right now. The session's share of
+  // the transmission rate is split between them.
+  std::atomic<int> active_downloads_{0};
+
+  // Scheduler of the disk that the tablet is downloaded to, when not null.
+  std::shared_ptr<IoScheduler> io_scheduler_;
 
   DISALLOW_COPY_AND_ASSIGN(RemoteBootstrapClient);
 };
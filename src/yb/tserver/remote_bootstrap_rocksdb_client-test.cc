@@ -18,6 +18,8 @@
 
 using std::shared_ptr;
 
+DECLARE_int32(remote_bootstrap_max_concurrent_file_downloads);
+
 namespace yb {
 namespace tserver {
 
@@ -79,5 +81,24 @@ TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFiles) {
   }
 }
 
+// Download the RocksDB files one at a time.
+TEST_F(RemoteBootstrapRocksDBClientTest, TestDownloadRocksDBFilesSequentially) {
+  FLAGS_remote_bootstrap_max_concurrent_file_downloads = 1;
+  ASSERT_OK(client_->DownloadRocksDBFiles());
+  auto tablet_peer_checkpoint_dir =
+      tablet_peer_->tablet()->TEST_LastRocksDBCheckpointDir();
+
+  vector<std::string> rocksdb_files;
+  ASSERT_OK(fs_manager_->ListDir(meta_->rocksdb_dir(), &rocksdb_files));
+
+  vector<std::string> tablet_peer_checkpoint_files;
+  ASSERT_OK(tablet_peer_->tablet_metadata()->fs_manager()->ListDir(tablet_peer_checkpoint_dir,
+                                                                   &tablet_peer_checkpoint_files));
+
+  std::sort(rocksdb_files.begin(), rocksdb_files.end());
+  std::sort(tablet_peer_checkpoint_files.begin(), tablet_peer_checkpoint_files.end());
+  ASSERT_EQ(tablet_peer_checkpoint_files, rocksdb_files);
+}
+
 } // namespace tserver
 } // namespace yb
@@ -278,13 +278,16 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
     ResetSessionExpirationUnlocked(session_id);
   }
 
-  session->EnsureRateLimiterIsInitialized();
-
   MAYBE_FAULT(FLAGS_fault_crash_on_handle_rb_fetch_data);
 
   uint64_t offset = req->offset();
-  VLOG(3) << " rate limiter max len: "  << session->rate_limiter().GetMaxSizeForNextTransmission();
-  auto rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  uint64_t rate_limit;
+  {
+    std::lock_guard<std::mutex> lock(session->rate_limiter_mutex());
+    session->EnsureRateLimiterIsInitialized();
+    rate_limit = session->rate_limiter().GetMaxSizeForNextTransmission();
+  }
+  VLOG(3) << " rate limiter max len: "  << rate_limit;
   int64_t client_maxlen = rate_limit == 0
       ? req->max_length() : std::min(static_cast<uint64_t>(req->max_length()), rate_limit);
   const DataIdPB& data_id = req->data_id();
@@ -300,7 +303,12 @@ void RemoteBootstrapServiceImpl::FetchData(const FetchDataRequestPB* req,
                     error_code, "Unable to get piece of data file");
 
   data_chunk->set_total_data_length(total_data_length);
-  session->rate_limiter().UpdateDataSizeAndMaybeSleep(data->size());
+  {
+    // Concurrent fetches of the same session wait for each other here, which keeps their total
+    // rate within the session's share.
+    std::lock_guard<std::mutex> lock(session->rate_limiter_mutex());
+    session->rate_limiter().UpdateDataSizeAndMaybeSleep(data->size());
+  }
   data_chunk->set_offset(offset);
 
   // Calculate checksum.
@@ -170,6 +170,8 @@ class RemoteBootstrapTest : public YBTabletTest {
                                            metric_entity,
                                            raft_pool_.get(),
                                            tablet_prepare_pool_.get(),
+                                           nullptr /* apply_pool */,
+                                           nullptr /* txn_apply_pool */,
                                            nullptr /* retryable_requests */));
     consensus::ConsensusBootstrapInfo boot_info;
     ASSERT_OK(tablet_peer_->Start(boot_info));
@@ -43,10 +43,18 @@
 #include "yb/server/metadata.h"
 #include "yb/tablet/tablet.h"
 #include "yb/tablet/tablet_peer.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(remote_bootstrap_flush_memtables, false,
+            "Whether memtables are flushed before creating the RocksDB checkpoint for a remote "
+            "bootstrap session. Without a flush, the operations after the flushed frontier are "
+            "replayed from the log on the new peer, and writes to large tablets are not stalled.");
+TAG_FLAG(remote_bootstrap_flush_memtables, advanced);
+TAG_FLAG(remote_bootstrap_flush_memtables, runtime);
+
 DECLARE_int32(rpc_max_message_size);
 DECLARE_int64(remote_bootstrap_rate_limit_bytes_per_sec);
 
@@ -246,11 +254,16 @@ Status RemoteBootstrapSession::Init() {
   // Clear any previous RocksDB files in the superblock. Each session should create a new list
   // based the checkpoint directory files.
   kv_store->clear_rocksdb_files();
-  auto status = tablet->CreateCheckpoint(checkpoint_dir_);
-  if (status.ok()) {
+  // The log is anchored at the minimum op id until the log segments are snapshotted below, so
+  // they contain all operations after the flushed frontiers of the checkpoint.
+  auto checkpoint_op_ids = tablet->CreateCheckpoint(
+      checkpoint_dir_, tablet::FlushMemtables(FLAGS_remote_bootstrap_flush_memtables));
+  if (checkpoint_op_ids.ok()) {
     *kv_store->mutable_rocksdb_files() = VERIFY_RESULT(ListFiles(checkpoint_dir_));
-  } else if (!status.IsNotSupported()) {
-    RETURN_NOT_OK(status);
+    VLOG(1) << "Checkpoint of " << tablet_id << " contains operations up to "
+            << checkpoint_op_ids->ToString();
+  } else if (!checkpoint_op_ids.status().IsNotSupported()) {
+    return checkpoint_op_ids.status();
   }
 
   RETURN_NOT_OK(InitSnapshotFiles());
@@ -45,6 +45,32 @@ void SetupErrorAndRespond(TabletServerErrorPB* error,
   SetupErrorAndRespond(error, s, static_cast<TabletServerErrorPB::Code>(s.error_code()), context);
 }
 
+Result<std::shared_ptr<tablet::TabletPeer>> LookupTabletPeer(
+    TabletPeerLookupIf* tablet_manager,
+    const string& tablet_id,
+    TabletServerErrorPB::Code* error_code) {
+  std::shared_ptr<tablet::TabletPeer> result;
+  Status status = tablet_manager->GetTabletPeer(tablet_id, &result);
+  if (PREDICT_FALSE(!status.ok())) {
+    *error_code = status.IsServiceUnavailable() ? TabletServerErrorPB::UNKNOWN_ERROR
+                                                : TabletServerErrorPB::TABLET_NOT_FOUND;
+    return status;
+  }
+
+  // Check RUNNING state.
+  tablet::RaftGroupStatePB state = result->state();
+  if (PREDICT_FALSE(state != tablet::RUNNING)) {
+    Status s = STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStatePB_Name(state));
+    if (state == tablet::FAILED) {
+      s = s.CloneAndAppend(result->error().ToString());
+    }
+    *error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+    return s;
+  }
+
+  return result;
+}
+
 Result<int64_t> LeaderTerm(const tablet::TabletPeer& tablet_peer) {
   std::shared_ptr<consensus::Consensus> consensus = tablet_peer.shared_consensus();
   auto leader_state = consensus->GetLeaderState();
@@ -98,6 +98,13 @@ StdStatusCallback BindHandleResponse(RespType* resp,
   return std::bind(&HandleResponse<RespType>, resp, context, std::placeholders::_1);
 }
 
+// Lookup the given tablet, ensuring that it both exists and is RUNNING.
+// If it is not, error_code is set to the code that should be reported to the caller.
+Result<std::shared_ptr<tablet::TabletPeer>> LookupTabletPeer(
+    TabletPeerLookupIf* tablet_manager,
+    const string& tablet_id,
+    TabletServerErrorPB::Code* error_code);
+
 // Lookup the given tablet, ensuring that it both exists and is RUNNING.
 // If it is not, respond to the RPC associated with 'context' after setting
 // resp->mutable_error() to indicate the failure reason.
@@ -109,28 +116,11 @@ Result<std::shared_ptr<tablet::TabletPeer>> LookupTabletPeerOrRespond(
     const string& tablet_id,
     RespClass* resp,
     rpc::RpcContext* context) {
-  std::shared_ptr<tablet::TabletPeer> result;
-  Status status = tablet_manager->GetTabletPeer(tablet_id, &result);
-  if (PREDICT_FALSE(!status.ok())) {
-    TabletServerErrorPB::Code code = status.IsServiceUnavailable() ?
-                                     TabletServerErrorPB::UNKNOWN_ERROR :
-                                     TabletServerErrorPB::TABLET_NOT_FOUND;
-    SetupErrorAndRespond(resp->mutable_error(), status, code, context);
-    return status;
+  TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+  auto result = LookupTabletPeer(tablet_manager, tablet_id, &error_code);
+  if (PREDICT_FALSE(!result.ok())) {
+    SetupErrorAndRespond(resp->mutable_error(), result.status(), error_code, context);
   }
-
-  // Check RUNNING state.
-  tablet::RaftGroupStatePB state = result->state();
-  if (PREDICT_FALSE(state != tablet::RUNNING)) {
-    Status s = STATUS(IllegalState, "Tablet not RUNNING", tablet::RaftGroupStatePB_Name(state));
-    if (state == tablet::FAILED) {
-      s = s.CloneAndAppend(result->error().ToString());
-    }
-    SetupErrorAndRespond(resp->mutable_error(), s,
-                         TabletServerErrorPB::TABLET_NOT_RUNNING, context);
-    return s;
-  }
-
   return result;
 }
 
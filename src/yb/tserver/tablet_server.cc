@@ -39,6 +39,7 @@
 
 #include <glog/logging.h>
 
+#include "yb/cdc/cdc_service.h"
 #include "yb/fs/fs_manager.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/rpc/service_if.h"
@@ -60,6 +61,9 @@
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/rocksdb/env.h"
+#include "yb/rocksutil/rocksdb_encrypted_file_factory.h"
+#include "yb/util/encrypted_file.h"
+#include "yb/util/universe_key_manager.h"
 
 using std::make_shared;
 using std::shared_ptr;
@@ -102,6 +106,10 @@ DEFINE_int32(ts_remote_bootstrap_svc_queue_length, 50,
              "RPC queue length for the TS remote bootstrap service");
 TAG_FLAG(ts_remote_bootstrap_svc_queue_length, advanced);
 
+DEFINE_int32(ts_cdc_svc_queue_length, 50,
+             "RPC queue length for the TS change data capture service");
+TAG_FLAG(ts_cdc_svc_queue_length, advanced);
+
 DEFINE_bool(enable_direct_local_tablet_server_call,
             true,
             "Enable direct call to local tablet server");
@@ -121,6 +129,14 @@ DEFINE_int64(inbound_rpc_memory_limit, 0, "Inbound RPC memory limit");
 DEFINE_bool(start_pgsql_proxy, false,
             "Whether to run a PostgreSQL server as a child process of the tablet server");
 
+DEFINE_bool(enable_encryption_at_rest, false,
+            "Store the WAL and SST files of tablets through encrypted envs. Files are encrypted "
+            "with AES in counter mode using their own keys, that are protected by the universe "
+            "key received from the master. New files are plaintext until the master enables "
+            "encryption, existing files are re-encrypted with the latest universe key when they "
+            "are rewritten by compactions or log rolls.");
+TAG_FLAG(enable_encryption_at_rest, experimental);
+
 DEFINE_bool(tserver_enable_metrics_snapshotter, false, "Should metrics snapshotter be enabled");
 
 namespace yb {
@@ -138,6 +154,11 @@ TabletServer::TabletServer(const TabletServerOptions& opts)
       tablet_server_service_(nullptr) {
   SetConnectionContextFactory(rpc::CreateConnectionContextFactory<rpc::YBInboundConnectionContext>(
       FLAGS_inbound_rpc_memory_limit, mem_tracker()));
+  if (FLAGS_enable_encryption_at_rest) {
+    universe_key_manager_ = std::make_unique<UniverseKeyManager>();
+    encrypted_env_ = NewEncryptedEnv(universe_key_manager_.get());
+    rocksdb_encrypted_env_ = NewRocksDBEncryptedEnv(universe_key_manager_.get());
+  }
 }
 
 TabletServer::~TabletServer() {
@@ -288,6 +309,14 @@ Status TabletServer::RegisterServices() {
                                                                         metric_entity());
   RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_ts_remote_bootstrap_svc_queue_length,
                                                      std::move(remote_bootstrap_service)));
+
+  std::unique_ptr<ServiceIf> cdc_service = std::make_unique<cdc::CDCServiceImpl>(
+      tablet_manager_.get(),
+      [this] { return tablet_manager_->GetTabletPeers(); },
+      metric_registry(),
+      metric_entity());
+  RETURN_NOT_OK(RpcAndWebServerBase::RegisterService(FLAGS_ts_cdc_svc_queue_length,
+                                                     std::move(cdc_service)));
   return Status::OK();
 }
 
@@ -366,6 +395,9 @@ Status TabletServer::GetTabletStatus(const GetTabletStatusRequestPB* req,
 
 Status TabletServer::SetUniverseKeyRegistry(
     const yb::UniverseKeyRegistryPB& universe_key_registry) {
+  if (universe_key_manager_) {
+    universe_key_manager_->SetUniverseKeyRegistry(universe_key_registry);
+  }
   return Status::OK();
 }
 
@@ -415,11 +447,11 @@ void TabletServer::DisplayRpcIcons(std::stringstream* output) {
 }
 
 Env* TabletServer::GetEnv() {
-  return Env::Default();
+  return encrypted_env_ ? encrypted_env_.get() : Env::Default();
 }
 
 rocksdb::Env* TabletServer::GetRocksDBEnv() {
-  return rocksdb::Env::Default();
+  return rocksdb_encrypted_env_ ? rocksdb_encrypted_env_.get() : rocksdb::Env::Default();
 }
 
 }  // namespace tserver
@@ -60,6 +60,7 @@ class Env;
 namespace yb {
 class Env;
 class MaintenanceManager;
+class UniverseKeyManager;
 
 namespace tserver {
 
@@ -182,6 +183,8 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
     return ysql_catalog_version_;
   }
 
+  // Envs used for the WAL and for RocksDB files of tablets. Encrypted ones when
+  // FLAGS_enable_encryption_at_rest is set.
   virtual Env* GetEnv();
 
   virtual rocksdb::Env* GetRocksDBEnv();
@@ -211,6 +214,12 @@ class TabletServer : public server::RpcAndWebServerBase, public TabletServerIf {
   // The options passed at construction time, and will be updated if master config changes.
   TabletServerOptions opts_;
 
+  // Universe keys received from the master, used by the encrypted envs. Declared before the tablet
+  // manager, so the envs outlive the tablets.
+  std::unique_ptr<UniverseKeyManager> universe_key_manager_;
+  std::unique_ptr<Env> encrypted_env_;
+  std::unique_ptr<rocksdb::Env> rocksdb_encrypted_env_;
+
   // Manager for tablets which are available on this server.
   gscoped_ptr<TSTabletManager> tablet_manager_;
 
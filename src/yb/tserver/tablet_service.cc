@@ -45,6 +45,7 @@
 #include "yb/consensus/leader_lease.h"
 
 #include "yb/docdb/cql_operation.h"
+#include "yb/docdb/deadline_info.h"
 #include "yb/docdb/doc_rowwise_iterator.h"
 #include "yb/docdb/pgsql_operation.h"
 
@@ -76,7 +77,9 @@
 #include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/monotime.h"
+#include "yb/util/net/rate_limiter.h"
 #include "yb/util/random_util.h"
+#include "yb/util/sampled_trace.h"
 #include "yb/util/size_literals.h"
 #include "yb/util/status.h"
 #include "yb/util/status_callback.h"
@@ -111,6 +114,12 @@ DEFINE_bool(parallelize_read_ops, true,
 TAG_FLAG(parallelize_read_ops, advanced);
 TAG_FLAG(parallelize_read_ops, runtime);
 
+DEFINE_int32(pgsql_max_scan_parallelism, 4,
+             "Max number of hash sub-ranges of a tablet that are scanned concurrently for a YSQL "
+             "full scan that allows parallelism. Values less than 2 disable parallel scans.");
+TAG_FLAG(pgsql_max_scan_parallelism, advanced);
+TAG_FLAG(pgsql_max_scan_parallelism, runtime);
+
 // Fault injection flags.
 DEFINE_test_flag(int32, scanner_inject_latency_on_each_batch_ms, 0,
                  "If set, the scanner will pause the specified number of milliesconds "
@@ -122,6 +131,13 @@ DEFINE_int32(max_wait_for_safe_time_ms, 5000,
              "Maximum time in milliseconds to wait for the safe time to advance when trying to "
              "scan at the given hybrid_time.");
 
+DEFINE_bool(lease_protected_reads, false,
+            "Serve strongly consistent reads of single rows on the leader without waiting for "
+            "safe time, when the leader lease covers the read time and no pending write could "
+            "change the rows read.");
+TAG_FLAG(lease_protected_reads, advanced);
+TAG_FLAG(lease_protected_reads, runtime);
+
 DEFINE_test_flag(bool, tserver_noop_read_write, false, "Respond NOOP to read/write.");
 
 DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from followers, "
@@ -131,6 +147,14 @@ DEFINE_int32(max_stale_read_bound_time_ms, 0, "If we are allowed to read from fo
 TAG_FLAG(max_stale_read_bound_time_ms, evolving);
 TAG_FLAG(max_stale_read_bound_time_ms, runtime);
 
+DEFINE_int32(follower_read_safe_time_wait_ms, 100,
+             "How long a YSQL read from a follower at a specified read time waits for the safe "
+             "time of the tablet to reach the read time. When it does not, the read is rejected as "
+             "stale, so the client retries it on the leader. Zero or less waits until the client "
+             "deadline. Other reads always wait until the client deadline.");
+TAG_FLAG(follower_read_safe_time_wait_ms, advanced);
+TAG_FLAG(follower_read_safe_time_wait_ms, runtime);
+
 DEFINE_test_flag(bool, assert_reads_from_follower_rejected_because_of_staleness, false,
                  "If set, we verify that the consistency level is CONSISTENT_PREFIX, and that "
                  "a follower receives the request, but that it gets rejected because it's a stale "
@@ -147,7 +171,18 @@ DEFINE_test_flag(bool, simulate_time_out_failures, false, "If true, we will rand
 DEFINE_test_flag(double, respond_write_failed_probability, 0.0,
                  "Probability to respond that write request is failed");
 
+DEFINE_int32(write_throttling_max_retry_delay_ms, 1000,
+             "Delay before retry requested from clients whose writes are rejected by adaptive "
+             "write throttling, when the tablet rejects all writes. The delay is proportional to "
+             "the fraction of rejected writes.");
+TAG_FLAG(write_throttling_max_retry_delay_ms, advanced);
+
+DEFINE_int64(checksum_scan_rate_limit_bytes_per_sec, 0,
+             "Maximum rate of reading tablet data by checksum scans, shared by all checksum scans "
+             "running on this server. Zero means no limit.");
+
 DECLARE_uint64(max_clock_skew_usec);
+DECLARE_bool(limit_read_uncertainty_by_safe_time);
 
 namespace yb {
 namespace tserver {
@@ -245,6 +280,55 @@ bool TabletServiceImpl::CheckMemoryPressure(
   return true;
 }
 
+bool TabletServiceImpl::CheckWriteThrottling(
+    tablet::Tablet* tablet, WriteResponsePB* resp, rpc::RpcContext* context) {
+  const double ratio = tablet->WriteThrottlingRatio();
+  if (ratio <= 0 || !RandomActWithProbability(ratio)) {
+    return true;
+  }
+
+  tablet->metrics()->write_throttling_rejections->Increment();
+  resp->set_retry_after_ms(std::max<uint32_t>(
+      ratio * std::max(FLAGS_write_throttling_max_retry_delay_ms, 0), 1));
+  auto msg = StringPrintf(
+      "Write throttled, rejecting %.2f%% of writes while compactions fall behind", ratio * 100);
+  YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting Write request: " << msg << THROTTLE_MSG;
+  SetupErrorAndRespond(resp->mutable_error(), STATUS(ServiceUnavailable, msg),
+                       TabletServerErrorPB::WRITE_THROTTLED, context);
+  return false;
+}
+
+template<class Resp>
+bool TabletServiceImpl::AdmitOrRespond(
+    tablet::Tablet* tablet, tablet::AdmissionKind kind, Resp* resp, rpc::RpcContext* context,
+    tablet::AdmissionTicket* ticket) {
+  auto* metrics = tablet->metrics();
+  const auto& queue_time = kind == tablet::AdmissionKind::kRead ? metrics->read_queue_time
+                                                                : metrics->write_queue_time;
+  queue_time->Increment(context->GetTimeInQueue().ToMicroseconds());
+
+  auto& admission_controller = tablet->admission_controller();
+  auto status = admission_controller.Admit(kind, context->GetClientDeadline(), ticket);
+  if (status.ok()) {
+    return true;
+  }
+
+  YB_LOG_EVERY_N_SECS(INFO, 1) << "Rejecting request: " << status << THROTTLE_MSG;
+  if (status.IsTimedOut()) {
+    metrics->admission_deadline_rejections->Increment();
+    SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR,
+                         context);
+  } else {
+    metrics->admission_overload_rejections->Increment();
+    // A slot is expected to be released in about the service time.
+    resp->set_retry_after_ms(std::max<int64_t>(
+        ToMilliseconds(admission_controller.ServiceTime(kind)), 1));
+    SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::TABLET_OVERLOADED,
+                         context);
+  }
+  return false;
+}
+
 typedef ListTabletsResponsePB::StatusAndSchemaPB StatusAndSchemaPB;
 
 class WriteOperationCompletionCallback : public OperationCompletionCallback {
@@ -254,9 +338,10 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
       WriteResponsePB* response,
       tablet::WriteOperationState* state,
       const server::ClockPtr& clock,
+      tablet::AdmissionTicket admission_ticket,
       bool trace = false)
       : context_(std::move(context)), response_(response), state_(state), clock_(clock),
-        include_trace_(trace) {}
+        admission_ticket_(std::move(admission_ticket)), include_trace_(trace) {}
 
   void OperationCompleted() override {
     // When we don't need to return any data, we could return success on duplicate request.
@@ -322,6 +407,7 @@ class WriteOperationCompletionCallback : public OperationCompletionCallback {
   WriteResponsePB* const response_;
   tablet::WriteOperationState* const state_;
   server::ClockPtr clock_;
+  tablet::AdmissionTicket admission_ticket_;
   const bool include_trace_;
 };
 
@@ -349,15 +435,20 @@ class ScanResultChecksummer {
         value.value().AppendToString(&buffer_);
       }
     }
-    crc_->Compute(buffer_.c_str(), buffer_.size(), &agg_checksum_, nullptr);
+    agg_checksum_ = crc::Crc32cExtend(
+        static_cast<uint32_t>(agg_checksum_), buffer_.c_str(), buffer_.size());
+    total_bytes_ += buffer_.size();
   }
 
   // Accessors for initializing / setting the checksum.
   uint64_t agg_checksum() const { return agg_checksum_; }
 
+  // Size of the checksummed data.
+  uint64_t total_bytes() const { return total_bytes_; }
+
  private:
-  crc::Crc* const crc_ = crc::GetCrc32cInstance();
   uint64_t agg_checksum_ = 0;
+  uint64_t total_bytes_ = 0;
   std::string buffer_;
 };
 
@@ -366,6 +457,13 @@ TabletServiceImpl::TabletServiceImpl(TabletServerIf* server)
       server_(server) {
 }
 
+bool TabletServiceImpl::IsLowPriority(const rpc::InboundCall& call) const {
+  // Checksum scans whole tablet and ImportData loads whole files, so they should not share
+  // queue and workers with latency sensitive reads and writes.
+  const auto& method_name = call.method_name();
+  return method_name == "Checksum" || method_name == "ImportData";
+}
+
 TabletServiceAdminImpl::TabletServiceAdminImpl(TabletServer* server)
     : TabletServerAdminServiceIf(server->MetricEnt()),
       server_(server) {
@@ -389,8 +487,15 @@ void TabletServiceAdminImpl::AlterSchema(const ChangeMetadataRequestPB* req,
 
   uint32_t schema_version = tablet.peer->tablet_metadata()->schema_version();
 
-  // If the schema was already applied, respond as succeeded
-  if (schema_version == req->schema_version()) {
+  if (req->has_add_table()) {
+    // Adding a colocated table does not change the schema of the tablet. If the table was already
+    // added, respond as succeeded.
+    if (tablet.peer->tablet_metadata()->GetTableInfo(req->add_table().table_id()).ok()) {
+      context.RespondSuccess();
+      return;
+    }
+  } else if (schema_version == req->schema_version()) {
+    // If the schema was already applied, respond as succeeded
     // Sanity check, to verify that the tablet should have the same schema
     // specified in the request.
     Schema req_schema;
@@ -422,7 +527,7 @@ void TabletServiceAdminImpl::AlterSchema(const ChangeMetadataRequestPB* req,
   }
 
   // If the current schema is newer than the one in the request reject the request.
-  if (schema_version > req->schema_version()) {
+  if (!req->has_add_table() && schema_version > req->schema_version()) {
     SetupErrorAndRespond(resp->mutable_error(),
                          STATUS(InvalidArgument, "Tablet has a newer schema"),
                          TabletServerErrorPB::TABLET_HAS_A_NEWER_SCHEMA, &context);
@@ -447,6 +552,54 @@ void TabletServiceAdminImpl::AlterSchema(const ChangeMetadataRequestPB* req,
     std::move(*__result); \
   })
 
+namespace {
+
+// Collects results of transaction updates received in one batched UpdateTransaction request,
+// and responds when all of them are completed.
+class BatchedUpdateTransactionContext {
+ public:
+  BatchedUpdateTransactionContext(
+      rpc::RpcContext context, UpdateTransactionResponsePB* response,
+      const server::ClockPtr& clock, int size)
+      : context_(std::move(context)), response_(response), clock_(clock), pending_(size) {
+    response_->mutable_batched_statuses()->Reserve(size);
+    for (int i = 0; i != size; ++i) {
+      response_->add_batched_statuses();
+    }
+  }
+
+  void Completed(int index, const Status& status) {
+    StatusToPB(status, response_->mutable_batched_statuses(index));
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      response_->set_propagated_hybrid_time(clock_->Now().ToUint64());
+      context_.RespondSuccess();
+    }
+  }
+
+ private:
+  rpc::RpcContext context_;
+  UpdateTransactionResponsePB* const response_;
+  server::ClockPtr clock_;
+  std::atomic<int> pending_;
+};
+
+class BatchedUpdateTxnCompletionCallback : public OperationCompletionCallback {
+ public:
+  BatchedUpdateTxnCompletionCallback(
+      std::shared_ptr<BatchedUpdateTransactionContext> context, int index)
+      : context_(std::move(context)), index_(index) {}
+
+  void OperationCompleted() override {
+    context_->Completed(index_, status_);
+  }
+
+ private:
+  std::shared_ptr<BatchedUpdateTransactionContext> context_;
+  const int index_;
+};
+
+} // namespace
+
 void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
                                           UpdateTransactionResponsePB* resp,
                                           rpc::RpcContext context) {
@@ -469,6 +622,30 @@ void TabletServiceImpl::UpdateTransaction(const UpdateTransactionRequestPB* req,
     return;
   }
 
+  if (req->batched_states_size() != 0) {
+    for (const auto& state : req->batched_states()) {
+      if (state.status() != TransactionStatus::PENDING) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(InvalidArgument, "Only heartbeats could be batched: $0",
+                          state.ShortDebugString()),
+            TabletServerErrorPB::UNKNOWN_ERROR, &context);
+        return;
+      }
+    }
+    auto batch = std::make_shared<BatchedUpdateTransactionContext>(
+        std::move(context), resp, server_->Clock(), req->batched_states_size());
+    auto* coordinator = tablet.peer->tablet()->transaction_coordinator();
+    for (int i = 0; i != req->batched_states_size(); ++i) {
+      auto state = std::make_unique<tablet::UpdateTxnOperationState>(
+          tablet.peer->tablet(), &req->batched_states(i));
+      state->set_completion_callback(
+          std::make_unique<BatchedUpdateTxnCompletionCallback>(batch, i));
+      coordinator->Handle(std::move(state), tablet.leader_term);
+    }
+    return;
+  }
+
   auto state = std::make_unique<tablet::UpdateTxnOperationState>(tablet.peer->tablet(),
                                                                  &req->state());
   state->set_completion_callback(MakeRpcOperationCompletionCallback(
@@ -726,6 +903,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     return;
   }
   TRACE("Start Write");
+  SAMPLED_TRACE("tserver.write_started",
+                req->ql_write_batch_size() + req->pgsql_write_batch_size());
   TRACE_EVENT1("tserver", "TabletServiceImpl::Write",
                "tablet_id", req->tablet_id());
   DVLOG(3) << "Received Write RPC: " << req->DebugString();
@@ -733,7 +912,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
 
   auto tablet = LookupLeaderTabletOrRespond(
       server_->tablet_peer_lookup(), req->tablet_id(), resp, &context);
-  if (!tablet || !CheckMemoryPressure(tablet.peer->tablet(), resp, &context)) {
+  if (!tablet || !CheckMemoryPressure(tablet.peer->tablet(), resp, &context) ||
+      !CheckWriteThrottling(tablet.peer->tablet(), resp, &context)) {
     return;
   }
 
@@ -778,6 +958,12 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
     }
   }
 
+  tablet::AdmissionTicket admission_ticket;
+  if (!AdmitOrRespond(tablet.peer->tablet(), tablet::AdmissionKind::kWrite, resp, &context,
+                      &admission_ticket)) {
+    return;
+  }
+
   auto operation_state = std::make_unique<WriteOperationState>(tablet.peer->tablet(), req, resp);
 
   auto context_ptr = std::make_shared<RpcContext>(std::move(context));
@@ -788,7 +974,8 @@ void TabletServiceImpl::Write(const WriteRequestPB* req,
   } else {
     operation_state->set_completion_callback(
         std::make_unique<WriteOperationCompletionCallback>(
-            context_ptr, resp, operation_state.get(), server_->Clock(), req->include_trace()));
+            context_ptr, resp, operation_state.get(), server_->Clock(),
+            std::move(admission_ticket), req->include_trace()));
   }
   tablet.peer->WriteAsync(
       std::move(operation_state), tablet.leader_term, context_ptr->GetClientDeadline());
@@ -932,6 +1119,9 @@ struct ReadContext {
   ReadHybridTime read_time;
   HybridTime safe_ht_to_read;
   ReadHybridTime used_read_time;
+  // Safe time of the tablet when the read arrived, that limits the read uncertainty window.
+  // Invalid when the window should not be limited.
+  HybridTime uncertainty_safe_ht;
   tablet::RequireLease require_lease = tablet::RequireLease::kFalse;
   HostPortPB* host_port_pb = nullptr;
   bool allow_retry = false;
@@ -977,9 +1167,10 @@ class ReadOperationCompletionCallback : public OperationCompletionCallback {
       TabletServiceImpl* service,
       tablet::TabletPeerPtr tablet_peer,
       const ReadContext& read_context,
-      std::shared_ptr<rpc::RpcContext> context)
+      std::shared_ptr<rpc::RpcContext> context,
+      tablet::AdmissionTicket admission_ticket)
       : service_(service), tablet_peer_(std::move(tablet_peer)), read_context_(read_context),
-        context_(std::move(context)) {}
+        context_(std::move(context)), admission_ticket_(std::move(admission_ticket)) {}
 
   void OperationCompleted() override {
     if (!status_.ok()) {
@@ -996,6 +1187,7 @@ class ReadOperationCompletionCallback : public OperationCompletionCallback {
   tablet::TabletPeerPtr tablet_peer_;
   ReadContext read_context_;
   std::shared_ptr<rpc::RpcContext> context_;
+  tablet::AdmissionTicket admission_ticket_;
 };
 
 void TabletServiceImpl::Read(const ReadRequestPB* req,
@@ -1006,6 +1198,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     return;
   }
   TRACE("Start Read");
+  SAMPLED_TRACE("tserver.read_started", req->ql_batch_size() + req->pgsql_batch_size());
   TRACE_EVENT1("tserver", "TabletServiceImpl::Read",
       "tablet_id", req->tablet_id());
   DVLOG(3) << "Received Read RPC: " << req->DebugString();
@@ -1055,8 +1248,30 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       req->consistency_level() == YBConsistencyLevel::STRONG);
   // TODO: should check all the tables referenced by the requests to decide if it is transactional.
   const bool transactional = read_context.tablet->SchemaRef().table_properties().is_transactional();
+  // Lease protected reads are served at the requested read time or at the current hybrid time,
+  // without waiting for the safe time of the whole tablet to reach it.
+  Tablet* lease_protected_tablet = nullptr;
+  if (GetAtomicFlag(&FLAGS_lease_protected_reads) && read_context.require_lease &&
+      !serializable_isolation && req->redis_batch().empty() &&
+      read_context.tablet->table_type() != TableType::TRANSACTION_STATUS_TABLE_TYPE) {
+    lease_protected_tablet = down_cast<Tablet*>(read_context.tablet.get());
+  }
+  bool lease_protected_read = false;
+  if (lease_protected_tablet) {
+    const auto lease_protected_ht = read_time ? read_time.read : server_->Clock()->Now();
+    lease_protected_read = lease_protected_tablet->CanServeLeaseProtectedRead(
+        req->ql_batch(), req->pgsql_batch(), lease_protected_ht);
+    if (lease_protected_read) {
+      read_context.safe_ht_to_read = lease_protected_ht;
+      lease_protected_tablet->metrics()->lease_protected_reads->Increment();
+    } else {
+      lease_protected_tablet->metrics()->safe_time_reads->Increment();
+    }
+  }
   if (!read_time) {
-    read_context.safe_ht_to_read = read_context.tablet->SafeTime(read_context.require_lease);
+    if (!lease_protected_read) {
+      read_context.safe_ht_to_read = read_context.tablet->SafeTime(read_context.require_lease);
+    }
     // If the read time is not specified, then it is non transactional read.
     // So we should restart it in server in case of failure.
     read_time.read = read_context.safe_ht_to_read;
@@ -1069,17 +1284,40 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
       read_time.local_limit = read_time.read;
       read_time.global_limit = read_time.read;
     }
-  } else {
+  } else if (!lease_protected_read) {
+    // A follower that is behind the read time of a YSQL follower read should not hold the read
+    // until the client deadline, the leader could serve it right away.
+    const auto follower_wait_ms = GetAtomicFlag(&FLAGS_follower_read_safe_time_wait_ms);
+    const bool bounded_wait =
+        !read_context.require_lease && !req->pgsql_batch().empty() && follower_wait_ms > 0;
+    auto deadline = context.GetClientDeadline();
+    if (bounded_wait) {
+      deadline = std::min(deadline, CoarseMonoClock::now() + follower_wait_ms * 1ms);
+    }
     read_context.safe_ht_to_read = read_context.tablet->SafeTime(
-        read_context.require_lease, read_time.read, context.GetClientDeadline());
+        read_context.require_lease, read_time.read, deadline);
     if (!read_context.safe_ht_to_read.is_valid()) { // Timed out
       TRACE("Timed out waiting for read time");
+      if (bounded_wait && deadline < context.GetClientDeadline()) {
+        SetupErrorAndRespond(
+            resp->mutable_error(),
+            STATUS_FORMAT(IllegalState, "Safe time of tablet $0 did not reach $1 within $2ms",
+                          req->tablet_id(), read_time.read, follower_wait_ms),
+            TabletServerErrorPB::STALE_FOLLOWER, &context);
+        return;
+      }
       SetupErrorAndRespond(resp->mutable_error(), STATUS(TimedOut, ""),
           TabletServerErrorPB::UNKNOWN_ERROR, &context);
       return;
     }
   }
 
+  // Lease protected reads could be served before the writes they should observe are applied.
+  if (read_context.require_lease && !lease_protected_read &&
+      GetAtomicFlag(&FLAGS_limit_read_uncertainty_by_safe_time)) {
+    read_context.uncertainty_safe_ht = read_context.safe_ht_to_read;
+  }
+
   // For postgres requests check that the syscatalog version matches.
   if (!req->pgsql_batch().empty()) {
     for (const auto& pg_req : req->pgsql_batch()) {
@@ -1094,6 +1332,12 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     }
   }
 
+  tablet::AdmissionTicket admission_ticket;
+  if (!AdmitOrRespond(down_cast<Tablet*>(read_context.tablet.get()), tablet::AdmissionKind::kRead,
+                      resp, &context, &admission_ticket)) {
+    return;
+  }
+
   RequestScope request_scope;
   if (transactional) {
     // Serial number is used for check whether this operation was initiated before
@@ -1133,7 +1377,7 @@ void TabletServiceImpl::Read(const ReadRequestPB* req,
     auto context_ptr = std::make_shared<RpcContext>(std::move(context));
     read_context.context = context_ptr.get();
     operation_state->set_completion_callback(std::make_unique<ReadOperationCompletionCallback>(
-        this, leader_peer.peer, read_context, context_ptr));
+        this, leader_peer.peer, read_context, context_ptr, std::move(admission_ticket)));
     leader_peer.peer->WriteAsync(
         std::move(operation_state), leader_peer.leader_term, context_ptr->GetClientDeadline());
     return;
@@ -1195,6 +1439,7 @@ void TabletServiceImpl::CompleteRead(ReadContext* read_context) {
       std::move(*read_context->context), read_context->resp, server_->Clock());
   callback.OperationCompleted();
   TRACE("Done Read");
+  SAMPLED_TRACE("tserver.read_done", 0);
 }
 
 void HandleRedisReadRequestAsync(
@@ -1208,11 +1453,207 @@ void HandleRedisReadRequestAsync(
   status_cb(tablet->HandleRedisReadRequest(deadline, read_time, redis_read_request, response));
 }
 
+namespace {
+
+// Inclusive range of hash codes that is scanned by one sub-request of a parallel scan.
+struct HashSubRange {
+  uint16_t min_hash_code;
+  uint16_t max_hash_code;
+};
+
+// Splits hash range of the tablet into sub-ranges that could be scanned concurrently for the
+// request. Returns an empty vector if the request should be served by a single scan.
+std::vector<HashSubRange> PgsqlScanSubRanges(
+    const tablet::Tablet& tablet, const PgsqlReadRequestPB& req) {
+  const auto& paging_state = req.paging_state();
+  size_t parallelism = paging_state.sub_range_next_row_keys_size();
+  if (parallelism == 0) {
+    // Start a parallel scan only for a forward full scan of the whole tablet, whose rows do not
+    // have to be returned in key order.
+    if (req.max_parallelism() < 2 || FLAGS_pgsql_max_scan_parallelism < 2 ||
+        !req.is_forward_scan() || !req.partition_column_values().empty() ||
+        !req.range_column_values().empty() || req.has_ybctid_column_value() ||
+        req.has_index_request() || req.has_max_hash_code() ||
+        !paging_state.next_row_key().empty() ||
+        !tablet.metadata()->partition_schema().IsHashPartitioning() ||
+        tablet.SchemaRef().num_hash_key_columns() == 0) {
+      return {};
+    }
+    parallelism = std::min<size_t>(req.max_parallelism(), FLAGS_pgsql_max_scan_parallelism);
+  }
+
+  const auto& partition = tablet.metadata()->partition();
+  const uint32_t min_hash_code = partition.partition_key_start().empty()
+      ? 0 : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_start());
+  const uint32_t end_hash_code = partition.partition_key_end().empty()
+      ? std::numeric_limits<uint16_t>::max() + 1
+      : PartitionSchema::DecodeMultiColumnHashValue(partition.partition_key_end());
+  if (paging_state.sub_range_next_row_keys_size() == 0 && req.has_hash_code() &&
+      req.hash_code() > min_hash_code) {
+    // The scan should start in the middle of the tablet.
+    return {};
+  }
+  const size_t width = end_hash_code - min_hash_code;
+  parallelism = std::min(parallelism, width);
+
+  std::vector<HashSubRange> result;
+  result.reserve(parallelism);
+  for (size_t i = 0; i != parallelism; ++i) {
+    result.push_back(HashSubRange{
+        static_cast<uint16_t>(min_hash_code + width * i / parallelism),
+        static_cast<uint16_t>(min_hash_code + width * (i + 1) / parallelism - 1)});
+  }
+  return result;
+}
+
+// Scans hash sub-ranges of the tablet concurrently using the read pool, and combines their rows
+// into one unordered result. Paging state of the result holds the next row key of each sub-range.
+CHECKED_STATUS HandlePgsqlReadRequestInSubRanges(
+    tablet::Tablet* tablet,
+    ThreadPool* read_pool,
+    CoarseTimePoint deadline,
+    const ReadHybridTime& read_time,
+    const PgsqlReadRequestPB& req,
+    const TransactionMetadataPB& transaction,
+    const std::vector<HashSubRange>& sub_ranges,
+    tablet::PgsqlReadRequestResult* result) {
+  const auto& paging_state = req.paging_state();
+  const bool continued = paging_state.sub_range_next_row_keys_size() != 0;
+
+  // Build requests for sub-ranges that are not exhausted yet.
+  std::vector<size_t> active;
+  for (size_t i = 0; i != sub_ranges.size(); ++i) {
+    if (!continued || !paging_state.sub_range_next_row_keys(i).empty()) {
+      active.push_back(i);
+    }
+  }
+  SCHECK(!active.empty(), IllegalState, "All sub-ranges of the tablet were already read");
+  std::vector<PgsqlReadRequestPB> sub_requests(active.size());
+  for (size_t j = 0; j != active.size(); ++j) {
+    auto& sub_request = sub_requests[j];
+    sub_request = req;
+    sub_request.clear_paging_state();
+    sub_request.clear_max_parallelism();
+    // Rows of the sub-ranges are concatenated, that is only supported for row format.
+    sub_request.clear_columnar_result();
+    sub_request.set_hash_code(sub_ranges[active[j]].min_hash_code);
+    sub_request.set_max_hash_code(sub_ranges[active[j]].max_hash_code);
+    if (continued) {
+      sub_request.mutable_paging_state()->set_next_row_key(
+          paging_state.sub_range_next_row_keys(active[j]));
+    }
+    if (req.has_limit()) {
+      sub_request.set_limit(std::max<uint64_t>(req.limit() / active.size(), 1));
+    }
+  }
+
+  std::vector<tablet::PgsqlReadRequestResult> sub_results(active.size());
+  std::vector<Status> statuses(active.size());
+  CountDownLatch latch(active.size());
+  for (size_t j = 0; j != active.size(); ++j) {
+    auto func = [tablet, deadline, &read_time, &transaction, &latch,
+                 sub_request = &sub_requests[j], sub_result = &sub_results[j],
+                 status = &statuses[j]] {
+      *status = tablet->HandlePgsqlReadRequest(
+          deadline, read_time, *sub_request, transaction, sub_result);
+      latch.CountDown();
+    };
+
+    Status s;
+    bool run_async = FLAGS_parallelize_read_ops && (j != active.size() - 1);
+    if (run_async) {
+      s = read_pool->SubmitFunc(func);
+    }
+
+    if (!s.ok() || !run_async) {
+      func();
+    }
+  }
+  latch.Wait();
+
+  for (auto& status : statuses) {
+    RETURN_NOT_OK(status);
+  }
+  for (auto& sub_result : sub_results) {
+    if (sub_result.restart_read_ht.is_valid()) {
+      result->restart_read_ht.MakeAtLeast(sub_result.restart_read_ht);
+    }
+  }
+  if (result->restart_read_ht.is_valid()) {
+    return Status::OK();
+  }
+  for (auto& sub_result : sub_results) {
+    if (sub_result.response.status() != PgsqlResponsePB::PGSQL_STATUS_OK) {
+      result->response.Swap(&sub_result.response);
+      return Status::OK();
+    }
+  }
+
+  std::vector<Slice> tuple_sets;
+  tuple_sets.reserve(sub_results.size());
+  for (const auto& sub_result : sub_results) {
+    tuple_sets.emplace_back(sub_result.rows_data.data(), sub_result.rows_data.size());
+  }
+  int64_t row_count = 0;
+  RETURN_NOT_OK(pggate::PgDocData::ConcatTuples(tuple_sets, &row_count, &result->rows_data));
+
+  // The whole tablet is done when every sub-range is exhausted, in that case sub-responses hold
+  // paging state pointing to the next tablet, if any.
+  PgsqlPagingStatePB next_paging_state;
+  if (continued) {
+    *next_paging_state.mutable_sub_range_next_row_keys() = paging_state.sub_range_next_row_keys();
+  } else {
+    for (size_t i = 0; i != sub_ranges.size(); ++i) {
+      next_paging_state.add_sub_range_next_row_keys();
+    }
+  }
+  bool has_more = false;
+  for (size_t j = 0; j != active.size(); ++j) {
+    const auto& sub_paging_state = sub_results[j].response.paging_state();
+    *next_paging_state.mutable_sub_range_next_row_keys(active[j]) =
+        sub_paging_state.next_row_key();
+    if (!sub_paging_state.next_row_key().empty()) {
+      has_more = true;
+    } else if (sub_paging_state.has_next_partition_key()) {
+      next_paging_state.set_next_partition_key(sub_paging_state.next_partition_key());
+    }
+  }
+
+  result->response.Swap(&sub_results.front().response);
+  result->response.clear_paging_state();
+  if (has_more) {
+    // Route the next request to this tablet.
+    next_paging_state.set_next_partition_key(
+        PartitionSchema::EncodeMultiColumnHashValue(sub_ranges.front().min_hash_code));
+  } else {
+    next_paging_state.clear_sub_range_next_row_keys();
+    if (!next_paging_state.has_next_partition_key()) {
+      return Status::OK();
+    }
+  }
+  next_paging_state.set_total_num_rows_read(paging_state.total_num_rows_read() + row_count);
+  result->response.mutable_paging_state()->Swap(&next_paging_state);
+  return Status::OK();
+}
+
+} // namespace
+
 Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
+  // Scans are not continued for a client that disconnected.
+  auto* rpc_context = read_context->context;
+  docdb::ScopedCancellationChecker cancellation_checker([rpc_context] {
+    return rpc_context->Cancelled();
+  });
   auto read_tx = VERIFY_RESULT(
       tablet::ScopedReadOperation::Create(
           read_context->tablet.get(), read_context->require_lease, read_context->read_time));
   read_context->used_read_time = read_tx.read_time();
+  // The limited window is specific to this tablet, so it is not reported as used read time.
+  auto read_time = read_tx.read_time();
+  if (read_context->uncertainty_safe_ht.is_valid()) {
+    down_cast<Tablet*>(read_context->tablet.get())->LimitReadUncertainty(
+        read_context->uncertainty_safe_ht, &read_time);
+  }
   if (!read_context->req->redis_batch().empty()) {
     // Assert the primary table is a redis table.
     DCHECK_EQ(read_context->tablet->table_type(), TableType::REDIS_TABLE_TYPE);
@@ -1231,7 +1672,7 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
           &HandleRedisReadRequestAsync,
           Unretained(read_context->tablet.get()),
           read_context->context->GetClientDeadline(),
-          read_tx.read_time(),
+          read_time,
           redis_read_req,
           Unretained(read_context->resp->add_redis_batch()),
           cb);
@@ -1279,7 +1720,7 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
       tablet::QLReadRequestResult result;
       TRACE("Start HandleQLReadRequest");
       RETURN_NOT_OK(read_context->tablet->HandleQLReadRequest(
-          read_context->context->GetClientDeadline(), read_tx.read_time(), ql_read_req,
+          read_context->context->GetClientDeadline(), read_time, ql_read_req,
           read_context->req->transaction(), &result));
       TRACE("Done HandleQLReadRequest");
       if (result.restart_read_ht.is_valid()) {
@@ -1304,9 +1745,18 @@ Result<ReadHybridTime> TabletServiceImpl::DoRead(ReadContext* read_context) {
     for (PgsqlReadRequestPB& pgsql_read_req : *mutable_req->mutable_pgsql_batch()) {
       tablet::PgsqlReadRequestResult result;
       TRACE("Start HandlePgsqlReadRequest");
-      RETURN_NOT_OK(read_context->tablet->HandlePgsqlReadRequest(
-          read_context->context->GetClientDeadline(), read_tx.read_time(), pgsql_read_req,
-          read_context->req->transaction(), &result));
+      auto* tablet = down_cast<Tablet*>(read_context->tablet.get());
+      auto sub_ranges = PgsqlScanSubRanges(*tablet, pgsql_read_req);
+      if (!sub_ranges.empty()) {
+        RETURN_NOT_OK(HandlePgsqlReadRequestInSubRanges(
+            tablet, server_->tablet_manager()->read_pool(),
+            read_context->context->GetClientDeadline(), read_time, pgsql_read_req,
+            read_context->req->transaction(), sub_ranges, &result));
+      } else {
+        RETURN_NOT_OK(read_context->tablet->HandlePgsqlReadRequest(
+            read_context->context->GetClientDeadline(), read_time, pgsql_read_req,
+            read_context->req->transaction(), &result));
+      }
       TRACE("Done HandlePgsqlReadRequest");
       if (result.restart_read_ht.is_valid()) {
         VLOG(1) << "Restart read required at: " << result.restart_read_ht;
@@ -1372,6 +1822,43 @@ void ConsensusServiceImpl::UpdateConsensus(const ConsensusRequestPB* req,
   context.RespondSuccess();
 }
 
+void ConsensusServiceImpl::MultiRaftUpdateConsensus(
+    const consensus::MultiRaftConsensusRequestPB* req,
+    consensus::MultiRaftConsensusResponsePB* resp,
+    rpc::RpcContext context) {
+  DVLOG(3) << "Received Multi Raft Consensus Update RPC: " << req->ShortDebugString();
+  if (!CheckUuidMatchOrRespond(tablet_manager_, "MultiRaftUpdateConsensus", req, resp, &context)) {
+    return;
+  }
+
+  // Errors are reported per tablet, the same way UpdateConsensus reports them.
+  for (const auto& request : req->consensus_request()) {
+    auto* response = resp->add_consensus_response();
+    TabletServerErrorPB::Code error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+    Status s;
+    auto tablet_peer = LookupTabletPeer(tablet_manager_, request.tablet_id(), &error_code);
+    if (tablet_peer.ok()) {
+      auto consensus = (**tablet_peer).shared_consensus();
+      if (consensus) {
+        error_code = TabletServerErrorPB::UNKNOWN_ERROR;
+        s = consensus->Update(
+            const_cast<ConsensusRequestPB*>(&request), response, context.GetClientDeadline());
+      } else {
+        error_code = TabletServerErrorPB::TABLET_NOT_RUNNING;
+        s = STATUS(ServiceUnavailable, "Consensus unavailable. Tablet not running");
+      }
+    } else {
+      s = tablet_peer.status();
+    }
+    if (PREDICT_FALSE(!s.ok())) {
+      response->Clear();
+      StatusToPB(s, response->mutable_error()->mutable_status());
+      response->mutable_error()->set_code(error_code);
+    }
+  }
+  context.RespondSuccess();
+}
+
 void ConsensusServiceImpl::RequestConsensusVote(const VoteRequestPB* req,
                                                 VoteResponsePB* resp,
                                                 rpc::RpcContext context) {
@@ -1674,18 +2161,32 @@ void TabletServiceImpl::ListTabletsForTabletServer(const ListTabletsForTabletSer
 
 namespace {
 
-Result<uint64_t> CalcChecksum(tablet::Tablet* tablet) {
+// The rate limiter is updated after reading this much data.
+constexpr uint64_t kChecksumRateLimitChunkBytes = 1_MB;
+
+Result<uint64_t> CalcChecksum(
+    tablet::Tablet* tablet, const ReadHybridTime& read_time, CoarseTimePoint deadline,
+    RateLimiter* rate_limiter) {
+  if (read_time && !tablet->SafeTime(tablet::RequireLease::kFalse, read_time.read, deadline)) {
+    return STATUS_FORMAT(TimedOut, "Timed out waiting for safe time $0", read_time);
+  }
+
   const Schema& schema = tablet->metadata()->schema();
   auto client_schema = schema.CopyWithoutColumnIds();
-  auto iter = tablet->NewRowIterator(client_schema, boost::none);
+  auto iter = tablet->NewRowIterator(client_schema, boost::none, "" /* table_id */, read_time);
   RETURN_NOT_OK(iter);
 
   QLTableRow value_map;
   ScanResultChecksummer collector;
+  uint64_t rate_limited_bytes = 0;
 
   while (VERIFY_RESULT((**iter).HasNext())) {
     RETURN_NOT_OK((**iter).NextRow(&value_map));
     collector.HandleRow(schema, value_map);
+    if (collector.total_bytes() - rate_limited_bytes >= kChecksumRateLimitChunkBytes) {
+      rate_limiter->UpdateDataSizeAndMaybeSleep(collector.total_bytes() - rate_limited_bytes);
+      rate_limited_bytes = collector.total_bytes();
+    }
   }
 
   return collector.agg_checksum();
@@ -1702,16 +2203,41 @@ void TabletServiceImpl::Checksum(const ChecksumRequestPB* req,
   if (!DoGetTabletOrRespond(req, resp, &context, &abstract_tablet)) {
     return;
   }
-  auto checksum = CalcChecksum(down_cast<tablet::Tablet*>(abstract_tablet.get()));
-  if (!checksum.ok()) {
-    SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
-                         TabletServerErrorPB::UNKNOWN_ERROR, &context);
-    return;
-  }
 
-  resp->set_checksum(*checksum);
+  // The scan could take long, so it is executed by the checksum pool instead of the RPC thread.
+  auto tablet = std::static_pointer_cast<tablet::Tablet>(abstract_tablet);
+  auto context_ptr = std::make_shared<rpc::RpcContext>(std::move(context));
+  auto read_time = req->has_read_hybrid_time()
+      ? ReadHybridTime::FromUint64(req->read_hybrid_time()) : ReadHybridTime();
+  auto status = server_->tablet_manager()->checksum_pool()->SubmitFunc(
+      [this, tablet, read_time, resp, context_ptr]() {
+    num_checksum_scans_.fetch_add(1, std::memory_order_acq_rel);
+    RateLimiter rate_limiter;
+    if (FLAGS_checksum_scan_rate_limit_bytes_per_sec > 0) {
+      // The rate limit is shared by all checksum scans running on this server.
+      rate_limiter.SetTargetRateUpdater([this]() -> uint64_t {
+        return FLAGS_checksum_scan_rate_limit_bytes_per_sec /
+               std::max(num_checksum_scans_.load(std::memory_order_acquire), 1);
+      });
+    }
+    rate_limiter.Init();
+    auto checksum = CalcChecksum(
+        tablet.get(), read_time, context_ptr->GetClientDeadline(), &rate_limiter);
+    num_checksum_scans_.fetch_sub(1, std::memory_order_acq_rel);
+    if (!checksum.ok()) {
+      SetupErrorAndRespond(resp->mutable_error(), checksum.status(),
+                           TabletServerErrorPB::UNKNOWN_ERROR, context_ptr.get());
+      return;
+    }
+
+    resp->set_checksum(*checksum);
 
-  context.RespondSuccess();
+    context_ptr->RespondSuccess();
+  });
+  if (!status.ok()) {
+    SetupErrorAndRespond(resp->mutable_error(), status, TabletServerErrorPB::UNKNOWN_ERROR,
+                         context_ptr.get());
+  }
 }
 
 void TabletServiceImpl::ImportData(const ImportDataRequestPB* req,
@@ -1745,6 +2271,41 @@ void TabletServiceImpl::GetTabletStatus(const GetTabletStatusRequestPB* req,
   context.RespondSuccess();
 }
 
+namespace {
+
+void HotKeysToPB(const std::vector<tablet::HotKey>& hot_keys,
+                 google::protobuf::RepeatedPtrField<HotKeyPB>* out) {
+  out->Reserve(hot_keys.size());
+  for (const auto& hot_key : hot_keys) {
+    auto* hot_key_pb = out->Add();
+    hot_key_pb->set_key(hot_key.key);
+    hot_key_pb->set_count(hot_key.count);
+    hot_key_pb->set_error(hot_key.error);
+  }
+}
+
+} // namespace
+
+void TabletServiceImpl::GetHotKeys(const GetHotKeysRequestPB* req,
+                                   GetHotKeysResponsePB* resp,
+                                   rpc::RpcContext context) {
+  auto peer = VERIFY_RESULT_OR_RETURN(LookupTabletPeerOrRespond(
+      server_->tablet_peer_lookup(), req->tablet_id(), resp, &context));
+  auto tablet = peer->shared_tablet();
+  if (!tablet) {
+    SetupErrorAndRespond(resp->mutable_error(),
+                         STATUS_FORMAT(IllegalState, "Tablet $0 is not running", req->tablet_id()),
+                         TabletServerErrorPB::TABLET_NOT_RUNNING, &context);
+    return;
+  }
+  const size_t limit = req->has_limit() ? req->limit() : std::numeric_limits<size_t>::max();
+  HotKeysToPB(tablet->hot_read_keys().TopKeys(limit), resp->mutable_read_keys());
+  HotKeysToPB(tablet->hot_write_keys().TopKeys(limit), resp->mutable_write_keys());
+  resp->set_total_reads(tablet->hot_read_keys().total_count());
+  resp->set_total_writes(tablet->hot_write_keys().total_count());
+  context.RespondSuccess();
+}
+
 void TabletServiceImpl::IsTabletServerReady(const IsTabletServerReadyRequestPB* req,
                                             IsTabletServerReadyResponsePB* resp,
                                             rpc::RpcContext context) {
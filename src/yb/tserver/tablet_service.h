@@ -32,6 +32,7 @@
 #ifndef YB_TSERVER_TABLET_SERVICE_H_
 #define YB_TSERVER_TABLET_SERVICE_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -40,6 +41,7 @@
 #include "yb/consensus/consensus.service.h"
 #include "yb/gutil/ref_counted.h"
 
+#include "yb/tablet/admission_controller.h"
 #include "yb/tablet/tablet_fwd.h"
 #include "yb/tablet/tablet_peer.h"
 
@@ -66,6 +68,8 @@ class TabletServiceImpl : public TabletServerServiceIf {
 
   explicit TabletServiceImpl(TabletServerIf* server);
 
+  bool IsLowPriority(const rpc::InboundCall& call) const override;
+
   void Write(const WriteRequestPB* req, WriteResponsePB* resp, rpc::RpcContext context) override;
 
   void Read(const ReadRequestPB* req, ReadResponsePB* resp, rpc::RpcContext context) override;
@@ -120,6 +124,10 @@ class TabletServiceImpl : public TabletServerServiceIf {
                        GetTabletStatusResponsePB* resp,
                        rpc::RpcContext context) override;
 
+  void GetHotKeys(const GetHotKeysRequestPB* req,
+                  GetHotKeysResponsePB* resp,
+                  rpc::RpcContext context) override;
+
   void IsTabletServerReady(const IsTabletServerReadyRequestPB* req,
                            IsTabletServerReadyResponsePB* resp,
                            rpc::RpcContext context) override;
@@ -150,6 +158,19 @@ class TabletServiceImpl : public TabletServerServiceIf {
   bool CheckMemoryPressure(
       tablet::Tablet* tablet, Resp* resp, rpc::RpcContext* context);
 
+  // Rejects the write with the WRITE_THROTTLED error, with probability equal to the write
+  // throttling ratio of the tablet. Returns true if the write should be processed.
+  bool CheckWriteThrottling(
+      tablet::Tablet* tablet, WriteResponsePB* resp, rpc::RpcContext* context);
+
+  // Records the time the request spent in the queue, and asks the admission controller of the
+  // tablet whether the request should be served. Responds with an error if it should not, and
+  // returns false. The request is considered served until ticket is released.
+  template<class Resp>
+  bool AdmitOrRespond(
+      tablet::Tablet* tablet, tablet::AdmissionKind kind, Resp* resp, rpc::RpcContext* context,
+      tablet::AdmissionTicket* ticket);
+
   // Read implementation. If restart is required returns restart time, in case of success
   // returns invalid ReadHybridTime. Otherwise returns error status.
   Result<ReadHybridTime> DoRead(ReadContext* read_context);
@@ -158,6 +179,9 @@ class TabletServiceImpl : public TabletServerServiceIf {
   void CompleteRead(ReadContext* read_context);
 
   TabletServerIf *const server_;
+
+  // Number of checksum scans running on this server, they share the rate limit.
+  std::atomic<int> num_checksum_scans_{0};
 };
 
 class TabletServiceAdminImpl : public TabletServerAdminServiceIf {
@@ -200,6 +224,10 @@ class ConsensusServiceImpl : public consensus::ConsensusServiceIf {
                                consensus::ConsensusResponsePB *resp,
                                rpc::RpcContext context) override;
 
+  virtual void MultiRaftUpdateConsensus(const consensus::MultiRaftConsensusRequestPB *req,
+                                        consensus::MultiRaftConsensusResponsePB *resp,
+                                        rpc::RpcContext context) override;
+
   virtual void RequestConsensusVote(const consensus::VoteRequestPB* req,
                                     consensus::VoteResponsePB* resp,
                                     rpc::RpcContext context) override;
@@ -32,6 +32,7 @@
 
 #include "yb/tserver/ts_tablet_manager.h"
 
+#include <set>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -58,6 +59,7 @@
   ASSERT_NO_FATALS(AssertMonotonicReportSeqno(report_seqno, tablet_report))
 
 DECLARE_bool(pretend_memory_exceeded_enforce_flush);
+DECLARE_int32(tablet_report_limit);
 
 namespace yb {
 namespace tserver {
@@ -319,5 +321,38 @@ TEST_F(TsTabletManagerTest, TestTabletReports) {
   ASSERT_MONOTONIC_REPORT_SEQNO(&seqno, report);
 }
 
+TEST_F(TsTabletManagerTest, TestTabletReportLimit) {
+  constexpr int kNumTablets = 5;
+  FLAGS_tablet_report_limit = 2;
+  for (int i = 0; i != kNumTablets; ++i) {
+    ASSERT_OK(CreateNewTablet(Format("tablet-$0", i), schema_, nullptr));
+  }
+
+  // The full report contains the first tablets, the rest are sent by incremental reports.
+  TabletReportPB report;
+  tablet_manager_->GenerateFullTabletReport(&report);
+  ASSERT_FALSE(report.is_incremental());
+  ASSERT_EQ(FLAGS_tablet_report_limit, report.updated_tablets_size());
+  ASSERT_EQ(kNumTablets - FLAGS_tablet_report_limit, report.remaining_tablet_count());
+  tablet_manager_->MarkTabletReportAcknowledged(report);
+
+  std::set<std::string> reported_tablets;
+  for (const auto& reported_tablet : report.updated_tablets()) {
+    reported_tablets.insert(reported_tablet.tablet_id());
+  }
+  // Tablets could be marked dirty again while they are being created, so just wait until every
+  // tablet is reported and nothing remains.
+  ASSERT_OK(WaitFor([&] {
+    tablet_manager_->GenerateIncrementalTabletReport(&report);
+    EXPECT_TRUE(report.is_incremental());
+    EXPECT_LE(report.updated_tablets_size(), FLAGS_tablet_report_limit);
+    for (const auto& reported_tablet : report.updated_tablets()) {
+      reported_tablets.insert(reported_tablet.tablet_id());
+    }
+    tablet_manager_->MarkTabletReportAcknowledged(report);
+    return reported_tablets.size() == kNumTablets && report.remaining_tablet_count() == 0;
+  }, MonoDelta::FromSeconds(10), "All tablets reported"));
+}
+
 } // namespace tserver
 } // namespace yb
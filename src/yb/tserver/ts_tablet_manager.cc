@@ -33,6 +33,7 @@
 #include "yb/tserver/ts_tablet_manager.h"
 
 #include <algorithm>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -59,12 +60,16 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/strings/util.h"
 
+#include "yb/docdb/docdb_rocksdb_util.h"
+
 #include "yb/master/master.pb.h"
 #include "yb/master/sys_catalog.h"
 
 #include "yb/rocksdb/memory_monitor.h"
+#include "yb/rocksdb/persistent_block_cache.h"
 
 #include "yb/rpc/messenger.h"
+#include "yb/rpc/thread_pool.h"
 
 #include "yb/tablet/metadata.pb.h"
 #include "yb/tablet/tablet.h"
@@ -84,9 +89,14 @@
 #include "yb/util/env_util.h"
 #include "yb/util/fault_injection.h"
 #include "yb/util/flag_tags.h"
+#include "yb/util/io_scheduler.h"
 #include "yb/util/mem_tracker.h"
 #include "yb/util/metrics.h"
+#include "yb/util/os-util.h"
+#include "yb/util/path_util.h"
 #include "yb/util/pb_util.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/trace.h"
 #include "yb/util/tsan_util.h"
@@ -94,6 +104,7 @@
 
 using namespace std::literals;
 using namespace std::placeholders;
+using namespace yb::size_literals;
 
 DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "Number of threads available to open tablets during startup. If this "
@@ -103,6 +114,13 @@ DEFINE_int32(num_tablets_to_open_simultaneously, 0,
              "may make sense to manually tune this.");
 TAG_FLAG(num_tablets_to_open_simultaneously, advanced);
 
+DEFINE_int32(num_tablets_to_prewarm_on_startup, 0,
+             "Number of the most recently written tablets whose SST files are opened, together "
+             "with their top level index block and first data block, by a background thread "
+             "after all tablets were bootstrapped during startup. Filter blocks are not loaded. "
+             "0 disables prewarming.");
+TAG_FLAG(num_tablets_to_prewarm_on_startup, advanced);
+
 DEFINE_int32(tablet_start_warn_threshold_ms, 500,
              "If a tablet takes more than this number of millis to start, issue "
              "a warning with a trace.");
@@ -152,6 +170,21 @@ DEFINE_int64(global_memstore_size_mb_max, 2048,
              "Global memstore size is determined as a percentage of the available "
              "memory. However, this flag limits it in absolute size. Value of 0 "
              "means no limit on the value obtained by the percentage. Default is 2048.");
+DEFINE_int32(global_memstore_soft_limit_percentage, 85,
+             "Percentage of the global memstore size at which tablets start being flushed, so the "
+             "global memstore stays below this target under write spikes. Value of 0 disables "
+             "flushing before the global memstore size is reached.");
+TAG_FLAG(global_memstore_soft_limit_percentage, advanced);
+DEFINE_double(memstore_flush_log_retention_weight, 0.25,
+              "Weight of the size of the log retained by a tablet memstore, relative to the "
+              "memstore size, when choosing tablets to flush because of memory pressure.");
+TAG_FLAG(memstore_flush_log_retention_weight, advanced);
+TAG_FLAG(memstore_flush_log_retention_weight, runtime);
+DEFINE_int32(memstore_flush_age_boost_sec, 300,
+             "A memstore whose oldest write is this old is valued as twice its size when choosing "
+             "tablets to flush because of memory pressure. Value of 0 disables the age boost.");
+TAG_FLAG(memstore_flush_age_boost_sec, advanced);
+TAG_FLAG(memstore_flush_age_boost_sec, runtime);
 
 DEFINE_int64(db_block_cache_size_bytes, kDbCacheSizeUsePercentage,
              "Size of cross-tablet shared RocksDB block cache (in bytes). "
@@ -163,6 +196,28 @@ DEFINE_int32(db_block_cache_size_percentage, 50,
              "Default percentage of total available memory to use as block cache size, if not "
              "asking for a raw number, through FLAGS_db_block_cache_size_bytes.");
 
+DEFINE_string(db_persistent_block_cache_path, "",
+              "Directory on a local device for the second-tier block cache. Blocks evicted from "
+              "the shared RocksDB block cache are written there and read back on block cache "
+              "misses. Empty value disables the persistent block cache.");
+DEFINE_int64(db_persistent_block_cache_size_bytes, 0,
+             "Disk space used by the persistent block cache, see "
+             "FLAGS_db_persistent_block_cache_path.");
+DEFINE_int64(db_persistent_block_cache_segment_size_bytes, 64_MB,
+             "Size of a single persistent block cache file. Space is reclaimed one file at a "
+             "time.");
+TAG_FLAG(db_persistent_block_cache_segment_size_bytes, advanced);
+DEFINE_int64(db_persistent_block_cache_max_pending_write_bytes, 16_MB,
+             "Maximum size of the evicted blocks waiting to be written to the persistent block "
+             "cache. Blocks evicted while the writer is that far behind are dropped.");
+TAG_FLAG(db_persistent_block_cache_max_pending_write_bytes, advanced);
+
+DEFINE_int64(db_block_cache_compressed_size_bytes, 0,
+             "Size of the shared RocksDB cache of compressed blocks, consulted on block cache "
+             "misses before reading the table file. Keeps more data in memory than the block "
+             "cache of uncompressed blocks, at the cost of decompressing blocks on every block "
+             "cache miss. 0 disables the compressed block cache.");
+
 DEFINE_int32(read_pool_max_threads, 128,
              "The maximum number of threads allowed for read_pool_. This pool is used "
              "to run multiple read operations, that are part of the same tablet rpc, "
@@ -172,6 +227,15 @@ DEFINE_int32(read_pool_max_queue_size, 128,
              "is used to run multiple read operations, that are part of the same tablet rpc, "
              "in parallel.");
 
+DEFINE_int32(checksum_pool_max_threads, 4,
+             "The maximum number of threads allowed for checksum_pool_. This pool runs checksum "
+             "scans of tablets, so it limits the number of them running concurrently.");
+
+DEFINE_int32(txn_apply_pool_max_threads, 4,
+             "The maximum number of threads allowed for txn_apply_pool_. This pool applies "
+             "intents of big transactions in background, after the first batch was applied "
+             "by the transaction apply operation.");
+
 DEFINE_test_flag(int32, sleep_after_tombstoning_tablet_secs, 0,
                  "Whether we sleep in LogAndTombstone after calling DeleteTabletData.");
 
@@ -181,6 +245,30 @@ DEFINE_int32(tserver_yb_client_default_timeout_ms, kTServerYbClientDefaultTimeou
              "Default timeout for the YBClient embedded into the tablet server that is used "
              "for distributed transactions.");
 
+DEFINE_int32(tablet_report_limit, 1000,
+             "Max number of tablets reported in a single heartbeat. Remaining changed tablets, "
+             "including the rest of a full report, are sent by the following heartbeats.");
+TAG_FLAG(tablet_report_limit, advanced);
+
+DEFINE_string(raft_pool_cpus, "",
+              "Cpus that threads of the raft pool are restricted to, in the taskset format, "
+              "e.g. 0-3,8. Empty means no restriction.");
+TAG_FLAG(raft_pool_cpus, advanced);
+DEFINE_string(log_append_cpus, "",
+              "Cpus that WAL append threads are restricted to, in the taskset format. "
+              "Empty means no restriction.");
+TAG_FLAG(log_append_cpus, advanced);
+
+DEFINE_bool(enable_io_scheduler, false,
+            "Whether WAL appends, flushes, compactions and remote bootstrap downloads share the "
+            "write bandwidth of each disk through its I/O scheduler. When enabled, "
+            "rocksdb_compact_flush_rate_limit_bytes_per_sec is not used.");
+
+static bool raft_pool_cpus_dummy = google::RegisterFlagValidator(
+    &FLAGS_raft_pool_cpus, &yb::ValidateCpuListFlag);
+static bool log_append_cpus_dummy = google::RegisterFlagValidator(
+    &FLAGS_log_append_cpus, &yb::ValidateCpuListFlag);
+
 namespace yb {
 namespace tserver {
 
@@ -270,25 +358,81 @@ void TSTabletManager::MaybeFlushTablet() {
           Substitute("Flush failed on $0", tablet_to_flush->tablet_id()));
     }
   }
+
+  if (!memory_monitor()->SoftLimitExceeded()) {
+    return;
+  }
+
+  // Memtables that are being flushed already will be freed soon, so we flush only enough tablets
+  // to bring the rest of the memstore memory below the soft limit.
+  size_t flushing_size = 0;
+  auto tablets_to_flush = TabletsToFlush(&flushing_size);
+  size_t usage = memory_monitor()->memory_usage();
+  usage = usage > flushing_size ? usage - flushing_size : 0;
+  for (const auto& info : tablets_to_flush) {
+    if (usage < memory_monitor()->soft_limit()) {
+      break;
+    }
+    VLOG(1) << "Flushing tablet " << info.tablet_peer->tablet_id() << " with "
+            << info.memtables_size << " bytes in memstore, score " << info.score
+            << ", memstore usage " << usage << " exceeds soft limit "
+            << memory_monitor()->soft_limit();
+    WARN_NOT_OK(info.tablet_peer->tablet()->Flush(tablet::FlushMode::kAsync),
+                Substitute("Flush failed on $0", info.tablet_peer->tablet_id()));
+    usage -= std::min(usage, info.memtables_size);
+  }
 }
 
-// Return the tablet with the oldest write in memstore, or nullptr if all
-// tablet memstores are empty or about to flush.
-TabletPeerPtr TSTabletManager::TabletToFlush() {
-  boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
-  HybridTime oldest_write_in_memstores = HybridTime::kMax;
-  TabletPeerPtr tablet_to_flush;
-  for (const TabletMap::value_type& entry : tablet_map_) {
-    const auto tablet = entry.second->shared_tablet();
-    if (tablet) {
-      const HybridTime oldest_write_in_memstore = tablet->flush_stats()->oldest_write_in_memstore();
-      if (oldest_write_in_memstore < oldest_write_in_memstores) {
-        oldest_write_in_memstores = oldest_write_in_memstore;
-        tablet_to_flush = entry.second;
+std::vector<TSTabletManager::TabletToFlushInfo> TSTabletManager::TabletsToFlush(
+    size_t* flushing_size) {
+  std::vector<TabletToFlushInfo> result;
+  *flushing_size = 0;
+  const auto log_retention_weight = FLAGS_memstore_flush_log_retention_weight;
+  const auto age_boost_sec = FLAGS_memstore_flush_age_boost_sec;
+  {
+    boost::shared_lock<RWMutex> lock(lock_); // For using the tablet map
+    for (const TabletMap::value_type& entry : tablet_map_) {
+      const auto tablet = entry.second->shared_tablet();
+      if (!tablet) {
+        continue;
       }
+      const size_t active_size = tablet->GetActiveMemTablesSize();
+      const size_t all_size = tablet->GetAllMemTablesSize();
+      *flushing_size += all_size > active_size ? all_size - active_size : 0;
+
+      // Memstore is empty or flush of it was just scheduled.
+      const HybridTime oldest_write = tablet->flush_stats()->oldest_write_in_memstore();
+      if (oldest_write == HybridTime::kMax) {
+        continue;
+      }
+
+      int64_t retained_log_size = 0;
+      int64_t gcable_log_size = 0;
+      if (entry.second->log_available() && entry.second->GetGCableDataSize(&gcable_log_size).ok()) {
+        retained_log_size = std::max<int64_t>(
+            entry.second->log()->OnDiskSize() - gcable_log_size, 0);
+      }
+
+      double score = active_size + log_retention_weight * retained_log_size;
+      if (age_boost_sec > 0) {
+        const auto now = entry.second->clock().Now();
+        const auto age_usec = std::max<int64_t>(
+            now.GetPhysicalValueMicros() - oldest_write.GetPhysicalValueMicros(), 0);
+        score *= 1.0 + age_usec / (age_boost_sec * 1e6);
+      }
+      result.push_back(TabletToFlushInfo{entry.second, active_size, score});
     }
   }
-  return tablet_to_flush;
+  std::sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.score > rhs.score;
+  });
+  return result;
+}
+
+TabletPeerPtr TSTabletManager::TabletToFlush() {
+  size_t flushing_size = 0;
+  auto tablets_to_flush = TabletsToFlush(&flushing_size);
+  return tablets_to_flush.empty() ? nullptr : tablets_to_flush.front().tablet_peer;
 }
 
 TSTabletManager::TSTabletManager(FsManager* fs_manager,
@@ -318,6 +462,7 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   // submit its own tasks via a dedicated token.
   CHECK_OK(ThreadPoolBuilder("raft")
                .unlimited_threads()
+               .set_cpus(CpuListFromFlag(FLAGS_raft_pool_cpus))
                .Build(&raft_pool_));
   CHECK_OK(ThreadPoolBuilder("prepare")
                .unlimited_threads()
@@ -325,6 +470,7 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
   CHECK_OK(ThreadPoolBuilder("append")
                .unlimited_threads()
                .set_idle_timeout(MonoDelta::FromMilliseconds(10000))
+               .set_cpus(CpuListFromFlag(FLAGS_log_append_cpus))
                .Build(&append_pool_));
   ThreadPoolMetrics read_metrics = {
       METRIC_op_read_queue_length.Instantiate(server_->metric_entity()),
@@ -336,6 +482,12 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
                .set_max_queue_size(FLAGS_read_pool_max_queue_size)
                .set_metrics(std::move(read_metrics))
                .Build(&read_pool_));
+  CHECK_OK(ThreadPoolBuilder("checksum")
+               .set_max_threads(FLAGS_checksum_pool_max_threads)
+               .Build(&checksum_pool_));
+  txn_apply_pool_ = std::make_unique<rpc::ThreadPool>(
+      "txn-apply", std::numeric_limits<size_t>::max() /* queue_limit */,
+      std::max(FLAGS_txn_apply_pool_max_threads, 1));
 
   int64_t block_cache_size_bytes = FLAGS_db_block_cache_size_bytes;
   int64_t total_ram_avail = MemTracker::GetRootTracker()->limit();
@@ -358,8 +510,35 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
     tablet_options_.block_cache = rocksdb::NewLRUCache(block_cache_size_bytes,
                                                        FLAGS_db_block_cache_num_shard_bits);
     tablet_options_.block_cache->SetMetrics(server_->metric_entity());
+
+    if (FLAGS_db_block_cache_compressed_size_bytes > 0) {
+      tablet_options_.block_cache_compressed = rocksdb::NewLRUCache(
+          FLAGS_db_block_cache_compressed_size_bytes, FLAGS_db_block_cache_num_shard_bits);
+      tablet_options_.block_cache_compressed_mem_tracker = MemTracker::FindOrCreateTracker(
+          FLAGS_db_block_cache_compressed_size_bytes, "CompressedBlockCache",
+          server_->mem_tracker());
+    }
+
+    if (!FLAGS_db_persistent_block_cache_path.empty() &&
+        FLAGS_db_persistent_block_cache_size_bytes > 0) {
+      rocksdb::PersistentBlockCacheOptions persistent_cache_options;
+      persistent_cache_options.env = tablet_options_.rocksdb_env;
+      persistent_cache_options.path = FLAGS_db_persistent_block_cache_path;
+      persistent_cache_options.capacity = FLAGS_db_persistent_block_cache_size_bytes;
+      persistent_cache_options.segment_size = FLAGS_db_persistent_block_cache_segment_size_bytes;
+      persistent_cache_options.max_pending_write_bytes =
+          FLAGS_db_persistent_block_cache_max_pending_write_bytes;
+      persistent_cache_options.mem_tracker = block_based_table_mem_tracker_;
+      CHECK_OK(rocksdb::NewPersistentBlockCache(
+          persistent_cache_options, &tablet_options_.persistent_block_cache));
+      tablet_options_.persistent_block_cache->SetMetrics(server_->metric_entity());
+    }
   }
 
+  priority_thread_pool_ = docdb::CreatePriorityThreadPoolForCompactions();
+  tablet_options_.priority_thread_pool_for_compactions = priority_thread_pool_.get();
+  tablet_options_.rate_limiter = docdb::CreateSharedCompactFlushRateLimiter();
+
   // Calculate memstore_size_bytes
   bool should_count_memory = FLAGS_global_memstore_size_percentage > 0;
   CHECK(FLAGS_global_memstore_size_percentage > 0 && FLAGS_global_memstore_size_percentage <= 100)
@@ -381,8 +560,12 @@ TSTabletManager::TSTabletManager(FsManager* fs_manager,
       "tablet manager",
       "flush scheduler bgtask",
       std::chrono::milliseconds(FLAGS_flush_background_task_interval_msec)));
+    const auto soft_limit_percentage = FLAGS_global_memstore_soft_limit_percentage;
+    const size_t memstore_soft_limit_bytes =
+        soft_limit_percentage > 0 && soft_limit_percentage < 100
+            ? memstore_size_bytes * soft_limit_percentage / 100 : 0;
     tablet_options_.memory_monitor = std::make_shared<rocksdb::MemoryMonitor>(
-        memstore_size_bytes,
+        memstore_size_bytes, memstore_soft_limit_bytes,
         std::function<void()>([this](){
                                 YB_WARN_NOT_OK(background_task_->Wake(), "Wakeup error"); }));
   }
@@ -403,6 +586,20 @@ Status TSTabletManager::Init() {
   tablet_options_.env = server_->GetEnv();
   tablet_options_.rocksdb_env = server_->GetRocksDBEnv();
 
+  if (FLAGS_enable_io_scheduler) {
+    // Data and WAL root dirs on the same disk have the same parent.
+    auto root_dirs = fs_manager_->GetDataRootDirs();
+    auto wal_root_dirs = fs_manager_->GetWalRootDirs();
+    root_dirs.insert(root_dirs.end(), wal_root_dirs.begin(), wal_root_dirs.end());
+    for (const auto& root_dir : root_dirs) {
+      auto disk_dir = DirName(root_dir);
+      if (!io_schedulers_.count(disk_dir)) {
+        io_schedulers_.emplace(disk_dir, std::make_shared<IoScheduler>(disk_dir));
+      }
+    }
+    LOG(INFO) << "Using I/O schedulers of " << io_schedulers_.size() << " disks";
+  }
+
   // Start the threadpool we'll use to open tablets.
   // This has to be done in Init() instead of the constructor, since the
   // FsManager isn't initialized until this point.
@@ -419,6 +616,9 @@ Status TSTabletManager::Init() {
   RETURN_NOT_OK(ThreadPoolBuilder("tablet-bootstrap")
                 .set_max_threads(max_bootstrap_threads)
                 .Build(&open_tablet_pool_));
+  RETURN_NOT_OK(ThreadPoolBuilder("tablet-prewarm")
+                .set_max_threads(1)
+                .Build(&prewarm_pool_));
 
   // Search for tablets in the metadata dir.
   vector<string> tablet_ids;
@@ -498,9 +698,48 @@ Status TSTabletManager::WaitForAllBootstrapsToFinish() {
     }
   }
 
+  if (FLAGS_num_tablets_to_prewarm_on_startup > 0) {
+    shared_lock.unlock();
+    PrewarmTablets(FLAGS_num_tablets_to_prewarm_on_startup);
+  }
+
   return s;
 }
 
+void TSTabletManager::PrewarmTablets(size_t num_tablets) {
+  std::vector<std::pair<HybridTime, TabletPeerPtr>> candidates;
+  for (const auto& peer : GetTabletPeers()) {
+    auto tablet = peer->shared_tablet();
+    if (peer->state() != RUNNING || !tablet) {
+      continue;
+    }
+    // Recency of writes is the only hint of tablet hotness available without any reads.
+    auto max_persistent_ht = tablet->MaxPersistentHybridTime();
+    if (max_persistent_ht.ok()) {
+      candidates.emplace_back(*max_persistent_ht, peer);
+    }
+  }
+  num_tablets = std::min(num_tablets, candidates.size());
+  std::partial_sort(
+      candidates.begin(), candidates.begin() + num_tablets, candidates.end(),
+      [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+  candidates.resize(num_tablets);
+
+  LOG(INFO) << "Prewarming SST files of " << num_tablets << " tablets";
+  for (const auto& candidate : candidates) {
+    auto peer = candidate.second;
+    // Prewarms run one at a time on their own pool, so tablets opened later, e.g. created by
+    // remote bootstrap, don't wait for them.
+    WARN_NOT_OK(prewarm_pool_->SubmitFunc([peer] {
+      auto tablet = peer->shared_tablet();
+      if (tablet) {
+        WARN_NOT_OK(tablet->PrewarmSstFiles(),
+                    Format("Failed to prewarm SST files of $0", peer->tablet_id()));
+      }
+    }), "Failed to submit prewarm of tablet " + peer->tablet_id());
+  }
+}
+
 Status TSTabletManager::CreateNewTablet(
     const string &table_id,
     const string &tablet_id,
@@ -966,7 +1205,7 @@ void TSTabletManager::OpenTablet(const scoped_refptr<RaftGroupMetadata>& meta,
         metric_registry_,
         tablet_peer->status_listener(),
         tablet_peer->log_anchor_registry(),
-        tablet_options_,
+        TabletOptionsFor(*meta),
         " P " + tablet_peer->permanent_uuid(),
         tablet_peer.get(),
         std::bind(&TSTabletManager::PreserveLocalLeadersOnly, this, _1),
@@ -994,6 +1233,8 @@ void TSTabletManager::OpenTablet(const scoped_refptr<RaftGroupMetadata>& meta,
                                          tablet->GetMetricEntity(),
                                          raft_pool(),
                                          tablet_prepare_pool(),
+                                         apply_pool_.get(),
+                                         txn_apply_pool_.get(),
                                          &retryable_requests);
 
     if (!s.ok()) {
@@ -1057,6 +1298,7 @@ void TSTabletManager::StartShutdown() {
 
   // Shut down the bootstrap pool, so new tablets are registered after this point.
   open_tablet_pool_->Shutdown();
+  prewarm_pool_->Shutdown();
 
   // Take a snapshot of the peers list -- that way we don't have to hold
   // on to the lock while shutting them down, which might cause a lock
@@ -1076,6 +1318,10 @@ void TSTabletManager::CompleteShutdown() {
   // Shut down the apply pool.
   apply_pool_->Shutdown();
 
+  // Background applies of destroyed tablets are complete, so only tasks of tablets that failed
+  // before being shut down could be dropped here.
+  txn_apply_pool_->Shutdown();
+
   if (raft_pool_) {
     raft_pool_->Shutdown();
   }
@@ -1085,6 +1331,12 @@ void TSTabletManager::CompleteShutdown() {
   if (append_pool_) {
     append_pool_->Shutdown();
   }
+  if (checksum_pool_) {
+    checksum_pool_->Shutdown();
+  }
+  if (priority_thread_pool_) {
+    priority_thread_pool_->Shutdown();
+  }
 
   {
     std::lock_guard<RWMutex> l(lock_);
@@ -1334,22 +1586,29 @@ void TSTabletManager::GenerateIncrementalTabletReport(TabletReportPB* report) {
   // to block if there is a waiting writer (see KUDU-2193). So, we just make
   // a local copy of the set of replicas.
   vector<std::shared_ptr<TabletPeer>> to_report;
+  const size_t limit = std::max(FLAGS_tablet_report_limit, 1);
+  int32_t remaining = 0;
   {
-    boost::shared_lock<RWMutex> shared_lock(lock_);
-    to_report.reserve(dirty_tablets_.size());
+    std::lock_guard<RWMutex> lock(lock_);
+    to_report.reserve(std::min(dirty_tablets_.size(), limit));
     report->set_sequence_number(next_report_seq_++);
-    for (const DirtyMap::value_type& dirty_entry : dirty_tablets_) {
+    for (DirtyMap::value_type& dirty_entry : dirty_tablets_) {
       const string& tablet_id = dirty_entry.first;
       TabletPeerPtr* tablet_peer = FindOrNull(tablet_map_, tablet_id);
-      if (tablet_peer) {
+      if (!tablet_peer) {
+        // Removed.
+        report->add_removed_tablet_ids(tablet_id);
+      } else if (to_report.size() < limit) {
         // Dirty entry, report on it.
         to_report.push_back(*tablet_peer);
       } else {
-        // Removed.
-        report->add_removed_tablet_ids(tablet_id);
+        // Does not fit into this report, keep it dirty after this report is acknowledged.
+        dirty_entry.second.change_seq = next_report_seq_;
+        ++remaining;
       }
     }
   }
+  report->set_remaining_tablet_count(remaining);
   for (const auto& replica : to_report) {
     CreateReportedTabletPB(replica, report->add_updated_tablets());
   }
@@ -1364,17 +1623,25 @@ void TSTabletManager::GenerateFullTabletReport(TabletReportPB* report) {
   // to block if there is a waiting writer (see KUDU-2193). So, we just make
   // a local copy of the set of replicas.
   vector<std::shared_ptr<TabletPeer>> to_report;
+  const size_t limit = std::max(FLAGS_tablet_report_limit, 1);
   {
-    boost::shared_lock<RWMutex> shared_lock(lock_);
+    std::lock_guard<RWMutex> lock(lock_);
     report->set_sequence_number(next_report_seq_++);
     GetTabletPeersUnlocked(&to_report);
+    dirty_tablets_.clear();
+    // Tablets that do not fit into this report are marked dirty, so they are sent by the following
+    // incremental reports.
+    if (to_report.size() > limit) {
+      for (size_t i = limit; i != to_report.size(); ++i) {
+        dirty_tablets_[to_report[i]->tablet_id()].change_seq = next_report_seq_;
+      }
+      report->set_remaining_tablet_count(to_report.size() - limit);
+      to_report.resize(limit);
+    }
   }
   for (const auto& replica : to_report) {
     CreateReportedTabletPB(replica, report->add_updated_tablets());
   }
-
-  std::lock_guard<RWMutex> l(lock_);
-  dirty_tablets_.clear();
 }
 
 void TSTabletManager::MarkTabletReportAcknowledged(const TabletReportPB& report) {
@@ -1502,6 +1769,22 @@ void TSTabletManager::GetAndRegisterDataAndWalDir(FsManager* fs_manager,
   wal_assignment_value_iter->second.insert(tablet_id);
 }
 
+std::shared_ptr<IoScheduler> TSTabletManager::IoSchedulerForRootDir(
+    const std::string& root_dir) const {
+  auto it = io_schedulers_.find(DirName(root_dir));
+  return it != io_schedulers_.end() ? it->second : nullptr;
+}
+
+tablet::TabletOptions TSTabletManager::TabletOptionsFor(const RaftGroupMetadata& meta) const {
+  auto result = tablet_options_;
+  auto data_io_scheduler = IoSchedulerForRootDir(meta.data_root_dir());
+  if (data_io_scheduler) {
+    result.rate_limiter = docdb::CreateIoSchedulerRateLimiter(std::move(data_io_scheduler));
+  }
+  result.wal_io_scheduler = IoSchedulerForRootDir(meta.wal_root_dir());
+  return result;
+}
+
 void TSTabletManager::RegisterDataAndWalDir(FsManager* fs_manager,
                                             const string& table_id,
                                             const string& tablet_id,
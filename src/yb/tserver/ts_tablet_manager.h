@@ -71,6 +71,11 @@ class HostPort;
 class Partition;
 class Schema;
 class BackgroundTask;
+class IoScheduler;
+
+namespace rpc {
+class ThreadPool;
+}
 
 namespace consensus {
 class RaftConfigPB;
@@ -153,6 +158,7 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   ThreadPool* tablet_prepare_pool() const { return tablet_prepare_pool_.get(); }
   ThreadPool* raft_pool() const { return raft_pool_.get(); }
   ThreadPool* read_pool() const { return read_pool_.get(); }
+  ThreadPool* checksum_pool() const { return checksum_pool_.get(); }
   ThreadPool* append_pool() const { return append_pool_.get(); }
 
   // Create a new tablet and register it with the tablet manager. The new tablet
@@ -219,11 +225,16 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // next tablet report will continue to include the same tablets until one
   // is acknowleged.
   //
+  // At most tablet_report_limit tablets are included, the number of changed tablets left out is
+  // set in remaining_tablet_count.
+  //
   // This is thread-safe to call along with tablet modification, but not safe
   // to call from multiple threads at the same time.
   void GenerateIncrementalTabletReport(master::TabletReportPB* report);
 
   // Generate a full tablet report and reset any incremental state tracking.
+  // Tablets beyond tablet_report_limit are marked dirty and sent by the following incremental
+  // reports.
   void GenerateFullTabletReport(master::TabletReportPB* report);
 
   // Mark that the master successfully received and processed the given
@@ -290,11 +301,16 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
 
   bool IsTabletInTransition(const std::string& tablet_id) const;
 
+  // Returns the I/O scheduler of the disk of the given data or WAL root dir, or nullptr if I/O
+  // schedulers are disabled.
+  std::shared_ptr<IoScheduler> IoSchedulerForRootDir(const std::string& root_dir) const;
+
   TabletServer* server() { return server_; }
 
   MemoryMonitor* memory_monitor() { return tablet_options_.memory_monitor.get(); }
 
-  // Flush some tablet if the memstore memory limit is exceeded
+  // Flush some tablet if the memstore memory limit is exceeded, and enough tablets to bring the
+  // memstore memory below the soft limit if it is exceeded.
   void MaybeFlushTablet();
 
  private:
@@ -330,6 +346,9 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
                                             const std::string& reason,
                                             scoped_refptr<TransitionInProgressDeleter>* deleter);
 
+  // Returns tablet_options_ with the I/O schedulers of the disks of the tablet.
+  tablet::TabletOptions TabletOptionsFor(const tablet::RaftGroupMetadata& meta) const;
+
   // Open a tablet meta from the local file system by loading its superblock.
   CHECKED_STATUS OpenTabletMeta(const std::string& tablet_id,
                         scoped_refptr<tablet::RaftGroupMetadata>* metadata);
@@ -348,6 +367,10 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   void OpenTablet(const scoped_refptr<tablet::RaftGroupMetadata>& meta,
                   const scoped_refptr<TransitionInProgressDeleter>& deleter);
 
+  // Submits opening of SST files of num_tablets most recently written running tablets to the
+  // tablet open pool, so first reads from them after startup do not wait for it.
+  void PrewarmTablets(size_t num_tablets);
+
   // Open a tablet whose metadata has already been loaded.
   void BootstrapAndInitTablet(const scoped_refptr<tablet::RaftGroupMetadata>& meta,
                               std::shared_ptr<tablet::TabletPeer>* peer);
@@ -387,7 +410,20 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   CHECKED_STATUS HandleNonReadyTabletOnStartup(
       const scoped_refptr<tablet::RaftGroupMetadata>& meta);
 
-  // Return the tablet with oldest write still in its memstore
+  struct TabletToFlushInfo {
+    std::shared_ptr<tablet::TabletPeer> tablet_peer;
+    // Memory that a flush of the tablet would free.
+    size_t memtables_size;
+    double score;
+  };
+
+  // Returns tablets with writes in their memstores, the most valuable flush first. Flushes are
+  // valued by the memory they free, the age of the oldest write in the memstore and the size of
+  // the log it retains. Sets flushing_size to the size of memtables that are already being flushed.
+  std::vector<TabletToFlushInfo> TabletsToFlush(size_t* flushing_size);
+
+  // Return the tablet that is the most valuable to flush, or nullptr if all tablet memstores are
+  // empty or about to flush.
   std::shared_ptr<tablet::TabletPeer> TabletToFlush();
 
   TSTabletManagerStatePB state() const {
@@ -449,12 +485,19 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool used to open the tablets async, whether bootstrap is required or not.
   std::unique_ptr<ThreadPool> open_tablet_pool_;
 
+  // Single thread pool used to prewarm SST files after startup, so prewarming does not delay
+  // tablets opened by open_tablet_pool_.
+  std::unique_ptr<ThreadPool> prewarm_pool_;
+
   // Thread pool for preparing transactions, shared between all tablets.
   std::unique_ptr<ThreadPool> tablet_prepare_pool_;
 
   // Thread pool for apply transactions, shared between all tablets.
   std::unique_ptr<ThreadPool> apply_pool_;
 
+  // Thread pool for background apply of intents of big transactions, shared between all tablets.
+  std::unique_ptr<rpc::ThreadPool> txn_apply_pool_;
+
   // Thread pool for Raft-related operations, shared between all tablets.
   std::unique_ptr<ThreadPool> raft_pool_;
 
@@ -464,12 +507,22 @@ class TSTabletManager : public tserver::TabletPeerLookupIf {
   // Thread pool for read ops, that are run in parallel, shared between all tablets.
   std::unique_ptr<ThreadPool> read_pool_;
 
+  // Thread pool for checksum scans of tablets, shared between all tablets.
+  std::unique_ptr<ThreadPool> checksum_pool_;
+
   // Used for scheduling flushes
   std::unique_ptr<BackgroundTask> background_task_;
 
+  // Thread pool for compactions, shared between all tablets.
+  std::unique_ptr<PriorityThreadPool> priority_thread_pool_;
+
   // For block cache and memory monitor shared across tablets
   tablet::TabletOptions tablet_options_;
 
+  // I/O schedulers keyed by the parent dir of the data and WAL root dirs of the disk. Filled in
+  // Init() and not changed after that.
+  std::unordered_map<std::string, std::shared_ptr<IoScheduler>> io_schedulers_;
+
   boost::optional<yb::client::AsyncClientInitialiser> async_client_init_;
 
   TabletPeers shutting_down_peers_;
@@ -42,6 +42,7 @@
 #include "yb/consensus/consensus.h"
 #include "yb/consensus/log_anchor_registry.h"
 #include "yb/consensus/quorum_util.h"
+#include "yb/docdb/doc_key.h"
 #include "yb/gutil/map-util.h"
 #include "yb/gutil/strings/human_readable.h"
 #include "yb/gutil/strings/join.h"
@@ -105,6 +106,10 @@ Status TabletServerPathHandlers::Register(Webserver* server) {
   server->RegisterPathHandler(
       "/log-anchors", "", std::bind(&TabletServerPathHandlers::HandleLogAnchorsPage, this, _1, _2),
       true /* styled */, false /* is_on_nav_bar */);
+  server->RegisterPathHandler(
+      "/tablet-hot-keys", "",
+      std::bind(&TabletServerPathHandlers::HandleHotKeysPage, this, _1, _2),
+      true /* styled */, false /* is_on_nav_bar */);
   server->RegisterPathHandler(
       "/", "Dashboards",
       std::bind(&TabletServerPathHandlers::HandleDashboardsPage, this, _1, _2), true /* styled */,
@@ -351,6 +356,12 @@ void TabletServerPathHandlers::HandleTabletPage(const Webserver::WebRequest& req
                                   "Tablet Log Anchors")
           << "</li>" << endl;
 
+  // Hot keys page.
+  *output << "<li>" << Substitute("<a href=\"/tablet-hot-keys?id=$0\">$1</a>",
+                                  UrlEncodeToString(tablet_id),
+                                  "Hot Keys")
+          << "</li>" << endl;
+
   // End list
   *output << "</ul>\n";
 }
@@ -383,6 +394,45 @@ void TabletServerPathHandlers::HandleLogAnchorsPage(const Webserver::WebRequest&
   *output << "<pre>" << EscapeForHtmlToString(dump) << "</pre>" << std::endl;
 }
 
+namespace {
+
+void HtmlOutputHotKeysTable(const std::string& title, const tablet::HotKeyTracker& tracker,
+                            std::stringstream* output) {
+  const auto total = tracker.total_count();
+  *output << "<h2>" << title << "</h2>\n";
+  *output << "<table class='table table-striped'>\n";
+  *output << "  <tr><th>Key</th><th>Estimated Count</th><th>Max Error</th><th>Share</th></tr>\n";
+  for (const auto& hot_key : tracker.TopKeys(std::numeric_limits<size_t>::max())) {
+    docdb::DocKey doc_key;
+    const auto key_str = doc_key.FullyDecodeFrom(hot_key.key).ok()
+        ? doc_key.ToString() : Slice(hot_key.key).ToDebugHexString();
+    *output << Substitute(
+        "  <tr><td>$0</td><td>$1</td><td>$2</td><td>$3%</td></tr>\n",
+        EscapeForHtmlToString(key_str), hot_key.count, hot_key.error,
+        StringPrintf("%.2f", total ? 100.0 * hot_key.count / total : 0.0));
+  }
+  *output << "</table>\n";
+}
+
+} // namespace
+
+void TabletServerPathHandlers::HandleHotKeysPage(const Webserver::WebRequest& req,
+                                                 std::stringstream* output) {
+  string tablet_id;
+  std::shared_ptr<TabletPeer> peer;
+  if (!LoadTablet(tserver_, req, &tablet_id, &peer, output)) return;
+  shared_ptr<Tablet> tablet = peer->shared_tablet();
+  if (!tablet) {
+    *output << "Tablet " << EscapeForHtmlToString(tablet_id) << " not running";
+    return;
+  }
+
+  *output << "<h1>Hot Keys for Tablet " << TabletLink(tablet_id) << "</h1>\n";
+  *output << "<p>Counts are estimated from sampled key accesses.</p>\n";
+  HtmlOutputHotKeysTable("Reads", tablet->hot_read_keys(), output);
+  HtmlOutputHotKeysTable("Writes", tablet->hot_write_keys(), output);
+}
+
 void TabletServerPathHandlers::HandleConsensusStatusPage(const Webserver::WebRequest& req,
                                                          std::stringstream* output) {
   string id;
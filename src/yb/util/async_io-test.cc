@@ -0,0 +1,123 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/async_io.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class AsyncIoTest : public YBTest {
+};
+
+TEST_F(AsyncIoTest, Order) {
+  constexpr int kQueues = 8;
+  constexpr int kOpsPerQueue = 1000;
+
+  std::vector<std::unique_ptr<AsyncIoQueue>> queues;
+  std::vector<std::vector<int>> executed(kQueues);
+  std::atomic<int> callbacks(0);
+  for (int i = 0; i != kQueues; ++i) {
+    queues.emplace_back(new AsyncIoQueue);
+  }
+  for (int j = 0; j != kOpsPerQueue; ++j) {
+    for (int i = 0; i != kQueues; ++i) {
+      auto* ops = &executed[i];
+      queues[i]->Submit([ops, j] {
+        ops->push_back(j);
+        return Status::OK();
+      }, [&callbacks](const Status& status) {
+        ASSERT_OK(status);
+        ++callbacks;
+      });
+    }
+  }
+  for (int i = 0; i != kQueues; ++i) {
+    ASSERT_OK(queues[i]->Wait());
+    ASSERT_EQ(kOpsPerQueue, executed[i].size());
+    for (int j = 0; j != kOpsPerQueue; ++j) {
+      ASSERT_EQ(j, executed[i][j]);
+    }
+  }
+  ASSERT_EQ(kQueues * kOpsPerQueue, callbacks.load());
+}
+
+// Operations submitted after a failed one are not executed, and report its failure.
+TEST_F(AsyncIoTest, Failure) {
+  AsyncIoQueue queue;
+  int executed = 0;
+  std::vector<Status> results;
+  for (int i = 0; i != 10; ++i) {
+    queue.Submit([&executed, i] {
+      ++executed;
+      return i == 3 ? STATUS_FORMAT(IOError, "Failed op $0", i) : Status::OK();
+    }, [&results](const Status& status) {
+      results.push_back(status);
+    });
+  }
+  auto status = queue.Wait();
+  ASSERT_TRUE(status.IsIOError()) << status;
+  ASSERT_EQ(4, executed);
+  ASSERT_EQ(10, results.size());
+  for (int i = 0; i != 10; ++i) {
+    ASSERT_EQ(i < 3, results[i].ok()) << i << ": " << results[i];
+  }
+  ASSERT_EQ(status.ToString(), results.back().ToString());
+}
+
+TEST_F(AsyncIoTest, WritableFile) {
+  const auto path = GetTestPath("async_file");
+  gscoped_ptr<WritableFile> target;
+  ASSERT_OK(env_->NewWritableFile(path, &target));
+  AsyncWritableFile file(std::shared_ptr<WritableFile>(target.release()));
+
+  std::string expected;
+  std::atomic<int> synced(0);
+  for (int i = 0; i != 100; ++i) {
+    auto piece = std::string(i + 1, 'a' + i % 26);
+    if (i % 2) {
+      ASSERT_OK(file.Append(piece));
+    } else {
+      ASSERT_OK(file.AppendVector({Slice(piece), Slice("-")}));
+      piece += "-";
+    }
+    expected += piece;
+    ASSERT_EQ(expected.size(), file.Size());
+    if (i % 10 == 0) {
+      file.SyncAsync([&synced](const Status& status) {
+        ASSERT_OK(status);
+        ++synced;
+      });
+    }
+  }
+  std::atomic<uint64_t> size_at_op(0);
+  file.SubmitAsync([&size_at_op](WritableFile* target) {
+    size_at_op = target->Size();
+    return Status::OK();
+  }, StdStatusCallback());
+  ASSERT_OK(file.Close());
+  ASSERT_EQ(10, synced.load());
+  ASSERT_EQ(expected.size(), size_at_op.load());
+
+  faststring content;
+  ASSERT_OK(ReadFileToString(env_.get(), path, &content));
+  ASSERT_EQ(expected, content.ToString());
+}
+
+} // namespace yb
@@ -0,0 +1,153 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/async_io.h"
+
+#include <string>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/threadpool.h"
+
+DEFINE_int32(async_io_threads, 4,
+             "Number of threads that perform asynchronous file I/O, shared by all the files "
+             "written asynchronously.");
+TAG_FLAG(async_io_threads, advanced);
+
+namespace yb {
+
+ThreadPool* AsyncIoThreadPool() {
+  // Never destroyed, since queues could be used during shutdown.
+  static ThreadPool* pool = [] {
+    std::unique_ptr<ThreadPool> result;
+    CHECK_OK(ThreadPoolBuilder("async_io")
+                 .set_max_threads(std::max(FLAGS_async_io_threads, 1))
+                 .Build(&result));
+    return result.release();
+  }();
+  return pool;
+}
+
+AsyncIoQueue::AsyncIoQueue(ThreadPool* pool)
+    : token_(pool->NewToken(ThreadPool::ExecutionMode::SERIAL)) {
+}
+
+AsyncIoQueue::~AsyncIoQueue() {
+  token_->Wait();
+}
+
+void AsyncIoQueue::Submit(std::function<Status()> op, StdStatusCallback callback) {
+  auto status = token_->SubmitFunc([this, op = std::move(op), callback] {
+    Execute(op, callback);
+  });
+  if (!status.ok()) {
+    SetFailed(status);
+    if (callback) {
+      callback(status);
+    }
+  }
+}
+
+void AsyncIoQueue::Execute(const std::function<Status()>& op, const StdStatusCallback& callback) {
+  Status status;
+  if (PREDICT_FALSE(failed_.load(std::memory_order_acquire))) {
+    status = this->status();
+  } else {
+    status = op();
+    if (!status.ok()) {
+      SetFailed(status);
+    }
+  }
+  if (callback) {
+    callback(status);
+  }
+}
+
+void AsyncIoQueue::SetFailed(const Status& status) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (status_.ok()) {
+    status_ = status;
+    failed_.store(true, std::memory_order_release);
+  }
+}
+
+Status AsyncIoQueue::Wait() {
+  token_->Wait();
+  return status();
+}
+
+Status AsyncIoQueue::status() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return status_;
+}
+
+AsyncWritableFile::AsyncWritableFile(std::shared_ptr<WritableFile> target, ThreadPool* pool)
+    : target_(std::move(target)), size_(target_->Size()), queue_(pool) {
+}
+
+AsyncWritableFile::~AsyncWritableFile() {
+  WARN_NOT_OK(queue_.Wait(), "Async write failed for " + target_->filename());
+}
+
+Status AsyncWritableFile::PreAllocate(uint64_t size) {
+  queue_.Submit([this, size] { return target_->PreAllocate(size); });
+  return queue_.status();
+}
+
+Status AsyncWritableFile::Append(const Slice& data) {
+  auto buffer = std::make_shared<std::string>(data.cdata(), data.size());
+  size_.fetch_add(data.size(), std::memory_order_acq_rel);
+  queue_.Submit([this, buffer] { return target_->Append(*buffer); });
+  return queue_.status();
+}
+
+Status AsyncWritableFile::AppendVector(const std::vector<Slice>& data_vector) {
+  size_t total_size = 0;
+  for (const auto& data : data_vector) {
+    total_size += data.size();
+  }
+  auto buffer = std::make_shared<std::string>();
+  buffer->reserve(total_size);
+  for (const auto& data : data_vector) {
+    buffer->append(data.cdata(), data.size());
+  }
+  size_.fetch_add(total_size, std::memory_order_acq_rel);
+  queue_.Submit([this, buffer] { return target_->Append(*buffer); });
+  return queue_.status();
+}
+
+Status AsyncWritableFile::Close() {
+  RETURN_NOT_OK(queue_.Wait());
+  return target_->Close();
+}
+
+Status AsyncWritableFile::Flush(FlushMode mode) {
+  RETURN_NOT_OK(queue_.Wait());
+  return target_->Flush(mode);
+}
+
+Status AsyncWritableFile::Sync() {
+  RETURN_NOT_OK(queue_.Wait());
+  return target_->Sync();
+}
+
+void AsyncWritableFile::SyncAsync(StdStatusCallback callback) {
+  queue_.Submit([this] { return target_->Sync(); }, std::move(callback));
+}
+
+void AsyncWritableFile::SubmitAsync(
+    std::function<Status(WritableFile*)> op, StdStatusCallback callback) {
+  queue_.Submit([this, op = std::move(op)] { return op(target_.get()); }, std::move(callback));
+}
+
+} // namespace yb
@@ -0,0 +1,118 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ASYNC_IO_H
+#define YB_UTIL_ASYNC_IO_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "yb/util/env.h"
+#include "yb/util/status.h"
+#include "yb/util/status_callback.h"
+
+namespace yb {
+
+class ThreadPool;
+class ThreadPoolToken;
+
+// Returns the process-wide thread pool that performs asynchronous file I/O. Its size is limited by
+// FLAGS_async_io_threads, so a few threads drive the I/O of all the files written through it.
+ThreadPool* AsyncIoThreadPool();
+
+// Serial queue of I/O operations on a single file, executed by a thread pool in submission order.
+//
+// After an operation fails, the following ones are not executed, and their callbacks receive the
+// status of the failed operation. All functions are thread-safe.
+class AsyncIoQueue {
+ public:
+  explicit AsyncIoQueue(ThreadPool* pool = AsyncIoThreadPool());
+
+  // Waits for the submitted operations.
+  ~AsyncIoQueue();
+
+  AsyncIoQueue(const AsyncIoQueue&) = delete;
+  void operator=(const AsyncIoQueue&) = delete;
+
+  // Submits op to be executed after the previously submitted operations. The callback, if any, is
+  // invoked with the result on the thread that executed op.
+  void Submit(std::function<Status()> op, StdStatusCallback callback = StdStatusCallback());
+
+  // Waits until all the submitted operations and their callbacks are done. Returns the status of
+  // the first failed operation, if any. Should not be called from a callback of this queue.
+  CHECKED_STATUS Wait();
+
+  // Returns the status of the first failed operation, without waiting.
+  Status status() const;
+
+ private:
+  void Execute(const std::function<Status()>& op, const StdStatusCallback& callback);
+  void SetFailed(const Status& status);
+
+  std::unique_ptr<ThreadPoolToken> token_;
+  std::atomic<bool> failed_{false};
+  mutable std::mutex mutex_;
+  Status status_;
+};
+
+// Writable file that performs its I/O on AsyncIoThreadPool, so callers do not block on it.
+//
+// Append, AppendVector and PreAllocate copy the data and queue the operation, so they return
+// immediately, and report failures of previously queued operations. Flush, Sync and Close wait for
+// the queued operations, like a buffered file does. SyncAsync and SubmitAsync do not wait, and
+// invoke their callbacks once the operation is done.
+class AsyncWritableFile : public WritableFile {
+ public:
+  explicit AsyncWritableFile(
+      std::shared_ptr<WritableFile> target, ThreadPool* pool = AsyncIoThreadPool());
+
+  ~AsyncWritableFile();
+
+  CHECKED_STATUS PreAllocate(uint64_t size) override;
+  CHECKED_STATUS Append(const Slice& data) override;
+  CHECKED_STATUS AppendVector(const std::vector<Slice>& data_vector) override;
+  CHECKED_STATUS Close() override;
+  CHECKED_STATUS Flush(FlushMode mode) override;
+  CHECKED_STATUS Sync() override;
+
+  // Size of the file including the queued appends.
+  uint64_t Size() const override {
+    return size_.load(std::memory_order_acquire);
+  }
+
+  const std::string& filename() const override {
+    return target_->filename();
+  }
+
+  // Queues a sync of the data appended so far.
+  void SyncAsync(StdStatusCallback callback);
+
+  // Queues op, that is invoked with the underlying file after the previously queued operations.
+  void SubmitAsync(std::function<Status(WritableFile*)> op, StdStatusCallback callback);
+
+  // Waits for the queued operations, see AsyncIoQueue::Wait.
+  CHECKED_STATUS Wait() {
+    return queue_.Wait();
+  }
+
+ private:
+  std::shared_ptr<WritableFile> target_;
+  std::atomic<uint64_t> size_;
+  AsyncIoQueue queue_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_ASYNC_IO_H
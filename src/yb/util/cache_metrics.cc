@@ -71,6 +71,29 @@ METRIC_DEFINE_gauge_uint64(server, block_cache_multi_touch_usage,
                            "Multi Cache Block Cache Memory Usage",
                            yb::MetricUnit::kBytes,
                            "Memory consumed by the multi cache block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_inserts,
+                      "Persistent Block Cache Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks written to the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_insert_failures,
+                      "Persistent Block Cache Insert Failures", yb::MetricUnit::kBlocks,
+                      "Number of blocks that could not be written to the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_dropped_inserts,
+                      "Persistent Block Cache Dropped Inserts", yb::MetricUnit::kBlocks,
+                      "Number of blocks dropped because too many blocks were waiting to be "
+                      "written to the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_hits,
+                      "Persistent Block Cache Hits", yb::MetricUnit::kBlocks,
+                      "Number of lookups that found a block in the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_misses,
+                      "Persistent Block Cache Misses", yb::MetricUnit::kBlocks,
+                      "Number of lookups that didn't find a block in the persistent block cache");
+METRIC_DEFINE_counter(server, persistent_block_cache_evictions,
+                      "Persistent Block Cache Evictions", yb::MetricUnit::kBlocks,
+                      "Number of blocks dropped from the persistent block cache");
+METRIC_DEFINE_gauge_uint64(server, persistent_block_cache_usage,
+                           "Persistent Block Cache Disk Usage", yb::MetricUnit::kBytes,
+                           "Disk space consumed by the persistent block cache");
+
 namespace yb {
 
 #define MINIT(member, x) member(METRIC_##x.Instantiate(entity))
@@ -87,6 +110,17 @@ CacheMetrics::CacheMetrics(const scoped_refptr<MetricEntity>& entity)
     GINIT(single_touch_cache_usage, block_cache_single_touch_usage),
     GINIT(multi_touch_cache_usage, block_cache_multi_touch_usage) {
 }
+
+PersistentBlockCacheMetrics::PersistentBlockCacheMetrics(
+    const scoped_refptr<MetricEntity>& entity)
+  : MINIT(inserts, persistent_block_cache_inserts),
+    MINIT(insert_failures, persistent_block_cache_insert_failures),
+    MINIT(dropped_inserts, persistent_block_cache_dropped_inserts),
+    MINIT(cache_hits, persistent_block_cache_hits),
+    MINIT(cache_misses, persistent_block_cache_misses),
+    MINIT(evictions, persistent_block_cache_evictions),
+    GINIT(cache_usage, persistent_block_cache_usage) {
+}
 #undef MINIT
 #undef GINIT
 
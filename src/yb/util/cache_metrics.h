@@ -60,5 +60,19 @@ struct CacheMetrics {
   scoped_refptr<AtomicGauge<uint64_t> > multi_touch_cache_usage;
 };
 
+// Metrics of the second-tier block cache kept in a local file (rocksdb::PersistentBlockCache).
+struct PersistentBlockCacheMetrics {
+  explicit PersistentBlockCacheMetrics(const scoped_refptr<MetricEntity>& metric_entity);
+
+  scoped_refptr<Counter> inserts;
+  scoped_refptr<Counter> insert_failures;
+  scoped_refptr<Counter> dropped_inserts;
+  scoped_refptr<Counter> cache_hits;
+  scoped_refptr<Counter> cache_misses;
+  scoped_refptr<Counter> evictions;
+
+  scoped_refptr<AtomicGauge<uint64_t> > cache_usage;
+};
+
 } // namespace yb
 #endif /* YB_UTIL_CACHE_METRICS_H */
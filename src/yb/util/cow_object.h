@@ -33,6 +33,7 @@
 #define YB_UTIL_COW_OBJECT_H
 
 #include <algorithm>
+#include <atomic>
 
 #include <glog/logging.h>
 
@@ -94,9 +95,16 @@ class CowObject {
     CHECK(dirty_state_);
     std::swap(state_, *dirty_state_);
     dirty_state_.reset();
+    version_.fetch_add(1, std::memory_order_acq_rel);
     lock_.CommitUnlock();
   }
 
+  // Number of committed mutations. Could be read without lock, to find out whether the state
+  // changed since it was read.
+  uint64_t version() const {
+    return version_.load(std::memory_order_acquire);
+  }
+
   // Return the current state, not reflecting any in-progress mutations.
   State& state() {
     DCHECK(lock_.HasReaders() || lock_.HasWriteLock());
@@ -124,6 +132,7 @@ class CowObject {
 
   State state_;
   gscoped_ptr<State> dirty_state_;
+  std::atomic<uint64_t> version_{0};
 
   DISALLOW_COPY_AND_ASSIGN(CowObject);
 };
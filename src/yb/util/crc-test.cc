@@ -33,6 +33,8 @@
 #include "yb/gutil/gscoped_ptr.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/crc.h"
+#include "yb/util/random.h"
+#include "yb/util/size_literals.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/test_util.h"
 
@@ -71,6 +73,34 @@ TEST_F(CrcTest, TestCRC32C) {
   output = FastHex32ToBuffer(static_cast<uint32_t>(data_crc), buf);
   LOG(INFO) << "CRC32C of " << test_data << " is: 0x" << output << " (truncated 32 bits)";
   ASSERT_EQ(0xa9421b7, data_crc); // Known value from crcutil usage test program.
+  ASSERT_EQ(0xa9421b7, Crc32c(test_data.data(), test_data.length()));
+  ASSERT_EQ(0xe3069283, Crc32c("123456789", 9));
+}
+
+// Crc32cExtend should match crcutil for any length, alignment and initial CRC, in particular for
+// the lengths where the interleaved computation of blocks starts.
+TEST_F(CrcTest, TestCrc32cExtend) {
+  LOG(INFO) << "Hardware CRC32C: " << IsHardwareCrc32cSupported();
+  std::vector<uint8_t> data(100000);
+  Random rng(SeedRandom());
+  for (auto& byte : data) {
+    byte = rng.Next();
+  }
+  Crc* crc32c = GetCrc32cInstance();
+  std::vector<size_t> lengths = { 0, 1, 7, 8, 9, 255, 256, 767, 768, 769, 8191, 24575, 24576,
+                                  24577, 24576 + 768, 99000 };
+  for (int i = 0; i != 100; ++i) {
+    lengths.push_back(rng.Uniform(99000));
+  }
+  for (auto length : lengths) {
+    for (size_t offset = 0; offset != 9; ++offset) {
+      uint32_t init = rng.Next();
+      uint64_t expected = init;
+      crc32c->Compute(data.data() + offset, length, &expected);
+      ASSERT_EQ(expected, Crc32cExtend(init, data.data() + offset, length))
+          << "length: " << length << ", offset: " << offset;
+    }
+  }
 }
 
 // Simple benchmark of CRC32C throughput.
@@ -86,20 +116,39 @@ TEST_F(CrcTest, BenchmarkCRC32C) {
   if (AllowSlowTests()) {
     kNumRuns = 40000;
   }
-  const uint64_t kNumBytes = kNumRuns * buflen;
-  Stopwatch sw;
-  sw.start();
-  for (int i = 0; i < kNumRuns; i++) {
-    uint64_t cksum;
-    crc32c->Compute(buf, buflen, &cksum);
+  auto log_result = [&](const char* name, size_t length, int num_runs, const CpuTimes& elapsed) {
+    const uint64_t num_bytes = num_runs * length;
+    LOG(INFO) << Substitute("$0: $1 runs of CRC32C on $2 bytes of data (total: $3 bytes)"
+                            " in $4 seconds; $5 bytes per millisecond, $6 bytes per nanosecond!",
+                            name, num_runs, length, num_bytes, elapsed.wall_seconds(),
+                            (num_bytes / std::max<int64_t>(elapsed.wall_millis(), 1)),
+                            (num_bytes / std::max<int64_t>(elapsed.wall, 1)));
+  };
+
+  // Besides the whole buffer, also measure sizes typical for WAL entries and SST blocks.
+  const size_t kLengths[] = { buflen, 32_KB, 4_KB, 256 };
+  for (size_t length : kLengths) {
+    const int num_runs = kNumRuns * (buflen / length);
+    uint32_t cksum = 0;
+    Stopwatch sw;
+    sw.start();
+    for (int i = 0; i < num_runs; i++) {
+      uint64_t crcutil_cksum = 0;
+      crc32c->Compute(buf, length, &crcutil_cksum);
+      cksum ^= crcutil_cksum;
+    }
+    sw.stop();
+    log_result("crcutil", length, num_runs, sw.elapsed());
+
+    sw.start();
+    for (int i = 0; i < num_runs; i++) {
+      cksum ^= Crc32c(buf, length);
+    }
+    sw.stop();
+    log_result("Crc32c", length, num_runs, sw.elapsed());
+    // Both computed the same value the same number of times.
+    ASSERT_EQ(0, cksum);
   }
-  sw.stop();
-  CpuTimes elapsed = sw.elapsed();
-  LOG(INFO) << Substitute("$0 runs of CRC32C on $1 bytes of data (total: $2 bytes)"
-                          " in $3 seconds; $4 bytes per millisecond, $5 bytes per nanosecond!",
-                          kNumRuns, buflen, kNumBytes, elapsed.wall_seconds(),
-                          (kNumBytes / elapsed.wall_millis()),
-                          (kNumBytes / elapsed.wall));
 }
 
 } // namespace crc
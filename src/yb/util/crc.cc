@@ -31,6 +31,16 @@
 //
 #include "yb/util/crc.h"
 
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__SSE4_2__)
+#include <nmmintrin.h>
+#define YB_HAVE_HARDWARE_CRC32C 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define YB_HAVE_HARDWARE_CRC32C 1
+#endif
+
 #include <crcutil/interface.h>
 
 #include "yb/gutil/once.h"
@@ -55,11 +65,206 @@ Crc* GetCrc32cInstance() {
   return crc32c_instance;
 }
 
-uint32_t Crc32c(const void* data, size_t length) {
-  uint64_t crc32 = 0;
+namespace {
+
+uint32_t SoftwareCrc32cExtend(uint32_t init_crc, const void* data, size_t length) {
+  crcutil_interface::UINT64 crc32 = init_crc;
   GetCrc32cInstance()->Compute(data, length, &crc32);
   return static_cast<uint32_t>(crc32); // Only uses lower 32 bits.
 }
 
+#ifdef YB_HAVE_HARDWARE_CRC32C
+
+#if defined(__x86_64__)
+inline uint64_t CrcByte(uint64_t crc, uint8_t value) { return _mm_crc32_u8(crc, value); }
+inline uint64_t CrcWord(uint64_t crc, uint64_t value) { return _mm_crc32_u64(crc, value); }
+#else
+inline uint64_t CrcByte(uint64_t crc, uint8_t value) { return __crc32cb(crc, value); }
+inline uint64_t CrcWord(uint64_t crc, uint64_t value) { return __crc32cd(crc, value); }
+#endif
+
+inline uint64_t LoadWord(const uint8_t* p) {
+  uint64_t result;
+  memcpy(&result, p, sizeof(result));
+  return result;
+}
+
+// The CRC32 instruction has a latency of 3 cycles, but could start every cycle. So large buffers
+// are split into 3 blocks, whose CRCs are computed at the same time and then combined. Combining
+// the CRC of A with the CRC of B is shifting the CRC of A by the length of B, i.e. appending
+// that many zero bytes to it, and xoring the CRC of B. Shifting by the fixed block lengths is done
+// with the tables below.
+constexpr size_t kLongBlock = 8192;
+constexpr size_t kShortBlock = 256;
+
+// Reflected CRC32C (Castagnoli) polynomial.
+constexpr uint32_t kCrc32cPolynomial = 0x82f63b78;
+
+// Multiplies the 32x32 matrix over GF(2) by the vector.
+uint32_t Gf2MatrixTimes(const uint32_t* matrix, uint32_t vector) {
+  uint32_t sum = 0;
+  while (vector) {
+    if (vector & 1) {
+      sum ^= *matrix;
+    }
+    vector >>= 1;
+    ++matrix;
+  }
+  return sum;
+}
+
+void Gf2MatrixSquare(uint32_t* square, const uint32_t* matrix) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = Gf2MatrixTimes(matrix, matrix[n]);
+  }
+}
+
+// Tables to shift a CRC by a fixed number of zero bytes, one per byte of the CRC.
+class Crc32cShift {
+ public:
+  // length must be a power of 2.
+  explicit Crc32cShift(size_t length) {
+    uint32_t even[32];
+    uint32_t odd[32];
+    // Operator for one zero bit.
+    odd[0] = kCrc32cPolynomial;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n) {
+      odd[n] = row;
+      row <<= 1;
+    }
+    // Operators for two and four zero bits.
+    Gf2MatrixSquare(even, odd);
+    Gf2MatrixSquare(odd, even);
+    // Each square doubles the number of zero bits, the first one gives the operator for one zero
+    // byte.
+    uint32_t* result = even;
+    for (;;) {
+      Gf2MatrixSquare(even, odd);
+      length >>= 1;
+      if (length == 0) {
+        result = even;
+        break;
+      }
+      Gf2MatrixSquare(odd, even);
+      length >>= 1;
+      if (length == 0) {
+        result = odd;
+        break;
+      }
+    }
+    for (uint32_t n = 0; n < 256; ++n) {
+      tables_[0][n] = Gf2MatrixTimes(result, n);
+      tables_[1][n] = Gf2MatrixTimes(result, n << 8);
+      tables_[2][n] = Gf2MatrixTimes(result, n << 16);
+      tables_[3][n] = Gf2MatrixTimes(result, n << 24);
+    }
+  }
+
+  uint32_t Apply(uint32_t crc) const {
+    return tables_[0][crc & 0xff] ^ tables_[1][(crc >> 8) & 0xff] ^
+           tables_[2][(crc >> 16) & 0xff] ^ tables_[3][crc >> 24];
+  }
+
+ private:
+  uint32_t tables_[4][256];
+};
+
+// Tables are initialized on first use, so CRCs could be computed during static initialization.
+const Crc32cShift& LongShift() {
+  static const Crc32cShift result(kLongBlock);
+  return result;
+}
+
+const Crc32cShift& ShortShift() {
+  static const Crc32cShift result(kShortBlock);
+  return result;
+}
+
+// Computes CRCs of 3 consecutive blocks of block_length bytes at the same time, and combines them.
+inline uint64_t ExtendInterleaved(
+    uint64_t crc0, size_t block_length, const Crc32cShift& shift, const uint8_t** next,
+    size_t* length) {
+  const uint8_t* p = *next;
+  while (*length >= block_length * 3) {
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const uint8_t* end = p + block_length;
+    do {
+      crc0 = CrcWord(crc0, LoadWord(p));
+      crc1 = CrcWord(crc1, LoadWord(p + block_length));
+      crc2 = CrcWord(crc2, LoadWord(p + block_length * 2));
+      p += 8;
+    } while (p < end);
+    crc0 = shift.Apply(static_cast<uint32_t>(crc0)) ^ crc1;
+    crc0 = shift.Apply(static_cast<uint32_t>(crc0)) ^ crc2;
+    p += block_length * 2;
+    *length -= block_length * 3;
+  }
+  *next = p;
+  return crc0;
+}
+
+uint32_t HardwareCrc32cExtend(uint32_t init_crc, const void* data, size_t length) {
+  const uint8_t* next = static_cast<const uint8_t*>(data);
+  uint64_t crc = init_crc ^ 0xffffffffu;
+
+  while (length && (reinterpret_cast<uintptr_t>(next) & 7) != 0) {
+    crc = CrcByte(crc, *next++);
+    --length;
+  }
+  if (length >= kLongBlock * 3) {
+    crc = ExtendInterleaved(crc, kLongBlock, LongShift(), &next, &length);
+  }
+  if (length >= kShortBlock * 3) {
+    crc = ExtendInterleaved(crc, kShortBlock, ShortShift(), &next, &length);
+  }
+  const uint8_t* end = next + (length & ~static_cast<size_t>(7));
+  while (next < end) {
+    crc = CrcWord(crc, LoadWord(next));
+    next += 8;
+  }
+  length &= 7;
+  while (length) {
+    crc = CrcByte(crc, *next++);
+    --length;
+  }
+  return static_cast<uint32_t>(crc) ^ 0xffffffffu;
+}
+
+bool DetectHardwareCrc32c() {
+#if defined(__x86_64__)
+  return __builtin_cpu_supports("sse4.2");
+#else
+  // __ARM_FEATURE_CRC32 means the target of the build always has the CRC32 instructions.
+  return true;
+#endif
+}
+
+#else
+
+bool DetectHardwareCrc32c() {
+  return false;
+}
+
+uint32_t HardwareCrc32cExtend(uint32_t init_crc, const void* data, size_t length) {
+  return SoftwareCrc32cExtend(init_crc, data, length);
+}
+
+#endif // YB_HAVE_HARDWARE_CRC32C
+
+const bool kHardwareCrc32c = DetectHardwareCrc32c();
+
+} // namespace
+
+uint32_t Crc32cExtend(uint32_t init_crc, const void* data, size_t length) {
+  return kHardwareCrc32c ? HardwareCrc32cExtend(init_crc, data, length)
+                         : SoftwareCrc32cExtend(init_crc, data, length);
+}
+
+bool IsHardwareCrc32cSupported() {
+  return kHardwareCrc32c;
+}
+
 } // namespace crc
 } // namespace yb
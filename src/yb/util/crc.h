@@ -42,11 +42,20 @@ namespace crc {
 
 typedef crcutil_interface::CRC Crc;
 
-// Returns pointer to singleton instance of CRC32C implementation.
+// Returns pointer to singleton instance of the crcutil CRC32C implementation.
+// Prefer Crc32c/Crc32cExtend, that use the CRC32 instructions of the CPU when available.
 Crc* GetCrc32cInstance();
 
+// Returns the CRC32C of concat(A, data), where init_crc is the CRC32C of A.
+uint32_t Crc32cExtend(uint32_t init_crc, const void* data, size_t length);
+
 // Helper function to simply calculate a CRC32C of the given data.
-uint32_t Crc32c(const void* data, size_t length);
+inline uint32_t Crc32c(const void* data, size_t length) {
+  return Crc32cExtend(0, data, length);
+}
+
+// Whether Crc32cExtend uses SSE4.2 or ARMv8 CRC32 instructions.
+bool IsHardwareCrc32cSupported();
 
 } // namespace crc
 } // namespace yb
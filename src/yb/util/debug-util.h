@@ -176,6 +176,15 @@ class StackTrace {
     return as_slice().compare(rhs.as_slice());
   }
 
+  int num_frames() const {
+    return num_frames_;
+  }
+
+  // Collected return addresses, the innermost frame first.
+  void* const* frames() const {
+    return frames_;
+  }
+
   Slice as_slice() const {
     return Slice(pointer_cast<const char*>(frames_),
                  pointer_cast<const char*>(frames_ + num_frames_));
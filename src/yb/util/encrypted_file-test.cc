@@ -0,0 +1,224 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/encrypted_file.h"
+#include "yb/util/faststring.h"
+#include "yb/util/random_util.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/universe_key_manager.h"
+
+using namespace yb::size_literals;
+
+DECLARE_int32(universe_key_wait_timeout_ms);
+
+namespace yb {
+
+class EncryptedFileTest : public YBTest {
+ protected:
+  void SetUp() override {
+    YBTest::SetUp();
+    encrypted_env_ = NewEncryptedEnv(&universe_key_manager_);
+  }
+
+  // Adds a new universe key version and makes it the latest one.
+  void RotateUniverseKey(const std::string& version_id) {
+    auto key = ASSERT_RESULT(EncryptionParams::NewRandom());
+    registry_.set_encryption_enabled(true);
+    key->ToPB(&(*registry_.mutable_universe_keys())[version_id]);
+    registry_.set_latest_version_id(version_id);
+    universe_key_manager_.SetUniverseKeyRegistry(registry_);
+  }
+
+  void WriteFile(Env* env, const std::string& path, const std::string& data) {
+    gscoped_ptr<WritableFile> file;
+    ASSERT_OK(env->NewWritableFile(path, &file));
+    // Mix of single and vector appends.
+    size_t pos = 0;
+    while (pos < data.size()) {
+      size_t len = std::min(RandomUniformInt<size_t>(1, 10_KB), data.size() - pos);
+      if (RandomActWithProbability(0.5)) {
+        ASSERT_OK(file->Append(Slice(data.data() + pos, len)));
+      } else {
+        size_t half = len / 2;
+        ASSERT_OK(file->AppendVector({Slice(data.data() + pos, half),
+                                      Slice(data.data() + pos + half, len - half)}));
+      }
+      pos += len;
+    }
+    ASSERT_EQ(data.size(), file->Size());
+    ASSERT_OK(file->Close());
+  }
+
+  void CheckRandomReads(Env* env, const std::string& path, const std::string& data) {
+    gscoped_ptr<RandomAccessFile> file;
+    ASSERT_OK(env->NewRandomAccessFile(path, &file));
+    ASSERT_EQ(data.size(), ASSERT_RESULT(file->Size()));
+    std::string scratch;
+    for (int i = 0; i != 1000; ++i) {
+      size_t offset = RandomUniformInt<size_t>(0, data.size() - 1);
+      size_t len = RandomUniformInt<size_t>(1, data.size() - offset);
+      scratch.resize(len);
+      Slice result;
+      ASSERT_OK(file->Read(offset, len, &result, util::to_uchar_ptr(&scratch[0])));
+      ASSERT_EQ(Slice(data.data() + offset, len).ToDebugHexString(), result.ToDebugHexString());
+    }
+  }
+
+  std::string ReadRawFile(const std::string& path) {
+    faststring raw;
+    EXPECT_OK(ReadFileToString(env_.get(), path, &raw));
+    return raw.ToString();
+  }
+
+  UniverseKeyManager universe_key_manager_;
+  UniverseKeyRegistryPB registry_;
+  std::unique_ptr<Env> encrypted_env_;
+};
+
+TEST_F(EncryptedFileTest, CipherStream) {
+  auto stream = ASSERT_RESULT(BlockAccessCipherStream::FromParams(
+      ASSERT_RESULT(EncryptionParams::NewRandom())));
+  const auto plaintext = RandomHumanReadableString(64_KB);
+  std::string encrypted(plaintext.size(), 0);
+  ASSERT_OK(stream->Encrypt(0, plaintext.data(), &encrypted[0], plaintext.size()));
+  ASSERT_NE(plaintext, encrypted);
+
+  // Any part could be decrypted independently, including unaligned ones.
+  for (int i = 0; i != 1000; ++i) {
+    size_t offset = RandomUniformInt<size_t>(0, plaintext.size() - 1);
+    size_t len = RandomUniformInt<size_t>(1, plaintext.size() - offset);
+    std::string decrypted(encrypted, offset, len);
+    ASSERT_OK(stream->Decrypt(offset, decrypted.data(), &decrypted[0], len));
+    ASSERT_EQ(plaintext.substr(offset, len), decrypted) << "offset: " << offset;
+  }
+}
+
+TEST_F(EncryptedFileTest, ReadWrite) {
+  RotateUniverseKey("v1");
+  const auto path = GetTestPath("file");
+  const auto data = RandomHumanReadableString(1_MB + 123);
+  WriteFile(encrypted_env_.get(), path, data);
+
+  auto raw = ReadRawFile(path);
+  ASSERT_EQ(data.size() + kEncryptionHeaderSize, raw.size());
+  ASSERT_EQ(std::string::npos, raw.find(data.substr(0, 32)));
+  ASSERT_EQ(data.size(), ASSERT_RESULT(encrypted_env_->GetFileSize(path)));
+
+  CheckRandomReads(encrypted_env_.get(), path, data);
+
+  gscoped_ptr<RandomAccessFile> random_file;
+  ASSERT_OK(encrypted_env_->NewRandomAccessFile(path, &random_file));
+  ASSERT_TRUE(random_file->IsEncrypted());
+  ASSERT_EQ(kEncryptionHeaderSize, random_file->GetHeaderSize());
+
+  gscoped_ptr<SequentialFile> file;
+  ASSERT_OK(encrypted_env_->NewSequentialFile(path, &file));
+  constexpr size_t kSkip = 1000;
+  ASSERT_OK(file->Skip(kSkip));
+  std::string scratch(data.size(), 0);
+  Slice result;
+  ASSERT_OK(file->Read(data.size(), &result, util::to_uchar_ptr(&scratch[0])));
+  ASSERT_EQ(data.substr(kSkip), result.ToBuffer());
+
+  faststring content;
+  ASSERT_OK(ReadFileToString(encrypted_env_.get(), path, &content));
+  ASSERT_EQ(data, content.ToString());
+}
+
+TEST_F(EncryptedFileTest, Plaintext) {
+  const auto plaintext_path = GetTestPath("plaintext");
+  const auto data = RandomHumanReadableString(100_KB);
+  WriteFile(env_.get(), plaintext_path, data);
+
+  // Files are written as plaintext before the registry is received and while encryption is
+  // disabled.
+  const auto before_registry_path = GetTestPath("before_registry");
+  WriteFile(encrypted_env_.get(), before_registry_path, data);
+  ASSERT_EQ(data, ReadRawFile(before_registry_path));
+
+  universe_key_manager_.SetUniverseKeyRegistry(registry_);
+  const auto disabled_path = GetTestPath("disabled");
+  WriteFile(encrypted_env_.get(), disabled_path, data);
+  ASSERT_EQ(data, ReadRawFile(disabled_path));
+
+  RotateUniverseKey("v1");
+  for (const auto& path : {plaintext_path, before_registry_path, disabled_path}) {
+    CheckRandomReads(encrypted_env_.get(), path, data);
+    ASSERT_EQ(data.size(), ASSERT_RESULT(encrypted_env_->GetFileSize(path)));
+  }
+}
+
+TEST_F(EncryptedFileTest, KeyRotation) {
+  RotateUniverseKey("v1");
+  const auto old_path = GetTestPath("old");
+  const auto old_data = RandomHumanReadableString(100_KB);
+  WriteFile(encrypted_env_.get(), old_path, old_data);
+
+  RotateUniverseKey("v2");
+  const auto new_path = GetTestPath("new");
+  const auto new_data = RandomHumanReadableString(100_KB);
+  WriteFile(encrypted_env_.get(), new_path, new_data);
+  CheckRandomReads(encrypted_env_.get(), old_path, old_data);
+  CheckRandomReads(encrypted_env_.get(), new_path, new_data);
+
+  // After the old file is rewritten with the new key, the old key is not needed anymore.
+  const auto rewritten_path = GetTestPath("rewritten");
+  WriteFile(encrypted_env_.get(), rewritten_path, old_data);
+  registry_.mutable_universe_keys()->erase("v1");
+  universe_key_manager_.SetUniverseKeyRegistry(registry_);
+  CheckRandomReads(encrypted_env_.get(), rewritten_path, old_data);
+  CheckRandomReads(encrypted_env_.get(), new_path, new_data);
+
+  FLAGS_universe_key_wait_timeout_ms = 100;
+  gscoped_ptr<RandomAccessFile> file;
+  auto status = encrypted_env_->NewRandomAccessFile(old_path, &file);
+  ASSERT_TRUE(status.IsTimedOut()) << status;
+}
+
+// Compares the throughput of appends of the typical WAL entry batch size with and without
+// encryption.
+TEST_F(EncryptedFileTest, BenchmarkWalAppend) {
+  RotateUniverseKey("v1");
+  const size_t kTotalSize = AllowSlowTests() ? 1_GB : 64_MB;
+  const auto data = RandomHumanReadableString(4_KB);
+
+  auto append = [this, kTotalSize, &data](Env* env, const std::string& name) {
+    gscoped_ptr<WritableFile> file;
+    auto path = GetTestPath(name);
+    CHECK_OK(env->NewWritableFile(path, &file));
+    auto start = MonoTime::Now();
+    for (size_t size = 0; size < kTotalSize; size += data.size()) {
+      CHECK_OK(file->Append(data));
+    }
+    CHECK_OK(file->Sync());
+    auto elapsed = MonoTime::Now() - start;
+    CHECK_OK(file->Close());
+    CHECK_OK(env_->DeleteFile(path));
+    LOG(INFO) << name << ": " << kTotalSize / 1_MB << " MB in " << elapsed << ", "
+              << kTotalSize / 1_MB / elapsed.ToSeconds() << " MB/s";
+    return elapsed;
+  };
+
+  auto plaintext_time = append(env_.get(), "plaintext");
+  auto encrypted_time = append(encrypted_env_.get(), "encrypted");
+  LOG(INFO) << "Encryption overhead: "
+            << (encrypted_time.ToSeconds() / plaintext_time.ToSeconds() - 1) * 100 << "%";
+}
+
+} // namespace yb
@@ -0,0 +1,207 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/encrypted_file.h"
+
+#include "yb/util/universe_key_manager.h"
+
+namespace yb {
+
+namespace {
+
+class EncryptedSequentialFile : public SequentialFileWrapper {
+ public:
+  EncryptedSequentialFile(gscoped_ptr<SequentialFile> file, BlockAccessCipherStreamPtr stream)
+      : SequentialFileWrapper(std::move(file)), stream_(std::move(stream)) {}
+
+  CHECKED_STATUS Read(size_t n, Slice* result, uint8_t* scratch) override {
+    RETURN_NOT_OK(SequentialFileWrapper::Read(n, result, scratch));
+    RETURN_NOT_OK(stream_->Decrypt(offset_, result->data(), scratch, result->size()));
+    *result = Slice(scratch, result->size());
+    offset_ += result->size();
+    return Status::OK();
+  }
+
+  CHECKED_STATUS Skip(uint64_t n) override {
+    RETURN_NOT_OK(SequentialFileWrapper::Skip(n));
+    offset_ += n;
+    return Status::OK();
+  }
+
+ private:
+  BlockAccessCipherStreamPtr stream_;
+  uint64_t offset_ = 0;
+};
+
+class EncryptedRandomAccessFile : public RandomAccessFileWrapper {
+ public:
+  EncryptedRandomAccessFile(gscoped_ptr<RandomAccessFile> file, BlockAccessCipherStreamPtr stream)
+      : RandomAccessFileWrapper(std::move(file)), stream_(std::move(stream)) {}
+
+  CHECKED_STATUS Read(uint64_t offset, size_t n, Slice* result, uint8_t* scratch) const override {
+    RETURN_NOT_OK(RandomAccessFileWrapper::Read(
+        offset + kEncryptionHeaderSize, n, result, scratch));
+    RETURN_NOT_OK(stream_->Decrypt(offset, result->data(), scratch, result->size()));
+    *result = Slice(scratch, result->size());
+    return Status::OK();
+  }
+
+  Result<uint64_t> Size() const override {
+    return VERIFY_RESULT(RandomAccessFileWrapper::Size()) - kEncryptionHeaderSize;
+  }
+
+  uint64_t GetHeaderSize() const override {
+    return kEncryptionHeaderSize;
+  }
+
+  bool IsEncrypted() const override {
+    return true;
+  }
+
+ private:
+  BlockAccessCipherStreamPtr stream_;
+};
+
+class EncryptedWritableFile : public WritableFileWrapper {
+ public:
+  EncryptedWritableFile(gscoped_ptr<WritableFile> file, BlockAccessCipherStreamPtr stream)
+      : WritableFileWrapper(std::move(file)), stream_(std::move(stream)) {}
+
+  CHECKED_STATUS Append(const Slice& data) override {
+    buffer_.resize(data.size());
+    RETURN_NOT_OK(stream_->Encrypt(offset_, data.data(), &buffer_[0], data.size()));
+    RETURN_NOT_OK(WritableFileWrapper::Append(buffer_));
+    offset_ += data.size();
+    return Status::OK();
+  }
+
+  // All slices are encrypted into one buffer, so the underlying file gets a single large write.
+  CHECKED_STATUS AppendVector(const std::vector<Slice>& data_vector) override {
+    size_t total_size = 0;
+    for (const auto& data : data_vector) {
+      total_size += data.size();
+    }
+    buffer_.resize(total_size);
+    size_t pos = 0;
+    for (const auto& data : data_vector) {
+      RETURN_NOT_OK(stream_->Encrypt(offset_ + pos, data.data(), &buffer_[pos], data.size()));
+      pos += data.size();
+    }
+    RETURN_NOT_OK(WritableFileWrapper::Append(buffer_));
+    offset_ += total_size;
+    return Status::OK();
+  }
+
+  uint64_t Size() const override {
+    return WritableFileWrapper::Size() - kEncryptionHeaderSize;
+  }
+
+ private:
+  BlockAccessCipherStreamPtr stream_;
+  // Plaintext offset of the next append.
+  uint64_t offset_ = 0;
+  std::string buffer_;
+};
+
+} // namespace
+
+Result<BlockAccessCipherStreamPtr> EncryptedFileFactory::ReadHeader(const RandomAccessFile& file) {
+  uint8_t header[kEncryptionHeaderSize];
+  Slice header_slice;
+  RETURN_NOT_OK(file.Read(0, kEncryptionHeaderSize, &header_slice, header));
+  return CipherStreamFromHeader(header_slice, universe_key_manager_);
+}
+
+Status EncryptedFileFactory::NewSequentialFile(
+    const std::string& fname, gscoped_ptr<SequentialFile>* result) {
+  // Sequential file could not return to the beginning, so the header is read separately.
+  gscoped_ptr<RandomAccessFile> header_file;
+  RETURN_NOT_OK(FileFactoryWrapper::NewRandomAccessFile(fname, &header_file));
+  auto stream = VERIFY_RESULT(ReadHeader(*header_file));
+  RETURN_NOT_OK(FileFactoryWrapper::NewSequentialFile(fname, result));
+  if (stream) {
+    RETURN_NOT_OK((*result)->Skip(kEncryptionHeaderSize));
+    result->reset(new EncryptedSequentialFile(std::move(*result), std::move(stream)));
+  }
+  return Status::OK();
+}
+
+Status EncryptedFileFactory::NewRandomAccessFile(
+    const std::string& fname, gscoped_ptr<RandomAccessFile>* result) {
+  return NewRandomAccessFile(RandomAccessFileOptions(), fname, result);
+}
+
+Status EncryptedFileFactory::NewRandomAccessFile(
+    const RandomAccessFileOptions& opts, const std::string& fname,
+    gscoped_ptr<RandomAccessFile>* result) {
+  RETURN_NOT_OK(FileFactoryWrapper::NewRandomAccessFile(opts, fname, result));
+  auto stream = VERIFY_RESULT(ReadHeader(**result));
+  if (stream) {
+    result->reset(new EncryptedRandomAccessFile(std::move(*result), std::move(stream)));
+  }
+  return Status::OK();
+}
+
+Status EncryptedFileFactory::NewWritableFile(
+    const std::string& fname, gscoped_ptr<WritableFile>* result) {
+  return NewWritableFile(WritableFileOptions(), fname, result);
+}
+
+Status EncryptedFileFactory::NewWritableFile(
+    const WritableFileOptions& opts, const std::string& fname,
+    gscoped_ptr<WritableFile>* result) {
+  if (opts.mode == Env::OPEN_EXISTING) {
+    return STATUS_FORMAT(NotSupported, "Appending to existing file is not supported: $0", fname);
+  }
+  RETURN_NOT_OK(FileFactoryWrapper::NewWritableFile(opts, fname, result));
+  return WrapWritableFile(result);
+}
+
+Status EncryptedFileFactory::NewTempWritableFile(
+    const WritableFileOptions& opts, const std::string& name_template,
+    std::string* created_filename, gscoped_ptr<WritableFile>* result) {
+  RETURN_NOT_OK(FileFactoryWrapper::NewTempWritableFile(
+      opts, name_template, created_filename, result));
+  return WrapWritableFile(result);
+}
+
+Status EncryptedFileFactory::WrapWritableFile(gscoped_ptr<WritableFile>* result) {
+  std::string header;
+  auto stream = VERIFY_RESULT(CreateNewFileCipherStream(universe_key_manager_, &header));
+  if (stream) {
+    RETURN_NOT_OK((*result)->Append(header));
+    result->reset(new EncryptedWritableFile(std::move(*result), std::move(stream)));
+  }
+  return Status::OK();
+}
+
+Result<uint64_t> EncryptedFileFactory::GetFileSize(const std::string& fname) {
+  auto size = VERIFY_RESULT(FileFactoryWrapper::GetFileSize(fname));
+  gscoped_ptr<RandomAccessFile> file;
+  RETURN_NOT_OK(FileFactoryWrapper::NewRandomAccessFile(fname, &file));
+  // Only the magic is checked, so the size is known even before the universe key is received.
+  uint8_t magic[kEncryptionMagicSize];
+  Slice magic_slice;
+  RETURN_NOT_OK(file->Read(0, sizeof(magic), &magic_slice, magic));
+  if (HasEncryptionMagic(magic_slice)) {
+    size -= kEncryptionHeaderSize;
+  }
+  return size;
+}
+
+std::unique_ptr<Env> NewEncryptedEnv(UniverseKeyManager* universe_key_manager) {
+  return Env::NewDefaultEnv(std::make_unique<EncryptedFileFactory>(
+      Env::DefaultFileFactory(), universe_key_manager));
+}
+
+} // namespace yb
@@ -0,0 +1,76 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ENCRYPTED_FILE_H
+#define YB_UTIL_ENCRYPTED_FILE_H
+
+#include <memory>
+#include <string>
+
+#include "yb/util/encryption_util.h"
+#include "yb/util/env.h"
+
+namespace yb {
+
+class UniverseKeyManager;
+
+// Files are encrypted with their own keys, that are stored in the file headers encrypted with the
+// latest universe key of universe_key_manager. New files are written as plaintext while
+// encryption is disabled, and files without an encryption header are always read as plaintext.
+//
+// Offsets and sizes of encrypted files exclude the header, so their users see the same layout as
+// in plaintext ones. RWFiles are not encrypted.
+class EncryptedFileFactory : public FileFactoryWrapper {
+ public:
+  EncryptedFileFactory(FileFactory* file_factory, UniverseKeyManager* universe_key_manager)
+      : FileFactoryWrapper(file_factory), universe_key_manager_(universe_key_manager) {}
+
+  CHECKED_STATUS NewSequentialFile(const std::string& fname,
+                                   gscoped_ptr<SequentialFile>* result) override;
+
+  CHECKED_STATUS NewRandomAccessFile(const std::string& fname,
+                                     gscoped_ptr<RandomAccessFile>* result) override;
+
+  CHECKED_STATUS NewRandomAccessFile(const RandomAccessFileOptions& opts,
+                                     const std::string& fname,
+                                     gscoped_ptr<RandomAccessFile>* result) override;
+
+  CHECKED_STATUS NewWritableFile(const std::string& fname,
+                                 gscoped_ptr<WritableFile>* result) override;
+
+  CHECKED_STATUS NewWritableFile(const WritableFileOptions& opts,
+                                 const std::string& fname,
+                                 gscoped_ptr<WritableFile>* result) override;
+
+  CHECKED_STATUS NewTempWritableFile(const WritableFileOptions& opts,
+                                     const std::string& name_template,
+                                     std::string* created_filename,
+                                     gscoped_ptr<WritableFile>* result) override;
+
+  Result<uint64_t> GetFileSize(const std::string& fname) override;
+
+ private:
+  // Returns the cipher stream of the file, or nullptr if it is plaintext.
+  Result<BlockAccessCipherStreamPtr> ReadHeader(const RandomAccessFile& file);
+
+  CHECKED_STATUS WrapWritableFile(gscoped_ptr<WritableFile>* result);
+
+  UniverseKeyManager* universe_key_manager_;
+};
+
+// Returns the env that stores files through EncryptedFileFactory over the default file factory.
+std::unique_ptr<Env> NewEncryptedEnv(UniverseKeyManager* universe_key_manager);
+
+} // namespace yb
+
+#endif // YB_UTIL_ENCRYPTED_FILE_H
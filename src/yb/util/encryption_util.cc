@@ -0,0 +1,218 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/encryption_util.h"
+
+#include <openssl/rand.h>
+
+#include "yb/util/coding.h"
+#include "yb/util/universe_key_manager.h"
+
+namespace yb {
+
+namespace {
+
+constexpr char kEncryptionMagic[] = "encrypt!";
+static_assert(sizeof(kEncryptionMagic) - 1 == kEncryptionMagicSize, "Wrong magic size");
+constexpr size_t kAesBlockSize = 16;
+constexpr size_t kMaxEncryptChunk = 1 << 30;
+
+struct CipherCtxDeleter {
+  void operator()(EVP_CIPHER_CTX* ctx) const {
+    EVP_CIPHER_CTX_free(ctx);
+  }
+};
+
+Result<const EVP_CIPHER*> CipherForKeySize(size_t key_size) {
+  switch (key_size) {
+    case 16: return EVP_aes_128_ctr();
+    case 24: return EVP_aes_192_ctr();
+    case 32: return EVP_aes_256_ctr();
+  }
+  return STATUS_FORMAT(InvalidArgument, "Wrong encryption key size: $0", key_size);
+}
+
+CHECKED_STATUS RandomBytes(void* out, size_t size) {
+  if (RAND_bytes(static_cast<uint8_t*>(out), size) != 1) {
+    return STATUS(InternalError, "Failed to generate random bytes");
+  }
+  return Status::OK();
+}
+
+} // namespace
+
+Result<EncryptionParamsPtr> EncryptionParams::NewRandom() {
+  auto result = std::make_unique<EncryptionParams>();
+  result->key.resize(kKeySize);
+  RETURN_NOT_OK(RandomBytes(&result->key[0], kKeySize));
+  RETURN_NOT_OK(RandomBytes(result->nonce, kNonceSize));
+  RETURN_NOT_OK(RandomBytes(&result->counter, sizeof(result->counter)));
+  return result;
+}
+
+Result<EncryptionParamsPtr> EncryptionParams::FromPB(const EncryptionParamsPB& pb) {
+  if (pb.nonce().size() != kNonceSize) {
+    return STATUS_FORMAT(Corruption, "Wrong encryption nonce size: $0", pb.nonce().size());
+  }
+  auto result = std::make_unique<EncryptionParams>();
+  result->key = pb.data_key();
+  memcpy(result->nonce, pb.nonce().data(), kNonceSize);
+  result->counter = pb.counter();
+  return result;
+}
+
+void EncryptionParams::ToPB(EncryptionParamsPB* pb) const {
+  pb->set_data_key(key);
+  pb->set_nonce(nonce, kNonceSize);
+  pb->set_counter(counter);
+}
+
+Result<BlockAccessCipherStreamPtr> BlockAccessCipherStream::FromParams(
+    EncryptionParamsPtr params) {
+  auto cipher = VERIFY_RESULT(CipherForKeySize(params->key.size()));
+  return BlockAccessCipherStreamPtr(new BlockAccessCipherStream(std::move(params), cipher));
+}
+
+BlockAccessCipherStream::BlockAccessCipherStream(
+    EncryptionParamsPtr params, const EVP_CIPHER* cipher)
+    : params_(std::move(params)), cipher_(cipher) {}
+
+Status BlockAccessCipherStream::Encrypt(
+    uint64_t offset, const void* input, void* output, size_t size) const {
+  // The counter of the block is the initial one, that is the nonce followed by the big endian
+  // counter, plus the index of the block. Carried over the whole 128 bits, as OpenSSL does.
+  uint8_t iv[kAesBlockSize];
+  memcpy(iv, params_->nonce, EncryptionParams::kNonceSize);
+  for (size_t i = 0; i != sizeof(params_->counter); ++i) {
+    iv[EncryptionParams::kNonceSize + i] = params_->counter >> (8 * (3 - i));
+  }
+  uint64_t carry = offset / kAesBlockSize;
+  for (int i = kAesBlockSize; i-- > 0 && carry;) {
+    carry += iv[i];
+    iv[i] = carry & 0xff;
+    carry >>= 8;
+  }
+
+  std::unique_ptr<EVP_CIPHER_CTX, CipherCtxDeleter> ctx(EVP_CIPHER_CTX_new());
+  if (!ctx || EVP_EncryptInit_ex(ctx.get(), cipher_, nullptr,
+                                 reinterpret_cast<const uint8_t*>(params_->key.data()), iv) != 1) {
+    return STATUS(InternalError, "Failed to initialize cipher");
+  }
+
+  int out_len = 0;
+  size_t block_offset = offset % kAesBlockSize;
+  if (block_offset) {
+    // Skip the beginning of the block, that precedes the offset.
+    uint8_t skipped[kAesBlockSize] = {0};
+    if (EVP_EncryptUpdate(ctx.get(), skipped, &out_len, skipped, block_offset) != 1) {
+      return STATUS(InternalError, "Failed to encrypt");
+    }
+  }
+
+  auto in = static_cast<const uint8_t*>(input);
+  auto out = static_cast<uint8_t*>(output);
+  while (size) {
+    size_t chunk = std::min(size, kMaxEncryptChunk);
+    if (EVP_EncryptUpdate(ctx.get(), out, &out_len, in, chunk) != 1 || out_len != chunk) {
+      return STATUS(InternalError, "Failed to encrypt");
+    }
+    in += chunk;
+    out += chunk;
+    size -= chunk;
+  }
+  return Status::OK();
+}
+
+// The header is:
+// magic | size of EncryptionHeaderPB (fixed32) | EncryptionHeaderPB | zero padding.
+Result<BlockAccessCipherStreamPtr> CreateNewFileCipherStream(
+    UniverseKeyManager* universe_key_manager, std::string* header) {
+  EncryptionHeaderPB header_pb;
+  EncryptionParamsPB universe_key;
+  if (!universe_key_manager->GetLatestUniverseKey(
+          header_pb.mutable_universe_key_id(), &universe_key)) {
+    return BlockAccessCipherStreamPtr();
+  }
+
+  auto wrap_params = std::make_unique<EncryptionParams>();
+  wrap_params->key = universe_key.data_key();
+  RETURN_NOT_OK(RandomBytes(wrap_params->nonce, EncryptionParams::kNonceSize));
+  wrap_params->counter = 0;
+  header_pb.set_wrap_nonce(wrap_params->nonce, EncryptionParams::kNonceSize);
+  auto wrap_stream = VERIFY_RESULT(BlockAccessCipherStream::FromParams(std::move(wrap_params)));
+
+  auto params = VERIFY_RESULT(EncryptionParams::NewRandom());
+  EncryptionParamsPB params_pb;
+  params->ToPB(&params_pb);
+  auto* encrypted_params = header_pb.mutable_encrypted_file_params();
+  params_pb.SerializeToString(encrypted_params);
+  RETURN_NOT_OK(wrap_stream->Encrypt(
+      0, encrypted_params->data(), &(*encrypted_params)[0], encrypted_params->size()));
+
+  const size_t pb_size = header_pb.ByteSizeLong();
+  if (kEncryptionMagicSize + sizeof(uint32_t) + pb_size > kEncryptionHeaderSize) {
+    return STATUS_FORMAT(InvalidArgument, "Too big encryption header: $0", pb_size);
+  }
+  header->assign(kEncryptionMagic, kEncryptionMagicSize);
+  header->resize(kEncryptionMagicSize + sizeof(uint32_t));
+  EncodeFixed32(reinterpret_cast<uint8_t*>(&(*header)[kEncryptionMagicSize]), pb_size);
+  header_pb.AppendToString(header);
+  header->resize(kEncryptionHeaderSize);
+
+  return BlockAccessCipherStream::FromParams(std::move(params));
+}
+
+bool HasEncryptionMagic(const Slice& prefix) {
+  return prefix.size() >= kEncryptionMagicSize &&
+         memcmp(prefix.data(), kEncryptionMagic, kEncryptionMagicSize) == 0;
+}
+
+Result<BlockAccessCipherStreamPtr> CipherStreamFromHeader(
+    const Slice& header, UniverseKeyManager* universe_key_manager) {
+  if (!HasEncryptionMagic(header)) {
+    return BlockAccessCipherStreamPtr();
+  }
+  if (header.size() < kEncryptionHeaderSize) {
+    return STATUS_FORMAT(Corruption, "Truncated encryption header: $0 bytes", header.size());
+  }
+  const uint32_t pb_size = DecodeFixed32(header.data() + kEncryptionMagicSize);
+  const size_t pb_offset = kEncryptionMagicSize + sizeof(uint32_t);
+  EncryptionHeaderPB header_pb;
+  if (pb_size > kEncryptionHeaderSize - pb_offset ||
+      !header_pb.ParseFromArray(header.data() + pb_offset, pb_size)) {
+    return STATUS(Corruption, "Failed to parse encryption header");
+  }
+
+  auto universe_key = VERIFY_RESULT(universe_key_manager->GetUniverseKey(
+      header_pb.universe_key_id()));
+  if (header_pb.wrap_nonce().size() != EncryptionParams::kNonceSize) {
+    return STATUS(Corruption, "Wrong nonce in encryption header");
+  }
+  auto wrap_params = std::make_unique<EncryptionParams>();
+  wrap_params->key = universe_key.data_key();
+  memcpy(wrap_params->nonce, header_pb.wrap_nonce().data(), EncryptionParams::kNonceSize);
+  wrap_params->counter = 0;
+  auto wrap_stream = VERIFY_RESULT(BlockAccessCipherStream::FromParams(std::move(wrap_params)));
+
+  std::string* decrypted_params = header_pb.mutable_encrypted_file_params();
+  RETURN_NOT_OK(wrap_stream->Decrypt(
+      0, decrypted_params->data(), &(*decrypted_params)[0], decrypted_params->size()));
+  EncryptionParamsPB params_pb;
+  if (!params_pb.ParseFromString(*decrypted_params)) {
+    return STATUS_FORMAT(Corruption, "Failed to decrypt file key with universe key $0",
+                         header_pb.universe_key_id());
+  }
+  return BlockAccessCipherStream::FromParams(VERIFY_RESULT(EncryptionParams::FromPB(params_pb)));
+}
+
+} // namespace yb
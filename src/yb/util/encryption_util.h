@@ -0,0 +1,92 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_ENCRYPTION_UTIL_H
+#define YB_UTIL_ENCRYPTION_UTIL_H
+
+#include <openssl/evp.h>
+
+#include <memory>
+#include <string>
+
+#include "yb/util/encryption.pb.h"
+#include "yb/util/result.h"
+#include "yb/util/slice.h"
+
+namespace yb {
+
+class UniverseKeyManager;
+
+// Encrypted files start with a header of this size, that is followed by the encrypted data.
+// The header is padded to a page, so the data keeps the same alignment as in plaintext files.
+constexpr size_t kEncryptionHeaderSize = 4096;
+
+// The header starts with a magic of this size, by which encrypted files are told apart.
+constexpr size_t kEncryptionMagicSize = 8;
+
+// Key and initial counter of AES in counter mode.
+struct EncryptionParams {
+  // New file keys are AES-256 ones, universe keys could also be 128 or 192 bits long.
+  static constexpr size_t kKeySize = 32;
+  static constexpr size_t kNonceSize = 12;
+
+  std::string key;
+  uint8_t nonce[kNonceSize];
+  uint32_t counter;
+
+  static Result<std::unique_ptr<EncryptionParams>> NewRandom();
+  static Result<std::unique_ptr<EncryptionParams>> FromPB(const EncryptionParamsPB& pb);
+  void ToPB(EncryptionParamsPB* pb) const;
+};
+
+typedef std::unique_ptr<EncryptionParams> EncryptionParamsPtr;
+
+// AES in counter mode, so any part of the file could be encrypted or decrypted independently of
+// the previous ones. OpenSSL uses AES-NI when it is supported by the CPU.
+class BlockAccessCipherStream {
+ public:
+  static Result<std::unique_ptr<BlockAccessCipherStream>> FromParams(EncryptionParamsPtr params);
+
+  // Encrypts size bytes of data located at the specified offset of the plaintext. Input and output
+  // could be the same buffer. In counter mode decryption is the same operation.
+  CHECKED_STATUS Encrypt(uint64_t offset, const void* input, void* output, size_t size) const;
+
+  CHECKED_STATUS Decrypt(uint64_t offset, const void* input, void* output, size_t size) const {
+    return Encrypt(offset, input, output, size);
+  }
+
+ private:
+  BlockAccessCipherStream(EncryptionParamsPtr params, const EVP_CIPHER* cipher);
+
+  EncryptionParamsPtr params_;
+  const EVP_CIPHER* cipher_;
+};
+
+typedef std::unique_ptr<BlockAccessCipherStream> BlockAccessCipherStreamPtr;
+
+// Generates the key of a new file and fills its header of kEncryptionHeaderSize bytes. Returns
+// nullptr when the file should be written as plaintext.
+Result<BlockAccessCipherStreamPtr> CreateNewFileCipherStream(
+    UniverseKeyManager* universe_key_manager, std::string* header);
+
+// Returns true if the beginning of the file starts with the magic of the encryption header.
+bool HasEncryptionMagic(const Slice& prefix);
+
+// Decodes the key of the file from its header. Returns nullptr when the file is plaintext, i.e. its
+// beginning, that could also be shorter than the header, is not an encryption header.
+Result<BlockAccessCipherStreamPtr> CipherStreamFromHeader(
+    const Slice& header, UniverseKeyManager* universe_key_manager);
+
+} // namespace yb
+
+#endif // YB_UTIL_ENCRYPTION_UTIL_H
@@ -442,6 +442,83 @@ TEST(FastVarIntTest, DecodeDescendingSignedPerformancePositiveValues) {
   TestDecodeDescendingSignedPerformance<uint64_t>();
 }
 
+TEST(FastVarIntTest, DecodeUnsignedPerformance) {
+  const auto values = GenerateRandomValues<uint64_t>();
+  std::string encoded;
+  for (auto value : values) {
+    FastAppendUnsignedVarIntToStr(value, &encoded);
+  }
+
+  std::clock_t start_time = std::clock();
+  Slice slice(encoded);
+  for (auto value : values) {
+    ASSERT_EQ(value, ASSERT_RESULT_FAST(FastDecodeUnsignedVarInt(&slice)));
+  }
+  std::clock_t end_time = std::clock();
+  LOG(INFO) << std::fixed << std::setprecision(2) << "One by one, CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
+
+  constexpr size_t kBatchSize = 16;
+  std::vector<uint64_t> decoded(values.size());
+  start_time = std::clock();
+  slice = Slice(encoded);
+  for (size_t i = 0; i < values.size(); i += kBatchSize) {
+    ASSERT_OK_FAST(FastDecodeUnsignedVarInts(
+        &slice, decoded.data() + i, std::min(kBatchSize, values.size() - i)));
+  }
+  end_time = std::clock();
+  LOG(INFO) << std::fixed << std::setprecision(2) << "Batched, CPU time used: "
+            << 1000.0 * (end_time - start_time) / CLOCKS_PER_SEC << " ms\n";
+  ASSERT_TRUE(slice.empty());
+  ASSERT_EQ(values, decoded);
+}
+
+TEST(FastVarIntTest, DecodeBatch) {
+  auto unsigned_values = GenerateRandomValues<uint64_t>(100);
+  auto signed_values = GenerateRandomValues<int64_t>(100);
+  // For the descending encoding the value should be negatable.
+  signed_values.push_back(std::numeric_limits<int64_t>::max());
+  signed_values.push_back(std::numeric_limits<int64_t>::min() + 1);
+  unsigned_values.push_back(std::numeric_limits<uint64_t>::max());
+
+  std::string unsigned_encoded;
+  for (auto value : unsigned_values) {
+    FastAppendUnsignedVarIntToStr(value, &unsigned_encoded);
+  }
+  std::string signed_encoded;
+  for (auto value : signed_values) {
+    FastEncodeDescendingSignedVarInt(value, &signed_encoded);
+  }
+
+  std::vector<uint64_t> unsigned_decoded(unsigned_values.size());
+  std::vector<int64_t> signed_decoded(signed_values.size());
+  Slice unsigned_slice(unsigned_encoded);
+  Slice signed_slice(signed_encoded);
+  for (size_t i = 0, count = 1; i < unsigned_values.size(); i += count, count = count % 7 + 1) {
+    count = std::min(count, unsigned_values.size() - i);
+    ASSERT_OK(FastDecodeUnsignedVarInts(&unsigned_slice, unsigned_decoded.data() + i, count));
+  }
+  for (size_t i = 0, count = 1; i < signed_values.size(); i += count, count = count % 7 + 1) {
+    count = std::min(count, signed_values.size() - i);
+    ASSERT_OK(FastDecodeDescendingSignedVarInts(&signed_slice, signed_decoded.data() + i, count));
+  }
+  ASSERT_TRUE(unsigned_slice.empty());
+  ASSERT_TRUE(signed_slice.empty());
+  ASSERT_EQ(unsigned_values, unsigned_decoded);
+  ASSERT_EQ(signed_values, signed_decoded);
+
+  // When a value is truncated, the slice starts at this value.
+  std::string truncated;
+  FastAppendUnsignedVarIntToStr(1, &truncated);
+  FastAppendUnsignedVarIntToStr(1ULL << 40, &truncated);
+  truncated.pop_back();
+  Slice truncated_slice(truncated);
+  uint64_t truncated_decoded[2];
+  ASSERT_NOK(FastDecodeUnsignedVarInts(&truncated_slice, truncated_decoded, 2));
+  ASSERT_EQ(1, truncated_decoded[0]);
+  ASSERT_EQ(truncated.size() - 1, truncated_slice.size());
+}
+
 TEST(FastVarIntTest, DecodeDescendingSignedCheck) {
   auto values = GenerateRandomValues<int64_t>(500);
 
@@ -165,8 +165,10 @@ const uint64_t kVarIntMasks[] = {
     0xffffffffffffffffULL,
 };
 
-Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, size_t src_size) {
-  typedef std::pair<int64_t, size_t> ResultType;
+namespace {
+
+inline Status DoDecodeSignedVarInt(
+    const uint8_t* src, size_t src_size, int64_t* v, size_t* decoded_size) {
   if (src_size == 0) {
     return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
   }
@@ -197,12 +199,13 @@ Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, si
     return NotEnoughEncodedBytes(n_bytes, src_size);
   }
   auto mask = kVarIntMasks[n_bytes];
+  *decoded_size = n_bytes;
 #if defined(THREAD_SANITIZER) || defined(ADDRESS_SANITIZER)
   uint64_t temp = 0;
   for (const uint8_t* i = std::max(src - 8 + n_bytes, src); i != src + n_bytes; ++i) {
     temp = (temp << 8) | *i;
   }
-  return ResultType(((temp & mask) | (~mask & negative)) - negative, n_bytes);
+  *v = ((temp & mask) | (~mask & negative)) - negative;
 #else
   // We are interested in range [src, src+n_bytes), so we use 64bit number that ends at src+n_bytes.
   // Then we use mask to drop header and bytes out of range.
@@ -211,19 +214,23 @@ Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, si
   // And add one: "- negative".
   // In case of non negative number, negative == 0.
   // So number will be unchanged by those manipulations.
-  return ResultType(
-        ((__builtin_bswap64(*reinterpret_cast<const uint64_t*>(src - 8 + n_bytes)) & mask) |
-            (~mask & negative)) - negative,
-        n_bytes);
+  *v = ((__builtin_bswap64(*reinterpret_cast<const uint64_t*>(src - 8 + n_bytes)) & mask) |
+            (~mask & negative)) - negative;
 #endif
+  return Status::OK();
+}
+
+} // namespace
+
+Result<std::pair<int64_t, size_t>> FastDecodeSignedVarInt(const uint8_t* src, size_t src_size) {
+  std::pair<int64_t, size_t> result;
+  RETURN_NOT_OK(DoDecodeSignedVarInt(src, src_size, &result.first, &result.second));
+  return result;
 }
 
 Status FastDecodeSignedVarInt(
     const uint8_t* src, size_t src_size, int64_t* v, size_t* decoded_size) {
-  auto temp = VERIFY_RESULT(FastDecodeSignedVarInt(src, src_size));
-  *v = temp.first;
-  *decoded_size = temp.second;
-  return Status::OK();
+  return DoDecodeSignedVarInt(src, src_size, v, decoded_size);
 }
 
 Result<int64_t> FastDecodeSignedVarInt(Slice* slice) {
@@ -250,6 +257,23 @@ Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice) {
   return -temp.first;
 }
 
+Status FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* values, size_t count) {
+  const uint8_t* pos = slice->data();
+  const uint8_t* const end = slice->end();
+  for (int64_t* const stop = values + count; values != stop; ++values) {
+    size_t decoded_size;
+    Status status = DoDecodeSignedVarInt(pos, end - pos, values, &decoded_size);
+    if (PREDICT_FALSE(!status.ok())) {
+      *slice = Slice(pos, end);
+      return status;
+    }
+    *values = -*values;
+    pos += decoded_size;
+  }
+  *slice = Slice(pos, end);
+  return Status::OK();
+}
+
 size_t UnsignedVarIntLength(uint64_t v) {
   size_t result = 1;
   v >>= 7;
@@ -296,7 +320,9 @@ void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size) {
   }
 }
 
-CHECKED_STATUS FastDecodeUnsignedVarInt(
+namespace {
+
+inline Status DoDecodeUnsignedVarInt(
     const uint8_t* src, size_t src_size, uint64_t* v, size_t* decoded_size) {
   if (src_size == 0) {
     return STATUS(Corruption, "Cannot decode a variable-length integer of zero size");
@@ -314,6 +340,16 @@ CHECKED_STATUS FastDecodeUnsignedVarInt(
     return Status::OK();
   }
 
+  if (n_bytes <= 8 && src_size >= 8) {
+    // The first n_bytes bytes of the big-endian word starting at src are the encoded value. With
+    // the header dropped, the value occupies the lower 7 * n_bytes bits of them.
+    uint64_t word;
+    memcpy(&word, src, sizeof(word));
+    *v = (__builtin_bswap64(word) >> (64 - 8 * n_bytes)) & ((1ULL << (7 * n_bytes)) - 1);
+    *decoded_size = n_bytes;
+    return Status::OK();
+  }
+
   uint64_t result = 0;
   int i = 0;
   if (n_bytes == 9) {
@@ -339,6 +375,29 @@ CHECKED_STATUS FastDecodeUnsignedVarInt(
   return Status::OK();
 }
 
+} // namespace
+
+Status FastDecodeUnsignedVarInt(
+    const uint8_t* src, size_t src_size, uint64_t* v, size_t* decoded_size) {
+  return DoDecodeUnsignedVarInt(src, src_size, v, decoded_size);
+}
+
+Status FastDecodeUnsignedVarInts(Slice* slice, uint64_t* values, size_t count) {
+  const uint8_t* pos = slice->data();
+  const uint8_t* const end = slice->end();
+  for (uint64_t* const stop = values + count; values != stop; ++values) {
+    size_t decoded_size;
+    Status status = DoDecodeUnsignedVarInt(pos, end - pos, values, &decoded_size);
+    if (PREDICT_FALSE(!status.ok())) {
+      *slice = Slice(pos, end);
+      return status;
+    }
+    pos += decoded_size;
+  }
+  *slice = Slice(pos, end);
+  return Status::OK();
+}
+
 Result<uint64_t> FastDecodeUnsignedVarInt(Slice* slice) {
   size_t size = 0;
   uint64_t value = 0;
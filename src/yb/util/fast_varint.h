@@ -65,6 +65,11 @@ inline void FastEncodeDescendingSignedVarInt(int64_t v, std::string *dest) {
 CHECKED_STATUS FastDecodeDescendingSignedVarInt(Slice *slice, int64_t *dest);
 Result<int64_t> FastDecodeDescendingSignedVarInt(Slice* slice);
 
+// Decodes count consecutive "descending VarInts" from the slice into values, consuming them.
+// Cheaper than decoding them one by one, since no Result is constructed per value.
+// On failure the slice starts at the value that could not be decoded.
+CHECKED_STATUS FastDecodeDescendingSignedVarInts(Slice* slice, int64_t* values, size_t count);
+
 size_t UnsignedVarIntLength(uint64_t v);
 void FastAppendUnsignedVarIntToStr(uint64_t v, std::string* dest);
 void FastEncodeUnsignedVarInt(uint64_t v, uint8_t *dest, size_t *size);
@@ -73,6 +78,9 @@ CHECKED_STATUS FastDecodeUnsignedVarInt(
 Result<uint64_t> FastDecodeUnsignedVarInt(Slice* slice);
 Result<uint64_t> FastDecodeUnsignedVarInt(const Slice& slice);
 
+// The same as FastDecodeDescendingSignedVarInts, but for unsigned VarInts.
+CHECKED_STATUS FastDecodeUnsignedVarInts(Slice* slice, uint64_t* values, size_t count);
+
 }  // namespace util
 }  // namespace yb
 
@@ -0,0 +1,84 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/flame_graph.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class FlameGraphTest : public YBTest {
+};
+
+TEST_F(FlameGraphTest, Folded) {
+  FlameGraph graph;
+  graph.AddStack({"leaf1", "middle", "main"}, 3);
+  graph.AddStack({"leaf2", "middle", "main"}, 2);
+  graph.AddStack({"middle", "main"}, 1);
+  graph.AddStack({"other", "main"}, 4);
+  ASSERT_EQ(10, graph.total_weight());
+
+  std::stringstream out;
+  graph.WriteFolded(&out);
+  ASSERT_EQ("main;middle;leaf1 3\n"
+            "main;middle;leaf2 2\n"
+            "main;middle 1\n"
+            "main;other 4\n", out.str());
+}
+
+TEST_F(FlameGraphTest, Svg) {
+  FlameGraph graph;
+  graph.AddStack({"Foo<int>::Bar", "main"}, 1);
+  graph.AddStack({"Baz", "main"}, 3);
+
+  std::stringstream out;
+  graph.WriteSvg("Test & graph", "samples", &out);
+  const auto svg = out.str();
+  ASSERT_STR_CONTAINS(svg, "<svg ");
+  ASSERT_STR_CONTAINS(svg, "Test &amp; graph");
+  ASSERT_STR_CONTAINS(svg, "<title>Foo&lt;int&gt;::Bar (1 samples, 25.00%)</title>");
+  ASSERT_STR_CONTAINS(svg, "<title>main (4 samples, 100.00%)</title>");
+  ASSERT_STR_CONTAINS(svg, "</svg>");
+}
+
+TEST_F(FlameGraphTest, CpuProfile) {
+  // Header, two samples, trailer.
+  std::vector<uintptr_t> words = {0, 3, 0, 10000, 0};
+  words.insert(words.end(), {5, 2, 0x10, 0x20});
+  words.insert(words.end(), {7, 1, 0x20});
+  words.insert(words.end(), {0, 1, 0});
+
+  FlameGraph graph;
+  ASSERT_OK(graph.AddCpuProfile(
+      Slice(reinterpret_cast<const uint8_t*>(words.data()), words.size() * sizeof(uintptr_t))));
+  ASSERT_EQ(12, graph.total_weight());
+
+  // Trailer is missing.
+  words.resize(words.size() - 3);
+  FlameGraph truncated;
+  auto status = truncated.AddCpuProfile(
+      Slice(reinterpret_cast<const uint8_t*>(words.data()), words.size() * sizeof(uintptr_t)));
+  ASSERT_TRUE(status.IsCorruption()) << status;
+
+  FlameGraph bad_header;
+  status = bad_header.AddCpuProfile(Slice("not a profile"));
+  ASSERT_TRUE(status.IsCorruption()) << status;
+}
+
+} // namespace yb
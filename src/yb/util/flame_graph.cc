@@ -0,0 +1,223 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/flame_graph.h"
+
+#include <algorithm>
+#include <functional>
+#include <ostream>
+
+#include "yb/gutil/stringprintf.h"
+
+// GLog already implements symbolization. Just import their hidden symbol.
+namespace google {
+bool Symbolize(void *pc, char *out, int out_size);
+}
+
+namespace yb {
+
+namespace {
+
+const double kSvgWidth = 1200;
+const double kSvgFrameHeight = 16;
+const double kSvgPadding = 10;
+const double kSvgTitleHeight = 24;
+const double kSvgCharWidth = 7;
+const double kSvgMinFrameWidth = 0.1;
+
+std::string EscapeXml(const std::string& input) {
+  std::string result;
+  result.reserve(input.size());
+  for (char c : input) {
+    switch (c) {
+      case '&': result += "&amp;"; break;
+      case '<': result += "&lt;"; break;
+      case '>': result += "&gt;"; break;
+      case '"': result += "&quot;"; break;
+      default: result += c; break;
+    }
+  }
+  return result;
+}
+
+// Stable warm color, so the same function has the same color in every graph.
+std::string FrameColor(const std::string& name) {
+  size_t hash = std::hash<std::string>()(name);
+  return StringPrintf("rgb(%d,%d,%d)",
+                      static_cast<int>(205 + hash % 50),
+                      static_cast<int>((hash >> 8) % 230),
+                      static_cast<int>((hash >> 16) % 55));
+}
+
+} // namespace
+
+struct FlameGraph::Node {
+  int64_t weight = 0;
+  std::map<std::string, std::unique_ptr<Node>> children;
+
+  size_t Depth() const {
+    size_t result = 0;
+    for (const auto& child : children) {
+      result = std::max(result, child.second->Depth());
+    }
+    return result + 1;
+  }
+
+  void WriteFolded(std::string* prefix, std::ostream* out) const {
+    int64_t children_weight = 0;
+    for (const auto& child : children) {
+      children_weight += child.second->weight;
+      auto old_size = prefix->size();
+      if (!prefix->empty()) {
+        prefix->push_back(';');
+      }
+      prefix->append(child.first);
+      child.second->WriteFolded(prefix, out);
+      prefix->resize(old_size);
+    }
+    // Weight of the samples that ended in this frame.
+    if (weight > children_weight && !prefix->empty()) {
+      *out << *prefix << " " << weight - children_weight << "\n";
+    }
+  }
+
+  void WriteSvg(const std::string& name, size_t depth, double x, double scale, double bottom,
+                int64_t total, const std::string& unit, std::ostream* out) const {
+    const double width = weight * scale;
+    if (width < kSvgMinFrameWidth) {
+      return;
+    }
+    const double y = bottom - (depth + 1) * kSvgFrameHeight;
+    auto escaped_name = EscapeXml(name);
+    *out << "<g><title>" << escaped_name << " (" << weight << " " << unit << ", "
+         << StringPrintf("%.2f", 100.0 * weight / total) << "%)</title>"
+         << StringPrintf("<rect x=\"%.1f\" y=\"%.1f\" width=\"%.1f\" height=\"%.1f\" ",
+                         x, y, width, kSvgFrameHeight - 1)
+         << "fill=\"" << FrameColor(name) << "\" rx=\"2\" ry=\"2\"/>";
+    const size_t max_chars = static_cast<size_t>((width - 6) / kSvgCharWidth);
+    if (max_chars >= 3) {
+      auto text = name.size() <= max_chars ? name : name.substr(0, max_chars - 2) + "..";
+      *out << StringPrintf("<text x=\"%.1f\" y=\"%.1f\">", x + 3, y + kSvgFrameHeight - 4.5)
+           << EscapeXml(text) << "</text>";
+    }
+    *out << "</g>\n";
+    for (const auto& child : children) {
+      child.second->WriteSvg(child.first, depth + 1, x, scale, bottom, total, unit, out);
+      x += child.second->weight * scale;
+    }
+  }
+};
+
+FlameGraph::FlameGraph() : root_(new Node) {
+}
+
+FlameGraph::~FlameGraph() {
+}
+
+void FlameGraph::AddStack(const std::vector<std::string>& frames, int64_t weight) {
+  auto* node = root_.get();
+  node->weight += weight;
+  for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+    auto& child = node->children[*it];
+    if (!child) {
+      child.reset(new Node);
+    }
+    node = child.get();
+    node->weight += weight;
+  }
+}
+
+void FlameGraph::AddStack(void* const* pcs, size_t num_pcs, int64_t weight) {
+  std::vector<std::string> frames;
+  frames.reserve(num_pcs);
+  for (size_t i = 0; i != num_pcs; ++i) {
+    frames.push_back(Symbolize(pcs[i]));
+  }
+  AddStack(frames, weight);
+}
+
+const std::string& FlameGraph::Symbolize(void* pc) {
+  auto it = symbols_.find(pc);
+  if (it != symbols_.end()) {
+    return it->second;
+  }
+  // Return addresses point after the call instruction, that could be in the next function.
+  char buf[1024];
+  std::string symbol;
+  if (google::Symbolize(static_cast<char*>(pc) - 1, buf, sizeof(buf))) {
+    symbol = buf;
+  } else {
+    symbol = StringPrintf("%p", pc);
+  }
+  return symbols_.emplace(pc, std::move(symbol)).first->second;
+}
+
+// The legacy gperftools CPU profile format consists of machine words: a header
+// (0, 3, 0, sampling period in microseconds, 0), then records (sample count, number of program
+// counters, program counters) and a trailer record (0, 1, 0). It is followed by the text of
+// /proc/self/maps, that we don't need, since the program counters are symbolized in process.
+Status FlameGraph::AddCpuProfile(Slice profile) {
+  const auto* words = reinterpret_cast<const uintptr_t*>(profile.data());
+  const size_t num_words = profile.size() / sizeof(uintptr_t);
+  if (num_words < 5 || words[0] != 0 || words[1] != 3 || words[2] != 0) {
+    return STATUS(Corruption, "Bad CPU profile header");
+  }
+  size_t pos = 2 + words[1];
+  for (;;) {
+    if (pos + 2 > num_words) {
+      return STATUS(Corruption, "Truncated CPU profile");
+    }
+    const auto count = words[pos];
+    const auto depth = words[pos + 1];
+    pos += 2;
+    if (pos + depth > num_words) {
+      return STATUS_FORMAT(Corruption, "Truncated CPU profile record of depth $0", depth);
+    }
+    if (count == 0 && depth == 1 && words[pos] == 0) {
+      return Status::OK();
+    }
+    AddStack(reinterpret_cast<void* const*>(words + pos), depth, count);
+    pos += depth;
+  }
+}
+
+int64_t FlameGraph::total_weight() const {
+  return root_->weight;
+}
+
+void FlameGraph::WriteFolded(std::ostream* out) const {
+  std::string prefix;
+  root_->WriteFolded(&prefix, out);
+}
+
+void FlameGraph::WriteSvg(
+    const std::string& title, const std::string& unit, std::ostream* out) const {
+  const double height =
+      kSvgTitleHeight + root_->Depth() * kSvgFrameHeight + 2 * kSvgPadding;
+  *out << StringPrintf(
+              "<svg version=\"1.1\" xmlns=\"http://www.w3.org/2000/svg\" width=\"%.0f\" "
+              "height=\"%.0f\" viewBox=\"0 0 %.0f %.0f\" "
+              "style=\"font-family:Verdana,sans-serif;font-size:12px\">\n",
+              kSvgWidth, height, kSvgWidth, height)
+       << StringPrintf("<text x=\"%.0f\" y=\"%.0f\" text-anchor=\"middle\" "
+                       "style=\"font-size:16px\">", kSvgWidth / 2, kSvgTitleHeight - 6)
+       << EscapeXml(title) << "</text>\n";
+  if (root_->weight > 0) {
+    const double scale = (kSvgWidth - 2 * kSvgPadding) / root_->weight;
+    root_->WriteSvg("all", 0, kSvgPadding, scale, height - kSvgPadding,
+                    root_->weight, unit, out);
+  }
+  *out << "</svg>\n";
+}
+
+} // namespace yb
@@ -0,0 +1,68 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_FLAME_GRAPH_H
+#define YB_UTIL_FLAME_GRAPH_H
+
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "yb/util/slice.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+// Aggregates weighted stack samples, and renders them as a flame graph.
+//
+// Not thread-safe.
+class FlameGraph {
+ public:
+  FlameGraph();
+  ~FlameGraph();
+
+  // Adds a sample with the given frame names, ordered from the innermost frame to the outermost.
+  void AddStack(const std::vector<std::string>& frames, int64_t weight);
+
+  // Same as above, but for program counters, that are symbolized. Program counters are expected
+  // to be return addresses, like the ones collected by StackTrace.
+  void AddStack(void* const* pcs, size_t num_pcs, int64_t weight);
+
+  // Adds the samples of a CPU profile written by the gperftools profiler.
+  CHECKED_STATUS AddCpuProfile(Slice profile);
+
+  int64_t total_weight() const;
+
+  // Writes the stacks in the collapsed format used by flamegraph.pl: one line per distinct stack,
+  // the frames separated by ';' starting from the outermost one, followed by the weight.
+  void WriteFolded(std::ostream* out) const;
+
+  // Writes a self-contained SVG image, that could be embedded in an HTML page. Each frame has a
+  // tooltip with its weight, expressed in the given unit.
+  void WriteSvg(const std::string& title, const std::string& unit, std::ostream* out) const;
+
+ private:
+  struct Node;
+
+  const std::string& Symbolize(void* pc);
+
+  std::unique_ptr<Node> root_;
+  std::unordered_map<void*, std::string> symbols_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_FLAME_GRAPH_H
@@ -125,4 +125,23 @@ TEST_F(HdrHistogramTest, PercentileAndCopyTest) {
   ASSERT_EQ(hist.TotalSum(), copy.TotalSum());
 }
 
+TEST_F(HdrHistogramTest, MoveDataTest) {
+  uint64_t specified_max = 10000;
+  HdrHistogram hist(specified_max, kSigDigits);
+  HdrHistogram other(specified_max, kSigDigits);
+  load_percentiles(&other);
+  uint64_t total_sum = other.TotalSum();
+
+  hist.MoveDataFrom(&other);
+  ASSERT_NO_FATALS(validate_percentiles(&hist, specified_max));
+  ASSERT_EQ(total_sum, hist.TotalSum());
+  ASSERT_EQ(0, other.TotalCount());
+  ASSERT_EQ(0, other.TotalSum());
+
+  // Nothing is moved twice.
+  hist.MoveDataFrom(&other);
+  ASSERT_NO_FATALS(validate_percentiles(&hist, specified_max));
+  ASSERT_EQ(total_sum, hist.TotalSum());
+}
+
 } // namespace yb
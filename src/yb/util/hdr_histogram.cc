@@ -41,6 +41,7 @@
 #include "yb/util/status.h"
 
 using base::subtle::Atomic64;
+using base::subtle::NoBarrier_AtomicExchange;
 using base::subtle::NoBarrier_AtomicIncrement;
 using base::subtle::NoBarrier_Store;
 using base::subtle::NoBarrier_Load;
@@ -174,11 +175,15 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   NoBarrier_AtomicIncrement(&total_count_, count);
   NoBarrier_AtomicIncrement(&total_sum_, value * count);
 
+  UpdateMinMax(value, value);
+}
+
+void HdrHistogram::UpdateMinMax(Atomic64 min, Atomic64 max) {
   // Update min, if needed.
   {
     Atomic64 min_val;
-    while (PREDICT_FALSE(value < (min_val = MinValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, value);
+    while (PREDICT_FALSE(min < (min_val = MinValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&min_value_, min_val, min);
       if (PREDICT_TRUE(old_val == min_val)) break; // CAS success.
     }
   }
@@ -186,13 +191,37 @@ void HdrHistogram::IncrementBy(int64_t value, int64_t count) {
   // Update max, if needed.
   {
     Atomic64 max_val;
-    while (PREDICT_FALSE(value > (max_val = MaxValue()))) {
-      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, value);
+    while (PREDICT_FALSE(max > (max_val = MaxValue()))) {
+      Atomic64 old_val = NoBarrier_CompareAndSwap(&max_value_, max_val, max);
       if (PREDICT_TRUE(old_val == max_val)) break; // CAS success.
     }
   }
 }
 
+void HdrHistogram::MoveDataFrom(HdrHistogram* other) {
+  DCHECK_EQ(counts_array_length_, other->counts_array_length_);
+
+  Atomic64 moved_count = 0;
+  for (int i = 0; i < counts_array_length_; i++) {
+    if (NoBarrier_Load(&other->counts_[i]) == 0) {
+      continue;
+    }
+    Atomic64 count = NoBarrier_AtomicExchange(&other->counts_[i], 0);
+    NoBarrier_AtomicIncrement(&counts_[i], count);
+    moved_count += count;
+  }
+  if (moved_count == 0) {
+    return;
+  }
+  // The total of 'other' could go negative for a short time, if a value is being recorded in it,
+  // so it is never read directly.
+  NoBarrier_AtomicIncrement(&other->total_count_, -moved_count);
+  NoBarrier_AtomicIncrement(&total_count_, moved_count);
+  NoBarrier_AtomicIncrement(&total_sum_, NoBarrier_AtomicExchange(&other->total_sum_, 0));
+  // Min and max of 'other' are never reset, they are for all the values ever recorded in it.
+  UpdateMinMax(NoBarrier_Load(&other->min_value_), NoBarrier_Load(&other->max_value_));
+}
+
 void HdrHistogram::IncrementWithExpectedInterval(int64_t value,
                                                  int64_t expected_interval_between_samples) {
   Increment(value);
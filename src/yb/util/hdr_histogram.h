@@ -105,6 +105,11 @@ class HdrHistogram {
   void IncrementWithExpectedInterval(int64_t value,
                                      int64_t expected_interval_between_samples);
 
+  // Moves the data recorded in 'other' to this histogram. 'other' should have the same
+  // configuration. Could be called concurrently with updates of both histograms; 'other'
+  // should only be read through the histogram its data is moved to.
+  void MoveDataFrom(HdrHistogram* other);
+
   // Fetch configuration params.
   uint64_t highest_trackable_value() const { return highest_trackable_value_; }
   int num_significant_digits() const { return num_significant_digits_; }
@@ -188,6 +193,7 @@ class HdrHistogram {
   static const int kMaxValidNumSignificantDigits = 5;
 
   void Init();
+  void UpdateMinMax(base::subtle::Atomic64 min, base::subtle::Atomic64 max);
   int CountsArrayIndex(int bucket_index, int sub_bucket_index) const;
 
   uint64_t highest_trackable_value_;
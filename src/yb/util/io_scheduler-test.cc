@@ -0,0 +1,105 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/io_scheduler.h"
+#include "yb/util/size_literals.h"
+#include "yb/util/test_util.h"
+
+using namespace std::literals;
+using namespace yb::size_literals;
+
+DECLARE_int64(io_scheduler_max_bytes_per_sec);
+DECLARE_int64(io_scheduler_min_bytes_per_sec);
+DECLARE_int32(io_scheduler_target_sync_latency_ms);
+DECLARE_int32(io_scheduler_adjust_interval_ms);
+
+namespace yb {
+
+class IoSchedulerTest : public YBTest {
+};
+
+TEST_F(IoSchedulerTest, RateLimit) {
+  FLAGS_io_scheduler_max_bytes_per_sec = 10_MB;
+  IoScheduler scheduler("disk");
+  ASSERT_EQ(FLAGS_io_scheduler_max_bytes_per_sec / 10, scheduler.burst_bytes());
+
+  constexpr size_t kTotalBytes = 3_MB;
+  constexpr size_t kChunk = 64_KB;
+  auto start = MonoTime::Now();
+  for (size_t bytes = 0; bytes < kTotalBytes; bytes += kChunk) {
+    scheduler.Request(IoPriority::kCompaction, kChunk);
+  }
+  // The first burst is granted at once, the rest at the rate of the disk.
+  auto elapsed = MonoTime::Now() - start;
+  ASSERT_GE(elapsed, MonoDelta::FromMilliseconds(150));
+  ASSERT_EQ(kTotalBytes, scheduler.total_bytes(IoPriority::kCompaction));
+  ASSERT_EQ(0U, scheduler.total_bytes(IoPriority::kFlush));
+}
+
+TEST_F(IoSchedulerTest, Priority) {
+  FLAGS_io_scheduler_max_bytes_per_sec = 1_MB;
+  IoScheduler scheduler("disk");
+
+  // WAL writes do not wait, but the following requests wait until the charged tokens are repaid.
+  auto start = MonoTime::Now();
+  scheduler.Charge(IoPriority::kWal, 10_MB);
+  ASSERT_LT(MonoTime::Now() - start, MonoDelta::FromMilliseconds(50));
+
+  std::mutex mutex;
+  std::vector<IoPriority> order;
+  auto request = [&scheduler, &mutex, &order](IoPriority priority) {
+    scheduler.Request(priority, 1_KB);
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(priority);
+  };
+  std::thread compaction(request, IoPriority::kCompaction);
+  std::this_thread::sleep_for(20ms);
+  std::thread flush(request, IoPriority::kFlush);
+  compaction.join();
+  flush.join();
+
+  ASSERT_EQ((std::vector<IoPriority>{IoPriority::kFlush, IoPriority::kCompaction}), order);
+  ASSERT_GE(MonoTime::Now() - start, MonoDelta::FromMilliseconds(50));
+}
+
+TEST_F(IoSchedulerTest, AdaptsToSyncLatency) {
+  constexpr int64_t kMaxRate = 256_MB;
+  constexpr int64_t kMinRate = 16_MB;
+  FLAGS_io_scheduler_max_bytes_per_sec = kMaxRate;
+  FLAGS_io_scheduler_min_bytes_per_sec = kMinRate;
+  FLAGS_io_scheduler_target_sync_latency_ms = 20;
+  FLAGS_io_scheduler_adjust_interval_ms = 10;
+  IoScheduler scheduler("disk");
+  ASSERT_EQ(kMaxRate, scheduler.bytes_per_second());
+
+  auto report = [&scheduler](MonoDelta latency, int times) {
+    for (int i = 0; i != times; ++i) {
+      std::this_thread::sleep_for(15ms);
+      scheduler.ReportSyncLatency(latency);
+    }
+  };
+
+  report(MonoDelta::FromMilliseconds(100), 1);
+  ASSERT_LT(scheduler.bytes_per_second(), kMaxRate);
+  report(MonoDelta::FromMilliseconds(100), 20);
+  ASSERT_EQ(kMinRate, scheduler.bytes_per_second());
+
+  report(MonoDelta::FromMilliseconds(1), 20);
+  ASSERT_EQ(kMaxRate, scheduler.bytes_per_second());
+}
+
+} // namespace yb
@@ -0,0 +1,177 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/io_scheduler.h"
+
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/size_literals.h"
+
+using namespace yb::size_literals;
+
+DEFINE_int64(io_scheduler_max_bytes_per_sec, 256_MB,
+             "Max write rate of a disk, shared by WAL appends, flushes, compactions and remote "
+             "bootstrap downloads that use the disk.");
+TAG_FLAG(io_scheduler_max_bytes_per_sec, runtime);
+
+DEFINE_int64(io_scheduler_min_bytes_per_sec, 16_MB,
+             "Write rate of a disk below which the I/O scheduler does not go while WAL syncs are "
+             "slow.");
+TAG_FLAG(io_scheduler_min_bytes_per_sec, runtime);
+
+DEFINE_int32(io_scheduler_target_sync_latency_ms, 20,
+             "Average WAL sync latency above which the I/O scheduler decreases the write rate of "
+             "the disk. Zero keeps the rate at io_scheduler_max_bytes_per_sec.");
+TAG_FLAG(io_scheduler_target_sync_latency_ms, runtime);
+
+DEFINE_int32(io_scheduler_adjust_interval_ms, 1000,
+             "Interval of changes of the write rate of a disk by the I/O scheduler.");
+TAG_FLAG(io_scheduler_adjust_interval_ms, runtime);
+
+namespace yb {
+
+namespace {
+
+constexpr auto kBurstPeriod = std::chrono::milliseconds(100);
+constexpr uint64_t kFairness = 10;
+
+int64_t MaxBytesPerSecond() {
+  return std::max<int64_t>(FLAGS_io_scheduler_max_bytes_per_sec, 1);
+}
+
+} // namespace
+
+struct IoScheduler::Waiter {
+};
+
+IoScheduler::IoScheduler(std::string dir)
+    : dir_(std::move(dir)), bytes_per_second_(MaxBytesPerSecond()),
+      last_refill_(CoarseMonoClock::Now()), adjust_start_(last_refill_) {
+  available_bytes_ = burst_bytes();
+  for (auto& bytes : total_bytes_) {
+    bytes.store(0, std::memory_order_release);
+  }
+}
+
+int64_t IoScheduler::burst_bytes() const {
+  return std::max<int64_t>(
+      bytes_per_second() * ToMicroseconds(kBurstPeriod) / MonoTime::kMicrosecondsPerSecond, 1);
+}
+
+void IoScheduler::Request(IoPriority priority, size_t bytes) {
+  if (bytes == 0) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  Waiter waiter;
+  auto& queue = waiters_[to_underlying(priority)];
+  queue.push_back(&waiter);
+  for (;;) {
+    Refill(CoarseMonoClock::Now());
+    if (NextWaiter() != &waiter) {
+      // The request that is served first notifies the others when it is granted.
+      cond_.wait(lock);
+    } else if (available_bytes_ > 0) {
+      break;
+    } else {
+      auto wait_us = (1 - available_bytes_) * MonoTime::kMicrosecondsPerSecond /
+                     bytes_per_second() + 1;
+      cond_.wait_for(lock, std::chrono::microseconds(wait_us));
+    }
+  }
+  queue.pop_front();
+  Take(priority, bytes);
+  ++num_grants_;
+  lock.unlock();
+  cond_.notify_all();
+}
+
+void IoScheduler::Charge(IoPriority priority, size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Refill(CoarseMonoClock::Now());
+  Take(priority, bytes);
+}
+
+void IoScheduler::ReportSyncLatency(MonoDelta latency) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sync_latency_sum_us_ += latency.ToMicroseconds();
+  ++num_syncs_;
+  MaybeAdjustRate(CoarseMonoClock::Now());
+}
+
+void IoScheduler::Refill(CoarseTimePoint now) {
+  auto elapsed_us = ToMicroseconds(now - last_refill_);
+  if (elapsed_us <= 0) {
+    return;
+  }
+  last_refill_ = now;
+  available_bytes_ = std::min(
+      available_bytes_ + bytes_per_second() * elapsed_us / MonoTime::kMicrosecondsPerSecond,
+      burst_bytes());
+  MaybeAdjustRate(now);
+}
+
+void IoScheduler::MaybeAdjustRate(CoarseTimePoint now) {
+  if (now - adjust_start_ < std::chrono::milliseconds(FLAGS_io_scheduler_adjust_interval_ms)) {
+    return;
+  }
+  const auto max_rate = MaxBytesPerSecond();
+  const auto min_rate = std::min(
+      std::max<int64_t>(FLAGS_io_scheduler_min_bytes_per_sec, 1), max_rate);
+  const auto target_latency_us = FLAGS_io_scheduler_target_sync_latency_ms * 1000LL;
+  const auto old_rate = bytes_per_second();
+  auto rate = old_rate;
+  if (target_latency_us <= 0) {
+    rate = max_rate;
+  } else if (num_syncs_ && sync_latency_sum_us_ / static_cast<int64_t>(num_syncs_) >
+                 target_latency_us) {
+    // Decrease multiplicatively and increase additively, so the rate backs off quickly when the
+    // disk is saturated and does not oscillate around the saturation point.
+    rate = rate * 3 / 4;
+  } else {
+    rate += max_rate / 16;
+  }
+  rate = std::max(std::min(rate, max_rate), min_rate);
+  if (rate != old_rate) {
+    VLOG(1) << dir_ << ": changed write rate from " << old_rate << " to " << rate
+            << " bytes/s, syncs: " << num_syncs_ << ", sync latency sum: "
+            << sync_latency_sum_us_ << "us";
+    bytes_per_second_.store(rate, std::memory_order_release);
+  }
+  adjust_start_ = now;
+  sync_latency_sum_us_ = 0;
+  num_syncs_ = 0;
+}
+
+void IoScheduler::Take(IoPriority priority, size_t bytes) {
+  available_bytes_ = std::max<int64_t>(available_bytes_ - bytes, -burst_bytes());
+  total_bytes_[to_underlying(priority)].fetch_add(bytes, std::memory_order_acq_rel);
+}
+
+IoScheduler::Waiter* IoScheduler::NextWaiter() const {
+  // Every kFairness-th grant goes to the least important waiting class, so it is not starved.
+  const bool least_important = num_grants_ % kFairness == kFairness - 1;
+  Waiter* result = nullptr;
+  for (const auto& queue : waiters_) {
+    if (!queue.empty()) {
+      result = queue.front();
+      if (!least_important) {
+        break;
+      }
+    }
+  }
+  return result;
+}
+
+} // namespace yb
@@ -0,0 +1,102 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_IO_SCHEDULER_H
+#define YB_UTIL_IO_SCHEDULER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+
+#include "yb/util/enums.h"
+#include "yb/util/monotime.h"
+
+namespace yb {
+
+// Classes of disk I/O, from the most to the least important one.
+YB_DEFINE_ENUM(IoPriority, (kWal)(kFlush)(kCompaction)(kBootstrap));
+
+// Shares the write bandwidth of a disk between the classes of I/O that use it.
+//
+// The bandwidth is a token bucket. WAL writes are charged to the bucket but never wait for it,
+// while the other classes wait until the bucket has tokens, and the most important waiting class
+// is served first. So compaction bursts are throttled before they inflate WAL latency.
+//
+// The rate of the bucket adapts to the device: it is decreased while the average latency of WAL
+// syncs is above --io_scheduler_target_sync_latency_ms and increased back otherwise, within
+// [--io_scheduler_min_bytes_per_sec, --io_scheduler_max_bytes_per_sec].
+class IoScheduler {
+ public:
+  explicit IoScheduler(std::string dir);
+
+  IoScheduler(const IoScheduler&) = delete;
+  void operator=(const IoScheduler&) = delete;
+
+  // Waits until the bucket has tokens and no more important request waits, then takes bytes from
+  // the bucket. Requests larger than the burst are granted as a whole and pay back later.
+  void Request(IoPriority priority, size_t bytes);
+
+  // Takes bytes from the bucket without waiting, for I/O that should not be delayed.
+  void Charge(IoPriority priority, size_t bytes);
+
+  // Reports the latency of a sync of the WAL on this disk.
+  void ReportSyncLatency(MonoDelta latency);
+
+  // Max bytes granted by the bucket at once.
+  int64_t burst_bytes() const;
+
+  int64_t bytes_per_second() const {
+    return bytes_per_second_.load(std::memory_order_acquire);
+  }
+
+  uint64_t total_bytes(IoPriority priority) const {
+    return total_bytes_[to_underlying(priority)].load(std::memory_order_acquire);
+  }
+
+  const std::string& dir() const {
+    return dir_;
+  }
+
+ private:
+  struct Waiter;
+
+  void Refill(CoarseTimePoint now);
+  void MaybeAdjustRate(CoarseTimePoint now);
+  void Take(IoPriority priority, size_t bytes);
+  Waiter* NextWaiter() const;
+
+  const std::string dir_;
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::atomic<int64_t> bytes_per_second_;
+  // Could be negative after large requests and charges, down to minus burst.
+  int64_t available_bytes_;
+  CoarseTimePoint last_refill_;
+  std::array<std::deque<Waiter*>, kIoPriorityMapSize> waiters_;
+  // Number of granted requests, used to let less important classes through from time to time.
+  uint64_t num_grants_ = 0;
+
+  CoarseTimePoint adjust_start_;
+  int64_t sync_latency_sum_us_ = 0;
+  size_t num_syncs_ = 0;
+
+  std::array<std::atomic<uint64_t>, kIoPriorityMapSize> total_bytes_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_IO_SCHEDULER_H
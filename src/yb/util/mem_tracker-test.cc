@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -46,6 +47,7 @@
 
 DECLARE_int32(memory_limit_soft_percentage);
 DECLARE_int64(mem_tracker_update_consumption_interval_us);
+DECLARE_int64(mem_tracker_consumption_batch_bytes);
 
 namespace yb {
 
@@ -129,6 +131,49 @@ TEST(MemTrackerTest, TrackerHierarchy) {
   c2->Release(60);
 }
 
+TEST(MemTrackerTest, BatchedConsumption) {
+  FLAGS_mem_tracker_consumption_batch_bytes = 100;
+  auto p = MemTracker::CreateTracker(1000, "p");
+  auto c1 = MemTracker::CreateTracker("c1", p);
+  auto c2 = MemTracker::CreateTracker("c2", p);
+  FLAGS_mem_tracker_consumption_batch_bytes = 0;
+
+  // Changes below the batch size stay pending.
+  c1->Consume(60);
+  EXPECT_EQ(c1->consumption(), 0);
+  EXPECT_EQ(p->consumption(), 0);
+
+  // Once the batch size is reached, the whole batch is applied.
+  c1->Consume(50);
+  EXPECT_EQ(c1->consumption(), 110);
+  EXPECT_EQ(p->consumption(), 110);
+
+  c1->Release(30);
+  EXPECT_EQ(c1->consumption(), 110);
+  EXPECT_EQ(c1->GetUpdatedConsumption(), 80);
+  EXPECT_EQ(p->consumption(), 80);
+
+  // TryConsume applies pending changes before checking the limit of the ancestor.
+  c2->Consume(90);
+  EXPECT_EQ(p->consumption(), 80);
+  EXPECT_FALSE(c2->TryConsume(850));
+  EXPECT_EQ(c2->consumption(), 90);
+  EXPECT_EQ(p->consumption(), 170);
+  EXPECT_TRUE(c2->TryConsume(830));
+  EXPECT_EQ(p->consumption(), 1000);
+
+  // Changes made by other threads are applied when the tracker is flushed.
+  std::thread([c1] { c1->Release(80); }).join();
+  EXPECT_EQ(p->consumption(), 1000);
+  c1->FlushPendingConsumption();
+  EXPECT_EQ(c1->consumption(), 0);
+  EXPECT_EQ(p->consumption(), 920);
+
+  c2->Release(920);
+  c2->FlushPendingConsumption();
+  EXPECT_EQ(p->consumption(), 0);
+}
+
 namespace {
 
 class GcTest : public GarbageCollector {
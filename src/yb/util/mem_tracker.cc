@@ -33,6 +33,7 @@
 #include "yb/util/mem_tracker.h"
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <limits>
 #include <list>
@@ -102,6 +103,15 @@ DEFINE_int64(mem_tracker_update_consumption_interval_us, 2000000,
              "Interval that is used to update memory consumption from external source. "
              "For instance from tcmalloc statistics.");
 
+DEFINE_int64(mem_tracker_consumption_batch_bytes, 0,
+             "When positive, consumption changes of a non-root memory tracker are accumulated "
+             "per thread, and only applied to the tracker and its ancestors once the accumulated "
+             "change of the thread reaches this value. Makes memory accounting cheaper, at the "
+             "cost of tracker consumption lagging behind. Trackers with limits, or whose "
+             "ancestors have limits, apply their pending changes before checking the limits in "
+             "TryConsume. Only affects trackers created after the flag is set.");
+TAG_FLAG(mem_tracker_consumption_batch_bytes, advanced);
+
 namespace yb {
 
 // NOTE: this class has been adapted from Impala, so the code style varies
@@ -167,6 +177,13 @@ void IncrementBy(int64_t amount, HighWaterMark* consumption,
   }
 }
 
+// Index of the stripe of MemTracker::PendingConsumption used by the current thread.
+size_t CurrentThreadStripe() {
+  static std::atomic<size_t> next_stripe{0};
+  static thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed);
+  return stripe;
+}
+
 std::string CreateMetricName(const MemTracker& mem_tracker) {
   if (mem_tracker.metric_entity() &&
         (!mem_tracker.parent() ||
@@ -282,12 +299,63 @@ shared_ptr<MemTracker> MemTracker::CreateChild(int64_t byte_limit,
   return result;
 }
 
+// Consumption changes of a tracker, split into stripes that are padded to a cache line, so threads
+// using different stripes do not contend.
+class MemTracker::PendingConsumption {
+ public:
+  static constexpr size_t kNumStripes = 16;
+
+  // The stripes should be aligned to a cache line, that new does not guarantee before C++17.
+  static void* operator new(size_t size) {
+    void* result = nullptr;
+    int err = posix_memalign(&result, CACHELINE_SIZE, size);
+    CHECK_EQ(0, err) << "error calling posix_memalign";
+    return result;
+  }
+
+  static void operator delete(void* ptr) {
+    free(ptr);
+  }
+
+  // Adds delta to the stripe of the current thread. Returns true and takes the accumulated value
+  // of the stripe into *to_apply when its absolute value reaches batch_bytes.
+  bool Add(int64_t delta, int64_t batch_bytes, int64_t* to_apply) {
+    auto& value = stripes_[CurrentThreadStripe() % kNumStripes].value;
+    auto pending = value.fetch_add(delta, std::memory_order_relaxed) + delta;
+    if (std::abs(pending) < batch_bytes) {
+      return false;
+    }
+    *to_apply = value.exchange(0, std::memory_order_relaxed);
+    return *to_apply != 0;
+  }
+
+  // Takes the accumulated value of all stripes.
+  int64_t TakeAll() {
+    int64_t result = 0;
+    for (auto& stripe : stripes_) {
+      if (stripe.value.load(std::memory_order_relaxed) != 0) {
+        result += stripe.value.exchange(0, std::memory_order_relaxed);
+      }
+    }
+    return result;
+  }
+
+ private:
+  struct Stripe {
+    std::atomic<int64_t> value{0};
+    char padding[CACHELINE_SIZE - sizeof(std::atomic<int64_t>)];
+  };
+
+  Stripe stripes_[kNumStripes];
+};
+
 MemTracker::MemTracker(int64_t byte_limit, const string& id, shared_ptr<MemTracker> parent,
                        AddToParent add_to_parent, CreateMetrics create_metrics)
     : limit_(byte_limit),
       id_(id),
       descr_(Substitute("memory consumption for $0", id)),
       parent_(std::move(parent)),
+      consumption_batch_bytes_(FLAGS_mem_tracker_consumption_batch_bytes),
       rand_(GetRandomSeed32()),
       enable_logging_(FLAGS_mem_tracker_logging),
       log_stack_(FLAGS_mem_tracker_log_stack_trace),
@@ -296,6 +364,10 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id, shared_ptr<MemTrack
   UpdateConsumption();
   soft_limit_ = (limit_ == -1)
       ? -1 : (limit_ * FLAGS_memory_limit_soft_percentage) / 100;
+  // The root tracker is not batched, since it could take its consumption from tcmalloc.
+  if (parent_ && consumption_batch_bytes_ > 0) {
+    pending_consumption_.reset(new PendingConsumption);
+  }
 
   all_trackers_.push_back(this);
   if (has_limit()) {
@@ -321,6 +393,7 @@ MemTracker::MemTracker(int64_t byte_limit, const string& id, shared_ptr<MemTrack
 
 MemTracker::~MemTracker() {
   VLOG(1) << "Destroying tracker " << ToString();
+  FlushPendingConsumption();
   if (parent_) {
     DCHECK_EQ(consumption(), 0) << "Memory tracker " << ToString();
     if (add_to_parent_) {
@@ -457,19 +530,54 @@ void MemTracker::Consume(int64_t bytes) {
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
+  if (pending_consumption_ &&
+      !pending_consumption_->Add(bytes, consumption_batch_bytes_, &bytes)) {
+    return;
+  }
+  ChangeConsumption(bytes);
+}
+
+void MemTracker::ChangeConsumption(int64_t delta) {
   for (auto& tracker : all_trackers_) {
     if (!tracker->UpdateConsumption()) {
-      IncrementBy(bytes, &tracker->consumption_, tracker->metrics_);
-      DCHECK_GE(tracker->consumption_.current_value(), 0);
+      IncrementBy(delta, &tracker->consumption_, tracker->metrics_);
+      // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
+      // reported amount, the subsequent call to FunctionContext::Free() may cause the
+      // process mem tracker to go negative until it is synced back to the tcmalloc
+      // metric. Don't blow up in this case. (Note that this doesn't affect non-process
+      // trackers since we can enforce that the reported memory usage is internally
+      // consistent.)
+      // With batching, memory consumed on one thread and released on another could make the
+      // consumption negative until the consuming thread applies its batch.
+      DCHECK(pending_consumption_ || tracker->consumption_.current_value() >= 0)
+          << "Tracker: " << tracker->ToString();
     }
   }
 }
 
+void MemTracker::FlushPendingConsumption() {
+  if (!pending_consumption_) {
+    return;
+  }
+  auto delta = pending_consumption_->TakeAll();
+  if (delta != 0) {
+    ChangeConsumption(delta);
+  }
+}
+
 bool MemTracker::TryConsume(int64_t bytes, MemTracker** blocking_mem_tracker) {
   UpdateConsumption();
   if (bytes <= 0) {
     return true;
   }
+  if (pending_consumption_) {
+    if (limit_trackers_.empty()) {
+      Consume(bytes);
+      return true;
+    }
+    // Make the limit checks below see all consumption of this tracker.
+    FlushPendingConsumption();
+  }
   if (PREDICT_FALSE(enable_logging_)) {
     LogUpdate(true, bytes);
   }
@@ -542,18 +650,12 @@ void MemTracker::Release(int64_t bytes) {
     LogUpdate(false, bytes);
   }
 
-  for (auto& tracker : all_trackers_) {
-    if (!tracker->UpdateConsumption()) {
-      IncrementBy(-bytes, &tracker->consumption_, tracker->metrics_);
-      // If a UDF calls FunctionContext::TrackAllocation() but allocates less than the
-      // reported amount, the subsequent call to FunctionContext::Free() may cause the
-      // process mem tracker to go negative until it is synced back to the tcmalloc
-      // metric. Don't blow up in this case. (Note that this doesn't affect non-process
-      // trackers since we can enforce that the reported memory usage is internally
-      // consistent.)
-      DCHECK_GE(tracker->consumption_.current_value(), 0) << "Tracker: " << tracker->ToString();
-    }
+  int64_t delta = -bytes;
+  if (pending_consumption_ &&
+      !pending_consumption_->Add(delta, consumption_batch_bytes_, &delta)) {
+    return;
   }
+  ChangeConsumption(delta);
 }
 
 bool MemTracker::AnyLimitExceeded() {
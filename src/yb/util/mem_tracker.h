@@ -300,9 +300,14 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   int64_t GetUpdatedConsumption() {
     UpdateConsumption();
+    FlushPendingConsumption();
     return consumption();
   }
 
+  // Propagates the consumption changes of this tracker that were batched, see
+  // FLAGS_mem_tracker_consumption_batch_bytes, to this tracker and its ancestors.
+  void FlushPendingConsumption();
+
   // Note that if consumption_ is based on consumption_func_, this
   // will be the max value we've recorded in consumption(), not
   // necessarily the highest value consumption_func_ has ever
@@ -359,6 +364,9 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
   // Logs the stack of the current consume/release. Used for debugging only.
   void LogUpdate(bool is_consume, int64_t bytes) const;
 
+  // Changes consumption of this tracker and its ancestors by 'delta', without limit checks.
+  void ChangeConsumption(int64_t delta);
+
   // Variant of CreateTracker() that:
   // 1. Must be called with a non-NULL parent, and
   // 2. Must be called with parent->child_trackers_lock_ held.
@@ -396,6 +404,12 @@ class MemTracker : public std::enable_shared_from_this<MemTracker> {
 
   HighWaterMark consumption_{0};
 
+  // Consumption changes not yet applied to consumption_ of this tracker and its ancestors,
+  // accumulated per thread. Null when changes are applied immediately.
+  class PendingConsumption;
+  const int64_t consumption_batch_bytes_;
+  std::unique_ptr<PendingConsumption> pending_consumption_;
+
   // this tracker plus all of its ancestors
   std::vector<MemTracker*> all_trackers_;
   // all_trackers_ with valid limits
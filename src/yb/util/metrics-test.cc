@@ -53,6 +53,8 @@ DECLARE_int32(metrics_retirement_age_ms);
 
 namespace yb {
 
+METRIC_DECLARE_entity(server);
+
 METRIC_DEFINE_entity(test_entity);
 
 class MetricsTest : public YBTest {
@@ -173,11 +175,11 @@ TEST_F(MetricsTest, SimpleHistogramTest) {
   scoped_refptr<Histogram> hist = METRIC_test_hist.Instantiate(entity_);
   hist->Increment(2);
   hist->IncrementBy(4, 1);
-  ASSERT_EQ(2, hist->histogram_->MinValue());
-  ASSERT_EQ(3, hist->histogram_->MeanValue());
-  ASSERT_EQ(4, hist->histogram_->MaxValue());
-  ASSERT_EQ(2, hist->histogram_->TotalCount());
-  ASSERT_EQ(6, hist->histogram_->TotalSum());
+  ASSERT_EQ(2, hist->histogram()->MinValue());
+  ASSERT_EQ(3, hist->histogram()->MeanValue());
+  ASSERT_EQ(4, hist->histogram()->MaxValue());
+  ASSERT_EQ(2, hist->histogram()->TotalCount());
+  ASSERT_EQ(6, hist->histogram()->TotalSum());
   // TODO: Test coverage needs to be improved a lot.
 }
 
@@ -282,6 +284,70 @@ TEST_F(MetricsTest, TestInstantiatingDifferentEntities) {
   ASSERT_NE(new_entity.get(), entity_.get());
 }
 
+METRIC_DEFINE_counter(server, test_server_counter, "Test Server Counter", MetricUnit::kRequests,
+                      "Test counter of the server entity");
+
+TEST_F(MetricsTest, PrometheusWriter) {
+  const MetricEntity::AttributeMap tablet1 = {
+      {"table_id", "t1"}, {"table_name", "table1"}, {"metric_id", "tablet1"}};
+  const MetricEntity::AttributeMap tablet2 = {
+      {"table_id", "t1"}, {"table_name", "table1"}, {"metric_id", "tablet2"}};
+
+  const string kTableAttrs = "table_id=\"t1\",table_name=\"table1\"}";
+
+  // Tablet metrics are summed up per table, including the first tablet of the table.
+  std::stringstream out;
+  {
+    PrometheusWriter writer(&out);
+    ASSERT_OK(writer.WriteSingleEntry(tablet1, "rows", 2));
+    ASSERT_OK(writer.WriteSingleEntry(tablet2, "rows", 3));
+    ASSERT_OK(writer.WriteSingleEntry(tablet2, "empty", 0));
+    ASSERT_EQ("", out.str());
+    ASSERT_OK(writer.FlushAggregatedValues());
+  }
+  ASSERT_STR_CONTAINS(out.str(), "rows{metric_id=\"tablet1\"," + kTableAttrs + " 5 ");
+  ASSERT_STR_CONTAINS(out.str(), "empty{");
+  ASSERT_EQ(string::npos, out.str().find("tablet2"));
+
+  // Not aggregated, skipping zeros, filtered by name.
+  out.str("");
+  {
+    MetricPrometheusOptions opts;
+    opts.metrics = {"row", "other"};
+    opts.aggregate_tablets = false;
+    opts.skip_zero_values = true;
+    PrometheusWriter writer(&out, opts);
+    ASSERT_OK(writer.WriteSingleEntry(tablet1, "rows", 2));
+    ASSERT_OK(writer.WriteSingleEntry(tablet2, "rows", 3));
+    ASSERT_OK(writer.WriteSingleEntry(tablet2, "rows_empty", 0));
+    ASSERT_OK(writer.WriteSingleEntry(tablet2, "filtered", 1));
+    ASSERT_OK(writer.FlushAggregatedValues());
+  }
+  ASSERT_STR_CONTAINS(out.str(), "metric_id=\"tablet1\"," + kTableAttrs + " 2 ");
+  ASSERT_STR_CONTAINS(out.str(), "metric_id=\"tablet2\"," + kTableAttrs + " 3 ");
+  ASSERT_EQ(string::npos, out.str().find("rows_empty"));
+  ASSERT_EQ(string::npos, out.str().find("filtered"));
+
+  // Entities are filtered by type or id.
+  auto server = METRIC_ENTITY_server.Instantiate(&registry_, "my-server");
+  METRIC_test_server_counter.Instantiate(server)->IncrementBy(7);
+  for (const auto& entities : std::vector<std::vector<string>>{{}, {"server"}, {"my-serv"}}) {
+    out.str("");
+    MetricPrometheusOptions opts;
+    opts.entities = entities;
+    PrometheusWriter writer(&out, opts);
+    ASSERT_OK(registry_.WriteForPrometheus(&writer));
+    ASSERT_STR_CONTAINS(out.str(), "test_server_counter{");
+    ASSERT_STR_CONTAINS(out.str(), "metric_id=\"my-server\"");
+  }
+  out.str("");
+  MetricPrometheusOptions opts;
+  opts.entities = {"tablet"};
+  PrometheusWriter writer(&out, opts);
+  ASSERT_OK(registry_.WriteForPrometheus(&writer));
+  ASSERT_EQ("", out.str());
+}
+
 TEST_F(MetricsTest, TestDumpJsonPrototypes) {
   // Dump the prototype info.
   std::stringstream out;
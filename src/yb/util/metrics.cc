@@ -57,6 +57,13 @@ DEFINE_int32(metrics_retirement_age_ms, 120 * 1000,
 TAG_FLAG(metrics_retirement_age_ms, runtime);
 TAG_FLAG(metrics_retirement_age_ms, advanced);
 
+DEFINE_int32(histogram_shards, 4,
+             "Number of shards of each histogram metric. Threads recording values in a histogram "
+             "are spread over its shards, that are merged when the histogram is read. Shards are "
+             "created on first use, each of them takes as much memory as an unsharded histogram. "
+             "Affects histograms created after the flag is set. (Advanced option)");
+TAG_FLAG(histogram_shards, advanced);
+
 // TODO: changed to empty string and add logic to get this from cluster_uuid in case empty.
 DEFINE_string(metric_node_name, "DEFAULT_NODE_NAME",
               "Value to use as node name for metrics reporting");
@@ -285,6 +292,12 @@ Status MetricEntity::WriteAsJson(JsonWriter* writer,
 }
 
 CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const {
+  const auto& requested_entities = writer->options().entities;
+  if (!requested_entities.empty() && !MatchMetricInList(prototype_->name(), requested_entities) &&
+      !MatchMetricInList(id_, requested_entities)) {
+    return Status::OK();
+  }
+
   // We want the keys to be in alphabetical order when printing, so we use an ordered map here.
   typedef std::map<const char*, scoped_refptr<Metric> > OrderedMetricMap;
   OrderedMetricMap metrics;
@@ -309,6 +322,9 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
   if (strcmp(prototype_->name(), "tablet") == 0)  {
     prometheus_attr["table_id"] = attrs["table_id"];
     prometheus_attr["table_name"] = attrs["table_name"];
+    if (!writer->options().aggregate_tablets) {
+      prometheus_attr["metric_id"] = id_;
+    }
   } else if (strcmp(prototype_->name(), "server") == 0 ||
       strcmp(prototype_->name(), "cluster") == 0) {
     prometheus_attr = attrs;
@@ -328,7 +344,7 @@ CHECKED_STATUS MetricEntity::WriteForPrometheus(PrometheusWriter* writer) const
   }
   // Run the external metrics collection callback if there is one set.
   for (const ExternalPrometheusMetricsCb& cb : external_metrics_cbs) {
-    cb(writer);
+    cb(writer, prometheus_attr);
   }
 
   return Status::OK();
@@ -436,6 +452,10 @@ Status MetricRegistry::WriteAsJson(JsonWriter* writer,
   return Status::OK();
 }
 
+bool PrometheusWriter::IsMetricRequested(const std::string& name) const {
+  return opts_.metrics.empty() || MatchMetricInList(name, opts_.metrics);
+}
+
 CHECKED_STATUS MetricRegistry::WriteForPrometheus(PrometheusWriter* writer) const {
   EntityMap entities;
   {
@@ -725,15 +745,63 @@ scoped_refptr<Histogram> HistogramPrototype::Instantiate(
 
 Histogram::Histogram(const HistogramPrototype* proto)
   : Metric(proto),
-    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())) {
+    histogram_(new HdrHistogram(proto->max_trackable_value(), proto->num_sig_digits())),
+    num_shards_(std::max(FLAGS_histogram_shards, 1) - 1),
+    shards_(new std::atomic<HdrHistogram*>[num_shards_]) {
+  for (size_t i = 0; i != num_shards_; ++i) {
+    shards_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+Histogram::~Histogram() {
+  for (size_t i = 0; i != num_shards_; ++i) {
+    delete shards_[i].load(std::memory_order_acquire);
+  }
+}
+
+HdrHistogram* Histogram::ShardForCurrentThread() {
+  static std::atomic<size_t> next_thread_index{0};
+  static thread_local size_t thread_index = next_thread_index.fetch_add(
+      1, std::memory_order_relaxed);
+
+  size_t index = thread_index % (num_shards_ + 1);
+  if (index == 0) {
+    return histogram_.get();
+  }
+  auto& shard = shards_[index - 1];
+  auto* result = shard.load(std::memory_order_acquire);
+  if (PREDICT_TRUE(result != nullptr)) {
+    return result;
+  }
+  std::unique_ptr<HdrHistogram> new_shard(new HdrHistogram(
+      histogram_->highest_trackable_value(), histogram_->num_significant_digits()));
+  if (shard.compare_exchange_strong(result, new_shard.get(), std::memory_order_acq_rel)) {
+    return new_shard.release();
+  }
+  // Another thread has created the shard.
+  return result;
+}
+
+void Histogram::MergeShards() const {
+  for (size_t i = 0; i != num_shards_; ++i) {
+    auto* shard = shards_[i].load(std::memory_order_acquire);
+    if (shard) {
+      histogram_->MoveDataFrom(shard);
+    }
+  }
+}
+
+const HdrHistogram* Histogram::histogram() const {
+  MergeShards();
+  return histogram_.get();
 }
 
 void Histogram::Increment(int64_t value) {
-  histogram_->Increment(value);
+  ShardForCurrentThread()->Increment(value);
 }
 
 void Histogram::IncrementBy(int64_t value, int64_t amount) {
-  histogram_->IncrementBy(value, amount);
+  ShardForCurrentThread()->IncrementBy(value, amount);
 }
 
 Status Histogram::WriteAsJson(JsonWriter* writer,
@@ -747,7 +815,8 @@ Status Histogram::WriteAsJson(JsonWriter* writer,
 
 CHECKED_STATUS Histogram::WriteForPrometheus(
     PrometheusWriter* writer, const MetricEntity::AttributeMap& attr) const {
-  HdrHistogram snapshot(*histogram_);
+  // Sum and count are read without copying the buckets of the histogram.
+  const HdrHistogram& snapshot = *histogram();
 
   // Representing the sum and count require suffixed names.
   std::string hist_name = prototype_->name();
@@ -780,7 +849,7 @@ CHECKED_STATUS Histogram::WriteForPrometheus(
 
 Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
                                          const MetricJsonOptions& opts) const {
-  HdrHistogram snapshot(*histogram_);
+  HdrHistogram snapshot(*histogram());
   snapshot_pb->set_name(prototype_->name());
   if (opts.include_schema_info) {
     snapshot_pb->set_type(MetricType::Name(prototype_->type()));
@@ -814,22 +883,22 @@ Status Histogram::GetHistogramSnapshotPB(HistogramSnapshotPB* snapshot_pb,
 }
 
 uint64_t Histogram::CountInBucketForValueForTests(uint64_t value) const {
-  return histogram_->CountInBucketForValue(value);
+  return histogram()->CountInBucketForValue(value);
 }
 
 uint64_t Histogram::TotalCount() const {
-  return histogram_->TotalCount();
+  return histogram()->TotalCount();
 }
 
 uint64_t Histogram::MinValueForTests() const {
-  return histogram_->MinValue();
+  return histogram()->MinValue();
 }
 
 uint64_t Histogram::MaxValueForTests() const {
-  return histogram_->MaxValue();
+  return histogram()->MaxValue();
 }
 double Histogram::MeanValueForTests() const {
-  return histogram_->MeanValue();
+  return histogram()->MeanValue();
 }
 
 ScopedLatencyMetric::ScopedLatencyMetric(
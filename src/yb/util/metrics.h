@@ -239,6 +239,7 @@
 /////////////////////////////////////////////////////
 
 #include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <sstream>
@@ -442,6 +443,23 @@ struct MetricJsonOptions {
   bool include_schema_info;
 };
 
+struct MetricPrometheusOptions {
+  // Only metrics with names containing one of these strings are written, "*" matches all of
+  // them. All metrics are written if empty.
+  std::vector<std::string> metrics;
+
+  // Only entities with type or id containing one of these strings are written, "*" matches
+  // all of them. All entities are written if empty.
+  std::vector<std::string> entities;
+
+  // Metrics of tablets are summed up per table, instead of written per tablet.
+  bool aggregate_tablets = true;
+
+  // Skip metrics with zero value, i.e. counters that were never incremented and histograms
+  // without samples. Saves most of the output on servers with many idle tablets.
+  bool skip_zero_values = false;
+};
+
 class MetricEntityPrototype {
  public:
   explicit MetricEntityPrototype(const char* name);
@@ -475,7 +493,8 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
   typedef std::unordered_map<std::string, std::string> AttributeMap;
   typedef std::function<void (JsonWriter* writer, const MetricJsonOptions& opts)>
     ExternalJsonMetricsCb;
-  typedef std::function<void (PrometheusWriter* writer)>
+  // Called with the attributes of the entity, that should be used for the written metrics.
+  typedef std::function<void (PrometheusWriter* writer, const AttributeMap& attrs)>
     ExternalPrometheusMetricsCb;
 
   scoped_refptr<Counter> FindOrCreateCounter(const CounterPrototype* proto);
@@ -582,28 +601,36 @@ class MetricEntity : public RefCountedThreadSafe<MetricEntity> {
 
 typedef scoped_refptr<MetricEntity> MetricEntityPtr;
 
+// Writes metrics in the Prometheus text format. Metrics are written to the output as they come,
+// except of the aggregated tablet metrics, that are written by FlushAggregatedValues.
 class PrometheusWriter {
  public:
-  explicit PrometheusWriter(std::stringstream* output)
+  explicit PrometheusWriter(std::ostream* output,
+                            const MetricPrometheusOptions& opts = MetricPrometheusOptions())
     : output_(output),
+      opts_(opts),
       timestamp_(std::chrono::duration_cast<std::chrono::milliseconds>(
           std::chrono::system_clock::now().time_since_epoch()).count()) {}
 
   virtual ~PrometheusWriter() {}
 
+  const MetricPrometheusOptions& options() const { return opts_; }
+
   template<typename T>
   CHECKED_STATUS WriteSingleEntry(
       const MetricEntity::AttributeMap& attr, const std::string& name, const T& value) {
-    auto it = attr.find("table_id");
+    if ((opts_.skip_zero_values && value == 0) || !IsMetricRequested(name)) {
+      return Status::OK();
+    }
+    auto it = opts_.aggregate_tablets ? attr.find("table_id") : attr.end();
     if (it != attr.end()) {
       // For tablet level metrics, we roll up on the table level.
-      if (per_table_attributes_.find(it->second) == per_table_attributes_.end()) {
+      auto table_it = per_table_attributes_.find(it->second);
+      if (table_it == per_table_attributes_.end()) {
         // If it's the first time we see this table, create the aggregate structures.
-        per_table_attributes_[it->second] = attr;
-        per_table_values_[it->second];
-      } else {
-        per_table_values_[it->second][name] += value;
+        per_table_attributes_.emplace(it->second, attr);
       }
+      per_table_values_[it->second][name] += value;
     } else {
       // For non-tablet level metrics, export them directly.
       RETURN_NOT_OK(FlushSingleEntry(attr, name, value));
@@ -622,6 +649,8 @@ class PrometheusWriter {
   }
 
  private:
+  bool IsMetricRequested(const std::string& name) const;
+
   // FlushSingleEntry() was a function template with type of "value" as template
   // var T. To allow NMSWriter to override FlushSingleEntry(), the type of "value"
   // has been instantiated to int64_t.
@@ -641,7 +670,8 @@ class PrometheusWriter {
     }
     *output_ << " " << value;
     *output_ << " " << timestamp_;
-    *output_ << std::endl;
+    // Not std::endl, the output could be written to the connection on each flush.
+    *output_ << '\n';
     return Status::OK();
   }
 
@@ -650,7 +680,8 @@ class PrometheusWriter {
   // Map from table_id to map of metric_name to value
   std::map<std::string, std::map<std::string, double>> per_table_values_;
   // Output stream
-  std::stringstream* output_;
+  std::ostream* output_;
+  const MetricPrometheusOptions opts_;
   // Timestamp for all metrics belonging to this writer instance.
   int64_t timestamp_;
 };
@@ -1218,9 +1249,9 @@ class Histogram : public Metric {
                                 const MetricJsonOptions& opts) const;
 
 
-  // Returns a pointer to the underlying histogram. The implementation of HdrHistogram
-  //   // is thread safe.
-  const HdrHistogram* histogram() const { return histogram_.get(); }
+  // Returns a pointer to the underlying histogram, after merging the shards into it. The
+  // implementation of HdrHistogram is thread safe.
+  const HdrHistogram* histogram() const;
 
   uint64_t CountInBucketForValueForTests(uint64_t value) const;
   uint64_t MinValueForTests() const;
@@ -1231,8 +1262,21 @@ class Histogram : public Metric {
   FRIEND_TEST(MetricsTest, SimpleHistogramTest);
   friend class MetricEntity;
   explicit Histogram(const HistogramPrototype* proto);
+  ~Histogram();
 
+  // Returns the histogram that records the values of the current thread.
+  HdrHistogram* ShardForCurrentThread();
+
+  // Moves the values recorded in the shards to histogram_.
+  void MergeShards() const;
+
+  // All reads go through histogram_, it also serves as the first shard.
   const gscoped_ptr<HdrHistogram> histogram_;
+
+  // Other shards, so threads recording values do not contend on the same counters. Shards are
+  // created on first use, see FLAGS_histogram_shards.
+  const size_t num_shards_;
+  std::unique_ptr<std::atomic<HdrHistogram*>[]> shards_;
   DISALLOW_COPY_AND_ASSIGN(Histogram);
 };
 
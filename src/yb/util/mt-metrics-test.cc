@@ -30,7 +30,9 @@
 // under the License.
 //
 
+#include <atomic>
 #include <functional>
+#include <thread>
 #include <vector>
 
 #include <gflags/gflags.h>
@@ -40,6 +42,7 @@
 #include "yb/gutil/ref_counted.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/util/debug/leakcheck_disabler.h"
+#include "yb/util/hdr_histogram.h"
 #include "yb/util/jsonwriter.h"
 #include "yb/util/metrics.h"
 #include "yb/util/monotime.h"
@@ -98,6 +101,40 @@ TEST_F(MultiThreadedMetricsTest, CounterIncrementTest) {
   ASSERT_EQ(num_threads * num_increments, counter->value());
 }
 
+METRIC_DEFINE_histogram(test_entity, test_histogram, "Test Histogram",
+                        MetricUnit::kMicroseconds, "Test histogram", 1000000, 2);
+
+// Ensure that values recorded in the histogram shards by different threads are all merged, also
+// while the histogram is read concurrently.
+TEST_F(MultiThreadedMetricsTest, HistogramIncrementTest) {
+  scoped_refptr<MetricEntity> entity = METRIC_ENTITY_test_entity.Instantiate(&registry_, "hist");
+  scoped_refptr<Histogram> histogram = METRIC_test_histogram.Instantiate(entity);
+  int num_threads = FLAGS_mt_metrics_test_num_threads;
+  int num_increments = 1000;
+
+  std::atomic<bool> stop(false);
+  std::thread reader([histogram, &stop] {
+    while (!stop.load()) {
+      histogram->TotalCount();
+    }
+  });
+  std::function<void()> f = [histogram, num_increments] {
+    for (int i = 1; i <= num_increments; ++i) {
+      histogram->Increment(i);
+    }
+  };
+  RunWithManyThreads(&f, num_threads);
+  stop.store(true);
+  reader.join();
+
+  ASSERT_EQ(num_threads * num_increments, histogram->TotalCount());
+  ASSERT_EQ(num_threads * num_increments * (num_increments + 1) / 2,
+            histogram->histogram()->TotalSum());
+  ASSERT_EQ(1, histogram->MinValueForTests());
+  ASSERT_EQ(num_increments, histogram->MaxValueForTests());
+  ASSERT_EQ(num_threads, histogram->CountInBucketForValueForTests(1));
+}
+
 // Helper function to register a bunch of counters in a loop.
 void MultiThreadedMetricsTest::RegisterCounters(
     const scoped_refptr<MetricEntity>& metric_entity,
@@ -71,4 +71,14 @@ TEST(OsUtilTest, TestSelfNameWithParens) {
   RunTest("a(b(c((d))e)", 111, 222, 333);
 }
 
+TEST(OsUtilTest, ParseCpuList) {
+  ASSERT_EQ(std::vector<int>(), ASSERT_RESULT(ParseCpuList("")));
+  ASSERT_EQ(std::vector<int>({3}), ASSERT_RESULT(ParseCpuList("3")));
+  ASSERT_EQ(std::vector<int>({0, 1, 2, 3, 8, 10, 11}),
+            ASSERT_RESULT(ParseCpuList("0-3,8,10-11")));
+  for (const auto* bad : {"a", "3-1", "1-2-3", "-1", "1,,x"}) {
+    ASSERT_NOK(ParseCpuList(bad)) << bad;
+  }
+}
+
 } // namespace yb
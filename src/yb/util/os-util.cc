@@ -42,8 +42,11 @@
 #include <sstream>
 #include <string>
 #include <vector>
+#include <sched.h>
 #include <unistd.h>
 
+#include <glog/logging.h>
+
 #include "yb/gutil/strings/numbers.h"
 #include "yb/gutil/strings/split.h"
 #include "yb/gutil/strings/substitute.h"
@@ -159,4 +162,54 @@ bool RunShellProcess(const string& cmd, string* msg) {
   return false;
 }
 
+Result<std::vector<int>> ParseCpuList(const std::string& cpu_list) {
+  std::vector<int> result;
+  for (const auto& range : Split(cpu_list, ",", strings::SkipWhitespace())) {
+    std::vector<std::string> bounds = Split(range, "-");
+    int32_t first = 0, last = 0;
+    if (bounds.size() > 2 || !safe_strto32(bounds[0], &first) ||
+        !safe_strto32(bounds.back(), &last) || first < 0 || last < first) {
+      return STATUS_FORMAT(
+          InvalidArgument, "Invalid cpu range '$0' in '$1'", range.ToString(), cpu_list);
+    }
+    for (auto cpu = first; cpu <= last; ++cpu) {
+      result.push_back(cpu);
+    }
+  }
+  return result;
+}
+
+std::vector<int> CpuListFromFlag(const std::string& cpu_list) {
+  auto result = ParseCpuList(cpu_list);
+  return result.ok() ? std::move(*result) : std::vector<int>();
+}
+
+bool ValidateCpuListFlag(const char* flag_name, const std::string& cpu_list) {
+  auto cpus = ParseCpuList(cpu_list);
+  if (cpus.ok()) {
+    return true;
+  }
+  LOG(ERROR) << flag_name << " value " << cpu_list << " is invalid: " << cpus.status();
+  return false;
+}
+
+Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus) {
+#if defined(__linux__)
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    if (cpu >= CPU_SETSIZE) {
+      return STATUS_FORMAT(InvalidArgument, "Cpu $0 is out of range", cpu);
+    }
+    CPU_SET(cpu, &cpu_set);
+  }
+  if (sched_setaffinity(0 /* current thread */, sizeof(cpu_set), &cpu_set) != 0) {
+    return STATUS_FORMAT(IOError, "Failed to set affinity to $0: $1", cpus, ErrnoToString(errno));
+  }
+  return Status::OK();
+#else
+  return STATUS(NotSupported, "Thread cpu affinity is supported only on Linux");
+#endif
+}
+
 } // namespace yb
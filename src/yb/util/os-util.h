@@ -38,7 +38,9 @@
 #define YB_UTIL_OS_UTIL_H
 
 #include <string>
+#include <vector>
 
+#include "yb/util/result.h"
 #include "yb/util/status.h"
 
 namespace yb {
@@ -74,6 +76,22 @@ Status GetThreadStats(int64_t tid, ThreadStats* stats);
 // first 1k of output otherwise.
 bool RunShellProcess(const std::string& cmd, std::string* msg);
 
+// Parses list of cpus in the format used by taskset(1), i.e. "0-3,8,10-11".
+// Empty string is parsed to empty list.
+Result<std::vector<int>> ParseCpuList(const std::string& cpu_list);
+
+// Returns parsed cpu list or empty list if it is invalid, for values of flags
+// validated by ValidateCpuListFlag.
+std::vector<int> CpuListFromFlag(const std::string& cpu_list);
+
+// Flag validator for cpu lists.
+bool ValidateCpuListFlag(const char* flag_name, const std::string& cpu_list);
+
+// Restricts current thread to run only on specified cpus.
+// When memory is allocated with the default NUMA policy its pages are placed on the node of the
+// thread that touches them first, so such thread also gets local memory for its own buffers.
+Status SetCurrentThreadCpuAffinity(const std::vector<int>& cpus);
+
 } // namespace yb
 
 #endif /* YB_UTIL_OS_UTIL_H */
@@ -85,7 +85,6 @@ using google::protobuf::Message;
 using google::protobuf::MessageLite;
 using google::protobuf::Reflection;
 using google::protobuf::SimpleDescriptorDatabase;
-using yb::crc::Crc;
 using yb::pb_util::internal::SequentialFileFileInputStream;
 using yb::pb_util::internal::WritableFileOutputStream;
 using std::deque;
@@ -505,11 +504,9 @@ Status ReadablePBContainerFile::ReadNextPB(Message* msg) {
   }
 
   // Validate CRC32C checksum.
-  Crc* crc32c = crc::GetCrc32cInstance();
-  uint64_t actual_checksum = 0;
   // Compute a rolling checksum over the two byte arrays (size, body).
-  crc32c->Compute(size.data(), size.size(), &actual_checksum);
-  crc32c->Compute(body.data(), body.size(), &actual_checksum);
+  uint32_t actual_checksum = crc::Crc32cExtend(0, size.data(), size.size());
+  actual_checksum = crc::Crc32cExtend(actual_checksum, body.data(), body.size());
   if (PREDICT_FALSE(actual_checksum != expected_checksum)) {
     return STATUS(Corruption, Substitute("Incorrect checksum of file $0: actually $1, expected $2",
                                          reader_->filename(), actual_checksum, expected_checksum));
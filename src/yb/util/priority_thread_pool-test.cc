@@ -0,0 +1,169 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/format.h"
+#include "yb/util/priority_thread_pool.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+namespace {
+
+typedef std::function<void(const Status&, PriorityThreadPoolSuspender*)> TestTaskFunctor;
+
+class TestTask : public PriorityThreadPoolTask {
+ public:
+  TestTask(void* owner, int priority, TestTaskFunctor functor)
+      : owner_(owner), priority_(priority), functor_(std::move(functor)) {}
+
+  void Run(const Status& status, PriorityThreadPoolSuspender* suspender) override {
+    functor_(status, suspender);
+  }
+
+  int Priority() const override {
+    return priority_;
+  }
+
+  bool BelongsTo(void* key) const override {
+    return key == owner_;
+  }
+
+  std::string ToString() const override {
+    return Format("TestTask { priority: $0 }", priority_);
+  }
+
+ private:
+  void* const owner_;
+  const int priority_;
+  TestTaskFunctor functor_;
+};
+
+class PriorityThreadPoolTest : public YBTest {
+ protected:
+  void Submit(int priority, TestTaskFunctor functor, void* owner = nullptr) {
+    std::unique_ptr<PriorityThreadPoolTask> task(new TestTask(owner, priority, std::move(functor)));
+    ASSERT_OK(pool_.Submit(&task));
+  }
+
+  // Submits task that records its priority.
+  void SubmitRecording(int priority, void* owner = nullptr) {
+    Submit(priority, [this, priority](const Status& status, PriorityThreadPoolSuspender*) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      order_.push_back(status.ok() ? priority : -priority);
+    }, owner);
+  }
+
+  CHECKED_STATUS WaitCompleted(size_t num_tasks) {
+    return WaitFor([this, num_tasks]() -> Result<bool> { return order().size() == num_tasks; },
+                   MonoDelta::FromSeconds(10), Format("$0 tasks completed", num_tasks));
+  }
+
+  std::vector<int> order() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return order_;
+  }
+
+  PriorityThreadPool pool_{1};
+  std::mutex mutex_;
+  std::vector<int> order_;
+};
+
+} // namespace
+
+TEST_F(PriorityThreadPoolTest, Priority) {
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  Submit(0, [&started, &release](const Status& status, PriorityThreadPoolSuspender*) {
+    started.CountDown();
+    release.Wait();
+  });
+  started.Wait();
+
+  SubmitRecording(1);
+  SubmitRecording(3);
+  SubmitRecording(2);
+  SubmitRecording(3);
+  release.CountDown();
+
+  ASSERT_OK(WaitCompleted(4));
+  ASSERT_EQ((std::vector<int>{3, 3, 2, 1}), order());
+}
+
+TEST_F(PriorityThreadPoolTest, Pause) {
+  std::atomic<bool> high_priority_done(false);
+  CountDownLatch started(1);
+  std::atomic<bool> low_priority_done(false);
+  Submit(0, [&](const Status& status, PriorityThreadPoolSuspender* suspender) {
+    started.CountDown();
+    while (!high_priority_done.load()) {
+      suspender->PauseIfNecessary();
+    }
+    low_priority_done = true;
+  });
+  started.Wait();
+
+  // Task with the same priority does not preempt the running one.
+  CountDownLatch same_priority_done(1);
+  Submit(0, [&same_priority_done](const Status& status, PriorityThreadPoolSuspender*) {
+    same_priority_done.CountDown();
+  });
+
+  // High priority task is run while the low priority task is paused.
+  Submit(1, [&](const Status& status, PriorityThreadPoolSuspender*) {
+    ASSERT_FALSE(low_priority_done.load());
+    high_priority_done = true;
+  });
+
+  ASSERT_OK(WaitFor([&low_priority_done]() -> Result<bool> { return low_priority_done.load(); },
+                    MonoDelta::FromSeconds(10), "Low priority task done"));
+  ASSERT_TRUE(high_priority_done.load());
+  same_priority_done.Wait();
+}
+
+TEST_F(PriorityThreadPoolTest, RemoveAndShutdown) {
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  Submit(0, [&started, &release](const Status& status, PriorityThreadPoolSuspender*) {
+    started.CountDown();
+    release.Wait();
+  });
+  started.Wait();
+
+  int owner1 = 0;
+  int owner2 = 0;
+  SubmitRecording(1, &owner1);
+  SubmitRecording(2, &owner2);
+  SubmitRecording(3, &owner1);
+  ASSERT_EQ(2, pool_.Remove(&owner1));
+  ASSERT_EQ(0, pool_.Remove(&owner1));
+
+  std::thread shutdown_thread([this] { pool_.Shutdown(); });
+  // Not started tasks are aborted during shutdown.
+  ASSERT_OK(WaitCompleted(1));
+  ASSERT_EQ((std::vector<int>{-2}), order());
+  release.CountDown();
+  shutdown_thread.join();
+
+  std::unique_ptr<PriorityThreadPoolTask> task(new TestTask(nullptr, 0, TestTaskFunctor()));
+  ASSERT_NOK(pool_.Submit(&task));
+  ASSERT_NE(nullptr, task);
+}
+
+} // namespace yb
@@ -0,0 +1,209 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/priority_thread_pool.h"
+
+#include <algorithm>
+
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/thread.h"
+
+namespace yb {
+
+struct PriorityThreadPool::TaskEntry : public PriorityThreadPoolSuspender {
+  TaskEntry(PriorityThreadPool* pool_, std::unique_ptr<PriorityThreadPoolTask> task_,
+            size_t serial_no_)
+      : pool(pool_), task(std::move(task_)), serial_no(serial_no_) {}
+
+  void PauseIfNecessary() override {
+    pool->Pause(this);
+  }
+
+  PriorityThreadPool* const pool;
+  std::unique_ptr<PriorityThreadPoolTask> task;
+  // Used to run tasks with the same priority in the submission order.
+  const size_t serial_no;
+};
+
+class PriorityThreadPool::Worker {
+ public:
+  scoped_refptr<Thread> thread;
+};
+
+PriorityThreadPool::PriorityThreadPool(size_t max_running_tasks)
+    : max_running_tasks_(std::max<size_t>(max_running_tasks, 1)) {
+}
+
+PriorityThreadPool::~PriorityThreadPool() {
+  Shutdown();
+}
+
+Status PriorityThreadPool::Submit(std::unique_ptr<PriorityThreadPoolTask>* task) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopping_) {
+    return STATUS(ServiceUnavailable, "Pool is shutting down");
+  }
+  queued_.emplace_back(new TaskEntry(this, std::move(*task), ++next_serial_no_));
+  if (idle_workers_ == 0 && running_tasks_ < max_running_tasks_) {
+    EnsureWorkerUnlocked();
+    if (workers_.empty()) {
+      *task = std::move(queued_.back()->task);
+      queued_.pop_back();
+      return STATUS(RuntimeError, "Failed to start worker thread");
+    }
+  }
+  cond_.notify_all();
+  return Status::OK();
+}
+
+size_t PriorityThreadPool::Remove(void* key) {
+  std::vector<std::unique_ptr<TaskEntry>> removed;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::stable_partition(
+        queued_.begin(), queued_.end(),
+        [key](const auto& entry) { return !entry->task->BelongsTo(key); });
+    removed.insert(removed.end(), std::make_move_iterator(it),
+                   std::make_move_iterator(queued_.end()));
+    queued_.erase(it, queued_.end());
+  }
+  return removed.size();
+}
+
+void PriorityThreadPool::Shutdown() {
+  std::vector<std::unique_ptr<TaskEntry>> aborted;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+    stopping_ = true;
+    aborted.swap(queued_);
+    cond_.notify_all();
+  }
+  const auto status = STATUS(Aborted, "Pool is shutting down");
+  for (const auto& entry : aborted) {
+    entry->task->Run(status, nullptr);
+  }
+  // Workers are not created after stopping_ is set, so it is safe to access workers_ here.
+  for (const auto& worker : workers_) {
+    worker->thread->Join();
+  }
+}
+
+void PriorityThreadPool::WorkerMain() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    if (stopping_) {
+      return;
+    }
+    auto* entry = running_tasks_ < max_running_tasks_ ? PickTaskUnlocked() : nullptr;
+    // Paused task resumes by itself, so only queued task could be started here.
+    auto it = std::find_if(
+        queued_.begin(), queued_.end(), [entry](const auto& e) { return e.get() == entry; });
+    if (it == queued_.end()) {
+      ++idle_workers_;
+      cond_.wait(lock);
+      --idle_workers_;
+      continue;
+    }
+    std::unique_ptr<TaskEntry> task = std::move(*it);
+    queued_.erase(it);
+    ++running_tasks_;
+    lock.unlock();
+    VLOG(3) << "Starting " << task->task->ToString();
+    task->task->Run(Status::OK(), task.get());
+    task.reset();
+    lock.lock();
+    --running_tasks_;
+    cond_.notify_all();
+  }
+}
+
+PriorityThreadPool::TaskEntry* PriorityThreadPool::PickTaskUnlocked() {
+  TaskEntry* result = nullptr;
+  int result_priority = 0;
+  auto check = [&result, &result_priority](TaskEntry* entry) {
+    auto priority = entry->task->Priority();
+    if (!result || priority > result_priority ||
+        (priority == result_priority && entry->serial_no < result->serial_no)) {
+      result = entry;
+      result_priority = priority;
+    }
+  };
+  for (auto* entry : paused_) {
+    check(entry);
+  }
+  for (const auto& entry : queued_) {
+    check(entry.get());
+  }
+  return result;
+}
+
+void PriorityThreadPool::EnsureWorkerUnlocked() {
+  if (stopping_ || idle_workers_ != 0 || queued_.empty()) {
+    return;
+  }
+  std::unique_ptr<Worker> worker(new Worker);
+  auto status = Thread::Create(
+      "priority_thread_pool", Format("worker-$0", workers_.size()),
+      &PriorityThreadPool::WorkerMain, this, &worker->thread);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to start worker: " << status;
+    return;
+  }
+  workers_.push_back(std::move(worker));
+}
+
+void PriorityThreadPool::Pause(TaskEntry* entry) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (stopping_ || (queued_.empty() && paused_.empty())) {
+    return;
+  }
+  if (running_tasks_ < max_running_tasks_) {
+    // There is a free slot, so waiting task does not need the slot of this one.
+    EnsureWorkerUnlocked();
+    return;
+  }
+  // Paused task should give the slot only to a task that has strictly greater priority,
+  // otherwise tasks with the same priority would switch forever.
+  const auto priority = entry->task->Priority();
+  auto* best = PickTaskUnlocked();
+  if (best->task->Priority() <= priority) {
+    return;
+  }
+  VLOG(2) << "Pausing " << entry->task->ToString() << " in favor of " << best->task->ToString();
+  paused_.push_back(entry);
+  --running_tasks_;
+  EnsureWorkerUnlocked();
+  cond_.notify_all();
+  cond_.wait(lock, [this, entry] {
+    return stopping_ || (running_tasks_ < max_running_tasks_ && PickTaskUnlocked() == entry);
+  });
+  paused_.erase(std::find(paused_.begin(), paused_.end(), entry));
+  ++running_tasks_;
+  VLOG(2) << "Resuming " << entry->task->ToString();
+  // Other paused tasks could wait for this one to be removed from paused_.
+  cond_.notify_all();
+}
+
+std::string PriorityThreadPool::StateToString() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Format("{ max_running_tasks: $0 running_tasks: $1 queued_tasks: $2 paused_tasks: $3 "
+                    "workers: $4 idle_workers: $5 }",
+                max_running_tasks_, running_tasks_, queued_.size(), paused_.size(),
+                workers_.size(), idle_workers_);
+}
+
+} // namespace yb
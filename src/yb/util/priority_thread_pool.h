@@ -0,0 +1,121 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_PRIORITY_THREAD_POOL_H
+#define YB_UTIL_PRIORITY_THREAD_POOL_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+
+// Allows running task to pause itself, when there are tasks with higher priority waiting for
+// a free slot in the pool.
+class PriorityThreadPoolSuspender {
+ public:
+  // Blocks the caller while there are tasks with higher priority that could use its slot.
+  virtual void PauseIfNecessary() = 0;
+
+ protected:
+  ~PriorityThreadPoolSuspender() {}
+};
+
+class PriorityThreadPoolTask {
+ public:
+  virtual ~PriorityThreadPoolTask() {}
+
+  // If status is not OK, then the task was aborted before it was started, i.e. the pool is being
+  // shut down, and suspender is null.
+  virtual void Run(const Status& status, PriorityThreadPoolSuspender* suspender) = 0;
+
+  // Current priority of the task, tasks with greater priority are run first. The priority could
+  // change over time, so it is evaluated every time the pool picks the next task to run.
+  // It is invoked while the pool mutex is held, so it should be cheap and should not acquire
+  // locks that could be held while submitting tasks to the pool.
+  virtual int Priority() const = 0;
+
+  // Returns true if the task was submitted by the specified owner, used by Remove.
+  virtual bool BelongsTo(void* key) const = 0;
+
+  virtual std::string ToString() const = 0;
+};
+
+// A thread pool that runs at most max_running_tasks tasks at the same time, picking the task
+// with the highest priority when a slot becomes free. Running task could pause itself using
+// suspender, giving its slot to a task with higher priority. Paused task is resumed when it
+// becomes the task with the highest priority and there is a free slot.
+//
+// Each running or paused task occupies its own thread, so the number of threads could exceed
+// max_running_tasks.
+class PriorityThreadPool {
+ public:
+  explicit PriorityThreadPool(size_t max_running_tasks);
+  ~PriorityThreadPool();
+
+  PriorityThreadPool(const PriorityThreadPool&) = delete;
+  void operator=(const PriorityThreadPool&) = delete;
+
+  // Submits the task to the pool. When submit fails the task is not run.
+  CHECKED_STATUS Submit(std::unique_ptr<PriorityThreadPoolTask>* task);
+
+  // Removes all tasks that belong to the specified key and were not started yet, returns the
+  // number of removed tasks. Removed tasks are destroyed without running them.
+  size_t Remove(void* key);
+
+  // Aborts all not started tasks and waits until running tasks complete.
+  void Shutdown();
+
+  size_t max_running_tasks() const {
+    return max_running_tasks_;
+  }
+
+  std::string StateToString();
+
+ private:
+  class Worker;
+  struct TaskEntry;
+
+  void WorkerMain();
+
+  // Returns queued or paused task with the highest priority.
+  TaskEntry* PickTaskUnlocked();
+
+  // Starts new worker if there is a queued task that could be started, but there are no idle
+  // workers to start it.
+  void EnsureWorkerUnlocked();
+
+  void Pause(TaskEntry* entry);
+
+  const size_t max_running_tasks_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool stopping_ = false;
+  size_t running_tasks_ = 0;
+  size_t idle_workers_ = 0;
+  size_t next_serial_no_ = 0;
+  std::vector<std::unique_ptr<TaskEntry>> queued_;
+  std::vector<TaskEntry*> paused_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_PRIORITY_THREAD_POOL_H
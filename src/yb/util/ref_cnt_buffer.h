@@ -88,6 +88,12 @@ class RefCntBuffer {
 
   void Reset() { DoReset(nullptr); }
 
+  // Reduces size of the buffer, allocated memory is not released.
+  void Shrink(size_t new_size) {
+    DCHECK_LE(new_size, size());
+    size_reference() = new_size;
+  }
+
   explicit operator bool() const {
     return data_ != nullptr;
   }
@@ -36,7 +36,9 @@
 #include <mutex>
 
 #include "yb/gutil/map-util.h"
+#include "yb/gutil/walltime.h"
 #include "yb/util/env.h"
+#include "yb/util/spinlock_profiling.h"
 
 using std::lock_guard;
 
@@ -103,7 +105,13 @@ RWMutex::~RWMutex() {
 
 void RWMutex::ReadLock() {
   CheckLockState(LockState::NEITHER);
-  int rv = pthread_rwlock_rdlock(&native_handle_);
+  int rv = pthread_rwlock_tryrdlock(&native_handle_);
+  if (rv == EBUSY) {
+    // Only contended acquisitions are timed, for the contention profile.
+    int64_t wait_start = CycleClock::Now();
+    rv = pthread_rwlock_rdlock(&native_handle_);
+    SubmitLockContention(this, CycleClock::Now() - wait_start);
+  }
   DCHECK_EQ(0, rv) << strerror(rv);
   MarkForReading();
 }
@@ -127,7 +135,12 @@ bool RWMutex::TryReadLock() {
 
 void RWMutex::WriteLock() {
   CheckLockState(LockState::NEITHER);
-  int rv = pthread_rwlock_wrlock(&native_handle_);
+  int rv = pthread_rwlock_trywrlock(&native_handle_);
+  if (rv == EBUSY) {
+    int64_t wait_start = CycleClock::Now();
+    rv = pthread_rwlock_wrlock(&native_handle_);
+    SubmitLockContention(this, CycleClock::Now() - wait_start);
+  }
   DCHECK_EQ(0, rv) << strerror(rv);
   MarkForWriting();
 }
@@ -0,0 +1,96 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/sampled_trace.h"
+#include "yb/util/test_util.h"
+#include "yb/util/trace.h"
+
+DECLARE_int32(sampled_trace_events_per_thread);
+
+namespace yb {
+
+class SampledTraceTest : public YBTest {
+};
+
+TEST_F(SampledTraceTest, CaptureSlowRequest) {
+  FLAGS_sampled_trace_capture_threshold_ms = 10;
+
+  scoped_refptr<Trace> slow_trace(new Trace);
+  scoped_refptr<Trace> other_trace(new Trace);
+  auto start = MonoTime::Now();
+  {
+    ADOPT_TRACE(slow_trace.get());
+    SAMPLED_TRACE("test.first", 1);
+    std::thread([&slow_trace] {
+      SAMPLED_TRACE_TO(slow_trace, "test.second", 2);
+    }).join();
+    SAMPLED_TRACE_TO(other_trace, "test.other", 3);
+    SleepFor(MonoDelta::FromMilliseconds(20));
+    SAMPLED_TRACE("test.third", 4);
+  }
+
+  // Fast requests are not captured.
+  SampledTrace::CaptureIfSlow(other_trace->id(), start, start, [] { return "fast"; });
+  SampledTrace::CaptureIfSlow(slow_trace->id(), start, MonoTime::Now(), [] { return "slow"; });
+
+  auto captured = SampledTrace::CapturedRequests();
+  ASSERT_FALSE(captured.empty());
+  const auto& request = captured.front();
+  ASSERT_EQ("slow", request.description);
+  ASSERT_GE(request.latency.ToMilliseconds(), 20);
+  ASSERT_EQ(3, request.events.size());
+  ASSERT_STREQ("test.first", request.events[0].name);
+  ASSERT_EQ(1, request.events[0].payload);
+  ASSERT_STREQ("test.second", request.events[1].name);
+  ASSERT_NE(request.events[0].buffer_index, request.events[1].buffer_index);
+  ASSERT_STREQ("test.third", request.events[2].name);
+  ASSERT_EQ(request.events[0].buffer_index, request.events[2].buffer_index);
+
+  std::stringstream out;
+  SampledTrace::DumpCaptured(&out);
+  ASSERT_NE(std::string::npos, out.str().find("test.second 2")) << out.str();
+}
+
+// Old events of a ring buffer are overwritten by new ones.
+TEST_F(SampledTraceTest, RingOverflow) {
+  FLAGS_sampled_trace_capture_threshold_ms = 0;
+  const int kEvents = FLAGS_sampled_trace_events_per_thread * 4;
+
+  scoped_refptr<Trace> trace(new Trace);
+  auto start = MonoTime::Now();
+  std::thread([&trace, kEvents] {
+    for (int i = 0; i != kEvents; ++i) {
+      SAMPLED_TRACE_TO(trace, "test.event", i);
+    }
+  }).join();
+  SampledTrace::CaptureIfSlow(trace->id(), start, MonoTime::Now(), [] { return "overflow"; });
+
+  auto captured = SampledTrace::CapturedRequests();
+  ASSERT_FALSE(captured.empty());
+  const auto& events = captured.front().events;
+  ASSERT_LT(events.size(), kEvents);
+  ASSERT_FALSE(events.empty());
+  int64_t max_payload = 0;
+  for (const auto& event : events) {
+    max_payload = std::max(max_payload, event.payload);
+  }
+  ASSERT_EQ(kEvents - 1, max_payload);
+}
+
+} // namespace yb
@@ -0,0 +1,251 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/sampled_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+
+#include "yb/util/flag_tags.h"
+#include "yb/util/logging.h"
+#include "yb/util/trace.h"
+
+DEFINE_bool(enable_sampled_tracing, true,
+            "Record compact trace events to per-thread ring buffers, and keep the events of "
+            "requests slower than sampled_trace_capture_threshold_ms.");
+TAG_FLAG(enable_sampled_tracing, runtime);
+TAG_FLAG(enable_sampled_tracing, advanced);
+
+DEFINE_int32(sampled_trace_capture_threshold_ms, 1000,
+             "Requests that take longer than this have their sampled trace events kept, so they "
+             "could be dumped from /tracing/sampled_slow_requests.");
+TAG_FLAG(sampled_trace_capture_threshold_ms, runtime);
+TAG_FLAG(sampled_trace_capture_threshold_ms, advanced);
+
+DEFINE_int32(sampled_trace_events_per_thread, 1024,
+             "Size of the ring buffer of sampled trace events of each thread, rounded up to a "
+             "power of 2. Only affects threads that record their first event after it is set.");
+TAG_FLAG(sampled_trace_events_per_thread, advanced);
+
+DEFINE_int32(sampled_trace_max_captured_requests, 32,
+             "Number of most recent slow requests whose sampled trace events are kept.");
+TAG_FLAG(sampled_trace_max_captured_requests, runtime);
+TAG_FLAG(sampled_trace_max_captured_requests, advanced);
+
+namespace yb {
+
+namespace {
+
+// Ring buffer of events, written only by the thread that owns it, and read by Capture from any
+// thread. Each slot is protected by a sequence number: it is odd while the slot is being written.
+class EventRing {
+ public:
+  EventRing(size_t index, size_t capacity)
+      : index_(index), mask_(capacity - 1), slots_(new Slot[capacity]) {
+    DCHECK_EQ(capacity & mask_, 0);
+  }
+
+  size_t index() const { return index_; }
+
+  void Record(uint64_t trace_id, const char* name, int64_t payload) {
+    uint64_t position = next_position_.load(std::memory_order_relaxed);
+    next_position_.store(position + 1, std::memory_order_relaxed);
+    auto& slot = slots_[position & mask_];
+    slot.sequence.store(position * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.time.store(MonoTime::Now().ToUint64(), std::memory_order_relaxed);
+    slot.trace_id.store(trace_id, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.payload.store(payload, std::memory_order_relaxed);
+    slot.sequence.store(position * 2 + 2, std::memory_order_release);
+  }
+
+  // Appends events of the trace recorded between start and end to out.
+  void Collect(uint64_t trace_id, MonoTime start, MonoTime end,
+               std::vector<SampledTrace::Event>* out) const {
+    for (size_t i = 0; i <= mask_; ++i) {
+      const auto& slot = slots_[i];
+      auto sequence = slot.sequence.load(std::memory_order_acquire);
+      if (sequence == 0 || (sequence & 1) ||
+          slot.trace_id.load(std::memory_order_relaxed) != trace_id) {
+        continue;
+      }
+      auto time = MonoTime::FromUint64(slot.time.load(std::memory_order_relaxed));
+      auto name = slot.name.load(std::memory_order_relaxed);
+      auto payload = slot.payload.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+        // Overwritten while we were reading it.
+        continue;
+      }
+      if (time >= start && time <= end) {
+        out->push_back(SampledTrace::Event{time, name, payload, index_});
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> time{0};
+    std::atomic<uint64_t> trace_id{0};
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> payload{0};
+  };
+
+  const size_t index_;
+  const size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<uint64_t> next_position_{0};
+};
+
+// All the ring buffers. A ring buffer is never destroyed, when its thread exits it is reused by
+// the next new thread, so the number of ring buffers is bounded by the number of live threads.
+class EventRings {
+ public:
+  EventRing* Acquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      auto* result = free_.back();
+      free_.pop_back();
+      return result;
+    }
+    size_t capacity = 1;
+    while (capacity < static_cast<size_t>(
+               std::max(FLAGS_sampled_trace_events_per_thread, 1))) {
+      capacity <<= 1;
+    }
+    rings_.emplace_back(new EventRing(rings_.size(), capacity));
+    return rings_.back().get();
+  }
+
+  void Release(EventRing* ring) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(ring);
+  }
+
+  std::vector<EventRing*> List() {
+    std::vector<EventRing*> result;
+    std::lock_guard<std::mutex> lock(mutex_);
+    result.reserve(rings_.size());
+    for (const auto& ring : rings_) {
+      result.push_back(ring.get());
+    }
+    return result;
+  }
+
+  // Keeps the request, dropping the oldest ones above the limit.
+  void AddCaptured(SampledTrace::CapturedRequest request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    captured_.push_front(std::move(request));
+    while (captured_.size() >
+               static_cast<size_t>(std::max(FLAGS_sampled_trace_max_captured_requests, 0))) {
+      captured_.pop_back();
+    }
+  }
+
+  std::vector<SampledTrace::CapturedRequest> Captured() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::vector<SampledTrace::CapturedRequest>(captured_.begin(), captured_.end());
+  }
+
+  // Only one capture runs at a time, so a burst of slow requests does not make every thread
+  // scan all the ring buffers.
+  std::mutex capture_mutex;
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<EventRing>> rings_;
+  std::vector<EventRing*> free_;
+  std::deque<SampledTrace::CapturedRequest> captured_;
+};
+
+EventRings& Rings() {
+  // Never destroyed, threads could record events during shutdown.
+  static EventRings* rings = new EventRings;
+  return *rings;
+}
+
+// Returns the ring buffer of the current thread to the free list when the thread exits.
+class ThreadEventRing {
+ public:
+  ThreadEventRing() : ring_(Rings().Acquire()) {}
+
+  ~ThreadEventRing() {
+    Rings().Release(ring_);
+  }
+
+  EventRing* get() const { return ring_; }
+
+ private:
+  EventRing* const ring_;
+};
+
+} // namespace
+
+void SampledTrace::Record(uint64_t trace_id, const char* name, int64_t payload) {
+  static thread_local ThreadEventRing ring;
+  ring.get()->Record(trace_id, name, payload);
+}
+
+void SampledTrace::Record(const char* name, int64_t payload) {
+  auto* trace = Trace::CurrentTrace();
+  if (trace) {
+    Record(trace->id(), name, payload);
+  }
+}
+
+void SampledTrace::Capture(
+    uint64_t trace_id, MonoTime start, MonoTime end, std::string description) {
+  auto& rings = Rings();
+  std::unique_lock<std::mutex> capture_lock(rings.capture_mutex, std::try_to_lock);
+  if (!capture_lock.owns_lock()) {
+    VLOG(1) << "Skip capture of " << description << ", another capture is in progress";
+    return;
+  }
+
+  CapturedRequest request;
+  request.description = std::move(description);
+  request.start = start;
+  request.latency = end - start;
+  for (auto* ring : rings.List()) {
+    ring->Collect(trace_id, start, end, &request.events);
+  }
+  std::sort(request.events.begin(), request.events.end(), [](const Event& lhs, const Event& rhs) {
+    return lhs.time < rhs.time;
+  });
+  rings.AddCaptured(std::move(request));
+}
+
+std::vector<SampledTrace::CapturedRequest> SampledTrace::CapturedRequests() {
+  return Rings().Captured();
+}
+
+void SampledTrace::DumpCaptured(std::ostream* out) {
+  for (const auto& request : CapturedRequests()) {
+    *out << request.description << " took " << request.latency.ToMilliseconds() << "ms, "
+         << request.events.size() << " events:" << std::endl;
+    for (const auto& event : request.events) {
+      *out << "  +" << (event.time - request.start).ToMicroseconds() << "us"
+           << " [" << event.buffer_index << "] " << event.name << " " << event.payload
+           << std::endl;
+    }
+    *out << std::endl;
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,111 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SAMPLED_TRACE_H
+#define YB_UTIL_SAMPLED_TRACE_H
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <gflags/gflags.h>
+
+#include "yb/util/atomic.h"
+#include "yb/util/monotime.h"
+
+DECLARE_bool(enable_sampled_tracing);
+DECLARE_int32(sampled_trace_capture_threshold_ms);
+
+// Records a compact event for the trace adopted by the current thread, see ADOPT_TRACE.
+// 'name' must be a string literal, 'payload' is an integer that is dumped with the event.
+// Example:
+//  SAMPLED_TRACE("tablet.write_applied", batch_size);
+#define SAMPLED_TRACE(name, payload) \
+  do { \
+    if (GetAtomicFlag(&FLAGS_enable_sampled_tracing)) { \
+      yb::SampledTrace::Record("" name, (payload)); \
+    } \
+  } while (0)
+
+// Like the above, but takes the trace as an explicit argument.
+#define SAMPLED_TRACE_TO(trace, name, payload) \
+  do { \
+    if (GetAtomicFlag(&FLAGS_enable_sampled_tracing)) { \
+      yb::SampledTrace::Record((trace)->id(), "" name, (payload)); \
+    } \
+  } while (0)
+
+namespace yb {
+
+// Always-on tracing that is cheap enough to be left on in production.
+//
+// Unlike Trace, that formats a message for each entry and allocates it in the arena of the
+// request, every event is a fixed size record with a timestamp, a static name and an integer
+// payload. It is written to a preallocated ring buffer of the current thread, without locks and
+// without allocations, so old events are overwritten by new ones.
+//
+// When a request completes, CaptureIfSlow checks its latency. Only for requests that took longer
+// than FLAGS_sampled_trace_capture_threshold_ms, the events with the id of their trace are
+// collected from the ring buffers of all threads, and kept for DumpCaptured. So the recent slow
+// requests could be inspected at any time, even when FLAGS_enable_tracing is off.
+class SampledTrace {
+ public:
+  struct Event {
+    MonoTime time;
+    const char* name;
+    int64_t payload;
+    // Index of the ring buffer the event was recorded to, identifies the thread.
+    size_t buffer_index;
+  };
+
+  struct CapturedRequest {
+    std::string description;
+    MonoTime start;
+    MonoDelta latency;
+    std::vector<Event> events;
+  };
+
+  // Records the event to the ring buffer of the current thread, for the trace with the given id.
+  static void Record(uint64_t trace_id, const char* name, int64_t payload);
+
+  // Records the event for the trace adopted by the current thread, if there is one.
+  static void Record(const char* name, int64_t payload);
+
+  // Keeps the events of the trace when the request took longer than the threshold. 'describe' is
+  // only called in that case.
+  template <class Describe>
+  static void CaptureIfSlow(uint64_t trace_id, MonoTime start, MonoTime end,
+                            const Describe& describe) {
+    if (!GetAtomicFlag(&FLAGS_enable_sampled_tracing)) {
+      return;
+    }
+    auto latency = end - start;
+    if (latency.ToMilliseconds() < GetAtomicFlag(&FLAGS_sampled_trace_capture_threshold_ms)) {
+      return;
+    }
+    Capture(trace_id, start, end, describe());
+  }
+
+  // Collects the events of the trace recorded between start and end, and keeps them.
+  static void Capture(uint64_t trace_id, MonoTime start, MonoTime end, std::string description);
+
+  // Returns the captured requests, the most recent first.
+  static std::vector<CapturedRequest> CapturedRequests();
+
+  // Dumps the captured requests in a human-readable form.
+  static void DumpCaptured(std::ostream* out);
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SAMPLED_TRACE_H
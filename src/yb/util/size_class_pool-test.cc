@@ -0,0 +1,160 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/blocking_queue.h"
+#include "yb/util/size_class_pool.h"
+#include "yb/util/stopwatch.h"
+#include "yb/util/test_util.h"
+
+namespace yb {
+
+class SizeClassPoolTest : public YBTest {
+};
+
+namespace {
+
+// Approximate sizes of the objects allocated for each write: inbound call, block with request and
+// response protobufs, operation, operation state and operation driver.
+const std::vector<size_t> kWriteObjectSizes = {720, 1100, 320, 480, 250};
+
+class Pooled : public SizeClassPooled {
+ public:
+  virtual ~Pooled() {}
+  char data[100];
+};
+
+class DerivedPooled : public Pooled {
+ public:
+  char more_data[1000];
+};
+
+} // namespace
+
+TEST_F(SizeClassPoolTest, Reuse) {
+  for (size_t size : {0, 1, 64, 65, 1000, 4096}) {
+    void* block = SizeClassPool::Allocate(size);
+    memset(block, 0xff, size);
+    SizeClassPool::Free(block, size);
+    void* next = SizeClassPool::Allocate(size);
+#ifndef ADDRESS_SANITIZER
+    // The last freed block of the size class is reused.
+    ASSERT_EQ(block, next);
+#endif
+    SizeClassPool::Free(next, size);
+  }
+
+  // Large blocks are allocated with malloc.
+  auto system_allocations = SizeClassPool::SystemAllocations();
+  void* large = SizeClassPool::Allocate(SizeClassPool::kMaxSize + 1);
+  SizeClassPool::Free(large, SizeClassPool::kMaxSize + 1);
+  ASSERT_EQ(system_allocations + 1, SizeClassPool::SystemAllocations());
+
+  std::unique_ptr<Pooled> pooled(new DerivedPooled);
+  pooled.reset();
+  auto shared = std::allocate_shared<DerivedPooled>(SizeClassAllocator<DerivedPooled>());
+  shared.reset();
+}
+
+// Objects are allocated by one thread and freed by another, like calls allocated by a reactor and
+// destroyed by a worker. The blocks get back to the allocating thread through the central list.
+TEST_F(SizeClassPoolTest, CrossThread) {
+  constexpr int kBatches = 2000;
+  constexpr int kBatchSize = 100;
+  constexpr size_t kSize = 700;
+  BlockingQueue<std::vector<void*>*> queue(16);
+
+  std::thread consumer([&queue] {
+    std::vector<void*>* batch;
+    while (queue.BlockingGet(&batch)) {
+      for (void* block : *batch) {
+        SizeClassPool::Free(block, kSize);
+      }
+      delete batch;
+    }
+  });
+
+  auto system_allocations = SizeClassPool::SystemAllocations();
+  for (int i = 0; i != kBatches; ++i) {
+    auto* batch = new std::vector<void*>();
+    for (int j = 0; j != kBatchSize; ++j) {
+      batch->push_back(SizeClassPool::Allocate(kSize));
+    }
+    ASSERT_TRUE(queue.BlockingPut(batch));
+  }
+  queue.Shutdown();
+  consumer.join();
+  system_allocations = SizeClassPool::SystemAllocations() - system_allocations;
+  LOG(INFO) << "System allocations: " << system_allocations << " of " << kBatches * kBatchSize;
+#ifndef ADDRESS_SANITIZER
+  ASSERT_LT(system_allocations, kBatches * kBatchSize / 10);
+#endif
+}
+
+// Reports malloc calls per write and the time spent allocating the per-write objects, with and
+// without the pool.
+TEST_F(SizeClassPoolTest, WriteBenchmark) {
+  constexpr int kWrites = 1000000;
+  constexpr int kInFlight = 64;
+  std::vector<void*> in_flight(kInFlight * kWriteObjectSizes.size());
+
+  auto run = [&](bool pool) {
+    Stopwatch stopwatch(Stopwatch::ALL_THREADS);
+    stopwatch.start();
+    for (int i = 0; i != kWrites; ++i) {
+      auto* objects = &in_flight[(i % kInFlight) * kWriteObjectSizes.size()];
+      for (size_t j = 0; j != kWriteObjectSizes.size(); ++j) {
+        if (objects[j]) {
+          if (pool) {
+            SizeClassPool::Free(objects[j], kWriteObjectSizes[j]);
+          } else {
+            free(objects[j]);
+          }
+        }
+        objects[j] = pool ? SizeClassPool::Allocate(kWriteObjectSizes[j])
+                          : malloc(kWriteObjectSizes[j]);
+      }
+    }
+    for (size_t j = 0; j != in_flight.size(); ++j) {
+      if (pool) {
+        SizeClassPool::Free(in_flight[j], kWriteObjectSizes[j % kWriteObjectSizes.size()]);
+      } else {
+        free(in_flight[j]);
+      }
+      in_flight[j] = nullptr;
+    }
+    stopwatch.stop();
+    return stopwatch.elapsed().wall_seconds();
+  };
+
+  auto malloc_time = run(false);
+  auto system_allocations = SizeClassPool::SystemAllocations();
+  auto pool_time = run(true);
+  system_allocations = SizeClassPool::SystemAllocations() - system_allocations;
+  LOG(INFO) << "Malloc calls per write: " << kWriteObjectSizes.size() << " without pool, "
+            << static_cast<double>(system_allocations) / kWrites << " with pool";
+  LOG(INFO) << "Time: " << malloc_time << "s with malloc, " << pool_time << "s with pool";
+#ifndef ADDRESS_SANITIZER
+  ASSERT_LE(system_allocations, in_flight.size());
+#endif
+}
+
+} // namespace yb
@@ -0,0 +1,237 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/size_class_pool.h"
+
+#include <stdlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "yb/gutil/port.h"
+#include "yb/util/size_literals.h"
+
+namespace yb {
+
+namespace {
+
+constexpr size_t kSizeClassGranularity = 64;
+constexpr size_t kNumSizeClasses = SizeClassPool::kMaxSize / kSizeClassGranularity;
+
+// Bytes of free blocks of a single size class, cached by a thread.
+constexpr size_t kThreadCacheBytesPerClass = 64_KB;
+
+// Bytes of free blocks of a single size class, kept in the central list.
+constexpr size_t kCentralBytesPerClass = 4_MB;
+
+std::atomic<size_t> system_allocations{0};
+
+size_t SizeClass(size_t size) {
+  return size == 0 ? 0 : (size - 1) / kSizeClassGranularity;
+}
+
+size_t ClassSize(size_t size_class) {
+  return (size_class + 1) * kSizeClassGranularity;
+}
+
+size_t MaxThreadCachedBlocks(size_t size_class) {
+  return std::max<size_t>(8, kThreadCacheBytesPerClass / ClassSize(size_class));
+}
+
+void* SystemAllocate(size_t size) {
+  system_allocations.fetch_add(1, std::memory_order_relaxed);
+  void* result = malloc(size);
+  if (PREDICT_FALSE(!result)) {
+    throw std::bad_alloc();
+  }
+  return result;
+}
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+// Singly linked list of free blocks.
+struct FreeList {
+  FreeBlock* head = nullptr;
+  size_t size = 0;
+
+  void Push(void* block) {
+    auto* free_block = static_cast<FreeBlock*>(block);
+    free_block->next = head;
+    head = free_block;
+    ++size;
+  }
+
+  void* Pop() {
+    auto* result = head;
+    head = result->next;
+    --size;
+    return result;
+  }
+
+  // Moves the first count blocks to a new list.
+  FreeList Split(size_t count) {
+    FreeList result;
+    while (result.size != count) {
+      result.Push(Pop());
+    }
+    return result;
+  }
+
+  void FreeAll() {
+    while (head) {
+      free(Pop());
+    }
+  }
+};
+
+// Batches of free blocks, moved between threads.
+class CentralCache {
+ public:
+  void Push(size_t size_class, FreeList batch) {
+    auto& entry = entries_[size_class];
+    {
+      std::lock_guard<std::mutex> lock(entry.mutex);
+      if ((entry.num_blocks + batch.size) * ClassSize(size_class) <= kCentralBytesPerClass) {
+        entry.num_blocks += batch.size;
+        entry.batches.push_back(batch);
+        return;
+      }
+    }
+    batch.FreeAll();
+  }
+
+  bool Pop(size_t size_class, FreeList* batch) {
+    auto& entry = entries_[size_class];
+    std::lock_guard<std::mutex> lock(entry.mutex);
+    if (entry.batches.empty()) {
+      return false;
+    }
+    *batch = entry.batches.back();
+    entry.batches.pop_back();
+    entry.num_blocks -= batch->size;
+    return true;
+  }
+
+ private:
+  struct Entry {
+    std::mutex mutex;
+    std::vector<FreeList> batches;
+    size_t num_blocks = 0;
+  };
+
+  Entry entries_[kNumSizeClasses];
+};
+
+CentralCache& Central() {
+  // Never destroyed, blocks could be freed by other static destructors.
+  static CentralCache* central = new CentralCache;
+  return *central;
+}
+
+class ThreadCache;
+
+// Set while the cache of the current thread is alive, blocks allocated or freed during thread
+// exit bypass the pool.
+thread_local ThreadCache* thread_cache = nullptr;
+
+class ThreadCache {
+ public:
+  ThreadCache() {
+    thread_cache = this;
+  }
+
+  ~ThreadCache() {
+    thread_cache = nullptr;
+    for (size_t i = 0; i != kNumSizeClasses; ++i) {
+      if (lists_[i].size) {
+        Central().Push(i, lists_[i]);
+      }
+    }
+  }
+
+  void* Allocate(size_t size_class) {
+    auto& list = lists_[size_class];
+    if (PREDICT_FALSE(!list.head) && !Central().Pop(size_class, &list)) {
+      return SystemAllocate(ClassSize(size_class));
+    }
+    return list.Pop();
+  }
+
+  void Free(void* block, size_t size_class) {
+    auto& list = lists_[size_class];
+    list.Push(block);
+    auto max_blocks = MaxThreadCachedBlocks(size_class);
+    if (PREDICT_FALSE(list.size > max_blocks)) {
+      Central().Push(size_class, list.Split(max_blocks / 2));
+    }
+  }
+
+ private:
+  FreeList lists_[kNumSizeClasses];
+};
+
+ThreadCache* GetThreadCache() {
+  if (PREDICT_TRUE(thread_cache != nullptr)) {
+    return thread_cache;
+  }
+  // Constructed on first use by the thread, after destruction stays null.
+  static thread_local bool initialized = false;
+  if (initialized) {
+    return nullptr;
+  }
+  initialized = true;
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+} // namespace
+
+void* SizeClassPool::Allocate(size_t size) {
+#ifndef ADDRESS_SANITIZER
+  if (size <= kMaxSize) {
+    auto size_class = SizeClass(size);
+    auto* cache = GetThreadCache();
+    if (PREDICT_TRUE(cache != nullptr)) {
+      return cache->Allocate(size_class);
+    }
+    return SystemAllocate(ClassSize(size_class));
+  }
+#endif
+  return SystemAllocate(size);
+}
+
+void SizeClassPool::Free(void* block, size_t size) {
+  if (!block) {
+    return;
+  }
+#ifndef ADDRESS_SANITIZER
+  if (size <= kMaxSize) {
+    auto* cache = GetThreadCache();
+    if (PREDICT_TRUE(cache != nullptr)) {
+      cache->Free(block, SizeClass(size));
+      return;
+    }
+  }
+#endif
+  free(block);
+}
+
+size_t SizeClassPool::SystemAllocations() {
+  return system_allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace yb
@@ -0,0 +1,90 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_SIZE_CLASS_POOL_H
+#define YB_UTIL_SIZE_CLASS_POOL_H
+
+#include <stddef.h>
+
+#include <new>
+
+namespace yb {
+
+// Pool of memory blocks for objects that are allocated and freed once per operation, like RPC
+// calls and tablet operations.
+//
+// Block sizes are rounded up to a size class. Each thread caches free blocks of each size class,
+// so most allocations and frees do not touch shared state. When a thread frees more blocks than it
+// caches, for instance because objects are allocated by a reactor and freed by a worker, a batch of
+// blocks is moved to a central list, where the allocating thread takes it from.
+//
+// Blocks larger than kMaxSize are allocated with malloc. With ASAN, all the blocks are allocated
+// with malloc, so use after free is still detected.
+class SizeClassPool {
+ public:
+  static constexpr size_t kMaxSize = 4096;
+
+  static void* Allocate(size_t size);
+
+  // size should be the same as passed to Allocate.
+  static void Free(void* block, size_t size);
+
+  // Number of blocks that were allocated with malloc since the process start, i.e. allocations
+  // that could not be served from the pool.
+  static size_t SystemAllocations();
+};
+
+// Standard allocator, that allocates from SizeClassPool. Could be used with std::allocate_shared,
+// so the object and its control block are allocated as a single pooled block.
+template <class T>
+class SizeClassAllocator {
+ public:
+  typedef T value_type;
+
+  SizeClassAllocator() = default;
+
+  template <class U>
+  SizeClassAllocator(const SizeClassAllocator<U>&) {} // NOLINT
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(SizeClassPool::Allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* p, size_t n) {
+    SizeClassPool::Free(p, n * sizeof(T));
+  }
+
+  template <class U>
+  bool operator==(const SizeClassAllocator<U>&) const { return true; }
+
+  template <class U>
+  bool operator!=(const SizeClassAllocator<U>&) const { return false; }
+};
+
+// Base class that makes new and delete of the derived classes allocate from SizeClassPool.
+// Classes with a virtual destructor get the size of the actual object on delete, so a single base
+// class covers the whole hierarchy.
+class SizeClassPooled {
+ public:
+  static void* operator new(size_t size) {
+    return SizeClassPool::Allocate(size);
+  }
+
+  static void operator delete(void* block, size_t size) {
+    SizeClassPool::Free(block, size);
+  }
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_SIZE_CLASS_POOL_H
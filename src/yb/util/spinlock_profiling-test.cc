@@ -33,8 +33,11 @@
 #include <gtest/gtest.h>
 #include <glog/logging.h>
 #include <strstream>
+#include <thread>
 
 #include "yb/gutil/spinlock.h"
+#include "yb/util/mutex.h"
+#include "yb/util/rw_mutex.h"
 #include "yb/util/spinlock_profiling.h"
 #include "yb/util/test_util.h"
 #include "yb/util/trace.h"
@@ -86,4 +89,39 @@ TEST_F(SpinLockProfilingTest, TestStackCollection) {
   ASSERT_EQ(0, dropped);
 }
 
+// Blocking locks report their contention to the same profile as spinlocks.
+TEST_F(SpinLockProfilingTest, TestBlockingLockContention) {
+  int64_t dropped = 0;
+  std::vector<ContentionSample> samples;
+  CollectSynchronizationProfile(&samples, &dropped);
+  samples.clear();
+
+  StartSynchronizationProfiling();
+  Mutex mutex;
+  RWMutex rw_mutex;
+  mutex.Acquire();
+  rw_mutex.WriteLock();
+  std::thread thread([&mutex, &rw_mutex] {
+    mutex.Acquire();
+    mutex.Release();
+    rw_mutex.ReadLock();
+    rw_mutex.ReadUnlock();
+  });
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  mutex.Release();
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  rw_mutex.WriteUnlock();
+  thread.join();
+  StopSynchronizationProfiling();
+
+  CollectSynchronizationProfile(&samples, &dropped);
+  int64_t trip_count = 0;
+  for (const auto& sample : samples) {
+    ASSERT_GT(sample.stack.num_frames(), 0);
+    trip_count += sample.trip_count;
+  }
+  ASSERT_GE(trip_count, 2);
+  ASSERT_EQ(0, dropped);
+}
+
 } // namespace yb
@@ -97,6 +97,9 @@ class ContentionStacks {
   // the call have been flushed. However, new stacks can be added concurrently with this call.
   void Flush(std::stringstream* out, int64_t* dropped);
 
+  // Same as Flush, but appends the samples to 'samples'.
+  void Collect(std::vector<ContentionSample>* samples, int64_t* dropped);
+
  private:
 
   // Collect the next sample from the underlying buffer, and set it back to 0 count
@@ -199,6 +202,16 @@ void ContentionStacks::Flush(std::stringstream* out, int64_t* dropped) {
   *dropped += dropped_samples_.Exchange(0);
 }
 
+void ContentionStacks::Collect(std::vector<ContentionSample>* samples, int64_t* dropped) {
+  uint64_t iterator = 0;
+  ContentionSample sample;
+  while (CollectSample(&iterator, &sample.stack, &sample.trip_count, &sample.cycles)) {
+    samples->push_back(sample);
+  }
+
+  *dropped += dropped_samples_.Exchange(0);
+}
+
 bool ContentionStacks::CollectSample(uint64_t* iterator, StackTrace* s, int64_t* trip_count,
                                      int64_t* cycles) {
   while (*iterator < kNumEntries) {
@@ -222,7 +235,7 @@ bool ContentionStacks::CollectSample(uint64_t* iterator, StackTrace* s, int64_t*
 // Disable TSAN on this function.
 // https://yugabyte.atlassian.net/browse/ENG-354
 ATTRIBUTE_NO_SANITIZE_THREAD
-void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
+void SubmitLockProfileData(const void *contendedlock, int64 wait_cycles, bool spinlock) {
   bool profiling_enabled = base::subtle::Acquire_Load(&g_profiling_enabled);
   bool long_wait_time = wait_cycles > FLAGS_lock_contention_trace_threshold_cycles;
   // Short circuit this function quickly in the common case.
@@ -253,8 +266,9 @@ void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
     }
   }
 
-  LongAdder* la = reinterpret_cast<LongAdder*>(
-      base::subtle::Acquire_Load(reinterpret_cast<AtomicWord*>(&g_contended_cycles)));
+  // Only spinlocks are accounted in the spinlock_contention_time metric.
+  LongAdder* la = spinlock ? reinterpret_cast<LongAdder*>(
+      base::subtle::Acquire_Load(reinterpret_cast<AtomicWord*>(&g_contended_cycles))) : nullptr;
   if (la) {
     la->IncrementBy(wait_cycles);
   }
@@ -302,6 +316,14 @@ void FlushSynchronizationProfile(std::stringstream* out,
   CHECK_NOTNULL(g_contention_stacks)->Flush(out, drop_count);
 }
 
+void CollectSynchronizationProfile(std::vector<ContentionSample>* samples, int64_t* drop_count) {
+  CHECK_NOTNULL(g_contention_stacks)->Collect(samples, drop_count);
+}
+
+void SubmitLockContention(const void* lock, int64_t wait_cycles) {
+  SubmitLockProfileData(lock, wait_cycles, /* spinlock */ false);
+}
+
 void StopSynchronizationProfiling() {
   InitSpinLockContentionProfiling();
   CHECK_GE(base::subtle::Barrier_AtomicIncrement(&g_profiling_enabled, -1), 0);
@@ -313,6 +335,6 @@ void StopSynchronizationProfiling() {
 // yb namespace so we don't need to qualify everything.
 namespace gutil {
 void SubmitSpinLockProfileData(const void *contendedlock, int64 wait_cycles) {
-  yb::SubmitSpinLockProfileData(contendedlock, wait_cycles);
+  yb::SubmitLockProfileData(contendedlock, wait_cycles, /* spinlock */ true);
 }
 } // namespace gutil
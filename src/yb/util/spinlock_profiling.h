@@ -33,9 +33,11 @@
 #define YB_UTIL_SPINLOCK_PROFILING_H
 
 #include <iosfwd>
+#include <vector>
 
 #include "yb/gutil/macros.h"
 #include "yb/gutil/ref_counted.h"
+#include "yb/util/debug-util.h"
 
 namespace yb {
 
@@ -80,6 +82,20 @@ void StartSynchronizationProfiling();
 // returned samples.
 void FlushSynchronizationProfile(std::stringstream* out, int64_t* drop_count);
 
+struct ContentionSample {
+  StackTrace stack;
+  int64_t trip_count;
+  int64_t cycles;
+};
+
+// Same as FlushSynchronizationProfile, but appends the samples to the given vector.
+void CollectSynchronizationProfile(std::vector<ContentionSample>* samples, int64_t* drop_count);
+
+// Reports that acquiring the given lock took wait_cycles, because the lock was held by another
+// thread. Spinlocks report their contention through gutil, blocking locks like Mutex and RWMutex
+// call this function, so all of them show up in the same contention profile.
+void SubmitLockContention(const void* lock, int64_t wait_cycles);
+
 // Stop collecting contention profiles.
 void StopSynchronizationProfiling();
 
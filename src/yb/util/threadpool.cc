@@ -46,6 +46,7 @@
 #include "yb/gutil/strings/substitute.h"
 #include "yb/gutil/sysinfo.h"
 #include "yb/util/metrics.h"
+#include "yb/util/os-util.h"
 #include "yb/util/stopwatch.h"
 #include "yb/util/thread.h"
 #include "yb/util/threadpool.h"
@@ -95,6 +96,11 @@ ThreadPoolBuilder& ThreadPoolBuilder::set_metrics(ThreadPoolMetrics metrics) {
   return *this;
 }
 
+ThreadPoolBuilder& ThreadPoolBuilder::set_cpus(std::vector<int> cpus) {
+  cpus_ = std::move(cpus);
+  return *this;
+}
+
 ThreadPoolBuilder& ThreadPoolBuilder::set_idle_timeout(const MonoDelta& idle_timeout) {
   idle_timeout_ = idle_timeout;
   return *this;
@@ -296,6 +302,7 @@ ThreadPool::ThreadPool(const ThreadPoolBuilder& builder)
     max_threads_(builder.max_threads_),
     max_queue_size_(builder.max_queue_size_),
     idle_timeout_(builder.idle_timeout_),
+    cpus_(builder.cpus_),
     pool_status_(STATUS(Uninitialized, "The pool was not initialized.")),
     idle_cond_(&lock_),
     no_threads_cond_(&lock_),
@@ -544,6 +551,10 @@ bool ThreadPool::WaitFor(const MonoDelta& delta) {
 }
 
 void ThreadPool::DispatchThread(bool permanent) {
+  if (!cpus_.empty()) {
+    WARN_NOT_OK(SetCurrentThreadCpuAffinity(cpus_),
+                Format("Failed to set cpu affinity of $0 thread", name_));
+  }
   MutexLock unique_lock(lock_);
   while (true) {
     // Note: STATUS(Aborted, ) is used to indicate normal shutdown.
@@ -37,6 +37,7 @@
 #include <memory>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include <gtest/gtest_prod.h>
 
@@ -117,6 +118,9 @@ struct ThreadPoolMetrics {
 // metrics: Histograms, counters, etc. to update on various threadpool events.
 //    Default: not set.
 //
+// cpus: Cpus that threads of the pool are restricted to.
+//    Default: not restricted.
+//
 class ThreadPoolBuilder {
  public:
   explicit ThreadPoolBuilder(std::string name);
@@ -129,6 +133,7 @@ class ThreadPoolBuilder {
   ThreadPoolBuilder& set_max_queue_size(int max_queue_size);
   ThreadPoolBuilder& set_idle_timeout(const MonoDelta& idle_timeout);
   ThreadPoolBuilder& set_metrics(ThreadPoolMetrics metrics);
+  ThreadPoolBuilder& set_cpus(std::vector<int> cpus);
 
   const std::string& name() const { return name_; }
   int min_threads() const { return min_threads_; }
@@ -148,6 +153,7 @@ class ThreadPoolBuilder {
   int max_queue_size_;
   MonoDelta idle_timeout_;
   ThreadPoolMetrics metrics_;
+  std::vector<int> cpus_;
 
   DISALLOW_COPY_AND_ASSIGN(ThreadPoolBuilder);
 };
@@ -303,6 +309,7 @@ class ThreadPool {
   const int max_threads_;
   const int max_queue_size_;
   const MonoDelta idle_timeout_;
+  const std::vector<int> cpus_;
 
   Status pool_status_;
   Mutex lock_;
@@ -0,0 +1,111 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <chrono>
+#include <map>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/test_util.h"
+#include "yb/util/timer_wheel.h"
+
+namespace yb {
+
+typedef std::chrono::steady_clock::time_point TimePoint;
+typedef TimerWheel<int, TimePoint> TestWheel;
+
+class TimerWheelTest : public YBTest {
+};
+
+TEST_F(TimerWheelTest, Simple) {
+  const TimePoint start;
+  TestWheel wheel(std::chrono::milliseconds(1), start);
+  ASSERT_TRUE(wheel.empty());
+  ASSERT_EQ(TimePoint::max(), wheel.NextExpiration());
+
+  wheel.Insert(start + std::chrono::milliseconds(10), 1);
+  wheel.Insert(start + std::chrono::milliseconds(5), 2);
+  wheel.Insert(start + std::chrono::milliseconds(100), 3);
+  ASSERT_EQ(3, wheel.size());
+  ASSERT_EQ(start + std::chrono::milliseconds(5), wheel.NextExpiration());
+
+  std::vector<int> fired;
+  auto handler = [&fired](int value) { fired.push_back(value); };
+  wheel.Advance(start + std::chrono::milliseconds(4), handler);
+  ASSERT_TRUE(fired.empty());
+  wheel.Advance(start + std::chrono::milliseconds(10), handler);
+  ASSERT_EQ((std::vector<int>{2, 1}), fired);
+
+  // Value that is already due expires on next advance.
+  wheel.Insert(start, 4);
+  ASSERT_EQ(start + std::chrono::milliseconds(10), wheel.NextExpiration());
+  wheel.Advance(start + std::chrono::milliseconds(10), handler);
+  ASSERT_EQ((std::vector<int>{2, 1, 4}), fired);
+
+  wheel.Clear(handler);
+  ASSERT_EQ((std::vector<int>{2, 1, 4, 3}), fired);
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST_F(TimerWheelTest, Random) {
+  const auto tick = std::chrono::milliseconds(1);
+  TimePoint now;
+  TestWheel wheel(tick, now);
+  std::multimap<TimePoint, int> expected;
+  std::mt19937_64 rng(123456);
+  // Cover all levels and distances beyond wheel range.
+  const int64_t kMaxDelays[] = {10, 1000, 100000, 10000000, 100000000};
+
+  std::vector<int> fired;
+  auto handler = [&fired](int value) { fired.push_back(value); };
+  for (int i = 0; i != 100000; ++i) {
+    if (rng() % 3) {
+      const int64_t max_delay = kMaxDelays[rng() % arraysize(kMaxDelays)];
+      const auto time = now + std::chrono::microseconds(rng() % (max_delay * 1000));
+      wheel.Insert(time, i);
+      expected.emplace(time, i);
+    } else {
+      now += std::chrono::microseconds(rng() % 100000000);
+      fired.clear();
+      wheel.Advance(now, handler);
+      std::set<int> expected_fired;
+      // Values could expire up to one tick later than requested.
+      for (auto it = expected.begin(); it != expected.end() && it->first <= now - tick;) {
+        expected_fired.insert(it->second);
+        it = expected.erase(it);
+      }
+      std::set<int> actual_fired(fired.begin(), fired.end());
+      ASSERT_EQ(fired.size(), actual_fired.size());
+      for (auto value : expected_fired) {
+        ASSERT_EQ(1, actual_fired.count(value)) << "Value not fired: " << value;
+      }
+      for (auto value : actual_fired) {
+        if (!expected_fired.count(value)) {
+          auto it = std::find_if(expected.begin(), expected.end(), [value](const auto& entry) {
+            return entry.second == value;
+          });
+          ASSERT_NE(it, expected.end());
+          ASSERT_LE(it->first, now) << "Value fired too early: " << value;
+          expected.erase(it);
+        }
+      }
+      ASSERT_EQ(expected.size(), wheel.size());
+      if (!expected.empty()) {
+        ASSERT_LE(wheel.NextExpiration(), expected.begin()->first + tick);
+      }
+    }
+  }
+}
+
+} // namespace yb
@@ -0,0 +1,232 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_TIMER_WHEEL_H
+#define YB_UTIL_TIMER_WHEEL_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "yb/gutil/bits.h"
+
+namespace yb {
+
+// Hashed hierarchical timing wheel.
+//
+// Time is split into ticks, values are stored in slots of kLevels levels, kSlots slots each.
+// A slot of level L covers kSlots^L ticks, when time reaches the slot its values are moved to
+// lower levels, and values of level 0 slots expire.
+// Insert takes O(1), each value is moved at most kLevels times. Values expire with granularity
+// of one tick, i.e. up to one tick later than requested, but never earlier.
+//
+// There is no removal, i.e. cancelled values should be recognized by the handler, for instance
+// using weak pointers or ids of cancelled tasks.
+// Not thread safe.
+template <class Value, class TimePoint>
+class TimerWheel {
+ public:
+  typedef typename TimePoint::duration Duration;
+
+  TimerWheel(Duration tick, TimePoint now) : tick_(tick), current_tick_(Floor(now)) {}
+
+  TimerWheel(const TimerWheel&) = delete;
+  void operator=(const TimerWheel&) = delete;
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  void Insert(TimePoint time, Value value) {
+    ++size_;
+    DoInsert(Entry{Ceil(time), std::move(value)});
+  }
+
+  // Invokes handler for each value that expired at now.
+  template <class Handler>
+  void Advance(TimePoint now, const Handler& handler) {
+    const int64_t now_tick = Floor(now);
+    for (;;) {
+      FireExpired(handler);
+      if (size_ == 0) {
+        current_tick_ = std::max(current_tick_, now_tick);
+        return;
+      }
+      const int64_t next_tick = NextTick();
+      if (next_tick > now_tick) {
+        current_tick_ = std::max(current_tick_, now_tick);
+        return;
+      }
+      current_tick_ = next_tick;
+      Cascade();
+    }
+  }
+
+  // Returns time when Advance should be invoked next time, TimePoint::max() if wheel is empty.
+  // Could be earlier than the time of the earliest value, because level contains values from
+  // the whole range of its slot.
+  TimePoint NextExpiration() const {
+    if (size_ == 0) {
+      return TimePoint::max();
+    }
+    if (!expired_.empty()) {
+      return TimePoint(tick_ * current_tick_);
+    }
+    return TimePoint(tick_ * NextTick());
+  }
+
+  // Invokes handler for all values and clears the wheel.
+  template <class Handler>
+  void Clear(const Handler& handler) {
+    FireExpired(handler);
+    for (auto& level : levels_) {
+      if (!level) {
+        continue;
+      }
+      for (auto& slot : level->slots) {
+        std::vector<Entry> entries;
+        entries.swap(slot);
+        for (auto& entry : entries) {
+          handler(std::move(entry.value));
+        }
+      }
+      level->occupied = 0;
+    }
+    size_ = 0;
+  }
+
+ private:
+  static constexpr size_t kLevels = 4;
+  static constexpr size_t kSlotBits = 6;
+  static constexpr size_t kSlots = 1ULL << kSlotBits;
+
+  struct Entry {
+    int64_t tick;
+    Value value;
+  };
+
+  struct Level {
+    std::array<std::vector<Entry>, kSlots> slots;
+    // Bit mask of non empty slots.
+    uint64_t occupied = 0;
+  };
+
+  static constexpr size_t Shift(size_t level) {
+    return level * kSlotBits;
+  }
+
+  int64_t Floor(TimePoint time) const {
+    return time.time_since_epoch() / tick_;
+  }
+
+  int64_t Ceil(TimePoint time) const {
+    const auto duration = time.time_since_epoch();
+    return duration / tick_ + (duration % tick_ != Duration::zero());
+  }
+
+  void DoInsert(Entry entry) {
+    const int64_t delta = entry.tick - current_tick_;
+    if (delta <= 0) {
+      expired_.push_back(std::move(entry));
+      return;
+    }
+    size_t level = 0;
+    while (level + 1 != kLevels && delta >= (1LL << Shift(level + 1))) {
+      ++level;
+    }
+    // Too far values are stored in the most distant slot of the top level, and moved again when
+    // time reaches it.
+    const int64_t slot_tick = delta < (1LL << Shift(kLevels))
+        ? entry.tick : current_tick_ + (1LL << Shift(kLevels)) - 1;
+    const size_t slot = (slot_tick >> Shift(level)) & (kSlots - 1);
+    auto& level_ptr = levels_[level];
+    if (!level_ptr) {
+      level_ptr.reset(new Level);
+    }
+    level_ptr->slots[slot].push_back(std::move(entry));
+    level_ptr->occupied |= 1ULL << slot;
+  }
+
+  // Returns first tick after current_tick_ when some slot should be processed.
+  int64_t NextTick() const {
+    int64_t result = std::numeric_limits<int64_t>::max();
+    for (size_t level = 0; level != kLevels; ++level) {
+      if (!levels_[level] || !levels_[level]->occupied) {
+        continue;
+      }
+      const uint64_t occupied = levels_[level]->occupied;
+      const size_t shift = Shift(level);
+      const int64_t block = 1LL << (shift + kSlotBits);
+      const int64_t base = current_tick_ & ~(block - 1);
+      const size_t current_slot = (current_tick_ >> shift) & (kSlots - 1);
+      const uint64_t after_current =
+          current_slot + 1 == kSlots ? 0 : occupied & (~0ULL << (current_slot + 1));
+      const int64_t tick = after_current
+          ? base + (static_cast<int64_t>(Bits::FindLSBSetNonZero64(after_current)) << shift)
+          : base + block + (static_cast<int64_t>(Bits::FindLSBSetNonZero64(occupied)) << shift);
+      result = std::min(result, tick);
+    }
+    return result;
+  }
+
+  // Moves values from slots that start at current_tick_ to lower levels or to expired_.
+  void Cascade() {
+    for (size_t level = kLevels; level-- > 0;) {
+      const size_t shift = Shift(level);
+      if (!levels_[level] || (current_tick_ & ((1LL << shift) - 1)) != 0) {
+        continue;
+      }
+      const size_t slot = (current_tick_ >> shift) & (kSlots - 1);
+      auto& current_level = *levels_[level];
+      if (!(current_level.occupied & (1ULL << slot))) {
+        continue;
+      }
+      std::vector<Entry> entries;
+      entries.swap(current_level.slots[slot]);
+      current_level.occupied &= ~(1ULL << slot);
+      for (auto& entry : entries) {
+        DoInsert(std::move(entry));
+      }
+    }
+  }
+
+  template <class Handler>
+  void FireExpired(const Handler& handler) {
+    while (!expired_.empty()) {
+      std::vector<Entry> expired;
+      expired.swap(expired_);
+      size_ -= expired.size();
+      for (auto& entry : expired) {
+        handler(std::move(entry.value));
+      }
+    }
+  }
+
+  const Duration tick_;
+  int64_t current_tick_;
+  size_t size_ = 0;
+  std::array<std::unique_ptr<Level>, kLevels> levels_;
+  std::vector<Entry> expired_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_TIMER_WHEEL_H
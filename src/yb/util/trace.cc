@@ -60,6 +60,12 @@ __thread Trace* Trace::threadlocal_trace_;
 
 namespace {
 
+uint64_t NextTraceId() {
+  // Zero is reserved for events that do not belong to any trace.
+  static std::atomic<uint64_t> next_id{1};
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
 // Get the part of filepath after the last path separator.
 // (Doesn't modify filepath, contrary to basename() in libgen.h.)
 // Borrowed from glog.
@@ -212,7 +218,7 @@ struct TraceEntry {
   }
 };
 
-Trace::Trace() {
+Trace::Trace() : id_(NextTraceId()) {
 }
 
 ThreadSafeObjectPool<ThreadSafeArena>& ArenaPool() {
@@ -0,0 +1,71 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/universe_key_manager.h"
+
+#include <chrono>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "yb/util/flag_tags.h"
+
+DEFINE_int32(universe_key_wait_timeout_ms, 300000,
+             "How long to wait for the universe key registry from the master, when opening an "
+             "encrypted file with a key version that is not known yet.");
+TAG_FLAG(universe_key_wait_timeout_ms, advanced);
+
+namespace yb {
+
+void UniverseKeyManager::SetUniverseKeyRegistry(const UniverseKeyRegistryPB& registry) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (has_registry_ && registry_.latest_version_id() != registry.latest_version_id()) {
+      LOG(INFO) << "Universe key rotated from version " << registry_.latest_version_id()
+                << " to " << registry.latest_version_id();
+    }
+    registry_ = registry;
+    has_registry_ = true;
+  }
+  cond_.notify_all();
+}
+
+bool UniverseKeyManager::GetLatestUniverseKey(std::string* version_id, EncryptionParamsPB* key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!has_registry_ || !registry_.encryption_enabled()) {
+    return false;
+  }
+  auto it = registry_.universe_keys().find(registry_.latest_version_id());
+  if (it == registry_.universe_keys().end()) {
+    LOG(DFATAL) << "Latest universe key " << registry_.latest_version_id()
+                << " is missing in the registry";
+    return false;
+  }
+  *version_id = it->first;
+  *key = it->second;
+  return true;
+}
+
+Result<EncryptionParamsPB> UniverseKeyManager::GetUniverseKey(const std::string& version_id) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto deadline = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(FLAGS_universe_key_wait_timeout_ms);
+  if (!cond_.wait_until(lock, deadline, [this, &version_id] {
+        return registry_.universe_keys().count(version_id) != 0;
+      })) {
+    return STATUS_FORMAT(TimedOut, "Universe key $0 is not known", version_id);
+  }
+  return registry_.universe_keys().at(version_id);
+}
+
+} // namespace yb
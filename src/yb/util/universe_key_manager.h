@@ -0,0 +1,54 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_UNIVERSE_KEY_MANAGER_H
+#define YB_UTIL_UNIVERSE_KEY_MANAGER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+#include "yb/util/encryption.pb.h"
+#include "yb/util/result.h"
+
+namespace yb {
+
+// Keeps the universe key registry, received from the master. Universe keys are only used to
+// encrypt the per-file keys stored in the headers of encrypted files.
+//
+// Keys are rotated by adding a new version to the registry: new files are encrypted with the
+// latest version, while the existing ones keep their keys until they are rewritten, e.g. by
+// compaction or by the WAL rolling to a new segment.
+class UniverseKeyManager {
+ public:
+  void SetUniverseKeyRegistry(const UniverseKeyRegistryPB& registry);
+
+  // Fills the latest universe key and its version. Returns false when new files should not be
+  // encrypted, i.e. encryption is disabled or the registry was not received yet.
+  bool GetLatestUniverseKey(std::string* version_id, EncryptionParamsPB* key);
+
+  // Returns the universe key of the specified version. Files could be opened before the first
+  // heartbeat to the master, so waits for the registry containing the key up to
+  // FLAGS_universe_key_wait_timeout_ms.
+  Result<EncryptionParamsPB> GetUniverseKey(const std::string& version_id);
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  bool has_registry_ = false;
+  UniverseKeyRegistryPB registry_;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_UNIVERSE_KEY_MANAGER_H
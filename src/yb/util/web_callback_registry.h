@@ -33,6 +33,7 @@
 #define YB_UTIL_WEB_CALLBACK_REGISTRY_H
 
 #include <functional>
+#include <iosfwd>
 #include <map>
 #include <string>
 
@@ -63,6 +64,9 @@ class WebCallbackRegistry {
   typedef std::function<void(const WebRequest& args, std::stringstream* output)>
       PathHandlerCallback;
 
+  typedef std::function<void(const WebRequest& args, std::ostream* output)>
+      StreamingPathHandlerCallback;
+
   virtual ~WebCallbackRegistry() {}
 
   // Register a callback for a URL path. Path should not include the
@@ -78,6 +82,13 @@ class WebCallbackRegistry {
                                    const PathHandlerCallback& callback,
                                    bool is_styled = true, bool is_on_nav_bar = true,
                                    const std::string icon = "") = 0;
+
+  // Register a callback for a URL path, whose plain text output could be large. The output is
+  // sent to the client while the callback writes it, instead of being buffered for the whole page.
+  // The page is not styled and not on the navigation bar. Only one streaming callback could be
+  // registered for a path, and it should be the only callback of this path.
+  virtual void RegisterStreamingPathHandler(const std::string& path, const std::string& alias,
+                                            const StreamingPathHandlerCallback& callback) = 0;
 };
 
 } // namespace yb
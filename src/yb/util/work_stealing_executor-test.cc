@@ -0,0 +1,196 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "yb/util/countdown_latch.h"
+#include "yb/util/monotime.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+#include "yb/util/threadpool.h"
+#include "yb/util/work_stealing_executor.h"
+
+namespace yb {
+
+class WorkStealingExecutorTest : public YBTest {
+};
+
+TEST_F(WorkStealingExecutorTest, SimpleTasks) {
+  WorkStealingExecutor executor("test", 4);
+  constexpr int kTasks = 10000;
+  std::atomic<int> counter(0);
+  for (int i = 0; i != kTasks; ++i) {
+    ASSERT_OK(executor.Submit([&counter] { ++counter; }));
+  }
+  executor.Wait();
+  ASSERT_EQ(kTasks, counter.load());
+}
+
+// Tasks submitting tasks go to the LIFO slot of their worker, the other workers steal them.
+TEST_F(WorkStealingExecutorTest, NestedTasks) {
+  WorkStealingExecutor executor("test", 4);
+  constexpr int kDepth = 12;
+  std::atomic<int> counter(0);
+  std::function<void(int)> fan_out = [&](int depth) {
+    ++counter;
+    if (depth == 0) {
+      return;
+    }
+    for (int i = 0; i != 2; ++i) {
+      ASSERT_OK(executor.Submit([&fan_out, depth] { fan_out(depth - 1); }));
+    }
+  };
+  ASSERT_OK(executor.Submit([&fan_out] { fan_out(kDepth); }));
+  executor.Wait();
+  ASSERT_EQ((1 << (kDepth + 1)) - 1, counter.load());
+}
+
+TEST_F(WorkStealingExecutorTest, SerialTokens) {
+  WorkStealingExecutor executor("test", 8);
+  constexpr int kTokens = 10;
+  constexpr int kTasksPerToken = 1000;
+
+  struct TokenState {
+    std::unique_ptr<WorkStealingSerialToken> token;
+    std::atomic<int> running{0};
+    std::vector<int> order;
+    bool overlapped = false;
+  };
+  std::vector<TokenState> states(kTokens);
+  for (auto& state : states) {
+    state.token = executor.NewSerialToken();
+  }
+  for (int i = 0; i != kTasksPerToken; ++i) {
+    for (auto& state : states) {
+      ASSERT_OK(state.token->Submit([&state, i] {
+        if (++state.running != 1) {
+          state.overlapped = true;
+        }
+        state.order.push_back(i);
+        --state.running;
+      }));
+    }
+  }
+  for (auto& state : states) {
+    state.token->Wait();
+    ASSERT_FALSE(state.overlapped);
+    ASSERT_EQ(kTasksPerToken, state.order.size());
+    for (int i = 0; i != kTasksPerToken; ++i) {
+      ASSERT_EQ(i, state.order[i]);
+    }
+  }
+}
+
+TEST_F(WorkStealingExecutorTest, Shutdown) {
+  WorkStealingExecutor executor("test", 2);
+  CountDownLatch started(1);
+  CountDownLatch release(1);
+  std::atomic<int> counter(0);
+  auto token = executor.NewSerialToken();
+  ASSERT_OK(token->Submit([&] {
+    started.CountDown();
+    release.Wait();
+    ++counter;
+  }));
+  ASSERT_OK(token->Submit([&counter] { ++counter; }));
+  started.Wait();
+
+  // Shutting the token down drops the queued task, and waits for the running one.
+  std::thread shutdown_thread([&token] { token->Shutdown(); });
+  SleepFor(MonoDelta::FromMilliseconds(100));
+  release.CountDown();
+  shutdown_thread.join();
+  ASSERT_EQ(1, counter.load());
+  ASSERT_NOK(token->Submit([] {}));
+
+  executor.Shutdown();
+  ASSERT_NOK(executor.Submit([] {}));
+  executor.Wait();
+}
+
+namespace {
+
+constexpr int kSubmitters = 8;
+
+// Runs kSubmitters threads, each of them submitting tasks_per_submitter tiny tasks through
+// submit, and returns the time it took to run all of them.
+template <class Submit, class Wait>
+MonoDelta MeasureTinyTasks(int tasks_per_submitter, const Submit& submit, const Wait& wait) {
+  std::atomic<int64_t> counter(0);
+  auto start = MonoTime::Now();
+  std::vector<std::thread> submitters;
+  for (int i = 0; i != kSubmitters; ++i) {
+    submitters.emplace_back([&] {
+      for (int j = 0; j != tasks_per_submitter; ++j) {
+        CHECK_OK(submit([&counter] { counter.fetch_add(1, std::memory_order_relaxed); }));
+      }
+    });
+  }
+  for (auto& submitter : submitters) {
+    submitter.join();
+  }
+  wait();
+  auto result = MonoTime::Now() - start;
+  CHECK_EQ(kSubmitters * tasks_per_submitter, counter.load());
+  return result;
+}
+
+} // namespace
+
+// Compares the time to run many tiny tasks with ThreadPool and with WorkStealingExecutor.
+TEST_F(WorkStealingExecutorTest, Performance) {
+  const int kWorkers = std::max<int>(4, std::thread::hardware_concurrency());
+  const int kTasksPerSubmitter = AllowSlowTests() ? 200000 : 20000;
+
+  std::unique_ptr<ThreadPool> thread_pool;
+  ASSERT_OK(ThreadPoolBuilder("test").set_min_threads(kWorkers).set_max_threads(kWorkers)
+                .Build(&thread_pool));
+  auto thread_pool_time = MeasureTinyTasks(
+      kTasksPerSubmitter,
+      [&thread_pool](std::function<void()> task) { return thread_pool->SubmitFunc(task); },
+      [&thread_pool] { thread_pool->Wait(); });
+
+  WorkStealingExecutor executor("test", kWorkers);
+  auto executor_time = MeasureTinyTasks(
+      kTasksPerSubmitter,
+      [&executor](std::function<void()> task) { return executor.Submit(std::move(task)); },
+      [&executor] { executor.Wait(); });
+
+  auto serial_token = executor.NewSerialToken();
+  auto serial_token_time = MeasureTinyTasks(
+      kTasksPerSubmitter,
+      [&serial_token](std::function<void()> task) { return serial_token->Submit(std::move(task)); },
+      [&serial_token] { serial_token->Wait(); });
+  serial_token.reset();
+
+  auto pool_token = thread_pool->NewToken(ThreadPool::ExecutionMode::SERIAL);
+  auto pool_token_time = MeasureTinyTasks(
+      kTasksPerSubmitter,
+      [&pool_token](std::function<void()> task) { return pool_token->SubmitFunc(task); },
+      [&pool_token] { pool_token->Wait(); });
+  pool_token.reset();
+  thread_pool->Shutdown();
+
+  LOG(INFO) << "Workers: " << kWorkers << ", submitters: " << kSubmitters
+            << ", tasks: " << kSubmitters * kTasksPerSubmitter
+            << ", ThreadPool: " << thread_pool_time
+            << ", WorkStealingExecutor: " << executor_time
+            << ", serial ThreadPoolToken: " << pool_token_time
+            << ", WorkStealingSerialToken: " << serial_token_time;
+}
+
+} // namespace yb
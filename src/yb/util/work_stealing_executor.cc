@@ -0,0 +1,287 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#include "yb/util/work_stealing_executor.h"
+
+#include <thread>
+
+#include "yb/util/format.h"
+#include "yb/util/logging.h"
+#include "yb/util/random_util.h"
+#include "yb/util/thread.h"
+
+namespace yb {
+
+namespace {
+
+// The worker running on the current thread, if it is a worker of some WorkStealingExecutor.
+thread_local void* current_worker = nullptr;
+
+} // namespace
+
+struct WorkStealingExecutor::Worker {
+  WorkStealingExecutor* executor;
+  scoped_refptr<Thread> thread;
+
+  std::mutex mutex;
+  // The last task submitted by this worker, it is run before the queued tasks.
+  std::function<void()> lifo_slot;
+  std::deque<std::function<void()>> tasks;
+};
+
+WorkStealingExecutor::WorkStealingExecutor(std::string name, size_t num_workers)
+    : name_(std::move(name)) {
+  CHECK_GT(num_workers, 0);
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i != num_workers; ++i) {
+    workers_.emplace_back(new Worker);
+    workers_.back()->executor = this;
+  }
+  // Workers steal from each other, so all of them are created before the first one is started.
+  for (size_t i = 0; i != num_workers; ++i) {
+    auto* worker = workers_[i].get();
+    CHECK_OK(Thread::Create(
+        "work_stealing_executor", Format("$0-$1", name_, i), &WorkStealingExecutor::Execute, this,
+        worker, &worker->thread));
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() {
+  Shutdown();
+}
+
+Status WorkStealingExecutor::Submit(std::function<void()> task) {
+  submitting_.fetch_add(1);
+  if (closing_.load()) {
+    submitting_.fetch_sub(1);
+    return STATUS_FORMAT(ServiceUnavailable, "Executor $0 is shut down", name_);
+  }
+  pending_tasks_.fetch_add(1);
+
+  bool wake_up = true;
+  auto* worker = static_cast<Worker*>(current_worker);
+  if (worker && worker->executor == this) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (worker->lifo_slot) {
+      worker->tasks.push_back(std::move(worker->lifo_slot));
+    } else {
+      // This worker will run the task once the current one is done, no need to wake anybody.
+      wake_up = false;
+    }
+    worker->lifo_slot = std::move(task);
+  } else {
+    worker = workers_[next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size()].get();
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    worker->tasks.push_back(std::move(task));
+  }
+  queued_tasks_.fetch_add(1);
+  submitting_.fetch_sub(1);
+
+  // Pairs with the increment of sleeping_workers_ followed by the check of queued_tasks_ in
+  // Execute: either the worker sees the task, or we see the sleeping worker.
+  if (wake_up && sleeping_workers_.load() > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cond_.notify_one();
+  }
+  return Status::OK();
+}
+
+void WorkStealingExecutor::Execute(Worker* worker) {
+  current_worker = worker;
+  std::function<void()> task;
+  while (!closing_.load()) {
+    if (PopTask(worker, &task) || StealTask(worker, &task)) {
+      queued_tasks_.fetch_sub(1);
+      task();
+      // The task is destroyed before it is reported as done, since its destructor could submit
+      // new tasks.
+      task = nullptr;
+      TaskDone();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleeping_workers_.fetch_add(1);
+    while (!closing_.load() && queued_tasks_.load() == 0) {
+      sleep_cond_.wait(lock);
+    }
+    sleeping_workers_.fetch_sub(1);
+  }
+  current_worker = nullptr;
+}
+
+bool WorkStealingExecutor::PopTask(Worker* worker, std::function<void()>* task) {
+  std::lock_guard<std::mutex> lock(worker->mutex);
+  if (worker->lifo_slot) {
+    *task = std::move(worker->lifo_slot);
+    worker->lifo_slot = nullptr;
+    return true;
+  }
+  if (worker->tasks.empty()) {
+    return false;
+  }
+  *task = std::move(worker->tasks.front());
+  worker->tasks.pop_front();
+  return true;
+}
+
+bool WorkStealingExecutor::StealTask(Worker* thief, std::function<void()>* task) {
+  const size_t num_workers = workers_.size();
+  const size_t start = RandomUniformInt<size_t>(0, num_workers - 1);
+  for (size_t i = 0; i != num_workers; ++i) {
+    auto* victim = workers_[(start + i) % num_workers].get();
+    if (victim == thief) {
+      continue;
+    }
+    std::lock_guard<std::mutex> lock(victim->mutex);
+    if (!victim->tasks.empty()) {
+      *task = std::move(victim->tasks.front());
+      victim->tasks.pop_front();
+      return true;
+    }
+    // The task in the LIFO slot waits for the current task of the victim, that could be long.
+    if (victim->lifo_slot) {
+      *task = std::move(victim->lifo_slot);
+      victim->lifo_slot = nullptr;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingExecutor::TaskDone() {
+  if (pending_tasks_.fetch_sub(1) == 1) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    idle_cond_.notify_all();
+  }
+}
+
+void WorkStealingExecutor::Wait() {
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  idle_cond_.wait(lock, [this] { return pending_tasks_.load() == 0; });
+}
+
+void WorkStealingExecutor::Shutdown() {
+  if (closing_.exchange(true)) {
+    return;
+  }
+  while (submitting_.load() != 0) {
+    std::this_thread::yield();
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    sleep_cond_.notify_all();
+  }
+  for (auto& worker : workers_) {
+    worker->thread->Join();
+  }
+
+  std::deque<std::function<void()>> dropped;
+  for (auto& worker : workers_) {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+    if (worker->lifo_slot) {
+      dropped.push_back(std::move(worker->lifo_slot));
+      worker->lifo_slot = nullptr;
+    }
+    std::move(worker->tasks.begin(), worker->tasks.end(), std::back_inserter(dropped));
+    worker->tasks.clear();
+  }
+  const auto num_dropped = static_cast<int64_t>(dropped.size());
+  // Destroy the tasks outside of the worker mutexes, their destructors could use the executor.
+  dropped.clear();
+  queued_tasks_.fetch_sub(num_dropped);
+  if (num_dropped != 0 && pending_tasks_.fetch_sub(num_dropped) == num_dropped) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    idle_cond_.notify_all();
+  }
+}
+
+std::unique_ptr<WorkStealingSerialToken> WorkStealingExecutor::NewSerialToken() {
+  return std::unique_ptr<WorkStealingSerialToken>(new WorkStealingSerialToken(this));
+}
+
+WorkStealingSerialToken::~WorkStealingSerialToken() {
+  Shutdown();
+}
+
+Status WorkStealingSerialToken::Submit(std::function<void()> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      return STATUS(ServiceUnavailable, "Token is shut down");
+    }
+    tasks_.push_back(std::move(task));
+    if (active_) {
+      return Status::OK();
+    }
+    active_ = true;
+  }
+  return ScheduleDrain();
+}
+
+Status WorkStealingSerialToken::ScheduleDrain() {
+  // The guard is destroyed with the last copy of the task, whether the task was run or dropped.
+  std::shared_ptr<WorkStealingSerialToken> guard(this, [](WorkStealingSerialToken* token) {
+    token->DrainTaskDestroyed();
+  });
+  return executor_->Submit([guard = std::move(guard)] { guard->Drain(); });
+}
+
+void WorkStealingSerialToken::Drain() {
+  for (size_t i = 0; i != kMaxTasksPerDrain; ++i) {
+    std::function<void()> task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    task();
+  }
+}
+
+void WorkStealingSerialToken::DrainTaskDestroyed() {
+  std::deque<std::function<void()>> dropped;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (tasks_.empty() || shutdown_ || executor_->closing_.load()) {
+      dropped.swap(tasks_);
+      active_ = false;
+      idle_cond_.notify_all();
+      return;
+    }
+  }
+  // active_ is kept, so tasks submitted meanwhile do not schedule another Drain. If the executor
+  // is shut down meanwhile, the task is dropped and this function deactivates the token.
+  auto status = ScheduleDrain();
+  if (!status.ok()) {
+    VLOG(1) << "Failed to schedule drain: " << status;
+  }
+}
+
+void WorkStealingSerialToken::Wait() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idle_cond_.wait(lock, [this] { return !active_; });
+}
+
+void WorkStealingSerialToken::Shutdown() {
+  std::deque<std::function<void()>> dropped;
+  std::unique_lock<std::mutex> lock(mutex_);
+  shutdown_ = true;
+  dropped.swap(tasks_);
+  idle_cond_.wait(lock, [this] { return !active_; });
+}
+
+} // namespace yb
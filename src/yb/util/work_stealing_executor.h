@@ -0,0 +1,153 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+#ifndef YB_UTIL_WORK_STEALING_EXECUTOR_H
+#define YB_UTIL_WORK_STEALING_EXECUTOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "yb/gutil/ref_counted.h"
+#include "yb/util/status.h"
+
+namespace yb {
+
+class Thread;
+class WorkStealingSerialToken;
+
+// Thread pool without a central task queue, for many small tasks on machines with many cores.
+//
+// Each worker has its own queue, protected by its own mutex, so submitters and workers contend
+// only when they touch the same queue:
+// - Tasks submitted from outside of the executor are spread over the workers round robin.
+// - A task submitted by a worker goes to the LIFO slot of this worker and runs next on it, while
+//   the data it uses is still in the cache. The task it replaces in the slot goes to the back of
+//   the worker queue, so a worker that keeps submitting tasks does not starve its queue.
+// - A worker without tasks steals the oldest task of another worker, starting from a random one.
+// - Workers that find nothing to steal go to sleep, and are only woken up when tasks are queued.
+//
+// The number of workers is fixed.
+class WorkStealingExecutor {
+ public:
+  WorkStealingExecutor(std::string name, size_t num_workers);
+  ~WorkStealingExecutor();
+
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  void operator=(const WorkStealingExecutor&) = delete;
+
+  // Submits the task, fails when the executor is shut down.
+  CHECKED_STATUS Submit(std::function<void()> task);
+
+  // Waits until all submitted tasks are completed.
+  void Wait();
+
+  // Waits for the running tasks and stops the workers. Queued tasks are destroyed without being
+  // run.
+  void Shutdown();
+
+  // Returns a token whose tasks are run one at a time, in the order of submission. The token
+  // must be destroyed before the executor.
+  std::unique_ptr<WorkStealingSerialToken> NewSerialToken();
+
+  size_t num_workers() const { return workers_.size(); }
+
+ private:
+  friend class WorkStealingSerialToken;
+
+  struct Worker;
+
+  void Execute(Worker* worker);
+  bool PopTask(Worker* worker, std::function<void()>* task);
+  bool StealTask(Worker* thief, std::function<void()>* task);
+  void TaskDone();
+
+  const std::string name_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Used to pick the worker of tasks submitted from outside of the executor.
+  std::atomic<size_t> next_worker_{0};
+
+  // Number of Submit calls in progress, so Shutdown could wait for them.
+  std::atomic<int> submitting_{0};
+
+  // Number of tasks waiting in the worker queues.
+  std::atomic<int64_t> queued_tasks_{0};
+
+  // Number of submitted tasks that are not completed yet.
+  std::atomic<int64_t> pending_tasks_{0};
+
+  std::atomic<int> sleeping_workers_{0};
+  std::atomic<bool> closing_{false};
+
+  // Only used while workers go to sleep or wake up, and by Wait, not while tasks are queued.
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cond_;
+  std::condition_variable idle_cond_;
+};
+
+// Runs the tasks submitted through it one at a time, in the order of submission, on the workers of
+// a WorkStealingExecutor. Only one task of the token is queued in the executor at a time, so the
+// tasks of different tokens still run in parallel.
+class WorkStealingSerialToken {
+ public:
+  ~WorkStealingSerialToken();
+
+  WorkStealingSerialToken(const WorkStealingSerialToken&) = delete;
+  void operator=(const WorkStealingSerialToken&) = delete;
+
+  // Submits the task, fails when the token or its executor is shut down.
+  CHECKED_STATUS Submit(std::function<void()> task);
+
+  // Waits until all tasks submitted through this token are completed.
+  void Wait();
+
+  // Destroys the tasks that were not started and waits for the running one. No new tasks could be
+  // submitted after that.
+  void Shutdown();
+
+ private:
+  friend class WorkStealingExecutor;
+
+  explicit WorkStealingSerialToken(WorkStealingExecutor* executor) : executor_(executor) {}
+
+  // Queues a Drain of this token in the executor.
+  CHECKED_STATUS ScheduleDrain();
+
+  // Runs at most kMaxTasksPerDrain queued tasks, so a busy token does not keep a worker to itself.
+  void Drain();
+
+  // Called when the executor destroys the task that called Drain, after it was run or when it was
+  // dropped by the shutdown of the executor. Schedules the next Drain if tasks are still queued.
+  void DrainTaskDestroyed();
+
+  static constexpr size_t kMaxTasksPerDrain = 16;
+
+  WorkStealingExecutor* const executor_;
+
+  std::mutex mutex_;
+  std::condition_variable idle_cond_;
+  std::deque<std::function<void()>> tasks_;
+  // Whether a Drain of this token is queued or running in the executor.
+  bool active_ = false;
+  bool shutdown_ = false;
+};
+
+} // namespace yb
+
+#endif // YB_UTIL_WORK_STEALING_EXECUTOR_H
@@ -24,8 +24,14 @@
 #include "yb/gutil/endian.h"
 #include "yb/gutil/strings/substitute.h"
 
+#include "yb/util/flag_tags.h"
 #include "yb/util/random_util.h"
 
+DEFINE_int32(cql_rows_data_trailer_min_bytes, 16 * 1024,
+             "Rows data of an uncompressed CQL response at least this large is sent as a separate "
+             "buffer rather than copied into the response message.");
+TAG_FLAG(cql_rows_data_trailer_min_bytes, advanced);
+
 namespace yb {
 namespace cqlserver {
 
@@ -121,7 +127,7 @@ Status CQLMessage::QueryParameters::GetBindVariable(const std::string& name,
         return STATUS_SUBSTITUTE(
             RuntimeError, "Unsupported datatype $0", static_cast<int>(type->main()));
       }
-      Slice data(v->value);
+      Slice data = v->value;
       return value->Deserialize(type, YQL_CLIENT_CQL, &data);
     }
     case Value::Kind::IS_NULL:
@@ -364,8 +370,10 @@ bool CQLRequest::ParseRequest(
     return false;
   }
 
-  // Clear and release the body after parsing.
+  // Clear and release the body after parsing. The uncompressed body is kept alive because it is
+  // referenced by the bind variable values.
   (*request)->body_.clear();
+  (*request)->uncompressed_body_ = std::move(buffer);
 
   return true;
 }
@@ -483,7 +491,7 @@ Status CQLRequest::ParseValue(const bool with_name, Value* value) {
     value->kind = Value::Kind::NOT_NULL;
     if (length > 0) {
       RETURN_NOT_ENOUGH(length);
-      value->value.assign(to_char_ptr(data), kIntSize + length);
+      value->value = Slice(data, kIntSize + length);
       body_.remove_prefix(length);
       DVLOG(4) << "CQL value bytes " << value->value;
     }
@@ -875,7 +883,7 @@ void SerializeValue(const CQLMessage::Value& value, faststring* mesg) {
   switch (value.kind) {
     case CQLMessage::Value::Kind::NOT_NULL:
       SerializeInt(value.value.size(), mesg);
-      mesg->append(value.value);
+      mesg->append(value.value.data(), value.value.size());
       return;
     case CQLMessage::Value::Kind::IS_NULL:
       SerializeInt(-1, mesg);
@@ -955,6 +963,23 @@ void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststri
       mesg->data(), start_pos + kHeaderPosLength, mesg->size() - start_pos - kMessageHeaderLength);
 }
 
+void CQLResponse::Serialize(const CompressionScheme compression_scheme, faststring* mesg,
+                            RefCntBuffer* trailer) const {
+  const string* body_trailer = BodyTrailer();
+  if (compression_scheme != CQLMessage::CompressionScheme::kNone || body_trailer == nullptr ||
+      body_trailer->size() < static_cast<size_t>(FLAGS_cql_rows_data_trailer_min_bytes)) {
+    Serialize(compression_scheme, mesg);
+    return;
+  }
+  const size_t start_pos = mesg->size(); // save the start position
+  SerializeHeader(false /* compress */, mesg);
+  SerializeBodyHead(mesg);
+  SERIALIZE_INT(
+      mesg->data(), start_pos + kHeaderPosLength,
+      mesg->size() + body_trailer->size() - start_pos - kMessageHeaderLength);
+  *trailer = RefCntBuffer(*body_trailer);
+}
+
 void CQLResponse::SerializeHeader(const bool compress, faststring* mesg) const {
   uint8_t buffer[kMessageHeaderLength];
   SERIALIZE_BYTE(buffer, kHeaderPosVersion, version());
@@ -1381,6 +1406,11 @@ void ResultResponse::SerializeBody(faststring* mesg) const {
   SerializeResultBody(mesg);
 }
 
+void ResultResponse::SerializeBodyHead(faststring* mesg) const {
+  SerializeInt(static_cast<int32_t>(kind_), mesg);
+  SerializeResultBodyHead(mesg);
+}
+
 void ResultResponse::SerializeType(const RowsMetadata::Type* type, faststring* mesg) const {
   SerializeShort(static_cast<uint16_t>(type->id), mesg);
   switch (type->id) {
@@ -1505,10 +1535,14 @@ RowsResultResponse::~RowsResultResponse() {
 }
 
 void RowsResultResponse::SerializeResultBody(faststring* mesg) const {
+  SerializeResultBodyHead(mesg);
+  mesg->append(result_->rows_data());
+}
+
+void RowsResultResponse::SerializeResultBodyHead(faststring* mesg) const {
   SerializeRowsMetadata(
       RowsMetadata(result_->table_name(), result_->column_schemas(),
                    result_->paging_state(), skip_metadata_), mesg);
-  mesg->append(result_->rows_data());
 }
 
 //----------------------------------------------------------------------------------------
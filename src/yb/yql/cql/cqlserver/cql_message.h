@@ -29,6 +29,7 @@
 #include "yb/rpc/server_event.h"
 #include "yb/yql/cql/ql/util/statement_params.h"
 #include "yb/yql/cql/ql/util/statement_result.h"
+#include "yb/util/ref_cnt_buffer.h"
 #include "yb/util/slice.h"
 #include "yb/util/status.h"
 #include "yb/util/net/sockaddr.h"
@@ -169,8 +170,10 @@ class CQLMessage {
 
     Kind kind = Kind::NOT_NULL;
     std::string name;
-    std::string value; // As required by QLValue::Deserialize() for CQL, the value includes
-                       // the 4-byte length header, i.e. "<4-byte-length><value>".
+    Slice value; // As required by QLValue::Deserialize() for CQL, the value includes the 4-byte
+                 // length header, i.e. "<4-byte-length><value>". It references the request body,
+                 // which is owned by the inbound call (or by the request if it was compressed),
+                 // so the value is not copied and is converted only when it is bound.
   };
 
   // Id of a prepared query for PREPARE, EXECUTE and BATCH requests.
@@ -312,6 +315,9 @@ class CQLRequest : public CQLMessage {
 
  private:
   Slice body_;
+
+  // Uncompressed body of a compressed request, referenced by the parsed bind variable values.
+  std::unique_ptr<uint8_t[]> uncompressed_body_;
 };
 
 // ------------------------------ Individual CQL requests -----------------------------------
@@ -465,6 +471,13 @@ class CQLResponse : public CQLMessage {
   virtual ~CQLResponse();
   virtual void Serialize(CompressionScheme compression_scheme, faststring* mesg) const;
 
+  // Same as Serialize() except that a large body trailer (see BodyTrailer()) of an uncompressed
+  // response is left out of mesg and returned in trailer instead. The trailer is to be sent right
+  // after mesg, so that the rows data returned by the tservers is not copied once more into the
+  // message.
+  void Serialize(CompressionScheme compression_scheme, faststring* mesg,
+                 RefCntBuffer* trailer) const;
+
  protected:
   CQLResponse(const CQLRequest& request, Opcode opcode);
   CQLResponse(StreamId stream_id, Opcode opcode);
@@ -472,6 +485,11 @@ class CQLResponse : public CQLMessage {
 
   // Function to serialize a response body that all CQLResponse subclasses need to implement
   virtual void SerializeBody(faststring* mesg) const = 0;
+
+  // Trailing part of the response body that is already in the wire format, if any. A response
+  // that has it also needs to serialize the rest of its body in SerializeBodyHead().
+  virtual const std::string* BodyTrailer() const { return nullptr; }
+  virtual void SerializeBodyHead(faststring* mesg) const { SerializeBody(mesg); }
 };
 
 // ------------------------------ Individual CQL responses -----------------------------------
@@ -695,10 +713,14 @@ class ResultResponse : public CQLResponse {
 
   ResultResponse(const CQLRequest& request, Kind kind);
   virtual void SerializeBody(faststring* mesg) const override;
+  virtual void SerializeBodyHead(faststring* mesg) const override;
 
   // Function to serialize a result body that all ResultResponse subclasses need to implement
   virtual void SerializeResultBody(faststring* mesg) const = 0;
 
+  // Serialize the result body without the body trailer.
+  virtual void SerializeResultBodyHead(faststring* mesg) const { SerializeResultBody(mesg); }
+
   // Helper serialize functions
   void SerializeType(const RowsMetadata::Type* type, faststring* mesg) const;
   void SerializeColSpecs(
@@ -731,6 +753,8 @@ class RowsResultResponse : public ResultResponse {
 
  protected:
   virtual void SerializeResultBody(faststring* mesg) const override;
+  virtual void SerializeResultBodyHead(faststring* mesg) const override;
+  virtual const std::string* BodyTrailer() const override { return &result_->rows_data(); }
 
  private:
   const ql::RowsResult::SharedPtr result_;
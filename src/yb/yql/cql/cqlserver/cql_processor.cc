@@ -172,6 +172,7 @@ void CQLProcessor::ProcessCall(rpc::InboundCallPtr call) {
   request_ = std::move(request);
   call_->SetRequest(request_, service_impl_);
   retry_count_ = 0;
+  result_rows_ = 0;
   response.reset(ProcessRequest(*request_));
   if (response != nullptr) {
     SendResponse(*response);
@@ -185,8 +186,9 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   const auto& context = static_cast<const CQLConnectionContext&>(call_->connection()->context());
   const auto compression_scheme = context.compression_scheme();
   faststring msg;
-  response.Serialize(compression_scheme, &msg);
-  call_->RespondSuccess(RefCntBuffer(msg), cql_metrics_->rpc_method_metrics_);
+  RefCntBuffer trailer;
+  response.Serialize(compression_scheme, &msg, &trailer);
+  call_->RespondSuccess(RefCntBuffer(msg), trailer, cql_metrics_->rpc_method_metrics_);
 
   MonoTime response_done = MonoTime::Now();
   cql_metrics_->time_to_process_request_->Increment(
@@ -194,6 +196,17 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   if (request_ != nullptr) {
     cql_metrics_->time_to_execute_cql_request_->Increment(
         response_begin.GetDeltaSince(execute_begin_).ToMicroseconds());
+    const auto& statement_stats = service_impl_->statement_stats();
+    if (statement_stats && statement_stats->Sample()) {
+      const MonoDelta elapsed = response_begin.GetDeltaSince(execute_begin_);
+      const bool failed = response.opcode() == CQLMessage::Opcode::ERROR;
+      for (const auto& stmt : stmts_) {
+        statement_stats->Record(*stmt, elapsed, result_rows_, retry_count_, failed);
+      }
+      for (const auto& stmt : unprepared_stmts_) {
+        statement_stats->Record(*stmt, elapsed, result_rows_, retry_count_, failed);
+      }
+    }
   }
   cql_metrics_->time_to_queue_cql_response_->Increment(
       response_done.GetDeltaSince(response_begin).ToMicroseconds());
@@ -202,6 +215,7 @@ void CQLProcessor::SendResponse(const CQLResponse& response) {
   call_ = nullptr;
   request_ = nullptr;
   stmts_.clear();
+  unprepared_stmts_.clear();
   parse_trees_.clear();
   SetCurrentSession(nullptr);
   service_impl_->ReturnProcessor(pos_);
@@ -310,8 +324,34 @@ CQLResponse* CQLProcessor::ProcessRequest(const ExecuteRequest& req) {
 
 CQLResponse* CQLProcessor::ProcessRequest(const QueryRequest& req) {
   VLOG(1) << "QUERY " << req.query();
-  RunAsync(req.query(), req.params(), statement_executed_cb_);
-  return nullptr;
+  const auto& cache = service_impl_->unprepared_stmts();
+  if (cache == nullptr) {
+    RunAsync(req.query(), req.params(), statement_executed_cb_);
+    return nullptr;
+  }
+
+  // Reuse the parse tree of the same statement text analyzed for the same keyspace before. A stale
+  // statement is dropped from the cache when its execution fails, see ProcessError().
+  const CQLMessage::QueryId query_id = CQLStatement::GetQueryId(
+      ql_env_.CurrentKeyspace(), req.query());
+  shared_ptr<const CQLStatement> stmt = cache->Get(query_id);
+  if (stmt != nullptr) {
+    cql_metrics_->ql_unprepared_stmt_cache_hits_->Increment();
+  } else {
+    cql_metrics_->ql_unprepared_stmt_cache_misses_->Increment();
+    shared_ptr<CQLStatement> new_stmt = cache->Allocate(
+        query_id, ql_env_.CurrentKeyspace(), req.query());
+    const Status s = new_stmt->Prepare(this, cache->mem_tracker());
+    if (!s.ok()) {
+      cache->Delete(new_stmt);
+      return ProcessError(s);
+    }
+    stmt = std::move(new_stmt);
+  }
+  stmt->clear_reparsed();
+  unprepared_stmts_.insert(stmt);
+  const Status s = stmt->ExecuteAsync(this, req.params(), statement_executed_cb_);
+  return s.ok() ? nullptr : ProcessError(s);
 }
 
 CQLResponse* CQLProcessor::ProcessRequest(const BatchRequest& req) {
@@ -405,6 +445,12 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
           query_id = stmt->query_id();
         }
       }
+      // Cached statements of queries are analyzed again when the query is retried below.
+      for (const auto& stmt : unprepared_stmts_) {
+        if (stmt->stale()) {
+          service_impl_->unprepared_stmts()->Delete(stmt);
+        }
+      }
       if (query_id) {
         return new UnpreparedErrorResponse(*request_, *query_id);
       }
@@ -414,6 +460,7 @@ CQLResponse* CQLProcessor::ProcessError(const Status& s,
       // thread. Also, rescheduling gives other calls a chance to execute first before we do.
       if (++retry_count_ == 1) {
         stmts_.clear();
+        unprepared_stmts_.clear();
         parse_trees_.clear();
         Reschedule(&process_request_task_.Bind(this));
         return nullptr;
@@ -457,6 +504,12 @@ CQLResponse* CQLProcessor::ProcessResult(const ExecutedResult::SharedPtr& result
       const RowsResult::SharedPtr& rows_result = std::static_pointer_cast<RowsResult>(result);
       if (request_->opcode() != CQLMessage::Opcode::AUTH_RESPONSE) {
         cql_metrics_->ql_response_size_bytes_->Increment(rows_result->rows_data().size());
+        if (service_impl_->statement_stats()) {
+          auto row_count = QLRowBlock::GetRowCount(rows_result->client(), rows_result->rows_data());
+          if (row_count.ok()) {
+            result_rows_ = *row_count;
+          }
+        }
       }
       switch (request_->opcode()) {
         case CQLMessage::Opcode::EXECUTE:
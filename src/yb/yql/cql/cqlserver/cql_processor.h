@@ -114,11 +114,15 @@ class CQLProcessor : public ql::QLProcessor {
   CQLInboundCallPtr call_;
   std::shared_ptr<const CQLRequest> request_;
   std::unordered_set<std::shared_ptr<const CQLStatement>> stmts_;
+  std::unordered_set<std::shared_ptr<const CQLStatement>> unprepared_stmts_;
   std::unordered_set<ql::ParseTree::UniPtr> parse_trees_;
 
   // Current retry count.
   int retry_count_ = 0;
 
+  // Number of rows returned by the current request, for the statement statistics.
+  size_t result_rows_ = 0;
+
   // Parse and execute begin times.
   MonoTime parse_begin_;
   MonoTime execute_begin_;
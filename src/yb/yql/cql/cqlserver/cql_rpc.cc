@@ -146,6 +146,9 @@ void CQLInboundCall::Serialize(boost::container::small_vector_base<RefCntBuffer>
   CHECK_GT(response_msg_buf_.size(), 0);
 
   output->push_back(std::move(response_msg_buf_));
+  if (!response_trailer_buf_.empty()) {
+    output->push_back(std::move(response_trailer_buf_));
+  }
 }
 
 void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code,
@@ -183,12 +186,18 @@ void CQLInboundCall::RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_cod
 
 void CQLInboundCall::RespondSuccess(const RefCntBuffer& buffer,
                                     const yb::rpc::RpcMethodMetrics& metrics) {
-  RecordHandlingCompleted(metrics.handler_latency);
+  RecordHandlingCompleted(metrics);
   response_msg_buf_ = buffer;
 
   QueueResponse(/* is_success */ true);
 }
 
+void CQLInboundCall::RespondSuccess(const RefCntBuffer& buffer, const RefCntBuffer& trailer,
+                                    const yb::rpc::RpcMethodMetrics& metrics) {
+  response_trailer_buf_ = trailer;
+  RespondSuccess(buffer, metrics);
+}
+
 void CQLInboundCall::GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) const {
   std::shared_ptr<const CQLRequest> request =
 #ifdef THREAD_SANITIZER
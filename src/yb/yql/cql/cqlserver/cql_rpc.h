@@ -118,6 +118,9 @@ class CQLInboundCall : public rpc::InboundCall {
   const std::string& method_name() const override;
   void RespondFailure(rpc::ErrorStatusPB::RpcErrorCodePB error_code, const Status& status) override;
   void RespondSuccess(const RefCntBuffer& buffer, const yb::rpc::RpcMethodMetrics& metrics);
+  // Same as above but sends trailer right after buffer as part of the same response message.
+  void RespondSuccess(const RefCntBuffer& buffer, const RefCntBuffer& trailer,
+                      const yb::rpc::RpcMethodMetrics& metrics);
   void GetCallDetails(rpc::RpcCallInProgressPB *call_in_progress_pb) const;
   void SetRequest(std::shared_ptr<const CQLRequest> request, CQLServiceImpl* service_impl) {
     service_impl_ = service_impl;
@@ -130,6 +133,7 @@ class CQLInboundCall : public rpc::InboundCall {
 
  private:
   RefCntBuffer response_msg_buf_;
+  RefCntBuffer response_trailer_buf_;
   const ql::QLSession::SharedPtr ql_session_;
   uint16_t stream_id_;
   std::shared_ptr<const CQLRequest> request_;
@@ -15,6 +15,7 @@
 #include "yb/yql/cql/cqlserver/cql_server.h"
 
 #include "yb/util/flag_tags.h"
+#include "yb/util/jsonwriter.h"
 #include "yb/util/size_literals.h"
 #include "yb/gutil/strings/substitute.h"
 #include "yb/yql/cql/cqlserver/cql_service.h"
@@ -41,6 +42,22 @@ namespace cqlserver {
 
 namespace {
 
+// Serves the execution statistics of statements as JSON. They are dropped when the "reset"
+// argument is present.
+void HandleStatementsPage(
+    const std::shared_ptr<CQLStatementStats>& statement_stats, const Webserver::WebRequest& req,
+    std::stringstream* output) {
+  if (req.parsed_args.find("reset") != req.parsed_args.end()) {
+    statement_stats->Reset();
+  }
+  JsonWriter writer(output, JsonWriter::PRETTY);
+  statement_stats->WriteAsJson(&writer);
+}
+
+} // namespace
+
+namespace {
+
 boost::posix_time::time_duration refresh_interval() {
   return boost::posix_time::seconds(FLAGS_cql_nodelist_refresh_interval_secs);
 }
@@ -70,6 +87,16 @@ Status CQLServer::Start() {
   auto cql_service = std::make_shared<CQLServiceImpl>(this, opts_, local_tablet_filter_);
   cql_service->CompleteInit();
 
+  if (cql_service->statement_stats()) {
+    web_server_->RegisterPathHandler(
+        "/statements", "Statements",
+        [statement_stats = cql_service->statement_stats()](
+            const Webserver::WebRequest& req, std::stringstream* output) {
+          HandleStatementsPage(statement_stats, req, output);
+        },
+        false /* is_styled */, false /* is_on_nav_bar */);
+  }
+
   RETURN_NOT_OK(RegisterService(FLAGS_cql_service_queue_length, std::move(cql_service)));
 
   RETURN_NOT_OK(server::RpcAndWebServerBase::Start());
@@ -20,6 +20,7 @@
 #include "yb/client/transaction_pool.h"
 
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/sysinfo.h"
 
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 #include "yb/yql/cql/cqlserver/cql_rpc.h"
@@ -30,6 +31,7 @@
 #include "yb/tserver/tablet_server.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/mem_tracker.h"
 
 using namespace std::placeholders;
@@ -40,6 +42,20 @@ DECLARE_bool(use_cassandra_authentication);
 DEFINE_int64(cql_service_max_prepared_statement_size_bytes, 128_MB,
              "The maximum amount of memory the CQL proxy should use to maintain prepared "
              "statements. 0 or negative means unlimited.");
+DEFINE_int64(cql_service_max_unprepared_statement_size_bytes, 32_MB,
+             "The maximum amount of memory the CQL proxy should use to cache analyzed statements of "
+             "QUERY requests, so the same statement text is not parsed and analyzed again. 0 "
+             "disables the cache, negative means unlimited.");
+DEFINE_int32(cql_service_cpu_available_processors, 16,
+             "The maximum number of available CQL processors kept for reuse by each CPU. Extra "
+             "available processors are kept in a list shared by all CPUs.");
+TAG_FLAG(cql_service_cpu_available_processors, advanced);
+DEFINE_int32(cql_statement_stats_max_entries, 1000,
+             "The maximum number of statements whose execution statistics are kept by the CQL "
+             "proxy. 0 disables the statistics.");
+DEFINE_double(cql_statement_stats_sampling_rate, 1.0,
+              "The fraction of statement executions recorded in the statement statistics.");
+TAG_FLAG(cql_statement_stats_sampling_rate, advanced);
 DEFINE_int32(cql_ybclient_reactor_threads, 24,
              "The number of reactor threads to be used for processing ybclient "
              "requests originating in the cql layer");
@@ -69,18 +85,33 @@ CQLServiceImpl::CQLServiceImpl(CQLServer* server, const CQLServerOptions& opts,
           server->tserver() ? server->tserver()->permanent_uuid() : "",
           &opts, server->metric_entity(), server->mem_tracker(),
           server->tserver() ? server->tserver()->messenger() : nullptr),
-      next_available_processor_(processors_.end()),
+      overflow_available_processors_(0),
       messenger_(server->messenger()),
       local_tablet_filter_(std::move(local_tablet_filter)) {
+  // The actual number of CPUs is needed, as sched_getcpu() may return any of them.
+  const size_t num_cpus = base::MaxCPUIndex() + 1;
+  while (cpu_available_processors_.size() != num_cpus) {
+    cpu_available_processors_.emplace_back(FLAGS_cql_service_cpu_available_processors);
+  }
+
   // TODO(ENG-446): Handle metrics for all the methods individually.
   cql_metrics_ = std::make_shared<CQLMetrics>(server->metric_entity());
 
-  // Setup prepared statements' memory tracker. Add garbage-collect function to delete least
-  // recently used statements when limit is hit.
-  prepared_stmts_mem_tracker_ = MemTracker::CreateTracker(
-      FLAGS_cql_service_max_prepared_statement_size_bytes > 0 ?
-      FLAGS_cql_service_max_prepared_statement_size_bytes : -1,
-      "CQL prepared statements", server->mem_tracker());
+  // Setup statement caches. Their garbage-collect functions are added to their memory trackers in
+  // CompleteInit() to delete least recently used statements when limit is hit.
+  prepared_stmts_ = std::make_shared<CQLStatementCache>(
+      "CQL prepared statements", FLAGS_cql_service_max_prepared_statement_size_bytes,
+      server->mem_tracker());
+  if (FLAGS_cql_service_max_unprepared_statement_size_bytes != 0) {
+    unprepared_stmts_ = std::make_shared<CQLStatementCache>(
+        "CQL unprepared statements", FLAGS_cql_service_max_unprepared_statement_size_bytes,
+        server->mem_tracker());
+  }
+
+  if (FLAGS_cql_statement_stats_max_entries > 0) {
+    statement_stats_ = std::make_shared<CQLStatementStats>(
+        FLAGS_cql_statement_stats_max_entries, FLAGS_cql_statement_stats_sampling_rate);
+  }
 
   auth_prepared_stmt_ = std::make_shared<ql::Statement>(
       "",
@@ -120,7 +151,10 @@ const std::shared_ptr<client::YBMetaDataCache>& CQLServiceImpl::metadata_cache()
 }
 
 void CQLServiceImpl::CompleteInit() {
-  prepared_stmts_mem_tracker_->AddGarbageCollector(shared_from_this());
+  prepared_stmts_->mem_tracker()->AddGarbageCollector(prepared_stmts_);
+  if (unprepared_stmts_) {
+    unprepared_stmts_->mem_tracker()->AddGarbageCollector(unprepared_stmts_);
+  }
 }
 
 void CQLServiceImpl::Shutdown() {
@@ -144,132 +178,62 @@ void CQLServiceImpl::Handle(yb::rpc::InboundCallPtr inbound_call) {
 }
 
 CQLProcessor *CQLServiceImpl::GetProcessor() {
+  // Retrieve an available processor of the current CPU, or one from the overflow stack. Before
+  // creating a new processor, take an available one of the other CPUs.
+  CQLProcessor* processor = nullptr;
+  const size_t cpu = CurrentCPU();
+  if (cpu_available_processors_[cpu].pop(processor) ||
+      overflow_available_processors_.pop(processor)) {
+    return processor;
+  }
+  for (size_t i = 1; i < cpu_available_processors_.size(); ++i) {
+    if (cpu_available_processors_[(cpu + i) % cpu_available_processors_.size()].pop(processor)) {
+      return processor;
+    }
+  }
+
+  // If none is available, allocate a new slot in the list. Then create the processor outside the
+  // mutex below.
   CQLProcessorListPos pos;
   {
-    // Retrieve the next available processor. If none is available, allocate a new slot in the list.
-    // Then create the processor outside the mutex below.
     std::lock_guard<std::mutex> guard(processors_mutex_);
-    pos = (next_available_processor_ != processors_.end() ?
-           next_available_processor_++ : processors_.emplace(processors_.end()));
-  }
-
-  if (pos->get() == nullptr) {
-    pos->reset(new CQLProcessor(this, pos));
+    pos = processors_.emplace(processors_.end());
   }
+  pos->reset(new CQLProcessor(this, pos));
   return pos->get();
 }
 
 void CQLServiceImpl::ReturnProcessor(const CQLProcessorListPos& pos) {
-  // Put the processor back before the next available one.
-  std::lock_guard<std::mutex> guard(processors_mutex_);
-  processors_.splice(next_available_processor_, processors_, pos);
-  next_available_processor_ = pos;
+  // Keep the processor for the CPU it has just run on.
+  if (!cpu_available_processors_[CurrentCPU()].bounded_push(pos->get())) {
+    overflow_available_processors_.push(pos->get());
+  }
+}
+
+size_t CQLServiceImpl::CurrentCPU() const {
+#if defined(__APPLE__)
+  // OSX doesn't have a way to get the CPU, so pick one by the current thread.
+  return std::hash<std::thread::id>()(std::this_thread::get_id()) %
+         cpu_available_processors_.size();
+#else
+  const size_t cpu = sched_getcpu();
+  DCHECK_LT(cpu, cpu_available_processors_.size());
+  return cpu % cpu_available_processors_.size();
+#endif // defined(__APPLE__)
 }
 
 shared_ptr<CQLStatement> CQLServiceImpl::AllocatePreparedStatement(
     const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
-  // Get exclusive lock before allocating a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  shared_ptr<CQLStatement> stmt;
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    // Allocate the prepared statement placeholder that multiple clients trying to prepare the same
-    // statement to contend on. The statement will then be prepared by one client while the rest
-    // wait for the results.
-    stmt = prepared_stmts_map_.emplace(
-        query_id, std::make_shared<CQLStatement>(
-            keyspace, query, prepared_stmts_list_.end())).first->second;
-    InsertLruPreparedStatementUnlocked(stmt);
-  } else {
-    // Return existing statement if found.
-    stmt = itr->second;
-    MoveLruPreparedStatementUnlocked(stmt);
-  }
-
-  VLOG(1) << "InsertPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
-
-  return stmt;
+  return prepared_stmts_->Allocate(query_id, keyspace, query);
 }
 
 shared_ptr<const CQLStatement> CQLServiceImpl::GetPreparedStatement(
     const CQLMessage::QueryId& query_id) {
-  // Get exclusive lock before looking up a prepared statement and updating the LRU list.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  const auto itr = prepared_stmts_map_.find(query_id);
-  if (itr == prepared_stmts_map_.end()) {
-    return nullptr;
-  }
-
-  shared_ptr<CQLStatement> stmt = itr->second;
-
-  // If the statement has not finished preparing, do not return it.
-  if (stmt->unprepared()) {
-    return nullptr;
-  }
-  // If the statement is stale, delete it.
-  if (stmt->stale()) {
-    DeletePreparedStatementUnlocked(stmt);
-    return nullptr;
-  }
-
-  MoveLruPreparedStatementUnlocked(stmt);
-  return stmt;
+  return prepared_stmts_->Get(query_id);
 }
 
 void CQLServiceImpl::DeletePreparedStatement(const shared_ptr<const CQLStatement>& stmt) {
-  // Get exclusive lock before deleting the prepared statement.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  DeletePreparedStatementUnlocked(stmt);
-
-  VLOG(1) << "DeletePreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
-}
-
-void CQLServiceImpl::InsertLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Insert the statement at the front of the LRU list.
-  stmt->set_pos(prepared_stmts_list_.insert(prepared_stmts_list_.begin(), stmt));
-}
-
-void CQLServiceImpl::MoveLruPreparedStatementUnlocked(const shared_ptr<CQLStatement>& stmt) {
-  // Move the statement to the front of the LRU list.
-  prepared_stmts_list_.splice(prepared_stmts_list_.begin(), prepared_stmts_list_, stmt->pos());
-}
-
-void CQLServiceImpl::DeletePreparedStatementUnlocked(
-    const std::shared_ptr<const CQLStatement> stmt) {
-  // Remove statement from cache by looking it up by query ID and only when it is same statement
-  // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
-  // a separate copy of the shared_ptr and not the very shared_ptr in prepared_stmts_map_ or
-  // prepared_stmt_list_ we are deleting.
-  const auto itr = prepared_stmts_map_.find(stmt->query_id());
-  if (itr != prepared_stmts_map_.end() && itr->second == stmt) {
-    prepared_stmts_map_.erase(itr);
-  }
-  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
-  if (stmt->pos() != prepared_stmts_list_.end()) {
-    prepared_stmts_list_.erase(stmt->pos());
-    stmt->set_pos(prepared_stmts_list_.end());
-  }
-}
-
-void CQLServiceImpl::CollectGarbage(size_t required) {
-  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
-  // list from the cache.
-  std::lock_guard<std::mutex> guard(prepared_stmts_mutex_);
-
-  if (!prepared_stmts_list_.empty()) {
-    DeletePreparedStatementUnlocked(prepared_stmts_list_.back());
-  }
-
-  VLOG(1) << "DeleteLruPreparedStatement: CQL prepared statement cache count = "
-          << prepared_stmts_map_.size() << "/" << prepared_stmts_list_.size()
-          << ", memory usage = " << prepared_stmts_mem_tracker_->consumption();
+  prepared_stmts_->Delete(stmt);
 }
 
 client::TransactionPool* CQLServiceImpl::GetTransactionPool() {
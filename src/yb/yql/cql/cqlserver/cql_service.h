@@ -19,11 +19,15 @@
 
 #include <vector>
 
+#include <boost/container/stable_vector.hpp>
+#include <boost/lockfree/stack.hpp>
+
 #include "yb/client/client_fwd.h"
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_processor.h"
 #include "yb/yql/cql/cqlserver/cql_statement.h"
+#include "yb/yql/cql/cqlserver/cql_statement_stats.h"
 #include "yb/yql/cql/cqlserver/cql_service.service.h"
 #include "yb/yql/cql/cqlserver/cql_server_options.h"
 #include "yb/yql/cql/ql/statement.h"
@@ -44,7 +48,6 @@ class CQLProcessor;
 class CQLServer;
 
 class CQLServiceImpl : public CQLServerServiceIf,
-                       public GarbageCollector,
                        public std::enable_shared_from_this<CQLServiceImpl> {
  public:
   // Constructor.
@@ -76,7 +79,18 @@ class CQLServiceImpl : public CQLServerServiceIf,
 
   // Return the memory tracker for prepared statements.
   const MemTrackerPtr& prepared_stmts_mem_tracker() const {
-    return prepared_stmts_mem_tracker_;
+    return prepared_stmts_->mem_tracker();
+  }
+
+  // Analyzed statements of QUERY requests, by the query id of their keyspace and text. Nullptr
+  // when the cache is disabled.
+  const std::shared_ptr<CQLStatementCache>& unprepared_stmts() const {
+    return unprepared_stmts_;
+  }
+
+  // Execution statistics of statements. Nullptr when they are not collected.
+  const std::shared_ptr<CQLStatementStats>& statement_stats() const {
+    return statement_stats_;
   }
 
   // Return the YBClient to communicate with either master or tserver.
@@ -101,20 +115,8 @@ class CQLServiceImpl : public CQLServerServiceIf,
   // Either gets an available processor or creates a new one.
   CQLProcessor *GetProcessor();
 
-  // Insert a prepared statement at the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void InsertLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Move a prepared statement to the front of the LRU list. "prepared_stmts_mutex_" needs to be
-  // locked before this call.
-  void MoveLruPreparedStatementUnlocked(const std::shared_ptr<CQLStatement>& stmt);
-
-  // Delete a prepared statement from the cache and the LRU list. "prepared_stmts_mutex_" needs to
-  // be locked before this call.
-  void DeletePreparedStatementUnlocked(const std::shared_ptr<const CQLStatement> stmt);
-
-  // Delete the least recently used prepared statement from the cache to free up memory.
-  void CollectGarbage(size_t required) override;
+  // Index of the available processors of the current CPU.
+  size_t CurrentCPU() const;
 
   // CQLServer of this service.
   CQLServer* const server_;
@@ -127,29 +129,29 @@ class CQLServiceImpl : public CQLServerServiceIf,
   mutable std::atomic<bool> is_metadata_initialized_ = { false };
   mutable std::mutex metadata_init_mutex_;
 
-  // List of CQL processors (in-use and available). In-use ones are at the beginning and available
-  // ones at the end.
+  // List of all CQL processors (in-use and available).
   CQLProcessorList processors_;
 
-  // Next available CQL processor.
-  CQLProcessorListPos next_available_processor_;
-
-  // Mutex that protects access to processors_.
+  // Mutex that protects access to processors_. It is taken only when a processor is created.
   std::mutex processors_mutex_;
 
-  // Prepared statements cache.
-  CQLStatementMap prepared_stmts_map_;
+  // Available CQL processors of each CPU, so that a processor returned on a core is reused by the
+  // next call on the same core with its caches still warm. Processors that do not fit go to the
+  // overflow stack, which is shared by all CPUs.
+  using ProcessorStack = boost::lockfree::stack<CQLProcessor*>;
+  boost::container::stable_vector<ProcessorStack> cpu_available_processors_;
+  ProcessorStack overflow_available_processors_;
 
-  // Prepared statements LRU list (least recently used one at the end).
-  CQLStatementList prepared_stmts_list_;
+  // Prepared statements cache.
+  std::shared_ptr<CQLStatementCache> prepared_stmts_;
 
-  // Mutex that protects the prepared statements and the LRU list.
-  std::mutex prepared_stmts_mutex_;
+  // Cache of analyzed unprepared statements.
+  std::shared_ptr<CQLStatementCache> unprepared_stmts_;
 
   std::shared_ptr<ql::Statement> auth_prepared_stmt_;
 
-  // Tracker to measure and limit memory usage of prepared statements.
-  MemTrackerPtr prepared_stmts_mem_tracker_;
+  // Execution statistics of statements.
+  std::shared_ptr<CQLStatementStats> statement_stats_;
 
   // Metrics to be collected and reported.
   yb::rpc::RpcMethodMetrics metrics_;
@@ -20,6 +20,9 @@
 namespace yb {
 namespace cqlserver {
 
+using std::shared_ptr;
+using std::string;
+
 //------------------------------------------------------------------------------------------------
 CQLStatement::CQLStatement(
     const string& keyspace, const string& query, const CQLStatementListPos pos)
@@ -39,5 +42,116 @@ CQLMessage::QueryId CQLStatement::GetQueryId(const string& keyspace, const strin
   return CQLMessage::QueryId(util::to_char_ptr(md5), sizeof(md5));
 }
 
+//------------------------------------------------------------------------------------------------
+CQLStatementCache::CQLStatementCache(
+    const string& name, const int64_t limit, const MemTrackerPtr& parent)
+    : name_(name),
+      mem_tracker_(MemTracker::CreateTracker(limit > 0 ? limit : -1, name, parent)) {
+}
+
+CQLStatementCache::~CQLStatementCache() {
+}
+
+shared_ptr<CQLStatement> CQLStatementCache::Allocate(
+    const CQLMessage::QueryId& query_id, const string& keyspace, const string& query) {
+  // Get exclusive lock before allocating a statement and updating the LRU list.
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  shared_ptr<CQLStatement> stmt;
+  const auto itr = map_.find(query_id);
+  if (itr == map_.end()) {
+    // Allocate the statement placeholder that multiple clients trying to prepare the same
+    // statement to contend on. The statement will then be prepared by one client while the rest
+    // wait for the results.
+    stmt = map_.emplace(
+        query_id, std::make_shared<CQLStatement>(keyspace, query, list_.end())).first->second;
+    InsertLruUnlocked(stmt);
+  } else {
+    // Return existing statement if found.
+    stmt = itr->second;
+    MoveLruUnlocked(stmt);
+  }
+
+  LogUsageUnlocked("Insert");
+  return stmt;
+}
+
+shared_ptr<const CQLStatement> CQLStatementCache::Get(const CQLMessage::QueryId& query_id) {
+  // Get exclusive lock before looking up a statement and updating the LRU list.
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  const auto itr = map_.find(query_id);
+  if (itr == map_.end()) {
+    return nullptr;
+  }
+
+  shared_ptr<CQLStatement> stmt = itr->second;
+
+  // If the statement has not finished preparing, do not return it.
+  if (stmt->unprepared()) {
+    return nullptr;
+  }
+  // If the statement is stale, delete it.
+  if (stmt->stale()) {
+    DeleteUnlocked(stmt);
+    return nullptr;
+  }
+
+  MoveLruUnlocked(stmt);
+  return stmt;
+}
+
+void CQLStatementCache::Delete(const shared_ptr<const CQLStatement>& stmt) {
+  // Get exclusive lock before deleting the statement.
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  DeleteUnlocked(stmt);
+
+  LogUsageUnlocked("Delete");
+}
+
+void CQLStatementCache::InsertLruUnlocked(const shared_ptr<CQLStatement>& stmt) {
+  // Insert the statement at the front of the LRU list.
+  stmt->set_pos(list_.insert(list_.begin(), stmt));
+}
+
+void CQLStatementCache::MoveLruUnlocked(const shared_ptr<CQLStatement>& stmt) {
+  // Move the statement to the front of the LRU list.
+  list_.splice(list_.begin(), list_, stmt->pos());
+}
+
+void CQLStatementCache::DeleteUnlocked(const shared_ptr<const CQLStatement> stmt) {
+  // Remove statement from cache by looking it up by query ID and only when it is same statement
+  // object. Note that the "stmt" parameter above is not a ref ("&") intentionally so that we have
+  // a separate copy of the shared_ptr and not the very shared_ptr in map_ or list_ we are
+  // deleting.
+  const auto itr = map_.find(stmt->query_id());
+  if (itr != map_.end() && itr->second == stmt) {
+    map_.erase(itr);
+  }
+  // Remove statement from LRU list only when it is in the list, i.e. pos() != end().
+  if (stmt->pos() != list_.end()) {
+    list_.erase(stmt->pos());
+    stmt->set_pos(list_.end());
+  }
+}
+
+void CQLStatementCache::CollectGarbage(size_t required) {
+  // Get exclusive lock before deleting the least recently used statement at the end of the LRU
+  // list from the cache.
+  std::lock_guard<std::mutex> guard(mutex_);
+
+  if (!list_.empty()) {
+    DeleteUnlocked(list_.back());
+  }
+
+  LogUsageUnlocked("DeleteLru");
+}
+
+void CQLStatementCache::LogUsageUnlocked(const char* action) const {
+  VLOG(1) << action << ": " << name_ << " cache count = " << map_.size() << "/" << list_.size()
+          << ", memory usage = " << mem_tracker_->consumption();
+}
+
 }  // namespace cqlserver
 }  // namespace yb
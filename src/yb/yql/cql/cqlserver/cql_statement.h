@@ -20,6 +20,10 @@
 #define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_H_
 
 #include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "yb/util/mem_tracker.h"
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/ql/statement.h"
@@ -59,6 +63,62 @@ class CQLStatement : public ql::Statement {
   mutable CQLStatementListPos pos_;
 };
 
+// A cache of CQL statements by query id. The memory used by the parse trees of the statements is
+// tracked by mem_tracker(), and the least recently used statements are deleted when its limit is
+// hit.
+class CQLStatementCache : public GarbageCollector {
+ public:
+  // limit <= 0 means unlimited.
+  CQLStatementCache(const std::string& name, int64_t limit, const MemTrackerPtr& parent);
+  ~CQLStatementCache();
+
+  // Allocate a statement. If the statement already exists, return it instead.
+  std::shared_ptr<CQLStatement> Allocate(
+      const CQLMessage::QueryId& id, const std::string& keyspace, const std::string& query);
+
+  // Look up a prepared statement by its id. Nullptr will be returned if the statement is not found,
+  // not prepared yet or stale. Stale statements are deleted.
+  std::shared_ptr<const CQLStatement> Get(const CQLMessage::QueryId& id);
+
+  // Delete the statement from the cache.
+  void Delete(const std::shared_ptr<const CQLStatement>& stmt);
+
+  // Return the memory tracker for the statements.
+  const MemTrackerPtr& mem_tracker() const {
+    return mem_tracker_;
+  }
+
+  // Delete the least recently used statement from the cache to free up memory.
+  void CollectGarbage(size_t required) override;
+
+ private:
+  // Insert a statement at the front of the LRU list. "mutex_" needs to be locked before this call.
+  void InsertLruUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+
+  // Move a statement to the front of the LRU list. "mutex_" needs to be locked before this call.
+  void MoveLruUnlocked(const std::shared_ptr<CQLStatement>& stmt);
+
+  // Delete a statement from the cache and the LRU list. "mutex_" needs to be locked before this
+  // call.
+  void DeleteUnlocked(const std::shared_ptr<const CQLStatement> stmt);
+
+  void LogUsageUnlocked(const char* action) const;
+
+  const std::string name_;
+
+  // Statements cache.
+  CQLStatementMap map_;
+
+  // Statements LRU list (least recently used one at the end).
+  CQLStatementList list_;
+
+  // Mutex that protects the statements and the LRU list.
+  std::mutex mutex_;
+
+  // Tracker to measure and limit memory usage of the statements.
+  MemTrackerPtr mem_tracker_;
+};
+
 }  // namespace cqlserver
 }  // namespace yb
 
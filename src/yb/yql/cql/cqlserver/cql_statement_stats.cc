@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//--------------------------------------------------------------------------------------------------
+
+#include "yb/yql/cql/cqlserver/cql_statement_stats.h"
+
+#include "yb/util/random_util.h"
+
+#include "yb/yql/cql/cqlserver/cql_statement.h"
+
+namespace yb {
+namespace cqlserver {
+
+namespace {
+
+// Latencies are tracked up to 60 seconds with 1 significant digit, which keeps the histogram of
+// each statement small.
+constexpr uint64_t kMaxLatencyUs = 60000000LU;
+constexpr int kLatencySignificantDigits = 1;
+
+} // namespace
+
+CQLStatementStats::Entry::Entry(const std::string& keyspace_, const std::string& text_)
+    : keyspace(keyspace_), text(text_), latency_us(kMaxLatencyUs, kLatencySignificantDigits) {
+}
+
+CQLStatementStats::CQLStatementStats(const size_t max_entries, const double sampling_rate)
+    : max_entries_(max_entries), sampling_rate_(sampling_rate) {
+}
+
+CQLStatementStats::~CQLStatementStats() {
+}
+
+bool CQLStatementStats::Sample() const {
+  return sampling_rate_ >= 1.0 || RandomActWithProbability(sampling_rate_);
+}
+
+void CQLStatementStats::Record(
+    const CQLStatement& stmt, const MonoDelta elapsed, const size_t rows, const int retries,
+    const bool failed) {
+  const CQLMessage::QueryId query_id = stmt.query_id();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(query_id);
+  if (it == entries_.end()) {
+    if (entries_.size() >= max_entries_) {
+      dropped_calls_++;
+      return;
+    }
+    it = entries_.emplace(
+        query_id, std::make_unique<Entry>(stmt.keyspace(), stmt.text())).first;
+  }
+  Entry& entry = *it->second;
+  entry.calls++;
+  if (failed) {
+    entry.errors++;
+  }
+  entry.rows += rows;
+  entry.retries += retries;
+  entry.latency_us.Increment(std::min<int64_t>(elapsed.ToMicroseconds(), kMaxLatencyUs));
+}
+
+void CQLStatementStats::WriteAsJson(JsonWriter* writer) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  writer->StartObject();
+  writer->String("sampling_rate");
+  writer->Double(sampling_rate_);
+  writer->String("dropped_calls");
+  writer->Int64(dropped_calls_);
+  writer->String("statements");
+  writer->StartArray();
+  for (const auto& id_and_entry : entries_) {
+    const Entry& entry = *id_and_entry.second;
+    writer->StartObject();
+    writer->String("keyspace");
+    writer->String(entry.keyspace);
+    writer->String("query");
+    writer->String(entry.text);
+    writer->String("calls");
+    writer->Int64(entry.calls);
+    writer->String("errors");
+    writer->Int64(entry.errors);
+    writer->String("rows");
+    writer->Int64(entry.rows);
+    writer->String("retries");
+    writer->Int64(entry.retries);
+    writer->String("total_latency_us");
+    writer->Uint64(entry.latency_us.TotalSum());
+    writer->String("mean_latency_us");
+    writer->Double(entry.latency_us.MeanValue());
+    writer->String("p99_latency_us");
+    writer->Uint64(entry.latency_us.ValueAtPercentile(99));
+    writer->String("max_latency_us");
+    writer->Uint64(entry.latency_us.MaxValue());
+    writer->EndObject();
+  }
+  writer->EndArray();
+  writer->EndObject();
+}
+
+void CQLStatementStats::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  dropped_calls_ = 0;
+}
+
+}  // namespace cqlserver
+}  // namespace yb
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+//
+// This class collects execution statistics of CQL statements by the query id of their keyspace and
+// text, so that expensive statements can be found on a CQL server.
+//--------------------------------------------------------------------------------------------------
+
+#ifndef YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_STATS_H_
+#define YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_STATS_H_
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/jsonwriter.h"
+#include "yb/util/monotime.h"
+
+#include "yb/yql/cql/cqlserver/cql_message.h"
+
+namespace yb {
+namespace cqlserver {
+
+class CQLStatement;
+
+class CQLStatementStats {
+ public:
+  // Statistics of at most max_entries statements are kept. Executions are recorded with the given
+  // sampling rate between 0 and 1.
+  CQLStatementStats(size_t max_entries, double sampling_rate);
+  ~CQLStatementStats();
+
+  // Whether the current execution should be recorded.
+  bool Sample() const;
+
+  // Record an execution of the statement that took elapsed time, returned rows and was retried
+  // retries times. If the statement is new and there are max_entries statements already, it is
+  // not recorded.
+  void Record(const CQLStatement& stmt, MonoDelta elapsed, size_t rows, int retries, bool failed);
+
+  // Write the statistics of the statements as a JSON object.
+  void WriteAsJson(JsonWriter* writer) const;
+
+  // Drop the statistics of all statements.
+  void Reset();
+
+ private:
+  struct Entry {
+    Entry(const std::string& keyspace, const std::string& text);
+
+    const std::string keyspace;
+    const std::string text;
+    int64_t calls = 0;
+    int64_t errors = 0;
+    int64_t rows = 0;
+    int64_t retries = 0;
+    HdrHistogram latency_us;
+  };
+
+  const size_t max_entries_;
+  const double sampling_rate_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<CQLMessage::QueryId, std::unique_ptr<Entry>> entries_;
+  // Number of executions not recorded because there were max_entries_ statements already.
+  int64_t dropped_calls_ = 0;
+};
+
+}  // namespace cqlserver
+}  // namespace yb
+
+#endif  // YB_YQL_CQL_CQLSERVER_CQL_STATEMENT_STATS_H_
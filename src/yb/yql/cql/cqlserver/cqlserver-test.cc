@@ -20,12 +20,16 @@
 
 #include "yb/yql/cql/cqlserver/cql_message.h"
 #include "yb/yql/cql/cqlserver/cql_server.h"
+#include "yb/yql/cql/cqlserver/cql_statement.h"
+#include "yb/yql/cql/cqlserver/cql_statement_stats.h"
 
 #include "yb/gutil/strings/join.h"
 #include "yb/util/cast.h"
 #include "yb/util/net/net_util.h"
 #include "yb/util/test_util.h"
 
+DECLARE_int32(cql_rows_data_trailer_min_bytes);
+
 namespace yb {
 namespace cqlserver {
 
@@ -251,5 +255,122 @@ TEST_F(TestCQLService, TestCQLServerEventConst) {
   ASSERT_EQ(0, memcmp(buffer, ptr, kSize));
 }
 
+TEST(CQLStatementCacheTest, AllocateAndDelete) {
+  auto cache = std::make_shared<CQLStatementCache>(
+      "test statements", 0 /* limit */, MemTracker::GetRootTracker());
+  const string query = "SELECT * FROM t WHERE k = 1";
+  const auto id1 = CQLStatement::GetQueryId("ks1", query);
+  const auto id2 = CQLStatement::GetQueryId("ks2", query);
+  ASSERT_NE(id1, id2);
+
+  // The same statement is shared by the callers allocating it, but it is not returned before it
+  // is prepared.
+  auto stmt = cache->Allocate(id1, "ks1", query);
+  ASSERT_EQ(stmt, cache->Allocate(id1, "ks1", query));
+  ASSERT_NE(stmt, cache->Allocate(id2, "ks2", query));
+  ASSERT_EQ(nullptr, cache->Get(id1));
+
+  // Least recently used statements are collected first.
+  ASSERT_EQ(stmt, cache->Allocate(id1, "ks1", query));
+  cache->CollectGarbage(1);
+  ASSERT_EQ(stmt, cache->Allocate(id1, "ks1", query));
+  cache->CollectGarbage(1);
+  ASSERT_NE(stmt, cache->Allocate(id1, "ks1", query));
+
+  stmt = cache->Allocate(id1, "ks1", query);
+  cache->Delete(stmt);
+  ASSERT_NE(stmt, cache->Allocate(id1, "ks1", query));
+}
+
+TEST(CQLStatementStatsTest, RecordAndReset) {
+  CQLStatementStats stats(2 /* max_entries */, 1.0 /* sampling_rate */);
+  ASSERT_TRUE(stats.Sample());
+
+  const CQLStatement stmt1("ks", "SELECT * FROM t WHERE k = ?", CQLStatementListPos());
+  const CQLStatement stmt2("ks", "INSERT INTO t (k) VALUES (?)", CQLStatementListPos());
+  const CQLStatement stmt3("ks", "DELETE FROM t WHERE k = ?", CQLStatementListPos());
+  stats.Record(stmt1, MonoDelta::FromMicroseconds(100), 1 /* rows */, 0 /* retries */, false);
+  stats.Record(stmt1, MonoDelta::FromMicroseconds(300), 2 /* rows */, 1 /* retries */, true);
+  stats.Record(stmt2, MonoDelta::FromMicroseconds(50), 0 /* rows */, 0 /* retries */, false);
+  // There is no room for new statements.
+  stats.Record(stmt3, MonoDelta::FromMicroseconds(50), 0 /* rows */, 0 /* retries */, false);
+
+  std::stringstream out;
+  {
+    JsonWriter writer(&out, JsonWriter::COMPACT);
+    stats.WriteAsJson(&writer);
+  }
+  const string json = out.str();
+  ASSERT_STR_CONTAINS(json, "\"dropped_calls\":1");
+  ASSERT_STR_CONTAINS(json, "\"query\":\"SELECT * FROM t WHERE k = ?\",\"calls\":2,\"errors\":1,"
+                            "\"rows\":3,\"retries\":1,\"total_latency_us\":400");
+  ASSERT_STR_CONTAINS(json, "\"query\":\"INSERT INTO t (k) VALUES (?)\",\"calls\":1");
+  ASSERT_EQ(string::npos, json.find("DELETE"));
+
+  stats.Reset();
+  out.str("");
+  {
+    JsonWriter writer(&out, JsonWriter::COMPACT);
+    stats.WriteAsJson(&writer);
+  }
+  ASSERT_STR_CONTAINS(out.str(), "\"dropped_calls\":0,\"statements\":[]");
+}
+
+TEST(CQLMessageTest, RowsDataTrailer) {
+  const string query_mesg = BINARY_STRING("\x04\x00\x00\x01\x07" "\x00\x00\x00\x0f"
+                                          "\x00\x00\x00\x08" "SELECT 1"
+                                          "\x00\x01" "\x00");
+  unique_ptr<CQLRequest> request;
+  unique_ptr<CQLResponse> error_response;
+  ASSERT_TRUE(CQLRequest::ParseRequest(
+      query_mesg, CQLMessage::CompressionScheme::kNone, &request, &error_response));
+
+  for (const size_t rows_data_size : {16, 64 * 1024}) {
+    auto result = std::make_shared<ql::RowsResult>(
+        client::YBTableName("ks", "t"), std::make_shared<vector<ColumnSchema>>(),
+        string(rows_data_size, 'x'));
+    RowsResultResponse response(down_cast<const QueryRequest&>(*request), result);
+
+    faststring expected;
+    response.Serialize(CQLMessage::CompressionScheme::kNone, &expected);
+
+    // Only large rows data is sent in a trailer, and the message with the trailer is the same as
+    // the message serialized as a whole.
+    faststring mesg;
+    RefCntBuffer trailer;
+    response.Serialize(CQLMessage::CompressionScheme::kNone, &mesg, &trailer);
+    ASSERT_EQ(rows_data_size >= static_cast<size_t>(FLAGS_cql_rows_data_trailer_min_bytes),
+              !trailer.empty());
+    mesg.append(trailer.data(), trailer.size());
+    ASSERT_EQ(expected.ToString(), mesg.ToString());
+
+    // Compressed responses are never split.
+    faststring compressed;
+    trailer = RefCntBuffer();
+    response.Serialize(CQLMessage::CompressionScheme::kLz4, &compressed, &trailer);
+    ASSERT_TRUE(trailer.empty());
+  }
+}
+
+TEST(CQLMessageTest, BindVariableValues) {
+  const string query_mesg = BINARY_STRING("\x04\x00\x00\x01\x07" "\x00\x00\x00\x19"
+                                          "\x00\x00\x00\x08" "SELECT ?"
+                                          "\x00\x01" "\x01" "\x00\x01"
+                                          "\x00\x00\x00\x04" "\x00\x00\x00\x2a");
+  unique_ptr<CQLRequest> request;
+  unique_ptr<CQLResponse> error_response;
+  ASSERT_TRUE(CQLRequest::ParseRequest(
+      query_mesg, CQLMessage::CompressionScheme::kNone, &request, &error_response));
+
+  // The bound value references the request message and is converted when it is bound.
+  const auto& params = down_cast<const QueryRequest&>(*request).params();
+  ASSERT_EQ(1, params.values.size());
+  ASSERT_EQ(query_mesg.data() + query_mesg.size() - 8,
+            params.values[0].value.cdata());
+  QLValue value;
+  ASSERT_OK(params.GetBindVariable("", 0, QLType::Create(DataType::INT32), &value));
+  ASSERT_EQ(42, value.int32_value());
+}
+
 }  // namespace cqlserver
 }  // namespace yb
@@ -30,10 +30,17 @@
 #include "yb/common/wire_protocol.h"
 #include "yb/rpc/thread_pool.h"
 #include "yb/util/decimal.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/logging.h"
 #include "yb/util/thread_restrictions.h"
 #include "yb/util/trace.h"
 
+DEFINE_bool(enable_parallel_aggregate_scan, true,
+            "Whether an aggregate SELECT over the whole table reads the partial aggregates of all "
+            "tablets concurrently instead of scanning the tablets one after another.");
+TAG_FLAG(enable_parallel_aggregate_scan, advanced);
+TAG_FLAG(enable_parallel_aggregate_scan, runtime);
+
 namespace yb {
 namespace ql {
 
@@ -846,6 +853,29 @@ Status Executor::ExecPTNode(const PTSelectStmt *tnode, TnodeContext* tnode_conte
     }
   }
 
+  // An aggregate over the whole table returns one partial aggregate per tablet, which are combined
+  // in AggregateResultSets. Read them all at once rather than following the paging state from one
+  // tablet to the next.
+  if (FLAGS_enable_parallel_aggregate_scan && tnode->is_aggregate() && !continue_select &&
+      !tnode->is_system() && !tnode->child_select() && !tnode->limit() && !tnode->offset() &&
+      req->hashed_column_values().empty() && tnode_context->UnreadPartitionsRemaining() == 0 &&
+      table->partition_schema().IsHashPartitioning() && table->GetPartitions().size() > 1) {
+    bool added = false;
+    for (size_t i = 0; i != table->GetPartitions().size(); ++i) {
+      YBqlReadOpPtr op(table->NewQLSelect());
+      op->mutable_request()->CopyFrom(select_op->request());
+      op->set_yb_consistency_level(select_op->yb_consistency_level());
+      // Skip tablets outside of the token range of the statement.
+      if (op->RestrictToPartition(i)) {
+        RETURN_NOT_OK(AddOperation(op, tnode_context));
+        added = true;
+      }
+    }
+    if (added) {
+      return Status::OK();
+    }
+  }
+
   // If this select statement uses an uncovered index underneath, save this op as a template to
   // read from the table once the primary keys are returned from the uncovered index. The paging
   // state should be used by the underlying select from the index only which decides where to
@@ -78,6 +78,14 @@ METRIC_DEFINE_histogram(
     server, handler_latency_yb_cqlserver_SQLProcessor_ResponseSize,
     "Size of the returned response blob (in bytes)", yb::MetricUnit::kBytes,
     "Size of the returned response blob (in bytes)", 60000000LU, 2);
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_SQLProcessor_UnpreparedStmtCacheHits,
+    "Unprepared statements found analyzed in the cache", yb::MetricUnit::kRequests,
+    "Unprepared statements found analyzed in the cache");
+METRIC_DEFINE_counter(
+    server, yb_cqlserver_SQLProcessor_UnpreparedStmtCacheMisses,
+    "Unprepared statements parsed and analyzed", yb::MetricUnit::kRequests,
+    "Unprepared statements parsed and analyzed");
 
 namespace yb {
 namespace ql {
@@ -120,6 +128,11 @@ QLMetrics::QLMetrics(const scoped_refptr<yb::MetricEntity> &metric_entity) {
 
   ql_response_size_bytes_ =
       METRIC_handler_latency_yb_cqlserver_SQLProcessor_ResponseSize.Instantiate(metric_entity);
+
+  ql_unprepared_stmt_cache_hits_ =
+      METRIC_yb_cqlserver_SQLProcessor_UnpreparedStmtCacheHits.Instantiate(metric_entity);
+  ql_unprepared_stmt_cache_misses_ =
+      METRIC_yb_cqlserver_SQLProcessor_UnpreparedStmtCacheMisses.Instantiate(metric_entity);
 }
 
 QLProcessor::QLProcessor(client::YBClient* client,
@@ -50,6 +50,10 @@ class QLMetrics {
   scoped_refptr<yb::Histogram> ql_transaction_;
 
   scoped_refptr<yb::Histogram> ql_response_size_bytes_;
+
+  // Lookups of unprepared statements in the cache of analyzed statements.
+  scoped_refptr<yb::Counter> ql_unprepared_stmt_cache_hits_;
+  scoped_refptr<yb::Counter> ql_unprepared_stmt_cache_misses_;
 };
 
 class QLProcessor : public Rescheduler {
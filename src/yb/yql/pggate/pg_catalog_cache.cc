@@ -0,0 +1,141 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//--------------------------------------------------------------------------------------------------
+
+#include "yb/yql/pggate/pg_catalog_cache.h"
+
+#include <unistd.h>
+
+#include "yb/common/entity_ids.h"
+#include "yb/gutil/hash/hash.h"
+#include "yb/gutil/stringprintf.h"
+#include "yb/util/env.h"
+#include "yb/util/path_util.h"
+#include "yb/yql/pggate/pggate_flags.h"
+#include "yb/yql/pggate/util/pg_wire.h"
+
+namespace yb {
+namespace pggate {
+
+namespace {
+
+// Oids below FirstNormalObjectId (see access/transam.h in Postgres) belong to catalog tables.
+constexpr uint32_t kPgFirstNormalObjectId = 16384;
+
+// Incremented when the file layout or the rows data format changes.
+constexpr int64_t kCatalogCacheFormatVersion = 1;
+
+Result<Slice> ReadBytes(Slice* cursor) {
+  int64_t size;
+  if (cursor->size() < sizeof(size)) {
+    return STATUS(Corruption, "Unexpected end of catalog cache file");
+  }
+  cursor->remove_prefix(PgWire::ReadNumber(cursor, &size));
+  if (size < 0 || static_cast<size_t>(size) > cursor->size()) {
+    return STATUS_FORMAT(Corruption, "Invalid size in catalog cache file: $0", size);
+  }
+  Slice result(cursor->data(), size);
+  cursor->remove_prefix(size);
+  return result;
+}
+
+void WriteBytes(const std::string& data, faststring* buffer) {
+  PgWire::WriteInt64(data.size(), buffer);
+  buffer->append(data.data(), data.size());
+}
+
+} // namespace
+
+std::string PgCatalogCache::Key(const PgsqlReadRequestPB& request, uint64_t catalog_version) {
+  if (FLAGS_ysql_catalog_cache_dir.empty() || catalog_version == 0) {
+    return std::string();
+  }
+  auto table_oid = GetPgsqlTableOid(request.table_id());
+  if (!table_oid.ok() || *table_oid >= kPgFirstNormalObjectId) {
+    return std::string();
+  }
+  // Only full scans are shared.
+  if (request.partition_column_values_size() != 0 || request.range_column_values_size() != 0 ||
+      request.has_ybctid_column_value() || request.has_index_request() ||
+      request.has_where_expr() || request.has_hash_code() || request.has_max_hash_code() ||
+      request.is_aggregate() || request.group_by_exprs_size() != 0) {
+    return std::string();
+  }
+
+  // Drop the fields that differ between backends or between pages of the same scan.
+  PgsqlReadRequestPB key_request = request;
+  key_request.clear_client();
+  key_request.clear_stmt_id();
+  key_request.clear_limit();
+  key_request.clear_paging_state();
+  key_request.clear_return_paging_state();
+  key_request.clear_max_parallelism();
+  key_request.clear_ysql_catalog_version();
+
+  std::string key = std::to_string(catalog_version) + ":";
+  key_request.AppendToString(&key);
+  return key;
+}
+
+std::string PgCatalogCache::FilePath(const std::string& key) {
+  return JoinPathSegments(
+      FLAGS_ysql_catalog_cache_dir, StringPrintf("%016" PRIx64, Hash64StringWithSeed(key, 0)));
+}
+
+Result<bool> PgCatalogCache::Load(const std::string& key, std::vector<std::string>* rows_data) {
+  const std::string path = FilePath(key);
+  Env* env = Env::Default();
+  if (!env->FileExists(path)) {
+    return false;
+  }
+  faststring data;
+  RETURN_NOT_OK(ReadFileToString(env, path, &data));
+
+  Slice cursor(data);
+  int64_t format_version;
+  if (cursor.size() < sizeof(format_version)) {
+    return STATUS(Corruption, "Catalog cache file is too short");
+  }
+  cursor.remove_prefix(PgWire::ReadNumber(&cursor, &format_version));
+  // A different key is a hash collision.
+  if (format_version != kCatalogCacheFormatVersion || VERIFY_RESULT(ReadBytes(&cursor)) != key) {
+    return false;
+  }
+
+  rows_data->clear();
+  while (!cursor.empty()) {
+    rows_data->push_back(VERIFY_RESULT(ReadBytes(&cursor)).ToBuffer());
+  }
+  return true;
+}
+
+Status PgCatalogCache::Store(const std::string& key, const std::vector<std::string>& rows_data) {
+  faststring data;
+  PgWire::WriteInt64(kCatalogCacheFormatVersion, &data);
+  WriteBytes(key, &data);
+  for (const auto& page : rows_data) {
+    WriteBytes(page, &data);
+  }
+
+  // Backends of the node could save the same scan concurrently, so the file is written under
+  // a temporary name and renamed, and readers never see a partially written file.
+  Env* env = Env::Default();
+  RETURN_NOT_OK(env->CreateDirs(FLAGS_ysql_catalog_cache_dir));
+  const std::string path = FilePath(key);
+  const std::string tmp_path = Format("$0.tmp.$1", path, getpid());
+  RETURN_NOT_OK(WriteStringToFile(env, data, tmp_path));
+  return env->RenameFile(tmp_path, path);
+}
+
+}  // namespace pggate
+}  // namespace yb
@@ -0,0 +1,58 @@
+//--------------------------------------------------------------------------------------------------
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//--------------------------------------------------------------------------------------------------
+
+#ifndef YB_YQL_PGGATE_PG_CATALOG_CACHE_H_
+#define YB_YQL_PGGATE_PG_CATALOG_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "yb/common/pgsql_protocol.pb.h"
+#include "yb/util/result.h"
+
+namespace yb {
+namespace pggate {
+
+// Catalog scans shared by the backends of a node.
+//
+// A backend preloads its relation cache with full scans of catalog tables when it starts and when
+// it refreshes the cache. The rows returned by these scans are saved to files in
+// ysql_catalog_cache_dir, keyed by the scan request and the catalog version. Backends that preload
+// the cache later at the same catalog version read the files instead of the master, which keeps
+// connection storms away from the master. It is a runtime counterpart of the initial sys catalog
+// snapshot.
+//
+// Only preloading uses the saved scans. CREATE statements do not increment the catalog version, so
+// a saved scan could miss objects created after it was saved. Preloading tolerates that, because
+// the relation cache looks up the missing objects in the master, the same as in the backends that
+// were already running when the objects were created.
+class PgCatalogCache {
+ public:
+  // Returns the key of the scan, or an empty string if the scan should not be shared.
+  static std::string Key(const PgsqlReadRequestPB& request, uint64_t catalog_version);
+
+  // Loads the rows data of the scan saved by Store(). Returns false if the scan is not saved.
+  static Result<bool> Load(const std::string& key, std::vector<std::string>* rows_data);
+
+  // Saves the rows data returned by all pages of the scan.
+  static CHECKED_STATUS Store(const std::string& key, const std::vector<std::string>& rows_data);
+
+ private:
+  static std::string FilePath(const std::string& key);
+};
+
+}  // namespace pggate
+}  // namespace yb
+
+#endif // YB_YQL_PGGATE_PG_CATALOG_CACHE_H_
@@ -101,6 +101,14 @@ class PgColumn {
 
   bool is_virtual_column();
 
+  // Forget the protobufs and requests of the statement that used this column.
+  void Reset() {
+    bind_pb_ = nullptr;
+    assign_pb_ = nullptr;
+    read_requested_ = false;
+    write_requested_ = false;
+  }
+
  private:
   ColumnDesc desc_;
 
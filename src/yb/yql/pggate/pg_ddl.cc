@@ -44,12 +44,14 @@ PgCreateDatabase::PgCreateDatabase(PgSession::ScopedRefPtr pg_session,
                                    const char *database_name,
                                    const PgOid database_oid,
                                    const PgOid source_database_oid,
-                                   const PgOid next_oid)
+                                   const PgOid next_oid,
+                                   const bool colocated)
     : PgDdl(std::move(pg_session)),
       database_name_(database_name),
       database_oid_(database_oid),
       source_database_oid_(source_database_oid),
-      next_oid_(next_oid) {
+      next_oid_(next_oid),
+      colocated_(colocated) {
 }
 
 PgCreateDatabase::~PgCreateDatabase() {
@@ -57,7 +59,7 @@ PgCreateDatabase::~PgCreateDatabase() {
 
 Status PgCreateDatabase::Exec() {
   return pg_session_->CreateDatabase(database_name_, database_oid_, source_database_oid_,
-                                     next_oid_);
+                                     next_oid_, colocated_);
 }
 
 PgDropDatabase::PgDropDatabase(PgSession::ScopedRefPtr pg_session,
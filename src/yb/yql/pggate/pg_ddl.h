@@ -48,7 +48,8 @@ class PgCreateDatabase : public PgDdl {
                    const char *database_name,
                    PgOid database_oid,
                    PgOid source_database_oid,
-                   PgOid next_oid);
+                   PgOid next_oid,
+                   const bool colocated);
   virtual ~PgCreateDatabase();
 
   StmtOp stmt_op() const override { return StmtOp::STMT_CREATE_DATABASE; }
@@ -61,6 +62,7 @@ class PgCreateDatabase : public PgDdl {
   const PgOid database_oid_;
   const PgOid source_database_oid_;
   const PgOid next_oid_;
+  const bool colocated_;
 };
 
 class PgDropDatabase : public PgDdl {
@@ -40,6 +40,23 @@ Status PgDml::LoadTable() {
   return Status::OK();
 }
 
+void PgDml::ResetForReuse() {
+  for (PgColumn& col : table_desc_->columns()) {
+    col.Reset();
+  }
+  CHECK_RESULT(table_desc_->FindColumn(static_cast<int>(PgSystemAttrNum::kYBTupleId)))->Reset();
+  targets_.clear();
+  ybctid_bind_ = false;
+  expr_binds_.clear();
+  expr_assigns_.clear();
+  exprs_.clear();
+  row_batch_.clear();
+  cursor_.clear();
+  columnar_tuples_ = PgColumnarTuples();
+  columnar_next_row_ = 0;
+  accumulated_row_count_ = 0;
+}
+
 Status PgDml::ClearBinds() {
   return STATUS(NotSupported, "Clearing binds for prepared statement is not yet implemented");
 }
@@ -236,7 +253,7 @@ Status PgDml::Fetch(int32_t natts,
   }
 
   // Load data from cache in doc_op_ to cursor_ if it is not pointing to any data.
-  if (cursor_.empty()) {
+  if (cursor_.empty() && columnar_next_row_ == columnar_tuples_.row_count()) {
     int64_t row_count = 0;
     // Keep reading untill we either reach the end or get some rows.
     while (row_count == 0) {
@@ -248,7 +265,15 @@ Status PgDml::Fetch(int32_t natts,
 
       // Read from cache.
       RETURN_NOT_OK(doc_op_->GetResult(&row_batch_));
-      RETURN_NOT_OK(PgDocData::LoadCache(row_batch_, &row_count, &cursor_));
+      if (PgDocData::IsColumnar(row_batch_)) {
+        RETURN_NOT_OK(columnar_tuples_.Load(row_batch_));
+        SCHECK_EQ(columnar_tuples_.column_count(), targets_.size(), Corruption,
+                  "Unexpected number of columns in result");
+        columnar_next_row_ = 0;
+        row_count = columnar_tuples_.row_count();
+      } else {
+        RETURN_NOT_OK(PgDocData::LoadCache(row_batch_, &row_count, &cursor_));
+      }
     }
 
     accumulated_row_count_ += row_count;
@@ -257,24 +282,63 @@ Status PgDml::Fetch(int32_t natts,
   // Read the tuple from cached buffer and write it to postgres buffer.
   *has_data = true;
   PgTuple pg_tuple(values, isnulls, syscols);
-  RETURN_NOT_OK(WritePgTuple(&pg_tuple));
+  if (columnar_next_row_ < columnar_tuples_.row_count()) {
+    RETURN_NOT_OK(WriteColumnarPgTuple(&pg_tuple));
+  } else {
+    RETURN_NOT_OK(WritePgTuple(&pg_tuple));
+  }
 
   return Status::OK();
 }
 
+Result<int> PgDml::TargetAttrIndex(const PgExpr *target, int index, bool is_aggregate) const {
+  if (is_aggregate) {
+    return index;
+  }
+  if (target->opcode() != PgColumnRef::Opcode::PG_EXPR_COLREF) {
+    return STATUS(InternalError, "Unexpected expression, only column refs supported here");
+  }
+  return static_cast<const PgColumnRef *>(target)->attr_num() - 1;
+}
 
 
 Status PgDml::WritePgTuple(PgTuple *pg_tuple) {
+  const bool is_aggregate = has_aggregate_targets();
+  int index = 0;
   for (const PgExpr *target : targets_) {
-    if (target->opcode() != PgColumnRef::Opcode::PG_EXPR_COLREF) {
-      return STATUS(InternalError, "Unexpected expression, only column refs supported here");
-    }
-    const auto *col_ref = static_cast<const PgColumnRef *>(target);
+    const int attr_index = VERIFY_RESULT(TargetAttrIndex(target, index++, is_aggregate));
     PgWireDataHeader header = PgDocData::ReadDataHeader(&cursor_);
-    target->TranslateData(&cursor_, header, col_ref->attr_num() - 1, pg_tuple);
+    target->TranslateData(&cursor_, header, attr_index, pg_tuple);
   }
   return Status::OK();
 }
 
+Status PgDml::WriteColumnarPgTuple(PgTuple *pg_tuple) {
+  // Values are located by the row index, so there is no need to parse the preceding values.
+  const bool is_aggregate = has_aggregate_targets();
+  const size_t row = columnar_next_row_++;
+  int index = 0;
+  for (const PgExpr *target : targets_) {
+    const int column = index;
+    const int attr_index = VERIFY_RESULT(TargetAttrIndex(target, index++, is_aggregate));
+    PgWireDataHeader header;
+    if (columnar_tuples_.IsNull(column, row)) {
+      header.set_null();
+    }
+    Slice value = columnar_tuples_.Value(column, row);
+    target->TranslateData(&value, header, attr_index, pg_tuple);
+  }
+  return Status::OK();
+}
+
+bool PgDml::has_aggregate_targets() const {
+  for (const PgExpr *target : targets_) {
+    if (target->is_aggregate()) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace pggate
 }  // namespace yb
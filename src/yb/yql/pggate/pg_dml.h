@@ -18,6 +18,7 @@
 #include "yb/yql/pggate/pg_session.h"
 #include "yb/yql/pggate/pg_statement.h"
 #include "yb/yql/pggate/pg_doc_op.h"
+#include "yb/yql/pggate/util/pg_doc_data.h"
 
 namespace yb {
 namespace pggate {
@@ -60,6 +61,12 @@ class PgDml : public PgStatement {
                        bool *has_data);
   CHECKED_STATUS WritePgTuple(PgTuple *pg_tuple);
 
+  // Write the next row of columnar_tuples_ to the Postgres buffer.
+  CHECKED_STATUS WriteColumnarPgTuple(PgTuple *pg_tuple);
+
+  // Index of the target value in the Postgres tuple.
+  Result<int> TargetAttrIndex(const PgExpr *target, int index, bool is_aggregate) const;
+
   virtual void SetCatalogCacheVersion(uint64_t catalog_cache_version) = 0;
 
  protected:
@@ -70,6 +77,9 @@ class PgDml : public PgStatement {
   // Load table.
   CHECKED_STATUS LoadTable();
 
+  // Drop targets, binds and results of the previous execution, keeping the table descriptor.
+  void ResetForReuse();
+
   // Allocate protobuf for a SELECTed expression.
   virtual PgsqlExpressionPB *AllocTargetPB() = 0;
 
@@ -88,6 +98,10 @@ class PgDml : public PgStatement {
   // Indicate in the protobuf what columns must be read before the statement is processed.
   static void SetColumnRefIds(PgTableDesc::ScopedRefPtr table_desc, PgsqlColumnRefsPB *column_refs);
 
+  // Whether any of the targets is an aggregate. The rows of an aggregate select contain the values
+  // of the targets in the order the targets were appended.
+  bool has_aggregate_targets() const;
+
   // -----------------------------------------------------------------------------------------------
   // Data members that define the DML statement.
   //
@@ -128,6 +142,10 @@ class PgDml : public PgStatement {
   // Cursor.
   Slice cursor_;
 
+  // Rows of the batch when it is in columnar format, and the index of the next row to read.
+  PgColumnarTuples columnar_tuples_;
+  size_t columnar_next_row_ = 0;
+
   // Total number of rows that have been found.
   int64_t accumulated_row_count_ = 0;
 };
@@ -14,6 +14,7 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/pggate/pg_dml_write.h"
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/client/yb_op.h"
 
 namespace yb {
@@ -103,7 +104,7 @@ Status PgDmlWrite::DeleteEmptyPrimaryBinds() {
   return Status::OK();
 }
 
-Status PgDmlWrite::Exec() {
+Status PgDmlWrite::UpdateWriteRequest() {
   // Delete allocated binds that are not associated with a value.
   // YBClient interface enforce us to allocate binds for primary key columns in their indexing
   // order, so we have to allocate these binds before associating them with values. When the values
@@ -122,6 +123,29 @@ Status PgDmlWrite::Exec() {
 
   // Set column references in protobuf.
   SetColumnRefIds(table_desc_, write_req_->mutable_column_refs());
+  return Status::OK();
+}
+
+Status PgDmlWrite::ExecBulk() {
+  RETURN_NOT_OK(UpdateWriteRequest());
+
+  std::shared_ptr<YBPgsqlWriteOp> op(table_desc_->NewPgsqlInsert());
+  op->mutable_request()->CopyFrom(*write_req_);
+  return pg_session_->ApplyBulkInsert(std::move(op));
+}
+
+Status PgDmlWrite::Exec() {
+  RETURN_NOT_OK(UpdateWriteRequest());
+
+  // A transactional write that returns no rows is pipelined. Current bind values are copied to a
+  // new operation, so the statement could be executed again while the write is in flight.
+  if (FLAGS_ysql_pipelined_writes && !is_single_row_txn_ && write_req_->targets().empty()) {
+    std::shared_ptr<YBPgsqlWriteOp> op(table_desc_->NewPgsqlInsert());
+    if (op->IsTransactional()) {
+      op->mutable_request()->CopyFrom(*write_req_);
+      return pg_session_->ApplyPipelinedWrite(std::move(op));
+    }
+  }
 
   // Execute the statement. If the request has been sent, get the result and handle any rows
   // returned.
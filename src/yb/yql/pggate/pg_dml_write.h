@@ -38,6 +38,11 @@ class PgDmlWrite : public PgDml {
   // Execute.
   CHECKED_STATUS Exec();
 
+  // Execute as a part of bulk insert. Current bind values are copied to a new operation, that is
+  // applied by PgSession::ApplyBulkInsert, so the statement could be bound and executed again
+  // before the operation is flushed.
+  CHECKED_STATUS ExecBulk();
+
   void SetIsSystemCatalogChange() {
     write_req_->set_is_ysql_catalog_change(true);
   }
@@ -67,6 +72,9 @@ class PgDmlWrite : public PgDml {
   // Delete allocated target for columns that have no bind-values.
   CHECKED_STATUS DeleteEmptyPrimaryBinds();
 
+  // Update write request with the current bind and assign values.
+  CHECKED_STATUS UpdateWriteRequest();
+
   // Protobuf code.
   PgsqlWriteRequestPB *write_req_ = nullptr;
 
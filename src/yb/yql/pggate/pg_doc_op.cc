@@ -13,11 +13,82 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/pggate/pg_doc_op.h"
+#include "yb/yql/pggate/pg_catalog_cache.h"
 #include "yb/yql/pggate/pggate_flags.h"
+#include "yb/yql/pggate/util/pg_doc_data.h"
+
+#include "yb/util/decimal.h"
 
 namespace yb {
 namespace pggate {
 
+namespace {
+
+// Adds partial SUM or COUNT to the aggregate.
+Status AddValue(const QLValue& val, QLValue *aggr_sum) {
+  switch (aggr_sum->type()) {
+    case InternalType::kInt8Value:
+      aggr_sum->set_int8_value(aggr_sum->int8_value() + val.int8_value());
+      break;
+    case InternalType::kInt16Value:
+      aggr_sum->set_int16_value(aggr_sum->int16_value() + val.int16_value());
+      break;
+    case InternalType::kInt32Value:
+      aggr_sum->set_int32_value(aggr_sum->int32_value() + val.int32_value());
+      break;
+    case InternalType::kInt64Value:
+      aggr_sum->set_int64_value(aggr_sum->int64_value() + val.int64_value());
+      break;
+    case InternalType::kFloatValue:
+      aggr_sum->set_float_value(aggr_sum->float_value() + val.float_value());
+      break;
+    case InternalType::kDoubleValue:
+      aggr_sum->set_double_value(aggr_sum->double_value() + val.double_value());
+      break;
+    case InternalType::kDecimalValue: {
+      util::Decimal sum, value;
+      RETURN_NOT_OK(sum.DecodeFromComparable(aggr_sum->decimal_value()));
+      RETURN_NOT_OK(value.DecodeFromComparable(val.decimal_value()));
+      sum = sum + value;
+      aggr_sum->set_decimal_value(sum.EncodeToComparable());
+      break;
+    }
+    default:
+      return STATUS_FORMAT(NotSupported, "Cannot merge SUM of type $0", aggr_sum->type());
+  }
+  return Status::OK();
+}
+
+Status MergeAggregate(bfpg::TSOpcode opcode, const QLValue& val, QLValue *aggr) {
+  if (val.IsNull()) {
+    return Status::OK();
+  }
+  if (aggr->IsNull()) {
+    *aggr = val;
+    return Status::OK();
+  }
+  switch (opcode) {
+    case bfpg::TSOpcode::kCount: FALLTHROUGH_INTENDED;
+    case bfpg::TSOpcode::kSum:
+      return AddValue(val, aggr);
+    case bfpg::TSOpcode::kMin:
+      if (val < *aggr) {
+        *aggr = val;
+      }
+      return Status::OK();
+    case bfpg::TSOpcode::kMax:
+      if (*aggr < val) {
+        *aggr = val;
+      }
+      return Status::OK();
+    default:
+      break;
+  }
+  return STATUS_FORMAT(NotSupported, "Cannot merge aggregate $0", static_cast<int>(opcode));
+}
+
+} // namespace
+
 PgDocOp::PgDocOp(PgSession::ScopedRefPtr pg_session, uint64_t* read_time)
     : pg_session_(std::move(pg_session)), read_time_(read_time),
       can_restart_(!pg_session_->HasAppliedOperations()) {
@@ -59,7 +130,7 @@ Result<RequestSent> PgDocOp::Execute() {
 
   RETURN_NOT_OK(SendRequestUnlocked());
 
-  return RequestSent(waiting_for_response_);
+  return RequestSent(waiting_for_response_ || end_of_data_);
 }
 
 void PgDocOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
@@ -75,6 +146,7 @@ void PgDocOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
   result_cache_.clear();
   end_of_data_ = false;
   has_cached_data_ = false;
+  read_ahead_sent_ = false;
 }
 
 Status PgDocOp::GetResult(string *result_set) {
@@ -89,9 +161,14 @@ Status PgDocOp::GetResult(string *result_set) {
   RETURN_NOT_OK(SendRequestIfNeededUnlocked());
 
   // Wait for response from DocDB.
+  bool stalled = false;
   while (!has_cached_data_ && !end_of_data_) {
+    stalled = true;
     cv_.wait(lock);
   }
+  if (stalled && read_ahead_sent_) {
+    ReadAheadStalledUnlocked();
+  }
 
   RETURN_NOT_OK(exec_status_);
 
@@ -101,10 +178,25 @@ Status PgDocOp::GetResult(string *result_set) {
   // This will pre-fetch the next chunk of data if we've consumed all cached
   // rows.
   RETURN_NOT_OK(SendRequestIfNeededUnlocked());
+  read_ahead_sent_ = waiting_for_response_;
 
   return Status::OK();
 }
 
+void PgDocOp::Reset(uint64_t* read_time) {
+  std::unique_lock<std::mutex> lock(mtx_);
+  while (waiting_for_response_) {
+    cv_.wait(lock);
+  }
+  read_time_ = read_time;
+  can_restart_ = !pg_session_->HasAppliedOperations();
+  exec_status_ = Status::OK();
+  result_cache_.clear();
+  end_of_data_ = false;
+  has_cached_data_ = false;
+  read_ahead_sent_ = false;
+}
+
 void PgDocOp::WriteToCacheUnlocked(std::shared_ptr<client::YBPgsqlOp> yb_op) {
   if (!yb_op->rows_data().empty()) {
     result_cache_.push_back(yb_op->rows_data());
@@ -114,15 +206,16 @@ void PgDocOp::WriteToCacheUnlocked(std::shared_ptr<client::YBPgsqlOp> yb_op) {
 
 void PgDocOp::ReadFromCacheUnlocked(string *result) {
   if (!result_cache_.empty()) {
-    *result = result_cache_.front();
+    *result = std::move(result_cache_.front());
     result_cache_.pop_front();
     has_cached_data_ = !result_cache_.empty();
   }
 }
 
 Status PgDocOp::SendRequestIfNeededUnlocked() {
-  // Request more data if more execution is needed and cache is empty.
-  if (!has_cached_data_ && !end_of_data_ && !waiting_for_response_) {
+  // Request more data if more execution is needed and cache is empty, or the next page could be
+  // fetched while the consumer works through the cached ones.
+  if (!end_of_data_ && !waiting_for_response_ && (!has_cached_data_ || CanReadAheadUnlocked())) {
     return SendRequestUnlocked();
   }
   return Status::OK();
@@ -156,7 +249,9 @@ bool PgDocOp::CheckRestartUnlocked(client::YBPgsqlOp* op) {
 
 PgDocReadOp::PgDocReadOp(
     PgSession::ScopedRefPtr pg_session, uint64_t* read_time, client::YBPgsqlReadOp *read_op)
-    : PgDocOp(pg_session, read_time), read_op_(read_op) {
+    : PgDocOp(pg_session, read_time), read_op_(read_op),
+      scan_parallelism_(FLAGS_ysql_scan_parallelism),
+      prefetch_limit_(FLAGS_ysql_prefetch_limit) {
 }
 
 PgDocReadOp::~PgDocReadOp() {
@@ -164,19 +259,55 @@ PgDocReadOp::~PgDocReadOp() {
 
 void PgDocReadOp::InitUnlocked(std::unique_lock<std::mutex>* lock) {
   PgDocOp::InitUnlocked(lock);
+  aggregate_rows_.clear();
+  prefetch_limit_ = FLAGS_ysql_prefetch_limit;
+  catalog_cache_key_.clear();
+  catalog_cache_rows_.clear();
 
   read_op_->mutable_request()->set_return_paging_state(true);
 }
 
+void PgDocReadOp::Reset(uint64_t* read_time) {
+  PgDocOp::Reset(read_time);
+  aggregate_targets_.clear();
+  aggregate_rows_.clear();
+  batch_ops_.clear();
+  scan_parallelism_ = FLAGS_ysql_scan_parallelism;
+  prefetch_limit_ = FLAGS_ysql_prefetch_limit;
+  catalog_cache_key_.clear();
+  catalog_cache_rows_.clear();
+}
+
 Status PgDocReadOp::SendRequestUnlocked() {
   CHECK(!waiting_for_response_);
 
-  PgsqlReadRequestPB *req = read_op_->mutable_request();
-  req->set_limit(FLAGS_ysql_prefetch_limit *
-                 (req->is_forward_scan() ? 1.0 : FLAGS_ysql_backward_prefetch_scale_factor));
+  if (!batch_ops_.empty()) {
+    for (const auto& op : batch_ops_) {
+      SCHECK_EQ(VERIFY_RESULT(pg_session_->PgApplyAsync(op, read_time_)), OpBuffered::kFalse,
+                IllegalState, "YSQL read operation should not be buffered");
+    }
+  } else {
+    PgsqlReadRequestPB *req = read_op_->mutable_request();
+    if (!req->has_paging_state() && aggregate_targets_.empty() &&
+        pg_session_->catalog_preload_version() != 0) {
+      catalog_cache_key_ = PgCatalogCache::Key(*req, pg_session_->catalog_preload_version());
+      catalog_cache_rows_.clear();
+      if (!catalog_cache_key_.empty() && LoadFromCatalogCacheUnlocked()) {
+        return Status::OK();
+      }
+    }
 
-  SCHECK_EQ(VERIFY_RESULT(pg_session_->PgApplyAsync(read_op_, read_time_)), OpBuffered::kFalse,
-            IllegalState, "YSQL read operation should not be buffered");
+    req->set_limit(prefetch_limit_ *
+                   (req->is_forward_scan() ? 1.0 : FLAGS_ysql_backward_prefetch_scale_factor));
+    if (scan_parallelism_ > 1 && req->is_forward_scan()) {
+      req->set_max_parallelism(scan_parallelism_);
+    } else {
+      req->clear_max_parallelism();
+    }
+
+    SCHECK_EQ(VERIFY_RESULT(pg_session_->PgApplyAsync(read_op_, read_time_)), OpBuffered::kFalse,
+              IllegalState, "YSQL read operation should not be buffered");
+  }
 
   waiting_for_response_ = true;
   Status s = pg_session_->PgFlushAsync([this](const Status& s) {
@@ -189,6 +320,71 @@ Status PgDocReadOp::SendRequestUnlocked() {
   return Status::OK();
 }
 
+bool PgDocReadOp::LoadFromCatalogCacheUnlocked() {
+  std::vector<string> rows_data;
+  auto loaded = PgCatalogCache::Load(catalog_cache_key_, &rows_data);
+  if (!loaded.ok()) {
+    LOG(WARNING) << "Failed to load catalog scan: " << loaded.status();
+    return false;
+  }
+  if (!*loaded) {
+    return false;
+  }
+  for (auto& page : rows_data) {
+    if (!page.empty()) {
+      result_cache_.push_back(std::move(page));
+    }
+  }
+  has_cached_data_ = !result_cache_.empty();
+  end_of_data_ = true;
+  catalog_cache_key_.clear();
+  return true;
+}
+
+Status PgDocReadOp::GetResult(string *result_set) {
+  RETURN_NOT_OK(PgDocOp::GetResult(result_set));
+
+  std::string key;
+  std::vector<string> rows_data;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!end_of_data_ || waiting_for_response_ || !exec_status_.ok() ||
+        catalog_cache_key_.empty()) {
+      return Status::OK();
+    }
+    key.swap(catalog_cache_key_);
+    rows_data.swap(catalog_cache_rows_);
+  }
+
+  // The file is written by the backend thread rather than by the reactor thread that received
+  // the last page.
+  auto status = PgCatalogCache::Store(key, rows_data);
+  if (!status.ok()) {
+    LOG(WARNING) << "Failed to save catalog scan: " << status;
+  }
+  return Status::OK();
+}
+
+bool PgDocReadOp::CanReadAheadUnlocked() const {
+  // Merged aggregates and batched point reads are received in full before anything is cached.
+  if (!aggregate_targets_.empty() || !batch_ops_.empty()) {
+    return false;
+  }
+  size_t buffered_bytes = 0;
+  for (const auto& page : result_cache_) {
+    buffered_bytes += page.size();
+  }
+  return buffered_bytes < FLAGS_ysql_prefetch_max_buffered_bytes;
+}
+
+void PgDocReadOp::ReadAheadStalledUnlocked() {
+  // The page was requested as soon as the previous one was handed out, yet the consumer still
+  // caught up with it. Fetch bigger pages so fewer round trips are exposed, bounded by
+  // ysql_max_prefetch_limit to cap the memory held by the cache.
+  prefetch_limit_ = std::max(prefetch_limit_,
+                             std::min(prefetch_limit_ * 2, FLAGS_ysql_max_prefetch_limit));
+}
+
 void PgDocReadOp::ReceiveResponse(Status exec_status) {
   std::unique_lock<std::mutex> lock(mtx_);
   CHECK(waiting_for_response_);
@@ -196,7 +392,14 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
   waiting_for_response_ = false;
   exec_status_ = exec_status;
 
+  if (!batch_ops_.empty()) {
+    ReceiveBatchResponseUnlocked();
+    return;
+  }
+
   if (exec_status.ok() && CheckRestartUnlocked(read_op_.get())) {
+    // Pages read before the restart could be inconsistent with the rest of the scan.
+    catalog_cache_key_.clear();
     return;
   }
 
@@ -208,7 +411,23 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
 
   if (!is_canceled_) {
     // Save it to cache.
-    WriteToCacheUnlocked(read_op_);
+    if (aggregate_targets_.empty()) {
+      if (!catalog_cache_key_.empty()) {
+        catalog_cache_rows_.push_back(read_op_->rows_data());
+      }
+      // Keep two pages within the buffered bytes limit, so the next page could be fetched while
+      // this one is consumed.
+      if (read_op_->rows_data().size() > FLAGS_ysql_prefetch_max_buffered_bytes / 2) {
+        prefetch_limit_ = std::max(prefetch_limit_ / 2, 1);
+      }
+      WriteToCacheUnlocked(read_op_);
+    } else {
+      exec_status_ = MergeAggregatesUnlocked(read_op_->rows_data());
+      if (!exec_status_.ok()) {
+        end_of_data_ = true;
+        return;
+      }
+    }
 
     // Setup request for the next batch of data.
     const PgsqlResponsePB& res = read_op_->response();
@@ -221,7 +440,19 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
        // This allows long-running queries to continue in the presence of other DDL statements
        // as long as they do not affect the table(s) being queried.
        req->clear_ysql_catalog_version();
+
+       // Nothing is cached until all partial aggregates are merged, so nobody else would request
+       // the next batch.
+       if (!aggregate_targets_.empty()) {
+         exec_status_ = SendRequestUnlocked();
+         if (!exec_status_.ok()) {
+           end_of_data_ = true;
+         }
+       }
      } else {
+      if (!aggregate_targets_.empty()) {
+        exec_status_ = WriteAggregatesToCacheUnlocked();
+      }
       end_of_data_ = true;
     }
   } else {
@@ -229,6 +460,96 @@ void PgDocReadOp::ReceiveResponse(Status exec_status) {
   }
 }
 
+void PgDocReadOp::ReceiveBatchResponseUnlocked() {
+  // Point reads by ybctid return at most one row each and are never paged.
+  end_of_data_ = true;
+  if (!exec_status_.ok() || is_canceled_) {
+    return;
+  }
+  for (const auto& op : batch_ops_) {
+    if (CheckRestartUnlocked(op.get())) {
+      // The whole batch was sent again.
+      end_of_data_ = false;
+      result_cache_.clear();
+      has_cached_data_ = false;
+      return;
+    }
+    if (!exec_status_.ok()) {
+      return;
+    }
+    WriteToCacheUnlocked(op);
+  }
+}
+
+Status PgDocReadOp::MergeAggregatesUnlocked(const string& rows_data) {
+  if (rows_data.empty()) {
+    return Status::OK();
+  }
+
+  Slice cursor;
+  int64_t row_count = 0;
+  RETURN_NOT_OK(PgDocData::LoadCache(rows_data, &row_count, &cursor));
+
+  std::vector<QLValue> row(aggregate_targets_.size());
+  string group_key;
+  for (int64_t row_index = 0; row_index < row_count; row_index++) {
+    group_key.clear();
+    for (size_t col_index = 0; col_index < aggregate_targets_.size(); col_index++) {
+      const PgAggregateTarget& target = aggregate_targets_[col_index];
+      const uint8_t* col_start = cursor.data();
+      RETURN_NOT_OK(PgDocData::ReadColumn(&cursor, target.type, &row[col_index]));
+      if (target.opcode == bfpg::TSOpcode::kNoOp) {
+        group_key.append(pointer_cast<const char*>(col_start), cursor.data() - col_start);
+      }
+    }
+
+    auto it = aggregate_rows_.find(group_key);
+    if (it == aggregate_rows_.end()) {
+      aggregate_rows_.emplace(group_key, row);
+      continue;
+    }
+    for (size_t col_index = 0; col_index < aggregate_targets_.size(); col_index++) {
+      const bfpg::TSOpcode opcode = aggregate_targets_[col_index].opcode;
+      if (opcode != bfpg::TSOpcode::kNoOp) {
+        RETURN_NOT_OK(MergeAggregate(opcode, row[col_index], &it->second[col_index]));
+      }
+    }
+  }
+  return Status::OK();
+}
+
+Status PgDocReadOp::WriteAggregatesToCacheUnlocked() {
+  // Tablets that read no rows return no partial aggregates. Without GROUP BY the select still
+  // returns one row, with zero counts and NULL results of the other aggregates.
+  if (aggregate_rows_.empty() && read_op_->request().group_by_exprs().empty()) {
+    std::vector<QLValue> row(aggregate_targets_.size());
+    for (size_t col_index = 0; col_index < aggregate_targets_.size(); col_index++) {
+      if (aggregate_targets_[col_index].opcode == bfpg::TSOpcode::kCount) {
+        row[col_index].set_int64_value(0);
+      }
+    }
+    aggregate_rows_.emplace(string(), std::move(row));
+  }
+  if (aggregate_rows_.empty()) {
+    return Status::OK();
+  }
+
+  PgsqlResultSet result_set;
+  for (const auto& entry : aggregate_rows_) {
+    PgsqlRSRow *rsrow = result_set.AllocateRSRow(entry.second.size());
+    for (size_t col_index = 0; col_index < entry.second.size(); col_index++) {
+      *rsrow->rscol(col_index) = entry.second[col_index];
+    }
+  }
+  aggregate_rows_.clear();
+
+  faststring buffer;
+  RETURN_NOT_OK(PgDocData::WriteTuples(result_set, &buffer));
+  result_cache_.push_back(buffer.ToString());
+  has_cached_data_ = true;
+  return Status::OK();
+}
+
 //--------------------------------------------------------------------------------------------------
 
 PgDocWriteOp::PgDocWriteOp(PgSession::ScopedRefPtr pg_session, client::YBPgsqlWriteOp *write_op)
@@ -15,11 +15,13 @@
 #ifndef YB_YQL_PGGATE_PG_DOC_OP_H_
 #define YB_YQL_PGGATE_PG_DOC_OP_H_
 
+#include <map>
 #include <mutex>
 #include <condition_variable>
 
 #include "yb/util/locks.h"
 #include "yb/client/yb_op.h"
+#include "yb/util/bfpg/tserver_opcodes.h"
 #include "yb/yql/pggate/pg_session.h"
 
 namespace yb {
@@ -27,6 +29,16 @@ namespace pggate {
 
 YB_STRONGLY_TYPED_BOOL(RequestSent);
 
+// Describes a target of an aggregate read. It is used to merge partial aggregates that are returned
+// by different tablets, or by different pages of the same tablet.
+struct PgAggregateTarget {
+  // Aggregate that computes the target, or kNoOp for a group-by value.
+  bfpg::TSOpcode opcode;
+
+  // Type of the target value.
+  InternalType type;
+};
+
 class PgDocOp {
  public:
   // Public types.
@@ -44,12 +56,17 @@ class PgDocOp {
   explicit PgDocOp(PgSession::ScopedRefPtr pg_session, uint64_t* read_time);
   virtual ~PgDocOp();
 
-  // Execute the op. Return true if the request has been sent and is awaiting the result.
+  // Execute the op. Return true if the request has been sent and is awaiting the result, or if the
+  // result is already available.
   virtual Result<RequestSent> Execute();
 
   // Get the result of the op.
   virtual CHECKED_STATUS GetResult(string *result_set);
 
+  // Discard the state of the previous execution, so the op could be executed again as a new op
+  // of the current statement. Waits for the response in flight, if any.
+  virtual void Reset(uint64_t* read_time);
+
   // Access functions.
   Status exec_status() {
     return exec_status_;
@@ -65,9 +82,18 @@ class PgDocOp {
   void ReadFromCacheUnlocked(string* result);
 
   // Send another request if no request is pending and we've already consumed
-  // all data in the cache.
+  // all data in the cache, or the next page could be fetched ahead of time.
   CHECKED_STATUS SendRequestIfNeededUnlocked();
 
+  // Whether the next page could be requested while the cache still holds data.
+  virtual bool CanReadAheadUnlocked() const {
+    return false;
+  }
+
+  // Called when the consumer had to wait for a page that was requested ahead of time, i.e. the
+  // read-ahead did not hide the round trip to DocDB.
+  virtual void ReadAheadStalledUnlocked() {}
+
   // Checks whether op causes restart. Could set exec_status_.
   // Returns true is restart was initiated;
   bool CheckRestartUnlocked(client::YBPgsqlOp* op);
@@ -75,7 +101,7 @@ class PgDocOp {
   // Session control.
   PgSession::ScopedRefPtr pg_session_;
 
-  uint64_t* const read_time_;
+  uint64_t* read_time_;
 
   // This mutex protects the fields below.
   mutable std::mutex mtx_;
@@ -89,6 +115,9 @@ class PgDocOp {
   // request can be sent to DocDB at a time.
   bool waiting_for_response_ = false;
 
+  // Whether the request in flight was sent ahead of time, after the cache had been drained.
+  bool read_ahead_sent_ = false;
+
   // Whether all requested data by the statement has been received or there's a run-time error.
   bool end_of_data_ = false;
 
@@ -102,7 +131,7 @@ class PgDocOp {
   std::list<string> result_cache_;
 
   // Whether we can restart this operation.
-  const bool can_restart_;
+  bool can_restart_;
 };
 
 class PgDocReadOp : public PgDocOp {
@@ -126,14 +155,69 @@ class PgDocReadOp : public PgDocOp {
     return read_op_;
   }
 
+  // Merge partial aggregates returned by DocDB. Rows with the same group-by values are combined
+  // into one, and the final result is made available after all data is read.
+  void SetAggregateTargets(std::vector<PgAggregateTarget> targets) {
+    aggregate_targets_ = std::move(targets);
+  }
+
+  // Degree of parallelism of a forward full scan within a tablet. When greater than 1, tablet
+  // server could scan sub-ranges of the tablet concurrently and return rows out of key order.
+  void SetScanParallelism(int scan_parallelism) {
+    scan_parallelism_ = scan_parallelism;
+  }
+
+  // Point reads executed instead of read_op_. They are flushed together, and their rows are
+  // returned in the order of the ops.
+  void SetBatchOps(std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops) {
+    batch_ops_ = std::move(ops);
+  }
+
+  CHECKED_STATUS GetResult(string *result_set) override;
+
+  void Reset(uint64_t* read_time) override;
+
  private:
   // Process response from DocDB.
   void InitUnlocked(std::unique_lock<std::mutex>* lock) override;
   CHECKED_STATUS SendRequestUnlocked() override;
+  bool CanReadAheadUnlocked() const override;
+  void ReadAheadStalledUnlocked() override;
   virtual void ReceiveResponse(Status exec_status);
+  void ReceiveBatchResponseUnlocked();
+
+  // Merge rows of partial aggregates from the response into aggregate_rows_.
+  CHECKED_STATUS MergeAggregatesUnlocked(const string& rows_data);
+
+  // Save merged aggregates to the cache.
+  CHECKED_STATUS WriteAggregatesToCacheUnlocked();
+
+  // Read the rows of the scan saved by another backend. Returns true if they were found.
+  bool LoadFromCatalogCacheUnlocked();
 
   // Operator.
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
+
+  // Targets of an aggregate read, empty for all other reads.
+  std::vector<PgAggregateTarget> aggregate_targets_;
+
+  // Merged aggregates, keyed by group-by values in wire format.
+  std::map<string, std::vector<QLValue>> aggregate_rows_;
+
+  // Degree of parallelism of the scan within a tablet.
+  int scan_parallelism_;
+
+  // Number of rows requested per page. Grows while the consumer outpaces the read-ahead, and
+  // shrinks when pages get too large for ysql_prefetch_max_buffered_bytes.
+  int prefetch_limit_;
+
+  // Point reads of a batched fetch by ybctids.
+  std::vector<std::shared_ptr<client::YBPgsqlReadOp>> batch_ops_;
+
+  // Key of the catalog scan that is saved for other backends when all of its pages are read, and
+  // the rows data of the pages read so far. The key is empty when the scan is not saved.
+  std::string catalog_cache_key_;
+  std::vector<string> catalog_cache_rows_;
 };
 
 class PgDocWriteOp : public PgDocOp {
@@ -93,6 +93,107 @@ PgExpr::Opcode PgExpr::NameToOpcode(const char *name) {
   return iter->second;
 }
 
+void PgExpr::InitializeTranslateData() {
+  switch (type_entity_->yb_type) {
+    case YB_YQL_DATA_TYPE_INT8:
+      translate_data_ = TranslateNumber<int8_t>;
+      datum_to_ql_value_ = NumberDatumToQLValue<int8_t>;
+      break;
+
+    case YB_YQL_DATA_TYPE_INT16:
+      translate_data_ = TranslateNumber<int16_t>;
+      datum_to_ql_value_ = NumberDatumToQLValue<int16_t>;
+      break;
+
+    case YB_YQL_DATA_TYPE_INT32:
+      translate_data_ = TranslateNumber<int32_t>;
+      datum_to_ql_value_ = NumberDatumToQLValue<int32_t>;
+      break;
+
+    case YB_YQL_DATA_TYPE_INT64:
+      translate_data_ = TranslateNumber<int64_t>;
+      datum_to_ql_value_ = NumberDatumToQLValue<int64_t>;
+      break;
+
+    case YB_YQL_DATA_TYPE_UINT32:
+      translate_data_ = TranslateNumber<uint32_t>;
+      datum_to_ql_value_ = NumberDatumToQLValue<uint32_t>;
+      break;
+
+    case YB_YQL_DATA_TYPE_STRING:
+      translate_data_ = TranslateText;
+      datum_to_ql_value_ = TextDatumToQLValue;
+      break;
+
+    case YB_YQL_DATA_TYPE_BOOL:
+      translate_data_ = TranslateNumber<bool>;
+      datum_to_ql_value_ = NumberDatumToQLValue<bool>;
+      break;
+
+    case YB_YQL_DATA_TYPE_FLOAT:
+      translate_data_ = TranslateNumber<float>;
+      datum_to_ql_value_ = NumberDatumToQLValue<float>;
+      break;
+
+    case YB_YQL_DATA_TYPE_DOUBLE:
+      translate_data_ = TranslateNumber<double>;
+      datum_to_ql_value_ = NumberDatumToQLValue<double>;
+      break;
+
+    case YB_YQL_DATA_TYPE_BINARY:
+      translate_data_ = TranslateBinary;
+      datum_to_ql_value_ = BinaryDatumToQLValue;
+      break;
+
+    case YB_YQL_DATA_TYPE_TIMESTAMP:
+      translate_data_ = TranslateNumber<int64_t>;
+      datum_to_ql_value_ = NumberDatumToQLValue<int64_t>;
+      break;
+
+    case YB_YQL_DATA_TYPE_DECIMAL:
+      translate_data_ = TranslateDecimal;
+      datum_to_ql_value_ = DecimalDatumToQLValue;
+      break;
+
+    case YB_YQL_DATA_TYPE_VARINT:
+    case YB_YQL_DATA_TYPE_INET:
+    case YB_YQL_DATA_TYPE_LIST:
+    case YB_YQL_DATA_TYPE_MAP:
+    case YB_YQL_DATA_TYPE_SET:
+    case YB_YQL_DATA_TYPE_UUID:
+    case YB_YQL_DATA_TYPE_TIMEUUID:
+    case YB_YQL_DATA_TYPE_TUPLE:
+    case YB_YQL_DATA_TYPE_TYPEARGS:
+    case YB_YQL_DATA_TYPE_USER_DEFINED_TYPE:
+    case YB_YQL_DATA_TYPE_FROZEN:
+    case YB_YQL_DATA_TYPE_DATE: // Not used for PG storage
+    case YB_YQL_DATA_TYPE_TIME: // Not used for PG storage
+    case YB_YQL_DATA_TYPE_JSONB:
+    case YB_YQL_DATA_TYPE_UINT8:
+    case YB_YQL_DATA_TYPE_UINT16:
+    case YB_YQL_DATA_TYPE_UINT64:
+    default:
+      LOG(DFATAL) << "Internal error: unsupported type " << type_entity_->yb_type;
+  }
+}
+
+bfpg::TSOpcode PgExpr::aggregate_tsopcode() const {
+  switch (opcode_) {
+    case Opcode::PG_EXPR_AVG:
+      return bfpg::TSOpcode::kAvg;
+    case Opcode::PG_EXPR_SUM:
+      return bfpg::TSOpcode::kSum;
+    case Opcode::PG_EXPR_COUNT:
+      return bfpg::TSOpcode::kCount;
+    case Opcode::PG_EXPR_MAX:
+      return bfpg::TSOpcode::kMax;
+    case Opcode::PG_EXPR_MIN:
+      return bfpg::TSOpcode::kMin;
+    default:
+      return bfpg::TSOpcode::kNoOp;
+  }
+}
+
 Status PgExpr::PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
   // For expression that doesn't need to be setup and prepared at construction time.
   return Status::OK();
@@ -156,7 +257,33 @@ void PgExpr::TranslateDecimal(Slice *yb_cursor, const PgWireDataHeader& header,
   }
   auto plaintext = yb_decimal.ToString();
 
-  pg_tuple->WriteDatum(index, type_entity->yb_to_datum(plaintext.c_str(), data_size, type_attrs));
+  pg_tuple->WriteDatum(index, type_entity->yb_to_datum(plaintext.c_str(), plaintext.size(),
+                                                       type_attrs));
+}
+
+void PgExpr::TextDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                QLValuePB *ql_value) {
+  char *value;
+  int64_t bytes = type_entity->datum_fixed_size;
+  type_entity->datum_to_yb(datum, &value, &bytes);
+  ql_value->set_string_value(value, bytes);
+}
+
+void PgExpr::BinaryDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                  QLValuePB *ql_value) {
+  uint8_t *value;
+  int64_t bytes = type_entity->datum_fixed_size;
+  type_entity->datum_to_yb(datum, &value, &bytes);
+  ql_value->set_binary_value(value, bytes);
+}
+
+void PgExpr::DecimalDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                   QLValuePB *ql_value) {
+  char* plaintext;
+  // Calls YBCDatumToDecimalText in ybctype.c
+  type_entity->datum_to_yb(datum, &plaintext, nullptr);
+  util::Decimal yb_decimal(plaintext);
+  ql_value->set_decimal_value(yb_decimal.EncodeToComparable());
 }
 
 //--------------------------------------------------------------------------------------------------
@@ -240,140 +367,17 @@ InternalType PgExpr::internal_type() const {
 
 PgConstant::PgConstant(const YBCPgTypeEntity *type_entity, uint64_t datum, bool is_null)
     : PgExpr(PgExpr::Opcode::PG_EXPR_CONSTANT, type_entity) {
+  InitializeTranslateData();
+  UpdateDatum(datum, is_null);
+}
 
-  switch (type_entity_->yb_type) {
-    case YB_YQL_DATA_TYPE_INT8:
-      if (!is_null) {
-        int8_t value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_int8_value(value);
-      }
-      translate_data_ = TranslateNumber<int8_t>;
-      break;
-
-    case YB_YQL_DATA_TYPE_INT16:
-      if (!is_null) {
-        int16_t value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_int16_value(value);
-      }
-      translate_data_ = TranslateNumber<int16_t>;
-      break;
-
-    case YB_YQL_DATA_TYPE_INT32:
-      if (!is_null) {
-        int32_t value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_int32_value(value);
-      }
-      translate_data_ = TranslateNumber<int32_t>;
-      break;
-
-    case YB_YQL_DATA_TYPE_INT64:
-      if (!is_null) {
-        int64_t value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_int64_value(value);
-      }
-      translate_data_ = TranslateNumber<int64_t>;
-      break;
-
-    case YB_YQL_DATA_TYPE_UINT32:
-      if (!is_null) {
-        uint32_t value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_uint32_value(value);
-      }
-      translate_data_ = TranslateNumber<uint32_t>;
-      break;
-
-    case YB_YQL_DATA_TYPE_STRING:
-      if (!is_null) {
-        char *value;
-        int64_t bytes = type_entity_->datum_fixed_size;
-        type_entity_->datum_to_yb(datum, &value, &bytes);
-        ql_value_.set_string_value(value, bytes);
-      }
-      translate_data_ = TranslateText;
-      break;
-
-    case YB_YQL_DATA_TYPE_BOOL:
-      if (!is_null) {
-        bool value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_bool_value(value);
-      }
-      translate_data_ = TranslateNumber<bool>;
-      break;
-
-    case YB_YQL_DATA_TYPE_FLOAT:
-      if (!is_null) {
-        float value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_float_value(value);
-      }
-      translate_data_ = TranslateNumber<float>;
-      break;
-
-    case YB_YQL_DATA_TYPE_DOUBLE:
-      if (!is_null) {
-        double value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_double_value(value);
-      }
-      translate_data_ = TranslateNumber<double>;
-      break;
-
-    case YB_YQL_DATA_TYPE_BINARY:
-      if (!is_null) {
-        uint8_t *value;
-        int64_t bytes = type_entity_->datum_fixed_size;
-        type_entity_->datum_to_yb(datum, &value, &bytes);
-        ql_value_.set_binary_value(value, bytes);
-      }
-      translate_data_ = TranslateBinary;
-      break;
-
-    case YB_YQL_DATA_TYPE_TIMESTAMP:
-      if (!is_null) {
-        int64_t value;
-        type_entity_->datum_to_yb(datum, &value, nullptr);
-        ql_value_.set_int64_value(value);
-      }
-      translate_data_ = TranslateNumber<int64_t>;
-      break;
-
-    case YB_YQL_DATA_TYPE_DECIMAL:
-      if (!is_null) {
-        char* plaintext;
-        // Calls YBCDatumToDecimalText in ybctype.c
-        type_entity_->datum_to_yb(datum, &plaintext, nullptr);
-        util::Decimal yb_decimal(plaintext);
-        ql_value_.set_decimal_value(yb_decimal.EncodeToComparable());
-      }
-      translate_data_ = TranslateDecimal;
-      break;
-
-    case YB_YQL_DATA_TYPE_VARINT:
-    case YB_YQL_DATA_TYPE_INET:
-    case YB_YQL_DATA_TYPE_LIST:
-    case YB_YQL_DATA_TYPE_MAP:
-    case YB_YQL_DATA_TYPE_SET:
-    case YB_YQL_DATA_TYPE_UUID:
-    case YB_YQL_DATA_TYPE_TIMEUUID:
-    case YB_YQL_DATA_TYPE_TUPLE:
-    case YB_YQL_DATA_TYPE_TYPEARGS:
-    case YB_YQL_DATA_TYPE_USER_DEFINED_TYPE:
-    case YB_YQL_DATA_TYPE_FROZEN:
-    case YB_YQL_DATA_TYPE_DATE: // Not used for PG storage
-    case YB_YQL_DATA_TYPE_TIME: // Not used for PG storage
-    case YB_YQL_DATA_TYPE_JSONB:
-    case YB_YQL_DATA_TYPE_UINT8:
-    case YB_YQL_DATA_TYPE_UINT16:
-    case YB_YQL_DATA_TYPE_UINT64:
-    default:
-      LOG(DFATAL) << "Internal error: unsupported type " << type_entity_->yb_type;
+void PgConstant::UpdateDatum(uint64_t datum, bool is_null) {
+  ql_value_.Clear();
+  // Unsupported types are reported by the constructor.
+  if (is_null || !datum_to_ql_value_) {
+    return;
   }
+  datum_to_ql_value_(type_entity_, datum, &ql_value_);
 }
 
 PgConstant::~PgConstant() {
@@ -489,75 +493,7 @@ PgColumnRef::PgColumnRef(int attr_num,
     }
   } else {
     // Setup regular columns.
-    switch (type_entity_->yb_type) {
-      case YB_YQL_DATA_TYPE_INT8:
-        translate_data_ = TranslateNumber<int8_t>;
-        break;
-
-      case YB_YQL_DATA_TYPE_INT16:
-        translate_data_ = TranslateNumber<int16_t>;
-        break;
-
-      case YB_YQL_DATA_TYPE_INT32:
-        translate_data_ = TranslateNumber<int32_t>;
-        break;
-
-      case YB_YQL_DATA_TYPE_INT64:
-        translate_data_ = TranslateNumber<int64_t>;
-        break;
-
-      case YB_YQL_DATA_TYPE_UINT32:
-        translate_data_ = TranslateNumber<uint32_t>;
-        break;
-
-      case YB_YQL_DATA_TYPE_STRING:
-        translate_data_ = TranslateText;
-        break;
-
-      case YB_YQL_DATA_TYPE_BOOL:
-        translate_data_ = TranslateNumber<bool>;
-        break;
-
-      case YB_YQL_DATA_TYPE_FLOAT:
-        translate_data_ = TranslateNumber<float>;
-        break;
-
-      case YB_YQL_DATA_TYPE_DOUBLE:
-        translate_data_ = TranslateNumber<double>;
-        break;
-
-      case YB_YQL_DATA_TYPE_BINARY:
-        translate_data_ = TranslateBinary;
-        break;
-
-      case YB_YQL_DATA_TYPE_TIMESTAMP:
-        translate_data_ = TranslateNumber<int64_t>;
-        break;
-
-      case YB_YQL_DATA_TYPE_DECIMAL:
-        translate_data_ = TranslateDecimal;
-        break;
-
-      case YB_YQL_DATA_TYPE_VARINT:
-      case YB_YQL_DATA_TYPE_INET:
-      case YB_YQL_DATA_TYPE_LIST:
-      case YB_YQL_DATA_TYPE_MAP:
-      case YB_YQL_DATA_TYPE_SET:
-      case YB_YQL_DATA_TYPE_UUID:
-      case YB_YQL_DATA_TYPE_TIMEUUID:
-      case YB_YQL_DATA_TYPE_TUPLE:
-      case YB_YQL_DATA_TYPE_TYPEARGS:
-      case YB_YQL_DATA_TYPE_USER_DEFINED_TYPE:
-      case YB_YQL_DATA_TYPE_FROZEN:
-      case YB_YQL_DATA_TYPE_DATE: // Not used for PG storage
-      case YB_YQL_DATA_TYPE_TIME: // Not used for PG storage
-      case YB_YQL_DATA_TYPE_JSONB:
-      case YB_YQL_DATA_TYPE_UINT8:
-      case YB_YQL_DATA_TYPE_UINT16:
-      case YB_YQL_DATA_TYPE_UINT64:
-      default:
-        LOG(DFATAL) << "Internal error: unsupported type " << type_entity_->yb_type;
-    }
+    InitializeTranslateData();
   }
 }
 
@@ -583,6 +519,105 @@ void PgOperator::AppendArg(PgExpr *arg) {
   args_.push_back(arg);
 }
 
+Status PgOperator::PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  if (is_condition()) {
+    return PrepareConditionForRead(pg_stmt, expr_pb);
+  }
+  if (!is_aggregate()) {
+    return PgExpr::PrepareForRead(pg_stmt, expr_pb);
+  }
+  if (opcode_ == Opcode::PG_EXPR_AVG) {
+    // Partial results of AVG could not be merged, Postgres should push down SUM and COUNT instead.
+    return STATUS(NotSupported, "AVG could not be computed by DocDB");
+  }
+  if (args_.size() > 1) {
+    return STATUS_FORMAT(InvalidArgument, "Aggregate $0 expects at most one argument", opname_);
+  }
+  InitializeTranslateData();
+
+  PgsqlBCallPB *tscall = expr_pb->mutable_tscall();
+  tscall->set_opcode(static_cast<int32_t>(aggregate_tsopcode()));
+  if (args_.empty()) {
+    // COUNT(*) counts all rows, so its argument is a constant that is never NULL.
+    if (opcode_ != Opcode::PG_EXPR_COUNT) {
+      return STATUS_FORMAT(InvalidArgument, "Aggregate $0 expects an argument", opname_);
+    }
+    tscall->add_operands()->mutable_value()->set_int64_value(1);
+    return Status::OK();
+  }
+
+  // Results are sent back in the type computed by DocDB, which must be the declared type of the
+  // aggregate: COUNT is int64, SUM is promoted as Postgres does and MIN/MAX keep the argument type.
+  const InternalType arg_type = args_[0]->internal_type();
+  InternalType result_type = arg_type;
+  if (opcode_ == Opcode::PG_EXPR_COUNT) {
+    result_type = InternalType::kInt64Value;
+  } else if (opcode_ == Opcode::PG_EXPR_SUM) {
+    result_type = PgsqlSumType(arg_type);
+  }
+  if (result_type == InternalType::VALUE_NOT_SET || result_type != internal_type()) {
+    return STATUS_FORMAT(NotSupported, "Aggregate $0 of type $1 could not be computed by DocDB",
+                         opname_, static_cast<int>(internal_type()));
+  }
+  return args_[0]->PrepareForRead(pg_stmt, tscall->add_operands());
+}
+
+Status PgOperator::PrepareConditionForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  PgsqlConditionPB *condition = expr_pb->mutable_condition();
+  switch (opcode_) {
+    case Opcode::PG_EXPR_NOT:
+      if (args_.size() != 1 || !args_[0]->is_condition()) {
+        return STATUS_FORMAT(InvalidArgument, "Operator $0 expects a condition argument", opname_);
+      }
+      condition->set_op(QL_OP_NOT);
+      return args_[0]->PrepareForRead(pg_stmt, condition->add_operands());
+    case Opcode::PG_EXPR_EQ:
+      condition->set_op(QL_OP_EQUAL);
+      break;
+    case Opcode::PG_EXPR_NE:
+      condition->set_op(QL_OP_NOT_EQUAL);
+      break;
+    case Opcode::PG_EXPR_GE:
+      condition->set_op(QL_OP_GREATER_THAN_EQUAL);
+      break;
+    case Opcode::PG_EXPR_GT:
+      condition->set_op(QL_OP_GREATER_THAN);
+      break;
+    case Opcode::PG_EXPR_LE:
+      condition->set_op(QL_OP_LESS_THAN_EQUAL);
+      break;
+    case Opcode::PG_EXPR_LT:
+      condition->set_op(QL_OP_LESS_THAN);
+      break;
+    default:
+      return STATUS_FORMAT(InvalidArgument, "Operator $0 is not a condition", opname_);
+  }
+
+  // DocDB compares values of the same type only.
+  if (args_.size() != 2 ||
+      args_[0]->type_entity()->yb_type != args_[1]->type_entity()->yb_type) {
+    return STATUS_FORMAT(InvalidArgument,
+                         "Operator $0 expects two arguments of the same type", opname_);
+  }
+  for (PgExpr *arg : args_) {
+    RETURN_NOT_OK(arg->PrepareForRead(pg_stmt, condition->add_operands()));
+  }
+  return Status::OK();
+}
+
+Status PgOperator::Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) {
+  if (is_condition()) {
+    for (size_t i = 0; i < args_.size(); i++) {
+      RETURN_NOT_OK(args_[i]->Eval(pg_stmt, expr_pb->mutable_condition()->mutable_operands(i)));
+    }
+    return Status::OK();
+  }
+  if (!is_aggregate() || args_.empty()) {
+    return PgExpr::Eval(pg_stmt, expr_pb);
+  }
+  return args_[0]->Eval(pg_stmt, expr_pb->mutable_tscall()->mutable_operands(0));
+}
+
 //--------------------------------------------------------------------------------------------------
 namespace {
 #define POSTGRESQL_BYTEAOID 17
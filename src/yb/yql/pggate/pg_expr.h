@@ -16,6 +16,7 @@
 #define YB_YQL_PGGATE_PG_EXPR_H_
 
 #include "yb/client/client.h"
+#include "yb/util/bfpg/tserver_opcodes.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
 #include "yb/yql/pggate/util/pg_tuple.h"
 
@@ -72,9 +73,22 @@ class PgExpr {
   Opcode opcode() const {
     return opcode_;
   }
+  const YBCPgTypeEntity *type_entity() const {
+    return type_entity_;
+  }
   bool is_constant() {
     return opcode_ == Opcode::PG_EXPR_CONSTANT;
   }
+  bool is_aggregate() const {
+    return opcode_ >= Opcode::PG_EXPR_AVG && opcode_ <= Opcode::PG_EXPR_MIN;
+  }
+  bool is_condition() const {
+    return opcode_ >= Opcode::PG_EXPR_NOT && opcode_ <= Opcode::PG_EXPR_LT;
+  }
+
+  // Tablet-server operator that computes this aggregate expression, or kNoOp for all other
+  // expressions.
+  bfpg::TSOpcode aggregate_tsopcode() const;
 
   // Read the result from input buffer (yb_cursor) that was computed by and sent from DocDB.
   // Write the result to output buffer (pg_cursor) in Postgres format.
@@ -87,12 +101,39 @@ class PgExpr {
   //   correctly during the compilation of a statement.
   // - For each postgres data type, to_datum() function pointer must be setup properly during
   //   the compilation of a statement.
+  // So fetching a row does not dispatch on the datatype of each value.
+  typedef void (*TranslateDataFunc)(Slice *yb_cursor, const PgWireDataHeader& header, int index,
+                                    const YBCPgTypeEntity *type_entity,
+                                    const PgTypeAttrs *type_attrs, PgTuple *pg_tuple);
+
   void TranslateData(Slice *yb_cursor, const PgWireDataHeader& header, int index,
                      PgTuple *pg_tuple) const {
-    CHECK(translate_data_) << "Data format translation is not provided";
+    DCHECK(translate_data_) << "Data format translation is not provided";
     translate_data_(yb_cursor, header, index, type_entity_, &type_attrs_, pg_tuple);
   }
 
+  // Function datum_to_ql_value_() converts a Postgres datum of this expression's datatype to
+  // QLValuePB using datum_to_yb(). Like translate_data_(), it is setup once per expression, so
+  // binding a value does not dispatch on the datatype.
+  typedef void (*DatumToQLValueFunc)(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                     QLValuePB *ql_value);
+
+  // Implementation for "datum_to_ql_value()" for each supported datatype.
+  template<typename data_type>
+  static void NumberDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                   QLValuePB *ql_value) {
+    data_type value;
+    type_entity->datum_to_yb(datum, &value, nullptr);
+    SetQLValue(value, ql_value);
+  }
+
+  static void TextDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                 QLValuePB *ql_value);
+  static void BinaryDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                   QLValuePB *ql_value);
+  static void DecimalDatumToQLValue(const YBCPgTypeEntity *type_entity, uint64_t datum,
+                                    QLValuePB *ql_value);
+
   // Implementation for "translate_data()" for each supported datatype.
   // Translates DocDB-numeric datatypes.
   template<typename data_type>
@@ -171,17 +212,30 @@ class PgExpr {
   // Get expression type.
   InternalType internal_type() const;
 
+  // Set value of the type corresponding to the datatype of the expression.
+  static void SetQLValue(int8_t value, QLValuePB *ql_value) { ql_value->set_int8_value(value); }
+  static void SetQLValue(int16_t value, QLValuePB *ql_value) { ql_value->set_int16_value(value); }
+  static void SetQLValue(int32_t value, QLValuePB *ql_value) { ql_value->set_int32_value(value); }
+  static void SetQLValue(int64_t value, QLValuePB *ql_value) { ql_value->set_int64_value(value); }
+  static void SetQLValue(uint32_t value, QLValuePB *ql_value) { ql_value->set_uint32_value(value); }
+  static void SetQLValue(bool value, QLValuePB *ql_value) { ql_value->set_bool_value(value); }
+  static void SetQLValue(float value, QLValuePB *ql_value) { ql_value->set_float_value(value); }
+  static void SetQLValue(double value, QLValuePB *ql_value) { ql_value->set_double_value(value); }
+
   // Find opcode.
   static CHECKED_STATUS CheckOperatorName(const char *name);
   static Opcode NameToOpcode(const char *name);
 
  protected:
+  // Setup translate_data_ and datum_to_ql_value_ for the datatype of this expression.
+  void InitializeTranslateData();
+
   // Data members.
   Opcode opcode_;
   const PgTypeEntity *type_entity_;
   const PgTypeAttrs type_attrs_;
-  std::function<void(Slice *, const PgWireDataHeader&, int, const YBCPgTypeEntity *,
-                     const PgTypeAttrs *, PgTuple *)> translate_data_;
+  TranslateDataFunc translate_data_ = nullptr;
+  DatumToQLValueFunc datum_to_ql_value_ = nullptr;
 };
 
 class PgConstant : public PgExpr {
@@ -199,6 +253,9 @@ class PgConstant : public PgExpr {
   // Destructor.
   virtual ~PgConstant();
 
+  // Update the value using a datum of the constant's type.
+  void UpdateDatum(uint64_t datum, bool is_null);
+
   // Update numeric.
   void UpdateConstant(int8_t value, bool is_null);
   void UpdateConstant(int16_t value, bool is_null);
@@ -264,7 +321,17 @@ class PgOperator : public PgExpr {
   // Append arguments.
   void AppendArg(PgExpr *arg);
 
+  // Setup aggregate call or condition when constructing statement. Other operators are not sent
+  // to DocDB.
+  CHECKED_STATUS PrepareForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) override;
+
+  // Update values of the arguments in the aggregate call or condition.
+  CHECKED_STATUS Eval(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb) override;
+
  private:
+  // Setup condition that is evaluated by DocDB for every row read.
+  CHECKED_STATUS PrepareConditionForRead(PgDml *pg_stmt, PgsqlExpressionPB *expr_pb);
+
   const string opname_;
   std::vector<PgExpr*> args_;
 };
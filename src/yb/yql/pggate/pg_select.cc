@@ -14,7 +14,9 @@
 //--------------------------------------------------------------------------------------------------
 
 #include "yb/yql/pggate/pg_select.h"
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/yql/pggate/util/pg_doc_data.h"
+#include "yb/client/table.h"
 #include "yb/client/yb_op.h"
 
 namespace yb {
@@ -43,6 +45,7 @@ Status PgSelect::LoadIndex() {
 }
 
 Status PgSelect::Prepare(uint64_t* read_time) {
+  table_cache_generation_ = pg_session_->table_cache_generation();
   RETURN_NOT_OK(LoadTable());
   if (index_id_.IsValid()) {
     RETURN_NOT_OK(LoadIndex());
@@ -59,10 +62,43 @@ Status PgSelect::Prepare(uint64_t* read_time) {
   PrepareColumns();
 
   // Preparation complete.
+  read_doc_op_ = doc_op.get();
   doc_op_ = doc_op;
   return Status::OK();
 }
 
+bool PgSelect::IsReusableFor(
+    const PgSession* pg_session, const PgObjectId& table_id, const PgObjectId& index_id) const {
+  return pg_session_.get() == pg_session && table_id_ == table_id && index_id_ == index_id &&
+         table_cache_generation_ == pg_session_->table_cache_generation();
+}
+
+void PgSelect::Reuse(uint64_t* read_time) {
+  read_doc_op_->Reset(read_time);
+  ResetForReuse();
+  if (index_desc_) {
+    for (PgColumn& col : index_desc_->columns()) {
+      col.Reset();
+    }
+  }
+  ybctid_batch_.clear();
+  key_batch_attr_nums_.clear();
+  key_batch_values_.clear();
+
+  // Same fields as YBPgsqlReadOp::NewSelect() sets.
+  const auto& table = table_desc_->table();
+  read_req_->Clear();
+  read_req_->set_client(YQL_CLIENT_PGSQL);
+  read_req_->set_table_id(table->id());
+  read_req_->set_schema_version(table->schema().version());
+  if (index_id_.IsValid()) {
+    index_req_ = read_req_->mutable_index_request();
+    index_req_->set_table_id(index_id_.GetYBTableId());
+  }
+
+  PrepareColumns();
+}
+
 void PgSelect::PrepareColumns() {
   // When reading, only values of partition columns are special-cased in protobuf.
   // Because Kudu API requires that partition columns must be listed in their created-order, the
@@ -217,19 +253,187 @@ Status PgSelect::BindIndexColumn(int attr_num, PgExpr *attr_value) {
   return Status::OK();
 }
 
+Status PgSelect::AppendGroupBy(PgExpr *group_by) {
+  if (group_by->is_aggregate()) {
+    return STATUS(InvalidArgument, "Aggregate could not be used as group-by expression");
+  }
+  PgsqlExpressionPB *expr_pb = read_req_->add_group_by_exprs();
+  RETURN_NOT_OK(group_by->PrepareForRead(this, expr_pb));
+  expr_binds_[expr_pb] = group_by;
+  return Status::OK();
+}
+
+Status PgSelect::AppendWhere(PgExpr *condition) {
+  if (!condition->is_condition()) {
+    return STATUS(InvalidArgument, "Where expression must be a condition");
+  }
+  // Conditions are appended as operands of one AND condition, so protobufs of the conditions that
+  // were already bound keep their addresses.
+  PgsqlConditionPB *where_pb = read_req_->mutable_where_expr()->mutable_condition();
+  where_pb->set_op(QL_OP_AND);
+  PgsqlExpressionPB *expr_pb = where_pb->add_operands();
+  RETURN_NOT_OK(condition->PrepareForRead(this, expr_pb));
+  expr_binds_[expr_pb] = condition;
+  return Status::OK();
+}
+
+Status PgSelect::AppendOrderBy(PgExpr *order_by, bool is_descending, bool nulls_first) {
+  if (order_by->is_aggregate()) {
+    return STATUS(InvalidArgument, "Aggregate could not be used as sort key");
+  }
+  PgsqlOrderByPB *order_by_pb = read_req_->add_order_by();
+  order_by_pb->set_is_descending(is_descending);
+  order_by_pb->set_nulls_first(nulls_first);
+  PgsqlExpressionPB *expr_pb = order_by_pb->mutable_expr();
+  RETURN_NOT_OK(order_by->PrepareForRead(this, expr_pb));
+  expr_binds_[expr_pb] = order_by;
+  return Status::OK();
+}
+
+Status PgSelect::PrepareAggregate() {
+  std::vector<PgAggregateTarget> aggregate_targets;
+  aggregate_targets.reserve(targets_.size());
+  for (const PgExpr *target : targets_) {
+    aggregate_targets.push_back({target->aggregate_tsopcode(), target->internal_type()});
+  }
+  if (read_req_->group_by_exprs().empty()) {
+    for (const PgAggregateTarget& target : aggregate_targets) {
+      if (target.opcode == bfpg::TSOpcode::kNoOp) {
+        return STATUS(InvalidArgument, "All targets of aggregate select must be aggregates");
+      }
+    }
+  }
+
+  read_req_->set_is_aggregate(true);
+  read_doc_op_->SetAggregateTargets(std::move(aggregate_targets));
+  return Status::OK();
+}
+
+Status PgSelect::SetHashCodeRange(uint16_t min_hash_code, uint16_t max_hash_code) {
+  if (!table_desc_->IsHashPartitioned()) {
+    return STATUS(InvalidArgument, "Hash code range of a table that is not hash partitioned");
+  }
+  if (min_hash_code > max_hash_code) {
+    return STATUS_FORMAT(InvalidArgument, "Empty hash code range: [$0, $1]",
+                         min_hash_code, max_hash_code);
+  }
+  // The request is routed to the tablet of min_hash_code, and the scan continues with the next
+  // tablets until the one that owns max_hash_code.
+  read_req_->set_hash_code(min_hash_code);
+  read_req_->set_max_hash_code(max_hash_code);
+  return Status::OK();
+}
+
+Status PgSelect::BindYbctids(std::vector<PgExpr*> ybctids) {
+  if (index_id_.IsValid() || ybctid_bind_) {
+    return STATUS(InvalidArgument, "Batch of ybctids could not be combined with other keys");
+  }
+  for (const PgExpr* ybctid : ybctids) {
+    if (!ybctid->is_constant()) {
+      return STATUS(InvalidArgument, "Column ybctid must be bound to constant");
+    }
+  }
+  ybctid_batch_ = std::move(ybctids);
+  return Status::OK();
+}
+
+Status PgSelect::BindKeyBatch(std::vector<int> attr_nums, std::vector<PgExpr*> values) {
+  if (index_id_.IsValid() || ybctid_bind_ || !ybctid_batch_.empty()) {
+    return STATUS(InvalidArgument, "Batch of keys could not be combined with other keys");
+  }
+  if (attr_nums.size() != table_desc_->num_key_columns() || values.empty() ||
+      values.size() % attr_nums.size() != 0) {
+    return STATUS(InvalidArgument, "Every key of the batch must have values of all key columns");
+  }
+  for (const PgExpr* value : values) {
+    if (!value->is_constant()) {
+      return STATUS(InvalidArgument, "Keys of the batch must be constants");
+    }
+  }
+  for (int attr_num : attr_nums) {
+    bool is_key_column = false;
+    for (size_t i = 0; i != table_desc_->num_key_columns(); ++i) {
+      is_key_column = is_key_column || table_desc_->columns()[i].attr_num() == attr_num;
+    }
+    if (!is_key_column) {
+      return STATUS_FORMAT(InvalidArgument, "Column $0 is not a key column", attr_num);
+    }
+  }
+
+  // The first key is bound as usual. Values of the other keys are evaluated into the same bind
+  // protobufs when the batch is executed.
+  for (size_t i = 0; i != attr_nums.size(); ++i) {
+    RETURN_NOT_OK(BindColumn(attr_nums[i], values[i]));
+  }
+  key_batch_attr_nums_ = std::move(attr_nums);
+  key_batch_values_ = std::move(values);
+  return Status::OK();
+}
+
 Status PgSelect::Exec() {
   // Delete key columns that are not bound to any values.
   RETURN_NOT_OK(DeleteEmptyPrimaryBinds());
 
+  // Aggregates are computed by DocDB when any of the targets is an aggregate.
+  if (has_aggregate_targets() || !read_req_->group_by_exprs().empty()) {
+    if (index_id_.IsValid()) {
+      return STATUS(NotSupported, "Aggregate select using index is not supported");
+    }
+    RETURN_NOT_OK(PrepareAggregate());
+  }
+
   // Update bind values for constants and placeholders.
   RETURN_NOT_OK(UpdateBindPBs());
 
+  // Results of aggregates are merged by PgDocReadOp, that reads them in row format.
+  if (FLAGS_ysql_columnar_result && !has_aggregate_targets() &&
+      read_req_->group_by_exprs().empty()) {
+    read_req_->set_columnar_result(true);
+  }
+
   // Set column references in protobuf.
   SetColumnRefIds(table_desc_, read_req_->mutable_column_refs());
   if (index_id_.IsValid()) {
     SetColumnRefIds(index_desc_, index_req_->mutable_column_refs());
   }
 
+  // Every ybctid of the batch is read by a copy of the prepared request. All of them are flushed
+  // together, so the batcher sends the keys of the same tablet in one RPC.
+  if (!ybctid_batch_.empty()) {
+    std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops;
+    ops.reserve(ybctid_batch_.size());
+    for (PgExpr* ybctid : ybctid_batch_) {
+      std::shared_ptr<client::YBPgsqlReadOp> op(table_desc_->NewPgsqlSelect());
+      PgsqlReadRequestPB* req = op->mutable_request();
+      *req = *read_req_;
+      RETURN_NOT_OK(ybctid->Eval(this, req->mutable_ybctid_column_value()));
+      ops.push_back(std::move(op));
+    }
+    read_doc_op_->SetBatchOps(std::move(ops));
+  }
+
+  // Every key of the batch is read by a copy of the prepared request with the key values of that
+  // key evaluated into it.
+  if (!key_batch_values_.empty()) {
+    std::vector<PgColumn*> key_columns;
+    for (int attr_num : key_batch_attr_nums_) {
+      PgColumn *col = nullptr;
+      RETURN_NOT_OK(FindColumn(attr_num, &col));
+      key_columns.push_back(col);
+    }
+    std::vector<std::shared_ptr<client::YBPgsqlReadOp>> ops;
+    ops.reserve(key_batch_values_.size() / key_columns.size());
+    for (size_t key = 0; key != key_batch_values_.size(); key += key_columns.size()) {
+      for (size_t i = 0; i != key_columns.size(); ++i) {
+        RETURN_NOT_OK(key_batch_values_[key + i]->Eval(this, key_columns[i]->bind_pb()));
+      }
+      std::shared_ptr<client::YBPgsqlReadOp> op(table_desc_->NewPgsqlSelect());
+      *op->mutable_request() = *read_req_;
+      ops.push_back(std::move(op));
+    }
+    read_doc_op_->SetBatchOps(std::move(ops));
+  }
+
   // Execute select statement asynchronously.
   SCHECK_EQ(VERIFY_RESULT(doc_op_->Execute()), RequestSent::kTrue, IllegalState,
             "YSQL read operation was not sent");
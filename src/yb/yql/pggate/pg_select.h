@@ -46,6 +46,14 @@ class PgSelect : public PgDml {
   // It is available while statement is executed.
   CHECKED_STATUS Prepare(uint64_t* read_time);
 
+  // Whether this statement could be reused by Reuse() for a new select of table_id using index_id.
+  bool IsReusableFor(
+      const PgSession* pg_session, const PgObjectId& table_id, const PgObjectId& index_id) const;
+
+  // Reset the statement to the state Prepare() leaves it in. The table descriptors, the doc op
+  // and the request protobufs are kept, cleared protobufs keep their memory for the next binds.
+  void Reuse(uint64_t* read_time);
+
   // Setup internal structures for binding values during prepare.
   void PrepareColumns();
 
@@ -60,6 +68,35 @@ class PgSelect : public PgDml {
     DCHECK_NOTNULL(read_req_)->set_is_forward_scan(is_forward_scan);
   }
 
+  // Append a group-by expression of an aggregate select. The aggregates are computed by DocDB,
+  // and all targets that are not aggregates must be group-by expressions.
+  CHECKED_STATUS AppendGroupBy(PgExpr *group_by);
+
+  // Append a condition that DocDB evaluates for every row read. Conditions are combined using AND.
+  CHECKED_STATUS AppendWhere(PgExpr *condition);
+
+  // Append a sort key of a top-N select. Each tablet returns only the first rows in the order of
+  // the sort keys, see SetTopNLimit().
+  CHECKED_STATUS AppendOrderBy(PgExpr *order_by, bool is_descending, bool nulls_first);
+
+  // Number of rows each tablet returns for a top-N select.
+  void SetTopNLimit(uint64_t limit) {
+    DCHECK_NOTNULL(read_req_)->set_top_n_limit(limit);
+  }
+
+  // Read only the rows whose hash codes are in [min_hash_code, max_hash_code]. The table must be
+  // hash partitioned.
+  CHECKED_STATUS SetHashCodeRange(uint16_t min_hash_code, uint16_t max_hash_code);
+
+  // Fetch the rows with the given ybctids, which must be constants. The rows are returned in the
+  // order of the ybctids.
+  CHECKED_STATUS BindYbctids(std::vector<PgExpr*> ybctids);
+
+  // Fetch the rows with the given primary keys, which must be constants. values holds the values of
+  // the key columns attr_nums for every key, one key after another. Keys of the same tablet are
+  // read in one RPC, and the rows are returned in the order of the keys.
+  CHECKED_STATUS BindKeyBatch(std::vector<int> attr_nums, std::vector<PgExpr*> values);
+
   // Execute.
   CHECKED_STATUS Exec();
 
@@ -85,13 +122,27 @@ class PgSelect : public PgDml {
   // Load index.
   CHECKED_STATUS LoadIndex();
 
+  // Setup computing of aggregate targets by DocDB.
+  CHECKED_STATUS PrepareAggregate();
+
   PgObjectId index_id_;
   PgTableDesc::ScopedRefPtr index_desc_;
 
+  // Generation of the table cache the table descriptors were loaded from.
+  uint64_t table_cache_generation_ = 0;
+
   // Protobuf instruction.
+  PgDocReadOp *read_doc_op_ = nullptr;
   std::shared_ptr<client::YBPgsqlReadOp> read_op_;
   PgsqlReadRequestPB *read_req_ = nullptr;
   PgsqlReadRequestPB *index_req_ = nullptr;
+
+  // Batch of ybctids to fetch, set by BindYbctids.
+  std::vector<PgExpr*> ybctid_batch_;
+
+  // Batch of primary keys to fetch, set by BindKeyBatch.
+  std::vector<int> key_batch_attr_nums_;
+  std::vector<PgExpr*> key_batch_values_;
 };
 
 }  // namespace pggate
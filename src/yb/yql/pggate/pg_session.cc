@@ -17,6 +17,7 @@
 
 #include "yb/yql/pggate/pg_expr.h"
 #include "yb/yql/pggate/pg_session.h"
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/yql/pggate/pggate_if_cxx_decl.h"
 
 #include "yb/client/batcher.h"
@@ -85,6 +86,22 @@ static constexpr const size_t kPgSequenceLastValueColIdx = 2;
 static constexpr const char* const kPgSequenceIsCalledColName = "is_called";
 static constexpr const size_t kPgSequenceIsCalledColIdx = 3;
 
+namespace {
+
+// Status of a write, that is reported to PostgreSQL.
+Status WriteOpStatus(const client::YBPgsqlWriteOp& op) {
+  switch (op.response().status()) {
+    case PgsqlResponsePB::PGSQL_STATUS_OK:
+      return Status::OK();
+    case PgsqlResponsePB::PGSQL_STATUS_DUPLICATE_KEY_ERROR:
+      return STATUS(AlreadyPresent, op.response().error_message());
+    default:
+      return STATUS(QLError, op.response().error_message());
+  }
+}
+
+} // namespace
+
 //--------------------------------------------------------------------------------------------------
 // Class PgSession
 //--------------------------------------------------------------------------------------------------
@@ -122,14 +139,16 @@ Status PgSession::ConnectDatabase(const string& database_name) {
 Status PgSession::CreateDatabase(const string& database_name,
                                  const PgOid database_oid,
                                  const PgOid source_database_oid,
-                                 const PgOid next_oid) {
+                                 const PgOid next_oid,
+                                 const bool colocated) {
   return client_->CreateNamespace(database_name,
                                   YQL_DATABASE_PGSQL,
                                   "" /* creator_role_name */,
                                   GetPgsqlNamespaceId(database_oid),
                                   source_database_oid != kPgInvalidOid
                                   ? GetPgsqlNamespaceId(source_database_oid) : "",
-                                  next_oid);
+                                  next_oid,
+                                  colocated);
 }
 
 Status PgSession::DropDatabase(const string& database_name, PgOid database_oid) {
@@ -427,6 +446,7 @@ Result<PgTableDesc::ScopedRefPtr> PgSession::LoadTable(const PgObjectId& table_i
 void PgSession::InvalidateTableCache(const PgObjectId& table_id) {
   const TableId yb_table_id = table_id.GetYBTableId();
   table_cache_.erase(yb_table_id);
+  ++table_cache_generation_;
 }
 
 Status PgSession::StartBufferingWriteOperations() {
@@ -447,10 +467,14 @@ Status PgSession::FlushBufferedWriteOperations() {
     client::YBSessionPtr session =
         VERIFY_RESULT(GetSession(false /* transactional */,
                                  false /* read_only_op */))->shared_from_this();
+    std::vector<client::YBOperationPtr> ops;
+    ops.reserve(buffered_write_ops_.size());
     for (const auto& op : buffered_write_ops_) {
       DCHECK(!op->IsTransactional());
-      RETURN_NOT_OK(session->Apply(op));
+      ops.push_back(op);
     }
+    // Applied as a batch, so the ops share tablet lookups.
+    RETURN_NOT_OK(session->Apply(ops));
     Synchronizer sync;
     StatusFunctor callback = sync.AsStatusFunctor();
     session->FlushAsync([this, session, callback] (const Status& status) {
@@ -486,6 +510,16 @@ Result<OpBuffered> PgSession::PgApplyAsync(const std::shared_ptr<client::YBPgsql
   }
 
   auto session = VERIFY_RESULT(GetSessionForOp(op));
+  if (read_time && has_txn_ops_ && !*read_time) {
+    // The statement should see its earlier writes of the transaction, that are still in flight.
+    RETURN_NOT_OK(pg_txn_manager_->WaitForPipelinedWrites());
+  }
+  if (op->type() == YBOperation::Type::PGSQL_READ && op->IsTransactional() &&
+      pg_txn_manager_->IsFollowerRead()) {
+    // The session reads in the past, so the nearest replica that caught up could serve the read.
+    down_cast<client::YBPgsqlReadOp*>(op.get())->set_yb_consistency_level(
+        YBConsistencyLevel::CONSISTENT_PREFIX);
+  }
   if (read_time && has_txn_ops_) {
     if (!*read_time) {
       *read_time = clock_->Now().ToUint64();
@@ -517,6 +551,91 @@ Status PgSession::PgFlushAsync(StatusFunctor callback) {
   return Status::OK();
 }
 
+void PgSession::StartBulkInserts() {
+  bulk_insert_ops_.clear();
+  std::unique_lock<std::mutex> lock(bulk_insert_mutex_);
+  bulk_insert_cond_.wait(lock, [this] { return bulk_flushes_in_flight_ == 0; });
+  bulk_insert_status_ = Status::OK();
+}
+
+Status PgSession::ApplyBulkInsert(std::shared_ptr<client::YBPgsqlWriteOp> op) {
+  {
+    std::lock_guard<std::mutex> lock(bulk_insert_mutex_);
+    RETURN_NOT_OK(bulk_insert_status_);
+  }
+  if (VERIFY_RESULT(PgApplyAsync(op, nullptr /* read_time */)) == OpBuffered::kTrue) {
+    return Status::OK();
+  }
+  bulk_insert_ops_.push_back(std::move(op));
+  if (bulk_insert_ops_.size() >= std::max<size_t>(FLAGS_ysql_bulk_insert_batch_size, 1)) {
+    return FlushBulkBatch();
+  }
+  return Status::OK();
+}
+
+Status PgSession::FlushBulkBatch() {
+  {
+    std::unique_lock<std::mutex> lock(bulk_insert_mutex_);
+    bulk_insert_cond_.wait(lock, [this] {
+      return bulk_flushes_in_flight_ < std::max(FLAGS_ysql_bulk_insert_max_flushes_in_flight, 1);
+    });
+    RETURN_NOT_OK(bulk_insert_status_);
+    ++bulk_flushes_in_flight_;
+  }
+  auto ops = std::move(bulk_insert_ops_);
+  bulk_insert_ops_.clear();
+  auto status = PgFlushAsync([this, ops = std::move(ops)](const Status& status) {
+    BulkBatchFlushed(ops, status);
+  });
+  if (!status.ok()) {
+    BulkBatchFlushed({}, status);
+  }
+  return status;
+}
+
+void PgSession::BulkBatchFlushed(
+    const std::vector<std::shared_ptr<client::YBPgsqlWriteOp>>& ops, const Status& status) {
+  Status result = status;
+  for (const auto& op : ops) {
+    if (!result.ok()) {
+      break;
+    }
+    result = WriteOpStatus(*op);
+  }
+
+  std::lock_guard<std::mutex> lock(bulk_insert_mutex_);
+  if (bulk_insert_status_.ok()) {
+    bulk_insert_status_ = result;
+  }
+  --bulk_flushes_in_flight_;
+  bulk_insert_cond_.notify_all();
+}
+
+Status PgSession::ApplyPipelinedWrite(std::shared_ptr<client::YBPgsqlWriteOp> op) {
+  client::YBSessionPtr session =
+      VERIFY_RESULT(GetSession(true /* transactional */, false /* read_only_op */))
+          ->shared_from_this();
+  RETURN_NOT_OK(session->Apply(op));
+  return session->FlushPipelined([this, session, op](const Status& status) -> Status {
+    RETURN_NOT_OK(CombineErrorsToStatus(session->GetPendingErrors(), status));
+    return WriteOpStatus(*op);
+  });
+}
+
+Status PgSession::FlushBulkInserts() {
+  Status status;
+  if (!bulk_insert_ops_.empty()) {
+    status = FlushBulkBatch();
+  }
+  std::unique_lock<std::mutex> lock(bulk_insert_mutex_);
+  bulk_insert_cond_.wait(lock, [this] { return bulk_flushes_in_flight_ == 0; });
+  if (status.ok()) {
+    status = bulk_insert_status_;
+  }
+  bulk_insert_status_ = Status::OK();
+  return status;
+}
+
 Status PgSession::RestartTransaction() {
   return pg_txn_manager_->RestartTransaction();
 }
@@ -562,7 +681,7 @@ Status PgSession::CombineErrorsToStatus(client::CollectedErrors errors, Status s
 Result<YBSession*> PgSession::GetSession(bool transactional, bool read_only_op) {
   if (transactional) {
     YBSession* txn_session = VERIFY_RESULT(pg_txn_manager_->GetTransactionalSession());
-    pg_txn_manager_->BeginWriteTransactionIfNecessary(read_only_op);
+    RETURN_NOT_OK(pg_txn_manager_->BeginWriteTransactionIfNecessary(read_only_op));
     VLOG(2) << __PRETTY_FUNCTION__
             << ": read_only_op=" << read_only_op << ", returning transactional session";
     return txn_session;
@@ -14,6 +14,9 @@
 #ifndef YB_YQL_PGGATE_PG_SESSION_H_
 #define YB_YQL_PGGATE_PG_SESSION_H_
 
+#include <condition_variable>
+#include <mutex>
+
 #include <boost/optional.hpp>
 
 #include "yb/client/client.h"
@@ -69,7 +72,8 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   CHECKED_STATUS CreateDatabase(const std::string& database_name,
                                 PgOid database_oid,
                                 PgOid source_database_oid,
-                                PgOid nexte_oid);
+                                PgOid nexte_oid,
+                                const bool colocated);
   CHECKED_STATUS DropDatabase(const std::string& database_name, PgOid database_oid);
 
   CHECKED_STATUS ReserveOids(PgOid database_oid,
@@ -134,6 +138,34 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
                                   uint64_t* read_time);
 
   CHECKED_STATUS PgFlushAsync(StatusFunctor callback);
+
+  // Bulk insert used by COPY FROM. Inserts are applied to the session and flushed every
+  // ysql_bulk_insert_batch_size rows without waiting for the flush to complete, keeping up to
+  // ysql_bulk_insert_max_flushes_in_flight flushes in flight. The batcher groups the rows of each
+  // flush into one RPC per tablet. An error is reported by one of the following calls, so the rows
+  // applied after the failed one could be written anyway, the same as the statement is aborted.
+  //
+  // StartBulkInserts drops the state left by a bulk insert that was aborted by an error.
+  void StartBulkInserts();
+  CHECKED_STATUS ApplyBulkInsert(std::shared_ptr<client::YBPgsqlWriteOp> op);
+
+  // Flush rows applied by ApplyBulkInsert and wait until all bulk insert flushes complete.
+  CHECKED_STATUS FlushBulkInserts();
+
+  // Sends a write of the current transaction without waiting for it, when ysql_pipelined_writes
+  // is set. Failure of the write is reported by the next statement that reads in the
+  // transaction, or by its commit.
+  CHECKED_STATUS ApplyPipelinedWrite(std::shared_ptr<client::YBPgsqlWriteOp> op);
+
+  // Catalog version the relation cache is being preloaded at, or 0 when it is not being preloaded.
+  // Catalog scans of the preload are shared by the backends of the node (see PgCatalogCache).
+  void SetCatalogPreloadVersion(uint64_t version) {
+    catalog_preload_version_ = version;
+  }
+  uint64_t catalog_preload_version() const {
+    return catalog_preload_version_;
+  }
+
   CHECKED_STATUS RestartTransaction();
   bool HasAppliedOperations() const;
 
@@ -178,6 +210,13 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   void InvalidateCache() {
     table_cache_.clear();
+    ++table_cache_generation_;
+  }
+
+  // Incremented whenever cached tables are invalidated. Statements prepared with an older
+  // generation could use stale table descriptors.
+  uint64_t table_cache_generation() const {
+    return table_cache_generation_;
   }
 
   // Check if initdb has already been run before. Needed to make initdb idempotent.
@@ -199,6 +238,12 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   // that is later passed to PostgreSQL and further converted into a more specific error code.
   Status CombineErrorsToStatus(client::CollectedErrors errors, Status status);
 
+  // Flush rows of the current bulk insert batch, waits while too many flushes are in flight.
+  CHECKED_STATUS FlushBulkBatch();
+
+  void BulkBatchFlushed(
+      const std::vector<std::shared_ptr<client::YBPgsqlWriteOp>>& ops, const Status& status);
+
   // YBClient, an API that SQL engine uses to communicate with all servers.
   client::YBClient* const client_;
 
@@ -221,6 +266,7 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
   ObjectIdGenerator rowid_generator_;
 
   std::unordered_map<TableId, std::shared_ptr<client::YBTable>> table_cache_;
+  uint64_t table_cache_generation_ = 0;
 
   // Should write operations be buffered?
   bool buffer_write_ops_ = false;
@@ -228,6 +274,16 @@ class PgSession : public RefCountedThreadSafe<PgSession> {
 
   bool has_txn_ops_ = false;
   bool has_non_txn_ops_ = false;
+
+  // Bulk insert state. The mutex protects the fields below it, because flush callbacks are invoked
+  // by the reactor threads.
+  std::vector<std::shared_ptr<client::YBPgsqlWriteOp>> bulk_insert_ops_;
+  std::mutex bulk_insert_mutex_;
+  std::condition_variable bulk_insert_cond_;
+  int bulk_flushes_in_flight_ = 0;
+  Status bulk_insert_status_;
+
+  uint64_t catalog_preload_version_ = 0;
 };
 
 }  // namespace pggate
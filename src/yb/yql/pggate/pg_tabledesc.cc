@@ -77,6 +77,14 @@ bool PgTableDesc::IsTransactional() const {
   return table_->schema().table_properties().is_transactional();
 }
 
+bool PgTableDesc::IsColocated() const {
+  return table_->colocated();
+}
+
+bool PgTableDesc::IsHashPartitioned() const {
+  return !IsColocated() && table_->partition_schema().IsHashPartitioning();
+}
+
 const client::YBTableName& PgTableDesc::table_name() const {
   return table_->name();
 }
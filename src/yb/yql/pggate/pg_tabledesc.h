@@ -64,6 +64,12 @@ class PgTableDesc : public RefCountedThreadSafe<PgTableDesc> {
 
   bool IsTransactional() const;
 
+  // Whether the table is stored in the tablet shared by the tables of its colocated database.
+  bool IsColocated() const;
+
+  // Whether the tablets of the table own ranges of hash codes of the hash columns.
+  bool IsHashPartitioned() const;
+
  private:
   std::shared_ptr<client::YBTable> table_;
 
@@ -65,12 +65,65 @@ Status PgTxnManager::SetIsolationLevel(int level) {
   return Status::OK();
 }
 
+Status PgTxnManager::SetFollowerReadStaleness(int staleness_ms) {
+  if (staleness_ms < 0) {
+    return STATUS_FORMAT(InvalidArgument, "Invalid follower read staleness: $0ms", staleness_ms);
+  }
+  // Query layer only changes the staleness before the first read of a transaction.
+  follower_read_staleness_ms_ = staleness_ms;
+  if (session_ && !txn_) {
+    SetSessionReadPoint();
+  }
+  return Status::OK();
+}
+
+bool PgTxnManager::IsFollowerRead() const {
+  // Serializable reads write read intents, so they are served by leaders.
+  return follower_read_staleness_ms_ > 0 && isolation_level_ != kSerializable && !txn_;
+}
+
 void PgTxnManager::StartNewSession() {
   session_ = std::make_shared<YBSession>(async_client_init_->client(), clock_);
-  session_->SetReadPoint(client::Restart::kFalse);
+  SetSessionReadPoint();
   session_->SetForceConsistentRead(client::ForceConsistentRead::kTrue);
 }
 
+void PgTxnManager::SetSessionReadPoint() {
+  if (IsFollowerRead()) {
+    // Any replica whose safe time passed this read time could serve the reads, so it does not
+    // depend on which one serves them and no read restart is required.
+    session_->SetReadPoint(ReadHybridTime::SingleTime(
+        clock_->Now().AddMilliseconds(-follower_read_staleness_ms_)));
+  } else {
+    session_->SetReadPoint(client::Restart::kFalse);
+  }
+}
+
+bool PgTxnManager::CanShareReadTime() {
+  return session_ && !txn_;
+}
+
+Status PgTxnManager::ExportReadTime(uint64_t* read_time, uint64_t* global_limit) {
+  if (!CanShareReadTime()) {
+    return STATUS(IllegalState, "Read time of a transaction that wrote could not be shared");
+  }
+  const auto current = session_->GetReadTime();
+  *read_time = current.read.ToUint64();
+  *global_limit = current.global_limit.ToUint64();
+  read_time_shared_ = true;
+  return Status::OK();
+}
+
+Status PgTxnManager::ImportReadTime(uint64_t read_time, uint64_t global_limit) {
+  if (!CanShareReadTime()) {
+    return STATUS(IllegalState, "Could not import read time into a transaction that wrote");
+  }
+  session_->SetReadPoint(ReadHybridTime::FromHybridTimeRange(
+      {HybridTime(read_time), HybridTime(global_limit)}));
+  read_time_shared_ = true;
+  return Status::OK();
+}
+
 Status PgTxnManager::BeginWriteTransactionIfNecessary(bool read_only_op) {
   VLOG(2) << "BeginWriteTransactionIfNecessary: txn_in_progress_="
           << txn_in_progress_;
@@ -87,6 +140,9 @@ Status PgTxnManager::BeginWriteTransactionIfNecessary(bool read_only_op) {
   if (txn_) {
     return Status::OK();
   }
+  if (IsFollowerRead()) {
+    return STATUS(IllegalState, "Cannot write in a transaction that reads from followers");
+  }
   txn_ = std::make_shared<YBTransaction>(GetOrCreateTransactionManager());
   RETURN_NOT_OK(txn_->Init(isolation));
   if (!session_) {
@@ -101,6 +157,10 @@ Status PgTxnManager::RestartTransaction() {
     if (!session_->IsRestartRequired()) {
       return STATUS(IllegalState, "Attempted to restart when session does not require restart");
     }
+    if (read_time_shared_) {
+      // The other backends that read at the same time would not see the rows read after restart.
+      return STATUS(TryAgain, "Read restart required for a read time shared with parallel workers");
+    }
     session_->SetReadPoint(client::Restart::kTrue);
     return Status::OK();
   }
@@ -115,6 +175,13 @@ Status PgTxnManager::RestartTransaction() {
   return Status::OK();
 }
 
+Status PgTxnManager::WaitForPipelinedWrites() {
+  if (!txn_) {
+    return Status::OK();
+  }
+  return txn_->PipelinedWritesFuture().get();
+}
+
 bool PgTxnManager::HasAppliedOperations() {
   return txn_ && txn_->HasOperations();
 }
@@ -178,6 +245,7 @@ void PgTxnManager::ResetTxnAndSession() {
   txn_in_progress_ = false;
   session_ = nullptr;
   txn_ = nullptr;
+  read_time_shared_ = false;
 }
 
 }  // namespace pggate
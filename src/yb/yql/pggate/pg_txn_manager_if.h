@@ -39,6 +39,16 @@ YBC_STATUS_METHOD(BeginTransaction, ((int, isolation)))
 YBC_STATUS_METHOD_NO_ARGS(CommitTransaction)
 YBC_STATUS_METHOD_NO_ARGS(AbortTransaction)
 YBC_STATUS_METHOD(SetIsolationLevel, ((int, isolation)));
+YBC_STATUS_METHOD(SetFollowerReadStaleness, ((int, staleness_ms)));
+
+// Whether other backends could read at the read time of the current transaction, i.e. it did not
+// write. Parallel workers use the read time of the leader, but could not see its writes.
+YBC_METHOD_NO_ARGS(bool, CanShareReadTime);
+
+// Read time of the current transaction, that parallel workers import to read at the same snapshot.
+// Neither the leader nor the workers could restart reads after that.
+YBC_STATUS_METHOD(ExportReadTime, ((uint64_t*, read_time))((uint64_t*, global_limit)));
+YBC_STATUS_METHOD(ImportReadTime, ((uint64_t, read_time))((uint64_t, global_limit)));
 
 #ifdef YBC_CXX_DECLARATION_MODE
   PgTxnManager(client::AsyncClientInitialiser* async_client_init,
@@ -48,14 +58,22 @@ YBC_STATUS_METHOD(SetIsolationLevel, ((int, isolation)));
   yb::Result<client::YBSession*> GetTransactionalSession();
 
   Status BeginWriteTransactionIfNecessary(bool read_only_op);
+
+  // Waits for pipelined writes of the current transaction, returns the first failure of them.
+  Status WaitForPipelinedWrites();
   Status RestartTransaction();
   bool HasAppliedOperations();
 
+  // Whether reads of the current transaction may be served by followers, i.e. follower reads are
+  // enabled for a snapshot isolation transaction that did not write.
+  bool IsFollowerRead() const;
+
  private:
 
   client::TransactionManager* GetOrCreateTransactionManager();
   void ResetTxnAndSession();
   void StartNewSession();
+  void SetSessionReadPoint();
 
   bool txn_in_progress_ = false;
   client::YBTransactionPtr txn_;
@@ -68,6 +86,13 @@ YBC_STATUS_METHOD(SetIsolationLevel, ((int, isolation)));
   std::unique_ptr<client::TransactionManager> transaction_manager_holder_;
   int isolation_level_ = 1;
 
+  // Read-only transactions read at this many milliseconds in the past from the nearest replica,
+  // when positive.
+  int follower_read_staleness_ms_ = 0;
+
+  // Whether the read time of the transaction was exported to or imported from other backends.
+  bool read_time_shared_ = false;
+
   DISALLOW_COPY_AND_ASSIGN(PgTxnManager);
 #endif  // YBC_CXX_DECLARATION_MODE
 
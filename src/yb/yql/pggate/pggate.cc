@@ -84,6 +84,7 @@ PgApiImpl::PgApiImpl(const YBCPgTypeEntity *YBCDataTypeArray, int count)
 }
 
 PgApiImpl::~PgApiImpl() {
+  select_pool_.clear();
   client()->messenger()->Shutdown();
 }
 
@@ -124,6 +125,11 @@ Status PgApiImpl::CreateSession(const PgEnv *pg_env,
 
 Status PgApiImpl::DestroySession(PgSession *pg_session) {
   if (pg_session) {
+    auto it = std::remove_if(select_pool_.begin(), select_pool_.end(),
+                             [pg_session](const PgStatement::ScopedRefPtr& stmt) {
+                               return stmt->pg_session().get() == pg_session;
+                             });
+    select_pool_.erase(it, select_pool_.end());
     pg_session->Release();
   }
   return Status::OK();
@@ -192,6 +198,11 @@ Status PgApiImpl::DeleteSequenceTuple(PgSession *pg_session, int64_t db_oid, int
 
 Status PgApiImpl::DeleteStatement(PgStatement *handle) {
   if (handle) {
+    // Nobody else references a statement that is deleted, so it could be reused by NewSelect().
+    if (PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT) && handle->HasOneRef() &&
+        select_pool_.size() < FLAGS_ysql_select_statement_pool_size) {
+      select_pool_.emplace_back(handle);
+    }
     handle->Release();
   }
   return Status::OK();
@@ -212,9 +223,10 @@ Status PgApiImpl::NewCreateDatabase(PgSession *pg_session,
                                     const PgOid database_oid,
                                     const PgOid source_database_oid,
                                     const PgOid next_oid,
+                                    const bool colocated,
                                     PgStatement **handle) {
   auto stmt = make_scoped_refptr<PgCreateDatabase>(pg_session, database_name, database_oid,
-                                                   source_database_oid, next_oid);
+                                                   source_database_oid, next_oid, colocated);
   *handle = stmt.detach();
   return Status::OK();
 }
@@ -414,6 +426,11 @@ Status PgApiImpl::GetColumnInfo(YBCPgTableDesc table_desc,
   return table_desc->GetColumnInfo(attr_number, is_primary, is_hash);
 }
 
+Status PgApiImpl::IsHashPartitionedTable(YBCPgTableDesc table_desc, bool *is_hash_partitioned) {
+  *is_hash_partitioned = table_desc->IsHashPartitioned();
+  return Status::OK();
+}
+
 Status PgApiImpl::SetIfIsSysCatalogVersionChange(PgStatement *handle, bool *is_version_change) {
   if (!handle) {
     return STATUS(InvalidArgument, "Invalid statement handle");
@@ -583,6 +600,26 @@ Status PgApiImpl::ExecInsert(PgStatement *handle) {
   return down_cast<PgInsert*>(handle)->Exec();
 }
 
+void PgApiImpl::StartBulkInserts(PgSession *pg_session) {
+  pg_session->StartBulkInserts();
+}
+
+void PgApiImpl::SetCatalogPreloadVersion(PgSession *pg_session, uint64_t version) {
+  pg_session->SetCatalogPreloadVersion(version);
+}
+
+Status PgApiImpl::ExecBulkInsert(PgStatement *handle) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_INSERT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgInsert*>(handle)->ExecBulk();
+}
+
+Status PgApiImpl::FlushBulkInserts(PgSession *pg_session) {
+  return pg_session->FlushBulkInserts();
+}
+
 // Update ------------------------------------------------------------------------------------------
 
 Status PgApiImpl::NewUpdate(PgSession *pg_session,
@@ -634,6 +671,16 @@ Status PgApiImpl::NewSelect(PgSession *pg_session,
                             uint64_t* read_time) {
   DCHECK(pg_session) << "Invalid session handle";
   *handle = nullptr;
+  for (auto it = select_pool_.begin(); it != select_pool_.end(); ++it) {
+    auto* pooled = down_cast<PgSelect*>(it->get());
+    if (pooled->IsReusableFor(pg_session, table_id, index_id)) {
+      pooled->Reuse(read_time);
+      *handle = it->detach();
+      select_pool_.erase(it);
+      return Status::OK();
+    }
+  }
+
   auto stmt = make_scoped_refptr<PgSelect>(pg_session, table_id);
   if (index_id.IsValid()) {
     stmt->UseIndex(index_id);
@@ -652,6 +699,66 @@ Status PgApiImpl::SetForwardScan(PgStatement *handle, bool is_forward_scan) {
   return Status::OK();
 }
 
+Status PgApiImpl::SelectAppendGroupBy(PgStatement *handle, PgExpr *group_by) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->AppendGroupBy(group_by);
+}
+
+Status PgApiImpl::SelectAppendWhere(PgStatement *handle, PgExpr *condition) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->AppendWhere(condition);
+}
+
+Status PgApiImpl::SelectAppendOrderBy(PgStatement *handle, PgExpr *order_by, bool is_descending,
+                                      bool nulls_first) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->AppendOrderBy(order_by, is_descending, nulls_first);
+}
+
+Status PgApiImpl::SelectSetTopNLimit(PgStatement *handle, uint64_t limit) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  down_cast<PgSelect*>(handle)->SetTopNLimit(limit);
+  return Status::OK();
+}
+
+Status PgApiImpl::SelectSetHashCodeRange(PgStatement *handle, uint16_t min_hash_code,
+                                         uint16_t max_hash_code) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->SetHashCodeRange(min_hash_code, max_hash_code);
+}
+
+Status PgApiImpl::SelectBindYbctids(PgStatement *handle, std::vector<PgExpr*> ybctids) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->BindYbctids(std::move(ybctids));
+}
+
+Status PgApiImpl::SelectBindKeyBatch(PgStatement *handle, std::vector<int> attr_nums,
+                                     std::vector<PgExpr*> values) {
+  if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid statement handle");
+  }
+  return down_cast<PgSelect*>(handle)->BindKeyBatch(std::move(attr_nums), std::move(values));
+}
+
 Status PgApiImpl::ExecSelect(PgStatement *handle) {
   if (!PgStatement::IsValidStmt(handle, StmtOp::STMT_SELECT)) {
     // Invalid handle.
@@ -713,6 +820,15 @@ Status PgApiImpl::UpdateConstant(PgExpr *expr, const void *value, int64_t bytes,
   return Status::OK();
 }
 
+Status PgApiImpl::UpdateConstantDatum(PgExpr *expr, uint64_t datum, bool is_null) {
+  if (expr->opcode() != PgExpr::Opcode::PG_EXPR_CONSTANT) {
+    // Invalid handle.
+    return STATUS(InvalidArgument, "Invalid expression handle for constant");
+  }
+  down_cast<PgConstant*>(expr)->UpdateDatum(datum, is_null);
+  return Status::OK();
+}
+
 // Text constant -----------------------------------------------------------------------------------
 
 Status PgApiImpl::NewOperator(PgStatement *stmt, const char *opname,
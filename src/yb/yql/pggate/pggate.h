@@ -142,6 +142,7 @@ class PgApiImpl {
                                    PgOid database_oid,
                                    PgOid source_database_oid,
                                    PgOid next_oid,
+                                   const bool colocated,
                                    PgStatement **handle);
   CHECKED_STATUS ExecCreateDatabase(PgStatement *handle);
 
@@ -221,6 +222,8 @@ class PgApiImpl {
                                bool *is_primary,
                                bool *is_hash);
 
+  CHECKED_STATUS IsHashPartitionedTable(YBCPgTableDesc table_desc, bool *is_hash_partitioned);
+
   CHECKED_STATUS SetIfIsSysCatalogVersionChange(PgStatement *handle, bool *is_version_change);
 
   CHECKED_STATUS SetCatalogCacheVersion(PgStatement *handle, uint64_t catalog_cache_version);
@@ -289,12 +292,13 @@ class PgApiImpl {
   // DB Operations: SET, WHERE, ORDER_BY, GROUP_BY, etc.
   // + The following operations are run by DocDB.
   //   - API for "set_clause" (not yet implemented).
+  //   - API for "group_by_expr" (see SelectAppendGroupBy()).
+  //   - API for "where_expr" conditions that DocDB could evaluate (see SelectAppendWhere()).
+  //   - API for "order_by_expr" with a limit, evaluated per tablet (see SelectAppendOrderBy()).
   //
   // + The following operations are run by Postgres layer. An API might be added to move these
   //   operations to DocDB.
-  //   - API for "where_expr"
-  //   - API for "order_by_expr"
-  //   - API for "group_by_expr"
+  //   - API for "order_by_expr" without a limit.
 
   // Buffer write operations.
   CHECKED_STATUS StartBufferingWriteOperations(PgSession *pg_session);
@@ -309,6 +313,14 @@ class PgApiImpl {
 
   CHECKED_STATUS ExecInsert(PgStatement *handle);
 
+  // Bulk insert used by COPY FROM.
+  void StartBulkInserts(PgSession *pg_session);
+  CHECKED_STATUS ExecBulkInsert(PgStatement *handle);
+  CHECKED_STATUS FlushBulkInserts(PgSession *pg_session);
+
+  // Catalog scans that preload the relation cache.
+  void SetCatalogPreloadVersion(PgSession *pg_session, uint64_t version);
+
   //------------------------------------------------------------------------------------------------
   // Update.
   CHECKED_STATUS NewUpdate(PgSession *pg_session, const PgObjectId& table_id, PgStatement **handle);
@@ -328,6 +340,23 @@ class PgApiImpl {
 
   CHECKED_STATUS SetForwardScan(PgStatement *handle, bool is_forward_scan);
 
+  CHECKED_STATUS SelectAppendGroupBy(PgStatement *handle, PgExpr *group_by);
+
+  CHECKED_STATUS SelectAppendWhere(PgStatement *handle, PgExpr *condition);
+
+  CHECKED_STATUS SelectAppendOrderBy(PgStatement *handle, PgExpr *order_by, bool is_descending,
+                                     bool nulls_first);
+
+  CHECKED_STATUS SelectSetTopNLimit(PgStatement *handle, uint64_t limit);
+
+  CHECKED_STATUS SelectSetHashCodeRange(PgStatement *handle, uint16_t min_hash_code,
+                                        uint16_t max_hash_code);
+
+  CHECKED_STATUS SelectBindYbctids(PgStatement *handle, std::vector<PgExpr*> ybctids);
+
+  CHECKED_STATUS SelectBindKeyBatch(PgStatement *handle, std::vector<int> attr_nums,
+                                    std::vector<PgExpr*> values);
+
   CHECKED_STATUS ExecSelect(PgStatement *handle);
 
   //------------------------------------------------------------------------------------------------
@@ -358,6 +387,7 @@ class PgApiImpl {
   }
   CHECKED_STATUS UpdateConstant(PgExpr *expr, const char *value, bool is_null);
   CHECKED_STATUS UpdateConstant(PgExpr *expr, const void *value, int64_t bytes, bool is_null);
+  CHECKED_STATUS UpdateConstantDatum(PgExpr *expr, uint64_t datum, bool is_null);
 
   // Operators.
   CHECKED_STATUS NewOperator(PgStatement *stmt, const char *opname,
@@ -388,6 +418,10 @@ class PgApiImpl {
 
   // Mapping table of YugaByte and PostgreSQL datatypes.
   std::unordered_map<int, const YBCPgTypeEntity *>type_map_;
+
+  // Select statements released by DeleteStatement(). NewSelect() resets and reuses them instead of
+  // preparing new ones, bounded by ysql_select_statement_pool_size.
+  std::vector<PgStatement::ScopedRefPtr> select_pool_;
 };
 
 }  // namespace pggate
@@ -44,3 +44,70 @@ DEFINE_int32(ysql_prefetch_limit, 1024,
 
 DEFINE_double(ysql_backward_prefetch_scale_factor, 0.0625 /* 1/16th */,
               "Scale factor to reduce ysql_prefetch_limit for backward scan");
+
+DEFINE_int32(ysql_max_prefetch_limit, 8192,
+             "Upper bound for the number of rows to prefetch. A scan whose consumer keeps waiting "
+             "for the read-ahead page doubles its page size, starting from ysql_prefetch_limit, "
+             "up to this limit");
+
+DEFINE_uint64(ysql_prefetch_max_buffered_bytes, 8 * 1024 * 1024,
+              "Size of the fetched rows a scan could buffer ahead of its consumer. The next page is "
+              "requested as soon as the previous one is received while the buffered pages are "
+              "smaller than this, and pages larger than half of it halve the page size");
+
+DEFINE_int32(ysql_scan_parallelism, 1,
+             "Max number of sub-ranges of a tablet that tablet server could scan concurrently for "
+             "a forward sequential scan. Such scans return rows out of key order");
+
+DEFINE_int32(ysql_index_fetch_batch_size, 128,
+             "Max number of base table rows a secondary index scan fetches in one batch. Rows of "
+             "the same tablet are fetched in one RPC. Values less than 2 fetch rows one by one");
+
+DEFINE_int32(ysql_nested_loop_batch_size, 1,
+             "Number of outer rows a nested loop join collects before it fetches the matching "
+             "inner rows by primary key in one batch. Values less than 2 fetch inner rows for "
+             "every outer row");
+
+DEFINE_int32(ysql_foreign_key_check_batch_size, 128,
+             "Number of foreign key checks of referencing rows that are collected before the "
+             "referenced primary keys are looked up in one batch. Values less than 2 check every "
+             "row separately");
+
+DEFINE_uint64(ysql_select_statement_pool_size, 16,
+              "Max number of finished select statements each backend keeps to reuse them, with "
+              "their table descriptors and request protobufs, for later selects of the same table");
+
+DEFINE_bool(ysql_columnar_result, false,
+             "Request rows of plain table scans from tablet servers in columnar format");
+
+DEFINE_int32(ysql_bulk_insert_batch_size, 512,
+             "Number of rows COPY FROM applies before it flushes them. Rows of the same tablet "
+             "are sent in one RPC");
+
+DEFINE_int32(ysql_bulk_insert_max_flushes_in_flight, 4,
+             "Max number of bulk insert flushes COPY FROM keeps in flight before it waits for "
+             "the oldest of them to complete");
+
+DEFINE_bool(ysql_pipelined_writes, false,
+            "Do not wait for writes of a transaction, that return no rows, to be replicated "
+            "before the next statement. They are waited for by the next statement, that reads in "
+            "the transaction, or by commit, which also reports their failures.");
+
+DEFINE_string(ysql_catalog_cache_dir, "",
+              "Directory where backends save the catalog scans they use to preload the relation "
+              "cache, so other backends of the node could read them instead of the master. Empty "
+              "disables sharing of catalog scans");
+
+DEFINE_int64(ysql_sequence_cache_minval, 1,
+             "Min number of sequence values each backend allocates at once, with one read and one "
+             "conditional update of the sequence. Sequences created with a larger CACHE allocate "
+             "that many values. Unused values of a backend are lost when it exits");
+
+DEFINE_bool(ysql_enable_parallel_scans, false,
+            "Whether sequential scans of hash partitioned user tables could be divided among "
+            "Postgres parallel workers. Workers read at the snapshot of the leader, so "
+            "transactions that wrote are scanned by the leader alone");
+
+DEFINE_int32(ysql_parallel_scan_chunks_per_worker, 4,
+             "Number of hash code ranges per participant that a parallel scan divides the table "
+             "into. Each participant claims the next range when it is done with the previous one");
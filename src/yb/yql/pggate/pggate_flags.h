@@ -23,5 +23,20 @@ DECLARE_string(pggate_proxy_bind_address);
 DECLARE_string(pggate_master_addresses);
 DECLARE_int32(ysql_prefetch_limit);
 DECLARE_double(ysql_backward_prefetch_scale_factor);
+DECLARE_int32(ysql_max_prefetch_limit);
+DECLARE_uint64(ysql_prefetch_max_buffered_bytes);
+DECLARE_int32(ysql_scan_parallelism);
+DECLARE_int32(ysql_index_fetch_batch_size);
+DECLARE_int32(ysql_nested_loop_batch_size);
+DECLARE_int32(ysql_foreign_key_check_batch_size);
+DECLARE_uint64(ysql_select_statement_pool_size);
+DECLARE_bool(ysql_columnar_result);
+DECLARE_int32(ysql_bulk_insert_batch_size);
+DECLARE_int32(ysql_bulk_insert_max_flushes_in_flight);
+DECLARE_bool(ysql_pipelined_writes);
+DECLARE_string(ysql_catalog_cache_dir);
+DECLARE_int64(ysql_sequence_cache_minval);
+DECLARE_bool(ysql_enable_parallel_scans);
+DECLARE_int32(ysql_parallel_scan_chunks_per_worker);
 
 #endif  // YB_YQL_PGGATE_PGGATE_FLAGS_H
@@ -262,5 +262,311 @@ TEST_F(PggateTestSelect, TestSelectOneTablet) {
   pg_stmt = nullptr;
 }
 
+TEST_F(PggateTestSelect, TestSelectWhere) {
+  CHECK_OK(Init("TestSelectWhere"));
+
+  const char *tabname = "where_table";
+  const YBCPgOid tab_oid = 4;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                               DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val", ++col_count,
+                                               DataType::INT32, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  CommitTransaction();
+  pg_stmt = nullptr;
+
+  // INSERT ----------------------------------------------------------------------------------------
+  constexpr int kInsertRowCount = 20;
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  YBCPgExpr expr_val;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, 0, false, &expr_val));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_val));
+  for (int i = 0; i < kInsertRowCount; i++) {
+    YBCPgUpdateConstInt8(expr_hash, i, false);
+    YBCPgUpdateConstInt4(expr_val, i, false);
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT hash_key, val FROM where_table WHERE val >= 5 AND val < 15 AND NOT (val = 10) ----------
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCPgExpr colref;
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+
+  auto new_condition = [pg_stmt](const char *opname, int32_t value) {
+    YBCPgExpr condition;
+    CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, opname, YBCPgFindTypeEntity(BOOLOID), &condition));
+    YBCPgExpr arg;
+    YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &arg);
+    CHECK_YBC_STATUS(YBCPgOperatorAppendArg(condition, arg));
+    CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, value, false, &arg));
+    CHECK_YBC_STATUS(YBCPgOperatorAppendArg(condition, arg));
+    return condition;
+  };
+  CHECK_YBC_STATUS(YBCPgSelectAppendWhere(pg_stmt, new_condition(">=", 5)));
+  CHECK_YBC_STATUS(YBCPgSelectAppendWhere(pg_stmt, new_condition("<", 15)));
+  YBCPgExpr not_equal;
+  CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, "not", YBCPgFindTypeEntity(BOOLOID), &not_equal));
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(not_equal, new_condition("=", 10)));
+  CHECK_YBC_STATUS(YBCPgSelectAppendWhere(pg_stmt, not_equal));
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // Only matching rows are returned by DocDB.
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  int select_row_count = 0;
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    const int32_t val = static_cast<int32_t>(values[1]);
+    CHECK_EQ(values[0], val);
+    CHECK_GE(val, 5);
+    CHECK_LT(val, 15);
+    CHECK_NE(val, 10);
+    select_row_count++;
+  }
+  CHECK_EQ(select_row_count, 9);
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+}
+
+TEST_F(PggateTestSelect, TestReuseSelect) {
+  CHECK_OK(Init("TestReuseSelect"));
+
+  const char *tabname = "reuse_table";
+  const YBCPgOid tab_oid = 5;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                               DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val", ++col_count,
+                                               DataType::INT32, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  CommitTransaction();
+  pg_stmt = nullptr;
+
+  // INSERT ----------------------------------------------------------------------------------------
+  constexpr int kInsertRowCount = 10;
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  YBCPgExpr expr_val;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, 0, false, &expr_val));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_val));
+  for (int i = 0; i < kInsertRowCount; i++) {
+    YBCPgUpdateConstInt8(expr_hash, i, false);
+    YBCPgUpdateConstInt4(expr_val, 100 + i, false);
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT val FROM reuse_table WHERE hash_key = i, alternating with full scans -------------------
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  YBCPgStatement prev_stmt = nullptr;
+  for (int i = 0; i < kInsertRowCount; i++) {
+    CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid,
+                                    &pg_stmt, nullptr /* read_time */));
+    // The statement deleted by the previous iteration is reset and reused.
+    if (prev_stmt != nullptr) {
+      CHECK_EQ(pg_stmt, prev_stmt);
+    }
+    prev_stmt = pg_stmt;
+
+    YBCPgExpr colref;
+    YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+    CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+    const bool point_select = i % 2 == 0;
+    if (point_select) {
+      CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, i, false, &expr_hash));
+      CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+    }
+    CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+    int select_row_count = 0;
+    for (;;) {
+      bool has_data = false;
+      CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data));
+      if (!has_data) {
+        break;
+      }
+      if (point_select) {
+        CHECK_EQ(static_cast<int32_t>(values[1]), 100 + i);
+      }
+      select_row_count++;
+    }
+    CHECK_EQ(select_row_count, point_select ? 1 : kInsertRowCount);
+
+    CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+    pg_stmt = nullptr;
+  }
+}
+
+// Reports the time to bind and fetch rows of a table with many columns of mixed types, that is
+// dominated by conversion between Postgres datums and DocDB values.
+TEST_F(PggateTestSelect, BenchmarkWideTable) {
+  CHECK_OK(Init("BenchmarkWideTable"));
+
+  constexpr int kNumColumns = 50;
+  const int kNumRows = AllowSlowTests() ? 10000 : 1000;
+  typedef std::pair<DataType, YBCPgOid> ColumnType;
+  const std::vector<ColumnType> kTypes = {
+      {DataType::INT16, INT2OID}, {DataType::INT32, INT4OID}, {DataType::INT64, INT8OID},
+      {DataType::FLOAT, FLOAT4OID}, {DataType::DOUBLE, FLOAT8OID}, {DataType::STRING, TEXTOID}};
+  const YBCPgTypeAttrs type_attrs = { 0 };
+  // The first column is the hash key, the others cycle through kTypes.
+  auto column_type = [&kTypes](int attr_num) {
+    return attr_num == 1 ? ColumnType(DataType::INT64, INT8OID) : kTypes[attr_num % kTypes.size()];
+  };
+  auto make_datum = [&type_attrs](DataType type, const YBCPgTypeEntity *type_entity, int row,
+                                  std::vector<std::string> *texts) -> uint64_t {
+    switch (type) {
+      case DataType::INT16: {
+        int16_t value = row;
+        return type_entity->yb_to_datum(&value, 0, nullptr);
+      }
+      case DataType::INT32: {
+        int32_t value = row;
+        return type_entity->yb_to_datum(&value, 0, nullptr);
+      }
+      case DataType::INT64: {
+        int64_t value = row;
+        return type_entity->yb_to_datum(&value, 0, nullptr);
+      }
+      case DataType::FLOAT: {
+        float value = row;
+        return type_entity->yb_to_datum(&value, 0, nullptr);
+      }
+      case DataType::DOUBLE: {
+        double value = row;
+        return type_entity->yb_to_datum(&value, 0, nullptr);
+      }
+      case DataType::STRING: {
+        texts->push_back(Format("value_$0", row));
+        return type_entity->yb_to_datum(texts->back().c_str(), texts->back().size(), &type_attrs);
+      }
+      default:
+        break;
+    }
+    LOG(FATAL) << "Unexpected type: " << type;
+    return 0;
+  };
+
+  const char *tabname = "wide_table";
+  const YBCPgOid tab_oid = 6;
+  YBCPgStatement pg_stmt;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  for (int attr_num = 1; attr_num <= kNumColumns; ++attr_num) {
+    CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(
+        pg_stmt, Format("col_$0", attr_num).c_str(), attr_num, column_type(attr_num).first,
+        attr_num == 1 /* is_hash */, attr_num == 1 /* is_range */));
+  }
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  CommitTransaction();
+
+  // INSERT ----------------------------------------------------------------------------------------
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  std::vector<YBCPgExpr> exprs(kNumColumns + 1);
+  std::vector<std::string> texts;
+  for (int attr_num = 1; attr_num <= kNumColumns; ++attr_num) {
+    const auto type = column_type(attr_num);
+    const YBCPgTypeEntity *type_entity = YBCPgFindTypeEntity(type.second);
+    CHECK_YBC_STATUS(YBCPgNewConstant(pg_stmt, type_entity,
+                                      make_datum(type.first, type_entity, 0, &texts),
+                                      false /* is_null */, &exprs[attr_num]));
+    CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, attr_num, exprs[attr_num]));
+  }
+  MonoDelta bind_time = MonoDelta::kZero;
+  std::vector<uint64_t> datums(kNumColumns + 1);
+  for (int row = 0; row < kNumRows; ++row) {
+    texts.clear();
+    for (int attr_num = 1; attr_num <= kNumColumns; ++attr_num) {
+      const auto type = column_type(attr_num);
+      datums[attr_num] = make_datum(type.first, YBCPgFindTypeEntity(type.second), row, &texts);
+    }
+    auto start = MonoTime::Now();
+    for (int attr_num = 1; attr_num <= kNumColumns; ++attr_num) {
+      CHECK_YBC_STATUS(YBCPgUpdateConstDatum(exprs[attr_num], datums[attr_num], false));
+    }
+    bind_time += MonoTime::Now() - start;
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+
+  // SELECT * FROM wide_table ----------------------------------------------------------------------
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid,
+                                  &pg_stmt, nullptr /* read_time */));
+  for (int attr_num = 1; attr_num <= kNumColumns; ++attr_num) {
+    YBCPgExpr colref;
+    CHECK_YBC_STATUS(YBCTestNewColumnRef(pg_stmt, attr_num, column_type(attr_num).first, &colref));
+    CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  }
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(kNumColumns * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(kNumColumns * sizeof(bool)));
+  int select_row_count = 0;
+  auto start = MonoTime::Now();
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, kNumColumns, values, isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    // The second column is INT64 too, and has the same value as the hash key.
+    CHECK_EQ(static_cast<int64_t>(values[1]), static_cast<int64_t>(values[0]));
+    select_row_count++;
+  }
+  auto fetch_time = MonoTime::Now() - start;
+  CHECK_EQ(select_row_count, kNumRows);
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+
+  const auto num_values = kNumRows * kNumColumns;
+  LOG(INFO) << "Bound " << num_values << " values in " << bind_time << ", "
+            << bind_time.ToNanoseconds() / num_values << " ns per value";
+  LOG(INFO) << "Fetched " << num_values << " values in " << fetch_time << ", "
+            << fetch_time.ToNanoseconds() / num_values << " ns per value, including reads";
+}
+
 } // namespace pggate
 } // namespace yb
@@ -13,7 +13,13 @@
 //
 //--------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <limits>
+#include <set>
+
+#include "yb/yql/pggate/pggate_flags.h"
 #include "yb/yql/pggate/test/pggate_test.h"
+#include "yb/util/decimal.h"
 #include "yb/util/ybc-internal.h"
 
 namespace yb {
@@ -272,5 +278,402 @@ TEST_F(PggateTestSelectMultiTablets, TestSelectMultiTablets) {
   pg_stmt = nullptr;
 }
 
+TEST_F(PggateTestSelectMultiTablets, TestSelectGroupBy) {
+  CHECK_OK(Init("TestSelectGroupBy"));
+
+  const char *tabname = "group_by_table";
+  const YBCPgOid tab_oid = 4;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                             DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "grp", ++col_count,
+                                             DataType::INT32, false, false));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val16", ++col_count,
+                                             DataType::INT16, false, false));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val32", ++col_count,
+                                             DataType::INT32, false, false));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val64", ++col_count,
+                                             DataType::INT64, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // INSERT ----------------------------------------------------------------------------------------
+  // Rows are spread across all tablets, so every tablet returns partial aggregates of each group.
+  // Values are close to the maximum of their types, so sums of a group overflow the type of the
+  // column.
+  constexpr int kNumGroups = 3;
+  constexpr int kInsertRowCount = 30;
+  constexpr int16_t kMaxInt16 = std::numeric_limits<int16_t>::max();
+  constexpr int32_t kMaxInt32 = std::numeric_limits<int32_t>::max();
+  constexpr int64_t kMaxInt64 = std::numeric_limits<int64_t>::max();
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  YBCPgExpr expr_grp;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, 0, false, &expr_grp));
+  YBCPgExpr expr_val16;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt2(pg_stmt, 0, false, &expr_val16));
+  YBCPgExpr expr_val32;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt4(pg_stmt, 0, false, &expr_val32));
+  YBCPgExpr expr_val64;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_val64));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_grp));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 3, expr_val16));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 4, expr_val32));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 5, expr_val64));
+  for (int i = 0; i < kInsertRowCount; i++) {
+    YBCPgUpdateConstInt8(expr_hash, i, false);
+    YBCPgUpdateConstInt4(expr_grp, i % kNumGroups, false);
+    YBCPgUpdateConstInt2(expr_val16, kMaxInt16 - i, false);
+    YBCPgUpdateConstInt4(expr_val32, kMaxInt32 - i, false);
+    YBCPgUpdateConstInt8(expr_val64, kMaxInt64 - i, false);
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT grp, COUNT(*), SUM(val16), SUM(val32), SUM(val64), MIN(val16), MAX(val32), MIN(val64),
+  //     MAX(val64) FROM group_by_table GROUP BY grp ---------------------------------------------
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCPgExpr colref;
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCPgExpr group_by;
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT32, &group_by);
+  CHECK_YBC_STATUS(YBCPgSelectAppendGroupBy(pg_stmt, group_by));
+
+  YBCPgExpr count;
+  CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, "count", YBCPgFindTypeEntity(INT8OID), &count));
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, count));
+
+  // Aggregates have the result types that Postgres declares for them.
+  struct AggregateTarget {
+    const char* opname;
+    int attr_num;
+    DataType arg_type;
+    YBCPgOid result_type;
+  };
+  const AggregateTarget aggregate_targets[] = {
+    {"sum", 3, DataType::INT16, INT8OID},
+    {"sum", 4, DataType::INT32, INT8OID},
+    {"sum", 5, DataType::INT64, NUMERICOID},
+    {"min", 3, DataType::INT16, INT2OID},
+    {"max", 4, DataType::INT32, INT4OID},
+    {"min", 5, DataType::INT64, INT8OID},
+    {"max", 5, DataType::INT64, INT8OID},
+  };
+  for (const AggregateTarget& target : aggregate_targets) {
+    YBCPgExpr aggregate;
+    CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, target.opname,
+                                      YBCPgFindTypeEntity(target.result_type), &aggregate));
+    YBCTestNewColumnRef(pg_stmt, target.attr_num, target.arg_type, &colref);
+    CHECK_YBC_STATUS(YBCPgOperatorAppendArg(aggregate, colref));
+    CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, aggregate));
+  }
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // Result rows contain the targets in the order they were appended.
+  constexpr int kNumTargets = 9;
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(kNumTargets * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(kNumTargets * sizeof(bool)));
+  std::set<int> seen_groups;
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, kNumTargets, values, isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    const int grp = static_cast<int32_t>(values[0]);
+    const string sum64 = reinterpret_cast<char*>(values[4]);
+    LOG(INFO) << "GROUP " << grp << ": count = " << values[1]
+              << ", sum16 = " << static_cast<int64_t>(values[2])
+              << ", sum32 = " << static_cast<int64_t>(values[3]) << ", sum64 = " << sum64;
+    CHECK(seen_groups.insert(grp).second) << "Duplicate group " << grp;
+
+    int64_t expected_sum16 = 0;
+    int64_t expected_sum32 = 0;
+    util::VarInt expected_sum64(0);
+    for (int i = grp; i < kInsertRowCount; i += kNumGroups) {
+      expected_sum16 += kMaxInt16 - i;
+      expected_sum32 += kMaxInt32 - i;
+      expected_sum64 = expected_sum64 + util::VarInt(kMaxInt64 - i);
+    }
+    CHECK_GT(expected_sum32, kMaxInt32);
+    util::Decimal decimal_sum64;
+    CHECK_OK(decimal_sum64.FromString(sum64));
+    CHECK_EQ(ASSERT_RESULT(decimal_sum64.ToVarInt()).ToString(), expected_sum64.ToString());
+
+    const int last = kInsertRowCount - kNumGroups + grp;
+    CHECK_EQ(values[1], kInsertRowCount / kNumGroups);
+    CHECK_EQ(static_cast<int64_t>(values[2]), expected_sum16);
+    CHECK_EQ(static_cast<int64_t>(values[3]), expected_sum32);
+    CHECK_EQ(static_cast<int16_t>(values[5]), kMaxInt16 - last);
+    CHECK_EQ(static_cast<int32_t>(values[6]), kMaxInt32 - grp);
+    CHECK_EQ(static_cast<int64_t>(values[7]), kMaxInt64 - last);
+    CHECK_EQ(static_cast<int64_t>(values[8]), kMaxInt64 - grp);
+  }
+  CHECK_EQ(seen_groups.size(), kNumGroups);
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // Aggregates of other result types could not be computed by DocDB, their results would not be
+  // decoded correctly.
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCPgExpr sum32;
+  CHECK_YBC_STATUS(YBCPgNewOperator(pg_stmt, "sum", YBCPgFindTypeEntity(INT4OID), &sum32));
+  YBCTestNewColumnRef(pg_stmt, 4, DataType::INT32, &colref);
+  CHECK_YBC_STATUS(YBCPgOperatorAppendArg(sum32, colref));
+  YBCStatus status = YBCPgDmlAppendTarget(pg_stmt, sum32);
+  CHECK(status != nullptr);
+  YBCFreeStatus(status);
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+}
+
+TEST_F(PggateTestSelectMultiTablets, TestParallelScan) {
+  // Small pages make every sub-range of a tablet to be continued several times.
+  FLAGS_ysql_scan_parallelism = 4;
+  FLAGS_ysql_prefetch_limit = 7;
+  CHECK_OK(Init("TestParallelScan"));
+
+  const char *tabname = "parallel_scan_table";
+  const YBCPgOid tab_oid = 5;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                             DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val", ++col_count,
+                                             DataType::INT64, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // INSERT ----------------------------------------------------------------------------------------
+  constexpr int kInsertRowCount = 100;
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  YBCPgExpr expr_val;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_val));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_val));
+  for (int i = 0; i < kInsertRowCount; i++) {
+    YBCPgUpdateConstInt8(expr_hash, i, false);
+    YBCPgUpdateConstInt8(expr_val, i * 10, false);
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT hash_key, val FROM parallel_scan_table -------------------------------------------------
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCPgExpr colref;
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // Rows come out of key order, but each row should be returned exactly once.
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  std::set<int64_t> seen_keys;
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    const int64_t key = values[0];
+    CHECK(seen_keys.insert(key).second) << "Duplicate row " << key;
+    CHECK_EQ(values[1], key * 10);
+  }
+  CHECK_EQ(seen_keys.size(), kInsertRowCount);
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+}
+
+TEST_F(PggateTestSelectMultiTablets, TestSelectTopN) {
+  CHECK_OK(Init("TestSelectTopN"));
+
+  const char *tabname = "top_n_table";
+  const YBCPgOid tab_oid = 6;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                             DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "score", ++col_count,
+                                             DataType::INT64, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // INSERT ----------------------------------------------------------------------------------------
+  // Every 10th row has a NULL score.
+  constexpr int kInsertRowCount = 100;
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  YBCPgExpr expr_score;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_score));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_score));
+  for (int i = 0; i < kInsertRowCount; i++) {
+    YBCPgUpdateConstInt8(expr_hash, i, false);
+    YBCPgUpdateConstInt8(expr_score, (i * 37) % kInsertRowCount, i % 10 == 0);
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT hash_key, score FROM top_n_table ORDER BY score DESC NULLS LAST LIMIT 5 ---------------
+  constexpr int kTopN = 5;
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCPgExpr colref;
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCPgExpr order_by;
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT64, &order_by);
+  CHECK_YBC_STATUS(YBCPgSelectAppendOrderBy(pg_stmt, order_by, true /* is_descending */,
+                                            false /* nulls_first */));
+  CHECK_YBC_STATUS(YBCPgSelectSetTopNLimit(pg_stmt, kTopN));
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // Every tablet returns its own first rows, so the rows fetched still have to be sorted.
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  std::vector<int64_t> scores;
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    CHECK(!isnulls[1]) << "NULL score returned for row " << values[0];
+    CHECK_EQ(values[1], (values[0] * 37) % kInsertRowCount);
+    scores.push_back(values[1]);
+  }
+  LOG(INFO) << "Fetched " << scores.size() << " rows";
+  CHECK_GE(scores.size(), kTopN);
+  CHECK_LT(scores.size(), kInsertRowCount);
+
+  std::sort(scores.begin(), scores.end(), std::greater<int64_t>());
+  for (int i = 0; i < kTopN; i++) {
+    // Scores are a permutation of 0..99 without multiples of 10 for the NULL rows.
+    CHECK_EQ(scores[i], kInsertRowCount - 1 - i);
+  }
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+}
+
+TEST_F(PggateTestSelectMultiTablets, TestReadAhead) {
+  // Small pages are requested ahead of the consumer, and the small buffer keeps shrinking them.
+  FLAGS_ysql_prefetch_limit = 16;
+  FLAGS_ysql_prefetch_max_buffered_bytes = 256;
+  CHECK_OK(Init("TestReadAhead"));
+
+  const char *tabname = "read_ahead_table";
+  const YBCPgOid tab_oid = 7;
+  YBCPgStatement pg_stmt;
+
+  // Create table in the connected database.
+  int col_count = 0;
+  CHECK_YBC_STATUS(YBCPgNewCreateTable(pg_session_, kDefaultDatabase, kDefaultSchema, tabname,
+                                       kDefaultDatabaseOid, tab_oid,
+                                       false /* is_shared_table */, true /* if_not_exist */,
+                                       false /* add_primary_key */, &pg_stmt));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "hash_key", ++col_count,
+                                             DataType::INT64, true, true));
+  CHECK_YBC_STATUS(YBCTestCreateTableAddColumn(pg_stmt, "val", ++col_count,
+                                             DataType::INT64, false, false));
+  CHECK_YBC_STATUS(YBCPgExecCreateTable(pg_stmt));
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // INSERT ----------------------------------------------------------------------------------------
+  constexpr int kInsertRowCount = 100;
+  CHECK_YBC_STATUS(YBCPgNewInsert(pg_session_, kDefaultDatabaseOid, tab_oid,
+                                  false /* is_single_row_txn */, &pg_stmt));
+  YBCPgExpr expr_hash;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_hash));
+  YBCPgExpr expr_val;
+  CHECK_YBC_STATUS(YBCTestNewConstantInt8(pg_stmt, 0, false, &expr_val));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 1, expr_hash));
+  CHECK_YBC_STATUS(YBCPgDmlBindColumn(pg_stmt, 2, expr_val));
+  for (int i = 0; i < kInsertRowCount; i++) {
+    YBCPgUpdateConstInt8(expr_hash, i, false);
+    YBCPgUpdateConstInt8(expr_val, i * 10, false);
+    CHECK_YBC_STATUS(YBCPgExecInsert(pg_stmt));
+    CommitTransaction();
+  }
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+
+  // SELECT hash_key, val FROM read_ahead_table -------------------------------------------------
+  CHECK_YBC_STATUS(YBCPgNewSelect(pg_session_, kDefaultDatabaseOid, tab_oid, kInvalidOid, &pg_stmt,
+                                  nullptr /* read_time */));
+  YBCPgExpr colref;
+  YBCTestNewColumnRef(pg_stmt, 1, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  YBCTestNewColumnRef(pg_stmt, 2, DataType::INT64, &colref);
+  CHECK_YBC_STATUS(YBCPgDmlAppendTarget(pg_stmt, colref));
+  CHECK_YBC_STATUS(YBCPgExecSelect(pg_stmt));
+
+  // Each row should be returned exactly once.
+  uint64_t *values = static_cast<uint64_t*>(YBCPAlloc(col_count * sizeof(uint64_t)));
+  bool *isnulls = static_cast<bool*>(YBCPAlloc(col_count * sizeof(bool)));
+  std::set<int64_t> seen_keys;
+  for (;;) {
+    bool has_data = false;
+    CHECK_YBC_STATUS(YBCPgDmlFetch(pg_stmt, col_count, values, isnulls, nullptr, &has_data));
+    if (!has_data) {
+      break;
+    }
+    const int64_t key = values[0];
+    CHECK(seen_keys.insert(key).second) << "Duplicate row " << key;
+    CHECK_EQ(values[1], key * 10);
+  }
+  CHECK_EQ(seen_keys.size(), kInsertRowCount);
+
+  CHECK_YBC_STATUS(YBCPgDeleteStatement(pg_stmt));
+  pg_stmt = nullptr;
+}
+
 } // namespace pggate
 } // namespace yb
@@ -157,6 +157,10 @@ static const YBCPgTypeEntity YBCTestTypeEntityTable[] = {
   { FLOAT8OID, YB_YQL_DATA_TYPE_DOUBLE, true, 8,
     (YBCPgDatumToData)YBCTestDatumToFloat8,
     (YBCPgDatumFromData)YBCTestFloat8ToDatum },
+
+  { NUMERICOID, YB_YQL_DATA_TYPE_DECIMAL, true, -1,
+    (YBCPgDatumToData)YBCTestDatumToStr,
+    (YBCPgDatumFromData)YBCTestStrToDatum },
 };
 
 void YBCTestGetTypeTable(const YBCPgTypeEntity **type_table, int *count) {
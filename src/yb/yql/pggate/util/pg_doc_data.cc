@@ -22,6 +22,10 @@
 namespace yb {
 namespace pggate {
 
+constexpr int64_t PgDocData::kColumnarFormatMarker;
+constexpr uint8_t PgDocData::kFixedWidthColumn;
+constexpr uint8_t PgDocData::kVariableLengthColumn;
+
 //--------------------------------------------------------------------------------------------------
 // Write Tuple Routine in DocDB Format (wire_protocol).
 //--------------------------------------------------------------------------------------------------
@@ -36,6 +40,122 @@ Status PgDocData::WriteTuples(const PgsqlResultSet& tuples, faststring *buffer)
   return Status::OK();
 }
 
+Status PgDocData::WriteColumnarTuples(const PgsqlResultSet& tuples, faststring *buffer) {
+  const auto& rows = tuples.rsrows();
+  const size_t column_count = rows.empty() ? 0 : rows.front().rscol_count();
+  WriteInt64(kColumnarFormatMarker, buffer);
+  WriteInt64(rows.size(), buffer);
+  WriteInt64(column_count, buffer);
+
+  std::vector<uint8_t> null_bitmap;
+  std::vector<size_t> offsets;
+  faststring values;
+  for (size_t column = 0; column != column_count; ++column) {
+    // Values of a column have the same type, the type of null values is not set.
+    InternalType type = InternalType::VALUE_NOT_SET;
+    null_bitmap.assign((rows.size() + 7) / 8, 0);
+    for (size_t row = 0; row != rows.size(); ++row) {
+      if (rows[row].rscol_count() != column_count) {
+        return STATUS_FORMAT(InternalError, "Row $0 has $1 columns, while $2 expected",
+                             row, rows[row].rscol_count(), column_count);
+      }
+      const QLValue& value = rows[row].rscol_value(column);
+      if (value.IsNull()) {
+        null_bitmap[row / 8] |= 1 << (row % 8);
+      } else if (type == InternalType::VALUE_NOT_SET) {
+        type = value.type();
+      } else if (type != value.type()) {
+        return STATUS_FORMAT(InternalError, "Column $0 has values of types $1 and $2",
+                             column, type, value.type());
+      }
+    }
+
+    const size_t width = FixedWidth(type);
+    const bool fixed_width = width != 0 || type == InternalType::VALUE_NOT_SET;
+    WriteUint8(fixed_width ? kFixedWidthColumn : kVariableLengthColumn, buffer);
+    buffer->append(null_bitmap.data(), null_bitmap.size());
+
+    if (fixed_width) {
+      WriteInt64(width, buffer);
+      for (const auto& row : rows) {
+        const QLValue& value = row.rscol_value(column);
+        if (value.IsNull()) {
+          buffer->resize(buffer->size() + width);
+          memset(buffer->data() + buffer->size() - width, 0, width);
+        } else {
+          RETURN_NOT_OK(WriteColumnValue(value, buffer));
+        }
+      }
+      continue;
+    }
+
+    offsets.clear();
+    values.clear();
+    for (const auto& row : rows) {
+      offsets.push_back(values.size());
+      const QLValue& value = row.rscol_value(column);
+      if (!value.IsNull()) {
+        RETURN_NOT_OK(WriteColumnValue(value, &values));
+      }
+    }
+    offsets.push_back(values.size());
+    for (auto offset : offsets) {
+      WriteInt64(offset, buffer);
+    }
+    buffer->append(values.data(), values.size());
+  }
+  return Status::OK();
+}
+
+bool PgDocData::IsColumnar(const Slice& data) {
+  if (data.size() < sizeof(int64_t)) {
+    return false;
+  }
+  Slice cursor = data;
+  int64_t marker;
+  ReadNumber(&cursor, &marker);
+  return marker == kColumnarFormatMarker;
+}
+
+size_t PgDocData::FixedWidth(InternalType type) {
+  switch (type) {
+    case InternalType::kBoolValue: FALLTHROUGH_INTENDED;
+    case InternalType::kInt8Value:
+      return 1;
+    case InternalType::kInt16Value:
+      return 2;
+    case InternalType::kInt32Value: FALLTHROUGH_INTENDED;
+    case InternalType::kUint32Value: FALLTHROUGH_INTENDED;
+    case InternalType::kFloatValue:
+      return 4;
+    case InternalType::kInt64Value: FALLTHROUGH_INTENDED;
+    case InternalType::kDoubleValue:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+Status PgDocData::ConcatTuples(
+    const std::vector<Slice>& tuple_sets, int64_t *total_row_count, faststring *buffer) {
+  *total_row_count = 0;
+  for (Slice cursor : tuple_sets) {
+    int64_t this_count;
+    if (cursor.size() < sizeof(this_count)) {
+      return STATUS(Corruption, "Tuple set is too short");
+    }
+    ReadNumber(&cursor, &this_count);
+    *total_row_count += this_count;
+  }
+
+  WriteInt64(*total_row_count, buffer);
+  for (Slice cursor : tuple_sets) {
+    cursor.remove_prefix(sizeof(int64_t));
+    buffer->append(cursor.data(), cursor.size());
+  }
+  return Status::OK();
+}
+
 Status PgDocData::WriteTuple(const PgsqlRSRow& tuple, faststring *buffer) {
   // Write the column contents.
   for (const QLValue& col_value : tuple.rscols()) {
@@ -58,6 +178,10 @@ Status PgDocData::WriteColumn(const QLValue& col_value, faststring *buffer) {
     return Status::OK();
   }
 
+  return WriteColumnValue(col_value, buffer);
+}
+
+Status PgDocData::WriteColumnValue(const QLValue& col_value, faststring *buffer) {
   switch (col_value.type()) {
     case InternalType::VALUE_NOT_SET:
       break;
@@ -146,5 +270,152 @@ PgWireDataHeader PgDocData::ReadDataHeader(Slice *cursor) {
   return PgWireDataHeader(header_data);
 }
 
+Status PgDocData::ReadColumn(Slice *cursor, InternalType type, QLValue *col_value) {
+  col_value->SetNull();
+  if (cursor->empty()) {
+    return STATUS(Corruption, "Unexpected end of data");
+  }
+  if (ReadDataHeader(cursor).is_null()) {
+    return Status::OK();
+  }
+
+  switch (type) {
+    case InternalType::VALUE_NOT_SET:
+      return Status::OK();
+    case InternalType::kBoolValue:
+      return ReadColumnNumber<bool>(cursor, [col_value](bool value) {
+        col_value->set_bool_value(value);
+      });
+    case InternalType::kInt8Value:
+      return ReadColumnNumber<int8>(cursor, [col_value](int8 value) {
+        col_value->set_int8_value(value);
+      });
+    case InternalType::kInt16Value:
+      return ReadColumnNumber<int16>(cursor, [col_value](int16 value) {
+        col_value->set_int16_value(value);
+      });
+    case InternalType::kInt32Value:
+      return ReadColumnNumber<int32>(cursor, [col_value](int32 value) {
+        col_value->set_int32_value(value);
+      });
+    case InternalType::kInt64Value:
+      return ReadColumnNumber<int64>(cursor, [col_value](int64 value) {
+        col_value->set_int64_value(value);
+      });
+    case InternalType::kUint32Value:
+      return ReadColumnNumber<uint32>(cursor, [col_value](uint32 value) {
+        col_value->set_uint32_value(value);
+      });
+    case InternalType::kFloatValue:
+      return ReadColumnNumber<float>(cursor, [col_value](float value) {
+        col_value->set_float_value(value);
+      });
+    case InternalType::kDoubleValue:
+      return ReadColumnNumber<double>(cursor, [col_value](double value) {
+        col_value->set_double_value(value);
+      });
+    case InternalType::kStringValue:
+    case InternalType::kDecimalValue: {
+      // Text is written together with its terminating '\0'.
+      Slice data = VERIFY_RESULT(ReadColumnBytes(cursor));
+      if (data.empty()) {
+        return STATUS(Corruption, "Text value is not null-terminated");
+      }
+      data.remove_suffix(1);
+      if (type == InternalType::kStringValue) {
+        col_value->set_string_value(data.ToBuffer());
+      } else {
+        col_value->set_decimal_value(data.ToBuffer());
+      }
+      return Status::OK();
+    }
+    case InternalType::kBinaryValue: {
+      Slice data = VERIFY_RESULT(ReadColumnBytes(cursor));
+      col_value->set_binary_value(data.data(), data.size());
+      return Status::OK();
+    }
+    default:
+      break;
+  }
+
+  return STATUS_FORMAT(NotSupported, "Unexpected data type: $0", type);
+}
+
+Status PgColumnarTuples::Load(const Slice& data) {
+  Slice cursor = data;
+  auto read_size = [&cursor]() -> Result<size_t> {
+    int64_t value;
+    if (cursor.size() < sizeof(value)) {
+      return STATUS(Corruption, "Unexpected end of columnar data");
+    }
+    cursor.remove_prefix(PgWire::ReadNumber(&cursor, &value));
+    if (value < 0 || static_cast<uint64_t>(value) > std::numeric_limits<uint32_t>::max()) {
+      return STATUS_FORMAT(Corruption, "Invalid size in columnar data: $0", value);
+    }
+    return value;
+  };
+
+  if (!PgDocData::IsColumnar(cursor)) {
+    return STATUS(Corruption, "Data is not in columnar format");
+  }
+  cursor.remove_prefix(sizeof(int64_t));
+  row_count_ = VERIFY_RESULT(read_size());
+  columns_.resize(VERIFY_RESULT(read_size()));
+  const size_t null_bitmap_size = (row_count_ + 7) / 8;
+
+  for (auto& column : columns_) {
+    if (cursor.size() < 1 + null_bitmap_size) {
+      return STATUS(Corruption, "Unexpected end of columnar data");
+    }
+    const uint8_t kind = cursor[0];
+    column.null_bitmap = cursor.data() + 1;
+    cursor.remove_prefix(1 + null_bitmap_size);
+
+    size_t data_size;
+    if (kind == PgDocData::kFixedWidthColumn) {
+      column.width = VERIFY_RESULT(read_size());
+      column.offsets.clear();
+      data_size = column.width * row_count_;
+    } else if (kind == PgDocData::kVariableLengthColumn) {
+      column.offsets.resize(row_count_ + 1);
+      size_t prev = 0;
+      for (auto& offset : column.offsets) {
+        offset = VERIFY_RESULT(read_size());
+        if (offset < prev) {
+          return STATUS_FORMAT(Corruption, "Decreasing offsets in columnar data: $0, $1",
+                               prev, offset);
+        }
+        prev = offset;
+      }
+      data_size = column.offsets.back();
+    } else {
+      return STATUS_FORMAT(Corruption, "Unknown column kind: $0", static_cast<int>(kind));
+    }
+    if (cursor.size() < data_size) {
+      return STATUS(Corruption, "Unexpected end of columnar data");
+    }
+    column.data = cursor.data();
+    cursor.remove_prefix(data_size);
+  }
+
+  if (!cursor.empty()) {
+    return STATUS_FORMAT(Corruption, "$0 extra bytes in columnar data", cursor.size());
+  }
+  return Status::OK();
+}
+
+Result<Slice> PgDocData::ReadColumnBytes(Slice *cursor) {
+  int64_t data_size = 0;
+  RETURN_NOT_OK(ReadColumnNumber<int64_t>(cursor, [&data_size](int64_t value) {
+    data_size = value;
+  }));
+  if (data_size < 0 || static_cast<size_t>(data_size) > cursor->size()) {
+    return STATUS_FORMAT(Corruption, "Invalid data size: $0", data_size);
+  }
+  Slice result(cursor->data(), data_size);
+  cursor->remove_prefix(data_size);
+  return result;
+}
+
 }  // namespace pggate
 }  // namespace yb
@@ -21,17 +21,105 @@
 namespace yb {
 namespace pggate {
 
+// Tuples written in columnar format by PgDocData::WriteColumnarTuples().
+//
+// The data starts with kColumnarFormatMarker, that could not be a row count of the row format,
+// followed by int64 row count and int64 column count. Then every column has:
+// - uint8 column kind.
+// - A null bitmap, (row count + 7) / 8 bytes.
+// - For a fixed width column: int64 value width and the values of all rows, nulls are zero filled.
+// - For a variable length column: row count + 1 int64 value offsets, the last one is the end of the
+//   values, followed by the values.
+// Values are encoded as in row format without the data header, so they are translated to Postgres
+// datums by the same functions.
+class PgColumnarTuples {
+ public:
+  // Parses data, that must outlive this object.
+  CHECKED_STATUS Load(const Slice& data);
+
+  size_t row_count() const {
+    return row_count_;
+  }
+
+  size_t column_count() const {
+    return columns_.size();
+  }
+
+  bool IsNull(size_t column, size_t row) const {
+    return (columns_[column].null_bitmap[row / 8] >> (row % 8)) & 1;
+  }
+
+  // Encoded value of the column in the row, empty for null.
+  Slice Value(size_t column, size_t row) const {
+    const auto& col = columns_[column];
+    if (col.offsets.empty()) {
+      return Slice(col.data + row * col.width, col.width);
+    }
+    return Slice(col.data + col.offsets[row], col.data + col.offsets[row + 1]);
+  }
+
+ private:
+  struct Column {
+    const uint8_t* null_bitmap = nullptr;
+    const uint8_t* data = nullptr;
+    // Value width of a fixed width column.
+    size_t width = 0;
+    // Value offsets of a variable length column, relative to data.
+    std::vector<size_t> offsets;
+  };
+
+  size_t row_count_ = 0;
+  std::vector<Column> columns_;
+};
+
 class PgDocData : public PgWire {
  public:
+  static constexpr int64_t kColumnarFormatMarker = -1;
+  static constexpr uint8_t kFixedWidthColumn = 0;
+  static constexpr uint8_t kVariableLengthColumn = 1;
+
   static CHECKED_STATUS WriteTuples(const PgsqlResultSet& tuples, faststring *buffer);
 
+  // Writes tuples in columnar format, see PgColumnarTuples.
+  static CHECKED_STATUS WriteColumnarTuples(const PgsqlResultSet& tuples, faststring *buffer);
+
+  // Whether the data was written by WriteColumnarTuples().
+  static bool IsColumnar(const Slice& data);
+
   static CHECKED_STATUS WriteTuple(const PgsqlRSRow& tuple, faststring *buffer);
 
   static CHECKED_STATUS WriteColumn(const QLValue& col_value, faststring *buffer);
 
+  // Writes the value as WriteColumn() without the data header. The value must not be null.
+  static CHECKED_STATUS WriteColumnValue(const QLValue& col_value, faststring *buffer);
+
+  // Writes all tuples of the sets, that were written by WriteTuples(), as one set.
+  static CHECKED_STATUS ConcatTuples(
+      const std::vector<Slice>& tuple_sets, int64_t *total_row_count, faststring *buffer);
+
   static CHECKED_STATUS LoadCache(const string& data, int64_t *total_row_count, Slice *cursor);
 
   static PgWireDataHeader ReadDataHeader(Slice *cursor);
+
+  // Reads a column value of the specified type, that was written by WriteColumn().
+  static CHECKED_STATUS ReadColumn(Slice *cursor, InternalType type, QLValue *col_value);
+
+ private:
+  template<class Number, class Setter>
+  static CHECKED_STATUS ReadColumnNumber(Slice *cursor, const Setter& setter) {
+    if (cursor->size() < sizeof(Number)) {
+      return STATUS(Corruption, "Unexpected end of data");
+    }
+    Number value;
+    cursor->remove_prefix(ReadNumber(cursor, &value));
+    setter(value);
+    return Status::OK();
+  }
+
+  static Result<Slice> ReadColumnBytes(Slice *cursor);
+
+  // Returns the width of values of a fixed width type, 0 for a variable length type.
+  static size_t FixedWidth(InternalType type);
 };
 
 }  // namespace pggate
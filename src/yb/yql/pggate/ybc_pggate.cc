@@ -125,9 +125,10 @@ YBCStatus YBCPgNewCreateDatabase(YBCPgSession pg_session,
                                  const YBCPgOid database_oid,
                                  const YBCPgOid source_database_oid,
                                  const YBCPgOid next_oid,
+                                 const bool colocated,
                                  YBCPgStatement *handle) {
   return ToYBCStatus(pgapi->NewCreateDatabase(pg_session, database_name, database_oid,
-                                              source_database_oid, next_oid, handle));
+                                              source_database_oid, next_oid, colocated, handle));
 }
 
 YBCStatus YBCPgExecCreateDatabase(YBCPgStatement handle) {
@@ -220,6 +221,10 @@ YBCStatus YBCDeleteSequenceTuple(YBCPgSession pg_session, int64_t db_oid, int64_
   return ToYBCStatus(pgapi->DeleteSequenceTuple(pg_session, db_oid, seq_oid));
 }
 
+int64_t YBCGetSequenceCacheMinval() {
+  return FLAGS_ysql_sequence_cache_minval;
+}
+
 // Table Operations -------------------------------------------------------------------------------
 
 YBCStatus YBCPgNewCreateTable(YBCPgSession pg_session,
@@ -311,6 +316,10 @@ YBCStatus YBCPgGetColumnInfo(YBCPgTableDesc table_desc,
   return ToYBCStatus(pgapi->GetColumnInfo(table_desc, attr_number, is_primary, is_hash));
 }
 
+YBCStatus YBCPgIsHashPartitionedTable(YBCPgTableDesc table_desc, bool *is_hash_partitioned) {
+  return ToYBCStatus(pgapi->IsHashPartitionedTable(table_desc, is_hash_partitioned));
+}
+
 YBCStatus YBCPgSetCatalogCacheVersion(YBCPgStatement handle,
                                       uint64_t catalog_cache_version) {
   return ToYBCStatus(pgapi->SetCatalogCacheVersion(handle, catalog_cache_version));
@@ -428,6 +437,22 @@ YBCStatus YBCPgExecInsert(YBCPgStatement handle) {
   return ToYBCStatus(pgapi->ExecInsert(handle));
 }
 
+void YBCPgStartBulkInserts(YBCPgSession pg_session) {
+  pgapi->StartBulkInserts(pg_session);
+}
+
+void YBCPgSetCatalogPreloadVersion(YBCPgSession pg_session, uint64_t version) {
+  pgapi->SetCatalogPreloadVersion(pg_session, version);
+}
+
+YBCStatus YBCPgExecBulkInsert(YBCPgStatement handle) {
+  return ToYBCStatus(pgapi->ExecBulkInsert(handle));
+}
+
+YBCStatus YBCPgFlushBulkInserts(YBCPgSession pg_session) {
+  return ToYBCStatus(pgapi->FlushBulkInserts(pg_session));
+}
+
 // UPDATE Operations -------------------------------------------------------------------------------
 YBCStatus YBCPgNewUpdate(YBCPgSession pg_session,
                          const YBCPgOid database_oid,
@@ -470,6 +495,60 @@ YBCStatus YBCPgSetForwardScan(YBCPgStatement handle, bool is_forward_scan) {
   return ToYBCStatus(pgapi->SetForwardScan(handle, is_forward_scan));
 }
 
+YBCStatus YBCPgSelectAppendGroupBy(YBCPgStatement handle, YBCPgExpr group_by) {
+  return ToYBCStatus(pgapi->SelectAppendGroupBy(handle, group_by));
+}
+
+YBCStatus YBCPgSelectAppendWhere(YBCPgStatement handle, YBCPgExpr condition) {
+  return ToYBCStatus(pgapi->SelectAppendWhere(handle, condition));
+}
+
+YBCStatus YBCPgSelectAppendOrderBy(YBCPgStatement handle, YBCPgExpr order_by, bool is_descending,
+                                   bool nulls_first) {
+  return ToYBCStatus(pgapi->SelectAppendOrderBy(handle, order_by, is_descending, nulls_first));
+}
+
+YBCStatus YBCPgSelectSetTopNLimit(YBCPgStatement handle, uint64_t limit) {
+  return ToYBCStatus(pgapi->SelectSetTopNLimit(handle, limit));
+}
+
+YBCStatus YBCPgSelectBindYbctids(YBCPgStatement handle, int count, YBCPgExpr *ybctids) {
+  return ToYBCStatus(pgapi->SelectBindYbctids(handle, std::vector<PgExpr*>(ybctids,
+                                                                           ybctids + count)));
+}
+
+int YBCGetIndexFetchBatchSize() {
+  return FLAGS_ysql_index_fetch_batch_size;
+}
+
+YBCStatus YBCPgSelectBindKeyBatch(YBCPgStatement handle, int count, int num_attrs,
+                                  const int *attr_nums, YBCPgExpr *values) {
+  return ToYBCStatus(pgapi->SelectBindKeyBatch(
+      handle, std::vector<int>(attr_nums, attr_nums + num_attrs),
+      std::vector<PgExpr*>(values, values + count * num_attrs)));
+}
+
+int YBCGetNestLoopBatchSize() {
+  return FLAGS_ysql_nested_loop_batch_size;
+}
+
+int YBCGetForeignKeyCheckBatchSize() {
+  return FLAGS_ysql_foreign_key_check_batch_size;
+}
+
+YBCStatus YBCPgSelectSetHashCodeRange(YBCPgStatement handle, uint16_t min_hash_code,
+                                      uint16_t max_hash_code) {
+  return ToYBCStatus(pgapi->SelectSetHashCodeRange(handle, min_hash_code, max_hash_code));
+}
+
+bool YBCIsParallelScanEnabled() {
+  return FLAGS_ysql_enable_parallel_scans;
+}
+
+int YBCGetParallelScanChunksPerWorker() {
+  return std::max(FLAGS_ysql_parallel_scan_chunks_per_worker, 1);
+}
+
 YBCStatus YBCPgExecSelect(YBCPgStatement handle) {
   return ToYBCStatus(pgapi->ExecSelect(handle));
 }
@@ -517,6 +596,10 @@ YBCStatus YBCPgUpdateConstChar(YBCPgExpr expr, const char *value,  int64_t bytes
   return ToYBCStatus(pgapi->UpdateConstant(expr, value, bytes, is_null));
 }
 
+YBCStatus YBCPgUpdateConstDatum(YBCPgExpr expr, uint64_t datum, bool is_null) {
+  return ToYBCStatus(pgapi->UpdateConstantDatum(expr, datum, is_null));
+}
+
 YBCStatus YBCPgNewOperator(YBCPgStatement stmt, const char *opname,
                            const YBCPgTypeEntity *type_entity,
                            YBCPgExpr *op_handle) {
@@ -97,12 +97,17 @@ YBCStatus YBCReadSequenceTuple(YBCPgSession pg_session,
 
 YBCStatus YBCDeleteSequenceTuple(YBCPgSession pg_session, int64_t db_oid, int64_t seq_oid);
 
+// Min number of sequence values a backend allocates at once, regardless of the CACHE setting of
+// the sequence. Every allocation reads and conditionally updates the sequence tuple.
+int64_t YBCGetSequenceCacheMinval();
+
 // Create database.
 YBCStatus YBCPgNewCreateDatabase(YBCPgSession pg_session,
                                  const char *database_name,
                                  YBCPgOid database_oid,
                                  YBCPgOid source_database_oid,
                                  YBCPgOid next_oid,
+                                 const bool colocated,
                                  YBCPgStatement *handle);
 YBCStatus YBCPgExecCreateDatabase(YBCPgStatement handle);
 
@@ -188,6 +193,10 @@ YBCStatus YBCPgGetColumnInfo(YBCPgTableDesc table_desc,
                              bool *is_primary,
                              bool *is_hash);
 
+// Whether rows of the table are distributed among tablets by the hash code of the hash columns,
+// so that a scan could be limited to a range of hash codes.
+YBCStatus YBCPgIsHashPartitionedTable(YBCPgTableDesc table_desc, bool *is_hash_partitioned);
+
 YBCStatus YBCPgSetIfIsSysCatalogVersionChange(YBCPgStatement handle, bool *is_version_change);
 
 YBCStatus YBCPgSetCatalogCacheVersion(YBCPgStatement handle, uint64_t catalog_cache_version);
@@ -265,13 +274,13 @@ YBCStatus YBCPgDmlExecWriteOp(YBCPgStatement handle);
 
 // DB Operations: WHERE, ORDER_BY, GROUP_BY, etc.
 // + The following operations are run by DocDB.
-//   - Not yet
+//   - API for "group_by_expr" and aggregate targets (see YBCPgSelectAppendGroupBy()).
+//   - API for "where_expr" conditions that DocDB could evaluate (see YBCPgSelectAppendWhere()).
+//   - API for "order_by_expr" with a limit, evaluated per tablet (see YBCPgSelectAppendOrderBy()).
 //
 // + The following operations are run by Postgres layer. An API might be added to move these
 //   operations to DocDB.
-//   - API for "where_expr"
-//   - API for "order_by_expr"
-//   - API for "group_by_expr"
+//   - API for "order_by_expr" without a limit.
 
 
 // Buffer write operations.
@@ -287,6 +296,19 @@ YBCStatus YBCPgNewInsert(YBCPgSession pg_session,
 
 YBCStatus YBCPgExecInsert(YBCPgStatement handle);
 
+// Bulk insert used by COPY FROM. YBCPgStartBulkInserts drops the state left by a bulk insert that
+// was interrupted by an error. YBCPgExecBulkInsert copies the values currently bound to the
+// statement into a new operation, so the statement could be rebound for the next row right away.
+// The operations are flushed in batches asynchronously. YBCPgFlushBulkInserts flushes the rest of
+// them, waits for all flushes to complete and reports the first error.
+void YBCPgStartBulkInserts(YBCPgSession pg_session);
+YBCStatus YBCPgExecBulkInsert(YBCPgStatement handle);
+YBCStatus YBCPgFlushBulkInserts(YBCPgSession pg_session);
+
+// Catalog scans executed until it is reset to 0 preload the relation cache at the given catalog
+// version. They are shared with the other backends of the node when ysql_catalog_cache_dir is set.
+void YBCPgSetCatalogPreloadVersion(YBCPgSession pg_session, uint64_t version);
+
 // UPDATE ------------------------------------------------------------------------------------------
 YBCStatus YBCPgNewUpdate(YBCPgSession pg_session,
                          YBCPgOid database_oid,
@@ -316,6 +338,52 @@ YBCStatus YBCPgNewSelect(YBCPgSession pg_session,
 // Set forward/backward scan direction.
 YBCStatus YBCPgSetForwardScan(YBCPgStatement handle, bool is_forward_scan);
 
+// Append a group-by expression. Aggregate targets of the select are then computed by DocDB for
+// each group, and all other targets must be group-by expressions.
+YBCStatus YBCPgSelectAppendGroupBy(YBCPgStatement handle, YBCPgExpr group_by);
+
+// Append a condition that DocDB evaluates for every row read, so that only matching rows are
+// returned. Conditions appended to the same select are combined using AND.
+YBCStatus YBCPgSelectAppendWhere(YBCPgStatement handle, YBCPgExpr condition);
+
+// Top-N select. Every tablet returns only its first "limit" rows in the order of the appended
+// sort keys. Rows of different tablets are not merged, so the caller must still sort the rows
+// fetched and apply the limit.
+YBCStatus YBCPgSelectAppendOrderBy(YBCPgStatement handle, YBCPgExpr order_by, bool is_descending,
+                                   bool nulls_first);
+YBCStatus YBCPgSelectSetTopNLimit(YBCPgStatement handle, uint64_t limit);
+
+// Fetch the rows identified by the given ybctid constants instead of binding a single ybctid.
+// Keys that belong to the same tablet are sent in one RPC, and the found rows are returned in the
+// order of the ybctids. Rows that do not exist are skipped.
+YBCStatus YBCPgSelectBindYbctids(YBCPgStatement handle, int count, YBCPgExpr *ybctids);
+
+// Max number of rows a secondary index scan should fetch from the base table in one batch.
+int YBCGetIndexFetchBatchSize();
+
+// Fetch the rows with the given primary keys. values holds num_attrs constants for each of count
+// keys, in the order of attr_nums, which must list all primary key columns. Keys that belong to
+// the same tablet are sent in one RPC, and the found rows are returned in the order of the keys.
+YBCStatus YBCPgSelectBindKeyBatch(YBCPgStatement handle, int count, int num_attrs,
+                                  const int *attr_nums, YBCPgExpr *values);
+
+// Number of outer rows a nested loop join should collect before fetching the inner rows.
+int YBCGetNestLoopBatchSize();
+
+// Number of foreign key checks that should be collected before looking up the referenced keys.
+int YBCGetForeignKeyCheckBatchSize();
+
+// Read only the rows of a hash partitioned table whose hash codes are in [min_hash_code,
+// max_hash_code]. Parallel workers scan different ranges of the same table this way.
+YBCStatus YBCPgSelectSetHashCodeRange(YBCPgStatement handle, uint16_t min_hash_code,
+                                      uint16_t max_hash_code);
+
+// Whether sequential scans could be divided among parallel workers.
+bool YBCIsParallelScanEnabled();
+
+// Number of hash code ranges per participant of a parallel scan.
+int YBCGetParallelScanChunksPerWorker();
+
 YBCStatus YBCPgExecSelect(YBCPgStatement handle);
 
 // Transaction control -----------------------------------------------------------------------------
@@ -341,6 +409,7 @@ YBCStatus YBCPgUpdateConstFloat4(YBCPgExpr expr, float value, bool is_null);
 YBCStatus YBCPgUpdateConstFloat8(YBCPgExpr expr, double value, bool is_null);
 YBCStatus YBCPgUpdateConstText(YBCPgExpr expr, const char *value, bool is_null);
 YBCStatus YBCPgUpdateConstChar(YBCPgExpr expr, const char *value, int64_t bytes, bool is_null);
+YBCStatus YBCPgUpdateConstDatum(YBCPgExpr expr, uint64_t datum, bool is_null);
 
 // Expressions with operators "=", "+", "between", "in", ...
 YBCStatus YBCPgNewOperator(YBCPgStatement stmt, const char *opname,
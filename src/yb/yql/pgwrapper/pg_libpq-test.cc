@@ -10,8 +10,19 @@
 // or implied.  See the License for the specific language governing permissions and limitations
 // under the License.
 
+#include <set>
+
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/scope_exit.hpp>
 
+#include "yb/client/client.h"
+#include "yb/client/table.h"
+
+#include "yb/master/master.proxy.h"
+
+#include "yb/rpc/rpc_controller.h"
+
+#include "yb/util/metrics.h"
 #include "yb/util/random_util.h"
 #include "yb/yql/pgwrapper/libpq_utils.h"
 #include "yb/yql/pgwrapper/pg_wrapper_test_base.h"
@@ -21,14 +32,18 @@ using namespace std::literals;
 DECLARE_int64(retryable_rpc_single_call_timeout_ms);
 DECLARE_int32(yb_client_admin_operation_timeout_sec);
 
+METRIC_DECLARE_entity(server);
+METRIC_DECLARE_histogram(handler_latency_yb_tserver_TabletServerService_Read);
+
 namespace yb {
 namespace pgwrapper {
 
 class PgLibPqTest : public PgWrapperTestBase {
  protected:
-  Result<PGConnPtr> Connect() {
+  Result<PGConnPtr> Connect(const std::string& db_name = "") {
     PGConnPtr result(PQconnectdb(Format(
-        "host=$0 port=$1 user=postgres", pg_ts->bind_host(), pg_ts->pgsql_rpc_port()).c_str()));
+        "host=$0 port=$1 user=postgres$2", pg_ts->bind_host(), pg_ts->pgsql_rpc_port(),
+        db_name.empty() ? "" : " dbname=" + db_name).c_str()));
     auto status = PQstatus(result.get());
     if (status != ConnStatusType::CONNECTION_OK) {
       return STATUS_FORMAT(NetworkError, "Connect failed: $0", status);
@@ -335,5 +350,794 @@ TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(ConcurrentIndexInsert)) {
   std::this_thread::sleep_for(30s);
 }
 
+// Secondary index scan fetches base table rows in batches, and should return each row once.
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(SecondaryIndexBatchedFetch)) {
+  constexpr int kNumRows = 1000;
+  constexpr int kNumValues = 5;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, value TEXT)"));
+  ASSERT_OK(Execute(conn.get(), "CREATE INDEX t_value_idx ON t(value)"));
+  for (int i = 0; i != kNumRows; ++i) {
+    ASSERT_OK(Execute(
+        conn.get(), Format("INSERT INTO t (key, value) VALUES ($0, 'v$1')", i, i % kNumValues)));
+  }
+
+  ASSERT_OK(Execute(conn.get(), "SET enable_seqscan = off"));
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT key, value FROM t WHERE value = 'v1'"));
+  const auto lines = PQntuples(res.get());
+  ASSERT_EQ(kNumRows / kNumValues, lines);
+  std::set<int32_t> keys;
+  for (int i = 0; i != lines; ++i) {
+    auto key = ASSERT_RESULT(GetInt32(res.get(), i, 0));
+    ASSERT_EQ(key % kNumValues, 1);
+    ASSERT_TRUE(keys.insert(key).second) << "Duplicate key: " << key;
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), i, 1)), "v1");
+  }
+
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT key FROM t WHERE value = 'v2' LIMIT 3"));
+  ASSERT_EQ(3, PQntuples(res.get()));
+}
+
+// COPY FROM into a table without secondary indexes sends rows in batches.
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(CopyFromBulkInsert)) {
+  constexpr int kNumRows = 5000;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, value TEXT, n FLOAT8)"));
+
+  auto copy = [&conn](int begin, int end) -> Status {
+    PGResultPtr res(PQexec(conn.get(), "COPY t FROM STDIN"));
+    if (PQresultStatus(res.get()) != PGRES_COPY_IN) {
+      return STATUS(NetworkError, "Failed to start COPY", PQerrorMessage(conn.get()));
+    }
+    for (int i = begin; i != end; ++i) {
+      auto line = i % 10 == 0 ? Format("$0\t\\N\t\\N\n", i) : Format("$0\tv$0\t$0.5\n", i);
+      if (PQputCopyData(conn.get(), line.c_str(), line.size()) != 1) {
+        return STATUS(NetworkError, "Failed to send COPY data", PQerrorMessage(conn.get()));
+      }
+    }
+    if (PQputCopyEnd(conn.get(), nullptr) != 1) {
+      return STATUS(NetworkError, "Failed to end COPY", PQerrorMessage(conn.get()));
+    }
+    res.reset(PQgetResult(conn.get()));
+    if (PQresultStatus(res.get()) != PGRES_COMMAND_OK) {
+      return STATUS(NetworkError, "COPY failed", PQerrorMessage(conn.get()));
+    }
+    while ((res = PGResultPtr(PQgetResult(conn.get())))) {}
+    return Status::OK();
+  };
+
+  ASSERT_OK(copy(0, kNumRows));
+
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT key, value, n::TEXT FROM t"));
+  const auto lines = PQntuples(res.get());
+  ASSERT_EQ(kNumRows, lines);
+  std::set<int32_t> keys;
+  for (int i = 0; i != lines; ++i) {
+    auto key = ASSERT_RESULT(GetInt32(res.get(), i, 0));
+    ASSERT_TRUE(keys.insert(key).second) << "Duplicate key: " << key;
+    if (key % 10 == 0) {
+      ASSERT_TRUE(PQgetisnull(res.get(), i, 1));
+      ASSERT_TRUE(PQgetisnull(res.get(), i, 2));
+    } else {
+      ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), i, 1)), Format("v$0", key));
+      ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), i, 2)), Format("$0.5", key));
+    }
+  }
+
+  // Duplicate key detected by one of the flushes should fail the whole COPY.
+  auto status = copy(kNumRows - 1, kNumRows + 1000);
+  ASSERT_NOK(status);
+  ASSERT_STR_CONTAINS(status.ToString(), "duplicate key");
+
+  // The next COPY should not be affected by the failed one.
+  ASSERT_OK(copy(kNumRows, kNumRows * 2));
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), kNumRows * 2);
+}
+
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(TopN)) {
+  constexpr int kNumRows = 1000;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, score BIGINT)"));
+  // Scores are a permutation of the keys, every 100th score is NULL.
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO t SELECT i, CASE WHEN i % 100 = 0 THEN NULL ELSE i * 7 % $0 END "
+      "FROM generate_series(0, $1) AS i", kNumRows, kNumRows - 1)));
+
+  // Ascending order puts NULLs last.
+  auto res = ASSERT_RESULT(Fetch(
+      conn.get(), "SELECT key, score::INT FROM t ORDER BY score LIMIT 5"));
+  ASSERT_EQ(PQntuples(res.get()), 5);
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), i, 1)), i + 1);
+  }
+
+  // Descending order puts NULLs first, and OFFSET is part of the rows each tablet returns.
+  res = ASSERT_RESULT(Fetch(
+      conn.get(), "SELECT key, score::INT FROM t ORDER BY score DESC LIMIT 5 OFFSET 8"));
+  ASSERT_EQ(PQntuples(res.get()), 5);
+  ASSERT_TRUE(PQgetisnull(res.get(), 0, 1));
+  ASSERT_TRUE(PQgetisnull(res.get(), 1, 1));
+  for (int i = 2; i != 5; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), i, 1)), kNumRows + 1 - i);
+  }
+
+  res = ASSERT_RESULT(Fetch(
+      conn.get(), "SELECT key FROM t ORDER BY score DESC NULLS LAST, key LIMIT 3"));
+  ASSERT_EQ(PQntuples(res.get()), 3);
+  for (int i = 0; i != 3; ++i) {
+    auto key = ASSERT_RESULT(GetInt32(res.get(), i, 0));
+    ASSERT_EQ(key * 7 % kNumRows, kNumRows - 1 - i);
+  }
+}
+
+namespace {
+
+Result<std::string> Explain(PGconn* conn, const std::string& query) {
+  auto res = VERIFY_RESULT(Fetch(conn, "EXPLAIN " + query));
+  std::string plan;
+  for (int i = 0; i != PQntuples(res.get()); ++i) {
+    plan += VERIFY_RESULT(GetString(res.get(), i, 0)) + "\n";
+  }
+  return plan;
+}
+
+} // namespace
+
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(AggregatePushdown)) {
+  constexpr int kNumRows = 1000;
+  constexpr int kNumGroups = 7;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(
+      conn.get(),
+      "CREATE TABLE t (key INT PRIMARY KEY, grp INT, i2 SMALLINT, i4 INT, i8 BIGINT, s TEXT)"));
+
+  // Without GROUP BY an empty table still has one row of aggregates.
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT, SUM(i4)::INT FROM t"));
+  ASSERT_EQ(PQntuples(res.get()), 1);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 0);
+  ASSERT_TRUE(PQgetisnull(res.get(), 0, 1));
+
+  // Values are close to the maximum of their types, so the sums overflow the types of the
+  // columns. Every 10th row has NULL values.
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO t SELECT i, i % $0, "
+      "CASE WHEN i % 10 = 0 THEN NULL ELSE 32767 - i % 100 END, "
+      "CASE WHEN i % 10 = 0 THEN NULL ELSE 2147483647 - i END, "
+      "CASE WHEN i % 10 = 0 THEN NULL ELSE 9223372036854775807 - i END, "
+      "CASE WHEN i % 10 = 0 THEN NULL ELSE 'v' || i END "
+      "FROM generate_series(0, $1) AS i", kNumGroups, kNumRows - 1)));
+
+  // Casts of the aggregates are computed by Postgres from the aggregates computed by DocDB.
+  const std::string kAggregates =
+      "COUNT(*)::TEXT, COUNT(s)::TEXT, SUM(i2)::TEXT, SUM(i4)::TEXT, SUM(i8)::TEXT, "
+      "MIN(i2)::TEXT, MAX(i4)::TEXT, MIN(i8)::TEXT, MAX(i8)::TEXT";
+  const std::string kGroupedQuery = Format(
+      "SELECT grp, $0 FROM t GROUP BY grp ORDER BY grp", kAggregates);
+
+  // Aggregates are computed by DocDB. Reference results are computed by Postgres from the rows of
+  // a scan with a condition, which is not pushed down.
+  auto plan = ASSERT_RESULT(Explain(conn.get(), kGroupedQuery));
+  ASSERT_EQ(plan.find("Aggregate"), std::string::npos) << plan;
+  const std::string kReferenceQuery = Format(
+      "SELECT grp, $0 FROM t WHERE key + 0 >= 0 GROUP BY grp ORDER BY grp", kAggregates);
+  plan = ASSERT_RESULT(Explain(conn.get(), kReferenceQuery));
+  ASSERT_NE(plan.find("Aggregate"), std::string::npos) << plan;
+
+  res = ASSERT_RESULT(Fetch(conn.get(), kGroupedQuery));
+  auto reference = ASSERT_RESULT(Fetch(conn.get(), kReferenceQuery));
+  ASSERT_EQ(PQntuples(res.get()), kNumGroups);
+  ASSERT_EQ(PQntuples(reference.get()), kNumGroups);
+  for (int row = 0; row != kNumGroups; ++row) {
+    for (int column = 0; column != PQnfields(res.get()); ++column) {
+      ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, column)),
+                ASSERT_RESULT(GetString(reference.get(), row, column)))
+          << "Row: " << row << ", column: " << column;
+    }
+  }
+  // SUM(i4) of a group is larger than the maximum of INT.
+  ASSERT_GT(std::stoll(ASSERT_RESULT(GetString(res.get(), 0, 4))), 2147483647LL);
+
+  // Aggregates of the whole table.
+  res = ASSERT_RESULT(Fetch(
+      conn.get(), "SELECT COUNT(*)::INT, COUNT(i4)::INT, SUM(i8)::TEXT FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), kNumRows);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 1)), kNumRows - kNumRows / 10);
+  reference = ASSERT_RESULT(Fetch(
+      conn.get(), "SELECT SUM(i8)::TEXT FROM t WHERE key + 0 >= 0"));
+  ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), 0, 2)),
+            ASSERT_RESULT(GetString(reference.get(), 0, 0)));
+}
+
+// Tables of a colocated database are stored in one tablet, but their rows are kept apart.
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(Colocation)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE DATABASE colocation_db WITH colocated = true"));
+
+  conn = ASSERT_RESULT(Connect("colocation_db"));
+  constexpr int kNumTables = 3;
+  for (int i = 0; i != kNumTables; ++i) {
+    ASSERT_OK(Execute(conn.get(), Format("CREATE TABLE t$0 (key INT PRIMARY KEY, value TEXT)", i)));
+    ASSERT_OK(Execute(conn.get(), Format("INSERT INTO t$0 (key, value) VALUES (1, 'v$0')", i)));
+  }
+
+  for (int i = 0; i != kNumTables; ++i) {
+    auto res = ASSERT_RESULT(Fetch(conn.get(), Format("SELECT * FROM t$0", i)));
+    ASSERT_EQ(1, PQntuples(res.get()));
+    auto value = ASSERT_RESULT(GetString(res.get(), 0, 1));
+    ASSERT_EQ(value, Format("v$0", i));
+  }
+
+  auto client = ASSERT_RESULT(cluster_->CreateClient());
+  std::vector<std::pair<std::string, client::YBTableName>> tables;
+  ASSERT_OK(client->ListTablesWithIds(&tables, "" /* filter */));
+  int num_colocated_tables = 0;
+  std::set<TabletId> tablet_ids;
+  for (const auto& table : tables) {
+    if (table.second.namespace_name() != "colocation_db" ||
+        !boost::starts_with(table.second.table_name(), "t")) {
+      continue;
+    }
+    std::shared_ptr<client::YBTable> yb_table;
+    ASSERT_OK(client->OpenTable(table.first, &yb_table));
+    ASSERT_TRUE(yb_table->colocated());
+    ++num_colocated_tables;
+
+    master::GetTableLocationsRequestPB req;
+    master::GetTableLocationsResponsePB resp;
+    rpc::RpcController rpc;
+    rpc.set_timeout(30s);
+    req.mutable_table()->set_table_id(table.first);
+    ASSERT_OK(cluster_->master_proxy()->GetTableLocations(req, &resp, &rpc));
+    ASSERT_FALSE(resp.has_error()) << resp.error().ShortDebugString();
+    for (const auto& tablet : resp.tablet_locations()) {
+      tablet_ids.insert(tablet.tablet_id());
+    }
+  }
+  ASSERT_EQ(kNumTables, num_colocated_tables);
+  ASSERT_EQ(1, tablet_ids.size());
+}
+
+class PgLibPqColumnarResultTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.emplace_back("--ysql_columnar_result=true");
+  }
+};
+
+TEST_F(PgLibPqColumnarResultTest, YB_DISABLE_TEST_IN_TSAN(Scan)) {
+  constexpr int kNumRows = 2000;
+
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(
+      conn.get(),
+      "CREATE TABLE t (key INT PRIMARY KEY, i8 BIGINT, f FLOAT8, b BOOL, s TEXT, d NUMERIC)"));
+  for (int i = 0; i != kNumRows; ++i) {
+    if (i % 7 == 0) {
+      ASSERT_OK(Execute(conn.get(), Format("INSERT INTO t (key) VALUES ($0)", i)));
+    } else {
+      ASSERT_OK(Execute(conn.get(), Format(
+          "INSERT INTO t VALUES ($0, $1, $0.25, $2, 'v$0', $0.5)",
+          i, i * 1000000000LL, i % 2 == 0 ? "true" : "false")));
+    }
+  }
+
+  auto res = ASSERT_RESULT(Fetch(
+      conn.get(), "SELECT key, i8::TEXT, f::TEXT, b::TEXT, s, d::TEXT FROM t"));
+  const auto lines = PQntuples(res.get());
+  ASSERT_EQ(kNumRows, lines);
+  std::set<int32_t> keys;
+  for (int row = 0; row != lines; ++row) {
+    auto key = ASSERT_RESULT(GetInt32(res.get(), row, 0));
+    ASSERT_TRUE(keys.insert(key).second) << "Duplicate key: " << key;
+    if (key % 7 == 0) {
+      for (int column = 1; column != 6; ++column) {
+        ASSERT_TRUE(PQgetisnull(res.get(), row, column)) << "Key: " << key;
+      }
+      continue;
+    }
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 1)), std::to_string(key * 1000000000LL));
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 2)), Format("$0.25", key));
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 3)), key % 2 == 0 ? "true" : "false");
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 4)), Format("v$0", key));
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 5)), Format("$0.5", key));
+  }
+
+  // Aggregates are still returned in row format.
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT, COUNT(s)::INT FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), kNumRows);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 1)), kNumRows - (kNumRows + 6) / 7);
+}
+
+class PgLibPqSequenceCacheTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.emplace_back("--ysql_sequence_cache_minval=100");
+  }
+};
+
+TEST_F(PgLibPqSequenceCacheTest, YB_DISABLE_TEST_IN_TSAN(Nextval)) {
+  auto conn1 = ASSERT_RESULT(Connect());
+  auto conn2 = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn1.get(), "CREATE SEQUENCE s"));
+  ASSERT_OK(Execute(conn1.get(), "CREATE SEQUENCE s_cache_1000 CACHE 1000"));
+
+  auto nextval = [](PGconn* conn, const char* seq) -> Result<int32_t> {
+    auto res = VERIFY_RESULT(Fetch(conn, Format("SELECT nextval('$0')::INT", seq)));
+    return GetInt32(res.get(), 0, 0);
+  };
+
+  // Every backend allocates its own range of values.
+  ASSERT_EQ(ASSERT_RESULT(nextval(conn1.get(), "s")), 1);
+  ASSERT_EQ(ASSERT_RESULT(nextval(conn2.get(), "s")), 101);
+  ASSERT_EQ(ASSERT_RESULT(nextval(conn1.get(), "s")), 2);
+  ASSERT_EQ(ASSERT_RESULT(nextval(conn2.get(), "s")), 102);
+
+  // A larger CACHE of the sequence is used as is.
+  ASSERT_EQ(ASSERT_RESULT(nextval(conn1.get(), "s_cache_1000")), 1);
+  ASSERT_EQ(ASSERT_RESULT(nextval(conn2.get(), "s_cache_1000")), 1001);
+}
+
+class PgLibPqNestLoopBatchTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.emplace_back("--ysql_nested_loop_batch_size=16");
+  }
+};
+
+TEST_F(PgLibPqNestLoopBatchTest, YB_DISABLE_TEST_IN_TSAN(Join)) {
+  constexpr int kNumRows = 100;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(),
+                    "CREATE TABLE outer_t (key INT PRIMARY KEY, ref_h INT, ref_r INT)"));
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE inner_t (h INT, r INT, value TEXT, "
+                                "PRIMARY KEY (h HASH, r ASC))"));
+  // Every third outer row has no inner row, and every tenth has a null reference.
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO outer_t SELECT i, i, CASE WHEN i % 10 = 0 THEN NULL ELSE i * 2 END "
+      "FROM generate_series(1, $0) AS i", kNumRows)));
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO inner_t SELECT i, i * 2, 'v' || i FROM generate_series(1, $0) AS i "
+      "WHERE i % 3 != 0", kNumRows)));
+  ASSERT_OK(Execute(conn.get(), "SET enable_hashjoin = off"));
+  ASSERT_OK(Execute(conn.get(), "SET enable_mergejoin = off"));
+
+  int expected_inner = 0;
+  for (int i = 1; i <= kNumRows; ++i) {
+    expected_inner += i % 10 != 0 && i % 3 != 0;
+  }
+
+  // Inner join, the matching rows of inner_t are fetched in batches of primary keys.
+  auto res = ASSERT_RESULT(Fetch(conn.get(),
+      "SELECT o.key, i.value FROM outer_t o JOIN inner_t i ON i.h = o.ref_h AND i.r = o.ref_r "
+      "ORDER BY o.key"));
+  ASSERT_EQ(PQntuples(res.get()), expected_inner);
+  for (int row = 0; row != PQntuples(res.get()); ++row) {
+    auto key = ASSERT_RESULT(GetInt32(res.get(), row, 0));
+    ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 1)), Format("v$0", key));
+  }
+
+  // Left join returns the outer rows without matches extended with nulls.
+  res = ASSERT_RESULT(Fetch(conn.get(),
+      "SELECT o.key, i.value FROM outer_t o LEFT JOIN inner_t i "
+      "ON i.h = o.ref_h AND i.r = o.ref_r ORDER BY o.key"));
+  ASSERT_EQ(PQntuples(res.get()), kNumRows);
+  for (int row = 0; row != kNumRows; ++row) {
+    auto key = ASSERT_RESULT(GetInt32(res.get(), row, 0));
+    ASSERT_EQ(key, row + 1);
+    if (key % 10 == 0 || key % 3 == 0) {
+      ASSERT_TRUE(PQgetisnull(res.get(), row, 1));
+    } else {
+      ASSERT_EQ(ASSERT_RESULT(GetString(res.get(), row, 1)), Format("v$0", key));
+    }
+  }
+}
+
+TEST_F(PgLibPqTest, YB_DISABLE_TEST_IN_TSAN(ForeignKeyBatch)) {
+  constexpr int kNumRows = 1000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE pk_t (h INT, r INT, PRIMARY KEY (h HASH, r ASC))"));
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE fk_t (key INT PRIMARY KEY, h INT, r INT, "
+                                "FOREIGN KEY (h, r) REFERENCES pk_t)"));
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO pk_t SELECT i, i * 2 FROM generate_series(1, $0) AS i", kNumRows)));
+
+  // Checks of referencing rows span several batches, and repeated keys are fine.
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO fk_t SELECT i, i % $0 + 1, (i % $0 + 1) * 2 FROM generate_series(1, $1) AS i",
+      kNumRows, kNumRows * 2)));
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT FROM fk_t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), kNumRows * 2);
+
+  // A missing key in the middle of a batch fails the whole statement.
+  auto status = Execute(conn.get(), Format(
+      "INSERT INTO fk_t SELECT i, i - $0, CASE WHEN i = $1 THEN 1 ELSE (i - $0) * 2 END "
+      "FROM generate_series($0 + 1, $1 + 10) AS i", kNumRows * 2, kNumRows * 2 + 5));
+  ASSERT_NOK(status);
+  ASSERT_STR_CONTAINS(status.ToString(), "violates foreign key constraint");
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT FROM fk_t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), kNumRows * 2);
+
+  // Rows without a reference are not checked.
+  ASSERT_OK(Execute(conn.get(), Format("INSERT INTO fk_t VALUES ($0, NULL, 1)", kNumRows * 3)));
+}
+
+class PgLibPqBlindUpdateTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.emplace_back("--ysql_enable_blind_column_updates=true");
+  }
+};
+
+// Updates of constant values by ybctid are written without reading the row, indexes and triggers
+// still see the old and new values.
+TEST_F(PgLibPqBlindUpdateTest, YB_DISABLE_TEST_IN_TSAN(IndexAndTriggers)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, v INT, w INT)"));
+  ASSERT_OK(Execute(conn.get(), "CREATE INDEX t_v ON t (v)"));
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE audit (key INT, old_v INT, new_v INT)"));
+  ASSERT_OK(Execute(conn.get(),
+      "CREATE FUNCTION t_before() RETURNS TRIGGER AS $$ "
+      "BEGIN NEW.w := NEW.v * 2; RETURN NEW; END; $$ LANGUAGE plpgsql"));
+  ASSERT_OK(Execute(conn.get(),
+      "CREATE FUNCTION t_after() RETURNS TRIGGER AS $$ "
+      "BEGIN INSERT INTO audit VALUES (NEW.key, OLD.v, NEW.v); RETURN NEW; END; $$ "
+      "LANGUAGE plpgsql"));
+  ASSERT_OK(Execute(conn.get(),
+      "CREATE TRIGGER t_before BEFORE UPDATE ON t FOR EACH ROW EXECUTE PROCEDURE t_before()"));
+  ASSERT_OK(Execute(conn.get(),
+      "CREATE TRIGGER t_after AFTER UPDATE ON t FOR EACH ROW EXECUTE PROCEDURE t_after()"));
+  ASSERT_OK(Execute(conn.get(), "INSERT INTO t SELECT i, i, 0 FROM generate_series(1, 10) AS i"));
+
+  ASSERT_OK(Execute(conn.get(), "UPDATE t SET v = 100 WHERE key = 3"));
+
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT v, w FROM t WHERE key = 3"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 100);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 1)), 200);
+
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT key FROM t WHERE v = 3"));
+  ASSERT_EQ(PQntuples(res.get()), 0);
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT key FROM t WHERE v = 100"));
+  ASSERT_EQ(PQntuples(res.get()), 1);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 3);
+
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT key, old_v, new_v FROM audit"));
+  ASSERT_EQ(PQntuples(res.get()), 1);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 3);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 1)), 3);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 2)), 100);
+}
+
+// Blind updates conflict with concurrent updates and deletes of the same row, and do not recreate
+// a deleted row.
+TEST_F(PgLibPqBlindUpdateTest, YB_DISABLE_TEST_IN_TSAN(ConflictingUpdates)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, v INT, w INT)"));
+  ASSERT_OK(Execute(conn.get(), "INSERT INTO t VALUES (1, 1, 1), (2, 2, 2)"));
+
+  auto conn1 = ASSERT_RESULT(Connect());
+  auto conn2 = ASSERT_RESULT(Connect());
+
+  // Concurrent updates of the same column, only one of them could commit.
+  ASSERT_OK(Execute(conn1.get(), "BEGIN"));
+  ASSERT_OK(Execute(conn2.get(), "BEGIN"));
+  auto status1 = Execute(conn1.get(), "UPDATE t SET w = 10 WHERE key = 1");
+  auto status2 = Execute(conn2.get(), "UPDATE t SET w = 20 WHERE key = 1");
+  status1 = status1.ok() ? Execute(conn1.get(), "COMMIT") : status1;
+  status2 = status2.ok() ? Execute(conn2.get(), "COMMIT") : status2;
+  LOG(INFO) << "Update 1: " << status1 << ", update 2: " << status2;
+  ASSERT_NE(status1.ok(), status2.ok());
+  if (!status1.ok()) {
+    ASSERT_OK(Execute(conn1.get(), "ROLLBACK"));
+  } else {
+    ASSERT_OK(Execute(conn2.get(), "ROLLBACK"));
+  }
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT v, w FROM t WHERE key = 1"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 1);
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 1)), status1.ok() ? 10 : 20);
+
+  // Update of a row that is deleted concurrently.
+  ASSERT_OK(Execute(conn1.get(), "BEGIN"));
+  status1 = Execute(conn1.get(), "UPDATE t SET w = 30 WHERE key = 2");
+  status2 = Execute(conn2.get(), "DELETE FROM t WHERE key = 2");
+  status1 = status1.ok() ? Execute(conn1.get(), "COMMIT") : status1;
+  LOG(INFO) << "Update: " << status1 << ", delete: " << status2;
+  ASSERT_NE(status1.ok(), status2.ok());
+  if (!status1.ok()) {
+    ASSERT_OK(Execute(conn1.get(), "ROLLBACK"));
+  }
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT v, w FROM t WHERE key = 2"));
+  if (status1.ok()) {
+    ASSERT_EQ(PQntuples(res.get()), 1);
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 2);
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 1)), 30);
+  } else {
+    ASSERT_EQ(PQntuples(res.get()), 0);
+  }
+}
+
+class PgLibPqCatalogCacheTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.emplace_back(
+        "--ysql_catalog_cache_dir=" + GetTestPath("catalog_cache"));
+  }
+};
+
+TEST_F(PgLibPqCatalogCacheTest, YB_DISABLE_TEST_IN_TSAN(Reconnect)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY)"));
+  ASSERT_OK(Execute(conn.get(), "INSERT INTO t VALUES (1)"));
+
+  // Catalog scans saved before t was created do not contain it.
+  auto conn2 = ASSERT_RESULT(Connect());
+  auto res = ASSERT_RESULT(Fetch(conn2.get(), "SELECT key FROM t"));
+  ASSERT_EQ(PQntuples(res.get()), 1);
+
+  // Altering the table increments the catalog version, so the scans saved before are not used.
+  ASSERT_OK(Execute(conn.get(), "ALTER TABLE t ADD COLUMN v INT"));
+  ASSERT_OK(Execute(conn.get(), "UPDATE t SET v = 2"));
+  for (int i = 0; i != 2; ++i) {
+    auto conn3 = ASSERT_RESULT(Connect());
+    res = ASSERT_RESULT(Fetch(conn3.get(), "SELECT v FROM t"));
+    ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 2);
+  }
+
+  std::vector<std::string> files;
+  ASSERT_OK(Env::Default()->GetChildren(GetTestPath("catalog_cache"), &files));
+  ASSERT_GT(files.size(), 2);
+}
+
+class PgLibPqParallelScanTest : public PgLibPqTest {
+ protected:
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    options->extra_tserver_flags.emplace_back("--ysql_enable_parallel_scans=true");
+    // Make the hash ranges of the workers span multiple tablets.
+    options->extra_tserver_flags.emplace_back("--yb_num_shards_per_tserver=4");
+  }
+
+  CHECKED_STATUS PreferParallelPlans(PGconn* conn) {
+    RETURN_NOT_OK(Execute(conn, "SET parallel_setup_cost = 0"));
+    RETURN_NOT_OK(Execute(conn, "SET parallel_tuple_cost = 0"));
+    RETURN_NOT_OK(Execute(conn, "SET min_parallel_table_scan_size = 0"));
+    return Execute(conn, "SET max_parallel_workers_per_gather = 4");
+  }
+
+  // Returns EXPLAIN output of the query as a single string.
+  Result<std::string> Explain(PGconn* conn, const std::string& query) {
+    auto res = VERIFY_RESULT(Fetch(conn, "EXPLAIN (ANALYZE, COSTS OFF) " + query));
+    std::string result;
+    for (int row = 0; row != PQntuples(res.get()); ++row) {
+      result += VERIFY_RESULT(GetString(res.get(), row, 0)) + "\n";
+    }
+    return result;
+  }
+
+  // Reads all keys of t, failing on a duplicate key.
+  Result<std::set<int32_t>> ReadKeys(PGconn* conn) {
+    auto res = VERIFY_RESULT(Fetch(conn, "SELECT key FROM t"));
+    std::set<int32_t> result;
+    for (int row = 0; row != PQntuples(res.get()); ++row) {
+      auto key = VERIFY_RESULT(GetInt32(res.get(), row, 0));
+      if (!result.insert(key).second) {
+        return STATUS_FORMAT(IllegalState, "Duplicate key $0", key);
+      }
+    }
+    return result;
+  }
+};
+
+TEST_F(PgLibPqParallelScanTest, YB_DISABLE_TEST_IN_TSAN(SeqScan)) {
+  constexpr int kNumRows = 1000;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, value INT)"));
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO t SELECT i, i FROM generate_series(1, $0) AS i", kNumRows)));
+  ASSERT_OK(PreferParallelPlans(conn.get()));
+
+  auto plan = ASSERT_RESULT(Explain(conn.get(), "SELECT key FROM t"));
+  ASSERT_STR_CONTAINS(plan, "Gather");
+  ASSERT_EQ(plan.find("Workers Launched: 0"), std::string::npos) << plan;
+
+  std::set<int32_t> expected;
+  for (int i = 1; i <= kNumRows; ++i) {
+    expected.insert(i);
+  }
+  for (int i = 0; i != 5; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(ReadKeys(conn.get())), expected);
+  }
+
+  // Workers could not see the writes of the transaction, so it does not use them.
+  ASSERT_OK(Execute(conn.get(), "BEGIN"));
+  ASSERT_OK(Execute(conn.get(), Format("INSERT INTO t VALUES ($0, 0)", kNumRows + 1)));
+  expected.insert(kNumRows + 1);
+  plan = ASSERT_RESULT(Explain(conn.get(), "SELECT key FROM t"));
+  ASSERT_STR_CONTAINS(plan, "Workers Launched: 0");
+  ASSERT_EQ(ASSERT_RESULT(ReadKeys(conn.get())), expected);
+  ASSERT_OK(Execute(conn.get(), "COMMIT"));
+}
+
+// Participants of a parallel scan read at the same read time, so a read restart could not be done
+// and is reported as an error. Scans that succeed read all rows committed before they started.
+TEST_F(PgLibPqParallelScanTest, YB_DISABLE_TEST_IN_TSAN(ReadRestart)) {
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY, value INT)"));
+  ASSERT_OK(Execute(conn.get(), "INSERT INTO t SELECT i, i FROM generate_series(1, 1000) AS i"));
+  ASSERT_OK(PreferParallelPlans(conn.get()));
+
+  std::atomic<bool> stop(false);
+  std::atomic<int> last_written(1000);
+
+  std::thread write_thread([this, &stop, &last_written] {
+    auto write_conn = ASSERT_RESULT(Connect());
+    int write_key = last_written.load(std::memory_order_acquire) + 1;
+    while (!stop.load(std::memory_order_acquire)) {
+      auto status = Execute(
+          write_conn.get(), Format("INSERT INTO t VALUES ($0, $0)", write_key));
+      if (status.ok()) {
+        last_written.store(write_key, std::memory_order_release);
+        ++write_key;
+      } else {
+        LOG(INFO) << "Write " << write_key << " failed: " << status;
+      }
+    }
+  });
+
+  BOOST_SCOPE_EXIT(&stop, &write_thread) {
+    stop.store(true, std::memory_order_release);
+    write_thread.join();
+  } BOOST_SCOPE_EXIT_END;
+
+  int restarts = 0;
+  int reads = 0;
+  auto deadline = CoarseMonoClock::now() + 30s;
+  while (CoarseMonoClock::now() < deadline && (restarts == 0 || reads == 0)) {
+    const int written_before = last_written.load(std::memory_order_acquire);
+    auto keys = ReadKeys(conn.get());
+    if (!keys.ok()) {
+      ASSERT_STR_CONTAINS(keys.status().ToString(), "shared with parallel workers");
+      ++restarts;
+      continue;
+    }
+    ++reads;
+    ASSERT_GE(keys->size(), static_cast<size_t>(written_before));
+    for (int key = 1; key <= written_before; ++key) {
+      ASSERT_EQ(keys->count(key), 1) << "Missing key " << key;
+    }
+  }
+  LOG(INFO) << "Reads: " << reads << ", restarts: " << restarts;
+  ASSERT_GT(restarts, 0);
+}
+
+class PgLibPqFollowerReadTest : public PgLibPqTest {
+ protected:
+  static constexpr int kStalenessMs = 2000;
+
+  void UpdateMiniClusterOptions(ExternalMiniClusterOptions* options) override {
+    // Follower reads are done in the past.
+    options->extra_tserver_flags.emplace_back("--timestamp_history_retention_interval_sec=600");
+  }
+
+  // Restarts the tablet server with postgres in its own zone, so that follower reads go to it.
+  CHECKED_STATUS PlacePgTabletServerInOwnZone() {
+    pg_ts->Shutdown();
+    pg_ts->mutable_flags()->push_back("--placement_zone=pg_zone");
+    RETURN_NOT_OK(pg_ts->Restart(false /* start_cql_proxy */, true /* start_pgsql_proxy */));
+    return WaitFor([this]() -> Result<bool> {
+      return Connect().ok();
+    }, 60s, "Connect to restarted postgres");
+  }
+
+  Result<int64_t> CountReads(ExternalTabletServer* ts) {
+    int64_t result = 0;
+    RETURN_NOT_OK(ts->GetInt64Metric(
+        &METRIC_ENTITY_server, "yb.tabletserver",
+        &METRIC_handler_latency_yb_tserver_TabletServerService_Read, "total_count", &result));
+    return result;
+  }
+
+  Result<int64_t> CountReadsOnOtherServers() {
+    int64_t result = 0;
+    for (int i = 0; i != cluster_->num_tablet_servers(); ++i) {
+      if (cluster_->tablet_server(i) != pg_ts) {
+        result += VERIFY_RESULT(CountReads(cluster_->tablet_server(i)));
+      }
+    }
+    return result;
+  }
+
+  Result<int32_t> ReadOnlyCount(PGconn* conn) {
+    RETURN_NOT_OK(Execute(conn, "BEGIN TRANSACTION READ ONLY"));
+    auto res = VERIFY_RESULT(Fetch(conn, "SELECT COUNT(*)::INT FROM t"));
+    RETURN_NOT_OK(Execute(conn, "COMMIT"));
+    return GetInt32(res.get(), 0, 0);
+  }
+};
+
+// Read-only transactions read kStalenessMs in the past, other transactions read the latest data.
+TEST_F(PgLibPqFollowerReadTest, YB_DISABLE_TEST_IN_TSAN(ReadTime)) {
+  constexpr int kNumRows = 10;
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY)"));
+  std::this_thread::sleep_for(kStalenessMs * 2ms);
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO t SELECT generate_series(1, $0)", kNumRows)));
+  ASSERT_OK(Execute(conn.get(), Format("SET yb_follower_read_staleness_ms = $0", kStalenessMs)));
+
+  ASSERT_EQ(ASSERT_RESULT(ReadOnlyCount(conn.get())), 0);
+
+  ASSERT_OK(Execute(conn.get(), "BEGIN"));
+  ASSERT_OK(Execute(conn.get(), "SET TRANSACTION READ ONLY"));
+  auto res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), 0);
+  ASSERT_OK(Execute(conn.get(), "COMMIT"));
+
+  ASSERT_OK(Execute(conn.get(), "BEGIN"));
+  res = ASSERT_RESULT(Fetch(conn.get(), "SELECT COUNT(*)::INT FROM t"));
+  ASSERT_EQ(ASSERT_RESULT(GetInt32(res.get(), 0, 0)), kNumRows);
+  ASSERT_OK(Execute(conn.get(), "COMMIT"));
+
+  // Writes are rejected, and do not affect the following transactions.
+  ASSERT_OK(Execute(conn.get(), "BEGIN TRANSACTION READ ONLY"));
+  ASSERT_NOK(Execute(conn.get(), "INSERT INTO t VALUES (0)"));
+  ASSERT_OK(Execute(conn.get(), "ROLLBACK"));
+  ASSERT_OK(Execute(conn.get(), "INSERT INTO t VALUES (0)"));
+
+  std::this_thread::sleep_for(kStalenessMs * 2ms);
+  ASSERT_EQ(ASSERT_RESULT(ReadOnlyCount(conn.get())), kNumRows + 1);
+
+  ASSERT_OK(Execute(conn.get(), "SET yb_follower_read_staleness_ms = 0"));
+  ASSERT_OK(Execute(conn.get(), "INSERT INTO t VALUES (-1)"));
+  ASSERT_EQ(ASSERT_RESULT(ReadOnlyCount(conn.get())), kNumRows + 2);
+}
+
+// Follower reads are CONSISTENT_PREFIX, so they are served by the replica in the zone of the
+// client, even when it is not the leader.
+TEST_F(PgLibPqFollowerReadTest, YB_DISABLE_TEST_IN_TSAN(ClosestReplica)) {
+  constexpr int kNumRows = 100;
+  constexpr int kNumReads = 20;
+  ASSERT_OK(PlacePgTabletServerInOwnZone());
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY)"));
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO t SELECT generate_series(1, $0)", kNumRows)));
+  std::this_thread::sleep_for(kStalenessMs * 2ms);
+  ASSERT_OK(Execute(conn.get(), Format("SET yb_follower_read_staleness_ms = $0", kStalenessMs)));
+
+  // Load tablet locations.
+  ASSERT_EQ(ASSERT_RESULT(ReadOnlyCount(conn.get())), kNumRows);
+
+  auto reads_before = ASSERT_RESULT(CountReadsOnOtherServers());
+  for (int i = 0; i != kNumReads; ++i) {
+    ASSERT_EQ(ASSERT_RESULT(ReadOnlyCount(conn.get())), kNumRows);
+  }
+  ASSERT_EQ(ASSERT_RESULT(CountReadsOnOtherServers()), reads_before);
+}
+
+// A follower that did not catch up to the read time rejects the read, so it is retried on the
+// leader.
+TEST_F(PgLibPqFollowerReadTest, YB_DISABLE_TEST_IN_TSAN(FallbackToLeader)) {
+  constexpr int kNumRows = 100;
+  ASSERT_OK(PlacePgTabletServerInOwnZone());
+  auto conn = ASSERT_RESULT(Connect());
+  ASSERT_OK(Execute(conn.get(), "CREATE TABLE t (key INT PRIMARY KEY)"));
+  ASSERT_OK(Execute(conn.get(), Format("SET yb_follower_read_staleness_ms = $0", kStalenessMs)));
+
+  // Replicas of pg_ts stop applying changes from leaders.
+  ASSERT_OK(cluster_->SetFlag(pg_ts, "do_not_start_election_test_only", "true"));
+  ASSERT_OK(cluster_->SetFlag(pg_ts, "follower_reject_update_consensus_requests", "true"));
+  ASSERT_OK(Execute(conn.get(), Format(
+      "INSERT INTO t SELECT generate_series(1, $0)", kNumRows)));
+  std::this_thread::sleep_for(kStalenessMs * 2ms);
+
+  ASSERT_EQ(ASSERT_RESULT(ReadOnlyCount(conn.get())), kNumRows);
+
+  ASSERT_OK(cluster_->SetFlag(pg_ts, "follower_reject_update_consensus_requests", "false"));
+}
+
 } // namespace pgwrapper
 } // namespace yb
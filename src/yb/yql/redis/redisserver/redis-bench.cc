@@ -0,0 +1,349 @@
+// Copyright (c) YugaByte, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not use this file except
+// in compliance with the License.  You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software distributed under the License
+// is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express
+// or implied.  See the License for the specific language governing permissions and limitations
+// under the License.
+//
+
+// Throughput and latency benchmark of the whole Redis stack: clients send pipelined commands to a
+// Redis proxy of an in-process or external mini cluster. Keys are picked with uniform or zipfian
+// distribution, commands are picked according to the weighted mix. Ops/sec and latency
+// percentiles are reported for every command, for instance:
+//   redis-bench --redis_bench_command_mix=get:80,set:20 --redis_bench_key_distribution=zipf
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/algorithm/string.hpp>
+
+#include "yb/gutil/strings/join.h"
+
+#include "yb/integration-tests/external_mini_cluster.h"
+#include "yb/integration-tests/redis_table_test_base.h"
+
+#include "yb/yql/redis/redisserver/redis_client.h"
+#include "yb/yql/redis/redisserver/redis_server.h"
+
+#include "yb/util/hdr_histogram.h"
+#include "yb/util/random_util.h"
+#include "yb/util/test_macros.h"
+#include "yb/util/test_util.h"
+
+DEFINE_int32(redis_bench_num_clients, 4, "Number of concurrent client connections.");
+DEFINE_int32(redis_bench_pipeline, 16, "Number of commands sent by a client before waiting for "
+             "their responses.");
+DEFINE_int32(redis_bench_num_ops, 20000, "Total number of commands sent by all clients.");
+DEFINE_int32(redis_bench_num_keys, 10000, "Number of distinct keys.");
+DEFINE_string(redis_bench_key_distribution, "uniform", "Distribution of accessed keys: uniform "
+              "or zipf.");
+DEFINE_double(redis_bench_zipf_exponent, 0.99, "Exponent of the zipfian key distribution.");
+DEFINE_int32(redis_bench_value_size, 64, "Size in bytes of written values.");
+DEFINE_string(redis_bench_command_mix, "get:50,set:50", "Comma separated list of command:weight "
+              "pairs. Supported commands are get, set, hset, zadd and tsadd.");
+DEFINE_bool(redis_bench_load_keys, true, "Write every key with SET before benchmarking, so GET "
+            "does not read missing keys.");
+DEFINE_bool(redis_bench_external_mini_cluster, false, "Run tablet servers and Redis proxies in "
+            "separate processes.");
+
+namespace yb {
+namespace redisserver {
+
+namespace {
+
+// Latencies are recorded in microseconds, up to a minute.
+constexpr int64_t kMaxLatencyUs = 60 * 1000 * 1000;
+constexpr int kLatencySignificantDigits = 3;
+
+// Number of distinct fields, members and timestamps written to every collection.
+constexpr int kNumSubKeys = 100;
+
+YB_DEFINE_ENUM(BenchCommand, (kGet)(kSet)(kHSet)(kZAdd)(kTsAdd));
+
+Result<BenchCommand> ParseBenchCommand(const std::string& name) {
+  static const std::vector<std::pair<std::string, BenchCommand>> kNames = {
+      {"get", BenchCommand::kGet}, {"set", BenchCommand::kSet}, {"hset", BenchCommand::kHSet},
+      {"zadd", BenchCommand::kZAdd}, {"tsadd", BenchCommand::kTsAdd}};
+  for (const auto& p : kNames) {
+    if (boost::iequals(p.first, name)) {
+      return p.second;
+    }
+  }
+  return STATUS_FORMAT(InvalidArgument, "Unknown command: $0", name);
+}
+
+// Picks commands according to their weights.
+class CommandMix {
+ public:
+  CHECKED_STATUS Init(const std::string& mix) {
+    std::vector<std::string> entries;
+    boost::split(entries, mix, boost::is_any_of(","));
+    for (const auto& entry : entries) {
+      std::vector<std::string> parts;
+      boost::split(parts, entry, boost::is_any_of(":"));
+      if (parts.size() != 2) {
+        return STATUS_FORMAT(InvalidArgument, "Wrong command mix entry: $0", entry);
+      }
+      const auto command = VERIFY_RESULT(ParseBenchCommand(parts[0]));
+      const auto weight = std::stoi(parts[1]);
+      if (weight <= 0) {
+        return STATUS_FORMAT(InvalidArgument, "Wrong command weight: $0", entry);
+      }
+      commands_.push_back(command);
+      weights_.push_back(weight);
+    }
+    return Status::OK();
+  }
+
+  BenchCommand Next(std::mt19937_64* rng) const {
+    std::discrete_distribution<size_t> distribution(weights_.begin(), weights_.end());
+    return commands_[distribution(*rng)];
+  }
+
+  const std::vector<BenchCommand>& commands() const {
+    return commands_;
+  }
+
+ private:
+  std::vector<BenchCommand> commands_;
+  std::vector<int> weights_;
+};
+
+// Picks key indexes in [0, num_keys), uniformly or with zipfian distribution, where index 0 is the
+// most popular key.
+class KeyDistribution {
+ public:
+  CHECKED_STATUS Init(const std::string& name, size_t num_keys, double exponent) {
+    num_keys_ = num_keys;
+    if (boost::iequals(name, "uniform")) {
+      return Status::OK();
+    }
+    if (!boost::iequals(name, "zipf")) {
+      return STATUS_FORMAT(InvalidArgument, "Unknown key distribution: $0", name);
+    }
+    cdf_.reserve(num_keys);
+    double sum = 0;
+    for (size_t i = 1; i <= num_keys; ++i) {
+      sum += 1 / std::pow(i, exponent);
+      cdf_.push_back(sum);
+    }
+    for (auto& value : cdf_) {
+      value /= sum;
+    }
+    return Status::OK();
+  }
+
+  size_t Next(std::mt19937_64* rng) const {
+    if (cdf_.empty()) {
+      return RandomUniformInt<size_t>(0, num_keys_ - 1, rng);
+    }
+    const auto p = std::uniform_real_distribution<double>()(*rng);
+    return std::min<size_t>(
+        std::lower_bound(cdf_.begin(), cdf_.end(), p) - cdf_.begin(), num_keys_ - 1);
+  }
+
+ private:
+  size_t num_keys_ = 0;
+  std::vector<double> cdf_;
+};
+
+// Latencies of one command, that are recorded by all clients.
+struct CommandStats {
+  CommandStats() : histogram(kMaxLatencyUs, kLatencySignificantDigits) {}
+
+  HdrHistogram histogram;
+  std::atomic<size_t> num_errors{0};
+};
+
+} // namespace
+
+class RedisBench : public integration_tests::RedisTableTestBase {
+ protected:
+  void SetUp() override {
+    RedisTableTestBase::SetUp();
+    ASSERT_OK(mix_.Init(FLAGS_redis_bench_command_mix));
+    ASSERT_OK(keys_.Init(
+        FLAGS_redis_bench_key_distribution, FLAGS_redis_bench_num_keys,
+        FLAGS_redis_bench_zipf_exponent));
+    for (size_t i = 0; i != kBenchCommandMapSize; ++i) {
+      stats_.emplace_back(new CommandStats());
+    }
+    if (!use_external_mini_cluster()) {
+      ASSERT_NO_FATALS(StartServer());
+    }
+  }
+
+  void TearDown() override {
+    if (server_) {
+      server_->Shutdown();
+      server_.reset();
+    }
+    RedisTableTestBase::TearDown();
+  }
+
+  bool use_external_mini_cluster() override {
+    return FLAGS_redis_bench_external_mini_cluster;
+  }
+
+  void StartServer() {
+    redis_server_port_ = GetFreePort(&redis_port_lock_);
+    RedisServerOptions opts;
+    opts.rpc_opts.rpc_bind_addresses = Format("0.0.0.0:$0", redis_server_port_);
+    opts.webserver_opts.port = GetFreePort(&redis_webserver_lock_);
+    const auto fs_root = GetTestPath("RedisBench-fsroot");
+    opts.fs_opts.wal_paths = {fs_root};
+    opts.fs_opts.data_paths = {fs_root};
+    opts.master_addresses_flag = JoinStrings(master_rpc_addresses_as_strings(), ",");
+    server_.reset(new RedisServer(opts, nullptr /* tserver */));
+    ASSERT_OK(server_->Start());
+  }
+
+  std::unique_ptr<RedisClient> NewClient() {
+    if (use_external_mini_cluster()) {
+      auto* ts = external_mini_cluster()->tablet_server(0);
+      return std::make_unique<RedisClient>(ts->bind_host(), ts->redis_rpc_port());
+    }
+    return std::make_unique<RedisClient>("127.0.0.1", redis_server_port_);
+  }
+
+  static std::string Key(size_t index) {
+    return Format("key$0", index);
+  }
+
+  RedisCommand MakeCommand(BenchCommand command, std::mt19937_64* rng) const {
+    auto key = Key(keys_.Next(rng));
+    const auto sub_key = std::to_string(RandomUniformInt<int>(1, kNumSubKeys, rng));
+    switch (command) {
+      case BenchCommand::kGet:
+        return {"GET", std::move(key)};
+      case BenchCommand::kSet:
+        return {"SET", std::move(key), RandomValue(rng)};
+      case BenchCommand::kHSet:
+        return {"HSET", "h" + key, "f" + sub_key, RandomValue(rng)};
+      case BenchCommand::kZAdd:
+        return {"ZADD", "z" + key, sub_key, RandomValue(rng)};
+      case BenchCommand::kTsAdd:
+        return {"TSADD", "ts" + key, sub_key, RandomValue(rng)};
+    }
+    FATAL_INVALID_ENUM_VALUE(BenchCommand, command);
+  }
+
+  std::string RandomValue(std::mt19937_64* rng) const {
+    return RandomHumanReadableString(FLAGS_redis_bench_value_size, rng);
+  }
+
+  // Sends num_ops commands in pipelines of redis_bench_pipeline commands. The latency of every
+  // command is measured from the start of its pipeline to the receipt of its response.
+  void RunClient(size_t num_ops) {
+    auto client = NewClient();
+    std::mt19937_64 rng(RandomUniformInt<uint64_t>());
+    const size_t pipeline = std::max(FLAGS_redis_bench_pipeline, 1);
+    while (num_ops > 0) {
+      const auto batch_size = std::min(pipeline, num_ops);
+      num_ops -= batch_size;
+      MonoTime start;
+      for (size_t i = 0; i != batch_size; ++i) {
+        const auto command = mix_.Next(&rng);
+        auto* stats = stats_[to_underlying(command)].get();
+        client->Send(MakeCommand(command, &rng), [&start, stats](const RedisReply& reply) {
+          if (reply.get_type() == RedisReplyType::kError) {
+            stats->num_errors.fetch_add(1, std::memory_order_relaxed);
+          }
+          stats->histogram.Increment(
+              std::min((MonoTime::Now() - start).ToMicroseconds(), kMaxLatencyUs));
+        });
+      }
+      start = MonoTime::Now();
+      client->Commit();
+    }
+    client->Disconnect();
+  }
+
+  // Writes every key, so reads of the benchmark find them.
+  void LoadKeys() {
+    auto client = NewClient();
+    std::mt19937_64 rng(RandomUniformInt<uint64_t>());
+    size_t num_errors = 0;
+    const size_t pipeline = std::max(FLAGS_redis_bench_pipeline, 1);
+    for (int i = 0; i != FLAGS_redis_bench_num_keys; ++i) {
+      client->Send({"SET", Key(i), RandomValue(&rng)}, [&num_errors](const RedisReply& reply) {
+        num_errors += reply.get_type() == RedisReplyType::kError;
+      });
+      if ((i + 1) % pipeline == 0) {
+        client->Commit();
+      }
+    }
+    client->Commit();
+    client->Disconnect();
+    ASSERT_EQ(0, num_errors);
+  }
+
+  void Report(MonoDelta elapsed) const {
+    size_t total = 0;
+    for (auto command : mix_.commands()) {
+      const auto& stats = *stats_[to_underlying(command)];
+      const auto& histogram = stats.histogram;
+      const auto count = histogram.TotalCount();
+      if (count == 0) {
+        continue;
+      }
+      total += count;
+      LOG(INFO) << ToString(command) << ": " << count << " ops, "
+                << count / elapsed.ToSeconds() << " ops/sec, " << stats.num_errors << " errors";
+      LOG(INFO) << ToString(command) << " latency (us): mean " << histogram.MeanValue()
+                << ", p50 " << histogram.ValueAtPercentile(50)
+                << ", p95 " << histogram.ValueAtPercentile(95)
+                << ", p99 " << histogram.ValueAtPercentile(99)
+                << ", p99.9 " << histogram.ValueAtPercentile(99.9)
+                << ", max " << histogram.MaxValue();
+    }
+    LOG(INFO) << "Total: " << total << " ops in " << elapsed << ", "
+              << total / elapsed.ToSeconds() << " ops/sec";
+  }
+
+  CommandMix mix_;
+  KeyDistribution keys_;
+  // Commands of the mix could repeat, so stats are kept per command instead of per mix entry.
+  std::vector<std::unique_ptr<CommandStats>> stats_;
+  std::unique_ptr<RedisServer> server_;
+  int redis_server_port_ = 0;
+  std::unique_ptr<FileLock> redis_port_lock_;
+  std::unique_ptr<FileLock> redis_webserver_lock_;
+};
+
+TEST_F(RedisBench, CommandMix) {
+  if (FLAGS_redis_bench_load_keys) {
+    ASSERT_NO_FATALS(LoadKeys());
+  }
+
+  const size_t num_clients = std::max(FLAGS_redis_bench_num_clients, 1);
+  const auto start = MonoTime::Now();
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i != num_clients; ++i) {
+    // The remainder of ops is sent by the first client.
+    const size_t num_ops = FLAGS_redis_bench_num_ops / num_clients +
+                           (i == 0 ? FLAGS_redis_bench_num_ops % num_clients : 0);
+    threads.emplace_back([this, num_ops] { RunClient(num_ops); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  Report(MonoTime::Now() - start);
+
+  for (auto command : mix_.commands()) {
+    ASSERT_EQ(0, stats_[to_underlying(command)]->num_errors) << ToString(command);
+  }
+}
+
+}  // namespace redisserver
+}  // namespace yb
@@ -33,6 +33,7 @@
 #include "yb/rpc/scheduler.h"
 
 #include "yb/util/crypt.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/metrics.h"
 #include "yb/util/redis_util.h"
 #include "yb/util/stol_utils.h"
@@ -63,6 +64,14 @@ DEFINE_string(redis_passwords_separator, ",", "The character used to separate mu
 DEFINE_int32(redis_keys_threshold, 10000,
              "Maximum number of keys allowed to be in the db before the KEYS operation errors out");
 
+DEFINE_int32(redis_collection_page_size, 10000,
+             "Maximum number of entries HGETALL, HKEYS, HVALS and SMEMBERS read from a tablet in "
+             "one RPC. The rest of the collection is read by subsequent RPCs. 0 reads the whole "
+             "collection at once.");
+TAG_FLAG(redis_collection_page_size, advanced);
+
+DECLARE_bool(redis_publish_invalidations);
+
 __attribute__((unused))
 DEFINE_validator(redis_passwords_separator, &ValidateRedisPasswordSeparator);
 
@@ -71,17 +80,17 @@ namespace redisserver {
 
 #define REDIS_COMMANDS \
     ((get, Get, 2, READ)) \
-    ((mget, MGet, -2, READ)) \
+    ((mget, MGet, -2, LOCAL)) \
     ((hget, HGet, 3, READ)) \
     ((tsget, TsGet, 3, READ)) \
     ((hmget, HMGet, -3, READ)) \
-    ((hgetall, HGetAll, 2, READ)) \
-    ((hkeys, HKeys, 2, READ)) \
-    ((hvals, HVals, 2, READ)) \
+    ((hgetall, HGetAll, 2, PAGED)) \
+    ((hkeys, HKeys, 2, PAGED)) \
+    ((hvals, HVals, 2, PAGED)) \
     ((hlen, HLen, 2, READ)) \
     ((hexists, HExists, 3, READ)) \
     ((hstrlen, HStrLen, 3, READ)) \
-    ((smembers, SMembers, 2, READ)) \
+    ((smembers, SMembers, 2, PAGED)) \
     ((sismember, SIsMember, 3, READ)) \
     ((scard, SCard, 2, READ)) \
     ((strlen, StrLen, 2, READ)) \
@@ -90,7 +99,7 @@ namespace redisserver {
     ((zcard, ZCard, 2, READ)) \
     ((rename, Rename, 3, LOCAL)) \
     ((set, Set, -3, WRITE)) \
-    ((mset, MSet, -3, WRITE)) \
+    ((mset, MSet, -3, LOCAL)) \
     ((hset, HSet, 4, WRITE)) \
     ((hmset, HMSet, -4, WRITE)) \
     ((hincrby, HIncrBy, 4, WRITE)) \
@@ -163,6 +172,7 @@ namespace redisserver {
 BOOST_PP_SEQ_FOR_EACH(DEFINE_HISTOGRAM, ~, REDIS_COMMANDS)
 
 #define READ_OP yb::client::YBRedisReadOp
+#define PAGED_OP yb::client::YBRedisReadOp
 #define WRITE_OP yb::client::YBRedisWriteOp
 #define LOCAL_OP RedisResponsePB
 #define CLUSTER_OP RedisResponsePB
@@ -214,6 +224,8 @@ void Command(
 
 #define READ_COMMAND(cname) \
     Command<yb::client::YBRedisReadOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
+#define PAGED_COMMAND(cname) \
+    PagedCommand(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define WRITE_COMMAND(cname) \
     Command<yb::client::YBRedisWriteOp>(info, idx, &BOOST_PP_CAT(Parse, cname), context)
 #define LOCAL_COMMAND(cname) \
@@ -311,13 +323,37 @@ class LocalCommandData {
   BatchContextPtr context_;
 };
 
-void GetTabletLocations(LocalCommandData data, RedisArrayPB* array_response) {
+Status GetRedisTabletLocations(
+    const LocalCommandData& data, vector<master::TabletLocationsPB>* locations) {
   vector<string> tablets, partitions;
-  vector<master::TabletLocationsPB> locations;
   const auto table_name = RedisServiceData::GetYBTableNameForRedisDatabase(
                               data.call()->connection_context().redis_db_to_use());
-  auto s = data.client()->GetTablets(table_name, 0, &tablets, &partitions, &locations,
-                                     true /* update tablets cache */);
+  return data.client()->GetTablets(table_name, 0, &tablets, &partitions, locations,
+                                   true /* update tablets cache */);
+}
+
+// Returns the first slot and the end slot (exclusive) of the tablet.
+std::pair<uint16_t, uint16_t> TabletSlots(const master::TabletLocationsPB& location) {
+  uint16_t start_key = 0;
+  uint16_t end_key_exclusive = kRedisClusterSlots;
+  if (location.partition().has_partition_key_start()) {
+    if (location.partition().partition_key_start().size() == PartitionSchema::kPartitionKeySize) {
+      start_key = PartitionSchema::DecodeMultiColumnHashValue(
+          location.partition().partition_key_start());
+    }
+  }
+  if (location.partition().has_partition_key_end()) {
+    if (location.partition().partition_key_end().size() == PartitionSchema::kPartitionKeySize) {
+      end_key_exclusive = PartitionSchema::DecodeMultiColumnHashValue(
+          location.partition().partition_key_end());
+    }
+  }
+  return {start_key, end_key_exclusive};
+}
+
+void GetTabletLocations(LocalCommandData data, RedisArrayPB* array_response) {
+  vector<master::TabletLocationsPB> locations;
+  auto s = GetRedisTabletLocations(data, &locations);
   if (!s.ok()) {
     LOG(ERROR) << "Error getting tablets: " << s.message();
     return;
@@ -329,20 +365,8 @@ void GetTabletLocations(LocalCommandData data, RedisArrayPB* array_response) {
     response.clear();
     ts_info.clear();
 
-    uint16_t start_key = 0;
-    uint16_t end_key_exclusive = kRedisClusterSlots;
-    if (location.partition().has_partition_key_start()) {
-      if (location.partition().partition_key_start().size() == PartitionSchema::kPartitionKeySize) {
-        start_key = PartitionSchema::DecodeMultiColumnHashValue(
-            location.partition().partition_key_start());
-      }
-    }
-    if (location.partition().has_partition_key_end()) {
-      if (location.partition().partition_key_end().size() == PartitionSchema::kPartitionKeySize) {
-        end_key_exclusive = PartitionSchema::DecodeMultiColumnHashValue(
-            location.partition().partition_key_end());
-      }
-    }
+    uint16_t start_key, end_key_exclusive;
+    std::tie(start_key, end_key_exclusive) = TabletSlots(location);
     response.push_back(redisserver::EncodeAsInteger(start_key).ToBuffer());
     response.push_back(redisserver::EncodeAsInteger(end_key_exclusive - 1).ToBuffer());
 
@@ -372,22 +396,68 @@ void GetTabletLocations(LocalCommandData data, RedisArrayPB* array_response) {
   array_response->set_encoded(true);
 }
 
+// Fills the response of CLUSTER NODES. Every proxy co-located with tablet leaders is a master node,
+// that serves the slots of these tablets.
+void GetClusterNodes(LocalCommandData data, RedisResponsePB* response) {
+  vector<master::TabletLocationsPB> locations;
+  auto s = GetRedisTabletLocations(data, &locations);
+  if (!s.ok()) {
+    LOG(ERROR) << "Error getting tablets: " << s.message();
+    response->set_code(RedisResponsePB::SERVER_ERROR);
+    response->set_error_message(s.message().ToBuffer());
+    return;
+  }
+
+  struct NodeInfo {
+    std::string host;
+    std::string slots;
+  };
+  std::map<std::string, NodeInfo> nodes;
+  for (const auto& location : locations) {
+    for (const auto& replica : location.replicas()) {
+      if (replica.role() != consensus::RaftPeerPB::LEADER) {
+        continue;
+      }
+      auto& node = nodes[replica.ts_info().permanent_uuid()];
+      node.host = DesiredHostPort(replica.ts_info(), CloudInfoPB()).host();
+      auto slots = TabletSlots(location);
+      node.slots += Format(" $0-$1", slots.first, slots.second - 1);
+      break;
+    }
+  }
+
+  const auto redis_port = data.server()->opts().rpc_opts.default_port;
+  const auto* tserver = data.server()->tserver();
+  const auto local_uuid = tserver ? tserver->permanent_uuid() : std::string();
+  std::string result;
+  for (const auto& uuid_and_node : nodes) {
+    // Cluster bus port is not used, but clients expect it after @.
+    result += Format(
+        "$0 $1:$2@$3 $4 - 0 0 0 connected$5\n",
+        uuid_and_node.first, uuid_and_node.second.host, redis_port, redis_port + 10000,
+        uuid_and_node.first == local_uuid ? "myself,master" : "master",
+        uuid_and_node.second.slots);
+  }
+  response->set_code(RedisResponsePB::OK);
+  response->set_string_response(result);
+}
+
 void ClusterCommand(
     const RedisCommandInfo& info,
     size_t idx,
     BatchContext* context) {
   RedisResponsePB cluster_response;
-  auto array_response = cluster_response.mutable_array_response();
   LocalCommandData data(info, idx, context);
-  GetTabletLocations(data, array_response);
+  data.call()->connection_context().set_cluster_aware();
+  if (boost::iequals(data.arg(1).ToBuffer(), "NODES")) {
+    GetClusterNodes(data, &cluster_response);
+  } else {
+    GetTabletLocations(data, cluster_response.mutable_array_response());
+  }
   context->call()->RespondSuccess(idx, info.metrics, &cluster_response);
   VLOG(1) << "Done responding to CLUSTER.";
 }
 
-void AddElements(const RefCntBuffer& buffer, RedisArrayPB* array) {
-  array->add_elements(buffer.data(), buffer.size());
-}
-
 void HandleEcho(LocalCommandData data) {
   RedisResponsePB response;
   response.set_code(RedisResponsePB::OK);
@@ -422,7 +492,7 @@ void HandlePubSub(LocalCommandData data) {
     // Build and send out an array response of all the matching channels.
     auto array_response = response.mutable_array_response();
     for (auto& channel : matched) {
-      AddElements(redisserver::EncodeAsBulkString(channel), array_response);
+      redisserver::AppendBulkString(channel, array_response->add_elements());
     }
     array_response->set_encoded(true);
   } else if (boost::iequals(data.arg(1).ToBuffer(), "NUMPAT") && data.arg_size() == 2) {
@@ -434,8 +504,8 @@ void HandlePubSub(LocalCommandData data) {
     for (int idx = 2; idx < data.arg_size(); idx++) {
       const string& channel = data.arg(idx).ToBuffer();
       int subs = data.context()->service_data()->NumSubscribers(AsPattern::kFalse, channel);
-      AddElements(redisserver::EncodeAsBulkString(channel), array_response);
-      AddElements(redisserver::EncodeAsInteger(subs), array_response);
+      redisserver::AppendBulkString(channel, array_response->add_elements());
+      redisserver::AppendInteger(subs, array_response->add_elements());
     }
     array_response->set_encoded(true);
   } else {
@@ -448,6 +518,11 @@ void HandlePubSub(LocalCommandData data) {
 void HandlePublish(LocalCommandData data) {
   const string& channel = data.arg(1).ToBuffer();
   const string& published_message = data.arg(2).ToBuffer();
+  if (channel == kRedisInvalidationChannel) {
+    data.Respond(STATUS_FORMAT(
+        InvalidCommand, "Channel $0 is reserved for invalidation messages", channel), nullptr);
+    return;
+  }
 
   data.context()->service_data()->ForwardToInterestedProxies(
       channel, published_message, [data = std::move(data)](int val) {
@@ -537,8 +612,8 @@ void HandleRole(LocalCommandData data) {
   RedisResponsePB response;
   response.set_code(RedisResponsePB::OK);
   auto array_response = response.mutable_array_response();
-  AddElements(redisserver::EncodeAsBulkString("master"), array_response);
-  AddElements(redisserver::EncodeAsInteger(0), array_response);
+  redisserver::AppendBulkString("master", array_response->add_elements());
+  redisserver::AppendInteger(0, array_response->add_elements());
   array_response->add_elements(
       redisserver::EncodeAsArrayOfEncodedElements(std::initializer_list<std::string>()));
   array_response->set_encoded(true);
@@ -977,6 +1052,120 @@ class KeysProcessor : public std::enable_shared_from_this<KeysProcessor> {
   size_t keys_threshold_ = FLAGS_redis_keys_threshold;
 };
 
+// Reads a hash or a set page by page, so a huge collection is not returned by a single RPC.
+// All pages are read at the hybrid time of the first one.
+class PagedReadProcessor : public std::enable_shared_from_this<PagedReadProcessor> {
+ public:
+  PagedReadProcessor(const LocalCommandData& data, std::shared_ptr<client::YBRedisReadOp> op)
+      : data_(data), op_(std::move(op)) {
+    resp_.set_code(RedisResponsePB::OK);
+    resp_.mutable_array_response();
+  }
+
+  void Execute() {
+    std::string partition_key;
+    auto status = op_->GetPartitionKey(&partition_key);
+    if (!status.ok()) {
+      data_.Respond(status, nullptr);
+      return;
+    }
+    data_.Apply(std::bind(&PagedReadProcessor::Store, shared_from_this(), _1, _2),
+                partition_key, ManualResponse::kTrue);
+  }
+
+ private:
+  bool Store(client::YBSession* session, const StatusFunctor& callback) {
+    session_ = session;
+    callback_ = callback;
+    session_->set_allow_local_calls_in_curr_thread(false);
+    ReadPage();
+    return true;
+  }
+
+  void ReadPage() {
+    op_->mutable_request()->set_page_size(FLAGS_redis_collection_page_size);
+    auto status = session_->Apply(op_);
+    if (!status.ok()) {
+      ProcessedAll(status);
+      return;
+    }
+    session_->FlushAsync(std::bind(&PagedReadProcessor::PageRead, shared_from_this(), _1));
+  }
+
+  void PageRead(const Status& status) {
+    if (!status.ok()) {
+      ProcessedAll(status);
+      return;
+    }
+
+    auto& response = *op_->mutable_response();
+    if (response.code() != RedisResponsePB::OK) {
+      // Wrong type or server error, forwarding the response.
+      resp_.Swap(&response);
+      ProcessedAll(Status::OK());
+      return;
+    }
+
+    size_t count = response.array_response().elements_size();
+    auto** elements = response.mutable_array_response()->mutable_elements()->mutable_data();
+    auto& array_response = *resp_.mutable_array_response();
+    for (size_t i = 0; i != count; ++i) {
+      array_response.mutable_elements()->AddAllocated(elements[i]);
+    }
+    response.mutable_array_response()->mutable_elements()->ExtractSubrange(0, count, nullptr);
+
+    if (!response.has_paging_state()) {
+      ProcessedAll(Status::OK());
+      return;
+    }
+
+    auto next_op = std::make_shared<client::YBRedisReadOp>(data_.context()->table());
+    next_op->mutable_request()->Swap(op_->mutable_request());
+    next_op->mutable_request()->mutable_paging_state()->Swap(response.mutable_paging_state());
+    op_ = std::move(next_op);
+    ReadPage();
+  }
+
+  void ProcessedAll(const Status& status) {
+    data_.Respond(status, &resp_);
+    callback_(status);
+  }
+
+  LocalCommandData data_;
+  std::shared_ptr<client::YBRedisReadOp> op_;
+  client::YBSession* session_ = nullptr;
+  StatusFunctor callback_;
+  RedisResponsePB resp_;
+};
+
+void PagedCommand(
+    const RedisCommandInfo& info,
+    size_t idx,
+    Parser<client::YBRedisReadOp> parser,
+    BatchContext* context) {
+  if (FLAGS_redis_collection_page_size <= 0) {
+    Command(info, idx, parser, context);
+    return;
+  }
+
+  VLOG(1) << "Processing " << info.name << " by pages.";
+
+  auto table = context->table();
+  if (!table) {
+    RespondWithFailure(context->call(), idx, "Could not open YBTable");
+    return;
+  }
+
+  auto op = std::make_shared<client::YBRedisReadOp>(table);
+  Status s = parser(op.get(), context->command(idx));
+  if (!s.ok()) {
+    RespondWithFailure(context->call(), idx, s.message().ToBuffer());
+    return;
+  }
+  std::make_shared<PagedReadProcessor>(LocalCommandData(info, idx, context), std::move(op))
+      ->Execute();
+}
+
 void HandleKeys(LocalCommandData data) {
   auto processor = std::make_shared<KeysProcessor>(data);
   size_t idx = 0;
@@ -987,6 +1176,149 @@ void HandleKeys(LocalCommandData data) {
   }
 }
 
+// Executes a command on many keys, i.e. MGET or MSET. The command is ordered with other commands
+// of the batch on the tablets of its keys. Then operations on all keys are flushed by a single
+// session, so they are sent as one RPC per tablet in parallel.
+class MultiKeyProcessor : public std::enable_shared_from_this<MultiKeyProcessor> {
+ public:
+  MultiKeyProcessor(const LocalCommandData& data, bool is_write)
+      : data_(data), is_write_(is_write) {
+  }
+
+  void Execute() {
+    auto table = data_.context()->table();
+    if (!table) {
+      data_.Respond(STATUS(IllegalState, "Could not open YBTable"), nullptr);
+      return;
+    }
+
+    // Partition key of a key in each tablet, by the partition start of the tablet.
+    std::map<std::string, std::string> tablet_partition_keys;
+    const size_t args_per_key = is_write_ ? 2 : 1;
+    for (size_t i = 1; i < data_.arg_size(); i += args_per_key) {
+      std::shared_ptr<client::YBRedisOp> op;
+      Status status;
+      if (is_write_) {
+        auto write_op = std::make_shared<client::YBRedisWriteOp>(table);
+        status = ParseSet(write_op.get(), {Slice("SET"), data_.arg(i), data_.arg(i + 1)});
+        op = std::move(write_op);
+      } else {
+        auto read_op = std::make_shared<client::YBRedisReadOp>(table);
+        status = ParseGet(read_op.get(), {Slice("GET"), data_.arg(i)});
+        op = std::move(read_op);
+      }
+      std::string partition_key;
+      if (status.ok()) {
+        status = op->GetPartitionKey(&partition_key);
+      }
+      if (!status.ok()) {
+        data_.Respond(status, nullptr);
+        return;
+      }
+      tablet_partition_keys.emplace(table->FindPartitionStart(partition_key), partition_key);
+      ops_.push_back(std::move(op));
+    }
+
+    callbacks_.resize(tablet_partition_keys.size());
+    size_t idx = 0;
+    for (const auto& partition_start_and_key : tablet_partition_keys) {
+      data_.Apply(
+          std::bind(&MultiKeyProcessor::Store, shared_from_this(), idx, _1, _2),
+          partition_start_and_key.second, ManualResponse::kTrue);
+      ++idx;
+    }
+  }
+
+ private:
+  bool Store(size_t idx, client::YBSession* session, const StatusFunctor& callback) {
+    session_ = session;
+    callbacks_[idx] = callback;
+    if (stored_.fetch_add(1, std::memory_order_acq_rel) + 1 == callbacks_.size()) {
+      Flush();
+    }
+    return true;
+  }
+
+  void Flush() {
+    session_->set_allow_local_calls_in_curr_thread(false);
+    for (const auto& op : ops_) {
+      auto status = session_->Apply(op);
+      if (!status.ok()) {
+        ProcessedAll(status);
+        return;
+      }
+    }
+    session_->FlushAsync(std::bind(&MultiKeyProcessor::Flushed, shared_from_this(), _1));
+  }
+
+  void Flushed(const Status& status) {
+    if (!status.ok()) {
+      ProcessedAll(status);
+      return;
+    }
+
+    for (const auto& op : ops_) {
+      auto& response = *op->mutable_response();
+      if (response.code() == RedisResponsePB::SERVER_ERROR) {
+        resp_ = response;
+        ProcessedAll(Status::OK());
+        return;
+      }
+      if (is_write_) {
+        continue;
+      }
+      // Keys that do not hold a string are reported as nil, like Redis does.
+      auto* array_response = resp_.mutable_array_response();
+      if (response.code() == RedisResponsePB::OK && response.has_string_response()) {
+        redisserver::AppendBulkString(response.string_response(), array_response->add_elements());
+      } else {
+        array_response->add_elements(kNilResponse);
+      }
+    }
+    if (!is_write_) {
+      resp_.mutable_array_response()->set_encoded(true);
+    } else if (FLAGS_redis_publish_invalidations) {
+      std::vector<std::string> keys;
+      for (size_t i = 1; i < data_.arg_size(); i += 2) {
+        keys.push_back(data_.arg(i).ToBuffer());
+      }
+      data_.context()->service_data()->PublishInvalidations(keys);
+    }
+    ProcessedAll(Status::OK());
+  }
+
+  void ProcessedAll(const Status& status) {
+    data_.Respond(status, &resp_);
+
+    for (const auto& callback : callbacks_) {
+      callback(status);
+    }
+  }
+
+  LocalCommandData data_;
+  const bool is_write_;
+
+  std::vector<std::shared_ptr<client::YBRedisOp>> ops_;
+  client::YBSession* session_ = nullptr;
+  std::vector<StatusFunctor> callbacks_;
+  std::atomic<size_t> stored_{0};
+  RedisResponsePB resp_;
+};
+
+void HandleMGet(LocalCommandData data) {
+  std::make_shared<MultiKeyProcessor>(data, false /* is_write */)->Execute();
+}
+
+void HandleMSet(LocalCommandData data) {
+  if (data.arg_size() % 2 == 0) {
+    data.Respond(STATUS_SUBSTITUTE(InvalidCommand,
+        "An MSET request must have at least 3, odd number of arguments, found $0",
+        data.arg_size()), nullptr);
+    return;
+  }
+  std::make_shared<MultiKeyProcessor>(data, true /* is_write */)->Execute();
+}
+
 void HandleCommand(LocalCommandData data) {
   data.Respond();
 }
@@ -1188,7 +1520,7 @@ void HandleListDB(LocalCommandData data) {
   }
   std::sort(dbs.begin(), dbs.end());
   for (const string& db : dbs) {
-    AddElements(redisserver::EncodeAsBulkString(db), array_response);
+    redisserver::AppendBulkString(db, array_response->add_elements());
   }
   array_response->set_encoded(true);
   resp.set_code(RedisResponsePB::OK);
@@ -1306,5 +1638,43 @@ void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
   BOOST_PP_SEQ_FOR_EACH(POPULATE_HANDLER, ~, REDIS_COMMANDS);
 }
 
+#define READ_KEYED true
+#define PAGED_KEYED true
+#define WRITE_KEYED true
+#define LOCAL_KEYED false
+#define CLUSTER_KEYED false
+
+#define DO_POPULATE_KEYED(name, cname, arity, type) \
+    { BOOST_PP_STRINGIZE(name), BOOST_PP_CAT(type, _KEYED) },
+#define POPULATE_KEYED(r, data, elem) DO_POPULATE_KEYED elem
+
+bool GetCommandKeys(const RedisClientCommand& command, std::vector<Slice>* keys) {
+  static const std::unordered_map<std::string, bool> kCommandKeyed = {
+    BOOST_PP_SEQ_FOR_EACH(POPULATE_KEYED, ~, REDIS_COMMANDS)
+  };
+
+  if (command.size() < 2) {
+    return false;
+  }
+  const auto name = boost::to_lower_copy(command[0].ToBuffer());
+  // MGET and MSET are local commands, that access only keys in their arguments.
+  if (name == "mget") {
+    keys->insert(keys->end(), command.begin() + 1, command.end());
+    return true;
+  }
+  if (name == "mset") {
+    for (size_t i = 1; i < command.size(); i += 2) {
+      keys->push_back(command[i]);
+    }
+    return true;
+  }
+  const auto it = kCommandKeyed.find(name);
+  if (it == kCommandKeyed.end() || !it->second) {
+    return false;
+  }
+  keys->push_back(command[1]);
+  return true;
+}
+
 } // namespace redisserver
 } // namespace yb
@@ -63,6 +63,10 @@ class RedisServiceData {
   virtual void ForwardToInterestedProxies(
       const std::string& channel, const std::string& message, const IntFunctor& f) = 0;
 
+  // Used for client side caching. Publishes keys modified by write commands to subscribers of the
+  // invalidation channel on all proxies.
+  virtual void PublishInvalidations(const std::vector<std::string>& keys) = 0;
+
   // Used for Auth.
   virtual CHECKED_STATUS GetRedisPasswords(std::vector<std::string>* passwords) = 0;
 
@@ -137,6 +141,10 @@ void RespondWithFailure(
 void FillRedisCommands(const scoped_refptr<MetricEntity>& metric_entity,
                        const std::function<void(const RedisCommandInfo& info)>& setup_method);
 
+// Appends keys accessed by the command to keys. Returns false when the command is not limited to
+// its keys, i.e. it is a local or cluster command, or it is unknown.
+bool GetCommandKeys(const RedisClientCommand& command, std::vector<Slice>* keys);
+
 #define YB_REDIS_METRIC(name) \
     BOOST_PP_CAT(METRIC_handler_latency_yb_redisserver_RedisServerService_, name)
 
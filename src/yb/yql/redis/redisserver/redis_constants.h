@@ -26,6 +26,8 @@ static constexpr const char* const kNX = "NX";
 static constexpr const char* const kXX = "XX";
 static constexpr const char* const kINCR = "INCR";
 static constexpr const char* const kCH = "CH";
+// Channel that receives keys modified by write commands, when redis_publish_invalidations is set.
+static constexpr const char* const kRedisInvalidationChannel = "__redis__:invalidate";
 static constexpr int64_t kRedisMaxTtlMillis = std::numeric_limits<int64_t>::max() /
     yb::MonoTime::kNanosecondsPerMillisecond;
 static constexpr int64_t kRedisMaxTtlSeconds = kRedisMaxTtlMillis /
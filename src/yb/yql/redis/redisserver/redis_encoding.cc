@@ -205,6 +205,14 @@ Out ProcessEncoded(const std::string& input, Out out) {
     DCHECK_EQ(result.uend(), pos); \
     return result; \
   } \
+  void BOOST_PP_CAT(Append, name)(type input, std::string* out) { \
+    static constexpr size_t kZero = 0; \
+    const size_t old_size = out->size(); \
+    out->resize(old_size + BOOST_PP_CAT(Process, name)(input, kZero)); \
+    auto* start = pointer_cast<uint8_t*>(&(*out)[0]); \
+    auto* pos = BOOST_PP_CAT(Process, name)(input, start + old_size); \
+    DCHECK_EQ(start + out->size(), pos); \
+  } \
   size_t BOOST_PP_CAT(Serialize, name)(type input, size_t size) { \
     return BOOST_PP_CAT(Process, name)(input, size); \
   } \
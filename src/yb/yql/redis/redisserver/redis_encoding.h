@@ -18,6 +18,7 @@
 #include <boost/preprocessor/seq/for_each.hpp>
 
 #include "yb/gutil/strings/join.h"
+#include "yb/gutil/strings/strcat.h"
 
 namespace google {
 namespace protobuf {
@@ -72,8 +73,14 @@ extern const std::string kInfoResponse;
   ((EncodedArray, const google::protobuf::RepeatedPtrField<std::string>&)) \
   /**/
 
+// EncodeAs<Primitive> allocates a buffer of the exact size and encodes input into it.
+// Append<Primitive> encodes input to the end of out, resizing it only once, so the result does not
+// have to be copied again when it is stored in a protobuf string.
+// Serialize<Primitive> is used to calculate the size of the encoded input and to encode it to the
+// preallocated memory.
 #define DO_REDIS_PRIMITIVES_FORWARD(name, type) \
   RefCntBuffer BOOST_PP_CAT(EncodeAs, name)(type input); \
+  void BOOST_PP_CAT(Append, name)(type input, std::string* out); \
   size_t BOOST_PP_CAT(Serialize, name)(type input, size_t size); \
   uint8_t* BOOST_PP_CAT(Serialize, name)(type input, uint8_t* pos);
 
@@ -83,7 +90,18 @@ BOOST_PP_SEQ_FOR_EACH(REDIS_PRIMITIVES_FORWARD, ~, REDIS_PRIMITIVES)
 
 template <typename Container>
 std::string EncodeAsArrayOfEncodedElements(const Container& encoded_elements) {
-  return StrCat("*", encoded_elements.size(), "\r\n", JoinStrings(encoded_elements, ""));
+  // Array header is at most 24 bytes: '*', up to 20 digits and "\r\n".
+  size_t size = 24;
+  for (const auto& element : encoded_elements) {
+    size += element.size();
+  }
+  std::string result;
+  result.reserve(size);
+  StrAppend(&result, "*", encoded_elements.size(), "\r\n");
+  for (const auto& element : encoded_elements) {
+    result.append(element.data(), element.size());
+  }
+  return result;
 }
 
 }  // namespace redisserver
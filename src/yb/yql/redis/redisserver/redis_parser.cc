@@ -48,6 +48,8 @@ namespace {
 constexpr size_t kMaxNumberOfArgs = 1 << 20;
 constexpr size_t kLineEndLength = 2;
 constexpr size_t kMaxNumberLength = 25;
+// Numbers of up to this number of decimal digits do not overflow ptrdiff_t.
+constexpr size_t kMaxFastNumberLength = 18;
 constexpr char kPositiveInfinity[] = "+inf";
 constexpr char kNegativeInfinity[] = "-inf";
 
@@ -167,14 +169,6 @@ CHECKED_STATUS ParseSetNX(YBRedisWriteOp *op, const RedisClientCommand& args) {
 }
 
 // TODO: support MSET
-CHECKED_STATUS ParseMSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
-  if (args.size() < 3 || args.size() % 2 == 0) {
-    return STATUS_SUBSTITUTE(InvalidCommand,
-        "An MSET request must have at least 3, odd number of arguments, found $0", args.size());
-  }
-  return STATUS(InvalidCommand, "MSET command not yet supported");
-}
-
 CHECKED_STATUS ParseHSet(YBRedisWriteOp *op, const RedisClientCommand& args) {
   const auto& key = args[1];
   const auto& subkey = args[2];
@@ -532,11 +526,6 @@ CHECKED_STATUS ParseHGetLikeCommands(YBRedisReadOp* op, const RedisClientCommand
   return ParseCollection(op, args, boost::none, add_string_subkey, remove_duplicates);
 }
 
-// TODO: Support MGET
-CHECKED_STATUS ParseMGet(YBRedisReadOp* op, const RedisClientCommand& args) {
-  return STATUS(InvalidCommand, "MGET command not yet supported");
-}
-
 CHECKED_STATUS ParseHGet(YBRedisReadOp* op, const RedisClientCommand& args) {
   return ParseHGetLikeCommands(op, args, RedisGetRequestPB_GetRequestType_HGET);
 }
@@ -1201,6 +1190,30 @@ Result<ptrdiff_t> RedisParser::ParseNumber(char prefix,
     return STATUS_FORMAT(
         Corruption, "Too long $0 of length $1", name, expected_stop - number_begin);
   }
+
+  // Fast path for a number of a few digits within a single block, that is the usual case.
+  // Anything else is handled by strtoll below, to keep its error reporting.
+  auto p = offset_to_idx_and_local_offset(number_begin);
+  const size_t number_length = expected_stop - number_begin;
+  if (number_length > 0 && number_length <= kMaxFastNumberLength &&
+      p.second + number_length <= source_[p.first].iov_len) {
+    const char* digit = IoVecBegin(source_[p.first]) + p.second;
+    const char* const end = digit + number_length;
+    ptrdiff_t parsed_number = 0;
+    for (; digit != end && *digit >= '0' && *digit <= '9'; ++digit) {
+      parsed_number = parsed_number * 10 + (*digit - '0');
+    }
+    if (digit == end) {
+      SCHECK_BOUNDS(parsed_number,
+                    min,
+                    max,
+                    Corruption,
+                    yb::Format("$0 out of expected range [$1, $2] : $3",
+                               name, min, max, parsed_number));
+      return parsed_number;
+    }
+  }
+
   number_buffer_.reserve(kMaxNumberLength);
   IoVecsToBuffer(source_, number_begin, expected_stop, &number_buffer_);
   number_buffer_.push_back(0);
@@ -19,6 +19,7 @@
 
 #include "yb/common/redis_protocol.pb.h"
 
+#include "yb/yql/redis/redisserver/redis_commands.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
 #include "yb/yql/redis/redisserver/redis_parser.h"
 
@@ -42,7 +43,8 @@ DECLARE_bool(rpc_dump_all_traces);
 DECLARE_int32(rpc_slow_query_threshold_ms);
 DEFINE_uint64(redis_max_concurrent_commands, 1,
               "Max number of redis commands received from single connection, "
-              "that could be processed concurrently");
+              "that could be processed concurrently. Commands accessing the same key, and "
+              "commands that are not limited to keys, are still processed in order.");
 DEFINE_uint64(redis_max_batch, 500, "Max number of redis commands that forms batch");
 DEFINE_int32(rpcz_max_redis_query_dump_size, 4_KB,
              "The maximum size of the Redis query string in the RPCZ dump.");
@@ -241,10 +243,45 @@ Status RedisInboundCall::ParseFrom(
                          end_of_command, request_data_.size());
   }
 
+  if (FLAGS_redis_max_concurrent_commands > 1) {
+    keyed_ = true;
+    for (const auto& command : client_batch_) {
+      if (!GetCommandKeys(command, &keys_)) {
+        keyed_ = false;
+        keys_.clear();
+        break;
+      }
+    }
+    std::sort(keys_.begin(), keys_.end(), [](const Slice& lhs, const Slice& rhs) {
+      return lhs.compare(rhs) < 0;
+    });
+  }
+
   parsed_.store(true, std::memory_order_release);
   return Status::OK();
 }
 
+bool RedisInboundCall::ConflictsWith(const rpc::QueueableInboundCall& other) const {
+  const auto& other_call = down_cast<const RedisInboundCall&>(other);
+  if (!keyed_ || !other_call.keyed_) {
+    return true;
+  }
+  auto it = keys_.begin();
+  auto other_it = other_call.keys_.begin();
+  while (it != keys_.end() && other_it != other_call.keys_.end()) {
+    const int cmp = it->compare(*other_it);
+    if (cmp == 0) {
+      return true;
+    }
+    if (cmp < 0) {
+      ++it;
+    } else {
+      ++other_it;
+    }
+  }
+  return false;
+}
+
 const std::string& RedisInboundCall::service_name() const {
   static std::string result = "yb.redisserver.RedisServerService"s;
   return result;
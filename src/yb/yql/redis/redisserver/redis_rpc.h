@@ -64,6 +64,14 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
 
   void SetCleanupHook(std::function<void()> hook) { cleanup_hook_ = std::move(hook); }
 
+  // Cluster aware clients ask for the slot map, so they are able to follow MOVED redirects.
+  bool is_cluster_aware() const {
+    return cluster_aware_.load(std::memory_order_acquire);
+  }
+  void set_cluster_aware() {
+    cluster_aware_.store(true, std::memory_order_release);
+  }
+
   // Shutdown this context. Clean up the subscriptions if any.
   void Shutdown(const Status& status) override;
 
@@ -94,6 +102,7 @@ class RedisConnectionContext : public rpc::ConnectionContextWithQueue {
   size_t commands_in_batch_ = 0;
   size_t end_of_batch_ = 0;
   std::atomic<bool> authenticated_{false};
+  std::atomic<bool> cluster_aware_{false};
   std::string redis_db_name_ = "0";
   std::atomic<RedisClientMode> mode_{RedisClientMode::kNormal};
   CoarseTimePoint soft_limit_exceeded_since_{CoarseTimePoint::max()};
@@ -139,6 +148,9 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
                       RedisResponsePB* resp);
   void MarkForClose() { quit_.store(true, std::memory_order_release); }
 
+  // Calls conflict unless both of them access only keys and their keys do not intersect.
+  bool ConflictsWith(const rpc::QueueableInboundCall& other) const override;
+
  private:
 
   // The connection on which this inbound call arrived.
@@ -149,6 +161,11 @@ class RedisInboundCall : public rpc::QueueableInboundCall {
   std::atomic<bool> had_failures_{false};
   RedisClientBatch client_batch_;
 
+  // Sorted keys accessed by the commands of this call, when all of them access only keys.
+  // Filled only when commands of a connection are processed concurrently.
+  std::vector<Slice> keys_;
+  bool keyed_ = false;
+
   // Atomic bool to indicate if the command batch has been parsed.
   std::atomic<bool> parsed_ = {false};
 
@@ -55,6 +55,7 @@
 #include "yb/tserver/tserver_service.proxy.h"
 
 #include "yb/util/bytes_formatter.h"
+#include "yb/util/flag_tags.h"
 #include "yb/util/locks.h"
 #include "yb/util/logging.h"
 #include "yb/util/memory/mc_types.h"
@@ -120,6 +121,15 @@ DEFINE_int32(redis_password_caching_duration_ms, 5000,
              "The duration for which we will cache the redis passwords. 0 to disable.");
 
 DEFINE_bool(redis_safe_batch, true, "Use safe batching with Redis service");
+DEFINE_bool(redis_publish_invalidations, false,
+            "Publish keys modified by write commands to the __redis__:invalidate channel, so "
+            "clients that cache values locally could subscribe to it and drop stale entries.");
+TAG_FLAG(redis_publish_invalidations, advanced);
+DEFINE_bool(redis_cluster_redirects, false,
+            "Reply with MOVED to commands of cluster aware clients, when the leader of the key's "
+            "tablet is not co-located with this proxy. So such clients send commands directly to "
+            "the proxy next to the leader.");
+TAG_FLAG(redis_cluster_redirects, advanced);
 DEFINE_bool(enable_redis_auth, true, "Enable AUTH for the Redis service");
 
 DECLARE_string(placement_cloud);
@@ -475,15 +485,23 @@ class Block : public std::enable_shared_from_this<Block> {
         return;
     }
 
+    std::vector<std::string> modified_keys;
     for (auto* op : ops_) {
       if (op->has_operation() && op_errors.find(&op->operation()) != op_errors.end()) {
         // Could check here for NotFound either.
         auto s = op_errors[&op->operation()];
         op->Respond(s);
       } else {
+        if (FLAGS_redis_publish_invalidations && op->type() == OperationType::kWrite &&
+            op->response().code() == RedisResponsePB::OK) {
+          modified_keys.push_back(op->operation().GetKey());
+        }
         op->Respond(Status::OK());
       }
     }
+    if (!modified_keys.empty()) {
+      context_->service_data()->PublishInvalidations(modified_keys);
+    }
 
     Processed();
   }
@@ -771,6 +789,7 @@ struct RedisServiceImplData : public RedisServiceData {
   int Publish(const string& channel, const string& message);
   void ForwardToInterestedProxies(
       const string& channel, const string& message, const IntFunctor& f) override;
+  void PublishInvalidations(const std::vector<std::string>& keys) override;
   int PublishToLocalClients(IsMonitorMessage mode, const string& channel, const string& message);
   Result<vector<HostPortPB>> GetServerAddrsForChannel(const string& channel);
   int NumSubscriptionsUnlocked(Connection* conn);
@@ -938,6 +957,10 @@ class BatchContextImpl : public BatchContext {
       }
     } else {
       operation->SetTablet(*result);
+      if (FLAGS_redis_cluster_redirects && operation->has_operation() &&
+          !operation->responded() && call_->connection_context().is_cluster_aware()) {
+        RedirectToLeader(operation);
+      }
     }
     if (lookups_left_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
       return;
@@ -967,6 +990,25 @@ class BatchContextImpl : public BatchContext {
     tablets_.clear();
   }
 
+  // Replies with MOVED when the tablet leader is on another node, like a Redis cluster node does
+  // for slots it does not serve.
+  void RedirectToLeader(Operation* operation) {
+    // A standalone proxy is not co-located with any leader, so it does not redirect.
+    const auto* tserver = impl_data_->server_->tserver();
+    auto* leader = operation->tablet()->LeaderTServer();
+    if (!tserver || !leader || leader->permanent_uuid() == tserver->permanent_uuid()) {
+      return;
+    }
+    auto host = leader->GetDesiredHostPort(CloudInfoPB()).host();
+    if (host.empty()) {
+      return;
+    }
+    auto slot = PartitionSchema::DecodeMultiColumnHashValue(operation->partition_key());
+    operation->Respond(STATUS_FORMAT(
+        InvalidCommand, "MOVED $0 $1:$2", slot, host,
+        impl_data_->server_->opts().rpc_opts.default_port));
+  }
+
   RedisServiceImplData* impl_data_ = nullptr;
 
   const string db_name_;
@@ -1261,21 +1303,43 @@ void RedisServiceImplData::ForwardToInterestedProxies(
   }
 }
 
+void RedisServiceImplData::PublishInvalidations(const std::vector<std::string>& keys) {
+  string encoded_keys = StrCat("*", keys.size(), "\r\n");
+  for (const auto& key : keys) {
+    redisserver::AppendBulkString(key, &encoded_keys);
+  }
+  ForwardToInterestedProxies(kRedisInvalidationChannel, encoded_keys, [](int) {});
+}
+
+// Messages of the invalidation channel are arrays of keys, that are already encoded.
+void AppendMessage(const string& channel, const string& message, string* out) {
+  if (channel == kRedisInvalidationChannel) {
+    out->append(message);
+  } else {
+    redisserver::AppendBulkString(message, out);
+  }
+}
+
+// Messages are encoded in place, so the payload is copied only once for each subscriber.
 string MessageFor(const string& channel, const string& message) {
-  vector<string> parts;
-  parts.push_back(redisserver::EncodeAsBulkString("message").ToBuffer());
-  parts.push_back(redisserver::EncodeAsBulkString(channel).ToBuffer());
-  parts.push_back(redisserver::EncodeAsBulkString(message).ToBuffer());
-  return redisserver::EncodeAsArrayOfEncodedElements(parts);
+  string result;
+  result.reserve(message.size() + channel.size() + 64);
+  result.append("*3\r\n");
+  redisserver::AppendBulkString("message", &result);
+  redisserver::AppendBulkString(channel, &result);
+  AppendMessage(channel, message, &result);
+  return result;
 }
 
 string PMessageFor(const string& pattern, const string& channel, const string& message) {
-  vector<string> parts;
-  parts.push_back(redisserver::EncodeAsBulkString("pmessage").ToBuffer());
-  parts.push_back(redisserver::EncodeAsBulkString(pattern).ToBuffer());
-  parts.push_back(redisserver::EncodeAsBulkString(channel).ToBuffer());
-  parts.push_back(redisserver::EncodeAsBulkString(message).ToBuffer());
-  return redisserver::EncodeAsArrayOfEncodedElements(parts);
+  string result;
+  result.reserve(message.size() + channel.size() + pattern.size() + 80);
+  result.append("*4\r\n");
+  redisserver::AppendBulkString("pmessage", &result);
+  redisserver::AppendBulkString(pattern, &result);
+  redisserver::AppendBulkString(channel, &result);
+  AppendMessage(channel, message, &result);
+  return result;
 }
 
 int RedisServiceImplData::PublishToLocalClients(
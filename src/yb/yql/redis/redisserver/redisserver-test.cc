@@ -32,6 +32,7 @@
 #include "yb/yql/redis/redisserver/redis_client.h"
 #include "yb/yql/redis/redisserver/redis_constants.h"
 #include "yb/yql/redis/redisserver/redis_encoding.h"
+#include "yb/yql/redis/redisserver/redis_parser.h"
 #include "yb/yql/redis/redisserver/redis_server.h"
 
 #include "yb/rpc/io_thread_pool.h"
@@ -48,12 +49,14 @@ DECLARE_uint64(redis_max_read_buffer_size);
 DECLARE_uint64(redis_max_queued_bytes);
 DECLARE_int64(redis_rpc_block_size);
 DECLARE_bool(redis_safe_batch);
+DECLARE_bool(redis_cluster_redirects);
 DECLARE_bool(emulate_redis_responses);
 DECLARE_bool(test_tserver_timeout);
 DECLARE_bool(enable_backpressure_mode_for_testing);
 DECLARE_bool(yedis_enable_flush);
 DECLARE_int32(redis_service_yb_client_timeout_millis);
 DECLARE_int32(redis_max_value_size);
+DECLARE_int32(redis_collection_page_size);
 DECLARE_int32(redis_max_command_size);
 DECLARE_int32(redis_password_caching_duration_ms);
 DECLARE_int32(rpc_max_message_size);
@@ -1073,6 +1076,44 @@ TEST_F(TestRedisService, SimpleCommandMulti) {
       __LINE__, "*3\r\n$3\r\nset\r\n$3\r\nfoo\r\n$4\r\nTEST\r\n", "+OK\r\n");
 }
 
+TEST(RedisEncodingTest, AppendEncoded) {
+  std::string out = "*3\r\n";
+  AppendBulkString("foo", &out);
+  AppendInteger(-42, &out);
+  AppendSimpleString("OK", &out);
+  ASSERT_EQ("*3\r\n$3\r\nfoo\r\n:-42\r\n+OK\r\n", out);
+
+  const std::vector<std::string> elements = {EncodeAsBulkString("").ToBuffer(), kNilResponse};
+  ASSERT_EQ("*2\r\n$0\r\n\r\n$-1\r\n", EncodeAsArrayOfEncodedElements(elements));
+  ASSERT_EQ("*0\r\n", EncodeAsArrayOfEncodedElements(std::vector<std::string>()));
+}
+
+TEST(RedisParserTest, ParsePipeline) {
+  constexpr int kNumCommands = 100000;
+  std::string pipeline;
+  for (int i = 0; i != kNumCommands; ++i) {
+    const auto key = Format("key$0", i);
+    const auto value = Format("value$0", i);
+    pipeline += Format("*3\r\n$$3\r\nSET\r\n$$$0\r\n$1\r\n$$$2\r\n$3\r\n",
+                       key.size(), key, value.size(), value);
+  }
+
+  RedisClientCommand args;
+  RedisParser parser(IoVecs(1, iovec{&pipeline[0], pipeline.size()}));
+  parser.SetArgs(&args);
+  auto start = MonoTime::Now();
+  for (int i = 0; i != kNumCommands; ++i) {
+    ASSERT_NE(0, ASSERT_RESULT(parser.NextCommand()));
+    ASSERT_EQ(3, args.size());
+    ASSERT_EQ(Format("key$0", i), args[1].ToBuffer());
+    ASSERT_EQ(Format("value$0", i), args[2].ToBuffer());
+  }
+  auto passed = MonoTime::Now() - start;
+  ASSERT_EQ(0, ASSERT_RESULT(parser.NextCommand()));
+  LOG(INFO) << "Parsed " << kNumCommands << " commands of " << pipeline.size() << " bytes in "
+            << passed << ", " << passed.ToNanoseconds() / kNumCommands << "ns per command";
+}
+
 TEST_F(TestRedisService, BatchedCommandsInline) {
   SendCommandAndExpectResponse(
       __LINE__,
@@ -1080,6 +1121,41 @@ TEST_F(TestRedisService, BatchedCommandsInline) {
       "+OK\r\n+OK\r\n$3\r\nbar\r\n$1\r\n5\r\n");
 }
 
+class TestRedisServiceConcurrentCommands : public TestRedisService {
+ public:
+  void SetUp() override {
+    saver_.emplace();
+
+    FLAGS_redis_max_concurrent_commands = 16;
+    FLAGS_redis_max_batch = 1;
+    TestRedisService::SetUp();
+  }
+
+  void TearDown() override {
+    TestRedisService::TearDown();
+    saver_.reset();
+  }
+
+ private:
+  boost::optional<google::FlagSaver> saver_;
+};
+
+TEST_F_EX(TestRedisService, ConcurrentCommands, TestRedisServiceConcurrentCommands) {
+  // Commands on the same key are executed in order, while commands on other keys could be
+  // executed concurrently. Replies are sent in request order.
+  for (int i = 0; i != 100; ++i) {
+    ASSERT_NO_FATAL_FAILURE(
+        SendCommandAndExpectResponse(
+            __LINE__,
+            Format("set a $0\r\nset b x\r\nget a\r\nincr a\r\nappend b y\r\n"
+                   "get b\r\nping\r\nget a\r\n", i),
+            Format("+OK\r\n+OK\r\n$$$0\r\n$1\r\n:$2\r\n:2\r\n"
+                   "$$2\r\nxy\r\n+PONG\r\n$$$3\r\n$2\r\n",
+                   std::to_string(i).size(), i, i + 1, std::to_string(i + 1).size()))
+    );
+  }
+}
+
 TEST_F(TestRedisService, TestTimedoutInQueue) {
   FLAGS_redis_max_batch = 1;
   SetAtomicFlag(true, &FLAGS_enable_backpressure_mode_for_testing);
@@ -1473,6 +1549,75 @@ TEST_F(TestRedisService, TestSetThenGet) {
   );
 }
 
+TEST_F(TestRedisService, TestMSetThenMGet) {
+  // Keys are spread over tablets, the values are returned in the order of the keys.
+  SendCommandAndExpectResponse(
+      __LINE__, "mset k1 v1 k2 v2 k3 v3 k4 v4 k5 v5\r\n", "+OK\r\n");
+  SendCommandAndExpectResponse(
+      __LINE__, "hset h1 s1 v\r\nmget k5 k3 missing h1 k1\r\n",
+      ":1\r\n*5\r\n$2\r\nv5\r\n$2\r\nv3\r\n$-1\r\n$-1\r\n$2\r\nv1\r\n");
+  // Commands before and after are ordered with MGET and MSET.
+  SendCommandAndExpectResponse(
+      __LINE__, "set k1 x\r\nmget k1\r\nmset k1 y\r\nget k1\r\n",
+      "+OK\r\n*1\r\n$1\r\nx\r\n+OK\r\n$1\r\ny\r\n");
+  DoRedisTestExpectError(__LINE__, {"MSET", "k1", "v1", "k2"});
+
+  SyncClient();
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestPagedCollectionReads) {
+  FLAGS_redis_collection_page_size = 2;
+  DoRedisTestOk(__LINE__, {"HMSET", "h", "f1", "v1", "f2", "v2", "f3", "v3", "f4", "v4"});
+  DoRedisTestInt(__LINE__, {"SADD", "s", "m1", "m2", "m3"}, 3);
+  SyncClient();
+
+  DoRedisTestArray(
+      __LINE__, {"HGETALL", "h"}, {"f1", "v1", "f2", "v2", "f3", "v3", "f4", "v4"});
+  DoRedisTestArray(__LINE__, {"HKEYS", "h"}, {"f1", "f2", "f3", "f4"});
+  DoRedisTestArray(__LINE__, {"HVALS", "h"}, {"v1", "v2", "v3", "v4"});
+  DoRedisTestArray(__LINE__, {"SMEMBERS", "s"}, {"m1", "m2", "m3"});
+  DoRedisTestArray(__LINE__, {"HGETALL", "missing"}, {});
+  DoRedisTestExpectError(__LINE__, {"SMEMBERS", "h"}, "WRONGTYPE");
+  SyncClient();
+  VerifyCallbacks();
+}
+
+TEST_F(TestRedisService, TestClusterNodes) {
+  FLAGS_redis_cluster_redirects = true;
+  DoRedisTest(__LINE__, {"CLUSTER", "NODES"}, RedisReplyType::kString,
+      [](const RedisReply& reply) {
+        // Slot ranges of all nodes cover the whole hash space.
+        size_t num_slots = 0;
+        vector<string> lines;
+        boost::split(lines, reply.as_string(), boost::is_any_of("\n"), boost::token_compress_on);
+        for (const auto& line : lines) {
+          if (line.empty()) {
+            continue;
+          }
+          vector<string> fields;
+          boost::split(fields, line, boost::is_any_of(" "));
+          ASSERT_GE(fields.size(), 9) << line;
+          // Standalone proxy is not co-located with any node.
+          ASSERT_EQ("master", fields[2]) << line;
+          for (size_t i = 8; i < fields.size(); ++i) {
+            vector<string> range;
+            boost::split(range, fields[i], boost::is_any_of("-"));
+            ASSERT_EQ(2, range.size()) << line;
+            num_slots += std::stoi(range[1]) - std::stoi(range[0]) + 1;
+          }
+        }
+        ASSERT_EQ(kRedisClusterSlots, num_slots);
+      });
+  SyncClient();
+
+  // Standalone proxy does not redirect commands of cluster aware clients.
+  DoRedisTestOk(__LINE__, {"SET", "k", "v"});
+  DoRedisTestBulkString(__LINE__, {"GET", "k"}, "v");
+  SyncClient();
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisService, TestUsingOpenSourceClient) {
   DoRedisTestOk(__LINE__, {"SET", "hello", "42"});
 
@@ -2582,6 +2727,59 @@ TEST_F(TestRedisServiceExternal, TestPUnsubscribeCluster) {
   TestPubSub(LocalOrCluster::kCluster, SubOrUnsub::kUnsubscribe, PatternOrChannel::kPattern);
 }
 
+class TestRedisServiceInvalidations : public TestRedisServiceExternal {
+ protected:
+  void CustomizeExternalMiniCluster(ExternalMiniClusterOptions* opts) override {
+    TestRedisServiceExternal::CustomizeExternalMiniCluster(opts);
+    opts->extra_tserver_flags.push_back("--redis_publish_invalidations=true");
+  }
+};
+
+TEST_F(TestRedisServiceInvalidations, InvalidateModifiedKeys) {
+  expected_no_sessions_ = true;
+  auto ts0 = external_mini_cluster()->tablet_server(0);
+  auto ts1 = external_mini_cluster()->tablet_server(1);
+  auto writer = std::make_shared<RedisClient>(ts0->bind_host(), ts0->redis_rpc_port());
+  auto subscriber = std::make_shared<RedisClient>(ts1->bind_host(), ts1->redis_rpc_port());
+  const string channel = kRedisInvalidationChannel;
+
+  UseClient(subscriber);
+  DoRedisTestResultsArray(
+      __LINE__, {"SUBSCRIBE", channel},
+      {RedisReply(RedisReplyType::kString, "subscribe"),
+       RedisReply(RedisReplyType::kString, channel), RedisReply(1)});
+  SyncClient();
+
+  // Keys modified through another proxy are published to subscribers of the channel.
+  UseClient(writer);
+  DoRedisTestOk(__LINE__, {"SET", "k1", "v1"});
+  SyncClient();
+  DoRedisTestOk(__LINE__, {"MSET", "k2", "v2", "k3", "v3"});
+  SyncClient();
+  DoRedisTestBulkString(__LINE__, {"GET", "k1"}, "v1");
+  DoRedisTestExpectError(__LINE__, {"PUBLISH", channel, "k1"});
+  SyncClient();
+
+  UseClient(subscriber);
+  DoRedisTestResultsArray(
+      __LINE__, {},
+      {RedisReply(RedisReplyType::kString, "message"),
+       RedisReply(RedisReplyType::kString, channel),
+       RedisReply({RedisReply(RedisReplyType::kString, "k1")})});
+  DoRedisTestResultsArray(
+      __LINE__, {},
+      {RedisReply(RedisReplyType::kString, "message"),
+       RedisReply(RedisReplyType::kString, channel),
+       RedisReply({RedisReply(RedisReplyType::kString, "k2"),
+                   RedisReply(RedisReplyType::kString, "k3")})});
+  // Reads are not published.
+  DoRedisTestArray(__LINE__, {"PING"}, {"pong", ""});
+  SyncClient();
+
+  UseClient(nullptr);
+  VerifyCallbacks();
+}
+
 TEST_F(TestRedisServiceExternal, TestSlowSubscribersCatchingUp) {
   expected_no_sessions_ = true;
 